@@ -0,0 +1,262 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/memory_pool.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/signal_table_reader.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid.h"
+
+#include <arrow/array/array_primitive.h>
+#include <arrow/buffer.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Allocation cost of each memory pool backend for the large, freshly touched buffers decoding
+// produces: first allocating, touching and freeing buffers the size of decoded signal and IPC
+// batch bodies, then decoding every read of a file read without memory mapping, so batch bodies
+// and decoded signal are allocated from the backend.
+//
+// Reports seconds and minor page faults for each, as a JSON array on stdout. Backends not
+// available on this system or in this build are skipped.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+pod5::RunInfoData make_run_info()
+{
+    return pod5::RunInfoData(
+        "acquisition_id",
+        1005,
+        4095,
+        -4096,
+        {},
+        "experiment_name",
+        "flow_cell_id",
+        "flow_cell_product_code",
+        "protocol_name",
+        "protocol_run_id",
+        200005,
+        "sample_id",
+        4000,
+        "sequencing_kit",
+        "sequencer_position",
+        "sequencer_position_type",
+        "software",
+        "system_name",
+        "system_type",
+        {});
+}
+
+// Minor page faults taken by the process so far, 0 where they can't be counted.
+long minor_page_faults()
+{
+#ifndef _WIN32
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+#else
+    return 0;
+#endif
+}
+
+// Write [read_count] reads of [samples_per_read] samples each to [path].
+void write_test_file(std::string const & path, std::size_t read_count, std::size_t samples_per_read)
+{
+    // One signal row per read, so decoded rows are as large as the reads:
+    pod5::FileWriterOptions options;
+    options.set_max_signal_chunk_size(std::uint32_t(samples_per_read));
+    auto writer_result = pod5::create_file_writer(path, "allocator_benchmark", options);
+    check_status(writer_result.status(), "create file");
+    auto writer = std::move(*writer_result);
+
+    auto const run_info = writer->add_run_info(make_run_info());
+    auto const pore_type = writer->add_pore_type("pore_type");
+    auto const end_reason = writer->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    check_status(run_info.status(), "add run info");
+    check_status(pore_type.status(), "add pore type");
+    check_status(end_reason.status(), "add end reason");
+
+    std::mt19937 rng(1);
+    auto uuid_gen = pod5::UuidRandomGenerator{rng};
+    std::normal_distribution<float> noise(0.0f, 8.0f);
+    std::uniform_int_distribution<int> level(300, 700);
+    std::vector<std::int16_t> signal(samples_per_read);
+    int current_level = 0;
+    for (std::size_t i = 0; i < signal.size(); ++i) {
+        if (i % 10 == 0) {
+            current_level = level(rng);
+        }
+        signal[i] = std::int16_t(current_level + noise(rng));
+    }
+
+    for (std::size_t i = 0; i < read_count; ++i) {
+        pod5::ReadData const read_data{
+            uuid_gen(),
+            std::uint32_t(i),
+            std::uint64_t(i * samples_per_read),
+            std::uint16_t(i % 512 + 1),
+            1,
+            *pore_type,
+            0.0f,
+            0.1f,
+            200.0f,
+            *end_reason,
+            false,
+            *run_info,
+            0,
+            1.0f,
+            0.0f,
+            1.0f,
+            0.0f,
+            0,
+            0.0f};
+        check_status(writer->add_complete_read(read_data, gsl::make_span(signal)), "add read");
+    }
+    check_status(writer->close(), "close file");
+}
+
+struct Measurement {
+    double seconds;
+    long minor_page_faults;
+};
+
+template <typename Run>
+Measurement measure(Run && run)
+{
+    auto const faults_start = minor_page_faults();
+    auto const start = Clock::now();
+    run();
+    return {
+        std::chrono::duration<double>(Clock::now() - start).count(),
+        minor_page_faults() - faults_start};
+}
+
+// Allocate [count] buffers of [size] bytes from [pool] in turn, writing to every page of each
+// before freeing it, as decoding fills its output.
+Measurement allocate_and_touch(arrow::MemoryPool * pool, std::int64_t size, std::size_t count)
+{
+    return measure([&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            auto buffer = arrow::AllocateBuffer(size, pool);
+            check_status(buffer.status(), "allocate buffer");
+            auto const data = (*buffer)->mutable_data();
+            for (std::int64_t offset = 0; offset < size; offset += 4096) {
+                data[offset] = std::uint8_t(i);
+            }
+        }
+    });
+}
+
+// Decode every signal row of [path] into buffers from [backend]'s pool, reading the file without
+// memory mapping so batch bodies are allocated from it too.
+Measurement decode_file(std::string const & path, pod5::MemoryPoolBackend backend)
+{
+    pod5::FileReaderOptions options;
+    options.set_force_disable_file_mapping(true);
+    check_status(options.set_memory_pool_backend(backend), "select memory pool backend");
+    auto reader = pod5::open_file_reader(path, options);
+    check_status(reader.status(), "open file");
+    auto const pool = options.memory_pool();
+
+    return measure([&] {
+        for (std::size_t i = 0; i < (*reader)->num_signal_record_batches(); ++i) {
+            auto batch = (*reader)->read_signal_record_batch(i);
+            check_status(batch.status(), "read signal batch");
+            auto const sample_counts = batch->samples_column();
+            for (std::size_t row = 0; row < batch->num_rows(); ++row) {
+                auto const sample_count = sample_counts->Value(row);
+                auto samples = arrow::AllocateBuffer(sample_count * sizeof(std::int16_t), pool);
+                check_status(samples.status(), "allocate samples");
+                check_status(
+                    batch->extract_signal_row(
+                        row,
+                        gsl::make_span(
+                            reinterpret_cast<std::int16_t *>((*samples)->mutable_data()),
+                            sample_count)),
+                    "decode signal");
+            }
+        }
+    });
+}
+
+struct Backend {
+    char const * name;
+    pod5::MemoryPoolBackend backend;
+};
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Pass a directory to write the synthetic file to, otherwise it is written here:
+    std::string const directory = argc > 1 ? argv[1] : ".";
+    std::size_t const read_count = argc > 2 ? std::stoull(argv[2]) : 200;
+
+    check_status(pod5::register_extension_types(), "register extension types");
+    auto const path = directory + "/allocator_benchmark.pod5";
+    std::filesystem::remove(path);
+    // Long reads, so decoded signal is megabytes per read:
+    write_test_file(path, read_count, 1'000'000);
+
+    std::vector<Backend> const backends{
+        {"default", pod5::MemoryPoolBackend::Default},
+        {"system", pod5::MemoryPoolBackend::System},
+        {"jemalloc", pod5::MemoryPoolBackend::Jemalloc},
+        {"mimalloc", pod5::MemoryPoolBackend::Mimalloc},
+        {"huge_pages", pod5::MemoryPoolBackend::HugePages}};
+
+    std::cout << "[";
+    bool first = true;
+    for (auto const & backend : backends) {
+        auto const pool = pod5::memory_pool_for_backend(backend.backend);
+        if (!pool.ok()) {
+            std::cerr << backend.name << " skipped: " << pool.status().ToString() << "\n";
+            continue;
+        }
+
+        std::ostringstream json;
+        json << "{\"backend\":\"" << backend.name << "\",\"allocate_and_touch\":[";
+        bool first_size = true;
+        for (std::int64_t const size : {256 * 1024, 2 * 1024 * 1024, 16 * 1024 * 1024}) {
+            auto const count = std::size_t(4LL * 1024 * 1024 * 1024 / size);
+            auto const result = allocate_and_touch(*pool, size, count);
+            json << (first_size ? "" : ",") << "{\"bytes\":" << size << ",\"count\":" << count
+                 << ",\"ns_per_allocation\":" << result.seconds * 1e9 / count
+                 << ",\"minor_page_faults\":" << result.minor_page_faults << "}";
+            first_size = false;
+        }
+
+        auto const decode = decode_file(path, backend.backend);
+        json << "],\"decode\":{\"reads\":" << read_count << ",\"seconds\":" << decode.seconds
+             << ",\"minor_page_faults\":" << decode.minor_page_faults << "}}";
+
+        std::cout << (first ? "" : ",\n") << json.str() << std::flush;
+        first = false;
+        std::cerr << backend.name << " done\n";
+    }
+    std::cout << "]\n";
+
+    std::filesystem::remove(path);
+    check_status(pod5::unregister_extension_types(), "unregister extension types");
+    return EXIT_SUCCESS;
+}
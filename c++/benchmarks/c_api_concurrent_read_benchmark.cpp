@@ -0,0 +1,208 @@
+#include "pod5_format/c_api.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/uuid.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+void check_pod5_ok(pod5_error_t error, char const * action)
+{
+    if (error != POD5_OK) {
+        std::cerr << "Failed to " << action << ": " << pod5_get_error_string() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+pod5::RunInfoData make_run_info()
+{
+    return pod5::RunInfoData(
+        "acquisition_id",
+        1005,
+        4095,
+        -4096,
+        {},
+        "experiment_name",
+        "flow_cell_id",
+        "flow_cell_product_code",
+        "protocol_name",
+        "protocol_run_id",
+        200005,
+        "sample_id",
+        4000,
+        "sequencing_kit",
+        "sequencer_position",
+        "sequencer_position_type",
+        "software",
+        "system_name",
+        "system_type",
+        {});
+}
+
+// Write a file of [read_count] short reads, so per call overhead is a large part of each read.
+void write_test_file(std::string const & path, std::size_t read_count)
+{
+    auto writer_result = pod5::create_file_writer(path, "c_api_concurrent_read_benchmark");
+    check_status(writer_result.status(), "create file");
+    auto writer = std::move(*writer_result);
+
+    auto const run_info = writer->add_run_info(make_run_info());
+    auto const pore_type = writer->add_pore_type("pore_type");
+    auto const end_reason = writer->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    check_status(run_info.status(), "add run info");
+    check_status(pore_type.status(), "add pore type");
+    check_status(end_reason.status(), "add end reason");
+
+    std::mt19937 rng(read_count);
+    auto uuid_gen = pod5::UuidRandomGenerator{rng};
+    std::uniform_int_distribution<int> sample(0, 2000);
+    std::vector<std::int16_t> signal(2'000);
+    for (std::size_t i = 0; i < read_count; ++i) {
+        pod5::ReadData const read_data{
+            uuid_gen(),
+            std::uint32_t(i),
+            std::uint64_t(i * 100'000),
+            std::uint16_t(i % 512 + 1),
+            1,
+            *pore_type,
+            0.0f,
+            0.1f,
+            200.0f,
+            *end_reason,
+            false,
+            *run_info,
+            0,
+            1.0f,
+            0.0f,
+            1.0f,
+            0.0f,
+            0,
+            0.0f};
+        for (auto & value : signal) {
+            value = std::int16_t(sample(rng));
+        }
+        check_status(writer->add_complete_read(read_data, gsl::make_span(signal)), "add read");
+    }
+    check_status(writer->close(), "close file");
+}
+
+// Read every read's row info and signal through the C API, splitting the rows of each batch
+// between [thread_count] threads sharing [reader], and return the reads read per second.
+double measure_reads_per_second(Pod5FileReader_t * reader, std::size_t thread_count)
+{
+    std::size_t batch_count = 0;
+    check_pod5_ok(pod5_get_read_batch_count(&batch_count, reader), "count batches");
+
+    std::atomic<bool> failed{false};
+    std::atomic<std::size_t> reads_read{0};
+    std::vector<std::thread> threads;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<std::int16_t> signal;
+            for (std::size_t batch_index = 0; batch_index < batch_count; ++batch_index) {
+                Pod5ReadRecordBatch_t * batch = nullptr;
+                if (pod5_get_read_batch(&batch, reader, batch_index) != POD5_OK) {
+                    failed = true;
+                    return;
+                }
+
+                std::size_t row_count = 0;
+                pod5_get_read_batch_row_count(&row_count, batch);
+                for (std::size_t row = t; row < row_count; row += thread_count) {
+                    ReadBatchRowInfo_t row_info;
+                    std::uint16_t table_version = 0;
+                    std::size_t sample_count = 0;
+                    if (pod5_get_read_batch_row_info_data(
+                            batch, row, READ_BATCH_ROW_INFO_VERSION, &row_info, &table_version)
+                            != POD5_OK
+                        || pod5_get_read_complete_sample_count(reader, batch, row, &sample_count)
+                               != POD5_OK)
+                    {
+                        failed = true;
+                        break;
+                    }
+                    signal.resize(sample_count);
+                    if (pod5_get_read_complete_signal(
+                            reader, batch, row, sample_count, signal.data())
+                        != POD5_OK)
+                    {
+                        failed = true;
+                        break;
+                    }
+                    reads_read += 1;
+                }
+                pod5_free_read_batch(batch);
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    if (failed) {
+        std::cerr << "Failed to read reads\n";
+        std::exit(EXIT_FAILURE);
+    }
+    auto const seconds = std::chrono::duration<double>(end - start).count();
+    return double(reads_read) / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Pass a pod5 file to benchmark against, otherwise a synthetic file is generated:
+    std::string path = argc > 1 ? argv[1] : "./c_api_concurrent_read_benchmark.pod5";
+
+    check_pod5_ok(pod5_init(), "init");
+    if (argc <= 1) {
+        write_test_file(path, 50'000);
+    }
+
+    auto reader = pod5_open_file(path.c_str());
+    if (!reader) {
+        std::cerr << "Failed to open file: " << pod5_get_error_string() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // Warm the signal cache, so only the calls and decompression are measured:
+    measure_reads_per_second(reader, 1);
+
+    std::cout << std::setw(9) << "threads" << std::setw(14) << "reads/s" << std::setw(10)
+              << "speedup"
+              << "\n";
+    double single_thread_rate = 0;
+    for (std::size_t thread_count : {1, 2, 4, 8, 16, 32, 64}) {
+        auto const rate = measure_reads_per_second(reader, thread_count);
+        if (thread_count == 1) {
+            single_thread_rate = rate;
+        }
+        std::cout << std::setw(9) << thread_count << std::setw(14) << std::fixed
+                  << std::setprecision(0) << rate << std::setw(10) << std::setprecision(2)
+                  << rate / single_thread_rate << "\n";
+    }
+
+    check_pod5_ok(pod5_close_and_free_reader(reader), "close file");
+    check_pod5_ok(pod5_terminate(), "terminate");
+    return EXIT_SUCCESS;
+}
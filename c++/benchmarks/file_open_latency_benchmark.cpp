@@ -0,0 +1,172 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid.h"
+
+#include <arrow/array/array_primitive.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+pod5::RunInfoData make_run_info()
+{
+    return pod5::RunInfoData(
+        "acquisition_id",
+        1005,
+        4095,
+        -4096,
+        {},
+        "experiment_name",
+        "flow_cell_id",
+        "flow_cell_product_code",
+        "protocol_name",
+        "protocol_run_id",
+        200005,
+        "sample_id",
+        4000,
+        "sequencing_kit",
+        "sequencer_position",
+        "sequencer_position_type",
+        "software",
+        "system_name",
+        "system_type",
+        {});
+}
+
+// Write a file of [read_count] short reads.
+void write_test_file(std::string const & path, std::size_t read_count)
+{
+    auto writer_result = pod5::create_file_writer(path, "file_open_latency_benchmark");
+    check_status(writer_result.status(), "create file");
+    auto writer = std::move(*writer_result);
+
+    auto const run_info = writer->add_run_info(make_run_info());
+    auto const pore_type = writer->add_pore_type("pore_type");
+    auto const end_reason = writer->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    check_status(run_info.status(), "add run info");
+    check_status(pore_type.status(), "add pore type");
+    check_status(end_reason.status(), "add end reason");
+
+    std::mt19937 rng(read_count);
+    auto uuid_gen = pod5::UuidRandomGenerator{rng};
+    std::vector<std::int16_t> const signal(4'000, 500);
+    for (std::size_t i = 0; i < read_count; ++i) {
+        pod5::ReadData const read_data{
+            uuid_gen(),
+            std::uint32_t(i),
+            std::uint64_t(i * 100'000),
+            std::uint16_t(i % 512 + 1),
+            1,
+            *pore_type,
+            0.0f,
+            0.1f,
+            200.0f,
+            *end_reason,
+            false,
+            *run_info,
+            0,
+            1.0f,
+            0.0f,
+            1.0f,
+            0.0f,
+            0,
+            0.0f};
+        check_status(writer->add_complete_read(read_data, gsl::make_span(signal)), "add read");
+    }
+    check_status(writer->close(), "close file");
+}
+
+// Read the signal of the first read in [reader], as a service reading one read would.
+void read_first_read(pod5::FileReader const & reader)
+{
+    auto batch = reader.read_read_record_batch(0);
+    check_status(batch.status(), "read read batch");
+    auto signal_rows = batch->get_signal_rows(0);
+    check_status(signal_rows.status(), "find signal rows");
+    auto const rows = gsl::make_span((*signal_rows)->raw_values(), (*signal_rows)->length());
+
+    auto sample_count = reader.extract_sample_count(rows);
+    check_status(sample_count.status(), "find sample count");
+    std::vector<std::int16_t> samples(*sample_count);
+    check_status(reader.extract_samples(rows, gsl::make_span(samples)), "extract samples");
+}
+
+struct Latencies {
+    double median_us;
+    double p90_us;
+};
+
+// Open [path] [open_count] times, also reading one read if [read_one], and find the latencies.
+Latencies measure_open(
+    std::string const & path,
+    pod5::FileReaderOptions const & options,
+    std::size_t open_count,
+    bool read_one)
+{
+    std::vector<double> latencies;
+    latencies.reserve(open_count);
+    for (std::size_t i = 0; i < open_count; ++i) {
+        auto const start = std::chrono::steady_clock::now();
+        auto reader = pod5::open_file_reader(path, options);
+        check_status(reader.status(), "open file");
+        if (read_one) {
+            read_first_read(**reader);
+        }
+        auto const end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    return {latencies[latencies.size() / 2], latencies[latencies.size() * 9 / 10]};
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Pass a pod5 file to benchmark against, otherwise a synthetic file is generated:
+    std::string path = argc > 1 ? argv[1] : "./file_open_latency_benchmark.pod5";
+    std::size_t const open_count = argc > 2 ? std::stoull(argv[2]) : 1'000;
+
+    check_status(pod5::register_extension_types(), "register extension types");
+    if (argc <= 1) {
+        write_test_file(path, 20'000);
+    }
+
+    std::cout << std::setw(8) << "open" << std::setw(12) << "workload" << std::setw(14)
+              << "median (us)" << std::setw(12) << "p90 (us)"
+              << "\n";
+
+    for (bool const lazy_open : {false, true}) {
+        pod5::FileReaderOptions options;
+        options.set_lazy_open(lazy_open);
+        for (bool const read_one : {false, true}) {
+            auto const latencies = measure_open(path, options, open_count, read_one);
+            std::cout << std::setw(8) << (lazy_open ? "lazy" : "eager") << std::setw(12)
+                      << (read_one ? "one read" : "open only") << std::setw(14) << std::fixed
+                      << std::setprecision(1) << latencies.median_us << std::setw(12)
+                      << latencies.p90_us << "\n";
+        }
+    }
+
+    check_status(pod5::unregister_extension_types(), "unregister extension types");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,329 @@
+#include "pod5_format/async_signal_loader.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Microbenchmarks of the writer, read id lookup and signal reading hot paths, each run against
+// files made by a seeded synthetic generator so results are reproducible without test data.
+//
+// Results are printed to stdout as one JSON object, progress is printed to stderr.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+pod5::RunInfoData make_run_info()
+{
+    return pod5::RunInfoData(
+        "acquisition_id",
+        1005,
+        4095,
+        -4096,
+        {},
+        "experiment_name",
+        "flow_cell_id",
+        "flow_cell_product_code",
+        "protocol_name",
+        "protocol_run_id",
+        200005,
+        "sample_id",
+        4000,
+        "sequencing_kit",
+        "sequencer_position",
+        "sequencer_position_type",
+        "software",
+        "system_name",
+        "system_type",
+        {});
+}
+
+// A synthetic file: how to write it, and the ids of the reads written.
+struct SyntheticFile {
+    std::string path;
+    std::size_t read_count;
+    std::size_t samples_per_read;
+    pod5::FileWriterOptions options;
+    std::vector<pod5::Uuid> read_ids;
+};
+
+// Write [file]'s reads, with signal stepping between levels plus noise like squiggle data, so
+// compression ratios are representative. Returns the seconds spent adding reads and closing.
+double write_synthetic_file(SyntheticFile & file)
+{
+    auto writer_result = pod5::create_file_writer(file.path, "hot_path_benchmark", file.options);
+    check_status(writer_result.status(), "create file");
+    auto writer = std::move(*writer_result);
+
+    auto const run_info = writer->add_run_info(make_run_info());
+    auto const pore_type = writer->add_pore_type("pore_type");
+    auto const end_reason = writer->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    check_status(run_info.status(), "add run info");
+    check_status(pore_type.status(), "add pore type");
+    check_status(end_reason.status(), "add end reason");
+
+    std::mt19937 rng(file.read_count);
+    auto uuid_gen = pod5::UuidRandomGenerator{rng};
+    std::normal_distribution<float> noise(0.0f, 8.0f);
+    std::uniform_int_distribution<int> level(300, 700);
+    std::vector<std::int16_t> signal(file.samples_per_read);
+    int current_level = 0;
+    for (std::size_t i = 0; i < signal.size(); ++i) {
+        if (i % 10 == 0) {
+            current_level = level(rng);
+        }
+        signal[i] = std::int16_t(current_level + noise(rng));
+    }
+
+    file.read_ids.clear();
+    auto const start = Clock::now();
+    for (std::size_t i = 0; i < file.read_count; ++i) {
+        file.read_ids.push_back(uuid_gen());
+        pod5::ReadData const read_data{
+            file.read_ids.back(),
+            std::uint32_t(i),
+            std::uint64_t(i * file.samples_per_read),
+            std::uint16_t(i % 512 + 1),
+            1,
+            *pore_type,
+            0.0f,
+            0.1f,
+            200.0f,
+            *end_reason,
+            false,
+            *run_info,
+            0,
+            1.0f,
+            0.0f,
+            1.0f,
+            0.0f,
+            0,
+            0.0f};
+        check_status(writer->add_complete_read(read_data, gsl::make_span(signal)), "add read");
+    }
+    check_status(writer->close(), "close file");
+    return seconds_since(start);
+}
+
+std::shared_ptr<pod5::FileReader> open_reader(std::string const & path)
+{
+    auto reader = pod5::open_file_reader(path);
+    check_status(reader.status(), "open file");
+    return *reader;
+}
+
+// add_complete_read throughput, by signal type and maximum signal chunk size.
+std::string benchmark_writer(std::string const & directory)
+{
+    std::ostringstream json;
+    json << "[";
+    bool first = true;
+    for (auto const signal_type :
+         {pod5::SignalType::VbzSignal, pod5::SignalType::UncompressedSignal})
+    {
+        for (std::uint32_t const chunk_size : {10'000u, 102'400u, 1'000'000u}) {
+            SyntheticFile file{directory + "/hot_path_writer.pod5", 2'000, 40'000, {}, {}};
+            file.options.set_signal_type(signal_type);
+            file.options.set_max_signal_chunk_size(chunk_size);
+            auto const seconds = write_synthetic_file(file);
+
+            auto const samples = double(file.read_count * file.samples_per_read);
+            json << (first ? "" : ",") << "{\"signal_type\":\""
+                 << (signal_type == pod5::SignalType::VbzSignal ? "vbz" : "uncompressed")
+                 << "\",\"max_signal_chunk_size\":" << chunk_size
+                 << ",\"reads\":" << file.read_count << ",\"seconds\":" << seconds
+                 << ",\"reads_per_second\":" << file.read_count / seconds
+                 << ",\"samples_per_second\":" << samples / seconds << "}";
+            first = false;
+            std::cerr << "writer: " << (signal_type == pod5::SignalType::VbzSignal ? "vbz" : "raw")
+                      << " chunk " << chunk_size << " " << seconds << "s\n";
+        }
+    }
+    json << "]";
+    return json.str();
+}
+
+// search_for_read_ids latency against file size, querying ids of which half are in the file.
+// The first search on a newly opened file includes loading or building its read id index.
+std::string benchmark_search(std::string const & directory)
+{
+    std::ostringstream json;
+    json << "[";
+    bool first = true;
+    for (std::size_t const read_count : {10'000u, 100'000u, 500'000u}) {
+        for (bool const stored_index : {true, false}) {
+            SyntheticFile file{directory + "/hot_path_search.pod5", read_count, 100, {}, {}};
+            file.options.set_write_read_id_index(stored_index);
+            write_synthetic_file(file);
+
+            static constexpr std::size_t QUERY_COUNT = 1'000;
+            std::mt19937 rng(read_count + 1);
+            auto uuid_gen = pod5::UuidRandomGenerator{rng};
+            std::vector<pod5::Uuid> query;
+            for (std::size_t i = 0; i < QUERY_COUNT; ++i) {
+                query.push_back(i % 2 ? uuid_gen() : file.read_ids[rng() % read_count]);
+            }
+            pod5::ReadIdSearchInput const search_input{gsl::make_span(query)};
+
+            auto const reader = open_reader(file.path);
+            std::vector<std::uint32_t> batch_counts(reader->num_read_record_batches());
+            std::vector<std::uint32_t> batch_rows(QUERY_COUNT);
+            auto const search = [&] {
+                auto const start = Clock::now();
+                auto found = reader->search_for_read_ids(
+                    search_input, gsl::make_span(batch_counts), gsl::make_span(batch_rows));
+                check_status(found.status(), "search read ids");
+                return seconds_since(start);
+            };
+
+            auto const first_seconds = search();
+            std::vector<double> warm_seconds;
+            for (std::size_t i = 0; i < 20; ++i) {
+                warm_seconds.push_back(search());
+            }
+
+            json << (first ? "" : ",") << "{\"file_reads\":" << read_count
+                 << ",\"stored_index\":" << (stored_index ? "true" : "false")
+                 << ",\"query_reads\":" << QUERY_COUNT << ",\"first_search_seconds\":"
+                 << first_seconds << ",\"search_seconds\":" << median(warm_seconds) << "}";
+            first = false;
+            std::cerr << "search: " << read_count << " reads, index " << stored_index << " "
+                      << first_seconds << "s first\n";
+        }
+    }
+    json << "]";
+    return json.str();
+}
+
+// Single read extract_samples latency. Cold reads each use a newly opened reader, so no signal
+// batch is cached yet (the OS page cache stays warm), warm reads repeat on one reader.
+std::string benchmark_extract_samples(std::string const & directory)
+{
+    SyntheticFile file{directory + "/hot_path_extract.pod5", 5'000, 40'000, {}, {}};
+    write_synthetic_file(file);
+
+    auto const extract = [&](pod5::FileReader & reader, std::size_t read) {
+        auto batch = reader.read_read_record_batch(read % reader.num_read_record_batches());
+        check_status(batch.status(), "read batch");
+        auto const row = std::int64_t(read % batch->num_rows());
+
+        auto const start = Clock::now();
+        auto signal_rows = batch->get_signal_rows(row);
+        check_status(signal_rows.status(), "find signal rows");
+        auto const rows = gsl::make_span((*signal_rows)->raw_values(), (*signal_rows)->length());
+        auto sample_count = reader.extract_sample_count(rows);
+        check_status(sample_count.status(), "count samples");
+        std::vector<std::int16_t> samples(*sample_count);
+        check_status(reader.extract_samples(rows, gsl::make_span(samples)), "extract samples");
+        return seconds_since(start);
+    };
+
+    static constexpr std::size_t SAMPLE_READS = 50;
+    std::vector<double> cold_seconds;
+    std::vector<double> warm_seconds;
+    auto const warm_reader = open_reader(file.path);
+    for (std::size_t i = 0; i < SAMPLE_READS; ++i) {
+        auto const read = i * 97;
+        auto const cold_reader = open_reader(file.path);
+        cold_seconds.push_back(extract(*cold_reader, read));
+
+        extract(*warm_reader, read);
+        warm_seconds.push_back(extract(*warm_reader, read));
+    }
+
+    std::ostringstream json;
+    json << "{\"samples_per_read\":" << file.samples_per_read
+         << ",\"cold_microseconds\":" << median(cold_seconds) * 1e6
+         << ",\"warm_microseconds\":" << median(warm_seconds) * 1e6 << "}";
+    return json.str();
+}
+
+// AsyncSignalLoader throughput loading every read's samples, against worker count.
+std::string benchmark_signal_loader(std::string const & directory)
+{
+    SyntheticFile file{directory + "/hot_path_loader.pod5", 20'000, 20'000, {}, {}};
+    write_synthetic_file(file);
+
+    std::vector<std::size_t> worker_counts{1, 2, 4, 8};
+    auto const hardware_workers = std::max(1u, std::thread::hardware_concurrency());
+    if (hardware_workers > worker_counts.back()) {
+        worker_counts.push_back(hardware_workers);
+    }
+
+    std::ostringstream json;
+    json << "[";
+    bool first = true;
+    for (auto const worker_count : worker_counts) {
+        auto const reader = open_reader(file.path);
+        auto const start = Clock::now();
+        pod5::AsyncSignalLoader loader(
+            reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, worker_count);
+        std::size_t reads = 0;
+        while (true) {
+            auto batch = loader.release_next_batch();
+            check_status(batch.status(), "load batch");
+            if (!*batch) {
+                break;
+            }
+            reads += (*batch)->sample_count().size();
+        }
+        auto const seconds = seconds_since(start);
+
+        json << (first ? "" : ",") << "{\"workers\":" << worker_count << ",\"reads\":" << reads
+             << ",\"seconds\":" << seconds << ",\"reads_per_second\":" << reads / seconds
+             << ",\"samples_per_second\":" << reads * file.samples_per_read / seconds << "}";
+        first = false;
+        std::cerr << "signal loader: " << worker_count << " workers " << seconds << "s\n";
+    }
+    json << "]";
+    return json.str();
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Pass a directory to write the synthetic files to, otherwise they are written here:
+    std::string const directory = argc > 1 ? argv[1] : ".";
+
+    check_status(pod5::register_extension_types(), "register extension types");
+
+    std::cout << "{\"add_complete_read\":" << benchmark_writer(directory)
+              << ",\"search_for_read_ids\":" << benchmark_search(directory)
+              << ",\"extract_samples\":" << benchmark_extract_samples(directory)
+              << ",\"async_signal_loader\":" << benchmark_signal_loader(directory) << "}\n";
+
+    check_status(pod5::unregister_extension_types(), "unregister extension types");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,305 @@
+#include "pod5_format/dataset_reader.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_id_index.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Random single read fetches, by read id with signal, against one file and against a dataset of
+// files, from increasing numbers of concurrent threads. Each fetch looks up the read id, reads
+// the read's table batch and decodes its samples, as a read serving API would.
+//
+// Reports p50/p90/p99/p999 fetch latency and throughput for each combination of memory mapped
+// or regular reads and signal table batch cache size, as a JSON array on stdout.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+pod5::RunInfoData make_run_info()
+{
+    return pod5::RunInfoData(
+        "acquisition_id",
+        1005,
+        4095,
+        -4096,
+        {},
+        "experiment_name",
+        "flow_cell_id",
+        "flow_cell_product_code",
+        "protocol_name",
+        "protocol_run_id",
+        200005,
+        "sample_id",
+        4000,
+        "sequencing_kit",
+        "sequencer_position",
+        "sequencer_position_type",
+        "software",
+        "system_name",
+        "system_type",
+        {});
+}
+
+// Write a file of [read_count] reads of varying length, seeded by [seed].
+void write_test_file(std::string const & path, std::size_t read_count, std::uint32_t seed)
+{
+    auto writer_result = pod5::create_file_writer(path, "random_access_latency_benchmark");
+    check_status(writer_result.status(), "create file");
+    auto writer = std::move(*writer_result);
+
+    auto const run_info = writer->add_run_info(make_run_info());
+    auto const pore_type = writer->add_pore_type("pore_type");
+    auto const end_reason = writer->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    check_status(run_info.status(), "add run info");
+    check_status(pore_type.status(), "add pore type");
+    check_status(end_reason.status(), "add end reason");
+
+    std::mt19937 rng(seed);
+    auto uuid_gen = pod5::UuidRandomGenerator{rng};
+    std::uniform_int_distribution<std::size_t> length(2'000, 60'000);
+    std::uniform_int_distribution<int> sample(300, 700);
+    std::vector<std::int16_t> signal(60'000);
+    std::generate(signal.begin(), signal.end(), [&] { return std::int16_t(sample(rng)); });
+
+    for (std::size_t i = 0; i < read_count; ++i) {
+        pod5::ReadData const read_data{
+            uuid_gen(),
+            std::uint32_t(i),
+            std::uint64_t(i * 60'000),
+            std::uint16_t(i % 512 + 1),
+            1,
+            *pore_type,
+            0.0f,
+            0.1f,
+            200.0f,
+            *end_reason,
+            false,
+            *run_info,
+            0,
+            1.0f,
+            0.0f,
+            1.0f,
+            0.0f,
+            0,
+            0.0f};
+        check_status(
+            writer->add_complete_read(
+                read_data, gsl::make_span(signal).subspan(0, length(rng))),
+            "add read");
+    }
+    check_status(writer->close(), "close file");
+}
+
+// Fetch the read at [row] of read table [batch] in [reader], with its samples, returning the
+// sample count.
+std::size_t fetch_read(pod5::FileReader & reader, std::uint32_t batch, std::uint32_t row)
+{
+    auto read_batch = reader.read_read_record_batch(batch);
+    check_status(read_batch.status(), "read batch");
+    auto signal_rows = read_batch->get_signal_rows(row);
+    check_status(signal_rows.status(), "find signal rows");
+    auto const rows = gsl::make_span((*signal_rows)->raw_values(), (*signal_rows)->length());
+    auto sample_count = reader.extract_sample_count(rows);
+    check_status(sample_count.status(), "count samples");
+    std::vector<std::int16_t> samples(*sample_count);
+    check_status(reader.extract_samples(rows, gsl::make_span(samples)), "extract samples");
+    return samples.size();
+}
+
+struct LatencyResult {
+    std::vector<double> latencies;
+    double wall_seconds;
+};
+
+// Run [fetches_per_thread] fetches of random ids from [read_ids] on each of [thread_count]
+// threads, timing each one.
+template <typename Fetch>
+LatencyResult run_fetches(
+    std::vector<pod5::Uuid> const & read_ids,
+    std::size_t thread_count,
+    std::size_t fetches_per_thread,
+    Fetch const & fetch)
+{
+    std::vector<std::vector<double>> thread_latencies(thread_count);
+    std::vector<std::thread> threads;
+    auto const start = Clock::now();
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::uniform_int_distribution<std::size_t> pick(0, read_ids.size() - 1);
+            auto & latencies = thread_latencies[t];
+            latencies.reserve(fetches_per_thread);
+            for (std::size_t i = 0; i < fetches_per_thread; ++i) {
+                auto const & read_id = read_ids[pick(rng)];
+                auto const fetch_start = Clock::now();
+                fetch(read_id);
+                latencies.push_back(
+                    std::chrono::duration<double>(Clock::now() - fetch_start).count());
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    LatencyResult result{{}, std::chrono::duration<double>(Clock::now() - start).count()};
+    for (auto const & latencies : thread_latencies) {
+        result.latencies.insert(result.latencies.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+double percentile(std::vector<double> const & sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    auto const index = std::min(sorted.size() - 1, std::size_t(fraction * sorted.size()));
+    return sorted[index];
+}
+
+std::string format_result(
+    char const * target,
+    bool mmap,
+    std::size_t cached_batches,
+    std::size_t thread_count,
+    LatencyResult const & result)
+{
+    std::ostringstream json;
+    json << "{\"target\":\"" << target << "\",\"mmap\":" << (mmap ? "true" : "false")
+         << ",\"max_cached_signal_table_batches\":" << cached_batches
+         << ",\"threads\":" << thread_count << ",\"fetches\":" << result.latencies.size()
+         << ",\"p50_us\":" << percentile(result.latencies, 0.5) * 1e6
+         << ",\"p90_us\":" << percentile(result.latencies, 0.9) * 1e6
+         << ",\"p99_us\":" << percentile(result.latencies, 0.99) * 1e6
+         << ",\"p999_us\":" << percentile(result.latencies, 0.999) * 1e6
+         << ",\"fetches_per_second\":" << result.latencies.size() / result.wall_seconds << "}";
+    return json.str();
+}
+
+std::vector<std::string> find_pod5_files(std::string const & directory)
+{
+    std::vector<std::string> paths;
+    for (auto const & entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".pod5") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Pass a directory of pod5 files to benchmark against, otherwise a synthetic dataset is
+    // generated. Single file runs use the first file in the directory.
+    std::string directory = argc > 1 ? argv[1] : "./random_access_latency_benchmark";
+    std::size_t const max_threads = argc > 2 ? std::stoull(argv[2]) : 8;
+    std::size_t const fetches_per_thread = argc > 3 ? std::stoull(argv[3]) : 2'000;
+
+    check_status(pod5::register_extension_types(), "register extension types");
+    if (argc <= 1) {
+        std::filesystem::create_directories(directory);
+        for (std::uint32_t i = 0; i < 4; ++i) {
+            write_test_file(directory + "/file_" + std::to_string(i) + ".pod5", 5'000, i);
+        }
+    }
+    auto const paths = find_pod5_files(directory);
+    if (paths.empty()) {
+        std::cerr << "No pod5 files found in " << directory << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> results;
+    for (bool const mmap : {true, false}) {
+        for (std::size_t const cached_batches :
+             {std::size_t(1),
+              std::size_t(pod5::FileReaderOptions::DEFAULT_MAX_CACHED_SIGNAL_TABLE_BATCHES),
+              std::size_t(64)})
+        {
+            pod5::FileReaderOptions reader_options;
+            reader_options.set_force_disable_file_mapping(!mmap);
+            reader_options.set_max_cached_signal_table_batches(cached_batches);
+
+            for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+                // One file, looked up through its read id index:
+                auto reader = pod5::open_file_reader(paths.front(), reader_options);
+                check_status(reader.status(), "open file");
+                auto file_index = (*reader)->read_id_index();
+                check_status(file_index.status(), "load read id index");
+                auto const & index = **file_index;
+                std::vector<pod5::Uuid> const file_ids(
+                    index.read_ids().begin(), index.read_ids().end());
+
+                auto const file_result =
+                    run_fetches(file_ids, threads, fetches_per_thread, [&](auto const & id) {
+                        auto const entry = index.lower_bound(id);
+                        fetch_read(**reader, index.batch(entry), index.batch_row(entry));
+                    });
+                results.push_back(
+                    format_result("file", mmap, cached_batches, threads, file_result));
+
+                // Every file, looked up through the dataset index:
+                pod5::DatasetReaderOptions dataset_options;
+                dataset_options.set_file_reader_options(reader_options);
+                auto dataset = pod5::open_dataset_reader(paths, dataset_options);
+                check_status(dataset.status(), "open dataset");
+                auto dataset_index = (*dataset)->index();
+                check_status(dataset_index.status(), "build dataset index");
+                auto const dataset_read_ids = (*dataset_index)->reads().read_ids();
+                std::vector<pod5::Uuid> const dataset_ids(
+                    dataset_read_ids.begin(), dataset_read_ids.end());
+
+                auto const dataset_result =
+                    run_fetches(dataset_ids, threads, fetches_per_thread, [&](auto const & id) {
+                        pod5::DatasetReadLocation location;
+                        auto found = (*dataset)->search_for_read_ids(
+                            gsl::make_span(&id, 1), gsl::make_span(&location, 1));
+                        check_status(found.status(), "search dataset");
+                        auto file = (*dataset)->file_reader(location.file);
+                        check_status(file.status(), "open dataset file");
+                        fetch_read(**file, location.batch, location.batch_row);
+                    });
+                results.push_back(
+                    format_result("dataset", mmap, cached_batches, threads, dataset_result));
+
+                std::cerr << (mmap ? "mmap" : "read") << " cache " << cached_batches << " "
+                          << threads << " threads done\n";
+            }
+        }
+    }
+
+    std::cout << "[";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        std::cout << (i ? ",\n" : "") << results[i];
+    }
+    std::cout << "]\n";
+
+    check_status(pod5::unregister_extension_types(), "unregister extension types");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,220 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/signal_table_reader.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+// Random walk, which roughly resembles nanopore signal.
+std::vector<std::int16_t> make_signal(std::mt19937 & rng, std::size_t sample_count)
+{
+    std::normal_distribution<float> step(0.0f, 12.0f);
+
+    std::vector<std::int16_t> signal(sample_count);
+    float value = 500;
+    for (auto & sample : signal) {
+        value = std::min(2000.0f, std::max(0.0f, value + step(rng)));
+        sample = static_cast<std::int16_t>(value);
+    }
+    return signal;
+}
+
+pod5::RunInfoData make_run_info()
+{
+    return pod5::RunInfoData(
+        "acquisition_id",
+        1005,
+        4095,
+        -4096,
+        {},
+        "experiment_name",
+        "flow_cell_id",
+        "flow_cell_product_code",
+        "protocol_name",
+        "protocol_run_id",
+        200005,
+        "sample_id",
+        4000,
+        "sequencing_kit",
+        "sequencer_position",
+        "sequencer_position_type",
+        "software",
+        "system_name",
+        "system_type",
+        {});
+}
+
+// Write a file of [read_count] reads, each split over several signal rows.
+void write_test_file(std::string const & path, std::size_t read_count)
+{
+    pod5::FileWriterOptions options;
+    options.set_max_signal_chunk_size(10'000);
+    auto writer_result = pod5::create_file_writer(path, "signal_cache_scaling_benchmark", options);
+    check_status(writer_result.status(), "create file");
+    auto writer = std::move(*writer_result);
+
+    auto const run_info = writer->add_run_info(make_run_info());
+    auto const pore_type = writer->add_pore_type("pore_type");
+    auto const end_reason = writer->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    check_status(run_info.status(), "add run info");
+    check_status(pore_type.status(), "add pore type");
+    check_status(end_reason.status(), "add end reason");
+
+    std::mt19937 rng(read_count);
+    auto uuid_gen = pod5::UuidRandomGenerator{rng};
+    std::uniform_int_distribution<std::size_t> read_length(20'000, 60'000);
+    for (std::size_t i = 0; i < read_count; ++i) {
+        pod5::ReadData const read_data{
+            uuid_gen(),
+            std::uint32_t(i),
+            std::uint64_t(i * 100'000),
+            std::uint16_t(i % 512 + 1),
+            1,
+            *pore_type,
+            0.0f,
+            0.1f,
+            200.0f,
+            *end_reason,
+            false,
+            *run_info,
+            0,
+            1.0f,
+            0.0f,
+            1.0f,
+            0.0f,
+            0,
+            0.0f};
+        auto const signal = make_signal(rng, read_length(rng));
+        check_status(writer->add_complete_read(read_data, gsl::make_span(signal)), "add read");
+    }
+    check_status(writer->close(), "close file");
+}
+
+std::size_t signal_row_count(pod5::FileReader const & reader)
+{
+    std::size_t rows = 0;
+    for (std::size_t i = 0; i < reader.num_signal_record_batches(); ++i) {
+        auto batch = reader.read_signal_record_batch(i);
+        check_status(batch.status(), "read signal batch");
+        rows += batch->num_rows();
+    }
+    return rows;
+}
+
+// Extract [rows_per_thread] random signal rows on each of [thread_count] threads sharing
+// [reader], returning the rows extracted per second.
+double measure_rows_per_second(
+    pod5::FileReader const & reader,
+    std::size_t row_count,
+    std::size_t thread_count,
+    std::size_t rows_per_thread)
+{
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::uniform_int_distribution<std::uint64_t> row_dist(0, row_count - 1);
+            std::vector<std::int16_t> samples;
+            for (std::size_t i = 0; i < rows_per_thread; ++i) {
+                std::uint64_t const row = row_dist(rng);
+                auto const rows = gsl::make_span(&row, 1);
+                auto sample_count = reader.extract_sample_count(rows);
+                if (!sample_count.ok()) {
+                    failed = true;
+                    return;
+                }
+                samples.resize(*sample_count);
+                if (!reader.extract_samples(rows, gsl::make_span(samples)).ok()) {
+                    failed = true;
+                    return;
+                }
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    if (failed) {
+        std::cerr << "Failed to extract samples\n";
+        std::exit(EXIT_FAILURE);
+    }
+    auto const seconds = std::chrono::duration<double>(end - start).count();
+    return double(thread_count * rows_per_thread) / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Pass a pod5 file to benchmark against, otherwise a synthetic file is generated:
+    std::string path = argc > 1 ? argv[1] : "./signal_cache_scaling_benchmark.pod5";
+    std::size_t const rows_per_thread = argc > 2 ? std::stoull(argv[2]) : 2'000;
+
+    check_status(pod5::register_extension_types(), "register extension types");
+    if (argc <= 1) {
+        write_test_file(path, 5'000);
+    }
+
+    struct CacheMode {
+        char const * name;
+        std::size_t max_cached_batches;
+    };
+    // "hot" caches every batch, so only lookups and decompression are measured. "small" keeps a
+    // handful of batches, so threads constantly load and evict batches.
+    std::vector<CacheMode> const modes{{"hot", 0}, {"small", 4}};
+
+    std::cout << std::setw(8) << "cache" << std::setw(9) << "threads" << std::setw(14) << "rows/s"
+              << std::setw(10) << "speedup"
+              << "\n";
+
+    for (auto const & mode : modes) {
+        pod5::FileReaderOptions options;
+        options.set_max_cached_signal_table_batches(mode.max_cached_batches);
+        auto reader = pod5::open_file_reader(path, options);
+        check_status(reader.status(), "open file");
+
+        // Also warms the cache in the hot mode:
+        auto const row_count = signal_row_count(**reader);
+
+        double single_thread_rate = 0;
+        for (std::size_t thread_count : {1, 2, 4, 8, 16, 32, 64}) {
+            auto const rate =
+                measure_rows_per_second(**reader, row_count, thread_count, rows_per_thread);
+            if (thread_count == 1) {
+                single_thread_rate = rate;
+            }
+            std::cout << std::setw(8) << mode.name << std::setw(9) << thread_count
+                      << std::setw(14) << std::fixed << std::setprecision(0) << rate
+                      << std::setw(10) << std::setprecision(2) << rate / single_thread_rate
+                      << "\n";
+        }
+    }
+
+    check_status(pod5::unregister_extension_types(), "unregister extension types");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include "pod5_format/crc32c.h"
+#include "pod5_format/signal_compression.h"
+
+#include <arrow/memory_pool.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Generate a random walk, which roughly resembles nanopore signal.
+std::vector<std::int16_t> make_signal(std::size_t sample_count)
+{
+    std::mt19937 rng(sample_count);
+    std::normal_distribution<float> step(0.0f, 12.0f);
+
+    std::vector<std::int16_t> signal(sample_count);
+    float value = 500;
+    for (auto & sample : signal) {
+        value = std::min(2000.0f, std::max(0.0f, value + step(rng)));
+        sample = static_cast<std::int16_t>(value);
+    }
+    return signal;
+}
+
+// Decode a row [iterations] times, checking one in [checksum_interval] against its checksum as
+// the signal table reader does (0 checks none).
+double time_decode(
+    std::vector<std::uint8_t> const & compressed,
+    std::uint32_t checksum,
+    std::vector<std::int16_t> & output,
+    std::size_t iterations,
+    std::size_t checksum_interval)
+{
+    pod5::SignalCompressionContext context(arrow::system_memory_pool());
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        if (checksum_interval != 0 && i % checksum_interval == 0
+            && pod5::crc32c(gsl::make_span(compressed)) != checksum)
+        {
+            std::cerr << "Signal does not match its checksum\n";
+            std::exit(EXIT_FAILURE);
+        }
+        auto status =
+            pod5::decompress_signal(gsl::make_span(compressed), context, gsl::make_span(output));
+        if (!status.ok()) {
+            std::cerr << "Failed to decompress signal: " << status.ToString() << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Total samples to decode per measurement, split into as many reads as needed:
+    std::size_t const total_samples = argc > 1 ? std::stoull(argv[1]) : 200'000'000;
+
+    // Throughput of the checksum alone, over a large buffer:
+    {
+        std::vector<std::uint8_t> data(64 * 1024 * 1024, 0x5a);
+        auto const start = std::chrono::steady_clock::now();
+        auto const checksum = pod5::crc32c(gsl::make_span(data));
+        auto const seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "crc32c: " << std::fixed << std::setprecision(2)
+                  << data.size() / seconds / 1e9 << " GB/s (checksum " << std::hex << checksum
+                  << std::dec << ")\n\n";
+    }
+
+    std::cout << std::setw(12) << "samples" << std::setw(14) << "unchecked" << std::setw(14)
+              << "every row" << std::setw(10) << "overhead" << std::setw(14) << "1 in 16"
+              << std::setw(10) << "overhead"
+              << "\n";
+
+    for (std::size_t sample_count : {4'000, 20'000, 102'400, 1'000'000}) {
+        auto const signal = make_signal(sample_count);
+        std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(signal.size()));
+        auto compressed_size = pod5::compress_signal(
+            gsl::make_span(signal), arrow::system_memory_pool(), gsl::make_span(compressed));
+        if (!compressed_size.ok()) {
+            std::cerr << "Failed to compress signal: " << compressed_size.status().ToString()
+                      << "\n";
+            return EXIT_FAILURE;
+        }
+        compressed.resize(*compressed_size);
+        auto const checksum = pod5::crc32c(gsl::make_span(compressed));
+
+        std::vector<std::int16_t> output(signal.size());
+        auto const iterations = std::max<std::size_t>(1, total_samples / sample_count);
+        auto const unchecked_time = time_decode(compressed, checksum, output, iterations, 0);
+        auto const checked_time = time_decode(compressed, checksum, output, iterations, 1);
+        auto const sampled_time = time_decode(compressed, checksum, output, iterations, 16);
+        if (output != signal) {
+            std::cerr << "Decompressed signal does not match input\n";
+            return EXIT_FAILURE;
+        }
+
+        // Report throughput in millions of samples per second, and the cost of checking:
+        auto const decoded_samples = double(sample_count * iterations);
+        auto const overhead = [&](double time) {
+            return (time - unchecked_time) / unchecked_time * 100;
+        };
+        std::cout << std::setw(12) << sample_count << std::fixed << std::setprecision(1)
+                  << std::setw(14) << decoded_samples / unchecked_time / 1e6 << std::setw(14)
+                  << decoded_samples / checked_time / 1e6 << std::setw(9)
+                  << overhead(checked_time) << "%" << std::setw(14)
+                  << decoded_samples / sampled_time / 1e6 << std::setw(9)
+                  << overhead(sampled_time) << "%\n";
+    }
+
+    return EXIT_SUCCESS;
+}
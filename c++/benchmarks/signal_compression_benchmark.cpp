@@ -0,0 +1,260 @@
+#include "pod5_format/signal_compression.h"
+#include "pod5_format/svb16/decode.hpp"
+#include "pod5_format/svb16/encode.hpp"
+
+#include <arrow/memory_pool.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr bool UseDelta = true;
+constexpr bool UseZigzag = true;
+
+struct SignalShape {
+    char const * name;
+    std::function<std::vector<std::int16_t>(std::size_t)> generate;
+};
+
+// Random walk, which roughly resembles nanopore signal.
+std::vector<std::int16_t> make_walk_signal(std::size_t sample_count)
+{
+    std::mt19937 rng(sample_count);
+    std::normal_distribution<float> step(0.0f, 12.0f);
+
+    std::vector<std::int16_t> signal(sample_count);
+    float value = 500;
+    for (auto & sample : signal) {
+        value = std::min(2000.0f, std::max(0.0f, value + step(rng)));
+        sample = static_cast<std::int16_t>(value);
+    }
+    return signal;
+}
+
+// Low noise around a fixed level, like an open pore - almost every delta fits in one byte.
+std::vector<std::int16_t> make_flat_signal(std::size_t sample_count)
+{
+    std::mt19937 rng(sample_count);
+    std::normal_distribution<float> noise(0.0f, 3.0f);
+
+    std::vector<std::int16_t> signal(sample_count);
+    for (auto & sample : signal) {
+        sample = static_cast<std::int16_t>(800 + noise(rng));
+    }
+    return signal;
+}
+
+// Uniformly random samples, the worst case for both svb16 and zstd.
+std::vector<std::int16_t> make_noise_signal(std::size_t sample_count)
+{
+    std::mt19937 rng(sample_count);
+    std::uniform_int_distribution<int> value(-2000, 2000);
+
+    std::vector<std::int16_t> signal(sample_count);
+    for (auto & sample : signal) {
+        sample = static_cast<std::int16_t>(value(rng));
+    }
+    return signal;
+}
+
+using EncodeFn = std::size_t (*)(std::vector<std::int16_t> const &, std::vector<std::uint8_t> &);
+using DecodeFn = std::size_t (*)(std::vector<std::uint8_t> const &, std::vector<std::int16_t> &);
+
+struct Svb16Kernel {
+    char const * name;
+    bool available;
+    EncodeFn encode;
+    DecodeFn decode;
+};
+
+// Wrap an svb16 kernel behind a common signature, so the instruction set can be forced rather
+// than relying on the runtime dispatch in svb16::encode/decode.
+template <auto Encode, auto Decode>
+Svb16Kernel make_kernel(char const * name, bool available)
+{
+    EncodeFn encode = [](std::vector<std::int16_t> const & in, std::vector<std::uint8_t> & out) {
+        auto const keys = out.data();
+        auto const data = keys + svb16_key_length(in.size());
+        auto const end = Encode(in.data(), keys, data, std::uint32_t(in.size()), 0);
+        return std::size_t(end - out.data());
+    };
+    DecodeFn decode = [](std::vector<std::uint8_t> const & in, std::vector<std::int16_t> & out) {
+        auto const key_length = svb16_key_length(out.size());
+        auto const encoded = gsl::make_span(in);
+        auto const end = Decode(
+            gsl::make_span(out), encoded.subspan(0, key_length), encoded.subspan(key_length), 0);
+        return std::size_t(end - encoded.begin());
+    };
+    return {name, available, encode, decode};
+}
+
+std::vector<Svb16Kernel> svb16_kernels()
+{
+    using namespace svb16;
+    using T = std::int16_t;
+    return {
+        make_kernel<
+            &encode_scalar<T, UseDelta, UseZigzag>,
+            &decode_scalar<T, UseDelta, UseZigzag>>("scalar", true),
+#ifdef SVB16_X64
+        make_kernel<&encode_sse<T, UseDelta, UseZigzag>, &decode_sse<T, UseDelta, UseZigzag>>(
+            "sse", has_ssse3() && has_sse4_1()),
+        make_kernel<&encode_avx2<T, UseDelta, UseZigzag>, &decode_avx2<T, UseDelta, UseZigzag>>(
+            "avx2", has_avx2()),
+        make_kernel<
+            &encode_avx512<T, UseDelta, UseZigzag>,
+            &decode_avx512<T, UseDelta, UseZigzag>>("avx512", has_avx512_vbmi2()),
+#endif
+#ifdef SVB16_NEON
+        make_kernel<&encode_neon<T, UseDelta, UseZigzag>, &decode_neon<T, UseDelta, UseZigzag>>(
+            "neon", true),
+#endif
+    };
+}
+
+template <typename Fn>
+double time_iterations(std::size_t iterations, Fn && fn)
+{
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+void check_round_trip(
+    std::vector<std::int16_t> const & expected,
+    std::vector<std::int16_t> const & actual,
+    char const * what)
+{
+    if (expected != actual) {
+        std::cerr << what << " output does not match input\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+// Report one measurement, throughput is relative to the uncompressed int16 signal size.
+void report(
+    char const * shape,
+    std::size_t sample_count,
+    std::string const & stage,
+    std::size_t encoded_size,
+    double total_samples,
+    double seconds)
+{
+    auto const raw_size = double(sample_count * sizeof(std::int16_t));
+    std::cout << std::setw(8) << shape << std::setw(11) << sample_count << std::setw(20) << stage
+              << std::setw(9) << std::fixed << std::setprecision(3) << encoded_size / raw_size
+              << std::setw(12) << std::setprecision(1) << total_samples / seconds / 1e6
+              << std::setw(12) << total_samples * sizeof(std::int16_t) / seconds / 1e6 << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Total samples to process per measurement, split into as many reads as needed:
+    std::size_t const total_samples = argc > 1 ? std::stoull(argv[1]) : 100'000'000;
+
+    std::vector<SignalShape> const shapes{
+        {"walk", make_walk_signal}, {"flat", make_flat_signal}, {"noise", make_noise_signal}};
+    auto const kernels = svb16_kernels();
+
+    std::cout << std::setw(8) << "shape" << std::setw(11) << "samples" << std::setw(20) << "stage"
+              << std::setw(9) << "ratio" << std::setw(12) << "Msamples/s" << std::setw(12)
+              << "MB/s"
+              << "\n";
+
+    pod5::SignalCompressionContext context(arrow::system_memory_pool());
+    for (auto const & shape : shapes) {
+        for (std::size_t sample_count : {4'000, 20'000, 102'400, 1'000'000}) {
+            auto const signal = shape.generate(sample_count);
+            auto const iterations = std::max<std::size_t>(1, total_samples / sample_count);
+            auto const processed_samples = double(sample_count * iterations);
+            std::vector<std::int16_t> decoded(signal.size());
+
+            // The raw svb16 kernels, run directly for each available instruction set:
+            std::vector<std::uint8_t> encoded(
+                svb16_max_encoded_length(signal.size())
+                + svb16::decode_input_buffer_padding_byte_count());
+            for (auto const & kernel : kernels) {
+                if (!kernel.available) {
+                    continue;
+                }
+
+                std::size_t encoded_size = 0;
+                auto const encode_time = time_iterations(
+                    iterations, [&] { encoded_size = kernel.encode(signal, encoded); });
+                auto const decode_time =
+                    time_iterations(iterations, [&] { kernel.decode(encoded, decoded); });
+                check_round_trip(signal, decoded, kernel.name);
+
+                auto const stage = std::string("svb16 ") + kernel.name;
+                report(
+                    shape.name,
+                    sample_count,
+                    stage + " enc",
+                    encoded_size,
+                    processed_samples,
+                    encode_time);
+                report(
+                    shape.name,
+                    sample_count,
+                    stage + " dec",
+                    encoded_size,
+                    processed_samples,
+                    decode_time);
+            }
+
+            // The full svb16 + zstd codec, as used when reading and writing files:
+            std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(signal.size()));
+            std::size_t compressed_size = 0;
+            auto const compress_time = time_iterations(iterations, [&] {
+                auto result = pod5::compress_signal(
+                    gsl::make_span(signal), context, gsl::make_span(compressed));
+                check_status(result.status(), "compress signal");
+                compressed_size = *result;
+            });
+            auto const compressed_span = gsl::make_span(compressed).first(compressed_size);
+            auto const decompress_time = time_iterations(iterations, [&] {
+                check_status(
+                    pod5::decompress_signal(compressed_span, context, gsl::make_span(decoded)),
+                    "decompress signal");
+            });
+            check_round_trip(signal, decoded, "vbz");
+
+            report(
+                shape.name,
+                sample_count,
+                "vbz compress",
+                compressed_size,
+                processed_samples,
+                compress_time);
+            report(
+                shape.name,
+                sample_count,
+                "vbz decompress",
+                compressed_size,
+                processed_samples,
+                decompress_time);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+#include "pod5_format/signal_compression.h"
+
+#include <arrow/memory_pool.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Generate a random walk, which roughly resembles nanopore signal.
+std::vector<std::int16_t> make_signal(std::size_t sample_count)
+{
+    std::mt19937 rng(sample_count);
+    std::normal_distribution<float> step(0.0f, 12.0f);
+
+    std::vector<std::int16_t> signal(sample_count);
+    float value = 500;
+    for (auto & sample : signal) {
+        value = std::min(2000.0f, std::max(0.0f, value + step(rng)));
+        sample = static_cast<std::int16_t>(value);
+    }
+    return signal;
+}
+
+using DecompressFn = pod5::Status (*)(
+    gsl::span<std::uint8_t const> const &,
+    pod5::SignalCompressionContext &,
+    gsl::span<std::int16_t> const &);
+
+double time_decompression(
+    DecompressFn fn,
+    std::vector<std::uint8_t> const & compressed,
+    std::vector<std::int16_t> & output,
+    std::size_t iterations)
+{
+    pod5::SignalCompressionContext context(arrow::system_memory_pool());
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        auto status = fn(gsl::make_span(compressed), context, gsl::make_span(output));
+        if (!status.ok()) {
+            std::cerr << "Failed to decompress signal: " << status.ToString() << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Total samples to decode per measurement, split into as many reads as needed:
+    std::size_t const total_samples = argc > 1 ? std::stoull(argv[1]) : 200'000'000;
+
+    std::cout << std::setw(12) << "samples" << std::setw(14) << "buffered" << std::setw(14)
+              << "streaming" << std::setw(10) << "speedup"
+              << "\n";
+
+    for (std::size_t sample_count : {4'000, 20'000, 102'400, 1'000'000, 10'000'000}) {
+        auto const signal = make_signal(sample_count);
+        std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(signal.size()));
+        auto compressed_size = pod5::compress_signal(
+            gsl::make_span(signal), arrow::system_memory_pool(), gsl::make_span(compressed));
+        if (!compressed_size.ok()) {
+            std::cerr << "Failed to compress signal: " << compressed_size.status().ToString()
+                      << "\n";
+            return EXIT_FAILURE;
+        }
+        compressed.resize(*compressed_size);
+
+        std::vector<std::int16_t> output(signal.size());
+        auto const iterations = std::max<std::size_t>(1, total_samples / sample_count);
+        auto const buffered_time =
+            time_decompression(&pod5::decompress_signal_buffered, compressed, output, iterations);
+        auto const streaming_time =
+            time_decompression(&pod5::decompress_signal_streaming, compressed, output, iterations);
+        if (output != signal) {
+            std::cerr << "Decompressed signal does not match input\n";
+            return EXIT_FAILURE;
+        }
+
+        // Report throughput in millions of samples per second:
+        auto const decoded_samples = double(sample_count * iterations);
+        std::cout << std::setw(12) << sample_count << std::setw(14) << std::fixed
+                  << std::setprecision(1) << decoded_samples / buffered_time / 1e6 << std::setw(14)
+                  << decoded_samples / streaming_time / 1e6 << std::setw(9)
+                  << std::setprecision(2) << buffered_time / streaming_time << "x\n";
+    }
+
+    return EXIT_SUCCESS;
+}
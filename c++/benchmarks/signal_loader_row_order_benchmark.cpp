@@ -0,0 +1,178 @@
+#include "pod5_format/async_signal_loader.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+pod5::RunInfoData make_run_info()
+{
+    return pod5::RunInfoData(
+        "acquisition_id",
+        1005,
+        4095,
+        -4096,
+        {},
+        "experiment_name",
+        "flow_cell_id",
+        "flow_cell_product_code",
+        "protocol_name",
+        "protocol_run_id",
+        200005,
+        "sample_id",
+        4000,
+        "sequencing_kit",
+        "sequencer_position",
+        "sequencer_position_type",
+        "software",
+        "system_name",
+        "system_type",
+        {});
+}
+
+// Write a file of [read_count] reads whose signal is in a different order to the reads, as in
+// files merged from several sources, where the signal of neighbouring reads is far apart.
+void write_merged_file(std::string const & path, std::size_t read_count)
+{
+    pod5::FileWriterOptions options;
+    options.set_signal_table_batch_size(100);
+    options.set_read_table_batch_size(1'000);
+    auto writer_result =
+        pod5::create_file_writer(path, "signal_loader_row_order_benchmark", options);
+    check_status(writer_result.status(), "create file");
+    auto writer = std::move(*writer_result);
+
+    auto const run_info = writer->add_run_info(make_run_info());
+    auto const pore_type = writer->add_pore_type("pore_type");
+    auto const end_reason = writer->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    check_status(run_info.status(), "add run info");
+    check_status(pore_type.status(), "add pore type");
+    check_status(end_reason.status(), "add end reason");
+
+    std::mt19937 rng(read_count);
+    auto uuid_gen = pod5::UuidRandomGenerator{rng};
+    std::vector<std::int16_t> signal(8'000);
+    std::iota(signal.begin(), signal.end(), 0);
+
+    // Write all the signal first, then the reads in a shuffled order:
+    std::vector<pod5::Uuid> read_ids;
+    std::vector<std::vector<std::uint64_t>> signal_rows;
+    for (std::size_t i = 0; i < read_count; ++i) {
+        read_ids.push_back(uuid_gen());
+        auto rows = writer->add_signal(read_ids.back(), gsl::make_span(signal));
+        check_status(rows.status(), "add signal");
+        signal_rows.push_back(std::move(*rows));
+    }
+
+    std::vector<std::size_t> read_order(read_count);
+    std::iota(read_order.begin(), read_order.end(), 0);
+    std::shuffle(read_order.begin(), read_order.end(), rng);
+    for (auto const i : read_order) {
+        pod5::ReadData const read_data{
+            read_ids[i],
+            std::uint32_t(i),
+            std::uint64_t(i * 100'000),
+            std::uint16_t(i % 512 + 1),
+            1,
+            *pore_type,
+            0.0f,
+            0.1f,
+            200.0f,
+            *end_reason,
+            false,
+            *run_info,
+            0,
+            1.0f,
+            0.0f,
+            1.0f,
+            0.0f,
+            0,
+            0.0f};
+        check_status(
+            writer->add_complete_read(read_data, gsl::make_span(signal_rows[i]), signal.size()),
+            "add read");
+    }
+    check_status(writer->close(), "close file");
+}
+
+// Load all the signal in [path] with reads loaded in [row_order], finding the time taken.
+double measure_load(
+    std::string const & path,
+    pod5::AsyncSignalLoader::RowOrder row_order,
+    std::size_t worker_count)
+{
+    auto reader = pod5::open_file_reader(path);
+    check_status(reader.status(), "open file");
+
+    auto const start = std::chrono::steady_clock::now();
+    pod5::AsyncSignalLoader loader(
+        *reader,
+        pod5::AsyncSignalLoader::SamplesMode::Samples,
+        {},
+        {},
+        worker_count,
+        10,
+        pod5::AsyncSignalLoader::DEFAULT_PREFETCH_DISTANCE,
+        pod5::AsyncSignalLoader::NO_PENDING_BYTES_LIMIT,
+        row_order);
+    while (true) {
+        auto batch = loader.release_next_batch();
+        check_status(batch.status(), "load batch");
+        if (!*batch) {
+            break;
+        }
+    }
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Pass a pod5 file to benchmark against, otherwise a synthetic merged file is generated:
+    std::string path = argc > 1 ? argv[1] : "./signal_loader_row_order_benchmark.pod5";
+    std::size_t const worker_count = argc > 2 ? std::stoull(argv[2]) : 4;
+
+    check_status(pod5::register_extension_types(), "register extension types");
+    if (argc <= 1) {
+        write_merged_file(path, 20'000);
+    }
+
+    std::cout << std::setw(14) << "row order" << std::setw(12) << "time (s)"
+              << "\n";
+    for (auto const row_order :
+         {pod5::AsyncSignalLoader::RowOrder::ReadTable,
+          pod5::AsyncSignalLoader::RowOrder::SignalTable})
+    {
+        auto const seconds = measure_load(path, row_order, worker_count);
+        std::cout << std::setw(14)
+                  << (row_order == pod5::AsyncSignalLoader::RowOrder::ReadTable ? "read table"
+                                                                                 : "signal table")
+                  << std::setw(12) << std::fixed << std::setprecision(3) << seconds << "\n";
+    }
+
+    check_status(pod5::unregister_extension_types(), "unregister extension types");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#include "pod5_format/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class PostMode {
+    // Each task wrapped in a std::function before posting, as tasks were posted before
+    // ThreadPoolTask, allocating for captures beyond its small buffer.
+    StdFunction,
+    // Each task posted as a ThreadPoolTask, held inline.
+    Task,
+    // Tasks posted in chunks with post_n().
+    PostN,
+};
+
+// Post [task_count] small tasks to a pool of [worker_count] threads from the calling thread, and
+// return the tasks run per second.
+//
+// Each task captures a shared buffer, [this]-like pointer and size, like the writes posted by
+// AsyncOutputStream::Write.
+double measure_tasks_per_second(PostMode mode, std::size_t worker_count, std::size_t task_count)
+{
+    std::size_t const POST_N_CHUNK = 64;
+
+    auto pool = pod5::make_thread_pool(worker_count);
+    auto const buffer = std::make_shared<std::vector<std::uint8_t>>(64, 1);
+
+    struct Counters {
+        std::atomic<std::size_t> tasks_run{0};
+        std::atomic<std::uint64_t> checksum{0};
+        std::mutex done_mutex;
+        std::condition_variable done_cv;
+    } counters;
+
+    auto const make_task = [&](std::size_t index) {
+        return [buffer, counters = &counters, index, task_count] {
+            counters->checksum += (*buffer)[index % buffer->size()];
+            if (counters->tasks_run.fetch_add(1) + 1 == task_count) {
+                std::lock_guard<std::mutex> l{counters->done_mutex};
+                counters->done_cv.notify_one();
+            }
+        };
+    };
+
+    auto const start = std::chrono::steady_clock::now();
+    if (mode == PostMode::PostN) {
+        for (std::size_t chunk_start = 0; chunk_start < task_count; chunk_start += POST_N_CHUNK) {
+            auto const chunk_end = std::min(chunk_start + POST_N_CHUNK, task_count);
+            std::vector<pod5::ThreadPoolTask> tasks;
+            tasks.reserve(chunk_end - chunk_start);
+            for (std::size_t i = chunk_start; i < chunk_end; ++i) {
+                tasks.emplace_back(make_task(i));
+            }
+            pool->post_n(std::move(tasks));
+        }
+    } else {
+        for (std::size_t i = 0; i < task_count; ++i) {
+            if (mode == PostMode::StdFunction) {
+                pool->post(std::function<void()>(make_task(i)));
+            } else {
+                pool->post(make_task(i));
+            }
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> l{counters.done_mutex};
+        counters.done_cv.wait(l, [&] { return counters.tasks_run >= task_count; });
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    pool->stop_and_drain();
+    auto const seconds = std::chrono::duration<double>(end - start).count();
+    return double(task_count) / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    std::size_t const task_count = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::size_t const repeats = argc > 2 ? std::stoull(argv[2]) : 3;
+
+    std::cout << std::setw(9) << "workers" << std::setw(18) << "std::function/s" << std::setw(14)
+              << "task/s" << std::setw(14) << "post_n/s"
+              << "\n";
+
+    for (std::size_t worker_count : {1, 2, 4, 8}) {
+        std::cout << std::setw(9) << worker_count;
+        for (auto mode : {PostMode::StdFunction, PostMode::Task, PostMode::PostN}) {
+            // The best of several runs, as the pool's threads start cold:
+            double best_rate = 0;
+            for (std::size_t i = 0; i < repeats; ++i) {
+                best_rate =
+                    std::max(best_rate, measure_tasks_per_second(mode, worker_count, task_count));
+            }
+            std::cout << std::setw(mode == PostMode::StdFunction ? 18 : 14) << std::fixed
+                      << std::setprecision(0) << best_rate;
+        }
+        std::cout << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+#include "pod5_format/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Post [tasks_per_strand] tasks to each of [strand_count] strands of a pool of [worker_count]
+// threads, interleaving the strands, and return the tasks run per second.
+//
+// [work_stealing] picks make_work_stealing_thread_pool() over make_thread_pool().
+//
+// Each task does a little work and then posts its strand's next task, like an output stream
+// writing one buffer after another, so every strand keeps a short queue of pending work.
+double measure_tasks_per_second(
+    bool work_stealing,
+    std::size_t worker_count,
+    std::size_t strand_count,
+    std::size_t tasks_per_strand)
+{
+    auto pool = work_stealing ? pod5::make_work_stealing_thread_pool(worker_count)
+                              : pod5::make_thread_pool(worker_count);
+
+    std::vector<std::shared_ptr<pod5::ThreadPoolStrand>> strands;
+    for (std::size_t i = 0; i < strand_count; ++i) {
+        strands.push_back(pool->create_strand());
+    }
+
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    std::size_t strands_done = 0;
+    std::atomic<std::uint64_t> checksum{0};
+
+    // Only touched by tasks on the strand, which never run concurrently:
+    struct StrandState {
+        std::size_t tasks_posted = 0;
+        std::size_t tasks_run = 0;
+        std::uint64_t value = 0;
+    };
+    std::vector<StrandState> states(strand_count);
+
+    std::function<void(std::size_t)> run_task = [&](std::size_t strand) {
+        auto & state = states[strand];
+        // Some work which can't be optimised away, standing in for a small write:
+        for (int i = 0; i < 200; ++i) {
+            state.value = state.value * 6364136223846793005ull + 1442695040888963407ull;
+        }
+
+        state.tasks_run += 1;
+        if (state.tasks_posted < tasks_per_strand) {
+            state.tasks_posted += 1;
+            strands[strand]->post([&, strand] { run_task(strand); });
+        } else if (state.tasks_run == tasks_per_strand) {
+            checksum += state.value;
+            std::lock_guard<std::mutex> l{done_mutex};
+            strands_done += 1;
+            done_cv.notify_one();
+        }
+    };
+
+    auto const start = std::chrono::steady_clock::now();
+    // Several tasks are queued on each strand at once, as writers queue several buffers:
+    std::size_t const queued_per_strand = std::min<std::size_t>(4, tasks_per_strand);
+    for (std::size_t strand = 0; strand < strand_count; ++strand) {
+        states[strand].tasks_posted = queued_per_strand;
+    }
+    for (std::size_t i = 0; i < queued_per_strand; ++i) {
+        for (std::size_t strand = 0; strand < strand_count; ++strand) {
+            strands[strand]->post([&, strand] { run_task(strand); });
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> l{done_mutex};
+        done_cv.wait(l, [&] { return strands_done >= strand_count; });
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    pool->stop_and_drain();
+    auto const seconds = std::chrono::duration<double>(end - start).count();
+    return double(strand_count * tasks_per_strand) / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    std::size_t const tasks_per_strand = argc > 1 ? std::stoull(argv[1]) : 2'000;
+    std::size_t const worker_count =
+        argc > 2 ? std::stoull(argv[2]) : std::max(2u, std::thread::hardware_concurrency());
+
+    std::cout << "workers: " << worker_count << "\n";
+    std::cout << std::setw(9) << "strands" << std::setw(14) << "tasks/s" << std::setw(10)
+              << "relative" << std::setw(18) << "stealing tasks/s" << std::setw(10) << "relative"
+              << "\n";
+
+    double single_strand_rates[2] = {0, 0};
+    for (std::size_t strand_count : {1, 4, 16, 64, 128, 256, 512, 1024}) {
+        std::cout << std::setw(9) << strand_count;
+        for (bool work_stealing : {false, true}) {
+            auto const rate = measure_tasks_per_second(
+                work_stealing, worker_count, strand_count, tasks_per_strand);
+            auto & single_strand_rate = single_strand_rates[work_stealing];
+            if (strand_count == 1) {
+                single_strand_rate = rate;
+            }
+            std::cout << std::setw(work_stealing ? 18 : 14) << std::fixed << std::setprecision(0)
+                      << rate << std::setw(10) << std::setprecision(2)
+                      << rate / single_strand_rate;
+        }
+        std::cout << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,278 @@
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Write path throughput for each output stream and IO mode: the default AsyncOutputStream, with
+// one write in flight or several at their own offsets, and on Linux the LinuxOutputStream with
+// sync or direct IO, across write chunk sizes and with and without flushing on each completed
+// batch.
+//
+// Each run writes the same acquisition like traffic, reads interleaved across many channels
+// with a long tailed spread of read lengths, and reports MB/s written, process CPU seconds per
+// GB written and the latency of the final close, as a JSON array on stdout.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void check_status(pod5::Status const & status, char const * action)
+{
+    if (!status.ok()) {
+        std::cerr << "Failed to " << action << ": " << status.ToString() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+pod5::RunInfoData make_run_info()
+{
+    return pod5::RunInfoData(
+        "acquisition_id",
+        1005,
+        4095,
+        -4096,
+        {},
+        "experiment_name",
+        "flow_cell_id",
+        "flow_cell_product_code",
+        "protocol_name",
+        "protocol_run_id",
+        200005,
+        "sample_id",
+        4000,
+        "sequencing_kit",
+        "sequencer_position",
+        "sequencer_position_type",
+        "software",
+        "system_name",
+        "system_type",
+        {});
+}
+
+// A read as the sequencer would emit it: which channel it came from and how long it is.
+struct SyntheticRead {
+    pod5::Uuid read_id;
+    std::uint16_t channel;
+    std::uint32_t read_number;
+    std::uint64_t start_sample;
+    std::size_t sample_count;
+};
+
+// Reads completing in turn across [channel_count] channels, with log normal lengths around a
+// median of ~20k samples (5s at 4kHz) so short reads and a tail of long ones are mixed.
+std::vector<SyntheticRead> make_traffic(std::size_t read_count, std::uint16_t channel_count)
+{
+    std::mt19937 rng(read_count);
+    auto uuid_gen = pod5::UuidRandomGenerator{rng};
+    std::lognormal_distribution<double> length(std::log(20'000.0), 0.8);
+    std::uniform_int_distribution<std::uint16_t> channel(1, channel_count);
+
+    std::vector<std::uint32_t> read_numbers(channel_count + 1);
+    std::vector<std::uint64_t> start_samples(channel_count + 1);
+    std::vector<SyntheticRead> reads;
+    reads.reserve(read_count);
+    for (std::size_t i = 0; i < read_count; ++i) {
+        auto const read_channel = channel(rng);
+        auto const sample_count = std::clamp<std::size_t>(std::size_t(length(rng)), 500, 1'000'000);
+        reads.push_back(
+            {uuid_gen(),
+             read_channel,
+             read_numbers[read_channel]++,
+             start_samples[read_channel],
+             sample_count});
+        start_samples[read_channel] += sample_count;
+    }
+    return reads;
+}
+
+// Signal stepping between levels plus noise like squiggle data, long enough for any read, so
+// compression costs are representative. Reads take their samples from an offset into it.
+std::vector<std::int16_t> make_signal(std::size_t sample_count)
+{
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, 8.0f);
+    std::uniform_int_distribution<int> level(300, 700);
+    std::vector<std::int16_t> signal(sample_count);
+    int current_level = 0;
+    for (std::size_t i = 0; i < signal.size(); ++i) {
+        if (i % 10 == 0) {
+            current_level = level(rng);
+        }
+        signal[i] = std::int16_t(current_level + noise(rng));
+    }
+    return signal;
+}
+
+struct IoMode {
+    char const * stream;
+    bool use_sync_io;
+    bool use_directio;
+    std::size_t write_chunk_size;
+    bool flush_on_batch_complete;
+    std::size_t max_parallel_writes;
+};
+
+std::vector<IoMode> io_modes()
+{
+    std::vector<IoMode> modes;
+    for (std::size_t const parallel_writes : {1, 4, 16}) {
+        modes.push_back(
+            {"AsyncOutputStream",
+             false,
+             false,
+             pod5::FileWriterOptions::DEFAULT_WRITE_CHUNK_SIZE,
+             pod5::FileWriterOptions::DEFAULT_FLUSH_ON_BATCH_COMPLETE,
+             parallel_writes});
+    }
+#ifdef __linux__
+    // Sync or direct IO selects LinuxOutputStream, the only stream the remaining options apply to:
+    using SyncDirect = std::pair<bool, bool>;
+    for (auto const [sync, direct] : {SyncDirect{true, false}, {false, true}, {true, true}}) {
+        for (std::size_t const chunk_size : {512 * 1024, 2 * 1024 * 1024, 8 * 1024 * 1024}) {
+            for (bool const flush : {true, false}) {
+                modes.push_back(
+                    {"LinuxOutputStream",
+                     sync,
+                     direct,
+                     chunk_size,
+                     flush,
+                     pod5::FileWriterOptions::DEFAULT_MAX_PARALLEL_WRITES});
+            }
+        }
+    }
+#endif
+    return modes;
+}
+
+std::string run_mode(
+    std::string const & path,
+    IoMode const & mode,
+    std::vector<SyntheticRead> const & traffic,
+    std::vector<std::int16_t> const & signal)
+{
+    pod5::FileWriterOptions options;
+    options.set_use_sync_io(mode.use_sync_io);
+    options.set_use_directio(mode.use_directio);
+    options.set_write_chunk_size(mode.write_chunk_size);
+    options.set_flush_on_batch_complete(mode.flush_on_batch_complete);
+    options.set_max_parallel_writes(mode.max_parallel_writes);
+
+    std::filesystem::remove(path);
+    auto const cpu_start = std::clock();
+    auto const start = Clock::now();
+
+    auto writer_result = pod5::create_file_writer(path, "write_io_benchmark", options);
+    check_status(writer_result.status(), "create file");
+    auto writer = std::move(*writer_result);
+    auto const run_info = writer->add_run_info(make_run_info());
+    auto const pore_type = writer->add_pore_type("pore_type");
+    auto const end_reason = writer->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    check_status(run_info.status(), "add run info");
+    check_status(pore_type.status(), "add pore type");
+    check_status(end_reason.status(), "add end reason");
+
+    std::size_t samples = 0;
+    for (auto const & read : traffic) {
+        pod5::ReadData const read_data{
+            read.read_id,
+            read.read_number,
+            read.start_sample,
+            read.channel,
+            1,
+            *pore_type,
+            0.0f,
+            0.1f,
+            200.0f,
+            *end_reason,
+            false,
+            *run_info,
+            0,
+            1.0f,
+            0.0f,
+            1.0f,
+            0.0f,
+            0,
+            0.0f};
+        auto const offset = read.start_sample % (signal.size() - read.sample_count + 1);
+        check_status(
+            writer->add_complete_read(
+                read_data, gsl::make_span(signal).subspan(offset, read.sample_count)),
+            "add read");
+        samples += read.sample_count;
+    }
+
+    auto const close_start = Clock::now();
+    check_status(writer->close(), "close file");
+    auto const end = Clock::now();
+    auto const cpu_seconds = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    auto const seconds = std::chrono::duration<double>(end - start).count();
+    auto const close_seconds = std::chrono::duration<double>(end - close_start).count();
+    auto const file_bytes = std::filesystem::file_size(path);
+    auto const file_gb = file_bytes / 1e9;
+    std::filesystem::remove(path);
+
+    std::ostringstream json;
+    json << "{\"stream\":\"" << mode.stream
+         << "\",\"use_sync_io\":" << (mode.use_sync_io ? "true" : "false")
+         << ",\"use_directio\":" << (mode.use_directio ? "true" : "false")
+         << ",\"write_chunk_size\":" << mode.write_chunk_size
+         << ",\"flush_on_batch_complete\":" << (mode.flush_on_batch_complete ? "true" : "false")
+         << ",\"max_parallel_writes\":" << mode.max_parallel_writes
+         << ",\"reads\":" << traffic.size() << ",\"samples\":" << samples
+         << ",\"file_bytes\":" << file_bytes << ",\"seconds\":" << seconds
+         << ",\"mb_per_second\":" << file_gb * 1e3 / seconds
+         << ",\"cpu_seconds_per_gb\":" << cpu_seconds / file_gb
+         << ",\"close_milliseconds\":" << close_seconds * 1e3 << "}";
+    return json.str();
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    // Pass the directory to write to, so the device under test can be chosen, then optionally
+    // the read and channel counts:
+    std::string const directory = argc > 1 ? argv[1] : ".";
+    std::size_t const read_count = argc > 2 ? std::stoull(argv[2]) : 20'000;
+    auto const channel_count = std::uint16_t(argc > 3 ? std::stoul(argv[3]) : 2'048);
+
+    check_status(pod5::register_extension_types(), "register extension types");
+
+    auto const traffic = make_traffic(read_count, channel_count);
+    auto const longest = std::max_element(
+        traffic.begin(), traffic.end(), [](auto const & a, auto const & b) {
+            return a.sample_count < b.sample_count;
+        });
+    auto const signal = make_signal(longest->sample_count * 2);
+    auto const path = directory + "/write_io_benchmark.pod5";
+
+    std::cout << "[";
+    bool first = true;
+    for (auto const & mode : io_modes()) {
+        auto const result = run_mode(path, mode, traffic, signal);
+        std::cout << (first ? "" : ",\n") << result << std::flush;
+        first = false;
+        std::cerr << mode.stream << " sync " << mode.use_sync_io << " direct "
+                  << mode.use_directio << " chunk " << mode.write_chunk_size << " flush "
+                  << mode.flush_on_batch_complete << " parallel writes "
+                  << mode.max_parallel_writes << " done\n";
+    }
+    std::cout << "]\n";
+
+    check_status(pod5::unregister_extension_types(), "unregister extension types");
+    return EXIT_SUCCESS;
+}
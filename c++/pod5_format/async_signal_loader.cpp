@@ -1,8 +1,104 @@
 #include "pod5_format/async_signal_loader.h"
 
+#include "pod5_format/internal/concurrency_tuner.h"
+#include "pod5_format/signal_compression.h"
+
+#include <algorithm>
+#include <exception>
+#include <numeric>
+
 namespace pod5 {
 
-std::size_t const AsyncSignalLoader::MINIMUM_JOB_SIZE = 50;
+std::uint64_t const AsyncSignalLoader::MINIMUM_JOB_SAMPLES = 1'000'000;
+
+namespace {
+std::uint64_t steady_clock_ns()
+{
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count());
+}
+}  // namespace
+
+SampleBufferPool::SampleBufferPool(std::size_t max_buffer_count)
+: m_max_buffer_count(max_buffer_count)
+{
+}
+
+std::vector<std::int16_t> SampleBufferPool::acquire(std::size_t sample_count)
+{
+    std::vector<std::int16_t> buffer;
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        auto it = m_buffers.lower_bound(sample_count);
+        if (it != m_buffers.end()) {
+            buffer = std::move(it->second);
+            m_buffers.erase(it);
+        }
+    }
+    buffer.resize(sample_count);
+    return buffer;
+}
+
+void SampleBufferPool::release(std::vector<std::int16_t> && buffer)
+{
+    if (buffer.capacity() == 0) {
+        return;
+    }
+
+    buffer.clear();
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_buffers.emplace(buffer.capacity(), std::move(buffer));
+    // Keep the largest buffers, which can hold any batch the smaller ones could:
+    if (m_buffers.size() > m_max_buffer_count) {
+        m_buffers.erase(m_buffers.begin());
+    }
+}
+
+std::size_t SampleBufferPool::buffer_count() const
+{
+    std::lock_guard<std::mutex> l(m_mutex);
+    return m_buffers.size();
+}
+
+CachedBatchSignalData::CachedBatchSignalData(
+    std::uint32_t batch_index,
+    std::vector<std::uint64_t> && sample_counts,
+    std::shared_ptr<SampleBufferPool> buffer_pool)
+: m_batch_index(batch_index)
+, m_sample_counts(std::move(sample_counts))
+, m_sample_offsets(m_sample_counts.size() + 1, 0)
+, m_buffer_pool(std::move(buffer_pool))
+{
+    std::partial_sum(
+        m_sample_counts.begin(), m_sample_counts.end(), m_sample_offsets.begin() + 1);
+    if (m_buffer_pool) {
+        m_samples = m_buffer_pool->acquire(m_sample_offsets.back());
+    }
+}
+
+CachedBatchSignalData::~CachedBatchSignalData()
+{
+    if (m_buffer_pool) {
+        m_buffer_pool->release(std::move(m_samples));
+    }
+}
+
+gsl::span<std::int16_t const> CachedBatchSignalData::samples(std::size_t row) const
+{
+    if (m_samples.empty()) {
+        return {};
+    }
+    return all_samples().subspan(m_sample_offsets[row], m_sample_counts[row]);
+}
+
+gsl::span<std::int16_t> CachedBatchSignalData::mutable_samples(std::size_t row)
+{
+    if (m_samples.empty()) {
+        return {};
+    }
+    return gsl::make_span(m_samples).subspan(m_sample_offsets[row], m_sample_counts[row]);
+}
 
 AsyncSignalLoader::AsyncSignalLoader(
     std::shared_ptr<pod5::FileReader> const & reader,
@@ -10,34 +106,94 @@ AsyncSignalLoader::AsyncSignalLoader(
     gsl::span<std::uint32_t const> const & batch_counts,
     gsl::span<std::uint32_t const> const & batch_rows,
     std::size_t worker_count,
-    std::size_t max_pending_batches)
+    std::size_t max_pending_batches,
+    std::size_t prefetch_distance,
+    std::uint64_t max_pending_bytes,
+    RowOrder row_order,
+    bool adaptive_worker_count)
+: AsyncSignalLoader(
+    reader,
+    samples_mode,
+    batch_counts,
+    batch_rows,
+    nullptr,
+    worker_count,
+    max_pending_batches,
+    prefetch_distance,
+    max_pending_bytes,
+    row_order,
+    std::nullopt,
+    adaptive_worker_count)
+{
+}
+
+AsyncSignalLoader::AsyncSignalLoader(
+    std::shared_ptr<pod5::FileReader> const & reader,
+    SamplesMode samples_mode,
+    gsl::span<std::uint32_t const> const & batch_counts,
+    gsl::span<std::uint32_t const> const & batch_rows,
+    std::shared_ptr<ThreadPool> thread_pool,
+    std::size_t max_concurrent_tasks,
+    std::size_t max_pending_batches,
+    std::size_t prefetch_distance,
+    std::uint64_t max_pending_bytes,
+    RowOrder row_order,
+    std::optional<std::size_t> worker_group,
+    bool adaptive_worker_count)
 : m_reader(reader)
 , m_samples_mode(samples_mode)
+, m_row_order(row_order)
 , m_max_pending_batches(max_pending_batches)
+, m_max_pending_bytes(max_pending_bytes)
 , m_reads_batch_count(m_reader->num_read_record_batches())
 , m_batch_counts(batch_counts)
-, m_total_batch_count_so_far(0)
 , m_batch_rows(batch_rows)
-, m_worker_job_size(std::max<std::size_t>(
-      MINIMUM_JOB_SIZE,
-      m_batch_rows.size() / (m_reads_batch_count * worker_count * 2)))
+, m_max_concurrent_tasks(std::max<std::size_t>(max_concurrent_tasks, 1))
 , m_current_batch(0)
+, m_next_staged_batch(0)
+, m_next_staged_batch_rows_offset(0)
+, m_prefetch_distance(prefetch_distance)
+, m_next_prefetch_batch(0)
+, m_next_prefetch_batch_rows_offset(0)
 , m_finished(false)
 , m_has_error(false)
 , m_batches_size(0)
+, m_pending_bytes(0)
+, m_sample_buffers(
+      samples_mode == SamplesMode::Samples
+          ? std::make_shared<SampleBufferPool>(max_pending_batches + 2)
+          : nullptr)
+, m_thread_pool(std::move(thread_pool))
+, m_worker_group(worker_group)
+, m_active_tasks(0)
+, m_parked_tasks(0)
+, m_parked_time_sum_ns(0)
+, m_concurrency_tuner(
+      adaptive_worker_count
+          ? std::make_unique<internal::ConcurrencyTuner>(1, m_max_concurrent_tasks)
+          : nullptr)
 {
     // Setup first batch:
     {
         std::unique_lock<std::mutex> l(m_worker_sync);
-        auto setup_result = setup_next_in_progress_batch(l);
-        if (!setup_result.ok()) {
-            set_error(setup_result);
+        auto start_result = start_staged_batch(l);
+        if (!start_result.ok()) {
+            set_error(start_result);
         }
     }
 
-    // Kick off workers on jobs:
-    for (std::size_t i = 0; i < worker_count; ++i) {
-        m_workers.emplace_back([&] { run_worker(); });
+    // Kick off workers on jobs, threads past the worker count wait for it to grow:
+    if (m_thread_pool) {
+        auto const task_count = worker_count();
+        {
+            std::lock_guard<std::mutex> l(m_pool_sync);
+            m_active_tasks += task_count;
+        }
+        post_pool_tasks(task_count);
+    } else {
+        for (std::size_t i = 0; i < max_concurrent_tasks; ++i) {
+            m_workers.emplace_back([this, i] { run_worker(i); });
+        }
     }
 }
 
@@ -48,6 +204,10 @@ AsyncSignalLoader::~AsyncSignalLoader()
     for (std::size_t i = 0; i < m_workers.size(); ++i) {
         m_workers[i].join();
     }
+
+    // Parked tasks are never queued again, so only wait for active ones:
+    std::unique_lock<std::mutex> l(m_pool_sync);
+    m_pool_tasks_done.wait(l, [&] { return m_active_tasks == 0; });
 }
 
 Result<std::unique_ptr<CachedBatchSignalData>> AsyncSignalLoader::release_next_batch(
@@ -95,13 +255,75 @@ Result<std::unique_ptr<CachedBatchSignalData>> AsyncSignalLoader::release_next_b
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
 
-        return batch->release_data();
+        return take_batch_data(batch);
+    }
+
+    // No more data - return null.
+    return nullptr;
+}
+
+Result<std::unique_ptr<CachedBatchSignalData>> AsyncSignalLoader::release_next_completed_batch(
+    std::optional<std::chrono::steady_clock::time_point> timeout)
+{
+    while (true) {
+        // Return any error, if one has occurred:
+        if (m_has_error) {
+            return error();
+        }
+
+        std::shared_ptr<SignalCacheWorkPackage> batch;
+        {
+            std::unique_lock<std::mutex> l(m_batches_sync);
+            auto const find_completed_batch = [&] {
+                return std::find_if(m_batches.begin(), m_batches.end(), [](auto const & batch) {
+                    return batch->is_complete();
+                });
+            };
+
+            // Wait until any batch has finished loading (workers notify as each completes):
+            auto const wait_end =
+                timeout.value_or(std::chrono::steady_clock::now() + std::chrono::seconds(5));
+            m_batch_done.wait_until(l, wait_end, [&] {
+                return find_completed_batch() != m_batches.end()
+                       || (m_finished && m_batches.empty()) || m_has_error;
+            });
+
+            auto const completed_batch = find_completed_batch();
+            if (completed_batch != m_batches.end()) {
+                batch = std::move(*completed_batch);
+                m_batches.erase(completed_batch);
+                m_batches_size -= 1;
+            } else if (m_finished && m_batches.empty()) {
+                break;
+            }
+        }
+
+        if (batch) {
+            return take_batch_data(batch);
+        }
+
+        if (timeout && std::chrono::steady_clock::now() > *timeout) {
+            return nullptr;
+        }
+    }
+
+    // Return any error, if one has occurred during our wait:
+    if (m_has_error) {
+        return error();
     }
 
     // No more data - return null.
     return nullptr;
 }
 
+std::unique_ptr<CachedBatchSignalData> AsyncSignalLoader::take_batch_data(
+    std::shared_ptr<SignalCacheWorkPackage> const & batch)
+{
+    m_pending_bytes -= batch->decoded_bytes();
+    resume_parked_tasks();
+    return batch->release_data();
+}
+
 void AsyncSignalLoader::set_error(pod5::Status status)
 {
     assert(!status.ok());
@@ -118,133 +340,563 @@ pod5::Status AsyncSignalLoader::error() const
     return m_error;
 }
 
-void AsyncSignalLoader::run_worker()
+std::size_t AsyncSignalLoader::worker_count() const
+{
+    return m_concurrency_tuner ? m_concurrency_tuner->concurrency() : m_max_concurrent_tasks;
+}
+
+bool AsyncSignalLoader::over_pending_limits() const
 {
+    if (m_batches_size > m_max_pending_batches) {
+        return true;
+    }
+
+    // Only hold back while a pending batch can be taken to free bytes, the in progress batch is
+    // never released otherwise:
+    return m_max_pending_bytes != NO_PENDING_BYTES_LIMIT && m_batches_size > 0
+           && m_pending_bytes >= m_max_pending_bytes;
+}
+
+void AsyncSignalLoader::run_worker(std::size_t worker_index)
+{
+    // Each worker reuses its own decompression state across all the rows it processes:
+    SignalCompressionContext compression_context;
+
+    std::shared_ptr<SignalCacheWorkPackage> batch;
+
     // Continue to work while there is work to do, and no error has occurred
     while (!m_finished && !m_has_error) {
-        std::shared_ptr<SignalCacheWorkPackage> batch;
-        std::uint32_t row_start = 0;
+        if (worker_index >= worker_count()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
 
-        // Try to secure some new work:
-        {
-            std::unique_lock<std::mutex> l(m_worker_sync);
-            // If we have run out of batches to process, release anything in progress and return:
-            if (m_current_batch >= m_reads_batch_count) {
-                release_in_progress_batch();
-                break;
+        auto const result = run_job(compression_context, batch);
+        if (result == JobResult::Finished) {
+            break;
+        }
+        if (result == JobResult::Blocked) {
+            auto const blocked_start = std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (m_concurrency_tuner) {
+                m_concurrency_tuner->add_stall(std::chrono::steady_clock::now() - blocked_start);
             }
+        }
+    }
+}
 
-            // If we have more batches than asked for complete that have
-            // not been queried, wait for it to get taken:
-            if (m_batches_size > m_max_pending_batches) {
-                l.unlock();
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                continue;
-            }
+AsyncSignalLoader::JobResult AsyncSignalLoader::run_job(
+    SignalCompressionContext & compression_context,
+    std::shared_ptr<SignalCacheWorkPackage> & batch)
+{
+    // If we have more batches or bytes than asked for complete that have
+    // not been queried, wait for them to get taken:
+    if (over_pending_limits()) {
+        return JobResult::Blocked;
+    }
 
-            // Now, if we have no work left in the current batch, release that:
-            if (!m_in_progress_batch->has_work_left()) {
-                if (!m_batch_counts.empty()) {
-                    m_total_batch_count_so_far += m_batch_counts[m_current_batch];
+    // Jobs are claimed from the worker's batch without locking, the lock is only taken to move
+    // on to another batch:
+    std::uint32_t job_index = batch ? batch->start_job() : 0;
+    if (!batch || job_index >= batch->job_count()) {
+        {
+            std::unique_lock<std::mutex> l(m_worker_sync);
+            while (true) {
+                // If we have run out of batches to process, release anything in progress and
+                // return:
+                if (m_current_batch >= m_reads_batch_count) {
+                    release_in_progress_batch();
+                    return JobResult::Finished;
+                }
+                // Only after an error starting the batch:
+                if (!m_in_progress_batch) {
+                    return JobResult::Finished;
                 }
 
-                // Release the current batch:
+                // Another worker may have moved on to a batch with rows left already:
+                if (m_in_progress_batch != batch) {
+                    batch = m_in_progress_batch;
+                    job_index = batch->start_job();
+                    if (job_index < batch->job_count()) {
+                        break;
+                    }
+                }
+
+                // Now there is no work left in the current batch, release that:
                 release_in_progress_batch();
 
-                // Then try to setup the next batch, if one exists:
+                // Then start the next batch, if one exists:
                 m_current_batch += 1;
                 if (m_current_batch >= m_reads_batch_count) {
                     // No more work to do.
                     m_finished = true;
-                    break;
+                    return JobResult::Finished;
                 }
 
-                auto setup_result = setup_next_in_progress_batch(l);
-                if (!setup_result.ok()) {
-                    set_error(setup_result);
-                    return;
+                auto start_result = start_staged_batch(l);
+                if (!start_result.ok()) {
+                    set_error(start_result);
+                    return JobResult::Finished;
                 }
             }
+        }
 
-            // Finally, tell the work package we have secured we are starting to do some work:
-            batch = m_in_progress_batch;
-            row_start = m_in_progress_batch->start_rows(l, m_worker_job_size);
+        // Make the batch after the one started, so the next move is only a hand over:
+        stage_next_batch();
+    }
+
+    // Now execute the work, for all the rows we said we would:
+    auto const & job = batch->job(job_index);
+    do_work(batch, job, compression_context);
+
+    // And report the work completed for anyone waiting:
+    batch->complete_job();
+    if (batch->is_complete()) {
+        std::lock_guard<std::mutex> l(m_batches_sync);
+        m_batch_done.notify_all();
+    }
+
+    if (m_concurrency_tuner) {
+        // Without samples only reads are loaded, so throughput is counted in reads:
+        m_concurrency_tuner->add_work(
+            m_samples_mode == SamplesMode::Samples ? job.sample_count
+                                                   : job.position_end - job.position_begin);
+        tune_worker_count();
+    }
+    return JobResult::Worked;
+}
+
+void AsyncSignalLoader::run_pool_task(std::shared_ptr<SignalCacheWorkPackage> batch)
+{
+    auto result = JobResult::Finished;
+    if (!m_finished && !m_has_error) {
+        result = run_job(thread_local_signal_compression_context(), batch);
+    }
+
+    {
+        std::lock_guard<std::mutex> l(m_pool_sync);
+        // Park rather than spin while over the limit, release_next_batch() queues the task
+        // again. Checked under the lock, so a release can't be missed between a check and here:
+        if (result == JobResult::Blocked && over_pending_limits() && !m_finished) {
+            m_parked_tasks += 1;
+            m_parked_time_sum_ns += steady_clock_ns();
+            result = JobResult::Finished;
+        }
+        // Tasks past the worker count end, tune_worker_count() queues more as it grows:
+        if (result == JobResult::Worked && m_active_tasks + m_parked_tasks > worker_count()) {
+            result = JobResult::Finished;
+        }
+        if (result == JobResult::Finished) {
+            m_active_tasks -= 1;
+            if (m_active_tasks == 0) {
+                m_pool_tasks_done.notify_all();
+            }
+            return;
         }
+    }
 
-        // Now execute the work, for all the rows we said we would:
-        std::uint32_t const row_end =
-            std::min(row_start + m_worker_job_size, batch->job_row_count());
+    // Queue the next job behind other work on the pool, so loaders sharing it take turns:
+    post_pool_task(std::move(batch));
+}
 
-        do_work(batch, row_start, row_end);
+bool AsyncSignalLoader::post_pool_task(std::shared_ptr<SignalCacheWorkPackage> batch)
+{
+    try {
+        auto task = [this, batch = std::move(batch)] { run_pool_task(batch); };
+        if (m_worker_group) {
+            m_thread_pool->post_to_group(std::move(task), *m_worker_group);
+        } else {
+            m_thread_pool->post(std::move(task));
+        }
+        return true;
+    } catch (std::exception const & e) {
+        // The pool throws once stopped:
+        set_error(Status::Invalid("Failed to queue signal loading: ", e.what()));
+    }
 
-        // And report the work completed for anyone waiting:
-        batch->complete_rows(m_worker_job_size);
+    std::lock_guard<std::mutex> l(m_pool_sync);
+    m_active_tasks -= 1;
+    if (m_active_tasks == 0) {
+        m_pool_tasks_done.notify_all();
     }
+    m_batch_done.notify_all();
+    return false;
+}
+
+void AsyncSignalLoader::resume_parked_tasks()
+{
+    if (!m_thread_pool) {
+        return;
+    }
+
+    std::size_t resumed_tasks = 0;
+    {
+        std::lock_guard<std::mutex> l(m_pool_sync);
+        if (m_finished) {
+            return;
+        }
+        resumed_tasks = m_parked_tasks;
+        m_parked_tasks = 0;
+        m_active_tasks += resumed_tasks;
+
+        auto const parked_time_ns = resumed_tasks * steady_clock_ns() - m_parked_time_sum_ns;
+        m_parked_time_sum_ns = 0;
+        if (m_concurrency_tuner) {
+            m_concurrency_tuner->add_stall(std::chrono::nanoseconds(parked_time_ns));
+        }
+    }
+    post_pool_tasks(resumed_tasks);
+}
+
+void AsyncSignalLoader::post_pool_tasks(std::size_t task_count)
+{
+    for (std::size_t i = 0; i < task_count; ++i) {
+        if (!post_pool_task()) {
+            // The pool is stopped, so the rest can't be queued either:
+            std::lock_guard<std::mutex> l(m_pool_sync);
+            m_active_tasks -= task_count - i - 1;
+            if (m_active_tasks == 0) {
+                m_pool_tasks_done.notify_all();
+            }
+            return;
+        }
+    }
+}
+
+void AsyncSignalLoader::tune_worker_count()
+{
+    // Threads past the worker count wait for it to grow, pool tasks are queued to match it:
+    if (!m_concurrency_tuner->update() || !m_thread_pool) {
+        return;
+    }
+
+    std::size_t added_tasks = 0;
+    {
+        std::lock_guard<std::mutex> l(m_pool_sync);
+        auto const task_count = m_active_tasks + m_parked_tasks;
+        if (m_finished || task_count >= worker_count()) {
+            return;
+        }
+        added_tasks = worker_count() - task_count;
+        m_active_tasks += added_tasks;
+    }
+    post_pool_tasks(added_tasks);
 }
 
 void AsyncSignalLoader::do_work(
     std::shared_ptr<SignalCacheWorkPackage> const & batch,
-    std::uint32_t row_start,
-    std::uint32_t row_end)
+    SignalCacheWorkPackage::Job const & job,
+    SignalCompressionContext & compression_context)
 {
-    // First secure the sample counts column for the batch we are processing:
-    auto signal_column = batch->read_batch().signal_column();
+    // Sample counts are found when the batch is setup, so only samples are left to load:
+    if (m_samples_mode != SamplesMode::Samples) {
+        return;
+    }
 
-    // And record where we are starting in the batch rows array, if it exists:
-    for (std::uint32_t i = row_start; i < row_end; ++i) {
+    auto signal_column = batch->read_batch().signal_column();
+    for (std::uint32_t position = job.position_begin; position < job.position_end; ++position) {
+        auto const i = batch->get_job_row_at(position);
         // Find the actual batch row to query - we may be working on a subset of batch data:
         auto const actual_batch_row = batch->get_batch_row_to_query(i);
         // Get the signal row data for the read:
         auto const signal_rows = std::static_pointer_cast<arrow::UInt64Array>(
             signal_column->value_slice(actual_batch_row));
-        auto const signal_rows_span =
-            gsl::make_span(signal_rows->raw_values(), signal_rows->length());
+        auto signal_rows_span = gsl::make_span(signal_rows->raw_values(), signal_rows->length());
+        auto samples = batch->mutable_samples(i);
+        // Part of a long read only loads some of its signal rows, to their place in its samples:
+        if (job.is_part_of_read()) {
+            signal_rows_span = signal_rows_span.subspan(
+                job.signal_row_begin, job.signal_row_end - job.signal_row_begin);
+            samples = samples.subspan(job.sample_offset);
+        }
 
-        // Find the sample count for these rows:
-        auto sample_count_result = m_reader->extract_sample_count(signal_rows_span);
-        if (!sample_count_result.ok()) {
-            set_error(sample_count_result.status());
+        // Decode the samples straight into the batch's storage for the row:
+        auto samples_result =
+            m_reader->extract_samples(signal_rows_span, samples, compression_context);
+        if (!samples_result.ok()) {
+            set_error(std::move(samples_result));
             return;
         }
-        std::uint64_t sample_count = *sample_count_result;
-
-        // And query the samples if that has been requested:
-        std::vector<std::int16_t> samples;
-        if (m_samples_mode == SamplesMode::Samples) {
-            samples.resize(sample_count);
-            auto samples_result =
-                m_reader->extract_samples(signal_rows_span, gsl::make_span(samples));
-            if (!samples_result.ok()) {
-                set_error(std::move(samples_result));
-                return;
-            }
-            sample_count = samples.size();
-        }
-
-        // Store the queried data into the batch:
-        batch->set_samples(i, sample_count, std::move(samples));
     }
 }
 
-Status AsyncSignalLoader::setup_next_in_progress_batch(std::unique_lock<std::mutex> & lock)
+Result<std::shared_ptr<SignalCacheWorkPackage>> AsyncSignalLoader::make_batch(
+    std::uint32_t batch_index,
+    std::size_t batch_rows_offset) const
 {
-    assert(!m_in_progress_batch);
-    ARROW_ASSIGN_OR_RAISE(auto read_batch, m_reader->read_read_record_batch(m_current_batch));
+    ARROW_ASSIGN_OR_RAISE(auto read_batch, m_reader->read_read_record_batch(batch_index));
     std::size_t row_count = read_batch.num_rows();
 
     gsl::span<std::uint32_t const> next_specific_batch_rows;
     if (!m_batch_counts.empty()) {
-        row_count = m_batch_counts[m_current_batch];
+        row_count = m_batch_counts[batch_index];
         if (!m_batch_rows.empty()) {
-            next_specific_batch_rows = m_batch_rows.subspan(m_total_batch_count_so_far, row_count);
+            next_specific_batch_rows = m_batch_rows.subspan(batch_rows_offset, row_count);
         }
     }
 
-    m_in_progress_batch = std::make_shared<SignalCacheWorkPackage>(
-        m_current_batch, row_count, next_specific_batch_rows, std::move(read_batch));
+    // Load all the batch's signal up front, so the reads are in flight together rather than
+    // one at a time as workers reach each read. Any real problem is reported finding the sample
+    // counts below:
+    auto signal_rows = batch_signal_rows(read_batch, row_count, next_specific_batch_rows);
+    if (signal_rows.ok() && !signal_rows->empty()) {
+        (void)m_reader->load_signal_rows(*signal_rows);
+    }
+
+    std::vector<std::uint32_t> job_row_order;
+    if (m_row_order == RowOrder::SignalTable) {
+        ARROW_ASSIGN_OR_RAISE(
+            job_row_order,
+            batch_signal_table_order(read_batch, row_count, next_specific_batch_rows));
+    }
+
+    // Size the batch's sample storage up front, so workers decode into one buffer:
+    ARROW_ASSIGN_OR_RAISE(
+        auto sample_counts,
+        batch_sample_counts(
+            read_batch, row_count, next_specific_batch_rows, gsl::make_span(job_row_order)));
+    ARROW_ASSIGN_OR_RAISE(
+        auto jobs,
+        batch_jobs(
+            read_batch, next_specific_batch_rows, gsl::make_span(job_row_order), sample_counts));
+    auto cached_data = std::make_unique<CachedBatchSignalData>(
+        batch_index, std::move(sample_counts), m_sample_buffers);
+    return std::make_shared<SignalCacheWorkPackage>(
+        row_count,
+        next_specific_batch_rows,
+        std::move(cached_data),
+        std::move(read_batch),
+        std::move(jobs),
+        std::move(job_row_order));
+}
+
+void AsyncSignalLoader::stage_next_batch()
+{
+    std::unique_lock<std::mutex> l(m_staging_sync, std::try_to_lock);
+    if (!l.owns_lock() || m_staged_batch || m_next_staged_batch >= m_reads_batch_count) {
+        return;
+    }
+    stage_next_batch(l);
+}
+
+void AsyncSignalLoader::stage_next_batch(std::unique_lock<std::mutex> & lock)
+{
+    assert(lock.owns_lock());
+    assert(!m_staged_batch);
+    m_staged_batch = make_batch(m_next_staged_batch, m_next_staged_batch_rows_offset);
+    prefetch_upcoming_batches(lock);
+
+    if (!m_batch_counts.empty()) {
+        m_next_staged_batch_rows_offset += m_batch_counts[m_next_staged_batch];
+    }
+    m_next_staged_batch += 1;
+}
+
+Status AsyncSignalLoader::start_staged_batch(std::unique_lock<std::mutex> & lock)
+{
+    assert(lock.owns_lock());
+    assert(!m_in_progress_batch);
+    std::unique_lock<std::mutex> staging_lock(m_staging_sync);
+    // Workers only stage ahead once a batch is started, so the first is made here:
+    if (!m_staged_batch) {
+        stage_next_batch(staging_lock);
+    }
+    auto staged_batch = std::move(*m_staged_batch);
+    m_staged_batch.reset();
+    staging_lock.unlock();
+
+    ARROW_ASSIGN_OR_RAISE(m_in_progress_batch, std::move(staged_batch));
+    m_pending_bytes += m_in_progress_batch->decoded_bytes();
     return Status::OK();
 }
 
+void AsyncSignalLoader::prefetch_upcoming_batches(std::unique_lock<std::mutex> & lock)
+{
+    assert(lock.owns_lock());
+    if (m_prefetch_distance == 0) {
+        return;
+    }
+
+    // The batch being staged starts after the current batch:
+    auto const prefetch_end =
+        std::min<std::size_t>(m_reads_batch_count, m_next_staged_batch + m_prefetch_distance);
+    for (; m_next_prefetch_batch < prefetch_end; ++m_next_prefetch_batch) {
+        auto const batch_rows_offset = m_next_prefetch_batch_rows_offset;
+        if (!m_batch_counts.empty()) {
+            m_next_prefetch_batch_rows_offset += m_batch_counts[m_next_prefetch_batch];
+        }
+
+        // Prefetching is only a hint - any real problem is reported when the batch is loaded:
+        (void)prefetch_batch_signal(m_next_prefetch_batch, batch_rows_offset);
+    }
+}
+
+Status AsyncSignalLoader::prefetch_batch_signal(
+    std::uint32_t batch_index,
+    std::size_t batch_rows_offset)
+{
+    gsl::span<std::uint32_t const> specific_batch_rows;
+    std::size_t row_count = 0;
+    if (!m_batch_counts.empty()) {
+        row_count = m_batch_counts[batch_index];
+        if (row_count == 0) {
+            return Status::OK();
+        }
+        if (!m_batch_rows.empty()) {
+            specific_batch_rows = m_batch_rows.subspan(batch_rows_offset, row_count);
+        }
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto read_batch, m_reader->read_read_record_batch(batch_index));
+    if (m_batch_counts.empty()) {
+        row_count = read_batch.num_rows();
+    }
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto const signal_rows, batch_signal_rows(read_batch, row_count, specific_batch_rows));
+    return m_reader->prefetch_signal_rows(signal_rows);
+}
+
+Result<std::vector<std::uint64_t>> AsyncSignalLoader::batch_signal_rows(
+    ReadTableRecordBatch const & read_batch,
+    std::size_t row_count,
+    gsl::span<std::uint32_t const> specific_batch_rows)
+{
+    auto const signal_column = read_batch.signal_column();
+    std::vector<std::uint64_t> signal_rows;
+    for (std::size_t i = 0; i < row_count; ++i) {
+        auto const batch_row = specific_batch_rows.empty() ? i : specific_batch_rows[i];
+        if (batch_row >= std::size_t(signal_column->length())) {
+            return Status::Invalid("Row outside read batch");
+        }
+        auto const read_signal_rows = std::static_pointer_cast<arrow::UInt64Array>(
+            signal_column->value_slice(batch_row));
+        signal_rows.insert(
+            signal_rows.end(),
+            read_signal_rows->raw_values(),
+            read_signal_rows->raw_values() + read_signal_rows->length());
+    }
+    return signal_rows;
+}
+
+Result<std::vector<std::uint32_t>> AsyncSignalLoader::batch_signal_table_order(
+    ReadTableRecordBatch const & read_batch,
+    std::size_t row_count,
+    gsl::span<std::uint32_t const> specific_batch_rows)
+{
+    auto const signal_column = read_batch.signal_column();
+    std::vector<std::uint64_t> first_signal_rows(row_count);
+    for (std::size_t i = 0; i < row_count; ++i) {
+        auto const batch_row = specific_batch_rows.empty() ? i : specific_batch_rows[i];
+        if (batch_row >= std::size_t(signal_column->length())) {
+            return Status::Invalid("Row outside read batch");
+        }
+        auto const signal_rows = std::static_pointer_cast<arrow::UInt64Array>(
+            signal_column->value_slice(batch_row));
+        first_signal_rows[i] = signal_rows->length() > 0 ? signal_rows->Value(0) : 0;
+    }
+
+    if (std::is_sorted(first_signal_rows.begin(), first_signal_rows.end())) {
+        return std::vector<std::uint32_t>{};
+    }
+
+    std::vector<std::uint32_t> order(row_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return first_signal_rows[a] < first_signal_rows[b];
+    });
+    return order;
+}
+
+Result<std::vector<std::uint64_t>> AsyncSignalLoader::batch_sample_counts(
+    ReadTableRecordBatch const & read_batch,
+    std::size_t row_count,
+    gsl::span<std::uint32_t const> specific_batch_rows,
+    gsl::span<std::uint32_t const> row_order) const
+{
+    auto const signal_column = read_batch.signal_column();
+    std::vector<std::uint64_t> sample_counts(row_count);
+    for (std::size_t position = 0; position < row_count; ++position) {
+        auto const i = row_order.empty() ? position : row_order[position];
+        auto const batch_row = specific_batch_rows.empty() ? i : specific_batch_rows[i];
+        if (batch_row >= std::size_t(signal_column->length())) {
+            return Status::Invalid("Row outside read batch");
+        }
+        auto const signal_rows = std::static_pointer_cast<arrow::UInt64Array>(
+            signal_column->value_slice(batch_row));
+        ARROW_ASSIGN_OR_RAISE(
+            sample_counts[i],
+            m_reader->extract_sample_count(
+                gsl::make_span(signal_rows->raw_values(), signal_rows->length())));
+    }
+    return sample_counts;
+}
+
+Result<std::vector<SignalCacheWorkPackage::Job>> AsyncSignalLoader::batch_jobs(
+    ReadTableRecordBatch const & read_batch,
+    gsl::span<std::uint32_t const> specific_batch_rows,
+    gsl::span<std::uint32_t const> row_order,
+    std::vector<std::uint64_t> const & sample_counts) const
+{
+    std::uint64_t batch_sample_count = 0;
+    for (auto const sample_count : sample_counts) {
+        batch_sample_count += sample_count;
+    }
+    // Each worker gets a couple of jobs of the batch, so one finishing early can take another:
+    auto const job_sample_budget = std::max<std::uint64_t>(
+        MINIMUM_JOB_SAMPLES, batch_sample_count / (m_max_concurrent_tasks * 2));
+
+    auto const signal_column = read_batch.signal_column();
+    std::vector<SignalCacheWorkPackage::Job> jobs;
+    SignalCacheWorkPackage::Job job{0, 0};
+    for (std::uint32_t position = 0; position < sample_counts.size(); ++position) {
+        auto const i = row_order.empty() ? position : row_order[position];
+        // Only reads with samples to load are worth splitting:
+        if (sample_counts[i] <= job_sample_budget || m_samples_mode != SamplesMode::Samples) {
+            job.position_end = position + 1;
+            job.sample_count += sample_counts[i];
+            if (job.sample_count >= job_sample_budget) {
+                jobs.push_back(job);
+                job = {position + 1, position + 1};
+            }
+            continue;
+        }
+
+        // A read longer than a job is given jobs of its own, of consecutive signal rows:
+        if (job.position_end > job.position_begin) {
+            jobs.push_back(job);
+        }
+        auto const batch_row = specific_batch_rows.empty() ? i : specific_batch_rows[i];
+        auto const signal_rows = std::static_pointer_cast<arrow::UInt64Array>(
+            signal_column->value_slice(batch_row));
+        ARROW_ASSIGN_OR_RAISE(
+            auto const chunk_boundaries,
+            m_reader->extract_chunk_boundaries(
+                gsl::make_span(signal_rows->raw_values(), signal_rows->length())));
+        auto const signal_row_count = std::uint32_t(signal_rows->length());
+        std::uint32_t signal_row_begin = 0;
+        for (std::uint32_t signal_row = 0; signal_row < signal_row_count; ++signal_row) {
+            auto const part_sample_count =
+                chunk_boundaries[signal_row + 1] - chunk_boundaries[signal_row_begin];
+            if (part_sample_count >= job_sample_budget || signal_row + 1 == signal_row_count) {
+                jobs.push_back(
+                    {position,
+                     position + 1,
+                     signal_row_begin,
+                     signal_row + 1,
+                     chunk_boundaries[signal_row_begin],
+                     part_sample_count});
+                signal_row_begin = signal_row + 1;
+            }
+        }
+        job = {position + 1, position + 1};
+    }
+    if (job.position_end > job.position_begin) {
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
 void AsyncSignalLoader::release_in_progress_batch()
 {
     if (m_in_progress_batch) {
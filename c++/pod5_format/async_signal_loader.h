@@ -4,12 +4,14 @@
 #include "pod5_format/pod5_format_export.h"
 #include "pod5_format/read_table_reader.h"
 #include "pod5_format/signal_table_reader.h"
+#include "pod5_format/thread_pool.h"
 
 #include <arrow/array/array_nested.h>
 #include <arrow/array/array_primitive.h>
 
 #include <condition_variable>
 #include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -17,64 +19,139 @@
 
 namespace pod5 {
 
+namespace internal {
+class ConcurrencyTuner;
+}
+
+/// \brief A free list of sample buffers, so loaded batches reuse the storage of released ones
+///        rather than allocating their own.
+class POD5_FORMAT_EXPORT SampleBufferPool {
+public:
+    /// \param max_buffer_count    The most released buffers to keep for reuse.
+    SampleBufferPool(std::size_t max_buffer_count);
+
+    /// Find a buffer holding [sample_count] samples, reusing the smallest released buffer with
+    /// enough capacity if there is one.
+    std::vector<std::int16_t> acquire(std::size_t sample_count);
+
+    /// Return [buffer] to the pool for reuse.
+    void release(std::vector<std::int16_t> && buffer);
+
+    /// Find the number of released buffers held for reuse.
+    std::size_t buffer_count() const;
+
+private:
+    std::size_t m_max_buffer_count;
+    mutable std::mutex m_mutex;
+    // Released buffers, keyed by capacity:
+    std::multimap<std::size_t, std::vector<std::int16_t>> m_buffers;
+};
+
 class POD5_FORMAT_EXPORT CachedBatchSignalData {
 public:
-    CachedBatchSignalData(std::uint32_t batch_index, std::size_t entry_count)
-    : m_batch_index(batch_index)
-    , m_sample_counts(entry_count)
-    , m_samples(entry_count)
-    {
-    }
+    /// \brief Make signal data for a batch with a row for each entry in [sample_counts].
+    ///
+    /// If [buffer_pool] is given, all rows' samples are stored in one buffer taken from it, and
+    /// returned to it when the data is destroyed, otherwise no samples are stored.
+    CachedBatchSignalData(
+        std::uint32_t batch_index,
+        std::vector<std::uint64_t> && sample_counts,
+        std::shared_ptr<SampleBufferPool> buffer_pool);
+    CachedBatchSignalData(CachedBatchSignalData &&) = default;
+    CachedBatchSignalData & operator=(CachedBatchSignalData &&) = delete;
+    ~CachedBatchSignalData();
 
     std::uint32_t batch_index() const { return m_batch_index; }
 
     /// Find a list of sample counts for all requested batch rows.
     std::vector<std::uint64_t> const & sample_count() const { return m_sample_counts; }
 
-    /// Find a list of signal samples counts for all requested batch rows.
-    std::vector<std::vector<std::int16_t>> const & samples() const { return m_samples; }
+    /// Find the offset of each row's samples in all_samples(), with a final entry for the end of
+    /// the last row.
+    std::vector<std::uint64_t> const & sample_offsets() const { return m_sample_offsets; }
 
-    void
-    set_samples(std::size_t row, std::uint64_t sample_count, std::vector<std::int16_t> && samples)
-    {
-        m_sample_counts[row] = sample_count;
-        m_samples[row] = std::move(samples);
-    }
+    /// Find the signal samples of all requested batch rows, in row order.
+    /// \note Empty unless samples were loaded.
+    gsl::span<std::int16_t const> all_samples() const { return gsl::make_span(m_samples); }
+
+    /// Find the signal samples of one requested batch row.
+    /// \note Empty unless samples were loaded.
+    gsl::span<std::int16_t const> samples(std::size_t row) const;
+
+    /// Find the storage for one row's signal samples, for the loader to fill.
+    gsl::span<std::int16_t> mutable_samples(std::size_t row);
 
 private:
     std::uint32_t m_batch_index;
     std::vector<std::uint64_t> m_sample_counts;
-    std::vector<std::vector<std::int16_t>> m_samples;
+    std::vector<std::uint64_t> m_sample_offsets;
+    std::shared_ptr<SampleBufferPool> m_buffer_pool;
+    std::vector<std::int16_t> m_samples;
 };
 
 class POD5_FORMAT_EXPORT SignalCacheWorkPackage {
 public:
+    /// A share of the batch's rows for one worker to load.
+    struct Job {
+        // The positions of the job's reads in the order rows are started:
+        std::uint32_t position_begin;
+        std::uint32_t position_end;
+        // A job loading part of one long read holds the range of the read's signal rows it loads,
+        // otherwise the range is empty and whole reads are loaded:
+        std::uint32_t signal_row_begin = 0;
+        std::uint32_t signal_row_end = 0;
+        // The offset of the first sample of the job's signal rows in the read's samples:
+        std::uint64_t sample_offset = 0;
+        // The number of samples the job loads:
+        std::uint64_t sample_count = 0;
+
+        bool is_part_of_read() const { return signal_row_end > signal_row_begin; }
+    };
+
     SignalCacheWorkPackage(
-        std::uint32_t batch_index,
         std::size_t job_row_count,
         gsl::span<std::uint32_t const> const & specific_job_rows,
-        pod5::ReadTableRecordBatch && read_batch)
+        std::unique_ptr<CachedBatchSignalData> && cached_data,
+        pod5::ReadTableRecordBatch && read_batch,
+        std::vector<Job> && jobs,
+        std::vector<std::uint32_t> && job_row_order = {})
     : m_job_row_count(job_row_count)
     , m_specific_job_rows(specific_job_rows)
-    , m_next_row_to_start(0)
-    , m_completed_rows(0)
-    , m_cached_data(std::make_unique<CachedBatchSignalData>(batch_index, m_job_row_count))
+    , m_job_row_order(std::move(job_row_order))
+    , m_jobs(std::move(jobs))
+    , m_next_job_to_start(0)
+    , m_completed_jobs(0)
+    , m_decoded_bytes(cached_data->all_samples().size_bytes())
+    , m_cached_data(std::move(cached_data))
     , m_read_batch(std::move(read_batch))
     {
     }
 
     std::uint32_t job_row_count() const { return m_job_row_count; }
 
-    void
-    set_samples(std::size_t row, std::uint64_t sample_count, std::vector<std::int16_t> && samples)
+    /// Find the storage for one row's signal samples, for a worker to fill.
+    gsl::span<std::int16_t> mutable_samples(std::size_t row)
     {
-        m_cached_data->set_samples(row, sample_count, std::move(samples));
+        return m_cached_data->mutable_samples(row);
     }
 
+    /// Find the bytes of decoded samples the batch holds storage for.
+    std::uint64_t decoded_bytes() const { return m_decoded_bytes; }
+
     std::unique_ptr<CachedBatchSignalData> release_data() { return std::move(m_cached_data); }
 
     pod5::ReadTableRecordBatch const & read_batch() const { return m_read_batch; }
 
+    // Find the job row index to work on [position] rows into the order rows are started.
+    std::uint32_t get_job_row_at(std::uint32_t position) const
+    {
+        if (!m_job_row_order.empty()) {
+            return m_job_row_order[position];
+        }
+
+        return position;
+    }
+
     // Find the actual batch row to query, for a given job row index.
     std::uint32_t get_batch_row_to_query(std::uint32_t job_row_index) const
     {
@@ -86,25 +163,30 @@ public:
         return job_row_index;
     }
 
-    std::uint32_t start_rows(std::unique_lock<std::mutex> & l, std::size_t row_count)
-    {
-        auto row = m_next_row_to_start;
-        m_next_row_to_start += row_count;
-        return row;
-    }
+    std::size_t job_count() const { return m_jobs.size(); }
 
-    void complete_rows(std::uint32_t row_count) { m_completed_rows += row_count; }
+    Job const & job(std::size_t index) const { return m_jobs[index]; }
 
-    bool has_work_left() const { return m_next_row_to_start < m_job_row_count; }
+    /// Claim the next job to start, returning its index.
+    /// \note Workers claim jobs concurrently, claims from the job count on hold no job.
+    std::uint32_t start_job() { return m_next_job_to_start.fetch_add(1); }
 
-    bool is_complete() const { return m_completed_rows.load() >= m_job_row_count; }
+    void complete_job() { m_completed_jobs += 1; }
+
+    bool has_work_left() const { return m_next_job_to_start.load() < m_jobs.size(); }
+
+    bool is_complete() const { return m_completed_jobs.load() >= m_jobs.size(); }
 
 private:
     std::size_t m_job_row_count;
     gsl::span<std::uint32_t const> m_specific_job_rows;
+    // The order to start job rows in, or empty to start them in order:
+    std::vector<std::uint32_t> m_job_row_order;
+    std::vector<Job> m_jobs;
 
-    std::uint32_t m_next_row_to_start;
-    std::atomic<std::uint32_t> m_completed_rows;
+    std::atomic<std::uint32_t> m_next_job_to_start;
+    std::atomic<std::uint32_t> m_completed_jobs;
+    std::uint64_t m_decoded_bytes;
 
     std::unique_ptr<CachedBatchSignalData> m_cached_data;
     pod5::ReadTableRecordBatch m_read_batch;
@@ -112,12 +194,26 @@ private:
 
 class POD5_FORMAT_EXPORT AsyncSignalLoader {
 public:
-    // Minimum number of tasks one thread will do in a batch.
-    static std::size_t const MINIMUM_JOB_SIZE;
+    // Minimum number of samples one job loads, jobs are sized by samples rather than reads so a
+    // few long reads don't leave workers idle while one finishes them. Reads longer than a job
+    // are split between jobs by their signal rows.
+    static std::uint64_t const MINIMUM_JOB_SAMPLES;
+    // Default number of read batches ahead of the current batch to prefetch signal for.
+    static constexpr std::size_t DEFAULT_PREFETCH_DISTANCE = 2;
+    // Value for max_pending_bytes placing no limit on the decoded bytes held by the loader.
+    static constexpr std::uint64_t NO_PENDING_BYTES_LIMIT = 0;
     enum class SamplesMode {
         NoSamples,
         Samples,
     };
+    /// The order a batch's reads are loaded in, the order batches are returned in is unchanged.
+    enum class RowOrder {
+        // Load reads in read table order.
+        ReadTable,
+        // Load reads in the order of their signal, so reads sharing a signal batch are loaded
+        // together rather than cycling the signal batch cache when their signal is scattered.
+        SignalTable,
+    };
 
     AsyncSignalLoader(
         std::shared_ptr<pod5::FileReader> const & reader,
@@ -125,34 +221,141 @@ public:
         gsl::span<std::uint32_t const> const & batch_counts,
         gsl::span<std::uint32_t const> const & batch_rows,
         std::size_t worker_count = std::thread::hardware_concurrency(),
-        std::size_t max_pending_batches = 10);
+        std::size_t max_pending_batches = 10,
+        std::size_t prefetch_distance = DEFAULT_PREFETCH_DISTANCE,
+        std::uint64_t max_pending_bytes = NO_PENDING_BYTES_LIMIT,
+        RowOrder row_order = RowOrder::SignalTable,
+        bool adaptive_worker_count = false);
+
+    /// \brief Make a loader running its work as tasks on [thread_pool], rather than on threads of
+    ///        its own, so loaders sharing a pool don't oversubscribe the machine.
+    ///
+    /// Each task loads one job of rows then queues the next behind other work on the pool, so
+    /// loaders sharing the pool take turns.
+    /// \param max_concurrent_tasks    The most tasks this loader has queued or running at once.
+    /// \param max_pending_bytes       Stop starting new rows while the decoded samples held by
+    ///                                the loader reach this many bytes, see pending_bytes().
+    /// \param row_order               The order to load reads within each batch in.
+    /// \param worker_group            The group of [thread_pool]'s workers to prefer, see
+    ///                                ThreadPool::post_to_group(), so the file's pages and the
+    ///                                sample buffers the tasks fill are first touched on that
+    ///                                group's NUMA node. By default tasks stay in the group of
+    ///                                the thread making the loader, if it is one of the pool's.
+    /// \param adaptive_worker_count   Tune the number of tasks between one and
+    ///                                [max_concurrent_tasks] while loading, see worker_count().
+    /// \note [thread_pool] must outlive the loader.
+    AsyncSignalLoader(
+        std::shared_ptr<pod5::FileReader> const & reader,
+        SamplesMode samples_mode,
+        gsl::span<std::uint32_t const> const & batch_counts,
+        gsl::span<std::uint32_t const> const & batch_rows,
+        std::shared_ptr<ThreadPool> thread_pool,
+        std::size_t max_concurrent_tasks,
+        std::size_t max_pending_batches = 10,
+        std::size_t prefetch_distance = DEFAULT_PREFETCH_DISTANCE,
+        std::uint64_t max_pending_bytes = NO_PENDING_BYTES_LIMIT,
+        RowOrder row_order = RowOrder::SignalTable,
+        std::optional<std::size_t> worker_group = std::nullopt,
+        bool adaptive_worker_count = false);
 
     ~AsyncSignalLoader();
 
     /// Find if all work is complete in the loader.
     bool is_finished() const { return m_finished; }
 
+    /// \brief Find the bytes of decoded samples the loader holds in batches not yet released.
+    ///
+    /// Once this reaches max_pending_bytes no new rows are started until batches are released.
+    /// Storage for a batch's samples is held from when the batch starts, and the batch in progress
+    /// is never held back while no other batch is pending, so this can exceed the limit by a batch.
+    std::uint64_t pending_bytes() const { return m_pending_bytes; }
+
+    /// \brief Find the number of workers (or pool tasks) loading signal.
+    ///
+    /// A loader made with an adaptive worker count starts halfway to the count it was given, and
+    /// every 100ms adds or removes a worker, climbing towards the count past which more workers
+    /// deliver no more samples, and removing workers while they are held back by the pending
+    /// limits.
+    std::size_t worker_count() const;
+
     /// Get the next batch of loaded signal, always returns the consecutive next signal batch
     /// \note Returns nullptr when timeoout occurs, or if all data is exhausted.
     Result<std::unique_ptr<CachedBatchSignalData>> release_next_batch(
         std::optional<std::chrono::steady_clock::time_point> timeout = std::nullopt);
 
+    /// \brief Get any batch of loaded signal that has finished loading, in the order batches
+    ///        finish, so a slow batch doesn't hold back those loaded after it.
+    ///
+    /// Use CachedBatchSignalData::batch_index() to find which batch was returned.
+    /// \note Returns nullptr when timeout occurs, or if all data is exhausted.
+    Result<std::unique_ptr<CachedBatchSignalData>> release_next_completed_batch(
+        std::optional<std::chrono::steady_clock::time_point> timeout = std::nullopt);
+
 private:
+    /// Take [batch]'s data once it is complete, freeing its place in the pending limits.
+    std::unique_ptr<CachedBatchSignalData> take_batch_data(
+        std::shared_ptr<SignalCacheWorkPackage> const & batch);
+
     /// Set an error code that will stop all async loading and return an error to the caller.
     void set_error(pod5::Status status);
     pod5::Status error() const;
 
-    void run_worker();
+    enum class JobResult {
+        // A job of rows was loaded.
+        Worked,
+        // No job could start until the caller releases pending batches.
+        Blocked,
+        // All work is finished, or has stopped after an error.
+        Finished,
+    };
+
+    /// Find if the pending batches or decoded bytes are over their limits, so no job can start.
+    bool over_pending_limits() const;
+
+    /// \param worker_index The worker's place among the loader's threads, workers placed past
+    ///                     worker_count() wait for it to grow.
+    void run_worker(std::size_t worker_index);
+    /// Claim and load one job of rows.
+    /// \param batch The batch the worker last claimed a job from, jobs are claimed from it without
+    ///              locking, and it is updated to the in progress batch once it has none left.
+    JobResult run_job(
+        SignalCompressionContext & compression_context,
+        std::shared_ptr<SignalCacheWorkPackage> & batch);
+
+    /// Run one job as a task on [m_thread_pool], queueing the next if there is work left.
+    /// \param batch The batch the previous task claimed a job from, see run_job().
+    void run_pool_task(std::shared_ptr<SignalCacheWorkPackage> batch);
+    /// Queue a task on [m_thread_pool], returning false after setting an error if it can't be.
+    bool post_pool_task(std::shared_ptr<SignalCacheWorkPackage> batch = nullptr);
+    /// Queue the tasks parked while pending batches were over the limit.
+    void resume_parked_tasks();
+    /// Queue [task_count] tasks already counted as active, uncounting those that can't be.
+    void post_pool_tasks(std::size_t task_count);
+    /// Step an adaptive worker count if it is due, queueing tasks on [m_thread_pool] to match.
+    void tune_worker_count();
     void do_work(
         std::shared_ptr<SignalCacheWorkPackage> const & batch,
-        std::uint32_t row_start,
-        std::uint32_t row_end);
+        SignalCacheWorkPackage::Job const & job,
+        SignalCompressionContext & compression_context);
+
+    /// Make the work for batch [batch_index], whose rows start [batch_rows_offset] into
+    /// [m_batch_rows], reading the batch and sizing the storage for its samples.
+    Result<std::shared_ptr<SignalCacheWorkPackage>> make_batch(
+        std::uint32_t batch_index,
+        std::size_t batch_rows_offset) const;
+
+    /// Make the next batch to start ahead of time, unless it is made already or another thread
+    /// is making it, so moving workers on to it only hands over prepared work.
+    void stage_next_batch();
+    /// Make the next batch to start.
+    /// \param lock A lock held on m_staging_sync.
+    /// \note There must not be a batch already staged.
+    void stage_next_batch(std::unique_lock<std::mutex> & lock);
 
-    /// Setup a new batch for in progress work to contain.
+    /// Start the staged batch as the in progress batch, making it first if it isn't staged.
     /// \param lock A lock held on m_worker_sync.
     /// \note There must not be a batch already in progress.
-    /// \note m_current_batch is used as the index of the next batch to begin.
-    Status setup_next_in_progress_batch(std::unique_lock<std::mutex> & lock);
+    Status start_staged_batch(std::unique_lock<std::mutex> & lock);
 
     /// Release the currently in progress batch to readers, if it exists.
     /// \note This call locks m_batches_sync internally.
@@ -160,20 +363,65 @@ private:
     /// \note This call notifys the condition variable to alert readers that new data is available.
     void release_in_progress_batch();
 
+    /// Hint the reader to read ahead signal for read batches up to [m_prefetch_distance] past the
+    /// current batch, so their signal is in memory by the time workers reach them.
+    /// \param lock A lock held on m_staging_sync.
+    void prefetch_upcoming_batches(std::unique_lock<std::mutex> & lock);
+    Status prefetch_batch_signal(std::uint32_t batch_index, std::size_t batch_rows_offset);
+    /// Find the signal rows of [row_count] reads in [read_batch], either the first rows or
+    /// [specific_batch_rows] if not empty.
+    static Result<std::vector<std::uint64_t>> batch_signal_rows(
+        ReadTableRecordBatch const & read_batch,
+        std::size_t row_count,
+        gsl::span<std::uint32_t const> specific_batch_rows);
+    /// Find an order to load [row_count] reads in [read_batch], as batch_signal_rows(), sorting
+    /// reads by their first signal row, or an empty order if they are already in that order.
+    static Result<std::vector<std::uint32_t>> batch_signal_table_order(
+        ReadTableRecordBatch const & read_batch,
+        std::size_t row_count,
+        gsl::span<std::uint32_t const> specific_batch_rows);
+    /// Find the sample count of [row_count] reads in [read_batch], as batch_signal_rows(), visiting
+    /// the reads in [row_order] if not empty.
+    Result<std::vector<std::uint64_t>> batch_sample_counts(
+        ReadTableRecordBatch const & read_batch,
+        std::size_t row_count,
+        gsl::span<std::uint32_t const> specific_batch_rows,
+        gsl::span<std::uint32_t const> row_order) const;
+    /// Divide the reads of a batch, as batch_sample_counts(), into jobs of similar sample counts,
+    /// splitting reads longer than a job by their signal rows.
+    Result<std::vector<SignalCacheWorkPackage::Job>> batch_jobs(
+        ReadTableRecordBatch const & read_batch,
+        gsl::span<std::uint32_t const> specific_batch_rows,
+        gsl::span<std::uint32_t const> row_order,
+        std::vector<std::uint64_t> const & sample_counts) const;
+
     std::shared_ptr<pod5::FileReader> m_reader;
     SamplesMode m_samples_mode;
+    RowOrder m_row_order;
     std::size_t m_max_pending_batches;
+    std::uint64_t m_max_pending_bytes;
     std::size_t m_reads_batch_count;
     gsl::span<std::uint32_t const> m_batch_counts;
-    std::size_t m_total_batch_count_so_far;
     gsl::span<std::uint32_t const> m_batch_rows;
 
-    std::uint32_t const m_worker_job_size;
+    std::size_t const m_max_concurrent_tasks;
 
     std::mutex m_worker_sync;
     std::condition_variable m_batch_done;
     std::uint32_t m_current_batch;
 
+    std::mutex m_staging_sync;
+    // The batch to start once the in progress batch has no rows left, made ahead of time:
+    std::optional<Result<std::shared_ptr<SignalCacheWorkPackage>>> m_staged_batch;
+    // The next batch to stage, and the offset of its rows in [m_batch_rows]:
+    std::uint32_t m_next_staged_batch;
+    std::size_t m_next_staged_batch_rows_offset;
+
+    std::size_t m_prefetch_distance;
+    // The next read batch to prefetch signal for, and the offset of its rows in [m_batch_rows].
+    std::uint32_t m_next_prefetch_batch;
+    std::size_t m_next_prefetch_batch_rows_offset;
+
     std::atomic<bool> m_finished;
     std::atomic<bool> m_has_error;
     mutable std::mutex m_error_mutex;
@@ -182,9 +430,27 @@ private:
 
     std::mutex m_batches_sync;
     std::atomic<std::uint32_t> m_batches_size;
+    // Bytes of decoded samples in the in progress batch and [m_batches]:
+    std::atomic<std::uint64_t> m_pending_bytes;
+    // Storage shared by batches' samples, or null if samples aren't loaded:
+    std::shared_ptr<SampleBufferPool> m_sample_buffers;
     std::deque<std::shared_ptr<SignalCacheWorkPackage>> m_batches;
 
     std::vector<std::thread> m_workers;
+
+    std::shared_ptr<ThreadPool> m_thread_pool;
+    std::optional<std::size_t> m_worker_group;
+    std::mutex m_pool_sync;
+    std::condition_variable m_pool_tasks_done;
+    // Tasks queued or running on [m_thread_pool], and tasks parked until batches are released:
+    std::size_t m_active_tasks;
+    std::size_t m_parked_tasks;
+    // The sum of the times tasks were parked at, in steady clock nanoseconds, to find the time
+    // parked tasks have been held back once they are resumed:
+    std::uint64_t m_parked_time_sum_ns;
+
+    // Picks the number of workers to run, or null to run them all:
+    std::unique_ptr<internal::ConcurrencyTuner> m_concurrency_tuner;
 };
 
 }  // namespace pod5
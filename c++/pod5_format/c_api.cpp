@@ -1,27 +1,57 @@
 #include "pod5_format/c_api.h"
 
+#include "pod5_format/async_signal_loader.h"
+#include "pod5_format/dataset_reader.h"
 #include "pod5_format/file_reader.h"
+#include "pod5_format/file_summary.h"
 #include "pod5_format/file_writer.h"
+#include "pod5_format/memory_pool.h"
+#include "pod5_format/read_batch_iterator.h"
+#include "pod5_format/read_id_filter.h"
+#include "pod5_format/read_scan.h"
 #include "pod5_format/read_table_reader.h"
 #include "pod5_format/signal_compression.h"
+#include "pod5_format/signal_summary.h"
 #include "pod5_format/signal_table_reader.h"
+#include "pod5_format/thread_pool.h"
 #include "pod5_format/uuid.h"
+#include "pod5_format/uuid_format.h"
 
 #include <arrow/array/array_binary.h>
 #include <arrow/array/array_dict.h>
 #include <arrow/array/array_nested.h>
 #include <arrow/array/array_primitive.h>
+#include <arrow/c/bridge.h>
 #include <arrow/memory_pool.h>
 #include <arrow/type.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <numeric>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
 
 //---------------------------------------------------------------------------------------------------------------------
+struct Pod5DatasetReader {
+    Pod5DatasetReader(std::shared_ptr<pod5::DatasetReader> && dataset_)
+    : dataset(std::move(dataset_))
+    {
+    }
+
+    std::shared_ptr<pod5::DatasetReader> dataset;
+};
+
+class ReadDictionaryCache;
+
 struct Pod5FileReader {
-    Pod5FileReader(std::shared_ptr<pod5::FileReader> && reader_) : reader(std::move(reader_)) {}
+    Pod5FileReader(std::shared_ptr<pod5::FileReader> && reader_);
 
     std::shared_ptr<pod5::FileReader> reader;
+    // Shared with the reader's batches, so cached values outlive whichever is freed last:
+    std::shared_ptr<ReadDictionaryCache> dictionaries;
 };
 
 struct Pod5FileWriter {
@@ -31,33 +61,76 @@ struct Pod5FileWriter {
 };
 
 struct Pod5ReadRecordBatch {
+    Pod5ReadRecordBatch(pod5::ReadTableRecordBatch && batch_, Pod5FileReader const & file)
+    : Pod5ReadRecordBatch(std::move(batch_), file.reader, file.dictionaries)
+    {
+    }
+
     Pod5ReadRecordBatch(
         pod5::ReadTableRecordBatch && batch_,
-        std::shared_ptr<pod5::FileReader> const & reader)
+        std::shared_ptr<pod5::FileReader> reader_,
+        std::shared_ptr<ReadDictionaryCache> dictionaries_)
     : batch(std::move(batch_))
-    , reader(reader)
+    , view(batch.view())
+    , reader(std::move(reader_))
+    , dictionaries(std::move(dictionaries_))
     {
     }
 
     pod5::ReadTableRecordBatch batch;
+    // Row lookups read the batch's columns through views found once:
+    pod5::ReadTableBatchView view;
+    std::shared_ptr<pod5::FileReader> reader;
+    std::shared_ptr<ReadDictionaryCache> dictionaries;
+};
+
+struct Pod5ReadTableProjection {
+    Pod5ReadTableProjection(std::shared_ptr<pod5::ReadTableProjection const> && projection_)
+    : projection(std::move(projection_))
+    {
+    }
+
+    std::shared_ptr<pod5::ReadTableProjection const> projection;
+};
+
+struct Pod5ReadBatchIterator {
+    std::unique_ptr<pod5::ReadBatchIterator> iterator;
+    // Shared with the batches returned, as for batches read from the file directly:
     std::shared_ptr<pod5::FileReader> reader;
+    std::shared_ptr<ReadDictionaryCache> dictionaries;
+};
+
+struct Pod5SignalLoader {
+    // The plan the loader works through, copied as the loader only refers to it:
+    std::vector<std::uint32_t> batch_counts;
+    std::vector<std::uint32_t> batch_rows;
+    // The offset of each read table batch's rows in [batch_rows]:
+    std::vector<std::size_t> batch_rows_offsets;
+    pod5::AsyncSignalLoader::SamplesMode samples_mode;
+    // Declared last, so its threads stop before the plan is destroyed:
+    std::unique_ptr<pod5::AsyncSignalLoader> loader;
 };
 
 namespace {
 //---------------------------------------------------------------------------------------------------------------------
-pod5_error_t g_pod5_error_no;
-std::string g_pod5_error_string;
+// Error state is per thread, so concurrent callers neither share a cache line nor see each other's
+// errors. The code is constant initialised, so reading it needs no thread local setup:
+thread_local pod5_error_t t_pod5_error_no = pod5_error_t::POD5_OK;
+thread_local std::string t_pod5_error_string;
 
 void pod5_set_error(arrow::Status status)
 {
-    g_pod5_error_no = (pod5_error_t)status.code();
-    g_pod5_error_string = status.ToString();
+    t_pod5_error_no = (pod5_error_t)status.code();
+    t_pod5_error_string = status.ToString();
 }
 
 void pod5_reset_error()
 {
-    g_pod5_error_no = pod5_error_t::POD5_OK;
-    g_pod5_error_string.clear();
+    // Only touch the string after an error, so successful calls write a single int:
+    if (t_pod5_error_no != pod5_error_t::POD5_OK) {
+        t_pod5_error_no = pod5_error_t::POD5_OK;
+        t_pod5_error_string.clear();
+    }
 }
 
 #define POD5_C_RETURN_NOT_OK(result)    \
@@ -65,7 +138,7 @@ void pod5_reset_error()
         ::arrow::Status __s = (result); \
         if (!__s.ok()) {                \
             pod5_set_error(__s);        \
-            return g_pod5_error_no;     \
+            return t_pod5_error_no;     \
         }                               \
     } while (0)
 
@@ -73,7 +146,7 @@ void pod5_reset_error()
     auto && result_name = (rexpr);                           \
     if (!(result_name).ok()) {                               \
         pod5_set_error((result_name).status());              \
-        return g_pod5_error_no;                              \
+        return t_pod5_error_no;                              \
     }                                                        \
     lhs = std::move(result_name).ValueUnsafe();
 
@@ -124,6 +197,17 @@ bool check_output_pointer_not_null(void const * output)
     return true;
 }
 
+// Check the columns a call needs are loaded, batches read with a projection may not hold them.
+template <typename... Columns>
+bool check_columns_loaded(Columns const &... columns)
+{
+    if (!(... && bool(columns))) {
+        pod5_set_error(arrow::Status::Invalid("read batch was loaded without a required column"));
+        return false;
+    }
+    return true;
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 pod5::FileWriterOptions make_internal_writer_options(Pod5WriterOptions const * options)
 {
@@ -177,9 +261,9 @@ pod5_error_t pod5_terminate()
     return POD5_OK;
 }
 
-pod5_error_t pod5_get_error_no() { return g_pod5_error_no; }
+pod5_error_t pod5_get_error_no() { return t_pod5_error_no; }
 
-char const * pod5_get_error_string() { return g_pod5_error_string.c_str(); }
+char const * pod5_get_error_string() { return t_pod5_error_string.c_str(); }
 
 //---------------------------------------------------------------------------------------------------------------------
 Pod5FileReader * pod5_open_file(char const * filename)
@@ -232,7 +316,7 @@ pod5_error_t pod5_get_file_info(Pod5FileReader_t * reader, FileInfo * file_info)
     pod5_reset_error();
 
     if (!check_file_not_null(reader) || !check_output_pointer_not_null(file_info)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     auto const metadata = reader->reader->schema_metadata();
@@ -252,7 +336,14 @@ pod5_error_t pod5_get_file_read_table_location(
     pod5_reset_error();
 
     if (!check_file_not_null(reader) || !check_output_pointer_not_null(file_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
+    }
+    // Migrated tables are only read in place, rather than written out for the caller to open:
+    if (reader->reader->read_table_migrated()) {
+        pod5_set_error(arrow::Status::NotImplemented(
+            "Read table is migrated from an older file version as it is read, read its batches "
+            "with pod5_get_read_batch"));
+        return t_pod5_error_no;
     }
     auto const & read_table_location = reader->reader->read_table_location();
 
@@ -269,7 +360,7 @@ pod5_error_t pod5_get_file_signal_table_location(
     pod5_reset_error();
 
     if (!check_file_not_null(reader) || !check_output_pointer_not_null(file_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
     auto const signal_table_location = reader->reader->signal_table_location();
 
@@ -285,7 +376,13 @@ pod5_error_t pod5_get_file_run_info_table_location(
     pod5_reset_error();
 
     if (!check_file_not_null(reader) || !check_output_pointer_not_null(file_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
+    }
+    if (reader->reader->run_info_table_migrated()) {
+        pod5_set_error(arrow::Status::NotImplemented(
+            "Run info table is built from an older file version's read table, read its run "
+            "infos with pod5_get_file_run_info"));
+        return t_pod5_error_no;
     }
     auto const run_info_table_location = reader->reader->run_info_table_location();
 
@@ -294,12 +391,83 @@ pod5_error_t pod5_get_file_run_info_table_location(
     return POD5_OK;
 }
 
+pod5_error_t pod5_get_file_reader_statistics(
+    Pod5FileReader_t * reader,
+    Pod5FileReaderStatistics_t * statistics)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_output_pointer_not_null(statistics)) {
+        return t_pod5_error_no;
+    }
+    auto const reader_statistics = reader->reader->statistics();
+
+    statistics->run_info_table_bytes_read = reader_statistics.run_info_table_bytes_read;
+    statistics->read_table_bytes_read = reader_statistics.read_table_bytes_read;
+    statistics->signal_table_bytes_read = reader_statistics.signal_table_bytes_read;
+    statistics->read_table_batches_decoded = reader_statistics.read_table_batches_decoded;
+    statistics->signal_table_batches_decoded = reader_statistics.signal_table_batches_decoded;
+    statistics->signal_cache_hits = reader_statistics.signal_cache_hits;
+    statistics->signal_cache_misses = reader_statistics.signal_cache_misses;
+    statistics->signal_cache_evictions = reader_statistics.signal_cache_evictions;
+    statistics->decompressed_bytes = reader_statistics.decompressed_bytes;
+    statistics->decompression_time_ns = reader_statistics.decompression_time.count();
+    return POD5_OK;
+}
+
+namespace {
+bool check_memory_subsystem(pod5_memory_subsystem_t subsystem)
+{
+    if (subsystem < POD5_MEMORY_SUBSYSTEM_SIGNAL_CACHE || subsystem > POD5_MEMORY_SUBSYSTEM_REPACKER)
+    {
+        pod5_set_error(arrow::Status::Invalid("Invalid memory subsystem ", int(subsystem)));
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+pod5_error_t pod5_get_memory_statistics(
+    pod5_memory_subsystem_t subsystem,
+    Pod5MemoryStatistics_t * statistics)
+{
+    pod5_reset_error();
+
+    if (!check_memory_subsystem(subsystem) || !check_output_pointer_not_null(statistics)) {
+        return t_pod5_error_no;
+    }
+    auto const pool_statistics =
+        pod5::subsystem_memory_pool(pod5::MemorySubsystem(subsystem)).statistics();
+
+    statistics->bytes_allocated = pool_statistics.bytes_allocated;
+    statistics->peak_bytes_allocated = pool_statistics.peak_bytes_allocated;
+    statistics->allocation_count = pool_statistics.allocation_count;
+    statistics->failed_allocations = pool_statistics.failed_allocations;
+    statistics->max_bytes = pool_statistics.max_bytes;
+    return POD5_OK;
+}
+
+pod5_error_t pod5_set_memory_limit(pod5_memory_subsystem_t subsystem, int64_t max_bytes)
+{
+    pod5_reset_error();
+
+    if (!check_memory_subsystem(subsystem)) {
+        return t_pod5_error_no;
+    }
+    if (max_bytes < 0) {
+        pod5_set_error(arrow::Status::Invalid("Memory limit must not be negative"));
+        return t_pod5_error_no;
+    }
+    pod5::subsystem_memory_pool(pod5::MemorySubsystem(subsystem)).set_max_bytes(max_bytes);
+    return POD5_OK;
+}
+
 pod5_error_t pod5_get_read_count(Pod5FileReader_t * reader, size_t * count)
 {
     pod5_reset_error();
 
     if (!check_file_not_null(reader) || !check_output_pointer_not_null(count)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(*count, reader->reader->read_count());
@@ -312,13 +480,13 @@ pod5_error_t pod5_get_read_ids(Pod5FileReader_t * reader, size_t count, read_id_
     pod5_reset_error();
 
     if (!check_file_not_null(reader) || !check_output_pointer_not_null(read_ids)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(auto read_count, reader->reader->read_count());
     if (count < read_count) {
         pod5_set_error(arrow::Status::Invalid("array to short to receive read ids"));
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     std::size_t count_so_far = 0;
@@ -351,7 +519,7 @@ pod5_error_t pod5_plan_traversal(
         || !check_output_pointer_not_null(batch_counts)
         || !check_output_pointer_not_null(batch_rows))
     {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     auto search_input = pod5::ReadIdSearchInput(
@@ -371,12 +539,103 @@ pod5_error_t pod5_plan_traversal(
     return POD5_OK;
 }
 
+pod5_error_t pod5_scan_reads(
+    Pod5FileReader_t * reader,
+    char const * expression,
+    uint32_t * batch_counts,
+    uint32_t * batch_rows,
+    size_t batch_rows_count,
+    size_t * selected_count_out)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_string_not_empty(expression)
+        || !check_output_pointer_not_null(batch_counts)
+        || !check_output_pointer_not_null(batch_rows))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(auto predicate, pod5::ReadScanPredicate::parse(expression));
+    POD5_C_ASSIGN_OR_RAISE(
+        auto selected_count,
+        reader->reader->scan_reads(
+            predicate,
+            gsl::make_span(batch_counts, reader->reader->num_read_record_batches()),
+            gsl::make_span(batch_rows, batch_rows_count)));
+
+    if (selected_count_out) {
+        *selected_count_out = selected_count;
+    }
+
+    return POD5_OK;
+}
+
+pod5_error_t pod5_file_may_contain_read_ids(
+    char const * filename,
+    uint8_t const * read_id_array,
+    size_t read_id_count,
+    uint8_t * may_contain)
+{
+    pod5_reset_error();
+
+    if (!check_string_not_empty(filename) || !check_not_null(read_id_array)
+        || !check_output_pointer_not_null(may_contain))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto filter, pod5::open_read_id_filter(filename, arrow::system_memory_pool()));
+
+    auto const read_ids =
+        gsl::make_span(reinterpret_cast<pod5::Uuid const *>(read_id_array), read_id_count);
+    for (std::size_t i = 0; i < read_ids.size(); ++i) {
+        may_contain[i] = !filter || filter->may_contain(read_ids[i]);
+    }
+
+    return POD5_OK;
+}
+
+pod5_error_t pod5_read_file_summary(
+    char const * filename,
+    Pod5FileSummary_t * summary,
+    uint8_t * has_summary)
+{
+    pod5_reset_error();
+
+    if (!check_string_not_empty(filename) || !check_output_pointer_not_null(summary)
+        || !check_output_pointer_not_null(has_summary))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto file_summary, pod5::open_file_summary(filename, arrow::system_memory_pool()));
+    *has_summary = file_summary != nullptr;
+    if (!file_summary) {
+        return POD5_OK;
+    }
+
+    summary->read_count = file_summary->read_count();
+    summary->sample_count = file_summary->sample_count();
+    summary->signal_bytes = file_summary->signal_bytes();
+    summary->run_info_count = file_summary->run_infos().size();
+
+    auto const min_start_time = file_summary->min_start_time();
+    auto const max_start_time = file_summary->max_start_time();
+    summary->has_start_times = min_start_time.has_value();
+    summary->min_start_time_ms = min_start_time.value_or(0);
+    summary->max_start_time_ms = max_start_time.value_or(0);
+    return POD5_OK;
+}
+
 pod5_error_t pod5_get_read_batch_count(size_t * count, Pod5FileReader * reader)
 {
     pod5_reset_error();
 
     if (!check_file_not_null(reader) || !check_output_pointer_not_null(count)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     *count = reader->reader->num_read_record_batches();
@@ -389,13 +648,78 @@ pod5_get_read_batch(Pod5ReadRecordBatch ** batch, Pod5FileReader * reader, size_
     pod5_reset_error();
 
     if (!check_file_not_null(reader) || !check_output_pointer_not_null(batch)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(auto internal_batch, reader->reader->read_read_record_batch(index));
 
-    auto wrapped_batch =
-        std::make_unique<Pod5ReadRecordBatch>(std::move(internal_batch), reader->reader);
+    auto wrapped_batch = std::make_unique<Pod5ReadRecordBatch>(std::move(internal_batch), *reader);
+
+    *batch = wrapped_batch.release();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_create_read_table_projection(
+    Pod5ReadTableProjection_t ** projection,
+    Pod5FileReader_t * reader,
+    char const * const * column_names,
+    size_t column_count)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_output_pointer_not_null(projection)
+        || (column_count > 0 && !check_not_null(column_names)))
+    {
+        return t_pod5_error_no;
+    }
+
+    std::vector<std::string> names;
+    names.reserve(column_count);
+    for (std::size_t i = 0; i < column_count; ++i) {
+        if (!check_string_not_empty(column_names[i])) {
+            return t_pod5_error_no;
+        }
+        names.emplace_back(column_names[i]);
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto internal_projection, reader->reader->make_read_table_projection(names));
+    *projection = new Pod5ReadTableProjection(std::move(internal_projection));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_free_read_table_projection(Pod5ReadTableProjection_t * projection)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(projection)) {
+        return t_pod5_error_no;
+    }
+
+    std::unique_ptr<Pod5ReadTableProjection> ptr{projection};
+    ptr.reset();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_read_batch_projected(
+    Pod5ReadRecordBatch_t ** batch,
+    Pod5FileReader_t * reader,
+    size_t index,
+    Pod5ReadTableProjection_t const * projection)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_output_pointer_not_null(batch)
+        || !check_not_null(projection))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto internal_batch,
+        reader->reader->read_read_record_batch(index, *projection->projection));
+
+    auto wrapped_batch = std::make_unique<Pod5ReadRecordBatch>(std::move(internal_batch), *reader);
 
     *batch = wrapped_batch.release();
     return POD5_OK;
@@ -406,7 +730,7 @@ pod5_error_t pod5_free_read_batch(Pod5ReadRecordBatch * batch)
     pod5_reset_error();
 
     if (!check_not_null(batch)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     std::unique_ptr<Pod5ReadRecordBatch> ptr{batch};
@@ -414,12 +738,120 @@ pod5_error_t pod5_free_read_batch(Pod5ReadRecordBatch * batch)
     return POD5_OK;
 }
 
+pod5_error_t pod5_create_read_batch_iterator(
+    Pod5ReadBatchIterator_t ** iterator,
+    Pod5FileReader_t * reader,
+    size_t prefetch_batches,
+    Pod5ReadTableProjection_t const * projection)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_output_pointer_not_null(iterator)) {
+        return t_pod5_error_no;
+    }
+
+    pod5::ReadBatchIteratorOptions options;
+    if (prefetch_batches > 0) {
+        options.set_prefetch_batches(prefetch_batches);
+    }
+
+    auto wrapped_iterator = std::make_unique<Pod5ReadBatchIterator>();
+    wrapped_iterator->iterator = std::make_unique<pod5::ReadBatchIterator>(
+        reader->reader, projection ? projection->projection : nullptr, options);
+    wrapped_iterator->reader = reader->reader;
+    wrapped_iterator->dictionaries = reader->dictionaries;
+
+    *iterator = wrapped_iterator.release();
+    return POD5_OK;
+}
+
+pod5_error_t
+pod5_read_batch_iterator_next(Pod5ReadBatchIterator_t * iterator, Pod5ReadRecordBatch_t ** batch)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(iterator) || !check_output_pointer_not_null(batch)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(auto internal_batch, iterator->iterator->next());
+    if (!internal_batch) {
+        *batch = nullptr;
+        return POD5_OK;
+    }
+
+    *batch = new Pod5ReadRecordBatch(
+        std::move(*internal_batch), iterator->reader, iterator->dictionaries);
+    return POD5_OK;
+}
+
+pod5_error_t pod5_free_read_batch_iterator(Pod5ReadBatchIterator_t * iterator)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(iterator)) {
+        return t_pod5_error_no;
+    }
+
+    std::unique_ptr<Pod5ReadBatchIterator> ptr{iterator};
+    ptr.reset();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_export_read_batch_arrow(
+    Pod5ReadRecordBatch_t * batch,
+    ArrowArray * out_array,
+    ArrowSchema * out_schema)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(batch) || !check_output_pointer_not_null(out_array)
+        || !check_output_pointer_not_null(out_schema))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_RETURN_NOT_OK(arrow::ExportRecordBatch(*batch->batch.batch(), out_array, out_schema));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_signal_batch_count(size_t * count, Pod5FileReader_t * reader)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_output_pointer_not_null(count)) {
+        return t_pod5_error_no;
+    }
+
+    *count = reader->reader->num_signal_record_batches();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_export_signal_batch_arrow(
+    Pod5FileReader_t * reader,
+    size_t index,
+    ArrowArray * out_array,
+    ArrowSchema * out_schema)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_output_pointer_not_null(out_array)
+        || !check_output_pointer_not_null(out_schema))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(auto const batch, reader->reader->read_signal_record_batch(index));
+    POD5_C_RETURN_NOT_OK(arrow::ExportRecordBatch(*batch.batch(), out_array, out_schema));
+    return POD5_OK;
+}
+
 pod5_error_t pod5_get_read_batch_row_count(size_t * count, Pod5ReadRecordBatch * batch)
 {
     pod5_reset_error();
 
     if (!check_not_null(batch) || !check_output_pointer_not_null(count)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     *count = batch->batch.num_rows();
@@ -431,7 +863,7 @@ static pod5_error_t check_row_index_and_set_error(size_t row, size_t batch_size)
     if (row >= batch_size) {
         pod5_set_error(arrow::Status::IndexError(
             "Invalid index into batch. Index ", row, " with batch size ", batch_size));
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     return POD5_OK;
@@ -447,7 +879,7 @@ pod5_error_t pod5_get_read_batch_row_info_data(
     pod5_reset_error();
 
     if (!check_not_null(batch) || !check_output_pointer_not_null(row_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     static_assert(
@@ -457,52 +889,185 @@ pod5_error_t pod5_get_read_batch_row_info_data(
     if (struct_version == READ_BATCH_ROW_INFO_VERSION_3) {
         auto typed_row_data = static_cast<ReadBatchRowInfoV3 *>(row_data);
 
-        POD5_C_ASSIGN_OR_RAISE(auto cols, batch->batch.columns());
+        auto const & cols = batch->view;
 
         // Inform the caller of the version of the input table.
         *read_table_version = cols.table_version.as_int();
 
-        if (check_row_index_and_set_error(row, cols.read_id->length()) != POD5_OK) {
-            return g_pod5_error_no;
+        if (check_row_index_and_set_error(row, batch->batch.num_rows()) != POD5_OK) {
+            return t_pod5_error_no;
         }
 
-        auto read_id_val = cols.read_id->Value(row);
-        read_id_val.to_c_array(typed_row_data->read_id);
-
-        typed_row_data->read_number = cols.read_number->Value(row);
-        typed_row_data->start_sample = cols.start_sample->Value(row);
-        typed_row_data->median_before = cols.median_before->Value(row);
-        typed_row_data->channel = cols.channel->Value(row);
-        typed_row_data->well = cols.well->Value(row);
-        auto pore_type_col = std::static_pointer_cast<arrow::Int16Array>(cols.pore_type->indices());
-        typed_row_data->pore_type = pore_type_col->Value(row);
-        typed_row_data->calibration_offset = cols.calibration_offset->Value(row);
-        typed_row_data->calibration_scale = cols.calibration_scale->Value(row);
-        auto end_reason_col =
-            std::static_pointer_cast<arrow::Int16Array>(cols.end_reason->indices());
-        typed_row_data->end_reason = end_reason_col->Value(row);
-        typed_row_data->end_reason_forced = cols.end_reason_forced->Value(row);
-        auto run_info_col = std::static_pointer_cast<arrow::Int16Array>(cols.run_info->indices());
-        typed_row_data->run_info = run_info_col->Value(row);
-        typed_row_data->num_minknow_events = cols.num_minknow_events->Value(row);
-        typed_row_data->tracked_scaling_scale = cols.tracked_scaling_scale->Value(row);
-        typed_row_data->tracked_scaling_shift = cols.tracked_scaling_shift->Value(row);
-        typed_row_data->predicted_scaling_scale = cols.predicted_scaling_scale->Value(row);
-        typed_row_data->predicted_scaling_shift = cols.predicted_scaling_shift->Value(row);
-        typed_row_data->num_reads_since_mux_change = cols.num_reads_since_mux_change->Value(row);
-        typed_row_data->time_since_mux_change = cols.time_since_mux_change->Value(row);
-
-        typed_row_data->signal_row_count = cols.signal->value_length(row);
-        typed_row_data->num_samples = cols.num_samples->Value(row);
+        // Batches read with a projection only hold some columns - the others are left zeroed:
+        *typed_row_data = {};
+        auto const value = [row](auto const & column, auto & output) {
+            if (column) {
+                output = column[row];
+            }
+        };
+
+        if (cols.read_id) {
+            cols.read_id[row].to_c_array(typed_row_data->read_id);
+        }
+        value(cols.read_number, typed_row_data->read_number);
+        value(cols.start_sample, typed_row_data->start_sample);
+        value(cols.median_before, typed_row_data->median_before);
+        value(cols.channel, typed_row_data->channel);
+        value(cols.well, typed_row_data->well);
+        value(cols.pore_type, typed_row_data->pore_type);
+        value(cols.calibration_offset, typed_row_data->calibration_offset);
+        value(cols.calibration_scale, typed_row_data->calibration_scale);
+        value(cols.end_reason, typed_row_data->end_reason);
+        value(cols.end_reason_forced, typed_row_data->end_reason_forced);
+        value(cols.run_info, typed_row_data->run_info);
+        value(cols.num_minknow_events, typed_row_data->num_minknow_events);
+        value(cols.tracked_scaling_scale, typed_row_data->tracked_scaling_scale);
+        value(cols.tracked_scaling_shift, typed_row_data->tracked_scaling_shift);
+        value(cols.predicted_scaling_scale, typed_row_data->predicted_scaling_scale);
+        value(cols.predicted_scaling_shift, typed_row_data->predicted_scaling_shift);
+        value(cols.num_reads_since_mux_change, typed_row_data->num_reads_since_mux_change);
+        value(cols.time_since_mux_change, typed_row_data->time_since_mux_change);
+
+        if (cols.signal) {
+            typed_row_data->signal_row_count = cols.signal.value_length(row);
+        }
+        value(cols.num_samples, typed_row_data->num_samples);
     } else {
         pod5_set_error(
             arrow::Status::Invalid("Invalid struct version '", struct_version, "' passed"));
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     return POD5_OK;
 }
 
+pod5_error_t pod5_get_read_batch_column(
+    Pod5ReadRecordBatch_t * batch,
+    pod5_read_column_t column,
+    size_t row_start,
+    size_t row_count,
+    size_t value_size,
+    void * values)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(batch) || (row_count > 0 && !check_output_pointer_not_null(values))) {
+        return t_pod5_error_no;
+    }
+
+    auto const num_rows = batch->batch.num_rows();
+    if (row_start > num_rows || row_count > num_rows - row_start) {
+        pod5_set_error(arrow::Status::IndexError(
+            "Invalid rows [",
+            row_start,
+            ", ",
+            row_start + row_count,
+            ") of batch with ",
+            num_rows,
+            " rows"));
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(auto const cols, batch->batch.columns());
+
+    auto const check_value_size = [&](std::size_t expected_size) {
+        if (value_size != expected_size) {
+            pod5_set_error(arrow::Status::Invalid(
+                "Value size ",
+                value_size,
+                " does not match the column's value size ",
+                expected_size));
+            return false;
+        }
+        return true;
+    };
+    // Fixed width columns are copied straight out of the column's buffer:
+    auto const copy_values = [&](auto const & array) {
+        using ValueType = std::decay_t<decltype(*array->raw_values())>;
+        if (!check_columns_loaded(array) || !check_value_size(sizeof(ValueType))) {
+            return t_pod5_error_no;
+        }
+        std::copy_n(array->raw_values() + row_start, row_count, static_cast<ValueType *>(values));
+        return POD5_OK;
+    };
+    auto const copy_dictionary_indices = [&](auto const & array) {
+        if (!check_columns_loaded(array)) {
+            return t_pod5_error_no;
+        }
+        return copy_values(std::static_pointer_cast<arrow::Int16Array>(array->indices()));
+    };
+
+    switch (column) {
+    case POD5_READ_COLUMN_READ_ID:
+        if (!check_columns_loaded(cols.read_id) || !check_value_size(sizeof(read_id_t))) {
+            return t_pod5_error_no;
+        }
+        static_assert(sizeof(pod5::Uuid) == sizeof(read_id_t), "Read ids must be 16 bytes");
+        std::memcpy(values, cols.read_id->raw_values() + row_start, row_count * sizeof(read_id_t));
+        return POD5_OK;
+    case POD5_READ_COLUMN_READ_NUMBER:
+        return copy_values(cols.read_number);
+    case POD5_READ_COLUMN_START_SAMPLE:
+        return copy_values(cols.start_sample);
+    case POD5_READ_COLUMN_MEDIAN_BEFORE:
+        return copy_values(cols.median_before);
+    case POD5_READ_COLUMN_CHANNEL:
+        return copy_values(cols.channel);
+    case POD5_READ_COLUMN_WELL:
+        return copy_values(cols.well);
+    case POD5_READ_COLUMN_PORE_TYPE:
+        return copy_dictionary_indices(cols.pore_type);
+    case POD5_READ_COLUMN_CALIBRATION_OFFSET:
+        return copy_values(cols.calibration_offset);
+    case POD5_READ_COLUMN_CALIBRATION_SCALE:
+        return copy_values(cols.calibration_scale);
+    case POD5_READ_COLUMN_END_REASON:
+        return copy_dictionary_indices(cols.end_reason);
+    case POD5_READ_COLUMN_END_REASON_FORCED: {
+        // Booleans are bit packed, so are unpacked a row at a time:
+        if (!check_columns_loaded(cols.end_reason_forced) || !check_value_size(sizeof(uint8_t))) {
+            return t_pod5_error_no;
+        }
+        auto const output = static_cast<uint8_t *>(values);
+        for (std::size_t i = 0; i < row_count; ++i) {
+            output[i] = cols.end_reason_forced->Value(row_start + i);
+        }
+        return POD5_OK;
+    }
+    case POD5_READ_COLUMN_RUN_INFO:
+        return copy_dictionary_indices(cols.run_info);
+    case POD5_READ_COLUMN_NUM_MINKNOW_EVENTS:
+        return copy_values(cols.num_minknow_events);
+    case POD5_READ_COLUMN_TRACKED_SCALING_SCALE:
+        return copy_values(cols.tracked_scaling_scale);
+    case POD5_READ_COLUMN_TRACKED_SCALING_SHIFT:
+        return copy_values(cols.tracked_scaling_shift);
+    case POD5_READ_COLUMN_PREDICTED_SCALING_SCALE:
+        return copy_values(cols.predicted_scaling_scale);
+    case POD5_READ_COLUMN_PREDICTED_SCALING_SHIFT:
+        return copy_values(cols.predicted_scaling_shift);
+    case POD5_READ_COLUMN_NUM_READS_SINCE_MUX_CHANGE:
+        return copy_values(cols.num_reads_since_mux_change);
+    case POD5_READ_COLUMN_TIME_SINCE_MUX_CHANGE:
+        return copy_values(cols.time_since_mux_change);
+    case POD5_READ_COLUMN_NUM_SAMPLES:
+        return copy_values(cols.num_samples);
+    case POD5_READ_COLUMN_SIGNAL_ROW_COUNT: {
+        if (!check_columns_loaded(cols.signal) || !check_value_size(sizeof(uint32_t))) {
+            return t_pod5_error_no;
+        }
+        auto const output = static_cast<uint32_t *>(values);
+        for (std::size_t i = 0; i < row_count; ++i) {
+            output[i] = cols.signal->value_length(row_start + i);
+        }
+        return POD5_OK;
+    }
+    }
+
+    pod5_set_error(arrow::Status::Invalid("Invalid read column '", int(column), "' passed"));
+    return t_pod5_error_no;
+}
+
 pod5_error_t pod5_get_signal_row_indices(
     Pod5ReadRecordBatch * batch,
     size_t row,
@@ -512,12 +1077,15 @@ pod5_error_t pod5_get_signal_row_indices(
     pod5_reset_error();
 
     if (!check_not_null(batch) || !check_output_pointer_not_null(signal_row_indices)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     auto const signal_col = batch->batch.signal_column();
+    if (!check_columns_loaded(signal_col)) {
+        return t_pod5_error_no;
+    }
     if (check_row_index_and_set_error(row, signal_col->length()) != POD5_OK) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     auto const & row_data =
@@ -529,7 +1097,7 @@ pod5_error_t pod5_get_signal_row_indices(
             row_data->length(),
             " received ",
             signal_row_indices_count));
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     for (std::int64_t i = 0; i < signal_row_indices_count; ++i) {
@@ -547,13 +1115,16 @@ pod5_error_t pod5_get_calibration_extra_info(
     pod5_reset_error();
 
     if (!check_not_null(batch) || !check_output_pointer_not_null(calibration_extra_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(auto cols, batch->batch.columns());
+    if (!check_columns_loaded(cols.calibration_scale, cols.run_info)) {
+        return t_pod5_error_no;
+    }
 
     if (check_row_index_and_set_error(row, cols.calibration_scale->length()) != POD5_OK) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     auto scale = cols.calibration_scale->Value(row);
@@ -561,8 +1132,8 @@ pod5_error_t pod5_get_calibration_extra_info(
         std::static_pointer_cast<arrow::Int16Array>(cols.run_info->indices())->Value(row);
 
     POD5_C_ASSIGN_OR_RAISE(
-        auto const acquisition_id, batch->batch.get_run_info(run_info_dict_index));
-    POD5_C_ASSIGN_OR_RAISE(auto run_info_data, batch->reader->find_run_info(acquisition_id));
+        auto const run_info_data,
+        batch->dictionaries->run_info(batch->batch, *batch->reader, run_info_dict_index));
 
     calibration_extra_data->digitisation = run_info_data->adc_max - run_info_data->adc_min + 1;
     calibration_extra_data->range = scale * calibration_extra_data->digitisation;
@@ -622,32 +1193,172 @@ struct RunInfoDataCHelper : public RunInfoDictData {
     InternalMapHelper tracking_id_helper;
 };
 
-pod5_error_t
-pod5_get_run_info(Pod5ReadRecordBatch * batch, int16_t run_info, RunInfoDictData ** run_info_data)
-{
-    pod5_reset_error();
-
-    if (!check_not_null(batch) || !check_output_pointer_not_null(run_info_data)) {
-        return g_pod5_error_no;
-    }
-
-    POD5_C_ASSIGN_OR_RAISE(auto const acquisition_id, batch->batch.get_run_info(run_info));
-    POD5_C_ASSIGN_OR_RAISE(auto internal_data, batch->reader->find_run_info(acquisition_id));
+}  // extern "C"
 
-    auto data = std::make_unique<RunInfoDataCHelper>(std::move(internal_data));
-    *run_info_data = data.release();
-    return POD5_OK;
-}
+namespace {
 
-pod5_error_t pod5_get_file_run_info(
-    Pod5FileReader_t * file,
-    run_info_index_t run_info_index,
-    RunInfoDictData_t ** run_info_data)
+pod5_end_reason_t to_c_end_reason(pod5::ReadEndReason end_reason)
 {
-    pod5_reset_error();
+    switch (end_reason) {
+    case pod5::ReadEndReason::mux_change:
+        return POD5_END_REASON_MUX_CHANGE;
+    case pod5::ReadEndReason::unblock_mux_change:
+        return POD5_END_REASON_UNBLOCK_MUX_CHANGE;
+    case pod5::ReadEndReason::data_service_unblock_mux_change:
+        return POD5_END_REASON_DATA_SERVICE_UNBLOCK_MUX_CHANGE;
+    case pod5::ReadEndReason::signal_positive:
+        return POD5_END_REASON_SIGNAL_POSITIVE;
+    case pod5::ReadEndReason::signal_negative:
+        return POD5_END_REASON_SIGNAL_NEGATIVE;
+    case pod5::ReadEndReason::api_request:
+        return POD5_END_REASON_API_REQUEST;
+    case pod5::ReadEndReason::device_data_error:
+        return POD5_END_REASON_DEVICE_DATA_ERROR;
+    case pod5::ReadEndReason::analysis_config_change:
+        return POD5_END_REASON_ANALYSIS_CONFIG_CHANGE;
+    default:
+    case pod5::ReadEndReason::unknown:
+        return POD5_END_REASON_UNKNOWN;
+    }
+}
+
+}  // namespace
+
+/// \brief The read table's dictionary values, each decoded the first time it is asked for and
+///        kept for as long as the file or a batch read from it is open.
+///
+/// A dictionary index means the same value in every batch of a file, as later batches only ever
+/// append to the dictionaries (as deltas), so values are cached by index for the whole file.
+class ReadDictionaryCache {
+public:
+    struct EndReason {
+        pod5_end_reason_t value;
+        std::string name;
+    };
+
+    template <typename T>
+    using Decoded = pod5::Result<std::unique_ptr<T>>;
+
+    pod5::Result<std::string const *> pore_type(
+        pod5::ReadTableRecordBatch const & batch,
+        std::int16_t index)
+    {
+        return find_or_decode(m_pore_types, index, [&]() -> Decoded<std::string> {
+            ARROW_ASSIGN_OR_RAISE(auto pore_type, batch.get_pore_type(index));
+            return std::make_unique<std::string>(std::move(pore_type));
+        });
+    }
+
+    pod5::Result<EndReason const *> end_reason(
+        pod5::ReadTableRecordBatch const & batch,
+        std::int16_t index)
+    {
+        return find_or_decode(m_end_reasons, index, [&]() -> Decoded<EndReason> {
+            ARROW_ASSIGN_OR_RAISE(auto end_reason, batch.get_end_reason(index));
+            return std::make_unique<EndReason>(
+                EndReason{to_c_end_reason(end_reason.first), std::move(end_reason.second)});
+        });
+    }
+
+    pod5::Result<RunInfoDataCHelper const *> run_info(
+        pod5::ReadTableRecordBatch const & batch,
+        pod5::FileReader const & reader,
+        std::int16_t index)
+    {
+        // Helpers point into themselves, so are made in place rather than moved:
+        return find_or_decode(m_run_infos, index, [&]() -> Decoded<RunInfoDataCHelper> {
+            ARROW_ASSIGN_OR_RAISE(auto const acquisition_id, batch.get_run_info(index));
+            ARROW_ASSIGN_OR_RAISE(auto internal_data, reader.find_run_info(acquisition_id));
+            return std::make_unique<RunInfoDataCHelper>(std::move(internal_data));
+        });
+    }
+
+private:
+    // Values are held by pointer so those handed out stay put as the list grows:
+    template <typename T, typename Decode>
+    pod5::Result<T const *> find_or_decode(
+        std::vector<std::unique_ptr<T>> & values,
+        std::int16_t index,
+        Decode && decode)
+    {
+        if (index < 0) {
+            return arrow::Status::IndexError("Invalid negative dictionary index ", index);
+        }
+        {
+            std::shared_lock<std::shared_mutex> l(m_mutex);
+            if (std::size_t(index) < values.size() && values[index]) {
+                return values[index].get();
+            }
+        }
+
+        std::lock_guard<std::shared_mutex> l(m_mutex);
+        if (std::size_t(index) < values.size() && values[index]) {
+            return values[index].get();
+        }
+        ARROW_ASSIGN_OR_RAISE(auto value, decode());
+        if (std::size_t(index) >= values.size()) {
+            values.resize(index + 1);
+        }
+        values[index] = std::move(value);
+        return values[index].get();
+    }
+
+    std::shared_mutex m_mutex;
+    std::vector<std::unique_ptr<std::string>> m_pore_types;
+    std::vector<std::unique_ptr<EndReason>> m_end_reasons;
+    std::vector<std::unique_ptr<RunInfoDataCHelper>> m_run_infos;
+};
+
+Pod5FileReader::Pod5FileReader(std::shared_ptr<pod5::FileReader> && reader_)
+: reader(std::move(reader_))
+, dictionaries(std::make_shared<ReadDictionaryCache>())
+{
+}
+
+extern "C" {
+
+pod5_error_t
+pod5_get_run_info(Pod5ReadRecordBatch * batch, int16_t run_info, RunInfoDictData ** run_info_data)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(batch) || !check_output_pointer_not_null(run_info_data)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto const cached, batch->dictionaries->run_info(batch->batch, *batch->reader, run_info));
+
+    auto data = std::make_unique<RunInfoDataCHelper>(cached->internal_data);
+    *run_info_data = data.release();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_cached_run_info(
+    Pod5ReadRecordBatch_t * batch,
+    int16_t run_info,
+    RunInfoDictData_t const ** run_info_data)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(batch) || !check_output_pointer_not_null(run_info_data)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        *run_info_data, batch->dictionaries->run_info(batch->batch, *batch->reader, run_info));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_file_run_info(
+    Pod5FileReader_t * file,
+    run_info_index_t run_info_index,
+    RunInfoDictData_t ** run_info_data)
+{
+    pod5_reset_error();
 
     if (!check_not_null(file) || !check_output_pointer_not_null(run_info_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(auto internal_data, file->reader->get_run_info(run_info_index));
@@ -662,7 +1373,7 @@ pod5_error_t pod5_free_run_info(RunInfoDictData_t * run_info_data)
     pod5_reset_error();
 
     if (!check_not_null(run_info_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     std::unique_ptr<RunInfoDataCHelper> helper(static_cast<RunInfoDataCHelper *>(run_info_data));
@@ -683,7 +1394,7 @@ pod5_error_t pod5_get_file_run_info_count(
     pod5_reset_error();
 
     if (!check_not_null(file)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(*run_info_count, file->reader->get_run_info_count());
@@ -704,49 +1415,41 @@ pod5_error_t pod5_get_end_reason(
         || !check_output_pointer_not_null(end_reason_string_value)
         || !check_output_pointer_not_null(end_reason_string_value_size))
     {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
-    POD5_C_ASSIGN_OR_RAISE(auto const end_reason_val, batch->batch.get_end_reason(end_reason));
+    POD5_C_ASSIGN_OR_RAISE(
+        auto const end_reason_val, batch->dictionaries->end_reason(batch->batch, end_reason));
     auto const input_buffer_len = *end_reason_string_value_size;
-    *end_reason_string_value_size = end_reason_val.second.size() + 1;
-    if (end_reason_val.second.size() >= input_buffer_len) {
+    *end_reason_string_value_size = end_reason_val->name.size() + 1;
+    if (end_reason_val->name.size() >= input_buffer_len) {
         return POD5_ERROR_STRING_NOT_LONG_ENOUGH;
     }
 
-    switch (end_reason_val.first) {
-    case pod5::ReadEndReason::mux_change:
-        *end_reason_value = POD5_END_REASON_MUX_CHANGE;
-        break;
-    case pod5::ReadEndReason::unblock_mux_change:
-        *end_reason_value = POD5_END_REASON_UNBLOCK_MUX_CHANGE;
-        break;
-    case pod5::ReadEndReason::data_service_unblock_mux_change:
-        *end_reason_value = POD5_END_REASON_DATA_SERVICE_UNBLOCK_MUX_CHANGE;
-        break;
-    case pod5::ReadEndReason::signal_positive:
-        *end_reason_value = POD5_END_REASON_SIGNAL_POSITIVE;
-        break;
-    case pod5::ReadEndReason::signal_negative:
-        *end_reason_value = POD5_END_REASON_SIGNAL_NEGATIVE;
-        break;
-    case pod5::ReadEndReason::api_request:
-        *end_reason_value = POD5_END_REASON_API_REQUEST;
-        break;
-    case pod5::ReadEndReason::device_data_error:
-        *end_reason_value = POD5_END_REASON_DEVICE_DATA_ERROR;
-        break;
-    case pod5::ReadEndReason::analysis_config_change:
-        *end_reason_value = POD5_END_REASON_ANALYSIS_CONFIG_CHANGE;
-        break;
-    default:
-    case pod5::ReadEndReason::unknown:
-        *end_reason_value = POD5_END_REASON_UNKNOWN;
-        break;
+    *end_reason_value = end_reason_val->value;
+    std::copy(end_reason_val->name.begin(), end_reason_val->name.end(), end_reason_string_value);
+    end_reason_string_value[end_reason_val->name.size()] = '\0';
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_cached_end_reason(
+    Pod5ReadRecordBatch_t * batch,
+    int16_t end_reason,
+    pod5_end_reason_t * end_reason_value,
+    char const ** end_reason_string_value)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(batch) || !check_output_pointer_not_null(end_reason_value)
+        || !check_output_pointer_not_null(end_reason_string_value))
+    {
+        return t_pod5_error_no;
     }
 
-    std::copy(end_reason_val.second.begin(), end_reason_val.second.end(), end_reason_string_value);
-    end_reason_string_value[*end_reason_string_value_size] = '\0';
+    POD5_C_ASSIGN_OR_RAISE(
+        auto const end_reason_val, batch->dictionaries->end_reason(batch->batch, end_reason));
+    *end_reason_value = end_reason_val->value;
+    *end_reason_string_value = end_reason_val->name.c_str();
     return POD5_OK;
 }
 
@@ -761,18 +1464,36 @@ pod5_error_t pod5_get_pore_type(
     if (!check_output_pointer_not_null(pore_type_string_value)
         || !check_output_pointer_not_null(pore_type_string_value_size))
     {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
-    POD5_C_ASSIGN_OR_RAISE(auto const pore_type_str, batch->batch.get_pore_type(pore_type));
+    POD5_C_ASSIGN_OR_RAISE(
+        auto const pore_type_str, batch->dictionaries->pore_type(batch->batch, pore_type));
     auto const input_buffer_len = *pore_type_string_value_size;
-    *pore_type_string_value_size = pore_type_str.size() + 1;
-    if (pore_type_str.size() >= input_buffer_len) {
+    *pore_type_string_value_size = pore_type_str->size() + 1;
+    if (pore_type_str->size() >= input_buffer_len) {
         return POD5_ERROR_STRING_NOT_LONG_ENOUGH;
     }
 
-    std::copy(pore_type_str.begin(), pore_type_str.end(), pore_type_string_value);
-    pore_type_string_value[*pore_type_string_value_size] = '\0';
+    std::copy(pore_type_str->begin(), pore_type_str->end(), pore_type_string_value);
+    pore_type_string_value[pore_type_str->size()] = '\0';
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_cached_pore_type(
+    Pod5ReadRecordBatch_t * batch,
+    int16_t pore_type,
+    char const ** pore_type_string_value)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(batch) || !check_output_pointer_not_null(pore_type_string_value)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto const pore_type_str, batch->dictionaries->pore_type(batch->batch, pore_type));
+    *pore_type_string_value = pore_type_str->c_str();
     return POD5_OK;
 }
 
@@ -783,6 +1504,85 @@ public:
     pod5::SignalTableRecordBatch batch;
 };
 
+pod5_error_t pod5_prefetch_signal_rows(
+    Pod5FileReader * reader,
+    size_t signal_rows_count,
+    uint64_t const * signal_rows)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_not_null(signal_rows)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_RETURN_NOT_OK(
+        reader->reader->prefetch_signal_rows(gsl::make_span(signal_rows, signal_rows_count)));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_set_signal_access_plan(
+    Pod5FileReader * reader,
+    uint32_t const * batch_counts,
+    uint32_t const * batch_rows,
+    size_t batch_rows_count)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_not_null(batch_counts)
+        || !check_not_null(batch_rows))
+    {
+        return t_pod5_error_no;
+    }
+
+    // Planned as the C API's signal loader loads reads:
+    POD5_C_RETURN_NOT_OK(reader->reader->set_signal_access_plan(
+        gsl::make_span(batch_counts, reader->reader->num_read_record_batches()),
+        gsl::make_span(batch_rows, batch_rows_count),
+        true));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_clear_signal_access_plan(Pod5FileReader * reader)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_RETURN_NOT_OK(reader->reader->clear_signal_access_plan());
+    return POD5_OK;
+}
+
+pod5_error_t pod5_estimate_traversal_cost(
+    Pod5FileReader * reader,
+    uint32_t const * batch_counts,
+    uint32_t const * batch_rows,
+    size_t batch_rows_count,
+    Pod5TraversalCost_t * cost)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_not_null(batch_counts)
+        || !check_not_null(batch_rows) || !check_output_pointer_not_null(cost))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto const estimate,
+        reader->reader->estimate_traversal_cost(
+            gsl::make_span(batch_counts, reader->reader->num_read_record_batches()),
+            gsl::make_span(batch_rows, batch_rows_count)));
+    cost->read_count = estimate.read_count;
+    cost->signal_row_count = estimate.signal_row_count;
+    cost->signal_batch_count = estimate.signal_batch_count;
+    cost->signal_batch_bytes = estimate.signal_batch_bytes;
+    cost->sample_count = estimate.sample_count;
+    cost->estimated_seeks = estimate.estimated_seeks;
+    return POD5_OK;
+}
+
 pod5_error_t pod5_get_signal_row_info(
     Pod5FileReader * reader,
     size_t signal_rows_count,
@@ -792,7 +1592,7 @@ pod5_error_t pod5_get_signal_row_info(
     pod5_reset_error();
 
     if (!check_not_null(reader) || !check_output_pointer_not_null(signal_row_info)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     // Sort all rows first, in order to make searching faster.
@@ -849,7 +1649,7 @@ pod5_error_t pod5_get_signal(
     if (!check_not_null(reader) || !check_not_null(row_info)
         || !check_output_pointer_not_null(sample_data))
     {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     SignalRowInfoCHelper * row_info_data = static_cast<SignalRowInfoCHelper *>(row_info);
@@ -869,7 +1669,7 @@ pod5_error_t pod5_get_read_complete_sample_count(
     pod5_reset_error();
 
     if (!check_not_null(reader) || !check_output_pointer_not_null(sample_count)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(auto const & signal_rows, batch->batch.get_signal_rows(batch_row));
@@ -891,17 +1691,579 @@ pod5_error_t pod5_get_read_complete_signal(
     pod5_reset_error();
 
     if (!check_not_null(reader) || !check_output_pointer_not_null(signal)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(auto const & signal_rows, batch->batch.get_signal_rows(batch_row));
+
+    POD5_C_RETURN_NOT_OK(reader->reader->extract_samples(
+        gsl::make_span(signal_rows->raw_values(), signal_rows->length()),
+        gsl::make_span(signal, sample_count)));
+    return POD5_OK;
+}
+
+namespace {
+// Pool shared by calls which spread their work across threads, remade in forked children.
+std::shared_ptr<pod5::ThreadPool> shared_thread_pool() { return pod5::process_thread_pool(); }
+}  // namespace
+
+pod5_error_t pod5_get_read_complete_signal_options(
+    Pod5FileReader_t * reader,
+    Pod5ReadRecordBatch_t * batch,
+    size_t batch_row,
+    size_t sample_count,
+    int16_t * signal,
+    Pod5ReadSignalOptions_t const * options)
+{
+    if (!options || !options->parallel_decode) {
+        return pod5_get_read_complete_signal(reader, batch, batch_row, sample_count, signal);
+    }
+
+    pod5_reset_error();
+
+    if (!check_not_null(reader) || !check_not_null(batch)
+        || !check_output_pointer_not_null(signal))
+    {
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(auto const & signal_rows, batch->batch.get_signal_rows(batch_row));
 
     POD5_C_RETURN_NOT_OK(reader->reader->extract_samples(
         gsl::make_span(signal_rows->raw_values(), signal_rows->length()),
+        gsl::make_span(signal, sample_count),
+        *shared_thread_pool()));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_reads_complete_signal_batch(
+    Pod5FileReader_t * reader,
+    Pod5ReadRecordBatch_t * batch,
+    size_t row_count,
+    uint32_t const * batch_rows,
+    size_t sample_count,
+    int16_t * signal,
+    uint64_t * signal_offsets)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(reader) || !check_not_null(batch)
+        || !check_output_pointer_not_null(signal_offsets))
+    {
+        return t_pod5_error_no;
+    }
+    if (row_count > 0 && !check_not_null(batch_rows)) {
+        return t_pod5_error_no;
+    }
+
+    std::vector<std::shared_ptr<arrow::UInt64Array>> signal_rows;
+    std::vector<gsl::span<std::uint64_t const>> reads_row_indices;
+    signal_rows.reserve(row_count);
+    reads_row_indices.reserve(row_count);
+    for (std::size_t i = 0; i < row_count; ++i) {
+        POD5_C_ASSIGN_OR_RAISE(auto read_signal_rows, batch->batch.get_signal_rows(batch_rows[i]));
+        reads_row_indices.emplace_back(read_signal_rows->raw_values(), read_signal_rows->length());
+        signal_rows.push_back(std::move(read_signal_rows));
+    }
+
+    if (!signal) {
+        std::uint64_t total_sample_count = 0;
+        for (std::size_t i = 0; i < row_count; ++i) {
+            signal_offsets[i] = total_sample_count;
+            POD5_C_ASSIGN_OR_RAISE(
+                auto const read_sample_count,
+                reader->reader->extract_sample_count(reads_row_indices[i]));
+            total_sample_count += read_sample_count;
+        }
+        signal_offsets[row_count] = total_sample_count;
+        return POD5_OK;
+    }
+
+    POD5_C_RETURN_NOT_OK(reader->reader->extract_samples_for_reads(
+        gsl::make_span(reads_row_indices),
+        gsl::make_span(signal, sample_count),
+        gsl::make_span(signal_offsets, row_count + 1),
+        *shared_thread_pool()));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_read_signal_range(
+    Pod5FileReader_t * reader,
+    Pod5ReadRecordBatch_t * batch,
+    size_t batch_row,
+    size_t sample_start,
+    size_t sample_count,
+    int16_t * signal)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(reader) || !check_not_null(batch)
+        || !check_output_pointer_not_null(signal))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(auto const & signal_rows, batch->batch.get_signal_rows(batch_row));
+
+    POD5_C_RETURN_NOT_OK(reader->reader->extract_samples_range(
+        gsl::make_span(signal_rows->raw_values(), signal_rows->length()),
+        sample_start,
+        gsl::make_span(signal, sample_count)));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_read_complete_signal_pa(
+    Pod5FileReader_t * reader,
+    Pod5ReadRecordBatch_t * batch,
+    size_t batch_row,
+    size_t sample_count,
+    float * signal)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(reader) || !check_not_null(batch)
+        || !check_output_pointer_not_null(signal))
+    {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(auto cols, batch->batch.columns());
+    if (!check_columns_loaded(cols.calibration_offset, cols.calibration_scale)) {
+        return t_pod5_error_no;
+    }
+    if (check_row_index_and_set_error(batch_row, cols.calibration_scale->length()) != POD5_OK) {
+        return t_pod5_error_no;
+    }
+    pod5::SignalCalibration const calibration{
+        cols.calibration_offset->Value(batch_row), cols.calibration_scale->Value(batch_row)};
+
+    POD5_C_ASSIGN_OR_RAISE(auto const & signal_rows, batch->batch.get_signal_rows(batch_row));
+
+    POD5_C_RETURN_NOT_OK(reader->reader->extract_samples_calibrated(
+        gsl::make_span(signal_rows->raw_values(), signal_rows->length()),
+        calibration,
         gsl::make_span(signal, sample_count)));
     return POD5_OK;
 }
 
+pod5_error_t pod5_get_signal_summary_decimations(
+    Pod5FileReader_t * reader,
+    size_t decimation_capacity,
+    uint32_t * decimations,
+    size_t * decimation_count)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_output_pointer_not_null(decimation_count)) {
+        return t_pod5_error_no;
+    }
+
+    auto const summary = reader->reader->signal_summary();
+    if (!summary) {
+        *decimation_count = 0;
+        return POD5_OK;
+    }
+
+    auto const & summary_decimations = summary->decimations();
+    *decimation_count = summary_decimations.size();
+    if (!decimations) {
+        return POD5_OK;
+    }
+    if (decimation_capacity < summary_decimations.size()) {
+        pod5_set_error(arrow::Status::CapacityError(
+            "Space for ",
+            decimation_capacity,
+            " decimations given, file has ",
+            summary_decimations.size()));
+        return t_pod5_error_no;
+    }
+    std::copy(summary_decimations.begin(), summary_decimations.end(), decimations);
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_read_signal_summary(
+    Pod5FileReader_t * reader,
+    read_id_t const read_id,
+    uint32_t decimation,
+    size_t capacity,
+    int16_t * min,
+    int16_t * max,
+    int16_t * mean,
+    size_t * level_size,
+    uint8_t * has_summary)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_not_null(read_id)
+        || !check_output_pointer_not_null(level_size)
+        || !check_output_pointer_not_null(has_summary))
+    {
+        return t_pod5_error_no;
+    }
+    if (min && (!check_output_pointer_not_null(max) || !check_output_pointer_not_null(mean))) {
+        return t_pod5_error_no;
+    }
+
+    *has_summary = 0;
+    auto const summary = reader->reader->signal_summary();
+    if (!summary) {
+        return POD5_OK;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto const level,
+        summary->find_level(*reinterpret_cast<pod5::Uuid const *>(read_id), decimation));
+    if (!level) {
+        return POD5_OK;
+    }
+
+    if (min) {
+        if (capacity < level->size()) {
+            pod5_set_error(arrow::Status::CapacityError(
+                "Space for ", capacity, " summary values given, summary has ", level->size()));
+            return t_pod5_error_no;
+        }
+        std::copy(level->min.begin(), level->min.end(), min);
+        std::copy(level->max.begin(), level->max.end(), max);
+        std::copy(level->mean.begin(), level->mean.end(), mean);
+    }
+    *level_size = level->size();
+    *has_summary = 1;
+    return POD5_OK;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+pod5_error_t pod5_create_signal_loader(
+    Pod5FileReader_t * reader,
+    uint32_t const * batch_counts,
+    size_t batch_counts_count,
+    uint32_t const * batch_rows,
+    size_t batch_rows_count,
+    Pod5SignalLoaderOptions_t const * options,
+    Pod5SignalLoader_t ** loader)
+{
+    pod5_reset_error();
+
+    if (!check_file_not_null(reader) || !check_output_pointer_not_null(loader)) {
+        return t_pod5_error_no;
+    }
+    if ((batch_counts == nullptr) != (batch_rows == nullptr)) {
+        pod5_set_error(arrow::Status::Invalid(
+            "batch_counts and batch_rows must both be given, or both be null"));
+        return t_pod5_error_no;
+    }
+
+    auto const read_batch_count = reader->reader->num_read_record_batches();
+    auto output = std::make_unique<Pod5SignalLoader>();
+    output->batch_rows_offsets.reserve(read_batch_count + 1);
+    if (batch_counts) {
+        if (batch_counts_count != read_batch_count) {
+            pod5_set_error(arrow::Status::Invalid(
+                "batch_counts_count (",
+                batch_counts_count,
+                ") must equal the file's read table batch count (",
+                read_batch_count,
+                ")"));
+            return t_pod5_error_no;
+        }
+
+        output->batch_counts.assign(batch_counts, batch_counts + batch_counts_count);
+        std::size_t offset = 0;
+        for (auto const count : output->batch_counts) {
+            output->batch_rows_offsets.push_back(offset);
+            offset += count;
+        }
+        output->batch_rows_offsets.push_back(offset);
+        if (offset > batch_rows_count) {
+            pod5_set_error(arrow::Status::Invalid(
+                "batch_rows_count (",
+                batch_rows_count,
+                ") is less than the sum of batch_counts (",
+                offset,
+                ")"));
+            return t_pod5_error_no;
+        }
+        output->batch_rows.assign(batch_rows, batch_rows + offset);
+    }
+
+    Pod5SignalLoaderOptions_t const default_options{};
+    if (!options) {
+        options = &default_options;
+    }
+    output->samples_mode = options->sample_counts_only
+                               ? pod5::AsyncSignalLoader::SamplesMode::NoSamples
+                               : pod5::AsyncSignalLoader::SamplesMode::Samples;
+
+    auto const worker_count = options->worker_count != 0
+                                  ? options->worker_count
+                                  : std::max(1u, std::thread::hardware_concurrency());
+    auto const max_pending_batches =
+        options->max_pending_batches != 0 ? options->max_pending_batches : 10;
+    output->loader = std::make_unique<pod5::AsyncSignalLoader>(
+        reader->reader,
+        output->samples_mode,
+        gsl::make_span(output->batch_counts),
+        gsl::make_span(output->batch_rows),
+        worker_count,
+        max_pending_batches,
+        pod5::AsyncSignalLoader::DEFAULT_PREFETCH_DISTANCE,
+        options->max_pending_bytes,
+        pod5::AsyncSignalLoader::RowOrder::SignalTable,
+        options->adaptive_worker_count != 0);
+
+    *loader = output.release();
+    return POD5_OK;
+}
+
+namespace {
+class SignalLoaderBatchCHelper : public Pod5SignalLoaderBatch {
+public:
+    SignalLoaderBatchCHelper(
+        std::unique_ptr<pod5::CachedBatchSignalData> && data_,
+        std::vector<std::uint32_t> && batch_rows_)
+    : data(std::move(data_))
+    , rows(std::move(batch_rows_))
+    {
+        batch_index = data->batch_index();
+        row_count = data->sample_count().size();
+        batch_rows = rows.data();
+        sample_counts = data->sample_count().data();
+        sample_offsets = data->sample_offsets().data();
+        samples = data->all_samples().empty() ? nullptr : data->all_samples().data();
+    }
+
+    std::unique_ptr<pod5::CachedBatchSignalData> data;
+    std::vector<std::uint32_t> rows;
+};
+
+pod5_error_t release_signal_loader_batch(
+    Pod5SignalLoader_t * loader,
+    Pod5SignalLoaderBatch_t ** batch,
+    bool any_completed)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(loader) || !check_output_pointer_not_null(batch)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(
+        auto data,
+        any_completed ? loader->loader->release_next_completed_batch()
+                      : loader->loader->release_next_batch());
+    if (!data) {
+        *batch = nullptr;
+        return POD5_OK;
+    }
+
+    // Copy the batch's rows out of the plan, so the batch can outlive the loader:
+    std::vector<std::uint32_t> rows;
+    auto const row_count = data->sample_count().size();
+    if (!loader->batch_counts.empty()) {
+        auto const rows_begin =
+            loader->batch_rows.begin() + loader->batch_rows_offsets[data->batch_index()];
+        rows.assign(rows_begin, rows_begin + row_count);
+    } else {
+        rows.resize(row_count);
+        std::iota(rows.begin(), rows.end(), 0);
+    }
+
+    *batch = new SignalLoaderBatchCHelper(std::move(data), std::move(rows));
+    return POD5_OK;
+}
+}  // namespace
+
+pod5_error_t pod5_signal_loader_release_next_batch(
+    Pod5SignalLoader_t * loader,
+    Pod5SignalLoaderBatch_t ** batch)
+{
+    return release_signal_loader_batch(loader, batch, false);
+}
+
+pod5_error_t pod5_signal_loader_release_next_completed_batch(
+    Pod5SignalLoader_t * loader,
+    Pod5SignalLoaderBatch_t ** batch)
+{
+    return release_signal_loader_batch(loader, batch, true);
+}
+
+pod5_error_t pod5_free_signal_loader_batch(Pod5SignalLoaderBatch_t * batch)
+{
+    pod5_reset_error();
+
+    std::unique_ptr<SignalLoaderBatchCHelper> helper(
+        static_cast<SignalLoaderBatchCHelper *>(batch));
+    helper.reset();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_signal_loader_worker_count(Pod5SignalLoader_t * loader, size_t * worker_count)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(loader) || !check_output_pointer_not_null(worker_count)) {
+        return t_pod5_error_no;
+    }
+
+    *worker_count = loader->loader->worker_count();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_close_and_free_signal_loader(Pod5SignalLoader_t * loader)
+{
+    pod5_reset_error();
+
+    std::unique_ptr<Pod5SignalLoader> ptr{loader};
+    ptr.reset();
+    return POD5_OK;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+Pod5DatasetReader * pod5_open_dataset(
+    char const * const * filenames,
+    size_t file_count,
+    Pod5DatasetReaderOptions_t const * options)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(filenames)) {
+        return nullptr;
+    }
+
+    std::vector<std::string> file_paths;
+    file_paths.reserve(file_count);
+    for (std::size_t i = 0; i < file_count; ++i) {
+        if (!check_string_not_empty(filenames[i])) {
+            return nullptr;
+        }
+        file_paths.emplace_back(filenames[i]);
+    }
+
+    pod5::DatasetReaderOptions internal_options;
+    if (options) {
+        internal_options.set_max_open_files(options->max_open_files);
+        if (options->index_threads != 0) {
+            internal_options.set_index_threads(options->index_threads);
+        }
+        pod5::FileReaderOptions file_reader_options;
+        file_reader_options.set_force_disable_file_mapping(options->force_disable_file_mapping);
+        internal_options.set_file_reader_options(file_reader_options);
+    }
+
+    auto internal_dataset = pod5::open_dataset_reader(std::move(file_paths), internal_options);
+    if (!internal_dataset.ok()) {
+        pod5_set_error(internal_dataset.status());
+        return nullptr;
+    }
+
+    auto dataset = std::make_unique<Pod5DatasetReader>(std::move(*internal_dataset));
+    return dataset.release();
+}
+
+pod5_error_t pod5_close_and_free_dataset(Pod5DatasetReader_t * dataset)
+{
+    pod5_reset_error();
+
+    std::unique_ptr<Pod5DatasetReader> ptr{dataset};
+    ptr.reset();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_dataset_file_count(Pod5DatasetReader_t * dataset, size_t * count)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(dataset) || !check_output_pointer_not_null(count)) {
+        return t_pod5_error_no;
+    }
+
+    *count = dataset->dataset->file_count();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_dataset_read_count(Pod5DatasetReader_t * dataset, size_t * count)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(dataset) || !check_output_pointer_not_null(count)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(*count, dataset->dataset->read_count());
+    return POD5_OK;
+}
+
+pod5_error_t pod5_get_dataset_file_reader(
+    Pod5DatasetReader_t * dataset,
+    size_t file_index,
+    Pod5FileReader_t ** reader)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(dataset) || !check_output_pointer_not_null(reader)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_ASSIGN_OR_RAISE(auto internal_reader, dataset->dataset->file_reader(file_index));
+    *reader = std::make_unique<Pod5FileReader>(std::move(internal_reader)).release();
+    return POD5_OK;
+}
+
+pod5_error_t pod5_load_dataset_index(Pod5DatasetReader_t * dataset, char const * index_filename)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(dataset) || !check_string_not_empty(index_filename)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_RETURN_NOT_OK(dataset->dataset->load_index(index_filename));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_write_dataset_index(Pod5DatasetReader_t * dataset, char const * index_filename)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(dataset) || !check_string_not_empty(index_filename)) {
+        return t_pod5_error_no;
+    }
+
+    POD5_C_RETURN_NOT_OK(dataset->dataset->write_index(index_filename));
+    return POD5_OK;
+}
+
+pod5_error_t pod5_plan_dataset_traversal(
+    Pod5DatasetReader_t * dataset,
+    uint8_t const * read_id_array,
+    size_t read_id_count,
+    DatasetReadLocation_t * locations,
+    size_t * find_success_count_out)
+{
+    pod5_reset_error();
+
+    if (!check_not_null(dataset) || !check_not_null(read_id_array)
+        || !check_output_pointer_not_null(locations))
+    {
+        return t_pod5_error_no;
+    }
+
+    static_assert(
+        sizeof(DatasetReadLocation_t) == sizeof(pod5::DatasetReadLocation),
+        "C and C++ dataset read locations must share a layout");
+    POD5_C_ASSIGN_OR_RAISE(
+        auto find_success_count,
+        dataset->dataset->search_for_read_ids(
+            gsl::make_span(reinterpret_cast<pod5::Uuid const *>(read_id_array), read_id_count),
+            gsl::make_span(
+                reinterpret_cast<pod5::DatasetReadLocation *>(locations), read_id_count)));
+
+    if (find_success_count_out) {
+        *find_success_count_out = find_success_count;
+    }
+    return POD5_OK;
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 Pod5FileWriter *
 pod5_create_file(char const * filename, char const * writer_name, Pod5WriterOptions const * options)
@@ -941,7 +2303,7 @@ pod5_error_t pod5_add_pore(int16_t * pore_index, Pod5FileWriter * file, char con
     if (!check_string_not_empty(pore_type) || !check_file_not_null(file)
         || !check_output_pointer_not_null(pore_index))
     {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(*pore_index, file->writer->add_pore_type(pore_type));
@@ -979,7 +2341,7 @@ pod5_error_t pod5_add_run_info(
     pod5_reset_error();
 
     if (!check_file_not_null(file)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     auto const parse_map =
@@ -1165,7 +2527,7 @@ pod5_error_t pod5_add_reads_data(
     pod5_reset_error();
 
     if (!check_file_not_null(file) || !check_read_data_struct(struct_version, row_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     for (std::uint32_t read = 0; read < read_count; ++read) {
@@ -1173,7 +2535,7 @@ pod5_error_t pod5_add_reads_data(
         if (!load_struct_row_into_read_data(
                 file->writer, read_data, struct_version, row_data, read))
         {
-            return g_pod5_error_no;
+            return t_pod5_error_no;
         }
 
         POD5_C_RETURN_NOT_OK(file->writer->add_complete_read(
@@ -1196,7 +2558,7 @@ pod5_error_t pod5_add_reads_data_pre_compressed(
     pod5_reset_error();
 
     if (!check_file_not_null(file) || !check_read_data_struct(struct_version, row_data)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     for (std::uint32_t read = 0; read < read_count; ++read) {
@@ -1204,7 +2566,7 @@ pod5_error_t pod5_add_reads_data_pre_compressed(
         if (!load_struct_row_into_read_data(
                 file->writer, read_data, struct_version, row_data, read))
         {
-            return g_pod5_error_no;
+            return t_pod5_error_no;
         }
 
         std::uint64_t total_sample_count = 0;
@@ -1246,7 +2608,7 @@ pod5_error_t pod5_vbz_compress_signal(
     if (!check_not_null(signal) || !check_output_pointer_not_null(compressed_signal_out)
         || !check_output_pointer_not_null(compressed_signal_size))
     {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     POD5_C_ASSIGN_OR_RAISE(
@@ -1260,7 +2622,7 @@ pod5_error_t pod5_vbz_compress_signal(
             ") is greater than provided buffer size (",
             compressed_signal_size,
             ")"));
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     std::copy(buffer->data(), buffer->data() + buffer->size(), compressed_signal_out);
@@ -1269,6 +2631,40 @@ pod5_error_t pod5_vbz_compress_signal(
     return POD5_OK;
 }
 
+pod5_error_t pod5_vbz_compress_signal_batch(
+    size_t read_count,
+    int16_t const ** signal,
+    size_t const * signal_size,
+    char * compressed_signal_out,
+    size_t compressed_signal_out_size,
+    size_t * compressed_signal_offsets)
+{
+    pod5_reset_error();
+
+    if (read_count > 0 && (!check_not_null(signal) || !check_not_null(signal_size))) {
+        return t_pod5_error_no;
+    }
+    if (!check_output_pointer_not_null(compressed_signal_out)
+        || !check_output_pointer_not_null(compressed_signal_offsets))
+    {
+        return t_pod5_error_no;
+    }
+
+    std::vector<gsl::span<std::int16_t const>> signal_spans;
+    signal_spans.reserve(read_count);
+    for (std::size_t read = 0; read < read_count; ++read) {
+        signal_spans.emplace_back(signal[read], signal_size[read]);
+    }
+
+    POD5_C_RETURN_NOT_OK(pod5::compress_signal_batch(
+        gsl::make_span(signal_spans),
+        *shared_thread_pool(),
+        gsl::make_span(compressed_signal_out, compressed_signal_out_size).as_span<std::uint8_t>(),
+        gsl::make_span(compressed_signal_offsets, read_count + 1)));
+
+    return POD5_OK;
+}
+
 pod5_error_t pod5_vbz_decompress_signal(
     char const * compressed_signal,
     size_t compressed_signal_size,
@@ -1278,7 +2674,7 @@ pod5_error_t pod5_vbz_decompress_signal(
     pod5_reset_error();
 
     if (!check_not_null(compressed_signal) || !check_output_pointer_not_null(signal_out)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     auto const in_span =
@@ -1289,24 +2685,116 @@ pod5_error_t pod5_vbz_decompress_signal(
     return POD5_OK;
 }
 
+pod5_error_t pod5_get_thread_pool_statistics(
+    Pod5ThreadPoolStatistics_t * statistics,
+    double * worker_busy_ratios,
+    size_t worker_busy_ratios_count)
+{
+    pod5_reset_error();
+
+    if (!check_output_pointer_not_null(statistics)) {
+        return t_pod5_error_no;
+    }
+
+    static_assert(
+        POD5_THREAD_POOL_TIME_HISTOGRAM_BUCKETS
+            == pod5::ThreadPoolStatistics::TIME_HISTOGRAM_BUCKETS,
+        "C API histograms must match the thread pool's");
+
+    auto const pool_statistics = shared_thread_pool()->statistics();
+    statistics->queued_tasks = pool_statistics.queued_tasks;
+    statistics->running_tasks = pool_statistics.running_tasks;
+    statistics->queued_strands = pool_statistics.strand_queued_tasks.size();
+    statistics->max_strand_queued_tasks = pool_statistics.strand_queued_tasks.empty()
+                                              ? 0
+                                              : pool_statistics.strand_queued_tasks.front();
+    statistics->tasks_run = pool_statistics.tasks_run;
+    for (std::size_t i = 0; i < POD5_THREAD_POOL_TIME_HISTOGRAM_BUCKETS; ++i) {
+        statistics->wait_time_histogram[i] = i < pool_statistics.wait_time_histogram.size()
+                                                 ? pool_statistics.wait_time_histogram[i]
+                                                 : 0;
+        statistics->run_time_histogram[i] = i < pool_statistics.run_time_histogram.size()
+                                                ? pool_statistics.run_time_histogram[i]
+                                                : 0;
+    }
+
+    auto const & busy_ratios = pool_statistics.worker_busy_ratios;
+    statistics->worker_count = busy_ratios.size();
+    statistics->mean_worker_busy_ratio =
+        busy_ratios.empty()
+            ? 0.0
+            : std::accumulate(busy_ratios.begin(), busy_ratios.end(), 0.0) / busy_ratios.size();
+    if (worker_busy_ratios) {
+        std::copy_n(
+            busy_ratios.begin(),
+            std::min(worker_busy_ratios_count, busy_ratios.size()),
+            worker_busy_ratios);
+    }
+
+    return POD5_OK;
+}
+
 pod5_error_t pod5_format_read_id(read_id_t const read_id, char * read_id_string)
 {
     pod5_reset_error();
 
     if (!check_not_null(read_id) || !check_output_pointer_not_null(read_id_string)) {
-        return g_pod5_error_no;
+        return t_pod5_error_no;
     }
 
     auto uuid_data = reinterpret_cast<pod5::Uuid const *>(read_id);
-    std::string string_data = to_string(*uuid_data);
-    if (string_data.size() != 36) {
-        pod5_set_error(pod5::Status::Invalid("Unexpected length of UUID"));
-        return g_pod5_error_no;
+    pod5::format_uuids(gsl::make_span(uuid_data, 1), read_id_string);
+    read_id_string[pod5::UUID_STRING_LENGTH] = '\0';
+
+    return POD5_OK;
+}
+
+pod5_error_t pod5_format_read_ids(
+    read_id_t const * read_ids,
+    size_t read_id_count,
+    char * read_id_strings)
+{
+    pod5_reset_error();
+
+    if (read_id_count == 0) {
+        return POD5_OK;
     }
+    if (!check_not_null(read_ids) || !check_output_pointer_not_null(read_id_strings)) {
+        return t_pod5_error_no;
+    }
+
+    pod5::format_uuids(
+        gsl::make_span(reinterpret_cast<pod5::Uuid const *>(read_ids), read_id_count),
+        read_id_strings);
+    return POD5_OK;
+}
+
+pod5_error_t pod5_parse_read_ids(
+    char const * read_id_strings,
+    size_t read_id_count,
+    read_id_t * read_ids)
+{
+    pod5_reset_error();
 
-    std::copy(string_data.begin(), string_data.end(), read_id_string);
-    read_id_string[string_data.size()] = '\0';
+    if (read_id_count == 0) {
+        return POD5_OK;
+    }
+    if (!check_not_null(read_id_strings) || !check_output_pointer_not_null(read_ids)) {
+        return t_pod5_error_no;
+    }
 
+    auto const parsed_count = pod5::parse_uuids(
+        read_id_strings, gsl::make_span(reinterpret_cast<pod5::Uuid *>(read_ids), read_id_count));
+    if (parsed_count != read_id_count) {
+        pod5_set_error(pod5::Status::Invalid(
+            "Invalid read id '",
+            std::string_view{
+                read_id_strings + parsed_count * pod5::UUID_STRING_LENGTH,
+                pod5::UUID_STRING_LENGTH},
+            "' at index ",
+            parsed_count));
+        return t_pod5_error_no;
+    }
     return POD5_OK;
 }
 }
@@ -15,12 +15,16 @@
 extern "C" {
 #endif
 
+struct Pod5DatasetReader;
+typedef struct Pod5DatasetReader Pod5DatasetReader_t;
 struct Pod5FileReader;
 typedef struct Pod5FileReader Pod5FileReader_t;
 struct Pod5FileWriter;
 typedef struct Pod5FileWriter Pod5FileWriter_t;
 struct Pod5ReadRecordBatch;
 typedef struct Pod5ReadRecordBatch Pod5ReadRecordBatch_t;
+struct Pod5ReadTableProjection;
+typedef struct Pod5ReadTableProjection Pod5ReadTableProjection_t;
 
 //---------------------------------------------------------------------------------------------------------------------
 // Error management
@@ -45,10 +49,17 @@ enum pod5_error {
 };
 typedef enum pod5_error pod5_error_t;
 
-/// \brief Get the most recent error number from all pod5 api's.
+// Error state is held per thread: each call resets the calling thread's error, and the functions
+// below report the most recent error on the calling thread only.
+//
+// Functions reading a Pod5FileReader_t, and the read batches taken from it, are safe to call
+// from many threads at once on the same reader. A writer must only be used by one thread at once.
+
+/// \brief Get the most recent error number from all pod5 api's called on this thread.
 POD5_FORMAT_EXPORT pod5_error_t pod5_get_error_no();
-/// \brief Get the most recent error description string from all pod5 api's.
-/// \note The string's lifetime is internally managed, a caller should not free it.
+/// \brief Get the most recent error description string from all pod5 api's called on this thread.
+/// \note The string's lifetime is internally managed, a caller should not free it. It is valid
+///       until the next pod5 api call on this thread.
 POD5_FORMAT_EXPORT char const * pod5_get_error_string();
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -196,6 +207,50 @@ typedef struct ReadBatchRowInfoArrayV3 ReadBatchRowInfoArray_t;
 // Latest available version.
 #define READ_BATCH_ROW_INFO_VERSION READ_BATCH_ROW_INFO_VERSION_3
 
+// Structures of the Arrow C data interface, see https://arrow.apache.org/docs/format/CDataInterface.html.
+// Guarded as the interface specifies, so they can be included alongside arrow's own definitions.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char * format;
+    const char * name;
+    const char * metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema ** children;
+    struct ArrowSchema * dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema *);
+    // Opaque producer-specific data
+    void * private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void ** buffers;
+    struct ArrowArray ** children;
+    struct ArrowArray * dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray *);
+    // Opaque producer-specific data
+    void * private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
 //---------------------------------------------------------------------------------------------------------------------
 // Reading files
 //---------------------------------------------------------------------------------------------------------------------
@@ -240,7 +295,7 @@ typedef struct FileInfo FileInfo_t;
 POD5_FORMAT_EXPORT pod5_error_t pod5_get_file_info(Pod5FileReader_t * file, FileInfo_t * file_info);
 
 struct EmbeddedFileData {
-    // The file name to open - note this may not be the original file name, if the file has been migrated.
+    // The file name to open.
     char const * file_name;
     size_t offset;
     size_t length;
@@ -250,6 +305,9 @@ typedef struct EmbeddedFileData EmbeddedFileData_t;
 /// \brief Find the location of the read table data
 /// \param[out] file        The file to be queried.
 /// \param      file_data   The output read table file data.
+/// \note Files written by older versions of the format have their read table migrated as it is
+///       read, with no location to give: POD5_ERROR_NOTIMPLEMENTED is returned, read the table
+///       with pod5_get_read_batch instead.
 POD5_FORMAT_EXPORT pod5_error_t
 pod5_get_file_read_table_location(Pod5FileReader_t * file, EmbeddedFileData_t * file_data);
 
@@ -262,9 +320,78 @@ pod5_get_file_signal_table_location(Pod5FileReader_t * file, EmbeddedFileData_t
 /// \brief Find the location of the run info table data
 /// \param[out] file        The file to be queried.
 /// \param      file_data   The output signal table file data.
+/// \note Files predating run info tables have theirs built from the read table, with no location
+///       to give: POD5_ERROR_NOTIMPLEMENTED is returned, read run infos with pod5_get_file_run_info
+///       instead.
 POD5_FORMAT_EXPORT pod5_error_t
 pod5_get_file_run_info_table_location(Pod5FileReader_t * file, EmbeddedFileData_t * file_data);
 
+struct Pod5FileReaderStatistics {
+    /// Bytes read from each table's part of the file.
+    uint64_t run_info_table_bytes_read;
+    uint64_t read_table_bytes_read;
+    uint64_t signal_table_bytes_read;
+    /// Arrow IPC record batches decoded from each table.
+    uint64_t read_table_batches_decoded;
+    uint64_t signal_table_batches_decoded;
+    /// Signal table batch cache lookups finding the batch cached, lookups loading it, and
+    /// batches evicted from the cache.
+    uint64_t signal_cache_hits;
+    uint64_t signal_cache_misses;
+    uint64_t signal_cache_evictions;
+    /// Bytes of samples decompressed, and the time spent decompressing summed across threads.
+    uint64_t decompressed_bytes;
+    uint64_t decompression_time_ns;
+};
+typedef struct Pod5FileReaderStatistics Pod5FileReaderStatistics_t;
+
+/// \brief Find the reader's IO and decoding counts since it was opened.
+/// \param      reader      The file reader to query.
+/// \param[out] statistics  The reader's statistics.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_file_reader_statistics(
+    Pod5FileReader_t * reader,
+    Pod5FileReaderStatistics_t * statistics);
+
+/// The parts of pod5 whose allocations from the default memory pool are counted separately.
+enum pod5_memory_subsystem {
+    /// Signal table batches read by file readers, held in their caches.
+    POD5_MEMORY_SUBSYSTEM_SIGNAL_CACHE = 0,
+    /// Read table batches read by file readers.
+    POD5_MEMORY_SUBSYSTEM_READ_TABLE_DECODE = 1,
+    /// Table builders of file writers, and the batches they write.
+    POD5_MEMORY_SUBSYSTEM_WRITER_BUILDERS = 2,
+    /// Signal compressed in bulk by file writers.
+    POD5_MEMORY_SUBSYSTEM_COMPRESSION_SCRATCH = 3,
+    /// Batches copied by the repacker.
+    POD5_MEMORY_SUBSYSTEM_REPACKER = 4
+};
+typedef enum pod5_memory_subsystem pod5_memory_subsystem_t;
+
+struct Pod5MemoryStatistics {
+    int64_t bytes_allocated;
+    int64_t peak_bytes_allocated;
+    uint64_t allocation_count;
+    /// Allocations refused for taking the subsystem over its limit.
+    uint64_t failed_allocations;
+    /// The subsystem's limit in bytes, 0 if it is unlimited.
+    int64_t max_bytes;
+};
+typedef struct Pod5MemoryStatistics Pod5MemoryStatistics_t;
+
+/// \brief Find the memory allocated by a subsystem of every reader and writer in the process.
+/// \param      subsystem   The subsystem to query.
+/// \param[out] statistics  The subsystem's memory statistics.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_memory_statistics(
+    pod5_memory_subsystem_t subsystem,
+    Pod5MemoryStatistics_t * statistics);
+
+/// \brief Limit the memory allocated at once by a subsystem of every reader and writer in the
+///        process. Allocations beyond the limit fail with POD5_ERROR_OUTOFMEMORY.
+/// \param subsystem   The subsystem to limit.
+/// \param max_bytes   The most bytes allocated at once, 0 for no limit.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_set_memory_limit(pod5_memory_subsystem_t subsystem, int64_t max_bytes);
+
 /// \brief Find the number of reads in the file.
 /// \param      reader  The file reader to read from
 /// \param[out] count   The number of reads in the file
@@ -299,6 +426,63 @@ POD5_FORMAT_EXPORT pod5_error_t pod5_plan_traversal(
     uint32_t * batch_rows,
     size_t * find_success_count);
 
+/// \brief Find the reads matching a filter expression, reading only the columns it tests.
+/// \param      file                The file to be scanned.
+/// \param      expression          The filter, for example
+///                                 "channel < 100 and end_reason in ('signal_positive')". See
+///                                 pod5::ReadScanPredicate::parse for the supported syntax.
+/// \param[out] batch_counts        The number of matching rows per batch (rows listed in batch_rows),
+///                                 input array length should be the number of read table batches.
+/// \param[out] batch_rows          Matching rows per batch, packed into one array as for
+///                                 [pod5_plan_traversal].
+/// \param      batch_rows_count    The length of [batch_rows], the file's read count is always enough.
+/// \param[out] selected_count      The number of matching reads.
+POD5_FORMAT_EXPORT pod5_error_t pod5_scan_reads(
+    Pod5FileReader_t * file,
+    char const * expression,
+    uint32_t * batch_counts,
+    uint32_t * batch_rows,
+    size_t batch_rows_count,
+    size_t * selected_count);
+
+/// \brief Check which read ids may be in a file, using only the file's footer and read id filter.
+/// \param      filename        The filename of the pod5 file.
+/// \param      read_id_array   The read id array (contiguous array, 16 bytes per id).
+/// \param      read_id_count   The number of read ids.
+/// \param[out] may_contain     Set to 0 for each read id definitely not in the file, 1 otherwise.
+///                             Input array length should equal read_id_count.
+/// \note Files written without a read id filter report every read id as possibly present.
+POD5_FORMAT_EXPORT pod5_error_t pod5_file_may_contain_read_ids(
+    char const * filename,
+    uint8_t const * read_id_array,
+    size_t read_id_count,
+    uint8_t * may_contain);
+
+struct Pod5FileSummary {
+    uint64_t read_count;
+    uint64_t sample_count;
+    /// The size in bytes of the file's signal table.
+    uint64_t signal_bytes;
+    size_t run_info_count;
+    /// Set to 1 if the start times below are known, 0 if the file has no reads or the sample
+    /// rates of its run infos are unknown.
+    char has_start_times;
+    /// The earliest and latest read start, in milliseconds since the epoch.
+    int64_t min_start_time_ms;
+    int64_t max_start_time_ms;
+};
+typedef struct Pod5FileSummary Pod5FileSummary_t;
+
+/// \brief Read the summary of a file's reads, using only the file's footer and summary.
+/// \param      filename        The filename of the pod5 file.
+/// \param[out] summary         The summary of the file.
+/// \param[out] has_summary     Set to 0 if the file was written without a summary, leaving
+///                             [summary] unchanged, 1 otherwise.
+POD5_FORMAT_EXPORT pod5_error_t pod5_read_file_summary(
+    char const * filename,
+    Pod5FileSummary_t * summary,
+    uint8_t * has_summary);
+
 /// \brief Find the number of read batches in the file.
 /// \param[out] count   The number of read batches in the file
 /// \param      reader  The file reader to read from
@@ -313,16 +497,105 @@ pod5_get_read_batch_count(size_t * count, Pod5FileReader_t * reader);
 POD5_FORMAT_EXPORT pod5_error_t
 pod5_get_read_batch(Pod5ReadRecordBatch_t ** batch, Pod5FileReader_t * reader, size_t index);
 
+/// \brief Create a projection, to read batches holding only some read table columns.
+/// \param[out] projection      The created projection.
+/// \param      reader          The file reader to make the projection for.
+/// \param      column_names    The names of the read table columns to load, e.g. "read_id".
+/// \param      column_count    The number of entries in column_names.
+/// \note Projections returned from this API must be freed using #pod5_free_read_table_projection
+POD5_FORMAT_EXPORT pod5_error_t pod5_create_read_table_projection(
+    Pod5ReadTableProjection_t ** projection,
+    Pod5FileReader_t * reader,
+    char const * const * column_names,
+    size_t column_count);
+
+/// \brief Release a projection when it is no longer used.
+/// \param projection The projection to release.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_free_read_table_projection(Pod5ReadTableProjection_t * projection);
+
+/// \brief Get a read batch from the file, reading and decoding only the columns in [projection].
+/// \param[out] batch       The extracted batch.
+/// \param      reader      The file reader to read from, which [projection] was created for.
+/// \param      index       The index of the batch to read.
+/// \param      projection  The columns to load.
+/// \note Fields of columns outside the projection are zeroed by #pod5_get_read_batch_row_info_data,
+///       and calls needing them report an error.
+/// \note Batches returned from this API must be freed using #pod5_free_read_batch
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_read_batch_projected(
+    Pod5ReadRecordBatch_t ** batch,
+    Pod5FileReader_t * reader,
+    size_t index,
+    Pod5ReadTableProjection_t const * projection);
+
 /// \brief Release a read batch when it is not longer used.
 /// \param batch The batch to release.
 POD5_FORMAT_EXPORT pod5_error_t pod5_free_read_batch(Pod5ReadRecordBatch_t * batch);
 
+struct Pod5ReadBatchIterator;
+typedef struct Pod5ReadBatchIterator Pod5ReadBatchIterator_t;
+
+/// \brief Start iterating over the read batches of a file in order, reading the batches after the one last
+///        returned on background threads while the caller works on it.
+/// \param[out] iterator          The iterator, to be released with #pod5_free_read_batch_iterator.
+/// \param      reader            The file to read batches from.
+/// \param      prefetch_batches  The most batches read ahead of the caller, 0 for the default of 4.
+/// \param      projection        The columns to load, created for [reader], or null to load every column.
+/// \note The iterator holds its own references to the file and projection, so both may be released while it runs.
+POD5_FORMAT_EXPORT pod5_error_t pod5_create_read_batch_iterator(
+    Pod5ReadBatchIterator_t ** iterator,
+    Pod5FileReader_t * reader,
+    size_t prefetch_batches,
+    Pod5ReadTableProjection_t const * projection);
+
+/// \brief Take the next read batch from an iterator, waiting for it to be read.
+/// \param      iterator  The iterator to take a batch from.
+/// \param[out] batch     The batch, to be released with #pod5_free_read_batch, or null once every batch has been taken.
+/// \note A batch which fails to read reports its error, and the next call moves on to the batch after it.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_read_batch_iterator_next(Pod5ReadBatchIterator_t * iterator, Pod5ReadRecordBatch_t ** batch);
+
+/// \brief Release a read batch iterator, waiting for the batches it is reading ahead.
+/// \note Batches taken from the iterator may be released before or after it.
+POD5_FORMAT_EXPORT pod5_error_t pod5_free_read_batch_iterator(Pod5ReadBatchIterator_t * iterator);
+
 /// \brief Find the number of rows in a batch.
 /// \param[out] count   The number of rows in the batch.
 /// \param      batch   The batch to query the number of rows for.
 POD5_FORMAT_EXPORT pod5_error_t
 pod5_get_read_batch_row_count(size_t * count, Pod5ReadRecordBatch_t * batch);
 
+/// \brief Export a read batch through the Arrow C data interface, without copying its columns.
+/// \param      batch       The read batch to export.
+/// \param[out] out_array   The batch's columns, as a struct array. Release with out_array->release.
+/// \param[out] out_schema  The batch's schema, as a struct type. Release with out_schema->release.
+/// \note The exported array holds its own references to the batch's data, so [batch] may be freed first.
+/// \note Columns are exported as stored: read ids as 16 byte fixed size binary with the "minknow.uuid"
+///       extension, and pore types, end reasons and run infos as dictionaries.
+POD5_FORMAT_EXPORT pod5_error_t pod5_export_read_batch_arrow(
+    Pod5ReadRecordBatch_t * batch,
+    struct ArrowArray * out_array,
+    struct ArrowSchema * out_schema);
+
+/// \brief Find the number of signal batches in a file.
+/// \param[out] count   The number of signal batches in the file.
+/// \param      reader  The file reader to read from.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_get_signal_batch_count(size_t * count, Pod5FileReader_t * reader);
+
+/// \brief Export a signal table batch through the Arrow C data interface, without copying its columns.
+/// \param      reader      The file reader to read from.
+/// \param      index       The index of the signal batch to export.
+/// \param[out] out_array   The batch's columns, as a struct array. Release with out_array->release.
+/// \param[out] out_schema  The batch's schema, as a struct type. Release with out_schema->release.
+/// \note The signal column holds each row's samples as stored, compressed with the "minknow.vbz" extension
+///       unless the file was written uncompressed. Compressed rows can be decoded with pod5_vbz_decompress_signal.
+POD5_FORMAT_EXPORT pod5_error_t pod5_export_signal_batch_arrow(
+    Pod5FileReader_t * reader,
+    size_t index,
+    struct ArrowArray * out_array,
+    struct ArrowSchema * out_schema);
+
 /// \brief Find the info for a row in a read batch.
 /// \param      batch               The read batch to query.
 /// \param      row                 The row index to query.
@@ -338,6 +611,71 @@ POD5_FORMAT_EXPORT pod5_error_t pod5_get_read_batch_row_info_data(
     void * row_data,
     uint16_t * read_table_version);
 
+// Columns of the read table which can be copied out of a read batch in bulk, each documented with
+// the type of its values.
+enum pod5_read_column {
+    /// \brief read_id_t
+    POD5_READ_COLUMN_READ_ID = 0,
+    /// \brief uint32_t
+    POD5_READ_COLUMN_READ_NUMBER = 1,
+    /// \brief uint64_t
+    POD5_READ_COLUMN_START_SAMPLE = 2,
+    /// \brief float
+    POD5_READ_COLUMN_MEDIAN_BEFORE = 3,
+    /// \brief uint16_t
+    POD5_READ_COLUMN_CHANNEL = 4,
+    /// \brief uint8_t
+    POD5_READ_COLUMN_WELL = 5,
+    /// \brief int16_t, a dictionary index as for pod5_get_pore_type
+    POD5_READ_COLUMN_PORE_TYPE = 6,
+    /// \brief float
+    POD5_READ_COLUMN_CALIBRATION_OFFSET = 7,
+    /// \brief float
+    POD5_READ_COLUMN_CALIBRATION_SCALE = 8,
+    /// \brief int16_t, a dictionary index as for pod5_get_end_reason
+    POD5_READ_COLUMN_END_REASON = 9,
+    /// \brief uint8_t, 0 or 1
+    POD5_READ_COLUMN_END_REASON_FORCED = 10,
+    /// \brief int16_t, a dictionary index as for pod5_get_run_info
+    POD5_READ_COLUMN_RUN_INFO = 11,
+    /// \brief uint64_t
+    POD5_READ_COLUMN_NUM_MINKNOW_EVENTS = 12,
+    /// \brief float
+    POD5_READ_COLUMN_TRACKED_SCALING_SCALE = 13,
+    /// \brief float
+    POD5_READ_COLUMN_TRACKED_SCALING_SHIFT = 14,
+    /// \brief float
+    POD5_READ_COLUMN_PREDICTED_SCALING_SCALE = 15,
+    /// \brief float
+    POD5_READ_COLUMN_PREDICTED_SCALING_SHIFT = 16,
+    /// \brief uint32_t
+    POD5_READ_COLUMN_NUM_READS_SINCE_MUX_CHANGE = 17,
+    /// \brief float
+    POD5_READ_COLUMN_TIME_SINCE_MUX_CHANGE = 18,
+    /// \brief uint64_t
+    POD5_READ_COLUMN_NUM_SAMPLES = 19,
+    /// \brief uint32_t
+    POD5_READ_COLUMN_SIGNAL_ROW_COUNT = 20,
+};
+typedef enum pod5_read_column pod5_read_column_t;
+
+/// \brief Copy a range of rows of one column of a read batch into a caller supplied array.
+/// \param      batch       The read batch to query.
+/// \param      column      The column to copy.
+/// \param      row_start   The first row to copy.
+/// \param      row_count   The number of rows to copy, row_start + row_count must not exceed the batch's row count.
+/// \param      value_size  The size of each value in [values], which must match the column's type, see pod5_read_column.
+/// \param[out] values      The output location for [row_count] values.
+/// \note Fixed width columns are copied with one memcpy, rather than converting each row to a ReadBatchRowInfo_t.
+/// \note Returns an error if the batch was read with a projection which did not load the column.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_read_batch_column(
+    Pod5ReadRecordBatch_t * batch,
+    pod5_read_column_t column,
+    size_t row_start,
+    size_t row_count,
+    size_t value_size,
+    void * values);
+
 /// \brief Find the signal indices for a row in a read batch.
 /// \param      batch                       The read batch to query.
 /// \param      row                         The row index to query.
@@ -411,6 +749,18 @@ POD5_FORMAT_EXPORT pod5_error_t pod5_get_run_info(
     int16_t run_info,
     RunInfoDictData_t ** run_info_data);
 
+/// \brief Find the run info for a row in a read batch, without allocating.
+/// \param      batch               The read batch to query.
+/// \param      run_info            The run info index to query from the passed batch.
+/// \param[out] run_info_data       Output location for a pointer to the run info data.
+/// \note Each run info is decoded once per file, the first time it is found. The returned value
+///       is owned by the file, must not be freed, and is valid until the file and every batch
+///       read from it have been freed.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_cached_run_info(
+    Pod5ReadRecordBatch_t * batch,
+    int16_t run_info,
+    RunInfoDictData_t const ** run_info_data);
+
 /// \brief Find the run info for a row in a file.
 /// \param      file                The file to query.
 /// \param      run_info_index      The run info index to query from the passed file.
@@ -461,6 +811,28 @@ POD5_FORMAT_EXPORT pod5_error_t pod5_get_pore_type(
     char * pore_type_string_value,
     size_t * pore_type_string_value_size);
 
+/// \brief Find the end reason for a row in a read batch, without copying its string.
+/// \param      batch                   The read batch to query.
+/// \param      end_reason              The end reason index to query from the passed batch.
+/// \param[out] end_reason_value        The enum value for end reason.
+/// \param[out] end_reason_string_value Output location for a pointer to the null terminated string value for the end reason.
+/// \note The string is owned by the file, as for #pod5_get_cached_run_info.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_cached_end_reason(
+    Pod5ReadRecordBatch_t * batch,
+    int16_t end_reason,
+    pod5_end_reason_t * end_reason_value,
+    char const ** end_reason_string_value);
+
+/// \brief Find the pore type for a row in a read batch, without copying its string.
+/// \param      batch                   The read batch to query.
+/// \param      pore_type               The pore type index to query from the passed batch.
+/// \param[out] pore_type_string_value  Output location for a pointer to the null terminated string value for the pore type.
+/// \note The string is owned by the file, as for #pod5_get_cached_run_info.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_cached_pore_type(
+    Pod5ReadRecordBatch_t * batch,
+    int16_t pore_type,
+    char const ** pore_type_string_value);
+
 struct SignalRowInfo {
     size_t batch_index;
     size_t batch_row_index;
@@ -480,6 +852,68 @@ POD5_FORMAT_EXPORT pod5_error_t pod5_get_signal_row_info(
     uint64_t * signal_rows,
     SignalRowInfo_t ** signal_row_info);
 
+/// \brief Hint that signal rows will be read soon, so the file reads them ahead of use.
+/// \param      reader                      The reader to query.
+/// \param      signal_rows_count           The number of signal rows to prefetch.
+/// \param      signal_rows                 The signal rows to prefetch, for example the signal rows of
+///                                         the next batches in a plan from [pod5_plan_traversal].
+/// \note Uses madvise for memory mapped files and posix_fadvise otherwise. This only issues a hint
+///       and returns without waiting for any data to be read.
+POD5_FORMAT_EXPORT pod5_error_t pod5_prefetch_signal_rows(
+    Pod5FileReader_t * reader,
+    size_t signal_rows_count,
+    uint64_t const * signal_rows);
+
+/// \brief Set the order a traversal plan's reads will have their signal read in, so the signal batch
+///        cache keeps the batches needed soonest and drops each batch after its last planned read,
+///        rather than evicting the least recently used batches.
+/// \param      reader              The reader to plan signal reads for.
+/// \param      batch_counts        The number of rows to visit per read table batch, as found by
+///                                 [pod5_plan_traversal], with one entry per read table batch.
+/// \param      batch_rows          The rows to visit per batch, as found by [pod5_plan_traversal].
+/// \param      batch_rows_count    The length of [batch_rows].
+/// \note The plan covers every signal read from the file until [pod5_clear_signal_access_plan].
+///       The reads of each read table batch are planned in the order of their first signal row,
+///       as a loader made by [pod5_create_signal_loader] loads them.
+POD5_FORMAT_EXPORT pod5_error_t pod5_set_signal_access_plan(
+    Pod5FileReader_t * reader,
+    uint32_t const * batch_counts,
+    uint32_t const * batch_rows,
+    size_t batch_rows_count);
+
+/// \brief Drop the plan set by [pod5_set_signal_access_plan].
+/// \param      reader              The reader to clear the plan of.
+POD5_FORMAT_EXPORT pod5_error_t pod5_clear_signal_access_plan(Pod5FileReader_t * reader);
+
+struct Pod5TraversalCost {
+    /// Reads visited by the plan, and the signal table rows holding their samples.
+    size_t read_count;
+    size_t signal_row_count;
+    /// Distinct signal table batches the plan touches, and their stored size in the file (0 if
+    /// the file doesn't list signal batch locations).
+    size_t signal_batch_count;
+    uint64_t signal_batch_bytes;
+    /// Samples held by the plan's reads (0 if the file doesn't record sample counts).
+    uint64_t sample_count;
+    /// Times the plan moves to a signal batch which doesn't follow the last one it read.
+    size_t estimated_seeks;
+};
+typedef struct Pod5TraversalCost Pod5TraversalCost_t;
+
+/// \brief Estimate the signal IO of a traversal plan from the read table, without reading signal.
+/// \param      reader              The reader the plan traverses.
+/// \param      batch_counts        The number of rows to visit per read table batch, as found by
+///                                 [pod5_plan_traversal], with one entry per read table batch.
+/// \param      batch_rows          The rows to visit per batch, as found by [pod5_plan_traversal].
+/// \param      batch_rows_count    The length of [batch_rows].
+/// \param[out] cost                The plan's estimated cost.
+POD5_FORMAT_EXPORT pod5_error_t pod5_estimate_traversal_cost(
+    Pod5FileReader_t * reader,
+    uint32_t const * batch_counts,
+    uint32_t const * batch_rows,
+    size_t batch_rows_count,
+    Pod5TraversalCost_t * cost);
+
 /// \brief Release a list of signal row infos allocated by [pod5_get_signal_row_info].
 /// \param      signal_rows_count           The number of signal rows to release.
 /// \param      signal_row_info             The signal row infos to release.
@@ -525,6 +959,278 @@ POD5_FORMAT_EXPORT pod5_error_t pod5_get_read_complete_signal(
     size_t sample_count,
     int16_t * signal);
 
+// Options to control how a read's signal is extracted.
+struct Pod5ReadSignalOptions {
+    /// \brief Decompress the read's signal rows concurrently on a thread pool shared across the
+    ///        library, rather than one after another on the calling thread. Reduces latency for
+    ///        long reads with many signal rows.
+    char parallel_decode;
+};
+typedef struct Pod5ReadSignalOptions Pod5ReadSignalOptions_t;
+
+/// \brief Find the signal for a full read, as pod5_get_read_complete_signal.
+/// \param      options         The options to use when extracting the signal, may be null.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_read_complete_signal_options(
+    Pod5FileReader_t * reader,
+    Pod5ReadRecordBatch_t * batch,
+    size_t batch_row,
+    size_t sample_count,
+    int16_t * signal,
+    Pod5ReadSignalOptions_t const * options);
+
+/// \brief Find the signal for several full reads of a batch, into one buffer.
+/// \param      reader          The reader to query.
+/// \param      batch           The read batch to query.
+/// \param      row_count       The number of reads to query, the length of [batch_rows].
+/// \param      batch_rows      The read rows to query data for.
+/// \param      sample_count    The number of samples allocated in [signal].
+/// \param[out] signal          The output location for the queried samples, each read's samples following the last's. May be null to only find [signal_offsets].
+/// \param[out] signal_offsets  The output location for the offset of each read's samples in [signal], followed by the total sample count. Must hold row_count + 1 entries.
+/// \note Signal rows are looked up once for all reads, and decompressed concurrently on a thread pool shared across the library.
+/// \note Call with a null [signal] first to find the total sample count to allocate.
+/// \note The signal data is allocated by the caller and should be released as appropriate by the caller.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_reads_complete_signal_batch(
+    Pod5FileReader_t * reader,
+    Pod5ReadRecordBatch_t * batch,
+    size_t row_count,
+    uint32_t const * batch_rows,
+    size_t sample_count,
+    int16_t * signal,
+    uint64_t * signal_offsets);
+
+/// \brief Find a range of the signal for a read, decoding only the signal rows which overlap it.
+/// \param      reader          The reader to query.
+/// \param      batch           The read batch to query.
+/// \param      batch_row       The read row to query data for.
+/// \param      sample_start    The first sample of the read to return.
+/// \param      sample_count    The number of samples to return, allocated in [signal]. sample_start + sample_count must not exceed the read's sample count.
+/// \param[out] signal          The output location for the queried samples.
+/// \note The signal data is allocated by the caller and should be released as appropriate by the caller.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_read_signal_range(
+    Pod5FileReader_t * reader,
+    Pod5ReadRecordBatch_t * batch,
+    size_t batch_row,
+    size_t sample_start,
+    size_t sample_count,
+    int16_t * signal);
+
+/// \brief Find the signal for a full read, calibrated to picoamps using the read's calibration.
+/// \param      reader          The reader to query.
+/// \param      batch           The read batch to query.
+/// \param      batch_row       The read row to query data for.
+/// \param      sample_count    The number of samples allocated in [signal] (must equal the length of signal data in the queryied read row).
+/// \param[out] signal          The output location for the queried samples, in picoamps.
+/// \note Samples are decompressed and calibrated in one pass, with no intermediate int16 copy of the read.
+/// \note The signal data is allocated by the caller and should be released as appropriate by the caller.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_read_complete_signal_pa(
+    Pod5FileReader_t * reader,
+    Pod5ReadRecordBatch_t * batch,
+    size_t batch_row,
+    size_t sample_count,
+    float * signal);
+
+/// \brief Find the decimations reads' signal summaries are stored at in a file.
+/// \param      reader              The reader to query.
+/// \param      decimation_capacity The number of decimations allocated in [decimations].
+/// \param[out] decimations         The output location for the decimations, in increasing order. May be null to only find [decimation_count].
+/// \param[out] decimation_count    The number of decimations reads are summarised at, 0 if the file was written without summaries.
+/// \note Call with a null [decimations] first to find the count to allocate.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_signal_summary_decimations(
+    Pod5FileReader_t * reader,
+    size_t decimation_capacity,
+    uint32_t * decimations,
+    size_t * decimation_count);
+
+/// \brief Find the summary of a read's signal at one decimation: the min, max and mean of each
+///        run of [decimation] samples, the last run holding whatever samples remain.
+/// \param      reader          The reader to query.
+/// \param      read_id         The read to find the summary of.
+/// \param      decimation      The decimation to find the summary at.
+/// \param      capacity        The number of values allocated in each of [min], [max] and [mean].
+/// \param[out] min             The output location for the minimum of each run. May be null to only find [level_size].
+/// \param[out] max             The output location for the maximum of each run, null if [min] is.
+/// \param[out] mean            The output location for the mean of each run, rounded to the nearest sample value, null if [min] is.
+/// \param[out] level_size      The number of runs in the summary.
+/// \param[out] has_summary     Set to 0 if the read has no summary at [decimation], leaving the other outputs unchanged, 1 otherwise.
+/// \note Call with a null [min] first to find the size to allocate. Only the summary batch holding the read is read.
+/// \note The summary data is allocated by the caller and should be released as appropriate by the caller.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_read_signal_summary(
+    Pod5FileReader_t * reader,
+    read_id_t const read_id,
+    uint32_t decimation,
+    size_t capacity,
+    int16_t * min,
+    int16_t * max,
+    int16_t * mean,
+    size_t * level_size,
+    uint8_t * has_summary);
+
+//---------------------------------------------------------------------------------------------------------------------
+// Loading signal in the background
+//---------------------------------------------------------------------------------------------------------------------
+
+struct Pod5SignalLoader;
+typedef struct Pod5SignalLoader Pod5SignalLoader_t;
+
+// Options to control how a signal loader loads reads.
+struct Pod5SignalLoaderOptions {
+    /// \brief The number of threads loading signal, 0 for one per hardware thread.
+    size_t worker_count;
+    /// \brief The most loaded batches held waiting to be released, 0 for the default of 10.
+    size_t max_pending_batches;
+    /// \brief Stop starting new reads while batches not yet released hold this many bytes of samples, 0 for no limit.
+    uint64_t max_pending_bytes;
+    /// \brief Only find the sample count of each read, without loading its samples.
+    char sample_counts_only;
+    /// \brief Tune the number of threads loading signal between one and [worker_count] by the samples they
+    ///        deliver, see [pod5_get_signal_loader_worker_count].
+    char adaptive_worker_count;
+};
+typedef struct Pod5SignalLoaderOptions Pod5SignalLoaderOptions_t;
+
+// The signal of the planned reads in one read table batch, loaded by a signal loader.
+struct Pod5SignalLoaderBatch {
+    /// \brief The read table batch holding the reads.
+    uint32_t batch_index;
+    /// \brief The number of reads loaded from the batch.
+    size_t row_count;
+    /// \brief The row of each read in the read table batch, in the order they were planned.
+    uint32_t const * batch_rows;
+    /// \brief The number of samples of each read.
+    uint64_t const * sample_counts;
+    /// \brief The offset of each read's samples in [samples], followed by the total sample count.
+    uint64_t const * sample_offsets;
+    /// \brief The samples of all reads, each read's samples following the last's. Null if only sample counts were loaded.
+    int16_t const * samples;
+};
+typedef struct Pod5SignalLoaderBatch Pod5SignalLoaderBatch_t;
+
+/// \brief Start loading the signal of a set of reads on background threads, one read table batch at a time.
+/// \param      reader              The file to load signal from.
+/// \param      batch_counts        The number of rows to load from each read table batch, as found by [pod5_plan_traversal].
+///                                 Null to load every read in the file.
+/// \param      batch_counts_count  The number of entries in [batch_counts], which must be the file's read table batch count.
+/// \param      batch_rows          The rows to load from each batch, packed into one array as found by [pod5_plan_traversal].
+///                                 Null to load every read in the file.
+/// \param      batch_rows_count    The number of entries in [batch_rows], at least the sum of [batch_counts].
+/// \param      options             The options to use when loading, or null for the defaults.
+/// \param[out] loader              The loader, to be released with pod5_close_and_free_signal_loader.
+/// \note The plan is copied, and the loader holds its own reference to the file, so both may be released while it runs.
+POD5_FORMAT_EXPORT pod5_error_t pod5_create_signal_loader(
+    Pod5FileReader_t * reader,
+    uint32_t const * batch_counts,
+    size_t batch_counts_count,
+    uint32_t const * batch_rows,
+    size_t batch_rows_count,
+    Pod5SignalLoaderOptions_t const * options,
+    Pod5SignalLoader_t ** loader);
+
+/// \brief Take the next batch of loaded signal, in read table batch order, waiting for it to finish loading.
+/// \param      loader  The loader to take a batch from.
+/// \param[out] batch   The batch, to be released with pod5_free_signal_loader_batch, or null once every batch has been taken.
+/// \note Every read table batch is returned, with no reads if none were planned from it.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_signal_loader_release_next_batch(Pod5SignalLoader_t * loader, Pod5SignalLoaderBatch_t ** batch);
+
+/// \brief Take any batch of loaded signal that has finished loading, in the order batches finish, so a slow
+///        batch doesn't hold back those loaded after it.
+/// \param      loader  The loader to take a batch from.
+/// \param[out] batch   The batch, to be released with pod5_free_signal_loader_batch, or null once every batch has been taken.
+/// \note Use [batch_index] on the batch to find which read table batch it holds.
+POD5_FORMAT_EXPORT pod5_error_t pod5_signal_loader_release_next_completed_batch(
+    Pod5SignalLoader_t * loader,
+    Pod5SignalLoaderBatch_t ** batch);
+
+/// \brief Release a batch taken from a signal loader, returning its sample storage to the loader for reuse.
+/// \note Batches may be released before or after the loader they came from.
+POD5_FORMAT_EXPORT pod5_error_t pod5_free_signal_loader_batch(Pod5SignalLoaderBatch_t * batch);
+
+/// \brief Find the number of threads a signal loader is loading signal with.
+/// \param      loader          The loader to query.
+/// \param[out] worker_count    The number of threads loading signal, which a loader with an adaptive worker count
+///                             changes as it loads.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_get_signal_loader_worker_count(Pod5SignalLoader_t * loader, size_t * worker_count);
+
+/// \brief Stop a signal loader, waiting for its threads to finish, and release it.
+POD5_FORMAT_EXPORT pod5_error_t pod5_close_and_free_signal_loader(Pod5SignalLoader_t * loader);
+
+//---------------------------------------------------------------------------------------------------------------------
+// Reading datasets
+//---------------------------------------------------------------------------------------------------------------------
+
+// Options to control how a dataset is read.
+struct Pod5DatasetReaderOptions {
+    /// \brief The most files to keep open at once, 0 for no limit.
+    size_t max_open_files;
+    /// \brief The number of threads used to build the dataset read id index, 0 for the default.
+    size_t index_threads;
+    /// \brief Disable file mapping into memory, as for Pod5ReaderOptions.
+    char force_disable_file_mapping;
+};
+typedef struct Pod5DatasetReaderOptions Pod5DatasetReaderOptions_t;
+
+/// \brief Open a set of pod5 files as one dataset. Files are opened lazily, as they are used.
+/// \param filenames        The filenames of the pod5 files.
+/// \param file_count       The number of filenames.
+/// \param options          The options to use when reading the dataset, or null for the defaults.
+POD5_FORMAT_EXPORT Pod5DatasetReader_t * pod5_open_dataset(
+    char const * const * filenames,
+    size_t file_count,
+    Pod5DatasetReaderOptions_t const * options);
+
+/// \brief Close a dataset reader, releasing all memory held by the reader.
+POD5_FORMAT_EXPORT pod5_error_t pod5_close_and_free_dataset(Pod5DatasetReader_t * dataset);
+
+/// \brief Find the number of files in the dataset.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_get_dataset_file_count(Pod5DatasetReader_t * dataset, size_t * count);
+
+/// \brief Find the number of reads in the dataset, building the dataset index if needed.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_get_dataset_read_count(Pod5DatasetReader_t * dataset, size_t * count);
+
+/// \brief Open a reader for one file of the dataset.
+/// \param      dataset     The dataset to read from.
+/// \param      file_index  The index of the file, in the order the dataset was opened with.
+/// \param[out] reader      The file reader, to be released with pod5_close_and_free_reader.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_dataset_file_reader(
+    Pod5DatasetReader_t * dataset,
+    size_t file_index,
+    Pod5FileReader_t ** reader);
+
+/// \brief Load a dataset read id index written by pod5_write_dataset_index, rather than building
+///        one from the files.
+/// \note The index must have been written for the same list of files.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_load_dataset_index(Pod5DatasetReader_t * dataset, char const * index_filename);
+
+/// \brief Write the dataset read id index to a file, building it first if needed.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_write_dataset_index(Pod5DatasetReader_t * dataset, char const * index_filename);
+
+struct DatasetReadLocation {
+    uint32_t file_index;
+    uint32_t batch;
+    uint32_t batch_row;
+};
+typedef struct DatasetReadLocation DatasetReadLocation_t;
+
+/// \brief Plan the most efficient route through the dataset for the given read ids.
+/// \param      dataset             The dataset to be queried.
+/// \param      read_id_array       The read id array (contiguous array, 16 bytes per id).
+/// \param      read_id_count       The number of read ids.
+/// \param[out] locations           The locations of the reads found, sorted by file, batch and
+///                                 then row. Input array length should equal read_id_count.
+/// \param[out] find_success_count  The number of requested read ids that were found.
+/// \note Builds the dataset index if needed. A read held by several files is found in the first.
+POD5_FORMAT_EXPORT pod5_error_t pod5_plan_dataset_traversal(
+    Pod5DatasetReader_t * dataset,
+    uint8_t const * read_id_array,
+    size_t read_id_count,
+    DatasetReadLocation_t * locations,
+    size_t * find_success_count);
+
 //---------------------------------------------------------------------------------------------------------------------
 // Writing files
 //---------------------------------------------------------------------------------------------------------------------
@@ -705,6 +1411,28 @@ POD5_FORMAT_EXPORT pod5_error_t pod5_vbz_compress_signal(
     char * compressed_signal_out,
     size_t * compressed_signal_size);
 
+/// \brief VBZ compress the signal for many reads in parallel, packing the result into one buffer.
+///
+/// The compressed signal for read `r` is at `compressed_signal_out + compressed_signal_offsets[r]`, and is
+/// `compressed_signal_offsets[r + 1] - compressed_signal_offsets[r]` bytes long, ready to pass to
+/// [pod5_add_reads_data_pre_compressed]. Reads are compressed on a thread pool shared by the process.
+///
+/// \param          read_count                  The number of reads to compress.
+/// \param          signal                      The signal for each read, an array of length [read_count].
+/// \param          signal_size                 The number of samples for each read, an array of length [read_count].
+/// \param[out]     compressed_signal_out       The packed compressed signal.
+/// \param          compressed_signal_out_size  The size of compressed_signal_out in bytes, must be at least the sum of
+///                                             [pod5_vbz_compressed_signal_max_size] for each read.
+/// \param[out]     compressed_signal_offsets   The offset of each read in compressed_signal_out, an array of length
+///                                             [read_count] + 1, the final entry is the total compressed size.
+POD5_FORMAT_EXPORT pod5_error_t pod5_vbz_compress_signal_batch(
+    size_t read_count,
+    int16_t const ** signal,
+    size_t const * signal_size,
+    char * compressed_signal_out,
+    size_t compressed_signal_out_size,
+    size_t * compressed_signal_offsets);
+
 /// \brief VBZ decompress an array of samples.
 /// \param          compressed_signal           The signal to decompress.
 /// \param          compressed_signal_size      The number of compressed bytes, ie the size of compressed_signal in bytes.
@@ -720,11 +1448,63 @@ POD5_FORMAT_EXPORT pod5_error_t pod5_vbz_decompress_signal(
 // Global state
 //---------------------------------------------------------------------------------------------------------------------
 
+#define POD5_THREAD_POOL_TIME_HISTOGRAM_BUCKETS 24
+
+// Work queued and run on a thread pool, see pod5_get_thread_pool_statistics.
+struct Pod5ThreadPoolStatistics {
+    /// Tasks posted and not yet started, including those queued on strands.
+    size_t queued_tasks;
+    /// Tasks running now.
+    size_t running_tasks;
+    /// Strands with queued tasks, and the most tasks queued on one strand.
+    size_t queued_strands;
+    size_t max_strand_queued_tasks;
+    /// Tasks run to completion.
+    uint64_t tasks_run;
+    /// Tasks by the time from being posted to starting, and by the time taken to run: [0] under 1us, [1] under 2us,
+    /// [2] under 4us... the last bucket holding every longer task.
+    uint64_t wait_time_histogram[POD5_THREAD_POOL_TIME_HISTOGRAM_BUCKETS];
+    uint64_t run_time_histogram[POD5_THREAD_POOL_TIME_HISTOGRAM_BUCKETS];
+    /// Workers in the pool, and the mean fraction of the time since they started they have spent running tasks.
+    size_t worker_count;
+    double mean_worker_busy_ratio;
+};
+typedef struct Pod5ThreadPoolStatistics Pod5ThreadPoolStatistics_t;
+
+/// \brief Find the work queued and run on the thread pool shared by the process, used by
+///        [pod5_get_read_complete_signal_options] for parallel decodes and by [pod5_vbz_compress_signal_batch].
+/// \param[out]     statistics                  The pool's statistics.
+/// \param[out]     worker_busy_ratios          The fraction of the time since each worker started it has spent running
+///                                             tasks, may be null.
+/// \param          worker_busy_ratios_count    The length of worker_busy_ratios, ratios are written for up to this many
+///                                             workers.
+POD5_FORMAT_EXPORT pod5_error_t pod5_get_thread_pool_statistics(
+    Pod5ThreadPoolStatistics_t * statistics,
+    double * worker_busy_ratios,
+    size_t worker_busy_ratios_count);
+
 /// \brief Format a packed binary read id as a readable read id string:
 /// \param          read_id           A 16 byte binary formatted UUID.
 /// \param[out]     read_id_string    Output string containing the string formatted UUID (expects a string of at least 37 bytes, one null byte is written.)
 POD5_FORMAT_EXPORT pod5_error_t pod5_format_read_id(read_id_t const read_id, char * read_id_string);
 
+/// \brief Format packed binary read ids as read id strings, several at a time:
+/// \param          read_ids            read_id_count 16 byte binary formatted UUIDs.
+/// \param          read_id_count       The number of read ids to format.
+/// \param[out]     read_id_strings     Output of 36 chars per read id, one after another with no null bytes (expects a string
+///                                     of at least 36 * read_id_count bytes).
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_format_read_ids(read_id_t const * read_ids, size_t read_id_count, char * read_id_strings);
+
+/// \brief Parse read id strings into packed binary read ids, several at a time:
+/// \param          read_id_strings     read_id_count read id strings of 36 chars each, one after another with no null bytes.
+///                                     Hex digits may be upper or lower case.
+/// \param          read_id_count       The number of read ids to parse.
+/// \param[out]     read_ids            Output of read_id_count 16 byte binary formatted UUIDs.
+/// \returns An error naming the first string which isn't a read id, if any.
+POD5_FORMAT_EXPORT pod5_error_t
+pod5_parse_read_ids(char const * read_id_strings, size_t read_id_count, read_id_t * read_ids);
+
 #ifdef __cplusplus
 }
 #endif
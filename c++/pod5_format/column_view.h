@@ -0,0 +1,172 @@
+#pragma once
+
+#include "pod5_format/types.h"
+
+#include <arrow/array/array_dict.h>
+#include <arrow/array/array_nested.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/record_batch.h>
+#include <arrow/util/bit_util.h>
+#include <gsl/gsl-lite.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace pod5 {
+
+/// \brief The raw values of an arrow column, found once so rows are read straight from the
+///        column's buffers.
+///
+/// A default constructed view is empty, as are views of fields a batch doesn't hold. Rows are
+/// not checked for nulls, or against the column's length, and a view is valid for as long as
+/// the batch it was made from.
+template <typename ArrayType>
+class ColumnView;
+
+template <typename ArrowType>
+class ColumnView<arrow::NumericArray<ArrowType>> {
+public:
+    using ValueType = typename ArrowType::c_type;
+
+    ColumnView() = default;
+
+    explicit ColumnView(arrow::NumericArray<ArrowType> const & array)
+    : m_values(array.raw_values())
+    {
+    }
+
+    explicit operator bool() const { return m_values != nullptr; }
+
+    ValueType operator[](std::int64_t row) const { return m_values[row]; }
+
+    ValueType const * data() const { return m_values; }
+
+private:
+    ValueType const * m_values = nullptr;
+};
+
+template <>
+class ColumnView<UuidArray> {
+public:
+    ColumnView() = default;
+
+    explicit ColumnView(UuidArray const & array) : m_values(array.raw_values()) {}
+
+    explicit operator bool() const { return m_values != nullptr; }
+
+    Uuid const & operator[](std::int64_t row) const { return m_values[row]; }
+
+    Uuid const * data() const { return m_values; }
+
+private:
+    Uuid const * m_values = nullptr;
+};
+
+template <>
+class ColumnView<arrow::BooleanArray> {
+public:
+    ColumnView() = default;
+
+    explicit ColumnView(arrow::BooleanArray const & array)
+    : m_bits(array.values()->data())
+    , m_bit_offset(array.offset())
+    {
+    }
+
+    explicit operator bool() const { return m_bits != nullptr; }
+
+    bool operator[](std::int64_t row) const
+    {
+        return arrow::bit_util::GetBit(m_bits, m_bit_offset + row);
+    }
+
+private:
+    std::uint8_t const * m_bits = nullptr;
+    std::int64_t m_bit_offset = 0;
+};
+
+/// \note Rows read the dictionary index of their value, as pod5 dictionaries are int16 indexed.
+template <>
+class ColumnView<arrow::DictionaryArray> {
+public:
+    ColumnView() = default;
+
+    explicit ColumnView(arrow::DictionaryArray const & array)
+    : m_indices(static_cast<arrow::Int16Array const &>(*array.indices()).raw_values())
+    {
+    }
+
+    explicit operator bool() const { return m_indices != nullptr; }
+
+    std::int16_t operator[](std::int64_t row) const { return m_indices[row]; }
+
+    std::int16_t const * data() const { return m_indices; }
+
+private:
+    std::int16_t const * m_indices = nullptr;
+};
+
+/// \brief The raw values of a list column, each row reading its span of [ElementArrayType]'s
+///        values.
+template <typename ElementArrayType>
+class ListColumnView {
+public:
+    using ValueType = typename ColumnView<ElementArrayType>::ValueType;
+
+    ListColumnView() = default;
+
+    explicit ListColumnView(arrow::ListArray const & array)
+    : m_offsets(array.raw_value_offsets())
+    , m_values(static_cast<ElementArrayType const &>(*array.values()).raw_values())
+    {
+    }
+
+    explicit operator bool() const { return m_offsets != nullptr; }
+
+    gsl::span<ValueType const> operator[](std::int64_t row) const
+    {
+        return gsl::make_span(m_values + m_offsets[row], m_values + m_offsets[row + 1]);
+    }
+
+    std::int32_t value_length(std::int64_t row) const
+    {
+        return m_offsets[row + 1] - m_offsets[row];
+    }
+
+private:
+    std::int32_t const * m_offsets = nullptr;
+    ValueType const * m_values = nullptr;
+};
+
+namespace detail {
+template <typename FieldType, typename = void>
+struct ColumnViewOf {
+    using type = ColumnView<typename FieldType::ArrayType>;
+};
+
+template <typename FieldType>
+struct ColumnViewOf<FieldType, std::void_t<typename FieldType::ElementType>> {
+    using type = ListColumnView<typename FieldType::ElementType>;
+};
+}  // namespace detail
+
+/// \brief The view of a schema field's column, ListColumnView for a ListField, ColumnView
+///        otherwise.
+template <typename FieldType>
+using ColumnViewType = typename detail::ColumnViewOf<FieldType>::type;
+
+/// \brief View [field]'s column in [batch], empty if the batch doesn't hold it.
+template <typename FieldType>
+ColumnViewType<FieldType> make_column_view(
+    arrow::RecordBatch const & batch,
+    FieldType const & field)
+{
+    // Batches loaded with a projection may not hold the field:
+    if (!field.found_field() || field.field_index() >= batch.num_columns()) {
+        return {};
+    }
+    auto const column = batch.column(field.field_index());
+    return ColumnViewType<FieldType>(static_cast<typename FieldType::ArrayType const &>(*column));
+}
+
+}  // namespace pod5
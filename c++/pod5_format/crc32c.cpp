@@ -0,0 +1,105 @@
+#include "pod5_format/crc32c.h"
+
+#include "pod5_format/svb16/common.hpp"
+#ifdef SVB16_X64
+#include "pod5_format/svb16/intrinsics.hpp"
+#include "pod5_format/svb16/simd_detect_x64.hpp"
+#endif
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#include <array>
+#include <cstring>
+
+namespace pod5 {
+
+namespace {
+
+// CRC32C's polynomial, bit reversed as the checksum is computed least significant bit first:
+static constexpr std::uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+constexpr std::array<std::uint32_t, 256> make_crc32c_table()
+{
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLYNOMIAL : 0);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static constexpr auto CRC32C_TABLE = make_crc32c_table();
+
+std::uint32_t crc32c_scalar(std::uint8_t const * data, std::size_t size, std::uint32_t crc)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = (crc >> 8) ^ CRC32C_TABLE[(crc ^ data[i]) & 0xff];
+    }
+    return crc;
+}
+
+std::uint64_t load_u64(std::uint8_t const * data)
+{
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+#ifdef SVB16_X64
+
+[[gnu::target("sse4.2")]] std::uint32_t crc32c_sse4_2(
+    std::uint8_t const * data,
+    std::size_t size,
+    std::uint32_t crc)
+{
+    std::uint64_t crc64 = crc;
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t)) {
+        crc64 = _mm_crc32_u64(crc64, load_u64(data));
+        data += sizeof(std::uint64_t);
+    }
+    crc = std::uint32_t(crc64);
+    for (; size > 0; --size) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+
+#endif  // SVB16_X64
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+
+std::uint32_t crc32c_armv8(std::uint8_t const * data, std::size_t size, std::uint32_t crc)
+{
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t)) {
+        crc = __crc32cd(crc, load_u64(data));
+        data += sizeof(std::uint64_t);
+    }
+    for (; size > 0; --size) {
+        crc = __crc32cb(crc, *data++);
+    }
+    return crc;
+}
+
+#endif
+
+}  // namespace
+
+std::uint32_t crc32c(gsl::span<std::uint8_t const> const & data, std::uint32_t crc)
+{
+    // The register holds the checksum inverted, so leading zero bytes change it:
+    crc = ~crc;
+#ifdef SVB16_X64
+    if (has_sse4_2()) {
+        return ~crc32c_sse4_2(data.data(), data.size(), crc);
+    }
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    return ~crc32c_armv8(data.data(), data.size(), crc);
+#endif
+    return ~crc32c_scalar(data.data(), data.size(), crc);
+}
+
+}  // namespace pod5
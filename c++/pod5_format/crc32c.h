@@ -0,0 +1,19 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+
+#include <gsl/gsl-lite.hpp>
+
+#include <cstdint>
+
+namespace pod5 {
+
+/// \brief Find the CRC32C (Castagnoli) checksum of [data].
+/// \param crc  The checksum of the data preceding [data], to checksum data given in pieces.
+///
+/// Uses the SSE4.2 or ARMv8 CRC32 instructions where the CPU supports them.
+POD5_FORMAT_EXPORT std::uint32_t crc32c(
+    gsl::span<std::uint8_t const> const & data,
+    std::uint32_t crc = 0);
+
+}  // namespace pod5
@@ -0,0 +1,738 @@
+#include "pod5_format/dataset_reader.h"
+
+#include "pod5_format/file_summary.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/internal/sharded_lru_cache.h"
+#include "pod5_format/read_id_index.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/schema_metadata.h"
+#include "pod5_format/thread_pool.h"
+
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <arrow/util/io_util.h>
+#include <arrow/util/key_value_metadata.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+
+namespace pod5 {
+
+namespace {
+
+char const * const INDEX_TYPE_KEY = "MINKNOW:index_type";
+char const * const DATASET_INDEX_TYPE = "dataset_read_id_index";
+char const * const FILE_COUNT_KEY = "MINKNOW:dataset_file_count";
+char const * const FILE_PATH_KEY_PREFIX = "MINKNOW:dataset_file_path_";
+char const * const FILE_IDENTIFIER_KEY_PREFIX = "MINKNOW:dataset_file_identifier_";
+
+struct IndexEntry {
+    Uuid id;
+    std::uint32_t file;
+    std::uint32_t batch;
+    std::uint32_t batch_row;
+};
+
+bool compare_ids(IndexEntry const & a, IndexEntry const & b) { return a.id < b.id; }
+
+struct IndexStorage {
+    std::vector<Uuid> read_ids;
+    std::vector<std::uint32_t> files;
+    std::vector<std::uint32_t> batches;
+    std::vector<std::uint32_t> batch_rows;
+};
+
+// Read and sample counts of a file, or of a read table batch.
+struct ReadTotals {
+    std::uint64_t read_count = 0;
+    std::uint64_t sample_count = 0;
+};
+
+// Count the reads and samples of each read table batch of [reader], reading only the
+// num_samples column.
+Result<std::vector<ReadTotals>> count_batch_samples(FileReader const & reader)
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto const projection, reader.make_read_table_projection({"num_samples"}));
+    std::vector<ReadTotals> batches(reader.num_read_record_batches());
+    for (std::size_t batch = 0; batch < batches.size(); ++batch) {
+        ARROW_ASSIGN_OR_RAISE(
+            auto const read_batch, reader.read_read_record_batch(batch, *projection));
+        ARROW_ASSIGN_OR_RAISE(auto const columns, read_batch.columns());
+        if (!columns.num_samples) {
+            return Status::IOError("Read table has no num_samples column");
+        }
+        batches[batch].read_count = read_batch.num_rows();
+        for (std::int64_t row = 0; row < columns.num_samples->length(); ++row) {
+            batches[batch].sample_count += columns.num_samples->Value(row);
+        }
+    }
+    return batches;
+}
+
+std::shared_ptr<arrow::Schema> make_dataset_index_schema(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    return arrow::schema(
+        {
+            arrow::field("read_id", arrow::fixed_size_binary(sizeof(Uuid)), false),
+            arrow::field("file", arrow::uint32(), false),
+            arrow::field("batch", arrow::uint32(), false),
+            arrow::field("batch_row", arrow::uint32(), false),
+        },
+        metadata);
+}
+
+}  // namespace
+
+DatasetReadIdIndex::DatasetReadIdIndex(
+    std::shared_ptr<void const> storage,
+    gsl::span<Uuid const> read_ids,
+    gsl::span<std::uint32_t const> files,
+    gsl::span<std::uint32_t const> batches,
+    gsl::span<std::uint32_t const> batch_rows,
+    std::vector<std::string> file_paths,
+    std::vector<Uuid> file_identifiers)
+: m_reads(std::make_shared<ReadIdIndex const>(std::move(storage), read_ids, batches, batch_rows))
+, m_files(files)
+, m_file_paths(std::move(file_paths))
+, m_file_identifiers(std::move(file_identifiers))
+{
+    assert(m_files.size() == m_reads->size());
+    assert(m_file_paths.size() == m_file_identifiers.size());
+}
+
+Result<std::shared_ptr<DatasetReadIdIndex const>> DatasetReadIdIndex::open(
+    std::string const & path)
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto file, arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ));
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(file));
+
+    auto const & schema = reader->schema();
+    auto const & metadata = schema->metadata();
+    if (!schema->Equals(*make_dataset_index_schema(nullptr), false) || !metadata) {
+        return Status::IOError("Invalid dataset index schema");
+    }
+    ARROW_ASSIGN_OR_RAISE(auto const index_type, metadata->Get(INDEX_TYPE_KEY));
+    if (index_type != DATASET_INDEX_TYPE) {
+        return Status::IOError("Invalid dataset index type '", index_type, "'");
+    }
+    if (reader->num_record_batches() != 1) {
+        return Status::IOError("Invalid dataset index, expected a single batch");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto const file_count_str, metadata->Get(FILE_COUNT_KEY));
+    std::size_t file_count = 0;
+    try {
+        file_count = std::stoull(file_count_str);
+    } catch (std::exception const &) {
+        return Status::IOError("Invalid dataset index file count '", file_count_str, "'");
+    }
+
+    std::vector<std::string> file_paths(file_count);
+    std::vector<Uuid> file_identifiers(file_count);
+    for (std::size_t i = 0; i < file_count; ++i) {
+        auto const index_str = std::to_string(i);
+        ARROW_ASSIGN_OR_RAISE(file_paths[i], metadata->Get(FILE_PATH_KEY_PREFIX + index_str));
+        ARROW_ASSIGN_OR_RAISE(
+            auto const identifier_str, metadata->Get(FILE_IDENTIFIER_KEY_PREFIX + index_str));
+        auto const identifier = Uuid::from_string(identifier_str);
+        if (!identifier) {
+            return Status::IOError("Invalid dataset index file identifier '", identifier_str, "'");
+        }
+        file_identifiers[i] = *identifier;
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadRecordBatch(0));
+    auto const read_ids = std::static_pointer_cast<arrow::FixedSizeBinaryArray>(batch->column(0));
+    auto const files = std::static_pointer_cast<arrow::UInt32Array>(batch->column(1));
+    auto const batches = std::static_pointer_cast<arrow::UInt32Array>(batch->column(2));
+    auto const batch_rows = std::static_pointer_cast<arrow::UInt32Array>(batch->column(3));
+    if (read_ids->null_count() != 0 || files->null_count() != 0 || batches->null_count() != 0
+        || batch_rows->null_count() != 0)
+    {
+        return Status::IOError("Invalid dataset index, unexpected null entries");
+    }
+
+    std::size_t const length = batch->num_rows();
+    auto const file_values = gsl::make_span(files->raw_values(), length);
+    if (std::any_of(file_values.begin(), file_values.end(), [&](std::uint32_t file) {
+            return file >= file_count;
+        }))
+    {
+        return Status::IOError("Invalid dataset index, entry refers to a missing file");
+    }
+
+    // The spans reference the mapped file, which [batch] keeps open:
+    return std::make_shared<DatasetReadIdIndex const>(
+        batch,
+        gsl::make_span(reinterpret_cast<Uuid const *>(read_ids->raw_values()), length),
+        file_values,
+        gsl::make_span(batches->raw_values(), length),
+        gsl::make_span(batch_rows->raw_values(), length),
+        std::move(file_paths),
+        std::move(file_identifiers));
+}
+
+Status DatasetReadIdIndex::write(std::string const & path, arrow::MemoryPool * pool) const
+{
+    auto const metadata = std::make_shared<arrow::KeyValueMetadata>();
+    metadata->Append(INDEX_TYPE_KEY, DATASET_INDEX_TYPE);
+    metadata->Append(FILE_COUNT_KEY, std::to_string(m_file_paths.size()));
+    for (std::size_t i = 0; i < m_file_paths.size(); ++i) {
+        auto const index_str = std::to_string(i);
+        metadata->Append(FILE_PATH_KEY_PREFIX + index_str, m_file_paths[i]);
+        metadata->Append(FILE_IDENTIFIER_KEY_PREFIX + index_str, to_string(m_file_identifiers[i]));
+    }
+
+    auto const length = std::int64_t(size());
+    auto const read_ids = std::make_shared<arrow::FixedSizeBinaryArray>(
+        arrow::fixed_size_binary(sizeof(Uuid)),
+        length,
+        arrow::Buffer::Wrap(m_reads->read_ids().data(), m_reads->read_ids().size()));
+    auto const files =
+        std::make_shared<arrow::UInt32Array>(length, arrow::Buffer::Wrap(m_files.data(), length));
+    auto const batches = std::make_shared<arrow::UInt32Array>(
+        length, arrow::Buffer::Wrap(m_reads->batches().data(), length));
+    auto const batch_rows = std::make_shared<arrow::UInt32Array>(
+        length, arrow::Buffer::Wrap(m_reads->batch_rows().data(), length));
+
+    auto const schema = make_dataset_index_schema(metadata);
+    auto const batch =
+        arrow::RecordBatch::Make(schema, length, {read_ids, files, batches, batch_rows});
+
+    ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::FileOutputStream::Open(path, false));
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(file, schema, options));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return file->Close();
+}
+
+bool DatasetReadIdIndex::has_duplicate_read_ids() const
+{
+    auto const read_ids = m_reads->read_ids();
+    return std::adjacent_find(read_ids.begin(), read_ids.end()) != read_ids.end();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+DatasetReader::DatasetReader(
+    std::vector<std::string> file_paths,
+    DatasetReaderOptions const & options)
+: m_file_paths(std::move(file_paths))
+, m_options(options)
+, m_open_files(
+      std::make_unique<ShardedLruCache<std::shared_ptr<FileReader>>>(
+          options.max_open_files(),
+          0,
+          "dataset open file cache"))
+{
+}
+
+DatasetReader::~DatasetReader() = default;
+
+Result<std::shared_ptr<FileReader>> DatasetReader::file_reader(std::size_t file) const
+{
+    if (file >= m_file_paths.size()) {
+        return Status::IndexError(
+            "Dataset file ", file, " out of range, dataset has ", m_file_paths.size(), " files");
+    }
+
+    using LoadedReader = ShardedLruCache<std::shared_ptr<FileReader>>::LoadedValue;
+    return m_open_files->get(file, [&]() -> Result<LoadedReader> {
+        ARROW_ASSIGN_OR_RAISE(auto reader, open_file(file));
+        return LoadedReader{std::move(reader), 1};
+    });
+}
+
+std::size_t DatasetReader::open_file_count() const { return m_open_files->item_count(); }
+
+Result<std::shared_ptr<FileReader>> DatasetReader::open_file(std::size_t file) const
+{
+    auto const & path = m_file_paths[file];
+    ARROW_ASSIGN_OR_RAISE(auto reader, open_file_reader(path, m_options.file_reader_options()));
+
+    std::shared_ptr<DatasetReadIdIndex const> index;
+    {
+        std::lock_guard<std::mutex> l(m_index_mutex);
+        index = m_index;
+    }
+    if (index && reader->schema_metadata().file_identifier != index->file_identifiers()[file]) {
+        return Status::IOError("File '", path, "' has changed since the dataset was indexed");
+    }
+    return reader;
+}
+
+Status DatasetReader::build_index()
+{
+    std::lock_guard<std::mutex> build_lock(m_index_build_mutex);
+    {
+        std::lock_guard<std::mutex> l(m_index_mutex);
+        if (m_index) {
+            return Status::OK();
+        }
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto index, build_index_from(nullptr));
+    std::lock_guard<std::mutex> l(m_index_mutex);
+    m_index = std::move(index);
+    return Status::OK();
+}
+
+Result<std::shared_ptr<DatasetReadIdIndex const>> DatasetReader::build_index_from(
+    DatasetReadIdIndex const * previous) const
+{
+    auto const file_count = m_file_paths.size();
+
+    // Find which files [previous] already holds, and where each of its files is in the dataset:
+    std::uint32_t const NOT_IN_DATASET = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> previous_to_file;
+    std::vector<bool> file_indexed(file_count, false);
+    if (previous) {
+        std::unordered_map<std::string, std::uint32_t> file_indices;
+        for (std::size_t file = 0; file < file_count; ++file) {
+            file_indices.emplace(m_file_paths[file], std::uint32_t(file));
+        }
+        for (auto const & path : previous->file_paths()) {
+            auto const it = file_indices.find(path);
+            previous_to_file.push_back(it != file_indices.end() ? it->second : NOT_IN_DATASET);
+            if (it != file_indices.end()) {
+                file_indexed[it->second] = true;
+            }
+        }
+    }
+
+    std::vector<std::size_t> files_to_read;
+    for (std::size_t file = 0; file < file_count; ++file) {
+        if (!file_indexed[file]) {
+            files_to_read.push_back(file);
+        }
+    }
+
+    // The calling thread indexes files alongside the pool, each thread has one file open:
+    auto thread_count = std::max<std::size_t>(1, m_options.index_threads());
+    if (m_options.max_open_files() != 0) {
+        thread_count = std::min(thread_count, m_options.max_open_files());
+    }
+    thread_count = std::max<std::size_t>(1, std::min(thread_count, file_count));
+    auto const thread_pool = thread_count > 1 ? make_thread_pool(thread_count - 1) : nullptr;
+
+    // Each file's own index is already sorted, giving one sorted run per file:
+    std::vector<std::vector<IndexEntry>> file_entries(file_count);
+    std::vector<Uuid> file_identifiers(file_count);
+    if (previous) {
+        // The previous index is sorted, so each file's entries taken from it stay sorted:
+        auto const & previous_reads = previous->reads();
+        for (std::size_t i = 0; i < previous_reads.size(); ++i) {
+            auto const file = previous_to_file[previous->file(i)];
+            if (file != NOT_IN_DATASET) {
+                file_entries[file].push_back(
+                    {previous_reads.read_ids()[i],
+                     file,
+                     previous_reads.batch(i),
+                     previous_reads.batch_row(i)});
+            }
+        }
+        for (std::size_t i = 0; i < previous_to_file.size(); ++i) {
+            if (previous_to_file[i] != NOT_IN_DATASET) {
+                file_identifiers[previous_to_file[i]] = previous->file_identifiers()[i];
+            }
+        }
+    }
+
+    auto const index_file = [&](std::size_t file) -> Status {
+        ARROW_ASSIGN_OR_RAISE(
+            auto reader, open_file_reader(m_file_paths[file], m_options.file_reader_options()));
+        file_identifiers[file] = reader->schema_metadata().file_identifier;
+
+        ARROW_ASSIGN_OR_RAISE(auto const file_index, reader->read_id_index());
+        auto & entries = file_entries[file];
+        entries.resize(file_index->size());
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            entries[i] = {
+                file_index->read_ids()[i],
+                std::uint32_t(file),
+                file_index->batch(i),
+                file_index->batch_row(i)};
+        }
+        return Status::OK();
+    };
+    ARROW_RETURN_NOT_OK(internal::run_parallel_tasks(
+        thread_pool.get(), files_to_read.size(), [&](std::size_t i) {
+            auto const file = files_to_read[i];
+            auto const status = index_file(file);
+            if (!status.ok()) {
+                return status.WithMessage(
+                    "Failed to index dataset file '", m_file_paths[file], "': ", status.message());
+            }
+            return status;
+        }));
+
+    // Run i of [sorted] covers [run_starts[i], run_starts[i + 1]):
+    std::vector<std::size_t> run_starts{0};
+    run_starts.reserve(file_count + 1);
+    for (auto const & entries : file_entries) {
+        run_starts.push_back(run_starts.back() + entries.size());
+    }
+
+    std::vector<IndexEntry> sorted(run_starts.back());
+    for (std::size_t i = 0; i < file_count; ++i) {
+        std::copy(file_entries[i].begin(), file_entries[i].end(), sorted.begin() + run_starts[i]);
+        file_entries[i] = {};
+    }
+
+    // The merge is stable, so a read id held by several files is found in the first file first:
+    ARROW_RETURN_NOT_OK(internal::merge_sorted_runs(
+        thread_pool.get(), sorted, std::move(run_starts), compare_ids));
+
+    auto storage = std::make_shared<IndexStorage>();
+    storage->read_ids.resize(sorted.size());
+    storage->files.resize(sorted.size());
+    storage->batches.resize(sorted.size());
+    storage->batch_rows.resize(sorted.size());
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        storage->read_ids[i] = sorted[i].id;
+        storage->files[i] = sorted[i].file;
+        storage->batches[i] = sorted[i].batch;
+        storage->batch_rows[i] = sorted[i].batch_row;
+    }
+
+    gsl::span<Uuid const> const read_ids{storage->read_ids};
+    gsl::span<std::uint32_t const> const files{storage->files};
+    gsl::span<std::uint32_t const> const batches{storage->batches};
+    gsl::span<std::uint32_t const> const batch_rows{storage->batch_rows};
+    return std::make_shared<DatasetReadIdIndex const>(
+        std::move(storage),
+        read_ids,
+        files,
+        batches,
+        batch_rows,
+        m_file_paths,
+        std::move(file_identifiers));
+}
+
+Status DatasetReader::check_open_files(DatasetReadIdIndex const & index)
+{
+    // Files opened later are checked against the index as they open:
+    for (std::size_t file = 0; file < m_file_paths.size(); ++file) {
+        if (!m_open_files->contains(file)) {
+            continue;
+        }
+        ARROW_ASSIGN_OR_RAISE(auto reader, file_reader(file));
+        if (reader->schema_metadata().file_identifier != index.file_identifiers()[file]) {
+            return Status::IOError(
+                "File '", m_file_paths[file], "' has changed since the dataset was indexed");
+        }
+    }
+    return Status::OK();
+}
+
+Status DatasetReader::load_index(std::string const & path)
+{
+    std::lock_guard<std::mutex> build_lock(m_index_build_mutex);
+    ARROW_ASSIGN_OR_RAISE(auto index, DatasetReadIdIndex::open(path));
+    if (index->file_paths() != m_file_paths) {
+        return Status::Invalid("Dataset index '", path, "' was written for a different dataset");
+    }
+    ARROW_RETURN_NOT_OK(check_open_files(*index));
+
+    std::lock_guard<std::mutex> l(m_index_mutex);
+    m_index = std::move(index);
+    return Status::OK();
+}
+
+Status DatasetReader::update_index(std::string const & path)
+{
+    std::lock_guard<std::mutex> build_lock(m_index_build_mutex);
+    ARROW_ASSIGN_OR_RAISE(
+        auto const arrow_path, arrow::internal::PlatformFilename::FromString(path));
+    ARROW_ASSIGN_OR_RAISE(bool const index_exists, arrow::internal::FileExists(arrow_path));
+
+    std::shared_ptr<DatasetReadIdIndex const> index;
+    if (index_exists) {
+        ARROW_ASSIGN_OR_RAISE(index, DatasetReadIdIndex::open(path));
+    }
+
+    if (!index || index->file_paths() != m_file_paths) {
+        ARROW_ASSIGN_OR_RAISE(auto const updated_index, build_index_from(index.get()));
+
+        // Write beside [path] and rename over it, so other processes never see a partial index.
+        // The written file is mapped before the rename, in case another process replaces it:
+        std::random_device gen;
+        auto uuid_gen = BasicUuidRandomGenerator<std::random_device>{gen};
+        auto const temporary_path = path + "." + to_string(uuid_gen()) + ".tmp";
+        auto const write_index_file = [&]() -> Result<std::shared_ptr<DatasetReadIdIndex const>> {
+            ARROW_RETURN_NOT_OK(updated_index->write(
+                temporary_path, m_options.file_reader_options().memory_pool()));
+            ARROW_ASSIGN_OR_RAISE(auto written_index, DatasetReadIdIndex::open(temporary_path));
+            if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+                return Status::IOError("Failed to replace dataset index '", path, "'");
+            }
+            return written_index;
+        };
+        auto written_index = write_index_file();
+        if (!written_index.ok()) {
+            std::remove(temporary_path.c_str());
+            return written_index.status();
+        }
+        index = std::move(*written_index);
+    }
+    ARROW_RETURN_NOT_OK(check_open_files(*index));
+
+    std::lock_guard<std::mutex> l(m_index_mutex);
+    m_index = std::move(index);
+    return Status::OK();
+}
+
+Status DatasetReader::write_index(std::string const & path)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const dataset_index, index());
+    return dataset_index->write(path, m_options.file_reader_options().memory_pool());
+}
+
+Result<std::shared_ptr<DatasetReadIdIndex const>> DatasetReader::index()
+{
+    ARROW_RETURN_NOT_OK(build_index());
+    std::lock_guard<std::mutex> l(m_index_mutex);
+    return m_index;
+}
+
+Result<std::size_t> DatasetReader::read_count()
+{
+    ARROW_ASSIGN_OR_RAISE(auto const dataset_index, index());
+    return dataset_index->size();
+}
+
+Result<std::size_t> DatasetReader::search_for_read_ids(
+    gsl::span<Uuid const> const & read_ids,
+    gsl::span<DatasetReadLocation> const & locations)
+{
+    if (locations.size() < read_ids.size()) {
+        return Status::Invalid("Dataset search needs a location for each of the input read ids");
+    }
+    ARROW_ASSIGN_OR_RAISE(auto const dataset_index, index());
+    auto const & reads = dataset_index->reads();
+
+    // Walk the sorted search input through the sorted index, galloping between matches:
+    ReadIdSearchInput const search_input{read_ids};
+    std::size_t found_count = 0;
+    std::size_t index_position = 0;
+    for (std::size_t i = 0; i < search_input.read_id_count(); ++i) {
+        auto const & id = search_input[i].id;
+        index_position = reads.lower_bound(id, index_position);
+        if (index_position == reads.size()) {
+            break;
+        }
+        if (reads.read_ids()[index_position] == id) {
+            locations[found_count++] = {
+                dataset_index->file(index_position),
+                reads.batch(index_position),
+                reads.batch_row(index_position)};
+        }
+    }
+
+    std::sort(
+        locations.begin(),
+        locations.begin() + found_count,
+        [](DatasetReadLocation const & a, DatasetReadLocation const & b) {
+            return std::tie(a.file, a.batch, a.batch_row)
+                   < std::tie(b.file, b.batch, b.batch_row);
+        });
+    return found_count;
+}
+
+Result<std::vector<DatasetShard>> DatasetReader::plan_shards(std::size_t shard_count) const
+{
+    if (shard_count == 0) {
+        return Status::Invalid("A dataset can't be split into 0 shards");
+    }
+    auto const file_count = m_file_paths.size();
+
+    // Tables are opened as they are used, so files a boundary doesn't fall within only have their
+    // footer and read table footer read:
+    auto reader_options = m_options.file_reader_options();
+    reader_options.set_lazy_open(true);
+    auto const open_lazily = [&](std::size_t file) {
+        return open_file_reader(m_file_paths[file], reader_options);
+    };
+
+    auto thread_count = std::max<std::size_t>(1, m_options.index_threads());
+    if (m_options.max_open_files() != 0) {
+        thread_count = std::min(thread_count, m_options.max_open_files());
+    }
+    thread_count = std::max<std::size_t>(1, std::min(thread_count, file_count));
+    auto const thread_pool = thread_count > 1 ? make_thread_pool(thread_count - 1) : nullptr;
+    auto const for_each_file = [&](std::vector<std::size_t> const & files, auto && task) {
+        return internal::run_parallel_tasks(
+            thread_pool.get(), files.size(), [&](std::size_t i) -> Status {
+                auto const status = task(files[i]);
+                if (!status.ok()) {
+                    return status.WithMessage(
+                        "Failed to size dataset file '",
+                        m_file_paths[files[i]],
+                        "': ",
+                        status.message());
+                }
+                return status;
+            });
+    };
+
+    // Size each file from its summary, or by its batches if it has none:
+    std::vector<Uuid> file_identifiers(file_count);
+    std::vector<std::size_t> file_batch_counts(file_count);
+    std::vector<ReadTotals> file_totals(file_count);
+    std::vector<std::vector<ReadTotals>> file_batches(file_count);
+    std::vector<std::size_t> all_files(file_count);
+    std::iota(all_files.begin(), all_files.end(), 0);
+    ARROW_RETURN_NOT_OK(for_each_file(all_files, [&](std::size_t file) -> Status {
+        ARROW_ASSIGN_OR_RAISE(auto const reader, open_lazily(file));
+        file_identifiers[file] = reader->schema_metadata().file_identifier;
+        file_batch_counts[file] = reader->num_read_record_batches();
+        ARROW_ASSIGN_OR_RAISE(
+            auto const summary,
+            open_file_summary(m_file_paths[file], m_options.file_reader_options().memory_pool()));
+        if (summary) {
+            file_totals[file] = {summary->read_count(), summary->sample_count()};
+            return Status::OK();
+        }
+        ARROW_ASSIGN_OR_RAISE(file_batches[file], count_batch_samples(*reader));
+        for (auto const & batch : file_batches[file]) {
+            file_totals[file].read_count += batch.read_count;
+            file_totals[file].sample_count += batch.sample_count;
+        }
+        return Status::OK();
+    }));
+
+    std::vector<std::uint64_t> file_starts{0};
+    for (auto const & totals : file_totals) {
+        file_starts.push_back(file_starts.back() + totals.sample_count);
+    }
+    auto const total_samples = file_starts.back();
+
+    // Shard i covers samples [i * total / shard_count, (i + 1) * total / shard_count), and takes
+    // each batch whose midpoint it covers:
+    auto const shard_at = [&](std::uint64_t start, std::uint64_t sample_count) -> std::size_t {
+        if (total_samples == 0) {
+            return 0;
+        }
+        auto const midpoint = (long double)start + (long double)sample_count / 2;
+        auto const shard = std::size_t(midpoint * shard_count / total_samples);
+        return std::min(shard, shard_count - 1);
+    };
+
+    // Files a boundary falls within are split by batch, so their batches are counted:
+    std::vector<std::size_t> files_to_split;
+    for (std::size_t file = 0; file < file_count; ++file) {
+        if (!file_batches[file].empty() || file_batch_counts[file] <= 1) {
+            continue;
+        }
+        if (shard_at(file_starts[file], 0) != shard_at(file_starts[file + 1], 0)) {
+            files_to_split.push_back(file);
+        }
+    }
+    ARROW_RETURN_NOT_OK(for_each_file(files_to_split, [&](std::size_t file) -> Status {
+        ARROW_ASSIGN_OR_RAISE(auto const reader, open_lazily(file));
+        if (reader->schema_metadata().file_identifier != file_identifiers[file]) {
+            return Status::IOError("File changed while the dataset was being split");
+        }
+        ARROW_ASSIGN_OR_RAISE(file_batches[file], count_batch_samples(*reader));
+        return Status::OK();
+    }));
+
+    std::vector<DatasetShard> shards(shard_count);
+    auto const add_batches = [&](std::size_t file,
+                                 std::size_t first_batch,
+                                 std::size_t batch_count,
+                                 std::uint64_t start,
+                                 ReadTotals const & totals) {
+        auto & shard = shards[shard_at(start, totals.sample_count)];
+        shard.read_count += totals.read_count;
+        shard.sample_count += totals.sample_count;
+        if (shard.units.empty() || shard.units.back().file != file) {
+            DatasetWorkUnit unit;
+            unit.file = std::uint32_t(file);
+            unit.file_path = m_file_paths[file];
+            unit.file_identifier = file_identifiers[file];
+            unit.first_batch = std::uint32_t(first_batch);
+            shard.units.push_back(std::move(unit));
+        }
+        auto & unit = shard.units.back();
+        unit.batch_count += std::uint32_t(batch_count);
+        unit.read_count += totals.read_count;
+        unit.sample_count += totals.sample_count;
+    };
+    for (std::size_t file = 0; file < file_count; ++file) {
+        if (file_batch_counts[file] == 0) {
+            continue;
+        }
+        if (file_batches[file].empty()) {
+            add_batches(file, 0, file_batch_counts[file], file_starts[file], file_totals[file]);
+            continue;
+        }
+        auto start = file_starts[file];
+        for (std::size_t batch = 0; batch < file_batches[file].size(); ++batch) {
+            add_batches(file, batch, 1, start, file_batches[file][batch]);
+            start += file_batches[file][batch].sample_count;
+        }
+    }
+    return shards;
+}
+
+DatasetWorkUnitReader::DatasetWorkUnitReader(
+    std::shared_ptr<FileReader> reader,
+    DatasetWorkUnit unit)
+: m_reader(std::move(reader))
+, m_unit(std::move(unit))
+{
+}
+
+Result<ReadTableRecordBatch> DatasetWorkUnitReader::read_read_record_batch(std::size_t i) const
+{
+    if (i >= m_unit.batch_count) {
+        return Status::IndexError(
+            "Work unit batch ", i, " out of range, unit has ", m_unit.batch_count, " batches");
+    }
+    return m_reader->read_read_record_batch(m_unit.first_batch + i);
+}
+
+Result<std::unique_ptr<DatasetWorkUnitReader>> open_dataset_work_unit(
+    DatasetWorkUnit const & unit,
+    FileReaderOptions const & options)
+{
+    ARROW_ASSIGN_OR_RAISE(auto reader, open_file_reader(unit.file_path, options));
+    if (reader->schema_metadata().file_identifier != unit.file_identifier) {
+        return Status::IOError(
+            "File '", unit.file_path, "' has changed since the work unit was planned");
+    }
+    if (std::size_t(unit.first_batch) + unit.batch_count > reader->num_read_record_batches()) {
+        return Status::IOError(
+            "Work unit batches are out of range of file '", unit.file_path, "'");
+    }
+    return std::make_unique<DatasetWorkUnitReader>(std::move(reader), unit);
+}
+
+Result<std::shared_ptr<DatasetReader>> open_dataset_reader(
+    std::vector<std::string> file_paths,
+    DatasetReaderOptions const & options)
+{
+    if (file_paths.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return Status::Invalid("Too many files in dataset");
+    }
+    return std::make_shared<DatasetReader>(std::move(file_paths), options);
+}
+
+}  // namespace pod5
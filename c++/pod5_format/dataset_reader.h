@@ -0,0 +1,249 @@
+#pragma once
+
+#include "pod5_format/file_reader.h"
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+#include "pod5_format/uuid.h"
+
+#include <gsl/gsl-lite.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pod5 {
+
+class ReadIdIndex;
+template <typename Value>
+class ShardedLruCache;
+
+class POD5_FORMAT_EXPORT DatasetReaderOptions {
+public:
+    static constexpr std::size_t DEFAULT_MAX_OPEN_FILES = 16;
+    static constexpr std::size_t DEFAULT_INDEX_THREADS = 4;
+
+    void set_file_reader_options(FileReaderOptions const & file_reader_options)
+    {
+        m_file_reader_options = file_reader_options;
+    }
+
+    FileReaderOptions const & file_reader_options() const { return m_file_reader_options; }
+
+    // Set how many files the dataset keeps open at once, the least recently used files are
+    // closed once this is exceeded.
+    // Note: 0 here implies no limit.
+    void set_max_open_files(std::size_t max_open_files) { m_max_open_files = max_open_files; }
+
+    std::size_t max_open_files() const { return m_max_open_files; }
+
+    // Set how many threads read files while building the dataset index. Indexing also reads no
+    // more than max_open_files() files at once.
+    void set_index_threads(std::size_t index_threads) { m_index_threads = index_threads; }
+
+    std::size_t index_threads() const { return m_index_threads; }
+
+private:
+    FileReaderOptions m_file_reader_options;
+    std::size_t m_max_open_files = DEFAULT_MAX_OPEN_FILES;
+    std::size_t m_index_threads = DEFAULT_INDEX_THREADS;
+};
+
+/// \brief The location of a read in a dataset.
+struct DatasetReadLocation {
+    std::uint32_t file;
+    std::uint32_t batch;
+    std::uint32_t batch_row;
+};
+
+/// \brief A unit of work in a dataset: a range of read table batches in one file.
+struct DatasetWorkUnit {
+    std::uint32_t file = 0;
+    /// The path and identifier of the file, so the unit can be opened without the dataset, and
+    /// changes to the file since the unit was planned detected.
+    std::string file_path;
+    Uuid file_identifier;
+    std::uint32_t first_batch = 0;
+    std::uint32_t batch_count = 0;
+    std::uint64_t read_count = 0;
+    std::uint64_t sample_count = 0;
+};
+
+/// \brief One worker's share of a dataset, made by DatasetReader::plan_shards().
+struct DatasetShard {
+    /// Units in dataset order, each file's batches in no more than one unit.
+    std::vector<DatasetWorkUnit> units;
+    std::uint64_t read_count = 0;
+    std::uint64_t sample_count = 0;
+};
+
+/// \brief Every read id in a dataset sorted by id, with the file and read table location of each
+///        read.
+///
+/// Written as an arrow table with one batch, holding sorted "read_id", "file", "batch" and
+/// "batch_row" columns. The schema metadata records the path and identifier of each file, so
+/// a stale index can be detected.
+class POD5_FORMAT_EXPORT DatasetReadIdIndex {
+public:
+    /// \param storage      Owns the memory the spans point into.
+    DatasetReadIdIndex(
+        std::shared_ptr<void const> storage,
+        gsl::span<Uuid const> read_ids,
+        gsl::span<std::uint32_t const> files,
+        gsl::span<std::uint32_t const> batches,
+        gsl::span<std::uint32_t const> batch_rows,
+        std::vector<std::string> file_paths,
+        std::vector<Uuid> file_identifiers);
+
+    /// \brief Open an index written by [write], memory mapping [path] rather than copying it.
+    static Result<std::shared_ptr<DatasetReadIdIndex const>> open(std::string const & path);
+
+    /// \brief Write the index to [path] as an arrow ipc file.
+    Status write(std::string const & path, arrow::MemoryPool * pool) const;
+
+    std::size_t size() const { return m_reads->size(); }
+
+    /// \brief Find the per file sorted index the dataset index is searched through.
+    /// \note The batch and batch row of each entry are locations in the entry's file().
+    ReadIdIndex const & reads() const { return *m_reads; }
+
+    std::uint32_t file(std::size_t i) const { return m_files[i]; }
+
+    std::vector<std::string> const & file_paths() const { return m_file_paths; }
+
+    std::vector<Uuid> const & file_identifiers() const { return m_file_identifiers; }
+
+    /// \brief Check if any read id is held by more than one entry.
+    bool has_duplicate_read_ids() const;
+
+private:
+    std::shared_ptr<ReadIdIndex const> m_reads;
+    gsl::span<std::uint32_t const> m_files;
+    std::vector<std::string> m_file_paths;
+    std::vector<Uuid> m_file_identifiers;
+};
+
+/// \brief Reads a set of pod5 files as one dataset.
+///
+/// Files are opened on first use, and only the most recently used are kept open. Reads are found
+/// across the dataset through a merged read id index, built on demand from each file's own index
+/// or loaded from a file written by write_index().
+class POD5_FORMAT_EXPORT DatasetReader {
+public:
+    DatasetReader(std::vector<std::string> file_paths, DatasetReaderOptions const & options);
+    ~DatasetReader();
+
+    std::size_t file_count() const { return m_file_paths.size(); }
+
+    std::string const & file_path(std::size_t file) const { return m_file_paths[file]; }
+
+    /// \brief Find the reader for [file], opening it if it isn't already open.
+    /// \note Readers stay usable after the dataset closes them, until the caller releases them.
+    Result<std::shared_ptr<FileReader>> file_reader(std::size_t file) const;
+
+    /// \brief Find the number of files the dataset currently has open.
+    std::size_t open_file_count() const;
+
+    /// \brief Build the dataset read id index, if it hasn't been built or loaded already.
+    Status build_index();
+
+    /// \brief Load an index written by write_index(), rather than building one.
+    /// \returns Invalid if the index was written for a different list of files. Changes to the
+    ///          files themselves are detected as each one is opened.
+    Status load_index(std::string const & path);
+
+    /// \brief Write the dataset read id index to [path], building it first if needed.
+    Status write_index(std::string const & path);
+
+    /// \brief Load the index at [path], first bringing it up to date with the dataset's files.
+    ///
+    /// Where the index at [path] was written for a different list of files, only the files it
+    /// doesn't hold are read, entries for files no longer in the dataset are dropped, and the
+    /// result replaces the index at [path]. A missing index is built and written in full.
+    ///
+    /// The index is memory mapped, so processes loading the same index share its pages.
+    /// \note Files already held by the index are not reopened, changes to them are detected as
+    ///       each one is opened, as with load_index().
+    Status update_index(std::string const & path);
+
+    /// \brief Find the dataset read id index, building it first if needed.
+    Result<std::shared_ptr<DatasetReadIdIndex const>> index();
+
+    /// \brief Find the number of reads in the dataset, building the index first if needed.
+    Result<std::size_t> read_count();
+
+    /// \brief Find the locations of [read_ids] in the dataset, building the index first if
+    ///        needed.
+    /// \param[out] locations  The location of each read found, ordered by file, then batch and
+    ///                        then row so reads can be visited in one pass through the dataset.
+    ///                        Should be at least as long as [read_ids].
+    /// \note Where a read id is held by more than one file, the location in the first file is
+    ///       returned.
+    /// \returns The number of reads found.
+    Result<std::size_t> search_for_read_ids(
+        gsl::span<Uuid const> const & read_ids,
+        gsl::span<DatasetReadLocation> const & locations);
+
+    /// \brief Split the dataset into [shard_count] shards of consecutive read table batches,
+    ///        balanced by sample count.
+    ///
+    /// Files' sample counts are taken from their embedded summaries. Only files a shard boundary
+    /// falls within, or without a summary, have their batches counted, from the read table's
+    /// num_samples column alone. Shards differ by about a batch's samples at most, and may be
+    /// empty if the dataset has fewer batches than shards.
+    Result<std::vector<DatasetShard>> plan_shards(std::size_t shard_count) const;
+
+private:
+    Result<std::shared_ptr<FileReader>> open_file(std::size_t file) const;
+
+    /// Build an index of the dataset, taking the entries of files [previous] holds from it rather
+    /// than reading the files again.
+    Result<std::shared_ptr<DatasetReadIdIndex const>> build_index_from(
+        DatasetReadIdIndex const * previous) const;
+
+    /// Check the files the dataset has open are those [index] was built from.
+    Status check_open_files(DatasetReadIdIndex const & index);
+
+    std::vector<std::string> m_file_paths;
+    DatasetReaderOptions m_options;
+
+    std::unique_ptr<ShardedLruCache<std::shared_ptr<FileReader>>> m_open_files;
+
+    // Held while building or loading the index, so only one build runs at a time:
+    std::mutex m_index_build_mutex;
+    mutable std::mutex m_index_mutex;
+    std::shared_ptr<DatasetReadIdIndex const> m_index;
+};
+
+/// \brief Reads the read table batches of one DatasetWorkUnit.
+class POD5_FORMAT_EXPORT DatasetWorkUnitReader {
+public:
+    DatasetWorkUnitReader(std::shared_ptr<FileReader> reader, DatasetWorkUnit unit);
+
+    DatasetWorkUnit const & unit() const { return m_unit; }
+
+    /// \brief Find the reader of the unit's file, to read the signal of the unit's reads.
+    std::shared_ptr<FileReader> const & file_reader() const { return m_reader; }
+
+    std::size_t batch_count() const { return m_unit.batch_count; }
+
+    /// \brief Read batch [i] of the unit, batch first_batch + [i] of its file.
+    Result<ReadTableRecordBatch> read_read_record_batch(std::size_t i) const;
+
+private:
+    std::shared_ptr<FileReader> m_reader;
+    DatasetWorkUnit m_unit;
+};
+
+/// \brief Open the file of [unit] to read the unit's batches.
+/// \returns IOError if the file has changed since the unit was planned.
+POD5_FORMAT_EXPORT Result<std::unique_ptr<DatasetWorkUnitReader>> open_dataset_work_unit(
+    DatasetWorkUnit const & unit,
+    FileReaderOptions const & options = {});
+
+POD5_FORMAT_EXPORT Result<std::shared_ptr<DatasetReader>> open_dataset_reader(
+    std::vector<std::string> file_paths,
+    DatasetReaderOptions const & options = {});
+
+}  // namespace pod5
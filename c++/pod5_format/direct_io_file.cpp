@@ -0,0 +1,194 @@
+#include "pod5_format/direct_io_file.h"
+
+#include "pod5_format/io_manager.h"
+
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+
+namespace pod5 {
+
+#ifdef __linux__
+
+namespace {
+
+class DirectIoFile : public arrow::io::RandomAccessFile {
+public:
+    DirectIoFile(int fd, std::int64_t size, arrow::MemoryPool * pool)
+    : m_fd(fd)
+    , m_size(size)
+    , m_pool(pool)
+    {
+    }
+
+    ~DirectIoFile() override { (void)Close(); }
+
+    arrow::Status Close() override
+    {
+        std::lock_guard<std::mutex> l(m_close_mutex);
+        if (m_fd < 0) {
+            return arrow::Status::OK();
+        }
+        auto const result = close(m_fd);
+        m_fd = -1;
+        if (result != 0) {
+            return arrow::Status::IOError("Failed to close file: ", std::strerror(errno));
+        }
+        return arrow::Status::OK();
+    }
+
+    bool closed() const override { return m_fd < 0; }
+
+    arrow::Result<std::int64_t> Tell() const override
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        std::lock_guard<std::mutex> l(m_position_mutex);
+        return m_position;
+    }
+
+    arrow::Status Seek(std::int64_t position) override
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        if (position < 0) {
+            return arrow::Status::Invalid("Invalid seek position ", position);
+        }
+        std::lock_guard<std::mutex> l(m_position_mutex);
+        m_position = position;
+        return arrow::Status::OK();
+    }
+
+    arrow::Result<std::int64_t> GetSize() override
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        return m_size;
+    }
+
+    arrow::Result<std::int64_t> Read(std::int64_t nbytes, void * out) override
+    {
+        std::lock_guard<std::mutex> l(m_position_mutex);
+        ARROW_ASSIGN_OR_RAISE(auto const read, ReadAt(m_position, nbytes, out));
+        m_position += read;
+        return read;
+    }
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Read(std::int64_t nbytes) override
+    {
+        std::lock_guard<std::mutex> l(m_position_mutex);
+        ARROW_ASSIGN_OR_RAISE(auto buffer, ReadAt(m_position, nbytes));
+        m_position += buffer->size();
+        return buffer;
+    }
+
+    arrow::Result<std::int64_t> ReadAt(std::int64_t position, std::int64_t nbytes, void * out)
+        override
+    {
+        // Direct reads can't land in the caller's (unaligned) memory, so are copied from an
+        // aligned buffer:
+        ARROW_ASSIGN_OR_RAISE(auto const buffer, ReadAt(position, nbytes));
+        std::memcpy(out, buffer->data(), buffer->size());
+        return buffer->size();
+    }
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(std::int64_t position, std::int64_t nbytes)
+        override
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        if (position < 0 || nbytes < 0) {
+            return arrow::Status::Invalid(
+                "Invalid read (offset = ", position, ", size = ", nbytes, ")");
+        }
+        nbytes = position < m_size ? (nbytes < m_size - position ? nbytes : m_size - position) : 0;
+        if (nbytes == 0) {
+            return std::make_shared<arrow::Buffer>(nullptr, 0);
+        }
+
+        // Widen the read to whole aligned blocks, the last may run past the end of the file:
+        std::int64_t const alignment = IOManager::Alignment;
+        auto const aligned_start = position - position % alignment;
+        auto const end = position + nbytes;
+        auto const aligned_end = end + (alignment - end % alignment) % alignment;
+        ARROW_ASSIGN_OR_RAISE(
+            std::shared_ptr<arrow::Buffer> buffer,
+            arrow::AllocateBuffer(aligned_end - aligned_start, alignment, m_pool));
+
+        std::int64_t read = 0;
+        while (aligned_start + read < end) {
+            auto const result = pread(
+                m_fd,
+                buffer->mutable_data() + read,
+                std::size_t(buffer->size() - read),
+                aligned_start + read);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return arrow::Status::IOError("Failed to read file: ", std::strerror(errno));
+            }
+            if (result == 0) {
+                return arrow::Status::IOError("Unexpected end of file");
+            }
+            read += result;
+        }
+        return arrow::SliceBuffer(buffer, position - aligned_start, nbytes);
+    }
+
+private:
+    arrow::Status check_open() const
+    {
+        if (m_fd < 0) {
+            return arrow::Status::Invalid("Operation on closed file");
+        }
+        return arrow::Status::OK();
+    }
+
+    int m_fd;
+    std::int64_t const m_size;
+    arrow::MemoryPool * m_pool;
+
+    std::mutex m_close_mutex;
+    mutable std::mutex m_position_mutex;
+    std::int64_t m_position = 0;
+};
+
+}  // namespace
+
+Result<std::shared_ptr<arrow::io::RandomAccessFile>> open_direct_io_file(
+    std::string const & path,
+    arrow::MemoryPool * pool)
+{
+    int const fd = open(path.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+    if (fd < 0) {
+        return Status::IOError(
+            "Failed to open file '", path, "' for direct I/O: ", std::strerror(errno));
+    }
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0) {
+        auto const error = errno;
+        close(fd);
+        return Status::IOError("Failed to stat file '", path, "': ", std::strerror(error));
+    }
+
+    return std::make_shared<DirectIoFile>(fd, file_stat.st_size, pool);
+}
+
+#else
+
+Result<std::shared_ptr<arrow::io::RandomAccessFile>> open_direct_io_file(
+    std::string const &,
+    arrow::MemoryPool *)
+{
+    return Status::NotImplemented("Direct I/O reads are not supported on this platform");
+}
+
+#endif
+
+}  // namespace pod5
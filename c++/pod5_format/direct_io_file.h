@@ -0,0 +1,29 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <arrow/io/type_fwd.h>
+
+#include <memory>
+#include <string>
+
+namespace arrow {
+class MemoryPool;
+}
+
+namespace pod5 {
+
+/// \brief Open [path] for reading with direct I/O, bypassing the page cache, so large scans
+///        don't evict the cached data of other processes.
+///
+/// Each read is widened to IOManager::Alignment boundaries and lands in a buffer allocated from
+/// [pool] with that alignment, returning a slice of it without copying. Reads of signal batches
+/// written page aligned (see FileWriterOptions::set_page_align_signal_batches) need no widening.
+/// \returns NotImplemented where direct I/O is unavailable, for example on other platforms, or
+///          IOError if the filesystem doesn't support it.
+POD5_FORMAT_EXPORT Result<std::shared_ptr<arrow::io::RandomAccessFile>> open_direct_io_file(
+    std::string const & path,
+    arrow::MemoryPool * pool);
+
+}  // namespace pod5
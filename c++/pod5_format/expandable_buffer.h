@@ -5,9 +5,69 @@
 #include <gsl/gsl-lite.hpp>
 
 #include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace pod5 {
 
+/// \brief Buffers handed out of ExpandableBuffers, kept so they can be reused once released.
+///
+/// Finishing a batch hands a builder's buffers to the batch, and the builder starts again from an
+/// empty buffer. Buffers are returned here when handed out, and once the batch holding them is
+/// written and released they are given back to builders with their capacity intact, rather than
+/// growing new buffers from empty for every batch.
+class ExpandableBufferPool {
+public:
+    /// \param max_buffers The most buffers to keep waiting for release, beyond which the oldest
+    ///                    are forgotten.
+    explicit ExpandableBufferPool(std::size_t max_buffers = 8) : m_max_buffers(max_buffers) {}
+
+    /// \brief Find an empty buffer, reusing a released one if there is any.
+    arrow::Result<std::shared_ptr<arrow::ResizableBuffer>> acquire(arrow::MemoryPool * pool)
+    {
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it) {
+                // Held only by us, so whatever it was handed out to has finished with it:
+                if (it->use_count() == 1) {
+                    auto buffer = std::move(*it);
+                    m_buffers.erase(it);
+                    m_reused_buffers += 1;
+                    ARROW_RETURN_NOT_OK(buffer->Resize(0, false));
+                    return buffer;
+                }
+            }
+        }
+        return arrow::AllocateResizableBuffer(0, pool);
+    }
+
+    /// \brief Keep [buffer], which has been handed out, to reuse once it is released.
+    void release(std::shared_ptr<arrow::ResizableBuffer> buffer)
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        if (m_buffers.size() >= m_max_buffers) {
+            m_buffers.erase(m_buffers.begin());
+        }
+        m_buffers.push_back(std::move(buffer));
+    }
+
+    /// \brief Find how many buffers have been reused.
+    std::size_t reused_buffers() const
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        return m_reused_buffers;
+    }
+
+private:
+    std::size_t const m_max_buffers;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<arrow::ResizableBuffer>> m_buffers;
+    std::size_t m_reused_buffers = 0;
+};
+
 template <typename T>
 class ExpandableBuffer {
 public:
@@ -15,9 +75,14 @@ public:
 
     ExpandableBuffer(arrow::MemoryPool * pool = nullptr) { m_pool = pool; }
 
-    arrow::Status init_buffer(arrow::MemoryPool * pool)
+    /// \param pool The pool to allocate from.
+    /// \param buffer_pool Optional pool to return handed out buffers to, and reuse them from.
+    arrow::Status init_buffer(
+        arrow::MemoryPool * pool,
+        std::shared_ptr<ExpandableBufferPool> buffer_pool = nullptr)
     {
         m_pool = pool;
+        m_buffer_pool = std::move(buffer_pool);
         return clear();
     }
 
@@ -36,7 +101,11 @@ public:
     arrow::Status clear()
     {
         if (!m_buffer || m_buffer.use_count() > 1) {
-            ARROW_ASSIGN_OR_RAISE(m_buffer, arrow::AllocateResizableBuffer(0, m_pool));
+            ARROW_ASSIGN_OR_RAISE(auto buffer, allocate_empty());
+            if (m_buffer && m_buffer_pool) {
+                m_buffer_pool->release(std::move(m_buffer));
+            }
+            m_buffer = std::move(buffer);
             return arrow::Status::OK();
         } else {
             return m_buffer->Resize(0, false);
@@ -87,31 +156,50 @@ public:
         return m_buffer->Resize(new_size, false);
     }
 
+    /// \brief Make room for [new_capacity] bytes.
+    ///
+    /// Capacity grows by at least EXPANSION_FACTOR each time it grows, so appending a value at a
+    /// time costs amortised constant time. Growth reallocates through the pool, which can extend
+    /// the allocation in place rather than copying.
     arrow::Status reserve(std::int64_t new_capacity)
     {
         assert(m_buffer);
-        auto const old_size = m_buffer->size();
-        if (m_buffer.use_count() > 1) {
-            std::shared_ptr<arrow::ResizableBuffer> buffer;
-            ARROW_ASSIGN_OR_RAISE(buffer, arrow::AllocateResizableBuffer(old_size, m_pool));
+        auto const old_capacity = m_buffer->capacity();
+        auto const grown_capacity = old_capacity * EXPANSION_FACTOR;
+        auto const target_capacity =
+            new_capacity > grown_capacity ? new_capacity : grown_capacity;
 
+        if (m_buffer.use_count() > 1) {
+            // Shared with an array, so the data must be copied into a buffer of our own:
+            auto const old_size = m_buffer->size();
+            ARROW_ASSIGN_OR_RAISE(auto buffer, allocate_empty());
+            ARROW_RETURN_NOT_OK(
+                buffer->Reserve(new_capacity > old_capacity ? target_capacity : old_capacity));
+            ARROW_RETURN_NOT_OK(buffer->Resize(old_size, false));
             std::copy(m_buffer->data(), m_buffer->data() + old_size, buffer->mutable_data());
             std::swap(m_buffer, buffer);
         }
 
         if (new_capacity > m_buffer->capacity()) {
-            ARROW_RETURN_NOT_OK(m_buffer->Reserve(new_capacity * EXPANSION_FACTOR));
+            ARROW_RETURN_NOT_OK(m_buffer->Reserve(target_capacity));
         }
         return arrow::Status::OK();
     }
 
 private:
+    arrow::Result<std::shared_ptr<arrow::ResizableBuffer>> allocate_empty()
+    {
+        if (m_buffer_pool) {
+            return m_buffer_pool->acquire(m_pool);
+        }
+        return arrow::AllocateResizableBuffer(0, m_pool);
+    }
+
     arrow::Status append_bytes(gsl::span<std::uint8_t const> const & bytes_span)
     {
         auto old_size = 0;
         if (!m_buffer) {
-            ARROW_ASSIGN_OR_RAISE(
-                m_buffer, arrow::AllocateResizableBuffer(bytes_span.size(), m_pool));
+            ARROW_ASSIGN_OR_RAISE(m_buffer, allocate_empty());
         } else {
             old_size = m_buffer->size();
         }
@@ -125,6 +213,7 @@ private:
 
     std::shared_ptr<arrow::ResizableBuffer> m_buffer;
     arrow::MemoryPool * m_pool = nullptr;
+    std::shared_ptr<ExpandableBufferPool> m_buffer_pool;
 };
 
 }  // namespace pod5
@@ -3,6 +3,8 @@
 #include <arrow/io/file.h>
 #include <arrow/status.h>
 
+#include <functional>
+
 namespace pod5 {
 
 class FileOutputStream : public arrow::io::OutputStream {
@@ -10,6 +12,20 @@ public:
     virtual arrow::Status batch_complete() { return arrow::Status::OK(); }
 
     virtual void set_file_start_offset(std::size_t val) {}
+
+    /// \brief Find the bytes written to the stream and not yet written to the file.
+    virtual std::size_t pending_write_bytes() const { return 0; }
+
+    /// \brief Find if pending writes are within the stream's limit, so the next write won't wait.
+    virtual bool has_write_capacity() const { return true; }
+
+    /// \brief Set whether writes wait while pending writes are over the stream's limit, rather
+    ///        than queueing beyond it.
+    virtual void set_wait_for_write_capacity(bool wait) {}
+
+    /// \brief Set a function called, from the thread completing writes, when pending writes fall
+    ///        back within the stream's limit after going over it.
+    virtual void set_write_capacity_callback(std::function<void()> callback) {}
 };
 
 }  // namespace pod5
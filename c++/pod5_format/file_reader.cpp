@@ -1,14 +1,35 @@
 #include "pod5_format/file_reader.h"
 
+#include "pod5_format/direct_io_file.h"
 #include "pod5_format/internal/combined_file_utils.h"
+#include "pod5_format/io_uring_file.h"
 #include "pod5_format/memory_pool.h"
 #include "pod5_format/migration/migration.h"
+#include "pod5_format/read_id_index.h"
+#include "pod5_format/read_scan.h"
 #include "pod5_format/read_table_reader.h"
+#include "pod5_format/read_table_statistics.h"
 #include "pod5_format/run_info_table_reader.h"
+#include "pod5_format/signal_row_index.h"
+#include "pod5_format/signal_summary.h"
 #include "pod5_format/signal_table_reader.h"
+#include "pod5_format/thread_pool.h"
 
+#include <arrow/filesystem/filesystem.h>
 #include <arrow/io/concurrency.h>
 #include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/message.h>
+#include <arrow/util/future.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <vector>
 
 namespace pod5 {
 
@@ -24,6 +45,12 @@ void FileReaderOptions::set_max_cached_signal_table_batches(
     m_max_cached_signal_table_batches = max_cached_signal_table_batches;
 }
 
+Status FileReaderOptions::set_memory_pool_backend(MemoryPoolBackend backend)
+{
+    ARROW_ASSIGN_OR_RAISE(m_memory_pool, memory_pool_for_backend(backend));
+    return Status::OK();
+}
+
 inline FileLocation make_file_locaton(combined_file_utils::ParsedFileInfo const & parsed_file_info)
 {
     return FileLocation{
@@ -32,28 +59,200 @@ inline FileLocation make_file_locaton(combined_file_utils::ParsedFileInfo const
         std::size_t(parsed_file_info.file_length)};
 }
 
-class FileReaderImpl : public FileReader {
+// Run [read] on [thread_pool], finishing the returned future with its result.
+template <typename T, typename Read>
+arrow::Future<T> read_on_thread_pool(ThreadPool & thread_pool, Read && read)
+{
+    auto future = arrow::Future<T>::Make();
+    try {
+        thread_pool.post([future, read = std::forward<Read>(read)]() mutable {
+            future.MarkFinished(read());
+        });
+    } catch (std::exception const & e) {
+        // The pool throws once stopped:
+        future.MarkFinished(Status::Invalid("Failed to queue read: ", e.what()));
+    }
+    return future;
+}
+
+namespace {
+
+// A value opened on first use, so files opened lazily only pay for the tables they use.
+template <typename T>
+class LazyOpen {
+public:
+    using Open = std::function<Result<T>()>;
+
+    explicit LazyOpen(Open open) : m_open(std::move(open)) {}
+
+    /// \brief Find the value, opening it if this is the first use. Concurrent first uses wait for
+    ///        one open, and a failure to open is reported to every use.
+    Result<T *> get() const
+    {
+        std::call_once(m_opened, [&] {
+            m_value.emplace(m_open());
+            m_open = nullptr;
+            m_is_open = true;
+        });
+        if (!m_value->ok()) {
+            return m_value->status();
+        }
+        return &m_value->ValueUnsafe();
+    }
+
+    /// \brief Find the value if it has already been opened successfully, without opening it.
+    T const * if_open() const
+    {
+        if (!m_is_open || !m_value->ok()) {
+            return nullptr;
+        }
+        return &m_value->ValueUnsafe();
+    }
+
+private:
+    mutable Open m_open;
+    mutable std::once_flag m_opened;
+    mutable std::optional<Result<T>> m_value;
+    mutable std::atomic<bool> m_is_open{false};
+};
+
+// Bytes read from each table's part of the file, counted by the sub files reading them.
+struct TableBytesRead {
+    std::atomic<std::uint64_t> run_info_table{0};
+    std::atomic<std::uint64_t> read_table{0};
+    std::atomic<std::uint64_t> signal_table{0};
+};
+
+// Find the read table statistics in [footer], or null if the file has none usable.
+std::shared_ptr<ReadTableStatistics const> open_read_table_statistics(
+    combined_file_utils::ParsedFooter const & footer,
+    std::size_t read_batch_count,
+    arrow::MemoryPool * pool)
+{
+    for (auto const & other_index : footer.other_indexes) {
+        // The statistics only let batches be skipped, so a file with broken statistics is
+        // still readable without them:
+        auto sub_file = open_sub_file(other_index);
+        if (!sub_file.ok()) {
+            continue;
+        }
+        auto statistics = ReadTableStatistics::open(*sub_file, pool);
+        if (!statistics.ok() || !*statistics) {
+            continue;
+        }
+        if ((*statistics)->batch_count() != read_batch_count) {
+            return nullptr;
+        }
+        return *statistics;
+    }
+    return nullptr;
+}
+
+// Find the signal row index in [footer], or null if the file has none usable for [signal_table].
+std::shared_ptr<SignalRowIndex const> open_signal_row_index(
+    combined_file_utils::ParsedFooter const & footer,
+    SignalTableReader const & signal_table,
+    arrow::MemoryPool * pool)
+{
+    // The table's row count is known if it lists its batches, otherwise every batch but the last,
+    // which may be shorter, holds the table's batch size:
+    auto const batch_count = signal_table.num_record_batches();
+    auto const batch_size = signal_table.table_batch_size();
+    auto const table_row_count = signal_table.batch_first_row(batch_count);
+    auto const row_count_fits = [&](std::uint64_t row_count) {
+        if (table_row_count.ok()) {
+            return row_count == *table_row_count;
+        }
+        return batch_count > 0 && row_count > (batch_count - 1) * batch_size
+               && row_count <= batch_count * batch_size;
+    };
+
+    for (auto const & other_index : footer.other_indexes) {
+        // Sample counts can be found from the signal batches, so a file with a broken index is
+        // still readable without it:
+        auto sub_file = open_sub_file(other_index);
+        if (!sub_file.ok()) {
+            continue;
+        }
+        auto index = SignalRowIndex::open(*sub_file, pool);
+        if (!index.ok() || !*index) {
+            continue;
+        }
+        if (!row_count_fits((*index)->row_count())) {
+            return nullptr;
+        }
+        return *index;
+    }
+    return nullptr;
+}
+
+// Find the signal summaries in [footer], or null if the file has none usable.
+std::shared_ptr<SignalSummary const> open_signal_summary(
+    combined_file_utils::ParsedFooter const & footer,
+    arrow::MemoryPool * pool)
+{
+    for (auto const & other_index : footer.other_indexes) {
+        // Signal can always be read in full, so a file with broken summaries is still readable
+        // without them:
+        auto sub_file = open_sub_file(other_index);
+        if (!sub_file.ok()) {
+            continue;
+        }
+        auto summary = SignalSummary::open(*sub_file, pool);
+        if (summary.ok() && *summary) {
+            return *summary;
+        }
+    }
+    return nullptr;
+}
+
+// A migrated table written out for users needing it as a file.
+struct MigratedTableFile {
+    std::unique_ptr<TemporaryDir> dir;
+    FileLocation location;
+};
+
+}  // namespace
+
+class FileReaderImpl : public FileReader, public std::enable_shared_from_this<FileReaderImpl> {
 public:
     FileReaderImpl(
         Version const & file_version_pre_migration,
         MigrationResult && migration_result,
-        RunInfoTableReader && run_info_table_reader,
-        ReadTableReader && read_table_reader,
-        SignalTableReader && signal_table_reader)
+        FileReaderOptions const & options)
     : m_file_version_pre_migration(file_version_pre_migration)
     , m_migration_result(std::move(migration_result))
+    , m_options(options)
     , m_run_info_table_location(make_file_locaton(m_migration_result.footer().run_info_table))
     , m_read_table_location(make_file_locaton(m_migration_result.footer().reads_table))
     , m_signal_table_location(make_file_locaton(m_migration_result.footer().signal_table))
-    , m_run_info_table_reader(std::move(run_info_table_reader))
-    , m_read_table_reader(std::move(read_table_reader))
-    , m_signal_table_reader(std::move(signal_table_reader))
+    , m_run_info_table_reader([this] { return open_run_info_table_reader(); })
+    , m_read_table_reader([this] { return open_read_table_reader(); })
+    , m_signal_table_reader([this] { return open_signal_table_reader(); })
+    , m_read_table_statistics([this] { return open_statistics(); })
+    , m_signal_summary([this] {
+        return open_signal_summary(m_migration_result.footer(), m_options.memory_pool());
+    })
+    , m_run_info_table_data([this] { return open_run_info_table_data(); })
+    , m_migrated_run_info_table_file([this] { return write_migrated_run_info_table(); })
+    , m_migrated_read_table_file([this] { return write_migrated_read_table(); })
+    , m_bytes_read(std::make_shared<TableBytesRead>())
     {
     }
 
+    /// \brief Open every table now, rather than on first use.
+    Status open_tables() const
+    {
+        ARROW_RETURN_NOT_OK(m_run_info_table_reader.get());
+        ARROW_RETURN_NOT_OK(m_read_table_reader.get());
+        ARROW_RETURN_NOT_OK(m_signal_table_reader.get());
+        return m_read_table_statistics.get().status();
+    }
+
     SchemaMetadataDescription schema_metadata() const override
     {
-        return m_read_table_reader.schema_metadata();
+        auto const read_table = m_read_table_reader.get();
+        return read_table.ok() ? (*read_table)->schema_metadata() : SchemaMetadataDescription{};
     }
 
     virtual Result<std::size_t> read_count() const override
@@ -71,12 +270,68 @@ public:
 
     Result<ReadTableRecordBatch> read_read_record_batch(std::size_t i) const override
     {
-        return m_read_table_reader.read_record_batch(i);
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        return read_table->read_record_batch(i);
+    }
+
+    Result<ReadTableRecordBatch> read_read_record_batch(
+        std::size_t i,
+        ReadTableProjection const & projection) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        return read_table->read_record_batch(i, projection);
+    }
+
+    Result<std::shared_ptr<ReadTableProjection const>> make_read_table_projection(
+        std::vector<std::string> const & column_names) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        return read_table->make_projection(column_names);
+    }
+
+    arrow::Future<ReadTableRecordBatch> read_read_record_batch_async(
+        std::size_t i,
+        ThreadPool & thread_pool) const override
+    {
+        return read_on_thread_pool<ReadTableRecordBatch>(
+            thread_pool,
+            [self = shared_from_this(), i] { return self->read_read_record_batch(i); });
+    }
+
+    arrow::Future<ReadTableRecordBatch> read_read_record_batch_async(
+        std::size_t i,
+        std::shared_ptr<ReadTableProjection const> const & projection,
+        ThreadPool & thread_pool) const override
+    {
+        return read_on_thread_pool<ReadTableRecordBatch>(
+            thread_pool, [self = shared_from_this(), i, projection] {
+                return self->read_read_record_batch(i, *projection);
+            });
     }
 
     std::size_t num_read_record_batches() const override
     {
-        return m_read_table_reader.num_record_batches();
+        auto const read_table = m_read_table_reader.get();
+        return read_table.ok() ? (*read_table)->num_record_batches() : 0;
+    }
+
+    std::shared_ptr<ReadTableStatistics const> read_table_statistics() const override
+    {
+        auto const statistics = m_read_table_statistics.get();
+        return statistics.ok() ? **statistics : nullptr;
+    }
+
+    std::vector<std::size_t> filter_read_record_batches(
+        ReadBatchPredicate const & predicate) const override
+    {
+        if (auto const statistics = read_table_statistics()) {
+            return statistics->filter_batches(predicate);
+        }
+
+        // Without statistics any batch may match:
+        std::vector<std::size_t> result(num_read_record_batches());
+        std::iota(result.begin(), result.end(), 0);
+        return result;
     }
 
     Result<std::size_t> search_for_read_ids(
@@ -84,85 +339,778 @@ public:
         gsl::span<uint32_t> const & batch_counts,
         gsl::span<uint32_t> const & batch_rows) override
     {
-        return m_read_table_reader.search_for_read_ids(search_input, batch_counts, batch_rows);
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        return read_table->search_for_read_ids(search_input, batch_counts, batch_rows);
+    }
+
+    Result<std::shared_ptr<ReadIdIndex const>> read_id_index() override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        ARROW_RETURN_NOT_OK(read_table->build_read_id_lookup());
+        return read_table->read_id_index();
+    }
+
+    Status prepare_for_fork() override
+    {
+        ARROW_RETURN_NOT_OK(open_tables());
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        // An index stored in the file is already shared through the file's pages:
+        if (!m_migration_result.footer().read_id_index.file && !m_read_id_index_shared) {
+            ARROW_RETURN_NOT_OK(read_table->build_read_id_lookup());
+            ARROW_ASSIGN_OR_RAISE(
+                auto shared_index, read_table->read_id_index()->copy_to_shared_memory());
+            read_table->set_read_id_index(std::move(shared_index));
+            m_read_id_index_shared = true;
+        }
+        read_table->clear_cache();
+
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        signal_table->clear_cache();
+        return Status::OK();
+    }
+
+    Result<std::size_t> scan_reads(
+        ReadScanPredicate const & predicate,
+        gsl::span<uint32_t> const & batch_counts,
+        gsl::span<uint32_t> const & batch_rows) const override
+    {
+        auto const batch_count = num_read_record_batches();
+        if (batch_counts.size() < batch_count) {
+            return Status::Invalid("Scan needs a row count for each of ", batch_count, " batches");
+        }
+
+        // Only the columns the predicate tests are read and decoded:
+        auto const columns = predicate.columns();
+        std::shared_ptr<ReadTableProjection const> projection;
+        if (!columns.empty()) {
+            ARROW_ASSIGN_OR_RAISE(projection, make_read_table_projection(columns));
+        }
+
+        std::size_t selected_count = 0;
+        std::vector<std::uint8_t> selected;
+        for (std::size_t i = 0; i < batch_count; ++i) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto batch,
+                projection ? read_read_record_batch(i, *projection) : read_read_record_batch(i));
+            ARROW_RETURN_NOT_OK(predicate.evaluate(batch, selected));
+
+            auto const batch_selected_count =
+                std::size_t(std::count(selected.begin(), selected.end(), 1));
+            if (selected_count + batch_selected_count > batch_rows.size()) {
+                return Status::Invalid("Too many matching reads for the scan output rows");
+            }
+            for (std::size_t row = 0; row < selected.size(); ++row) {
+                if (selected[row]) {
+                    batch_rows[selected_count++] = std::uint32_t(row);
+                }
+            }
+            batch_counts[i] = std::uint32_t(batch_selected_count);
+        }
+        return selected_count;
     }
 
     Result<SignalTableRecordBatch> read_signal_record_batch(std::size_t i) const override
     {
-        return m_signal_table_reader.read_record_batch(i);
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->read_record_batch(i);
+    }
+
+    arrow::Future<SignalTableRecordBatch> read_signal_record_batch_async(
+        std::size_t i,
+        ThreadPool & thread_pool) const override
+    {
+        return read_on_thread_pool<SignalTableRecordBatch>(
+            thread_pool,
+            [self = shared_from_this(), i] { return self->read_signal_record_batch(i); });
+    }
+
+    Result<std::unique_ptr<arrow::ipc::Message>> read_signal_record_batch_message(
+        std::size_t i) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->read_record_batch_message(i);
     }
 
     std::size_t num_signal_record_batches() const override
     {
-        return m_signal_table_reader.num_record_batches();
+        auto const signal_table = m_signal_table_reader.get();
+        return signal_table.ok() ? (*signal_table)->num_record_batches() : 0;
+    }
+
+    std::shared_ptr<SignalRowIndex const> signal_row_index() const override
+    {
+        auto const signal_table = m_signal_table_reader.get();
+        return signal_table.ok() ? (*signal_table)->row_index() : nullptr;
+    }
+
+    std::shared_ptr<SignalSummary const> signal_summary() const override
+    {
+        auto const summary = m_signal_summary.get();
+        return summary.ok() ? **summary : nullptr;
+    }
+
+    Result<std::size_t> signal_table_batch_size() const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->table_batch_size();
     }
 
     Result<std::size_t> signal_batch_for_row_id(std::size_t row, std::size_t * batch_row)
         const override
     {
-        return m_signal_table_reader.signal_batch_for_row_id(row, batch_row);
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->signal_batch_for_row_id(row, batch_row);
+    }
+
+    Result<std::uint64_t> signal_batch_first_row(std::size_t batch) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->batch_first_row(batch);
+    }
+
+    std::vector<RecordBatchLocation> const & signal_table_batch_locations() const override
+    {
+        return m_migration_result.footer().signal_table.batch_locations;
+    }
+
+    Status prefetch_signal_rows(gsl::span<std::uint64_t const> const & row_indices) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto const batches, signal_batches_for_rows(row_indices));
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->prefetch_record_batches(batches);
+    }
+
+    Status load_signal_rows(gsl::span<std::uint64_t const> const & row_indices) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto const batches, signal_batches_for_rows(row_indices));
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->load_record_batches(batches);
+    }
+
+    Status set_signal_access_plan(
+        gsl::span<std::uint32_t const> const & batch_counts,
+        gsl::span<std::uint32_t const> const & batch_rows,
+        bool in_signal_order) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        std::vector<std::size_t> signal_batches;
+        ARROW_RETURN_NOT_OK(for_each_planned_read(
+            batch_counts,
+            batch_rows,
+            false,
+            in_signal_order,
+            [&](ReadTableBatchView const & view, std::size_t batch_row) -> Status {
+                for (auto const signal_row : view.signal[batch_row]) {
+                    ARROW_ASSIGN_OR_RAISE(
+                        auto const signal_batch,
+                        signal_table->signal_batch_for_row_id(signal_row, nullptr));
+                    if (signal_batches.empty() || signal_batches.back() != signal_batch) {
+                        signal_batches.push_back(signal_batch);
+                    }
+                }
+                return Status::OK();
+            }));
+
+        signal_table->set_batch_access_plan(signal_batches);
+        return Status::OK();
+    }
+
+    Status clear_signal_access_plan() const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        signal_table->clear_batch_access_plan();
+        return Status::OK();
+    }
+
+    Result<TraversalCost> estimate_traversal_cost(
+        gsl::span<std::uint32_t const> const & batch_counts,
+        gsl::span<std::uint32_t const> const & batch_rows) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        auto const & row_index = signal_table->row_index();
+        auto const & batch_locations = signal_table_batch_locations();
+        bool const batch_bytes_known = batch_locations.size() == num_signal_record_batches();
+
+        TraversalCost cost;
+        std::vector<bool> batch_touched(num_signal_record_batches());
+        std::optional<std::size_t> last_batch;
+        ARROW_RETURN_NOT_OK(for_each_planned_read(
+            batch_counts,
+            batch_rows,
+            true,
+            false,
+            [&](ReadTableBatchView const & view, std::size_t batch_row) -> Status {
+                auto const signal_rows = view.signal[batch_row];
+                cost.read_count += 1;
+                cost.signal_row_count += signal_rows.size();
+                if (view.num_samples) {
+                    cost.sample_count += view.num_samples[batch_row];
+                } else if (row_index) {
+                    cost.sample_count += row_index->sample_count(signal_rows);
+                }
+
+                for (auto const signal_row : signal_rows) {
+                    ARROW_ASSIGN_OR_RAISE(
+                        auto const batch,
+                        signal_table->signal_batch_for_row_id(signal_row, nullptr));
+                    if (batch_touched[batch]) {
+                        continue;
+                    }
+                    batch_touched[batch] = true;
+                    cost.signal_batch_count += 1;
+                    if (batch_bytes_known) {
+                        cost.signal_batch_bytes += batch_locations[batch].length();
+                    }
+                    if (!last_batch || batch != *last_batch + 1) {
+                        cost.estimated_seeks += 1;
+                    }
+                    last_batch = batch;
+                }
+                return Status::OK();
+            }));
+        return cost;
     }
 
     Result<std::size_t> extract_sample_count(
         gsl::span<std::uint64_t const> const & row_indices) const override
     {
-        return m_signal_table_reader.extract_sample_count(row_indices);
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_sample_count(row_indices);
+    }
+
+    Result<std::vector<std::uint64_t>> extract_chunk_boundaries(
+        gsl::span<std::uint64_t const> const & row_indices) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_chunk_boundaries(row_indices);
     }
 
     Status extract_samples(
         gsl::span<std::uint64_t const> const & row_indices,
         gsl::span<std::int16_t> const & output_samples) const override
     {
-        return m_signal_table_reader.extract_samples(row_indices, output_samples);
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples(row_indices, output_samples);
+    }
+
+    Status extract_samples(
+        gsl::span<std::uint64_t const> const & row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        SignalCompressionContext & compression_context) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples(
+            row_indices, output_samples, compression_context);
+    }
+
+    Status extract_samples(
+        gsl::span<std::uint64_t const> const & row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        ThreadPool & thread_pool) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples(row_indices, output_samples, thread_pool);
+    }
+
+    Status extract_samples_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_for_reads(
+            reads_row_indices, output_samples, sample_offsets, thread_pool);
+    }
+
+    Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<float> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_calibrated_for_reads(
+            reads_row_indices, calibrations, output_samples, sample_offsets, thread_pool);
+    }
+
+    Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<Float16> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_calibrated_for_reads(
+            reads_row_indices, calibrations, output_samples, sample_offsets, thread_pool);
+    }
+
+    Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<std::int8_t> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_calibrated_for_reads(
+            reads_row_indices, calibrations, output_samples, sample_offsets, thread_pool);
+    }
+
+    Status extract_samples_range(
+        gsl::span<std::uint64_t const> const & row_indices,
+        std::uint64_t sample_start,
+        gsl::span<std::int16_t> const & output_samples) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_range(
+            row_indices, sample_start, output_samples);
+    }
+
+    Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<float> const & output_samples) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_calibrated(
+            row_indices, calibration, output_samples);
+    }
+
+    Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<Float16> const & output_samples) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_calibrated(
+            row_indices, calibration, output_samples, thread_local_signal_compression_context());
+    }
+
+    Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<std::int8_t> const & output_samples) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_calibrated(
+            row_indices, calibration, output_samples, thread_local_signal_compression_context());
+    }
+
+    Result<std::shared_ptr<arrow::Buffer>> extract_sample_buffer(
+        gsl::span<std::uint64_t const> const & row_indices) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_sample_buffer(row_indices);
     }
 
     Result<std::vector<std::shared_ptr<arrow::Buffer>>> extract_samples_inplace(
         gsl::span<std::uint64_t const> const & row_indices,
         std::vector<std::uint32_t> & sample_count) const override
     {
-        return m_signal_table_reader.extract_samples_inplace(row_indices, sample_count);
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_samples_inplace(row_indices, sample_count);
+    }
+
+    Result<std::vector<std::shared_ptr<arrow::Buffer>>> extract_uncompressed_sample_buffers(
+        gsl::span<std::uint64_t const> const & row_indices) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        return signal_table->extract_uncompressed_sample_buffers(row_indices);
     }
 
     FileLocation const & run_info_table_location() const override
     {
-        return m_run_info_table_location;
+        if (!run_info_table_migrated()) {
+            return m_run_info_table_location;
+        }
+        auto const file = m_migrated_run_info_table_file.get();
+        return file.ok() ? (*file)->location : m_missing_location;
     }
 
-    FileLocation const & read_table_location() const override { return m_read_table_location; }
+    FileLocation const & read_table_location() const override
+    {
+        if (!read_table_migrated()) {
+            return m_read_table_location;
+        }
+        auto const file = m_migrated_read_table_file.get();
+        return file.ok() ? (*file)->location : m_missing_location;
+    }
 
     FileLocation const & signal_table_location() const override { return m_signal_table_location; }
 
+    bool read_table_migrated() const override
+    {
+        return !m_migration_result.read_table_migrations().empty();
+    }
+
+    bool run_info_table_migrated() const override
+    {
+        return m_migration_result.run_info_table_from_read_table();
+    }
+
+    Result<RunInfoTableRecordBatch> read_run_info_record_batch(std::size_t i) const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto run_info_table, m_run_info_table_reader.get());
+        return run_info_table->read_record_batch(i);
+    }
+
+    Result<std::size_t> num_run_info_record_batches() const override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto run_info_table, m_run_info_table_reader.get());
+        return run_info_table->num_record_batches();
+    }
+
     Version file_version_pre_migration() const override { return m_file_version_pre_migration; }
 
-    SignalType signal_type() const override { return m_signal_table_reader.signal_type(); }
+    SignalType signal_type() const override
+    {
+        auto const signal_table = m_signal_table_reader.get();
+        return signal_table.ok() ? (*signal_table)->signal_type() : SignalType::VbzSignal;
+    }
+
+    bool has_signal_checksums() const override
+    {
+        auto const signal_table = m_signal_table_reader.get();
+        return signal_table.ok() && (*signal_table)->has_signal_checksums();
+    }
+
+    std::shared_ptr<SignalCompressionDictionary const> signal_compression_dictionary()
+        const override
+    {
+        auto const signal_table = m_signal_table_reader.get();
+        return signal_table.ok() ? (*signal_table)->dictionary() : nullptr;
+    }
+
+    std::shared_ptr<SignalCodec const> signal_codec() const override
+    {
+        auto const signal_table = m_signal_table_reader.get();
+        return signal_table.ok() ? (*signal_table)->codec() : nullptr;
+    }
 
     Result<std::shared_ptr<RunInfoData const>> find_run_info(
         std::string const & acquisition_id) const override
     {
-        return m_run_info_table_reader.find_run_info(acquisition_id);
+        ARROW_ASSIGN_OR_RAISE(auto run_info_table, m_run_info_table_reader.get());
+        return run_info_table->find_run_info(acquisition_id);
     }
 
     Result<std::shared_ptr<RunInfoData const>> get_run_info(std::size_t index) const override
     {
-        return m_run_info_table_reader.get_run_info(index);
+        ARROW_ASSIGN_OR_RAISE(auto run_info_table, m_run_info_table_reader.get());
+        return run_info_table->get_run_info(index);
     }
 
     Result<std::size_t> get_run_info_count() const override
     {
-        return m_run_info_table_reader.get_run_info_count();
+        ARROW_ASSIGN_OR_RAISE(auto run_info_table, m_run_info_table_reader.get());
+        return run_info_table->get_run_info_count();
+    }
+
+    FileReaderStatistics statistics() const override
+    {
+        FileReaderStatistics result;
+        result.run_info_table_bytes_read = m_bytes_read->run_info_table;
+        result.read_table_bytes_read = m_bytes_read->read_table;
+        result.signal_table_bytes_read = m_bytes_read->signal_table;
+        if (auto const read_table = m_read_table_reader.if_open()) {
+            auto const read_statistics = read_table->statistics();
+            result.read_table_batches_decoded = read_statistics.batches_decoded;
+            result.read_table_cache_hits = read_statistics.cache_hits;
+            result.read_table_cache_misses = read_statistics.cache_misses;
+            result.read_table_cache_evictions = read_statistics.cache_evictions;
+        }
+        if (auto const signal_table = m_signal_table_reader.if_open()) {
+            auto const signal_statistics = signal_table->statistics();
+            result.signal_table_batches_decoded = signal_statistics.batches_decoded;
+            result.signal_cache_hits = signal_statistics.cache_hits;
+            result.signal_cache_misses = signal_statistics.cache_misses;
+            result.signal_cache_evictions = signal_statistics.cache_evictions;
+            result.decoded_read_cache_hits = signal_statistics.decoded_read_cache_hits;
+            result.decoded_read_cache_misses = signal_statistics.decoded_read_cache_misses;
+            result.decoded_read_cache_evictions = signal_statistics.decoded_read_cache_evictions;
+            result.decompressed_bytes = signal_statistics.decompressed_bytes;
+            result.decompression_time = signal_statistics.decompression_time;
+        }
+        return result;
     }
 
 private:
+    // Call [visit] with the view of the read table batch and the batch row of each read in a
+    // traversal plan, in plan order, or if [in_signal_order] with the reads of each batch in
+    // the order of their first signal row. Only the signal column is read, and the num_samples
+    // column if [with_sample_counts] and the table holds it.
+    template <typename Visit>
+    Status for_each_planned_read(
+        gsl::span<std::uint32_t const> const & batch_counts,
+        gsl::span<std::uint32_t const> const & batch_rows,
+        bool with_sample_counts,
+        bool in_signal_order,
+        Visit && visit) const
+    {
+        auto const read_batch_count = num_read_record_batches();
+        if (!batch_counts.empty() && batch_counts.size() != read_batch_count) {
+            return Status::Invalid(
+                "Plan holds ", batch_counts.size(), " batch counts, file has ", read_batch_count);
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        std::vector<std::string> columns{"signal"};
+        if (with_sample_counts && read_table->schema()->GetFieldIndex("num_samples") >= 0) {
+            columns.push_back("num_samples");
+        }
+        ARROW_ASSIGN_OR_RAISE(auto const projection, make_read_table_projection(columns));
+
+        std::size_t batch_rows_offset = 0;
+        for (std::size_t batch = 0; batch < read_batch_count; ++batch) {
+            if (!batch_counts.empty() && batch_counts[batch] == 0) {
+                continue;
+            }
+            ARROW_ASSIGN_OR_RAISE(
+                auto const read_batch, read_read_record_batch(batch, *projection));
+            auto const view = read_batch.view();
+
+            auto row_count = std::size_t(view.num_rows);
+            gsl::span<std::uint32_t const> rows;
+            if (!batch_counts.empty()) {
+                row_count = batch_counts[batch];
+                if (batch_rows_offset + row_count > batch_rows.size()) {
+                    return Status::Invalid("Plan batch counts exceed its batch rows");
+                }
+                rows = batch_rows.subspan(batch_rows_offset, row_count);
+                batch_rows_offset += row_count;
+            }
+
+            std::vector<std::size_t> visited_rows(row_count);
+            for (std::size_t i = 0; i < row_count; ++i) {
+                auto const batch_row = rows.empty() ? i : std::size_t(rows[i]);
+                if (batch_row >= std::size_t(view.num_rows)) {
+                    return Status::Invalid("Row outside read batch");
+                }
+                visited_rows[i] = batch_row;
+            }
+            if (in_signal_order) {
+                // As AsyncSignalLoader::RowOrder::SignalTable loads them, reads without signal
+                // sorting as row 0:
+                auto const first_signal_row = [&](std::size_t batch_row) -> std::uint64_t {
+                    auto const signal_rows = view.signal[batch_row];
+                    return signal_rows.empty() ? 0 : signal_rows[0];
+                };
+                std::stable_sort(
+                    visited_rows.begin(), visited_rows.end(), [&](std::size_t a, std::size_t b) {
+                        return first_signal_row(a) < first_signal_row(b);
+                    });
+            }
+            for (auto const batch_row : visited_rows) {
+                ARROW_RETURN_NOT_OK(visit(view, batch_row));
+            }
+        }
+        return Status::OK();
+    }
+
+    // Find the unique signal batches holding [row_indices], in ascending order.
+    Result<std::vector<std::size_t>> signal_batches_for_rows(
+        gsl::span<std::uint64_t const> const & row_indices) const
+    {
+        ARROW_ASSIGN_OR_RAISE(auto signal_table, m_signal_table_reader.get());
+        std::vector<std::size_t> batches;
+        for (auto const row : row_indices) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto const batch, signal_table->signal_batch_for_row_id(row, nullptr));
+            // Rows of a read are mostly consecutive, so adjacent duplicates are common:
+            if (batches.empty() || batches.back() != batch) {
+                batches.push_back(batch);
+            }
+        }
+        std::sort(batches.begin(), batches.end());
+        batches.erase(std::unique(batches.begin(), batches.end()), batches.end());
+        return batches;
+    }
+
+    // Find the byte counter [table] of m_bytes_read, sharing its ownership.
+    std::shared_ptr<std::atomic<std::uint64_t>> counter(
+        std::atomic<std::uint64_t> TableBytesRead::*table) const
+    {
+        return {m_bytes_read, &((*m_bytes_read).*table)};
+    }
+
+    Result<RunInfoTableReader> open_run_info_table_reader() const
+    {
+        if (m_migration_result.run_info_table_from_read_table()) {
+            ARROW_ASSIGN_OR_RAISE(auto data, m_run_info_table_data.get());
+            return make_run_info_table_reader(
+                std::make_shared<arrow::io::BufferReader>(*data), m_options.memory_pool());
+        }
+
+        ARROW_ASSIGN_OR_RAISE(
+            auto run_info_sub_file,
+            open_sub_file(
+                m_migration_result.footer().run_info_table,
+                counter(&TableBytesRead::run_info_table)));
+        return make_run_info_table_reader(run_info_sub_file, m_options.memory_pool());
+    }
+
+    Result<std::shared_ptr<arrow::Buffer>> open_run_info_table_data() const
+    {
+        return make_v3_run_info_table(
+            m_migration_result.footer().reads_table, m_options.memory_pool());
+    }
+
+    // Write the migrated tables out, so their locations can be opened as current version files.
+    // Each is written separately, so finding one location doesn't migrate the other table.
+    Result<MigratedTableFile> write_migrated_read_table() const
+    {
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        ARROW_ASSIGN_OR_RAISE(auto dir, MakeTmpDir("pod5_migration"));
+        ARROW_ASSIGN_OR_RAISE(
+            auto table,
+            write_migrated_table(
+                *dir,
+                "reads_table.arrow",
+                read_table->schema(),
+                read_table->num_record_batches(),
+                [&](std::size_t i) -> Result<std::shared_ptr<arrow::RecordBatch>> {
+                    ARROW_ASSIGN_OR_RAISE(auto batch, read_table->read_record_batch(i));
+                    return batch.batch();
+                },
+                m_options.memory_pool()));
+        return MigratedTableFile{std::move(dir), make_file_locaton(table)};
+    }
+
+    Result<MigratedTableFile> write_migrated_run_info_table() const
+    {
+        ARROW_ASSIGN_OR_RAISE(auto data, m_run_info_table_data.get());
+        ARROW_ASSIGN_OR_RAISE(auto dir, MakeTmpDir("pod5_migration"));
+        ARROW_ASSIGN_OR_RAISE(
+            auto table, write_migrated_table(*dir, "run_info_table.arrow", *data));
+        return MigratedTableFile{std::move(dir), make_file_locaton(table)};
+    }
+
+    Result<ReadTableReader> open_read_table_reader() const
+    {
+        auto const & footer = m_migration_result.footer();
+        auto const pool =
+            tagged_memory_pool(MemorySubsystem::ReadTableDecode, m_options.memory_pool());
+        ARROW_ASSIGN_OR_RAISE(
+            auto reads_sub_file,
+            open_sub_file(footer.reads_table, counter(&TableBytesRead::read_table), pool));
+        ARROW_ASSIGN_OR_RAISE(
+            auto read_table_reader,
+            make_read_table_reader(
+                reads_sub_file,
+                pool,
+                m_migration_result.read_table_migrations(),
+                m_options.max_cached_read_table_bytes()));
+
+        // Searching uses the file's read id index where present, otherwise one is built on demand:
+        if (footer.read_id_index.file) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto read_id_index_sub_file, open_sub_file(footer.read_id_index));
+            ARROW_ASSIGN_OR_RAISE(
+                auto read_id_index, ReadIdIndex::open(read_id_index_sub_file, pool));
+            read_table_reader.set_read_id_index(std::move(read_id_index));
+        }
+        return read_table_reader;
+    }
+
+    Result<SignalTableReader> open_signal_table_reader() const
+    {
+        auto const pool =
+            tagged_memory_pool(MemorySubsystem::SignalCache, m_options.memory_pool());
+        ARROW_ASSIGN_OR_RAISE(
+            auto signal_sub_file,
+            open_sub_file(
+                m_migration_result.footer().signal_table,
+                counter(&TableBytesRead::signal_table),
+                pool));
+        ARROW_ASSIGN_OR_RAISE(
+            auto signal_table_reader,
+            make_signal_table_reader(
+                signal_sub_file,
+                m_options.max_cached_signal_table_batches(),
+                m_options.max_cached_signal_table_bytes(),
+                pool,
+                m_migration_result.footer().signal_table.batch_locations));
+        signal_table_reader.set_read_coalescing(m_options.read_coalescing());
+        signal_table_reader.set_vbz_signal_decoder(m_options.vbz_signal_decoder());
+        signal_table_reader.set_signal_checksum_interval(m_options.signal_checksum_interval());
+        signal_table_reader.set_max_cached_decoded_read_bytes(
+            m_options.max_cached_decoded_read_bytes());
+        signal_table_reader.set_row_index(open_signal_row_index(
+            m_migration_result.footer(), signal_table_reader, m_options.memory_pool()));
+
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        auto signal_metadata = signal_table_reader.schema_metadata();
+        auto reads_metadata = read_table->schema_metadata();
+        if (signal_metadata.file_identifier != reads_metadata.file_identifier) {
+            return Status::Invalid(
+                "Invalid read and signal file pair signal identifier: ",
+                signal_metadata.file_identifier,
+                ", reads identifier: ",
+                reads_metadata.file_identifier);
+        }
+        return signal_table_reader;
+    }
+
+    Result<std::shared_ptr<ReadTableStatistics const>> open_statistics() const
+    {
+        ARROW_ASSIGN_OR_RAISE(auto read_table, m_read_table_reader.get());
+        return open_read_table_statistics(
+            m_migration_result.footer(), read_table->num_record_batches(), m_options.memory_pool());
+    }
+
     Version m_file_version_pre_migration;
     MigrationResult m_migration_result;
+    FileReaderOptions m_options;
     FileLocation m_run_info_table_location;
     FileLocation m_read_table_location;
     FileLocation m_signal_table_location;
-    RunInfoTableReader m_run_info_table_reader;
-    ReadTableReader m_read_table_reader;
-    SignalTableReader m_signal_table_reader;
+    LazyOpen<RunInfoTableReader> m_run_info_table_reader;
+    LazyOpen<ReadTableReader> m_read_table_reader;
+    LazyOpen<SignalTableReader> m_signal_table_reader;
+    LazyOpen<std::shared_ptr<ReadTableStatistics const>> m_read_table_statistics;
+    LazyOpen<std::shared_ptr<SignalSummary const>> m_signal_summary;
+    // Only used by files migrated from older versions:
+    LazyOpen<std::shared_ptr<arrow::Buffer>> m_run_info_table_data;
+    LazyOpen<MigratedTableFile> m_migrated_run_info_table_file;
+    LazyOpen<MigratedTableFile> m_migrated_read_table_file;
+    FileLocation m_missing_location{"", 0, 0};
+    std::shared_ptr<TableBytesRead> m_bytes_read;
+    bool m_read_id_index_shared = false;
 };
 
+namespace {
+
+Result<std::shared_ptr<FileReader>> open_file_reader_from_file(
+    std::string const & path,
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    FileReaderOptions const & options)
+{
+    auto pool = options.memory_pool();
+    ARROW_ASSIGN_OR_RAISE(
+        auto original_footer_metadata, combined_file_utils::read_footer(path, file));
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto const original_writer_version,
+        parse_version_number(original_footer_metadata.writer_pod5_version));
+    ARROW_ASSIGN_OR_RAISE(
+        auto migration_result,
+        migrate_if_required(original_writer_version, original_footer_metadata, file, pool));
+
+    // Each table is opened as a sub file of the combined file, so it can be read as if it were
+    // standalone:
+    auto reader = std::make_shared<FileReaderImpl>(
+        original_writer_version, std::move(migration_result), options);
+    if (!options.lazy_open()) {
+        ARROW_RETURN_NOT_OK(reader->open_tables());
+    }
+    return reader;
+}
+
+}  // namespace
+
 pod5::Result<std::shared_ptr<FileReader>> open_file_reader(
     std::string const & path,
     FileReaderOptions const & options)
@@ -173,7 +1121,17 @@ pod5::Result<std::shared_ptr<FileReader>> open_file_reader(
     }
 
     std::shared_ptr<arrow::io::RandomAccessFile> file;
-    if (!options.force_disable_file_mapping() && getenv("POD5_DISABLE_MMAP_OPEN") == nullptr) {
+    if (options.use_direct_io()) {
+        // Not every filesystem supports direct I/O (tmpfs for one), so fall back if it fails:
+        auto file_opt = open_direct_io_file(path, pool);
+        if (file_opt.ok()) {
+            file = *file_opt;
+        }
+    }
+
+    if (!file && !options.force_disable_file_mapping()
+        && getenv("POD5_DISABLE_MMAP_OPEN") == nullptr)
+    {
         // Try to open the file with mmap, if we fail fall back to a traditional open.
         auto file_opt = arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ);
         if (file_opt.ok()) {
@@ -181,54 +1139,51 @@ pod5::Result<std::shared_ptr<FileReader>> open_file_reader(
         }
     }
 
+    if (!file && options.use_io_uring()) {
+        // io_uring is only an optimisation, so fall back to a regular open if it's unavailable:
+        auto file_opt = open_io_uring_file(path, options.io_uring_queue_depth(), pool);
+        if (file_opt.ok()) {
+            file = *file_opt;
+        }
+    }
+
     if (!file) {
         ARROW_ASSIGN_OR_RAISE(auto file_reader, arrow::io::ReadableFile::Open(path, pool));
         file = file_reader;
     }
 
-    ARROW_ASSIGN_OR_RAISE(
-        auto original_footer_metadata, combined_file_utils::read_footer(path, file));
-
-    ARROW_ASSIGN_OR_RAISE(
-        auto const original_writer_version,
-        parse_version_number(original_footer_metadata.writer_pod5_version));
-    ARROW_ASSIGN_OR_RAISE(
-        auto migration_result,
-        migrate_if_required(original_writer_version, original_footer_metadata, file, pool));
+    return open_file_reader_from_file(path, file, options);
+}
 
-    // Files are written standalone, and so needs to be treated with a file offset - it wants to seek around as if the reads file is standalone:
+pod5::Result<std::shared_ptr<FileReader>> open_file_reader(
+    std::shared_ptr<arrow::fs::FileSystem> const & filesystem,
+    std::string const & path,
+    FileReaderOptions const & options)
+{
+    if (!filesystem) {
+        return Status::Invalid("Invalid filesystem specified for file reader");
+    }
+    if (!options.memory_pool()) {
+        return Status::Invalid("Invalid memory pool specified for file writer");
+    }
 
-    ARROW_ASSIGN_OR_RAISE(
-        auto run_info_sub_file, open_sub_file(migration_result.footer().run_info_table));
-    ARROW_ASSIGN_OR_RAISE(
-        auto run_info_table_reader, make_run_info_table_reader(run_info_sub_file, pool));
+    ARROW_ASSIGN_OR_RAISE(auto file, filesystem->OpenInputFile(path));
 
-    ARROW_ASSIGN_OR_RAISE(
-        auto reads_sub_file, open_sub_file(migration_result.footer().reads_table));
-    ARROW_ASSIGN_OR_RAISE(auto read_table_reader, make_read_table_reader(reads_sub_file, pool));
+    // Each read from a remote filesystem has a high latency, so coalesce them by default:
+    auto filesystem_options = options;
+    if (!filesystem_options.read_coalescing()) {
+        filesystem_options.set_read_coalescing(arrow::io::CacheOptions::Defaults());
+    }
+    return open_file_reader_from_file(path, file, filesystem_options);
+}
 
-    ARROW_ASSIGN_OR_RAISE(
-        auto signal_sub_file, open_sub_file(migration_result.footer().signal_table));
-    ARROW_ASSIGN_OR_RAISE(
-        auto signal_table_reader,
-        make_signal_table_reader(signal_sub_file, options.max_cached_signal_table_batches(), pool));
-
-    auto signal_metadata = signal_table_reader.schema_metadata();
-    auto reads_metadata = read_table_reader.schema_metadata();
-    if (signal_metadata.file_identifier != reads_metadata.file_identifier) {
-        return Status::Invalid(
-            "Invalid read and signal file pair signal identifier: ",
-            signal_metadata.file_identifier,
-            ", reads identifier: ",
-            reads_metadata.file_identifier);
-    }
-
-    return std::make_shared<FileReaderImpl>(
-        original_writer_version,
-        std::move(migration_result),
-        std::move(run_info_table_reader),
-        std::move(read_table_reader),
-        std::move(signal_table_reader));
+pod5::Result<std::shared_ptr<FileReader>> open_file_reader_from_uri(
+    std::string const & uri,
+    FileReaderOptions const & options)
+{
+    std::string path;
+    ARROW_ASSIGN_OR_RAISE(auto filesystem, arrow::fs::FileSystemFromUriOrPath(uri, &path));
+    return open_file_reader(filesystem, path, options);
 }
 
 }  // namespace pod5
@@ -5,28 +5,54 @@
 #include "pod5_format/result.h"
 #include "pod5_format/signal_table_utils.h"
 
+#include <arrow/filesystem/type_fwd.h>
+#include <arrow/io/caching.h>
+#include <arrow/util/type_fwd.h>
+
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace arrow {
 class Array;
 class Buffer;
 class MemoryPool;
+
+namespace ipc {
+class Message;
+}
 }  // namespace arrow
 
 namespace pod5 {
 
+class SignalCodec;
+class SignalCompressionContext;
+enum class MemoryPoolBackend : std::uint8_t;
+class SignalCompressionDictionary;
+class ThreadPool;
+struct SignalCalibration;
 class Version;
 struct SchemaMetadataDescription;
 
 class POD5_FORMAT_EXPORT FileReaderOptions {
 public:
     static constexpr std::uint32_t DEFAULT_MAX_CACHED_SIGNAL_TABLE_BATCHES = 5;
+    static constexpr std::size_t DEFAULT_MAX_CACHED_READ_TABLE_BYTES = 16 * 1024 * 1024;
+    static constexpr std::uint32_t DEFAULT_IO_URING_QUEUE_DEPTH = 64;
+    static constexpr std::size_t DEFAULT_SIGNAL_CHECKSUM_INTERVAL = 1;
 
     FileReaderOptions();
 
     void memory_pool(arrow::MemoryPool * memory_pool) { m_memory_pool = memory_pool; }
 
+    // Set the memory pool to one allocating with [backend], failing if it isn't available, see
+    // memory_pool_for_backend(). Only the default backend's allocations are counted per
+    // subsystem, see tagged_memory_pool().
+    pod5::Status set_memory_pool_backend(MemoryPoolBackend backend);
+
     arrow::MemoryPool * memory_pool() const { return m_memory_pool; }
 
     std::size_t max_cached_signal_table_batches() const
@@ -38,6 +64,37 @@ public:
     // Note: 0 here implies no limit.
     void set_max_cached_signal_table_batches(std::size_t max_cached_signal_table_batches);
 
+    std::size_t max_cached_signal_table_bytes() const { return m_max_cached_signal_table_bytes; }
+
+    // Set how many bytes of signal table batches can be cached in memory, applied alongside the
+    // batch count limit. Useful as batch sizes vary widely between files.
+    // Note: 0 here implies no limit.
+    void set_max_cached_signal_table_bytes(std::size_t max_cached_signal_table_bytes)
+    {
+        m_max_cached_signal_table_bytes = max_cached_signal_table_bytes;
+    }
+
+    std::size_t max_cached_read_table_bytes() const { return m_max_cached_read_table_bytes; }
+
+    // Set how many bytes of read table batches can be cached in memory, so repeated lookups of
+    // reads in the same batches don't decode the batch again. Projected batches aren't cached.
+    // Note: 0 here disables the cache.
+    void set_max_cached_read_table_bytes(std::size_t max_cached_read_table_bytes)
+    {
+        m_max_cached_read_table_bytes = max_cached_read_table_bytes;
+    }
+
+    std::size_t max_cached_decoded_read_bytes() const { return m_max_cached_decoded_read_bytes; }
+
+    // Set how many bytes of decoded read signal can be cached in memory, above the signal batch
+    // cache, so reads extracted again are copied (or shared, see
+    // FileReader::extract_sample_buffer) rather than decoded again.
+    // Note: 0 here disables the cache.
+    void set_max_cached_decoded_read_bytes(std::size_t max_cached_decoded_read_bytes)
+    {
+        m_max_cached_decoded_read_bytes = max_cached_decoded_read_bytes;
+    }
+
     void set_force_disable_file_mapping(bool force_disable_file_mapping)
     {
         m_force_disable_file_mapping = force_disable_file_mapping;
@@ -45,10 +102,89 @@ public:
 
     bool force_disable_file_mapping() const { return m_force_disable_file_mapping; }
 
+    // Set if files which aren't memory mapped should be read through io_uring, so batched signal
+    // loads keep many reads in flight. Falls back to regular reads where io_uring is unavailable.
+    void set_use_io_uring(bool use_io_uring) { m_use_io_uring = use_io_uring; }
+
+    bool use_io_uring() const { return m_use_io_uring; }
+
+    // Set the most reads to have in flight at once when reading through io_uring.
+    void set_io_uring_queue_depth(std::uint32_t io_uring_queue_depth)
+    {
+        m_io_uring_queue_depth = io_uring_queue_depth;
+    }
+
+    std::uint32_t io_uring_queue_depth() const { return m_io_uring_queue_depth; }
+
+    // Set if files should be read with direct I/O, bypassing the page cache, in place of memory
+    // mapping or io_uring. Suits one pass scans of files written with page aligned signal
+    // batches. Falls back to the other options where direct I/O is unavailable.
+    void set_use_direct_io(bool use_direct_io) { m_use_direct_io = use_direct_io; }
+
+    bool use_direct_io() const { return m_use_direct_io; }
+
+    // Set if batched signal loads should merge the byte ranges of nearby batches into fewer,
+    // larger reads, issued in parallel. Worthwhile where each read has a high latency, such
+    // as object stores. Files opened from a filesystem coalesce with default options if unset.
+    void set_read_coalescing(std::optional<arrow::io::CacheOptions> read_coalescing)
+    {
+        m_read_coalescing = read_coalescing;
+    }
+
+    std::optional<arrow::io::CacheOptions> const & read_coalescing() const
+    {
+        return m_read_coalescing;
+    }
+
+    // Set if opening should only read the file's footer, leaving each table's footer to be read
+    // when the table is first used. Reduces the cost of opening files to read a few reads.
+    // Note: errors opening a table are then reported on its first use, accessors which can't
+    //       report errors find an empty table.
+    void set_lazy_open(bool lazy_open) { m_lazy_open = lazy_open; }
+
+    bool lazy_open() const { return m_lazy_open; }
+
+    // Set a codec to decode the signal of vbz compressed files in place of the built in vbz
+    // codec, such as one decoding whole batches at once on an accelerator by overriding
+    // SignalCodec::decompress_rows. It must decode vbz signal, with the table's dictionary if
+    // it has one. Files of other signal types are unaffected.
+    void set_vbz_signal_decoder(std::shared_ptr<SignalCodec const> vbz_signal_decoder)
+    {
+        m_vbz_signal_decoder = std::move(vbz_signal_decoder);
+    }
+
+    std::shared_ptr<SignalCodec const> const & vbz_signal_decoder() const
+    {
+        return m_vbz_signal_decoder;
+    }
+
+    // Set how often signal rows are checked against their checksums as they are decoded, in
+    // files written with FileWriterOptions::set_write_signal_checksums: one in every
+    // [signal_checksum_interval] rows of each batch, starting with its first. 1 checks every
+    // row, larger intervals trade detection for less overhead on very fast decoders.
+    // Note: 0 checks no rows, SignalTableRecordBatch::verify_signal_checksum still checks rows
+    //       on demand.
+    void set_signal_checksum_interval(std::size_t signal_checksum_interval)
+    {
+        m_signal_checksum_interval = signal_checksum_interval;
+    }
+
+    std::size_t signal_checksum_interval() const { return m_signal_checksum_interval; }
+
 private:
     arrow::MemoryPool * m_memory_pool;
     std::size_t m_max_cached_signal_table_batches;
+    std::size_t m_max_cached_signal_table_bytes = 0;
+    std::size_t m_max_cached_read_table_bytes = DEFAULT_MAX_CACHED_READ_TABLE_BYTES;
+    std::size_t m_max_cached_decoded_read_bytes = 0;
     bool m_force_disable_file_mapping = false;
+    bool m_use_io_uring = false;
+    std::uint32_t m_io_uring_queue_depth = DEFAULT_IO_URING_QUEUE_DEPTH;
+    bool m_use_direct_io = false;
+    std::optional<arrow::io::CacheOptions> m_read_coalescing;
+    bool m_lazy_open = false;
+    std::shared_ptr<SignalCodec const> m_vbz_signal_decoder;
+    std::size_t m_signal_checksum_interval = DEFAULT_SIGNAL_CHECKSUM_INTERVAL;
 };
 
 class POD5_FORMAT_EXPORT FileLocation {
@@ -65,7 +201,71 @@ public:
     std::size_t size;
 };
 
+/// \brief Counts of a FileReader's IO and decoding since it was opened, to tune caching and
+///        batch sizes for a workload.
+struct FileReaderStatistics {
+    /// Bytes read from each table's part of the file. For memory mapped files, the bytes
+    /// accessed through the mapping.
+    std::uint64_t run_info_table_bytes_read = 0;
+    std::uint64_t read_table_bytes_read = 0;
+    std::uint64_t signal_table_bytes_read = 0;
+
+    /// Arrow IPC record batches decoded from each table.
+    std::uint64_t read_table_batches_decoded = 0;
+    std::uint64_t signal_table_batches_decoded = 0;
+
+    /// Signal batch cache lookups finding the batch cached (or being loaded by another thread),
+    /// lookups which loaded it, and batches evicted to make room.
+    std::uint64_t signal_cache_hits = 0;
+    std::uint64_t signal_cache_misses = 0;
+    std::uint64_t signal_cache_evictions = 0;
+
+    /// The same counts for the read table batch cache.
+    std::uint64_t read_table_cache_hits = 0;
+    std::uint64_t read_table_cache_misses = 0;
+    std::uint64_t read_table_cache_evictions = 0;
+
+    /// The same counts for the decoded read cache, see
+    /// FileReaderOptions::set_max_cached_decoded_read_bytes.
+    std::uint64_t decoded_read_cache_hits = 0;
+    std::uint64_t decoded_read_cache_misses = 0;
+    std::uint64_t decoded_read_cache_evictions = 0;
+
+    /// Bytes of int16 samples decompressed, and the time spent decompressing summed across
+    /// threads.
+    std::uint64_t decompressed_bytes = 0;
+    std::chrono::nanoseconds decompression_time{0};
+};
+
+/// \brief The signal a traversal plan reads, see FileReader::estimate_traversal_cost().
+struct TraversalCost {
+    /// Reads visited by the plan, and the signal table rows holding their samples.
+    std::size_t read_count = 0;
+    std::size_t signal_row_count = 0;
+
+    /// Distinct signal table batches the plan's reads touch, and their stored (compressed)
+    /// size. The size is 0 if the file's footer doesn't list signal batch locations.
+    std::size_t signal_batch_count = 0;
+    std::uint64_t signal_batch_bytes = 0;
+
+    /// Samples held by the plan's reads, each decoding to 2 bytes. 0 if the file doesn't
+    /// record sample counts.
+    std::uint64_t sample_count = 0;
+
+    /// Times the plan moves to a signal batch which doesn't follow the last one it read.
+    std::size_t estimated_seeks = 0;
+};
+
+struct ReadBatchPredicate;
+class ReadIdIndex;
+class ReadScanPredicate;
+class ReadTableProjection;
 class ReadTableRecordBatch;
+class ReadTableStatistics;
+struct RecordBatchLocation;
+class RunInfoTableRecordBatch;
+class SignalRowIndex;
+class SignalSummary;
 class SignalTableRecordBatch;
 
 class POD5_FORMAT_EXPORT FileReader {
@@ -78,23 +278,148 @@ public:
     virtual Result<std::size_t> read_count() const = 0;
 
     virtual Result<ReadTableRecordBatch> read_read_record_batch(std::size_t i) const = 0;
+    /// \brief Read a read table batch holding only the columns in [projection], from
+    ///        make_read_table_projection(). Other columns are reported as missing (null).
+    virtual Result<ReadTableRecordBatch> read_read_record_batch(
+        std::size_t i,
+        ReadTableProjection const & projection) const = 0;
+    /// \brief Make a projection loading only the read table columns named [column_names].
+    virtual Result<std::shared_ptr<ReadTableProjection const>> make_read_table_projection(
+        std::vector<std::string> const & column_names) const = 0;
+    /// \brief Read a read table batch on [thread_pool], without blocking the caller.
+    /// \note The reader is kept alive until the read completes, [thread_pool] must outlive it.
+    virtual arrow::Future<ReadTableRecordBatch> read_read_record_batch_async(
+        std::size_t i,
+        ThreadPool & thread_pool) const = 0;
+    /// \brief Read a read table batch holding only the columns in [projection] on [thread_pool].
+    /// \note The reader and projection are kept alive until the read completes.
+    virtual arrow::Future<ReadTableRecordBatch> read_read_record_batch_async(
+        std::size_t i,
+        std::shared_ptr<ReadTableProjection const> const & projection,
+        ThreadPool & thread_pool) const = 0;
     virtual std::size_t num_read_record_batches() const = 0;
 
+    /// \brief Find the per batch read table statistics, or null if the file has none.
+    virtual std::shared_ptr<ReadTableStatistics const> read_table_statistics() const = 0;
+    /// \brief Find the read table batches which may hold rows matching [predicate], skipping
+    ///        batches whose statistics rule out a match. Every batch is returned for files
+    ///        without statistics.
+    virtual std::vector<std::size_t> filter_read_record_batches(
+        ReadBatchPredicate const & predicate) const = 0;
+
     virtual Result<std::size_t> search_for_read_ids(
         ReadIdSearchInput const & search_input,
         gsl::span<uint32_t> const & batch_counts,
         gsl::span<uint32_t> const & batch_rows) = 0;
 
+    /// \brief Find the file's sorted read id index, building it if the file doesn't store one.
+    virtual Result<std::shared_ptr<ReadIdIndex const>> read_id_index() = 0;
+
+    /// \brief Ready the reader to be shared with processes forked after this call, such as
+    ///        dataloader workers, rather than each reopening the file.
+    ///
+    /// Every table is opened and the read id index built, in memory shared with the children,
+    /// so children neither parse the file again nor copy the index. Cached read and signal
+    /// batches are dropped, so each child caches only the batches it decodes itself.
+    /// \note Fork while no other thread is using the reader. Children may use the reader from
+    ///       any thread. Readers opened with io_uring must not be shared.
+    virtual Status prepare_for_fork() = 0;
+
+    /// \brief Find the reads matching [predicate], reading only the columns it uses.
+    /// \param[out] batch_counts   The number of matching rows per read table batch, length should
+    ///                            be the number of read table batches.
+    /// \param[out] batch_rows     The matching rows of each batch, packed into one array in file
+    ///                            order, as for search_for_read_ids(). A length of the file's read
+    ///                            count is always enough.
+    /// \returns The number of matching reads.
+    virtual Result<std::size_t> scan_reads(
+        ReadScanPredicate const & predicate,
+        gsl::span<uint32_t> const & batch_counts,
+        gsl::span<uint32_t> const & batch_rows) const = 0;
+
     virtual Result<SignalTableRecordBatch> read_signal_record_batch(std::size_t i) const = 0;
+    /// \brief Read a signal table batch on [thread_pool], without blocking the caller.
+    /// \note The reader is kept alive until the read completes, [thread_pool] must outlive it.
+    virtual arrow::Future<SignalTableRecordBatch> read_signal_record_batch_async(
+        std::size_t i,
+        ThreadPool & thread_pool) const = 0;
+    /// \brief Read signal table batch [i] as the record batch message stored in the file,
+    ///        without decoding it (see FileWriter::add_raw_signal_batch()).
+    virtual Result<std::unique_ptr<arrow::ipc::Message>> read_signal_record_batch_message(
+        std::size_t i) const = 0;
     virtual std::size_t num_signal_record_batches() const = 0;
+    /// \brief Find the sample count of every signal table row, embedded in the file when it was
+    ///        written, or null if the file has none.
+    virtual std::shared_ptr<SignalRowIndex const> signal_row_index() const = 0;
+    /// \brief Find reads' signal summaries, embedded in the file when it was written, or null if
+    ///        the file has none.
+    /// \see FileWriterOptions::set_signal_summary_decimations()
+    virtual std::shared_ptr<SignalSummary const> signal_summary() const = 0;
+    /// \brief Find the number of rows in the first signal table batch, which every batch but the
+    ///        last holds unless the file lists batches of different sizes.
+    virtual Result<std::size_t> signal_table_batch_size() const = 0;
     virtual Result<std::size_t> signal_batch_for_row_id(std::size_t row, std::size_t * batch_row)
         const = 0;
+    /// \brief Find the first row of signal table batch [batch].
+    /// \see SignalTableReader::batch_first_row()
+    virtual Result<std::uint64_t> signal_batch_first_row(std::size_t batch) const = 0;
+    /// \brief Find the locations and row counts of the signal table's batches, as listed in the
+    ///        file's footer, empty if the file doesn't list them.
+    virtual std::vector<RecordBatchLocation> const & signal_table_batch_locations() const = 0;
+
+    /// \brief Hint that the signal rows in [row_indices] will be read soon, so the signal
+    ///        batches holding them are read ahead of use.
+    virtual Status prefetch_signal_rows(gsl::span<std::uint64_t const> const & row_indices)
+        const = 0;
+
+    /// \brief Load the signal batches holding the rows in [row_indices] into the cache, with the
+    ///        reads for all batches in flight at once.
+    virtual Status load_signal_rows(gsl::span<std::uint64_t const> const & row_indices)
+        const = 0;
+
+    /// \brief Set the order a traversal plan's reads will have their signal read in, so the
+    ///        signal batch cache keeps the batches needed soonest and drops each batch after its
+    ///        last planned read, see SignalTableReader::set_batch_access_plan().
+    /// \param batch_counts The number of rows to visit in each read table batch, as found by
+    ///                     search_for_read_ids(), or empty to visit every read in file order.
+    /// \param batch_rows   The rows to visit in each batch, packed into one array.
+    /// \param in_signal_order Plan the reads of each read table batch in the order of their
+    ///                        first signal row, as AsyncSignalLoader loads them by default (see
+    ///                        AsyncSignalLoader::RowOrder::SignalTable), rather than in plan order.
+    /// \note Reads the planned reads' signal rows from the read table. The plan covers all
+    ///       signal reads from the file until it is cleared, so suits one traversal at a time.
+    virtual Status set_signal_access_plan(
+        gsl::span<std::uint32_t const> const & batch_counts,
+        gsl::span<std::uint32_t const> const & batch_rows,
+        bool in_signal_order) const = 0;
+
+    /// \brief Drop the plan set by set_signal_access_plan(), evicting the least recently used
+    ///        signal batches again.
+    virtual Status clear_signal_access_plan() const = 0;
+
+    /// \brief Estimate the signal IO a traversal plan needs, without reading any signal.
+    /// \param batch_counts The number of rows to visit in each read table batch, as found by
+    ///                     search_for_read_ids(), or empty to visit every read in file order.
+    /// \param batch_rows   The rows to visit in each batch, packed into one array.
+    /// \note Reads the planned reads' signal rows (and sample counts, when the read table holds
+    ///       them) from the read table, and batch sizes from the footer's signal batch offsets.
+    virtual Result<TraversalCost> estimate_traversal_cost(
+        gsl::span<std::uint32_t const> const & batch_counts,
+        gsl::span<std::uint32_t const> const & batch_rows) const = 0;
+
     /// \brief Find the number of samples in a given list of rows.
     /// \param row_indices      The rows to query for sample ount.
     /// \returns The sum of all sample counts on input rows.
     virtual Result<std::size_t> extract_sample_count(
         gsl::span<std::uint64_t const> const & row_indices) const = 0;
 
+    /// \brief Find where each of a read's signal rows starts within its signal, as chunked by
+    ///        the writer.
+    /// \param row_indices      The read's signal rows, in order.
+    /// \returns The sample offset of each row's chunk, followed by the read's sample count.
+    virtual Result<std::vector<std::uint64_t>> extract_chunk_boundaries(
+        gsl::span<std::uint64_t const> const & row_indices) const = 0;
+
     /// \brief Extract the samples for a list of rows.
     /// \param row_indices      The rows to query for samples.
     /// \param output_samples   The output samples from the rows.
@@ -102,6 +427,103 @@ public:
         gsl::span<std::uint64_t const> const & row_indices,
         gsl::span<std::int16_t> const & output_samples) const = 0;
 
+    /// \brief Extract the samples for a list of rows, decompressing using [compression_context].
+    virtual Status extract_samples(
+        gsl::span<std::uint64_t const> const & row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        SignalCompressionContext & compression_context) const = 0;
+
+    /// \brief Extract the samples for a list of rows, decompressing rows concurrently on
+    ///        [thread_pool] and the calling thread.
+    virtual Status extract_samples(
+        gsl::span<std::uint64_t const> const & row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        ThreadPool & thread_pool) const = 0;
+
+    /// \brief Extract the samples for several reads into one buffer, decompressing the rows of all
+    ///        reads concurrently on [thread_pool] and the calling thread.
+    /// \param reads_row_indices    The signal rows of each read.
+    /// \param output_samples       The output samples, each read's samples following the last's.
+    /// \param sample_offsets       Output for the offset of each read's samples, followed by the
+    ///                             total sample count.
+    virtual Status extract_samples_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const = 0;
+
+    /// \brief Extract the samples for several reads into one buffer calibrated to picoamps,
+    ///        decompressing the rows of all reads concurrently on [thread_pool] and the calling
+    ///        thread.
+    /// \param calibrations         The calibration of each read in [reads_row_indices].
+    /// \see extract_samples_for_reads()
+    virtual Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<float> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const = 0;
+
+    /// \brief Extract the samples for several reads into one buffer as half precision picoamps,
+    ///        half the size of float output.
+    /// \see extract_samples_calibrated_for_reads()
+    virtual Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<Float16> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const = 0;
+
+    /// \brief Extract the samples for several reads into one buffer as 8 bit levels, each
+    ///        (adc + offset) * scale rounded and clamped to the int8 range.
+    /// \see extract_samples_calibrated_for_reads()
+    virtual Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<std::int8_t> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const = 0;
+
+    /// \brief Extract a range of samples from the signal for a list of rows, decoding only the
+    ///        rows which overlap the range.
+    /// \param row_indices      The rows holding the signal.
+    /// \param sample_start     The first sample to extract.
+    /// \param output_samples   The output samples, sized to the number of samples to extract.
+    virtual Status extract_samples_range(
+        gsl::span<std::uint64_t const> const & row_indices,
+        std::uint64_t sample_start,
+        gsl::span<std::int16_t> const & output_samples) const = 0;
+
+    /// \brief Extract the samples for a list of rows, calibrated to picoamps using [calibration].
+    /// \param row_indices      The rows to query for samples.
+    /// \param calibration      The calibration of the read the rows belong to.
+    /// \param output_samples   The output samples from the rows.
+    virtual Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<float> const & output_samples) const = 0;
+
+    /// \brief Extract the samples for a list of rows as half precision picoamps, see
+    ///        calibrate_signal().
+    virtual Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<Float16> const & output_samples) const = 0;
+
+    /// \brief Extract the samples for a list of rows as clamped 8 bit levels, see
+    ///        calibrate_signal().
+    virtual Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<std::int8_t> const & output_samples) const = 0;
+
+    /// \brief Find the samples for a list of rows as one buffer of int16 samples, shared with the
+    ///        decoded read cache rather than copied if it is enabled, see
+    ///        FileReaderOptions::set_max_cached_decoded_read_bytes.
+    /// \param row_indices      The rows to query for samples.
+    virtual Result<std::shared_ptr<arrow::Buffer>> extract_sample_buffer(
+        gsl::span<std::uint64_t const> const & row_indices) const = 0;
+
     /// \brief Extract the samples as written in the arrow table for a list of rows.
     /// \param row_indices      The rows to query for samples.
     /// \param sample_count     The output samples from the rows.
@@ -109,23 +531,71 @@ public:
         gsl::span<std::uint64_t const> const & row_indices,
         std::vector<std::uint32_t> & sample_count) const = 0;
 
+    /// \brief Find the int16 samples for a list of rows of an uncompressed file, pointing into
+    ///        the file's own buffers (or its mapping) rather than copying them.
+    /// \returns Invalid if the file's signal is compressed.
+    virtual Result<std::vector<std::shared_ptr<arrow::Buffer>>>
+    extract_uncompressed_sample_buffers(gsl::span<std::uint64_t const> const & row_indices)
+        const = 0;
+
     virtual FileLocation const & run_info_table_location() const = 0;
     virtual FileLocation const & read_table_location() const = 0;
     virtual FileLocation const & signal_table_location() const = 0;
 
+    /// \brief Find if the read table is migrated batch by batch as it is read, as the file was
+    ///        written by an older version of the format.
+    /// \note read_table_location() then writes the migrated table to a temporary directory, so
+    ///       read its batches through the reader instead.
+    virtual bool read_table_migrated() const = 0;
+    /// \brief Find if the run info table is built in memory from the read table, as the file
+    ///        predates run info tables.
+    /// \note run_info_table_location() then writes the built table to a temporary directory, so
+    ///       read its batches through the reader instead.
+    virtual bool run_info_table_migrated() const = 0;
+
+    virtual Result<RunInfoTableRecordBatch> read_run_info_record_batch(std::size_t i) const = 0;
+    virtual Result<std::size_t> num_run_info_record_batches() const = 0;
+
     virtual Version file_version_pre_migration() const = 0;
 
     virtual SignalType signal_type() const = 0;
+    /// \brief Find if the file stores a checksum of each signal row, see
+    ///        FileWriterOptions::set_write_signal_checksums.
+    virtual bool has_signal_checksums() const = 0;
+    /// \brief Find the dictionary signal is compressed against, or null if none is used.
+    virtual std::shared_ptr<SignalCompressionDictionary const> signal_compression_dictionary()
+        const = 0;
+    /// \brief Find the codec decoding the file's signal, null if the signal is uncompressed.
+    virtual std::shared_ptr<SignalCodec const> signal_codec() const = 0;
 
     virtual Result<std::shared_ptr<RunInfoData const>> find_run_info(
         std::string const & acquisition_id) const = 0;
 
     virtual Result<std::shared_ptr<RunInfoData const>> get_run_info(std::size_t index) const = 0;
     virtual Result<std::size_t> get_run_info_count() const = 0;
+
+    /// \brief Find the reader's IO and decoding counts so far.
+    /// \note Tables not yet opened (see FileReaderOptions::set_lazy_open) count nothing.
+    virtual FileReaderStatistics statistics() const = 0;
 };
 
 POD5_FORMAT_EXPORT pod5::Result<std::shared_ptr<FileReader>> open_file_reader(
     std::string const & path,
     FileReaderOptions const & options = {});
 
+/// \brief Open the file at [path] in [filesystem], for example an object store.
+/// \note Only the footer and tables' metadata are read when opening, signal is fetched as it is
+///       loaded, with nearby batches coalesced unless [options] sets other read coalescing.
+POD5_FORMAT_EXPORT pod5::Result<std::shared_ptr<FileReader>> open_file_reader(
+    std::shared_ptr<arrow::fs::FileSystem> const & filesystem,
+    std::string const & path,
+    FileReaderOptions const & options = {});
+
+/// \brief Open the file at [uri] (for example "s3://bucket/file.pod5"), or an absolute local
+///        path.
+/// \note Object store schemes are only available if arrow was built with support for them.
+POD5_FORMAT_EXPORT pod5::Result<std::shared_ptr<FileReader>> open_file_reader_from_uri(
+    std::string const & uri,
+    FileReaderOptions const & options = {});
+
 }  // namespace pod5
@@ -1,18 +1,25 @@
 #pragma once
 
 #include "pod5_format/internal/combined_file_utils.h"
+#include "pod5_format/internal/recovery_checkpoints.h"
 #include "pod5_format/schema_metadata.h"
 
 #include <arrow/buffer.h>
 #include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/dictionary.h>
+#include <arrow/ipc/message.h>
 #include <arrow/ipc/reader.h>
 #include <arrow/status.h>
+#include <gsl/gsl-lite.hpp>
 
 #include <iostream>
 
 namespace pod5 {
 
 static constexpr char const * kArrowMagicBytes = "ARROW1";
+// The stream format within an ipc file starts after the (padded) magic bytes:
+static constexpr std::int64_t kArrowFileStreamOffset = 8;
 
 struct RecoveredData {
     // Metadata from the original file:
@@ -21,12 +28,21 @@ struct RecoveredData {
     std::size_t recovered_batches = 0;
     arrow::Status failed_batch_status;
     std::size_t recovered_rows = 0;
+    // Batches copied as listed by recovery checkpoints, without being decoded:
+    std::size_t passthrough_batches = 0;
 };
 
-template <typename DestFileType>
-arrow::Result<RecoveredData> recover_arrow_file(
-    std::shared_ptr<arrow::io::RandomAccessFile> const & file_to_recover,
-    DestFileType const & destination_file)
+namespace detail {
+
+struct ArrowFileToRecover {
+    std::shared_ptr<arrow::io::InputStream> input_stream;
+    std::shared_ptr<arrow::ipc::RecordBatchStreamReader> reader;
+    SchemaMetadataDescription metadata;
+};
+
+/// \brief Open the stream of batches within an ipc file, which may have been cut short.
+inline arrow::Result<ArrowFileToRecover> open_arrow_file_to_recover(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file_to_recover)
 {
     // Check for arrow start file:
     int32_t const magic_size = static_cast<int>(::strlen(kArrowMagicBytes));
@@ -36,40 +52,230 @@ arrow::Result<RecoveredData> recover_arrow_file(
     }
 
     // Open the stream format within the ipc file:
+    ArrowFileToRecover result;
+    ARROW_ASSIGN_OR_RAISE(
+        result.input_stream,
+        combined_file_utils::open_sub_file(file_to_recover, kArrowFileStreamOffset));
     ARROW_ASSIGN_OR_RAISE(
-        auto input_stream, combined_file_utils::open_sub_file(file_to_recover, 8));
+        result.reader, arrow::ipc::RecordBatchStreamReader::Open(result.input_stream));
     ARROW_ASSIGN_OR_RAISE(
-        auto opened_stream, arrow::ipc::RecordBatchStreamReader::Open(input_stream));
+        result.metadata, read_schema_key_value_metadata(result.reader->schema()->metadata()));
+    return result;
+}
 
+template <typename DestFileType>
+arrow::Status check_recovered_schema(
+    ArrowFileToRecover const & file,
+    DestFileType const & destination_file)
+{
     auto const & expected_schema = destination_file->schema();
-    auto schema = opened_stream->schema();
-    if (!schema->Equals(*expected_schema, false)) {
+    if (!file.reader->schema()->Equals(*expected_schema, false)) {
         return arrow::Status::Invalid(
             "Recovered file Schema does not match expected schema, version mismatch?");
     }
+    return arrow::Status::OK();
+}
 
-    RecoveredData recovered_data;
-    ARROW_ASSIGN_OR_RAISE(
-        recovered_data.metadata, read_schema_key_value_metadata(schema->metadata()));
+/// \brief Decode the batches left in [file] into [destination_file], until one fails to load.
+template <typename DestFileType>
+arrow::Status recover_remaining_batches(
+    ArrowFileToRecover const & file,
+    DestFileType const & destination_file,
+    RecoveredData & recovered_data)
+{
     while (true) {
-        auto result_opt = opened_stream->Next();
+        auto result_opt = file.reader->Next();
         // Check if the batch failed to load:
         if (!result_opt.ok()) {
             recovered_data.failed_batch_status = result_opt.status();
-            return recovered_data;
+            return arrow::Status::OK();
         }
 
         auto & result = *result_opt;
         if (!result) {
-            break;
+            return arrow::Status::OK();
         }
 
         recovered_data.recovered_batches += 1;
         recovered_data.recovered_rows += result->num_rows();
         ARROW_RETURN_NOT_OK(destination_file->write_batch(*result));
     }
+}
+
+/// \brief Check [message] is a whole record batch, without decoding its body.
+inline bool is_intact_batch_message(arrow::ipc::Message const & message)
+{
+    return message.type() == arrow::ipc::MessageType::RECORD_BATCH && message.Verify();
+}
+
+/// \brief Read the record batch message framed by [begin, end) in [file], without decoding it.
+/// \returns Null if there isn't a complete record batch message there.
+inline std::unique_ptr<arrow::ipc::Message> read_checkpointed_message(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    std::int64_t begin,
+    std::int64_t end)
+{
+    if (end <= begin) {
+        return nullptr;
+    }
+    auto const buffer = file->ReadAt(begin, end - begin);
+    if (!buffer.ok() || (*buffer)->size() != end - begin) {
+        return nullptr;
+    }
+
+    arrow::io::BufferReader reader(*buffer);
+    auto message = arrow::ipc::ReadMessage(&reader);
+    auto const consumed = reader.Tell();
+    // A batch cut short, or zeros from preallocation, won't frame exactly one batch:
+    if (!message.ok() || !*message || !consumed.ok() || *consumed != end - begin
+        || !is_intact_batch_message(**message))
+    {
+        return nullptr;
+    }
+    return std::move(*message);
+}
+
+/// \brief Decode [message] and write it to [destination_file].
+/// \returns False, with [recovered_data]'s failed status set, if [message] can't be decoded.
+template <typename DestFileType>
+arrow::Result<bool> recover_batch_message(
+    arrow::ipc::Message const & message,
+    std::shared_ptr<arrow::Schema> const & schema,
+    DestFileType const & destination_file,
+    RecoveredData & recovered_data)
+{
+    arrow::ipc::DictionaryMemo dictionary_memo;
+    auto batch = arrow::ipc::ReadRecordBatch(
+        message, schema, &dictionary_memo, arrow::ipc::IpcReadOptions::Defaults());
+    if (!batch.ok()) {
+        recovered_data.failed_batch_status = batch.status();
+        return false;
+    }
+    recovered_data.recovered_batches += 1;
+    recovered_data.recovered_rows += (*batch)->num_rows();
+    ARROW_RETURN_NOT_OK(destination_file->write_batch(**batch));
+    return true;
+}
+
+template <typename DestFileType>
+arrow::Status pass_through_batch_message(
+    arrow::ipc::Message const & message,
+    std::size_t row_count,
+    DestFileType const & destination_file,
+    RecoveredData & recovered_data)
+{
+    ARROW_RETURN_NOT_OK(destination_file->write_raw_batch(message, row_count));
+    recovered_data.recovered_batches += 1;
+    recovered_data.passthrough_batches += 1;
+    recovered_data.recovered_rows += row_count;
+    return arrow::Status::OK();
+}
 
+}  // namespace detail
+
+template <typename DestFileType>
+arrow::Result<RecoveredData> recover_arrow_file(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file_to_recover,
+    DestFileType const & destination_file)
+{
+    ARROW_ASSIGN_OR_RAISE(auto opened_file, detail::open_arrow_file_to_recover(file_to_recover));
+    ARROW_RETURN_NOT_OK(detail::check_recovered_schema(opened_file, destination_file));
+
+    RecoveredData recovered_data;
+    recovered_data.metadata = opened_file.metadata;
+    ARROW_RETURN_NOT_OK(
+        detail::recover_remaining_batches(opened_file, destination_file, recovered_data));
     return recovered_data;
 }
 
+/// \brief Recover a file's batches, copying their messages through to [destination_file] without
+///        decoding them where their framing is intact.
+///
+/// The first batch is decoded, to start [destination_file] and find the file's batch size. Batches
+/// listed in [checkpointed_batches] are then read at the offsets listed, if the checkpoints
+/// describe this file. Later batches are read message by message, each checked to be a whole
+/// record batch whose metadata verifies. Every batch but the last holds the batch size's rows, so
+/// a batch followed by an intact batch is copied through as it is, while the last batch (or one
+/// followed by a bad message) is decoded to find its rows.
+/// \note [destination_file] must have fixed size batches, as signal tables do.
+template <typename DestFileType>
+arrow::Result<RecoveredData> recover_arrow_file_passthrough(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file_to_recover,
+    DestFileType const & destination_file,
+    gsl::span<internal::CheckpointedBatch const> const & checkpointed_batches = {})
+{
+    ARROW_ASSIGN_OR_RAISE(auto opened_file, detail::open_arrow_file_to_recover(file_to_recover));
+    ARROW_RETURN_NOT_OK(detail::check_recovered_schema(opened_file, destination_file));
+
+    RecoveredData recovered_data;
+    recovered_data.metadata = opened_file.metadata;
+
+    auto first_batch = opened_file.reader->Next();
+    if (!first_batch.ok()) {
+        recovered_data.failed_batch_status = first_batch.status();
+        return recovered_data;
+    }
+    if (!*first_batch) {
+        return recovered_data;
+    }
+    std::size_t const batch_rows = (*first_batch)->num_rows();
+    recovered_data.recovered_batches += 1;
+    recovered_data.recovered_rows += batch_rows;
+    ARROW_RETURN_NOT_OK(destination_file->write_batch(**first_batch));
+
+    ARROW_ASSIGN_OR_RAISE(auto position, opened_file.input_stream->Tell());
+    position += kArrowFileStreamOffset;
+
+    // Checkpoints for some other file are ignored:
+    if (!checkpointed_batches.empty() && position == checkpointed_batches[0].end_offset) {
+        for (std::size_t i = 1; i < checkpointed_batches.size(); ++i) {
+            auto const & batch = checkpointed_batches[i];
+            auto message =
+                detail::read_checkpointed_message(file_to_recover, position, batch.end_offset);
+            if (!message) {
+                break;
+            }
+            ARROW_RETURN_NOT_OK(detail::pass_through_batch_message(
+                *message, batch.row_count, destination_file, recovered_data));
+            position = batch.end_offset;
+        }
+    }
+
+    // Each message is held until the next is read, to know if it's the last:
+    ARROW_ASSIGN_OR_RAISE(auto const file_size, file_to_recover->GetSize());
+    auto const remaining_stream = arrow::io::RandomAccessFile::GetStream(
+        file_to_recover, position, file_size - position);
+    auto message_reader = arrow::ipc::MessageReader::Open(remaining_stream);
+    auto const schema = opened_file.reader->schema();
+    std::unique_ptr<arrow::ipc::Message> pending_message;
+    while (true) {
+        auto message = message_reader->ReadNextMessage();
+        bool const intact = message.ok() && *message && detail::is_intact_batch_message(**message);
+        if (!intact) {
+            if (pending_message) {
+                ARROW_ASSIGN_OR_RAISE(
+                    auto const decoded,
+                    detail::recover_batch_message(
+                        *pending_message, schema, destination_file, recovered_data));
+                if (!decoded) {
+                    return recovered_data;
+                }
+            }
+            if (!message.ok()) {
+                recovered_data.failed_batch_status = message.status();
+            } else if (*message) {
+                recovered_data.failed_batch_status =
+                    arrow::Status::Invalid("Unexpected message in recovered file");
+            }
+            return recovered_data;
+        }
+
+        if (pending_message) {
+            ARROW_RETURN_NOT_OK(detail::pass_through_batch_message(
+                *pending_message, batch_rows, destination_file, recovered_data));
+        }
+        pending_message = std::move(*message);
+    }
+}
+
 }  // namespace pod5
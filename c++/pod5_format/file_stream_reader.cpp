@@ -0,0 +1,292 @@
+#include "pod5_format/file_stream_reader.h"
+
+#include "pod5_format/internal/combined_file_utils.h"
+#include "pod5_format/migration/migration.h"
+#include "pod5_format/read_table_schema.h"
+#include "pod5_format/run_info_table_schema.h"
+#include "pod5_format/signal_table_schema.h"
+
+#include <arrow/io/buffered.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/record_batch.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace pod5 {
+
+namespace {
+
+static constexpr std::int64_t STREAM_BUFFER_SIZE = 1024 * 1024;
+static constexpr std::array<char, 6> ARROW_FILE_MAGIC{'A', 'R', 'R', 'O', 'W', '1'};
+// Arrow footers only list a table's schema and blocks, so a table whose footer runs past this
+// before its section marker is treated as corrupt:
+static constexpr std::size_t MAX_TABLE_FOOTER_SIZE = 64 * 1024 * 1024;
+
+// Counts the bytes read from [m_input], so the position in the file is known for streams that
+// can't report it.
+class CountingInputStream : public arrow::io::InputStream {
+public:
+    CountingInputStream(std::shared_ptr<arrow::io::InputStream> input) : m_input(std::move(input))
+    {
+    }
+
+    arrow::Status Close() override { return m_input->Close(); }
+
+    bool closed() const override { return m_input->closed(); }
+
+    arrow::Result<std::int64_t> Tell() const override { return m_position; }
+
+    arrow::Result<std::int64_t> Read(std::int64_t nbytes, void * out) override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto const read, m_input->Read(nbytes, out));
+        m_position += read;
+        return read;
+    }
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Read(std::int64_t nbytes) override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto buffer, m_input->Read(nbytes));
+        m_position += buffer->size();
+        return buffer;
+    }
+
+private:
+    std::shared_ptr<arrow::io::InputStream> m_input;
+    std::int64_t m_position = 0;
+};
+
+// Tables in the order they are stored in a file:
+enum class StreamedTable { Signal, RunInfo, Reads };
+
+class FileStreamReaderImpl : public FileStreamReader {
+public:
+    FileStreamReaderImpl(
+        std::shared_ptr<arrow::io::InputStream> && input,
+        Uuid const & section_marker,
+        arrow::MemoryPool * pool)
+    : m_input(std::move(input))
+    , m_section_marker(section_marker)
+    , m_pool(pool)
+    {
+    }
+
+    // Opens the signal table, the first in the file, which holds the file's schema metadata.
+    Status open() { return open_table(StreamedTable::Signal); }
+
+    SchemaMetadataDescription const & schema_metadata() const override
+    {
+        return m_schema_metadata;
+    }
+
+    Result<std::optional<SignalTableRecordBatch>> read_next_signal_batch() override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto batch, read_next_batch(StreamedTable::Signal));
+        if (!batch) {
+            return std::nullopt;
+        }
+        return SignalTableRecordBatch(
+            batch, m_signal_field_locations, m_pool, m_signal_dictionary);
+    }
+
+    Result<std::optional<RunInfoTableRecordBatch>> read_next_run_info_batch() override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto batch, read_next_batch(StreamedTable::RunInfo));
+        if (!batch) {
+            return std::nullopt;
+        }
+        return RunInfoTableRecordBatch(std::move(batch), m_run_info_field_locations);
+    }
+
+    Result<std::optional<ReadTableRecordBatch>> read_next_read_batch() override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto batch, read_next_batch(StreamedTable::Reads));
+        if (!batch) {
+            return std::nullopt;
+        }
+        return ReadTableRecordBatch(std::move(batch), m_read_field_locations);
+    }
+
+private:
+    // Read the next batch of [table], or null once it is finished or skipped.
+    Result<std::shared_ptr<arrow::RecordBatch>> read_next_batch(StreamedTable table)
+    {
+        while (m_table < table) {
+            ARROW_RETURN_NOT_OK(skip_table());
+            ARROW_RETURN_NOT_OK(open_table(StreamedTable(int(m_table) + 1)));
+        }
+        if (m_table != table || !m_table_reader) {
+            return nullptr;
+        }
+
+        std::shared_ptr<arrow::RecordBatch> batch;
+        ARROW_RETURN_NOT_OK(m_table_reader->ReadNext(&batch));
+        if (!batch) {
+            ARROW_RETURN_NOT_OK(finish_table());
+        }
+        return batch;
+    }
+
+    Status open_table(StreamedTable table)
+    {
+        m_table = table;
+
+        // Each table is an arrow ipc file, whose magic comes before a stream of its batches:
+        std::array<char, 8> magic;
+        ARROW_RETURN_NOT_OK(read_exactly(magic.data(), magic.size()));
+        if (!std::equal(ARROW_FILE_MAGIC.begin(), ARROW_FILE_MAGIC.end(), magic.begin())) {
+            return Status::IOError("Missing arrow magic at the start of a table");
+        }
+
+        arrow::ipc::IpcReadOptions options;
+        options.memory_pool = m_pool;
+        ARROW_ASSIGN_OR_RAISE(
+            m_table_reader, arrow::ipc::RecordBatchStreamReader::Open(m_input, options));
+
+        auto const schema = m_table_reader->schema();
+        auto const metadata = schema->metadata();
+        if (!metadata) {
+            return Status::IOError("Missing metadata on table schema");
+        }
+
+        switch (table) {
+        case StreamedTable::Signal: {
+            ARROW_ASSIGN_OR_RAISE(m_schema_metadata, read_schema_key_value_metadata(metadata));
+            if (is_migration_required(m_schema_metadata.writing_pod5_version)) {
+                return Status::NotImplemented(
+                    "Streaming files written by pod5 ",
+                    m_schema_metadata.writing_pod5_version.to_string(),
+                    " requires migration, open them with open_file_reader");
+            }
+            ARROW_ASSIGN_OR_RAISE(m_signal_field_locations, read_signal_table_schema(schema));
+            if (m_signal_field_locations.signal_type == SignalType::VbzDictionarySignal) {
+                ARROW_ASSIGN_OR_RAISE(
+                    m_signal_dictionary, read_signal_dictionary_metadata(metadata));
+            }
+            break;
+        }
+        case StreamedTable::RunInfo: {
+            ARROW_ASSIGN_OR_RAISE(
+                auto const table_metadata, read_schema_key_value_metadata(metadata));
+            ARROW_ASSIGN_OR_RAISE(
+                m_run_info_field_locations, read_run_info_table_schema(table_metadata, schema));
+            break;
+        }
+        case StreamedTable::Reads: {
+            ARROW_ASSIGN_OR_RAISE(
+                auto const table_metadata, read_schema_key_value_metadata(metadata));
+            ARROW_ASSIGN_OR_RAISE(
+                m_read_field_locations, read_read_table_schema(table_metadata, schema));
+            break;
+        }
+        }
+        return Status::OK();
+    }
+
+    // Read past the batches left in the current table and its footer.
+    Status skip_table()
+    {
+        while (m_table_reader) {
+            ARROW_ASSIGN_OR_RAISE(auto batch, read_next_batch(m_table));
+            (void)batch;
+        }
+        return Status::OK();
+    }
+
+    // Read past the footer of the current table, whose stream of batches has ended, up to the
+    // section marker following it.
+    Status finish_table()
+    {
+        m_table_reader = nullptr;
+
+        // The footer's length is only stored at its end, so it is read until the marker, which
+        // is padded to 8 bytes in the file, is found after the closing arrow magic:
+        ARROW_ASSIGN_OR_RAISE(auto const position, m_input->Tell());
+        std::vector<char> footer((8 - position % 8) % 8 + m_section_marker.size());
+        ARROW_RETURN_NOT_OK(read_exactly(footer.data(), footer.size()));
+        while (!is_footer_complete(footer)) {
+            if (footer.size() > MAX_TABLE_FOOTER_SIZE) {
+                return Status::IOError("Failed to find the end of a table");
+            }
+            footer.resize(footer.size() + 8);
+            ARROW_RETURN_NOT_OK(read_exactly(footer.data() + footer.size() - 8, 8));
+        }
+        return Status::OK();
+    }
+
+    bool is_footer_complete(std::vector<char> const & footer) const
+    {
+        auto const marker_start = footer.end() - m_section_marker.size();
+        if (!std::equal(marker_start, footer.end(), (char const *)m_section_marker.data())) {
+            return false;
+        }
+        // Up to 7 bytes of padding come between the magic and the marker:
+        auto magic_end = marker_start;
+        for (std::size_t i = 0; i < 7 && magic_end != footer.begin() && *(magic_end - 1) == 0;
+             ++i)
+        {
+            --magic_end;
+        }
+        return magic_end - footer.begin() >= std::ptrdiff_t(ARROW_FILE_MAGIC.size())
+               && std::equal(
+                   ARROW_FILE_MAGIC.begin(),
+                   ARROW_FILE_MAGIC.end(),
+                   magic_end - ARROW_FILE_MAGIC.size());
+    }
+
+    Status read_exactly(char * out, std::size_t size)
+    {
+        ARROW_ASSIGN_OR_RAISE(auto const read, m_input->Read(size, out));
+        if (read != std::int64_t(size)) {
+            return Status::IOError("Unexpected end of pod5 file stream");
+        }
+        return Status::OK();
+    }
+
+    std::shared_ptr<arrow::io::InputStream> m_input;
+    Uuid m_section_marker;
+    arrow::MemoryPool * m_pool;
+
+    StreamedTable m_table = StreamedTable::Signal;
+    std::shared_ptr<arrow::ipc::RecordBatchStreamReader> m_table_reader;
+
+    SchemaMetadataDescription m_schema_metadata;
+    SignalTableSchemaDescription m_signal_field_locations;
+    std::shared_ptr<SignalCompressionDictionary const> m_signal_dictionary;
+    std::shared_ptr<RunInfoTableSchemaDescription const> m_run_info_field_locations;
+    std::shared_ptr<ReadTableSchemaDescription const> m_read_field_locations;
+};
+
+}  // namespace
+
+Result<std::unique_ptr<FileStreamReader>> open_file_stream_reader(
+    std::shared_ptr<arrow::io::InputStream> const & input,
+    arrow::MemoryPool * pool)
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto buffered_input,
+        arrow::io::BufferedInputStream::Create(
+            STREAM_BUFFER_SIZE, pool, std::make_shared<CountingInputStream>(input)));
+
+    std::array<char, combined_file_utils::header_size> header;
+    ARROW_ASSIGN_OR_RAISE(auto const read, buffered_input->Read(header.size(), header.data()));
+    auto const & signature = combined_file_utils::FILE_SIGNATURE;
+    if (read != std::int64_t(header.size())
+        || !std::equal(signature.begin(), signature.end(), header.begin()))
+    {
+        return Status::IOError("Invalid signature in file stream");
+    }
+    std::array<std::uint8_t, 16> section_marker_bytes;
+    std::memcpy(
+        section_marker_bytes.data(), header.data() + signature.size(), section_marker_bytes.size());
+
+    auto reader = std::make_unique<FileStreamReaderImpl>(
+        std::move(buffered_input), Uuid(section_marker_bytes), pool);
+    ARROW_RETURN_NOT_OK(reader->open());
+    return reader;
+}
+
+}  // namespace pod5
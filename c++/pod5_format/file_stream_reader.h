@@ -0,0 +1,52 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/result.h"
+#include "pod5_format/run_info_table_reader.h"
+#include "pod5_format/schema_metadata.h"
+#include "pod5_format/signal_table_reader.h"
+
+#include <arrow/io/type_fwd.h>
+#include <arrow/memory_pool.h>
+
+#include <memory>
+#include <optional>
+
+namespace pod5 {
+
+/// \brief Reads a pod5 file front to back from a stream which can't seek, such as a pipe or
+///        socket, handing out batches as they arrive.
+///
+/// A file's tables are stored signal, run info then reads, and are read in that order: reading
+/// from a later table skips any batches left in earlier ones, which can't be read after. The
+/// footer at the end of the file isn't read, so files are readable before the stream ends and
+/// the indexes it lists aren't available.
+class POD5_FORMAT_EXPORT FileStreamReader {
+public:
+    virtual ~FileStreamReader() = default;
+
+    virtual SchemaMetadataDescription const & schema_metadata() const = 0;
+
+    /// \brief Read the next batch of the signal table.
+    /// \returns std::nullopt once the signal table is finished or has been skipped.
+    virtual Result<std::optional<SignalTableRecordBatch>> read_next_signal_batch() = 0;
+
+    /// \brief Read the next batch of the run info table, skipping the rest of the signal table.
+    /// \returns std::nullopt once the run info table is finished or has been skipped.
+    virtual Result<std::optional<RunInfoTableRecordBatch>> read_next_run_info_batch() = 0;
+
+    /// \brief Read the next batch of the read table, skipping the rest of the signal and run info
+    ///        tables.
+    /// \returns std::nullopt once the read table is finished.
+    virtual Result<std::optional<ReadTableRecordBatch>> read_next_read_batch() = 0;
+};
+
+/// \brief Open a pod5 file for reading front to back from [input], see FileStreamReader.
+/// \returns NotImplemented for files written by versions whose tables need migrating, which
+///          open_file_reader() can read.
+POD5_FORMAT_EXPORT Result<std::unique_ptr<FileStreamReader>> open_file_stream_reader(
+    std::shared_ptr<arrow::io::InputStream> const & input,
+    arrow::MemoryPool * pool = arrow::default_memory_pool());
+
+}  // namespace pod5
@@ -0,0 +1,310 @@
+#include "pod5_format/file_summary.h"
+
+#include "pod5_format/internal/combined_file_utils.h"
+#include "pod5_format/read_table_schema.h"
+
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_dict.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/array/builder_binary.h>
+#include <arrow/array/builder_primitive.h>
+#include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <arrow/util/key_value_metadata.h>
+
+#include <algorithm>
+#include <array>
+
+namespace pod5 {
+
+namespace {
+
+char const * const INDEX_TYPE_KEY = "MINKNOW:index_type";
+char const * const FILE_SUMMARY_INDEX_TYPE = "file_summary";
+char const * const SIGNAL_BYTES_KEY = "MINKNOW:file_summary_signal_bytes";
+
+std::shared_ptr<arrow::Schema> make_file_summary_schema(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    return arrow::schema(
+        {
+            arrow::field("acquisition_id", arrow::utf8(), false),
+            arrow::field("read_count", arrow::uint64(), false),
+            arrow::field("sample_count", arrow::uint64(), false),
+            arrow::field("min_start_sample", arrow::uint64(), false),
+            arrow::field("max_start_sample", arrow::uint64(), false),
+            arrow::field("acquisition_start_time", arrow::int64(), false),
+            arrow::field("sample_rate", arrow::uint16(), false),
+        },
+        metadata);
+}
+
+bool is_file_summary(arrow::Schema const & schema)
+{
+    auto const & metadata = schema.metadata();
+    if (!metadata) {
+        return false;
+    }
+    auto const index_type = metadata->Get(INDEX_TYPE_KEY);
+    return index_type.ok() && *index_type == FILE_SUMMARY_INDEX_TYPE;
+}
+
+// Find the time in milliseconds since the epoch of [sample] in [run_info].
+std::int64_t sample_time(RunInfoSummary const & run_info, std::uint64_t sample)
+{
+    return run_info.acquisition_start_time + std::int64_t(sample * 1000 / run_info.sample_rate);
+}
+
+bool has_start_times(RunInfoSummary const & run_info)
+{
+    return run_info.read_count > 0 && run_info.sample_rate > 0;
+}
+
+}  // namespace
+
+FileSummary::FileSummary(std::uint64_t signal_bytes, std::vector<RunInfoSummary> && run_infos)
+: m_signal_bytes(signal_bytes)
+, m_run_infos(std::move(run_infos))
+{
+}
+
+RunInfoSummary & FileSummary::find_run_info(std::string const & acquisition_id)
+{
+    auto it = std::find_if(m_run_infos.begin(), m_run_infos.end(), [&](auto const & run_info) {
+        return run_info.acquisition_id == acquisition_id;
+    });
+    if (it != m_run_infos.end()) {
+        return *it;
+    }
+
+    m_run_infos.emplace_back();
+    m_run_infos.back().acquisition_id = acquisition_id;
+    return m_run_infos.back();
+}
+
+Status FileSummary::add_read_table_batch(
+    arrow::RecordBatch const & batch,
+    ReadTableSchemaDescription const & field_locations)
+{
+    std::array<FieldBase const *, 3> const fields{
+        &field_locations.num_samples,
+        &field_locations.start,
+        &field_locations.run_info,
+    };
+    for (auto const * field : fields) {
+        if (!field->found_field() || field->field_index() >= batch.num_columns()) {
+            return Status::Invalid("Read table batch is missing column '", field->name(), "'");
+        }
+    }
+
+    auto const num_samples = std::static_pointer_cast<arrow::UInt64Array>(
+        batch.column(field_locations.num_samples.field_index()));
+    auto const start = std::static_pointer_cast<arrow::UInt64Array>(
+        batch.column(field_locations.start.field_index()));
+    auto const run_info = std::static_pointer_cast<arrow::DictionaryArray>(
+        batch.column(field_locations.run_info.field_index()));
+    auto const run_info_indices = std::static_pointer_cast<arrow::Int16Array>(run_info->indices());
+    auto const acquisition_ids =
+        std::static_pointer_cast<arrow::StringArray>(run_info->dictionary());
+
+    // Map dictionary indices to summary entries as they are first seen in the batch:
+    std::vector<std::int64_t> run_info_entries(acquisition_ids->length(), -1);
+    for (std::int64_t row = 0; row < batch.num_rows(); ++row) {
+        if (!run_info_indices->IsValid(row)) {
+            continue;
+        }
+        auto const index = run_info_indices->Value(row);
+        if (index < 0 || index >= acquisition_ids->length()) {
+            return Status::Invalid("Read table run info index ", index, " is out of range");
+        }
+        if (run_info_entries[index] < 0) {
+            auto const & entry = find_run_info(acquisition_ids->GetString(index));
+            run_info_entries[index] = &entry - m_run_infos.data();
+        }
+
+        auto & entry = m_run_infos[run_info_entries[index]];
+        entry.read_count += 1;
+        entry.sample_count += num_samples->Value(row);
+        entry.min_start_sample = std::min(entry.min_start_sample, start->Value(row));
+        entry.max_start_sample = std::max(entry.max_start_sample, start->Value(row));
+    }
+    return Status::OK();
+}
+
+void FileSummary::add_run_info(
+    std::string const & acquisition_id,
+    std::int64_t acquisition_start_time,
+    std::uint16_t sample_rate)
+{
+    auto & entry = find_run_info(acquisition_id);
+    entry.acquisition_start_time = acquisition_start_time;
+    entry.sample_rate = sample_rate;
+}
+
+std::uint64_t FileSummary::read_count() const
+{
+    std::uint64_t result = 0;
+    for (auto const & run_info : m_run_infos) {
+        result += run_info.read_count;
+    }
+    return result;
+}
+
+std::uint64_t FileSummary::sample_count() const
+{
+    std::uint64_t result = 0;
+    for (auto const & run_info : m_run_infos) {
+        result += run_info.sample_count;
+    }
+    return result;
+}
+
+std::optional<std::int64_t> FileSummary::min_start_time() const
+{
+    std::optional<std::int64_t> result;
+    for (auto const & run_info : m_run_infos) {
+        if (has_start_times(run_info)) {
+            auto const time = sample_time(run_info, run_info.min_start_sample);
+            result = result ? std::min(*result, time) : time;
+        }
+    }
+    return result;
+}
+
+std::optional<std::int64_t> FileSummary::max_start_time() const
+{
+    std::optional<std::int64_t> result;
+    for (auto const & run_info : m_run_infos) {
+        if (has_start_times(run_info)) {
+            auto const time = sample_time(run_info, run_info.max_start_sample);
+            result = result ? std::max(*result, time) : time;
+        }
+    }
+    return result;
+}
+
+Result<std::shared_ptr<FileSummary const>> FileSummary::open(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    arrow::MemoryPool * pool)
+{
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = pool;
+
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(file, options));
+    auto const & schema = reader->schema();
+    if (!is_file_summary(*schema)) {
+        return std::shared_ptr<FileSummary const>();
+    }
+    if (!schema->Equals(*make_file_summary_schema(nullptr), false)) {
+        return Status::IOError("Invalid file summary schema");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto const signal_bytes_str, schema->metadata()->Get(SIGNAL_BYTES_KEY));
+    std::uint64_t signal_bytes = 0;
+    try {
+        signal_bytes = std::stoull(signal_bytes_str);
+    } catch (std::exception const &) {
+        return Status::IOError("Invalid file summary signal bytes '", signal_bytes_str, "'");
+    }
+
+    std::vector<RunInfoSummary> run_infos;
+    for (int i = 0; i < reader->num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadRecordBatch(i));
+        auto const acquisition_id = std::static_pointer_cast<arrow::StringArray>(batch->column(0));
+        auto const read_count = std::static_pointer_cast<arrow::UInt64Array>(batch->column(1));
+        auto const sample_count = std::static_pointer_cast<arrow::UInt64Array>(batch->column(2));
+        auto const min_start_sample =
+            std::static_pointer_cast<arrow::UInt64Array>(batch->column(3));
+        auto const max_start_sample =
+            std::static_pointer_cast<arrow::UInt64Array>(batch->column(4));
+        auto const acquisition_start_time =
+            std::static_pointer_cast<arrow::Int64Array>(batch->column(5));
+        auto const sample_rate = std::static_pointer_cast<arrow::UInt16Array>(batch->column(6));
+
+        for (std::int64_t row = 0; row < batch->num_rows(); ++row) {
+            run_infos.push_back(RunInfoSummary{
+                acquisition_id->GetString(row),
+                read_count->Value(row),
+                sample_count->Value(row),
+                min_start_sample->Value(row),
+                max_start_sample->Value(row),
+                acquisition_start_time->Value(row),
+                sample_rate->Value(row)});
+        }
+    }
+    return std::make_shared<FileSummary const>(signal_bytes, std::move(run_infos));
+}
+
+Result<std::shared_ptr<arrow::Buffer>> FileSummary::write(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    arrow::MemoryPool * pool) const
+{
+    auto const summary_metadata =
+        metadata ? metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    summary_metadata->Append(INDEX_TYPE_KEY, FILE_SUMMARY_INDEX_TYPE);
+    summary_metadata->Append(SIGNAL_BYTES_KEY, std::to_string(m_signal_bytes));
+
+    arrow::StringBuilder acquisition_id(pool);
+    arrow::UInt64Builder read_count(pool);
+    arrow::UInt64Builder sample_count(pool);
+    arrow::UInt64Builder min_start_sample(pool);
+    arrow::UInt64Builder max_start_sample(pool);
+    arrow::Int64Builder acquisition_start_time(pool);
+    arrow::UInt16Builder sample_rate(pool);
+    for (auto const & run_info : m_run_infos) {
+        ARROW_RETURN_NOT_OK(acquisition_id.Append(run_info.acquisition_id));
+        ARROW_RETURN_NOT_OK(read_count.Append(run_info.read_count));
+        ARROW_RETURN_NOT_OK(sample_count.Append(run_info.sample_count));
+        ARROW_RETURN_NOT_OK(min_start_sample.Append(run_info.min_start_sample));
+        ARROW_RETURN_NOT_OK(max_start_sample.Append(run_info.max_start_sample));
+        ARROW_RETURN_NOT_OK(acquisition_start_time.Append(run_info.acquisition_start_time));
+        ARROW_RETURN_NOT_OK(sample_rate.Append(run_info.sample_rate));
+    }
+
+    std::vector<std::shared_ptr<arrow::Array>> columns(7);
+    ARROW_RETURN_NOT_OK(acquisition_id.Finish(&columns[0]));
+    ARROW_RETURN_NOT_OK(read_count.Finish(&columns[1]));
+    ARROW_RETURN_NOT_OK(sample_count.Finish(&columns[2]));
+    ARROW_RETURN_NOT_OK(min_start_sample.Finish(&columns[3]));
+    ARROW_RETURN_NOT_OK(max_start_sample.Finish(&columns[4]));
+    ARROW_RETURN_NOT_OK(acquisition_start_time.Finish(&columns[5]));
+    ARROW_RETURN_NOT_OK(sample_rate.Finish(&columns[6]));
+
+    auto const schema = make_file_summary_schema(summary_metadata);
+    auto const batch =
+        arrow::RecordBatch::Make(schema, std::int64_t(m_run_infos.size()), std::move(columns));
+
+    ARROW_ASSIGN_OR_RAISE(auto sink, arrow::io::BufferOutputStream::Create(4096, pool));
+
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return sink->Finish();
+}
+
+Result<std::shared_ptr<FileSummary const>> open_file_summary(
+    std::string const & path,
+    arrow::MemoryPool * pool)
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto file, arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ));
+    ARROW_ASSIGN_OR_RAISE(auto const footer, combined_file_utils::read_footer(path, file));
+
+    for (auto const & other_index : footer.other_indexes) {
+        ARROW_ASSIGN_OR_RAISE(auto sub_file, combined_file_utils::open_sub_file(other_index));
+        ARROW_ASSIGN_OR_RAISE(auto summary, FileSummary::open(sub_file, pool));
+        if (summary) {
+            return summary;
+        }
+    }
+    return std::shared_ptr<FileSummary const>();
+}
+
+}  // namespace pod5
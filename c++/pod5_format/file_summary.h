@@ -0,0 +1,104 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <arrow/io/type_fwd.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace arrow {
+class Buffer;
+class KeyValueMetadata;
+class MemoryPool;
+class RecordBatch;
+}  // namespace arrow
+
+namespace pod5 {
+
+class ReadTableSchemaDescription;
+
+/// \brief Totals for the reads of one run info in a file.
+struct POD5_FORMAT_EXPORT RunInfoSummary {
+    std::string acquisition_id;
+    std::uint64_t read_count = 0;
+    std::uint64_t sample_count = 0;
+    std::uint64_t min_start_sample = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_start_sample = 0;
+    /// Milliseconds since the epoch, from the run info table. Zero if the run info wasn't added
+    /// through the writer.
+    std::int64_t acquisition_start_time = 0;
+    /// Zero if the run info wasn't added through the writer.
+    std::uint16_t sample_rate = 0;
+};
+
+/// \brief Totals for the reads in a file, answering inventory queries without opening the
+///        file's tables.
+///
+/// Written into the file as an arrow table with one row per run info, tagged with
+/// "MINKNOW:index_type" schema metadata so it can be told apart from other OtherIndex embedded
+/// files.
+class POD5_FORMAT_EXPORT FileSummary {
+public:
+    FileSummary() = default;
+    FileSummary(std::uint64_t signal_bytes, std::vector<RunInfoSummary> && run_infos);
+
+    /// \brief Add the reads in a read table batch laid out as [field_locations].
+    Status add_read_table_batch(
+        arrow::RecordBatch const & batch,
+        ReadTableSchemaDescription const & field_locations);
+
+    /// \brief Record the start time and sample rate of a run info, adding it if it has no reads.
+    void add_run_info(
+        std::string const & acquisition_id,
+        std::int64_t acquisition_start_time,
+        std::uint16_t sample_rate);
+
+    void set_signal_bytes(std::uint64_t signal_bytes) { m_signal_bytes = signal_bytes; }
+
+    /// \brief Open a summary written by [write] from an OtherIndex embedded file.
+    /// \returns The summary, or null if [file] holds a different kind of index.
+    static Result<std::shared_ptr<FileSummary const>> open(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+        arrow::MemoryPool * pool);
+
+    /// \brief Serialise the summary as an arrow ipc file, tagged with [metadata].
+    Result<std::shared_ptr<arrow::Buffer>> write(
+        std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+        arrow::MemoryPool * pool) const;
+
+    std::uint64_t read_count() const;
+    std::uint64_t sample_count() const;
+
+    /// \brief Find the size in bytes of the file's signal table.
+    std::uint64_t signal_bytes() const { return m_signal_bytes; }
+
+    std::vector<RunInfoSummary> const & run_infos() const { return m_run_infos; }
+
+    /// \brief Find the earliest read start, in milliseconds since the epoch, over run infos with
+    ///        a known sample rate.
+    std::optional<std::int64_t> min_start_time() const;
+    /// \brief Find the latest read start, in milliseconds since the epoch, over run infos with
+    ///        a known sample rate.
+    std::optional<std::int64_t> max_start_time() const;
+
+private:
+    RunInfoSummary & find_run_info(std::string const & acquisition_id);
+
+    std::uint64_t m_signal_bytes = 0;
+    std::vector<RunInfoSummary> m_run_infos;
+};
+
+/// \brief Open the summary in the pod5 file at [path], reading only the footer and the summary
+///        itself.
+/// \returns The summary, or null if the file was written without one.
+POD5_FORMAT_EXPORT Result<std::shared_ptr<FileSummary const>> open_file_summary(
+    std::string const & path,
+    arrow::MemoryPool * pool);
+
+}  // namespace pod5
@@ -0,0 +1,220 @@
+#include "pod5_format/file_tail_reader.h"
+
+#include "pod5_format/file_recovery.h"
+#include "pod5_format/internal/combined_file_utils.h"
+#include "pod5_format/internal/recovery_checkpoints.h"
+#include "pod5_format/signal_table_schema.h"
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/dictionary.h>
+#include <arrow/ipc/message.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/record_batch.h>
+#include <arrow/util/endian.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace pod5 {
+
+namespace {
+
+static constexpr std::uint32_t IPC_CONTINUATION_MARKER = 0xFFFFFFFF;
+static constexpr std::int64_t IPC_MESSAGE_PREFIX_SIZE = 8;
+
+class FileTailReaderImpl : public FileTailReader {
+public:
+    FileTailReaderImpl(
+        std::string const & path,
+        std::string const & checkpoints_path,
+        std::shared_ptr<arrow::Schema> && schema,
+        SchemaMetadataDescription && schema_metadata,
+        SignalTableSchemaDescription field_locations,
+        std::shared_ptr<SignalCompressionDictionary const> && dictionary,
+        std::int64_t position,
+        arrow::MemoryPool * pool)
+    : m_path(path)
+    , m_checkpoints_path(checkpoints_path)
+    , m_schema(std::move(schema))
+    , m_schema_metadata(std::move(schema_metadata))
+    , m_field_locations(field_locations)
+    , m_dictionary(std::move(dictionary))
+    , m_position(position)
+    , m_pool(pool)
+    {
+    }
+
+    SchemaMetadataDescription const & schema_metadata() const override
+    {
+        return m_schema_metadata;
+    }
+
+    Result<std::vector<SignalTableRecordBatch>> poll_signal_batches() override
+    {
+        std::vector<SignalTableRecordBatch> batches;
+        if (m_signal_table_complete) {
+            return batches;
+        }
+
+        // A file's size is found when it is opened, so it is reopened to see what was written
+        // since the last poll:
+        ARROW_ASSIGN_OR_RAISE(auto const file, arrow::io::ReadableFile::Open(m_path, m_pool));
+        ARROW_ASSIGN_OR_RAISE(
+            auto const table,
+            combined_file_utils::open_sub_file(file, combined_file_utils::header_size));
+        // The writer removes its checkpoints as it closes the file, so they may be gone:
+        auto checkpoints = internal::read_recovery_checkpoints(m_checkpoints_path);
+        auto const checkpointed_batches =
+            checkpoints.ok() ? std::move(*checkpoints) : std::vector<internal::CheckpointedBatch>{};
+
+        arrow::ipc::IpcReadOptions options;
+        options.memory_pool = m_pool;
+        while (true) {
+            auto message = read_next_message(table, checkpointed_batches);
+            if (!message.message) {
+                break;
+            }
+
+            arrow::ipc::DictionaryMemo dictionary_memo;
+            ARROW_ASSIGN_OR_RAISE(
+                auto batch,
+                arrow::ipc::ReadRecordBatch(
+                    *message.message, m_schema, &dictionary_memo, options));
+            m_position = message.end_offset;
+            m_signal_row_count += batch->num_rows();
+            batches.emplace_back(batch, m_field_locations, m_pool, m_dictionary);
+        }
+        return batches;
+    }
+
+    std::size_t signal_row_count() const override { return m_signal_row_count; }
+
+    bool signal_table_complete() const override { return m_signal_table_complete; }
+
+private:
+    struct FramedMessage {
+        std::unique_ptr<arrow::ipc::Message> message;
+        std::int64_t end_offset = 0;
+    };
+
+    // Read the batch message at the current position of [table], if it's known to be whole.
+    FramedMessage read_next_message(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & table,
+        std::vector<internal::CheckpointedBatch> const & checkpointed_batches)
+    {
+        // Batches listed by a checkpoint were flushed before it was recorded:
+        auto const checkpointed = std::find_if(
+            checkpointed_batches.begin(),
+            checkpointed_batches.end(),
+            [&](internal::CheckpointedBatch const & batch) {
+                return batch.end_offset > m_position;
+            });
+        if (checkpointed != checkpointed_batches.end()) {
+            auto message =
+                detail::read_checkpointed_message(table, m_position, checkpointed->end_offset);
+            if (message) {
+                return {std::move(message), checkpointed->end_offset};
+            }
+        }
+
+        auto const table_size = table->GetSize();
+        auto const prefix = table->ReadAt(m_position, IPC_MESSAGE_PREFIX_SIZE);
+        if (!table_size.ok() || !prefix.ok() || (*prefix)->size() != IPC_MESSAGE_PREFIX_SIZE
+            || read_u32((*prefix)->data()) != IPC_CONTINUATION_MARKER)
+        {
+            return {};
+        }
+
+        // The end of stream marker is written as the file is closed:
+        auto const metadata_length =
+            std::int32_t(read_u32((*prefix)->data() + sizeof(std::uint32_t)));
+        if (metadata_length == 0) {
+            m_signal_table_complete = true;
+            return {};
+        }
+
+        auto message = arrow::ipc::ReadMessage(
+            m_position, IPC_MESSAGE_PREFIX_SIZE + metadata_length, table.get());
+        if (!message.ok() || !*message || !detail::is_intact_batch_message(**message)) {
+            return {};
+        }
+
+        // Zeros from reserved space could be read as part of the body, so the body is only known
+        // to be written once the writer has started the next message or finished the file:
+        auto const end_offset =
+            m_position + IPC_MESSAGE_PREFIX_SIZE + metadata_length + (*message)->body_length();
+        if (end_offset != *table_size) {
+            auto const next_prefix = table->ReadAt(end_offset, sizeof(std::uint32_t));
+            if (!next_prefix.ok() || (*next_prefix)->size() != sizeof(std::uint32_t)
+                || read_u32((*next_prefix)->data()) != IPC_CONTINUATION_MARKER)
+            {
+                return {};
+            }
+        }
+        return {std::move(*message), end_offset};
+    }
+
+    static std::uint32_t read_u32(std::uint8_t const * data)
+    {
+        std::uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return arrow::bit_util::FromLittleEndian(value);
+    }
+
+    std::string m_path;
+    std::string m_checkpoints_path;
+    std::shared_ptr<arrow::Schema> m_schema;
+    SchemaMetadataDescription m_schema_metadata;
+    SignalTableSchemaDescription m_field_locations;
+    std::shared_ptr<SignalCompressionDictionary const> m_dictionary;
+    // Offset of the next batch in the signal table:
+    std::int64_t m_position;
+    arrow::MemoryPool * m_pool;
+
+    std::size_t m_signal_row_count = 0;
+    bool m_signal_table_complete = false;
+};
+
+}  // namespace
+
+Result<std::unique_ptr<FileTailReader>> open_file_tail_reader(
+    std::string const & path,
+    FileReaderOptions const & options)
+{
+    auto const pool = options.memory_pool();
+    ARROW_ASSIGN_OR_RAISE(auto const file, arrow::io::ReadableFile::Open(path, pool));
+    ARROW_RETURN_NOT_OK(combined_file_utils::check_signature(file, 0));
+    ARROW_ASSIGN_OR_RAISE(
+        auto const table,
+        combined_file_utils::open_sub_file(file, combined_file_utils::header_size));
+
+    // The table is opened as a file being recovered would be, its stream read up to the schema:
+    ARROW_ASSIGN_OR_RAISE(auto signal_table, detail::open_arrow_file_to_recover(table));
+    auto schema = signal_table.reader->schema();
+    ARROW_ASSIGN_OR_RAISE(auto field_locations, read_signal_table_schema(schema));
+    field_locations.checksum_interval = options.signal_checksum_interval();
+    std::shared_ptr<SignalCompressionDictionary const> dictionary;
+    if (field_locations.signal_type == SignalType::VbzDictionarySignal) {
+        ARROW_ASSIGN_OR_RAISE(dictionary, read_signal_dictionary_metadata(schema->metadata()));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto position, signal_table.input_stream->Tell());
+    position += kArrowFileStreamOffset;
+
+    // The writer's checkpoints are named by the file's identifier:
+    ARROW_ASSIGN_OR_RAISE(
+        auto const arrow_path, ::arrow::internal::PlatformFilename::FromString(path));
+    auto const checkpoints_path = internal::make_checkpoints_tmp_path(
+        arrow_path, signal_table.metadata.file_identifier);
+
+    return std::make_unique<FileTailReaderImpl>(
+        path,
+        checkpoints_path,
+        std::move(schema),
+        std::move(signal_table.metadata),
+        field_locations,
+        std::move(dictionary),
+        position,
+        pool);
+}
+
+}  // namespace pod5
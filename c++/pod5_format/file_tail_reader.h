@@ -0,0 +1,52 @@
+#pragma once
+
+#include "pod5_format/file_reader.h"
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+#include "pod5_format/schema_metadata.h"
+#include "pod5_format/signal_table_reader.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pod5 {
+
+/// \brief Reads signal table batches from a file a FileWriter is still writing, polling for the
+///        batches flushed since the last poll.
+///
+/// Until the writer closes the file, the signal table is the only table in it, the run info and
+/// read tables being kept in the writer's temporary files, so only signal batches are read.
+///
+/// A batch is returned once it is known to be whole in the file: listed by a recovery
+/// checkpoint, see FileWriterOptions::set_recovery_checkpoint_interval, followed by the start of
+/// the next batch, or ending the file. Without checkpoints, the batch written last is held back
+/// until the next is started, as space the writer reserves ahead reads as zeros. Writers flushing
+/// each batch as it completes, see FileWriterOptions::set_flush_on_batch_complete, and recording a
+/// checkpoint per batch hand their batches to tailing readers soonest.
+class POD5_FORMAT_EXPORT FileTailReader {
+public:
+    virtual ~FileTailReader() = default;
+
+    virtual SchemaMetadataDescription const & schema_metadata() const = 0;
+
+    /// \brief Read the signal batches which have reached the file since the last poll.
+    /// \returns The new batches in the order written, none if there are no more yet.
+    virtual Result<std::vector<SignalTableRecordBatch>> poll_signal_batches() = 0;
+
+    /// \brief Find the number of signal table rows returned by polls so far.
+    virtual std::size_t signal_row_count() const = 0;
+
+    /// \brief Find if the signal table has been finished by the writer closing the file, after
+    ///        which polls return no more batches.
+    virtual bool signal_table_complete() const = 0;
+};
+
+/// \brief Open the file at [path], which may still be being written, to tail its signal table.
+/// \returns An error if the writer hasn't yet flushed the start of the signal table.
+POD5_FORMAT_EXPORT Result<std::unique_ptr<FileTailReader>> open_file_tail_reader(
+    std::string const & path,
+    FileReaderOptions const & options = {});
+
+}  // namespace pod5
@@ -2,10 +2,21 @@
 
 #include "pod5_format/file_reader.h"
 #include "pod5_format/internal/combined_file_utils.h"
+#include "pod5_format/migration/migration.h"
+#include "pod5_format/read_table_reader.h"
 #include "pod5_format/schema_metadata.h"
+#include "pod5_format/thread_pool.h"
 #include "pod5_format/uuid.h"
 
 #include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/util/future.h>
+#include <arrow/util/io_util.h>
+#include <gsl/gsl-lite.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <exception>
 
 namespace pod5 {
 
@@ -33,6 +44,8 @@ pod5::Status update_file(
             source->signal_table_location(),
             combined_file_utils::SubFileCleanup::LeaveOrignalFile,
             section_marker));
+    // The table is copied as it is, so its batches are where the source lists them:
+    signal_info_table.batch_locations = source->signal_table_batch_locations();
     ARROW_ASSIGN_OR_RAISE(
         auto run_info_info_table,
         combined_file_utils::write_file_and_marker(
@@ -63,4 +76,144 @@ pod5::Status update_file(
     return main_file->Close();
 }
 
+namespace {
+
+// Write the migrated read table of [source] to [path], migrating batches on [thread_pool] and
+// writing them in order.
+pod5::Result<FileLocation> write_migrated_read_table(
+    arrow::MemoryPool * pool,
+    FileReader const & source,
+    std::string const & path,
+    ThreadPool & thread_pool,
+    std::size_t max_pending_batches)
+{
+    auto const batch_count = source.num_read_record_batches();
+    max_pending_batches = std::max<std::size_t>(max_pending_batches, 1);
+
+    ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::FileOutputStream::Open(path, false));
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    options.emit_dictionary_deltas = true;
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+
+    std::deque<arrow::Future<ReadTableRecordBatch>> pending_batches;
+    std::size_t next_batch = 0;
+    for (std::size_t i = 0; i < batch_count; ++i) {
+        while (next_batch < batch_count && pending_batches.size() < max_pending_batches) {
+            pending_batches.push_back(source.read_read_record_batch_async(next_batch, thread_pool));
+            next_batch += 1;
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto batch, pending_batches.front().result());
+        pending_batches.pop_front();
+
+        // The migrated schema is the schema of migrated batches:
+        if (!writer) {
+            auto const & schema = batch.batch()->schema();
+            ARROW_ASSIGN_OR_RAISE(
+                writer, arrow::ipc::MakeFileWriter(file, schema, options, schema->metadata()));
+        }
+        ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch.batch()));
+    }
+
+    if (writer) {
+        ARROW_RETURN_NOT_OK(writer->Close());
+    }
+    ARROW_ASSIGN_OR_RAISE(auto const size, file->Tell());
+    ARROW_RETURN_NOT_OK(file->Close());
+    return FileLocation{path, 0, std::size_t(size)};
+}
+
+}  // namespace
+
+pod5::Status update_file(
+    arrow::MemoryPool * pool,
+    std::shared_ptr<FileReader> const & source,
+    std::string destination,
+    ThreadPool & thread_pool,
+    std::size_t max_pending_batches)
+{
+    // Files needing no migration, or with no read batches to find a schema from, are copied:
+    if (!is_migration_required(source->file_version_pre_migration())
+        || source->num_read_record_batches() == 0)
+    {
+        return update_file(pool, source, std::move(destination));
+    }
+
+    auto metadata = source->schema_metadata();
+    ARROW_ASSIGN_OR_RAISE(
+        auto const arrow_path, ::arrow::internal::PlatformFilename::FromString(destination));
+    auto const reads_tmp_path = arrow_path.Parent().ToString() + "/"
+                                + ("." + to_string(metadata.file_identifier) + ".tmp-reads");
+
+    // Removed however the update ends:
+    auto remove_reads_tmp = gsl::finally([&] {
+        (void)arrow::internal::DeleteFile(
+            *::arrow::internal::PlatformFilename::FromString(reads_tmp_path));
+    });
+
+    ARROW_ASSIGN_OR_RAISE(auto main_file, arrow::io::FileOutputStream::Open(destination, false));
+
+    std::random_device gen;
+    auto uuid_gen = BasicUuidRandomGenerator<std::random_device>{gen};
+    auto const section_marker = uuid_gen();
+
+    // Write the initial header to the combined file:
+    ARROW_RETURN_NOT_OK(combined_file_utils::write_combined_header(main_file, section_marker));
+
+    // The signal table is most of a file, and is copied while the read table is migrated:
+    auto signal_copied = arrow::Future<combined_file_utils::FileInfo>::Make();
+    try {
+        thread_pool.post([&, signal_copied]() mutable {
+            signal_copied.MarkFinished(combined_file_utils::write_file_and_marker(
+                pool,
+                main_file,
+                source->signal_table_location(),
+                combined_file_utils::SubFileCleanup::LeaveOrignalFile,
+                section_marker));
+        });
+    } catch (std::exception const & e) {
+        // The pool throws once stopped:
+        return Status::Invalid("Failed to queue signal table copy: ", e.what());
+    }
+
+    auto const read_table_location =
+        write_migrated_read_table(pool, *source, reads_tmp_path, thread_pool, max_pending_batches);
+    // Wait for the copy either way, as it writes to [main_file]:
+    auto signal_info_table = signal_copied.result();
+    ARROW_RETURN_NOT_OK(read_table_location);
+    ARROW_RETURN_NOT_OK(signal_info_table);
+    // The table is copied as it is, so its batches are where the source lists them:
+    signal_info_table->batch_locations = source->signal_table_batch_locations();
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto run_info_info_table,
+        combined_file_utils::write_file_and_marker(
+            pool,
+            main_file,
+            source->run_info_table_location(),
+            combined_file_utils::SubFileCleanup::LeaveOrignalFile,
+            section_marker));
+    ARROW_ASSIGN_OR_RAISE(
+        auto reads_info_table,
+        combined_file_utils::write_file_and_marker(
+            pool,
+            main_file,
+            *read_table_location,
+            combined_file_utils::SubFileCleanup::LeaveOrignalFile,
+            section_marker));
+
+    // Write full file footer:
+    ARROW_RETURN_NOT_OK(combined_file_utils::write_footer(
+        main_file,
+        section_marker,
+        metadata.file_identifier,
+        metadata.writing_software,
+        *signal_info_table,
+        run_info_info_table,
+        reads_info_table));
+
+    return main_file->Close();
+}
+
 }  // namespace pod5
@@ -2,6 +2,7 @@
 
 #include "pod5_format/result.h"
 
+#include <cstddef>
 #include <memory>
 
 namespace arrow {
@@ -11,6 +12,7 @@ class MemoryPool;
 namespace pod5 {
 
 class FileReader;
+class ThreadPool;
 
 /// \brief Write the path [destination] with any migrated data from [source].
 /// \param source The source file data to write updated.
@@ -21,4 +23,19 @@ pod5::Status update_file(
     std::shared_ptr<FileReader> const & source,
     std::string destination);
 
+/// \brief Write the path [destination] with any migrated data from [source], migrating read table
+///        batches in parallel on [thread_pool].
+/// \param max_pending_batches The most read table batches migrated ahead of the one written.
+/// \note No migration changes the signal table, so it is copied as stored, without decoding its
+///       batches, while the read table is migrated. Tables of files needing no migration are all
+///       copied as stored.
+/// \note The destination path should not be the same file that was opened for input, and this
+///       must not be called from a thread of [thread_pool].
+pod5::Status update_file(
+    arrow::MemoryPool * pool,
+    std::shared_ptr<FileReader> const & source,
+    std::string destination,
+    ThreadPool & thread_pool,
+    std::size_t max_pending_batches = 16);
+
 }  // namespace pod5
@@ -0,0 +1,225 @@
+#include "pod5_format/file_verify.h"
+
+#include "pod5_format/file_reader.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/signal_compression.h"
+#include "pod5_format/signal_table_reader.h"
+#include "pod5_format/table_reader.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/types.h"
+
+#include <arrow/array/array_nested.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/record_batch.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace pod5 {
+
+namespace {
+
+/// Counts shared by the tasks checking a file's batches.
+struct VerifyCounters {
+    std::atomic<std::uint64_t> read_count{0};
+    std::atomic<std::uint64_t> sample_count{0};
+    std::atomic<std::uint64_t> checksummed_signal_rows{0};
+    std::atomic<std::uint64_t> checked_signal_frames{0};
+};
+
+Status locate_error(Status const & status, char const * where, std::size_t index)
+{
+    return status.WithMessage(where, " ", index, ": ", status.message());
+}
+
+/// Check the rows of one signal table batch, recording each row's sample count.
+Status verify_signal_batch(
+    FileReader const & reader,
+    FileVerifyOptions const & options,
+    std::size_t batch_index,
+    std::vector<std::uint32_t> & row_sample_counts,
+    VerifyCounters & counters)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const batch, reader.read_signal_record_batch(batch_index));
+    ARROW_RETURN_NOT_OK(batch.batch()->ValidateFull());
+
+    auto const & locations = reader.signal_table_batch_locations();
+    auto const row_count = std::int64_t(batch.num_rows());
+    if (batch_index < locations.size() && locations[batch_index].row_count != 0
+        && locations[batch_index].row_count != row_count)
+    {
+        return Status::IOError(
+            "Footer lists ", locations[batch_index].row_count, " rows, batch holds ", row_count);
+    }
+
+    auto const samples = batch.samples_column();
+    row_sample_counts.assign(samples->raw_values(), samples->raw_values() + row_count);
+
+    auto const signal_type = reader.signal_type();
+    auto const check_checksums = options.check_signal_checksums() && reader.has_signal_checksums();
+    auto const check_frames =
+        options.check_compressed_frames()
+        && (signal_type == SignalType::VbzSignal || signal_type == SignalType::VbzDictionarySignal);
+    auto const vbz_signal = check_frames ? batch.vbz_signal_column() : nullptr;
+    auto const uncompressed_signal = signal_type == SignalType::UncompressedSignal
+                                         ? batch.uncompressed_signal_column()
+                                         : nullptr;
+
+    for (std::int64_t row = 0; row < row_count; ++row) {
+        if (uncompressed_signal && uncompressed_signal->value_length(row) != samples->Value(row)) {
+            return locate_error(
+                Status::IOError(
+                    "Row holds ",
+                    uncompressed_signal->value_length(row),
+                    " samples, expected ",
+                    samples->Value(row)),
+                "row",
+                row);
+        }
+        if (check_checksums) {
+            auto const status = batch.verify_signal_checksum(row);
+            if (!status.ok()) {
+                return locate_error(status, "row", row);
+            }
+        }
+        if (check_frames) {
+            auto const status = check_compressed_signal_frame(
+                vbz_signal->Value(row), samples->Value(row));
+            if (!status.ok()) {
+                return locate_error(status, "row", row);
+            }
+        }
+    }
+
+    if (check_checksums) {
+        counters.checksummed_signal_rows += row_count;
+    }
+    if (check_frames) {
+        counters.checked_signal_frames += row_count;
+    }
+    return Status::OK();
+}
+
+/// Check each read of one read table batch refers to signal rows in the table, holding its
+/// sample count.
+Status verify_read_batch(
+    FileReader const & reader,
+    std::size_t batch_index,
+    std::vector<std::uint32_t> const & row_sample_counts,
+    VerifyCounters & counters)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const batch, reader.read_read_record_batch(batch_index));
+    ARROW_RETURN_NOT_OK(batch.batch()->ValidateFull());
+    auto const columns = batch.view();
+    if (!columns.signal || !columns.num_samples) {
+        return Status::IOError("Batch is missing its signal or num_samples column");
+    }
+
+    std::uint64_t batch_sample_count = 0;
+    for (std::int64_t row = 0; row < columns.num_rows; ++row) {
+        std::uint64_t read_sample_count = 0;
+        for (auto const signal_row : columns.signal[row]) {
+            if (signal_row >= row_sample_counts.size()) {
+                return locate_error(
+                    Status::IOError(
+                        "Signal row ",
+                        signal_row,
+                        " is outside the signal table of ",
+                        row_sample_counts.size(),
+                        " rows"),
+                    "row",
+                    row);
+            }
+            read_sample_count += row_sample_counts[signal_row];
+        }
+
+        if (read_sample_count != columns.num_samples[row]) {
+            return locate_error(
+                Status::IOError(
+                    "Signal rows hold ",
+                    read_sample_count,
+                    " samples, num_samples is ",
+                    columns.num_samples[row]),
+                "row",
+                row);
+        }
+        batch_sample_count += read_sample_count;
+    }
+
+    counters.read_count += columns.num_rows;
+    counters.sample_count += batch_sample_count;
+    return Status::OK();
+}
+
+}  // namespace
+
+Result<FileVerifyReport> verify_file(FileReader const & reader, FileVerifyOptions const & options)
+{
+    auto thread_pool = options.thread_pool();
+    if (!thread_pool) {
+        thread_pool = make_thread_pool(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    VerifyCounters counters;
+
+    ARROW_ASSIGN_OR_RAISE(auto const run_info_count, reader.get_run_info_count());
+    for (std::size_t i = 0; i < run_info_count; ++i) {
+        auto const run_info = reader.get_run_info(i);
+        if (!run_info.ok()) {
+            return locate_error(run_info.status(), "Run info", i);
+        }
+    }
+
+    // Signal batches are checked first, finding every signal row's sample count for the reads:
+    auto const signal_batch_count = reader.num_signal_record_batches();
+    std::vector<std::vector<std::uint32_t>> batch_sample_counts(signal_batch_count);
+    ARROW_RETURN_NOT_OK(internal::run_parallel_tasks(
+        thread_pool.get(), signal_batch_count, [&](std::size_t batch) -> Status {
+            auto const status = verify_signal_batch(
+                reader, options, batch, batch_sample_counts[batch], counters);
+            return status.ok() ? status : locate_error(status, "Signal batch", batch);
+        }));
+
+    std::vector<std::uint32_t> row_sample_counts;
+    for (std::size_t batch = 0; batch < signal_batch_count; ++batch) {
+        // Rows are found in batches by where the reader expects each batch to start:
+        ARROW_ASSIGN_OR_RAISE(auto const first_row, reader.signal_batch_first_row(batch));
+        if (first_row != row_sample_counts.size()) {
+            return locate_error(
+                Status::IOError(
+                    "Batch is expected to start at row ",
+                    first_row,
+                    ", the batches before it hold ",
+                    row_sample_counts.size(),
+                    " rows"),
+                "Signal batch",
+                batch);
+        }
+        row_sample_counts.insert(
+            row_sample_counts.end(),
+            batch_sample_counts[batch].begin(),
+            batch_sample_counts[batch].end());
+        batch_sample_counts[batch] = {};
+    }
+
+    auto const read_batch_count = reader.num_read_record_batches();
+    ARROW_RETURN_NOT_OK(internal::run_parallel_tasks(
+        thread_pool.get(), read_batch_count, [&](std::size_t batch) -> Status {
+            auto const status = verify_read_batch(reader, batch, row_sample_counts, counters);
+            return status.ok() ? status : locate_error(status, "Read batch", batch);
+        }));
+
+    FileVerifyReport report;
+    report.read_count = counters.read_count;
+    report.read_table_batch_count = read_batch_count;
+    report.signal_row_count = row_sample_counts.size();
+    report.signal_table_batch_count = signal_batch_count;
+    report.sample_count = counters.sample_count;
+    report.checksummed_signal_rows = counters.checksummed_signal_rows;
+    report.checked_signal_frames = counters.checked_signal_frames;
+    return report;
+}
+
+}  // namespace pod5
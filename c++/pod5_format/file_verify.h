@@ -0,0 +1,75 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace pod5 {
+
+class FileReader;
+class ThreadPool;
+
+class POD5_FORMAT_EXPORT FileVerifyOptions {
+public:
+    // Set whether signal rows are checked against their stored checksums, in files written with
+    // FileWriterOptions::set_write_signal_checksums. The stored bytes are checked, so no signal
+    // is decompressed.
+    void set_check_signal_checksums(bool check_signal_checksums)
+    {
+        m_check_signal_checksums = check_signal_checksums;
+    }
+
+    bool check_signal_checksums() const { return m_check_signal_checksums; }
+
+    // Set whether each vbz signal row's zstd frame is checked to be whole, and to hold as many
+    // encoded bytes as its sample count needs, from the frame's headers without decompressing it.
+    void set_check_compressed_frames(bool check_compressed_frames)
+    {
+        m_check_compressed_frames = check_compressed_frames;
+    }
+
+    bool check_compressed_frames() const { return m_check_compressed_frames; }
+
+    // Set the thread pool batches are checked on.
+    // Note: If unset a pool with a thread per core is made for the check.
+    void set_thread_pool(std::shared_ptr<ThreadPool> const & thread_pool)
+    {
+        m_thread_pool = thread_pool;
+    }
+
+    std::shared_ptr<ThreadPool> const & thread_pool() const { return m_thread_pool; }
+
+private:
+    bool m_check_signal_checksums = true;
+    bool m_check_compressed_frames = true;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+};
+
+/// \brief What verify_file() found in an intact file.
+struct FileVerifyReport {
+    std::uint64_t read_count = 0;
+    std::uint64_t read_table_batch_count = 0;
+    std::uint64_t signal_row_count = 0;
+    std::uint64_t signal_table_batch_count = 0;
+    std::uint64_t sample_count = 0;
+    /// Signal rows checked against their stored checksums.
+    std::uint64_t checksummed_signal_rows = 0;
+    /// Signal rows whose zstd frame headers were checked.
+    std::uint64_t checked_signal_frames = 0;
+};
+
+/// \brief Check a file is intact, without decoding its signal.
+///
+/// Every batch of each table is read and its arrow arrays validated, so the IPC framing of the
+/// whole file is checked (the footer is checked as the reader is opened). Each read's signal
+/// rows are checked to be in the signal table, and their sample counts to add up to the read's
+/// num_samples. Signal rows are checked against their checksums and their zstd frame headers as
+/// [options] sets. Batches are checked in parallel on the options' thread pool.
+/// \returns IOError locating the first problem found.
+POD5_FORMAT_EXPORT Result<FileVerifyReport> verify_file(
+    FileReader const & reader,
+    FileVerifyOptions const & options = {});
+
+}  // namespace pod5
@@ -1,26 +1,61 @@
 #include "pod5_format/file_writer.h"
 
 #include "pod5_format/file_recovery.h"
+#include "pod5_format/file_summary.h"
 #include "pod5_format/internal/async_output_stream.h"
 #include "pod5_format/internal/combined_file_utils.h"
+#include "pod5_format/internal/flush_scheduler.h"
+#include "pod5_format/internal/ipc_file_blocks.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/internal/recovery_checkpoints.h"
 #include "pod5_format/io_manager.h"
 #include "pod5_format/memory_pool.h"
+#include "pod5_format/read_id_filter.h"
+#include "pod5_format/read_id_index.h"
 #include "pod5_format/read_table_reader.h"
+#include "pod5_format/read_table_sort.h"
 #include "pod5_format/read_table_writer.h"
 #include "pod5_format/read_table_writer_utils.h"
+#include "pod5_format/run_info_table_reader.h"
 #include "pod5_format/run_info_table_writer.h"
 #include "pod5_format/schema_metadata.h"
+#include "pod5_format/signal_compression.h"
+#include "pod5_format/signal_row_index.h"
+#include "pod5_format/signal_summary.h"
+#include "pod5_format/signal_table_reader.h"
+#include "pod5_format/signal_table_schema.h"
 #include "pod5_format/signal_table_writer.h"
 #include "pod5_format/thread_pool.h"
 #include "pod5_format/uuid.h"
 #include "pod5_format/version.h"
+#include "pod5_format/writer_resources.h"
 
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_dict.h>
+#include <arrow/buffer.h>
 #include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/message.h>
 #include <arrow/result.h>
+#include <arrow/util/compression.h>
 #include <arrow/util/future.h>
+#include <arrow/util/io_util.h>
 #include <arrow/util/key_value_metadata.h>
-
+#include <gsl/gsl-lite.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
 #include <optional>
+#include <thread>
 
 #ifdef __linux__
 #include "pod5_format/internal/linux_output_stream.h"
@@ -30,26 +65,224 @@ namespace {
 struct CachedFileValues {
     std::shared_ptr<pod5::IOManager> io_manager;
     std::shared_ptr<pod5::ThreadPool> thread_pool;
+    std::shared_ptr<pod5::ThreadPool> preallocation_thread_pool;
 };
 
 enum class FlushMode { Default, ForceFlushOnBatchComplete };
 
+/// Writes straight through to an arrow stream, counting the bytes written so positions in the
+/// file don't depend on the stream supporting Tell().
+/// \note The stream is flushed, not closed, as the writer closes, so its owner can go on to use it.
+class SinkOutputStream : public pod5::FileOutputStream {
+public:
+    explicit SinkOutputStream(std::shared_ptr<arrow::io::OutputStream> sink)
+    : m_sink(std::move(sink))
+    {
+    }
+
+    arrow::Status Close() override
+    {
+        if (m_closed) {
+            return arrow::Status::OK();
+        }
+        m_closed = true;
+        return m_sink->Flush();
+    }
+
+    bool closed() const override { return m_closed; }
+
+    arrow::Result<std::int64_t> Tell() const override
+    {
+        return m_bytes_written - m_file_start_offset;
+    }
+
+    arrow::Status Write(void const * data, std::int64_t length) override
+    {
+        ARROW_RETURN_NOT_OK(m_sink->Write(data, length));
+        m_bytes_written += length;
+        return arrow::Status::OK();
+    }
+
+    arrow::Status Write(std::shared_ptr<arrow::Buffer> const & data) override
+    {
+        ARROW_RETURN_NOT_OK(m_sink->Write(data));
+        m_bytes_written += data->size();
+        return arrow::Status::OK();
+    }
+
+    arrow::Status Flush() override { return m_sink->Flush(); }
+
+    void set_file_start_offset(std::size_t offset) override { m_file_start_offset = offset; }
+
+private:
+    std::shared_ptr<arrow::io::OutputStream> m_sink;
+    std::int64_t m_bytes_written = 0;
+    std::int64_t m_file_start_offset = 0;
+    bool m_closed = false;
+};
+
+/// Counts the bytes of a signal table's existing batches as its writer writes them again, then
+/// writes on to a stream attached for the batches following them, so the writer continues the
+/// table without the batches being written to the file again.
+class AppendingOutputStream : public pod5::FileOutputStream {
+public:
+    /// \brief Write to [stream] from here on, the bytes counted so far lying ahead of it in the
+    ///        file.
+    void attach(std::shared_ptr<pod5::FileOutputStream> stream) { m_stream = std::move(stream); }
+
+    /// \brief Find the bytes counted before a stream was attached.
+    std::int64_t counted_bytes() const { return m_counted_bytes; }
+
+    arrow::Status Close() override
+    {
+        if (m_closed) {
+            return arrow::Status::OK();
+        }
+        m_closed = true;
+        return m_stream ? m_stream->Close() : arrow::Status::OK();
+    }
+
+    bool closed() const override { return m_closed; }
+
+    arrow::Result<std::int64_t> Tell() const override
+    {
+        if (!m_stream) {
+            return m_counted_bytes;
+        }
+        ARROW_ASSIGN_OR_RAISE(auto const position, m_stream->Tell());
+        return m_counted_bytes + position;
+    }
+
+    arrow::Status Write(void const * data, std::int64_t length) override
+    {
+        if (!m_stream) {
+            m_counted_bytes += length;
+            return arrow::Status::OK();
+        }
+        return m_stream->Write(data, length);
+    }
+
+    arrow::Status Write(std::shared_ptr<arrow::Buffer> const & data) override
+    {
+        if (!m_stream) {
+            m_counted_bytes += data->size();
+            return arrow::Status::OK();
+        }
+        return m_stream->Write(data);
+    }
+
+    arrow::Status Flush() override { return m_stream ? m_stream->Flush() : arrow::Status::OK(); }
+
+    arrow::Status batch_complete() override
+    {
+        return m_stream ? m_stream->batch_complete() : arrow::Status::OK();
+    }
+
+    std::size_t pending_write_bytes() const override
+    {
+        return m_stream ? m_stream->pending_write_bytes() : 0;
+    }
+
+    bool has_write_capacity() const override
+    {
+        return m_stream ? m_stream->has_write_capacity() : true;
+    }
+
+    void set_wait_for_write_capacity(bool wait) override
+    {
+        if (m_stream) {
+            m_stream->set_wait_for_write_capacity(wait);
+        }
+    }
+
+    void set_write_capacity_callback(std::function<void()> callback) override
+    {
+        if (m_stream) {
+            m_stream->set_write_capacity_callback(std::move(callback));
+        }
+    }
+
+private:
+    std::shared_ptr<pod5::FileOutputStream> m_stream;
+    std::int64_t m_counted_bytes = 0;
+    bool m_closed = false;
+};
+
+arrow::Result<std::vector<std::uint8_t>> compress_signal_chunk(
+    gsl::span<std::int16_t const> const & samples,
+    pod5::SignalCodec const & codec,
+    pod5::SignalCompressionProfile const & profile,
+    std::shared_ptr<pod5::SignalCompressionDictionary const> const & dictionary)
+{
+    auto & context = pod5::thread_local_signal_compression_context();
+    context.set_profile(profile);
+    context.set_dictionary(dictionary);
+
+    std::vector<std::uint8_t> compressed(codec.max_compressed_size(samples.size()));
+    ARROW_ASSIGN_OR_RAISE(
+        auto const compressed_size, codec.compress(samples, context, gsl::make_span(compressed)));
+    compressed.resize(compressed_size);
+    return compressed;
+}
+
+// Write to [file] from the writer's io thread pool.
+arrow::Result<std::shared_ptr<pod5::FileOutputStream>> make_async_file_stream(
+    std::shared_ptr<arrow::io::FileOutputStream> const & file,
+    pod5::FileWriterOptions const & options,
+    CachedFileValues & cached_values,
+    std::size_t max_parallel_writes)
+{
+    if (!cached_values.thread_pool) {
+        if (options.thread_pool()) {
+            cached_values.thread_pool = options.thread_pool();
+        } else if (options.writer_resources()) {
+            cached_values.thread_pool = options.writer_resources()->io_thread_pool();
+        } else {
+            cached_values.thread_pool =
+                pod5::make_thread_pool(std::max<std::size_t>(options.max_parallel_writes(), 1));
+        }
+    }
+
+    return pod5::AsyncOutputStream::make(
+        file,
+        cached_values.thread_pool,
+        options.memory_pool(),
+        options.max_pending_write_bytes(),
+        max_parallel_writes);
+}
+
 arrow::Result<std::shared_ptr<pod5::FileOutputStream>> make_file_stream(
     std::string const & path,
     pod5::FileWriterOptions const & options,
     CachedFileValues & cached_values,
-    FlushMode flush_mode = FlushMode::Default)
+    FlushMode flush_mode = FlushMode::Default,
+    std::size_t expected_file_size = 0)
 {
 #ifdef __linux__
     if (options.use_directio() || options.use_sync_io()) {
         if (!cached_values.io_manager) {
             if (options.io_manager()) {
                 cached_values.io_manager = options.io_manager();
+            } else if (options.writer_resources() && options.writer_resources()->io_manager()) {
+                cached_values.io_manager = options.writer_resources()->io_manager();
             } else {
                 ARROW_ASSIGN_OR_RAISE(
                     cached_values.io_manager, pod5::make_sync_io_manager(options.memory_pool()));
             }
         }
+
+        pod5::FilePreallocationOptions preallocation;
+        preallocation.expected_size = expected_file_size;
+        if (options.preallocate_in_background()) {
+            // Not the writer's pool, a stream closing on it would wait on its own reservation:
+            if (!cached_values.preallocation_thread_pool) {
+                cached_values.preallocation_thread_pool =
+                    options.writer_resources()
+                        ? options.writer_resources()->preallocation_thread_pool()
+                        : pod5::make_thread_pool(1);
+            }
+            preallocation.thread_pool = cached_values.preallocation_thread_pool;
+        }
         return pod5::LinuxOutputStream::make(
             path,
             cached_values.io_manager,
@@ -57,21 +290,14 @@ arrow::Result<std::shared_ptr<pod5::FileOutputStream>> make_file_stream(
             options.use_directio(),
             options.use_sync_io(),
             flush_mode == FlushMode::ForceFlushOnBatchComplete ? true
-                                                               : options.flush_on_batch_complete());
+                                                               : options.flush_on_batch_complete(),
+            preallocation);
     }
 
 #endif
-    if (!cached_values.thread_pool) {
-        if (options.thread_pool()) {
-            cached_values.thread_pool = options.thread_pool();
-        } else {
-            cached_values.thread_pool = pod5::make_thread_pool(1);
-        }
-    }
-
+    (void)expected_file_size;
     ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::FileOutputStream::Open(path, false));
-
-    return pod5::AsyncOutputStream::make(file, cached_values.thread_pool, options.memory_pool());
+    return make_async_file_stream(file, options, cached_values, options.max_parallel_writes());
 }
 }  // namespace
 
@@ -83,12 +309,39 @@ FileWriterOptions::FileWriterOptions()
 , m_signal_type(DEFAULT_SIGNAL_TYPE)
 , m_signal_table_batch_size(DEFAULT_SIGNAL_TABLE_BATCH_SIZE)
 , m_read_table_batch_size(DEFAULT_READ_TABLE_BATCH_SIZE)
+, m_signal_table_batch_bytes(DEFAULT_TABLE_BATCH_BYTES)
+, m_read_table_batch_bytes(DEFAULT_TABLE_BATCH_BYTES)
 , m_run_info_table_batch_size(DEFAULT_RUN_INFO_TABLE_BATCH_SIZE)
+, m_table_compression(DEFAULT_TABLE_COMPRESSION)
 , m_use_directio{DEFAULT_USE_DIRECTIO}
+, m_page_align_signal_batches(DEFAULT_PAGE_ALIGN_SIGNAL_BATCHES)
 , m_write_chunk_size(DEFAULT_WRITE_CHUNK_SIZE)
 , m_use_sync_io(DEFAULT_USE_SYNC_IO)
 , m_flush_on_batch_complete(DEFAULT_FLUSH_ON_BATCH_COMPLETE)
+, m_expected_file_size(DEFAULT_EXPECTED_FILE_SIZE)
+, m_preallocate_in_background(DEFAULT_PREALLOCATE_IN_BACKGROUND)
+, m_max_flush_latency(DEFAULT_MAX_FLUSH_LATENCY)
+, m_max_unflushed_bytes(DEFAULT_MAX_UNFLUSHED_BYTES)
+, m_max_pending_write_bytes(DEFAULT_MAX_PENDING_WRITE_BYTES)
+, m_max_parallel_writes(DEFAULT_MAX_PARALLEL_WRITES)
+, m_recovery_checkpoint_interval(DEFAULT_RECOVERY_CHECKPOINT_INTERVAL)
+, m_write_read_id_index(DEFAULT_WRITE_READ_ID_INDEX)
+, m_write_read_id_filter(DEFAULT_WRITE_READ_ID_FILTER)
+, m_write_read_table_statistics(DEFAULT_WRITE_READ_TABLE_STATISTICS)
+, m_write_file_summary(DEFAULT_WRITE_FILE_SUMMARY)
+, m_write_signal_row_index(DEFAULT_WRITE_SIGNAL_ROW_INDEX)
+, m_write_signal_checksums(DEFAULT_WRITE_SIGNAL_CHECKSUMS)
+, m_write_signal_statistics(DEFAULT_WRITE_SIGNAL_STATISTICS)
+, m_sort_read_table_by_read_id(DEFAULT_SORT_READ_TABLE_BY_READ_ID)
+, m_max_compression_jobs(DEFAULT_MAX_COMPRESSION_JOBS)
+, m_max_recycled_batch_bytes(DEFAULT_MAX_RECYCLED_BATCH_BYTES)
+{
+}
+
+Status FileWriterOptions::set_memory_pool_backend(MemoryPoolBackend backend)
 {
+    ARROW_ASSIGN_OR_RAISE(m_memory_pool, memory_pool_for_backend(backend));
+    return Status::OK();
 }
 
 class FileWriterImpl {
@@ -101,19 +354,58 @@ public:
         std::shared_ptr<RunInfoWriter> run_info_writer;
     };
 
+    /// When the writer flushes [streams], see FileWriterOptions::set_max_flush_latency.
+    struct FlushPolicy {
+        std::chrono::milliseconds max_latency{0};
+        std::size_t max_unflushed_bytes = 0;
+        std::shared_ptr<ThreadPool> thread_pool;
+        std::vector<std::shared_ptr<FileOutputStream>> streams;
+    };
+
+    /// Where and how often the writer records recovery checkpoints, see
+    /// FileWriterOptions::set_recovery_checkpoint_interval.
+    struct RecoveryCheckpoints {
+        std::unique_ptr<internal::RecoveryCheckpointWriter> writer;
+        std::size_t interval = 0;
+        std::shared_ptr<FileOutputStream> signal_stream;
+    };
+
+    /// Where reads' signal summaries are written until the file is closed, see
+    /// FileWriterOptions::set_signal_summary_decimations.
+    struct SignalSummaries {
+        std::unique_ptr<SignalSummaryWriter> writer;
+        std::string path;
+    };
+
+    /// Where signal added to a closed file is staged until the writer closes, see
+    /// open_file_writer_for_append.
+    struct AppendedSignal {
+        std::string staging_path;
+        // Where the file's existing signal batches end, for the staged signal to follow them:
+        std::int64_t batches_end = 0;
+    };
+
     FileWriterImpl(
         DictionaryWriters && read_table_dict_writers,
         RunInfoTableWriter && run_info_table_writer,
         ReadTableWriter && read_table_writer,
         SignalTableWriter && signal_table_writer,
-        std::uint32_t signal_chunk_size,
-        arrow::MemoryPool * pool)
-    : m_read_table_dict_writers(std::move(read_table_dict_writers))
+        SignalChunker signal_chunker,
+        std::shared_ptr<ThreadPool> const & compression_thread_pool,
+        std::size_t max_compression_jobs,
+        std::shared_ptr<RecyclingMemoryPool> const & recycling_pool,
+        arrow::MemoryPool * pool,
+        arrow::MemoryPool * compression_pool)
+    : m_recycling_pool(recycling_pool)
+    , m_read_table_dict_writers(std::move(read_table_dict_writers))
     , m_run_info_table_writer(std::move(run_info_table_writer))
     , m_read_table_writer(std::move(read_table_writer))
     , m_signal_table_writer(std::move(signal_table_writer))
-    , m_signal_chunk_size(signal_chunk_size)
+    , m_signal_chunker(std::move(signal_chunker))
+    , m_compression_thread_pool(compression_thread_pool)
+    , m_max_compression_jobs(max_compression_jobs)
     , m_pool(pool)
+    , m_compression_pool(compression_pool)
     {
     }
 
@@ -133,13 +425,25 @@ public:
 
     pod5::Result<RunInfoDictionaryIndex> add_run_info(RunInfoData const & run_info_data)
     {
+        auto & run_info_writer = *m_read_table_dict_writers.run_info_writer;
+        if (auto const existing = run_info_writer.find(run_info_data)) {
+            return *existing;
+        }
+
         ARROW_RETURN_NOT_OK(m_run_info_table_writer->add_run_info(run_info_data));
-        return m_read_table_dict_writers.run_info_writer->add(run_info_data.acquisition_id);
+        ARROW_ASSIGN_OR_RAISE(auto const index, run_info_writer.add(run_info_data));
+        m_run_info_timings.push_back(
+            {run_info_data.acquisition_id,
+             run_info_data.acquisition_start_time,
+             run_info_data.sample_rate});
+        return index;
     }
 
+    /// \param signal_owner Keeps [signal] alive, if set, so compression jobs can use it in place.
     pod5::Status add_complete_read(
         ReadData const & read_data,
-        gsl::span<std::int16_t const> const & signal)
+        gsl::span<std::int16_t const> const & signal,
+        std::shared_ptr<void const> const & signal_owner = nullptr)
     {
         if (!m_signal_table_writer || !m_read_table_writer) {
             return arrow::Status::Invalid("File writer closed, cannot write further data");
@@ -147,19 +451,38 @@ public:
 
         ARROW_RETURN_NOT_OK(check_read(read_data));
 
+        if (m_signal_summaries.writer) {
+            gsl::span<std::int16_t const> const chunks[] = {signal};
+            ARROW_RETURN_NOT_OK(
+                m_signal_summaries.writer->add_read(read_data.read_id, gsl::make_span(chunks)));
+        }
+
+        std::optional<SignalStatistics> signal_statistics;
+        if (m_read_table_writer->writes_signal_statistics()) {
+            gsl::span<std::int16_t const> const chunks[] = {signal};
+            signal_statistics = compute_signal_statistics(gsl::make_span(chunks));
+        }
+
         ARROW_ASSIGN_OR_RAISE(
-            std::vector<std::uint64_t> signal_rows, add_signal(read_data.read_id, signal));
+            std::vector<std::uint64_t> signal_rows,
+            add_signal(read_data.read_id, signal, signal_owner));
 
         // Write read data and signal row entries:
         auto read_table_row = m_read_table_writer->add_read(
-            read_data, gsl::make_span(signal_rows.data(), signal_rows.size()), signal.size());
-        return read_table_row.status();
+            read_data,
+            gsl::make_span(signal_rows.data(), signal_rows.size()),
+            signal.size(),
+            signal_statistics ? &*signal_statistics : nullptr);
+        ARROW_RETURN_NOT_OK(read_table_row.status());
+        return flush_if_due();
     }
 
+    /// \param signal_statistics The statistics of the read's samples, null if unknown.
     pod5::Status add_complete_read(
         ReadData const & read_data,
         gsl::span<std::uint64_t const> const & signal_rows,
-        std::uint64_t signal_duration)
+        std::uint64_t signal_duration,
+        SignalStatistics const * signal_statistics = nullptr)
     {
         if (!m_signal_table_writer || !m_read_table_writer) {
             return arrow::Status::Invalid("File writer closed, cannot write further data");
@@ -168,9 +491,191 @@ public:
         ARROW_RETURN_NOT_OK(check_read(read_data));
 
         // Write read data and signal row entries:
-        auto read_table_row =
-            m_read_table_writer->add_read(read_data, signal_rows, signal_duration);
-        return read_table_row.status();
+        auto read_table_row = m_read_table_writer->add_read(
+            read_data, signal_rows, signal_duration, signal_statistics);
+        ARROW_RETURN_NOT_OK(read_table_row.status());
+        return flush_if_due();
+    }
+
+    /// \brief Add a complete read, unless the write or compression queues are full.
+    /// \returns false, without adding the read, if it would wait on either.
+    pod5::Result<bool> try_add_complete_read(
+        ReadData const & read_data,
+        gsl::span<std::int16_t const> const & signal)
+    {
+        if (!m_signal_table_writer || !m_read_table_writer) {
+            return arrow::Status::Invalid("File writer closed, cannot write further data");
+        }
+
+        // Marked before checking, so capacity freed during the check is still signalled:
+        m_capacity_callback->refused = true;
+        if (!has_write_capacity()) {
+            return false;
+        }
+        m_capacity_callback->refused = false;
+
+        // The queues had room, so the read's batches and chunks are queued beyond their limits
+        // rather than waiting:
+        set_wait_for_capacity(false);
+        auto restore_waits = gsl::finally([&] { set_wait_for_capacity(true); });
+        ARROW_RETURN_NOT_OK(add_complete_read(read_data, signal));
+        return true;
+    }
+
+    /// \brief Find if the write and compression queues have room for another read.
+    bool has_write_capacity() const
+    {
+        for (auto const & stream : m_output_streams) {
+            if (!stream->has_write_capacity()) {
+                return false;
+            }
+        }
+        if (!m_compression_thread_pool) {
+            return true;
+        }
+
+        // Chunks compressed at the front of the queue are written before the next read's:
+        auto queued_chunks = m_pending_chunks.size();
+        for (auto const & chunk : m_pending_chunks) {
+            if (chunk.compressed.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                break;
+            }
+            queued_chunks -= 1;
+        }
+        if (queued_chunks >= m_max_compression_jobs) {
+            return false;
+        }
+        if (m_writer_resources && queued_chunks > 0) {
+            auto const max_bytes = m_writer_resources->options().max_pending_signal_bytes;
+            if (max_bytes > 0 && m_writer_resources->pending_signal_bytes() >= max_bytes) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Set the files the writer queues writes to, whose pending writes limit the reads
+    ///        try_add_complete_read accepts.
+    void set_output_streams(std::vector<std::shared_ptr<FileOutputStream>> && streams)
+    {
+        m_output_streams = std::move(streams);
+        for (auto const & stream : m_output_streams) {
+            stream->set_write_capacity_callback(
+                [capacity_callback = m_capacity_callback] { capacity_callback->notify(); });
+        }
+    }
+
+    void set_write_capacity_callback(std::function<void()> callback)
+    {
+        std::lock_guard<std::mutex> l(m_capacity_callback->mutex);
+        m_capacity_callback->callback = std::move(callback);
+    }
+
+    /// \brief Add reads in bulk, with their signal already split into chunks.
+    /// \param chunks Every read's signal chunks in order, read i owning the chunks from
+    ///               [chunk_offsets][i] up to [chunk_offsets][i + 1].
+    /// \param compressed_chunks The compressed [chunks], unset if signal isn't compressed.
+    pod5::Status add_reads(
+        ReadDataColumns const & reads,
+        gsl::span<gsl::span<std::int16_t const> const> const & chunks,
+        CompressedSignalBatch const * compressed_chunks,
+        gsl::span<std::size_t const> const & chunk_offsets,
+        gsl::span<std::uint64_t const> const & signal_durations)
+    {
+        if (!m_signal_table_writer || !m_read_table_writer) {
+            return arrow::Status::Invalid("File writer closed, cannot write further data");
+        }
+
+        ARROW_RETURN_NOT_OK(check_reads(reads));
+
+        if (m_signal_summaries.writer) {
+            for (std::size_t read = 0; read < reads.size(); ++read) {
+                ARROW_RETURN_NOT_OK(m_signal_summaries.writer->add_read(
+                    reads.read_id[read],
+                    chunks.subspan(
+                        chunk_offsets[read], chunk_offsets[read + 1] - chunk_offsets[read])));
+            }
+        }
+
+        std::vector<SignalStatistics> signal_statistics;
+        if (m_read_table_writer->writes_signal_statistics()) {
+            signal_statistics.reserve(reads.size());
+            for (std::size_t read = 0; read < reads.size(); ++read) {
+                signal_statistics.push_back(compute_signal_statistics(chunks.subspan(
+                    chunk_offsets[read], chunk_offsets[read + 1] - chunk_offsets[read])));
+            }
+        }
+
+        // Chunks queued by earlier reads take the signal rows before these:
+        ARROW_RETURN_NOT_OK(write_compressed_chunks(WaitMode::All));
+
+        std::vector<SignalTableRowIndex> signal_rows;
+        signal_rows.reserve(chunks.size());
+        for (std::size_t read = 0; read < reads.size(); ++read) {
+            for (auto chunk = chunk_offsets[read]; chunk < chunk_offsets[read + 1]; ++chunk) {
+                auto const chunk_bytes =
+                    compressed_chunks ? compressed_chunks->signal(chunk)
+                                      : gsl::make_span(
+                                          reinterpret_cast<std::uint8_t const *>(
+                                              chunks[chunk].data()),
+                                          chunks[chunk].size() * sizeof(std::int16_t));
+                ARROW_ASSIGN_OR_RAISE(
+                    auto const row_index,
+                    m_signal_table_writer->add_pre_compressed_signal(
+                        reads.read_id[read], chunk_bytes, std::uint32_t(chunks[chunk].size())));
+                signal_rows.push_back(row_index);
+            }
+        }
+
+        auto const first_read_row = m_read_table_writer->add_reads(
+            reads,
+            gsl::make_span(signal_rows),
+            chunk_offsets,
+            signal_durations,
+            gsl::make_span(signal_statistics));
+        ARROW_RETURN_NOT_OK(first_read_row.status());
+        return flush_if_due();
+    }
+
+    arrow::Status check_reads(ReadDataColumns const & reads)
+    {
+        for (std::size_t read = 0; read < reads.size(); ++read) {
+            if (!m_read_table_dict_writers.run_info_writer->is_valid(reads.run_info[read])) {
+                return arrow::Status::Invalid("Invalid run info passed to add_reads");
+            }
+
+            if (!m_read_table_dict_writers.pore_writer->is_valid(reads.pore_type[read])) {
+                return arrow::Status::Invalid("Invalid pore type passed to add_reads");
+            }
+
+            if (!m_read_table_dict_writers.end_reason_writer->is_valid(reads.end_reason[read])) {
+                return arrow::Status::Invalid("Invalid end reason passed to add_reads");
+            }
+        }
+        return arrow::Status::OK();
+    }
+
+    /// \brief Find the pool compressing signal added in bulk, unset if signal isn't compressed.
+    /// \note A pool is made the first time if signal isn't already compressed on a pool.
+    pod5::Result<std::shared_ptr<ThreadPool>> batch_compression_thread_pool()
+    {
+        if (!m_signal_table_writer || !m_read_table_writer) {
+            return arrow::Status::Invalid("File writer closed, cannot write further data");
+        }
+        // Bulk compression is vbz only, other codecs compress as reads are added to the table:
+        if (signal_type() == SignalType::UncompressedSignal
+            || signal_type() == SignalType::CodecSignal)
+        {
+            return std::shared_ptr<ThreadPool>{};
+        }
+        if (m_compression_thread_pool) {
+            return m_compression_thread_pool;
+        }
+        if (!m_batch_compression_thread_pool) {
+            m_batch_compression_thread_pool =
+                make_thread_pool(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        return m_batch_compression_thread_pool;
     }
 
     arrow::Status check_read(ReadData const & read_data)
@@ -192,28 +697,39 @@ public:
 
     pod5::Result<std::vector<SignalTableRowIndex>> add_signal(
         Uuid const & read_id,
-        gsl::span<std::int16_t const> const & signal)
+        gsl::span<std::int16_t const> const & signal,
+        std::shared_ptr<void const> const & signal_owner = nullptr)
     {
         if (!m_signal_table_writer || !m_read_table_writer) {
             return arrow::Status::Invalid("File writer closed, cannot write further data");
         }
 
         std::vector<SignalTableRowIndex> signal_rows;
-        signal_rows.reserve((signal.size() / m_signal_chunk_size) + 1);
+        signal_rows.reserve((signal.size() / m_signal_chunker.max_chunk_size()) + 1);
 
         // Chunk and write each piece of signal to the file:
-        for (std::size_t chunk_start = 0; chunk_start < signal.size();
-             chunk_start += m_signal_chunk_size)
-        {
-            std::size_t chunk_size =
-                std::min<std::size_t>(signal.size() - chunk_start, m_signal_chunk_size);
+        std::size_t chunk_size = 0;
+        for (std::size_t chunk_start = 0; chunk_start < signal.size(); chunk_start += chunk_size) {
+            chunk_size = m_signal_chunker.next_chunk_size(signal.size() - chunk_start);
 
             auto const chunk_span = signal.subspan(chunk_start, chunk_size);
 
+            if (m_compression_thread_pool) {
+                ARROW_ASSIGN_OR_RAISE(
+                    auto row_index,
+                    queue_signal_compression(read_id, chunk_span, signal_owner));
+                signal_rows.push_back(row_index);
+                continue;
+            }
+
             ARROW_ASSIGN_OR_RAISE(
                 auto row_index, m_signal_table_writer->add_signal(read_id, chunk_span));
             signal_rows.push_back(row_index);
         }
+
+        // Write any chunks already compressed, without waiting for the rest:
+        ARROW_RETURN_NOT_OK(write_compressed_chunks(WaitMode::CompletedOnly));
+        ARROW_RETURN_NOT_OK(flush_if_due());
         return signal_rows;
     }
 
@@ -226,6 +742,7 @@ public:
             return arrow::Status::Invalid("File writer closed, cannot write further data");
         }
 
+        ARROW_RETURN_NOT_OK(write_compressed_chunks(WaitMode::All));
         return m_signal_table_writer->add_pre_compressed_signal(
             read_id, signal_bytes, sample_count);
     }
@@ -239,16 +756,64 @@ public:
             return arrow::Status::Invalid("File writer closed, cannot write further data");
         }
 
+        ARROW_RETURN_NOT_OK(write_compressed_chunks(WaitMode::All));
         return m_signal_table_writer->add_signal_batch(row_count, std::move(columns), final_batch);
     }
 
+    pod5::Result<SignalTableRowIndex> add_raw_signal_batch(
+        arrow::ipc::Message const & message,
+        std::size_t row_count)
+    {
+        if (!m_signal_table_writer || !m_read_table_writer) {
+            return arrow::Status::Invalid("File writer closed, cannot write further data");
+        }
+        if (row_count != m_signal_table_writer->table_batch_size()) {
+            return arrow::Status::Invalid(
+                "Unable to write invalid sized signal batch to signal table");
+        }
+
+        // The writer refuses the batch if rows written one by one leave a batch in progress:
+        ARROW_RETURN_NOT_OK(write_compressed_chunks(WaitMode::All));
+        auto const first_row = m_signal_table_writer->row_count();
+        ARROW_RETURN_NOT_OK(m_signal_table_writer->write_raw_batch(message, row_count));
+        ARROW_RETURN_NOT_OK(flush_if_due());
+        return first_row;
+    }
+
     SignalType signal_type() const { return m_signal_table_writer->signal_type(); }
 
+    SignalCompressionProfile const & signal_compression_profile() const
+    {
+        return m_signal_table_writer->compression_profile();
+    }
+
+    std::shared_ptr<SignalCompressionDictionary const> const & signal_compression_dictionary()
+        const
+    {
+        return m_signal_table_writer->compression_dictionary();
+    }
+
+    std::shared_ptr<SignalCodec const> const & signal_codec() const
+    {
+        return m_signal_table_writer->codec();
+    }
+
+    bool writes_signal_checksums() const { return m_signal_table_writer->writes_checksums(); }
+
+    bool writes_signal_statistics() const
+    {
+        return m_read_table_writer->writes_signal_statistics();
+    }
+
     std::size_t signal_table_batch_size() const
     {
         return m_signal_table_writer->table_batch_size();
     }
 
+    SignalChunker const & signal_chunker() const { return m_signal_chunker; }
+
+    std::size_t signal_bytes() const { return m_signal_table_writer->signal_bytes(); }
+
     pod5::Status close_run_info_table_writer()
     {
         if (m_run_info_table_writer) {
@@ -262,6 +827,12 @@ public:
     {
         if (m_read_table_writer) {
             ARROW_RETURN_NOT_OK(m_read_table_writer->close());
+            m_read_table_statistics = m_read_table_writer->statistics();
+            m_file_summary = m_read_table_writer->summary();
+            for (auto const & run_info : m_run_info_timings) {
+                m_file_summary.add_run_info(
+                    run_info.acquisition_id, run_info.acquisition_start_time, run_info.sample_rate);
+            }
             m_read_table_writer = std::nullopt;
         }
         return pod5::Status::OK();
@@ -270,14 +841,102 @@ public:
     pod5::Status close_signal_table_writer()
     {
         if (m_signal_table_writer) {
+            ARROW_RETURN_NOT_OK(write_compressed_chunks(WaitMode::All));
             ARROW_RETURN_NOT_OK(m_signal_table_writer->close());
+            m_signal_batch_locations = m_signal_table_writer->batch_locations();
             m_signal_table_writer = std::nullopt;
         }
         return pod5::Status::OK();
     }
 
+    pod5::Status close_signal_summary_writer()
+    {
+        if (m_signal_summaries.writer) {
+            ARROW_RETURN_NOT_OK(m_signal_summaries.writer->close());
+            m_signal_summaries.writer.reset();
+        }
+        return pod5::Status::OK();
+    }
+
+    /// \brief Find the file signal summaries are written to, empty if reads aren't summarised.
+    std::string const & signal_summaries_path() const { return m_signal_summaries.path; }
+
+    /// \brief Find where signal added to a closed file is staged, empty unless appending.
+    AppendedSignal const & appended_signal() const { return m_appended_signal; }
+
     virtual arrow::Status close() = 0;
 
+    void set_flush_policy(FlushPolicy && flush_policy) { m_flush_policy = std::move(flush_policy); }
+
+    /// \brief Share [writer_resources] with other writers, compressing reads added in bulk on
+    ///        [thread_pool], the writer's view of the shared compression pool.
+    void set_writer_resources(
+        std::shared_ptr<WriterResources> const & writer_resources,
+        std::shared_ptr<ThreadPool> const & thread_pool)
+    {
+        m_writer_resources = writer_resources;
+        m_batch_compression_thread_pool = thread_pool;
+    }
+
+    void set_recovery_checkpoints(RecoveryCheckpoints && recovery_checkpoints)
+    {
+        m_recovery_checkpoints = std::move(recovery_checkpoints);
+    }
+
+    void set_signal_summaries(SignalSummaries && signal_summaries)
+    {
+        m_signal_summaries = std::move(signal_summaries);
+    }
+
+    void set_appended_signal(AppendedSignal && appended_signal)
+    {
+        m_appended_signal = std::move(appended_signal);
+    }
+
+    /// \brief Start flushing output by the flush policy, if it has any limits.
+    /// \param writer_sync Held for each of the writer's calls, and taken (without waiting) to
+    ///                    flush once a deadline expires.
+    void start_flush_scheduler(std::mutex & writer_sync)
+    {
+        if (m_flush_policy.streams.empty()
+            || (m_flush_policy.max_latency.count() == 0 && m_flush_policy.max_unflushed_bytes == 0))
+        {
+            return;
+        }
+
+        m_flush_scheduler = std::make_unique<internal::FlushScheduler>(
+            m_flush_policy.max_latency,
+            m_flush_policy.max_unflushed_bytes,
+            m_flush_policy.thread_pool,
+            [this, &writer_sync] {
+                bool flushed = false;
+                {
+                    std::unique_lock<std::mutex> l(writer_sync, std::try_to_lock);
+                    if (!l.owns_lock() || is_closed()) {
+                        return false;
+                    }
+                    // An error is left for the writer's next call to find, as it flushes again:
+                    flushed = flush_output().ok();
+                }
+                // A read refused while the flush held the writer can be added now:
+                m_capacity_callback->notify();
+                return flushed;
+            });
+    }
+
+    /// \brief Stop flushing on deadlines, called with the writer held before it is closed.
+    void stop_flush_scheduler()
+    {
+        if (m_flush_scheduler) {
+            m_flush_scheduler->stop();
+        }
+    }
+
+    /// \brief Find the close started by FileWriter::close_async(), if any.
+    std::optional<arrow::Future<>> const & async_close() const { return m_async_close; }
+
+    void set_async_close(arrow::Future<> const & future) { m_async_close = future; }
+
     bool is_closed() const
     {
         assert(!!m_read_table_writer == !!m_signal_table_writer);
@@ -286,6 +945,15 @@ public:
 
     arrow::MemoryPool * pool() const { return m_pool; }
 
+    /// \brief Find the pool signal compressed in bulk is allocated from.
+    arrow::MemoryPool * compression_pool() const { return m_compression_pool; }
+
+    /// \brief Find the statistics of the read table batches, once the read table is closed.
+    ReadTableStatistics const & read_table_statistics() const { return m_read_table_statistics; }
+
+    /// \brief Find the summary of the file's reads, once the read table is closed.
+    FileSummary const & file_summary() const { return m_file_summary; }
+
     RunInfoTableWriter * run_info_table_writer()
     {
         if (is_closed() || !m_run_info_table_writer.has_value()) {
@@ -310,15 +978,367 @@ public:
         return &m_signal_table_writer.value();
     }
 
+    /// \brief Find the locations of the signal table's batches, once the table is closed.
+    std::vector<RecordBatchLocation> const & signal_batch_locations() const
+    {
+        return m_signal_batch_locations;
+    }
+
 private:
-    DictionaryWriters m_read_table_dict_writers;
+    struct RunInfoTiming {
+        std::string acquisition_id;
+        std::int64_t acquisition_start_time;
+        std::uint16_t sample_rate;
+    };
+
+    /// A chunk of signal compressing on [m_compression_thread_pool], not yet written.
+    struct PendingSignalChunk {
+        Uuid read_id;
+        std::uint32_t sample_count;
+        SignalTableRowIndex row_index;
+        std::future<arrow::Result<std::vector<std::uint8_t>>> compressed;
+        // The chunk's share of the shared pending signal budget, if the writer has one:
+        PendingSignalReservation reservation;
+    };
+
+    enum class WaitMode { CompletedOnly, All };
+
+    /// Calls the writer's capacity callback once capacity frees after a read was refused.
+    struct CapacityCallback {
+        std::mutex mutex;
+        std::function<void()> callback;
+        std::atomic<bool> refused{false};
+
+        void notify()
+        {
+            if (!refused.exchange(false)) {
+                return;
+            }
+            std::function<void()> callback_copy;
+            {
+                std::lock_guard<std::mutex> l(mutex);
+                callback_copy = callback;
+            }
+            if (callback_copy) {
+                callback_copy();
+            }
+        }
+    };
+
+    /// \brief Set whether adding a read waits on full write and compression queues, rather than
+    ///        queueing beyond their limits.
+    void set_wait_for_capacity(bool wait)
+    {
+        m_wait_for_capacity = wait;
+        for (auto const & stream : m_output_streams) {
+            stream->set_wait_for_write_capacity(wait);
+        }
+    }
+
+    arrow::Result<std::size_t> flushed_stream_bytes() const
+    {
+        std::size_t bytes = 0;
+        for (auto const & stream : m_flush_policy.streams) {
+            ARROW_ASSIGN_OR_RAISE(auto const stream_bytes, stream->Tell());
+            bytes += stream_bytes;
+        }
+        return bytes;
+    }
+
+    /// \brief Flush output once the flush policy's deadline or byte limit is reached, and record
+    ///        a recovery checkpoint once enough signal batches have been written.
+    arrow::Status flush_if_due()
+    {
+        ARROW_RETURN_NOT_OK(checkpoint_if_due());
+        if (!m_flush_scheduler) {
+            return arrow::Status::OK();
+        }
+        ARROW_ASSIGN_OR_RAISE(auto const bytes, flushed_stream_bytes());
+        if (!m_flush_scheduler->is_flush_due(bytes)) {
+            return arrow::Status::OK();
+        }
+        return flush_output();
+    }
+
+    arrow::Status checkpoint_if_due()
+    {
+        auto & signal_table_writer = *m_signal_table_writer;
+        if (!m_recovery_checkpoints.writer) {
+            // Without checkpoints there's no need to keep track of written batches:
+            if (signal_table_writer.written_batch_count() > 0) {
+                (void)signal_table_writer.take_written_batches();
+            }
+            return arrow::Status::OK();
+        }
+        if (signal_table_writer.written_batch_count() < m_recovery_checkpoints.interval) {
+            return arrow::Status::OK();
+        }
+
+        // The checkpoint can't list batches which may not reach the file before it:
+        ARROW_RETURN_NOT_OK(m_recovery_checkpoints.signal_stream->Flush());
+        auto const batches = signal_table_writer.take_written_batches();
+        return m_recovery_checkpoints.writer->write_checkpoint(gsl::make_span(batches));
+    }
+
+    /// \brief Remove the recovery checkpoints, once the file is complete.
+    arrow::Status remove_recovery_checkpoints()
+    {
+        if (!m_recovery_checkpoints.writer) {
+            return arrow::Status::OK();
+        }
+        auto writer = std::move(m_recovery_checkpoints.writer);
+        return writer->remove();
+    }
+
+    /// \brief Flush every batch written so far to the file.
+    /// \note Open batches aren't written early, as readers find signal rows by batch size.
+    arrow::Status flush_output()
+    {
+        ARROW_RETURN_NOT_OK(write_compressed_chunks(WaitMode::CompletedOnly));
+        for (auto const & stream : m_flush_policy.streams) {
+            ARROW_RETURN_NOT_OK(stream->Flush());
+        }
+        ARROW_ASSIGN_OR_RAISE(auto const bytes, flushed_stream_bytes());
+        m_flush_scheduler->flushed(bytes);
+        return arrow::Status::OK();
+    }
+
+    /// \brief Start compressing [samples] on the compression pool, finding the row it will be
+    ///        written to once every chunk queued before it is written.
+    /// \param samples_owner Keeps [samples] alive until compressed, if unset they are copied.
+    pod5::Result<SignalTableRowIndex> queue_signal_compression(
+        Uuid const & read_id,
+        gsl::span<std::int16_t const> const & samples,
+        std::shared_ptr<void const> const & samples_owner)
+    {
+        // Make room for this chunk, bounding the signal held in memory:
+        ARROW_RETURN_NOT_OK(write_compressed_chunks(WaitMode::CompletedOnly));
+        while (m_wait_for_capacity && m_pending_chunks.size() >= m_max_compression_jobs) {
+            ARROW_RETURN_NOT_OK(write_next_compressed_chunk());
+        }
+        PendingSignalReservation reservation;
+        if (m_writer_resources) {
+            // Wait on this writer's own chunks while writers sharing the budget have spent it. A
+            // writer with nothing queued goes over budget rather than waiting on the others:
+            auto const bytes = samples.size_bytes();
+            while (true) {
+                if (auto reserved = m_writer_resources->try_reserve_pending_signal(bytes)) {
+                    reservation = std::move(*reserved);
+                    break;
+                }
+                if (m_pending_chunks.empty() || !m_wait_for_capacity) {
+                    reservation = m_writer_resources->reserve_pending_signal(bytes);
+                    break;
+                }
+                ARROW_RETURN_NOT_OK(write_next_compressed_chunk());
+            }
+        }
+
+        using CompressedChunk = arrow::Result<std::vector<std::uint8_t>>;
+        auto chunk_samples = samples;
+        auto chunk_owner = samples_owner;
+        if (!chunk_owner) {
+            auto samples_copy =
+                std::make_shared<std::vector<std::int16_t>>(samples.begin(), samples.end());
+            chunk_samples = gsl::make_span(*samples_copy);
+            chunk_owner = std::move(samples_copy);
+        }
+        auto compressed = std::make_shared<std::promise<CompressedChunk>>();
+        auto const row_index = m_signal_table_writer->row_count() + m_pending_chunks.size();
+        PendingSignalChunk chunk{
+            read_id,
+            std::uint32_t(samples.size()),
+            row_index,
+            compressed->get_future(),
+            std::move(reservation)};
+
+        auto const profile = m_signal_table_writer->compression_profile();
+        auto const dictionary = m_signal_table_writer->compression_dictionary();
+        auto const codec = m_signal_table_writer->codec();
+        try {
+            m_compression_thread_pool->post(
+                [chunk_samples,
+                 chunk_owner,
+                 compressed,
+                 codec,
+                 profile,
+                 dictionary,
+                 capacity_callback = m_capacity_callback] {
+                    compressed->set_value(
+                        compress_signal_chunk(chunk_samples, *codec, profile, dictionary));
+                    capacity_callback->notify();
+                });
+        } catch (std::exception const & e) {
+            // The pool throws once stopped:
+            return arrow::Status::Invalid("Failed to queue signal compression: ", e.what());
+        }
+
+        m_pending_chunks.push_back(std::move(chunk));
+        return row_index;
+    }
+
+    /// \brief Write compressed chunks to the signal table in the order they were queued.
+    /// \param wait_mode Whether to wait for every queued chunk, or stop at the first still
+    ///                  compressing.
+    arrow::Status write_compressed_chunks(WaitMode wait_mode)
+    {
+        while (!m_pending_chunks.empty()) {
+            if (wait_mode == WaitMode::CompletedOnly
+                && m_pending_chunks.front().compressed.wait_for(std::chrono::seconds(0))
+                       != std::future_status::ready)
+            {
+                break;
+            }
+            ARROW_RETURN_NOT_OK(write_next_compressed_chunk());
+        }
+        return arrow::Status::OK();
+    }
+
+    arrow::Status write_next_compressed_chunk()
+    {
+        auto chunk = std::move(m_pending_chunks.front());
+        m_pending_chunks.pop_front();
+
+        ARROW_ASSIGN_OR_RAISE(auto const compressed, chunk.compressed.get());
+        ARROW_ASSIGN_OR_RAISE(
+            auto const row_index,
+            m_signal_table_writer->add_pre_compressed_signal(
+                chunk.read_id, gsl::make_span(compressed), chunk.sample_count));
+        if (row_index != chunk.row_index) {
+            return arrow::Status::Invalid(
+                "Compressed signal written to row ", row_index, ", expected ", chunk.row_index);
+        }
+        return arrow::Status::OK();
+    }
+
+    // Declared first, so it outlives the buffers allocated from it by the other members:
+    std::shared_ptr<RecyclingMemoryPool> m_recycling_pool;
+    DictionaryWriters m_read_table_dict_writers;
     std::optional<RunInfoTableWriter> m_run_info_table_writer;
     std::optional<ReadTableWriter> m_read_table_writer;
+    ReadTableStatistics m_read_table_statistics;
+    std::vector<RunInfoTiming> m_run_info_timings;
+    FileSummary m_file_summary;
     std::optional<SignalTableWriter> m_signal_table_writer;
-    std::uint32_t m_signal_chunk_size;
+    std::vector<RecordBatchLocation> m_signal_batch_locations;
+    SignalChunker m_signal_chunker;
+    // Set when signal is compressed on a pool, with up to [m_max_compression_jobs] chunks queued:
+    std::shared_ptr<ThreadPool> m_compression_thread_pool;
+    std::size_t m_max_compression_jobs;
+    std::deque<PendingSignalChunk> m_pending_chunks;
+    // Made by the first bulk add when [m_compression_thread_pool] is unset:
+    std::shared_ptr<ThreadPool> m_batch_compression_thread_pool;
+    // Set when threads, IO and a pending signal budget are shared with other writers:
+    std::shared_ptr<WriterResources> m_writer_resources;
+    // The files writes are queued to, and whether adding reads waits while their queues are full:
+    std::vector<std::shared_ptr<FileOutputStream>> m_output_streams;
+    bool m_wait_for_capacity = true;
+    std::shared_ptr<CapacityCallback> m_capacity_callback = std::make_shared<CapacityCallback>();
+    FlushPolicy m_flush_policy;
+    RecoveryCheckpoints m_recovery_checkpoints;
+    SignalSummaries m_signal_summaries;
+    AppendedSignal m_appended_signal;
+    // Set when the flush policy has limits, once the writer is made:
+    std::unique_ptr<internal::FlushScheduler> m_flush_scheduler;
+    // Set once the writer is closing on a thread pool:
+    std::optional<arrow::Future<>> m_async_close;
     arrow::MemoryPool * m_pool;
+    arrow::MemoryPool * m_compression_pool;
+};
+
+namespace {
+
+/// Which of the optional indexes a writer embeds in the file as it is closed, see
+/// FileWriterOptions::set_write_read_id_index and the options after it.
+struct IndexSelection {
+    bool read_id_index = false;
+    bool read_id_filter = false;
+    bool read_table_statistics = false;
+    bool file_summary = false;
+    bool signal_row_index = false;
+
+    bool any() const
+    {
+        return read_id_index || read_id_filter || read_table_statistics || file_summary
+               || signal_row_index;
+    }
+};
+
+/// The serialised indexes embedded in a file, each unset unless selected.
+struct IndexData {
+    std::shared_ptr<arrow::Buffer> index;
+    std::shared_ptr<arrow::Buffer> filter;
+    std::shared_ptr<arrow::Buffer> statistics;
+    std::shared_ptr<arrow::Buffer> summary;
+    std::shared_ptr<arrow::Buffer> signal_row_index;
 };
 
+/// Build the [selection] of indexes for a closed writer's file.
+/// \param reads_file The file's complete read table.
+/// \param signal_file The file's complete signal table, only read for the signal row index.
+/// \param signal_bytes The length of the signal table in the file.
+/// \param sorted_read_table_statistics The statistics of the read table, if it was sorted after
+///        it was written.
+arrow::Result<IndexData> build_indexes(
+    FileWriterImpl const & writer,
+    IndexSelection const & selection,
+    std::shared_ptr<arrow::io::RandomAccessFile> const & reads_file,
+    std::shared_ptr<arrow::io::RandomAccessFile> const & signal_file,
+    std::int64_t signal_bytes,
+    std::optional<ReadTableStatistics> const & sorted_read_table_statistics)
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto read_table_reader, make_read_table_reader(reads_file, writer.pool()));
+    auto const & metadata = read_table_reader.reader()->schema()->metadata();
+
+    IndexData result;
+    if (selection.read_id_index || selection.read_id_filter) {
+        ARROW_RETURN_NOT_OK(read_table_reader.build_read_id_lookup());
+        auto const & read_id_index = read_table_reader.read_id_index();
+        if (selection.read_id_index) {
+            ARROW_ASSIGN_OR_RAISE(result.index, read_id_index->write(metadata, writer.pool()));
+        }
+        if (selection.read_id_filter) {
+            ARROW_ASSIGN_OR_RAISE(auto filter, ReadIdFilter::build(read_id_index->read_ids()));
+            ARROW_ASSIGN_OR_RAISE(result.filter, filter->write(metadata, writer.pool()));
+        }
+    }
+    if (selection.read_table_statistics) {
+        // Sorting moves rows between batches, so the statistics gathered as the table was
+        // written no longer describe it:
+        auto const & statistics = sorted_read_table_statistics
+                                      ? *sorted_read_table_statistics
+                                      : writer.read_table_statistics();
+        ARROW_ASSIGN_OR_RAISE(result.statistics, statistics.write(metadata, writer.pool()));
+    }
+    if (selection.file_summary) {
+        auto summary = writer.file_summary();
+        summary.set_signal_bytes(signal_bytes);
+        ARROW_ASSIGN_OR_RAISE(result.summary, summary.write(metadata, writer.pool()));
+    }
+    if (selection.signal_row_index) {
+        ARROW_ASSIGN_OR_RAISE(auto index, SignalRowIndex::build(signal_file, writer.pool()));
+        ARROW_ASSIGN_OR_RAISE(result.signal_row_index, index->write(metadata, writer.pool()));
+    }
+    return result;
+}
+
+/// Write the read table in [reads_file] to [sink] sorted by read id.
+/// \returns The statistics of the sorted table.
+arrow::Result<ReadTableStatistics> write_sorted_read_table(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & reads_file,
+    std::shared_ptr<arrow::io::OutputStream> const & sink,
+    std::size_t read_table_batch_size,
+    arrow::MemoryPool * pool,
+    arrow::Compression::type table_compression)
+{
+    ARROW_ASSIGN_OR_RAISE(auto read_table_reader, make_read_table_reader(reads_file, pool));
+    return write_read_table_sorted_by_read_id(
+        read_table_reader, sink, read_table_batch_size, pool, table_compression);
+}
+
+}  // namespace
+
 class CombinedFileWriterImpl : public FileWriterImpl {
 public:
     CombinedFileWriterImpl(
@@ -329,19 +1349,31 @@ public:
         Uuid const & section_marker,
         Uuid const & file_identifier,
         std::string const & software_name,
+        IndexSelection const & indexes,
+        bool sort_read_table_by_read_id,
+        std::size_t read_table_batch_size,
+        arrow::Compression::type table_compression,
         DictionaryWriters && dict_writers,
         RunInfoTableWriter && run_info_table_writer,
         ReadTableWriter && read_table_writer,
         SignalTableWriter && signal_table_writer,
-        std::uint32_t signal_chunk_size,
-        arrow::MemoryPool * pool)
+        SignalChunker signal_chunker,
+        std::shared_ptr<ThreadPool> const & compression_thread_pool,
+        std::size_t max_compression_jobs,
+        std::shared_ptr<RecyclingMemoryPool> const & recycling_pool,
+        arrow::MemoryPool * pool,
+        arrow::MemoryPool * compression_pool)
     : FileWriterImpl(
         std::move(dict_writers),
         std::move(run_info_table_writer),
         std::move(read_table_writer),
         std::move(signal_table_writer),
-        signal_chunk_size,
-        pool)
+        std::move(signal_chunker),
+        compression_thread_pool,
+        max_compression_jobs,
+        recycling_pool,
+        pool,
+        compression_pool)
     , m_path(path)
     , m_run_info_tmp_path(run_info_tmp_path)
     , m_reads_tmp_path(reads_tmp_path)
@@ -349,6 +1381,10 @@ public:
     , m_section_marker(section_marker)
     , m_file_identifier(file_identifier)
     , m_software_name(software_name)
+    , m_indexes(indexes)
+    , m_sort_read_table_by_read_id(sort_read_table_by_read_id)
+    , m_read_table_batch_size(read_table_batch_size)
+    , m_table_compression(table_compression)
     {
     }
 
@@ -362,15 +1398,30 @@ public:
         ARROW_RETURN_NOT_OK(close_run_info_table_writer());
         ARROW_RETURN_NOT_OK(close_read_table_writer());
         ARROW_RETURN_NOT_OK(close_signal_table_writer());
+        ARROW_RETURN_NOT_OK(close_signal_summary_writer());
+
+        // The unsorted read table is kept until the sorted one is in the main file, so the file
+        // can still be recovered until then:
+        std::optional<std::string> unsorted_reads_tmp_path;
+        if (m_sort_read_table_by_read_id) {
+            unsorted_reads_tmp_path = m_reads_tmp_path;
+            ARROW_RETURN_NOT_OK(sort_read_table());
+        }
+
+        // A file appended to is only cut back to its signal batches now the new tables are
+        // complete, so it stays readable until then:
+        ARROW_RETURN_NOT_OK(move_in_appended_signal());
 
-        // Open main path with append set:
-        ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::FileOutputStream::Open(m_path, true));
+        // Open main path to append the other tables:
+        ARROW_ASSIGN_OR_RAISE(auto file, combined_file_utils::open_file_for_append(m_path));
 
         // Record signal table length:
         combined_file_utils::FileInfo signal_table;
         signal_table.file_start_offset = m_signal_file_start_offset;
         ARROW_ASSIGN_OR_RAISE(signal_table.file_length, file->Tell());
         signal_table.file_length -= signal_table.file_start_offset;
+        // List the signal batches in the footer, so readers needn't parse the table's own:
+        signal_table.batch_locations = signal_batch_locations();
 
         // pad file to 8 bytes and mark section:
         ARROW_RETURN_NOT_OK(combined_file_utils::pad_file(file, 8));
@@ -395,6 +1446,31 @@ public:
                 combined_file_utils::SubFileCleanup::CleanupOriginalFile,
                 m_section_marker));
 
+        // Index the read table before it is moved into the main file:
+        IndexData index_data;
+        if (m_indexes.any()) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto reads_file, arrow::io::ReadableFile::Open(m_reads_tmp_path, pool()));
+            // The signal table is complete in the main file by now, so the signal row index
+            // reads its samples column back from there:
+            std::shared_ptr<arrow::io::RandomAccessFile> signal_file;
+            if (m_indexes.signal_row_index) {
+                ARROW_ASSIGN_OR_RAISE(
+                    auto main_file, arrow::io::ReadableFile::Open(m_path, pool()));
+                signal_file = std::make_shared<combined_file_utils::SubFile>(
+                    main_file, signal_table.file_start_offset, signal_table.file_length);
+            }
+            ARROW_ASSIGN_OR_RAISE(
+                index_data,
+                build_indexes(
+                    *this,
+                    m_indexes,
+                    reads_file,
+                    signal_file,
+                    signal_table.file_length,
+                    m_sorted_read_table_statistics));
+        }
+
         // Write in read table:
         ARROW_ASSIGN_OR_RAISE(auto reads_location, file_location_for_full_file(m_reads_tmp_path));
         ARROW_ASSIGN_OR_RAISE(
@@ -405,6 +1481,53 @@ public:
                 reads_location,
                 combined_file_utils::SubFileCleanup::CleanupOriginalFile,
                 m_section_marker));
+        if (unsorted_reads_tmp_path) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto unsorted_reads_file,
+                ::arrow::internal::PlatformFilename::FromString(*unsorted_reads_tmp_path));
+            ARROW_RETURN_NOT_OK(arrow::internal::DeleteFile(unsorted_reads_file));
+        }
+
+        // Write in read id index, filter, read table statistics, file summary and signal row
+        // index:
+        std::optional<combined_file_utils::FileInfo> read_id_index_table;
+        if (index_data.index) {
+            ARROW_ASSIGN_OR_RAISE(
+                read_id_index_table,
+                combined_file_utils::write_buffer_and_marker(
+                    file, index_data.index, m_section_marker));
+        }
+        std::vector<combined_file_utils::FileInfo> other_index_tables;
+        for (auto const & other_index :
+             {index_data.filter,
+              index_data.statistics,
+              index_data.summary,
+              index_data.signal_row_index})
+        {
+            if (!other_index) {
+                continue;
+            }
+            ARROW_ASSIGN_OR_RAISE(
+                auto other_index_table,
+                combined_file_utils::write_buffer_and_marker(file, other_index, m_section_marker));
+            other_index_tables.push_back(other_index_table);
+        }
+
+        // Write in the signal summaries, kept beside the file as reads were added:
+        if (!signal_summaries_path().empty()) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto signal_summaries_location,
+                file_location_for_full_file(signal_summaries_path()));
+            ARROW_ASSIGN_OR_RAISE(
+                auto signal_summaries_table,
+                combined_file_utils::write_file_and_marker(
+                    pool(),
+                    file,
+                    signal_summaries_location,
+                    combined_file_utils::SubFileCleanup::CleanupOriginalFile,
+                    m_section_marker));
+            other_index_tables.push_back(signal_summaries_table);
+        }
 
         // Write full file footer:
         ARROW_RETURN_NOT_OK(combined_file_utils::write_footer(
@@ -414,11 +1537,60 @@ public:
             m_software_name,
             signal_table,
             run_info_info_table,
-            reads_info_table));
-        return arrow::Status::OK();
+            reads_info_table,
+            read_id_index_table,
+            other_index_tables));
+        return remove_recovery_checkpoints();
     }
 
 private:
+    // Truncate a file appended to where its signal batches end, and copy the signal staged since
+    // the writer was opened in after them.
+    arrow::Status move_in_appended_signal()
+    {
+        auto const & staged = appended_signal();
+        if (staged.staging_path.empty()) {
+            return arrow::Status::OK();
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto file, combined_file_utils::open_file_for_append(m_path));
+        ARROW_RETURN_NOT_OK(
+            arrow::internal::FileTruncate(file->file_descriptor(), staged.batches_end));
+        ARROW_RETURN_NOT_OK(arrow::internal::FileSeek(file->file_descriptor(), staged.batches_end));
+
+        ARROW_ASSIGN_OR_RAISE(
+            auto staged_file, arrow::io::ReadableFile::Open(staged.staging_path, pool()));
+        ARROW_ASSIGN_OR_RAISE(auto const staged_size, staged_file->GetSize());
+        ARROW_RETURN_NOT_OK(staged_file->Close());
+        auto const signal_table = combined_file_utils::write_file(
+            pool(),
+            file,
+            FileLocation{staged.staging_path, 0, std::size_t(staged_size)},
+            combined_file_utils::SubFileCleanup::CleanupOriginalFile);
+        ARROW_RETURN_NOT_OK(signal_table.status());
+        return file->Close();
+    }
+
+    // Rewrite the read table sorted by read id, alongside the unsorted table, and read the table
+    // from there from now on:
+    arrow::Status sort_read_table()
+    {
+        auto const sorted_reads_tmp_path = m_reads_tmp_path + "-sorted";
+        {
+            ARROW_ASSIGN_OR_RAISE(
+                auto reads_file, arrow::io::ReadableFile::Open(m_reads_tmp_path, pool()));
+            ARROW_ASSIGN_OR_RAISE(
+                auto sorted_file, arrow::io::FileOutputStream::Open(sorted_reads_tmp_path, false));
+            ARROW_ASSIGN_OR_RAISE(
+                m_sorted_read_table_statistics,
+                write_sorted_read_table(
+                    reads_file, sorted_file, m_read_table_batch_size, pool(), m_table_compression));
+            ARROW_RETURN_NOT_OK(sorted_file->Close());
+        }
+        m_reads_tmp_path = sorted_reads_tmp_path;
+        return arrow::Status::OK();
+    }
+
     std::string m_path;
     std::string m_run_info_tmp_path;
     std::string m_reads_tmp_path;
@@ -426,76 +1598,572 @@ private:
     Uuid m_section_marker;
     Uuid m_file_identifier;
     std::string m_software_name;
+    IndexSelection m_indexes;
+    bool m_sort_read_table_by_read_id;
+    std::size_t m_read_table_batch_size;
+    arrow::Compression::type m_table_compression;
+    std::optional<ReadTableStatistics> m_sorted_read_table_statistics;
 };
 
-FileWriter::FileWriter(std::unique_ptr<FileWriterImpl> && impl) : m_impl(std::move(impl)) {}
+/// Writes a file to a stream: its signal table as reads are added, then the tables held in memory
+/// until the writer is closed.
+class StreamFileWriterImpl : public FileWriterImpl {
+public:
+    /// The tables held in memory until the file is closed.
+    struct TableBuffers {
+        std::shared_ptr<arrow::io::BufferOutputStream> run_info;
+        std::shared_ptr<arrow::io::BufferOutputStream> reads;
+        // Unset unless reads are summarised:
+        std::shared_ptr<arrow::io::BufferOutputStream> signal_summaries;
+    };
+
+    StreamFileWriterImpl(
+        std::shared_ptr<FileOutputStream> const & sink,
+        TableBuffers && table_buffers,
+        std::int64_t signal_file_start_offset,
+        Uuid const & section_marker,
+        Uuid const & file_identifier,
+        std::string const & software_name,
+        IndexSelection const & indexes,
+        bool sort_read_table_by_read_id,
+        std::size_t read_table_batch_size,
+        arrow::Compression::type table_compression,
+        DictionaryWriters && dict_writers,
+        RunInfoTableWriter && run_info_table_writer,
+        ReadTableWriter && read_table_writer,
+        SignalTableWriter && signal_table_writer,
+        SignalChunker signal_chunker,
+        std::shared_ptr<ThreadPool> const & compression_thread_pool,
+        std::size_t max_compression_jobs,
+        std::shared_ptr<RecyclingMemoryPool> const & recycling_pool,
+        arrow::MemoryPool * pool,
+        arrow::MemoryPool * compression_pool)
+    : FileWriterImpl(
+        std::move(dict_writers),
+        std::move(run_info_table_writer),
+        std::move(read_table_writer),
+        std::move(signal_table_writer),
+        std::move(signal_chunker),
+        compression_thread_pool,
+        max_compression_jobs,
+        recycling_pool,
+        pool,
+        compression_pool)
+    , m_sink(sink)
+    , m_table_buffers(std::move(table_buffers))
+    , m_signal_file_start_offset(signal_file_start_offset)
+    , m_section_marker(section_marker)
+    , m_file_identifier(file_identifier)
+    , m_software_name(software_name)
+    , m_indexes(indexes)
+    , m_sort_read_table_by_read_id(sort_read_table_by_read_id)
+    , m_read_table_batch_size(read_table_batch_size)
+    , m_table_compression(table_compression)
+    {
+    }
 
-FileWriter::~FileWriter() { (void)close(); }
+    std::string path() const override { return {}; }
 
-std::string FileWriter::path() const { return m_impl->path(); }
+    arrow::Status close() override
+    {
+        if (is_closed()) {
+            return arrow::Status::OK();
+        }
+        ARROW_RETURN_NOT_OK(close_run_info_table_writer());
+        ARROW_RETURN_NOT_OK(close_read_table_writer());
+        ARROW_RETURN_NOT_OK(close_signal_table_writer());
+        ARROW_RETURN_NOT_OK(close_signal_summary_writer());
 
-arrow::Status FileWriter::close() { return m_impl->close(); }
+        // Positions are in the whole file from here on:
+        ARROW_ASSIGN_OR_RAISE(auto const signal_table_end, m_sink->Tell());
+        m_sink->set_file_start_offset(0);
 
-arrow::Status FileWriter::add_complete_read(
-    ReadData const & read_data,
-    gsl::span<std::int16_t const> const & signal)
+        combined_file_utils::FileInfo signal_table;
+        signal_table.file_start_offset = m_signal_file_start_offset;
+        signal_table.file_length = signal_table_end;
+        signal_table.batch_locations = signal_batch_locations();
+
+        ARROW_RETURN_NOT_OK(combined_file_utils::pad_file(m_sink, 8));
+        ARROW_RETURN_NOT_OK(combined_file_utils::write_section_marker(m_sink, m_section_marker));
+
+        ARROW_ASSIGN_OR_RAISE(auto const run_info_buffer, m_table_buffers.run_info->Finish());
+        ARROW_ASSIGN_OR_RAISE(
+            auto const run_info_table,
+            combined_file_utils::write_buffer_and_marker(
+                m_sink, run_info_buffer, m_section_marker));
+
+        ARROW_ASSIGN_OR_RAISE(auto reads_buffer, m_table_buffers.reads->Finish());
+        std::optional<ReadTableStatistics> sorted_read_table_statistics;
+        if (m_sort_read_table_by_read_id) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto sorted_reads, arrow::io::BufferOutputStream::Create(0, pool()));
+            ARROW_ASSIGN_OR_RAISE(
+                sorted_read_table_statistics,
+                write_sorted_read_table(
+                    std::make_shared<arrow::io::BufferReader>(reads_buffer),
+                    sorted_reads,
+                    m_read_table_batch_size,
+                    pool(),
+                    m_table_compression));
+            ARROW_ASSIGN_OR_RAISE(reads_buffer, sorted_reads->Finish());
+        }
+
+        // The signal table has been streamed out, so it can't be read back for the signal row
+        // index, which isn't selected here:
+        IndexData index_data;
+        if (m_indexes.any()) {
+            ARROW_ASSIGN_OR_RAISE(
+                index_data,
+                build_indexes(
+                    *this,
+                    m_indexes,
+                    std::make_shared<arrow::io::BufferReader>(reads_buffer),
+                    nullptr,
+                    signal_table.file_length,
+                    sorted_read_table_statistics));
+        }
+
+        ARROW_ASSIGN_OR_RAISE(
+            auto const reads_table,
+            combined_file_utils::write_buffer_and_marker(m_sink, reads_buffer, m_section_marker));
+        reads_buffer.reset();
+
+        std::optional<combined_file_utils::FileInfo> read_id_index_table;
+        if (index_data.index) {
+            ARROW_ASSIGN_OR_RAISE(
+                read_id_index_table,
+                combined_file_utils::write_buffer_and_marker(
+                    m_sink, index_data.index, m_section_marker));
+        }
+        std::vector<combined_file_utils::FileInfo> other_index_tables;
+        for (auto const & other_index :
+             {index_data.filter, index_data.statistics, index_data.summary})
+        {
+            if (!other_index) {
+                continue;
+            }
+            ARROW_ASSIGN_OR_RAISE(
+                auto other_index_table,
+                combined_file_utils::write_buffer_and_marker(
+                    m_sink, other_index, m_section_marker));
+            other_index_tables.push_back(other_index_table);
+        }
+        if (m_table_buffers.signal_summaries) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto const signal_summaries_buffer, m_table_buffers.signal_summaries->Finish());
+            ARROW_ASSIGN_OR_RAISE(
+                auto signal_summaries_table,
+                combined_file_utils::write_buffer_and_marker(
+                    m_sink, signal_summaries_buffer, m_section_marker));
+            other_index_tables.push_back(signal_summaries_table);
+        }
+
+        ARROW_RETURN_NOT_OK(combined_file_utils::write_footer(
+            m_sink,
+            m_section_marker,
+            m_file_identifier,
+            m_software_name,
+            signal_table,
+            run_info_table,
+            reads_table,
+            read_id_index_table,
+            other_index_tables));
+        return m_sink->Close();
+    }
+
+private:
+    std::shared_ptr<FileOutputStream> m_sink;
+    TableBuffers m_table_buffers;
+    std::int64_t m_signal_file_start_offset;
+    Uuid m_section_marker;
+    Uuid m_file_identifier;
+    std::string m_software_name;
+    IndexSelection m_indexes;
+    bool m_sort_read_table_by_read_id;
+    std::size_t m_read_table_batch_size;
+    arrow::Compression::type m_table_compression;
+};
+
+FileWriter::FileWriter(std::unique_ptr<FileWriterImpl> && impl)
+: m_impl(std::move(impl))
+, m_sync(std::make_shared<std::mutex>())
 {
-    return m_impl->add_complete_read(read_data, signal);
+    m_impl->start_flush_scheduler(*m_sync);
 }
 
-arrow::Status FileWriter::add_complete_read(
-    ReadData const & read_data,
-    gsl::span<std::uint64_t const> const & signal_rows,
-    std::uint64_t signal_duration)
+FileWriter::~FileWriter()
 {
-    return m_impl->add_complete_read(read_data, signal_rows, signal_duration);
+    {
+        // A writer closing on a thread pool finishes there, holding its own references:
+        std::lock_guard<std::mutex> l(*m_sync);
+        if (m_impl->async_close()) {
+            return;
+        }
+    }
+    (void)close();
 }
 
-pod5::Result<std::vector<SignalTableRowIndex>> FileWriter::add_signal(
-    Uuid const & read_id,
-    gsl::span<std::int16_t const> const & signal)
+std::string FileWriter::path() const { return m_impl->path(); }
+
+arrow::Status FileWriter::close()
 {
-    return m_impl->add_signal(read_id, signal);
+    std::optional<arrow::Future<>> async_close;
+    {
+        std::lock_guard<std::mutex> l(*m_sync);
+        async_close = m_impl->async_close();
+        if (!async_close) {
+            m_impl->stop_flush_scheduler();
+            return m_impl->close();
+        }
+    }
+    return async_close->status();
 }
 
-pod5::Result<SignalTableRowIndex> FileWriter::add_pre_compressed_signal(
-    Uuid const & read_id,
-    gsl::span<std::uint8_t const> const & signal_bytes,
-    std::uint32_t sample_count)
+arrow::Future<> FileWriter::close_async(ThreadPool & thread_pool)
 {
-    return m_impl->add_pre_compressed_signal(read_id, signal_bytes, sample_count);
+    std::lock_guard<std::mutex> l(*m_sync);
+    if (auto const & async_close = m_impl->async_close()) {
+        return *async_close;
+    }
+
+    auto future = arrow::Future<>::Make();
+    try {
+        thread_pool.post([future, impl = m_impl, sync = m_sync]() mutable {
+            pod5::Status status;
+            {
+                std::lock_guard<std::mutex> l(*sync);
+                status = impl->close();
+            }
+            // Finished outside the lock, so callbacks on the future can use the writer:
+            future.MarkFinished(std::move(status));
+        });
+    } catch (std::exception const & e) {
+        // The pool throws once stopped, the writer is left open to be closed in place:
+        future.MarkFinished(Status::Invalid("Failed to queue close: ", e.what()));
+        return future;
+    }
+    // The close waits on the lock held here, so is found by any later call before it starts:
+    m_impl->stop_flush_scheduler();
+    m_impl->set_async_close(future);
+    return future;
 }
 
-pod5::Result<std::pair<SignalTableRowIndex, SignalTableRowIndex>> FileWriter::add_signal_batch(
-    std::size_t row_count,
-    std::vector<std::shared_ptr<arrow::Array>> && columns,
-    bool final_batch)
+arrow::Status FileWriter::add_complete_read(
+    ReadData const & read_data,
+    gsl::span<std::int16_t const> const & signal)
 {
-    return m_impl->add_signal_batch(row_count, std::move(columns), final_batch);
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_complete_read(read_data, signal);
 }
 
-pod5::Result<EndReasonDictionaryIndex> FileWriter::lookup_end_reason(ReadEndReason end_reason) const
+pod5::Result<bool> FileWriter::try_add_complete_read(
+    ReadData const & read_data,
+    gsl::span<std::int16_t const> const & signal)
 {
-    return m_impl->lookup_end_reason(end_reason);
+    std::unique_lock<std::mutex> l(*m_sync, std::try_to_lock);
+    if (!l.owns_lock()) {
+        return false;
+    }
+    return m_impl->try_add_complete_read(read_data, signal);
 }
 
-pod5::Result<PoreDictionaryIndex> FileWriter::add_pore_type(std::string const & pore_type_data)
+bool FileWriter::has_write_capacity() const
 {
-    return m_impl->add_pore_type(pore_type_data);
+    std::unique_lock<std::mutex> l(*m_sync, std::try_to_lock);
+    return l.owns_lock() && !m_impl->is_closed() && m_impl->has_write_capacity();
 }
 
-pod5::Result<RunInfoDictionaryIndex> FileWriter::add_run_info(RunInfoData const & run_info_data)
+void FileWriter::set_write_capacity_callback(std::function<void()> callback)
 {
-    return m_impl->add_run_info(run_info_data);
+    m_impl->set_write_capacity_callback(std::move(callback));
+}
+
+arrow::Status FileWriter::add_complete_read(
+    ReadData const & read_data,
+    std::shared_ptr<arrow::Buffer> const & signal)
+{
+    if (!signal) {
+        return arrow::Status::Invalid("Signal buffer must be set");
+    }
+    if (signal->size() % sizeof(std::int16_t) != 0) {
+        return arrow::Status::Invalid(
+            "Signal buffer of ", signal->size(), " bytes is not a whole number of samples");
+    }
+
+    auto const samples = gsl::make_span(
+        reinterpret_cast<std::int16_t const *>(signal->data()),
+        signal->size() / sizeof(std::int16_t));
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_complete_read(read_data, samples, signal);
+}
+
+arrow::Status FileWriter::add_complete_read(
+    ReadData const & read_data,
+    std::vector<std::int16_t> && signal)
+{
+    auto const owned_signal = std::make_shared<std::vector<std::int16_t>>(std::move(signal));
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_complete_read(read_data, gsl::make_span(*owned_signal), owned_signal);
+}
+
+arrow::Status FileWriter::add_complete_read(
+    ReadData const & read_data,
+    gsl::span<std::uint64_t const> const & signal_rows,
+    std::uint64_t signal_duration)
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_complete_read(read_data, signal_rows, signal_duration);
+}
+
+arrow::Status FileWriter::add_reads(
+    ReadDataColumns const & reads,
+    gsl::span<gsl::span<std::int16_t const> const> const & signals)
+{
+    if (!reads.has_consistent_sizes() || signals.size() != reads.size()) {
+        return arrow::Status::Invalid("Read columns passed to add_reads differ in length");
+    }
+
+    // Split every read's signal into chunks, so they can all be compressed at once:
+    auto const & chunker = m_impl->signal_chunker();
+    std::vector<gsl::span<std::int16_t const>> chunks;
+    std::vector<std::size_t> chunk_offsets{0};
+    std::vector<std::uint64_t> signal_durations;
+    chunk_offsets.reserve(reads.size() + 1);
+    signal_durations.reserve(reads.size());
+    for (auto const & signal : signals) {
+        std::size_t chunk_size = 0;
+        for (std::size_t chunk_start = 0; chunk_start < signal.size(); chunk_start += chunk_size) {
+            chunk_size = chunker.next_chunk_size(signal.size() - chunk_start);
+            chunks.push_back(signal.subspan(chunk_start, chunk_size));
+        }
+        chunk_offsets.push_back(chunks.size());
+        signal_durations.push_back(signal.size());
+    }
+
+    std::shared_ptr<ThreadPool> thread_pool;
+    SignalCompressionProfile profile;
+    std::shared_ptr<SignalCompressionDictionary const> dictionary;
+    {
+        std::lock_guard<std::mutex> l(*m_sync);
+        ARROW_ASSIGN_OR_RAISE(thread_pool, m_impl->batch_compression_thread_pool());
+        if (thread_pool) {
+            profile = m_impl->signal_compression_profile();
+            dictionary = m_impl->signal_compression_dictionary();
+        }
+    }
+
+    // Compress outside the writer's lock, so other threads can keep adding reads:
+    std::optional<CompressedSignalBatch> compressed_chunks;
+    if (thread_pool) {
+        ARROW_ASSIGN_OR_RAISE(
+            compressed_chunks,
+            compress_signal_batch(
+                gsl::make_span(chunks),
+                *thread_pool,
+                m_impl->compression_pool(),
+                profile,
+                dictionary));
+    }
+
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_reads(
+        reads,
+        gsl::make_span(chunks),
+        compressed_chunks ? &*compressed_chunks : nullptr,
+        gsl::make_span(chunk_offsets),
+        gsl::make_span(signal_durations));
+}
+
+pod5::Result<std::vector<SignalTableRowIndex>> FileWriter::add_signal(
+    Uuid const & read_id,
+    gsl::span<std::int16_t const> const & signal)
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_signal(read_id, signal);
+}
+
+pod5::Result<SignalTableRowIndex> FileWriter::add_pre_compressed_signal(
+    Uuid const & read_id,
+    gsl::span<std::uint8_t const> const & signal_bytes,
+    std::uint32_t sample_count)
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_pre_compressed_signal(read_id, signal_bytes, sample_count);
+}
+
+pod5::Result<std::pair<SignalTableRowIndex, SignalTableRowIndex>> FileWriter::add_signal_batch(
+    std::size_t row_count,
+    std::vector<std::shared_ptr<arrow::Array>> && columns,
+    bool final_batch)
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_signal_batch(row_count, std::move(columns), final_batch);
+}
+
+pod5::Result<SignalTableRowIndex> FileWriter::add_raw_signal_batch(
+    arrow::ipc::Message const & message,
+    std::size_t row_count)
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_raw_signal_batch(message, row_count);
+}
+
+pod5::Result<EndReasonDictionaryIndex> FileWriter::lookup_end_reason(ReadEndReason end_reason) const
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->lookup_end_reason(end_reason);
+}
+
+pod5::Result<PoreDictionaryIndex> FileWriter::add_pore_type(std::string const & pore_type_data)
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_pore_type(pore_type_data);
+}
+
+pod5::Result<RunInfoDictionaryIndex> FileWriter::add_run_info(RunInfoData const & run_info_data)
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->add_run_info(run_info_data);
+}
+
+SignalType FileWriter::signal_type() const { return m_impl->signal_type(); }
+
+SignalCompressionProfile const & FileWriter::signal_compression_profile() const
+{
+    return m_impl->signal_compression_profile();
+}
+
+std::shared_ptr<SignalCompressionDictionary const> const &
+FileWriter::signal_compression_dictionary() const
+{
+    return m_impl->signal_compression_dictionary();
+}
+
+bool FileWriter::writes_signal_checksums() const { return m_impl->writes_signal_checksums(); }
+
+std::size_t FileWriter::signal_bytes() const
+{
+    std::lock_guard<std::mutex> l(*m_sync);
+    return m_impl->signal_bytes();
 }
 
-SignalType FileWriter::signal_type() const { return m_impl->signal_type(); }
-
 std::size_t FileWriter::signal_table_batch_size() const
 {
     return m_impl->signal_table_batch_size();
 }
 
+std::unique_ptr<FileWriterProducer> FileWriter::create_producer(std::size_t max_pending_reads)
+{
+    return std::unique_ptr<FileWriterProducer>(new FileWriterProducer(*this, max_pending_reads));
+}
+
+FileWriterProducer::FileWriterProducer(FileWriter & writer, std::size_t max_pending_reads)
+: m_writer(writer)
+, m_max_pending_reads(std::max<std::size_t>(1, max_pending_reads))
+, m_signal_type(writer.m_impl->signal_type())
+, m_compression_profile(writer.m_impl->signal_compression_profile())
+, m_compression_dictionary(writer.m_impl->signal_compression_dictionary())
+, m_codec(writer.m_impl->signal_codec())
+, m_signal_chunker(writer.m_impl->signal_chunker())
+, m_write_signal_statistics(writer.m_impl->writes_signal_statistics())
+, m_chunk_offsets{0}
+{
+}
+
+FileWriterProducer::~FileWriterProducer()
+{
+    assert(m_reads.empty() && "FileWriterProducer destroyed before its reads were flushed");
+}
+
+arrow::Status FileWriterProducer::add_complete_read(
+    ReadData const & read_data,
+    gsl::span<std::int16_t const> const & signal)
+{
+    auto & context = thread_local_signal_compression_context();
+    context.set_profile(m_compression_profile);
+    context.set_dictionary(m_compression_dictionary);
+
+    // Compress the read's chunks outside the writer's lock:
+    std::size_t chunk_count = 0;
+    std::size_t chunk_size = 0;
+    for (std::size_t chunk_start = 0; chunk_start < signal.size(); chunk_start += chunk_size) {
+        chunk_size = m_signal_chunker.next_chunk_size(signal.size() - chunk_start);
+        auto const chunk_span = signal.subspan(chunk_start, chunk_size);
+
+        auto const chunk_offset = m_chunk_data.size();
+        if (m_signal_type == SignalType::UncompressedSignal) {
+            auto const chunk_bytes = chunk_span.size() * sizeof(std::int16_t);
+            m_chunk_data.resize(chunk_offset + chunk_bytes);
+            std::memcpy(m_chunk_data.data() + chunk_offset, chunk_span.data(), chunk_bytes);
+        } else {
+            m_chunk_data.resize(chunk_offset + m_codec->max_compressed_size(chunk_span.size()));
+            auto const compressed = m_codec->compress(
+                chunk_span, context, gsl::make_span(m_chunk_data).subspan(chunk_offset));
+            if (!compressed.ok()) {
+                // Drop this read's chunks, leaving the reads before it buffered:
+                m_chunk_offsets.resize(m_chunk_offsets.size() - chunk_count);
+                m_chunk_sample_counts.resize(m_chunk_sample_counts.size() - chunk_count);
+                m_chunk_data.resize(m_chunk_offsets.back());
+                return compressed.status();
+            }
+            m_chunk_data.resize(chunk_offset + *compressed);
+        }
+        m_chunk_offsets.push_back(m_chunk_data.size());
+        m_chunk_sample_counts.push_back(std::uint32_t(chunk_span.size()));
+        chunk_count += 1;
+    }
+    std::optional<SignalStatistics> signal_statistics;
+    if (m_write_signal_statistics) {
+        gsl::span<std::int16_t const> const chunks[] = {signal};
+        signal_statistics = compute_signal_statistics(gsl::make_span(chunks));
+    }
+    m_reads.push_back({read_data, signal.size(), chunk_count, signal_statistics});
+
+    if (m_reads.size() >= m_max_pending_reads) {
+        return flush();
+    }
+    return arrow::Status::OK();
+}
+
+arrow::Status FileWriterProducer::flush()
+{
+    if (m_reads.empty()) {
+        return arrow::Status::OK();
+    }
+
+    // Buffered reads are dropped whether or not they are committed, so none are written twice:
+    auto clear_buffers = gsl::finally([&] {
+        m_reads.clear();
+        m_chunk_data.clear();
+        m_chunk_offsets.resize(1);
+        m_chunk_sample_counts.clear();
+    });
+
+    std::lock_guard<std::mutex> l(*m_writer.m_sync);
+    auto & impl = *m_writer.m_impl;
+    std::size_t chunk_index = 0;
+    std::vector<SignalTableRowIndex> signal_rows;
+    for (auto const & read : m_reads) {
+        signal_rows.clear();
+        for (std::size_t i = 0; i < read.chunk_count; ++i, ++chunk_index) {
+            auto const chunk_offset = m_chunk_offsets[chunk_index];
+            auto const chunk_bytes = gsl::make_span(m_chunk_data).subspan(
+                chunk_offset, m_chunk_offsets[chunk_index + 1] - chunk_offset);
+            ARROW_ASSIGN_OR_RAISE(
+                auto const row_index,
+                impl.add_pre_compressed_signal(
+                    read.read_data.read_id, chunk_bytes, m_chunk_sample_counts[chunk_index]));
+            signal_rows.push_back(row_index);
+        }
+        ARROW_RETURN_NOT_OK(impl.add_complete_read(
+            read.read_data,
+            gsl::make_span(signal_rows),
+            read.signal_duration,
+            read.signal_statistics ? &*read.signal_statistics : nullptr));
+    }
+    return arrow::Status::OK();
+}
+
 pod5::Result<FileWriterImpl::DictionaryWriters> make_dictionary_writers(arrow::MemoryPool * pool)
 {
     FileWriterImpl::DictionaryWriters writers;
@@ -507,6 +2175,27 @@ pod5::Result<FileWriterImpl::DictionaryWriters> make_dictionary_writers(arrow::M
     return writers;
 }
 
+Status check_table_compression(arrow::Compression::type table_compression)
+{
+    if (table_compression == arrow::Compression::UNCOMPRESSED) {
+        return Status::OK();
+    }
+    if (table_compression != arrow::Compression::ZSTD
+        && table_compression != arrow::Compression::LZ4_FRAME)
+    {
+        return Status::Invalid(
+            "Table compression must be zstd or lz4 frame, not ",
+            arrow::util::Codec::GetCodecAsString(table_compression));
+    }
+    if (!arrow::util::Codec::IsAvailable(table_compression)) {
+        return Status::NotImplemented(
+            "Table compression ",
+            arrow::util::Codec::GetCodecAsString(table_compression),
+            " isn't available in this build of arrow");
+    }
+    return Status::OK();
+}
+
 std::string make_reads_tmp_path(
     ::arrow::internal::PlatformFilename const & arrow_path,
     Uuid const & file_identifier)
@@ -522,44 +2211,488 @@ std::string make_run_info_tmp_path(
            + ("." + to_string(file_identifier) + ".tmp-run-info");
 }
 
-pod5::Result<std::unique_ptr<FileWriter>> create_file_writer(
-    std::string const & path,
+std::string make_signal_summary_tmp_path(
+    ::arrow::internal::PlatformFilename const & arrow_path,
+    Uuid const & file_identifier)
+{
+    return arrow_path.Parent().ToString() + "/"
+           + ("." + to_string(file_identifier) + ".tmp-signal-summary");
+}
+
+std::string make_appended_signal_tmp_path(
+    ::arrow::internal::PlatformFilename const & arrow_path,
+    Uuid const & file_identifier)
+{
+    return arrow_path.Parent().ToString() + "/"
+           + ("." + to_string(file_identifier) + ".tmp-appended-signal");
+}
+
+namespace {
+
+/// A closed file a new writer appends to, read before the writer overwrites anything beyond its
+/// signal table's batches.
+struct AppendedFile {
+    std::string path;
+    Uuid section_marker;
+    std::int64_t signal_table_start;
+    std::shared_ptr<arrow::io::RandomAccessFile> signal_table_file;
+    // Listed by the signal table's own footer, with the row count of each batch:
+    std::vector<RecordBatchLocation> signal_batch_locations;
+    SignalTableReader signal_table;
+    ReadTableReader read_table;
+    RunInfoTableReader run_info_table;
+};
+
+// Read the flatbuffer metadata of the signal batch message at [location], without its body.
+pod5::Result<std::shared_ptr<arrow::Buffer>> read_signal_batch_metadata(
+    arrow::io::RandomAccessFile & file,
+    RecordBatchLocation const & location)
+{
+    // Messages are framed as a continuation marker and the metadata's length, then the metadata:
+    static constexpr std::int64_t PREFIX_SIZE = 8;
+    ARROW_ASSIGN_OR_RAISE(
+        auto const framed, file.ReadAt(location.offset, location.metadata_length));
+    if (framed->size() != location.metadata_length || framed->size() < PREFIX_SIZE
+        || ipc_file_blocks::read_little_endian<std::uint32_t>(framed->data()) != 0xFFFFFFFF)
+    {
+        return Status::IOError("Invalid signal batch message at offset ", location.offset);
+    }
+    auto const metadata_size =
+        ipc_file_blocks::read_little_endian<std::int32_t>(framed->data() + sizeof(std::uint32_t));
+    if (metadata_size < 0 || metadata_size > framed->size() - PREFIX_SIZE) {
+        return Status::IOError("Invalid signal batch metadata at offset ", location.offset);
+    }
+    return arrow::SliceBuffer(framed, PREFIX_SIZE, metadata_size);
+}
+
+pod5::Result<AppendedFile> open_appended_file(std::string const & path, arrow::MemoryPool * pool)
+{
+    ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::ReadableFile::Open(path, pool));
+    ARROW_ASSIGN_OR_RAISE(auto const footer, combined_file_utils::read_footer(path, file));
+
+    // The section marker follows the signature in the file's header:
+    std::array<std::uint8_t, 16> section_marker_bytes;
+    ARROW_ASSIGN_OR_RAISE(
+        auto const read_bytes,
+        file->ReadAt(
+            combined_file_utils::FILE_SIGNATURE.size(),
+            section_marker_bytes.size(),
+            section_marker_bytes.data()));
+    if (read_bytes != std::int64_t(section_marker_bytes.size())) {
+        return Status::IOError("Failed to read section marker of '", path, "'");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::io::RandomAccessFile> signal_table_file,
+        combined_file_utils::open_sub_file(footer.signal_table));
+    ARROW_ASSIGN_OR_RAISE(
+        auto signal_batch_locations,
+        ipc_file_blocks::read_record_batch_locations(signal_table_file));
+    ARROW_ASSIGN_OR_RAISE(
+        auto signal_table,
+        make_signal_table_reader(
+            signal_table_file, 1, 0, pool, footer.signal_table.batch_locations));
+    if (signal_batch_locations.size() != signal_table.num_record_batches()) {
+        return Status::IOError("Signal table of '", path, "' lists the wrong number of batches");
+    }
+    for (std::size_t i = 0; i < signal_batch_locations.size(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(
+            auto const metadata,
+            read_signal_batch_metadata(*signal_table_file, signal_batch_locations[i]));
+        ARROW_ASSIGN_OR_RAISE(
+            signal_batch_locations[i].row_count,
+            ipc_file_blocks::read_record_batch_row_count(*metadata));
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto reads_file, combined_file_utils::open_sub_file(footer.reads_table));
+    ARROW_ASSIGN_OR_RAISE(auto read_table, make_read_table_reader(reads_file, pool));
+    ARROW_ASSIGN_OR_RAISE(
+        auto run_info_file, combined_file_utils::open_sub_file(footer.run_info_table));
+    ARROW_ASSIGN_OR_RAISE(auto run_info_table, make_run_info_table_reader(run_info_file, pool));
+
+    return AppendedFile{
+        path,
+        Uuid(section_marker_bytes),
+        footer.signal_table.file_start_offset,
+        std::move(signal_table_file),
+        std::move(signal_batch_locations),
+        std::move(signal_table),
+        std::move(read_table),
+        std::move(run_info_table)};
+}
+
+/// How a writer writes its signal table: as its options ask, or as the signal table of the file
+/// it appends to was written.
+struct SignalTableSettings {
+    std::shared_ptr<arrow::KeyValueMetadata const> metadata;
+    SignalType signal_type;
+    SignalCompressionProfile compression_profile;
+    std::shared_ptr<SignalCompressionDictionary const> compression_dictionary;
+    std::size_t batch_alignment;
+    std::shared_ptr<SignalCodec const> codec;
+    bool write_checksums;
+    std::size_t batch_size;
+    std::size_t batch_bytes;
+};
+
+pod5::Result<SignalTableSettings> appended_signal_table_settings(
+    AppendedFile const & appended_file,
+    FileWriterOptions const & options)
+{
+    auto const schema = appended_file.signal_table.schema();
+    ARROW_ASSIGN_OR_RAISE(auto const field_locations, read_signal_table_schema(schema));
+    auto const & schema_metadata = appended_file.signal_table.schema_metadata();
+
+    SignalTableSettings settings;
+    ARROW_ASSIGN_OR_RAISE(settings.metadata, make_schema_key_value_metadata(schema_metadata));
+    settings.signal_type = field_locations.signal_type;
+    settings.compression_profile = schema_metadata.signal_compression_profile;
+    if (settings.signal_type == SignalType::VbzDictionarySignal) {
+        ARROW_ASSIGN_OR_RAISE(
+            settings.compression_dictionary, read_signal_dictionary_metadata(schema->metadata()));
+    }
+    ARROW_ASSIGN_OR_RAISE(
+        settings.batch_alignment, read_signal_batch_alignment_metadata(schema->metadata()));
+    if (settings.signal_type == SignalType::CodecSignal) {
+        settings.codec = field_locations.codec;
+    }
+    settings.write_checksums = field_locations.checksum >= 0;
+
+    // Batches after the first must hold its rows, unless it's the table's only batch and short,
+    // when it's added again row by row and the options size the batches:
+    auto const & locations = appended_file.signal_batch_locations;
+    if (locations.size() > 1
+        || (locations.size() == 1
+            && locations.front().row_count >= options.signal_table_batch_size()))
+    {
+        settings.batch_size = locations.front().row_count;
+        settings.batch_bytes = 0;
+    } else {
+        settings.batch_size = options.signal_table_batch_size();
+        settings.batch_bytes = options.signal_table_batch_bytes();
+    }
+    return settings;
+}
+
+// Find the number of [appended_file]'s signal batches [writer] continues after. Only a table's
+// last batch may be short, so a short last batch is left out, its rows added again to [writer],
+// see continue_short_signal_batch.
+std::size_t continued_signal_batch_count(
+    AppendedFile const & appended_file,
+    SignalTableWriter const & writer)
+{
+    auto const & locations = appended_file.signal_batch_locations;
+    if (!locations.empty() && locations.back().row_count < writer.table_batch_size()) {
+        return locations.size() - 1;
+    }
+    return locations.size();
+}
+
+// Write the batches of [appended_file]'s signal table to [writer] again, into a stream counting
+// their bytes, checking each lands where it lies in the file so the writer continues the table.
+// Only the first batch, written with the table's schema, is decoded. The others are written from
+// their metadata, with zeroed bodies of the same length, so their signal is never read.
+Status replay_signal_batches(
+    AppendedFile const & appended_file,
+    SignalTableWriter & writer,
+    arrow::MemoryPool * pool)
+{
+    if (!appended_file.signal_table.schema()->Equals(*writer.schema(), true)) {
+        return Status::Invalid(
+            "Signal table of '", appended_file.path, "' can't be continued by this writer");
+    }
+
+    auto const & locations = appended_file.signal_batch_locations;
+    std::int64_t max_body_length = 0;
+    for (auto const & location : locations) {
+        max_body_length = std::max(max_body_length, location.body_length);
+    }
+    ARROW_ASSIGN_OR_RAISE(
+        std::unique_ptr<arrow::Buffer> zeroed_body, arrow::AllocateBuffer(max_body_length, pool));
+    std::memset(zeroed_body->mutable_data(), 0, zeroed_body->size());
+    std::shared_ptr<arrow::Buffer> const body = std::move(zeroed_body);
+
+    auto const replayed_count = continued_signal_batch_count(appended_file, writer);
+    for (std::size_t i = 0; i < replayed_count; ++i) {
+        auto const & location = locations[i];
+        std::unique_ptr<arrow::ipc::Message> message;
+        if (i == 0) {
+            ARROW_ASSIGN_OR_RAISE(message, appended_file.signal_table.read_record_batch_message(0));
+        } else {
+            ARROW_ASSIGN_OR_RAISE(
+                auto const metadata,
+                read_signal_batch_metadata(*appended_file.signal_table_file, location));
+            ARROW_ASSIGN_OR_RAISE(
+                message,
+                arrow::ipc::Message::Open(
+                    metadata, arrow::SliceBuffer(body, 0, location.body_length)));
+        }
+        ARROW_RETURN_NOT_OK(writer.write_raw_batch(*message, location.row_count));
+
+        auto const & written = writer.batch_locations().back();
+        if (written.offset != location.offset || written.metadata_length != location.metadata_length
+            || written.body_length != location.body_length)
+        {
+            return Status::Invalid(
+                "Signal batch ",
+                i,
+                " of '",
+                appended_file.path,
+                "' can't be written again where it lies in the file");
+        }
+    }
+
+    // The batches are in the file already, and needn't be checkpointed:
+    writer.take_written_batches();
+    return Status::OK();
+}
+
+// Add the rows of [appended_file]'s short last signal batch, if it has one, to [writer] as the
+// start of its next batch, copying their signal as stored. The file is cut after the batches
+// before it as the writer closes.
+Status continue_short_signal_batch(AppendedFile const & appended_file, SignalTableWriter & writer)
+{
+    auto const batch_index = continued_signal_batch_count(appended_file, writer);
+    if (batch_index == appended_file.signal_batch_locations.size()) {
+        return Status::OK();
+    }
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto const batch, appended_file.signal_table.read_record_batch(batch_index));
+    auto const read_ids = batch.read_id_column();
+    auto const sample_counts = batch.samples_column();
+    for (std::size_t row = 0; row < batch.num_rows(); ++row) {
+        ARROW_RETURN_NOT_OK(writer.add_pre_compressed_signal(
+            read_ids->Value(row), batch.stored_signal_row(row), sample_counts->Value(row)));
+    }
+    return Status::OK();
+}
+
+// Check [column] of the appended file's reads has the dictionary [writer] holds, so reads added
+// later share the file's dictionary indices.
+Status check_appended_dictionary(
+    arrow::DictionaryArray const & column,
+    DictionaryWriter & writer,
+    char const * name)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const values, writer.get_value_array());
+    if (!values->Equals(*column.dictionary())) {
+        return Status::Invalid("The ", name, " dictionary of the file's reads can't be continued");
+    }
+    return Status::OK();
+}
+
+/// Continue [appended_file]'s tables in [impl], then attach a stream staging the signal written
+/// from here on beside the file to [signal_file].
+///
+/// The signal table's batches are written again only to be counted, see replay_signal_batches,
+/// but for a short last batch, whose rows start the writer's first batch. The run info table is
+/// rebuilt from the file's run infos, and the read table's batches are decoded and written to
+/// the new read table after its dictionaries are seeded with the file's, in the same order. The
+/// file itself is left as it was until the writer closes, when the staged signal is moved in
+/// after its signal batches.
+Status continue_appended_file(
+    AppendedFile const & appended_file,
+    FileWriterImpl & impl,
+    FileWriterImpl::DictionaryWriters const & dict_writers,
+    AppendingOutputStream & signal_file,
+    FileWriterOptions const & options,
+    CachedFileValues & cached_values)
+{
+    ARROW_RETURN_NOT_OK(
+        replay_signal_batches(appended_file, *impl.signal_table_writer(), options.memory_pool()));
+
+    auto & read_table_writer = *impl.read_table_writer();
+    auto const & read_table = appended_file.read_table;
+    if (!read_table.schema()->Equals(*read_table_writer.schema(), false)) {
+        return Status::Invalid(
+            "Read table of '",
+            appended_file.path,
+            "' was written by another version of pod5, and can't be appended to");
+    }
+
+    // Run infos are added to the read table's dictionary in the order of their table:
+    ARROW_ASSIGN_OR_RAISE(
+        auto const run_info_count, appended_file.run_info_table.get_run_info_count());
+    for (std::size_t i = 0; i < run_info_count; ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto const run_info, appended_file.run_info_table.get_run_info(i));
+        ARROW_RETURN_NOT_OK(impl.add_run_info(*run_info));
+    }
+
+    auto const batch_count = read_table.num_record_batches();
+    if (batch_count > 0) {
+        // Dictionaries are extended by deltas, so the last batch holds every value:
+        ARROW_ASSIGN_OR_RAISE(auto const last_batch, read_table.read_record_batch(batch_count - 1));
+        ARROW_ASSIGN_OR_RAISE(auto const columns, last_batch.columns());
+        auto const & pore_types =
+            static_cast<arrow::StringArray const &>(*columns.pore_type->dictionary());
+        for (std::int64_t i = 0; i < pore_types.length(); ++i) {
+            ARROW_RETURN_NOT_OK(impl.add_pore_type(pore_types.GetString(i)));
+        }
+        ARROW_RETURN_NOT_OK(
+            check_appended_dictionary(*columns.pore_type, *dict_writers.pore_writer, "pore type"));
+        ARROW_RETURN_NOT_OK(check_appended_dictionary(
+            *columns.end_reason, *dict_writers.end_reason_writer, "end reason"));
+        ARROW_RETURN_NOT_OK(check_appended_dictionary(
+            *columns.run_info, *dict_writers.run_info_writer, "run info"));
+    }
+    for (std::size_t i = 0; i < batch_count; ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto const batch, read_table.read_record_batch(i));
+        ARROW_RETURN_NOT_OK(read_table_writer.write_batch(*batch.batch()));
+    }
+
+    // Everything beyond the signal table's batches is written again as the writer closes:
+    ARROW_ASSIGN_OR_RAISE(
+        auto const arrow_path, ::arrow::internal::PlatformFilename::FromString(appended_file.path));
+    FileWriterImpl::AppendedSignal appended_signal;
+    appended_signal.staging_path = make_appended_signal_tmp_path(
+        arrow_path, appended_file.signal_table.schema_metadata().file_identifier);
+    appended_signal.batches_end = appended_file.signal_table_start + signal_file.counted_bytes();
+    ARROW_ASSIGN_OR_RAISE(
+        auto stream, make_file_stream(appended_signal.staging_path, options, cached_values));
+    impl.set_appended_signal(std::move(appended_signal));
+    signal_file.attach(std::move(stream));
+
+    // Once attached, so any batch the rows fill is staged with the new signal:
+    return continue_short_signal_batch(appended_file, *impl.signal_table_writer());
+}
+
+/// Where a new writer writes its file: to [path], with the run info and read tables in files
+/// beside it until it is closed, or to [sink], with them held in memory. [appended_file] is set
+/// when the writer continues the closed file at [path].
+struct FileWriterOutput {
+    std::string path;
+    std::shared_ptr<arrow::io::OutputStream> sink;
+    AppendedFile const * appended_file = nullptr;
+};
+
+pod5::Result<std::unique_ptr<FileWriter>> make_file_writer(
+    FileWriterOutput const & output,
     std::string const & writing_software_name,
     FileWriterOptions const & options)
 {
-    auto pool = options.memory_pool();
-    if (!pool) {
+    if (!options.memory_pool()) {
         return Status::Invalid("Invalid memory pool specified for file writer");
     }
+    ARROW_RETURN_NOT_OK(check_signal_compression_profile(options.signal_compression_profile()));
+    ARROW_RETURN_NOT_OK(check_signal_summary_decimations(options.signal_summary_decimations()));
+    ARROW_RETURN_NOT_OK(check_table_compression(options.table_compression()));
+    // Reads are chunked by the configured sizes, or the max chunk size where none are set:
+    ARROW_ASSIGN_OR_RAISE(
+        auto signal_chunker,
+        SignalChunker::make(
+            options.signal_chunk_sizes().empty()
+                ? std::vector<std::uint32_t>{options.max_signal_chunk_size()}
+                : options.signal_chunk_sizes()));
+    auto pool = tagged_memory_pool(MemorySubsystem::WriterBuilders, options.memory_pool());
+    auto const compression_pool =
+        tagged_memory_pool(MemorySubsystem::CompressionScratch, options.memory_pool());
+
+    // Table builders allocate from a pool recycling each written batch's memory into the next:
+    std::shared_ptr<RecyclingMemoryPool> recycling_pool;
+    if (options.max_recycled_batch_bytes() > 0) {
+        recycling_pool =
+            std::make_shared<RecyclingMemoryPool>(pool, options.max_recycled_batch_bytes());
+        pool = recycling_pool.get();
+    }
 
-    ARROW_ASSIGN_OR_RAISE(auto arrow_path, ::arrow::internal::PlatformFilename::FromString(path));
-    ARROW_ASSIGN_OR_RAISE(bool file_exists, arrow::internal::FileExists(arrow_path));
-    if (file_exists) {
-        return Status::Invalid("Unable to create new file '", path, "', already exists");
+    std::optional<::arrow::internal::PlatformFilename> arrow_path;
+    if (!output.sink) {
+        ARROW_ASSIGN_OR_RAISE(
+            arrow_path, ::arrow::internal::PlatformFilename::FromString(output.path));
+        ARROW_ASSIGN_OR_RAISE(bool file_exists, arrow::internal::FileExists(*arrow_path));
+        if (file_exists && !output.appended_file) {
+            return Status::Invalid("Unable to create new file '", output.path, "', already exists");
+        }
     }
 
     // Open dictionary writers:
     ARROW_ASSIGN_OR_RAISE(auto dict_writers, make_dictionary_writers(pool));
 
-    // Prep file metadata:
+    // Prep file metadata, an appended file keeping its own:
     std::random_device gen;
     auto uuid_gen = BasicUuidRandomGenerator<std::random_device>{gen};
-    auto const section_marker = uuid_gen();
-    auto const file_identifier = uuid_gen();
+    SignalTableSettings signal_settings;
+    Uuid section_marker;
+    Uuid file_identifier;
+    if (output.appended_file) {
+        ARROW_ASSIGN_OR_RAISE(
+            signal_settings, appended_signal_table_settings(*output.appended_file, options));
+        section_marker = output.appended_file->section_marker;
+        file_identifier = output.appended_file->signal_table.schema_metadata().file_identifier;
+    } else {
+        signal_settings.signal_type = options.signal_type();
+        signal_settings.compression_profile = options.signal_compression_profile();
+        signal_settings.compression_dictionary = options.signal_compression_dictionary();
+        signal_settings.batch_alignment =
+            options.page_align_signal_batches() ? IOManager::Alignment : 0;
+        signal_settings.codec = options.signal_codec();
+        signal_settings.write_checksums = options.write_signal_checksums();
+        signal_settings.batch_size = options.signal_table_batch_size();
+        signal_settings.batch_bytes = options.signal_table_batch_bytes();
+        section_marker = uuid_gen();
+        file_identifier = uuid_gen();
+    }
 
     ARROW_ASSIGN_OR_RAISE(auto current_version, parse_version_number(Pod5Version));
     ARROW_ASSIGN_OR_RAISE(
         auto file_schema_metadata,
-        make_schema_key_value_metadata({file_identifier, writing_software_name, current_version}));
-
-    auto reads_tmp_path = make_reads_tmp_path(arrow_path, file_identifier);
-    auto run_info_tmp_path = make_run_info_tmp_path(arrow_path, file_identifier);
+        make_schema_key_value_metadata(
+            {file_identifier,
+             writing_software_name,
+             current_version,
+             signal_settings.compression_profile}));
+    if (!output.appended_file) {
+        signal_settings.metadata = file_schema_metadata;
+    }
 
+    // Open the streams the tables are written to, the signal table's being the main file's:
+    std::string reads_tmp_path;
+    std::string run_info_tmp_path;
+    StreamFileWriterImpl::TableBuffers table_buffers;
+    std::shared_ptr<FileOutputStream> read_table_file_async;
+    std::shared_ptr<FileOutputStream> run_info_table_file_async;
+    std::shared_ptr<FileOutputStream> signal_file;
+    std::shared_ptr<AppendingOutputStream> appending_signal_file;
     CachedFileValues cached_values;
+    if (output.sink) {
+        // Held apart from the recycling pool, which holds memory for table builders:
+        auto const buffer_pool = options.memory_pool();
+        ARROW_ASSIGN_OR_RAISE(
+            table_buffers.reads, arrow::io::BufferOutputStream::Create(0, buffer_pool));
+        ARROW_ASSIGN_OR_RAISE(
+            table_buffers.run_info, arrow::io::BufferOutputStream::Create(0, buffer_pool));
+        read_table_file_async = std::make_shared<SinkOutputStream>(table_buffers.reads);
+        run_info_table_file_async = std::make_shared<SinkOutputStream>(table_buffers.run_info);
+        signal_file = std::make_shared<SinkOutputStream>(output.sink);
+    } else {
+        reads_tmp_path = make_reads_tmp_path(*arrow_path, file_identifier);
+        run_info_tmp_path = make_run_info_tmp_path(*arrow_path, file_identifier);
+        ARROW_ASSIGN_OR_RAISE(
+            read_table_file_async, make_file_stream(reads_tmp_path, options, cached_values));
+        // Run info is normally global, if we don't flush on batch complete we can
+        // lose a large number of reads in a crash.
+        ARROW_ASSIGN_OR_RAISE(
+            run_info_table_file_async,
+            make_file_stream(
+                run_info_tmp_path, options, cached_values, FlushMode::ForceFlushOnBatchComplete));
+        if (output.appended_file) {
+            // Nothing is written to an appended file until its tables are known to continue:
+            appending_signal_file = std::make_shared<AppendingOutputStream>();
+            signal_file = appending_signal_file;
+        } else {
+            ARROW_ASSIGN_OR_RAISE(
+                signal_file,
+                make_file_stream(
+                    output.path,
+                    options,
+                    cached_values,
+                    FlushMode::Default,
+                    options.expected_file_size()));
+        }
+    }
 
-    // Prepare the temporary reads file:
-    ARROW_ASSIGN_OR_RAISE(
-        auto read_table_file_async, make_file_stream(reads_tmp_path, options, cached_values));
+    // Prepare the reads table:
     ARROW_ASSIGN_OR_RAISE(
         auto read_table_tmp_writer,
         make_read_table_writer(
@@ -569,66 +2702,238 @@ pod5::Result<std::unique_ptr<FileWriter>> create_file_writer(
             dict_writers.pore_writer,
             dict_writers.end_reason_writer,
             dict_writers.run_info_writer,
-            pool));
-
-    // Prepare the temporary run_info file:
-    //
-    // Run info is normally global, if we don't flush on batch complete we can
-    // lose a large number of reads in a crash.
-    ARROW_ASSIGN_OR_RAISE(
-        auto run_info_table_file_async,
-        make_file_stream(
-            run_info_tmp_path, options, cached_values, FlushMode::ForceFlushOnBatchComplete));
-
+            pool,
+            options.read_table_batch_bytes(),
+            options.table_compression(),
+            output.appended_file
+                ? output.appended_file->read_table.field_locations()->has_signal_statistics()
+                : options.write_signal_statistics()));
+
+    // Prepare the run_info table:
     ARROW_ASSIGN_OR_RAISE(
         auto run_info_table_tmp_writer,
         make_run_info_table_writer(
             run_info_table_file_async,
             file_schema_metadata,
             options.run_info_table_batch_size(),
-            pool));
-
-    // Prepare the main file - and set up the signal table to write here:
-    ARROW_ASSIGN_OR_RAISE(auto signal_file, make_file_stream(path, options, cached_values));
-
-    // Write the initial header to the combined file:
-    ARROW_RETURN_NOT_OK(combined_file_utils::write_combined_header(signal_file, section_marker));
-
-    ARROW_ASSIGN_OR_RAISE(size_t const signal_table_start, signal_file->Tell());
-
-    static_cast<AsyncOutputStream *>(signal_file.get())->set_file_start_offset(signal_table_start);
+            pool,
+            options.table_compression()));
+
+    // Write the initial header to the combined file, which an appended file has already:
+    std::size_t signal_table_start = 0;
+    if (output.appended_file) {
+        signal_table_start = output.appended_file->signal_table_start;
+    } else {
+        ARROW_RETURN_NOT_OK(
+            combined_file_utils::write_combined_header(signal_file, section_marker));
+        ARROW_ASSIGN_OR_RAISE(signal_table_start, signal_file->Tell());
+        signal_file->set_file_start_offset(signal_table_start);
+    }
 
     // Then place the signal file directly after that:
     ARROW_ASSIGN_OR_RAISE(
         auto signal_table_writer,
         make_signal_table_writer(
             signal_file,
-            file_schema_metadata,
-            options.signal_table_batch_size(),
-            options.signal_type(),
-            pool));
+            signal_settings.metadata,
+            signal_settings.batch_size,
+            signal_settings.signal_type,
+            pool,
+            signal_settings.compression_profile,
+            signal_settings.compression_dictionary,
+            signal_settings.batch_bytes,
+            signal_settings.batch_alignment,
+            signal_table_start,
+            signal_settings.codec,
+            signal_settings.write_checksums));
+
+    // Uncompressed signal is written as it is added, so only compressed signal uses a pool:
+    std::shared_ptr<ThreadPool> compression_thread_pool;
+    std::shared_ptr<ThreadPool> writer_resources_thread_pool;
+    if (options.writer_resources()) {
+        writer_resources_thread_pool = options.thread_pool()
+                                           ? options.thread_pool()
+                                           : options.writer_resources()->make_writer_thread_pool();
+    }
+    if (options.max_compression_jobs() > 0
+        && signal_settings.signal_type != SignalType::UncompressedSignal)
+    {
+        if (writer_resources_thread_pool) {
+            compression_thread_pool = writer_resources_thread_pool;
+        } else {
+            compression_thread_pool = options.thread_pool()
+                                          ? options.thread_pool()
+                                          : make_thread_pool(options.max_compression_jobs());
+        }
+    }
 
-    // Throw it all together into a writer object:
-    return std::make_unique<FileWriter>(std::make_unique<CombinedFileWriterImpl>(
-        path,
-        run_info_tmp_path,
-        reads_tmp_path,
-        signal_table_start,
-        section_marker,
-        file_identifier,
-        writing_software_name,
-        std::move(dict_writers),
-        std::move(run_info_table_tmp_writer),
-        std::move(read_table_tmp_writer),
-        std::move(signal_table_writer),
-        options.max_signal_chunk_size(),
-        pool));
+    IndexSelection indexes;
+    indexes.read_id_index = options.write_read_id_index();
+    indexes.read_id_filter = options.write_read_id_filter();
+    indexes.read_table_statistics = options.write_read_table_statistics();
+    indexes.file_summary = options.write_file_summary();
+    // A streamed signal table can't be read back to index:
+    indexes.signal_row_index = options.write_signal_row_index() && !output.sink;
+
+    // Signal summaries are kept beside the file, or in memory, until it is closed:
+    std::string signal_summaries_path;
+    std::shared_ptr<arrow::io::OutputStream> signal_summaries_file;
+    if (!options.signal_summary_decimations().empty()) {
+        if (output.sink) {
+            ARROW_ASSIGN_OR_RAISE(
+                table_buffers.signal_summaries,
+                arrow::io::BufferOutputStream::Create(0, options.memory_pool()));
+            signal_summaries_file = table_buffers.signal_summaries;
+        } else {
+            signal_summaries_path = make_signal_summary_tmp_path(*arrow_path, file_identifier);
+            ARROW_ASSIGN_OR_RAISE(
+                signal_summaries_file, arrow::io::FileOutputStream::Open(signal_summaries_path));
+        }
+    }
+
+    // Throw it all together into a writer object, keeping the dictionary writers to check an
+    // appended file's dictionaries against:
+    auto const shared_dict_writers = dict_writers;
+    std::unique_ptr<FileWriterImpl> impl;
+    if (output.sink) {
+        impl = std::make_unique<StreamFileWriterImpl>(
+            signal_file,
+            std::move(table_buffers),
+            signal_table_start,
+            section_marker,
+            file_identifier,
+            writing_software_name,
+            indexes,
+            options.sort_read_table_by_read_id(),
+            options.read_table_batch_size(),
+            options.table_compression(),
+            std::move(dict_writers),
+            std::move(run_info_table_tmp_writer),
+            std::move(read_table_tmp_writer),
+            std::move(signal_table_writer),
+            std::move(signal_chunker),
+            compression_thread_pool,
+            options.max_compression_jobs(),
+            recycling_pool,
+            pool,
+            compression_pool);
+    } else {
+        impl = std::make_unique<CombinedFileWriterImpl>(
+            output.path,
+            run_info_tmp_path,
+            reads_tmp_path,
+            signal_table_start,
+            section_marker,
+            file_identifier,
+            writing_software_name,
+            indexes,
+            options.sort_read_table_by_read_id(),
+            options.read_table_batch_size(),
+            options.table_compression(),
+            std::move(dict_writers),
+            std::move(run_info_table_tmp_writer),
+            std::move(read_table_tmp_writer),
+            std::move(signal_table_writer),
+            std::move(signal_chunker),
+            compression_thread_pool,
+            options.max_compression_jobs(),
+            recycling_pool,
+            pool,
+            compression_pool);
+    }
+
+    // Deadlines are waited for on a thread of their own, so they don't hold up compression:
+    FileWriterImpl::FlushPolicy flush_policy;
+    flush_policy.max_latency = options.max_flush_latency();
+    flush_policy.max_unflushed_bytes = options.max_unflushed_bytes();
+    if (flush_policy.max_latency.count() > 0) {
+        flush_policy.thread_pool = make_thread_pool(1);
+    }
+    flush_policy.streams = {signal_file, read_table_file_async};
+    impl->set_flush_policy(std::move(flush_policy));
+    impl->set_output_streams({signal_file, read_table_file_async, run_info_table_file_async});
+    if (options.writer_resources()) {
+        impl->set_writer_resources(options.writer_resources(), writer_resources_thread_pool);
+    }
+
+    // Checkpoints locate the batches of a file to recover, so a stream has none, and nor does a
+    // file appended to, which is left whole until the writer closes:
+    if (options.recovery_checkpoint_interval() > 0 && !output.sink && !output.appended_file) {
+        FileWriterImpl::RecoveryCheckpoints recovery_checkpoints;
+        ARROW_ASSIGN_OR_RAISE(
+            recovery_checkpoints.writer,
+            internal::RecoveryCheckpointWriter::open(
+                internal::make_checkpoints_tmp_path(*arrow_path, file_identifier)));
+        recovery_checkpoints.interval = options.recovery_checkpoint_interval();
+        recovery_checkpoints.signal_stream = signal_file;
+        impl->set_recovery_checkpoints(std::move(recovery_checkpoints));
+    }
+
+    if (signal_summaries_file) {
+        FileWriterImpl::SignalSummaries signal_summaries;
+        signal_summaries.path = signal_summaries_path;
+        ARROW_ASSIGN_OR_RAISE(
+            signal_summaries.writer,
+            SignalSummaryWriter::open(
+                signal_summaries_file,
+                file_schema_metadata,
+                options.signal_summary_decimations(),
+                pool));
+        impl->set_signal_summaries(std::move(signal_summaries));
+    }
+
+    if (output.appended_file) {
+        ARROW_RETURN_NOT_OK(continue_appended_file(
+            *output.appended_file,
+            *impl,
+            shared_dict_writers,
+            *appending_signal_file,
+            options,
+            cached_values));
+    }
+
+    return std::make_unique<FileWriter>(std::move(impl));
+}
+
+}  // namespace
+
+pod5::Result<std::unique_ptr<FileWriter>> create_file_writer(
+    std::string const & path,
+    std::string const & writing_software_name,
+    FileWriterOptions const & options)
+{
+    return make_file_writer({path, nullptr}, writing_software_name, options);
+}
+
+pod5::Result<std::unique_ptr<FileWriter>> create_file_writer(
+    std::shared_ptr<arrow::io::OutputStream> const & sink,
+    std::string const & writing_software_name,
+    FileWriterOptions const & options)
+{
+    if (!sink) {
+        return Status::Invalid("Invalid output stream specified for file writer");
+    }
+    return make_file_writer({{}, sink}, writing_software_name, options);
+}
+
+pod5::Result<std::unique_ptr<FileWriter>> open_file_writer_for_append(
+    std::string const & path,
+    std::string const & writing_software_name,
+    FileWriterOptions const & options)
+{
+    if (!options.signal_summary_decimations().empty()) {
+        return Status::Invalid("Signal summaries can't be written to a file appended to");
+    }
+    ARROW_ASSIGN_OR_RAISE(
+        auto const appended_file, open_appended_file(path, arrow::default_memory_pool()));
+    return make_file_writer({path, nullptr, &appended_file}, writing_software_name, options);
 }
 
 pod5::Result<std::unique_ptr<FileWriter>> recover_file_writer(
     std::string const & src_path,
     std::string const & dest_path,
-    FileWriterOptions const & options)
+    FileWriterOptions const & options,
+    FileRecoveryOptions const & recovery_options)
 {
     // Create a file to push recovered data into:
     ARROW_ASSIGN_OR_RAISE(
@@ -642,44 +2947,67 @@ pod5::Result<std::unique_ptr<FileWriter>> recover_file_writer(
     // Signature should be right at 0:
     ARROW_RETURN_NOT_OK(combined_file_utils::check_signature(file, 0));
 
-    auto null_metadata = arrow::KeyValueMetadata::Make({}, {});
-
-    // Recover the signal data into [dest_file]:
-    RecoveredData recovered_raw_data;
-    {
-        ARROW_ASSIGN_OR_RAISE(
-            auto raw_sub_file,
-            combined_file_utils::open_sub_file(file, combined_file_utils::header_size));
-        ARROW_ASSIGN_OR_RAISE(
-            recovered_raw_data,
-            recover_arrow_file(raw_sub_file, dest_file->impl()->signal_table_writer()));
-    }
+    ARROW_ASSIGN_OR_RAISE(
+        auto raw_sub_file,
+        combined_file_utils::open_sub_file(file, combined_file_utils::header_size));
 
-    auto file_identifier = recovered_raw_data.metadata.file_identifier;
+    // The file identifier names the temporary files holding the other tables:
+    ARROW_ASSIGN_OR_RAISE(
+        auto const signal_table, detail::open_arrow_file_to_recover(raw_sub_file));
+    auto const file_identifier = signal_table.metadata.file_identifier;
     auto reads_tmp_path = make_reads_tmp_path(arrow_path, file_identifier);
     auto run_info_tmp_path = make_run_info_tmp_path(arrow_path, file_identifier);
 
-    // Recover the run info data into [dest_file]:
-    {
-        ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::ReadableFile::Open(run_info_tmp_path, pool));
-        ARROW_ASSIGN_OR_RAISE(auto size, file->GetSize());
-        if (size > 0) {
+    // Each table has a writer of its own in [dest_file], so they can be recovered at once:
+    auto recover_table = [&](std::size_t index) -> arrow::Status {
+        switch (index) {
+        // Recover the signal data into [dest_file]:
+        case 0: {
+            if (!recovery_options.pass_through_signal_batches) {
+                return recover_arrow_file(raw_sub_file, dest_file->impl()->signal_table_writer())
+                    .status();
+            }
+            // Checkpoints list signal batches to copy without reading through the file:
             ARROW_ASSIGN_OR_RAISE(
-                recovered_raw_data,
-                recover_arrow_file(file, dest_file->impl()->run_info_table_writer()));
+                auto const checkpointed_batches,
+                internal::read_recovery_checkpoints(
+                    internal::make_checkpoints_tmp_path(arrow_path, file_identifier)));
+            return recover_arrow_file_passthrough(
+                       raw_sub_file,
+                       dest_file->impl()->signal_table_writer(),
+                       gsl::make_span(checkpointed_batches))
+                .status();
         }
-    }
 
-    // Recover the read data into [dest_file]:
-    {
-        ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::ReadableFile::Open(reads_tmp_path, pool));
-        ARROW_ASSIGN_OR_RAISE(auto size, file->GetSize());
-        if (size > 0) {
+        // Recover the run info data into [dest_file]:
+        case 1: {
             ARROW_ASSIGN_OR_RAISE(
-                recovered_raw_data,
-                recover_arrow_file(file, dest_file->impl()->read_table_writer()));
+                auto file, arrow::io::ReadableFile::Open(run_info_tmp_path, pool));
+            ARROW_ASSIGN_OR_RAISE(auto size, file->GetSize());
+            if (size == 0) {
+                return arrow::Status::OK();
+            }
+            return recover_arrow_file(file, dest_file->impl()->run_info_table_writer()).status();
+        }
+
+        // Recover the read data into [dest_file]:
+        case 2: {
+            ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::ReadableFile::Open(reads_tmp_path, pool));
+            ARROW_ASSIGN_OR_RAISE(auto size, file->GetSize());
+            if (size == 0) {
+                return arrow::Status::OK();
+            }
+            return recover_arrow_file(file, dest_file->impl()->read_table_writer()).status();
+        }
         }
+        return arrow::Status::OK();
+    };
+
+    std::shared_ptr<ThreadPool> recovery_thread_pool;
+    if (recovery_options.recover_tables_concurrently) {
+        recovery_thread_pool = make_thread_pool(2);
     }
+    ARROW_RETURN_NOT_OK(internal::run_parallel_tasks(recovery_thread_pool.get(), 3, recover_table));
 
     return dest_file;
 }
@@ -3,20 +3,40 @@
 #include "pod5_format/pod5_format_export.h"
 #include "pod5_format/read_table_utils.h"
 #include "pod5_format/result.h"
+#include "pod5_format/signal_chunking.h"
+#include "pod5_format/signal_codec.h"
+#include "pod5_format/signal_compression.h"
+#include "pod5_format/signal_summary.h"
 #include "pod5_format/signal_table_utils.h"
 
+#include <arrow/io/type_fwd.h>
+#include <arrow/util/type_fwd.h>
+
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 
 namespace arrow {
 class Array;
+class Buffer;
 class MemoryPool;
+
+namespace ipc {
+class Message;
+}
 }  // namespace arrow
 
 namespace pod5 {
 
 class IOManager;
+enum class MemoryPoolBackend : std::uint8_t;
 class ThreadPool;
+class WriterResources;
 
 class POD5_FORMAT_EXPORT FileWriterOptions {
 public:
@@ -25,11 +45,33 @@ public:
     static constexpr std::uint32_t DEFAULT_SIGNAL_TABLE_BATCH_SIZE = 100;
     static constexpr std::uint32_t DEFAULT_READ_TABLE_BATCH_SIZE = 1000;
     static constexpr std::uint32_t DEFAULT_RUN_INFO_TABLE_BATCH_SIZE = 1;
+    /// \brief Default byte target for table batches, 0 sizes batches by row count alone.
+    static constexpr std::size_t DEFAULT_TABLE_BATCH_BYTES = 0;
+    static constexpr arrow::Compression::type DEFAULT_TABLE_COMPRESSION =
+        arrow::Compression::UNCOMPRESSED;
     static constexpr SignalType DEFAULT_SIGNAL_TYPE = SignalType::VbzSignal;
     static constexpr bool DEFAULT_USE_DIRECTIO = false;
+    static constexpr bool DEFAULT_PAGE_ALIGN_SIGNAL_BATCHES = false;
     static constexpr bool DEFAULT_USE_SYNC_IO = false;
     static constexpr bool DEFAULT_FLUSH_ON_BATCH_COMPLETE = true;
     static constexpr std::size_t DEFAULT_WRITE_CHUNK_SIZE = 2 * 1024 * 1024;
+    static constexpr bool DEFAULT_WRITE_READ_ID_INDEX = false;
+    static constexpr bool DEFAULT_WRITE_READ_ID_FILTER = false;
+    static constexpr bool DEFAULT_WRITE_READ_TABLE_STATISTICS = false;
+    static constexpr bool DEFAULT_WRITE_FILE_SUMMARY = false;
+    static constexpr bool DEFAULT_WRITE_SIGNAL_ROW_INDEX = false;
+    static constexpr bool DEFAULT_WRITE_SIGNAL_CHECKSUMS = false;
+    static constexpr bool DEFAULT_WRITE_SIGNAL_STATISTICS = false;
+    static constexpr bool DEFAULT_SORT_READ_TABLE_BY_READ_ID = false;
+    static constexpr std::size_t DEFAULT_MAX_COMPRESSION_JOBS = 0;
+    static constexpr std::size_t DEFAULT_MAX_RECYCLED_BATCH_BYTES = 64 * 1024 * 1024;
+    static constexpr std::size_t DEFAULT_EXPECTED_FILE_SIZE = 0;
+    static constexpr bool DEFAULT_PREALLOCATE_IN_BACKGROUND = true;
+    static constexpr std::chrono::milliseconds DEFAULT_MAX_FLUSH_LATENCY{0};
+    static constexpr std::size_t DEFAULT_MAX_UNFLUSHED_BYTES = 0;
+    static constexpr std::size_t DEFAULT_MAX_PENDING_WRITE_BYTES = 10 * 1024 * 1024;
+    static constexpr std::size_t DEFAULT_MAX_PARALLEL_WRITES = 4;
+    static constexpr std::size_t DEFAULT_RECOVERY_CHECKPOINT_INTERVAL = 0;
 
     FileWriterOptions();
 
@@ -40,14 +82,67 @@ public:
 
     std::uint32_t max_signal_chunk_size() const { return m_max_signal_chunk_size; }
 
+    /// \brief Split each read's signal into chunks with sizes from [chunk_sizes] in place of
+    ///        the max signal chunk size, see SignalChunker.
+    /// \note Sizes which are all multiples of a basecaller's window keep every chunk boundary
+    ///       on a window boundary, in every file written with them. Empty (the default) chunks
+    ///       by the max signal chunk size alone.
+    void set_signal_chunk_sizes(std::vector<std::uint32_t> chunk_sizes)
+    {
+        m_signal_chunk_sizes = std::move(chunk_sizes);
+    }
+
+    std::vector<std::uint32_t> const & signal_chunk_sizes() const { return m_signal_chunk_sizes; }
+
     void set_memory_pool(arrow::MemoryPool * memory_pool) { m_memory_pool = memory_pool; }
 
+    /// \brief Set the memory pool to one allocating with [backend], failing if it isn't
+    ///        available, see memory_pool_for_backend().
+    /// \note Only the default backend's allocations are counted per subsystem, see
+    ///       tagged_memory_pool().
+    pod5::Status set_memory_pool_backend(MemoryPoolBackend backend);
+
     arrow::MemoryPool * memory_pool() const { return m_memory_pool; }
 
     void set_signal_type(SignalType signal_type) { m_signal_type = signal_type; }
 
     SignalType signal_type() const { return m_signal_type; }
 
+    /// \brief Set the zstd settings used to compress vbz signal, recorded in the file metadata.
+    void set_signal_compression_profile(SignalCompressionProfile const & profile)
+    {
+        m_signal_compression_profile = profile;
+    }
+
+    SignalCompressionProfile const & signal_compression_profile() const
+    {
+        return m_signal_compression_profile;
+    }
+
+    /// \brief Set the dictionary signal is compressed against, used with
+    ///        SignalType::VbzDictionarySignal and stored once in the file.
+    void set_signal_compression_dictionary(
+        std::shared_ptr<SignalCompressionDictionary const> const & dictionary)
+    {
+        m_signal_compression_dictionary = dictionary;
+    }
+
+    std::shared_ptr<SignalCompressionDictionary const> const & signal_compression_dictionary()
+        const
+    {
+        return m_signal_compression_dictionary;
+    }
+
+    /// \brief Set the codec compressing signal, used with SignalType::CodecSignal and recorded
+    ///        by id in the file. Readers must register a codec with the same id.
+    /// \see register_signal_codec()
+    void set_signal_codec(std::shared_ptr<SignalCodec const> const & codec)
+    {
+        m_signal_codec = codec;
+    }
+
+    std::shared_ptr<SignalCodec const> const & signal_codec() const { return m_signal_codec; }
+
     void set_signal_table_batch_size(std::size_t batch_size)
     {
         m_signal_table_batch_size = batch_size;
@@ -59,6 +154,28 @@ public:
 
     std::size_t read_table_batch_size() const { return m_read_table_batch_size; }
 
+    /// \brief Set a target size in bytes for signal table batches, with the signal table batch
+    ///        size becoming the most rows a batch can hold.
+    ///
+    /// Batches in a table share one row count, so the first batch is filled until it reaches
+    /// the target and its row count is used for the rest of the table.
+    /// \note 0 sizes batches by the signal table batch size alone.
+    void set_signal_table_batch_bytes(std::size_t batch_bytes)
+    {
+        m_signal_table_batch_bytes = batch_bytes;
+    }
+
+    std::size_t signal_table_batch_bytes() const { return m_signal_table_batch_bytes; }
+
+    /// \brief Set a target size in bytes for read table batches, with the read table batch size
+    ///        becoming the most rows a batch can hold, see set_signal_table_batch_bytes.
+    void set_read_table_batch_bytes(std::size_t batch_bytes)
+    {
+        m_read_table_batch_bytes = batch_bytes;
+    }
+
+    std::size_t read_table_batch_bytes() const { return m_read_table_batch_bytes; }
+
     void set_run_info_table_batch_size(std::size_t batch_size)
     {
         m_run_info_table_batch_size = batch_size;
@@ -66,6 +183,17 @@ public:
 
     std::size_t run_info_table_batch_size() const { return m_run_info_table_batch_size; }
 
+    /// \brief Set the codec compressing the buffers of read and run info table batches in the
+    ///        file, arrow::Compression::ZSTD or LZ4_FRAME, read back by any arrow IPC reader.
+    /// \note Only codecs built into arrow can be used, checked when the writer is created.
+    ///       UNCOMPRESSED (the default) writes the tables as they are built.
+    void set_table_compression(arrow::Compression::type table_compression)
+    {
+        m_table_compression = table_compression;
+    }
+
+    arrow::Compression::type table_compression() const { return m_table_compression; }
+
     void set_io_manager(std::shared_ptr<IOManager> const & io_manager)
     {
         m_io_manager = io_manager;
@@ -80,10 +208,37 @@ public:
 
     std::shared_ptr<ThreadPool> thread_pool() const { return m_writer_thread_pool; }
 
+    /// \brief Set threads, IO and a pending signal budget shared with other writers, used in
+    ///        place of the pools and IO manager the writer would otherwise make for itself.
+    ///
+    /// Signal is compressed on the shared compression pool, in turn with the other writers, when
+    /// max compression jobs are set and for reads added in bulk. A thread pool or IO manager set
+    /// on these options is still used in preference to the shared ones.
+    /// \see make_writer_resources()
+    void set_writer_resources(std::shared_ptr<WriterResources> const & writer_resources)
+    {
+        m_writer_resources = writer_resources;
+    }
+
+    std::shared_ptr<WriterResources> const & writer_resources() const
+    {
+        return m_writer_resources;
+    }
+
     void set_use_directio(bool use_directio) { m_use_directio = use_directio; }
 
     bool use_directio() const { return m_use_directio; }
 
+    /// \brief Set whether each signal table batch is padded to start on a page boundary
+    ///        (IOManager::Alignment) in the file, so readers using direct I/O read whole batches
+    ///        without reading into their neighbours. Recorded in the signal table's metadata.
+    void set_page_align_signal_batches(bool page_align_signal_batches)
+    {
+        m_page_align_signal_batches = page_align_signal_batches;
+    }
+
+    bool page_align_signal_batches() const { return m_page_align_signal_batches; }
+
     void set_write_chunk_size(std::size_t chunk_size) { m_write_chunk_size = chunk_size; }
 
     std::size_t write_chunk_size() const { return m_write_chunk_size; }
@@ -99,23 +254,321 @@ public:
 
     bool flush_on_batch_complete() const { return m_flush_on_batch_complete; }
 
+    /// \brief Set the longest a written table batch waits in the writer's buffers before it is
+    ///        flushed to the file, with deadlines waited for on a background thread.
+    ///
+    /// Used with set_flush_on_batch_complete(false), so live readers see batches within a bound
+    /// while the writer still flushes many batches at once. A deadline expiring while the writer
+    /// is busy is flushed by the writer's next call, rather than waiting for the writer.
+    /// \note Batches are written once full, as readers find signal rows by batch size, so this
+    ///       doesn't bound the wait for a batch to fill. 0 flushes on no deadline.
+    void set_max_flush_latency(std::chrono::milliseconds max_flush_latency)
+    {
+        m_max_flush_latency = max_flush_latency;
+    }
+
+    std::chrono::milliseconds max_flush_latency() const { return m_max_flush_latency; }
+
+    /// \brief Set the most bytes of written table batches held in the writer's buffers before
+    ///        they are flushed to the file, see set_max_flush_latency.
+    /// \note 0 flushes on no byte limit.
+    void set_max_unflushed_bytes(std::size_t max_unflushed_bytes)
+    {
+        m_max_unflushed_bytes = max_unflushed_bytes;
+    }
+
+    std::size_t max_unflushed_bytes() const { return m_max_unflushed_bytes; }
+
+    /// \brief Set the most bytes each of the writer's files queues for writing on the writer's
+    ///        IO threads before further writes wait for them.
+    /// \note 0 queues writes without limit. Files written with direct or sync io aren't queued
+    ///       this way, see FileWriter::try_add_complete_read.
+    void set_max_pending_write_bytes(std::size_t max_pending_write_bytes)
+    {
+        m_max_pending_write_bytes = max_pending_write_bytes;
+    }
+
+    std::size_t max_pending_write_bytes() const { return m_max_pending_write_bytes; }
+
+    /// \brief Set the most writes to each of the writer's files in flight at once on the
+    ///        writer's IO threads, each made at its own offset in the file.
+    ///
+    /// The writer makes an IO thread for each, unless a thread pool or writer resources are
+    /// set. 1 writes each file in order, one write at a time.
+    /// \note Files written with direct or sync io are written through the IO manager instead.
+    void set_max_parallel_writes(std::size_t max_parallel_writes)
+    {
+        m_max_parallel_writes = max_parallel_writes;
+    }
+
+    std::size_t max_parallel_writes() const { return m_max_parallel_writes; }
+
+    /// \brief Set how many signal table batches are written between recovery checkpoints.
+    ///
+    /// Each checkpoint flushes the signal table, then records where its batches end in a file
+    /// beside the output. recover_file_writer copies the batches listed without parsing them,
+    /// only reading batches written after the last checkpoint. The file is removed on close.
+    /// \note 0, the default, records no checkpoints, so writers leave no file beside the output
+    ///       unless asked to.
+    void set_recovery_checkpoint_interval(std::size_t signal_batches)
+    {
+        m_recovery_checkpoint_interval = signal_batches;
+    }
+
+    std::size_t recovery_checkpoint_interval() const { return m_recovery_checkpoint_interval; }
+
+    /// \brief Set the size the file is expected to reach, reserved when it is created so
+    ///        direct or sync io writes don't wait on the file growing.
+    /// \note 0 reserves space as the file grows, in reservations growing with the file.
+    void set_expected_file_size(std::size_t expected_file_size)
+    {
+        m_expected_file_size = expected_file_size;
+    }
+
+    std::size_t expected_file_size() const { return m_expected_file_size; }
+
+    /// \brief Set whether direct or sync io writes reserve file space on a background thread,
+    ///        rather than on the thread writing the file.
+    void set_preallocate_in_background(bool preallocate_in_background)
+    {
+        m_preallocate_in_background = preallocate_in_background;
+    }
+
+    bool preallocate_in_background() const { return m_preallocate_in_background; }
+
+    /// \brief Set whether a sorted read id index is embedded in the file when it is closed,
+    ///        letting readers search for read ids without scanning the read table.
+    /// \note Off by default, since released readers don't recognise the index's footer entry.
+    void set_write_read_id_index(bool write_read_id_index)
+    {
+        m_write_read_id_index = write_read_id_index;
+    }
+
+    bool write_read_id_index() const { return m_write_read_id_index; }
+
+    /// \brief Set whether a read id bloom filter is embedded in the file when it is closed,
+    ///        letting readers rule out read ids from the footer alone.
+    /// \note Off by default: readers older than the filter reject files embedding it.
+    void set_write_read_id_filter(bool write_read_id_filter)
+    {
+        m_write_read_id_filter = write_read_id_filter;
+    }
+
+    bool write_read_id_filter() const { return m_write_read_id_filter; }
+
+    /// \brief Set whether per batch read table statistics are embedded in the file when it is
+    ///        closed, letting readers skip batches which can't match a filter.
+    /// \note Off by default, as files embedding them can't be opened by older readers.
+    void set_write_read_table_statistics(bool write_read_table_statistics)
+    {
+        m_write_read_table_statistics = write_read_table_statistics;
+    }
+
+    bool write_read_table_statistics() const { return m_write_read_table_statistics; }
+
+    /// \brief Set whether a summary of the file's reads is embedded in the file when it is
+    ///        closed, letting readers count reads and samples from the footer alone.
+    /// \note Not written by default, older readers fail to open files holding a summary.
+    void set_write_file_summary(bool write_file_summary)
+    {
+        m_write_file_summary = write_file_summary;
+    }
+
+    bool write_file_summary() const { return m_write_file_summary; }
+
+    /// \brief Set whether the sample count of every signal table row is embedded in the file
+    ///        when it is closed, letting readers count and locate reads' samples without loading
+    ///        signal batches.
+    /// \note Defaults to off, so released readers, which reject the index, can open the file.
+    void set_write_signal_row_index(bool write_signal_row_index)
+    {
+        m_write_signal_row_index = write_signal_row_index;
+    }
+
+    bool write_signal_row_index() const { return m_write_signal_row_index; }
+
+    /// \brief Set whether the CRC32C checksum of each signal row, as stored in the file, is
+    ///        written beside the row, letting readers detect corrupt signal before decoding it.
+    /// \see FileReaderOptions::set_signal_checksum_interval
+    void set_write_signal_checksums(bool write_signal_checksums)
+    {
+        m_write_signal_checksums = write_signal_checksums;
+    }
+
+    bool write_signal_checksums() const { return m_write_signal_checksums; }
+
+    /// \brief Set whether the min, max, mean and standard deviation of each read's samples are
+    ///        written as columns of the read table, letting readers filter reads on their signal
+    ///        without decoding it.
+    ///
+    /// The statistics are found in one pass over each read's samples as it is added, on the
+    /// thread adding it. \see ReadTableBatchView::signal_min
+    /// \note Reads added as already written signal rows have null statistics.
+    void set_write_signal_statistics(bool write_signal_statistics)
+    {
+        m_write_signal_statistics = write_signal_statistics;
+    }
+
+    bool write_signal_statistics() const { return m_write_signal_statistics; }
+
+    /// \brief Set the decimations reads' signal is summarised at, as the min, max and mean of
+    ///        each run of that many samples, embedded in the file when it is closed.
+    ///
+    /// Lets readers draw a read's signal at a coarse scale without decompressing it, see
+    /// FileReader::signal_summary. Summaries are kept in a file beside the output until close.
+    /// \note Reads added as already written signal rows aren't summarised. Empty, the default,
+    ///       writes no summaries.
+    void set_signal_summary_decimations(std::vector<std::uint32_t> decimations)
+    {
+        m_signal_summary_decimations = std::move(decimations);
+    }
+
+    std::vector<std::uint32_t> const & signal_summary_decimations() const
+    {
+        return m_signal_summary_decimations;
+    }
+
+    /// \brief Set whether the read table is rewritten sorted by read id when the file is closed,
+    ///        letting readers search its read id column directly rather than building an index.
+    /// \note The whole read table is held in memory while it is sorted.
+    void set_sort_read_table_by_read_id(bool sort_read_table_by_read_id)
+    {
+        m_sort_read_table_by_read_id = sort_read_table_by_read_id;
+    }
+
+    bool sort_read_table_by_read_id() const { return m_sort_read_table_by_read_id; }
+
+    /// \brief Set how many signal chunks can be compressing at once on the writer's thread pool,
+    ///        rather than compressing on the thread adding each read.
+    ///
+    /// Reads are still written in the order they are added. Adding a read waits once this many
+    /// chunks are compressing, and an error compressing a chunk is returned by a later call.
+    /// If no thread pool is set, one with a thread per job is made for the writer.
+    /// \note 0 compresses signal on the calling thread.
+    void set_max_compression_jobs(std::size_t max_compression_jobs)
+    {
+        m_max_compression_jobs = max_compression_jobs;
+    }
+
+    std::size_t max_compression_jobs() const { return m_max_compression_jobs; }
+
+    /// \brief Set the most memory freed by written table batches which is kept for the builders
+    ///        of later batches to reuse, rather than returned to the memory pool.
+    /// \note 0 returns batch memory to the memory pool as soon as it is freed.
+    void set_max_recycled_batch_bytes(std::size_t max_recycled_batch_bytes)
+    {
+        m_max_recycled_batch_bytes = max_recycled_batch_bytes;
+    }
+
+    std::size_t max_recycled_batch_bytes() const { return m_max_recycled_batch_bytes; }
+
 private:
     std::shared_ptr<ThreadPool> m_writer_thread_pool;
+    std::shared_ptr<WriterResources> m_writer_resources;
     std::shared_ptr<IOManager> m_io_manager;
     std::uint32_t m_max_signal_chunk_size;
+    std::vector<std::uint32_t> m_signal_chunk_sizes;
     arrow::MemoryPool * m_memory_pool;
     SignalType m_signal_type;
+    SignalCompressionProfile m_signal_compression_profile;
+    std::shared_ptr<SignalCompressionDictionary const> m_signal_compression_dictionary;
+    std::shared_ptr<SignalCodec const> m_signal_codec;
     std::size_t m_signal_table_batch_size;
     std::size_t m_read_table_batch_size;
+    std::size_t m_signal_table_batch_bytes;
+    std::size_t m_read_table_batch_bytes;
     std::size_t m_run_info_table_batch_size;
+    arrow::Compression::type m_table_compression;
     bool m_use_directio;
+    bool m_page_align_signal_batches;
     std::size_t m_write_chunk_size;
     bool m_use_sync_io;
     bool m_flush_on_batch_complete;
+    std::size_t m_expected_file_size;
+    bool m_preallocate_in_background;
+    std::chrono::milliseconds m_max_flush_latency;
+    std::size_t m_max_unflushed_bytes;
+    std::size_t m_max_pending_write_bytes;
+    std::size_t m_max_parallel_writes;
+    std::size_t m_recovery_checkpoint_interval;
+    bool m_write_read_id_index;
+    bool m_write_read_id_filter;
+    bool m_write_read_table_statistics;
+    bool m_write_file_summary;
+    bool m_write_signal_row_index;
+    bool m_write_signal_checksums;
+    bool m_write_signal_statistics;
+    std::vector<std::uint32_t> m_signal_summary_decimations;
+    bool m_sort_read_table_by_read_id;
+    std::size_t m_max_compression_jobs;
+    std::size_t m_max_recycled_batch_bytes;
 };
 
+class FileWriter;
 class FileWriterImpl;
 
+/// \brief Add reads to a FileWriter from one of several threads at once.
+///
+/// Each producing thread owns a producer, which compresses signal on the calling thread and
+/// buffers reads locally. Buffered reads are committed to the file together under a short lock,
+/// so they are given signal row indices in the file's global signal table.
+/// \note Callers must flush() producers and check the result before the writer is closed.
+class POD5_FORMAT_EXPORT FileWriterProducer {
+public:
+    static constexpr std::size_t DEFAULT_MAX_PENDING_READS = 100;
+
+    /// \note Doesn't flush, as its errors couldn't be reported. Destroying a producer which still
+    ///       buffers reads drops them, and asserts in debug builds.
+    ~FileWriterProducer();
+
+    FileWriterProducer(FileWriterProducer const &) = delete;
+    FileWriterProducer & operator=(FileWriterProducer const &) = delete;
+
+    /// \brief Compress [signal] and buffer the read, committing buffered reads to the file once
+    ///        the producer holds its maximum pending reads.
+    /// \note Reads are checked against the writer's dictionaries as they are committed.
+    pod5::Status add_complete_read(
+        ReadData const & read_data,
+        gsl::span<std::int16_t const> const & signal);
+
+    /// \brief Commit every buffered read to the file.
+    /// \note Buffered reads are dropped whether or not committing them succeeds.
+    pod5::Status flush();
+
+    /// \brief Find the number of reads buffered and not yet committed to the file.
+    std::size_t pending_read_count() const { return m_reads.size(); }
+
+private:
+    friend class FileWriter;
+
+    FileWriterProducer(FileWriter & writer, std::size_t max_pending_reads);
+
+    struct PendingRead {
+        ReadData read_data;
+        std::uint64_t signal_duration;
+        std::size_t chunk_count;
+        // Unset unless the writer writes signal statistics:
+        std::optional<SignalStatistics> signal_statistics;
+    };
+
+    FileWriter & m_writer;
+    std::size_t m_max_pending_reads;
+    SignalType m_signal_type;
+    SignalCompressionProfile m_compression_profile;
+    std::shared_ptr<SignalCompressionDictionary const> m_compression_dictionary;
+    std::shared_ptr<SignalCodec const> m_codec;
+    SignalChunker m_signal_chunker;
+    bool m_write_signal_statistics;
+
+    std::vector<PendingRead> m_reads;
+    // Signal chunks of every pending read, in order, packed into one buffer:
+    std::vector<std::uint8_t> m_chunk_data;
+    std::vector<std::size_t> m_chunk_offsets;
+    std::vector<std::uint32_t> m_chunk_sample_counts;
+};
+
+/// \note Writer calls are serialised, so a writer can be shared between threads, along with
+///       any producers created for it.
 class POD5_FORMAT_EXPORT FileWriter {
 public:
     FileWriter(std::unique_ptr<FileWriterImpl> && impl);
@@ -123,18 +576,79 @@ public:
 
     std::string path() const;
 
+    /// \brief Close the file, writing its tables and footer.
+    /// \note Waits for a close started by close_async() to finish, returning its result.
     pod5::Status close();
 
+    /// \brief Close the file on [thread_pool], without blocking the caller.
+    ///
+    /// The tables are flushed, queued writes waited for, and the footer written on
+    /// [thread_pool], with any error reported through the returned future. The writer can be
+    /// destroyed straight away, it is kept alive until the close completes. Further calls
+    /// return the same future, and no reads should be added once it is called.
+    /// \note Closing waits for the writes queued to the writer's IO pool, so if [thread_pool] is
+    ///       that pool it needs a spare thread.
+    arrow::Future<> close_async(ThreadPool & thread_pool);
+
     pod5::Status add_complete_read(
         ReadData const & read_data,
         gsl::span<std::int16_t const> const & signal);
 
+    /// \brief Add a complete read unless the writer would wait to add it, for producers which
+    ///        must never block.
+    ///
+    /// A read is refused while another thread's call holds the writer, while any of the
+    /// writer's files has more than the max pending write bytes queued (see
+    /// FileWriterOptions::set_max_pending_write_bytes), or while signal compressing on a thread
+    /// pool fills the max compression jobs. An accepted read is added without waiting, so the
+    /// queues can go over their limits by one read's batches and signal chunks.
+    /// \note Flushes due by the max unflushed bytes or recovery checkpoint interval, and files
+    ///       written with direct or sync io, still write on the calling thread.
+    /// \returns Whether the read was added.
+    /// \see set_write_capacity_callback()
+    pod5::Result<bool> try_add_complete_read(
+        ReadData const & read_data,
+        gsl::span<std::int16_t const> const & signal);
+
+    /// \brief Find if the writer's write and compression queues have room for another read, so
+    ///        try_add_complete_read() would accept it. False while another thread holds the writer.
+    bool has_write_capacity() const;
+
+    /// \brief Set a function called when the writer may accept a read try_add_complete_read()
+    ///        refused.
+    /// \note Called from the writer's IO, compression or flush threads, so it should signal the
+    ///       producer rather than call the writer. It may be called while reads are still refused,
+    ///       or once the writer has failed.
+    void set_write_capacity_callback(std::function<void()> callback);
+
+    /// \brief Add a complete read, sharing ownership of its signal samples.
+    /// \note When signal is compressed on a thread pool (see
+    ///       FileWriterOptions::set_max_compression_jobs) chunks are compressed straight from
+    ///       [signal] rather than copied first, and [signal] is released once all are compressed.
+    pod5::Status add_complete_read(
+        ReadData const & read_data,
+        std::shared_ptr<arrow::Buffer> const & signal);
+
+    /// \brief Add a complete read, taking ownership of its signal, as above.
+    pod5::Status add_complete_read(ReadData const & read_data, std::vector<std::int16_t> && signal);
+
     /// \brief Add a complete with rows already pre appended.
     pod5::Status add_complete_read(
         ReadData const & read_data,
         gsl::span<std::uint64_t const> const & signal_rows,
         std::uint64_t signal_duration);
 
+    /// \brief Add many complete reads at once, appending each field's column to the read table
+    ///        in bulk rather than read by read.
+    /// \param reads The fields of every read, see ReadDataColumns.
+    /// \param signals The signal of each read in [reads], in the same order.
+    /// \note Signal is compressed in parallel on the writer's compression thread pool, or a pool
+    ///       made for bulk adds if signal isn't compressed on a pool (see
+    ///       FileWriterOptions::set_max_compression_jobs), outside the writer's lock.
+    pod5::Status add_reads(
+        ReadDataColumns const & reads,
+        gsl::span<gsl::span<std::int16_t const> const> const & signals);
+
     pod5::Result<std::vector<SignalTableRowIndex>> add_signal(
         Uuid const & read_id,
         gsl::span<std::int16_t const> const & signal);
@@ -149,18 +663,46 @@ public:
         std::vector<std::shared_ptr<arrow::Array>> && columns,
         bool final_batch);
 
+    /// \brief Add a signal table batch read from another file, copying its encoded bytes
+    ///        without decoding them (see FileReader::read_signal_record_batch_message()).
+    /// \param message The batch's record batch message, from a signal table with this file's
+    ///                signal type, compression dictionary, signal checksums and batch size.
+    /// \param row_count The rows held by the batch, which must be the table batch size.
+    /// \returns The row index of the first row of the batch.
+    pod5::Result<SignalTableRowIndex> add_raw_signal_batch(
+        arrow::ipc::Message const & message,
+        std::size_t row_count);
+
     // Find or create an end reason index representing this read end reason.
     pod5::Result<EndReasonDictionaryIndex> lookup_end_reason(ReadEndReason end_reason) const;
     pod5::Result<PoreDictionaryIndex> add_pore_type(std::string const & pore_type_data);
     pod5::Result<RunInfoDictionaryIndex> add_run_info(RunInfoData const & run_info_data);
 
     SignalType signal_type() const;
+    SignalCompressionProfile const & signal_compression_profile() const;
+    std::shared_ptr<SignalCompressionDictionary const> const & signal_compression_dictionary()
+        const;
+    /// \brief Find if the file stores a checksum of each signal row.
+    bool writes_signal_checksums() const;
     std::size_t signal_table_batch_size() const;
 
+    /// \brief Find the bytes of signal added to the file so far, as compressed in the file.
+    /// \note Signal still compressing on the writer's thread pool isn't counted.
+    std::size_t signal_bytes() const;
+
+    /// \brief Create a producer adding reads to this writer from another thread.
+    /// \param max_pending_reads The reads the producer buffers before committing them.
+    std::unique_ptr<FileWriterProducer> create_producer(
+        std::size_t max_pending_reads = FileWriterProducer::DEFAULT_MAX_PENDING_READS);
+
     FileWriterImpl * impl() const { return m_impl.get(); };
 
 private:
-    std::unique_ptr<FileWriterImpl> m_impl;
+    friend class FileWriterProducer;
+
+    // Shared with a close running on a thread pool, which may outlive the writer:
+    std::shared_ptr<FileWriterImpl> m_impl;
+    std::shared_ptr<std::mutex> m_sync;
 };
 
 POD5_FORMAT_EXPORT pod5::Result<std::unique_ptr<FileWriter>> create_file_writer(
@@ -168,9 +710,56 @@ POD5_FORMAT_EXPORT pod5::Result<std::unique_ptr<FileWriter>> create_file_writer(
     std::string const & writing_software_name,
     FileWriterOptions const & options = {});
 
+/// \brief Create a writer producing a whole file into [sink], such as a buffer or a socket.
+///
+/// The signal table is written to [sink] as reads are added, while the run info and read tables
+/// are held in memory, rather than in files beside the output, until the writer is closed and
+/// they are written after it. Positions are counted from the first byte written, so [sink]
+/// needn't support Tell().
+/// \note No signal row index or recovery checkpoints are written, as the file can't be read back
+///       as it is written, and FileWriter::path() is empty. [sink] is flushed, not closed, as the
+///       writer closes.
+POD5_FORMAT_EXPORT pod5::Result<std::unique_ptr<FileWriter>> create_file_writer(
+    std::shared_ptr<arrow::io::OutputStream> const & sink,
+    std::string const & writing_software_name,
+    FileWriterOptions const & options = {});
+
+/// \brief Open a writer adding reads to the closed file at [path], without writing its existing
+///        signal again.
+///
+/// New signal batches are staged beside the file until the writer closes, then the file is
+/// truncated where its signal table's batches end and the new batches copied in after them, the
+/// signal table's footer listing old and new batches alike. The run info and read tables are
+/// written again as the writer closes, holding the file's reads followed by those added, with
+/// the file's indexes rebuilt over all of them. A short last signal batch is cut from the file,
+/// its rows starting the first new batch, as only a table's last batch may be short.
+///
+/// The signal table keeps the signal type, compression, checksums, batch size and batch
+/// alignment it was written with, whatever [options] ask for, and the file keeps its identifier.
+/// \returns Invalid, leaving the file untouched, if the file's tables can't be continued by this
+///          version of pod5, or [options] ask for signal summaries.
+/// \note The file is left as it was, and readable, until the writer closes, so a writer which
+///       is never closed leaves the file without the reads added. No recovery checkpoints are
+///       written.
+POD5_FORMAT_EXPORT pod5::Result<std::unique_ptr<FileWriter>> open_file_writer_for_append(
+    std::string const & path,
+    std::string const & writing_software_name,
+    FileWriterOptions const & options = {});
+
+/// \brief How recover_file_writer reads the file it recovers.
+struct FileRecoveryOptions {
+    /// Copy signal table batches whose IPC framing is intact straight to the recovered file,
+    /// rather than decoding and writing them again. Read and run info batches are always decoded,
+    /// as their dictionaries are rebuilt by the recovered file's writers.
+    bool pass_through_signal_batches = true;
+    /// Recover the signal, read and run info tables at the same time, each on a thread of its own.
+    bool recover_tables_concurrently = true;
+};
+
 POD5_FORMAT_EXPORT pod5::Result<std::unique_ptr<FileWriter>> recover_file_writer(
     std::string const & src_path,
     std::string const & dest_path,
-    FileWriterOptions const & options = {});
+    FileWriterOptions const & options = {},
+    FileRecoveryOptions const & recovery_options = {});
 
 }  // namespace pod5
@@ -5,13 +5,26 @@
 #include "pod5_format/thread_pool.h"
 
 #include <arrow/buffer.h>
+#include <arrow/io/file.h>
 #include <arrow/util/future.h>
 #include <gsl/gsl-lite.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
 #include <condition_variable>
+#include <cstring>
 #include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 namespace pod5 {
 
@@ -19,13 +32,36 @@ class AsyncOutputStream : public FileOutputStream {
     struct PrivateDummy {};
 
 public:
+    static constexpr std::size_t DEFAULT_MAX_PENDING_WRITE_BYTES = 10 * 1024 * 1024;
+
+    /// \param max_pending_write_bytes The most bytes of writes queued before writes wait, 0 for
+    ///                                no limit.
+    /// \param max_parallel_writes The most writes in flight on [thread_pool] at once. Above 1,
+    ///                            writes to a file stream are made at their offsets in the file,
+    ///                            so they can land in any order, otherwise they are made one at a
+    ///                            time through the stream.
     static arrow::Result<std::shared_ptr<AsyncOutputStream>> make(
         std::shared_ptr<OutputStream> const & main_stream,
         std::shared_ptr<ThreadPool> const & thread_pool,
-        arrow::MemoryPool * memory_pool = arrow::default_memory_pool())
+        arrow::MemoryPool * memory_pool = arrow::default_memory_pool(),
+        std::size_t max_pending_write_bytes = DEFAULT_MAX_PENDING_WRITE_BYTES,
+        std::size_t max_parallel_writes = 1)
     {
+        std::optional<std::int64_t> file_start;
+#ifndef _WIN32
+        auto const file = dynamic_cast<arrow::io::FileOutputStream *>(main_stream.get());
+        if (file && max_parallel_writes > 1) {
+            ARROW_ASSIGN_OR_RAISE(file_start, file->Tell());
+        }
+#endif
         return std::make_shared<AsyncOutputStream>(
-            main_stream, thread_pool, memory_pool, PrivateDummy{});
+            main_stream,
+            thread_pool,
+            memory_pool,
+            max_pending_write_bytes,
+            file_start ? max_parallel_writes : 1,
+            file_start,
+            PrivateDummy{});
     }
 
     ~AsyncOutputStream() { (void)Close(); }
@@ -80,26 +116,39 @@ public:
             return error();
         }
 
-        std::size_t const BUFFER_SIZE = 10 * 1024 * 1024;  // 10mb pending writes max
-        while ((m_submitted_byte_writes - m_completed_byte_writes) > BUFFER_SIZE) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        if (m_wait_for_write_capacity && !has_write_capacity()) {
+            std::unique_lock<std::mutex> l(m_capacity_mutex);
+            m_capacity_changed.wait(l, [&] { return has_write_capacity() || m_has_error; });
+            if (m_has_error) {
+                return error();
+            }
         }
 
+        // Each write's place in the file is fixed as it is submitted, so positional writes can
+        // be made in any order:
+        auto const file_offset = m_file_start + std::int64_t(m_submitted_byte_writes.load());
         m_submitted_byte_writes += data->size();
         m_actual_bytes_written += data->size();
+        if (!has_write_capacity()) {
+            m_over_capacity = true;
+        }
 
+        auto const & strand = m_strands[m_submitted_writes % m_strands.size()];
         m_submitted_writes += 1;
-        m_strand->post([&, data] {
+        strand->post([&, data, file_offset] {
             POD5_TRACE_FUNCTION();
             if (m_has_error) {
                 return;
             }
 
-            auto result = m_main_stream->Write(data);
+            auto result =
+                m_positional_writes ? write_at(*data, file_offset) : m_main_stream->Write(data);
             m_completed_byte_writes += data->size();
 
             if (!result.ok()) {
                 set_error(std::move(result));
+            } else if (has_write_capacity() && m_over_capacity.exchange(false)) {
+                write_capacity_freed();
             }
 
             // Ensure we do this after editing all the other members, in order to prevent `Flush`
@@ -113,8 +162,9 @@ public:
     arrow::Status Flush() override
     {
         POD5_TRACE_FUNCTION();
-        // Wait for our completed writes to match our submitted writes,
-        // this guarantees our async operations are finished.
+        // Wait for our completed writes to match our submitted writes, this guarantees our async
+        // operations are finished. Writes are only submitted by the caller, so every write
+        // before the flush is complete once as many have completed, in whatever order.
         auto wait_for_write_count = m_submitted_writes.load();
         while (m_completed_writes.load() < wait_for_write_count && !m_has_error) {
             std::this_thread::sleep_for(std::chrono::microseconds(10));
@@ -134,10 +184,31 @@ public:
 
     void set_file_start_offset(std::size_t val) override { m_file_start_offset = val; }
 
+    std::size_t pending_write_bytes() const override
+    {
+        return m_submitted_byte_writes.load() - m_completed_byte_writes.load();
+    }
+
+    bool has_write_capacity() const override
+    {
+        return m_max_pending_write_bytes == 0 || pending_write_bytes() <= m_max_pending_write_bytes;
+    }
+
+    void set_wait_for_write_capacity(bool wait) override { m_wait_for_write_capacity = wait; }
+
+    void set_write_capacity_callback(std::function<void()> callback) override
+    {
+        std::lock_guard<std::mutex> l{m_capacity_mutex};
+        m_write_capacity_callback = std::move(callback);
+    }
+
     AsyncOutputStream(
         std::shared_ptr<OutputStream> const & main_stream,
         std::shared_ptr<ThreadPool> const & thread_pool,
         arrow::MemoryPool * memory_pool,
+        std::size_t max_pending_write_bytes,
+        std::size_t max_parallel_writes,
+        std::optional<std::int64_t> file_start,
         PrivateDummy)
     : m_has_error{false}
     , m_submitted_writes{0}
@@ -147,9 +218,16 @@ public:
     , m_actual_bytes_written{0}
     , m_main_stream{main_stream}
     , m_file_start_offset{0}
-    , m_strand{thread_pool->create_strand()}
     , m_memory_pool(memory_pool)
+    , m_max_pending_write_bytes(max_pending_write_bytes)
+    , m_over_capacity{false}
+    , m_positional_writes(file_start.has_value())
+    , m_file_start(file_start.value_or(0))
     {
+        // Each strand writes one at a time, so the strands bound the writes in flight:
+        for (std::size_t i = 0; i < std::max<std::size_t>(max_parallel_writes, 1); ++i) {
+            m_strands.push_back(thread_pool->create_strand());
+        }
     }
 
 protected:
@@ -169,6 +247,8 @@ protected:
             m_error = std::move(status);
         }
         m_has_error = true;
+        // Writes waiting for capacity return the error instead:
+        write_capacity_freed();
     }
 
     arrow::Status error() const
@@ -190,12 +270,63 @@ protected:
     std::shared_ptr<OutputStream> m_main_stream;
 
 private:
+    arrow::Status write_at(arrow::Buffer const & data, std::int64_t offset)
+    {
+#ifndef _WIN32
+        auto const fd =
+            static_cast<arrow::io::FileOutputStream *>(m_main_stream.get())->file_descriptor();
+        auto remaining = gsl::make_span(data.data(), data.size());
+        while (!remaining.empty()) {
+            auto const written = ::pwrite(fd, remaining.data(), remaining.size(), offset);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return arrow::Status::IOError("Failed to write file: ", std::strerror(errno));
+            }
+            remaining = remaining.subspan(std::size_t(written));
+            offset += written;
+        }
+        return arrow::Status::OK();
+#else
+        (void)data;
+        (void)offset;
+        return arrow::Status::NotImplemented("Positional writes are not supported");
+#endif
+    }
+
+    void write_capacity_freed()
+    {
+        std::function<void()> callback;
+        {
+            std::lock_guard<std::mutex> l{m_capacity_mutex};
+            callback = m_write_capacity_callback;
+        }
+        m_capacity_changed.notify_all();
+        if (callback) {
+            callback();
+        }
+    }
+
     mutable std::mutex m_error_mutex;
     arrow::Status m_error;
 
     std::size_t m_file_start_offset;
-    std::shared_ptr<ThreadPoolStrand> m_strand;
     arrow::MemoryPool * m_memory_pool;
+
+    std::size_t m_max_pending_write_bytes;
+    bool m_wait_for_write_capacity = true;
+    // Set once queued writes go over the limit, cleared as they fall back within it:
+    std::atomic<bool> m_over_capacity;
+    std::mutex m_capacity_mutex;
+    std::condition_variable m_capacity_changed;
+    std::function<void()> m_write_capacity_callback;
+
+    // Whether writes are made at their offsets, from [m_file_start], rather than through the
+    // main stream:
+    bool m_positional_writes;
+    std::int64_t m_file_start;
+    std::vector<std::shared_ptr<ThreadPoolStrand>> m_strands;
 };
 
 }  // namespace pod5
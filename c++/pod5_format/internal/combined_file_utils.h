@@ -3,16 +3,29 @@
 #include "footer_generated.h"
 #include "pod5_format/file_reader.h"
 #include "pod5_format/result.h"
+#include "pod5_format/table_reader.h"
 #include "pod5_format/uuid.h"
 #include "pod5_format/version.h"
 
 #include <arrow/buffer.h>
 #include <arrow/io/file.h>
 #include <arrow/util/endian.h>
+#include <arrow/util/future.h>
 #include <arrow/util/io_util.h>
 #include <flatbuffers/flatbuffers.h>
 
 #include <array>
+#include <atomic>
+#include <optional>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
 
 namespace pod5 { namespace combined_file_utils {
 
@@ -63,6 +76,8 @@ inline pod5::Status write_footer_magic(std::shared_ptr<arrow::io::OutputStream>
 struct FileInfo {
     std::int64_t file_start_offset = 0;
     std::int64_t file_length = 0;
+    // The locations of the file's record batches, relative to its start, if they are listed.
+    std::vector<RecordBatchLocation> batch_locations;
 };
 
 struct ParsedFileInfo : FileInfo {
@@ -80,39 +95,62 @@ struct ParsedFileInfo : FileInfo {
     }
 };
 
+inline flatbuffers::Offset<Minknow::ReadsFormat::EmbeddedFile> create_embedded_file(
+    flatbuffers::FlatBufferBuilder & builder,
+    FileInfo const & file_info,
+    Minknow::ReadsFormat::ContentType content_type)
+{
+    flatbuffers::Offset<flatbuffers::Vector<Minknow::ReadsFormat::BatchLocation const *>> batches;
+    if (!file_info.batch_locations.empty()) {
+        std::vector<Minknow::ReadsFormat::BatchLocation> locations;
+        locations.reserve(file_info.batch_locations.size());
+        for (auto const & location : file_info.batch_locations) {
+            locations.emplace_back(
+                location.offset,
+                location.metadata_length,
+                location.body_length,
+                location.row_count);
+        }
+        batches = builder.CreateVectorOfStructs(locations);
+    }
+    return Minknow::ReadsFormat::CreateEmbeddedFile(
+        builder,
+        file_info.file_start_offset,
+        file_info.file_length,
+        Minknow::ReadsFormat::Format_FeatherV2,
+        content_type,
+        batches);
+}
+
 inline pod5::Result<std::int64_t> write_footer_flatbuffer(
     std::shared_ptr<arrow::io::OutputStream> const & sink,
     Uuid const & file_identifier,
     std::string const & software_name,
     FileInfo const & signal_table,
     FileInfo const & run_info_table,
-    FileInfo const & reads_table)
+    FileInfo const & reads_table,
+    std::optional<FileInfo> const & read_id_index,
+    std::vector<FileInfo> const & other_indexes)
 {
     flatbuffers::FlatBufferBuilder builder(1024);
 
-    auto signal_file = Minknow::ReadsFormat::CreateEmbeddedFile(
-        builder,
-        signal_table.file_start_offset,
-        signal_table.file_length,
-        Minknow::ReadsFormat::Format_FeatherV2,
-        Minknow::ReadsFormat::ContentType_SignalTable);
-
-    auto run_info_file = Minknow::ReadsFormat::CreateEmbeddedFile(
-        builder,
-        run_info_table.file_start_offset,
-        run_info_table.file_length,
-        Minknow::ReadsFormat::Format_FeatherV2,
-        Minknow::ReadsFormat::ContentType_RunInfoTable);
-
-    auto reads_file = Minknow::ReadsFormat::CreateEmbeddedFile(
-        builder,
-        reads_table.file_start_offset,
-        reads_table.file_length,
-        Minknow::ReadsFormat::Format_FeatherV2,
-        Minknow::ReadsFormat::ContentType_ReadsTable);
+    auto signal_file = create_embedded_file(
+        builder, signal_table, Minknow::ReadsFormat::ContentType_SignalTable);
+    auto run_info_file = create_embedded_file(
+        builder, run_info_table, Minknow::ReadsFormat::ContentType_RunInfoTable);
+    auto reads_file =
+        create_embedded_file(builder, reads_table, Minknow::ReadsFormat::ContentType_ReadsTable);
 
-    std::vector<flatbuffers::Offset<Minknow::ReadsFormat::EmbeddedFile>> const files{
+    std::vector<flatbuffers::Offset<Minknow::ReadsFormat::EmbeddedFile>> files{
         signal_file, run_info_file, reads_file};
+    if (read_id_index) {
+        files.push_back(create_embedded_file(
+            builder, *read_id_index, Minknow::ReadsFormat::ContentType_ReadIdIndex));
+    }
+    for (auto const & other_index : other_indexes) {
+        files.push_back(create_embedded_file(
+            builder, other_index, Minknow::ReadsFormat::ContentType_OtherIndex));
+    }
     auto footer = Minknow::ReadsFormat::CreateFooterDirect(
         builder,
         to_string(file_identifier).c_str(),
@@ -132,13 +170,22 @@ inline pod5::Status write_footer(
     std::string const & software_name,
     FileInfo const & signal_table,
     FileInfo const & run_info_table,
-    FileInfo const & reads_table)
+    FileInfo const & reads_table,
+    std::optional<FileInfo> const & read_id_index = std::nullopt,
+    std::vector<FileInfo> const & other_indexes = {})
 {
     ARROW_RETURN_NOT_OK(write_footer_magic(sink));
     ARROW_ASSIGN_OR_RAISE(
         std::int64_t length,
         write_footer_flatbuffer(
-            sink, file_identifier, software_name, signal_table, run_info_table, reads_table));
+            sink,
+            file_identifier,
+            software_name,
+            signal_table,
+            run_info_table,
+            reads_table,
+            read_id_index,
+            other_indexes));
     ARROW_RETURN_NOT_OK(pad_file(sink, 8));
 
     std::int64_t paded_flatbuffer_size = arrow::bit_util::ToLittleEndian(length);
@@ -156,6 +203,10 @@ struct ParsedFooter {
     ParsedFileInfo run_info_table;
     ParsedFileInfo reads_table;
     ParsedFileInfo signal_table;
+    // Optional, files written before the index was added don't contain one.
+    ParsedFileInfo read_id_index;
+    // Optional indexes which aren't part of the core format, such as the read id filter.
+    std::vector<ParsedFileInfo> other_indexes;
 };
 
 inline pod5::Status check_signature(
@@ -183,6 +234,29 @@ inline pod5::Result<Minknow::ReadsFormat::Footer const *> read_footer_flatbuffer
     return flatbuffers::GetRoot<Minknow::ReadsFormat::Footer>(footer_data.data());
 }
 
+inline ParsedFileInfo read_embedded_file(
+    Minknow::ReadsFormat::EmbeddedFile const & embedded_file,
+    std::string const & file_path,
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file)
+{
+    ParsedFileInfo file_info;
+    file_info.file_start_offset = embedded_file.offset();
+    file_info.file_length = embedded_file.length();
+    if (auto const batches = embedded_file.batches()) {
+        file_info.batch_locations.reserve(batches->size());
+        for (auto const batch : *batches) {
+            file_info.batch_locations.push_back(
+                {batch->offset(),
+                 batch->metadata_length(),
+                 batch->body_length(),
+                 batch->row_count()});
+        }
+    }
+    file_info.file = file;
+    file_info.file_path = file_path;
+    return file_info;
+}
+
 inline pod5::Result<ParsedFooter> read_footer(
     std::string const & file_path,
     std::shared_ptr<arrow::io::RandomAccessFile> const & file)
@@ -249,22 +323,19 @@ inline pod5::Result<ParsedFooter> read_footer(
         }
         switch (embedded_file->content_type()) {
         case Minknow::ReadsFormat::ContentType_RunInfoTable:
-            footer.run_info_table.file_start_offset = embedded_file->offset();
-            footer.run_info_table.file_length = embedded_file->length();
-            footer.run_info_table.file = file;
-            footer.run_info_table.file_path = file_path;
+            footer.run_info_table = read_embedded_file(*embedded_file, file_path, file);
             break;
         case Minknow::ReadsFormat::ContentType_ReadsTable:
-            footer.reads_table.file_start_offset = embedded_file->offset();
-            footer.reads_table.file_length = embedded_file->length();
-            footer.reads_table.file = file;
-            footer.reads_table.file_path = file_path;
+            footer.reads_table = read_embedded_file(*embedded_file, file_path, file);
             break;
         case Minknow::ReadsFormat::ContentType_SignalTable:
-            footer.signal_table.file_start_offset = embedded_file->offset();
-            footer.signal_table.file_length = embedded_file->length();
-            footer.signal_table.file = file;
-            footer.signal_table.file_path = file_path;
+            footer.signal_table = read_embedded_file(*embedded_file, file_path, file);
+            break;
+        case Minknow::ReadsFormat::ContentType_ReadIdIndex:
+            footer.read_id_index = read_embedded_file(*embedded_file, file_path, file);
+            break;
+        case Minknow::ReadsFormat::ContentType_OtherIndex:
+            footer.other_indexes.push_back(read_embedded_file(*embedded_file, file_path, file));
             break;
 
         default:
@@ -277,14 +348,54 @@ inline pod5::Result<ParsedFooter> read_footer(
 
 class SubFile : public arrow::io::internal::RandomAccessFileConcurrencyWrapper<SubFile> {
 public:
+    /// \param bytes_read  Counter to add the bytes read from the sub file to, if any.
+    /// \param pool        Pool to allocate the buffers read from the sub file from, if set and
+    ///                    the main file copies its reads, so the sub file's memory use is
+    ///                    counted apart from the main file's.
     SubFile(
         std::shared_ptr<arrow::io::RandomAccessFile> main_file,
         std::int64_t sub_file_offset,
-        std::int64_t sub_file_length)
+        std::int64_t sub_file_length,
+        std::shared_ptr<std::atomic<std::uint64_t>> bytes_read = nullptr,
+        arrow::MemoryPool * pool = nullptr)
     : m_file(std::move(main_file))
     , m_sub_file_offset(sub_file_offset)
     , m_sub_file_length(sub_file_length)
+    , m_bytes_read(std::move(bytes_read))
+    , m_pool(pool && !m_file->supports_zero_copy() ? pool : nullptr)
+    {
+    }
+
+    arrow::Status WillNeed(std::vector<arrow::io::ReadRange> const & ranges) override
+    {
+        // Forward read ahead hints to the main file, offset to this sub file's location:
+        std::vector<arrow::io::ReadRange> main_file_ranges;
+        main_file_ranges.reserve(ranges.size());
+        for (auto const & range : ranges) {
+            if (range.offset < 0 || range.length < 0 || range.offset > m_sub_file_length) {
+                return arrow::Status::IOError("Invalid range in SubFile");
+            }
+            main_file_ranges.push_back(
+                {range.offset + m_sub_file_offset,
+                 std::min(range.length, m_sub_file_length - range.offset)});
+        }
+        return m_file->WillNeed(main_file_ranges);
+    }
+
+    arrow::Future<std::shared_ptr<arrow::Buffer>> ReadAsync(
+        arrow::io::IOContext const & io_context,
+        std::int64_t position,
+        std::int64_t nbytes) override
     {
+        // Forward to the main file, so files with their own asynchronous reads keep them:
+        if (position < 0 || position > m_sub_file_length) {
+            return arrow::Future<std::shared_ptr<arrow::Buffer>>::MakeFinished(
+                arrow::Status::IOError("Invalid offset into SubFile"));
+        }
+        int64_t const remaining = m_sub_file_length - position;
+        nbytes = std::min(nbytes, remaining);
+        count_bytes_read(nbytes);
+        return m_file->ReadAsync(io_context, position + m_sub_file_offset, nbytes);
     }
 
 protected:
@@ -312,7 +423,9 @@ protected:
         ARROW_ASSIGN_OR_RAISE(auto pos, m_file->Tell());
         int64_t const remaining = m_sub_file_offset + m_sub_file_length - pos;
         length = std::min(remaining, length);
-        return m_file->Read(length, data);
+        ARROW_ASSIGN_OR_RAISE(auto const bytes_read, m_file->Read(length, data));
+        count_bytes_read(bytes_read);
+        return bytes_read;
     }
 
     arrow::Result<std::shared_ptr<arrow::Buffer>> DoRead(int64_t length)
@@ -320,7 +433,9 @@ protected:
         ARROW_ASSIGN_OR_RAISE(auto pos, m_file->Tell());
         int64_t const remaining = m_sub_file_offset + m_sub_file_length - pos;
         length = std::min(remaining, length);
-        return m_file->Read(length);
+        ARROW_ASSIGN_OR_RAISE(auto buffer, m_file->Read(length));
+        count_bytes_read(buffer->size());
+        return buffer;
     }
 
     Result<int64_t> DoReadAt(int64_t position, int64_t nbytes, void * out)
@@ -330,7 +445,10 @@ protected:
         }
         int64_t const remaining = m_sub_file_length - position;
         nbytes = std::min(nbytes, remaining);
-        return m_file->ReadAt(position + m_sub_file_offset, nbytes, out);
+        ARROW_ASSIGN_OR_RAISE(
+            auto const bytes_read, m_file->ReadAt(position + m_sub_file_offset, nbytes, out));
+        count_bytes_read(bytes_read);
+        return bytes_read;
     }
 
     Result<std::shared_ptr<arrow::Buffer>> DoReadAt(int64_t position, int64_t nbytes)
@@ -340,7 +458,19 @@ protected:
         }
         int64_t const remaining = m_sub_file_length - position;
         nbytes = std::min(nbytes, remaining);
-        return m_file->ReadAt(position + m_sub_file_offset, nbytes);
+        if (m_pool) {
+            ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateResizableBuffer(nbytes, m_pool));
+            ARROW_ASSIGN_OR_RAISE(
+                auto const bytes_read,
+                m_file->ReadAt(position + m_sub_file_offset, nbytes, buffer->mutable_data()));
+            ARROW_RETURN_NOT_OK(buffer->Resize(bytes_read, false));
+            buffer->ZeroPadding();
+            count_bytes_read(bytes_read);
+            return std::shared_ptr<arrow::Buffer>(std::move(buffer));
+        }
+        ARROW_ASSIGN_OR_RAISE(auto buffer, m_file->ReadAt(position + m_sub_file_offset, nbytes));
+        count_bytes_read(buffer->size());
+        return buffer;
     }
 
     arrow::Result<std::int64_t> DoGetSize() { return m_sub_file_length; }
@@ -348,12 +478,26 @@ protected:
 private:
     friend RandomAccessFileConcurrencyWrapper<SubFile>;
 
+    void count_bytes_read(std::int64_t bytes)
+    {
+        if (m_bytes_read) {
+            *m_bytes_read += bytes;
+        }
+    }
+
     std::shared_ptr<arrow::io::RandomAccessFile> m_file;
     std::int64_t m_sub_file_offset;
     std::int64_t m_sub_file_length;
+    std::shared_ptr<std::atomic<std::uint64_t>> m_bytes_read;
+    arrow::MemoryPool * m_pool;
 };
 
-inline arrow::Result<std::shared_ptr<SubFile>> open_sub_file(ParsedFileInfo file_info)
+/// \param bytes_read  Counter to add the bytes read from the sub file to, if any.
+/// \param pool        Pool to allocate the buffers read from the sub file from, see SubFile.
+inline arrow::Result<std::shared_ptr<SubFile>> open_sub_file(
+    ParsedFileInfo file_info,
+    std::shared_ptr<std::atomic<std::uint64_t>> bytes_read = nullptr,
+    arrow::MemoryPool * pool = nullptr)
 {
     if (!file_info.file) {
         return arrow::Status::Invalid("Failed to open file from footer");
@@ -366,7 +510,11 @@ inline arrow::Result<std::shared_ptr<SubFile>> open_sub_file(ParsedFileInfo file
     }
     // Restrict our open file to just the run info section:
     auto sub_file = std::make_shared<SubFile>(
-        file_info.file, file_info.file_start_offset, file_info.file_length);
+        file_info.file,
+        file_info.file_start_offset,
+        file_info.file_length,
+        std::move(bytes_read),
+        pool);
     ARROW_RETURN_NOT_OK(sub_file->Seek(0));
     return sub_file;
 }
@@ -389,6 +537,68 @@ inline arrow::Result<std::shared_ptr<SubFile>> open_sub_file(
 
 enum class SubFileCleanup { CleanupOriginalFile, LeaveOrignalFile };
 
+/// \brief Open [path] to write to its end.
+/// \note On Linux the file is opened without O_APPEND, which copy_file_range refuses to write to,
+///       and the stream is positioned at the end of the file instead.
+inline arrow::Result<std::shared_ptr<arrow::io::FileOutputStream>> open_file_for_append(
+    std::string const & path)
+{
+#ifdef __linux__
+    int const fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return arrow::Status::IOError("Failed to open ", path, ": ", errno);
+    }
+    if (::lseek(fd, 0, SEEK_END) < 0) {
+        auto const error = errno;
+        ::close(fd);
+        return arrow::Status::IOError("Failed to seek to end of ", path, ": ", error);
+    }
+    // The stream owns the descriptor from here:
+    return arrow::io::FileOutputStream::Open(fd);
+#else
+    return arrow::io::FileOutputStream::Open(path, true);
+#endif
+}
+
+/// \brief Copy the start of [file_location] to the current position of [file] inside the kernel,
+///        so the data never passes through user space, and filesystems supporting reflinks can
+///        share the data's extents instead of copying them.
+/// \returns The number of bytes copied, which is short of the location's size if the kernel or
+///          filesystem can't copy between these files, leaving the rest for the caller to copy.
+inline std::int64_t copy_file_range_to(
+    arrow::io::FileOutputStream const & file,
+    arrow::io::ReadableFile const & source,
+    FileLocation const & file_location)
+{
+    std::int64_t copied_bytes = 0;
+#if defined(__linux__) && defined(SYS_copy_file_range)
+    // Called directly as older C libraries have no wrapper for the syscall:
+    std::int64_t source_offset = file_location.offset;
+    while (copied_bytes < std::int64_t(file_location.size)) {
+        auto const result = ::syscall(
+            SYS_copy_file_range,
+            source.file_descriptor(),
+            &source_offset,
+            file.file_descriptor(),
+            nullptr,
+            std::size_t(file_location.size - copied_bytes),
+            0u);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            break;
+        }
+        copied_bytes += result;
+    }
+#else
+    (void)file;
+    (void)source;
+    (void)file_location;
+#endif
+    return copied_bytes;
+}
+
 inline arrow::Result<combined_file_utils::FileInfo> write_file(
     arrow::MemoryPool * pool,
     std::shared_ptr<arrow::io::FileOutputStream> const & file,
@@ -403,8 +613,10 @@ inline arrow::Result<combined_file_utils::FileInfo> write_file(
         // Stream out the reads table into the main file:
         ARROW_ASSIGN_OR_RAISE(
             auto reads_table_file_in, arrow::io::ReadableFile::Open(file_location.file_path, pool));
-        ARROW_RETURN_NOT_OK(reads_table_file_in->Seek(file_location.offset));
-        std::int64_t copied_bytes = 0;
+
+        // Copy in the kernel where possible, then copy anything left by hand:
+        std::int64_t copied_bytes = copy_file_range_to(*file, *reads_table_file_in, file_location);
+        ARROW_RETURN_NOT_OK(reads_table_file_in->Seek(file_location.offset + copied_bytes));
         std::int64_t target_chunk_size = 10 * 1024 * 1024;  // Read in 10MB of data at a time
         while (copied_bytes < std::int64_t(file_location.size)) {
             std::size_t const to_read =
@@ -444,4 +656,19 @@ inline arrow::Result<combined_file_utils::FileInfo> write_file_and_marker(
     return file_info;
 }
 
+inline arrow::Result<combined_file_utils::FileInfo> write_buffer_and_marker(
+    std::shared_ptr<arrow::io::OutputStream> const & file,
+    std::shared_ptr<arrow::Buffer> const & buffer,
+    Uuid const & section_marker)
+{
+    combined_file_utils::FileInfo file_info;
+    ARROW_ASSIGN_OR_RAISE(file_info.file_start_offset, file->Tell());
+    ARROW_RETURN_NOT_OK(file->Write(buffer));
+    file_info.file_length = buffer->size();
+    // Pad file to 8 bytes and mark section:
+    ARROW_RETURN_NOT_OK(combined_file_utils::pad_file(file, 8));
+    ARROW_RETURN_NOT_OK(combined_file_utils::write_section_marker(file, section_marker));
+    return file_info;
+}
+
 }}  // namespace pod5::combined_file_utils
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace pod5 { namespace internal {
+
+/// \brief Picks how many of a set of workers to run, between a minimum and maximum, by
+///        hill-climbing on the throughput the workers deliver.
+///
+/// Workers report the work they complete, and the time they spend held back by limits on results
+/// not yet taken. Once a sample interval has passed, update() compares the interval's throughput
+/// with the last interval's: a step which raised throughput is followed by another the same way,
+/// a step which lowered it is reversed, and a step making no difference steps down, so the count
+/// settles around the knee of the throughput curve. Intervals where workers spend much of their
+/// time held back also step down, as more workers can't deliver more than is taken from them.
+class ConcurrencyTuner {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds DEFAULT_SAMPLE_INTERVAL{100};
+    // Throughput changes smaller than this fraction are treated as noise:
+    static constexpr double SIGNIFICANT_CHANGE = 0.05;
+    // The fraction of worker time held back above which workers are removed:
+    static constexpr double MAX_STALL_RATIO = 0.25;
+
+    /// \note Starts halfway between [min_concurrency] and [max_concurrency], and at least one.
+    ConcurrencyTuner(
+        std::size_t min_concurrency,
+        std::size_t max_concurrency,
+        std::chrono::nanoseconds sample_interval = DEFAULT_SAMPLE_INTERVAL,
+        Clock::time_point start = Clock::now())
+    : m_min_concurrency(std::max<std::size_t>(min_concurrency, 1))
+    , m_max_concurrency(std::max(max_concurrency, m_min_concurrency))
+    , m_sample_interval(sample_interval)
+    , m_concurrency((m_min_concurrency + m_max_concurrency + 1) / 2)
+    , m_interval_start(start)
+    {
+    }
+
+    ConcurrencyTuner(ConcurrencyTuner const &) = delete;
+    ConcurrencyTuner & operator=(ConcurrencyTuner const &) = delete;
+
+    /// \brief Find the number of workers to run now.
+    std::size_t concurrency() const { return m_concurrency.load(std::memory_order_relaxed); }
+
+    std::size_t min_concurrency() const { return m_min_concurrency; }
+
+    std::size_t max_concurrency() const { return m_max_concurrency; }
+
+    /// \brief Record [work] units completed by a worker, in any unit used consistently.
+    void add_work(std::uint64_t work) { m_work.fetch_add(work, std::memory_order_relaxed); }
+
+    /// \brief Record a worker having been held back for [time].
+    void add_stall(std::chrono::nanoseconds time)
+    {
+        m_stall_ns.fetch_add(std::uint64_t(time.count()), std::memory_order_relaxed);
+    }
+
+    /// \brief Step the concurrency if a sample interval has passed since the last step.
+    ///
+    /// Safe to call from any worker, calls made while another is stepping return at once.
+    /// \returns True if the concurrency changed.
+    bool update(Clock::time_point now = Clock::now())
+    {
+        std::unique_lock<std::mutex> l(m_mutex, std::try_to_lock);
+        if (!l.owns_lock() || now - m_interval_start < m_sample_interval) {
+            return false;
+        }
+
+        auto const elapsed_ns = double(std::chrono::nanoseconds(now - m_interval_start).count());
+        m_interval_start = now;
+        auto const work = m_work.exchange(0);
+        auto const stall_ns = m_stall_ns.exchange(0);
+        // Nothing ran, so the interval says nothing about the workers:
+        if (work == 0 && stall_ns == 0) {
+            return false;
+        }
+
+        auto const current = concurrency();
+        auto const throughput = double(work) / elapsed_ns;
+        auto const stall_ratio = double(stall_ns) / (elapsed_ns * double(current));
+
+        int step = m_direction;
+        if (stall_ratio > MAX_STALL_RATIO) {
+            step = -1;
+        } else if (m_last_throughput) {
+            auto const last = *m_last_throughput;
+            if (throughput < last * (1 - SIGNIFICANT_CHANGE)) {
+                step = -m_direction;
+            } else if (throughput <= last * (1 + SIGNIFICANT_CHANGE)) {
+                step = -1;
+            }
+        }
+        m_last_throughput = throughput;
+
+        auto const next = step > 0 ? std::min(current + 1, m_max_concurrency)
+                                   : std::max(current - 1, m_min_concurrency);
+        // At a bound, probe back the other way next:
+        m_direction = next == current ? -step : step;
+        m_concurrency.store(next, std::memory_order_relaxed);
+        return next != current;
+    }
+
+private:
+    std::size_t const m_min_concurrency;
+    std::size_t const m_max_concurrency;
+    std::chrono::nanoseconds const m_sample_interval;
+    std::atomic<std::size_t> m_concurrency;
+
+    std::atomic<std::uint64_t> m_work{0};
+    std::atomic<std::uint64_t> m_stall_ns{0};
+
+    std::mutex m_mutex;
+    Clock::time_point m_interval_start;
+    // Work per nanosecond in the last interval, unset before the first:
+    std::optional<double> m_last_throughput;
+    // The way the last step went, +1 adding a worker and -1 removing one:
+    int m_direction = 1;
+};
+
+}}  // namespace pod5::internal
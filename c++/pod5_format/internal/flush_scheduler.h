@@ -0,0 +1,147 @@
+#pragma once
+
+#include "pod5_format/thread_pool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace pod5 { namespace internal {
+
+/// \brief Decides when a writer flushes its output: once its oldest unflushed byte is
+///        [max_latency] old, or once [max_unflushed_bytes] are unflushed, whichever is first.
+///
+/// The writer reports the bytes it has written after each call, and flushes when told to.
+/// Deadlines expiring between the writer's calls are waited for on [thread_pool], which calls
+/// [try_flush]. It should flush without waiting on the writer, returning false if the writer is
+/// busy or can't flush, in which case the writer's next call flushes instead.
+class FlushScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// \note A zero [max_latency] or [max_unflushed_bytes] doesn't flush by that limit.
+    FlushScheduler(
+        std::chrono::milliseconds max_latency,
+        std::size_t max_unflushed_bytes,
+        std::shared_ptr<ThreadPool> const & thread_pool,
+        std::function<bool()> try_flush)
+    : m_max_latency(max_latency)
+    , m_max_unflushed_bytes(max_unflushed_bytes)
+    , m_thread_pool(thread_pool)
+    , m_state(std::make_shared<State>())
+    {
+        m_state->try_flush = std::move(try_flush);
+    }
+
+    ~FlushScheduler() { stop(); }
+
+    FlushScheduler(FlushScheduler const &) = delete;
+    FlushScheduler & operator=(FlushScheduler const &) = delete;
+
+    /// \brief Record the bytes the writer has written in total, finding if it should flush now.
+    bool is_flush_due(std::size_t bytes_written)
+    {
+        if (bytes_written <= m_flushed_bytes) {
+            return false;
+        }
+        if (m_max_unflushed_bytes > 0 && bytes_written - m_flushed_bytes >= m_max_unflushed_bytes)
+        {
+            return true;
+        }
+        if (m_max_latency.count() == 0) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> l(m_state->mutex);
+        if (m_state->deadline_missed) {
+            return true;
+        }
+        if (!m_state->deadline) {
+            // The first unflushed write since the last flush starts the clock:
+            m_state->deadline = Clock::now() + m_max_latency;
+            if (!m_state->waiting && !m_state->stopped) {
+                start_waiting();
+            }
+        }
+        return Clock::now() >= *m_state->deadline;
+    }
+
+    /// \brief Record that the writer has flushed its first [bytes_written] bytes.
+    void flushed(std::size_t bytes_written)
+    {
+        m_flushed_bytes = bytes_written;
+
+        std::lock_guard<std::mutex> l(m_state->mutex);
+        m_state->deadline.reset();
+        m_state->deadline_missed = false;
+        m_state->changed.notify_all();
+    }
+
+    /// \brief Stop waiting for deadlines, returning once [try_flush] won't be called again.
+    /// \note Call with the writer held, so a deadline expiring now can't wait on the writer.
+    void stop()
+    {
+        std::unique_lock<std::mutex> l(m_state->mutex);
+        m_state->stopped = true;
+        m_state->changed.notify_all();
+        m_state->changed.wait(l, [&] { return !m_state->waiting; });
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::optional<Clock::time_point> deadline;
+        // Set when a deadline expired while the writer was busy:
+        bool deadline_missed = false;
+        bool waiting = false;
+        bool stopped = false;
+        std::function<bool()> try_flush;
+    };
+
+    /// Called with the state locked.
+    void start_waiting()
+    {
+        m_state->waiting = true;
+        try {
+            m_thread_pool->post([state = m_state] { wait_for_deadlines(*state); });
+        } catch (std::exception const &) {
+            // The pool throws once stopped, leaving the writer's calls to check deadlines:
+            m_state->waiting = false;
+        }
+    }
+
+    static void wait_for_deadlines(State & state)
+    {
+        std::unique_lock<std::mutex> l(state.mutex);
+        while (!state.stopped && state.deadline && !state.deadline_missed) {
+            if (Clock::now() < *state.deadline) {
+                state.changed.wait_until(l, *state.deadline);
+                continue;
+            }
+
+            l.unlock();
+            auto const flushed = state.try_flush();
+            l.lock();
+            if (!flushed) {
+                state.deadline_missed = true;
+            }
+        }
+        state.waiting = false;
+        state.changed.notify_all();
+    }
+
+    std::chrono::milliseconds m_max_latency;
+    std::size_t m_max_unflushed_bytes;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+    // Only touched by the writer, or by [try_flush] holding the writer:
+    std::size_t m_flushed_bytes = 0;
+    std::shared_ptr<State> m_state;
+};
+
+}}  // namespace pod5::internal
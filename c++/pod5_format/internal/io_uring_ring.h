@@ -0,0 +1,400 @@
+#pragma once
+
+#include "pod5_format/result.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define POD5_HAS_IO_URING 1
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pod5 { namespace io_uring {
+
+/// \brief A read to submit to an IoUringRing.
+struct ReadRequest {
+    int fd;
+    std::uint64_t offset;
+    void * destination;
+    std::uint64_t length;
+    /// \brief Called on the ring's completion thread with the number of bytes read, which is
+    ///        short only at the end of the file, or a negative errno.
+    std::function<void(std::int64_t)> on_complete;
+};
+
+/// \brief A write to submit to an IoUringRing.
+struct WriteRequest {
+    int fd;
+    std::uint64_t offset;
+    void const * source;
+    std::uint64_t length;
+    /// \brief Called on the ring's completion thread with the number of bytes written, which is
+    ///        short only if the device stops accepting data, or a negative errno.
+    std::function<void(std::int64_t)> on_complete;
+};
+
+/// \brief Minimal io_uring ring for reads and writes, talking to the kernel directly rather than
+///        through liburing.
+///
+/// Needs Linux 5.7 or later. Many threads can submit requests at once, and up to the queue depth
+/// of requests are in flight together. Completions are handled by a thread owned by the ring,
+/// which retries short and interrupted requests before reporting them.
+class IoUringRing {
+public:
+    static Result<std::unique_ptr<IoUringRing>> create(std::uint32_t queue_depth)
+    {
+        io_uring_params params{};
+        int const ring_fd = syscall(__NR_io_uring_setup, std::max(1u, queue_depth), &params);
+        if (ring_fd < 0) {
+            return Status::NotImplemented("io_uring unavailable: ", std::strerror(errno));
+        }
+        // IORING_OP_READ/WRITE need Linux 5.6, fast poll arrived in 5.7 and is easy to check for:
+        if (!(params.features & IORING_FEAT_FAST_POLL)) {
+            close(ring_fd);
+            return Status::NotImplemented("io_uring too old to support reads and writes");
+        }
+
+        std::unique_ptr<IoUringRing> ring(new IoUringRing(ring_fd, params));
+        ARROW_RETURN_NOT_OK(ring->map_rings());
+        ring->m_completion_thread = std::thread([ring = ring.get()] { ring->run_completions(); });
+        return ring;
+    }
+
+    IoUringRing(IoUringRing const &) = delete;
+    IoUringRing & operator=(IoUringRing const &) = delete;
+
+    /// \brief Waits for all requests in flight to complete before releasing the ring.
+    ~IoUringRing()
+    {
+        if (m_completion_thread.joinable()) {
+            {
+                std::unique_lock<std::mutex> l(m_mutex);
+                m_stopping = true;
+                m_slot_freed.wait(l, [&] { return m_free_slots.size() == m_slots.size(); });
+                // Wake the completion thread with a no-op, so it sees the ring stopping:
+                auto const sqe = next_sqe();
+                sqe->opcode = IORING_OP_NOP;
+                sqe->user_data = STOP_USER_DATA;
+                (void)publish_sqes(1);
+            }
+            m_completion_thread.join();
+        }
+
+        if (m_sqes) {
+            munmap(m_sqes, m_sqes_size);
+        }
+        if (m_cq_ring && m_cq_ring != m_sq_ring) {
+            munmap(m_cq_ring, m_cq_ring_size);
+        }
+        if (m_sq_ring) {
+            munmap(m_sq_ring, m_sq_ring_size);
+        }
+        close(m_ring_fd);
+    }
+
+    /// \brief Submit [requests], waiting for free space in the ring where it is full.
+    /// \note All requests are submitted together where the ring has space for them.
+    Status submit_reads(std::vector<ReadRequest> && requests)
+    {
+        return submit(std::move(requests), IORING_OP_READ);
+    }
+
+    /// \brief Submit [requests], waiting for free space in the ring where it is full.
+    /// \note The caller orders writes to overlapping ranges, as requests in flight together may
+    ///       complete in any order.
+    Status submit_writes(std::vector<WriteRequest> && requests)
+    {
+        return submit(std::move(requests), IORING_OP_WRITE);
+    }
+
+    std::uint32_t queue_depth() const { return std::uint32_t(m_slots.size()); }
+
+private:
+    static constexpr std::uint64_t STOP_USER_DATA = ~std::uint64_t(0);
+    // Requests are split so each fits the 32 bit length of a submission:
+    static constexpr std::uint64_t MAX_REQUEST_CHUNK = 1u << 30;
+
+    struct Slot {
+        std::uint8_t opcode = IORING_OP_READ;
+        int fd = -1;
+        std::uint64_t offset = 0;
+        std::uint8_t * buffer = nullptr;
+        std::uint64_t remaining = 0;
+        std::int64_t completed = 0;
+        std::function<void(std::int64_t)> on_complete;
+    };
+
+    static std::uint8_t * request_buffer(ReadRequest const & request)
+    {
+        return static_cast<std::uint8_t *>(request.destination);
+    }
+
+    // The kernel only reads from a write's buffer:
+    static std::uint8_t * request_buffer(WriteRequest const & request)
+    {
+        return const_cast<std::uint8_t *>(static_cast<std::uint8_t const *>(request.source));
+    }
+
+    template <typename Request>
+    Status submit(std::vector<Request> && requests, std::uint8_t opcode)
+    {
+        std::unique_lock<std::mutex> l(m_mutex);
+        std::size_t submitted = 0;
+        while (submitted < requests.size()) {
+            m_slot_freed.wait(l, [&] { return !m_free_slots.empty() || m_stopping; });
+            if (m_stopping) {
+                return Status::Invalid("io_uring ring is stopping");
+            }
+
+            std::uint32_t queued = 0;
+            while (submitted < requests.size() && !m_free_slots.empty()) {
+                auto const slot_index = m_free_slots.back();
+                m_free_slots.pop_back();
+
+                auto & slot = m_slots[slot_index];
+                auto & request = requests[submitted++];
+                slot.opcode = opcode;
+                slot.fd = request.fd;
+                slot.offset = request.offset;
+                slot.buffer = request_buffer(request);
+                slot.remaining = request.length;
+                slot.completed = 0;
+                slot.on_complete = std::move(request.on_complete);
+                queue_request(slot_index);
+                queued += 1;
+            }
+            ARROW_RETURN_NOT_OK(publish_sqes(queued));
+        }
+        return Status::OK();
+    }
+
+    IoUringRing(int ring_fd, io_uring_params const & params)
+    : m_ring_fd(ring_fd)
+    , m_params(params)
+    , m_slots(params.sq_entries)
+    {
+        // The completion queue is larger than the submission queue, so limiting requests in flight
+        // to the submission queue size means completions can never overflow:
+        m_free_slots.reserve(m_slots.size());
+        for (std::uint32_t i = 0; i < m_slots.size(); ++i) {
+            m_free_slots.push_back(m_slots.size() - 1 - i);
+        }
+    }
+
+    Status map_rings()
+    {
+        auto const & sq_off = m_params.sq_off;
+        auto const & cq_off = m_params.cq_off;
+        m_sq_ring_size = sq_off.array + m_params.sq_entries * sizeof(std::uint32_t);
+        m_cq_ring_size = cq_off.cqes + m_params.cq_entries * sizeof(io_uring_cqe);
+        bool const single_mmap = m_params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+        }
+
+        m_sq_ring = map_ring(m_sq_ring_size, IORING_OFF_SQ_RING);
+        if (!m_sq_ring) {
+            return Status::IOError("Failed to map io_uring submission ring");
+        }
+        m_cq_ring = single_mmap ? m_sq_ring : map_ring(m_cq_ring_size, IORING_OFF_CQ_RING);
+        if (!m_cq_ring) {
+            return Status::IOError("Failed to map io_uring completion ring");
+        }
+        m_sqes_size = m_params.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = static_cast<io_uring_sqe *>(map_ring(m_sqes_size, IORING_OFF_SQES));
+        if (!m_sqes) {
+            return Status::IOError("Failed to map io_uring submission entries");
+        }
+
+        auto const sq = static_cast<std::uint8_t *>(m_sq_ring);
+        m_sq_tail = reinterpret_cast<unsigned *>(sq + sq_off.tail);
+        m_sq_mask = *reinterpret_cast<unsigned *>(sq + sq_off.ring_mask);
+        m_sq_array = reinterpret_cast<unsigned *>(sq + sq_off.array);
+
+        auto const cq = static_cast<std::uint8_t *>(m_cq_ring);
+        m_cq_head = reinterpret_cast<unsigned *>(cq + cq_off.head);
+        m_cq_tail = reinterpret_cast<unsigned *>(cq + cq_off.tail);
+        m_cq_mask = *reinterpret_cast<unsigned *>(cq + cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe *>(cq + cq_off.cqes);
+        return Status::OK();
+    }
+
+    void * map_ring(std::size_t size, off_t offset)
+    {
+        auto const mapping = mmap(
+            nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, offset);
+        return mapping == MAP_FAILED ? nullptr : mapping;
+    }
+
+    // Find the next free submission entry, must be called with m_mutex held.
+    io_uring_sqe * next_sqe()
+    {
+        auto const index = (*m_sq_tail + m_pending_sqes) & m_sq_mask;
+        m_pending_sqes += 1;
+        auto const sqe = &m_sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        m_sq_array[index] = index;
+        return sqe;
+    }
+
+    // Queue the next chunk of the request in [slot_index], must be called with m_mutex held.
+    void queue_request(std::uint32_t slot_index)
+    {
+        auto const & slot = m_slots[slot_index];
+        auto const sqe = next_sqe();
+        sqe->opcode = slot.opcode;
+        sqe->fd = slot.fd;
+        sqe->off = slot.offset + slot.completed;
+        sqe->addr = reinterpret_cast<std::uint64_t>(slot.buffer + slot.completed);
+        sqe->len = std::uint32_t(std::min(slot.remaining, MAX_REQUEST_CHUNK));
+        sqe->user_data = slot_index;
+    }
+
+    // Make queued entries visible to the kernel and submit them, must be called with m_mutex held.
+    Status publish_sqes(std::uint32_t count)
+    {
+        assert(count == m_pending_sqes);
+        __atomic_store_n(m_sq_tail, *m_sq_tail + count, __ATOMIC_RELEASE);
+        m_pending_sqes = 0;
+
+        while (count > 0) {
+            auto const submitted = syscall(__NR_io_uring_enter, m_ring_fd, count, 0, 0, nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                    continue;
+                }
+                return Status::IOError("io_uring submission failed: ", std::strerror(errno));
+            }
+            count -= std::min<std::uint32_t>(count, submitted);
+        }
+        return Status::OK();
+    }
+
+    void run_completions()
+    {
+        while (true) {
+            auto const waited =
+                syscall(__NR_io_uring_enter, m_ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (waited < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                // The ring is unusable, fail everything in flight rather than hang:
+                fail_all_in_flight(-errno);
+                return;
+            }
+
+            auto head = *m_cq_head;
+            auto const tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head) {
+                auto const & cqe = m_cqes[head & m_cq_mask];
+                if (cqe.user_data == STOP_USER_DATA) {
+                    __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+                    return;
+                }
+                complete(std::uint32_t(cqe.user_data), cqe.res);
+            }
+            __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+        }
+    }
+
+    void complete(std::uint32_t slot_index, std::int32_t result)
+    {
+        std::function<void(std::int64_t)> on_complete;
+        std::int64_t reported = 0;
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            auto & slot = m_slots[slot_index];
+            if (result == -EINTR || result == -EAGAIN) {
+                queue_request(slot_index);
+                (void)publish_sqes(1);
+                return;
+            }
+            if (result > 0) {
+                slot.completed += result;
+                slot.remaining -= result;
+                if (slot.remaining > 0) {
+                    // Short transfer - continue from where it stopped:
+                    queue_request(slot_index);
+                    (void)publish_sqes(1);
+                    return;
+                }
+            }
+
+            // Finished, at the end of the file, or failed:
+            reported = result < 0 ? result : slot.completed;
+            on_complete = std::move(slot.on_complete);
+            slot.on_complete = nullptr;
+        }
+
+        on_complete(reported);
+
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            m_free_slots.push_back(slot_index);
+        }
+        m_slot_freed.notify_all();
+    }
+
+    void fail_all_in_flight(std::int64_t error)
+    {
+        std::vector<std::function<void(std::int64_t)>> failed;
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            m_stopping = true;
+            for (auto & slot : m_slots) {
+                if (slot.on_complete) {
+                    failed.push_back(std::move(slot.on_complete));
+                    slot.on_complete = nullptr;
+                }
+            }
+            m_free_slots.clear();
+            for (std::uint32_t i = 0; i < m_slots.size(); ++i) {
+                m_free_slots.push_back(i);
+            }
+        }
+        for (auto & on_complete : failed) {
+            on_complete(error);
+        }
+        m_slot_freed.notify_all();
+    }
+
+    int m_ring_fd;
+    io_uring_params m_params;
+
+    void * m_sq_ring = nullptr;
+    void * m_cq_ring = nullptr;
+    io_uring_sqe * m_sqes = nullptr;
+    std::size_t m_sq_ring_size = 0;
+    std::size_t m_cq_ring_size = 0;
+    std::size_t m_sqes_size = 0;
+
+    unsigned * m_sq_tail = nullptr;
+    unsigned m_sq_mask = 0;
+    unsigned * m_sq_array = nullptr;
+    unsigned * m_cq_head = nullptr;
+    unsigned * m_cq_tail = nullptr;
+    unsigned m_cq_mask = 0;
+    io_uring_cqe * m_cqes = nullptr;
+
+    std::mutex m_mutex;
+    std::condition_variable m_slot_freed;
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_free_slots;
+    std::uint32_t m_pending_sqes = 0;
+    bool m_stopping = false;
+
+    std::thread m_completion_thread;
+};
+
+}}  // namespace pod5::io_uring
+
+#endif
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "pod5_format/result.h"
+#include "pod5_format/table_reader.h"
+
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/util/endian.h>
+#include <flatbuffers/flatbuffers.h>
+
+#include <cstring>
+#include <vector>
+
+namespace pod5 { namespace ipc_file_blocks {
+
+// Layout of the arrow ipc file footer, from the arrow format's File.fbs:
+static constexpr char IPC_FILE_MAGIC[] = "ARROW1";
+static constexpr std::size_t IPC_FILE_MAGIC_SIZE = sizeof(IPC_FILE_MAGIC) - 1;
+// The file's leading magic is padded to 8 bytes, followed by the schema message.
+static constexpr std::int64_t IPC_FILE_LEADING_MAGIC_SIZE = 8;
+static constexpr flatbuffers::voffset_t FOOTER_RECORD_BATCHES_FIELD = 10;
+// struct Block { offset: long; metaDataLength: int; bodyLength: long; }, padded to 24 bytes.
+static constexpr std::size_t BLOCK_SIZE = 24;
+static constexpr std::size_t BLOCK_METADATA_LENGTH_OFFSET = 8;
+static constexpr std::size_t BLOCK_BODY_LENGTH_OFFSET = 16;
+
+// Layout of an arrow ipc message's metadata, from the arrow format's Message.fbs:
+static constexpr flatbuffers::voffset_t MESSAGE_HEADER_TYPE_FIELD = 6;
+static constexpr flatbuffers::voffset_t MESSAGE_HEADER_FIELD = 8;
+static constexpr std::uint8_t MESSAGE_HEADER_RECORD_BATCH = 3;
+static constexpr flatbuffers::voffset_t RECORD_BATCH_LENGTH_FIELD = 4;
+
+template <typename T>
+T read_little_endian(std::uint8_t const * data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return arrow::bit_util::FromLittleEndian(value);
+}
+
+/// \brief Find the location of each record batch in an arrow ipc file.
+///
+/// Arrow doesn't expose record batch locations, so they are read from the ipc file footer here.
+inline Result<std::vector<RecordBatchLocation>> read_record_batch_locations(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const file_size, file->GetSize());
+    std::int64_t const trailer_size = sizeof(std::int32_t) + IPC_FILE_MAGIC_SIZE;
+    if (file_size < trailer_size) {
+        return Status::IOError("Arrow ipc file too small");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto const trailer, file->ReadAt(file_size - trailer_size, trailer_size));
+    if (trailer->size() != trailer_size
+        || std::memcmp(trailer->data() + sizeof(std::int32_t), IPC_FILE_MAGIC, IPC_FILE_MAGIC_SIZE)
+               != 0)
+    {
+        return Status::IOError("Invalid arrow ipc file trailer");
+    }
+
+    auto const footer_length = read_little_endian<std::int32_t>(trailer->data());
+    if (footer_length <= 0 || footer_length > file_size - trailer_size) {
+        return Status::IOError("Invalid arrow ipc footer length");
+    }
+    ARROW_ASSIGN_OR_RAISE(
+        auto const footer_data,
+        file->ReadAt(file_size - trailer_size - footer_length, footer_length));
+    if (footer_data->size() != footer_length) {
+        return Status::IOError("Failed to read arrow ipc footer");
+    }
+
+    flatbuffers::Verifier verifier(footer_data->data(), footer_data->size());
+    if (!verifier.Verify<flatbuffers::uoffset_t>(0)) {
+        return Status::IOError("Invalid arrow ipc footer");
+    }
+    auto const footer = flatbuffers::GetRoot<flatbuffers::Table>(footer_data->data());
+    if (!footer->VerifyTableStart(verifier)
+        || !footer->VerifyOffset(verifier, FOOTER_RECORD_BATCHES_FIELD))
+    {
+        return Status::IOError("Invalid arrow ipc footer");
+    }
+
+    std::vector<RecordBatchLocation> locations;
+    auto const blocks = footer->GetPointer<flatbuffers::Vector<std::uint8_t> const *>(
+        FOOTER_RECORD_BATCHES_FIELD);
+    if (!blocks) {
+        return locations;
+    }
+
+    // The vector holds structs inline, check all of them lie within the footer:
+    auto const blocks_data = blocks->Data();
+    auto const block_count = blocks->size();
+    if (!verifier.VerifyVector(blocks)
+        || !verifier.VerifyFromPointer(blocks_data, std::size_t(block_count) * BLOCK_SIZE))
+    {
+        return Status::IOError("Invalid arrow ipc footer record batches");
+    }
+
+    locations.reserve(block_count);
+    for (std::size_t i = 0; i < block_count; ++i) {
+        auto const block = blocks_data + i * BLOCK_SIZE;
+        auto const offset = read_little_endian<std::int64_t>(block);
+        auto const metadata_length =
+            read_little_endian<std::int32_t>(block + BLOCK_METADATA_LENGTH_OFFSET);
+        auto const body_length = read_little_endian<std::int64_t>(block + BLOCK_BODY_LENGTH_OFFSET);
+        if (offset < 0 || metadata_length < 0 || body_length < 0 || offset > file_size
+            || body_length > file_size - offset - metadata_length)
+        {
+            return Status::IOError("Invalid arrow ipc record batch location");
+        }
+        locations.push_back({offset, metadata_length, body_length});
+    }
+    return locations;
+}
+
+/// \brief Find the number of rows of a record batch from its message's flatbuffer [metadata],
+///        without decoding the batch.
+inline Result<std::int64_t> read_record_batch_row_count(arrow::Buffer const & metadata)
+{
+    flatbuffers::Verifier verifier(metadata.data(), metadata.size());
+    if (!verifier.Verify<flatbuffers::uoffset_t>(0)) {
+        return Status::IOError("Invalid arrow ipc message metadata");
+    }
+    auto const message = flatbuffers::GetRoot<flatbuffers::Table>(metadata.data());
+    if (!message->VerifyTableStart(verifier)
+        || !message->VerifyOffset(verifier, MESSAGE_HEADER_FIELD))
+    {
+        return Status::IOError("Invalid arrow ipc message metadata");
+    }
+
+    // Scalar fields are checked to lie within the metadata by hand, as flatbuffers versions
+    // differ in how they verify them:
+    auto const field_in_metadata = [&](flatbuffers::Table const * table,
+                                       flatbuffers::voffset_t field,
+                                       std::size_t size) {
+        auto const field_offset = table->GetOptionalFieldOffset(field);
+        return field_offset == 0
+               || verifier.VerifyFromPointer(
+                   reinterpret_cast<std::uint8_t const *>(table) + field_offset, size);
+    };
+    if (!field_in_metadata(message, MESSAGE_HEADER_TYPE_FIELD, sizeof(std::uint8_t))
+        || message->GetField<std::uint8_t>(MESSAGE_HEADER_TYPE_FIELD, 0)
+               != MESSAGE_HEADER_RECORD_BATCH)
+    {
+        return Status::IOError("Arrow ipc message is not a record batch");
+    }
+
+    auto const header = message->GetPointer<flatbuffers::Table const *>(MESSAGE_HEADER_FIELD);
+    if (!header || !header->VerifyTableStart(verifier)
+        || !field_in_metadata(header, RECORD_BATCH_LENGTH_FIELD, sizeof(std::int64_t)))
+    {
+        return Status::IOError("Invalid arrow ipc record batch metadata");
+    }
+    auto const row_count = header->GetField<std::int64_t>(RECORD_BATCH_LENGTH_FIELD, 0);
+    if (row_count < 0) {
+        return Status::IOError("Invalid arrow ipc record batch length");
+    }
+    return row_count;
+}
+
+}}  // namespace pod5::ipc_file_blocks
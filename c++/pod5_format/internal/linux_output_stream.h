@@ -3,13 +3,18 @@
 #include "pod5_format/file_output_stream.h"
 #include "pod5_format/internal/tracing/tracing.h"
 #include "pod5_format/io_manager.h"
+#include "pod5_format/thread_pool.h"
 
 #include <arrow/buffer.h>
 #include <arrow/util/future.h>
 #include <gsl/gsl-lite.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
+#include <exception>
+#include <mutex>
 
 #ifdef __linux__
 #include <fcntl.h>
@@ -22,6 +27,33 @@ namespace {
 constexpr size_t fallocate_chunk = 50 * 256 * IOManager::Alignment;  // 50MB
 }  // namespace
 
+/// \brief How a LinuxOutputStream reserves file space ahead of its writes.
+///
+/// Each reservation matches the space already reserved, so reservations grow with the file,
+/// between [min_reservation] and [max_reservation] bytes.
+struct FilePreallocationOptions {
+    static constexpr std::size_t DEFAULT_MIN_RESERVATION = fallocate_chunk;
+    // 1GB:
+    static constexpr std::size_t DEFAULT_MAX_RESERVATION = 1024 * 256 * IOManager::Alignment;
+
+    /// The size the file is expected to reach, reserved up front, or 0 if unknown.
+    std::size_t expected_size = 0;
+    std::size_t min_reservation = DEFAULT_MIN_RESERVATION;
+    std::size_t max_reservation = DEFAULT_MAX_RESERVATION;
+    /// A pool to reserve space on, keeping fallocate off the write path, or null to reserve
+    /// space on the writing thread.
+    std::shared_ptr<ThreadPool> thread_pool;
+};
+
+/// \brief Counters for file space reserved by a LinuxOutputStream.
+struct FilePreallocationStatistics {
+    std::size_t reservation_count = 0;
+    /// Bytes reserved by successful reservations.
+    std::size_t reserved_bytes = 0;
+    /// Time spent in fallocate, on whichever thread reserved the space.
+    std::chrono::nanoseconds reservation_time{0};
+};
+
 #ifdef __linux__
 class LinuxOutputStream : public FileOutputStream {
     struct PrivateDummy {};
@@ -33,7 +65,8 @@ public:
         std::size_t write_chunk_size,
         bool use_directio,
         bool use_syncio,
-        bool flush_on_batch_complete)
+        bool flush_on_batch_complete,
+        FilePreallocationOptions const & preallocation = {})
     {
         auto flags = O_RDWR | O_CREAT;
         if (use_directio) {
@@ -51,7 +84,12 @@ public:
         }
 
         return std::make_shared<LinuxOutputStream>(
-            fd, io_manager, write_chunk_size, flush_on_batch_complete, PrivateDummy{});
+            fd,
+            io_manager,
+            write_chunk_size,
+            flush_on_batch_complete,
+            preallocation,
+            PrivateDummy{});
     }
 
     ~LinuxOutputStream() { (void)Close(); }
@@ -61,13 +99,8 @@ public:
         // flush all output
         ARROW_RETURN_NOT_OK(Flush());
 
-        while (!m_queued_writes.empty()) {
-            ARROW_RETURN_NOT_OK(process_queued_writes());
-
-            if (!m_queued_writes.empty()) {
-                ARROW_RETURN_NOT_OK(m_io_manager->wait_for_event(std::chrono::seconds(1)));
-            }
-        }
+        // A reservation finishing after the truncate would extend the file again:
+        wait_for_preallocation();
 
         // truncate excess data
         ARROW_RETURN_NOT_OK(truncate_file());
@@ -80,7 +113,11 @@ public:
 
     arrow::Future<> CloseAsync() override { return Close(); }
 
-    arrow::Status Abort() override { return close_fd(); }
+    arrow::Status Abort() override
+    {
+        wait_for_preallocation();
+        return close_fd();
+    }
 
     arrow::Result<int64_t> Tell() const override { return m_bytes_written - m_file_start_offset; }
 
@@ -134,8 +171,11 @@ public:
 
     arrow::Status Flush() override
     {
+        POD5_TRACE_FUNCTION();
         ARROW_RETURN_NOT_OK(flush_writes(FlushMode::AllWrites));
 
+        // Writes still in flight would be missed by the sync:
+        ARROW_RETURN_NOT_OK(wait_for_queued_writes());
         if (fsync(m_file_descriptor) < 0) {
             return arrow::Status::IOError("Error flushing file");
         }
@@ -150,17 +190,31 @@ public:
         m_flush_on_batch_complete = flush_on_batch_complete;
     }
 
+    FilePreallocationStatistics preallocation_statistics() const
+    {
+        std::lock_guard<std::mutex> l(m_preallocation->mutex);
+        return m_preallocation->statistics;
+    }
+
     LinuxOutputStream(
         int file_descriptor,
         std::shared_ptr<IOManager> const & io_manager,
         std::size_t write_chunk_size,
         bool flush_on_batch_complete,
+        FilePreallocationOptions const & preallocation,
         PrivateDummy)
     : m_file_descriptor{file_descriptor}
     , m_aligned_buffer(write_chunk_size, io_manager)
     , m_io_manager(io_manager)
     , m_flush_on_batch_complete(flush_on_batch_complete)
+    , m_preallocation_options(preallocation)
+    , m_next_reservation(std::max<std::size_t>(preallocation.min_reservation, 1))
+    , m_preallocation(std::make_shared<PreallocationState>())
     {
+        if (m_preallocation_options.expected_size > 0) {
+            m_fallocate_offset = m_preallocation_options.expected_size;
+            reserve_file_space(0, m_fallocate_offset);
+        }
     }
 
 protected:
@@ -288,6 +342,7 @@ protected:
 
     arrow::Status flush_writes(FlushMode flush_mode)
     {
+        POD5_TRACE_FUNCTION();
         std::size_t write_offset{};
         std::shared_ptr<QueuedWrite> released_data;
 
@@ -317,9 +372,25 @@ protected:
         m_queued_writes.emplace_back(released_data);
         ARROW_RETURN_NOT_OK(m_io_manager->write_buffer(std::move(released_data)));
 
+        if (flush_mode == FlushMode::AllWrites) {
+            // The padded tail of this write is written again by the next, so the two must not be
+            // in flight together:
+            return wait_for_queued_writes();
+        }
         return process_queued_writes();
     }
 
+    arrow::Status wait_for_queued_writes()
+    {
+        while (true) {
+            ARROW_RETURN_NOT_OK(process_queued_writes());
+            if (m_queued_writes.empty()) {
+                return arrow::Status::OK();
+            }
+            ARROW_RETURN_NOT_OK(m_io_manager->wait_for_event(std::chrono::milliseconds(10)));
+        }
+    }
+
     arrow::Status truncate_file()
     {
         if (::ftruncate(m_file_descriptor, m_bytes_written) < 0) {
@@ -343,16 +414,80 @@ protected:
         return arrow::Status::OK();
     }
 
+    /// Reservations in flight on the preallocation pool, and counters for all reservations.
+    struct PreallocationState {
+        std::mutex mutex;
+        std::condition_variable reserved;
+        bool in_flight = false;
+        FilePreallocationStatistics statistics;
+    };
+
     void allocate_file_space(std::size_t new_write_size)
     {
-        auto new_total_size = m_bytes_written + new_write_size;
-        if (new_total_size > m_fallocate_offset) {
-            // reserve more space before continuing
-            m_fallocate_offset += fallocate_chunk;
+        // Reserve the next space once writes reach half a reservation from the end of the space
+        // already reserved, so a background reservation is done before writes need it:
+        auto const new_total_size = m_bytes_written + new_write_size;
+        if (new_total_size + m_next_reservation / 2 <= m_fallocate_offset) {
+            return;
+        }
+
+        {
+            // Writes don't wait on the last reservation, the file is extended as they land:
+            std::lock_guard<std::mutex> l(m_preallocation->mutex);
+            if (m_preallocation->in_flight) {
+                return;
+            }
+        }
 
+        auto const offset = m_fallocate_offset;
+        auto length = m_next_reservation;
+        if (new_total_size > offset) {
+            length += new_total_size - offset;
+        }
+        m_fallocate_offset = offset + length;
+        m_next_reservation = std::min(
+            std::max(m_fallocate_offset, m_preallocation_options.min_reservation),
+            m_preallocation_options.max_reservation);
+        reserve_file_space(offset, length);
+    }
+
+    void reserve_file_space(std::size_t offset, std::size_t length)
+    {
+        auto reserve = [state = m_preallocation, fd = m_file_descriptor, offset, length] {
+            auto const start = std::chrono::steady_clock::now();
             // If this fails, we will just write less optimially, so we ignore the result.
-            ::fallocate(m_file_descriptor, 0, m_fallocate_offset, fallocate_chunk);
+            auto const result = ::fallocate(fd, 0, offset, length);
+            auto const end = std::chrono::steady_clock::now();
+
+            std::lock_guard<std::mutex> l(state->mutex);
+            state->statistics.reservation_count += 1;
+            state->statistics.reservation_time += end - start;
+            if (result == 0) {
+                state->statistics.reserved_bytes += length;
+            }
+            state->in_flight = false;
+            state->reserved.notify_all();
+        };
+
+        if (m_preallocation_options.thread_pool) {
+            {
+                std::lock_guard<std::mutex> l(m_preallocation->mutex);
+                m_preallocation->in_flight = true;
+            }
+            try {
+                m_preallocation_options.thread_pool->post(reserve);
+                return;
+            } catch (std::exception const &) {
+                // The pool throws once stopped, so reserve the space here instead:
+            }
         }
+        reserve();
+    }
+
+    void wait_for_preallocation()
+    {
+        std::unique_lock<std::mutex> l(m_preallocation->mutex);
+        m_preallocation->reserved.wait(l, [&] { return !m_preallocation->in_flight; });
     }
 
     int m_file_descriptor;
@@ -364,6 +499,9 @@ protected:
     std::size_t m_bytes_written{0};
     std::size_t m_bytes_submitted_to_manager{0};
     bool m_flush_on_batch_complete;
+    FilePreallocationOptions m_preallocation_options;
+    std::size_t m_next_reservation;
+    std::shared_ptr<PreallocationState> m_preallocation;
 };
 #endif
 
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "pod5_format/result.h"
+#include "pod5_format/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace pod5 { namespace internal {
+
+// Upper bound on helper tasks posted to a thread pool for a single call.
+constexpr std::size_t PARALLEL_TASKS_MAX_HELPERS = 64;
+
+/// \brief Run [task] for every index in [0, task_count), spreading the calls across
+///        [thread_pool] and the calling thread.
+/// \note The calling thread also runs tasks, so this is safe to call from a worker of
+///       [thread_pool], and [thread_pool] may be null to run everything on the calling thread.
+/// \returns The first error returned by a task, tasks not yet started are skipped after an error.
+inline Status run_parallel_tasks(
+    ThreadPool * thread_pool,
+    std::size_t task_count,
+    std::function<Status(std::size_t)> task)
+{
+    struct State {
+        std::function<Status(std::size_t)> task;
+        std::size_t task_count;
+        std::atomic<std::size_t> next_task{0};
+        std::atomic<bool> failed{false};
+
+        std::mutex mutex;
+        std::condition_variable tasks_complete;
+        std::size_t completed_tasks{0};
+        Status status;
+
+        // Claim and run tasks until there are none left.
+        void run()
+        {
+            while (true) {
+                auto const index = next_task.fetch_add(1);
+                if (index >= task_count) {
+                    return;
+                }
+
+                auto const task_status = failed ? Status::OK() : task(index);
+
+                std::lock_guard<std::mutex> lock{mutex};
+                if (!task_status.ok() && status.ok()) {
+                    status = task_status;
+                    failed = true;
+                }
+                completed_tasks += 1;
+                if (completed_tasks == task_count) {
+                    tasks_complete.notify_all();
+                }
+            }
+        }
+    };
+
+    if (task_count == 0) {
+        return Status::OK();
+    }
+
+    auto state = std::make_shared<State>();
+    state->task = std::move(task);
+    state->task_count = task_count;
+
+    if (thread_pool) {
+        auto const helper_count = std::min(task_count - 1, PARALLEL_TASKS_MAX_HELPERS);
+        std::vector<ThreadPoolTask> helpers;
+        helpers.reserve(helper_count);
+        for (std::size_t i = 0; i < helper_count; ++i) {
+            helpers.emplace_back([state] { state->run(); });
+        }
+        try {
+            thread_pool->post_n(std::move(helpers));
+        } catch (std::logic_error const &) {
+            // The pool has been stopped, the calling thread will pick up the remaining work.
+        }
+    }
+
+    state->run();
+
+    std::unique_lock<std::mutex> lock{state->mutex};
+    state->tasks_complete.wait(lock, [&] { return state->completed_tasks == state->task_count; });
+    return state->status;
+}
+
+/// \brief Merge the sorted runs of [values] into one sorted run, merging adjacent pairs of runs
+///        in parallel on [thread_pool] until one is left.
+/// \param run_starts   Run i covers [run_starts[i], run_starts[i + 1]), the last entry is the
+///                     size of [values].
+/// \note std::merge is stable, so equal values stay in run order.
+template <typename T, typename Compare>
+Status merge_sorted_runs(
+    ThreadPool * thread_pool,
+    std::vector<T> & values,
+    std::vector<std::size_t> run_starts,
+    Compare compare)
+{
+    if (run_starts.size() <= 2) {
+        return Status::OK();
+    }
+
+    std::vector<T> merged(values.size());
+    while (run_starts.size() > 2) {
+        auto const run_count = run_starts.size() - 1;
+        auto const pair_count = (run_count + 1) / 2;
+        ARROW_RETURN_NOT_OK(run_parallel_tasks(thread_pool, pair_count, [&](std::size_t pair) {
+            auto const first = run_starts[pair * 2];
+            auto const middle = run_starts[std::min(pair * 2 + 1, run_count)];
+            auto const last = run_starts[std::min(pair * 2 + 2, run_count)];
+            std::merge(
+                values.begin() + first,
+                values.begin() + middle,
+                values.begin() + middle,
+                values.begin() + last,
+                merged.begin() + first,
+                compare);
+            return Status::OK();
+        }));
+
+        std::vector<std::size_t> merged_starts;
+        merged_starts.reserve(pair_count + 1);
+        for (std::size_t i = 0; i < run_count; i += 2) {
+            merged_starts.push_back(run_starts[i]);
+        }
+        merged_starts.push_back(run_starts.back());
+
+        std::swap(values, merged);
+        run_starts = std::move(merged_starts);
+    }
+    return Status::OK();
+}
+
+}}  // namespace pod5::internal
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <gsl/gsl-lite.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace pod5 { namespace internal {
+
+/// \brief A range of bytes in a file.
+struct ByteRange {
+    std::int64_t offset = 0;
+    std::int64_t length = 0;
+
+    std::int64_t end() const { return offset + length; }
+};
+
+/// \brief Reads covering a set of byte ranges, see coalesce_byte_ranges().
+struct CoalescedReads {
+    /// The reads to issue, in file order.
+    std::vector<ByteRange> reads;
+    /// The index in [reads] of the read holding each input range.
+    std::vector<std::size_t> read_for_range;
+};
+
+/// \brief Merge [ranges] into fewer, larger reads, in file order.
+///
+/// Ranges are merged when the gap between them is at most [hole_size_limit] bytes, and the merged
+/// read stays within [range_size_limit] bytes. Overlapping ranges are always merged, so a read can
+/// exceed the size limit where the ranges themselves overlap by more than it.
+inline CoalescedReads coalesce_byte_ranges(
+    gsl::span<ByteRange const> ranges,
+    std::int64_t hole_size_limit,
+    std::int64_t range_size_limit)
+{
+    std::vector<std::size_t> order(ranges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return ranges[a].offset < ranges[b].offset;
+    });
+
+    CoalescedReads result;
+    result.read_for_range.resize(ranges.size());
+    for (auto const index : order) {
+        auto const & range = ranges[index];
+        if (!result.reads.empty()) {
+            auto & read = result.reads.back();
+            auto const merged_end = std::max(read.end(), range.end());
+            if (range.offset < read.end()
+                || (range.offset - read.end() <= hole_size_limit
+                    && merged_end - read.offset <= range_size_limit))
+            {
+                read.length = merged_end - read.offset;
+                result.read_for_range[index] = result.reads.size() - 1;
+                continue;
+            }
+        }
+        result.read_for_range[index] = result.reads.size();
+        result.reads.push_back(range);
+    }
+    return result;
+}
+
+}}  // namespace pod5::internal
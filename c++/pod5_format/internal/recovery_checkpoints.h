@@ -0,0 +1,167 @@
+#pragma once
+
+#include "pod5_format/result.h"
+#include "pod5_format/signal_table_writer.h"
+#include "pod5_format/uuid.h"
+
+#include <arrow/buffer.h>
+#include <arrow/io/file.h>
+#include <arrow/util/endian.h>
+#include <arrow/util/io_util.h>
+#include <gsl/gsl-lite.hpp>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pod5 { namespace internal {
+
+/// Recovery checkpoints record where a writer's signal table batches end, in a file beside the
+/// output, so recovering a file cut short can copy them without parsing the table.
+///
+/// The file holds a record per checkpoint, each listing the batches written since the last:
+///     u32 magic, u32 batch count, {i64 end offset, u64 row count} per batch, u64 checksum
+/// all little endian. A record torn by a crash fails its checksum, so it and any records after
+/// it are ignored.
+static constexpr std::uint32_t CHECKPOINT_RECORD_MAGIC = 0x504b4350;  // "PCKP"
+static constexpr std::size_t CHECKPOINT_RECORD_HEADER_SIZE = 2 * sizeof(std::uint32_t);
+static constexpr std::size_t CHECKPOINT_BATCH_SIZE = 2 * sizeof(std::uint64_t);
+static constexpr std::size_t CHECKPOINT_CHECKSUM_SIZE = sizeof(std::uint64_t);
+
+using CheckpointedBatch = SignalTableWriter::WrittenBatch;
+
+/// \brief Find the checkpoint file of the output at [arrow_path] with [file_identifier].
+inline std::string make_checkpoints_tmp_path(
+    ::arrow::internal::PlatformFilename const & arrow_path,
+    Uuid const & file_identifier)
+{
+    return arrow_path.Parent().ToString() + "/"
+           + ("." + to_string(file_identifier) + ".tmp-checkpoints");
+}
+
+/// FNV-1a, enough to catch a record left partly written.
+inline std::uint64_t checkpoint_checksum(gsl::span<std::uint8_t const> const & data)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (auto const byte : data) {
+        hash = (hash ^ byte) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+template <typename T>
+void write_checkpoint_value(std::vector<std::uint8_t> & data, T value)
+{
+    value = arrow::bit_util::ToLittleEndian(value);
+    auto const offset = data.size();
+    data.resize(offset + sizeof(value));
+    std::memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+template <typename T>
+T read_checkpoint_value(std::uint8_t const * data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return arrow::bit_util::FromLittleEndian(value);
+}
+
+/// \brief Appends recovery checkpoints to a file, removed once the output is complete.
+class RecoveryCheckpointWriter {
+public:
+    static Result<std::unique_ptr<RecoveryCheckpointWriter>> open(std::string const & path)
+    {
+        ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::FileOutputStream::Open(path));
+        return std::unique_ptr<RecoveryCheckpointWriter>(
+            new RecoveryCheckpointWriter(path, std::move(file)));
+    }
+
+    /// \brief Append a checkpoint listing [batches], written since the last checkpoint.
+    /// \note The batches should be flushed to the output first.
+    Status write_checkpoint(gsl::span<CheckpointedBatch const> const & batches)
+    {
+        m_record.clear();
+        write_checkpoint_value(m_record, CHECKPOINT_RECORD_MAGIC);
+        write_checkpoint_value(m_record, std::uint32_t(batches.size()));
+        for (auto const & batch : batches) {
+            write_checkpoint_value(m_record, batch.end_offset);
+            write_checkpoint_value(m_record, batch.row_count);
+        }
+        write_checkpoint_value(m_record, checkpoint_checksum(gsl::make_span(m_record)));
+
+        ARROW_RETURN_NOT_OK(m_file->Write(m_record.data(), m_record.size()));
+        return m_file->Flush();
+    }
+
+    /// \brief Close and remove the checkpoint file, once the output no longer needs recovery.
+    Status remove()
+    {
+        ARROW_RETURN_NOT_OK(m_file->Close());
+        ARROW_ASSIGN_OR_RAISE(
+            auto const arrow_path, ::arrow::internal::PlatformFilename::FromString(m_path));
+        ARROW_RETURN_NOT_OK(arrow::internal::DeleteFile(arrow_path));
+        return Status::OK();
+    }
+
+private:
+    RecoveryCheckpointWriter(
+        std::string const & path,
+        std::shared_ptr<arrow::io::FileOutputStream> && file)
+    : m_path(path)
+    , m_file(std::move(file))
+    {
+    }
+
+    std::string m_path;
+    std::shared_ptr<arrow::io::FileOutputStream> m_file;
+    std::vector<std::uint8_t> m_record;
+};
+
+/// \brief Read the batches listed by every intact checkpoint in [path], in the order written.
+/// \returns No batches if there is no checkpoint file.
+inline Result<std::vector<CheckpointedBatch>> read_recovery_checkpoints(std::string const & path)
+{
+    std::vector<CheckpointedBatch> batches;
+    ARROW_ASSIGN_OR_RAISE(
+        auto const arrow_path, ::arrow::internal::PlatformFilename::FromString(path));
+    ARROW_ASSIGN_OR_RAISE(bool const file_exists, arrow::internal::FileExists(arrow_path));
+    if (!file_exists) {
+        return batches;
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto const file, arrow::io::ReadableFile::Open(path));
+    ARROW_ASSIGN_OR_RAISE(auto const file_size, file->GetSize());
+    ARROW_ASSIGN_OR_RAISE(auto const data, file->ReadAt(0, file_size));
+
+    std::size_t offset = 0;
+    auto const size = std::size_t(data->size());
+    while (size - offset >= CHECKPOINT_RECORD_HEADER_SIZE + CHECKPOINT_CHECKSUM_SIZE) {
+        auto const record = data->data() + offset;
+        if (read_checkpoint_value<std::uint32_t>(record) != CHECKPOINT_RECORD_MAGIC) {
+            break;
+        }
+        std::size_t const batch_count =
+            read_checkpoint_value<std::uint32_t>(record + sizeof(std::uint32_t));
+        auto const checksummed_size =
+            CHECKPOINT_RECORD_HEADER_SIZE + batch_count * CHECKPOINT_BATCH_SIZE;
+        if (size - offset < checksummed_size + CHECKPOINT_CHECKSUM_SIZE
+            || read_checkpoint_value<std::uint64_t>(record + checksummed_size)
+                   != checkpoint_checksum(gsl::make_span(record, checksummed_size)))
+        {
+            break;
+        }
+
+        for (std::size_t i = 0; i < batch_count; ++i) {
+            auto const batch =
+                record + CHECKPOINT_RECORD_HEADER_SIZE + i * CHECKPOINT_BATCH_SIZE;
+            batches.push_back(
+                {read_checkpoint_value<std::int64_t>(batch),
+                 read_checkpoint_value<std::uint64_t>(batch + sizeof(std::int64_t))});
+        }
+        offset += checksummed_size + CHECKPOINT_CHECKSUM_SIZE;
+    }
+    return batches;
+}
+
+}}  // namespace pod5::internal
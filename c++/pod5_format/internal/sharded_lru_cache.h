@@ -0,0 +1,405 @@
+#pragma once
+
+#include "pod5_format/internal/tracing/tracing.h"
+#include "pod5_format/result.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace pod5 {
+
+/// \brief Thread safe LRU cache, bounded by item count and total item size in bytes.
+///
+/// Keys are spread over a fixed number of shards, each with its own lock, so threads looking up
+/// different keys rarely contend. Loads run outside of any lock: a lookup of a loaded item never
+/// waits on another thread's load, and concurrent misses for the same key share a single load.
+///
+/// When the order of future lookups is known, see set_access_plan(), items are instead evicted
+/// by how far away their next planned use is, and dropped once their last planned use is passed.
+template <typename Value>
+class ShardedLruCache {
+public:
+    static constexpr std::size_t SHARD_COUNT = 16;
+
+    struct LoadedValue {
+        Value value;
+        std::size_t byte_size;
+    };
+
+    /// \brief Counts of lookups and evictions since the cache was made.
+    struct Statistics {
+        /// Lookups finding the item cached, or being loaded by another lookup.
+        std::uint64_t hits = 0;
+        /// Lookups which loaded the item.
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+    };
+
+    /// \param max_item_count   The most items to keep cached, 0 for no limit.
+    /// \param max_byte_size    The most bytes of items to keep cached, 0 for no limit.
+    /// \param trace_name       The counter name hits and misses are traced under.
+    ShardedLruCache(
+        std::size_t max_item_count,
+        std::size_t max_byte_size,
+        char const * trace_name = "ShardedLruCache")
+    : m_max_item_count(max_item_count)
+    , m_max_byte_size(max_byte_size)
+    , m_trace_name(trace_name)
+    {
+    }
+
+    ShardedLruCache(ShardedLruCache const &) = delete;
+    ShardedLruCache & operator=(ShardedLruCache const &) = delete;
+
+    /// \brief Find the item for [key], calling [load] to produce it if it is not cached.
+    /// \param load Callable returning Result<LoadedValue>. Failed loads are not cached.
+    /// \note Counts as the next planned use of [key] if an access plan is set.
+    template <typename Loader>
+    Result<Value> get(std::size_t key, Loader && load)
+    {
+        if (m_has_plan.load()) {
+            for (auto const finished_key : advance_plan(key)) {
+                erase(finished_key);
+            }
+        }
+        return lookup(key, std::forward<Loader>(load));
+    }
+
+    /// \brief Find the item for [key] as get() does, without counting as a planned use of
+    ///        [key], for loading items ahead of their use.
+    template <typename Loader>
+    Result<Value> load_ahead(std::size_t key, Loader && load)
+    {
+        return lookup(key, std::forward<Loader>(load));
+    }
+
+    /// \brief Set the order keys will be looked up in by get(), so the cache evicts the item whose
+    ///        next planned use is furthest away, and drops an item as soon as a lookup passes its
+    ///        last planned use.
+    ///
+    /// Lookups may run a little out of the planned order, for example from several threads: the
+    /// plan only moves forward, to the next planned use of each key looked up. Items with no
+    /// planned use left are evicted first, least recently used first.
+    /// \param keys The keys in the order they will be looked up, repeated lookups of a key in a
+    ///             row may be listed once.
+    void set_access_plan(std::vector<std::size_t> const & keys)
+    {
+        auto plan = std::make_unique<AccessPlan>();
+        for (auto const key : keys) {
+            if (!plan->steps.empty() && plan->steps.back() == key) {
+                continue;
+            }
+            plan->key_steps[key].push_back(plan->steps.size());
+            plan->steps.push_back(key);
+        }
+
+        std::lock_guard<std::mutex> l(m_plan_mutex);
+        m_plan = std::move(plan);
+        m_has_plan = true;
+    }
+
+    /// \brief Drop the access plan, returning to evicting the least recently used items.
+    void clear_access_plan()
+    {
+        std::lock_guard<std::mutex> l(m_plan_mutex);
+        m_plan.reset();
+        m_has_plan = false;
+    }
+
+    /// \brief Find if an access plan is set, see set_access_plan().
+    bool has_access_plan() const { return m_has_plan.load(); }
+
+    /// \brief Check if the item for [key] is cached or being loaded, without updating its use.
+    bool contains(std::size_t key) const
+    {
+        auto & shard = m_shards[key % SHARD_COUNT];
+        std::lock_guard<std::mutex> l(shard.mutex);
+        return shard.entries.find(key) != shard.entries.end();
+    }
+
+    /// \brief Evict every loaded item. Items still being loaded are cached once they load.
+    void clear()
+    {
+        for (auto & shard : m_shards) {
+            std::lock_guard<std::mutex> l(shard.mutex);
+            for (auto const key : shard.lru) {
+                auto const entry = shard.entries.find(key);
+                m_item_count -= 1;
+                m_byte_size -= entry->second->byte_size;
+                shard.entries.erase(entry);
+                shard.statistics.evictions += 1;
+            }
+            shard.lru.clear();
+        }
+    }
+
+    /// \brief Find the most items to keep cached, 0 for no limit.
+    std::size_t max_item_count() const { return m_max_item_count; }
+
+    /// \brief Find the most bytes of items to keep cached, 0 for no limit.
+    std::size_t max_byte_size() const { return m_max_byte_size; }
+
+    /// \brief Find the number of items currently cached.
+    std::size_t item_count() const { return m_item_count.load(); }
+
+    /// \brief Find the total size in bytes of the items currently cached.
+    std::size_t byte_size() const { return m_byte_size.load(); }
+
+    /// \brief Find the cache's lookup and eviction counts.
+    Statistics statistics() const
+    {
+        Statistics result;
+        for (auto const & shard : m_shards) {
+            std::lock_guard<std::mutex> l(shard.mutex);
+            result.hits += shard.statistics.hits;
+            result.misses += shard.statistics.misses;
+            result.evictions += shard.statistics.evictions;
+        }
+        return result;
+    }
+
+    /// \brief Find the counter name hits and misses are traced under.
+    char const * trace_name() const { return m_trace_name; }
+
+private:
+    struct Entry {
+        std::shared_future<Result<Value>> value;
+        std::size_t byte_size = 0;
+        std::uint64_t last_access = 0;
+        // Set once the item has loaded and is tracked in the shard's LRU list.
+        bool cached = false;
+        typename std::list<std::size_t>::iterator lru_position;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::size_t, std::shared_ptr<Entry>> entries;
+        // Keys of loaded items, ordered from most to least recently used.
+        std::list<std::size_t> lru;
+        // Counted under the shard's lock, so lookups don't contend on shared counters.
+        Statistics statistics;
+    };
+
+    /// The planned order of lookups, see set_access_plan().
+    struct AccessPlan {
+        // Keys in the order they will be looked up, repeated lookups in a row merged into a step.
+        std::vector<std::size_t> steps;
+        // The steps each key is looked up at, in order.
+        std::unordered_map<std::size_t, std::vector<std::size_t>> key_steps;
+        // The latest step a lookup has reached.
+        std::size_t current_step = 0;
+    };
+
+    static constexpr std::size_t NO_PLANNED_USE = std::numeric_limits<std::size_t>::max();
+
+    template <typename Loader>
+    Result<Value> lookup(std::size_t key, Loader && load)
+    {
+        auto & shard = m_shards[key % SHARD_COUNT];
+
+        std::shared_ptr<Entry> entry;
+        std::promise<Result<Value>> loaded_promise;
+        bool load_here = false;
+        {
+            std::lock_guard<std::mutex> l(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                shard.statistics.hits += 1;
+                entry = it->second;
+                if (entry->cached) {
+                    shard.lru.splice(shard.lru.begin(), shard.lru, entry->lru_position);
+                    entry->last_access = m_access_counter++;
+                }
+            } else {
+                entry = std::make_shared<Entry>();
+                entry->value = loaded_promise.get_future().share();
+                shard.entries.emplace(key, entry);
+                shard.statistics.misses += 1;
+                load_here = true;
+            }
+        }
+
+        if (!load_here) {
+            // Another thread loaded, or is loading, this item - share its result:
+            POD5_TRACE_COUNT(m_trace_name, "hits");
+            return entry->value.get();
+        }
+
+        POD5_TRACE_COUNT(m_trace_name, "misses");
+        return load_entry(shard, key, entry, loaded_promise, std::forward<Loader>(load));
+    }
+
+    // Move the plan on to the next planned use of [key], if it is ahead of the current step.
+    // Returns the keys whose last planned use was passed over.
+    std::vector<std::size_t> advance_plan(std::size_t key)
+    {
+        std::vector<std::size_t> finished_keys;
+        std::lock_guard<std::mutex> l(m_plan_mutex);
+        if (!m_plan) {
+            return finished_keys;
+        }
+        auto const next_step = next_planned_use(key);
+        if (next_step == NO_PLANNED_USE || next_step == m_plan->current_step) {
+            return finished_keys;
+        }
+        for (auto step = m_plan->current_step; step < next_step; ++step) {
+            auto const passed_key = m_plan->steps[step];
+            if (m_plan->key_steps.at(passed_key).back() == step) {
+                finished_keys.push_back(passed_key);
+            }
+        }
+        m_plan->current_step = next_step;
+        return finished_keys;
+    }
+
+    // Find the step of the next planned use of [key], at or after the current step, with the
+    // plan mutex held.
+    std::size_t next_planned_use(std::size_t key) const
+    {
+        auto const it = m_plan->key_steps.find(key);
+        if (it == m_plan->key_steps.end()) {
+            return NO_PLANNED_USE;
+        }
+        auto const & steps = it->second;
+        auto const next = std::lower_bound(steps.begin(), steps.end(), m_plan->current_step);
+        return next == steps.end() ? NO_PLANNED_USE : *next;
+    }
+
+    // Evict [key] from [shard] if it is loaded, with the shard's mutex held.
+    bool erase_cached(Shard & shard, std::size_t key)
+    {
+        auto const entry = shard.entries.find(key);
+        if (entry == shard.entries.end() || !entry->second->cached) {
+            return false;
+        }
+        m_item_count -= 1;
+        m_byte_size -= entry->second->byte_size;
+        shard.lru.erase(entry->second->lru_position);
+        shard.entries.erase(entry);
+        shard.statistics.evictions += 1;
+        return true;
+    }
+
+    void erase(std::size_t key)
+    {
+        auto & shard = m_shards[key % SHARD_COUNT];
+        std::lock_guard<std::mutex> l(shard.mutex);
+        erase_cached(shard, key);
+    }
+
+    template <typename Loader>
+    Result<Value> load_entry(
+        Shard & shard,
+        std::size_t key,
+        std::shared_ptr<Entry> const & entry,
+        std::promise<Result<Value>> & loaded_promise,
+        Loader && load)
+    {
+        Result<LoadedValue> loaded = load();
+        Result<Value> result =
+            loaded.ok() ? Result<Value>(loaded->value) : Result<Value>(loaded.status());
+        {
+            std::lock_guard<std::mutex> l(shard.mutex);
+            if (loaded.ok()) {
+                shard.lru.push_front(key);
+                entry->lru_position = shard.lru.begin();
+                entry->byte_size = loaded->byte_size;
+                entry->last_access = m_access_counter++;
+                entry->cached = true;
+                m_item_count += 1;
+                m_byte_size += loaded->byte_size;
+            } else {
+                // Forget the failure, so the next lookup tries again:
+                shard.entries.erase(key);
+            }
+        }
+        loaded_promise.set_value(result);
+
+        if (loaded.ok()) {
+            evict(key);
+        }
+        return result;
+    }
+
+    bool over_limit() const
+    {
+        return (m_max_item_count != 0 && m_item_count.load() > m_max_item_count)
+               || (m_max_byte_size != 0 && m_byte_size.load() > m_max_byte_size);
+    }
+
+    // Evict items across all shards until the cache is within its limits, never evicting
+    // [keep_key] so the item just loaded is always available. Evicts the item used furthest ahead
+    // in the access plan if one is set, otherwise the least recently used item.
+    void evict(std::size_t keep_key)
+    {
+        while (over_limit()) {
+            Shard * victim_shard = nullptr;
+            std::size_t victim_key = 0;
+            {
+                // The plan mutex is always taken before a shard's, and only one shard lock is
+                // held at a time, so this can't deadlock with other threads:
+                std::lock_guard<std::mutex> plan_lock(m_plan_mutex);
+                std::size_t victim_next_use = 0;
+                std::uint64_t victim_access = std::numeric_limits<std::uint64_t>::max();
+                for (auto & shard : m_shards) {
+                    std::lock_guard<std::mutex> l(shard.mutex);
+                    // Without a plan only the least recently used item of each shard competes:
+                    auto candidate_count = shard.lru.size();
+                    if (!m_plan) {
+                        candidate_count = std::min<std::size_t>(candidate_count, 1);
+                    }
+                    auto key_it = shard.lru.rbegin();
+                    for (std::size_t i = 0; i < candidate_count; ++i, ++key_it) {
+                        auto const key = *key_it;
+                        if (key == keep_key) {
+                            continue;
+                        }
+                        auto const next_use = m_plan ? next_planned_use(key) : 0;
+                        auto const access = shard.entries.at(key)->last_access;
+                        if (!victim_shard || next_use > victim_next_use
+                            || (next_use == victim_next_use && access < victim_access))
+                        {
+                            victim_shard = &shard;
+                            victim_key = key;
+                            victim_next_use = next_use;
+                            victim_access = access;
+                        }
+                    }
+                }
+            }
+            if (!victim_shard) {
+                return;
+            }
+
+            // Another thread may have evicted the item since, in which case rescan:
+            std::lock_guard<std::mutex> l(victim_shard->mutex);
+            erase_cached(*victim_shard, victim_key);
+        }
+    }
+
+    std::size_t const m_max_item_count;
+    std::size_t const m_max_byte_size;
+    char const * const m_trace_name;
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+    std::atomic<std::uint64_t> m_access_counter{0};
+    std::atomic<std::size_t> m_item_count{0};
+    std::atomic<std::size_t> m_byte_size{0};
+
+    std::mutex m_plan_mutex;
+    // Null unless an access plan is set:
+    std::unique_ptr<AccessPlan> m_plan;
+    // Set with [m_plan], so lookups without a plan don't take the plan mutex:
+    std::atomic<bool> m_has_plan{false};
+};
+
+}  // namespace pod5
@@ -0,0 +1,138 @@
+#include "pod5_format/internal/tracing/tracing.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pod5 { namespace internal { namespace tracing {
+
+namespace {
+
+struct Event {
+    char const * name;
+    // Null for spans.
+    char const * series;
+    std::int64_t start_ns;
+    // The span's duration, or the counter's value.
+    std::int64_t value;
+};
+
+// Events recorded by one thread. Threads append to their own list, so the lock is only
+// contended while flushing.
+struct ThreadEvents {
+    explicit ThreadEvents(std::size_t _thread_id) : thread_id(_thread_id) {}
+
+    std::size_t const thread_id;
+    std::mutex mutex;
+    std::vector<Event> events;
+};
+
+class Recorder {
+public:
+    // Stop recording past this many events, rather than growing without bound:
+    static constexpr std::size_t MAX_EVENTS = 50'000'000;
+
+    Recorder()
+    {
+        if (auto const path = std::getenv("POD5_TRACE_FILE")) {
+            m_path = path;
+        }
+    }
+
+    ~Recorder() { (void)flush(); }
+
+    bool enabled() const { return !m_path.empty(); }
+
+    void record(Event const & event)
+    {
+        if (m_event_count.fetch_add(1, std::memory_order_relaxed) >= MAX_EVENTS) {
+            return;
+        }
+        thread_local std::shared_ptr<ThreadEvents> const events = add_thread();
+        std::lock_guard<std::mutex> l(events->mutex);
+        events->events.push_back(event);
+    }
+
+    std::int64_t since_start(Clock::time_point time) const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_start).count();
+    }
+
+    Status flush()
+    {
+        if (!enabled()) {
+            return Status::OK();
+        }
+
+        std::lock_guard<std::mutex> l(m_mutex);
+        std::ofstream file(m_path, std::ios::trunc);
+        file << "{\"traceEvents\":[";
+        bool first = true;
+        for (auto const & thread : m_threads) {
+            std::lock_guard<std::mutex> thread_lock(thread->mutex);
+            for (auto const & event : thread->events) {
+                file << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name
+                     << "\",\"pid\":1,\"tid\":" << thread->thread_id
+                     << ",\"ts\":" << event.start_ns / 1000.0;
+                if (event.series) {
+                    file << ",\"ph\":\"C\",\"args\":{\"" << event.series << "\":" << event.value
+                         << "}}";
+                } else {
+                    file << ",\"ph\":\"X\",\"dur\":" << event.value / 1000.0 << "}";
+                }
+                first = false;
+            }
+        }
+        file << "\n]}\n";
+        file.close();
+        if (!file) {
+            return Status::IOError("Failed to write trace file ", m_path);
+        }
+        return Status::OK();
+    }
+
+private:
+    std::shared_ptr<ThreadEvents> add_thread()
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        m_threads.push_back(std::make_shared<ThreadEvents>(m_threads.size() + 1));
+        return m_threads.back();
+    }
+
+    std::string m_path;
+    Clock::time_point const m_start = Clock::now();
+    std::atomic<std::size_t> m_event_count{0};
+
+    std::mutex m_mutex;
+    // Kept after their threads exit, until the process does.
+    std::vector<std::shared_ptr<ThreadEvents>> m_threads;
+};
+
+Recorder & recorder()
+{
+    static Recorder recorder;
+    return recorder;
+}
+
+}  // namespace
+
+bool enabled() { return recorder().enabled(); }
+
+void record_span(char const * name, Clock::time_point start, Clock::time_point end)
+{
+    auto & r = recorder();
+    r.record({name, nullptr, r.since_start(start), r.since_start(end) - r.since_start(start)});
+}
+
+void record_counter(char const * name, char const * series, std::int64_t value)
+{
+    auto & r = recorder();
+    r.record({name, series, r.since_start(Clock::now()), value});
+}
+
+Status flush() { return recorder().flush(); }
+
+}}}  // namespace pod5::internal::tracing
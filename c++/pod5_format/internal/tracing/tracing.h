@@ -1,3 +1,103 @@
 #pragma once
 
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// Tracing of pod5's hot paths, compiled in with the POD5_ENABLE_TRACING cmake option and
+/// otherwise compiled out entirely.
+///
+/// When compiled in, tracing runs only if the POD5_TRACE_FILE environment variable names a file
+/// when the first event is traced. Events are written to that file in Chrome's trace event JSON
+/// format, viewable in Perfetto or chrome://tracing, when the process exits or on flush().
+///
+/// Event names and counter series must be string literals, or otherwise live until the process
+/// exits, as only the pointers are stored.
+
+namespace pod5 { namespace internal { namespace tracing {
+
+using Clock = std::chrono::steady_clock;
+
+/// \brief Find if events are being recorded, checking POD5_TRACE_FILE on the first call.
+POD5_FORMAT_EXPORT bool enabled();
+
+/// \brief Record a span [name] on the calling thread, from [start] to [end].
+POD5_FORMAT_EXPORT void record_span(
+    char const * name,
+    Clock::time_point start,
+    Clock::time_point end);
+
+/// \brief Record that the [series] of counter [name] is now [value].
+POD5_FORMAT_EXPORT void record_counter(char const * name, char const * series, std::int64_t value);
+
+/// \brief Write every event recorded so far to the trace file, replacing its contents.
+POD5_FORMAT_EXPORT Status flush();
+
+/// \brief Records a span covering its own lifetime.
+class ScopedSpan {
+public:
+    explicit ScopedSpan(char const * name) : m_name(enabled() ? name : nullptr)
+    {
+        if (m_name) {
+            m_start = Clock::now();
+        }
+    }
+
+    ~ScopedSpan()
+    {
+        if (m_name) {
+            record_span(m_name, m_start, Clock::now());
+        }
+    }
+
+    ScopedSpan(ScopedSpan const &) = delete;
+    ScopedSpan & operator=(ScopedSpan const &) = delete;
+
+private:
+    char const * m_name;
+    Clock::time_point m_start;
+};
+
+}}}  // namespace pod5::internal::tracing
+
+#define POD5_TRACE_CONCAT_INNER(a, b) a##b
+#define POD5_TRACE_CONCAT(a, b) POD5_TRACE_CONCAT_INNER(a, b)
+
+#ifdef POD5_ENABLE_TRACING
+
+/// Trace the rest of the enclosing scope as a span named after the enclosing function.
+#define POD5_TRACE_FUNCTION() POD5_TRACE_SPAN(__func__)
+
+/// Trace the rest of the enclosing scope as a span called [name].
+#define POD5_TRACE_SPAN(name) \
+    ::pod5::internal::tracing::ScopedSpan POD5_TRACE_CONCAT(pod5_trace_span_, __LINE__)(name)
+
+/// Record [value] for the [series] of counter [name].
+#define POD5_TRACE_COUNTER(name, series, value)                                   \
+    do {                                                                          \
+        if (::pod5::internal::tracing::enabled()) {                               \
+            ::pod5::internal::tracing::record_counter(name, series, (value));     \
+        }                                                                         \
+    } while (false)
+
+/// Count each time this line runs, as the [series] of counter [name]. The count is shared by
+/// every call from this line, so each line should count one series.
+#define POD5_TRACE_COUNT(name, series)                                                     \
+    do {                                                                                   \
+        static std::atomic<std::int64_t> pod5_trace_count{0};                              \
+        if (::pod5::internal::tracing::enabled()) {                                        \
+            ::pod5::internal::tracing::record_counter(name, series, ++pod5_trace_count);   \
+        }                                                                                  \
+    } while (false)
+
+#else
+
 #define POD5_TRACE_FUNCTION()
+#define POD5_TRACE_SPAN(name)
+#define POD5_TRACE_COUNTER(name, series, value)
+#define POD5_TRACE_COUNT(name, series)
+
+#endif
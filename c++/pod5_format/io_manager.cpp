@@ -1,7 +1,14 @@
 #include "pod5_format/io_manager.h"
 
+#include "pod5_format/internal/io_uring_ring.h"
+
 #ifdef __linux__
 #include <unistd.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <vector>
 #endif
 
 namespace pod5 {
@@ -75,6 +82,132 @@ arrow::Result<std::shared_ptr<IOManager>> make_sync_io_manager(arrow::MemoryPool
 {
     return std::make_shared<IOManagerSyncImpl>(memory_pool);
 }
+
+#ifdef POD5_HAS_IO_URING
+class IOManagerIoUringImpl : public IOManager {
+public:
+    IOManagerIoUringImpl(
+        std::unique_ptr<io_uring::IoUringRing> && ring,
+        arrow::MemoryPool * memory_pool)
+    : m_memory_pool(memory_pool)
+    , m_cached_write_count(std::max<std::size_t>(CachedBufferCount, ring->queue_depth()))
+    , m_ring(std::move(ring))
+    {
+    }
+
+    arrow::Result<std::shared_ptr<QueuedWrite>> allocate_new_write(std::size_t capacity) override
+    {
+        std::unique_lock<std::mutex> l(m_mutex);
+        if (m_queued_writes.size()) {
+            auto new_write = m_queued_writes.back();
+            m_queued_writes.pop_back();
+            l.unlock();
+            ARROW_RETURN_NOT_OK(new_write->reset_queued_write());
+            ARROW_RETURN_NOT_OK(new_write->get_buffer().Reserve(capacity));
+            assert((std::size_t)new_write->get_buffer().capacity() >= capacity);
+            return new_write;
+        }
+        l.unlock();
+
+        ARROW_ASSIGN_OR_RAISE(
+            std::unique_ptr<arrow::ResizableBuffer> buffer,
+            arrow::AllocateResizableBuffer(capacity, IOManager::Alignment, m_memory_pool));
+        ARROW_RETURN_NOT_OK(buffer->Resize(0, false));
+        assert((std::size_t)buffer->capacity() >= capacity);
+        return std::make_shared<QueuedWrite>(std::move(buffer));
+    }
+
+    arrow::Status return_used_write(std::shared_ptr<QueuedWrite> && used_write) override
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        if (m_queued_writes.size() < m_cached_write_count) {
+            m_queued_writes.push_back(std::move(used_write));
+        }
+        used_write.reset();
+        return arrow::Status::OK();
+    }
+
+    arrow::Status write_buffer(std::shared_ptr<QueuedWrite> && data) override
+    {
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            ARROW_RETURN_NOT_OK(m_write_error);
+        }
+
+        data->set_state(QueuedWrite::WriteState::InFlight);
+        auto const & buffer = data->get_buffer();
+        std::vector<io_uring::WriteRequest> requests{
+            {data->file_descriptor(),
+             data->file_offset(),
+             buffer.data(),
+             std::uint64_t(buffer.size()),
+             [this, data](std::int64_t result) { complete_write(*data, result); }}};
+
+        // Waits for a write to complete when the ring is full:
+        auto const submitted = m_ring->submit_writes(std::move(requests));
+        if (!submitted.ok()) {
+            data->set_state(QueuedWrite::WriteState::Completed);
+        }
+        return submitted;
+    }
+
+    arrow::Status wait_for_event(std::chrono::nanoseconds timeout) override
+    {
+        std::unique_lock<std::mutex> l(m_mutex);
+        auto const completed_writes = m_completed_writes;
+        m_write_completed.wait_for(
+            l, timeout, [&] { return m_completed_writes != completed_writes; });
+        return m_write_error;
+    }
+
+private:
+    void complete_write(QueuedWrite & data, std::int64_t result)
+    {
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            auto const expected = data.get_buffer().size();
+            if (result != expected && m_write_error.ok()) {
+                m_write_error = arrow::Status::IOError(
+                    "Error writing to file: ",
+                    result < 0 ? std::strerror(-result) : "short write",
+                    " desc: ",
+                    data.file_descriptor(),
+                    " offset: ",
+                    data.file_offset(),
+                    " size: ",
+                    expected);
+            }
+            data.set_state(QueuedWrite::WriteState::Completed);
+            m_completed_writes += 1;
+        }
+        m_write_completed.notify_all();
+    }
+
+    arrow::MemoryPool * m_memory_pool;
+    std::size_t m_cached_write_count;
+
+    std::mutex m_mutex;
+    std::condition_variable m_write_completed;
+    std::vector<std::shared_ptr<QueuedWrite>> m_queued_writes;
+    std::uint64_t m_completed_writes = 0;
+    arrow::Status m_write_error;
+
+    // Destroyed first, waiting for writes in flight, which complete into the members above:
+    std::unique_ptr<io_uring::IoUringRing> m_ring;
+};
+#endif
+
+arrow::Result<std::shared_ptr<IOManager>> make_io_uring_io_manager(
+    arrow::MemoryPool * memory_pool,
+    std::uint32_t queue_depth)
+{
+#ifdef POD5_HAS_IO_URING
+    ARROW_ASSIGN_OR_RAISE(auto ring, io_uring::IoUringRing::create(queue_depth));
+    return std::make_shared<IOManagerIoUringImpl>(std::move(ring), memory_pool);
+#else
+    return arrow::Status::NotImplemented("io_uring is not supported on this platform");
+#endif
+}
 #endif
 
 }  // namespace pod5
@@ -53,16 +53,17 @@ public:
 
     enum class WriteState { Empty, ReadyForWrite, InFlight, Completed };
 
-    WriteState state() const { return m_state; }
+    // The state is atomic, as writes may be completed on another thread:
+    WriteState state() const { return m_state.load(std::memory_order_acquire); }
 
-    void set_state(WriteState state) { m_state = state; }
+    void set_state(WriteState state) { m_state.store(state, std::memory_order_release); }
 
 private:
     std::unique_ptr<arrow::ResizableBuffer> m_buffer;
     std::uint64_t m_file_offset{(std::uint64_t)-1};
     iovec m_iovec{};
     int m_file_descriptor{-1};
-    WriteState m_state{WriteState::Empty};
+    std::atomic<WriteState> m_state{WriteState::Empty};
 };
 #endif
 
@@ -87,6 +88,14 @@ public:
 #ifdef __linux__
 arrow::Result<std::shared_ptr<IOManager>> make_sync_io_manager(
     arrow::MemoryPool * memory_pool = arrow::default_memory_pool());
+
+/// \brief Make an IO manager keeping up to [queue_depth] writes in flight through io_uring.
+///
+/// The manager is thread safe, so one can be shared by several writers.
+/// \note Returns NotImplemented where io_uring is unavailable.
+arrow::Result<std::shared_ptr<IOManager>> make_io_uring_io_manager(
+    arrow::MemoryPool * memory_pool = arrow::default_memory_pool(),
+    std::uint32_t queue_depth = 32);
 #endif
 
 }  // namespace pod5
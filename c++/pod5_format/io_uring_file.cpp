@@ -0,0 +1,248 @@
+#include "pod5_format/io_uring_file.h"
+
+#include "pod5_format/internal/io_uring_ring.h"
+#include "pod5_format/io_manager.h"
+
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/util/future.h>
+
+#ifdef POD5_HAS_IO_URING
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace pod5 {
+
+#ifdef POD5_HAS_IO_URING
+
+namespace {
+
+class IoUringFile : public arrow::io::RandomAccessFile {
+public:
+    IoUringFile(
+        int fd,
+        std::int64_t size,
+        std::unique_ptr<io_uring::IoUringRing> && ring,
+        arrow::MemoryPool * pool)
+    : m_fd(fd)
+    , m_size(size)
+    , m_ring(std::move(ring))
+    , m_pool(pool)
+    {
+    }
+
+    ~IoUringFile() override { (void)Close(); }
+
+    arrow::Status Close() override
+    {
+        std::lock_guard<std::mutex> l(m_close_mutex);
+        if (m_fd < 0) {
+            return arrow::Status::OK();
+        }
+        // Destroying the ring waits for reads in flight, which may still use the descriptor:
+        m_ring.reset();
+        auto const result = close(m_fd);
+        m_fd = -1;
+        if (result != 0) {
+            return arrow::Status::IOError("Failed to close file: ", std::strerror(errno));
+        }
+        return arrow::Status::OK();
+    }
+
+    bool closed() const override { return m_fd < 0; }
+
+    arrow::Result<std::int64_t> Tell() const override
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        std::lock_guard<std::mutex> l(m_position_mutex);
+        return m_position;
+    }
+
+    arrow::Status Seek(std::int64_t position) override
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        if (position < 0) {
+            return arrow::Status::Invalid("Invalid seek position ", position);
+        }
+        std::lock_guard<std::mutex> l(m_position_mutex);
+        m_position = position;
+        return arrow::Status::OK();
+    }
+
+    arrow::Result<std::int64_t> GetSize() override
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        return m_size;
+    }
+
+    arrow::Result<std::int64_t> Read(std::int64_t nbytes, void * out) override
+    {
+        std::lock_guard<std::mutex> l(m_position_mutex);
+        ARROW_ASSIGN_OR_RAISE(auto const read, ReadAt(m_position, nbytes, out));
+        m_position += read;
+        return read;
+    }
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Read(std::int64_t nbytes) override
+    {
+        std::lock_guard<std::mutex> l(m_position_mutex);
+        ARROW_ASSIGN_OR_RAISE(auto buffer, ReadAt(m_position, nbytes));
+        m_position += buffer->size();
+        return buffer;
+    }
+
+    arrow::Result<std::int64_t> ReadAt(std::int64_t position, std::int64_t nbytes, void * out)
+        override
+    {
+        ARROW_ASSIGN_OR_RAISE(nbytes, clamp_read(position, nbytes));
+        if (nbytes == 0) {
+            return 0;
+        }
+
+        std::promise<std::int64_t> result;
+        auto result_future = result.get_future();
+        std::vector<io_uring::ReadRequest> requests{
+            {m_fd, std::uint64_t(position), out, std::uint64_t(nbytes), [&](std::int64_t res) {
+                 result.set_value(res);
+             }}};
+        ARROW_RETURN_NOT_OK(m_ring->submit_reads(std::move(requests)));
+        auto const read = result_future.get();
+        if (read < 0) {
+            return arrow::Status::IOError("Failed to read file: ", std::strerror(-read));
+        }
+        return read;
+    }
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(std::int64_t position, std::int64_t nbytes)
+        override
+    {
+        return ReadAsync(arrow::io::default_io_context(), position, nbytes).result();
+    }
+
+    arrow::Future<std::shared_ptr<arrow::Buffer>>
+    ReadAsync(arrow::io::IOContext const &, std::int64_t position, std::int64_t nbytes) override
+    {
+        using BufferFuture = arrow::Future<std::shared_ptr<arrow::Buffer>>;
+
+        auto clamped = clamp_read(position, nbytes);
+        if (!clamped.ok()) {
+            return BufferFuture::MakeFinished(clamped.status());
+        }
+        nbytes = *clamped;
+
+        auto allocated = arrow::AllocateResizableBuffer(nbytes, IOManager::Alignment, m_pool);
+        if (!allocated.ok()) {
+            return BufferFuture::MakeFinished(allocated.status());
+        }
+        std::shared_ptr<arrow::ResizableBuffer> buffer = std::move(*allocated);
+        if (nbytes == 0) {
+            return BufferFuture::MakeFinished(std::shared_ptr<arrow::Buffer>(buffer));
+        }
+
+        auto future = BufferFuture::Make();
+        std::vector<io_uring::ReadRequest> requests{
+            {m_fd,
+             std::uint64_t(position),
+             buffer->mutable_data(),
+             std::uint64_t(nbytes),
+             [future, buffer](std::int64_t res) mutable {
+                 if (res < 0) {
+                     future.MarkFinished(
+                         arrow::Status::IOError("Failed to read file: ", std::strerror(-res)));
+                     return;
+                 }
+                 auto const resized = buffer->Resize(res, false);
+                 if (!resized.ok()) {
+                     future.MarkFinished(resized);
+                     return;
+                 }
+                 future.MarkFinished(std::shared_ptr<arrow::Buffer>(std::move(buffer)));
+             }}};
+        auto const submitted = m_ring->submit_reads(std::move(requests));
+        if (!submitted.ok()) {
+            return BufferFuture::MakeFinished(submitted);
+        }
+        return future;
+    }
+
+    arrow::Status WillNeed(std::vector<arrow::io::ReadRange> const & ranges) override
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        for (auto const & range : ranges) {
+            // Only a hint, so failures are ignored:
+            (void)posix_fadvise(m_fd, range.offset, range.length, POSIX_FADV_WILLNEED);
+        }
+        return arrow::Status::OK();
+    }
+
+private:
+    arrow::Status check_open() const
+    {
+        if (m_fd < 0) {
+            return arrow::Status::Invalid("Operation on closed file");
+        }
+        return arrow::Status::OK();
+    }
+
+    // Limit a read to the end of the file, as reads past the end return the bytes that exist.
+    arrow::Result<std::int64_t> clamp_read(std::int64_t position, std::int64_t nbytes) const
+    {
+        ARROW_RETURN_NOT_OK(check_open());
+        if (position < 0 || nbytes < 0) {
+            return arrow::Status::Invalid(
+                "Invalid read (offset = ", position, ", size = ", nbytes, ")");
+        }
+        return std::max<std::int64_t>(0, std::min(nbytes, m_size - position));
+    }
+
+    int m_fd;
+    std::int64_t const m_size;
+    std::unique_ptr<io_uring::IoUringRing> m_ring;
+    arrow::MemoryPool * m_pool;
+
+    std::mutex m_close_mutex;
+    mutable std::mutex m_position_mutex;
+    std::int64_t m_position = 0;
+};
+
+}  // namespace
+
+Result<std::shared_ptr<arrow::io::RandomAccessFile>>
+open_io_uring_file(std::string const & path, std::uint32_t queue_depth, arrow::MemoryPool * pool)
+{
+    ARROW_ASSIGN_OR_RAISE(auto ring, io_uring::IoUringRing::create(queue_depth));
+
+    int const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Status::IOError("Failed to open file '", path, "': ", std::strerror(errno));
+    }
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0) {
+        auto const error = errno;
+        close(fd);
+        return Status::IOError("Failed to stat file '", path, "': ", std::strerror(error));
+    }
+
+    return std::make_shared<IoUringFile>(fd, file_stat.st_size, std::move(ring), pool);
+}
+
+#else
+
+Result<std::shared_ptr<arrow::io::RandomAccessFile>>
+open_io_uring_file(std::string const &, std::uint32_t, arrow::MemoryPool *)
+{
+    return Status::NotImplemented("io_uring is not supported on this platform");
+}
+
+#endif
+
+}  // namespace pod5
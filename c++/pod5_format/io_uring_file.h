@@ -0,0 +1,28 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <arrow/io/type_fwd.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace arrow {
+class MemoryPool;
+}
+
+namespace pod5 {
+
+/// \brief Open [path] for reading through an io_uring ring, so many reads can be in flight at
+///        once: ReadAsync() queues a read and returns without waiting for it.
+///
+/// Reads land in buffers allocated from [pool], aligned to IOManager::Alignment.
+/// \param queue_depth  The most reads to have in flight at once.
+/// \returns NotImplemented where io_uring is unavailable, for example on other platforms, older
+///          kernels, or when disabled by a sandbox.
+POD5_FORMAT_EXPORT Result<std::shared_ptr<arrow::io::RandomAccessFile>>
+open_io_uring_file(std::string const & path, std::uint32_t queue_depth, arrow::MemoryPool * pool);
+
+}  // namespace pod5
@@ -1,11 +1,20 @@
 #include "memory_pool.h"
 
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
 #ifdef _WIN32
 #include <windows.h>
 #elif !defined(__FreeBSD__)
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 namespace {
 
 // Referenced from the jemalloc source:
@@ -31,6 +40,55 @@ size_t os_page_detect(void)
 #endif
 }
 
+bool is_huge_page_allocation(std::int64_t size, std::int64_t alignment)
+{
+#ifdef __linux__
+    // Mappings are page aligned, which satisfies any alignment arrow asks for:
+    return size >= pod5::HugePageMemoryPool::HUGE_PAGE_BYTES && alignment <= 4096;
+#else
+    (void)size;
+    (void)alignment;
+    return false;
+#endif
+}
+
+std::int64_t huge_page_mapping_size(std::int64_t size)
+{
+    auto const page = pod5::HugePageMemoryPool::HUGE_PAGE_BYTES;
+    return (size + page - 1) / page * page;
+}
+
+#ifdef __linux__
+// Map [size] bytes aligned to a huge page, so the kernel can back them with huge pages.
+arrow::Status map_huge_pages(std::int64_t size, std::uint8_t ** out)
+{
+    auto const page = pod5::HugePageMemoryPool::HUGE_PAGE_BYTES;
+    auto const mapping_size = huge_page_mapping_size(size);
+    // Map an extra page to align within, then unmap the unaligned ends:
+    auto const mapped = mmap(
+        nullptr, mapping_size + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        return arrow::Status::OutOfMemory(
+            "Failed to map ", mapping_size, " bytes: ", std::strerror(errno));
+    }
+
+    auto const start = reinterpret_cast<std::uintptr_t>(mapped);
+    auto const aligned_start = (start + page - 1) / page * page;
+    auto const head = aligned_start - start;
+    if (head > 0) {
+        munmap(mapped, head);
+    }
+    if (auto const tail = page - head) {
+        munmap(reinterpret_cast<void *>(aligned_start + mapping_size), tail);
+    }
+
+    // Only a hint, the memory is still usable if the kernel won't use huge pages:
+    madvise(reinterpret_cast<void *>(aligned_start), mapping_size, MADV_HUGEPAGE);
+    *out = reinterpret_cast<std::uint8_t *>(aligned_start);
+    return arrow::Status::OK();
+}
+#endif
+
 }  // namespace
 
 namespace pod5 {
@@ -44,4 +102,358 @@ arrow::MemoryPool * default_memory_pool()
     return arrow::default_memory_pool();
 }
 
+Result<arrow::MemoryPool *> memory_pool_for_backend(MemoryPoolBackend backend)
+{
+    arrow::MemoryPool * pool = nullptr;
+    switch (backend) {
+    case MemoryPoolBackend::Default:
+        return default_memory_pool();
+    case MemoryPoolBackend::System:
+        return arrow::system_memory_pool();
+    case MemoryPoolBackend::Jemalloc:
+        if (os_page_detect() > 4096) {
+            return arrow::Status::NotImplemented("jemalloc doesn't support pages larger than 4KiB");
+        }
+        ARROW_RETURN_NOT_OK(arrow::jemalloc_memory_pool(&pool));
+        return pool;
+    case MemoryPoolBackend::Mimalloc:
+        ARROW_RETURN_NOT_OK(arrow::mimalloc_memory_pool(&pool));
+        return pool;
+    case MemoryPoolBackend::HugePages: {
+#ifdef __linux__
+        // Never destroyed, as buffers may still be freed to it while the process exits:
+        static auto const huge_page_pool = new HugePageMemoryPool(default_memory_pool());
+        pool = huge_page_pool;
+        return pool;
+#else
+        return arrow::Status::NotImplemented("Huge page memory pools are only available on Linux");
+#endif
+    }
+    }
+    return arrow::Status::Invalid("Unknown memory pool backend ", int(backend));
+}
+
+HugePageMemoryPool::HugePageMemoryPool(arrow::MemoryPool * pool) : arrow::ProxyMemoryPool(pool) {}
+
+arrow::Status
+HugePageMemoryPool::Allocate(std::int64_t size, std::int64_t alignment, std::uint8_t ** out)
+{
+    if (!is_huge_page_allocation(size, alignment)) {
+        return arrow::ProxyMemoryPool::Allocate(size, alignment, out);
+    }
+#ifdef __linux__
+    ARROW_RETURN_NOT_OK(map_huge_pages(size, out));
+    m_huge_page_bytes += huge_page_mapping_size(size);
+#endif
+    return arrow::Status::OK();
+}
+
+arrow::Status HugePageMemoryPool::Reallocate(
+    std::int64_t old_size,
+    std::int64_t new_size,
+    std::int64_t alignment,
+    std::uint8_t ** ptr)
+{
+    auto const old_huge = is_huge_page_allocation(old_size, alignment);
+    auto const new_huge = is_huge_page_allocation(new_size, alignment);
+    if (!old_huge && !new_huge) {
+        return arrow::ProxyMemoryPool::Reallocate(old_size, new_size, alignment, ptr);
+    }
+    if (old_huge && new_huge
+        && huge_page_mapping_size(old_size) == huge_page_mapping_size(new_size))
+    {
+        return arrow::Status::OK();
+    }
+
+    std::uint8_t * allocation = nullptr;
+    ARROW_RETURN_NOT_OK(Allocate(new_size, alignment, &allocation));
+    std::memcpy(allocation, *ptr, std::size_t(old_size < new_size ? old_size : new_size));
+    Free(*ptr, old_size, alignment);
+    *ptr = allocation;
+    return arrow::Status::OK();
+}
+
+void HugePageMemoryPool::Free(std::uint8_t * buffer, std::int64_t size, std::int64_t alignment)
+{
+    if (!is_huge_page_allocation(size, alignment)) {
+        arrow::ProxyMemoryPool::Free(buffer, size, alignment);
+        return;
+    }
+#ifdef __linux__
+    munmap(buffer, huge_page_mapping_size(size));
+    m_huge_page_bytes -= huge_page_mapping_size(size);
+#endif
+}
+
+std::int64_t HugePageMemoryPool::bytes_allocated() const
+{
+    return arrow::ProxyMemoryPool::bytes_allocated() + m_huge_page_bytes;
+}
+
+std::string HugePageMemoryPool::backend_name() const
+{
+    return "huge_pages(" + arrow::ProxyMemoryPool::backend_name() + ")";
+}
+
+RecyclingMemoryPool::RecyclingMemoryPool(arrow::MemoryPool * pool, std::size_t max_cached_bytes)
+: arrow::ProxyMemoryPool(pool)
+, m_max_cached_bytes(max_cached_bytes)
+, m_cached_bytes(0)
+, m_recycled_allocations(0)
+{
+}
+
+RecyclingMemoryPool::~RecyclingMemoryPool() { ReleaseUnused(); }
+
+arrow::Status
+RecyclingMemoryPool::Allocate(std::int64_t size, std::int64_t alignment, std::uint8_t ** out)
+{
+    if (size < MIN_RECYCLED_BYTES) {
+        return arrow::ProxyMemoryPool::Allocate(size, alignment, out);
+    }
+
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        if (auto const cached = take_cached(size, alignment)) {
+            *out = cached;
+            return arrow::Status::OK();
+        }
+    }
+
+    ARROW_RETURN_NOT_OK(arrow::ProxyMemoryPool::Allocate(size, alignment, out));
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_capacities[*out] = size;
+    return arrow::Status::OK();
+}
+
+arrow::Status RecyclingMemoryPool::Reallocate(
+    std::int64_t old_size,
+    std::int64_t new_size,
+    std::int64_t alignment,
+    std::uint8_t ** ptr)
+{
+    std::unique_lock<std::mutex> l(m_mutex);
+    auto const capacity_it = m_capacities.find(*ptr);
+    if (capacity_it == m_capacities.end()) {
+        l.unlock();
+        if (old_size == 0 && new_size >= MIN_RECYCLED_BYTES) {
+            // There is nothing to copy, so a cached allocation is as good as a new one:
+            std::uint8_t * allocation = nullptr;
+            ARROW_RETURN_NOT_OK(Allocate(new_size, alignment, &allocation));
+            arrow::ProxyMemoryPool::Free(*ptr, old_size, alignment);
+            *ptr = allocation;
+            return arrow::Status::OK();
+        }
+
+        ARROW_RETURN_NOT_OK(
+            arrow::ProxyMemoryPool::Reallocate(old_size, new_size, alignment, ptr));
+        if (new_size >= MIN_RECYCLED_BYTES) {
+            l.lock();
+            m_capacities[*ptr] = new_size;
+        }
+        return arrow::Status::OK();
+    }
+
+    // Recycled allocations may already be large enough:
+    auto const capacity = capacity_it->second;
+    if (new_size <= capacity) {
+        return arrow::Status::OK();
+    }
+    m_capacities.erase(capacity_it);
+    l.unlock();
+
+    auto const status = arrow::ProxyMemoryPool::Reallocate(capacity, new_size, alignment, ptr);
+    l.lock();
+    // On failure [ptr] is left as it was, so is still ours to track:
+    m_capacities[*ptr] = status.ok() ? new_size : capacity;
+    return status;
+}
+
+void RecyclingMemoryPool::Free(std::uint8_t * buffer, std::int64_t size, std::int64_t alignment)
+{
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        auto const capacity_it = m_capacities.find(buffer);
+        if (capacity_it != m_capacities.end()) {
+            size = capacity_it->second;
+            m_capacities.erase(capacity_it);
+            if (m_cached_bytes + size <= m_max_cached_bytes) {
+                m_cache.emplace(size, CachedAllocation{buffer, alignment});
+                m_cached_bytes += size;
+                return;
+            }
+        }
+    }
+
+    arrow::ProxyMemoryPool::Free(buffer, size, alignment);
+}
+
+void RecyclingMemoryPool::ReleaseUnused()
+{
+    decltype(m_cache) cache;
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        std::swap(cache, m_cache);
+        m_cached_bytes = 0;
+    }
+
+    for (auto const & [capacity, allocation] : cache) {
+        arrow::ProxyMemoryPool::Free(allocation.data, capacity, allocation.alignment);
+    }
+    arrow::ProxyMemoryPool::ReleaseUnused();
+}
+
+std::size_t RecyclingMemoryPool::cached_bytes() const
+{
+    std::lock_guard<std::mutex> l(m_mutex);
+    return m_cached_bytes;
+}
+
+std::size_t RecyclingMemoryPool::recycled_allocations() const
+{
+    std::lock_guard<std::mutex> l(m_mutex);
+    return m_recycled_allocations;
+}
+
+std::uint8_t * RecyclingMemoryPool::take_cached(std::int64_t size, std::int64_t alignment)
+{
+    // Only reuse allocations up to twice the size asked for, so small requests don't hold on to
+    // large allocations:
+    auto const end = m_cache.upper_bound(size * 2);
+    for (auto it = m_cache.lower_bound(size); it != end; ++it) {
+        if (it->second.alignment != alignment) {
+            continue;
+        }
+
+        auto const data = it->second.data;
+        m_capacities[data] = it->first;
+        m_cached_bytes -= it->first;
+        m_cache.erase(it);
+        m_recycled_allocations += 1;
+        return data;
+    }
+    return nullptr;
+}
+
+TrackingMemoryPool::TrackingMemoryPool(
+    arrow::MemoryPool * pool,
+    std::string name,
+    std::int64_t max_bytes)
+: arrow::ProxyMemoryPool(pool)
+, m_name(std::move(name))
+, m_max_bytes(max_bytes)
+{
+}
+
+arrow::Status
+TrackingMemoryPool::Allocate(std::int64_t size, std::int64_t alignment, std::uint8_t ** out)
+{
+    ARROW_RETURN_NOT_OK(reserve(size));
+    auto const status = arrow::ProxyMemoryPool::Allocate(size, alignment, out);
+    if (!status.ok()) {
+        m_bytes_allocated -= size;
+        return status;
+    }
+    m_allocation_count += 1;
+    return status;
+}
+
+arrow::Status TrackingMemoryPool::Reallocate(
+    std::int64_t old_size,
+    std::int64_t new_size,
+    std::int64_t alignment,
+    std::uint8_t ** ptr)
+{
+    // Growth is counted before reallocating, so it can be refused, shrinking once done:
+    auto const growth = new_size > old_size ? new_size - old_size : 0;
+    ARROW_RETURN_NOT_OK(reserve(growth));
+    auto const status = arrow::ProxyMemoryPool::Reallocate(old_size, new_size, alignment, ptr);
+    if (!status.ok()) {
+        m_bytes_allocated -= growth;
+        return status;
+    }
+    m_bytes_allocated -= old_size > new_size ? old_size - new_size : 0;
+    return status;
+}
+
+void TrackingMemoryPool::Free(std::uint8_t * buffer, std::int64_t size, std::int64_t alignment)
+{
+    arrow::ProxyMemoryPool::Free(buffer, size, alignment);
+    m_bytes_allocated -= size;
+}
+
+MemoryPoolStatistics TrackingMemoryPool::statistics() const
+{
+    MemoryPoolStatistics result;
+    result.bytes_allocated = m_bytes_allocated;
+    result.peak_bytes_allocated = m_peak_bytes_allocated;
+    result.allocation_count = m_allocation_count;
+    result.failed_allocations = m_failed_allocations;
+    result.max_bytes = m_max_bytes;
+    return result;
+}
+
+arrow::Status TrackingMemoryPool::reserve(std::int64_t bytes)
+{
+    auto const allocated = m_bytes_allocated += bytes;
+    auto const max_bytes = m_max_bytes.load();
+    if (max_bytes > 0 && allocated > max_bytes) {
+        m_bytes_allocated -= bytes;
+        m_failed_allocations += 1;
+        return arrow::Status::OutOfMemory(
+            "Allocating ",
+            bytes,
+            " bytes would take the ",
+            m_name,
+            " memory pool over its limit of ",
+            max_bytes,
+            " bytes");
+    }
+
+    auto peak = m_peak_bytes_allocated.load();
+    while (allocated > peak && !m_peak_bytes_allocated.compare_exchange_weak(peak, allocated)) {
+    }
+    return arrow::Status::OK();
+}
+
+char const * memory_subsystem_name(MemorySubsystem subsystem)
+{
+    switch (subsystem) {
+    case MemorySubsystem::SignalCache:
+        return "signal_cache";
+    case MemorySubsystem::ReadTableDecode:
+        return "read_table_decode";
+    case MemorySubsystem::WriterBuilders:
+        return "writer_builders";
+    case MemorySubsystem::CompressionScratch:
+        return "compression_scratch";
+    case MemorySubsystem::Repacker:
+        return "repacker";
+    }
+    return "unknown";
+}
+
+TrackingMemoryPool & subsystem_memory_pool(MemorySubsystem subsystem)
+{
+    using Pools = std::array<TrackingMemoryPool *, MEMORY_SUBSYSTEM_COUNT>;
+    // Never destroyed, as buffers may still be freed to them while the process exits:
+    static Pools const pools = [] {
+        Pools result;
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            result[i] = new TrackingMemoryPool(
+                default_memory_pool(), memory_subsystem_name(MemorySubsystem(i)));
+        }
+        return result;
+    }();
+    return *pools[std::size_t(subsystem)];
+}
+
+arrow::MemoryPool * tagged_memory_pool(MemorySubsystem subsystem, arrow::MemoryPool * pool)
+{
+    if (pool != default_memory_pool()) {
+        return pool;
+    }
+    return &subsystem_memory_pool(subsystem);
+}
+
 }  // namespace pod5
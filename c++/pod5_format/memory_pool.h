@@ -1,6 +1,17 @@
 #pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
 #include <arrow/memory_pool.h>
 
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 namespace pod5 {
 
 /// \brief Find a memory pool that should be used by default when opening or creating a pod5 file.
@@ -8,4 +19,201 @@ namespace pod5 {
 ///       pages, which jemalloc does not support.
 arrow::MemoryPool * default_memory_pool();
 
+/// \brief The allocators a pod5 memory pool can be backed by.
+enum class MemoryPoolBackend : std::uint8_t {
+    /// default_memory_pool().
+    Default,
+    /// The system allocator.
+    System,
+    /// Arrow's jemalloc pool, if arrow was built with it and the system uses 4KiB pages.
+    Jemalloc,
+    /// Arrow's mimalloc pool, if arrow was built with it.
+    Mimalloc,
+    /// default_memory_pool(), with large allocations mapped separately and backed by transparent
+    /// huge pages, see HugePageMemoryPool. Linux only.
+    HugePages,
+};
+
+/// \brief Find the memory pool allocating with [backend].
+/// \returns The pool, which lives until the process exits, or an error if [backend] isn't
+///          available on this system or in this build.
+POD5_FORMAT_EXPORT Result<arrow::MemoryPool *> memory_pool_for_backend(MemoryPoolBackend backend);
+
+/// \brief A memory pool mapping large allocations, like decoded signal and IPC batch bodies,
+///        directly from the OS and asking for them to be backed by transparent huge pages, so
+///        touching them takes fewer page faults and TLB misses. Smaller allocations are passed to
+///        the wrapped pool.
+/// \note Only available on Linux, elsewhere every allocation is passed to the wrapped pool.
+class POD5_FORMAT_EXPORT HugePageMemoryPool : public arrow::ProxyMemoryPool {
+public:
+    /// Allocations this size or larger are mapped as huge pages, in multiples of this size.
+    static constexpr std::int64_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+    /// \param pool The pool to allocate small allocations from, which must outlive this pool.
+    explicit HugePageMemoryPool(arrow::MemoryPool * pool);
+
+    using arrow::MemoryPool::Allocate;
+    using arrow::MemoryPool::Free;
+    using arrow::MemoryPool::Reallocate;
+
+    arrow::Status Allocate(std::int64_t size, std::int64_t alignment, std::uint8_t ** out) override;
+    arrow::Status Reallocate(
+        std::int64_t old_size,
+        std::int64_t new_size,
+        std::int64_t alignment,
+        std::uint8_t ** ptr) override;
+    void Free(std::uint8_t * buffer, std::int64_t size, std::int64_t alignment) override;
+
+    /// Find the bytes allocated, including those mapped as huge pages.
+    std::int64_t bytes_allocated() const override;
+    std::string backend_name() const override;
+
+    /// Find the bytes currently mapped as huge pages.
+    std::int64_t huge_page_bytes() const { return m_huge_page_bytes; }
+
+private:
+    std::atomic<std::int64_t> m_huge_page_bytes{0};
+};
+
+/// \brief A memory pool keeping freed allocations to hand out again, rather than returning them to
+///        the pool it wraps.
+///
+/// Writers allocate the same builder buffers for every batch, and a batch's buffers are freed once
+/// its write completes, so the next batch can reuse them without the allocator's help.
+class POD5_FORMAT_EXPORT RecyclingMemoryPool : public arrow::ProxyMemoryPool {
+public:
+    /// Allocations smaller than this are passed straight to the wrapped pool.
+    static constexpr std::int64_t MIN_RECYCLED_BYTES = 4096;
+
+    /// \param pool The pool to allocate from, which must outlive this pool.
+    /// \param max_cached_bytes The most freed bytes to keep for reuse, beyond which freed memory
+    ///                         is returned to [pool].
+    RecyclingMemoryPool(arrow::MemoryPool * pool, std::size_t max_cached_bytes);
+    ~RecyclingMemoryPool() override;
+
+    using arrow::MemoryPool::Allocate;
+    using arrow::MemoryPool::Free;
+    using arrow::MemoryPool::Reallocate;
+
+    arrow::Status Allocate(std::int64_t size, std::int64_t alignment, std::uint8_t ** out) override;
+    arrow::Status Reallocate(
+        std::int64_t old_size,
+        std::int64_t new_size,
+        std::int64_t alignment,
+        std::uint8_t ** ptr) override;
+    void Free(std::uint8_t * buffer, std::int64_t size, std::int64_t alignment) override;
+
+    /// Return every cached allocation to the wrapped pool.
+    void ReleaseUnused() override;
+
+    /// Find the bytes held for reuse.
+    std::size_t cached_bytes() const;
+    /// Find how many allocations were served from memory freed earlier.
+    std::size_t recycled_allocations() const;
+
+private:
+    struct CachedAllocation {
+        std::uint8_t * data;
+        std::int64_t alignment;
+    };
+
+    /// \brief Find a cached allocation of at least [size] bytes, not much larger.
+    /// \returns The allocation's data, or null if none fits.
+    std::uint8_t * take_cached(std::int64_t size, std::int64_t alignment);
+
+    std::size_t const m_max_cached_bytes;
+
+    mutable std::mutex m_mutex;
+    // Freed allocations waiting to be reused, keyed by capacity:
+    std::multimap<std::int64_t, CachedAllocation> m_cache;
+    std::size_t m_cached_bytes;
+    // The capacity of each allocation handed out which may be cached once freed:
+    std::unordered_map<std::uint8_t *, std::int64_t> m_capacities;
+    std::size_t m_recycled_allocations;
+};
+
+/// \brief Counts of the memory allocated through a TrackingMemoryPool.
+struct MemoryPoolStatistics {
+    std::int64_t bytes_allocated = 0;
+    std::int64_t peak_bytes_allocated = 0;
+    std::uint64_t allocation_count = 0;
+    /// Allocations refused for taking the pool over its limit.
+    std::uint64_t failed_allocations = 0;
+    /// The pool's limit in bytes, 0 if it is unlimited.
+    std::int64_t max_bytes = 0;
+};
+
+/// \brief A memory pool counting the memory allocated through it, optionally refusing
+///        allocations beyond a limit so callers see an error rather than the process growing.
+class POD5_FORMAT_EXPORT TrackingMemoryPool : public arrow::ProxyMemoryPool {
+public:
+    /// \param pool The pool to allocate from, which must outlive this pool.
+    /// \param name The name of the pool, given in errors for allocations refused.
+    /// \param max_bytes The most bytes allocated through this pool at once, 0 for no limit.
+    TrackingMemoryPool(arrow::MemoryPool * pool, std::string name, std::int64_t max_bytes = 0);
+
+    using arrow::MemoryPool::Allocate;
+    using arrow::MemoryPool::Free;
+    using arrow::MemoryPool::Reallocate;
+
+    arrow::Status Allocate(std::int64_t size, std::int64_t alignment, std::uint8_t ** out) override;
+    arrow::Status Reallocate(
+        std::int64_t old_size,
+        std::int64_t new_size,
+        std::int64_t alignment,
+        std::uint8_t ** ptr) override;
+    void Free(std::uint8_t * buffer, std::int64_t size, std::int64_t alignment) override;
+
+    std::string const & name() const { return m_name; }
+
+    /// \brief Set the most bytes allocated through this pool at once, 0 for no limit.
+    /// \note Memory already allocated is kept when lowering the limit, only later allocations are
+    ///       refused.
+    void set_max_bytes(std::int64_t max_bytes) { m_max_bytes = max_bytes; }
+
+    MemoryPoolStatistics statistics() const;
+
+private:
+    /// \brief Count [bytes] more allocated, unless that takes the pool over its limit.
+    arrow::Status reserve(std::int64_t bytes);
+
+    std::string const m_name;
+    std::atomic<std::int64_t> m_max_bytes;
+    std::atomic<std::int64_t> m_bytes_allocated{0};
+    std::atomic<std::int64_t> m_peak_bytes_allocated{0};
+    std::atomic<std::uint64_t> m_allocation_count{0};
+    std::atomic<std::uint64_t> m_failed_allocations{0};
+};
+
+/// \brief The parts of pod5 whose allocations from the default memory pool are counted separately,
+///        so memory use can be attributed to them.
+enum class MemorySubsystem : std::uint8_t {
+    /// Signal table batches read by file readers, held in their caches.
+    SignalCache,
+    /// Read table batches read by file readers.
+    ReadTableDecode,
+    /// Table builders of file writers, and the batches they write.
+    WriterBuilders,
+    /// Signal compressed in bulk by file writers.
+    CompressionScratch,
+    /// Batches copied by the repacker.
+    Repacker,
+};
+
+static constexpr std::size_t MEMORY_SUBSYSTEM_COUNT = 5;
+
+POD5_FORMAT_EXPORT char const * memory_subsystem_name(MemorySubsystem subsystem);
+
+/// \brief Find the pool counting [subsystem]'s allocations, which allocates from
+///        default_memory_pool().
+/// \note The pools live until the process exits, as buffers allocated from them can outlive the
+///       readers and writers which allocated them.
+POD5_FORMAT_EXPORT TrackingMemoryPool & subsystem_memory_pool(MemorySubsystem subsystem);
+
+/// \brief Find the pool [subsystem] should allocate from when configured to use [pool]: its
+///        counting pool if [pool] is default_memory_pool(), otherwise [pool] itself.
+POD5_FORMAT_EXPORT arrow::MemoryPool * tagged_memory_pool(
+    MemorySubsystem subsystem,
+    arrow::MemoryPool * pool);
+
 }  // namespace pod5
@@ -1,5 +1,9 @@
 #include "pod5_format/migration/migration.h"
 
+#include "pod5_format/migration/migration_utils.h"
+
+#include <arrow/io/file.h>
+
 #include <random>
 
 namespace pod5 {
@@ -26,4 +30,85 @@ Result<std::unique_ptr<TemporaryDir>> MakeTmpDir(char const * suffix)
     return arrow::Status::Invalid("Failed to make temporary directory");
 }
 
+arrow::Result<combined_file_utils::ParsedFileInfo> write_migrated_table(
+    TemporaryDir & dir,
+    char const * name,
+    std::shared_ptr<arrow::Schema> const & schema,
+    std::size_t batch_count,
+    std::function<Result<std::shared_ptr<arrow::RecordBatch>>(std::size_t)> const & read_batch,
+    arrow::MemoryPool * pool)
+{
+    ARROW_ASSIGN_OR_RAISE(auto table_path, dir.path().Join(name));
+    {
+        ARROW_ASSIGN_OR_RAISE(
+            auto writer,
+            make_record_batch_writer(pool, table_path.ToString(), schema, schema->metadata()));
+        for (std::size_t batch_idx = 0; batch_idx < batch_count; ++batch_idx) {
+            ARROW_ASSIGN_OR_RAISE(auto batch, read_batch(batch_idx));
+            ARROW_RETURN_NOT_OK(writer.writer->WriteRecordBatch(*batch));
+        }
+        ARROW_RETURN_NOT_OK(writer.writer->Close());
+    }
+
+    combined_file_utils::ParsedFileInfo result;
+    ARROW_RETURN_NOT_OK(result.from_full_file(table_path.ToString()));
+    return result;
+}
+
+arrow::Result<combined_file_utils::ParsedFileInfo> write_migrated_table(
+    TemporaryDir & dir,
+    char const * name,
+    std::shared_ptr<arrow::Buffer> const & data)
+{
+    ARROW_ASSIGN_OR_RAISE(auto table_path, dir.path().Join(name));
+    {
+        ARROW_ASSIGN_OR_RAISE(
+            auto file, arrow::io::FileOutputStream::Open(table_path.ToString(), false));
+        ARROW_RETURN_NOT_OK(file->Write(data));
+        ARROW_RETURN_NOT_OK(file->Close());
+    }
+
+    combined_file_utils::ParsedFileInfo result;
+    ARROW_RETURN_NOT_OK(result.from_full_file(table_path.ToString()));
+    return result;
+}
+
+arrow::Result<MigrationResult> migrate_if_required(
+    Version writer_version,
+    combined_file_utils::ParsedFooter const & read_footer,
+    std::shared_ptr<arrow::io::RandomAccessFile> const & source,
+    arrow::MemoryPool * pool)
+{
+    MigrationResult result{read_footer};
+    if (!is_migration_required(writer_version)) {
+        return result;
+    }
+
+    // Each migration is made for the schema the one before it migrates to:
+    ARROW_ASSIGN_OR_RAISE(
+        auto reads_reader, open_record_batch_reader(pool, read_footer.reads_table));
+    auto schema = reads_reader.schema;
+
+    if (writer_version < Version(0, 0, 24)) {
+        // Added fields for read scaling
+        ARROW_ASSIGN_OR_RAISE(auto migration, make_v0_to_v1_migration(schema, pool));
+        schema = migration->schema();
+        result.add_read_table_migration(std::move(migration));
+    }
+
+    if (writer_version < Version(0, 0, 32)) {
+        // Added num samples field
+        ARROW_ASSIGN_OR_RAISE(
+            auto migration, make_v1_to_v2_migration(schema, read_footer.signal_table, pool));
+        schema = migration->schema();
+        result.add_read_table_migration(std::move(migration));
+    }
+
+    // Flattening fields
+    ARROW_ASSIGN_OR_RAISE(auto migration, make_v2_to_v3_migration(schema, pool));
+    result.add_read_table_migration(std::move(migration));
+    result.set_run_info_table_from_read_table();
+    return result;
+}
+
 }  // namespace pod5
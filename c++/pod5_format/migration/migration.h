@@ -3,9 +3,12 @@
 #include "pod5_format/internal/combined_file_utils.h"
 #include "pod5_format/result.h"
 #include "pod5_format/schema_utils.h"
+#include "pod5_format/table_reader.h"
 
 #include <arrow/util/io_util.h>
 
+#include <functional>
+
 namespace pod5 {
 
 class TemporaryDir {
@@ -22,6 +25,10 @@ private:
 
 Result<std::unique_ptr<TemporaryDir>> MakeTmpDir(char const * suffix);
 
+/// \brief How to read a file written by an older version of the format as the current version.
+///
+/// Nothing is rewritten on open: read table batches are migrated one at a time as they're read,
+/// and a run info table missing from older files is built in memory when first used.
 class MigrationResult {
 public:
     MigrationResult(combined_file_utils::ParsedFooter const & footer) : m_footer(footer) {}
@@ -35,49 +42,80 @@ public:
 
     combined_file_utils::ParsedFooter const & footer() const { return m_footer; }
 
-    void add_temp_dir(std::unique_ptr<TemporaryDir> && temp_dir)
+    /// \brief Find the migrations applied to each read table batch, in order.
+    TableBatchMigrations const & read_table_migrations() const { return m_read_table_migrations; }
+
+    void add_read_table_migration(std::shared_ptr<TableBatchMigration const> && migration)
     {
-        m_temp_dirs.emplace_back(std::move(temp_dir));
+        m_read_table_migrations.emplace_back(std::move(migration));
+    }
+
+    /// \brief Find if the run info table is built from the read table's run info dictionary, as
+    ///        files before v3 kept their run infos there.
+    bool run_info_table_from_read_table() const { return m_run_info_table_from_read_table; }
+
+    void set_run_info_table_from_read_table() { m_run_info_table_from_read_table = true; }
+
+    /// \brief Find if any table is read differently to how it is stored.
+    bool is_migrated() const
+    {
+        return !m_read_table_migrations.empty() || m_run_info_table_from_read_table;
     }
 
 private:
     combined_file_utils::ParsedFooter m_footer;
-    std::vector<std::unique_ptr<TemporaryDir>> m_temp_dirs;
+    TableBatchMigrations m_read_table_migrations;
+    bool m_run_info_table_from_read_table = false;
 };
 
-arrow::Result<MigrationResult> migrate_v0_to_v1(
-    MigrationResult && v0_input,
+/// Added fields for read scaling.
+arrow::Result<std::shared_ptr<TableBatchMigration const>> make_v0_to_v1_migration(
+    std::shared_ptr<arrow::Schema> const & v0_schema,
     arrow::MemoryPool * pool);
-arrow::Result<MigrationResult> migrate_v1_to_v2(
-    MigrationResult && v1_input,
+/// Added num samples field, counted from [signal_table].
+arrow::Result<std::shared_ptr<TableBatchMigration const>> make_v1_to_v2_migration(
+    std::shared_ptr<arrow::Schema> const & v1_schema,
+    combined_file_utils::ParsedFileInfo const & signal_table,
     arrow::MemoryPool * pool);
-arrow::Result<MigrationResult> migrate_v2_to_v3(
-    MigrationResult && v2_input,
+/// Flattening fields.
+arrow::Result<std::shared_ptr<TableBatchMigration const>> make_v2_to_v3_migration(
+    std::shared_ptr<arrow::Schema> const & v2_schema,
     arrow::MemoryPool * pool);
 
-inline arrow::Result<MigrationResult> migrate_if_required(
-    Version writer_version,
-    combined_file_utils::ParsedFooter const & read_footer,
-    std::shared_ptr<arrow::io::RandomAccessFile> const & source,
-    arrow::MemoryPool * pool)
-{
-    MigrationResult result{read_footer};
+/// \brief Build a v3 run info table from the run info dictionary of an older [reads_table], as an
+///        ipc file in memory.
+arrow::Result<std::shared_ptr<arrow::Buffer>> make_v3_run_info_table(
+    combined_file_utils::ParsedFileInfo const & reads_table,
+    arrow::MemoryPool * pool);
 
-    if (writer_version < Version(0, 0, 24)) {
-        // Added fields for read scaling
-        ARROW_ASSIGN_OR_RAISE(result, migrate_v0_to_v1(std::move(result), pool));
-    }
+/// \brief Write [batch_count] batches of a migrated table, found by [read_batch], to a file
+///        [name] in [dir], for users needing the migrated table as a file.
+arrow::Result<combined_file_utils::ParsedFileInfo> write_migrated_table(
+    TemporaryDir & dir,
+    char const * name,
+    std::shared_ptr<arrow::Schema> const & schema,
+    std::size_t batch_count,
+    std::function<Result<std::shared_ptr<arrow::RecordBatch>>(std::size_t)> const & read_batch,
+    arrow::MemoryPool * pool);
 
-    if (writer_version < Version(0, 0, 32)) {
-        // Added num samples field
-        ARROW_ASSIGN_OR_RAISE(result, migrate_v1_to_v2(std::move(result), pool));
-    }
+/// \brief Write a table held as an ipc file in [data] to a file [name] in [dir].
+arrow::Result<combined_file_utils::ParsedFileInfo> write_migrated_table(
+    TemporaryDir & dir,
+    char const * name,
+    std::shared_ptr<arrow::Buffer> const & data);
 
-    if (writer_version < Version(0, 0, 38)) {
-        // Flattening fields
-        ARROW_ASSIGN_OR_RAISE(result, migrate_v2_to_v3(std::move(result), pool));
-    }
-    return result;
+/// \brief Find if a file written by [writer_version] is read through migrations.
+inline bool is_migration_required(Version writer_version)
+{
+    return writer_version < Version(0, 0, 38);
 }
 
+/// \brief Find how to read a file written by [writer_version] as the current version.
+/// \note Only the read table's schema is read, batches are migrated as they're read.
+arrow::Result<MigrationResult> migrate_if_required(
+    Version writer_version,
+    combined_file_utils::ParsedFooter const & read_footer,
+    std::shared_ptr<arrow::io::RandomAccessFile> const & source,
+    arrow::MemoryPool * pool);
+
 }  // namespace pod5
@@ -8,97 +8,99 @@
 
 namespace pod5 {
 
-arrow::Result<MigrationResult> migrate_v0_to_v1(
-    MigrationResult && v0_input,
-    arrow::MemoryPool * pool)
-{
-    ARROW_ASSIGN_OR_RAISE(auto temp_dir, MakeTmpDir("pod5_v0_v1_migration"));
-    ARROW_ASSIGN_OR_RAISE(auto v1_reads_table_path, temp_dir->path().Join("reads_table.arrow"));
+namespace {
 
+class V0ToV1Migration : public TableBatchMigration {
+public:
+    V0ToV1Migration(
+        std::shared_ptr<arrow::Schema> const & v0_schema,
+        std::shared_ptr<arrow::Schema> && v1_schema,
+        arrow::MemoryPool * pool)
+    : m_v0_schema(v0_schema)
+    , m_v1_schema(std::move(v1_schema))
+    , m_pool(pool)
     {
-        ARROW_ASSIGN_OR_RAISE(
-            auto v0_reader, open_record_batch_reader(pool, v0_input.footer().reads_table));
+    }
 
-        auto v1_new_schama = arrow::schema(
-            {arrow::field("num_minknow_events", arrow::uint64()),
-             arrow::field("tracked_scaling_scale", arrow::float32()),
-             arrow::field("tracked_scaling_shift", arrow::float32()),
-             arrow::field("predicted_scaling_scale", arrow::float32()),
-             arrow::field("predicted_scaling_shift", arrow::float32()),
-             arrow::field("num_reads_since_mux_change", arrow::uint32()),
-             arrow::field("time_since_mux_change", arrow::float32())});
+    std::shared_ptr<arrow::Schema> const & schema() const override { return m_v1_schema; }
 
-        ARROW_ASSIGN_OR_RAISE(
-            auto v1_schema, arrow::UnifySchemas({v0_reader.schema, v1_new_schama}));
+    Result<std::shared_ptr<arrow::RecordBatch>> migrate(
+        std::shared_ptr<arrow::RecordBatch> const & v0_batch) const override
+    {
+        auto const num_rows = v0_batch->num_rows();
 
-        ARROW_ASSIGN_OR_RAISE(
-            auto new_metadata, update_metadata(v0_reader.metadata, Version(0, 0, 24)));
-        ARROW_ASSIGN_OR_RAISE(
-            auto v1_writer,
-            make_record_batch_writer(
-                pool, v1_reads_table_path.ToString(), v1_schema, new_metadata));
+        // Extend with V1 data:
+        std::vector<std::shared_ptr<arrow::Array>> columns = v0_batch->columns();
+        ARROW_RETURN_NOT_OK(check_columns(m_v0_schema, columns));
+        ARROW_RETURN_NOT_OK(set_column(
+            m_v1_schema,
+            columns,
+            "num_minknow_events",
+            make_filled_array<arrow::UInt64Builder>(m_pool, num_rows, 0)));
+        ARROW_RETURN_NOT_OK(set_column(
+            m_v1_schema,
+            columns,
+            "tracked_scaling_scale",
+            make_filled_array<arrow::FloatBuilder>(
+                m_pool, num_rows, std::numeric_limits<float>::quiet_NaN())));
+        ARROW_RETURN_NOT_OK(set_column(
+            m_v1_schema,
+            columns,
+            "tracked_scaling_shift",
+            make_filled_array<arrow::FloatBuilder>(
+                m_pool, num_rows, std::numeric_limits<float>::quiet_NaN())));
+        ARROW_RETURN_NOT_OK(set_column(
+            m_v1_schema,
+            columns,
+            "predicted_scaling_scale",
+            make_filled_array<arrow::FloatBuilder>(
+                m_pool, num_rows, std::numeric_limits<float>::quiet_NaN())));
+        ARROW_RETURN_NOT_OK(set_column(
+            m_v1_schema,
+            columns,
+            "predicted_scaling_shift",
+            make_filled_array<arrow::FloatBuilder>(
+                m_pool, num_rows, std::numeric_limits<float>::quiet_NaN())));
+        ARROW_RETURN_NOT_OK(set_column(
+            m_v1_schema,
+            columns,
+            "num_reads_since_mux_change",
+            make_filled_array<arrow::UInt32Builder>(m_pool, num_rows, 0)));
+        ARROW_RETURN_NOT_OK(set_column(
+            m_v1_schema,
+            columns,
+            "time_since_mux_change",
+            make_filled_array<arrow::FloatBuilder>(m_pool, num_rows, 0.0f)));
+        return arrow::RecordBatch::Make(m_v1_schema, num_rows, std::move(columns));
+    }
 
-        for (std::int64_t batch_idx = 0; batch_idx < v0_reader.reader->num_record_batches();
-             ++batch_idx)
-        {
-            // Read V0 data:
-            ARROW_ASSIGN_OR_RAISE(auto v0_batch, v0_reader.reader->ReadRecordBatch(batch_idx));
-            auto const num_rows = v0_batch->num_rows();
+private:
+    std::shared_ptr<arrow::Schema> m_v0_schema;
+    std::shared_ptr<arrow::Schema> m_v1_schema;
+    arrow::MemoryPool * m_pool;
+};
 
-            // Extend with V1 data:
-            std::vector<std::shared_ptr<arrow::Array>> columns = v0_batch->columns();
-            ARROW_RETURN_NOT_OK(check_columns(v0_reader.schema, columns));
-            ARROW_RETURN_NOT_OK(set_column(
-                v1_schema,
-                columns,
-                "num_minknow_events",
-                make_filled_array<arrow::UInt64Builder>(pool, num_rows, 0)));
-            ARROW_RETURN_NOT_OK(set_column(
-                v1_schema,
-                columns,
-                "tracked_scaling_scale",
-                make_filled_array<arrow::FloatBuilder>(
-                    pool, num_rows, std::numeric_limits<float>::quiet_NaN())));
-            ARROW_RETURN_NOT_OK(set_column(
-                v1_schema,
-                columns,
-                "tracked_scaling_shift",
-                make_filled_array<arrow::FloatBuilder>(
-                    pool, num_rows, std::numeric_limits<float>::quiet_NaN())));
-            ARROW_RETURN_NOT_OK(set_column(
-                v1_schema,
-                columns,
-                "predicted_scaling_scale",
-                make_filled_array<arrow::FloatBuilder>(
-                    pool, num_rows, std::numeric_limits<float>::quiet_NaN())));
-            ARROW_RETURN_NOT_OK(set_column(
-                v1_schema,
-                columns,
-                "predicted_scaling_shift",
-                make_filled_array<arrow::FloatBuilder>(
-                    pool, num_rows, std::numeric_limits<float>::quiet_NaN())));
-            ARROW_RETURN_NOT_OK(set_column(
-                v1_schema,
-                columns,
-                "num_reads_since_mux_change",
-                make_filled_array<arrow::UInt32Builder>(pool, num_rows, 0)));
-            ARROW_RETURN_NOT_OK(set_column(
-                v1_schema,
-                columns,
-                "time_since_mux_change",
-                make_filled_array<arrow::FloatBuilder>(pool, num_rows, 0.0f)));
-            ARROW_RETURN_NOT_OK(v1_writer.write_batch(num_rows, std::move(columns)));
-        }
+}  // namespace
 
-        ARROW_RETURN_NOT_OK(v1_writer.writer->Close());
-    }
+arrow::Result<std::shared_ptr<TableBatchMigration const>> make_v0_to_v1_migration(
+    std::shared_ptr<arrow::Schema> const & v0_schema,
+    arrow::MemoryPool * pool)
+{
+    auto v1_new_schama = arrow::schema(
+        {arrow::field("num_minknow_events", arrow::uint64()),
+         arrow::field("tracked_scaling_scale", arrow::float32()),
+         arrow::field("tracked_scaling_shift", arrow::float32()),
+         arrow::field("predicted_scaling_scale", arrow::float32()),
+         arrow::field("predicted_scaling_shift", arrow::float32()),
+         arrow::field("num_reads_since_mux_change", arrow::uint32()),
+         arrow::field("time_since_mux_change", arrow::float32())});
 
-    // Set up migrated data to point at our new table:
-    MigrationResult result = std::move(v0_input);
-    ARROW_RETURN_NOT_OK(result.footer().reads_table.from_full_file(v1_reads_table_path.ToString()));
-    result.add_temp_dir(std::move(temp_dir));
+    ARROW_ASSIGN_OR_RAISE(auto v1_schema, arrow::UnifySchemas({v0_schema, v1_new_schama}));
+    ARROW_ASSIGN_OR_RAISE(
+        auto new_metadata, update_metadata(v0_schema->metadata(), Version(0, 0, 24)));
 
-    return result;
+    return std::make_shared<V0ToV1Migration const>(
+        v0_schema, v1_schema->WithMetadata(new_metadata), pool);
 }
 
 }  // namespace pod5
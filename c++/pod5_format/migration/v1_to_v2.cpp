@@ -7,19 +7,28 @@
 #include <arrow/util/io_util.h>
 
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
 
 namespace pod5 {
 
+namespace {
+
+/// Finds the samples column of signal batch [batch_idx].
+using FindSamplesColumn =
+    std::function<arrow::Result<std::shared_ptr<arrow::UInt32Array>>(std::size_t batch_idx)>;
+
 arrow::Result<std::size_t> get_num_samples(
     std::shared_ptr<arrow::ListArray> const & signal_col,
     std::size_t row_idx,
-    std::vector<std::shared_ptr<arrow::RecordBatch>> const & signal_batches)
+    std::size_t signal_batch_size,
+    std::size_t signal_batch_count,
+    FindSamplesColumn const & find_samples_column)
 {
-    if (signal_batches.empty()) {
+    if (signal_batch_count == 0) {
         return 0;
     }
 
-    std::size_t signal_batch_size = signal_batches[0]->num_rows();
     std::size_t num_samples = 0;
 
     auto values = std::dynamic_pointer_cast<arrow::UInt64Array>(signal_col->values());
@@ -39,18 +48,12 @@ arrow::Result<std::size_t> get_num_samples(
         auto const batch_idx = abs_row / signal_batch_size;
         auto const batch_row = abs_row - (batch_idx * signal_batch_size);
 
-        if (batch_idx >= signal_batches.size()) {
+        if (batch_idx >= signal_batch_count) {
             return arrow::Status::Invalid(
                 "Invalid signal row ", abs_row, ", cannot find signal batch ", batch_idx);
         }
 
-        auto batch = signal_batches[batch_idx];
-
-        auto samples_column =
-            std::dynamic_pointer_cast<arrow::UInt32Array>(batch->GetColumnByName("samples"));
-        if (!samples_column) {
-            return arrow::Status::Invalid("`samples` column is missing from file");
-        }
+        ARROW_ASSIGN_OR_RAISE(auto samples_column, find_samples_column(batch_idx));
         if (batch_row >= (std::size_t)samples_column->length()) {
             return arrow::Status::Invalid(
                 "Invalid signal batch row ", batch_row, ", length is ", samples_column->length());
@@ -61,73 +64,133 @@ arrow::Result<std::size_t> get_num_samples(
     return num_samples;
 }
 
-arrow::Result<MigrationResult> migrate_v1_to_v2(
-    MigrationResult && v1_input,
-    arrow::MemoryPool * pool)
-{
-    ARROW_ASSIGN_OR_RAISE(auto temp_dir, MakeTmpDir("pod5_v1_v2_migration"));
-    ARROW_ASSIGN_OR_RAISE(auto v2_reads_table_path, temp_dir->path().Join("reads_table.arrow"));
+class V1ToV2Migration : public TableBatchMigration {
+public:
+    V1ToV2Migration(
+        std::shared_ptr<arrow::Schema> && v2_schema,
+        combined_file_utils::ParsedFileInfo const & signal_table,
+        arrow::MemoryPool * pool)
+    : m_v2_schema(std::move(v2_schema))
+    , m_signal_table(signal_table)
+    , m_pool(pool)
+    {
+    }
 
+    std::shared_ptr<arrow::Schema> const & schema() const override { return m_v2_schema; }
+
+    Result<std::shared_ptr<arrow::RecordBatch>> migrate(
+        std::shared_ptr<arrow::RecordBatch> const & v1_batch) const override
     {
-        ARROW_ASSIGN_OR_RAISE(
-            auto v1_reader, open_record_batch_reader(pool, v1_input.footer().reads_table));
-        ARROW_ASSIGN_OR_RAISE(
-            auto v1_signal_reader, open_record_batch_reader(pool, v1_input.footer().signal_table));
-        std::vector<std::shared_ptr<arrow::RecordBatch>> signal_batches(
-            v1_signal_reader.reader->num_record_batches());
-        for (std::size_t batch_idx = 0;
-             batch_idx < (std::size_t)v1_signal_reader.reader->num_record_batches();
-             ++batch_idx)
-        {
+        auto const num_rows = v1_batch->num_rows();
+
+        // Extend with V2 data:
+        std::vector<std::shared_ptr<arrow::Array>> columns = v1_batch->columns();
+
+        auto signal_column =
+            std::dynamic_pointer_cast<arrow::ListArray>(v1_batch->GetColumnByName("signal"));
+        if (!signal_column) {
+            return arrow::Status::Invalid("`signal` column is missing from file");
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto const signal_batch_count, open_signal_table());
+
+        // Only the signal batches this batch's reads use are loaded:
+        std::unordered_map<std::size_t, std::shared_ptr<arrow::UInt32Array>> samples_columns;
+        auto const find_samples_column = [&](std::size_t batch_idx)
+            -> arrow::Result<std::shared_ptr<arrow::UInt32Array>> {
+            auto & samples_column = samples_columns[batch_idx];
+            if (!samples_column) {
+                ARROW_ASSIGN_OR_RAISE(samples_column, read_samples_column(batch_idx));
+            }
+            return samples_column;
+        };
+
+        arrow::UInt64Builder num_samples_builder(m_pool);
+        for (std::int64_t row = 0; row < num_rows; ++row) {
             ARROW_ASSIGN_OR_RAISE(
-                signal_batches[batch_idx], v1_signal_reader.reader->ReadRecordBatch(batch_idx));
+                auto num_samples,
+                get_num_samples(
+                    signal_column,
+                    row,
+                    m_signal_batch_size,
+                    signal_batch_count,
+                    find_samples_column));
+            ARROW_RETURN_NOT_OK(num_samples_builder.Append(num_samples));
         }
+        ARROW_RETURN_NOT_OK(
+            set_column(m_v2_schema, columns, "num_samples", num_samples_builder.Finish()));
+        return arrow::RecordBatch::Make(m_v2_schema, num_rows, std::move(columns));
+    }
 
-        auto v2_new_schama = arrow::schema({arrow::field("num_samples", arrow::uint64())});
-        ARROW_ASSIGN_OR_RAISE(
-            auto new_metadata, update_metadata(v1_reader.metadata, Version(0, 0, 32)));
+private:
+    /// Open the signal table if no batch has yet, finding its batch count.
+    arrow::Result<std::size_t> open_signal_table() const
+    {
+        // Migrations are shared by a table's reader and its projections, and run concurrently:
+        std::lock_guard<std::mutex> l(m_signal_mutex);
+        if (m_signal_reader) {
+            return m_signal_reader->num_record_batches();
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto file, open_sub_file(m_signal_table));
+        arrow::ipc::IpcReadOptions read_options;
+        read_options.memory_pool = m_pool;
         ARROW_ASSIGN_OR_RAISE(
-            auto v2_schema, arrow::UnifySchemas({v1_reader.schema, v2_new_schama}));
+            auto reader, arrow::ipc::RecordBatchFileReader::Open(file, read_options));
+
+        // Only sample counts are needed, so signal data isn't read:
+        auto const samples_field = reader->schema()->GetFieldIndex("samples");
+        if (samples_field < 0) {
+            return arrow::Status::Invalid("`samples` column is missing from file");
+        }
+        read_options.included_fields = {samples_field};
         ARROW_ASSIGN_OR_RAISE(
-            auto v2_writer,
-            make_record_batch_writer(
-                pool, v2_reads_table_path.ToString(), v2_schema, new_metadata));
-
-        for (std::int64_t batch_idx = 0; batch_idx < v1_reader.reader->num_record_batches();
-             ++batch_idx)
-        {
-            // Read V1 data:
-            ARROW_ASSIGN_OR_RAISE(auto v1_batch, v1_reader.reader->ReadRecordBatch(batch_idx));
-            auto const num_rows = v1_batch->num_rows();
-
-            // Extend with V2 data:
-            std::vector<std::shared_ptr<arrow::Array>> columns = v1_batch->columns();
-
-            auto signal_column =
-                std::dynamic_pointer_cast<arrow::ListArray>(v1_batch->GetColumnByName("signal"));
-            if (!signal_column) {
-                return arrow::Status::Invalid("`signal` column is missing from file");
-            }
-            arrow::UInt64Builder num_samples_builder;
-            for (std::int64_t row = 0; row < num_rows; ++row) {
-                ARROW_ASSIGN_OR_RAISE(
-                    auto num_samples, get_num_samples(signal_column, row, signal_batches));
-                ARROW_RETURN_NOT_OK(num_samples_builder.Append(num_samples));
-            }
-            ARROW_RETURN_NOT_OK(
-                set_column(v2_schema, columns, "num_samples", num_samples_builder.Finish()));
-            ARROW_RETURN_NOT_OK(v2_writer.write_batch(num_rows, std::move(columns)));
+            m_signal_reader, arrow::ipc::RecordBatchFileReader::Open(file, read_options));
+
+        if (m_signal_reader->num_record_batches() > 0) {
+            ARROW_ASSIGN_OR_RAISE(auto first_batch, m_signal_reader->ReadRecordBatch(0));
+            m_signal_batch_size = first_batch->num_rows();
         }
+        return m_signal_reader->num_record_batches();
+    }
 
-        ARROW_RETURN_NOT_OK(v2_writer.writer->Close());
+    arrow::Result<std::shared_ptr<arrow::UInt32Array>> read_samples_column(
+        std::size_t batch_idx) const
+    {
+        std::lock_guard<std::mutex> l(m_signal_mutex);
+        ARROW_ASSIGN_OR_RAISE(auto batch, m_signal_reader->ReadRecordBatch(batch_idx));
+        auto samples_column =
+            std::dynamic_pointer_cast<arrow::UInt32Array>(batch->GetColumnByName("samples"));
+        if (!samples_column) {
+            return arrow::Status::Invalid("`samples` column is missing from file");
+        }
+        return samples_column;
     }
 
-    // Set up migrated data to point at our new table:
-    MigrationResult result = std::move(v1_input);
-    ARROW_RETURN_NOT_OK(result.footer().reads_table.from_full_file(v2_reads_table_path.ToString()));
-    result.add_temp_dir(std::move(temp_dir));
+    std::shared_ptr<arrow::Schema> m_v2_schema;
+    combined_file_utils::ParsedFileInfo m_signal_table;
+    arrow::MemoryPool * m_pool;
+
+    mutable std::mutex m_signal_mutex;
+    // Opened by the first batch migrated:
+    mutable std::shared_ptr<arrow::ipc::RecordBatchFileReader> m_signal_reader;
+    mutable std::size_t m_signal_batch_size = 0;
+};
+
+}  // namespace
+
+arrow::Result<std::shared_ptr<TableBatchMigration const>> make_v1_to_v2_migration(
+    std::shared_ptr<arrow::Schema> const & v1_schema,
+    combined_file_utils::ParsedFileInfo const & signal_table,
+    arrow::MemoryPool * pool)
+{
+    auto v2_new_schama = arrow::schema({arrow::field("num_samples", arrow::uint64())});
+    ARROW_ASSIGN_OR_RAISE(
+        auto new_metadata, update_metadata(v1_schema->metadata(), Version(0, 0, 32)));
+    ARROW_ASSIGN_OR_RAISE(auto v2_schema, arrow::UnifySchemas({v1_schema, v2_new_schama}));
 
-    return result;
+    return std::make_shared<V1ToV2Migration const>(
+        v2_schema->WithMetadata(new_metadata), signal_table, pool);
 }
 
 }  // namespace pod5
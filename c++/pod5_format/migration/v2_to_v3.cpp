@@ -4,6 +4,7 @@
 
 #include <arrow/array/builder_binary.h>
 #include <arrow/array/builder_primitive.h>
+#include <arrow/io/memory.h>
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 #include <arrow/util/io_util.h>
@@ -82,6 +83,32 @@ append_struct_row(StructRow const & struct_row, char const * field_name, Builder
     return builder.Append(typed_field_array->Value(struct_row.dict_item_index));
 }
 
+// Add every string [field_name] of the dictionary [struct_row] indexes to [builder], in dictionary
+// order. Dictionaries only grow across a file's batches, so each batch's migrated dictionary
+// extends the one before, as the ipc file format needs.
+arrow::Status add_struct_dict_items(
+    StructRow const & struct_row,
+    char const * field_name,
+    StringDictBuilder & builder)
+{
+    auto typed_field_array =
+        std::dynamic_pointer_cast<arrow::StringArray>(struct_row.data->GetFieldByName(field_name));
+    if (!typed_field_array) {
+        return Status::Invalid("Struct is missing ", field_name, " string field");
+    }
+
+    for (std::int64_t i = 0; i < typed_field_array->length(); ++i) {
+        auto str_value = typed_field_array->GetString(i);
+        if (builder.lookup.find(str_value) != builder.lookup.end()) {
+            continue;
+        }
+        auto index = builder.items.length();
+        ARROW_RETURN_NOT_OK(builder.items.Append(str_value));
+        builder.lookup[str_value] = index;
+    }
+    return arrow::Status::OK();
+}
+
 arrow::Status append_struct_row_to_dict(
     StructRow const & struct_row,
     char const * field_name,
@@ -113,199 +140,204 @@ arrow::Status append_struct_row_to_dict(
     return builder.indices.Append(index);
 }
 
-arrow::Result<MigrationResult> migrate_v2_to_v3(
-    MigrationResult && v2_input,
-    arrow::MemoryPool * pool)
-{
-    ARROW_ASSIGN_OR_RAISE(auto temp_dir, MakeTmpDir("pod5_v2_v3_migration"));
-    ARROW_ASSIGN_OR_RAISE(auto v3_reads_table_path, temp_dir->path().Join("reads_table.arrow"));
-    ARROW_ASSIGN_OR_RAISE(
-        auto v3_run_info_table_path, temp_dir->path().Join("run_info_table.arrow"));
+namespace {
+
+class V2ToV3Migration : public TableBatchMigration {
+public:
+    V2ToV3Migration(
+        std::shared_ptr<arrow::Schema> const & v2_schema,
+        std::shared_ptr<arrow::Schema> && v3_schema,
+        arrow::MemoryPool * pool)
+    : m_v2_schema(v2_schema)
+    , m_v3_schema(std::move(v3_schema))
+    , m_pool(pool)
+    {
+    }
+
+    std::shared_ptr<arrow::Schema> const & schema() const override { return m_v3_schema; }
 
+    Result<std::shared_ptr<arrow::RecordBatch>> migrate(
+        std::shared_ptr<arrow::RecordBatch> const & v2_batch) const override
     {
-        ARROW_ASSIGN_OR_RAISE(
-            auto v2_reader, open_record_batch_reader(pool, v2_input.footer().reads_table));
-        ARROW_ASSIGN_OR_RAISE(
-            auto new_metadata, update_metadata(v2_reader.metadata, Version(0, 0, 35)));
-
-        {
-            auto v3_reads_schema = arrow::schema(
-                {arrow::field("read_id", uuid()),
-                 arrow::field("signal", arrow::list(arrow::uint64())),
-                 arrow::field("read_number", arrow::uint32()),
-                 arrow::field("start", arrow::uint64()),
-                 arrow::field("median_before", arrow::float32()),
-                 arrow::field("num_minknow_events", arrow::uint64()),
-                 arrow::field("tracked_scaling_scale", arrow::float32()),
-                 arrow::field("tracked_scaling_shift", arrow::float32()),
-                 arrow::field("predicted_scaling_scale", arrow::float32()),
-                 arrow::field("predicted_scaling_shift", arrow::float32()),
-                 arrow::field("num_reads_since_mux_change", arrow::uint32()),
-                 arrow::field("time_since_mux_change", arrow::float32()),
-                 arrow::field("num_samples", arrow::uint64()),
-                 arrow::field("channel", arrow::uint16()),
-                 arrow::field("well", arrow::uint8()),
-                 arrow::field("pore_type", arrow::dictionary(arrow::int16(), arrow::utf8())),
-                 arrow::field("calibration_offset", arrow::float32()),
-                 arrow::field("calibration_scale", arrow::float32()),
-                 arrow::field("end_reason", arrow::dictionary(arrow::int16(), arrow::utf8())),
-                 arrow::field("end_reason_forced", arrow::boolean()),
-                 arrow::field("run_info", arrow::dictionary(arrow::int16(), arrow::utf8()))},
-                new_metadata);
-            ARROW_ASSIGN_OR_RAISE(
-                auto v3_reads_writer,
-                make_record_batch_writer(
-                    pool, v3_reads_table_path.ToString(), v3_reads_schema, new_metadata));
-
-            std::vector<std::string> const columns_to_copy{
-                "read_id",
-                "signal",
-                "read_number",
-                "start",
-                "median_before",
-                "num_minknow_events",
-                "tracked_scaling_scale",
-                "tracked_scaling_shift",
-                "predicted_scaling_scale",
-                "predicted_scaling_shift",
-                "num_reads_since_mux_change",
-                "time_since_mux_change",
-                "num_samples"};
-
-            // Builders for dict columns
-            StringDictBuilder pore_type;
-            StringDictBuilder end_reason;
-            StringDictBuilder run_info;
-            for (std::int64_t batch_idx = 0; batch_idx < v2_reader.reader->num_record_batches();
-                 ++batch_idx)
-            {
-                // Read V2 data:
-                ARROW_ASSIGN_OR_RAISE(auto v2_batch, v2_reader.reader->ReadRecordBatch(batch_idx));
-                auto const num_rows = v2_batch->num_rows();
-
-                std::vector<std::shared_ptr<arrow::Array>> v3_columns;
-
-                // Write V3 data:
-                std::vector<std::shared_ptr<arrow::Array>> v2_columns = v2_batch->columns();
-                for (auto const & col_name : columns_to_copy) {
-                    ARROW_RETURN_NOT_OK(copy_column(
-                        v2_reader.schema,
-                        v2_columns,
-                        col_name.data(),
-                        v3_reads_schema,
-                        v3_columns));
-                }
-
-                arrow::UInt16Builder channel;
-                arrow::UInt8Builder well;
-                arrow::FloatBuilder calibration_offset;
-                arrow::FloatBuilder calibration_scale;
-                arrow::BooleanBuilder end_reason_forced;
-                for (std::int64_t row = 0; row < num_rows; ++row) {
-                    ARROW_ASSIGN_OR_RAISE(
-                        auto calibration_data, get_dict_struct(v2_batch, row, "calibration"));
-                    ARROW_RETURN_NOT_OK(append_struct_row<arrow::FloatArray>(
-                        calibration_data, "offset", calibration_offset));
-                    ARROW_RETURN_NOT_OK(append_struct_row<arrow::FloatArray>(
-                        calibration_data, "scale", calibration_scale));
-
-                    ARROW_ASSIGN_OR_RAISE(auto pore_data, get_dict_struct(v2_batch, row, "pore"));
-                    ARROW_RETURN_NOT_OK(
-                        append_struct_row<arrow::UInt16Array>(pore_data, "channel", channel));
-                    ARROW_RETURN_NOT_OK(
-                        append_struct_row<arrow::UInt8Array>(pore_data, "well", well));
-                    ARROW_RETURN_NOT_OK(
-                        append_struct_row_to_dict(pore_data, "pore_type", pore_type));
-
-                    ARROW_ASSIGN_OR_RAISE(
-                        auto end_reason_data, get_dict_struct(v2_batch, row, "end_reason"));
-                    ARROW_RETURN_NOT_OK(
-                        append_struct_row_to_dict(end_reason_data, "name", end_reason));
-                    ARROW_RETURN_NOT_OK(append_struct_row<arrow::BooleanArray>(
-                        end_reason_data, "forced", end_reason_forced));
-
-                    ARROW_ASSIGN_OR_RAISE(
-                        auto run_info_data, get_dict_struct(v2_batch, row, "run_info"));
-                    ARROW_RETURN_NOT_OK(
-                        append_struct_row_to_dict(run_info_data, "acquisition_id", run_info));
-                }
-                ARROW_RETURN_NOT_OK(set_column(
-                    v3_reads_schema,
-                    v3_columns,
-                    "calibration_offset",
-                    calibration_offset.Finish()));
-                ARROW_RETURN_NOT_OK(set_column(
-                    v3_reads_schema, v3_columns, "calibration_scale", calibration_scale.Finish()));
-                ARROW_RETURN_NOT_OK(
-                    set_column(v3_reads_schema, v3_columns, "channel", channel.Finish()));
-                ARROW_RETURN_NOT_OK(set_column(v3_reads_schema, v3_columns, "well", well.Finish()));
-                ARROW_RETURN_NOT_OK(
-                    set_column(v3_reads_schema, v3_columns, "pore_type", pore_type.finish()));
-                ARROW_RETURN_NOT_OK(
-                    set_column(v3_reads_schema, v3_columns, "end_reason", end_reason.finish()));
-                ARROW_RETURN_NOT_OK(set_column(
-                    v3_reads_schema, v3_columns, "end_reason_forced", end_reason_forced.Finish()));
-                ARROW_RETURN_NOT_OK(
-                    set_column(v3_reads_schema, v3_columns, "run_info", run_info.finish()));
-
-                ARROW_RETURN_NOT_OK(v3_reads_writer.write_batch(num_rows, std::move(v3_columns)));
-            }
-            ARROW_RETURN_NOT_OK(v3_reads_writer.writer->Close());
+        std::vector<std::string> const columns_to_copy{
+            "read_id",
+            "signal",
+            "read_number",
+            "start",
+            "median_before",
+            "num_minknow_events",
+            "tracked_scaling_scale",
+            "tracked_scaling_shift",
+            "predicted_scaling_scale",
+            "predicted_scaling_shift",
+            "num_reads_since_mux_change",
+            "time_since_mux_change",
+            "num_samples"};
+
+        auto const num_rows = v2_batch->num_rows();
+
+        std::vector<std::shared_ptr<arrow::Array>> v3_columns;
+
+        std::vector<std::shared_ptr<arrow::Array>> v2_columns = v2_batch->columns();
+        for (auto const & col_name : columns_to_copy) {
+            ARROW_RETURN_NOT_OK(copy_column(
+                m_v2_schema, v2_columns, col_name.data(), m_v3_schema, v3_columns));
         }
-        {
-            ARROW_ASSIGN_OR_RAISE(
-                auto v2_last_batch,
-                v2_reader.reader->ReadRecordBatch(v2_reader.reader->num_record_batches() - 1));
-            auto run_info_column = std::dynamic_pointer_cast<arrow::DictionaryArray>(
-                v2_last_batch->GetColumnByName("run_info"));
-            if (!run_info_column) {
-                return arrow::Status::Invalid("Failed to find the run info column");
-            }
-            auto run_info_dict_type =
-                std::dynamic_pointer_cast<arrow::DictionaryType>(run_info_column->type());
-            if (!run_info_dict_type) {
-                return arrow::Status::Invalid("Failed to find a run info of the right type");
-            }
-            auto run_info_items =
-                std::dynamic_pointer_cast<arrow::StructArray>(run_info_column->dictionary());
-            if (!run_info_items) {
-                return arrow::Status::Invalid("Failed to find a run info items array");
-            }
-            auto run_info_items_type =
-                std::dynamic_pointer_cast<arrow::StructType>(run_info_items->type());
-            if (!run_info_items_type) {
-                return arrow::Status::Invalid(
-                    "Failed to find a run info items array of the right type");
-            }
-
-            // Append all the run info dict-struct data to the new table:
-            auto v3_run_info_schema = arrow::schema(run_info_items_type->fields(), new_metadata);
+
+        StringDictBuilder pore_type;
+        StringDictBuilder end_reason;
+        StringDictBuilder run_info;
+        if (num_rows > 0) {
+            ARROW_ASSIGN_OR_RAISE(auto pore_data, get_dict_struct(v2_batch, 0, "pore"));
+            ARROW_RETURN_NOT_OK(add_struct_dict_items(pore_data, "pore_type", pore_type));
+            ARROW_ASSIGN_OR_RAISE(auto end_reason_data, get_dict_struct(v2_batch, 0, "end_reason"));
+            ARROW_RETURN_NOT_OK(add_struct_dict_items(end_reason_data, "name", end_reason));
+            ARROW_ASSIGN_OR_RAISE(auto run_info_data, get_dict_struct(v2_batch, 0, "run_info"));
+            ARROW_RETURN_NOT_OK(add_struct_dict_items(run_info_data, "acquisition_id", run_info));
+        }
+        arrow::UInt16Builder channel(m_pool);
+        arrow::UInt8Builder well(m_pool);
+        arrow::FloatBuilder calibration_offset(m_pool);
+        arrow::FloatBuilder calibration_scale(m_pool);
+        arrow::BooleanBuilder end_reason_forced(m_pool);
+        for (std::int64_t row = 0; row < num_rows; ++row) {
             ARROW_ASSIGN_OR_RAISE(
-                auto v3_run_info_writer,
-                make_record_batch_writer(
-                    pool, v3_run_info_table_path.ToString(), v3_run_info_schema, new_metadata));
+                auto calibration_data, get_dict_struct(v2_batch, row, "calibration"));
+            ARROW_RETURN_NOT_OK(append_struct_row<arrow::FloatArray>(
+                calibration_data, "offset", calibration_offset));
+            ARROW_RETURN_NOT_OK(append_struct_row<arrow::FloatArray>(
+                calibration_data, "scale", calibration_scale));
+
+            ARROW_ASSIGN_OR_RAISE(auto pore_data, get_dict_struct(v2_batch, row, "pore"));
+            ARROW_RETURN_NOT_OK(
+                append_struct_row<arrow::UInt16Array>(pore_data, "channel", channel));
+            ARROW_RETURN_NOT_OK(append_struct_row<arrow::UInt8Array>(pore_data, "well", well));
+            ARROW_RETURN_NOT_OK(append_struct_row_to_dict(pore_data, "pore_type", pore_type));
 
-            auto const & fields = run_info_items->fields();
-            std::vector<std::shared_ptr<arrow::Array>> v3_columns(
-                v3_run_info_schema->fields().size());
-            for (std::size_t col = 0; col < v3_columns.size(); ++col) {
-                v3_columns[col] = fields[col];
-            }
+            ARROW_ASSIGN_OR_RAISE(
+                auto end_reason_data, get_dict_struct(v2_batch, row, "end_reason"));
+            ARROW_RETURN_NOT_OK(append_struct_row_to_dict(end_reason_data, "name", end_reason));
+            ARROW_RETURN_NOT_OK(append_struct_row<arrow::BooleanArray>(
+                end_reason_data, "forced", end_reason_forced));
 
+            ARROW_ASSIGN_OR_RAISE(auto run_info_data, get_dict_struct(v2_batch, row, "run_info"));
             ARROW_RETURN_NOT_OK(
-                v3_run_info_writer.write_batch(run_info_items->length(), std::move(v3_columns)));
-            ARROW_RETURN_NOT_OK(v3_run_info_writer.writer->Close());
+                append_struct_row_to_dict(run_info_data, "acquisition_id", run_info));
         }
+        ARROW_RETURN_NOT_OK(set_column(
+            m_v3_schema, v3_columns, "calibration_offset", calibration_offset.Finish()));
+        ARROW_RETURN_NOT_OK(
+            set_column(m_v3_schema, v3_columns, "calibration_scale", calibration_scale.Finish()));
+        ARROW_RETURN_NOT_OK(set_column(m_v3_schema, v3_columns, "channel", channel.Finish()));
+        ARROW_RETURN_NOT_OK(set_column(m_v3_schema, v3_columns, "well", well.Finish()));
+        ARROW_RETURN_NOT_OK(set_column(m_v3_schema, v3_columns, "pore_type", pore_type.finish()));
+        ARROW_RETURN_NOT_OK(
+            set_column(m_v3_schema, v3_columns, "end_reason", end_reason.finish()));
+        ARROW_RETURN_NOT_OK(
+            set_column(m_v3_schema, v3_columns, "end_reason_forced", end_reason_forced.Finish()));
+        ARROW_RETURN_NOT_OK(set_column(m_v3_schema, v3_columns, "run_info", run_info.finish()));
+
+        return arrow::RecordBatch::Make(m_v3_schema, num_rows, std::move(v3_columns));
     }
 
-    // Set up migrated data to point at our new table:
-    MigrationResult result = std::move(v2_input);
-    ARROW_RETURN_NOT_OK(result.footer().reads_table.from_full_file(v3_reads_table_path.ToString()));
-    ARROW_RETURN_NOT_OK(
-        result.footer().run_info_table.from_full_file(v3_run_info_table_path.ToString()));
-    result.add_temp_dir(std::move(temp_dir));
+private:
+    std::shared_ptr<arrow::Schema> m_v2_schema;
+    std::shared_ptr<arrow::Schema> m_v3_schema;
+    arrow::MemoryPool * m_pool;
+};
+
+}  // namespace
+
+arrow::Result<std::shared_ptr<TableBatchMigration const>> make_v2_to_v3_migration(
+    std::shared_ptr<arrow::Schema> const & v2_schema,
+    arrow::MemoryPool * pool)
+{
+    if (!v2_schema->metadata()) {
+        return Status::IOError("Missing metadata on read table schema");
+    }
+    ARROW_ASSIGN_OR_RAISE(
+        auto new_metadata, update_metadata(v2_schema->metadata(), Version(0, 0, 35)));
+
+    auto v3_reads_schema = arrow::schema(
+        {arrow::field("read_id", uuid()),
+         arrow::field("signal", arrow::list(arrow::uint64())),
+         arrow::field("read_number", arrow::uint32()),
+         arrow::field("start", arrow::uint64()),
+         arrow::field("median_before", arrow::float32()),
+         arrow::field("num_minknow_events", arrow::uint64()),
+         arrow::field("tracked_scaling_scale", arrow::float32()),
+         arrow::field("tracked_scaling_shift", arrow::float32()),
+         arrow::field("predicted_scaling_scale", arrow::float32()),
+         arrow::field("predicted_scaling_shift", arrow::float32()),
+         arrow::field("num_reads_since_mux_change", arrow::uint32()),
+         arrow::field("time_since_mux_change", arrow::float32()),
+         arrow::field("num_samples", arrow::uint64()),
+         arrow::field("channel", arrow::uint16()),
+         arrow::field("well", arrow::uint8()),
+         arrow::field("pore_type", arrow::dictionary(arrow::int16(), arrow::utf8())),
+         arrow::field("calibration_offset", arrow::float32()),
+         arrow::field("calibration_scale", arrow::float32()),
+         arrow::field("end_reason", arrow::dictionary(arrow::int16(), arrow::utf8())),
+         arrow::field("end_reason_forced", arrow::boolean()),
+         arrow::field("run_info", arrow::dictionary(arrow::int16(), arrow::utf8()))},
+        new_metadata);
+
+    return std::make_shared<V2ToV3Migration const>(v2_schema, std::move(v3_reads_schema), pool);
+}
 
-    return result;
+arrow::Result<std::shared_ptr<arrow::Buffer>> make_v3_run_info_table(
+    combined_file_utils::ParsedFileInfo const & reads_table,
+    arrow::MemoryPool * pool)
+{
+    ARROW_ASSIGN_OR_RAISE(auto v2_reader, open_record_batch_reader(pool, reads_table));
+    ARROW_ASSIGN_OR_RAISE(
+        auto new_metadata, update_metadata(v2_reader.metadata, Version(0, 0, 35)));
+
+    // Dictionary deltas leave every run info in the last batch's dictionary:
+    ARROW_ASSIGN_OR_RAISE(
+        auto v2_last_batch,
+        v2_reader.reader->ReadRecordBatch(v2_reader.reader->num_record_batches() - 1));
+    auto run_info_column = std::dynamic_pointer_cast<arrow::DictionaryArray>(
+        v2_last_batch->GetColumnByName("run_info"));
+    if (!run_info_column) {
+        return arrow::Status::Invalid("Failed to find the run info column");
+    }
+    auto run_info_dict_type =
+        std::dynamic_pointer_cast<arrow::DictionaryType>(run_info_column->type());
+    if (!run_info_dict_type) {
+        return arrow::Status::Invalid("Failed to find a run info of the right type");
+    }
+    auto run_info_items =
+        std::dynamic_pointer_cast<arrow::StructArray>(run_info_column->dictionary());
+    if (!run_info_items) {
+        return arrow::Status::Invalid("Failed to find a run info items array");
+    }
+    auto run_info_items_type =
+        std::dynamic_pointer_cast<arrow::StructType>(run_info_items->type());
+    if (!run_info_items_type) {
+        return arrow::Status::Invalid("Failed to find a run info items array of the right type");
+    }
+
+    // Append all the run info dict-struct data to the new table:
+    auto v3_run_info_schema = arrow::schema(run_info_items_type->fields(), new_metadata);
+
+    auto const & fields = run_info_items->fields();
+    std::vector<std::shared_ptr<arrow::Array>> v3_columns(v3_run_info_schema->fields().size());
+    for (std::size_t col = 0; col < v3_columns.size(); ++col) {
+        v3_columns[col] = fields[col];
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto sink, arrow::io::BufferOutputStream::Create(4096, pool));
+    arrow::ipc::IpcWriteOptions write_options;
+    write_options.memory_pool = pool;
+    ARROW_ASSIGN_OR_RAISE(
+        auto writer,
+        arrow::ipc::MakeFileWriter(sink, v3_run_info_schema, write_options, new_metadata));
+    auto const record_batch = arrow::RecordBatch::Make(
+        v3_run_info_schema, run_info_items->length(), std::move(v3_columns));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*record_batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return sink->Finish();
 }
 
 }  // namespace pod5
@@ -0,0 +1,149 @@
+#include "pod5_format/multi_file_signal_loader.h"
+
+#include <exception>
+#include <thread>
+
+namespace pod5 {
+
+MultiFileSignalLoader::MultiFileSignalLoader(
+    std::vector<SignalLoadPlan> plans,
+    MultiFileSignalLoaderOptions const & options)
+: m_plans(std::move(plans))
+, m_options(options)
+, m_thread_pool(
+      m_options.thread_pool()
+          ? m_options.thread_pool()
+          : make_thread_pool(
+              numa_thread_pool_options(std::max(1u, std::thread::hardware_concurrency()))))
+, m_next_file_index(0)
+, m_opening_files(0)
+{
+    std::unique_lock<std::mutex> l(m_sync);
+    start_next_files(l);
+}
+
+MultiFileSignalLoader::~MultiFileSignalLoader()
+{
+    // Wait for files being opened, as the open tasks refer to this loader:
+    std::unique_lock<std::mutex> l(m_sync);
+    m_file_opened.wait(l, [&] { return m_opening_files == 0; });
+    auto files = std::move(m_files);
+    l.unlock();
+
+    // Each file's loader waits for its own tasks as it is destroyed:
+    files.clear();
+}
+
+Result<std::optional<MultiFileSignalBatch>> MultiFileSignalLoader::release_next_batch(
+    std::optional<std::chrono::steady_clock::time_point> timeout)
+{
+    while (true) {
+        // Wait for the first file in flight to finish opening:
+        std::shared_ptr<InFlightFile> file;
+        {
+            std::unique_lock<std::mutex> l(m_sync);
+            if (m_files.empty()) {
+                return std::nullopt;
+            }
+
+            file = m_files.front();
+            auto const is_opened = [&] { return file->opened; };
+            if (timeout) {
+                if (!m_file_opened.wait_until(l, *timeout, is_opened)) {
+                    return std::nullopt;
+                }
+            } else {
+                m_file_opened.wait(l, is_opened);
+            }
+            ARROW_RETURN_NOT_OK(file->open_status);
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto signal, file->loader->release_next_batch(timeout));
+        if (signal) {
+            return MultiFileSignalBatch{file->file_index, std::move(signal)};
+        }
+
+        // The loader is only unfinished if the wait timed out:
+        if (!file->loader->is_finished()) {
+            return std::nullopt;
+        }
+
+        // This file is exhausted, so start the next file in its place:
+        std::unique_lock<std::mutex> l(m_sync);
+        m_files.pop_front();
+        start_next_files(l);
+    }
+}
+
+bool MultiFileSignalLoader::is_finished() const
+{
+    std::lock_guard<std::mutex> l(m_sync);
+    return m_files.empty() && m_next_file_index >= m_plans.size();
+}
+
+void MultiFileSignalLoader::start_next_files(std::unique_lock<std::mutex> & lock)
+{
+    assert(lock.owns_lock());
+    while (m_files.size() < m_options.files_in_flight() && m_next_file_index < m_plans.size()) {
+        auto file = std::make_shared<InFlightFile>();
+        file->file_index = m_next_file_index;
+        m_next_file_index += 1;
+        m_files.push_back(file);
+
+        try {
+            // Each file is opened and loaded by one group of workers, so its pages and decoded
+            // samples stay on that group's NUMA node:
+            m_thread_pool->post_to_group(
+                [this, file] { open_file(file); },
+                file->file_index % m_thread_pool->worker_group_count());
+            m_opening_files += 1;
+        } catch (std::exception const & e) {
+            // The pool throws once stopped:
+            file->opened = true;
+            file->open_status = Status::Invalid("Failed to queue file open: ", e.what());
+            m_file_opened.notify_all();
+        }
+    }
+}
+
+void MultiFileSignalLoader::open_file(std::shared_ptr<InFlightFile> const & file)
+{
+    auto const & plan = m_plans[file->file_index];
+
+    Status open_status;
+    std::unique_ptr<AsyncSignalLoader> loader;
+    auto reader = plan.reader;
+    if (!reader) {
+        auto opened_reader = open_file_reader(plan.path, m_options.file_reader_options());
+        if (opened_reader.ok()) {
+            reader = std::move(*opened_reader);
+        } else {
+            open_status = opened_reader.status();
+        }
+    }
+
+    // Making the loader starts it loading, ahead of the files before it being released:
+    if (reader) {
+        loader = std::make_unique<AsyncSignalLoader>(
+            reader,
+            m_options.samples_mode(),
+            gsl::make_span(plan.batch_counts),
+            gsl::make_span(plan.batch_rows),
+            m_thread_pool,
+            m_options.tasks_per_file(),
+            m_options.max_pending_batches(),
+            AsyncSignalLoader::DEFAULT_PREFETCH_DISTANCE,
+            AsyncSignalLoader::NO_PENDING_BYTES_LIMIT,
+            AsyncSignalLoader::RowOrder::SignalTable,
+            file->file_index % m_thread_pool->worker_group_count());
+    }
+
+    std::lock_guard<std::mutex> l(m_sync);
+    file->opened = true;
+    file->open_status = std::move(open_status);
+    file->loader = std::move(loader);
+    m_opening_files -= 1;
+    m_file_opened.notify_all();
+}
+
+}  // namespace pod5
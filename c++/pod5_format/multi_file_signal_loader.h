@@ -0,0 +1,150 @@
+#pragma once
+
+#include "pod5_format/async_signal_loader.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+#include "pod5_format/thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pod5 {
+
+class POD5_FORMAT_EXPORT MultiFileSignalLoaderOptions {
+public:
+    static constexpr std::size_t DEFAULT_FILES_IN_FLIGHT = 2;
+    static constexpr std::size_t DEFAULT_TASKS_PER_FILE = 4;
+    static constexpr std::size_t DEFAULT_MAX_PENDING_BATCHES = 10;
+
+    void set_file_reader_options(FileReaderOptions const & file_reader_options)
+    {
+        m_file_reader_options = file_reader_options;
+    }
+
+    FileReaderOptions const & file_reader_options() const { return m_file_reader_options; }
+
+    void set_samples_mode(AsyncSignalLoader::SamplesMode samples_mode)
+    {
+        m_samples_mode = samples_mode;
+    }
+
+    AsyncSignalLoader::SamplesMode samples_mode() const { return m_samples_mode; }
+
+    // Set how many files are opened and loading at once. Files after the one being released are
+    // opened and start loading ahead, so their batches are ready when the file before finishes.
+    void set_files_in_flight(std::size_t files_in_flight)
+    {
+        m_files_in_flight = std::max<std::size_t>(1, files_in_flight);
+    }
+
+    std::size_t files_in_flight() const { return m_files_in_flight; }
+
+    // Set the most tasks each file's loader has on the thread pool at once.
+    void set_tasks_per_file(std::size_t tasks_per_file)
+    {
+        m_tasks_per_file = std::max<std::size_t>(1, tasks_per_file);
+    }
+
+    std::size_t tasks_per_file() const { return m_tasks_per_file; }
+
+    // Set how many loaded batches each file's loader holds before waiting for them to be released.
+    void set_max_pending_batches(std::size_t max_pending_batches)
+    {
+        m_max_pending_batches = max_pending_batches;
+    }
+
+    std::size_t max_pending_batches() const { return m_max_pending_batches; }
+
+    // Set the thread pool files are opened and loaded on, shared between all files' loaders.
+    // Files are spread over the pool's worker groups, each loaded within one group.
+    // Note: If unset a pool with a thread per core is made for the loader, with a worker group
+    // per NUMA node, see numa_thread_pool_options().
+    void set_thread_pool(std::shared_ptr<ThreadPool> const & thread_pool)
+    {
+        m_thread_pool = thread_pool;
+    }
+
+    std::shared_ptr<ThreadPool> const & thread_pool() const { return m_thread_pool; }
+
+private:
+    FileReaderOptions m_file_reader_options;
+    AsyncSignalLoader::SamplesMode m_samples_mode = AsyncSignalLoader::SamplesMode::Samples;
+    std::size_t m_files_in_flight = DEFAULT_FILES_IN_FLIGHT;
+    std::size_t m_tasks_per_file = DEFAULT_TASKS_PER_FILE;
+    std::size_t m_max_pending_batches = DEFAULT_MAX_PENDING_BATCHES;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+};
+
+/// \brief The signal to load from one file, see AsyncSignalLoader for the meaning of the batch
+///        counts and rows.
+struct SignalLoadPlan {
+    /// The file to load from, opened by the loader if [reader] is null.
+    std::string path;
+    std::shared_ptr<FileReader> reader;
+    /// Rows to load in each read batch, or empty to load every row.
+    std::vector<std::uint32_t> batch_counts;
+    /// Specific rows to load within each batch, or empty to load the first [batch_counts] rows.
+    std::vector<std::uint32_t> batch_rows;
+};
+
+/// \brief A batch of loaded signal, and the index of the plan it was loaded for.
+struct MultiFileSignalBatch {
+    std::size_t file_index;
+    std::unique_ptr<CachedBatchSignalData> signal;
+};
+
+/// \brief Load signal from a sequence of files, keeping several files open and loading at once so
+///        there is no pause between files.
+///
+/// Batches are released file by file in plan order, and in batch order within each file.
+class POD5_FORMAT_EXPORT MultiFileSignalLoader {
+public:
+    MultiFileSignalLoader(
+        std::vector<SignalLoadPlan> plans,
+        MultiFileSignalLoaderOptions const & options = {});
+    ~MultiFileSignalLoader();
+
+    /// Get the next batch of loaded signal.
+    /// \note Returns nullopt when timeout occurs, or if all files are exhausted.
+    Result<std::optional<MultiFileSignalBatch>> release_next_batch(
+        std::optional<std::chrono::steady_clock::time_point> timeout = std::nullopt);
+
+    /// Find if every file's signal has been released.
+    bool is_finished() const;
+
+private:
+    struct InFlightFile {
+        std::size_t file_index;
+        // Set, with [loader], by the opening task once the file is open:
+        bool opened = false;
+        Status open_status;
+        std::unique_ptr<AsyncSignalLoader> loader;
+    };
+
+    /// Start opening files until [m_options.files_in_flight()] are in flight.
+    /// \param lock A lock held on m_sync.
+    void start_next_files(std::unique_lock<std::mutex> & lock);
+    void open_file(std::shared_ptr<InFlightFile> const & file);
+
+    std::vector<SignalLoadPlan> m_plans;
+    MultiFileSignalLoaderOptions m_options;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+
+    mutable std::mutex m_sync;
+    std::condition_variable m_file_opened;
+    std::size_t m_next_file_index;
+    // Open tasks queued or running on [m_thread_pool]:
+    std::size_t m_opening_files;
+    std::deque<std::shared_ptr<InFlightFile>> m_files;
+};
+
+}  // namespace pod5
@@ -0,0 +1,72 @@
+#include "pod5_format/read_batch_iterator.h"
+
+#include <utility>
+
+namespace pod5 {
+
+ReadBatchIterator::ReadBatchIterator(
+    std::shared_ptr<FileReader> reader,
+    std::shared_ptr<ReadTableProjection const> projection,
+    ReadBatchIteratorOptions const & options)
+: m_reader(std::move(reader))
+, m_projection(std::move(projection))
+, m_options(options)
+, m_thread_pool(
+      m_options.thread_pool() ? m_options.thread_pool()
+                              : make_thread_pool(m_options.prefetch_batches()))
+, m_batch_count(m_reader->num_read_record_batches())
+{
+    start_reads();
+}
+
+ReadBatchIterator::~ReadBatchIterator()
+{
+    // Reads keep the reader alive themselves, but waiting means no IO continues for a dropped
+    // iterator, and a pool made for it is idle as it is destroyed:
+    for (auto & pending : m_pending) {
+        pending.Wait();
+    }
+}
+
+Result<std::optional<ReadTableRecordBatch>> ReadBatchIterator::next()
+{
+    if (m_pending.empty()) {
+        return std::nullopt;
+    }
+
+    auto pending = std::move(m_pending.front());
+    m_pending.pop_front();
+    m_next_batch_index += 1;
+    // Replace the batch being returned before waiting for it, so the pool stays busy:
+    start_reads();
+
+    ARROW_ASSIGN_OR_RAISE(auto batch, pending.MoveResult());
+    return std::optional<ReadTableRecordBatch>{std::move(batch)};
+}
+
+void ReadBatchIterator::start_reads()
+{
+    while (m_pending.size() < m_options.prefetch_batches() && m_next_read_index < m_batch_count) {
+        auto const i = m_next_read_index++;
+        m_pending.push_back(
+            m_projection ? m_reader->read_read_record_batch_async(i, m_projection, *m_thread_pool)
+                         : m_reader->read_read_record_batch_async(i, *m_thread_pool));
+    }
+}
+
+Result<std::unique_ptr<ReadBatchIterator>> make_read_batch_iterator(
+    std::shared_ptr<FileReader> const & reader,
+    ReadBatchIteratorOptions const & options)
+{
+    if (!reader) {
+        return Status::Invalid("A reader is required to iterate over read batches");
+    }
+
+    std::shared_ptr<ReadTableProjection const> projection;
+    if (!options.columns().empty()) {
+        ARROW_ASSIGN_OR_RAISE(projection, reader->make_read_table_projection(options.columns()));
+    }
+    return std::make_unique<ReadBatchIterator>(reader, std::move(projection), options);
+}
+
+}  // namespace pod5
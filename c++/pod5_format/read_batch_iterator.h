@@ -0,0 +1,98 @@
+#pragma once
+
+#include "pod5_format/file_reader.h"
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/result.h"
+#include "pod5_format/thread_pool.h"
+
+#include <arrow/util/future.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pod5 {
+
+class POD5_FORMAT_EXPORT ReadBatchIteratorOptions {
+public:
+    static constexpr std::size_t DEFAULT_PREFETCH_BATCHES = 4;
+
+    // Set how many batches after the one last returned are read ahead. At most this many decoded
+    // batches are held by the iterator at once.
+    void set_prefetch_batches(std::size_t prefetch_batches)
+    {
+        m_prefetch_batches = std::max<std::size_t>(1, prefetch_batches);
+    }
+
+    std::size_t prefetch_batches() const { return m_prefetch_batches; }
+
+    // Set the read table columns to load, or empty to load every column.
+    void set_columns(std::vector<std::string> columns) { m_columns = std::move(columns); }
+
+    std::vector<std::string> const & columns() const { return m_columns; }
+
+    // Set the thread pool batches are read on.
+    // Note: If unset a pool with a thread for each prefetched batch is made for the iterator.
+    void set_thread_pool(std::shared_ptr<ThreadPool> const & thread_pool)
+    {
+        m_thread_pool = thread_pool;
+    }
+
+    std::shared_ptr<ThreadPool> const & thread_pool() const { return m_thread_pool; }
+
+private:
+    std::size_t m_prefetch_batches = DEFAULT_PREFETCH_BATCHES;
+    std::vector<std::string> m_columns;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+};
+
+/// \brief Iterate over a file's read table batches in order, reading the next few batches on a
+///        thread pool while the caller works on the last one returned.
+class POD5_FORMAT_EXPORT ReadBatchIterator {
+public:
+    /// \brief Iterate over the batches of [reader], loading only the columns in [projection], or
+    ///        every column if it is null. The columns set in [options] are not used, see
+    ///        make_read_batch_iterator() to project them.
+    ReadBatchIterator(
+        std::shared_ptr<FileReader> reader,
+        std::shared_ptr<ReadTableProjection const> projection,
+        ReadBatchIteratorOptions const & options);
+    ReadBatchIterator(ReadBatchIterator const &) = delete;
+    ReadBatchIterator & operator=(ReadBatchIterator const &) = delete;
+    ~ReadBatchIterator();
+
+    /// \brief Get the next batch, waiting for it to be read if it isn't yet.
+    /// \note Returns nullopt once every batch has been returned. A batch which failed to read
+    ///       returns its error, and the next call moves on to the following batch.
+    Result<std::optional<ReadTableRecordBatch>> next();
+
+    /// \brief The index of the batch the next call to next() returns.
+    std::size_t next_batch_index() const { return m_next_batch_index; }
+
+    std::size_t batch_count() const { return m_batch_count; }
+
+private:
+    /// Queue reads until [m_options.prefetch_batches()] are in flight, or none are left.
+    void start_reads();
+
+    std::shared_ptr<FileReader> m_reader;
+    std::shared_ptr<ReadTableProjection const> m_projection;
+    ReadBatchIteratorOptions m_options;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+    std::size_t m_batch_count;
+    std::size_t m_next_batch_index = 0;
+    std::size_t m_next_read_index = 0;
+    std::deque<arrow::Future<ReadTableRecordBatch>> m_pending;
+};
+
+/// \brief Make an iterator over the read table batches of [reader], see ReadBatchIteratorOptions.
+POD5_FORMAT_EXPORT Result<std::unique_ptr<ReadBatchIterator>> make_read_batch_iterator(
+    std::shared_ptr<FileReader> const & reader,
+    ReadBatchIteratorOptions const & options = {});
+
+}  // namespace pod5
@@ -0,0 +1,223 @@
+#include "pod5_format/read_id_filter.h"
+
+#include "pod5_format/internal/combined_file_utils.h"
+
+#include <arrow/array/array_primitive.h>
+#include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <arrow/util/key_value_metadata.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace pod5 {
+
+namespace {
+
+char const * const INDEX_TYPE_KEY = "MINKNOW:index_type";
+char const * const READ_ID_FILTER_INDEX_TYPE = "read_id_bloom_filter";
+char const * const HASH_COUNT_KEY = "MINKNOW:read_id_filter_hash_count";
+
+constexpr std::uint32_t MAX_HASH_COUNT = 16;
+constexpr std::uint64_t SECOND_HASH_SEED = 0x9e3779b97f4a7c15ull;
+
+// The splitmix64 finaliser, mixing every input bit into every output bit.
+std::uint64_t mix64(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+struct ReadIdHashes {
+    std::uint64_t first;
+    std::uint64_t second;
+};
+
+// Derive the bit positions for a read id with double hashing: bit i is (first + i * second).
+ReadIdHashes hash_read_id(Uuid const & read_id)
+{
+    std::uint64_t halves[2];
+    std::memcpy(halves, read_id.data(), sizeof(halves));
+
+    auto const first = mix64(halves[0] ^ mix64(halves[1]));
+    // An odd step never cycles back onto the first bit early:
+    auto const second = mix64(first ^ SECOND_HASH_SEED) | 1;
+    return {first, second};
+}
+
+std::shared_ptr<arrow::Schema> make_read_id_filter_schema(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    return arrow::schema({arrow::field("bits", arrow::uint64(), false)}, metadata);
+}
+
+bool is_read_id_filter(arrow::Schema const & schema)
+{
+    auto const & metadata = schema.metadata();
+    if (!metadata) {
+        return false;
+    }
+    auto const index_type = metadata->Get(INDEX_TYPE_KEY);
+    return index_type.ok() && *index_type == READ_ID_FILTER_INDEX_TYPE;
+}
+
+Result<std::shared_ptr<ReadIdFilter const>> open_from_reader(
+    arrow::ipc::RecordBatchFileReader & reader)
+{
+    auto const & schema = reader.schema();
+    if (!schema->Equals(*make_read_id_filter_schema(nullptr), false)) {
+        return Status::IOError("Invalid read id filter schema");
+    }
+    if (reader.num_record_batches() != 1) {
+        return Status::IOError("Invalid read id filter, expected a single batch");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto const hash_count_str, schema->metadata()->Get(HASH_COUNT_KEY));
+    std::uint32_t hash_count = 0;
+    try {
+        hash_count = std::stoul(hash_count_str);
+    } catch (std::exception const &) {
+        return Status::IOError("Invalid read id filter hash count '", hash_count_str, "'");
+    }
+    if (hash_count < 1 || hash_count > MAX_HASH_COUNT) {
+        return Status::IOError("Invalid read id filter hash count ", hash_count);
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto batch, reader.ReadRecordBatch(0));
+    auto const bits = std::static_pointer_cast<arrow::UInt64Array>(batch->column(0));
+    if (bits->null_count() != 0 || bits->length() == 0) {
+        return Status::IOError("Invalid read id filter bits");
+    }
+
+    return std::make_shared<ReadIdFilter const>(
+        batch, gsl::make_span(bits->raw_values(), bits->length()), hash_count);
+}
+
+}  // namespace
+
+ReadIdFilter::ReadIdFilter(
+    std::shared_ptr<void const> storage,
+    gsl::span<std::uint64_t const> bits,
+    std::uint32_t hash_count)
+: m_storage(std::move(storage))
+, m_bits(bits)
+, m_hash_count(hash_count)
+{
+}
+
+Result<std::shared_ptr<ReadIdFilter const>> ReadIdFilter::build(
+    gsl::span<Uuid const> read_ids,
+    std::size_t bits_per_read)
+{
+    if (bits_per_read == 0) {
+        return Status::Invalid("Read id filter needs at least one bit per read");
+    }
+
+    // k = m/n * ln(2) minimises the false positive rate for a filter of m bits and n reads:
+    auto const hash_count = std::uint32_t(std::clamp<double>(
+        std::round(bits_per_read * std::log(2.0)), 1, MAX_HASH_COUNT));
+    auto const word_count = std::max<std::size_t>(1, (read_ids.size() * bits_per_read + 63) / 64);
+
+    auto storage = std::make_shared<std::vector<std::uint64_t>>(word_count, 0);
+    auto & words = *storage;
+    auto const bit_count = word_count * 64;
+    for (auto const & read_id : read_ids) {
+        auto const hashes = hash_read_id(read_id);
+        for (std::uint32_t i = 0; i < hash_count; ++i) {
+            auto const bit = (hashes.first + i * hashes.second) % bit_count;
+            words[bit / 64] |= std::uint64_t(1) << (bit % 64);
+        }
+    }
+
+    auto const bits = gsl::make_span(storage->data(), storage->size());
+    return std::make_shared<ReadIdFilter const>(std::move(storage), bits, hash_count);
+}
+
+Result<std::shared_ptr<ReadIdFilter const>> ReadIdFilter::open(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    arrow::MemoryPool * pool)
+{
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = pool;
+
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(file, options));
+    if (!is_read_id_filter(*reader->schema())) {
+        return Status::IOError("Embedded file is not a read id filter");
+    }
+    return open_from_reader(*reader);
+}
+
+Result<std::shared_ptr<arrow::Buffer>> ReadIdFilter::write(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    arrow::MemoryPool * pool) const
+{
+    auto const filter_metadata =
+        metadata ? metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    filter_metadata->Append(INDEX_TYPE_KEY, READ_ID_FILTER_INDEX_TYPE);
+    filter_metadata->Append(HASH_COUNT_KEY, std::to_string(m_hash_count));
+
+    auto const length = std::int64_t(m_bits.size());
+    auto const bits = std::make_shared<arrow::UInt64Array>(
+        length, arrow::Buffer::Wrap(m_bits.data(), m_bits.size()));
+
+    auto const schema = make_read_id_filter_schema(filter_metadata);
+    auto const batch = arrow::RecordBatch::Make(schema, length, {bits});
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto sink,
+        arrow::io::BufferOutputStream::Create(length * sizeof(std::uint64_t) + 1024, pool));
+
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return sink->Finish();
+}
+
+bool ReadIdFilter::may_contain(Uuid const & read_id) const
+{
+    auto const hashes = hash_read_id(read_id);
+    auto const bits = bit_count();
+    for (std::uint32_t i = 0; i < m_hash_count; ++i) {
+        auto const bit = (hashes.first + i * hashes.second) % bits;
+        if ((m_bits[bit / 64] & (std::uint64_t(1) << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Result<std::shared_ptr<ReadIdFilter const>> open_read_id_filter(
+    std::string const & path,
+    arrow::MemoryPool * pool)
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto file, arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ));
+    ARROW_ASSIGN_OR_RAISE(auto const footer, combined_file_utils::read_footer(path, file));
+
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = pool;
+    for (auto const & other_index : footer.other_indexes) {
+        ARROW_ASSIGN_OR_RAISE(auto sub_file, combined_file_utils::open_sub_file(other_index));
+        ARROW_ASSIGN_OR_RAISE(
+            auto reader, arrow::ipc::RecordBatchFileReader::Open(sub_file, options));
+        if (is_read_id_filter(*reader->schema())) {
+            return open_from_reader(*reader);
+        }
+    }
+    return std::shared_ptr<ReadIdFilter const>();
+}
+
+}  // namespace pod5
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+#include "pod5_format/uuid.h"
+
+#include <arrow/io/type_fwd.h>
+#include <gsl/gsl-lite.hpp>
+
+#include <memory>
+#include <string>
+
+namespace arrow {
+class Buffer;
+class KeyValueMetadata;
+class MemoryPool;
+}  // namespace arrow
+
+namespace pod5 {
+
+/// \brief Bloom filter over the read ids in a file, answering "definitely not in the file" or
+///        "possibly in the file" without opening the file's tables.
+///
+/// Written into the file as an arrow table with one batch holding a single "bits" column of
+/// uint64 words, tagged with "MINKNOW:index_type" schema metadata so it can be told apart from
+/// other OtherIndex embedded files.
+class POD5_FORMAT_EXPORT ReadIdFilter {
+public:
+    /// \brief Default filter size, giving a false positive rate of around 1%.
+    static constexpr std::size_t DEFAULT_BITS_PER_READ = 10;
+
+    /// \param storage      Owns the memory [bits] points into.
+    ReadIdFilter(
+        std::shared_ptr<void const> storage,
+        gsl::span<std::uint64_t const> bits,
+        std::uint32_t hash_count);
+
+    /// \brief Build a filter holding [read_ids].
+    static Result<std::shared_ptr<ReadIdFilter const>> build(
+        gsl::span<Uuid const> read_ids,
+        std::size_t bits_per_read = DEFAULT_BITS_PER_READ);
+
+    /// \brief Open a filter written by [write], referencing the data in [file] without copying
+    ///        where possible.
+    static Result<std::shared_ptr<ReadIdFilter const>> open(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+        arrow::MemoryPool * pool);
+
+    /// \brief Serialise the filter as an arrow ipc file, tagged with [metadata].
+    Result<std::shared_ptr<arrow::Buffer>> write(
+        std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+        arrow::MemoryPool * pool) const;
+
+    /// \brief Check if [read_id] may be present, false means it is definitely absent.
+    bool may_contain(Uuid const & read_id) const;
+
+    std::size_t bit_count() const { return m_bits.size() * 64; }
+
+    std::uint32_t hash_count() const { return m_hash_count; }
+
+private:
+    std::shared_ptr<void const> m_storage;
+    gsl::span<std::uint64_t const> m_bits;
+    std::uint32_t m_hash_count;
+};
+
+/// \brief Open the read id filter in the pod5 file at [path], reading only the footer and the
+///        filter itself.
+/// \returns The filter, or null if the file was written without one.
+POD5_FORMAT_EXPORT Result<std::shared_ptr<ReadIdFilter const>> open_read_id_filter(
+    std::string const & path,
+    arrow::MemoryPool * pool);
+
+}  // namespace pod5
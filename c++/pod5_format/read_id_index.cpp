@@ -0,0 +1,274 @@
+#include "pod5_format/read_id_index.h"
+
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/read_table_reader.h"
+
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace pod5 {
+
+namespace {
+
+struct IndexData {
+    Uuid id;
+    std::uint32_t batch;
+    std::uint32_t batch_row;
+};
+
+bool compare_ids(IndexData const & a, IndexData const & b) { return a.id < b.id; }
+
+struct IndexStorage {
+    std::vector<Uuid> read_ids;
+    std::vector<std::uint32_t> batches;
+    std::vector<std::uint32_t> batch_rows;
+};
+
+std::shared_ptr<arrow::Schema> make_read_id_index_schema(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    return arrow::schema(
+        {
+            arrow::field("read_id", arrow::fixed_size_binary(sizeof(Uuid)), false),
+            arrow::field("batch", arrow::uint32(), false),
+            arrow::field("batch_row", arrow::uint32(), false),
+        },
+        metadata);
+}
+
+}  // namespace
+
+ReadIdIndex::ReadIdIndex(
+    std::shared_ptr<void const> storage,
+    gsl::span<Uuid const> read_ids,
+    gsl::span<std::uint32_t const> batches,
+    gsl::span<std::uint32_t const> batch_rows)
+: m_storage(std::move(storage))
+, m_read_ids(read_ids)
+, m_batches(batches)
+, m_batch_rows(batch_rows)
+{
+    assert(m_read_ids.size() == m_batches.size());
+    assert(m_read_ids.size() == m_batch_rows.size());
+}
+
+Result<std::shared_ptr<ReadIdIndex const>> ReadIdIndex::build(
+    ReadTableReader const & reader,
+    ThreadPool * thread_pool)
+{
+    auto const batch_count = reader.num_record_batches();
+    if (batch_count > std::numeric_limits<std::uint32_t>::max()) {
+        return Status::Invalid("Too many read table batches to index");
+    }
+
+    // Copy each batch's read ids out and sort them, giving one sorted run per batch. A table
+    // written sorted by read id already is one sorted run, so needs neither sort nor merge:
+    auto const sorted_table = reader.sorted_by_read_id();
+
+    // The table's ipc reader reads a batch at a time, so batches are read in turn here, and only
+    // their ids are copied and sorted in parallel. Only the read id column is read, unless the
+    // table is migrated, as migrations load every column:
+    std::shared_ptr<ReadTableProjection const> read_id_projection;
+    if (reader.migrations().empty()) {
+        auto projection = reader.make_projection({"read_id"});
+        if (projection.ok()) {
+            read_id_projection = std::move(*projection);
+        }
+    }
+    std::vector<std::shared_ptr<UuidArray>> read_id_columns(batch_count);
+    for (std::size_t i = 0; i < batch_count; ++i) {
+        ARROW_ASSIGN_OR_RAISE(
+            auto const batch,
+            read_id_projection ? reader.read_record_batch(i, *read_id_projection)
+                               : reader.read_record_batch(i));
+        read_id_columns[i] = batch.read_id_column();
+    }
+
+    std::vector<std::vector<IndexData>> batch_read_ids(batch_count);
+    ARROW_RETURN_NOT_OK(
+        internal::run_parallel_tasks(thread_pool, batch_count, [&](std::size_t i) -> Status {
+            auto const read_id_col = std::move(read_id_columns[i]);
+            auto raw_read_id_values = read_id_col->raw_values();
+            auto & read_ids = batch_read_ids[i];
+            read_ids.resize(read_id_col->length());
+            for (std::size_t row = 0; row < read_ids.size(); ++row) {
+                // Record the id, and its location within the file:
+                read_ids[row] = {raw_read_id_values[row], std::uint32_t(i), std::uint32_t(row)};
+            }
+            if (!sorted_table) {
+                std::stable_sort(read_ids.begin(), read_ids.end(), compare_ids);
+            }
+            return Status::OK();
+        }));
+
+    // Run i of [sorted] covers [run_starts[i], run_starts[i + 1]):
+    std::vector<std::size_t> run_starts{0};
+    run_starts.reserve(batch_count + 1);
+    for (auto const & read_ids : batch_read_ids) {
+        run_starts.push_back(run_starts.back() + read_ids.size());
+    }
+
+    std::vector<IndexData> sorted(run_starts.back());
+    for (std::size_t i = 0; i < batch_count; ++i) {
+        std::copy(
+            batch_read_ids[i].begin(), batch_read_ids[i].end(), sorted.begin() + run_starts[i]);
+        batch_read_ids[i] = {};
+    }
+
+    // Merge the runs across threads. The merge is stable, so duplicate ids stay in file order:
+    if (!sorted_table) {
+        ARROW_RETURN_NOT_OK(
+            internal::merge_sorted_runs(thread_pool, sorted, std::move(run_starts), compare_ids));
+    }
+
+    auto storage = std::make_shared<IndexStorage>();
+    storage->read_ids.resize(sorted.size());
+    storage->batches.resize(sorted.size());
+    storage->batch_rows.resize(sorted.size());
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        storage->read_ids[i] = sorted[i].id;
+        storage->batches[i] = sorted[i].batch;
+        storage->batch_rows[i] = sorted[i].batch_row;
+    }
+
+    gsl::span<Uuid const> const read_ids{storage->read_ids};
+    gsl::span<std::uint32_t const> const batches{storage->batches};
+    gsl::span<std::uint32_t const> const batch_rows{storage->batch_rows};
+    return std::make_shared<ReadIdIndex const>(std::move(storage), read_ids, batches, batch_rows);
+}
+
+Result<std::shared_ptr<ReadIdIndex const>> ReadIdIndex::open(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    arrow::MemoryPool * pool)
+{
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = pool;
+
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(file, options));
+    if (!reader->schema()->Equals(*make_read_id_index_schema(nullptr), false)) {
+        return Status::IOError("Invalid read id index schema");
+    }
+    if (reader->num_record_batches() != 1) {
+        return Status::IOError("Invalid read id index, expected a single batch");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadRecordBatch(0));
+    auto const read_ids = std::static_pointer_cast<arrow::FixedSizeBinaryArray>(batch->column(0));
+    auto const batches = std::static_pointer_cast<arrow::UInt32Array>(batch->column(1));
+    auto const batch_rows = std::static_pointer_cast<arrow::UInt32Array>(batch->column(2));
+    if (read_ids->null_count() != 0 || batches->null_count() != 0
+        || batch_rows->null_count() != 0)
+    {
+        return Status::IOError("Invalid read id index, unexpected null entries");
+    }
+
+    std::size_t const length = batch->num_rows();
+    return std::make_shared<ReadIdIndex const>(
+        batch,
+        gsl::make_span(reinterpret_cast<Uuid const *>(read_ids->raw_values()), length),
+        gsl::make_span(batches->raw_values(), length),
+        gsl::make_span(batch_rows->raw_values(), length));
+}
+
+Result<std::shared_ptr<ReadIdIndex const>> ReadIdIndex::copy_to_shared_memory() const
+{
+#ifdef _WIN32
+    // Processes aren't forked on windows, so there is nothing to share with:
+    return std::make_shared<ReadIdIndex const>(m_storage, m_read_ids, m_batches, m_batch_rows);
+#else
+    auto const read_ids_bytes = m_read_ids.size_bytes();
+    auto const batches_bytes = m_batches.size_bytes();
+    auto const mapping_size = std::max<std::size_t>(1, read_ids_bytes + 2 * batches_bytes);
+    auto const mapped = mmap(
+        nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        return Status::OutOfMemory(
+            "Failed to map ", mapping_size, " bytes for the read id index: ", std::strerror(errno));
+    }
+    std::shared_ptr<void const> storage(
+        mapped, [mapping_size](void * ptr) { munmap(ptr, mapping_size); });
+
+    // Ids are 16 bytes each, so the batch columns following them stay aligned:
+    auto const data = static_cast<std::uint8_t *>(mapped);
+    auto const batches = reinterpret_cast<std::uint32_t *>(data + read_ids_bytes);
+    auto const batch_rows = batches + m_batches.size();
+    std::copy(m_read_ids.begin(), m_read_ids.end(), reinterpret_cast<Uuid *>(data));
+    std::copy(m_batches.begin(), m_batches.end(), batches);
+    std::copy(m_batch_rows.begin(), m_batch_rows.end(), batch_rows);
+
+    // Nothing writes to the index once copied, protect it so no page is ever copied on write:
+    if (mprotect(mapped, mapping_size, PROT_READ) != 0) {
+        return Status::IOError("Failed to protect the read id index: ", std::strerror(errno));
+    }
+
+    return std::make_shared<ReadIdIndex const>(
+        std::move(storage),
+        gsl::make_span(reinterpret_cast<Uuid const *>(data), m_read_ids.size()),
+        gsl::make_span(batches, m_batches.size()),
+        gsl::make_span(batch_rows, m_batch_rows.size()));
+#endif
+}
+
+Result<std::shared_ptr<arrow::Buffer>> ReadIdIndex::write(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    arrow::MemoryPool * pool) const
+{
+    auto const length = std::int64_t(size());
+    auto const read_ids = std::make_shared<arrow::FixedSizeBinaryArray>(
+        arrow::fixed_size_binary(sizeof(Uuid)),
+        length,
+        arrow::Buffer::Wrap(m_read_ids.data(), m_read_ids.size()));
+    auto const batches = std::make_shared<arrow::UInt32Array>(
+        length, arrow::Buffer::Wrap(m_batches.data(), m_batches.size()));
+    auto const batch_rows = std::make_shared<arrow::UInt32Array>(
+        length, arrow::Buffer::Wrap(m_batch_rows.data(), m_batch_rows.size()));
+
+    auto const schema = make_read_id_index_schema(metadata);
+    auto const batch = arrow::RecordBatch::Make(schema, length, {read_ids, batches, batch_rows});
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto sink,
+        arrow::io::BufferOutputStream::Create(
+            length * (sizeof(Uuid) + 2 * sizeof(std::uint32_t)), pool));
+
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return sink->Finish();
+}
+
+std::size_t ReadIdIndex::lower_bound(Uuid const & id, std::size_t first) const
+{
+    // Gallop forward from [first] to bracket the result, then binary search the bracket:
+    std::size_t low = std::min(first, size());
+    std::size_t high = low;
+    std::size_t step = 1;
+    while (high < size() && m_read_ids[high] < id) {
+        low = high + 1;
+        high = std::min(size(), high + step);
+        step *= 2;
+    }
+
+    auto const begin = m_read_ids.begin();
+    return std::lower_bound(begin + low, begin + high, id) - begin;
+}
+
+}  // namespace pod5
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+#include "pod5_format/uuid.h"
+
+#include <arrow/io/type_fwd.h>
+#include <gsl/gsl-lite.hpp>
+
+#include <memory>
+
+namespace arrow {
+class Buffer;
+class KeyValueMetadata;
+class MemoryPool;
+}  // namespace arrow
+
+namespace pod5 {
+
+class ReadTableReader;
+class ThreadPool;
+
+/// \brief Every read id in a file sorted by id, with the location of each read in the read table.
+///
+/// Written into the file as an arrow table with one batch, holding sorted "read_id",
+/// "batch" and "batch_row" columns, so it can be searched straight from a memory mapped file.
+class POD5_FORMAT_EXPORT ReadIdIndex {
+public:
+    /// \param storage      Owns the memory the other parameters point into.
+    ReadIdIndex(
+        std::shared_ptr<void const> storage,
+        gsl::span<Uuid const> read_ids,
+        gsl::span<std::uint32_t const> batches,
+        gsl::span<std::uint32_t const> batch_rows);
+
+    /// \brief Build an index by reading every read id in [reader].
+    /// \param thread_pool  Optional pool to sort batches' ids on, alongside the calling thread,
+    ///                     which reads the batches.
+    static Result<std::shared_ptr<ReadIdIndex const>> build(
+        ReadTableReader const & reader,
+        ThreadPool * thread_pool = nullptr);
+
+    /// \brief Open an index written by [write], referencing the data in [file] without copying
+    ///        where possible.
+    static Result<std::shared_ptr<ReadIdIndex const>> open(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+        arrow::MemoryPool * pool);
+
+    /// \brief Copy the index into read only memory shared with processes forked after the copy
+    ///        is made, so each child searches the parent's index rather than a copy of it.
+    Result<std::shared_ptr<ReadIdIndex const>> copy_to_shared_memory() const;
+
+    /// \brief Serialise the index as an arrow ipc file, tagged with [metadata].
+    Result<std::shared_ptr<arrow::Buffer>> write(
+        std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+        arrow::MemoryPool * pool) const;
+
+    std::size_t size() const { return m_read_ids.size(); }
+
+    gsl::span<Uuid const> read_ids() const { return m_read_ids; }
+
+    gsl::span<std::uint32_t const> batches() const { return m_batches; }
+
+    gsl::span<std::uint32_t const> batch_rows() const { return m_batch_rows; }
+
+    std::uint32_t batch(std::size_t i) const { return m_batches[i]; }
+
+    std::uint32_t batch_row(std::size_t i) const { return m_batch_rows[i]; }
+
+    /// \brief Find the first entry at or after [first] with a read id not less than [id].
+    /// \note Searches by galloping forward from [first], costing O(log distance), so walking
+    ///       a sorted list of ids through the index is fast for both sparse and dense lists.
+    std::size_t lower_bound(Uuid const & id, std::size_t first = 0) const;
+
+private:
+    std::shared_ptr<void const> m_storage;
+    gsl::span<Uuid const> m_read_ids;
+    gsl::span<std::uint32_t const> m_batches;
+    gsl::span<std::uint32_t const> m_batch_rows;
+};
+
+}  // namespace pod5
@@ -0,0 +1,599 @@
+#include "pod5_format/read_scan.h"
+
+#include "pod5_format/read_table_reader.h"
+
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_dict.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <variant>
+
+namespace pod5 {
+
+struct ReadScanPredicate::Node {
+    enum class Kind { Compare, InValues, InStrings, AllOf, AnyOf, Not };
+
+    Kind kind;
+    std::string column;
+    Comparison comparison = Comparison::Equal;
+    double value = 0;
+    std::vector<double> values;
+    std::vector<std::string> strings;
+    std::vector<ReadScanPredicate> operands;
+};
+
+namespace {
+
+using Node = ReadScanPredicate::Node;
+using Comparison = ReadScanPredicate::Comparison;
+
+//---------------------------------------------------------------------------------------------------------------------
+// Evaluation
+
+template <typename T>
+void compare_values(
+    T const * values,
+    std::size_t count,
+    Comparison comparison,
+    double value,
+    std::uint8_t * selected)
+{
+    // Each case is a simple loop over the column, which the compiler vectorises:
+    switch (comparison) {
+    case Comparison::Equal:
+        for (std::size_t i = 0; i < count; ++i) {
+            selected[i] = double(values[i]) == value;
+        }
+        break;
+    case Comparison::NotEqual:
+        for (std::size_t i = 0; i < count; ++i) {
+            selected[i] = double(values[i]) != value;
+        }
+        break;
+    case Comparison::Less:
+        for (std::size_t i = 0; i < count; ++i) {
+            selected[i] = double(values[i]) < value;
+        }
+        break;
+    case Comparison::LessEqual:
+        for (std::size_t i = 0; i < count; ++i) {
+            selected[i] = double(values[i]) <= value;
+        }
+        break;
+    case Comparison::Greater:
+        for (std::size_t i = 0; i < count; ++i) {
+            selected[i] = double(values[i]) > value;
+        }
+        break;
+    case Comparison::GreaterEqual:
+        for (std::size_t i = 0; i < count; ++i) {
+            selected[i] = double(values[i]) >= value;
+        }
+        break;
+    }
+}
+
+template <typename T>
+void values_in_set(
+    T const * values,
+    std::size_t count,
+    std::vector<double> const & wanted,
+    std::uint8_t * selected)
+{
+    std::fill(selected, selected + count, 0);
+    for (auto const value : wanted) {
+        for (std::size_t i = 0; i < count; ++i) {
+            selected[i] |= double(values[i]) == value;
+        }
+    }
+}
+
+// Run [fn] with the raw values of the numeric [array], as a typed pointer.
+template <typename Fn>
+Status visit_numeric_values(arrow::Array const & array, std::string const & column, Fn && fn)
+{
+    switch (array.type_id()) {
+    case arrow::Type::UINT8:
+        fn(static_cast<arrow::UInt8Array const &>(array).raw_values());
+        return Status::OK();
+    case arrow::Type::UINT16:
+        fn(static_cast<arrow::UInt16Array const &>(array).raw_values());
+        return Status::OK();
+    case arrow::Type::UINT32:
+        fn(static_cast<arrow::UInt32Array const &>(array).raw_values());
+        return Status::OK();
+    case arrow::Type::UINT64:
+        fn(static_cast<arrow::UInt64Array const &>(array).raw_values());
+        return Status::OK();
+    case arrow::Type::FLOAT:
+        fn(static_cast<arrow::FloatArray const &>(array).raw_values());
+        return Status::OK();
+    case arrow::Type::DOUBLE:
+        fn(static_cast<arrow::DoubleArray const &>(array).raw_values());
+        return Status::OK();
+    case arrow::Type::BOOL: {
+        auto const & booleans = static_cast<arrow::BooleanArray const &>(array);
+        std::vector<std::uint8_t> values(booleans.length());
+        for (std::int64_t i = 0; i < booleans.length(); ++i) {
+            values[i] = booleans.Value(i);
+        }
+        fn(values.data());
+        return Status::OK();
+    }
+    default:
+        return Status::TypeError(
+            "Column '", column, "' of type ", array.type()->ToString(), " is not numeric");
+    }
+}
+
+Result<std::shared_ptr<arrow::Array>> find_scan_column(
+    ReadTableRecordBatch const & batch,
+    std::string const & column)
+{
+    auto array = batch.batch()->GetColumnByName(column);
+    if (!array) {
+        return Status::Invalid("Column '", column, "' is not loaded in the read table batch");
+    }
+    return array;
+}
+
+// Rows with a null value never match a comparison or set test.
+void clear_null_rows(arrow::Array const & array, std::uint8_t * selected)
+{
+    if (array.null_count() == 0) {
+        return;
+    }
+    for (std::int64_t i = 0; i < array.length(); ++i) {
+        if (array.IsNull(i)) {
+            selected[i] = 0;
+        }
+    }
+}
+
+Status evaluate_strings_in_set(
+    Node const & node,
+    arrow::Array const & array,
+    std::uint8_t * selected)
+{
+    if (array.type_id() != arrow::Type::DICTIONARY) {
+        return Status::TypeError("Column '", node.column, "' is not a dictionary column");
+    }
+    auto const & dict_array = static_cast<arrow::DictionaryArray const &>(array);
+    auto const dictionary = std::dynamic_pointer_cast<arrow::StringArray>(dict_array.dictionary());
+    auto const indices = std::dynamic_pointer_cast<arrow::Int16Array>(dict_array.indices());
+    if (!dictionary || !indices) {
+        return Status::TypeError("Column '", node.column, "' has an unexpected dictionary type");
+    }
+
+    // Decode the dictionary once, then each row is a lookup on its index:
+    std::vector<std::uint8_t> wanted_entries(dictionary->length(), 0);
+    for (std::int64_t i = 0; i < dictionary->length(); ++i) {
+        auto const entry = dictionary->GetView(i);
+        wanted_entries[i] =
+            std::any_of(node.strings.begin(), node.strings.end(), [&](std::string const & wanted) {
+                return entry == wanted;
+            });
+    }
+
+    auto const entry_count = std::int16_t(wanted_entries.size());
+    auto const index_values = indices->raw_values();
+    for (std::int64_t i = 0; i < indices->length(); ++i) {
+        auto const index = index_values[i];
+        selected[i] = index >= 0 && index < entry_count && wanted_entries[index];
+    }
+    return Status::OK();
+}
+
+Status evaluate_node(Node const & node, ReadTableRecordBatch const & batch, std::uint8_t * selected)
+{
+    auto const row_count = batch.num_rows();
+    switch (node.kind) {
+    case Node::Kind::Compare:
+    case Node::Kind::InValues: {
+        ARROW_ASSIGN_OR_RAISE(auto array, find_scan_column(batch, node.column));
+        ARROW_RETURN_NOT_OK(visit_numeric_values(*array, node.column, [&](auto const * values) {
+            if (node.kind == Node::Kind::Compare) {
+                compare_values(values, row_count, node.comparison, node.value, selected);
+            } else {
+                values_in_set(values, row_count, node.values, selected);
+            }
+        }));
+        clear_null_rows(*array, selected);
+        return Status::OK();
+    }
+    case Node::Kind::InStrings: {
+        ARROW_ASSIGN_OR_RAISE(auto array, find_scan_column(batch, node.column));
+        ARROW_RETURN_NOT_OK(evaluate_strings_in_set(node, *array, selected));
+        clear_null_rows(*array, selected);
+        return Status::OK();
+    }
+    case Node::Kind::AllOf:
+    case Node::Kind::AnyOf: {
+        bool const all_of = node.kind == Node::Kind::AllOf;
+        std::fill(selected, selected + row_count, all_of);
+        std::vector<std::uint8_t> operand_selected;
+        for (auto const & operand : node.operands) {
+            ARROW_RETURN_NOT_OK(operand.evaluate(batch, operand_selected));
+            for (std::size_t i = 0; i < row_count; ++i) {
+                selected[i] = all_of ? (selected[i] & operand_selected[i])
+                                     : (selected[i] | operand_selected[i]);
+            }
+        }
+        return Status::OK();
+    }
+    case Node::Kind::Not: {
+        std::vector<std::uint8_t> operand_selected;
+        ARROW_RETURN_NOT_OK(node.operands.front().evaluate(batch, operand_selected));
+        for (std::size_t i = 0; i < row_count; ++i) {
+            selected[i] = !operand_selected[i];
+        }
+        return Status::OK();
+    }
+    }
+    return Status::Invalid("Unknown scan predicate");
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Parsing
+
+struct Token {
+    enum class Type { End, Identifier, Number, String, Operator };
+
+    Type type;
+    std::string text;
+    double number = 0;
+    std::size_t position = 0;
+};
+
+class ExpressionParser {
+public:
+    explicit ExpressionParser(std::string const & expression) : m_expression(expression) {}
+
+    Result<ReadScanPredicate> parse()
+    {
+        ARROW_RETURN_NOT_OK(advance());
+        ARROW_ASSIGN_OR_RAISE(auto predicate, parse_or());
+        if (m_token.type != Token::Type::End) {
+            return error("Unexpected '", m_token.text, "'");
+        }
+        return predicate;
+    }
+
+private:
+    template <typename... Args>
+    Status error(Args &&... args) const
+    {
+        return Status::Invalid(
+            "Invalid scan expression at position ",
+            m_token.position,
+            ": ",
+            std::forward<Args>(args)...);
+    }
+
+    bool is_keyword(char const * keyword) const
+    {
+        return m_token.type == Token::Type::Identifier && m_token.text == keyword;
+    }
+
+    bool is_operator(char const * op) const
+    {
+        return m_token.type == Token::Type::Operator && m_token.text == op;
+    }
+
+    Status expect_operator(char const * op)
+    {
+        if (!is_operator(op)) {
+            return error("Expected '", op, "'");
+        }
+        return advance();
+    }
+
+    // Read the next token from the expression into [m_token].
+    Status advance()
+    {
+        while (m_position < m_expression.size()
+               && std::isspace(static_cast<unsigned char>(m_expression[m_position])))
+        {
+            ++m_position;
+        }
+
+        m_token = Token{Token::Type::End, "", 0, m_position};
+        if (m_position == m_expression.size()) {
+            return Status::OK();
+        }
+
+        auto const c = m_expression[m_position];
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            auto const begin = m_position;
+            while (m_position < m_expression.size()
+                   && (std::isalnum(static_cast<unsigned char>(m_expression[m_position]))
+                       || m_expression[m_position] == '_'))
+            {
+                ++m_position;
+            }
+            m_token.type = Token::Type::Identifier;
+            m_token.text = m_expression.substr(begin, m_position - begin);
+            return Status::OK();
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '+' || c == '.') {
+            char const * begin = m_expression.c_str() + m_position;
+            char * end = nullptr;
+            m_token.number = std::strtod(begin, &end);
+            if (end == begin) {
+                return error("Invalid number");
+            }
+            m_token.type = Token::Type::Number;
+            m_token.text = std::string(begin, end);
+            m_position += end - begin;
+            return Status::OK();
+        }
+
+        if (c == '\'' || c == '"') {
+            auto const end = m_expression.find(c, m_position + 1);
+            if (end == std::string::npos) {
+                return error("Unterminated string");
+            }
+            m_token.type = Token::Type::String;
+            m_token.text = m_expression.substr(m_position + 1, end - m_position - 1);
+            m_position = end + 1;
+            return Status::OK();
+        }
+
+        for (char const * op : {"==", "!=", "<=", ">=", "<", ">", "=", "(", ")", ","}) {
+            if (m_expression.compare(m_position, std::strlen(op), op) == 0) {
+                m_token.type = Token::Type::Operator;
+                m_token.text = op;
+                m_position += std::strlen(op);
+                return Status::OK();
+            }
+        }
+        return error("Unexpected character '", c, "'");
+    }
+
+    Result<ReadScanPredicate> parse_or()
+    {
+        ARROW_ASSIGN_OR_RAISE(auto first, parse_and());
+        std::vector<ReadScanPredicate> operands{std::move(first)};
+        while (is_keyword("or")) {
+            ARROW_RETURN_NOT_OK(advance());
+            ARROW_ASSIGN_OR_RAISE(auto operand, parse_and());
+            operands.push_back(std::move(operand));
+        }
+        if (operands.size() == 1) {
+            return std::move(operands.front());
+        }
+        return ReadScanPredicate::any_of(std::move(operands));
+    }
+
+    Result<ReadScanPredicate> parse_and()
+    {
+        ARROW_ASSIGN_OR_RAISE(auto first, parse_unary());
+        std::vector<ReadScanPredicate> operands{std::move(first)};
+        while (is_keyword("and")) {
+            ARROW_RETURN_NOT_OK(advance());
+            ARROW_ASSIGN_OR_RAISE(auto operand, parse_unary());
+            operands.push_back(std::move(operand));
+        }
+        if (operands.size() == 1) {
+            return std::move(operands.front());
+        }
+        return ReadScanPredicate::all_of(std::move(operands));
+    }
+
+    Result<ReadScanPredicate> parse_unary()
+    {
+        if (is_keyword("not")) {
+            ARROW_RETURN_NOT_OK(advance());
+            ARROW_ASSIGN_OR_RAISE(auto operand, parse_unary());
+            return ReadScanPredicate::negate(std::move(operand));
+        }
+        if (is_operator("(")) {
+            ARROW_RETURN_NOT_OK(advance());
+            ARROW_ASSIGN_OR_RAISE(auto predicate, parse_or());
+            ARROW_RETURN_NOT_OK(expect_operator(")"));
+            return predicate;
+        }
+        return parse_test();
+    }
+
+    using Literal = std::variant<double, std::string>;
+
+    Result<Literal> parse_literal()
+    {
+        Literal literal;
+        if (m_token.type == Token::Type::Number) {
+            literal = m_token.number;
+        } else if (m_token.type == Token::Type::String) {
+            literal = m_token.text;
+        } else if (is_keyword("true") || is_keyword("false")) {
+            literal = is_keyword("true") ? 1.0 : 0.0;
+        } else {
+            return error("Expected a number or string");
+        }
+        ARROW_RETURN_NOT_OK(advance());
+        return literal;
+    }
+
+    // Parse "column <op> literal", "column in (...)" or "column not in (...)".
+    Result<ReadScanPredicate> parse_test()
+    {
+        if (m_token.type != Token::Type::Identifier) {
+            return error("Expected a column name");
+        }
+        auto column = m_token.text;
+        ARROW_RETURN_NOT_OK(advance());
+
+        bool negated = false;
+        if (is_keyword("not")) {
+            negated = true;
+            ARROW_RETURN_NOT_OK(advance());
+            if (!is_keyword("in")) {
+                return error("Expected 'in'");
+            }
+        }
+
+        if (is_keyword("in")) {
+            ARROW_RETURN_NOT_OK(advance());
+            ARROW_RETURN_NOT_OK(expect_operator("("));
+            std::vector<double> values;
+            std::vector<std::string> strings;
+            while (true) {
+                ARROW_ASSIGN_OR_RAISE(auto literal, parse_literal());
+                if (auto const * number = std::get_if<double>(&literal)) {
+                    values.push_back(*number);
+                } else {
+                    strings.push_back(std::get<std::string>(literal));
+                }
+                if (!is_operator(",")) {
+                    break;
+                }
+                ARROW_RETURN_NOT_OK(advance());
+            }
+            if (!values.empty() && !strings.empty()) {
+                return error("Set for '", column, "' mixes numbers and strings");
+            }
+            ARROW_RETURN_NOT_OK(expect_operator(")"));
+
+            auto predicate = strings.empty()
+                                 ? ReadScanPredicate::is_in(column, std::move(values))
+                                 : ReadScanPredicate::is_in(column, std::move(strings));
+            return negated ? ReadScanPredicate::negate(std::move(predicate)) : predicate;
+        }
+
+        std::optional<Comparison> comparison;
+        if (is_operator("==") || is_operator("=")) {
+            comparison = Comparison::Equal;
+        } else if (is_operator("!=")) {
+            comparison = Comparison::NotEqual;
+        } else if (is_operator("<")) {
+            comparison = Comparison::Less;
+        } else if (is_operator("<=")) {
+            comparison = Comparison::LessEqual;
+        } else if (is_operator(">")) {
+            comparison = Comparison::Greater;
+        } else if (is_operator(">=")) {
+            comparison = Comparison::GreaterEqual;
+        } else {
+            return error("Expected a comparison after '", column, "'");
+        }
+        ARROW_RETURN_NOT_OK(advance());
+
+        ARROW_ASSIGN_OR_RAISE(auto literal, parse_literal());
+        if (auto const * number = std::get_if<double>(&literal)) {
+            return ReadScanPredicate::compare(column, *comparison, *number);
+        }
+
+        // Dictionary columns only support equality, as a single entry set:
+        if (*comparison != Comparison::Equal && *comparison != Comparison::NotEqual) {
+            return error("Strings can only be compared with == or !=");
+        }
+        auto predicate = ReadScanPredicate::is_in(
+            column, std::vector<std::string>{std::get<std::string>(literal)});
+        if (*comparison == Comparison::NotEqual) {
+            return ReadScanPredicate::negate(std::move(predicate));
+        }
+        return predicate;
+    }
+
+    std::string const & m_expression;
+    std::size_t m_position = 0;
+    Token m_token;
+};
+
+std::shared_ptr<Node> make_node(Node::Kind kind, std::string column = {})
+{
+    auto node = std::make_shared<Node>();
+    node->kind = kind;
+    node->column = std::move(column);
+    return node;
+}
+
+}  // namespace
+
+ReadScanPredicate::ReadScanPredicate(std::shared_ptr<Node const> node) : m_node(std::move(node))
+{
+}
+
+Result<ReadScanPredicate> ReadScanPredicate::parse(std::string const & expression)
+{
+    return ExpressionParser(expression).parse();
+}
+
+ReadScanPredicate ReadScanPredicate::compare(
+    std::string column,
+    Comparison comparison,
+    double value)
+{
+    auto node = make_node(Node::Kind::Compare, std::move(column));
+    node->comparison = comparison;
+    node->value = value;
+    return ReadScanPredicate(std::move(node));
+}
+
+ReadScanPredicate ReadScanPredicate::is_in(std::string column, std::vector<double> values)
+{
+    auto node = make_node(Node::Kind::InValues, std::move(column));
+    node->values = std::move(values);
+    return ReadScanPredicate(std::move(node));
+}
+
+ReadScanPredicate ReadScanPredicate::is_in(std::string column, std::vector<std::string> values)
+{
+    auto node = make_node(Node::Kind::InStrings, std::move(column));
+    node->strings = std::move(values);
+    return ReadScanPredicate(std::move(node));
+}
+
+ReadScanPredicate ReadScanPredicate::all_of(std::vector<ReadScanPredicate> operands)
+{
+    auto node = make_node(Node::Kind::AllOf);
+    node->operands = std::move(operands);
+    return ReadScanPredicate(std::move(node));
+}
+
+ReadScanPredicate ReadScanPredicate::any_of(std::vector<ReadScanPredicate> operands)
+{
+    auto node = make_node(Node::Kind::AnyOf);
+    node->operands = std::move(operands);
+    return ReadScanPredicate(std::move(node));
+}
+
+ReadScanPredicate ReadScanPredicate::negate(ReadScanPredicate operand)
+{
+    auto node = make_node(Node::Kind::Not);
+    node->operands.push_back(std::move(operand));
+    return ReadScanPredicate(std::move(node));
+}
+
+std::vector<std::string> ReadScanPredicate::columns() const
+{
+    std::vector<std::string> result;
+    if (!m_node->column.empty()) {
+        result.push_back(m_node->column);
+    }
+    for (auto const & operand : m_node->operands) {
+        auto const operand_columns = operand.columns();
+        result.insert(result.end(), operand_columns.begin(), operand_columns.end());
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+Status ReadScanPredicate::evaluate(
+    ReadTableRecordBatch const & batch,
+    std::vector<std::uint8_t> & selected) const
+{
+    selected.resize(batch.num_rows());
+    return evaluate_node(*m_node, batch, selected.data());
+}
+
+}  // namespace pod5
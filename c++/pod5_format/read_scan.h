@@ -0,0 +1,63 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pod5 {
+
+class ReadTableRecordBatch;
+
+/// \brief A filter on read table rows, built from comparisons and set tests on read table
+///        columns joined with and, or and not.
+///
+/// Numeric columns compare against numbers, dictionary columns (pore_type, end_reason and
+/// run_info) compare against their decoded string values. Predicates are evaluated a column at a
+/// time over whole batches.
+class POD5_FORMAT_EXPORT ReadScanPredicate {
+public:
+    enum class Comparison { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+    /// \brief Parse an expression, for example
+    ///        "channel < 100 and end_reason in ('signal_positive', 'unblock_mux_change')".
+    ///
+    /// Supports the comparisons ==, !=, <, <=, > and >=, the set tests "in (...)" and
+    /// "not in (...)", and "and", "or", "not" and parentheses. Strings are quoted with ' or ",
+    /// true and false compare as 1 and 0.
+    static Result<ReadScanPredicate> parse(std::string const & expression);
+
+    /// \brief Match rows where the numeric [column] compares to [value] as [comparison].
+    static ReadScanPredicate compare(std::string column, Comparison comparison, double value);
+    /// \brief Match rows where the numeric [column] equals one of [values].
+    static ReadScanPredicate is_in(std::string column, std::vector<double> values);
+    /// \brief Match rows where the dictionary [column] decodes to one of [values].
+    static ReadScanPredicate is_in(std::string column, std::vector<std::string> values);
+    /// \brief Match rows matching every one of [operands], or every row if there are none.
+    static ReadScanPredicate all_of(std::vector<ReadScanPredicate> operands);
+    /// \brief Match rows matching any of [operands], or no rows if there are none.
+    static ReadScanPredicate any_of(std::vector<ReadScanPredicate> operands);
+    /// \brief Match rows which don't match [operand].
+    static ReadScanPredicate negate(ReadScanPredicate operand);
+
+    /// \brief Find the sorted, distinct names of the columns the predicate reads.
+    std::vector<std::string> columns() const;
+
+    /// \brief Evaluate the predicate for every row of [batch].
+    /// \param[out] selected Resized to the batch row count, set to 1 for matching rows and 0
+    ///                      otherwise.
+    Status evaluate(ReadTableRecordBatch const & batch, std::vector<std::uint8_t> & selected)
+        const;
+
+    struct Node;
+
+private:
+    explicit ReadScanPredicate(std::shared_ptr<Node const> node);
+
+    std::shared_ptr<Node const> m_node;
+};
+
+}  // namespace pod5
@@ -0,0 +1,843 @@
+#include "pod5_format/read_table_export.h"
+
+#include "pod5_format/file_reader.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid_format.h"
+
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_dict.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/array/builder_binary.h>
+#include <arrow/array/builder_primitive.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace pod5 {
+
+namespace {
+
+constexpr std::size_t FIELD_COUNT = std::size_t(ReadTableExportField::pore_type) + 1;
+
+std::array<char const *, FIELD_COUNT> const FIELD_NAMES{
+    "read_id",
+    "filename",
+    "read_number",
+    "channel",
+    "mux",
+    "end_reason",
+    "start_time",
+    "start_sample",
+    "duration",
+    "num_samples",
+    "minknow_events",
+    "sample_rate",
+    "median_before",
+    "predicted_scaling_scale",
+    "predicted_scaling_shift",
+    "tracked_scaling_scale",
+    "tracked_scaling_shift",
+    "num_reads_since_mux_change",
+    "time_since_mux_change",
+    "run_id",
+    "sample_id",
+    "experiment_id",
+    "flow_cell_id",
+    "pore_type",
+};
+
+char const * const NOT_SET = "not_set";
+
+// Find the read table columns [field] is exported from.
+std::vector<std::string> source_columns(ReadTableExportField field)
+{
+    switch (field) {
+    case ReadTableExportField::read_id:
+        return {"read_id"};
+    case ReadTableExportField::filename:
+        return {};
+    case ReadTableExportField::read_number:
+        return {"read_number"};
+    case ReadTableExportField::channel:
+        return {"channel"};
+    case ReadTableExportField::mux:
+        return {"well"};
+    case ReadTableExportField::end_reason:
+        return {"end_reason"};
+    case ReadTableExportField::start_time:
+        return {"start", "run_info"};
+    case ReadTableExportField::start_sample:
+        return {"start"};
+    case ReadTableExportField::duration:
+        return {"num_samples", "run_info"};
+    case ReadTableExportField::num_samples:
+        return {"num_samples"};
+    case ReadTableExportField::minknow_events:
+        return {"num_minknow_events"};
+    case ReadTableExportField::median_before:
+        return {"median_before"};
+    case ReadTableExportField::predicted_scaling_scale:
+        return {"predicted_scaling_scale"};
+    case ReadTableExportField::predicted_scaling_shift:
+        return {"predicted_scaling_shift"};
+    case ReadTableExportField::tracked_scaling_scale:
+        return {"tracked_scaling_scale"};
+    case ReadTableExportField::tracked_scaling_shift:
+        return {"tracked_scaling_shift"};
+    case ReadTableExportField::num_reads_since_mux_change:
+        return {"num_reads_since_mux_change"};
+    case ReadTableExportField::time_since_mux_change:
+        return {"time_since_mux_change"};
+    case ReadTableExportField::sample_rate:
+    case ReadTableExportField::run_id:
+    case ReadTableExportField::sample_id:
+    case ReadTableExportField::experiment_id:
+    case ReadTableExportField::flow_cell_id:
+        return {"run_info"};
+    case ReadTableExportField::pore_type:
+        return {"pore_type"};
+    }
+    return {};
+}
+
+std::shared_ptr<arrow::DataType> field_type(ReadTableExportField field)
+{
+    switch (field) {
+    case ReadTableExportField::read_number:
+    case ReadTableExportField::num_reads_since_mux_change:
+        return arrow::uint32();
+    case ReadTableExportField::channel:
+    case ReadTableExportField::sample_rate:
+        return arrow::uint16();
+    case ReadTableExportField::mux:
+        return arrow::uint8();
+    case ReadTableExportField::start_time:
+    case ReadTableExportField::duration:
+        return arrow::float64();
+    case ReadTableExportField::start_sample:
+    case ReadTableExportField::num_samples:
+    case ReadTableExportField::minknow_events:
+        return arrow::uint64();
+    case ReadTableExportField::median_before:
+    case ReadTableExportField::predicted_scaling_scale:
+    case ReadTableExportField::predicted_scaling_shift:
+    case ReadTableExportField::tracked_scaling_scale:
+    case ReadTableExportField::tracked_scaling_shift:
+    case ReadTableExportField::time_since_mux_change:
+        return arrow::float32();
+    default:
+        return arrow::utf8();
+    }
+}
+
+// Check the dictionary indices of [column] are in range, returning its decoded entries.
+template <typename Entry, typename Decode>
+Result<std::vector<Entry>> decode_dictionary(
+    std::shared_ptr<arrow::DictionaryArray> const & column,
+    char const * name,
+    Decode && decode)
+{
+    if (!column) {
+        return Status::Invalid("Read table batch is missing column '", name, "'");
+    }
+    auto const dictionary = std::dynamic_pointer_cast<arrow::StringArray>(column->dictionary());
+    auto const indices = std::dynamic_pointer_cast<arrow::Int16Array>(column->indices());
+    if (!dictionary || !indices) {
+        return Status::TypeError("Column '", name, "' has an unexpected dictionary type");
+    }
+    for (std::int64_t row = 0; row < indices->length(); ++row) {
+        auto const index = indices->Value(row);
+        if (indices->IsValid(row) && (index < 0 || index >= dictionary->length())) {
+            return Status::Invalid("Read table ", name, " index ", index, " is out of range");
+        }
+    }
+
+    std::vector<Entry> entries;
+    entries.reserve(dictionary->length());
+    for (std::int64_t i = 0; i < dictionary->length(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto entry, decode(dictionary->GetView(i)));
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+// A read table batch with its dictionary columns decoded, so every field is a lookup per row.
+struct DecodedBatch {
+    std::int64_t row_count = 0;
+    std::string const * filename = nullptr;
+    ReadTableRecordColumns columns;
+
+    std::vector<std::string_view> end_reasons;
+    std::vector<std::string_view> pore_types;
+    std::vector<RunInfoData const *> run_infos;
+
+    std::string_view end_reason(std::int64_t row) const
+    {
+        auto const & indices = *columns.end_reason->indices();
+        return indices.IsValid(row) ? end_reasons[index(indices, row)] : std::string_view{};
+    }
+
+    std::string_view pore_type(std::int64_t row) const
+    {
+        auto const & indices = *columns.pore_type->indices();
+        return indices.IsValid(row) ? pore_types[index(indices, row)] : std::string_view{};
+    }
+
+    RunInfoData const * run_info(std::int64_t row) const
+    {
+        auto const & indices = *columns.run_info->indices();
+        return indices.IsValid(row) ? run_infos[index(indices, row)] : nullptr;
+    }
+
+    static std::int16_t index(arrow::Array const & indices, std::int64_t row)
+    {
+        return static_cast<arrow::Int16Array const &>(indices).Value(row);
+    }
+};
+
+// Find the exported value of a run info string, which is "not_set" when empty.
+std::string_view run_info_string(RunInfoData const * run_info, ReadTableExportField field)
+{
+    if (!run_info) {
+        return {};
+    }
+
+    std::string const * value = nullptr;
+    switch (field) {
+    case ReadTableExportField::run_id:
+        value = &run_info->protocol_run_id;
+        break;
+    case ReadTableExportField::sample_id:
+        value = &run_info->sample_id;
+        break;
+    case ReadTableExportField::experiment_id:
+        value = &run_info->experiment_name;
+        break;
+    default:
+        value = &run_info->flow_cell_id;
+        break;
+    }
+    return value->empty() ? std::string_view{NOT_SET} : std::string_view{*value};
+}
+
+// Find the seconds [samples] take at the sample rate of [run_info], null without a run info.
+std::optional<double> samples_to_seconds(std::uint64_t samples, RunInfoData const * run_info)
+{
+    if (!run_info) {
+        return std::nullopt;
+    }
+    return double(samples) / double(run_info->sample_rate);
+}
+
+// Append [value] to a delimited line, quoting it if it holds the separator, a quote or a
+// newline.
+void append_text(std::string & out, std::string_view value, std::string const & separator)
+{
+    if (value.find(separator) == std::string_view::npos
+        && value.find_first_of("\"\r\n") == std::string_view::npos)
+    {
+        out.append(value);
+        return;
+    }
+
+    out.push_back('"');
+    for (auto c : value) {
+        if (c == '"') {
+            out.push_back('"');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+template <typename T>
+void append_integer(std::string & out, T value)
+{
+    char buffer[24];
+    auto const result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Floats are written with 8 decimal places, as `pod5 view` has always written them.
+void append_float(std::string & out, double value)
+{
+    char buffer[352];
+    auto const length = std::snprintf(buffer, sizeof(buffer), "%.8f", value);
+    out.append(buffer, std::size_t(std::max(length, 0)));
+}
+
+template <typename ArrayType>
+void append_column_value(
+    std::string & out,
+    std::shared_ptr<ArrayType> const & column,
+    std::int64_t row)
+{
+    if (!column || column->IsNull(row)) {
+        return;
+    }
+    if constexpr (std::is_same_v<ArrayType, arrow::FloatArray>) {
+        append_float(out, column->Value(row));
+    } else {
+        append_integer(out, column->Value(row));
+    }
+}
+
+void append_field_text(
+    std::string & out,
+    DecodedBatch const & batch,
+    ReadTableExportField field,
+    std::int64_t row,
+    std::string const & separator)
+{
+    auto const & columns = batch.columns;
+    switch (field) {
+    case ReadTableExportField::read_id: {
+        char read_id[UUID_STRING_LENGTH];
+        format_uuids(gsl::make_span(columns.read_id->raw_values() + row, 1), read_id);
+        out.append(read_id, sizeof(read_id));
+        break;
+    }
+    case ReadTableExportField::filename:
+        append_text(out, *batch.filename, separator);
+        break;
+    case ReadTableExportField::read_number:
+        append_column_value(out, columns.read_number, row);
+        break;
+    case ReadTableExportField::channel:
+        append_column_value(out, columns.channel, row);
+        break;
+    case ReadTableExportField::mux:
+        append_column_value(out, columns.well, row);
+        break;
+    case ReadTableExportField::end_reason:
+        append_text(out, batch.end_reason(row), separator);
+        break;
+    case ReadTableExportField::start_time:
+        if (auto const seconds =
+                samples_to_seconds(columns.start_sample->Value(row), batch.run_info(row)))
+        {
+            append_float(out, *seconds);
+        }
+        break;
+    case ReadTableExportField::start_sample:
+        append_column_value(out, columns.start_sample, row);
+        break;
+    case ReadTableExportField::duration:
+        if (auto const seconds =
+                samples_to_seconds(columns.num_samples->Value(row), batch.run_info(row)))
+        {
+            append_float(out, *seconds);
+        }
+        break;
+    case ReadTableExportField::num_samples:
+        append_column_value(out, columns.num_samples, row);
+        break;
+    case ReadTableExportField::minknow_events:
+        append_column_value(out, columns.num_minknow_events, row);
+        break;
+    case ReadTableExportField::sample_rate:
+        if (auto const run_info = batch.run_info(row)) {
+            append_integer(out, run_info->sample_rate);
+        }
+        break;
+    case ReadTableExportField::median_before:
+        append_column_value(out, columns.median_before, row);
+        break;
+    case ReadTableExportField::predicted_scaling_scale:
+        append_column_value(out, columns.predicted_scaling_scale, row);
+        break;
+    case ReadTableExportField::predicted_scaling_shift:
+        append_column_value(out, columns.predicted_scaling_shift, row);
+        break;
+    case ReadTableExportField::tracked_scaling_scale:
+        append_column_value(out, columns.tracked_scaling_scale, row);
+        break;
+    case ReadTableExportField::tracked_scaling_shift:
+        append_column_value(out, columns.tracked_scaling_shift, row);
+        break;
+    case ReadTableExportField::num_reads_since_mux_change:
+        append_column_value(out, columns.num_reads_since_mux_change, row);
+        break;
+    case ReadTableExportField::time_since_mux_change:
+        append_column_value(out, columns.time_since_mux_change, row);
+        break;
+    case ReadTableExportField::run_id:
+    case ReadTableExportField::sample_id:
+    case ReadTableExportField::experiment_id:
+    case ReadTableExportField::flow_cell_id:
+        append_text(out, run_info_string(batch.run_info(row), field), separator);
+        break;
+    case ReadTableExportField::pore_type:
+        append_text(out, batch.pore_type(row), separator);
+        break;
+    }
+}
+
+Result<std::shared_ptr<arrow::Array>> build_string_array(
+    DecodedBatch const & batch,
+    std::int64_t value_length_estimate,
+    arrow::MemoryPool * pool,
+    std::function<std::optional<std::string_view>(std::int64_t row)> const & value)
+{
+    arrow::StringBuilder builder(pool);
+    ARROW_RETURN_NOT_OK(builder.Reserve(batch.row_count));
+    ARROW_RETURN_NOT_OK(builder.ReserveData(batch.row_count * value_length_estimate));
+    for (std::int64_t row = 0; row < batch.row_count; ++row) {
+        if (auto const row_value = value(row)) {
+            ARROW_RETURN_NOT_OK(builder.Append(*row_value));
+        } else {
+            ARROW_RETURN_NOT_OK(builder.AppendNull());
+        }
+    }
+    return builder.Finish();
+}
+
+Result<std::shared_ptr<arrow::Array>> build_seconds_array(
+    DecodedBatch const & batch,
+    arrow::UInt64Array const & samples,
+    arrow::MemoryPool * pool)
+{
+    arrow::DoubleBuilder builder(pool);
+    ARROW_RETURN_NOT_OK(builder.Reserve(batch.row_count));
+    for (std::int64_t row = 0; row < batch.row_count; ++row) {
+        if (auto const seconds = samples_to_seconds(samples.Value(row), batch.run_info(row))) {
+            builder.UnsafeAppend(*seconds);
+        } else {
+            builder.UnsafeAppendNull();
+        }
+    }
+    return builder.Finish();
+}
+
+// Build the column of [field], sharing the read table's column where it is exported unchanged.
+Result<std::shared_ptr<arrow::Array>> build_field_array(
+    DecodedBatch const & batch,
+    ReadTableExportField field,
+    arrow::MemoryPool * pool)
+{
+    auto const & columns = batch.columns;
+    switch (field) {
+    case ReadTableExportField::read_id: {
+        // Format the whole column at once, then copy each id into the array:
+        std::vector<char> read_ids(std::size_t(batch.row_count) * UUID_STRING_LENGTH);
+        format_uuids(
+            gsl::make_span(columns.read_id->raw_values(), std::size_t(batch.row_count)),
+            read_ids.data());
+        return build_string_array(batch, UUID_STRING_LENGTH, pool, [&](std::int64_t row) {
+            return std::string_view{
+                read_ids.data() + row * UUID_STRING_LENGTH, UUID_STRING_LENGTH};
+        });
+    }
+    case ReadTableExportField::filename:
+        return build_string_array(
+            batch, std::int64_t(batch.filename->size()), pool, [&](std::int64_t) {
+                return std::string_view{*batch.filename};
+            });
+    case ReadTableExportField::read_number:
+        return columns.read_number;
+    case ReadTableExportField::channel:
+        return columns.channel;
+    case ReadTableExportField::mux:
+        return columns.well;
+    case ReadTableExportField::end_reason:
+        return build_string_array(batch, 16, pool, [&](std::int64_t row) {
+            return std::optional<std::string_view>{batch.end_reason(row)};
+        });
+    case ReadTableExportField::start_time:
+        return build_seconds_array(batch, *columns.start_sample, pool);
+    case ReadTableExportField::start_sample:
+        return columns.start_sample;
+    case ReadTableExportField::duration:
+        return build_seconds_array(batch, *columns.num_samples, pool);
+    case ReadTableExportField::num_samples:
+        return columns.num_samples;
+    case ReadTableExportField::minknow_events:
+        return columns.num_minknow_events;
+    case ReadTableExportField::sample_rate: {
+        arrow::UInt16Builder builder(pool);
+        ARROW_RETURN_NOT_OK(builder.Reserve(batch.row_count));
+        for (std::int64_t row = 0; row < batch.row_count; ++row) {
+            if (auto const run_info = batch.run_info(row)) {
+                builder.UnsafeAppend(run_info->sample_rate);
+            } else {
+                builder.UnsafeAppendNull();
+            }
+        }
+        return builder.Finish();
+    }
+    case ReadTableExportField::median_before:
+        return columns.median_before;
+    case ReadTableExportField::predicted_scaling_scale:
+        return columns.predicted_scaling_scale;
+    case ReadTableExportField::predicted_scaling_shift:
+        return columns.predicted_scaling_shift;
+    case ReadTableExportField::tracked_scaling_scale:
+        return columns.tracked_scaling_scale;
+    case ReadTableExportField::tracked_scaling_shift:
+        return columns.tracked_scaling_shift;
+    case ReadTableExportField::num_reads_since_mux_change:
+        return columns.num_reads_since_mux_change;
+    case ReadTableExportField::time_since_mux_change:
+        return columns.time_since_mux_change;
+    case ReadTableExportField::run_id:
+    case ReadTableExportField::sample_id:
+    case ReadTableExportField::experiment_id:
+    case ReadTableExportField::flow_cell_id:
+        return build_string_array(
+            batch, 36, pool, [&](std::int64_t row) -> std::optional<std::string_view> {
+                auto const run_info = batch.run_info(row);
+                if (!run_info) {
+                    return std::nullopt;
+                }
+                return run_info_string(run_info, field);
+            });
+    case ReadTableExportField::pore_type:
+        return build_string_array(batch, 16, pool, [&](std::int64_t row) {
+            return std::optional<std::string_view>{batch.pore_type(row)};
+        });
+    }
+    return Status::Invalid("Unknown export field ", int(field));
+}
+
+// Check the columns [fields] are exported from were loaded, as migrated or projected batches may
+// lack them.
+Status check_field_columns(
+    ReadTableRecordColumns const & columns,
+    std::vector<ReadTableExportField> const & fields)
+{
+    std::vector<std::pair<char const *, bool>> loaded{
+        {"read_id", bool(columns.read_id)},
+        {"read_number", bool(columns.read_number)},
+        {"channel", bool(columns.channel)},
+        {"well", bool(columns.well)},
+        {"end_reason", bool(columns.end_reason)},
+        {"start", bool(columns.start_sample)},
+        {"num_samples", bool(columns.num_samples)},
+        {"num_minknow_events", bool(columns.num_minknow_events)},
+        {"median_before", bool(columns.median_before)},
+        {"predicted_scaling_scale", bool(columns.predicted_scaling_scale)},
+        {"predicted_scaling_shift", bool(columns.predicted_scaling_shift)},
+        {"tracked_scaling_scale", bool(columns.tracked_scaling_scale)},
+        {"tracked_scaling_shift", bool(columns.tracked_scaling_shift)},
+        {"num_reads_since_mux_change", bool(columns.num_reads_since_mux_change)},
+        {"time_since_mux_change", bool(columns.time_since_mux_change)},
+        {"run_info", bool(columns.run_info)},
+        {"pore_type", bool(columns.pore_type)},
+    };
+    for (auto field : fields) {
+        for (auto const & column : source_columns(field)) {
+            auto const it = std::find_if(loaded.begin(), loaded.end(), [&](auto const & entry) {
+                return column == entry.first;
+            });
+            if (it != loaded.end() && !it->second) {
+                return Status::Invalid("Read table batch is missing column '", column, "'");
+            }
+        }
+    }
+    return Status::OK();
+}
+
+}  // namespace
+
+std::vector<std::string> const & read_table_export_field_names()
+{
+    static std::vector<std::string> const names(FIELD_NAMES.begin(), FIELD_NAMES.end());
+    return names;
+}
+
+Result<ReadTableExportField> find_read_table_export_field(std::string const & name)
+{
+    auto const it = std::find(FIELD_NAMES.begin(), FIELD_NAMES.end(), name);
+    if (it == FIELD_NAMES.end()) {
+        return Status::Invalid("Unknown export field '", name, "'");
+    }
+    return ReadTableExportField(it - FIELD_NAMES.begin());
+}
+
+struct ReadTableExporter::FileContext {
+    std::shared_ptr<FileReader> reader;
+    std::string filename;
+    std::shared_ptr<ReadTableProjection const> projection;
+    std::unordered_map<std::string, std::shared_ptr<RunInfoData const>> run_infos;
+};
+
+struct ReadTableExporter::ExportedBatch {
+    std::int64_t row_count = 0;
+    // Tsv lines, or the batch of Arrow output:
+    std::string text;
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+};
+
+ReadTableExporter::ReadTableExporter(
+    std::shared_ptr<arrow::io::OutputStream> && output,
+    ReadTableExportOptions const & options,
+    std::shared_ptr<ThreadPool> && thread_pool,
+    arrow::MemoryPool * pool)
+: m_output(std::move(output))
+, m_options(options)
+, m_thread_pool(std::move(thread_pool))
+, m_pool(pool)
+, m_max_batches_in_flight(options.max_batches_in_flight)
+{
+}
+
+ReadTableExporter::~ReadTableExporter()
+{
+    // Queued batches refer to the exporter, so must finish before it is destroyed:
+    for (auto & pending : m_pending_batches) {
+        pending.Wait();
+    }
+}
+
+Result<std::unique_ptr<ReadTableExporter>> ReadTableExporter::create(
+    std::shared_ptr<arrow::io::OutputStream> output,
+    ReadTableExportOptions const & options,
+    std::shared_ptr<ThreadPool> thread_pool,
+    arrow::MemoryPool * pool)
+{
+    if (!output) {
+        return Status::Invalid("Export needs an output stream");
+    }
+    if (options.max_batches_in_flight == 0) {
+        return Status::Invalid("Export needs at least one batch in flight");
+    }
+
+    std::unique_ptr<ReadTableExporter> exporter(
+        new ReadTableExporter(std::move(output), options, std::move(thread_pool), pool));
+    auto & fields = exporter->m_options.fields;
+    if (fields.empty()) {
+        for (std::size_t i = 0; i < FIELD_COUNT; ++i) {
+            fields.push_back(ReadTableExportField(i));
+        }
+    }
+    std::sort(fields.begin(), fields.end());
+    fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+    if (std::size_t(fields.back()) >= FIELD_COUNT) {
+        return Status::Invalid("Unknown export field ", int(fields.back()));
+    }
+
+    arrow::FieldVector schema_fields;
+    for (auto field : fields) {
+        schema_fields.push_back(arrow::field(FIELD_NAMES[std::size_t(field)], field_type(field)));
+    }
+    exporter->m_schema = arrow::schema(schema_fields);
+
+    if (options.format == ReadTableExportFormat::Arrow) {
+        auto write_options = arrow::ipc::IpcWriteOptions::Defaults();
+        write_options.memory_pool = pool;
+        ARROW_ASSIGN_OR_RAISE(
+            exporter->m_arrow_writer,
+            arrow::ipc::MakeStreamWriter(
+                exporter->m_output, exporter->m_schema, write_options));
+    } else if (options.header) {
+        std::string header;
+        for (auto field : fields) {
+            if (!header.empty()) {
+                header += options.separator;
+            }
+            header += FIELD_NAMES[std::size_t(field)];
+        }
+        header += "\n";
+        ARROW_RETURN_NOT_OK(exporter->m_output->Write(header.data(), header.size()));
+    }
+
+    return exporter;
+}
+
+Status ReadTableExporter::add_file(
+    std::shared_ptr<FileReader> const & reader,
+    std::string const & filename)
+{
+    if (m_closed) {
+        return Status::Invalid("Export is already closed");
+    }
+
+    auto file = std::make_shared<FileContext>();
+    file->reader = reader;
+    file->filename = filename;
+
+    // Reads are joined to their run info by acquisition id, which must pick one run info:
+    ARROW_ASSIGN_OR_RAISE(auto const run_info_count, reader->get_run_info_count());
+    for (std::size_t i = 0; i < run_info_count; ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto run_info, reader->get_run_info(i));
+        auto const inserted = file->run_infos.emplace(run_info->acquisition_id, run_info);
+        auto const & existing = *inserted.first->second;
+        if (!inserted.second
+            && (existing.protocol_run_id != run_info->protocol_run_id
+                || existing.sample_id != run_info->sample_id
+                || existing.experiment_name != run_info->experiment_name
+                || existing.flow_cell_id != run_info->flow_cell_id
+                || existing.sample_rate != run_info->sample_rate))
+        {
+            return Status::Invalid(
+                "Found non-unique run_info acquisition_id in ",
+                filename,
+                ": ",
+                run_info->acquisition_id);
+        }
+    }
+
+    // Only the columns of the exported fields are read, never the signal:
+    std::vector<std::string> columns;
+    for (auto field : m_options.fields) {
+        auto const field_columns = source_columns(field);
+        columns.insert(columns.end(), field_columns.begin(), field_columns.end());
+    }
+    if (columns.empty()) {
+        // Filenames need a row count, so load the smallest fixed size column:
+        columns.push_back("well");
+    }
+    ARROW_ASSIGN_OR_RAISE(file->projection, reader->make_read_table_projection(columns));
+
+    std::shared_ptr<FileContext const> const context = std::move(file);
+    for (std::size_t i = 0; i < reader->num_read_record_batches(); ++i) {
+        while (m_pending_batches.size() >= m_max_batches_in_flight) {
+            ARROW_RETURN_NOT_OK(write_next_batch());
+        }
+
+        auto pending = PendingBatch::Make();
+        auto export_task = [this, pending, context, i]() mutable {
+            pending.MarkFinished(export_batch(*context, i, m_options, m_schema, m_pool));
+        };
+        if (!m_thread_pool) {
+            export_task();
+        } else {
+            try {
+                m_thread_pool->post(std::move(export_task));
+            } catch (std::exception const & e) {
+                // The pool throws once stopped:
+                return Status::Invalid("Failed to queue export: ", e.what());
+            }
+        }
+        m_pending_batches.push_back(std::move(pending));
+    }
+    return Status::OK();
+}
+
+Status ReadTableExporter::close()
+{
+    if (m_closed) {
+        return Status::OK();
+    }
+
+    while (!m_pending_batches.empty()) {
+        ARROW_RETURN_NOT_OK(write_next_batch());
+    }
+    if (m_arrow_writer) {
+        ARROW_RETURN_NOT_OK(m_arrow_writer->Close());
+    }
+    m_closed = true;
+    return m_output->Flush();
+}
+
+Result<std::shared_ptr<ReadTableExporter::ExportedBatch const>> ReadTableExporter::export_batch(
+    FileContext const & file,
+    std::size_t batch_index,
+    ReadTableExportOptions const & options,
+    std::shared_ptr<arrow::Schema> const & schema,
+    arrow::MemoryPool * pool)
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto const read_batch, file.reader->read_read_record_batch(batch_index, *file.projection));
+
+    DecodedBatch batch;
+    batch.row_count = read_batch.num_rows();
+    batch.filename = &file.filename;
+    ARROW_ASSIGN_OR_RAISE(batch.columns, read_batch.columns());
+    ARROW_RETURN_NOT_OK(check_field_columns(batch.columns, options.fields));
+
+    // Each dictionary is decoded once for the batch, rather than once per row:
+    auto const uses_column = [&](char const * column) {
+        return std::any_of(options.fields.begin(), options.fields.end(), [&](auto field) {
+            auto const field_columns = source_columns(field);
+            return std::find(field_columns.begin(), field_columns.end(), column)
+                   != field_columns.end();
+        });
+    };
+    auto const as_view = [](std::string_view entry) -> Result<std::string_view> { return entry; };
+    if (uses_column("end_reason")) {
+        ARROW_ASSIGN_OR_RAISE(
+            batch.end_reasons,
+            decode_dictionary<std::string_view>(batch.columns.end_reason, "end_reason", as_view));
+    }
+    if (uses_column("pore_type")) {
+        ARROW_ASSIGN_OR_RAISE(
+            batch.pore_types,
+            decode_dictionary<std::string_view>(batch.columns.pore_type, "pore_type", as_view));
+    }
+    if (uses_column("run_info")) {
+        ARROW_ASSIGN_OR_RAISE(
+            batch.run_infos,
+            decode_dictionary<RunInfoData const *>(
+                batch.columns.run_info,
+                "run_info",
+                [&](std::string_view acquisition_id) -> Result<RunInfoData const *> {
+                    auto const it = file.run_infos.find(std::string{acquisition_id});
+                    if (it == file.run_infos.end()) {
+                        return Status::Invalid(
+                            "Read table run info '",
+                            acquisition_id,
+                            "' is not in the run info table of ",
+                            file.filename);
+                    }
+                    return it->second.get();
+                }));
+    }
+
+    auto exported = std::make_shared<ExportedBatch>();
+    exported->row_count = batch.row_count;
+    if (options.format == ReadTableExportFormat::Arrow) {
+        std::vector<std::shared_ptr<arrow::Array>> arrays;
+        arrays.reserve(options.fields.size());
+        for (auto field : options.fields) {
+            ARROW_ASSIGN_OR_RAISE(auto array, build_field_array(batch, field, pool));
+            arrays.push_back(std::move(array));
+        }
+        exported->record_batch = arrow::RecordBatch::Make(schema, batch.row_count, arrays);
+        return exported;
+    }
+
+    auto & text = exported->text;
+    text.reserve(std::size_t(batch.row_count) * options.fields.size() * 12);
+    for (std::int64_t row = 0; row < batch.row_count; ++row) {
+        for (std::size_t i = 0; i < options.fields.size(); ++i) {
+            if (i != 0) {
+                text += options.separator;
+            }
+            append_field_text(text, batch, options.fields[i], row, options.separator);
+        }
+        text += '\n';
+    }
+    return exported;
+}
+
+Status ReadTableExporter::write_next_batch()
+{
+    auto pending = std::move(m_pending_batches.front());
+    m_pending_batches.pop_front();
+
+    ARROW_ASSIGN_OR_RAISE(auto const batch, pending.result());
+    if (m_arrow_writer) {
+        ARROW_RETURN_NOT_OK(m_arrow_writer->WriteRecordBatch(*batch->record_batch));
+    } else {
+        ARROW_RETURN_NOT_OK(m_output->Write(batch->text.data(), batch->text.size()));
+    }
+    m_reads_written += batch->row_count;
+    return Status::OK();
+}
+
+}  // namespace pod5
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <arrow/io/type_fwd.h>
+#include <arrow/util/future.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace arrow {
+class MemoryPool;
+class Schema;
+
+namespace ipc {
+class RecordBatchWriter;
+}
+}  // namespace arrow
+
+namespace pod5 {
+
+class FileReader;
+class ThreadPool;
+
+/// \brief A column of a read table export, as listed by `pod5 view`, in output order.
+enum class ReadTableExportField : std::uint8_t {
+    read_id,
+    filename,
+    read_number,
+    channel,
+    mux,
+    end_reason,
+    start_time,
+    start_sample,
+    duration,
+    num_samples,
+    minknow_events,
+    sample_rate,
+    median_before,
+    predicted_scaling_scale,
+    predicted_scaling_shift,
+    tracked_scaling_scale,
+    tracked_scaling_shift,
+    num_reads_since_mux_change,
+    time_since_mux_change,
+    run_id,
+    sample_id,
+    experiment_id,
+    flow_cell_id,
+    pore_type,
+};
+
+/// \brief Find the names of every export field, in output order.
+POD5_FORMAT_EXPORT std::vector<std::string> const & read_table_export_field_names();
+
+/// \brief Find the export field named [name].
+/// \returns Invalid if [name] isn't an export field.
+POD5_FORMAT_EXPORT Result<ReadTableExportField> find_read_table_export_field(
+    std::string const & name);
+
+enum class ReadTableExportFormat : std::uint8_t {
+    /// Delimited text, one line per read.
+    Tsv,
+    /// An arrow ipc stream, one record batch per read table batch.
+    Arrow,
+};
+
+struct POD5_FORMAT_EXPORT ReadTableExportOptions {
+    /// Columns to export, written in ReadTableExportField order whatever order they are listed
+    /// in. Every field is exported if empty.
+    std::vector<ReadTableExportField> fields;
+    ReadTableExportFormat format = ReadTableExportFormat::Tsv;
+    /// Text between the values of each line of Tsv output.
+    std::string separator = "\t";
+    /// Start Tsv output with a line of field names.
+    bool header = true;
+    /// The most read table batches exported ahead of the one being written, bounding memory
+    /// use. More than the thread pool's worker count keeps every worker busy.
+    std::size_t max_batches_in_flight = 16;
+};
+
+/// \brief Export the read table columns listed by `pod5 view` from a series of files into one
+///        output stream.
+///
+/// Batches are read and formatted on a thread pool, a bounded number at a time, and written in
+/// order. Dictionary columns are decoded once per batch, and run info columns once per file, so
+/// each row is a lookup. Empty run info strings are exported as "not_set".
+class POD5_FORMAT_EXPORT ReadTableExporter {
+public:
+    ~ReadTableExporter();
+
+    /// \brief Make an exporter writing to [output], writing the Tsv header or Arrow schema now.
+    /// \param thread_pool Runs the export of each batch. Batches run on the caller if null.
+    static Result<std::unique_ptr<ReadTableExporter>> create(
+        std::shared_ptr<arrow::io::OutputStream> output,
+        ReadTableExportOptions const & options,
+        std::shared_ptr<ThreadPool> thread_pool,
+        arrow::MemoryPool * pool);
+
+    /// \brief Queue the reads of [reader] for export, labelled with [filename], waiting for
+    ///        earlier batches to be written while too many are in flight.
+    /// \returns Invalid if the file has distinct run infos with the same acquisition id, or the
+    ///          error of any batch written meanwhile.
+    Status add_file(std::shared_ptr<FileReader> const & reader, std::string const & filename);
+
+    /// \brief Write every queued batch, then end the Arrow stream and flush the output.
+    Status close();
+
+    /// \brief Find the number of reads written so far.
+    std::uint64_t reads_written() const { return m_reads_written; }
+
+private:
+    struct ExportedBatch;
+    struct FileContext;
+    using PendingBatch = arrow::Future<std::shared_ptr<ExportedBatch const>>;
+
+    ReadTableExporter(
+        std::shared_ptr<arrow::io::OutputStream> && output,
+        ReadTableExportOptions const & options,
+        std::shared_ptr<ThreadPool> && thread_pool,
+        arrow::MemoryPool * pool);
+
+    static Result<std::shared_ptr<ExportedBatch const>> export_batch(
+        FileContext const & file,
+        std::size_t batch_index,
+        ReadTableExportOptions const & options,
+        std::shared_ptr<arrow::Schema> const & schema,
+        arrow::MemoryPool * pool);
+
+    Status write_next_batch();
+
+    std::shared_ptr<arrow::io::OutputStream> m_output;
+    ReadTableExportOptions m_options;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+    arrow::MemoryPool * m_pool;
+    std::shared_ptr<arrow::Schema> m_schema;
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> m_arrow_writer;
+    std::size_t m_max_batches_in_flight;
+    std::deque<PendingBatch> m_pending_batches;
+    std::uint64_t m_reads_written = 0;
+    bool m_closed = false;
+};
+
+}  // namespace pod5
@@ -1,19 +1,46 @@
 #include "pod5_format/read_table_reader.h"
 
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/internal/sharded_lru_cache.h"
+#include "pod5_format/internal/tracing/tracing.h"
+#include "pod5_format/read_id_index.h"
+#include "pod5_format/read_table_sort.h"
 #include "pod5_format/read_table_utils.h"
 #include "pod5_format/schema_metadata.h"
 #include "pod5_format/schema_utils.h"
+#include "pod5_format/thread_pool.h"
 
 #include <arrow/array/array_binary.h>
 #include <arrow/array/array_dict.h>
 #include <arrow/array/array_nested.h>
 #include <arrow/array/array_primitive.h>
 #include <arrow/ipc/reader.h>
+#include <arrow/util/byte_size.h>
 
 #include <algorithm>
+#include <thread>
 
 namespace pod5 {
 
+namespace {
+
+// Queries are only split across threads once each thread has at least this many ids to search.
+constexpr std::size_t READ_ID_SEARCH_TASK_SIZE = 64 * 1024;
+constexpr std::size_t READ_ID_SEARCH_MAX_TASKS = 64;
+
+// Find the pool to help run [task_count] tasks alongside the calling thread, or null if the
+// calling thread should run them alone. The process's shared pool is used, rather than starting
+// threads for each build or search.
+std::shared_ptr<ThreadPool> search_thread_pool(std::size_t task_count)
+{
+    if (task_count <= 1 || std::thread::hardware_concurrency() <= 1) {
+        return nullptr;
+    }
+    return process_thread_pool();
+}
+
+}  // namespace
+
 ReadTableRecordBatch::ReadTableRecordBatch(
     std::shared_ptr<arrow::RecordBatch> && batch,
     std::shared_ptr<ReadTableSchemaDescription const> const & field_locations)
@@ -96,10 +123,54 @@ Result<ReadTableRecordColumns> ReadTableRecordBatch::columns() const
     return result;
 }
 
+ReadTableBatchView ReadTableRecordBatch::view() const
+{
+    auto const & bat = *batch();
+    auto const & fields = *m_field_locations;
+
+    ReadTableBatchView result;
+    result.read_id = make_column_view(bat, fields.read_id);
+    result.signal = make_column_view(bat, fields.signal);
+    result.read_number = make_column_view(bat, fields.read_number);
+    result.start_sample = make_column_view(bat, fields.start);
+    result.median_before = make_column_view(bat, fields.median_before);
+
+    result.num_minknow_events = make_column_view(bat, fields.num_minknow_events);
+    result.tracked_scaling_scale = make_column_view(bat, fields.tracked_scaling_scale);
+    result.tracked_scaling_shift = make_column_view(bat, fields.tracked_scaling_shift);
+    result.predicted_scaling_scale = make_column_view(bat, fields.predicted_scaling_scale);
+    result.predicted_scaling_shift = make_column_view(bat, fields.predicted_scaling_shift);
+    result.num_reads_since_mux_change = make_column_view(bat, fields.num_reads_since_mux_change);
+    result.time_since_mux_change = make_column_view(bat, fields.time_since_mux_change);
+
+    result.num_samples = make_column_view(bat, fields.num_samples);
+
+    result.channel = make_column_view(bat, fields.channel);
+    result.well = make_column_view(bat, fields.well);
+    result.pore_type = make_column_view(bat, fields.pore_type);
+    result.calibration_offset = make_column_view(bat, fields.calibration_offset);
+    result.calibration_scale = make_column_view(bat, fields.calibration_scale);
+    result.end_reason = make_column_view(bat, fields.end_reason);
+    result.end_reason_forced = make_column_view(bat, fields.end_reason_forced);
+    result.run_info = make_column_view(bat, fields.run_info);
+
+    result.signal_min = make_column_view(bat, fields.signal_min);
+    result.signal_max = make_column_view(bat, fields.signal_max);
+    result.signal_mean = make_column_view(bat, fields.signal_mean);
+    result.signal_standard_deviation = make_column_view(bat, fields.signal_standard_deviation);
+
+    result.num_rows = bat.num_rows();
+    result.table_version = fields.table_version();
+    return result;
+}
+
 Result<std::shared_ptr<arrow::UInt64Array>> ReadTableRecordBatch::get_signal_rows(
     std::int64_t batch_row)
 {
     auto signal_col = signal_column();
+    if (!signal_col) {
+        return arrow::Status::Invalid("signal column was not loaded for this batch");
+    }
 
     auto const & values = signal_col->values();
 
@@ -185,164 +256,358 @@ Result<std::string> ReadTableRecordBatch::get_run_info(std::int16_t run_info_ind
 
 //---------------------------------------------------------------------------------------------------------------------
 
+ReadTableProjection::ReadTableProjection(
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
+    std::shared_ptr<ReadTableSchemaDescription const> && field_locations,
+    TableBatchMigrations migrations)
+: m_reader(std::move(reader))
+, m_field_locations(std::move(field_locations))
+, m_migrations(std::move(migrations))
+{
+}
+
+ReadTableProjection::~ReadTableProjection() = default;
+
+//---------------------------------------------------------------------------------------------------------------------
+
 ReadTableReader::ReadTableReader(
     std::shared_ptr<void> && input_source,
     std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
     std::shared_ptr<ReadTableSchemaDescription const> const & field_locations,
     SchemaMetadataDescription && schema_metadata,
-    arrow::MemoryPool * pool)
-: TableReader(std::move(input_source), std::move(reader), std::move(schema_metadata), pool)
+    arrow::MemoryPool * pool,
+    std::shared_ptr<arrow::io::RandomAccessFile> input_file,
+    TableBatchMigrations && migrations,
+    std::size_t max_cached_batch_bytes)
+: TableReader(
+    std::move(input_source),
+    std::move(reader),
+    std::move(schema_metadata),
+    pool,
+    std::move(migrations))
 , m_field_locations(field_locations)
+, m_sorted_by_read_id(is_read_table_sorted_by_read_id(*schema()))
+, m_input_file(std::move(input_file))
+, m_pool(pool)
 {
+    if (max_cached_batch_bytes > 0) {
+        m_table_batches = std::make_unique<ShardedLruCache<std::shared_ptr<arrow::RecordBatch>>>(
+            0, max_cached_batch_bytes, "read table batch cache");
+    }
 }
 
 ReadTableReader::ReadTableReader(ReadTableReader && other)
 : TableReader(std::move(other))
 , m_field_locations(std::move(other.m_field_locations))
-, m_sorted_file_read_ids(std::move(other.m_sorted_file_read_ids))
+, m_read_id_index(std::move(other.m_read_id_index))
+, m_sorted_by_read_id(other.m_sorted_by_read_id)
+, m_input_file(std::move(other.m_input_file))
+, m_pool(other.m_pool)
+, m_table_batches(std::move(other.m_table_batches))
 {
 }
 
+ReadTableReader::~ReadTableReader() = default;
+
 ReadTableReader & ReadTableReader::operator=(ReadTableReader && other)
 {
-    static_cast<TableReader &>(*this) = std::move(static_cast<TableReader &>(*this));
+    static_cast<TableReader &>(*this) = std::move(static_cast<TableReader &>(other));
     m_field_locations = std::move(other.m_field_locations);
-    m_sorted_file_read_ids = std::move(other.m_sorted_file_read_ids);
+    m_read_id_index = std::move(other.m_read_id_index);
+    m_sorted_by_read_id = other.m_sorted_by_read_id;
+    m_input_file = std::move(other.m_input_file);
+    m_pool = other.m_pool;
+    m_table_batches = std::move(other.m_table_batches);
     return *this;
 }
 
 Result<ReadTableRecordBatch> ReadTableReader::read_record_batch(std::size_t i) const
 {
-    std::lock_guard<std::mutex> l(m_batch_get_mutex);
-    auto record_batch = reader()->ReadRecordBatch(i);
+    POD5_TRACE_FUNCTION();
+    if (!m_table_batches) {
+        ARROW_ASSIGN_OR_RAISE(auto record_batch, read_batch(i, m_batch_get_mutex));
+        return ReadTableRecordBatch{std::move(record_batch), m_field_locations};
+    }
+
+    // Batches are cached migrated, with their dictionaries decoded, so a hit does no IPC work:
+    using CachedBatch = ShardedLruCache<std::shared_ptr<arrow::RecordBatch>>::LoadedValue;
+    auto record_batch = m_table_batches->get(i, [&]() -> Result<CachedBatch> {
+        ARROW_ASSIGN_OR_RAISE(auto batch, read_batch(i, m_batch_get_mutex));
+        auto const byte_size = arrow::util::TotalBufferSize(*batch);
+        return CachedBatch{std::move(batch), static_cast<std::size_t>(byte_size)};
+    });
     if (!record_batch.ok()) {
         return record_batch.status();
     }
     return ReadTableRecordBatch{std::move(*record_batch), m_field_locations};
 }
 
-Status ReadTableReader::build_read_id_lookup()
+std::size_t ReadTableReader::cached_batch_bytes() const
 {
-    if (!m_sorted_file_read_ids.empty()) {
-        return Status::OK();
+    return m_table_batches ? m_table_batches->byte_size() : 0;
+}
+
+void ReadTableReader::clear_cache()
+{
+    if (m_table_batches) {
+        m_table_batches->clear();
     }
+}
 
-    std::vector<IndexData> file_read_ids;
+ReadTableBatchStatistics ReadTableReader::statistics() const
+{
+    ReadTableBatchStatistics result;
+    result.batches_decoded = batches_decoded();
+    if (m_table_batches) {
+        auto const cache_statistics = m_table_batches->statistics();
+        result.cache_hits = cache_statistics.hits;
+        result.cache_misses = cache_statistics.misses;
+        result.cache_evictions = cache_statistics.evictions;
+    }
+    return result;
+}
 
-    auto const batch_count = num_record_batches();
-    std::size_t abs_row_count = 0;
+Result<ReadTableRecordBatch> ReadTableReader::read_record_batch(
+    std::size_t i,
+    ReadTableProjection const & projection) const
+{
+    POD5_TRACE_FUNCTION();
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    {
+        std::lock_guard<std::mutex> l(projection.m_batch_get_mutex);
+        ARROW_ASSIGN_OR_RAISE(record_batch, projection.m_reader->ReadRecordBatch(i));
+    }
+    count_batch_decoded();
+    ARROW_ASSIGN_OR_RAISE(
+        record_batch, migrate_batch(projection.m_migrations, std::move(record_batch)));
+    return ReadTableRecordBatch{std::move(record_batch), projection.m_field_locations};
+}
 
-    // Loop each batch and copy read ids out into the index:
-    for (std::size_t i = 0; i < batch_count; ++i) {
-        ARROW_ASSIGN_OR_RAISE(auto batch, read_record_batch(i));
+Result<std::shared_ptr<ReadTableProjection const>> ReadTableReader::make_projection(
+    std::vector<std::string> const & column_names) const
+{
+    if (!m_input_file) {
+        return Status::Invalid("Read table was opened without access to its file");
+    }
 
-        if (file_read_ids.empty()) {
-            file_read_ids.reserve(batch.num_rows() * batch_count);
-        }
-        file_read_ids.resize(file_read_ids.size() + batch.num_rows());
-
-        auto read_id_col = batch.read_id_column();
-        auto raw_read_id_values = read_id_col->raw_values();
-        for (std::size_t row = 0; row < (std::size_t)read_id_col->length(); ++row) {
-            // Record the id, and its location within the file:
-            file_read_ids[abs_row_count].id = raw_read_id_values[row];
-            file_read_ids[abs_row_count].batch = i;
-            file_read_ids[abs_row_count].batch_row = row;
-            abs_row_count += 1;
+    auto const schema = this->schema();
+    for (auto const & name : column_names) {
+        if (schema->GetFieldIndex(name) < 0) {
+            return Status::Invalid("Column '", name, "' is not in the read table");
         }
     }
 
-    // Sort by read id for searching later:
-    std::sort(file_read_ids.begin(), file_read_ids.end(), [](auto const & a, auto const & b) {
-        return a.id < b.id;
-    });
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = m_pool;
+    if (!migrations().empty()) {
+        // Migrations need the columns of the original schema, so every column is loaded:
+        ARROW_ASSIGN_OR_RAISE(
+            auto full_reader, arrow::ipc::RecordBatchFileReader::Open(m_input_file, options));
+        auto field_locations = m_field_locations;
+        return std::make_shared<ReadTableProjection const>(
+            std::move(full_reader), std::move(field_locations), migrations());
+    }
 
-    // Move data out now we successfully build the index:
-    m_sorted_file_read_ids = std::move(file_read_ids);
+    std::vector<int> included_fields;
+    included_fields.reserve(column_names.size());
+    for (auto const & name : column_names) {
+        included_fields.push_back(schema->GetFieldIndex(name));
+    }
+    std::sort(included_fields.begin(), included_fields.end());
+    included_fields.erase(
+        std::unique(included_fields.begin(), included_fields.end()), included_fields.end());
 
+    // The ipc reader applies its projection to every batch, so each projection needs its own:
+    options.included_fields = included_fields;
+    ARROW_ASSIGN_OR_RAISE(
+        auto projected_reader, arrow::ipc::RecordBatchFileReader::Open(m_input_file, options));
+    ARROW_ASSIGN_OR_RAISE(
+        auto field_locations,
+        project_read_table_schema(schema_metadata(), schema, included_fields));
+
+    return std::make_shared<ReadTableProjection const>(
+        std::move(projected_reader), std::move(field_locations));
+}
+
+Status ReadTableReader::build_read_id_lookup()
+{
+    if (m_read_id_index) {
+        return Status::OK();
+    }
+
+    // Batch ids are sorted in parallel, on the process's shared pool:
+    auto thread_pool = search_thread_pool(num_record_batches());
+    ARROW_ASSIGN_OR_RAISE(m_read_id_index, ReadIdIndex::build(*this, thread_pool.get()));
     return Status::OK();
 }
 
+void ReadTableReader::set_read_id_index(std::shared_ptr<ReadIdIndex const> index)
+{
+    m_read_id_index = std::move(index);
+}
+
 Result<std::size_t> ReadTableReader::search_for_read_ids(
     ReadIdSearchInput const & search_input,
     gsl::span<uint32_t> const & batch_counts,
     gsl::span<uint32_t> const & batch_rows)
 {
+    if (!m_read_id_index && m_sorted_by_read_id && m_input_file) {
+        return search_sorted_table_for_read_ids(search_input, batch_counts, batch_rows);
+    }
     ARROW_RETURN_NOT_OK(build_read_id_lookup());
 
-    if (m_sorted_file_read_ids.empty()) {
+    auto const & index = *m_read_id_index;
+    if (index.size() == 0) {
         return 0;
     }
 
-    std::size_t successes = 0;
+    // Large queries are split into contiguous runs of the (sorted) search input, searched in
+    // parallel. Each task records the locations it finds packed as (batch << 32 | batch_row):
+    auto const query_count = search_input.read_id_count();
+    auto const task_count = std::max<std::size_t>(
+        1, std::min(query_count / READ_ID_SEARCH_TASK_SIZE, READ_ID_SEARCH_MAX_TASKS));
+    std::vector<std::vector<std::uint64_t>> task_locations(task_count);
+
+    auto const search_task = [&](std::size_t task) -> Status {
+        auto const query_begin = query_count * task / task_count;
+        auto const query_end = query_count * (task + 1) / task_count;
+        auto & locations = task_locations[task];
+        locations.reserve(query_end - query_begin);
+
+        std::size_t index_position = 0;
+        for (std::size_t i = query_begin; i < query_end; ++i) {
+            auto const & search_item = search_input[i];
+
+            // Search inputs are sorted, so only the index after the last match needs searching.
+            // Galloping keeps this cheap for both sparse and dense queries:
+            index_position = index.lower_bound(search_item.id, index_position);
+
+            // No more ids to search, both lists are sorted and we haven't found this one, we won't find any others.
+            if (index_position == index.size()) {
+                break;
+            }
+
+            // If we found it record the location:
+            if (index.read_ids()[index_position] == search_item.id) {
+                auto const batch = index.batch(index_position);
+                if (batch >= batch_counts.size()) {
+                    return Status::IOError("Read id index refers to a missing read table batch");
+                }
+                locations.push_back(
+                    (std::uint64_t(batch) << 32) | index.batch_row(index_position));
+            }
+        }
+        return Status::OK();
+    };
+
+    auto thread_pool = search_thread_pool(task_count);
+    ARROW_RETURN_NOT_OK(internal::run_parallel_tasks(thread_pool.get(), task_count, search_task));
 
-    std::vector<std::vector<std::uint32_t>> batch_data(batch_counts.size());
-    auto const initial_reserve_size = search_input.read_id_count() / batch_counts.size();
-    for (auto & br : batch_data) {
-        br.reserve(initial_reserve_size);
+    std::vector<std::uint64_t> locations = std::move(task_locations.front());
+    for (std::size_t task = 1; task < task_count; ++task) {
+        locations.insert(
+            locations.end(), task_locations[task].begin(), task_locations[task].end());
     }
 
-    auto file_ids_current_it = m_sorted_file_read_ids.begin();
-    auto const file_ids_end = m_sorted_file_read_ids.end();
-    for (std::size_t i = 0; i < search_input.read_id_count(); ++i) {
-        auto const & search_item = search_input[i];
+    // Sorting the packed locations orders rows by batch, and then by row within each batch:
+    std::sort(locations.begin(), locations.end());
 
-        // Increment file pointer while less than the search term:
-        while (file_ids_current_it->id < search_item.id && file_ids_current_it != file_ids_end) {
-            ++file_ids_current_it;
-        }
+    std::fill(batch_counts.begin(), batch_counts.end(), 0);
+    for (std::size_t i = 0; i < locations.size(); ++i) {
+        batch_counts[locations[i] >> 32] += 1;
+        batch_rows[i] = std::uint32_t(locations[i]);
+    }
 
-        // No more ids to search, both lists are sorted and we haven't found this one, we won't find any others.
-        if (file_ids_current_it == file_ids_end) {
-            break;
-        }
+    return locations.size();
+}
 
-        // If we found it record the location:
-        if (file_ids_current_it->id == search_item.id) {
-            batch_data[file_ids_current_it->batch].push_back(file_ids_current_it->batch_row);
-            successes += 1;
-        }
-    }
+Result<std::size_t> ReadTableReader::search_sorted_table_for_read_ids(
+    ReadIdSearchInput const & search_input,
+    gsl::span<uint32_t> const & batch_counts,
+    gsl::span<uint32_t> const & batch_rows) const
+{
+    ARROW_ASSIGN_OR_RAISE(auto projection, make_projection({m_field_locations->read_id.name()}));
 
-    std::size_t full_size_so_far = 0;
-    for (std::size_t i = 0; i < batch_data.size(); ++i) {
-        auto & data = batch_data[i];
-        batch_counts[i] = data.size();
+    std::fill(batch_counts.begin(), batch_counts.end(), 0);
 
-        // Ensure the batch indices within the batch are sorted:
-        std::sort(data.begin(), data.end());
+    // Both the search input and the table are sorted, so matches are found in table order, and
+    // each batch is only searched after the previous match:
+    auto const batch_count = num_record_batches();
+    std::size_t batch_index = 0;
+    std::shared_ptr<UuidArray> batch_read_ids;
+    gsl::span<Uuid const> read_ids;
+    std::size_t search_position = 0;
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < search_input.read_id_count(); ++i) {
+        auto const & id = search_input[i].id;
+
+        // Move on past batches ending before this id:
+        while (batch_index < batch_count) {
+            if (!batch_read_ids) {
+                ARROW_ASSIGN_OR_RAISE(auto batch, read_record_batch(batch_index, *projection));
+                batch_read_ids = batch.read_id_column();
+                read_ids = gsl::make_span(batch_read_ids->raw_values(), batch.num_rows());
+                search_position = 0;
+            }
+            if (!read_ids.empty() && !(read_ids.back() < id)) {
+                break;
+            }
+            batch_index += 1;
+            batch_read_ids = nullptr;
+        }
 
-        // Copy the row indices into the packed vector:
-        std::copy(data.begin(), data.end(), batch_rows.begin() + full_size_so_far);
+        // No batch holds ids this large, so none holds any later id either:
+        if (batch_index == batch_count) {
+            break;
+        }
+        if (batch_index >= batch_counts.size()) {
+            return Status::Invalid("Too few batch counts for the read table");
+        }
 
-        full_size_so_far += data.size();
+        auto const match =
+            std::lower_bound(read_ids.begin() + search_position, read_ids.end(), id);
+        search_position = match - read_ids.begin();
+        if (*match == id) {
+            batch_counts[batch_index] += 1;
+            batch_rows[found] = std::uint32_t(search_position);
+            found += 1;
+        }
     }
-
-    return successes;
+    return found;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 
 Result<ReadTableReader> make_read_table_reader(
     std::shared_ptr<arrow::io::RandomAccessFile> const & input,
-    arrow::MemoryPool * pool)
+    arrow::MemoryPool * pool,
+    TableBatchMigrations migrations,
+    std::size_t max_cached_batch_bytes)
 {
     arrow::ipc::IpcReadOptions options;
     options.memory_pool = pool;
 
     ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(input, options));
 
-    auto read_metadata_key_values = reader->schema()->metadata();
+    // Fields are found in the schema batches are migrated to:
+    auto const schema = migrations.empty() ? reader->schema() : migrations.back()->schema();
+    auto read_metadata_key_values = schema->metadata();
     if (!read_metadata_key_values) {
         return Status::IOError("Missing metadata on read table schema");
     }
     ARROW_ASSIGN_OR_RAISE(
         auto read_metadata, read_schema_key_value_metadata(read_metadata_key_values));
-    ARROW_ASSIGN_OR_RAISE(
-        auto field_locations, read_read_table_schema(read_metadata, reader->schema()));
+    ARROW_ASSIGN_OR_RAISE(auto field_locations, read_read_table_schema(read_metadata, schema));
 
     return ReadTableReader(
-        {input}, std::move(reader), field_locations, std::move(read_metadata), pool);
+        {input},
+        std::move(reader),
+        field_locations,
+        std::move(read_metadata),
+        pool,
+        input,
+        std::move(migrations),
+        max_cached_batch_bytes);
 }
 
 }  // namespace pod5
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "pod5_format/column_view.h"
 #include "pod5_format/pod5_format_export.h"
 #include "pod5_format/read_table_schema.h"
 #include "pod5_format/read_table_utils.h"
@@ -13,6 +14,8 @@
 #include <gsl/gsl-lite.hpp>
 
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace arrow {
 class Schema;
@@ -32,7 +35,20 @@ class CalibrationData;
 class EndReasonData;
 class PoreData;
 class RunInfoData;
+class ReadIdIndex;
 class ReadIdSearchInput;
+template <typename Value>
+class ShardedLruCache;
+
+/// \brief Counts of a read table's batch loads since it was opened.
+struct ReadTableBatchStatistics {
+    std::uint64_t batches_decoded = 0;
+    /// Batch cache lookups finding the batch cached (or being loaded by another thread), lookups
+    /// which loaded it, and batches evicted to make room. All 0 if the cache is disabled.
+    std::uint64_t cache_hits = 0;
+    std::uint64_t cache_misses = 0;
+    std::uint64_t cache_evictions = 0;
+};
 
 struct ReadTableRecordColumns {
     std::shared_ptr<UuidArray> read_id;
@@ -64,6 +80,53 @@ struct ReadTableRecordColumns {
     TableSpecVersion table_version;
 };
 
+/// \brief Views of a read table batch's columns, for loops reading fields row by row.
+///
+/// Each column's values are found once for the batch, rather than its array being looked up for
+/// every row. Columns the batch doesn't hold, such as those outside a projection, are empty.
+/// \see ColumnView
+struct ReadTableBatchView {
+    template <typename FieldType>
+    using View = ColumnViewType<FieldType>;
+    using Schema = ReadTableSchemaDescription;
+
+    View<decltype(Schema::read_id)> read_id;
+    View<decltype(Schema::signal)> signal;
+    View<decltype(Schema::read_number)> read_number;
+    View<decltype(Schema::start)> start_sample;
+    View<decltype(Schema::median_before)> median_before;
+
+    View<decltype(Schema::num_minknow_events)> num_minknow_events;
+
+    View<decltype(Schema::tracked_scaling_scale)> tracked_scaling_scale;
+    View<decltype(Schema::tracked_scaling_shift)> tracked_scaling_shift;
+    View<decltype(Schema::predicted_scaling_scale)> predicted_scaling_scale;
+    View<decltype(Schema::predicted_scaling_shift)> predicted_scaling_shift;
+    View<decltype(Schema::num_reads_since_mux_change)> num_reads_since_mux_change;
+    View<decltype(Schema::time_since_mux_change)> time_since_mux_change;
+
+    View<decltype(Schema::num_samples)> num_samples;
+
+    View<decltype(Schema::channel)> channel;
+    View<decltype(Schema::well)> well;
+    View<decltype(Schema::pore_type)> pore_type;
+    View<decltype(Schema::calibration_offset)> calibration_offset;
+    View<decltype(Schema::calibration_scale)> calibration_scale;
+    View<decltype(Schema::end_reason)> end_reason;
+    View<decltype(Schema::end_reason_forced)> end_reason_forced;
+    View<decltype(Schema::run_info)> run_info;
+
+    // Empty unless the file was written with signal statistics. Reads whose statistics weren't
+    // found are null in the table, and read as 0 here:
+    View<decltype(Schema::signal_min)> signal_min;
+    View<decltype(Schema::signal_max)> signal_max;
+    View<decltype(Schema::signal_mean)> signal_mean;
+    View<decltype(Schema::signal_standard_deviation)> signal_standard_deviation;
+
+    std::int64_t num_rows = 0;
+    TableSpecVersion table_version;
+};
+
 class POD5_FORMAT_EXPORT ReadTableRecordBatch : public TableRecordBatch {
 public:
     ReadTableRecordBatch(
@@ -82,6 +145,9 @@ public:
 
     Result<ReadTableRecordColumns> columns() const;
 
+    /// \brief View the batch's columns, valid for as long as the batch.
+    ReadTableBatchView view() const;
+
     Result<std::shared_ptr<arrow::UInt64Array>> get_signal_rows(std::int64_t batch_row);
 
 private:
@@ -89,42 +155,130 @@ private:
     mutable std::mutex m_dictionary_access_lock;
 };
 
+/// \brief A subset of read table columns to load, made by ReadTableReader::make_projection().
+///
+/// Columns outside the projection are neither read nor decoded, and are reported as missing
+/// (null) by the accessors of batches loaded with it.
+class POD5_FORMAT_EXPORT ReadTableProjection {
+public:
+    ReadTableProjection(
+        std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
+        std::shared_ptr<ReadTableSchemaDescription const> && field_locations,
+        TableBatchMigrations migrations = {});
+    ~ReadTableProjection();
+
+    /// \brief Find the locations of the loaded columns in projected batches.
+    std::shared_ptr<ReadTableSchemaDescription const> const & field_locations() const
+    {
+        return m_field_locations;
+    }
+
+private:
+    friend class ReadTableReader;
+
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> m_reader;
+    std::shared_ptr<ReadTableSchemaDescription const> m_field_locations;
+    TableBatchMigrations m_migrations;
+    mutable std::mutex m_batch_get_mutex;
+};
+
 class POD5_FORMAT_EXPORT ReadTableReader : public TableReader {
 public:
+    /// \param max_cached_batch_bytes The most bytes of whole batches to keep cached, 0 to read
+    ///                               every batch from the file.
     ReadTableReader(
         std::shared_ptr<void> && input_source,
         std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
         std::shared_ptr<ReadTableSchemaDescription const> const & field_locations,
         SchemaMetadataDescription && schema_metadata,
-        arrow::MemoryPool * pool);
+        arrow::MemoryPool * pool,
+        std::shared_ptr<arrow::io::RandomAccessFile> input_file = nullptr,
+        TableBatchMigrations && migrations = {},
+        std::size_t max_cached_batch_bytes = 0);
 
     ReadTableReader(ReadTableReader && other);
     ReadTableReader & operator=(ReadTableReader && other);
+    ~ReadTableReader();
 
+    /// \brief Read a batch, using the cached batch if it has already been loaded.
+    /// \note Cached batches are shared by every caller, along with their decoded dictionaries.
     Result<ReadTableRecordBatch> read_record_batch(std::size_t i) const;
 
+    /// \brief Read a batch holding only the columns in [projection].
+    /// \note Projected batches aren't cached.
+    Result<ReadTableRecordBatch> read_record_batch(
+        std::size_t i,
+        ReadTableProjection const & projection) const;
+
+    /// \brief Make a projection loading only the columns named [column_names].
+    /// \returns Invalid if a column isn't in the table.
+    /// \note Batches of a migrated table are migrated whole, so their projections load every
+    ///       column.
+    Result<std::shared_ptr<ReadTableProjection const>> make_projection(
+        std::vector<std::string> const & column_names) const;
+
+    /// \brief Find the locations of the table's columns in its batches.
+    std::shared_ptr<ReadTableSchemaDescription const> const & field_locations() const
+    {
+        return m_field_locations;
+    }
+
+    /// \brief Check if the table's rows were written sorted by read id.
+    bool sorted_by_read_id() const { return m_sorted_by_read_id; }
+
+    /// \brief Build the read id index by scanning the table, if one was not loaded from the file.
     Status build_read_id_lookup();
 
+    /// \brief Use [index], stored in the file, to search for read ids rather than building one.
+    void set_read_id_index(std::shared_ptr<ReadIdIndex const> index);
+
+    /// \brief Find the read id index in use, null if it has not been built or loaded yet.
+    std::shared_ptr<ReadIdIndex const> const & read_id_index() const { return m_read_id_index; }
+
+    /// \brief Find the rows holding the ids in [search_input].
+    ///
+    /// Uses the read id index if one is loaded. Otherwise a table sorted by read id is searched
+    /// directly, and the index is built for any other table.
     Result<std::size_t> search_for_read_ids(
         ReadIdSearchInput const & search_input,
         gsl::span<uint32_t> const & batch_counts,
         gsl::span<uint32_t> const & batch_rows);
 
+    /// \brief Find the total size in bytes of the batches currently held in the cache.
+    std::size_t cached_batch_bytes() const;
+
+    /// \brief Drop every batch held in the cache.
+    void clear_cache();
+
+    /// \brief Find the table's batch load and cache counts.
+    ReadTableBatchStatistics statistics() const;
+
 private:
-    struct IndexData {
-        Uuid id;
-        std::size_t batch;
-        std::size_t batch_row;
-    };
+    // Search the read id column of a table sorted by read id, loading only that column of each
+    // batch which may hold a searched id:
+    Result<std::size_t> search_sorted_table_for_read_ids(
+        ReadIdSearchInput const & search_input,
+        gsl::span<uint32_t> const & batch_counts,
+        gsl::span<uint32_t> const & batch_rows) const;
 
     std::shared_ptr<ReadTableSchemaDescription const> m_field_locations;
-    std::vector<IndexData> m_sorted_file_read_ids;
+    std::shared_ptr<ReadIdIndex const> m_read_id_index;
+    bool m_sorted_by_read_id;
+    std::shared_ptr<arrow::io::RandomAccessFile> m_input_file;
+    arrow::MemoryPool * m_pool;
+    // Null when caching is disabled:
+    std::unique_ptr<ShardedLruCache<std::shared_ptr<arrow::RecordBatch>>> m_table_batches;
 
     mutable std::mutex m_batch_get_mutex;
 };
 
+/// \param migrations              Applied to each batch read, for tables written by older
+///                                versions.
+/// \param max_cached_batch_bytes  The most bytes of batches to keep cached, 0 for no cache.
 POD5_FORMAT_EXPORT Result<ReadTableReader> make_read_table_reader(
     std::shared_ptr<arrow::io::RandomAccessFile> const & sink,
-    arrow::MemoryPool * pool);
+    arrow::MemoryPool * pool,
+    TableBatchMigrations migrations = {},
+    std::size_t max_cached_batch_bytes = 0);
 
 }  // namespace pod5
@@ -3,6 +3,8 @@
 #include "pod5_format/schema_metadata.h"
 #include "pod5_format/types.h"
 
+#include <algorithm>
+
 namespace pod5 {
 
 ReadTableSchemaDescription::ReadTableSchemaDescription()
@@ -59,7 +61,37 @@ channel(this, "channel", arrow::uint16(), ReadTableSpecVersion::v3())
       "run_info",
       arrow::dictionary(arrow::int16(), arrow::utf8()),
       ReadTableSpecVersion::v3())
+,
+// Optional Fields
+signal_min("signal_min", arrow::int16())
+, signal_max("signal_max", arrow::int16())
+, signal_mean("signal_mean", arrow::float32())
+, signal_standard_deviation("signal_standard_deviation", arrow::float32())
+{
+}
+
+std::shared_ptr<arrow::Schema> ReadTableSchemaDescription::add_signal_statistics_fields(
+    std::shared_ptr<arrow::Schema> const & schema)
+{
+    auto fields = schema->fields();
+    auto const add_field = [&](auto & field) {
+        field.set_field_index(int(fields.size()));
+        fields.push_back(arrow::field(field.name(), field.datatype()));
+    };
+    add_field(signal_min);
+    add_field(signal_max);
+    add_field(signal_mean);
+    add_field(signal_standard_deviation);
+    return arrow::schema(fields, schema->metadata());
+}
+
+Status ReadTableSchemaDescription::find_optional_fields(
+    std::shared_ptr<arrow::Schema> const & schema)
 {
+    ARROW_RETURN_NOT_OK(signal_min.find_in(schema));
+    ARROW_RETURN_NOT_OK(signal_max.find_in(schema));
+    ARROW_RETURN_NOT_OK(signal_mean.find_in(schema));
+    return signal_standard_deviation.find_in(schema);
 }
 
 TableSpecVersion ReadTableSchemaDescription::table_version_from_file_version(
@@ -88,6 +120,43 @@ Result<std::shared_ptr<ReadTableSchemaDescription const>> read_read_table_schema
 {
     auto result = std::make_shared<ReadTableSchemaDescription>();
     ARROW_RETURN_NOT_OK(ReadTableSchemaDescription::read_schema(result, schema_metadata, schema));
+    ARROW_RETURN_NOT_OK(result->find_optional_fields(schema));
+
+    return result;
+}
+
+Result<std::shared_ptr<ReadTableSchemaDescription const>> project_read_table_schema(
+    SchemaMetadataDescription const & schema_metadata,
+    std::shared_ptr<arrow::Schema> const & schema,
+    std::vector<int> const & included_fields)
+{
+    auto result = std::make_shared<ReadTableSchemaDescription>();
+    ARROW_RETURN_NOT_OK(ReadTableSchemaDescription::read_schema(result, schema_metadata, schema));
+    ARROW_RETURN_NOT_OK(result->find_optional_fields(schema));
+
+    // Projected batches hold only the included columns, in schema order:
+    auto const project_field = [&](auto & field) {
+        auto const it =
+            std::lower_bound(included_fields.begin(), included_fields.end(), field.field_index());
+        if (it == included_fields.end() || *it != field.field_index()) {
+            field.set_field_index((int)SpecialFieldValues::InvalidField);
+        } else {
+            field.set_field_index(int(it - included_fields.begin()));
+        }
+    };
+    for (auto & field : result->fields()) {
+        if (result->table_version() < field->added_table_spec_version()
+            || result->table_version() >= field->removed_table_spec_version())
+        {
+            field->set_field_index((int)SpecialFieldValues::InvalidField);
+            continue;
+        }
+        project_field(*field);
+    }
+    project_field(result->signal_min);
+    project_field(result->signal_max);
+    project_field(result->signal_mean);
+    project_field(result->signal_standard_deviation);
 
     return result;
 }
@@ -84,6 +84,28 @@ public:
     Field<19, arrow::BooleanArray> end_reason_forced;
     Field<20, arrow::DictionaryArray> run_info;
 
+    // Optional fields, after the fields above in tables written with signal statistics, see
+    // FileWriterOptions::set_write_signal_statistics:
+    OptionalField<arrow::Int16Array> signal_min;
+    OptionalField<arrow::Int16Array> signal_max;
+    OptionalField<arrow::FloatArray> signal_mean;
+    OptionalField<arrow::FloatArray> signal_standard_deviation;
+
+    /// \brief Find if the table holds the signal statistics fields.
+    bool has_signal_statistics() const
+    {
+        return signal_min.found_field() && signal_max.found_field() && signal_mean.found_field()
+               && signal_standard_deviation.found_field();
+    }
+
+    /// \brief Append the signal statistics fields to [schema], a schema made by
+    ///        make_writer_schema(), locating them in the result.
+    std::shared_ptr<arrow::Schema> add_signal_statistics_fields(
+        std::shared_ptr<arrow::Schema> const & schema);
+
+    /// \brief Locate the optional fields held by [schema].
+    Status find_optional_fields(std::shared_ptr<arrow::Schema> const & schema);
+
     // Field Builders only for fields we write in newly generated files.
     // Should not include fields which are removed in the latest version:
     using FieldBuilders = FieldBuilder<
@@ -121,4 +143,14 @@ POD5_FORMAT_EXPORT Result<std::shared_ptr<ReadTableSchemaDescription const>> rea
     SchemaMetadataDescription const & schema_metadata,
     std::shared_ptr<arrow::Schema> const &);
 
+/// \brief Describe batches of a read table loaded with only some of its columns.
+/// \param included_fields Indices into [schema] of the loaded columns, sorted and unique.
+/// \returns A description where fields outside [included_fields] are reported as not found, and
+///          loaded fields are located by their position in the projected batches.
+POD5_FORMAT_EXPORT Result<std::shared_ptr<ReadTableSchemaDescription const>>
+project_read_table_schema(
+    SchemaMetadataDescription const & schema_metadata,
+    std::shared_ptr<arrow::Schema> const & schema,
+    std::vector<int> const & included_fields);
+
 }  // namespace pod5
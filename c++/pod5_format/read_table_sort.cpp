@@ -0,0 +1,182 @@
+#include "pod5_format/read_table_sort.h"
+
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/uuid.h"
+
+#include <arrow/array/array_dict.h>
+#include <arrow/array/concatenate.h>
+#include <arrow/extension_type.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <arrow/util/compression.h>
+#include <arrow/util/key_value_metadata.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace pod5 {
+
+char const * const READ_TABLE_SORTED_BY_KEY = "MINKNOW:sorted_by";
+char const * const READ_TABLE_SORTED_BY_READ_ID = "read_id";
+
+namespace {
+
+struct RowLocation {
+    Uuid id;
+    std::uint32_t batch;
+    std::uint32_t batch_row;
+};
+
+using BatchColumns = std::vector<std::shared_ptr<arrow::Array>>;
+
+// Point the dictionary columns of every batch at the last batch's dictionaries. Dictionaries are
+// only appended to as the table is written, so the last batch's hold every entry an earlier batch
+// refers to, and rows from any batch can then be concatenated.
+void share_dictionaries(std::vector<BatchColumns> & batch_columns)
+{
+    if (batch_columns.empty()) {
+        return;
+    }
+    auto const & last_batch = batch_columns.back();
+    for (std::size_t column = 0; column < last_batch.size(); ++column) {
+        if (last_batch[column]->type_id() != arrow::Type::DICTIONARY) {
+            continue;
+        }
+        auto const dictionary =
+            std::static_pointer_cast<arrow::DictionaryArray>(last_batch[column])->dictionary();
+        for (auto & columns : batch_columns) {
+            auto const array = std::static_pointer_cast<arrow::DictionaryArray>(columns[column]);
+            if (array->dictionary() != dictionary) {
+                columns[column] = std::make_shared<arrow::DictionaryArray>(
+                    array->type(), array->indices(), dictionary);
+            }
+        }
+    }
+}
+
+// Gather [rows] from [batch_columns] into a single batch, slicing each run of rows adjacent in
+// the source batches at once.
+Result<std::shared_ptr<arrow::RecordBatch>> gather_rows(
+    std::shared_ptr<arrow::Schema> const & schema,
+    std::vector<BatchColumns> const & batch_columns,
+    gsl::span<RowLocation const> const & rows,
+    arrow::MemoryPool * pool)
+{
+    struct Run {
+        std::uint32_t batch;
+        std::uint32_t first_row;
+        std::uint32_t length;
+    };
+    std::vector<Run> runs;
+    for (auto const & row : rows) {
+        if (!runs.empty() && runs.back().batch == row.batch
+            && runs.back().first_row + runs.back().length == row.batch_row)
+        {
+            runs.back().length += 1;
+        } else {
+            runs.push_back({row.batch, row.batch_row, 1});
+        }
+    }
+
+    BatchColumns columns(schema->num_fields());
+    arrow::ArrayVector slices(runs.size());
+    for (std::size_t column = 0; column < columns.size(); ++column) {
+        auto const & type = schema->field(int(column))->type();
+        auto const extension_type = type->id() == arrow::Type::EXTENSION
+                                        ? std::static_pointer_cast<arrow::ExtensionType>(type)
+                                        : nullptr;
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            auto slice =
+                batch_columns[runs[i].batch][column]->Slice(runs[i].first_row, runs[i].length);
+            // Extension columns (the read id) are concatenated through their storage:
+            slices[i] = extension_type
+                            ? std::static_pointer_cast<arrow::ExtensionArray>(slice)->storage()
+                            : std::move(slice);
+        }
+        ARROW_ASSIGN_OR_RAISE(columns[column], arrow::Concatenate(slices, pool));
+        if (extension_type) {
+            columns[column] = extension_type->WrapArray(extension_type, columns[column]);
+        }
+    }
+    return arrow::RecordBatch::Make(schema, std::int64_t(rows.size()), std::move(columns));
+}
+
+}  // namespace
+
+bool is_read_table_sorted_by_read_id(arrow::Schema const & schema)
+{
+    auto const & metadata = schema.metadata();
+    if (!metadata) {
+        return false;
+    }
+    auto const sorted_by = metadata->Get(READ_TABLE_SORTED_BY_KEY);
+    return sorted_by.ok() && *sorted_by == READ_TABLE_SORTED_BY_READ_ID;
+}
+
+Result<ReadTableStatistics> write_read_table_sorted_by_read_id(
+    ReadTableReader const & reader,
+    std::shared_ptr<arrow::io::OutputStream> const & sink,
+    std::size_t batch_size,
+    arrow::MemoryPool * pool,
+    arrow::Compression::type table_compression)
+{
+    if (batch_size == 0) {
+        return Status::Invalid("Sorted read table batch size must be non zero");
+    }
+    auto const batch_count = reader.num_record_batches();
+    if (batch_count > std::numeric_limits<std::uint32_t>::max()) {
+        return Status::Invalid("Too many read table batches to sort");
+    }
+
+    std::vector<BatchColumns> batch_columns(batch_count);
+    std::vector<RowLocation> rows;
+    for (std::size_t i = 0; i < batch_count; ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader.read_record_batch(i));
+        auto const read_ids = batch.read_id_column()->raw_values();
+        for (std::size_t row = 0; row < batch.num_rows(); ++row) {
+            rows.push_back({read_ids[row], std::uint32_t(i), std::uint32_t(row)});
+        }
+        batch_columns[i] = batch.batch()->columns();
+    }
+    share_dictionaries(batch_columns);
+
+    // A stable sort keeps rows sharing a read id in table order:
+    std::stable_sort(rows.begin(), rows.end(), [](auto const & a, auto const & b) {
+        return a.id < b.id;
+    });
+
+    auto const source_metadata = reader.schema()->metadata();
+    auto const metadata =
+        source_metadata ? source_metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    metadata->Set(READ_TABLE_SORTED_BY_KEY, READ_TABLE_SORTED_BY_READ_ID);
+    auto const schema = reader.schema()->WithMetadata(metadata);
+
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    options.emit_dictionary_deltas = true;
+    if (table_compression != arrow::Compression::UNCOMPRESSED) {
+        ARROW_ASSIGN_OR_RAISE(options.codec, arrow::util::Codec::Create(table_compression));
+    }
+    ARROW_ASSIGN_OR_RAISE(
+        auto writer, arrow::ipc::MakeFileWriter(sink, schema, options, metadata));
+
+    ReadTableStatistics statistics;
+    gsl::span<RowLocation const> const all_rows{rows};
+    for (std::size_t first = 0; first < rows.size(); first += batch_size) {
+        auto const count = rows.size() - first < batch_size ? rows.size() - first : batch_size;
+        ARROW_ASSIGN_OR_RAISE(
+            auto batch, gather_rows(schema, batch_columns, all_rows.subspan(first, count), pool));
+        ARROW_ASSIGN_OR_RAISE(
+            auto batch_statistics,
+            ReadTableStatistics::compute_batch(*batch, *reader.field_locations()));
+        statistics.add_batch(std::move(batch_statistics));
+        ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
+    }
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return statistics;
+}
+
+}  // namespace pod5
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/read_table_statistics.h"
+#include "pod5_format/result.h"
+
+#include <arrow/io/type_fwd.h>
+#include <arrow/util/type_fwd.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace arrow {
+class MemoryPool;
+class Schema;
+}  // namespace arrow
+
+namespace pod5 {
+
+class ReadTableReader;
+
+/// Read table schema metadata naming the column the table's rows are sorted by, if any.
+POD5_FORMAT_EXPORT extern char const * const READ_TABLE_SORTED_BY_KEY;
+/// The value of READ_TABLE_SORTED_BY_KEY for tables sorted by read id.
+POD5_FORMAT_EXPORT extern char const * const READ_TABLE_SORTED_BY_READ_ID;
+
+/// \brief Check if a read table with [schema] records its rows as sorted by read id.
+POD5_FORMAT_EXPORT bool is_read_table_sorted_by_read_id(arrow::Schema const & schema);
+
+/// \brief Write the rows of [reader]'s table to [sink] sorted by read id, recording the order in
+///        the schema metadata so readers can search the read id column directly.
+///
+/// Rows sharing a read id keep their order in the table. The table is held in memory while it
+/// is rewritten.
+/// \param batch_size   The rows to write in each batch, the last holding the remainder.
+/// \param table_compression The codec compressing the written batches' buffers.
+/// \returns The statistics of each batch written.
+POD5_FORMAT_EXPORT Result<ReadTableStatistics> write_read_table_sorted_by_read_id(
+    ReadTableReader const & reader,
+    std::shared_ptr<arrow::io::OutputStream> const & sink,
+    std::size_t batch_size,
+    arrow::MemoryPool * pool,
+    arrow::Compression::type table_compression = arrow::Compression::UNCOMPRESSED);
+
+}  // namespace pod5
@@ -0,0 +1,282 @@
+#include "pod5_format/read_table_statistics.h"
+
+#include "pod5_format/read_table_schema.h"
+
+#include <arrow/array/array_dict.h>
+#include <arrow/array/array_nested.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/array/builder_nested.h>
+#include <arrow/array/builder_primitive.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <arrow/util/key_value_metadata.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace pod5 {
+
+namespace {
+
+char const * const INDEX_TYPE_KEY = "MINKNOW:index_type";
+char const * const READ_TABLE_STATISTICS_INDEX_TYPE = "read_table_batch_statistics";
+
+std::shared_ptr<arrow::Schema> make_read_table_statistics_schema(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    return arrow::schema(
+        {
+            arrow::field("min_channel", arrow::uint16(), false),
+            arrow::field("max_channel", arrow::uint16(), false),
+            arrow::field("min_num_samples", arrow::uint64(), false),
+            arrow::field("max_num_samples", arrow::uint64(), false),
+            arrow::field("min_start_sample", arrow::uint64(), false),
+            arrow::field("max_start_sample", arrow::uint64(), false),
+            arrow::field("end_reasons", arrow::list(arrow::int16()), false),
+            arrow::field("run_infos", arrow::list(arrow::int16()), false),
+        },
+        metadata);
+}
+
+bool is_read_table_statistics(arrow::Schema const & schema)
+{
+    auto const & metadata = schema.metadata();
+    if (!metadata) {
+        return false;
+    }
+    auto const index_type = metadata->Get(INDEX_TYPE_KEY);
+    return index_type.ok() && *index_type == READ_TABLE_STATISTICS_INDEX_TYPE;
+}
+
+template <typename ArrayType, typename T>
+void find_min_max(ArrayType const & array, T & min, T & max)
+{
+    min = std::numeric_limits<T>::max();
+    max = std::numeric_limits<T>::lowest();
+    for (std::int64_t i = 0; i < array.length(); ++i) {
+        if (array.IsNull(i)) {
+            continue;
+        }
+        auto const value = array.Value(i);
+        min = std::min<T>(min, value);
+        max = std::max<T>(max, value);
+    }
+}
+
+std::vector<std::int16_t> find_distinct_indices(arrow::DictionaryArray const & array)
+{
+    auto const indices = std::static_pointer_cast<arrow::Int16Array>(array.indices());
+    std::vector<std::int16_t> result;
+    for (std::int64_t i = 0; i < indices->length(); ++i) {
+        if (indices->IsValid(i)) {
+            result.push_back(indices->Value(i));
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+template <typename T>
+bool range_may_match(
+    std::optional<ReadBatchPredicate::Range<T>> const & range,
+    T batch_min,
+    T batch_max)
+{
+    return !range || (range->min <= batch_max && range->max >= batch_min);
+}
+
+bool indices_may_match(
+    std::optional<std::vector<std::int16_t>> const & wanted,
+    std::vector<std::int16_t> const & batch_indices)
+{
+    if (!wanted) {
+        return true;
+    }
+    return std::any_of(wanted->begin(), wanted->end(), [&](std::int16_t index) {
+        return std::binary_search(batch_indices.begin(), batch_indices.end(), index);
+    });
+}
+
+Status append_indices(arrow::ListBuilder & builder, std::vector<std::int16_t> const & indices)
+{
+    ARROW_RETURN_NOT_OK(builder.Append());
+    auto & values = static_cast<arrow::Int16Builder &>(*builder.value_builder());
+    return values.AppendValues(indices.data(), indices.size());
+}
+
+std::vector<std::int16_t> read_indices(arrow::ListArray const & array, std::int64_t row)
+{
+    auto const values = std::static_pointer_cast<arrow::Int16Array>(array.values());
+    auto const begin = values->raw_values() + array.value_offset(row);
+    return std::vector<std::int16_t>(begin, begin + array.value_length(row));
+}
+
+}  // namespace
+
+bool ReadBatchPredicate::may_match(ReadTableBatchStatistics const & statistics) const
+{
+    return range_may_match(channel, statistics.min_channel, statistics.max_channel)
+           && range_may_match(num_samples, statistics.min_num_samples, statistics.max_num_samples)
+           && range_may_match(
+               start_sample, statistics.min_start_sample, statistics.max_start_sample)
+           && indices_may_match(end_reasons, statistics.end_reasons)
+           && indices_may_match(run_infos, statistics.run_infos);
+}
+
+ReadTableStatistics::ReadTableStatistics(std::vector<ReadTableBatchStatistics> && batches)
+: m_batches(std::move(batches))
+{
+}
+
+Result<ReadTableBatchStatistics> ReadTableStatistics::compute_batch(
+    arrow::RecordBatch const & batch,
+    ReadTableSchemaDescription const & field_locations)
+{
+    std::array<FieldBase const *, 5> const fields{
+        &field_locations.channel,
+        &field_locations.num_samples,
+        &field_locations.start,
+        &field_locations.end_reason,
+        &field_locations.run_info,
+    };
+    for (auto const * field : fields) {
+        if (!field->found_field() || field->field_index() >= batch.num_columns()) {
+            return Status::Invalid("Read table batch is missing column '", field->name(), "'");
+        }
+    }
+
+    auto const channel = std::static_pointer_cast<arrow::UInt16Array>(
+        batch.column(field_locations.channel.field_index()));
+    auto const num_samples = std::static_pointer_cast<arrow::UInt64Array>(
+        batch.column(field_locations.num_samples.field_index()));
+    auto const start = std::static_pointer_cast<arrow::UInt64Array>(
+        batch.column(field_locations.start.field_index()));
+    auto const end_reason = std::static_pointer_cast<arrow::DictionaryArray>(
+        batch.column(field_locations.end_reason.field_index()));
+    auto const run_info = std::static_pointer_cast<arrow::DictionaryArray>(
+        batch.column(field_locations.run_info.field_index()));
+
+    // An empty batch ends up with min above max, so no range matches it:
+    ReadTableBatchStatistics result;
+    find_min_max(*channel, result.min_channel, result.max_channel);
+    find_min_max(*num_samples, result.min_num_samples, result.max_num_samples);
+    find_min_max(*start, result.min_start_sample, result.max_start_sample);
+    result.end_reasons = find_distinct_indices(*end_reason);
+    result.run_infos = find_distinct_indices(*run_info);
+    return result;
+}
+
+Result<std::shared_ptr<ReadTableStatistics const>> ReadTableStatistics::open(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    arrow::MemoryPool * pool)
+{
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = pool;
+
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(file, options));
+    if (!is_read_table_statistics(*reader->schema())) {
+        return std::shared_ptr<ReadTableStatistics const>();
+    }
+    if (!reader->schema()->Equals(*make_read_table_statistics_schema(nullptr), false)) {
+        return Status::IOError("Invalid read table statistics schema");
+    }
+
+    std::vector<ReadTableBatchStatistics> batches;
+    for (int i = 0; i < reader->num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadRecordBatch(i));
+        auto const min_channel = std::static_pointer_cast<arrow::UInt16Array>(batch->column(0));
+        auto const max_channel = std::static_pointer_cast<arrow::UInt16Array>(batch->column(1));
+        auto const min_num_samples = std::static_pointer_cast<arrow::UInt64Array>(batch->column(2));
+        auto const max_num_samples = std::static_pointer_cast<arrow::UInt64Array>(batch->column(3));
+        auto const min_start_sample =
+            std::static_pointer_cast<arrow::UInt64Array>(batch->column(4));
+        auto const max_start_sample =
+            std::static_pointer_cast<arrow::UInt64Array>(batch->column(5));
+        auto const end_reasons = std::static_pointer_cast<arrow::ListArray>(batch->column(6));
+        auto const run_infos = std::static_pointer_cast<arrow::ListArray>(batch->column(7));
+
+        for (std::int64_t row = 0; row < batch->num_rows(); ++row) {
+            batches.push_back(ReadTableBatchStatistics{
+                min_channel->Value(row),
+                max_channel->Value(row),
+                min_num_samples->Value(row),
+                max_num_samples->Value(row),
+                min_start_sample->Value(row),
+                max_start_sample->Value(row),
+                read_indices(*end_reasons, row),
+                read_indices(*run_infos, row)});
+        }
+    }
+    return std::make_shared<ReadTableStatistics const>(std::move(batches));
+}
+
+Result<std::shared_ptr<arrow::Buffer>> ReadTableStatistics::write(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    arrow::MemoryPool * pool) const
+{
+    auto const statistics_metadata =
+        metadata ? metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    statistics_metadata->Append(INDEX_TYPE_KEY, READ_TABLE_STATISTICS_INDEX_TYPE);
+
+    arrow::UInt16Builder min_channel(pool);
+    arrow::UInt16Builder max_channel(pool);
+    arrow::UInt64Builder min_num_samples(pool);
+    arrow::UInt64Builder max_num_samples(pool);
+    arrow::UInt64Builder min_start_sample(pool);
+    arrow::UInt64Builder max_start_sample(pool);
+    arrow::ListBuilder end_reasons(pool, std::make_shared<arrow::Int16Builder>(pool));
+    arrow::ListBuilder run_infos(pool, std::make_shared<arrow::Int16Builder>(pool));
+    for (auto const & batch : m_batches) {
+        ARROW_RETURN_NOT_OK(min_channel.Append(batch.min_channel));
+        ARROW_RETURN_NOT_OK(max_channel.Append(batch.max_channel));
+        ARROW_RETURN_NOT_OK(min_num_samples.Append(batch.min_num_samples));
+        ARROW_RETURN_NOT_OK(max_num_samples.Append(batch.max_num_samples));
+        ARROW_RETURN_NOT_OK(min_start_sample.Append(batch.min_start_sample));
+        ARROW_RETURN_NOT_OK(max_start_sample.Append(batch.max_start_sample));
+        ARROW_RETURN_NOT_OK(append_indices(end_reasons, batch.end_reasons));
+        ARROW_RETURN_NOT_OK(append_indices(run_infos, batch.run_infos));
+    }
+
+    std::vector<std::shared_ptr<arrow::Array>> columns(8);
+    ARROW_RETURN_NOT_OK(min_channel.Finish(&columns[0]));
+    ARROW_RETURN_NOT_OK(max_channel.Finish(&columns[1]));
+    ARROW_RETURN_NOT_OK(min_num_samples.Finish(&columns[2]));
+    ARROW_RETURN_NOT_OK(max_num_samples.Finish(&columns[3]));
+    ARROW_RETURN_NOT_OK(min_start_sample.Finish(&columns[4]));
+    ARROW_RETURN_NOT_OK(max_start_sample.Finish(&columns[5]));
+    ARROW_RETURN_NOT_OK(end_reasons.Finish(&columns[6]));
+    ARROW_RETURN_NOT_OK(run_infos.Finish(&columns[7]));
+
+    auto const schema = make_read_table_statistics_schema(statistics_metadata);
+    auto const batch =
+        arrow::RecordBatch::Make(schema, std::int64_t(m_batches.size()), std::move(columns));
+
+    ARROW_ASSIGN_OR_RAISE(auto sink, arrow::io::BufferOutputStream::Create(4096, pool));
+
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return sink->Finish();
+}
+
+std::vector<std::size_t> ReadTableStatistics::filter_batches(
+    ReadBatchPredicate const & predicate) const
+{
+    std::vector<std::size_t> result;
+    for (std::size_t i = 0; i < m_batches.size(); ++i) {
+        if (predicate.may_match(m_batches[i])) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+}  // namespace pod5
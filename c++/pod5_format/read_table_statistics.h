@@ -0,0 +1,102 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <arrow/io/type_fwd.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace arrow {
+class Buffer;
+class KeyValueMetadata;
+class MemoryPool;
+class RecordBatch;
+}  // namespace arrow
+
+namespace pod5 {
+
+class ReadTableSchemaDescription;
+
+/// \brief Zone map statistics for a single read table batch.
+struct POD5_FORMAT_EXPORT ReadTableBatchStatistics {
+    std::uint16_t min_channel;
+    std::uint16_t max_channel;
+    std::uint64_t min_num_samples;
+    std::uint64_t max_num_samples;
+    std::uint64_t min_start_sample;
+    std::uint64_t max_start_sample;
+    /// Sorted, distinct end reason dictionary indices used in the batch.
+    std::vector<std::int16_t> end_reasons;
+    /// Sorted, distinct run info dictionary indices used in the batch.
+    std::vector<std::int16_t> run_infos;
+};
+
+/// \brief Conditions on read table rows, used to skip batches whose statistics show no row
+///        can match. Unset conditions match every row.
+struct POD5_FORMAT_EXPORT ReadBatchPredicate {
+    /// \brief Inclusive range of values.
+    template <typename T>
+    struct Range {
+        T min;
+        T max;
+    };
+
+    std::optional<Range<std::uint16_t>> channel;
+    std::optional<Range<std::uint64_t>> num_samples;
+    std::optional<Range<std::uint64_t>> start_sample;
+    /// Dictionary indices of the end reasons to match.
+    std::optional<std::vector<std::int16_t>> end_reasons;
+    /// Dictionary indices of the run infos to match.
+    std::optional<std::vector<std::int16_t>> run_infos;
+
+    /// \brief Check if any row in a batch with [statistics] may match, false means none do.
+    bool may_match(ReadTableBatchStatistics const & statistics) const;
+};
+
+/// \brief Per batch statistics for a read table, letting readers skip batches without loading
+///        them.
+///
+/// Written into the file as an arrow table with one row per read table batch, tagged with
+/// "MINKNOW:index_type" schema metadata so it can be told apart from other OtherIndex embedded
+/// files.
+class POD5_FORMAT_EXPORT ReadTableStatistics {
+public:
+    ReadTableStatistics() = default;
+    explicit ReadTableStatistics(std::vector<ReadTableBatchStatistics> && batches);
+
+    /// \brief Compute the statistics for a read table batch laid out as [field_locations].
+    static Result<ReadTableBatchStatistics> compute_batch(
+        arrow::RecordBatch const & batch,
+        ReadTableSchemaDescription const & field_locations);
+
+    /// \brief Open statistics written by [write] from an OtherIndex embedded file.
+    /// \returns The statistics, or null if [file] holds a different kind of index.
+    static Result<std::shared_ptr<ReadTableStatistics const>> open(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+        arrow::MemoryPool * pool);
+
+    /// \brief Serialise the statistics as an arrow ipc file, tagged with [metadata].
+    Result<std::shared_ptr<arrow::Buffer>> write(
+        std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+        arrow::MemoryPool * pool) const;
+
+    /// \brief Add the statistics for the next batch in the table.
+    void add_batch(ReadTableBatchStatistics && batch) { m_batches.push_back(std::move(batch)); }
+
+    std::vector<ReadTableBatchStatistics> const & batches() const { return m_batches; }
+
+    std::size_t batch_count() const { return m_batches.size(); }
+
+    /// \brief Find the indices of the batches which may hold rows matching [predicate].
+    std::vector<std::size_t> filter_batches(ReadBatchPredicate const & predicate) const;
+
+private:
+    std::vector<ReadTableBatchStatistics> m_batches;
+};
+
+}  // namespace pod5
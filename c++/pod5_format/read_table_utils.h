@@ -7,6 +7,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -114,6 +115,52 @@ inline bool operator==(ReadData const & a, ReadData const & b)
            && a.calibration_scale == b.calibration_scale;
 }
 
+/// \brief The fields of many reads, one column per ReadData field, each holding a value for
+///        every read in the same order.
+struct ReadDataColumns {
+    /// \brief Find the number of reads, the length of every column.
+    std::size_t size() const { return read_id.size(); }
+
+    /// \brief Check every column holds a value for each of the [size()] reads.
+    bool has_consistent_sizes() const
+    {
+        auto const n = size();
+        return read_number.size() == n && start_sample.size() == n && median_before.size() == n
+               && end_reason.size() == n && end_reason_forced.size() == n && run_info.size() == n
+               && num_minknow_events.size() == n && tracked_scaling_scale.size() == n
+               && tracked_scaling_shift.size() == n && predicted_scaling_scale.size() == n
+               && predicted_scaling_shift.size() == n && num_reads_since_mux_change.size() == n
+               && time_since_mux_change.size() == n && channel.size() == n && well.size() == n
+               && pore_type.size() == n && calibration_offset.size() == n
+               && calibration_scale.size() == n;
+    }
+
+    // V1 Fields
+    gsl::span<Uuid const> read_id;
+    gsl::span<std::uint32_t const> read_number;
+    gsl::span<std::uint64_t const> start_sample;
+    gsl::span<float const> median_before;
+    gsl::span<EndReasonDictionaryIndex const> end_reason;
+    gsl::span<bool const> end_reason_forced;
+    gsl::span<RunInfoDictionaryIndex const> run_info;
+
+    // V2 Fields
+    gsl::span<std::uint64_t const> num_minknow_events;
+    gsl::span<float const> tracked_scaling_scale;
+    gsl::span<float const> tracked_scaling_shift;
+    gsl::span<float const> predicted_scaling_scale;
+    gsl::span<float const> predicted_scaling_shift;
+    gsl::span<std::uint32_t const> num_reads_since_mux_change;
+    gsl::span<float const> time_since_mux_change;
+
+    // V3 Fields
+    gsl::span<std::uint16_t const> channel;
+    gsl::span<std::uint8_t const> well;
+    gsl::span<PoreDictionaryIndex const> pore_type;
+    gsl::span<float const> calibration_offset;
+    gsl::span<float const> calibration_scale;
+};
+
 class RunInfoData {
 public:
     using MapType = std::vector<std::pair<std::string, std::string>>;
@@ -289,6 +336,7 @@ public:
         std::size_t index;
     };
 
+    /// \brief Prepare a search for [input_ids], which may be in any order.
     ReadIdSearchInput(gsl::span<Uuid const> const & input_ids);
 
     std::size_t read_id_count() const { return m_search_read_ids.size(); }
@@ -300,3 +348,50 @@ private:
 };
 
 }  // namespace pod5
+
+namespace std {
+/// Hashes every field of a run info, so equal run infos hash equally.
+template <>
+struct hash<pod5::RunInfoData> {
+    using argument_type = pod5::RunInfoData;
+    using result_type = std::size_t;
+
+    [[nodiscard]] result_type operator()(argument_type const & run_info) const
+    {
+        std::size_t seed = 0;
+        auto combine = [&](auto const & value) {
+            seed ^= std::hash<std::decay_t<decltype(value)>>{}(value) + 0x9e3779b9 + (seed << 6)
+                    + (seed >> 2);
+        };
+        auto combine_map = [&](pod5::RunInfoData::MapType const & map) {
+            combine(map.size());
+            for (auto const & item : map) {
+                combine(item.first);
+                combine(item.second);
+            }
+        };
+
+        combine(run_info.acquisition_id);
+        combine(run_info.acquisition_start_time);
+        combine(run_info.adc_max);
+        combine(run_info.adc_min);
+        combine_map(run_info.context_tags);
+        combine(run_info.experiment_name);
+        combine(run_info.flow_cell_id);
+        combine(run_info.flow_cell_product_code);
+        combine(run_info.protocol_name);
+        combine(run_info.protocol_run_id);
+        combine(run_info.protocol_start_time);
+        combine(run_info.sample_id);
+        combine(run_info.sample_rate);
+        combine(run_info.sequencing_kit);
+        combine(run_info.sequencer_position);
+        combine(run_info.sequencer_position_type);
+        combine(run_info.software);
+        combine(run_info.system_name);
+        combine(run_info.system_type);
+        combine_map(run_info.tracking_id);
+        return seed;
+    }
+};
+}  // namespace std
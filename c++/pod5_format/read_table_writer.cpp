@@ -4,14 +4,93 @@
 #include "pod5_format/internal/async_output_stream.h"
 #include "pod5_format/internal/tracing/tracing.h"
 
+#include <arrow/array/builder_primitive.h>
 #include <arrow/extension_type.h>
 #include <arrow/ipc/writer.h>
 #include <arrow/record_batch.h>
 #include <arrow/type.h>
 #include <arrow/util/compression.h>
 
+#include <algorithm>
+
 namespace pod5 {
 
+namespace {
+
+// Estimate the bytes a row takes in a batch, counting an offset for each variable length column:
+std::size_t estimate_row_bytes(arrow::Schema const & schema)
+{
+    std::size_t row_bits = 0;
+    for (auto const & field : schema.fields()) {
+        auto type = field->type();
+        if (type->id() == arrow::Type::EXTENSION) {
+            type = std::static_pointer_cast<arrow::ExtensionType>(type)->storage_type();
+        }
+        if (auto const fixed_width_type = dynamic_cast<arrow::FixedWidthType const *>(type.get())) {
+            row_bits += fixed_width_type->bit_width();
+        } else {
+            row_bits += 64;
+        }
+    }
+    return (row_bits + 7) / 8;
+}
+
+}  // namespace
+
+struct ReadTableWriter::SignalStatisticsBuilders {
+    explicit SignalStatisticsBuilders(arrow::MemoryPool * pool)
+    : min(pool)
+    , max(pool)
+    , mean(pool)
+    , standard_deviation(pool)
+    {
+    }
+
+    Status reserve(std::size_t row_count)
+    {
+        ARROW_RETURN_NOT_OK(min.Reserve(row_count));
+        ARROW_RETURN_NOT_OK(max.Reserve(row_count));
+        ARROW_RETURN_NOT_OK(mean.Reserve(row_count));
+        return standard_deviation.Reserve(row_count);
+    }
+
+    Status append(SignalStatistics const & statistics)
+    {
+        ARROW_RETURN_NOT_OK(min.Append(statistics.min));
+        ARROW_RETURN_NOT_OK(max.Append(statistics.max));
+        ARROW_RETURN_NOT_OK(mean.Append(statistics.mean));
+        return standard_deviation.Append(statistics.standard_deviation);
+    }
+
+    Status append_nulls(std::size_t row_count)
+    {
+        ARROW_RETURN_NOT_OK(min.AppendNulls(row_count));
+        ARROW_RETURN_NOT_OK(max.AppendNulls(row_count));
+        ARROW_RETURN_NOT_OK(mean.AppendNulls(row_count));
+        return standard_deviation.AppendNulls(row_count);
+    }
+
+    // Finish the columns in the order ReadTableSchemaDescription::add_signal_statistics_fields
+    // adds them to the schema:
+    Status finish_columns(std::vector<std::shared_ptr<arrow::Array>> & columns)
+    {
+        auto const finish = [&](arrow::ArrayBuilder & builder) -> Status {
+            ARROW_ASSIGN_OR_RAISE(auto column, builder.Finish());
+            columns.emplace_back(std::move(column));
+            return Status::OK();
+        };
+        ARROW_RETURN_NOT_OK(finish(min));
+        ARROW_RETURN_NOT_OK(finish(max));
+        ARROW_RETURN_NOT_OK(finish(mean));
+        return finish(standard_deviation);
+    }
+
+    arrow::Int16Builder min;
+    arrow::Int16Builder max;
+    arrow::FloatBuilder mean;
+    arrow::FloatBuilder standard_deviation;
+};
+
 ReadTableWriter::ReadTableWriter(
     std::shared_ptr<arrow::ipc::RecordBatchWriter> && writer,
     std::shared_ptr<arrow::Schema> && schema,
@@ -21,10 +100,13 @@ ReadTableWriter::ReadTableWriter(
     std::shared_ptr<EndReasonWriter> const & end_reason_writer,
     std::shared_ptr<RunInfoWriter> const & run_info_writer,
     std::shared_ptr<FileOutputStream> const & output_stream,
-    arrow::MemoryPool * pool)
+    arrow::MemoryPool * pool,
+    std::size_t table_batch_bytes)
 : m_schema(schema)
 , m_field_locations(field_locations)
 , m_table_batch_size(table_batch_size)
+, m_table_batch_bytes(table_batch_bytes)
+, m_row_bytes(estimate_row_bytes(*m_schema))
 , m_writer(std::move(writer))
 , m_field_builders(m_field_locations, pool)
 , m_output_stream{output_stream}
@@ -32,6 +114,9 @@ ReadTableWriter::ReadTableWriter(
     m_field_builders.get_builder(m_field_locations->pore_type).set_dict_writer(pore_writer);
     m_field_builders.get_builder(m_field_locations->end_reason).set_dict_writer(end_reason_writer);
     m_field_builders.get_builder(m_field_locations->run_info).set_dict_writer(run_info_writer);
+    if (m_field_locations->has_signal_statistics()) {
+        m_signal_statistics_builders = std::make_unique<SignalStatisticsBuilders>(pool);
+    }
 }
 
 ReadTableWriter::ReadTableWriter(ReadTableWriter && other) = default;
@@ -47,7 +132,8 @@ ReadTableWriter::~ReadTableWriter()
 Result<std::size_t> ReadTableWriter::add_read(
     ReadData const & read_data,
     gsl::span<SignalTableRowIndex const> const & signal,
-    std::uint64_t signal_duration)
+    std::uint64_t signal_duration,
+    SignalStatistics const * signal_statistics)
 {
     POD5_TRACE_FUNCTION();
     if (!m_writer) {
@@ -86,15 +172,142 @@ Result<std::size_t> ReadTableWriter::add_read(
         read_data.end_reason,
         read_data.end_reason_forced,
         read_data.run_info));
+    if (m_signal_statistics_builders) {
+        ARROW_RETURN_NOT_OK(
+            signal_statistics ? m_signal_statistics_builders->append(*signal_statistics)
+                              : m_signal_statistics_builders->append_nulls(1));
+    }
 
     ++m_current_batch_row_count;
+    m_current_batch_bytes += m_row_bytes + signal.size() * sizeof(SignalTableRowIndex);
 
-    if (m_current_batch_row_count >= m_table_batch_size) {
+    if (is_batch_full()) {
         ARROW_RETURN_NOT_OK(write_batch());
     }
     return row_id;
 }
 
+Result<std::size_t> ReadTableWriter::add_reads(
+    ReadDataColumns const & reads,
+    gsl::span<SignalTableRowIndex const> const & signal_rows,
+    gsl::span<std::size_t const> const & signal_row_offsets,
+    gsl::span<std::uint64_t const> const & signal_durations,
+    gsl::span<SignalStatistics const> const & signal_statistics)
+{
+    POD5_TRACE_FUNCTION();
+    if (!m_writer) {
+        return Status::IOError("Writer terminated");
+    }
+
+    auto const read_count = reads.size();
+    if (!reads.has_consistent_sizes() || signal_durations.size() != read_count
+        || signal_row_offsets.size() != read_count + 1)
+    {
+        return Status::Invalid("Read columns passed to add_reads differ in length");
+    }
+    if (!signal_statistics.empty() && signal_statistics.size() != read_count) {
+        return Status::Invalid("Signal statistics passed to add_reads differ in length");
+    }
+    for (std::size_t read = 0; read < read_count; ++read) {
+        if (signal_row_offsets[read + 1] < signal_row_offsets[read]) {
+            return Status::Invalid("Signal row offsets passed to add_reads must not decrease");
+        }
+    }
+    if (signal_row_offsets[read_count] > signal_rows.size()) {
+        return Status::Invalid("Signal row offsets passed to add_reads exceed the signal rows");
+    }
+
+    auto const first_row_id = m_written_batched_row_count + m_current_batch_row_count;
+    std::size_t start = 0;
+    while (start < read_count) {
+        ARROW_RETURN_NOT_OK(reserve_rows());
+
+        // Append up to the row that fills the current batch, as add_read would:
+        auto end =
+            start + std::min(read_count - start, m_table_batch_size - m_current_batch_row_count);
+        if (m_table_batch_bytes > 0 && m_written_batched_row_count == 0) {
+            auto batch_bytes = m_current_batch_bytes;
+            for (std::size_t read = start; read < end; ++read) {
+                batch_bytes += m_row_bytes
+                               + (signal_row_offsets[read + 1] - signal_row_offsets[read])
+                                     * sizeof(SignalTableRowIndex);
+                if (batch_bytes >= m_table_batch_bytes) {
+                    end = read + 1;
+                    break;
+                }
+            }
+        }
+
+        auto const count = end - start;
+        ARROW_RETURN_NOT_OK(m_field_builders.append_columns(
+            // V0 Fields
+            reads.read_id.subspan(start, count),
+            detail::ListColumn<SignalTableRowIndex>{
+                signal_rows, signal_row_offsets.subspan(start, count + 1)},
+            reads.read_number.subspan(start, count),
+            reads.start_sample.subspan(start, count),
+            reads.median_before.subspan(start, count),
+
+            // V1 Fields
+            reads.num_minknow_events.subspan(start, count),
+            reads.tracked_scaling_scale.subspan(start, count),
+            reads.tracked_scaling_shift.subspan(start, count),
+            reads.predicted_scaling_scale.subspan(start, count),
+            reads.predicted_scaling_shift.subspan(start, count),
+            reads.num_reads_since_mux_change.subspan(start, count),
+            reads.time_since_mux_change.subspan(start, count),
+
+            // V2 Fields
+            signal_durations.subspan(start, count),
+
+            // V3 Fields
+            reads.channel.subspan(start, count),
+            reads.well.subspan(start, count),
+            reads.pore_type.subspan(start, count),
+            reads.calibration_offset.subspan(start, count),
+            reads.calibration_scale.subspan(start, count),
+            reads.end_reason.subspan(start, count),
+            reads.end_reason_forced.subspan(start, count),
+            reads.run_info.subspan(start, count)));
+        if (m_signal_statistics_builders) {
+            if (signal_statistics.empty()) {
+                ARROW_RETURN_NOT_OK(m_signal_statistics_builders->append_nulls(count));
+            } else {
+                for (auto const & statistics : signal_statistics.subspan(start, count)) {
+                    ARROW_RETURN_NOT_OK(m_signal_statistics_builders->append(statistics));
+                }
+            }
+        }
+
+        m_current_batch_row_count += count;
+        m_current_batch_bytes += count * m_row_bytes
+                                 + (signal_row_offsets[end] - signal_row_offsets[start])
+                                       * sizeof(SignalTableRowIndex);
+
+        if (is_batch_full()) {
+            ARROW_RETURN_NOT_OK(write_batch());
+        }
+        start = end;
+    }
+    return first_row_id;
+}
+
+bool ReadTableWriter::is_batch_full()
+{
+    if (m_current_batch_row_count >= m_table_batch_size) {
+        return true;
+    }
+    if (m_table_batch_bytes == 0 || m_written_batched_row_count > 0
+        || m_current_batch_bytes < m_table_batch_bytes)
+    {
+        return false;
+    }
+
+    // Every batch must hold the same number of rows, so the first batch decides it:
+    m_table_batch_size = m_current_batch_row_count;
+    return true;
+}
+
 Status ReadTableWriter::close()
 {
     // Check for already closed
@@ -110,7 +323,13 @@ Status ReadTableWriter::close()
 
 Status ReadTableWriter::write_batch(arrow::RecordBatch const & record_batch)
 {
+    ARROW_ASSIGN_OR_RAISE(
+        auto statistics, ReadTableStatistics::compute_batch(record_batch, *m_field_locations));
+    ARROW_RETURN_NOT_OK(m_summary.add_read_table_batch(record_batch, *m_field_locations));
     ARROW_RETURN_NOT_OK(m_writer->WriteRecordBatch(record_batch));
+    // Rows added later are numbered after the passed batch's:
+    m_written_batched_row_count += record_batch.num_rows();
+    m_statistics.add_batch(std::move(statistics));
     return m_output_stream->batch_complete();
 }
 
@@ -126,14 +345,22 @@ Status ReadTableWriter::write_batch()
     }
 
     ARROW_ASSIGN_OR_RAISE(auto columns, m_field_builders.finish_columns());
+    if (m_signal_statistics_builders) {
+        ARROW_RETURN_NOT_OK(m_signal_statistics_builders->finish_columns(columns));
+    }
 
     auto const record_batch =
         arrow::RecordBatch::Make(m_schema, m_current_batch_row_count, std::move(columns));
 
     m_written_batched_row_count += m_current_batch_row_count;
     m_current_batch_row_count = 0;
+    m_current_batch_bytes = 0;
 
+    ARROW_ASSIGN_OR_RAISE(
+        auto statistics, ReadTableStatistics::compute_batch(*record_batch, *m_field_locations));
+    ARROW_RETURN_NOT_OK(m_summary.add_read_table_batch(*record_batch, *m_field_locations));
     ARROW_RETURN_NOT_OK(m_writer->WriteRecordBatch(*record_batch));
+    m_statistics.add_batch(std::move(statistics));
     return m_output_stream->batch_complete();
 }
 
@@ -144,7 +371,16 @@ Status ReadTableWriter::reserve_rows()
         return arrow::Status::OK();
     }
 
-    return m_field_builders.reserve(m_table_batch_size);
+    auto reserve_row_count = m_table_batch_size;
+    if (m_table_batch_bytes > 0) {
+        // Don't reserve many more rows than the byte target holds when the row limit is high:
+        reserve_row_count = std::min(reserve_row_count, m_table_batch_bytes / m_row_bytes + 1);
+    }
+    ARROW_RETURN_NOT_OK(m_field_builders.reserve(reserve_row_count));
+    if (m_signal_statistics_builders) {
+        ARROW_RETURN_NOT_OK(m_signal_statistics_builders->reserve(reserve_row_count));
+    }
+    return Status::OK();
 }
 
 Result<ReadTableWriter> make_read_table_writer(
@@ -154,16 +390,23 @@ Result<ReadTableWriter> make_read_table_writer(
     std::shared_ptr<PoreWriter> const & pore_writer,
     std::shared_ptr<EndReasonWriter> const & end_reason_writer,
     std::shared_ptr<RunInfoWriter> const & run_info_writer,
-    arrow::MemoryPool * pool)
+    arrow::MemoryPool * pool,
+    std::size_t table_batch_bytes,
+    arrow::Compression::type table_compression,
+    bool with_signal_statistics)
 {
     auto field_locations = std::make_shared<ReadTableSchemaDescription>();
     auto schema = field_locations->make_writer_schema(metadata);
+    if (with_signal_statistics) {
+        schema = field_locations->add_signal_statistics_fields(schema);
+    }
 
     arrow::ipc::IpcWriteOptions options;
     options.memory_pool = pool;
     options.emit_dictionary_deltas = true;
-    // todo... consider:
-    //ARROW_ASSIGN_OR_RAISE(options.codec, arrow::util::Codec::Create(arrow::Compression::LZ4_FRAME));
+    if (table_compression != arrow::Compression::UNCOMPRESSED) {
+        ARROW_ASSIGN_OR_RAISE(options.codec, arrow::util::Codec::Create(table_compression));
+    }
 
     ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options, metadata));
 
@@ -176,7 +419,8 @@ Result<ReadTableWriter> make_read_table_writer(
         end_reason_writer,
         run_info_writer,
         sink,
-        pool);
+        pool,
+        table_batch_bytes);
 
     return read_table_writer;
 }
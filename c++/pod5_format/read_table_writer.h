@@ -1,14 +1,18 @@
 #pragma once
 
+#include "pod5_format/file_summary.h"
 #include "pod5_format/pod5_format_export.h"
 #include "pod5_format/read_table_schema.h"
+#include "pod5_format/read_table_statistics.h"
 #include "pod5_format/read_table_writer_utils.h"
 #include "pod5_format/result.h"
 #include "pod5_format/schema_field_builder.h"
+#include "pod5_format/signal_summary.h"
 #include "pod5_format/signal_table_utils.h"
 
 #include <arrow/array/builder_dict.h>
 #include <arrow/io/type_fwd.h>
+#include <arrow/util/type_fwd.h>
 
 namespace arrow {
 class Schema;
@@ -33,7 +37,8 @@ public:
         std::shared_ptr<EndReasonWriter> const & end_reason_writer,
         std::shared_ptr<RunInfoWriter> const & run_info_writer,
         std::shared_ptr<FileOutputStream> const & output_stream,
-        arrow::MemoryPool * pool);
+        arrow::MemoryPool * pool,
+        std::size_t table_batch_bytes = 0);
     ReadTableWriter(ReadTableWriter &&);
     ReadTableWriter & operator=(ReadTableWriter &&);
     ReadTableWriter(ReadTableWriter const &) = delete;
@@ -44,39 +49,86 @@ public:
     /// \param read_data The data to add as a read.
     /// \param signal List of signal table row indices that belong to this read.
     /// \param signal_duration The length of the read in samples.
+    /// \param signal_statistics The statistics of the read's samples, for a table written with
+    ///        signal statistics. Left null in the table if unset.
     /// \returns The row index of the inserted read, or a status on failure.
     Result<std::size_t> add_read(
         ReadData const & read_data,
         gsl::span<SignalTableRowIndex const> const & signal,
-        std::uint64_t signal_duration);
+        std::uint64_t signal_duration,
+        SignalStatistics const * signal_statistics = nullptr);
+
+    /// \brief Add many reads to the read table at once, appending each column in bulk.
+    /// \param reads The data to add, one row per read.
+    /// \param signal_rows Signal table row indices of the reads, read i owning the rows from
+    ///                    [signal_row_offsets][i] up to [signal_row_offsets][i + 1].
+    /// \param signal_row_offsets Offsets into [signal_rows], one more than the read count.
+    /// \param signal_durations The length of each read in samples.
+    /// \param signal_statistics The statistics of each read's samples, for a table written with
+    ///        signal statistics. Left null in the table if empty.
+    /// \returns The row index of the first inserted read, or a status on failure.
+    Result<std::size_t> add_reads(
+        ReadDataColumns const & reads,
+        gsl::span<SignalTableRowIndex const> const & signal_rows,
+        gsl::span<std::size_t const> const & signal_row_offsets,
+        gsl::span<std::uint64_t const> const & signal_durations,
+        gsl::span<SignalStatistics const> const & signal_statistics = {});
 
     /// \brief Close this writer, signaling no further data will be written to the writer.
     Status close();
 
+    /// \brief Find the size of table batches for the read table writer, see
+    ///        SignalTableWriter::table_batch_size.
+    std::size_t table_batch_size() const { return m_table_batch_size; }
+
     /// \brief Reserve space for future row writes, called automatically when a flush occurs.
     Status reserve_rows();
 
+    /// \brief Find if the table holds the signal statistics fields, filled by add_read and
+    ///        add_reads.
+    bool writes_signal_statistics() const { return m_signal_statistics_builders != nullptr; }
+
     /// \brief Find the schema for the table
     std::shared_ptr<arrow::Schema> const & schema() const { return m_schema; }
 
     /// \brief Flush passed data into the writer as a record batch.
     Status write_batch(arrow::RecordBatch const &);
 
+    /// \brief Find the statistics of the batches written so far.
+    ReadTableStatistics const & statistics() const { return m_statistics; }
+
+    /// \brief Find the summary of the reads written so far.
+    FileSummary const & summary() const { return m_summary; }
+
 private:
+    struct SignalStatisticsBuilders;
+
     /// \brief Flush buffered data into the writer as a record batch.
     Status write_batch();
 
+    /// \brief Find if the current batch should be written, fixing the batch size once the first
+    ///        batch reaches the byte target.
+    bool is_batch_full();
+
     std::shared_ptr<arrow::Schema> m_schema;
     std::shared_ptr<ReadTableSchemaDescription> m_field_locations;
     std::size_t m_table_batch_size;
+    std::size_t m_table_batch_bytes;
+    // Estimated size of a row, excluding its signal row indices:
+    std::size_t m_row_bytes;
+    std::size_t m_current_batch_bytes = 0;
 
     std::shared_ptr<arrow::ipc::RecordBatchWriter> m_writer;
 
     ReadTableSchemaDescription::FieldBuilders m_field_builders;
+    // Builders of the signal statistics fields, unset if the table doesn't hold them:
+    std::unique_ptr<SignalStatisticsBuilders> m_signal_statistics_builders;
 
     std::size_t m_written_batched_row_count = 0;
     std::size_t m_current_batch_row_count = 0;
     std::shared_ptr<FileOutputStream> m_output_stream;
+    ReadTableStatistics m_statistics;
+    FileSummary m_summary;
 };
 
 /// \brief Make a new writer for a read table.
@@ -84,6 +136,10 @@ private:
 /// \param metadata Metadata to be applied to the table schema.
 /// \param table_batch_size The size of each batch written for the table.
 /// \param pool Pool to be used for building table in memory.
+/// \param table_batch_bytes Target size of the first batch, which fixes the row count of every
+///        batch, with [table_batch_size] the most rows it can hold. 0 uses [table_batch_size].
+/// \param with_signal_statistics Add the optional fields holding the statistics of each read's
+///        samples, see ReadTableSchemaDescription::signal_min.
 /// \returns The writer for the new table.
 POD5_FORMAT_EXPORT Result<ReadTableWriter> make_read_table_writer(
     std::shared_ptr<FileOutputStream> const & sink,
@@ -92,6 +148,9 @@ POD5_FORMAT_EXPORT Result<ReadTableWriter> make_read_table_writer(
     std::shared_ptr<PoreWriter> const & pore_writer,
     std::shared_ptr<EndReasonWriter> const & end_reason_writer,
     std::shared_ptr<RunInfoWriter> const & run_info_writer,
-    arrow::MemoryPool * pool);
+    arrow::MemoryPool * pool,
+    std::size_t table_batch_bytes = 0,
+    arrow::Compression::type table_compression = arrow::Compression::UNCOMPRESSED,
+    bool with_signal_statistics = false);
 
 }  // namespace pod5
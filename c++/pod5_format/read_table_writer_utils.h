@@ -15,6 +15,10 @@
 #include <chrono>
 #include <cstdint>
 #include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace pod5 {
 
@@ -175,8 +179,14 @@ class POD5_FORMAT_EXPORT PoreWriter : public DictionaryWriter {
 public:
     PoreWriter(arrow::MemoryPool * pool);
 
+    /// \brief Add [pore_type] to the dictionary, or find its index if it was added before.
     pod5::Result<PoreDictionaryIndex> add(std::string const & pore_type)
     {
+        auto const existing = m_indices.find(pore_type);
+        if (existing != m_indices.end()) {
+            return existing->second;
+        }
+
         auto const index = item_count();
 
         if (index >= std::size_t(std::numeric_limits<std::int16_t>::max())) {
@@ -185,6 +195,7 @@ public:
         }
 
         ARROW_RETURN_NOT_OK(m_builder.append(pore_type));
+        m_indices.emplace(pore_type, PoreDictionaryIndex(index));
         return index;
     }
 
@@ -193,6 +204,7 @@ public:
 
 private:
     detail::StringDictionaryKeyBuilder m_builder;
+    std::unordered_map<std::string, PoreDictionaryIndex> m_indices;
 };
 
 class POD5_FORMAT_EXPORT EndReasonWriter : public DictionaryWriter {
@@ -231,11 +243,38 @@ public:
         return index;
     }
 
+    /// \brief Add [run_info]'s acquisition id to the dictionary, keeping [run_info] so an equal
+    ///        run info added later is found by find().
+    pod5::Result<RunInfoDictionaryIndex> add(RunInfoData const & run_info)
+    {
+        ARROW_ASSIGN_OR_RAISE(auto const index, add(run_info.acquisition_id));
+        m_run_info_indices.emplace(std::hash<RunInfoData>{}(run_info), index);
+        m_run_infos.resize(std::size_t(index) + 1, std::nullopt);
+        m_run_infos[index] = run_info;
+        return index;
+    }
+
+    /// \brief Find the index of a run info equal to [run_info] added before, if there is one.
+    std::optional<RunInfoDictionaryIndex> find(RunInfoData const & run_info) const
+    {
+        // Hashes of added run infos are kept, so each candidate is compared once:
+        auto const candidates = m_run_info_indices.equal_range(std::hash<RunInfoData>{}(run_info));
+        for (auto it = candidates.first; it != candidates.second; ++it) {
+            if (*m_run_infos[it->second] == run_info) {
+                return it->second;
+            }
+        }
+        return std::nullopt;
+    }
+
     pod5::Result<std::shared_ptr<arrow::Array>> get_value_array() override;
     std::size_t item_count() override;
 
 private:
     detail::StringDictionaryKeyBuilder m_builder;
+    // Run infos added whole, by their hashes, and by index:
+    std::unordered_multimap<std::size_t, RunInfoDictionaryIndex> m_run_info_indices;
+    std::vector<std::optional<RunInfoData>> m_run_infos;
 };
 
 POD5_FORMAT_EXPORT arrow::Result<std::shared_ptr<PoreWriter>> make_pore_writer(
@@ -0,0 +1,220 @@
+#include "pod5_format/rotating_file_writer.h"
+
+#include <chrono>
+#include <exception>
+#include <limits>
+
+namespace pod5 {
+
+RotatingFileWriter::RotatingFileWriter(
+    RotatingFilePathGenerator path_generator,
+    std::string const & writing_software_name,
+    RotatingFileWriterOptions const & options)
+: m_path_generator(std::move(path_generator))
+, m_writing_software_name(writing_software_name)
+, m_options(options)
+, m_thread_pool(m_options.thread_pool() ? m_options.thread_pool() : make_thread_pool(1))
+, m_closed(false)
+, m_file_read_count(0)
+{
+}
+
+RotatingFileWriter::~RotatingFileWriter() { (void)close(); }
+
+pod5::Status RotatingFileWriter::close()
+{
+    std::lock_guard<std::mutex> l(m_sync);
+    if (m_closed) {
+        return pod5::Status::OK();
+    }
+    m_closed = true;
+
+    pod5::Status result;
+    if (m_writer) {
+        result = close_current_file();
+    }
+
+    auto const closing_result = check_closing_files(0);
+    return result.ok() ? closing_result : result;
+}
+
+pod5::Status RotatingFileWriter::add_complete_read(
+    ReadData const & read_data,
+    gsl::span<std::int16_t const> const & signal)
+{
+    std::lock_guard<std::mutex> l(m_sync);
+    if (m_closed) {
+        return pod5::Status::Invalid("File writer closed, cannot write further data");
+    }
+
+    if (read_data.run_info < 0 || std::size_t(read_data.run_info) >= m_run_infos.size()) {
+        return pod5::Status::Invalid("Invalid run info passed to add_read");
+    }
+    if (read_data.pore_type < 0 || std::size_t(read_data.pore_type) >= m_pore_types.size()) {
+        return pod5::Status::Invalid("Invalid pore type passed to add_read");
+    }
+
+    // Report files which failed to close as soon as possible:
+    ARROW_RETURN_NOT_OK(check_closing_files(MAX_CLOSING_FILES));
+
+    if (!m_writer) {
+        ARROW_RETURN_NOT_OK(open_next_file());
+    }
+
+    // Swap the writer's dictionary indexes for the current file's:
+    auto file_read_data = read_data;
+    file_read_data.run_info = m_file_run_infos[read_data.run_info];
+    file_read_data.pore_type = m_file_pore_types[read_data.pore_type];
+    ARROW_ASSIGN_OR_RAISE(
+        file_read_data.end_reason,
+        m_writer->lookup_end_reason(ReadEndReason(read_data.end_reason)));
+
+    ARROW_RETURN_NOT_OK(m_writer->add_complete_read(file_read_data, signal));
+    m_file_read_count += 1;
+
+    auto const max_file_reads = m_options.max_file_reads();
+    auto const max_file_bytes = m_options.max_file_bytes();
+    if ((max_file_reads > 0 && m_file_read_count >= max_file_reads)
+        || (max_file_bytes > 0 && m_writer->signal_bytes() >= max_file_bytes))
+    {
+        // The next file is opened by the next read, so the sequence never ends in an empty file:
+        return close_current_file();
+    }
+    return pod5::Status::OK();
+}
+
+pod5::Result<EndReasonDictionaryIndex> RotatingFileWriter::lookup_end_reason(
+    ReadEndReason end_reason) const
+{
+    // End reasons are a fixed dictionary, with the same indexes in every file:
+    if (end_reason > ReadEndReason::last_end_reason) {
+        return pod5::Status::Invalid("Invalid read end reason requested");
+    }
+    return EndReasonDictionaryIndex(end_reason);
+}
+
+pod5::Result<PoreDictionaryIndex> RotatingFileWriter::add_pore_type(
+    std::string const & pore_type_data)
+{
+    std::lock_guard<std::mutex> l(m_sync);
+    if (m_closed) {
+        return pod5::Status::Invalid("File writer closed, cannot write further data");
+    }
+    auto const existing = m_pore_type_indices.find(pore_type_data);
+    if (existing != m_pore_type_indices.end()) {
+        return existing->second;
+    }
+    if (m_pore_types.size() > std::size_t(std::numeric_limits<PoreDictionaryIndex>::max())) {
+        return pod5::Status::Invalid("Too many pore types added to writer");
+    }
+
+    if (m_writer) {
+        ARROW_ASSIGN_OR_RAISE(auto const file_index, m_writer->add_pore_type(pore_type_data));
+        m_file_pore_types.push_back(file_index);
+    }
+    m_pore_types.push_back(pore_type_data);
+    auto const index = PoreDictionaryIndex(m_pore_types.size() - 1);
+    m_pore_type_indices.emplace(pore_type_data, index);
+    return index;
+}
+
+pod5::Result<RunInfoDictionaryIndex> RotatingFileWriter::add_run_info(
+    RunInfoData const & run_info_data)
+{
+    std::lock_guard<std::mutex> l(m_sync);
+    if (m_closed) {
+        return pod5::Status::Invalid("File writer closed, cannot write further data");
+    }
+    auto const hash = std::hash<RunInfoData>{}(run_info_data);
+    auto const candidates = m_run_info_indices.equal_range(hash);
+    for (auto it = candidates.first; it != candidates.second; ++it) {
+        if (m_run_infos[it->second] == run_info_data) {
+            return it->second;
+        }
+    }
+    if (m_run_infos.size() > std::size_t(std::numeric_limits<RunInfoDictionaryIndex>::max())) {
+        return pod5::Status::Invalid("Too many run infos added to writer");
+    }
+
+    if (m_writer) {
+        ARROW_ASSIGN_OR_RAISE(auto const file_index, m_writer->add_run_info(run_info_data));
+        m_file_run_infos.push_back(file_index);
+    }
+    m_run_infos.push_back(run_info_data);
+    auto const index = RunInfoDictionaryIndex(m_run_infos.size() - 1);
+    m_run_info_indices.emplace(hash, index);
+    return index;
+}
+
+std::vector<std::string> RotatingFileWriter::paths() const
+{
+    std::lock_guard<std::mutex> l(m_sync);
+    return m_paths;
+}
+
+pod5::Status RotatingFileWriter::open_next_file()
+{
+    auto const path = m_path_generator(m_paths.size());
+    ARROW_ASSIGN_OR_RAISE(
+        auto writer,
+        create_file_writer(path, m_writing_software_name, m_options.file_writer_options()));
+    m_paths.push_back(path);
+
+    std::vector<RunInfoDictionaryIndex> file_run_infos;
+    file_run_infos.reserve(m_run_infos.size());
+    for (auto const & run_info : m_run_infos) {
+        ARROW_ASSIGN_OR_RAISE(auto const file_index, writer->add_run_info(run_info));
+        file_run_infos.push_back(file_index);
+    }
+
+    std::vector<PoreDictionaryIndex> file_pore_types;
+    file_pore_types.reserve(m_pore_types.size());
+    for (auto const & pore_type : m_pore_types) {
+        ARROW_ASSIGN_OR_RAISE(auto const file_index, writer->add_pore_type(pore_type));
+        file_pore_types.push_back(file_index);
+    }
+
+    m_writer = std::move(writer);
+    m_file_run_infos = std::move(file_run_infos);
+    m_file_pore_types = std::move(file_pore_types);
+    m_file_read_count = 0;
+    return pod5::Status::OK();
+}
+
+pod5::Status RotatingFileWriter::close_current_file()
+{
+    std::shared_ptr<FileWriter> writer = std::move(m_writer);
+    auto closed = std::make_shared<std::promise<pod5::Status>>();
+    m_closing_files.push_back(closed->get_future());
+    try {
+        m_thread_pool->post([writer, closed] { closed->set_value(writer->close()); });
+    } catch (std::exception const &) {
+        // The pool throws once stopped, so close the file here instead:
+        closed->set_value(writer->close());
+    }
+
+    // Bound the files open at once, should files fill faster than they close:
+    return check_closing_files(MAX_CLOSING_FILES);
+}
+
+pod5::Status RotatingFileWriter::check_closing_files(std::size_t wait_for_count)
+{
+    pod5::Status result;
+    while (!m_closing_files.empty()) {
+        auto & closing_file = m_closing_files.front();
+        if (m_closing_files.size() <= wait_for_count
+            && closing_file.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            break;
+        }
+
+        auto const status = closing_file.get();
+        m_closing_files.pop_front();
+        if (result.ok()) {
+            result = status;
+        }
+    }
+    return result;
+}
+
+}  // namespace pod5
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "pod5_format/file_writer.h"
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/result.h"
+#include "pod5_format/thread_pool.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pod5 {
+
+class POD5_FORMAT_EXPORT RotatingFileWriterOptions {
+public:
+    static constexpr std::size_t DEFAULT_MAX_FILE_BYTES = 4ull * 1024 * 1024 * 1024;
+    static constexpr std::size_t DEFAULT_MAX_FILE_READS = 0;
+
+    /// \brief Set the options each file in the sequence is written with.
+    void set_file_writer_options(FileWriterOptions const & file_writer_options)
+    {
+        m_file_writer_options = file_writer_options;
+    }
+
+    FileWriterOptions const & file_writer_options() const { return m_file_writer_options; }
+
+    /// \brief Set the signal bytes a file holds before the next read starts a new file.
+    /// \note Signal is counted as compressed in the file, the file's other tables are small in
+    ///       comparison but make it slightly larger. 0 sets no limit.
+    void set_max_file_bytes(std::size_t max_file_bytes) { m_max_file_bytes = max_file_bytes; }
+
+    std::size_t max_file_bytes() const { return m_max_file_bytes; }
+
+    /// \brief Set the reads a file holds before the next read starts a new file.
+    /// \note 0 sets no limit.
+    void set_max_file_reads(std::size_t max_file_reads) { m_max_file_reads = max_file_reads; }
+
+    std::size_t max_file_reads() const { return m_max_file_reads; }
+
+    /// \brief Set the thread pool full files are closed on.
+    /// \note If unset a pool with a single thread is made for the writer. Closing a file waits
+    ///       for its queued writes, so sharing the files' own writer thread pool needs a pool
+    ///       with threads to spare.
+    void set_thread_pool(std::shared_ptr<ThreadPool> const & thread_pool)
+    {
+        m_thread_pool = thread_pool;
+    }
+
+    std::shared_ptr<ThreadPool> const & thread_pool() const { return m_thread_pool; }
+
+private:
+    FileWriterOptions m_file_writer_options;
+    std::size_t m_max_file_bytes = DEFAULT_MAX_FILE_BYTES;
+    std::size_t m_max_file_reads = DEFAULT_MAX_FILE_READS;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+};
+
+/// \brief Find the path of the file at [file_index] in a rotating writer's sequence of files.
+using RotatingFilePathGenerator = std::function<std::string(std::size_t file_index)>;
+
+/// \brief Write reads to a sequence of files, starting a new file whenever one is full.
+///
+/// Run infos, pore types and end reasons are added once, and added again to each file in the
+/// sequence, so reads are added with the writer's dictionary indexes whichever file they go to.
+/// Each file is opened as its first read is added, and full files are closed on a thread pool,
+/// so adding reads doesn't wait for files to close.
+/// \note Writer calls are serialised, so a writer can be shared between threads.
+class POD5_FORMAT_EXPORT RotatingFileWriter {
+public:
+    /// \param path_generator Finds the path of each file in the sequence, none of which should
+    ///                       exist.
+    RotatingFileWriter(
+        RotatingFilePathGenerator path_generator,
+        std::string const & writing_software_name,
+        RotatingFileWriterOptions const & options = {});
+    ~RotatingFileWriter();
+
+    RotatingFileWriter(RotatingFileWriter const &) = delete;
+    RotatingFileWriter & operator=(RotatingFileWriter const &) = delete;
+
+    /// \brief Close the current file, and wait for every file to finish closing.
+    /// \returns The first error closing any file.
+    pod5::Status close();
+
+    pod5::Status add_complete_read(
+        ReadData const & read_data,
+        gsl::span<std::int16_t const> const & signal);
+
+    // Find or create an end reason index representing this read end reason.
+    pod5::Result<EndReasonDictionaryIndex> lookup_end_reason(ReadEndReason end_reason) const;
+    pod5::Result<PoreDictionaryIndex> add_pore_type(std::string const & pore_type_data);
+    pod5::Result<RunInfoDictionaryIndex> add_run_info(RunInfoData const & run_info_data);
+
+    /// \brief Find the paths of every file started so far, in order.
+    std::vector<std::string> paths() const;
+
+private:
+    /// Files closing at once, beyond which starting a new file waits for the oldest to close.
+    static constexpr std::size_t MAX_CLOSING_FILES = 2;
+
+    /// \brief Start the next file in the sequence, adding every dictionary entry to it.
+    pod5::Status open_next_file();
+    /// \brief Start closing the current file on the thread pool.
+    pod5::Status close_current_file();
+    /// \brief Check the result of files finished closing.
+    /// \param wait_for_count Wait until at most this many files are still closing.
+    pod5::Status check_closing_files(std::size_t wait_for_count);
+
+    RotatingFilePathGenerator m_path_generator;
+    std::string m_writing_software_name;
+    RotatingFileWriterOptions m_options;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+
+    mutable std::mutex m_sync;
+    bool m_closed;
+    std::vector<std::string> m_paths;
+    std::vector<RunInfoData> m_run_infos;
+    std::vector<std::string> m_pore_types;
+    // Indexes of the dictionary entries above, so adding one again finds the existing index:
+    std::unordered_multimap<std::size_t, RunInfoDictionaryIndex> m_run_info_indices;
+    std::unordered_map<std::string, PoreDictionaryIndex> m_pore_type_indices;
+
+    // The file being written, and its indexes for each of the dictionary entries above:
+    std::unique_ptr<FileWriter> m_writer;
+    std::vector<RunInfoDictionaryIndex> m_file_run_infos;
+    std::vector<PoreDictionaryIndex> m_file_pore_types;
+    std::size_t m_file_read_count;
+
+    std::deque<std::future<pod5::Status>> m_closing_files;
+};
+
+}  // namespace pod5
@@ -101,100 +101,85 @@ RunInfoTableReader::RunInfoTableReader(
 RunInfoTableReader::RunInfoTableReader(RunInfoTableReader && other)
 : TableReader(std::move(other))
 , m_field_locations(std::move(other.m_field_locations))
+, m_run_info_indices(std::move(other.m_run_info_indices))
+, m_run_info_locations(std::move(other.m_run_info_locations))
+, m_run_infos(std::move(other.m_run_infos))
 {
 }
 
 RunInfoTableReader & RunInfoTableReader::operator=(RunInfoTableReader && other)
 {
-    static_cast<TableReader &>(*this) = std::move(static_cast<TableReader &>(*this));
+    static_cast<TableReader &>(*this) = std::move(static_cast<TableReader &>(other));
     m_field_locations = std::move(other.m_field_locations);
+    m_run_info_indices = std::move(other.m_run_info_indices);
+    m_run_info_locations = std::move(other.m_run_info_locations);
+    m_run_infos = std::move(other.m_run_infos);
     return *this;
 }
 
 Result<RunInfoTableRecordBatch> RunInfoTableReader::read_record_batch(std::size_t i) const
 {
-    std::lock_guard<std::mutex> l(m_batch_get_mutex);
-    ARROW_ASSIGN_OR_RAISE(auto record_batch, reader()->ReadRecordBatch(i));
+    ARROW_ASSIGN_OR_RAISE(auto record_batch, read_batch(i, m_batch_get_mutex));
     return RunInfoTableRecordBatch{std::move(record_batch), m_field_locations};
 }
 
 Result<std::shared_ptr<RunInfoData const>> RunInfoTableReader::find_run_info(
     std::string const & acquisition_id) const
 {
-    std::lock_guard<std::mutex> l(m_run_info_lookup_mutex);
-    auto it = m_run_info_lookup.find(acquisition_id);
-    if (it != m_run_info_lookup.end()) {
-        return it->second;
-    }
-
-    ARROW_RETURN_NOT_OK(prepare_run_infos_vector());
-
-    std::shared_ptr<RunInfoData const> run_info = nullptr;
-    std::size_t glb_run_info_index = 0;
-    for (std::size_t i = 0; i < num_record_batches(); ++i) {
-        ARROW_ASSIGN_OR_RAISE(auto batch, read_record_batch(i));
-        auto acq_id = find_column(batch.batch(), m_field_locations->acquisition_id);
-
-        for (std::size_t j = 0; j < batch.num_rows(); ++j) {
-            if (acq_id->Value(j) == acquisition_id) {
-                ARROW_ASSIGN_OR_RAISE(
-                    run_info, load_run_info_from_batch(batch, j, glb_run_info_index++));
-                break;
-            }
-        }
-
-        if (run_info) {
-            break;
-        }
-    }
-
-    if (!run_info) {
+    auto const it = m_run_info_indices.find(acquisition_id);
+    if (it == m_run_info_indices.end()) {
         return arrow::Status::Invalid(
             "Failed to find acquisition id '", acquisition_id, "' in run info table");
     }
-
-    return run_info;
+    return get_run_info(it->second);
 }
 
 Result<std::shared_ptr<RunInfoData const>> RunInfoTableReader::get_run_info(std::size_t index) const
 {
-    ARROW_RETURN_NOT_OK(prepare_run_infos_vector());
-
-    if (index < 0 || index >= m_run_infos.size()) {
+    if (index >= m_run_info_locations.size()) {
         return arrow::Status::IndexError(
-            "Invalid index into run infos (expected ", index, " < ", m_run_infos.size(), ")");
+            "Invalid index into run infos (expected ",
+            index,
+            " < ",
+            m_run_info_locations.size(),
+            ")");
     }
 
-    if (m_run_infos[index]) {
-        return m_run_infos[index];
-    }
-
-    ARROW_ASSIGN_OR_RAISE(auto first_batch, read_record_batch(0));
-    auto const batch_size = first_batch.num_rows();
-
-    auto const batch_idx = index / batch_size;
-    auto const batch_row = index - (batch_idx * batch_size);
-
-    if (batch_idx >= num_record_batches()) {
-        return Status::Invalid("Row outside batch bounds");
+    {
+        std::lock_guard<std::mutex> l(m_run_info_lookup_mutex);
+        if (m_run_infos[index]) {
+            return m_run_infos[index];
+        }
     }
 
-    ARROW_ASSIGN_OR_RAISE(auto batch, read_record_batch(batch_idx));
-
-    return load_run_info_from_batch(batch, batch_row, index);
+    auto const & location = m_run_info_locations[index];
+    ARROW_ASSIGN_OR_RAISE(auto batch, read_record_batch(location.batch));
+    return load_run_info_from_batch(batch, location.batch_row, index);
 }
 
 Result<std::size_t> RunInfoTableReader::get_run_info_count() const
 {
-    auto batch_count = num_record_batches();
-    if (batch_count == 0) {
-        return 0;
-    }
+    return m_run_info_locations.size();
+}
 
-    ARROW_ASSIGN_OR_RAISE(auto first_batch, read_record_batch(0));
-    ARROW_ASSIGN_OR_RAISE(auto last_batch, read_record_batch(batch_count - 1));
+Status RunInfoTableReader::build_run_info_index()
+{
+    m_run_info_indices.clear();
+    m_run_info_locations.clear();
+    for (std::size_t i = 0; i < num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, read_record_batch(i));
+        auto acquisition_ids = find_column(batch.batch(), m_field_locations->acquisition_id);
+        for (std::size_t row = 0; row < batch.num_rows(); ++row) {
+            // Where an acquisition id repeats, lookups find its first run info:
+            m_run_info_indices.emplace(
+                acquisition_ids->GetString(row), m_run_info_locations.size());
+            m_run_info_locations.push_back({i, row});
+        }
+    }
 
-    return (batch_count - 1) * first_batch.num_rows() + last_batch.num_rows();
+    std::lock_guard<std::mutex> l(m_run_info_lookup_mutex);
+    m_run_infos.assign(m_run_info_locations.size(), nullptr);
+    return Status::OK();
 }
 
 Result<std::shared_ptr<RunInfoData const>> RunInfoTableReader::load_run_info_from_batch(
@@ -227,20 +212,12 @@ Result<std::shared_ptr<RunInfoData const>> RunInfoTableReader::load_run_info_fro
         columns.system_type->GetString(batch_index),
         value_for_map(columns.tracking_id, batch_index));
 
-    // Cache run info for later retrieval by index:
-    m_run_infos[global_index] = run_info;
-    m_run_info_lookup[acquisition_id] = run_info;
-    return run_info;
-}
-
-arrow::Status RunInfoTableReader::prepare_run_infos_vector() const
-{
-    if (m_run_infos.empty()) {
-        ARROW_ASSIGN_OR_RAISE(auto row_count, get_run_info_count())
-        m_run_infos.resize(row_count);
+    // Cache run info for later retrieval, keeping the first where threads decode it at once:
+    std::lock_guard<std::mutex> l(m_run_info_lookup_mutex);
+    if (!m_run_infos[global_index]) {
+        m_run_infos[global_index] = std::move(run_info);
     }
-
-    return Status::OK();
+    return m_run_infos[global_index];
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -263,8 +240,10 @@ Result<RunInfoTableReader> make_run_info_table_reader(
     ARROW_ASSIGN_OR_RAISE(
         auto field_locations, read_run_info_table_schema(read_metadata, reader->schema()));
 
-    return RunInfoTableReader(
+    RunInfoTableReader run_info_table_reader(
         {input}, std::move(reader), field_locations, std::move(read_metadata), pool);
+    ARROW_RETURN_NOT_OK(run_info_table_reader.build_run_info_index());
+    return run_info_table_reader;
 }
 
 }  // namespace pod5
@@ -12,7 +12,9 @@
 #include <gsl/gsl-lite.hpp>
 
 #include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace arrow {
 class Schema;
@@ -82,22 +84,35 @@ public:
 
     Result<RunInfoTableRecordBatch> read_record_batch(std::size_t i) const;
 
+    /// \brief Find the run info with [acquisition_id], through an index built when the table is
+    ///        opened.
+    /// \note Run infos are decoded on first use and cached, so later lookups don't allocate.
     Result<std::shared_ptr<RunInfoData const>> find_run_info(
         std::string const & acquisition_id) const;
 
     Result<std::shared_ptr<RunInfoData const>> get_run_info(std::size_t index) const;
     Result<std::size_t> get_run_info_count() const;
 
+    /// \brief Index the acquisition id of every run info in the table, for find_run_info().
+    Status build_run_info_index();
+
 private:
+    struct RunInfoLocation {
+        std::size_t batch;
+        std::size_t batch_row;
+    };
+
     Result<std::shared_ptr<RunInfoData const>> load_run_info_from_batch(
         RunInfoTableRecordBatch const & batch,
         std::size_t batch_index,
         std::size_t global_index) const;
-    arrow::Status prepare_run_infos_vector() const;
 
     std::shared_ptr<RunInfoTableSchemaDescription const> m_field_locations;
     mutable std::mutex m_batch_get_mutex;
-    mutable std::unordered_map<std::string, std::shared_ptr<RunInfoData const>> m_run_info_lookup;
+    // Index of each acquisition id's run info, and where each run info is in the table:
+    std::unordered_map<std::string, std::size_t> m_run_info_indices;
+    std::vector<RunInfoLocation> m_run_info_locations;
+    // Run infos decoded so far, by index:
     mutable std::vector<std::shared_ptr<RunInfoData const>> m_run_infos;
     mutable std::mutex m_run_info_lookup_mutex;
 };
@@ -136,13 +136,17 @@ Result<RunInfoTableWriter> make_run_info_table_writer(
     std::shared_ptr<FileOutputStream> const & sink,
     std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
     std::size_t table_batch_size,
-    arrow::MemoryPool * pool)
+    arrow::MemoryPool * pool,
+    arrow::Compression::type table_compression)
 {
     auto field_locations = std::make_shared<RunInfoTableSchemaDescription>();
     auto schema = field_locations->make_writer_schema(metadata);
 
     arrow::ipc::IpcWriteOptions options;
     options.memory_pool = pool;
+    if (table_compression != arrow::Compression::UNCOMPRESSED) {
+        ARROW_ASSIGN_OR_RAISE(options.codec, arrow::util::Codec::Create(table_compression));
+    }
 
     ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options, metadata));
 
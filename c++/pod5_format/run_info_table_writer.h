@@ -7,6 +7,7 @@
 
 #include <arrow/array/builder_dict.h>
 #include <arrow/io/type_fwd.h>
+#include <arrow/util/type_fwd.h>
 
 namespace arrow {
 class Schema;
@@ -80,6 +81,7 @@ POD5_FORMAT_EXPORT Result<RunInfoTableWriter> make_run_info_table_writer(
     std::shared_ptr<FileOutputStream> const & sink,
     std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
     std::size_t table_batch_size,
-    arrow::MemoryPool * pool);
+    arrow::MemoryPool * pool,
+    arrow::Compression::type table_compression = arrow::Compression::UNCOMPRESSED);
 
 }  // namespace pod5
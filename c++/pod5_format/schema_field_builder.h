@@ -6,6 +6,9 @@
 #include <arrow/array/builder_binary.h>
 #include <arrow/array/builder_nested.h>
 #include <arrow/array/builder_primitive.h>
+#include <gsl/gsl-lite.hpp>
+
+#include <vector>
 
 namespace pod5 {
 
@@ -17,6 +20,16 @@ class BuilderHelper;
 template <typename ArrayType, typename ElementArrayType>
 class ListBuilderHelper;
 
+/// \brief The lists of many rows, row i holding [values] from [offsets][i] up to
+///        [offsets][i + 1].
+template <typename T>
+struct ListColumn {
+    gsl::span<T const> values;
+    gsl::span<std::size_t const> offsets;
+
+    std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
 template <>
 class BuilderHelper<UuidArray> : public arrow::FixedSizeBinaryBuilder {
 public:
@@ -203,11 +216,63 @@ public:
         return m_array_builder->AppendValues(items.data(), items.size());
     }
 
+    template <typename T>
+    arrow::Status AppendValues(ListColumn<T> const & column)
+    {
+        auto const row_count = column.size();
+        if (row_count == 0) {
+            return arrow::Status::OK();
+        }
+
+        // List offsets index the child array, which may already hold earlier rows:
+        auto const first = column.offsets[0];
+        auto const child_start = m_array_builder->length();
+        std::vector<std::int32_t> list_offsets(row_count);
+        for (std::size_t i = 0; i < row_count; ++i) {
+            list_offsets[i] = std::int32_t(child_start + (column.offsets[i] - first));
+        }
+        ARROW_RETURN_NOT_OK(m_builder->AppendValues(list_offsets.data(), row_count));
+        return m_array_builder->AppendValues(
+            column.values.data() + first, column.offsets[row_count] - first);
+    }
+
 private:
     std::shared_ptr<BuilderHelper<ElementArrayType>> m_array_builder;
     std::unique_ptr<arrow::ListBuilder> m_builder;
 };
 
+template <typename Builder, typename T>
+arrow::Status append_column(Builder & builder, gsl::span<T const> const & values)
+{
+    return builder.AppendValues(values.data(), values.size());
+}
+
+inline arrow::Status append_column(
+    BuilderHelper<UuidArray> & builder,
+    gsl::span<Uuid const> const & values)
+{
+    static_assert(sizeof(Uuid) == 16, "Uuids must be packed to append as a column");
+    return builder.AppendValues(
+        reinterpret_cast<std::uint8_t const *>(values.data()), values.size());
+}
+
+inline arrow::Status append_column(
+    BuilderHelper<arrow::BooleanArray> & builder,
+    gsl::span<bool const> const & values)
+{
+    static_assert(sizeof(bool) == 1, "bools must be bytes to append as a column");
+    return builder.AppendValues(
+        reinterpret_cast<std::uint8_t const *>(values.data()), values.size());
+}
+
+template <typename ElementArrayType, typename T>
+arrow::Status append_column(
+    ListBuilderHelper<arrow::ListArray, ElementArrayType> & builder,
+    ListColumn<T> const & column)
+{
+    return builder.AppendValues(column);
+}
+
 }  // namespace detail
 
 template <typename... Args>
@@ -275,6 +340,22 @@ public:
         return result;
     }
 
+    /// \brief Append many rows at once, passing a column of values for each field.
+    template <typename... Columns>
+    arrow::Status append_columns(Columns const &... columns)
+    {
+        auto columns_list = std::forward_as_tuple(columns...);
+
+        arrow::Status result;
+        for_each_in_tuple_zipped(
+            m_builders, columns_list, [&](auto & builder, auto & column, std::size_t _) {
+                if (result.ok()) {
+                    result = detail::append_column(builder, column);
+                }
+            });
+        return result;
+    }
+
 private:
     BuilderTuple m_builders;
 };
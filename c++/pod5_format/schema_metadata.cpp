@@ -75,10 +75,14 @@ Result<std::shared_ptr<arrow::KeyValueMetadata const>> make_schema_key_value_met
     }
 
     return arrow::KeyValueMetadata::Make(
-        {"MINKNOW:file_identifier", "MINKNOW:software", "MINKNOW:pod5_version"},
+        {"MINKNOW:file_identifier",
+         "MINKNOW:software",
+         "MINKNOW:pod5_version",
+         "MINKNOW:signal_compression"},
         {to_string(schema_metadata.file_identifier),
          schema_metadata.writing_software,
-         schema_metadata.writing_pod5_version.to_string()});
+         schema_metadata.writing_pod5_version.to_string(),
+         to_string(schema_metadata.signal_compression_profile)});
 }
 
 Result<SchemaMetadataDescription> read_schema_key_value_metadata(
@@ -96,7 +100,16 @@ Result<SchemaMetadataDescription> read_schema_key_value_metadata(
             "Schema file_identifier metadata not uuid form: '", file_identifier_str, "'");
     }
 
-    return SchemaMetadataDescription{*file_identifier, software_str, pod5_version};
+    SignalCompressionProfile signal_compression_profile;
+    if (key_value_metadata->FindKey("MINKNOW:signal_compression") >= 0) {
+        ARROW_ASSIGN_OR_RAISE(
+            auto signal_compression_str, key_value_metadata->Get("MINKNOW:signal_compression"));
+        ARROW_ASSIGN_OR_RAISE(
+            signal_compression_profile, parse_signal_compression_profile(signal_compression_str));
+    }
+
+    return SchemaMetadataDescription{
+        *file_identifier, software_str, pod5_version, signal_compression_profile};
 }
 
 }  // namespace pod5
@@ -2,6 +2,7 @@
 
 #include "pod5_format/pod5_format_export.h"
 #include "pod5_format/result.h"
+#include "pod5_format/signal_compression.h"
 #include "pod5_format/uuid.h"
 
 #include <memory>
@@ -54,6 +55,9 @@ struct SchemaMetadataDescription {
     Uuid file_identifier;
     std::string writing_software;
     Version writing_pod5_version;
+    /// Settings the file's signal was compressed with, files written before this was recorded
+    /// were compressed with the default profile.
+    SignalCompressionProfile signal_compression_profile;
 };
 
 POD5_FORMAT_EXPORT Result<std::shared_ptr<arrow::KeyValueMetadata const>>
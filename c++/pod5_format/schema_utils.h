@@ -70,6 +70,10 @@ std::shared_ptr<typename FieldType::ArrayType> find_column(
     std::shared_ptr<arrow::RecordBatch> const & batch,
     FieldType const & field)
 {
+    // Batches loaded with a projection may not hold the field:
+    if (!field.found_field() || field.field_index() >= batch->num_columns()) {
+        return nullptr;
+    }
     auto const field_base = batch->column(field.field_index());
     return std::static_pointer_cast<typename FieldType::ArrayType>(field_base);
 }
@@ -239,6 +243,47 @@ struct ListField : public Field<WriteIndex_, ArrayType_> {
     }
 };
 
+/// \brief A field a table may hold beyond the fields of its spec version, only written when asked
+///        for, and located by name when the table is read.
+template <typename ArrayType_>
+class OptionalField {
+public:
+    using ArrayType = ArrayType_;
+
+    OptionalField(std::string name, std::shared_ptr<arrow::DataType> const & datatype)
+    : m_name(std::move(name))
+    , m_datatype(datatype)
+    {
+    }
+
+    std::string const & name() const { return m_name; }
+
+    std::shared_ptr<arrow::DataType> const & datatype() const { return m_datatype; }
+
+    int field_index() const { return m_field_index; }
+
+    void set_field_index(int index) { m_field_index = index; }
+
+    bool found_field() const { return m_field_index != (int)SpecialFieldValues::InvalidField; }
+
+    /// \brief Locate the field in [schema], leaving it not found if [schema] doesn't hold it.
+    /// \returns TypeError if [schema] holds the field with a different type.
+    Status find_in(std::shared_ptr<arrow::Schema> const & schema)
+    {
+        m_field_index = (int)SpecialFieldValues::InvalidField;
+        if (schema->GetFieldIndex(m_name) == -1) {
+            return Status::OK();
+        }
+        ARROW_ASSIGN_OR_RAISE(m_field_index, find_field(schema, m_name.c_str(), m_datatype));
+        return Status::OK();
+    }
+
+private:
+    std::string m_name;
+    std::shared_ptr<arrow::DataType> m_datatype;
+    int m_field_index = (int)SpecialFieldValues::InvalidField;
+};
+
 template <typename... Args>
 class FieldBuilder;
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "pod5_format/crc32c.h"
 #include "pod5_format/expandable_buffer.h"
+#include "pod5_format/signal_codec.h"
 #include "pod5_format/signal_compression.h"
 #include "pod5_format/signal_table_utils.h"
 #include "pod5_format/types.h"
@@ -18,15 +20,20 @@ struct UncompressedSignalBuilder {
     std::unique_ptr<arrow::LargeListBuilder> signal_builder;
 };
 
+/// Builds a column of signal compressed by [codec], vbz unless the column is CodecSignal.
 struct VbzSignalBuilder {
     ExpandableBuffer<std::int64_t> offset_values;
     ExpandableBuffer<std::uint8_t> data_values;
+    std::shared_ptr<arrow::DataType> signal_type = vbz_signal();
+    std::shared_ptr<SignalCodec const> codec = vbz_signal_codec();
 };
 
 using SignalBuilderVariant = std::variant<UncompressedSignalBuilder, VbzSignalBuilder>;
 
+/// \param codec The codec compressing signal, required for SignalType::CodecSignal.
 inline arrow::Result<SignalBuilderVariant> make_signal_builder(
     SignalType compression_type,
+    std::shared_ptr<SignalCodec const> const & codec,
     arrow::MemoryPool * pool)
 {
     if (compression_type == SignalType::UncompressedSignal) {
@@ -37,8 +44,21 @@ inline arrow::Result<SignalBuilderVariant> make_signal_builder(
         };
     } else {
         VbzSignalBuilder vbz_builder;
-        ARROW_RETURN_NOT_OK(vbz_builder.offset_values.init_buffer(pool));
-        ARROW_RETURN_NOT_OK(vbz_builder.data_values.init_buffer(pool));
+        if (compression_type == SignalType::VbzDictionarySignal) {
+            vbz_builder.signal_type = vbz_dictionary_signal();
+        } else if (compression_type == SignalType::CodecSignal) {
+            if (!codec) {
+                return arrow::Status::Invalid("Codec signal type requires a signal codec");
+            }
+            vbz_builder.signal_type = codec_signal();
+            vbz_builder.codec = codec;
+        }
+        // Buffers handed to written batches come back for later batches, a pool each so offset
+        // and data buffers keep to the sizes they have grown to:
+        ARROW_RETURN_NOT_OK(vbz_builder.offset_values.init_buffer(
+            pool, std::make_shared<ExpandableBufferPool>()));
+        ARROW_RETURN_NOT_OK(
+            vbz_builder.data_values.init_buffer(pool, std::make_shared<ExpandableBufferPool>()));
         return vbz_builder;
     }
 }
@@ -92,9 +112,11 @@ public:
 
 class append_signal {
 public:
-    append_signal(gsl::span<std::int16_t const> const & signal, arrow::MemoryPool * pool)
+    append_signal(
+        gsl::span<std::int16_t const> const & signal,
+        SignalCompressionContext & compression_context)
     : m_signal(signal)
-    , m_pool(pool)
+    , m_compression_context(compression_context)
     {
     }
 
@@ -108,17 +130,49 @@ public:
     {
         ARROW_RETURN_NOT_OK(builder.offset_values.append(builder.data_values.size()));
 
-        auto const max_size = compressed_signal_max_size(m_signal.size());
+        auto const max_size = builder.codec->max_compressed_size(m_signal.size());
 
         // Compress the signal in place into our buffer.
         return builder.data_values.append(
             max_size, [&](gsl::span<std::uint8_t> buffer) -> arrow::Result<std::size_t> {
-                return compress_signal(m_signal, m_pool, buffer);
+                return builder.codec->compress(m_signal, m_compression_context, buffer);
             });
     }
 
     gsl::span<std::int16_t const> m_signal;
-    arrow::MemoryPool * m_pool;
+    SignalCompressionContext & m_compression_context;
+};
+
+/// Find the CRC32C checksum of the last row appended from [signal], as stored in the column.
+class last_row_checksum {
+public:
+    last_row_checksum(gsl::span<std::int16_t const> const & signal) : m_signal(signal) {}
+
+    std::uint32_t operator()(UncompressedSignalBuilder const &) const
+    {
+        return crc32c(m_signal.as_span<std::uint8_t const>());
+    }
+
+    std::uint32_t operator()(VbzSignalBuilder const & builder) const
+    {
+        auto const row_start = builder.offset_values.get_data_span().back();
+        return crc32c(builder.data_values.get_data_span().subspan(row_start));
+    }
+
+    gsl::span<std::int16_t const> m_signal;
+};
+
+class signal_data_size {
+public:
+    std::size_t operator()(UncompressedSignalBuilder const & builder) const
+    {
+        return builder.signal_data_builder->length() * sizeof(std::int16_t);
+    }
+
+    std::size_t operator()(VbzSignalBuilder const & builder) const
+    {
+        return builder.data_values.size();
+    }
 };
 
 class finish_column {
@@ -132,22 +186,22 @@ public:
 
     Status operator()(VbzSignalBuilder & builder) const
     {
-        auto offsets_copy = builder.offset_values;
+        auto const length = builder.offset_values.size();
+
+        // Write final offset (values length)
+        ARROW_RETURN_NOT_OK(builder.offset_values.append(builder.data_values.size()));
+
+        auto const offsets = builder.offset_values.get_buffer();
         ARROW_RETURN_NOT_OK(builder.offset_values.clear());
 
         auto const value_data = builder.data_values.get_buffer();
         ARROW_RETURN_NOT_OK(builder.data_values.clear());
 
-        auto const length = offsets_copy.size();
-
-        // Write final offset (values length)
-        ARROW_RETURN_NOT_OK(offsets_copy.append(value_data->size()));
-        auto const offsets = offsets_copy.get_buffer();
-
         std::shared_ptr<arrow::Buffer> null_bitmap;
 
         *m_dest = arrow::MakeArray(
-            arrow::ArrayData::Make(vbz_signal(), length, {null_bitmap, offsets, value_data}, 0, 0));
+            arrow::ArrayData::Make(
+                builder.signal_type, length, {null_bitmap, offsets, value_data}, 0, 0));
 
         return arrow::Status::OK();
     }
@@ -0,0 +1,38 @@
+#include "pod5_format/signal_chunking.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace pod5 {
+
+SignalChunker::SignalChunker(std::vector<std::uint32_t> && chunk_sizes)
+: m_chunk_sizes(std::move(chunk_sizes))
+{
+}
+
+Result<SignalChunker> SignalChunker::make(std::vector<std::uint32_t> chunk_sizes)
+{
+    if (chunk_sizes.empty()) {
+        return arrow::Status::Invalid("Signal chunking needs at least one chunk size");
+    }
+    std::sort(chunk_sizes.begin(), chunk_sizes.end(), std::greater<>{});
+    if (chunk_sizes.back() == 0) {
+        return arrow::Status::Invalid("Signal chunk sizes must be greater than 0");
+    }
+    chunk_sizes.erase(std::unique(chunk_sizes.begin(), chunk_sizes.end()), chunk_sizes.end());
+    return SignalChunker{std::move(chunk_sizes)};
+}
+
+std::vector<std::uint32_t> SignalChunker::plan(std::size_t sample_count) const
+{
+    std::vector<std::uint32_t> sizes;
+    sizes.reserve(sample_count / m_chunk_sizes.front() + 1);
+    for (std::size_t start = 0; start < sample_count;) {
+        sizes.push_back(next_chunk_size(sample_count - start));
+        start += sizes.back();
+    }
+    return sizes;
+}
+
+}  // namespace pod5
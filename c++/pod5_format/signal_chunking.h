@@ -0,0 +1,50 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pod5 {
+
+/// \brief Splits a read's signal into the chunks stored as its signal table rows.
+///
+/// Each chunk takes the largest of the chunker's sizes which fits the samples left in the read,
+/// the last holding whatever is left below the smallest size. Chunks depend only on the read's
+/// sample count, so a read is chunked the same way in every file written with the same sizes,
+/// and sizes which are all multiples of a consumer's window put every boundary on one.
+class POD5_FORMAT_EXPORT SignalChunker {
+public:
+    /// \brief Make a chunker splitting reads into chunks with sizes from [chunk_sizes].
+    /// \returns The chunker, or an error if no sizes are given or any is 0.
+    static Result<SignalChunker> make(std::vector<std::uint32_t> chunk_sizes);
+
+    /// \brief Find the largest chunk the chunker makes.
+    std::uint32_t max_chunk_size() const { return m_chunk_sizes.front(); }
+
+    /// \brief Find the chunk sizes, largest first.
+    std::vector<std::uint32_t> const & chunk_sizes() const { return m_chunk_sizes; }
+
+    /// \brief Find the size of the next chunk of a read with [remaining_samples] left to chunk.
+    std::uint32_t next_chunk_size(std::size_t remaining_samples) const
+    {
+        for (auto const size : m_chunk_sizes) {
+            if (size <= remaining_samples) {
+                return size;
+            }
+        }
+        return std::uint32_t(remaining_samples);
+    }
+
+    /// \brief Find the sizes of the chunks a read of [sample_count] samples is split into.
+    std::vector<std::uint32_t> plan(std::size_t sample_count) const;
+
+private:
+    explicit SignalChunker(std::vector<std::uint32_t> && chunk_sizes);
+
+    std::vector<std::uint32_t> m_chunk_sizes;
+};
+
+}  // namespace pod5
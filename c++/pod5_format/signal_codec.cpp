@@ -0,0 +1,188 @@
+#include "pod5_format/signal_codec.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace pod5 {
+
+char const * const VBZ_SIGNAL_CODEC_ID = "vbz";
+
+namespace {
+
+class VbzSignalCodec : public SignalCodec {
+public:
+    std::string id() const override { return VBZ_SIGNAL_CODEC_ID; }
+
+    std::size_t max_compressed_size(std::size_t sample_count) const override
+    {
+        return compressed_signal_max_size(sample_count);
+    }
+
+    Result<std::size_t> compress(
+        gsl::span<SampleType const> const & samples,
+        SignalCompressionContext & context,
+        gsl::span<std::uint8_t> const & destination) const override
+    {
+        return compress_signal(samples, context, destination);
+    }
+
+    Status decompress(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        SignalCompressionContext & context,
+        gsl::span<SampleType> const & destination) const override
+    {
+        return decompress_signal(compressed_bytes, context, destination);
+    }
+
+    Status decompress_calibrated(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        SignalCompressionContext & context,
+        SignalCalibration const & calibration,
+        gsl::span<float> const & destination) const override
+    {
+        return decompress_signal_calibrated(compressed_bytes, context, calibration, destination);
+    }
+
+    Status decompress_calibrated(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        SignalCompressionContext & context,
+        SignalCalibration const & calibration,
+        gsl::span<Float16> const & destination) const override
+    {
+        return decompress_signal_calibrated(compressed_bytes, context, calibration, destination);
+    }
+
+    Status decompress_calibrated(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        SignalCompressionContext & context,
+        SignalCalibration const & calibration,
+        gsl::span<std::int8_t> const & destination) const override
+    {
+        return decompress_signal_calibrated(compressed_bytes, context, calibration, destination);
+    }
+};
+
+struct SignalCodecRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<SignalCodec const>> codecs{
+        {VBZ_SIGNAL_CODEC_ID, vbz_signal_codec()},
+    };
+};
+
+SignalCodecRegistry & signal_codec_registry()
+{
+    static SignalCodecRegistry registry;
+    return registry;
+}
+
+}  // namespace
+
+SignalCodec::~SignalCodec() = default;
+
+namespace {
+template <typename OutputType>
+Status decompress_then_calibrate(
+    SignalCodec const & codec,
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<OutputType> const & destination)
+{
+    std::vector<SampleType> samples(destination.size());
+    ARROW_RETURN_NOT_OK(codec.decompress(compressed_bytes, context, gsl::make_span(samples)));
+    calibrate_signal(gsl::make_span(samples), calibration, destination);
+    return Status::OK();
+}
+}  // namespace
+
+Status SignalCodec::decompress_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<float> const & destination) const
+{
+    return decompress_then_calibrate(*this, compressed_bytes, context, calibration, destination);
+}
+
+Status SignalCodec::decompress_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<Float16> const & destination) const
+{
+    return decompress_then_calibrate(*this, compressed_bytes, context, calibration, destination);
+}
+
+Status SignalCodec::decompress_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<std::int8_t> const & destination) const
+{
+    return decompress_then_calibrate(*this, compressed_bytes, context, calibration, destination);
+}
+
+Status SignalCodec::decompress_rows(
+    gsl::span<gsl::span<std::uint8_t const> const> const & compressed_rows,
+    SignalCompressionContext & context,
+    gsl::span<gsl::span<SampleType> const> const & destinations) const
+{
+    if (compressed_rows.size() != destinations.size()) {
+        return Status::Invalid(
+            "Row count (",
+            compressed_rows.size(),
+            ") must match the destination count (",
+            destinations.size(),
+            ")");
+    }
+    for (std::size_t i = 0; i < compressed_rows.size(); ++i) {
+        ARROW_RETURN_NOT_OK(decompress(compressed_rows[i], context, destinations[i]));
+    }
+    return Status::OK();
+}
+
+std::shared_ptr<SignalCodec const> vbz_signal_codec()
+{
+    static auto codec = std::make_shared<VbzSignalCodec>();
+    return codec;
+}
+
+Status register_signal_codec(std::shared_ptr<SignalCodec const> const & codec)
+{
+    if (!codec) {
+        return Status::Invalid("Can't register a null signal codec");
+    }
+    auto & registry = signal_codec_registry();
+    std::lock_guard<std::mutex> l(registry.mutex);
+    if (!registry.codecs.emplace(codec->id(), codec).second) {
+        return Status::Invalid("A signal codec is already registered with id '", codec->id(), "'");
+    }
+    return Status::OK();
+}
+
+Status unregister_signal_codec(std::string const & id)
+{
+    if (id == VBZ_SIGNAL_CODEC_ID) {
+        return Status::Invalid("The built in vbz signal codec can't be unregistered");
+    }
+    auto & registry = signal_codec_registry();
+    std::lock_guard<std::mutex> l(registry.mutex);
+    if (registry.codecs.erase(id) == 0) {
+        return Status::Invalid("No signal codec is registered with id '", id, "'");
+    }
+    return Status::OK();
+}
+
+Result<std::shared_ptr<SignalCodec const>> find_signal_codec(std::string const & id)
+{
+    auto & registry = signal_codec_registry();
+    std::lock_guard<std::mutex> l(registry.mutex);
+    auto const it = registry.codecs.find(id);
+    if (it == registry.codecs.end()) {
+        return Status::NotImplemented("No signal codec is registered with id '", id, "'");
+    }
+    return it->second;
+}
+
+}  // namespace pod5
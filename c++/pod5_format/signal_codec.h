@@ -0,0 +1,98 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+#include "pod5_format/signal_compression.h"
+
+#include <gsl/gsl-lite.hpp>
+
+#include <memory>
+#include <string>
+
+namespace pod5 {
+
+/// The id of the built in vbz codec, used by SignalType::VbzSignal and
+/// SignalType::VbzDictionarySignal tables.
+POD5_FORMAT_EXPORT extern char const * const VBZ_SIGNAL_CODEC_ID;
+
+/// \brief Encodes and decodes the signal of a compressed signal table.
+///
+/// Tables of SignalType::CodecSignal record their codec's id in the schema metadata, and are
+/// readable by any process registering a codec with that id (see register_signal_codec()).
+/// \note Codecs are shared between threads, so must keep any per call state in the
+///       SignalCompressionContext passed to them, or their own thread safe storage.
+class POD5_FORMAT_EXPORT SignalCodec {
+public:
+    virtual ~SignalCodec();
+
+    /// \brief The id stored in the files written with this codec.
+    virtual std::string id() const = 0;
+
+    /// \brief Find the most bytes compress() writes for [sample_count] samples.
+    virtual std::size_t max_compressed_size(std::size_t sample_count) const = 0;
+
+    /// \brief Compress [samples] into [destination], sized by max_compressed_size().
+    /// \returns The number of bytes written to [destination].
+    virtual Result<std::size_t> compress(
+        gsl::span<SampleType const> const & samples,
+        SignalCompressionContext & context,
+        gsl::span<std::uint8_t> const & destination) const = 0;
+
+    /// \brief Decompress a row's signal into [destination], sized by the row's sample count.
+    virtual Status decompress(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        SignalCompressionContext & context,
+        gsl::span<SampleType> const & destination) const = 0;
+
+    /// \brief Decompress a row's signal straight to picoamps.
+    /// \note Decompresses to a temporary copy before calibrating, unless overridden.
+    virtual Status decompress_calibrated(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        SignalCompressionContext & context,
+        SignalCalibration const & calibration,
+        gsl::span<float> const & destination) const;
+
+    /// \brief Decompress a row's signal straight to half precision picoamps, see
+    ///        calibrate_signal().
+    /// \note Decompresses to a temporary copy before calibrating, unless overridden.
+    virtual Status decompress_calibrated(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        SignalCompressionContext & context,
+        SignalCalibration const & calibration,
+        gsl::span<Float16> const & destination) const;
+
+    /// \brief Decompress a row's signal straight to clamped 8 bit levels, see calibrate_signal().
+    /// \note Decompresses to a temporary copy before calibrating, unless overridden.
+    virtual Status decompress_calibrated(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        SignalCompressionContext & context,
+        SignalCalibration const & calibration,
+        gsl::span<std::int8_t> const & destination) const;
+
+    /// \brief Decompress many rows of one batch at once, each row into the matching entry of
+    ///        [destinations].
+    /// \note Decompresses each row in turn, unless overridden by codecs decoding many rows
+    ///       faster together (for example, on a GPU).
+    virtual Status decompress_rows(
+        gsl::span<gsl::span<std::uint8_t const> const> const & compressed_rows,
+        SignalCompressionContext & context,
+        gsl::span<gsl::span<SampleType> const> const & destinations) const;
+};
+
+/// \brief Find the built in vbz codec.
+POD5_FORMAT_EXPORT std::shared_ptr<SignalCodec const> vbz_signal_codec();
+
+/// \brief Register [codec] so tables written with it can be read.
+/// \returns Invalid if a codec is already registered with the codec's id.
+POD5_FORMAT_EXPORT Status register_signal_codec(std::shared_ptr<SignalCodec const> const & codec);
+
+/// \brief Unregister the codec with [id].
+/// \returns Invalid for the built in vbz codec, or if no codec is registered with [id].
+POD5_FORMAT_EXPORT Status unregister_signal_codec(std::string const & id);
+
+/// \brief Find the registered codec with [id].
+/// \returns NotImplemented if no codec is registered with [id].
+POD5_FORMAT_EXPORT Result<std::shared_ptr<SignalCodec const>> find_signal_codec(
+    std::string const & id);
+
+}  // namespace pod5
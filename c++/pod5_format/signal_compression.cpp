@@ -1,13 +1,303 @@
 #include "pod5_format/signal_compression.h"
 
+#include "pod5_format/internal/tracing/tracing.h"
+#include "pod5_format/memory_pool.h"
 #include "pod5_format/svb16/decode.hpp"
 #include "pod5_format/svb16/encode.hpp"
+#include "pod5_format/thread_pool.h"
 
 #include <arrow/buffer.h>
+#include <zdict.h>
 #include <zstd.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
 namespace pod5 {
 
+namespace {
+// Size of the window zstd output is streamed through when decoding large signals.
+// Small enough to stay resident in L2 alongside the decoded samples.
+constexpr std::size_t STREAMING_DECODE_WINDOW_SIZE = 64 * 1024;
+
+// Decoded svb16 size above which signal is streamed rather than inflated into scratch space.
+//
+// zstd keeps its own history window when streaming, so throughput is similar to the buffered
+// path - but streaming avoids holding a scratch buffer the size of the largest read.
+constexpr std::size_t STREAMING_DECODE_THRESHOLD = 4 * 1024 * 1024;
+
+// Samples decoded at a time when calibrating, small enough that the int16 tile stays in L1.
+// Must be a multiple of 8 so each tile starts on a whole svb16 key byte.
+constexpr std::size_t CALIBRATED_DECODE_TILE_SIZE = 2048;
+
+constexpr bool UseDelta = true;
+constexpr bool UseZigzag = true;
+
+// Encoded bytes of each read used when training a dictionary, the dictionary is aimed at short
+// reads so the start of longer reads is representative enough.
+constexpr std::size_t DICTIONARY_TRAINING_MAX_READ_BYTES = 128 * 1024;
+}  // namespace
+
+struct SignalCompressionDictionary::Impl {
+    ~Impl() { ZSTD_freeDDict(ddict); }
+
+    std::shared_ptr<arrow::Buffer> data;
+    ZSTD_DDict * ddict = nullptr;
+    std::uint32_t id = 0;
+};
+
+SignalCompressionDictionary::SignalCompressionDictionary(std::unique_ptr<Impl> && impl)
+: m_impl(std::move(impl))
+{
+}
+
+SignalCompressionDictionary::~SignalCompressionDictionary() = default;
+
+arrow::Result<std::shared_ptr<SignalCompressionDictionary const>> SignalCompressionDictionary::make(
+    std::shared_ptr<arrow::Buffer> const & data)
+{
+    if (!data || data->size() == 0) {
+        return pod5::Status::Invalid("Signal compression dictionary is empty");
+    }
+
+    auto impl = std::make_unique<Impl>();
+    impl->data = data;
+    impl->id = ZSTD_getDictID_fromDict(data->data(), data->size());
+    if (impl->id == 0) {
+        return pod5::Status::Invalid("Signal compression dictionary is not a zstd dictionary");
+    }
+    impl->ddict = ZSTD_createDDict(data->data(), data->size());
+    if (!impl->ddict) {
+        return pod5::Status::Invalid("Failed to load signal compression dictionary");
+    }
+
+    return std::shared_ptr<SignalCompressionDictionary const>(
+        new SignalCompressionDictionary(std::move(impl)));
+}
+
+std::shared_ptr<arrow::Buffer> const & SignalCompressionDictionary::data() const
+{
+    return m_impl->data;
+}
+
+std::uint32_t SignalCompressionDictionary::id() const { return m_impl->id; }
+
+struct SignalCompressionContext::Impl {
+    Impl(arrow::MemoryPool * pool_, SignalCompressionProfile const & profile_)
+    : pool(pool_ ? pool_ : default_memory_pool())
+    , profile(profile_)
+    {
+    }
+
+    ~Impl()
+    {
+        ZSTD_freeCCtx(cctx);
+        ZSTD_freeDCtx(dctx);
+    }
+
+    Result<ZSTD_CCtx *> compression_context()
+    {
+        if (!cctx) {
+            cctx = ZSTD_createCCtx();
+            if (!cctx) {
+                return pod5::Status::OutOfMemory("Failed to create zstd compression context");
+            }
+            profile_applied = false;
+        }
+        if (!profile_applied) {
+            ARROW_RETURN_NOT_OK(apply_profile(cctx, profile));
+            if (dictionary) {
+                // zstd digests the dictionary once and reuses it for every following frame:
+                auto const & data = dictionary->data();
+                if (ZSTD_isError(ZSTD_CCtx_loadDictionary(cctx, data->data(), data->size()))) {
+                    return pod5::Status::Invalid("Failed to load signal compression dictionary");
+                }
+            }
+            profile_applied = true;
+        }
+        return cctx;
+    }
+
+    Result<ZSTD_DCtx *> decompression_context()
+    {
+        if (!dctx) {
+            dctx = ZSTD_createDCtx();
+            if (!dctx) {
+                return pod5::Status::OutOfMemory("Failed to create zstd decompression context");
+            }
+            applied_ddict = nullptr;
+        }
+        ZSTD_DDict const * const ddict = dictionary ? dictionary->impl().ddict : nullptr;
+        if (ddict != applied_ddict) {
+            if (ZSTD_isError(ZSTD_DCtx_refDDict(dctx, ddict))) {
+                return pod5::Status::Invalid("Failed to use signal compression dictionary");
+            }
+            applied_ddict = ddict;
+        }
+        return dctx;
+    }
+
+    Result<gsl::span<std::uint8_t>> scratch_space(std::size_t size)
+    {
+        return reuse_buffer(scratch, size);
+    }
+
+    Result<gsl::span<std::uint8_t>> window_space(std::size_t size)
+    {
+        return reuse_buffer(window, size);
+    }
+
+    arrow::MemoryPool * pool;
+    SignalCompressionProfile profile;
+    bool profile_applied = false;
+    std::shared_ptr<SignalCompressionDictionary const> dictionary;
+    ZSTD_DDict const * applied_ddict = nullptr;
+    ZSTD_CCtx * cctx = nullptr;
+    ZSTD_DCtx * dctx = nullptr;
+    std::unique_ptr<arrow::ResizableBuffer> scratch;
+    std::unique_ptr<arrow::ResizableBuffer> window;
+
+    static arrow::Status apply_profile(ZSTD_CCtx * cctx, SignalCompressionProfile const & profile)
+    {
+        ZSTD_CCtx_reset(cctx, ZSTD_reset_parameters);
+        if (ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, profile.level))) {
+            return pod5::Status::Invalid("Invalid zstd compression level ", profile.level);
+        }
+        if (ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_strategy, profile.strategy))) {
+            return pod5::Status::Invalid("Invalid zstd compression strategy ", profile.strategy);
+        }
+        if (ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, profile.worker_count))) {
+            return pod5::Status::NotImplemented(
+                "zstd worker count ", profile.worker_count, " not supported by this zstd build");
+        }
+        return arrow::Status::OK();
+    }
+
+private:
+    /// Find a buffer of at least [size] bytes, reusing the existing allocation where possible.
+    Result<gsl::span<std::uint8_t>> reuse_buffer(
+        std::unique_ptr<arrow::ResizableBuffer> & buffer,
+        std::size_t size)
+    {
+        if (!buffer) {
+            ARROW_ASSIGN_OR_RAISE(buffer, arrow::AllocateResizableBuffer(size, pool));
+        } else if ((std::size_t)buffer->size() < size) {
+            ARROW_RETURN_NOT_OK(buffer->Resize(size, false));
+        }
+        return gsl::make_span(buffer->mutable_data(), size);
+    }
+};
+
+SignalCompressionContext::SignalCompressionContext(
+    arrow::MemoryPool * pool,
+    SignalCompressionProfile const & profile)
+: m_impl(std::make_unique<Impl>(pool, profile))
+{
+}
+
+SignalCompressionContext::~SignalCompressionContext() = default;
+SignalCompressionContext::SignalCompressionContext(SignalCompressionContext &&) = default;
+SignalCompressionContext & SignalCompressionContext::operator=(SignalCompressionContext &&) =
+    default;
+
+void SignalCompressionContext::set_profile(SignalCompressionProfile const & profile)
+{
+    if (m_impl->profile != profile) {
+        m_impl->profile = profile;
+        m_impl->profile_applied = false;
+    }
+}
+
+SignalCompressionProfile const & SignalCompressionContext::profile() const
+{
+    return m_impl->profile;
+}
+
+void SignalCompressionContext::set_dictionary(
+    std::shared_ptr<SignalCompressionDictionary const> const & dictionary)
+{
+    if (m_impl->dictionary != dictionary) {
+        m_impl->dictionary = dictionary;
+        m_impl->profile_applied = false;
+    }
+}
+
+std::shared_ptr<SignalCompressionDictionary const> const & SignalCompressionContext::dictionary()
+    const
+{
+    return m_impl->dictionary;
+}
+
+SignalCompressionContext & thread_local_signal_compression_context()
+{
+    thread_local SignalCompressionContext context;
+    return context;
+}
+
+arrow::Status check_signal_compression_profile(SignalCompressionProfile const & profile)
+{
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx{ZSTD_createCCtx(), &ZSTD_freeCCtx};
+    if (!cctx) {
+        return pod5::Status::OutOfMemory("Failed to create zstd compression context");
+    }
+    return SignalCompressionContext::Impl::apply_profile(cctx.get(), profile);
+}
+
+std::string to_string(SignalCompressionProfile const & profile)
+{
+    return "zstd_level=" + std::to_string(profile.level) + ";zstd_strategy="
+           + std::to_string(profile.strategy) + ";zstd_workers="
+           + std::to_string(profile.worker_count);
+}
+
+arrow::Result<SignalCompressionProfile> parse_signal_compression_profile(
+    std::string const & profile_str)
+{
+    SignalCompressionProfile profile;
+    std::size_t position = 0;
+    while (position < profile_str.size()) {
+        auto end = profile_str.find(';', position);
+        if (end == std::string::npos) {
+            end = profile_str.size();
+        }
+        auto const entry = profile_str.substr(position, end - position);
+        position = end + 1;
+
+        auto const separator = entry.find('=');
+        if (separator == std::string::npos) {
+            return pod5::Status::Invalid("Invalid signal compression profile '", profile_str, "'");
+        }
+        auto const key = entry.substr(0, separator);
+        int value = 0;
+        try {
+            std::size_t parsed_chars = 0;
+            value = std::stoi(entry.substr(separator + 1), &parsed_chars);
+            if (parsed_chars != entry.size() - separator - 1) {
+                throw std::invalid_argument("Trailing characters");
+            }
+        } catch (std::exception const &) {
+            return pod5::Status::Invalid("Invalid signal compression profile '", profile_str, "'");
+        }
+
+        // Unknown keys are skipped, so newer writers can record extra settings.
+        if (key == "zstd_level") {
+            profile.level = value;
+        } else if (key == "zstd_strategy") {
+            profile.strategy = value;
+        } else if (key == "zstd_workers") {
+            profile.worker_count = value;
+        }
+    }
+    return profile;
+}
+
 std::size_t compressed_signal_max_size(std::size_t sample_count)
 {
     auto const max_svb_size = svb16_max_encoded_length(sample_count);
@@ -17,37 +307,45 @@ std::size_t compressed_signal_max_size(std::size_t sample_count)
 
 arrow::Result<std::size_t> compress_signal(
     gsl::span<SampleType const> const & samples,
-    arrow::MemoryPool * pool,
+    SignalCompressionContext & context,
     gsl::span<std::uint8_t> const & destination)
 {
+    POD5_TRACE_FUNCTION();
+    auto & impl = context.impl();
+
     // First compress the data using svb:
     auto const max_size = svb16_max_encoded_length(samples.size());
-    ARROW_ASSIGN_OR_RAISE(auto intermediate, arrow::AllocateResizableBuffer(max_size, pool));
+    ARROW_ASSIGN_OR_RAISE(auto intermediate, impl.scratch_space(max_size));
 
-    static constexpr bool UseDelta = true;
-    static constexpr bool UseZigzag = true;
     auto const encoded_count = svb16::encode<SampleType, UseDelta, UseZigzag>(
-        samples.data(), intermediate->mutable_data(), samples.size());
-    ARROW_RETURN_NOT_OK(intermediate->Resize(encoded_count));
+        samples.data(), intermediate.data(), samples.size());
 
     // Now compress the svb data using zstd:
-    size_t const zstd_compressed_max_size = ZSTD_compressBound(intermediate->size());
+    size_t const zstd_compressed_max_size = ZSTD_compressBound(encoded_count);
     if (ZSTD_isError(zstd_compressed_max_size)) {
         return pod5::Status::Invalid("Failed to find zstd max size for data");
     }
 
-    /* Compress.
-     * If you are doing many compressions, you may want to reuse the context.
-     * See the multiple_simple_compression.c example.
-     */
-    size_t const compressed_size = ZSTD_compress(
-        destination.data(), destination.size(), intermediate->data(), intermediate->size(), 1);
+    ARROW_ASSIGN_OR_RAISE(auto cctx, impl.compression_context());
+    size_t const compressed_size = ZSTD_compress2(
+        cctx, destination.data(), destination.size(), intermediate.data(), encoded_count);
     if (ZSTD_isError(compressed_size)) {
         return pod5::Status::Invalid("Failed to compress data");
     }
     return compressed_size;
 }
 
+arrow::Result<std::size_t> compress_signal(
+    gsl::span<SampleType const> const & samples,
+    arrow::MemoryPool *,
+    gsl::span<std::uint8_t> const & destination)
+{
+    auto & context = thread_local_signal_compression_context();
+    context.set_profile({});
+    context.set_dictionary(nullptr);
+    return compress_signal(samples, context, destination);
+}
+
 arrow::Result<std::shared_ptr<arrow::Buffer>> compress_signal(
     gsl::span<SampleType const> const & samples,
     arrow::MemoryPool * pool)
@@ -64,12 +362,256 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> compress_signal(
     return out;
 }
 
-POD5_FORMAT_EXPORT arrow::Status decompress_signal(
-    gsl::span<std::uint8_t const> const & compressed_bytes,
+arrow::Result<std::shared_ptr<SignalCompressionDictionary const>>
+train_signal_compression_dictionary(
+    gsl::span<gsl::span<SampleType const> const> const & samples,
+    std::size_t max_dictionary_size,
+    arrow::MemoryPool * pool)
+{
+    pool = pool ? pool : default_memory_pool();
+
+    std::size_t training_size = 0;
+    for (auto const & read_samples : samples) {
+        training_size += std::min<std::size_t>(
+            svb16_max_encoded_length(read_samples.size()), DICTIONARY_TRAINING_MAX_READ_BYTES);
+    }
+
+    // zdict trains on a single buffer holding every sample back to back:
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::ResizableBuffer> training_data,
+        arrow::AllocateResizableBuffer(training_size, pool));
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::ResizableBuffer> encoded,
+        arrow::AllocateResizableBuffer(0, pool));
+
+    std::vector<std::size_t> training_sample_sizes;
+    training_sample_sizes.reserve(samples.size());
+    std::size_t training_offset = 0;
+    for (auto const & read_samples : samples) {
+        ARROW_RETURN_NOT_OK(encoded->Resize(svb16_max_encoded_length(read_samples.size()), false));
+        auto const encoded_count = svb16::encode<SampleType, UseDelta, UseZigzag>(
+            read_samples.data(), encoded->mutable_data(), read_samples.size());
+
+        auto const used_count =
+            std::min<std::size_t>(encoded_count, DICTIONARY_TRAINING_MAX_READ_BYTES);
+        std::memcpy(
+            training_data->mutable_data() + training_offset, encoded->data(), used_count);
+        training_offset += used_count;
+        training_sample_sizes.push_back(used_count);
+    }
+
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::ResizableBuffer> dictionary,
+        arrow::AllocateResizableBuffer(max_dictionary_size, pool));
+    auto const dictionary_size = ZDICT_trainFromBuffer(
+        dictionary->mutable_data(),
+        max_dictionary_size,
+        training_data->data(),
+        training_sample_sizes.data(),
+        training_sample_sizes.size());
+    if (ZDICT_isError(dictionary_size)) {
+        return pod5::Status::Invalid(
+            "Failed to train signal compression dictionary: ",
+            ZDICT_getErrorName(dictionary_size));
+    }
+    ARROW_RETURN_NOT_OK(dictionary->Resize(dictionary_size));
+
+    return SignalCompressionDictionary::make(std::move(dictionary));
+}
+
+namespace {
+// Number of samples compressed by one task of a batch, large enough that claiming a task is
+// cheap relative to the work, small enough that short reads still spread across workers.
+constexpr std::size_t BATCH_COMPRESSION_TASK_SAMPLES = 256 * 1024;
+
+// Upper bound on helper tasks posted to a thread pool for a single batch.
+constexpr std::size_t BATCH_COMPRESSION_MAX_HELPERS = 64;
+
+struct BatchCompressionState {
+    gsl::span<gsl::span<SampleType const> const> samples;
+    gsl::span<std::uint8_t> destination;
+    SignalCompressionProfile profile;
+    std::shared_ptr<SignalCompressionDictionary const> dictionary;
+    // Worst case offset of each read in [destination], each read is compressed into its own slot.
+    std::vector<std::size_t> slot_offsets;
+    std::vector<std::size_t> compressed_sizes;
+    // Task i compresses reads [task_starts[i], task_starts[i + 1]).
+    std::vector<std::size_t> task_starts;
+
+    std::atomic<std::size_t> next_task{0};
+
+    std::mutex mutex;
+    std::condition_variable tasks_complete;
+    std::size_t completed_tasks{0};
+    arrow::Status status;
+
+    std::size_t task_count() const { return task_starts.size() - 1; }
+
+    // Claim and run tasks until there are none left.
+    void run()
+    {
+        SignalCompressionContext * context = nullptr;
+        while (true) {
+            auto const task = next_task.fetch_add(1);
+            if (task >= task_count()) {
+                return;
+            }
+            if (!context) {
+                context = &thread_local_signal_compression_context();
+                context->set_profile(profile);
+                context->set_dictionary(dictionary);
+            }
+
+            arrow::Status task_status;
+            for (auto read = task_starts[task]; read < task_starts[task + 1]; ++read) {
+                auto const slot = destination.subspan(
+                    slot_offsets[read], slot_offsets[read + 1] - slot_offsets[read]);
+                auto compressed_size = compress_signal(samples[read], *context, slot);
+                if (!compressed_size.ok()) {
+                    task_status = compressed_size.status();
+                    break;
+                }
+                compressed_sizes[read] = *compressed_size;
+            }
+
+            std::lock_guard<std::mutex> lock{mutex};
+            if (status.ok()) {
+                status = task_status;
+            }
+            completed_tasks += 1;
+            if (completed_tasks == task_count()) {
+                tasks_complete.notify_all();
+            }
+        }
+    }
+};
+}  // namespace
+
+gsl::span<std::uint8_t const> CompressedSignalBatch::signal(std::size_t index) const
+{
+    return gsl::make_span(data->data() + offsets[index], offsets[index + 1] - offsets[index]);
+}
+
+arrow::Status compress_signal_batch(
+    gsl::span<gsl::span<SampleType const> const> const & samples,
+    ThreadPool & thread_pool,
+    gsl::span<std::uint8_t> const & destination,
+    gsl::span<std::size_t> const & offsets,
+    SignalCompressionProfile const & profile,
+    std::shared_ptr<SignalCompressionDictionary const> const & dictionary)
+{
+    POD5_TRACE_FUNCTION();
+    if (offsets.size() != samples.size() + 1) {
+        return pod5::Status::Invalid(
+            "Offsets size (",
+            offsets.size(),
+            ") must be one more than the read count (",
+            samples.size(),
+            ")");
+    }
+
+    auto state = std::make_shared<BatchCompressionState>();
+    state->samples = samples;
+    state->destination = destination;
+    state->profile = profile;
+    state->dictionary = dictionary;
+    state->slot_offsets.reserve(samples.size() + 1);
+    state->slot_offsets.push_back(0);
+    state->compressed_sizes.resize(samples.size());
+    state->task_starts.push_back(0);
+
+    std::size_t task_samples = 0;
+    for (std::size_t read = 0; read < samples.size(); ++read) {
+        state->slot_offsets.push_back(
+            state->slot_offsets.back() + compressed_signal_max_size(samples[read].size()));
+
+        task_samples += samples[read].size();
+        if (task_samples >= BATCH_COMPRESSION_TASK_SAMPLES) {
+            state->task_starts.push_back(read + 1);
+            task_samples = 0;
+        }
+    }
+    if (state->task_starts.back() != samples.size()) {
+        state->task_starts.push_back(samples.size());
+    }
+
+    if (state->slot_offsets.back() > destination.size()) {
+        return pod5::Status::Invalid(
+            "Destination size (",
+            destination.size(),
+            ") is less than the max compressed size of the batch (",
+            state->slot_offsets.back(),
+            ")");
+    }
+
+    if (state->task_count() > 0) {
+        auto const helper_count = std::min(state->task_count() - 1, BATCH_COMPRESSION_MAX_HELPERS);
+        for (std::size_t i = 0; i < helper_count; ++i) {
+            try {
+                thread_pool.post([state] { state->run(); });
+            } catch (std::logic_error const &) {
+                // The pool has been stopped, the calling thread will pick up the remaining work.
+                break;
+            }
+        }
+
+        state->run();
+
+        std::unique_lock<std::mutex> lock{state->mutex};
+        state->tasks_complete.wait(
+            lock, [&] { return state->completed_tasks == state->task_count(); });
+        ARROW_RETURN_NOT_OK(state->status);
+    }
+
+    // Pack the reads down to the front of the buffer, every read's slot starts at or after its
+    // packed offset so moving them in order never overwrites data still to be moved.
+    offsets[0] = 0;
+    for (std::size_t read = 0; read < samples.size(); ++read) {
+        auto const size = state->compressed_sizes[read];
+        std::memmove(
+            destination.data() + offsets[read],
+            destination.data() + state->slot_offsets[read],
+            size);
+        offsets[read + 1] = offsets[read] + size;
+    }
+    return arrow::Status::OK();
+}
+
+arrow::Result<CompressedSignalBatch> compress_signal_batch(
+    gsl::span<gsl::span<SampleType const> const> const & samples,
+    ThreadPool & thread_pool,
     arrow::MemoryPool * pool,
-    gsl::span<std::int16_t> const & destination)
+    SignalCompressionProfile const & profile,
+    std::shared_ptr<SignalCompressionDictionary const> const & dictionary)
+{
+    std::size_t max_size = 0;
+    for (auto const & read_samples : samples) {
+        max_size += compressed_signal_max_size(read_samples.size());
+    }
+
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::ResizableBuffer> data,
+        arrow::AllocateResizableBuffer(max_size, pool));
+
+    CompressedSignalBatch batch;
+    batch.offsets.resize(samples.size() + 1);
+    ARROW_RETURN_NOT_OK(compress_signal_batch(
+        samples,
+        thread_pool,
+        gsl::make_span(data->mutable_data(), data->size()),
+        gsl::make_span(batch.offsets),
+        profile,
+        dictionary));
+
+    ARROW_RETURN_NOT_OK(data->Resize(batch.offsets.back()));
+    batch.data = std::move(data);
+    return batch;
+}
+
+namespace {
+Result<std::size_t> find_decompressed_zstd_size(
+    gsl::span<std::uint8_t const> const & compressed_bytes)
 {
-    // First decompress the data using zstd:
     unsigned long long const decompressed_zstd_size =
         ZSTD_getFrameContentSize(compressed_bytes.data(), compressed_bytes.size());
     if (ZSTD_isError(decompressed_zstd_size)) {
@@ -80,14 +622,83 @@ POD5_FORMAT_EXPORT arrow::Status decompress_signal(
             ZSTD_getErrorName(decompressed_zstd_size),
             ")");
     }
+    return decompressed_zstd_size;
+}
+}  // namespace
+
+namespace {
+// Writes decoded samples straight into the caller's int16 destination.
+struct SampleWriter {
+    gsl::span<std::int16_t> destination;
+
+    std::size_t size() const { return destination.size(); }
+
+    std::size_t decode(
+        std::size_t offset,
+        std::size_t count,
+        gsl::span<std::uint8_t const> keys,
+        gsl::span<std::uint8_t const> data)
+    {
+        std::int16_t const prev = offset ? destination[offset - 1] : 0;
+        return svb16::decode<SampleType, UseDelta, UseZigzag>(
+            destination.subspan(offset, count), keys, data, prev);
+    }
+};
+
+// Calibrates decoded samples as they are produced, so no int16 copy of the read is ever written
+// out, [OutputType] being any type calibrate_signal() writes.
+template <typename OutputType>
+struct CalibratedSampleWriter {
+    SignalCalibration calibration;
+    gsl::span<OutputType> destination;
+    SampleType prev = 0;
+
+    std::size_t size() const { return destination.size(); }
+
+    std::size_t decode(
+        std::size_t offset,
+        std::size_t count,
+        gsl::span<std::uint8_t const> keys,
+        gsl::span<std::uint8_t const> data)
+    {
+        std::array<SampleType, CALIBRATED_DECODE_TILE_SIZE> tile;
+        std::size_t consumed_count = 0;
+        for (std::size_t position = 0; position < count; position += tile.size()) {
+            auto const tile_count = std::min(tile.size(), count - position);
+            auto const tile_samples = gsl::make_span(tile.data(), tile_count);
+            consumed_count += svb16::decode<SampleType, UseDelta, UseZigzag>(
+                tile_samples,
+                keys.subspan(position / 8, svb16_key_length(tile_count)),
+                data.subspan(consumed_count),
+                prev);
+            prev = tile[tile_count - 1];
+            calibrate_signal(
+                tile_samples, calibration, destination.subspan(offset + position, tile_count));
+        }
+        return consumed_count;
+    }
+};
+
+template <typename Writer>
+arrow::Status decompress_signal_buffered(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    Writer & writer)
+{
+    auto & impl = context.impl();
+
+    // First decompress the data using zstd:
+    ARROW_ASSIGN_OR_RAISE(
+        auto const decompressed_zstd_size, find_decompressed_zstd_size(compressed_bytes));
 
     auto allocation_padding = svb16::decode_input_buffer_padding_byte_count();
     ARROW_ASSIGN_OR_RAISE(
-        auto intermediate,
-        arrow::AllocateResizableBuffer(decompressed_zstd_size + allocation_padding, pool));
-    size_t const decompress_res = ZSTD_decompress(
-        intermediate->mutable_data(),
-        intermediate->size(),
+        auto intermediate, impl.scratch_space(decompressed_zstd_size + allocation_padding));
+    ARROW_ASSIGN_OR_RAISE(auto dctx, impl.decompression_context());
+    size_t const decompress_res = ZSTD_decompressDCtx(
+        dctx,
+        intermediate.data(),
+        intermediate.size(),
         compressed_bytes.data(),
         compressed_bytes.size());
     if (ZSTD_isError(decompress_res)) {
@@ -100,17 +711,382 @@ POD5_FORMAT_EXPORT arrow::Status decompress_signal(
     }
 
     // Now decompress the data using svb:
-    static constexpr bool UseDelta = true;
-    static constexpr bool UseZigzag = true;
-    auto consumed_count = svb16::decode<SampleType, UseDelta, UseZigzag>(
-        destination, gsl::make_span(intermediate->data(), intermediate->size()));
-    if ((consumed_count + allocation_padding) != (std::size_t)intermediate->size()) {
+    auto const encoded = gsl::make_span(intermediate.data(), intermediate.size());
+    auto const keys_length = svb16_key_length(writer.size());
+    if (keys_length > decompressed_zstd_size) {
+        return pod5::Status::Invalid("Too few samples in signal buffer");
+    }
+    auto consumed_count = keys_length
+                          + writer.decode(
+                              0,
+                              writer.size(),
+                              encoded.subspan(0, keys_length),
+                              encoded.subspan(keys_length));
+    if ((consumed_count + allocation_padding) != intermediate.size()) {
+        return pod5::Status::Invalid("Remaining data at end of signal buffer");
+    }
+
+    return pod5::Status::OK();
+}
+
+template <typename Writer>
+arrow::Status decompress_signal_streaming(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    Writer & writer)
+{
+    auto & impl = context.impl();
+    ARROW_ASSIGN_OR_RAISE(auto dctx, impl.decompression_context());
+    ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+
+    // The svb16 stream holds all keys first, then all data. Keys are small (1 bit per sample)
+    // so are collected in full, data is then decoded a window at a time as zstd produces it.
+    auto const sample_count = writer.size();
+    auto const keys_length = svb16_key_length(sample_count);
+    auto const padding = svb16::decode_input_buffer_padding_byte_count();
+    ARROW_ASSIGN_OR_RAISE(auto keys, impl.scratch_space(keys_length));
+    ARROW_ASSIGN_OR_RAISE(auto window, impl.window_space(STREAMING_DECODE_WINDOW_SIZE + padding));
+
+    ZSTD_inBuffer input{compressed_bytes.data(), compressed_bytes.size(), 0};
+    std::size_t keys_filled = 0;
+    std::size_t window_filled = 0;
+    std::size_t decoded_count = 0;
+    while (true) {
+        ZSTD_outBuffer output{window.data(), STREAMING_DECODE_WINDOW_SIZE, window_filled};
+        std::size_t const zstd_result = ZSTD_decompressStream(dctx, &output, &input);
+        if (ZSTD_isError(zstd_result)) {
+            return pod5::Status::Invalid(
+                "Input data failed to decompress using zstd: (",
+                zstd_result,
+                " ",
+                ZSTD_getErrorName(zstd_result),
+                ")");
+        }
+        bool const made_progress = output.pos != window_filled;
+        window_filled = output.pos;
+
+        std::size_t window_consumed = 0;
+        if (keys_filled < keys_length) {
+            auto const key_bytes = std::min(keys_length - keys_filled, window_filled);
+            std::memcpy(keys.data() + keys_filled, window.data(), key_bytes);
+            keys_filled += key_bytes;
+            window_consumed += key_bytes;
+        }
+
+        if (keys_filled == keys_length && decoded_count < sample_count) {
+            // Find how many whole key bytes have all their data present in the window:
+            auto const available_bytes = window_filled - window_consumed;
+            std::size_t data_bytes = 0;
+            std::size_t value_count = 0;
+            std::size_t key_index = decoded_count / 8;
+            // Step over 64 values at a time while the window clearly holds their data:
+            while (key_index + 8 <= sample_count / 8 && data_bytes + 128 <= available_bytes) {
+                std::uint64_t key_block;
+                std::memcpy(&key_block, keys.data() + key_index, sizeof(key_block));
+                data_bytes += 64 + svb16_popcount(static_cast<std::uint32_t>(key_block))
+                              + svb16_popcount(static_cast<std::uint32_t>(key_block >> 32));
+                value_count += 64;
+                key_index += 8;
+            }
+            for (; key_index < keys_length; ++key_index) {
+                auto const group_count =
+                    std::min<std::size_t>(8, sample_count - decoded_count - value_count);
+                auto const key = keys[key_index] & ((1u << group_count) - 1);
+                auto const group_bytes = group_count + svb16_popcount(key);
+                if (data_bytes + group_bytes > available_bytes) {
+                    break;
+                }
+                data_bytes += group_bytes;
+                value_count += group_count;
+            }
+
+            if (value_count > 0) {
+                auto const consumed_count = writer.decode(
+                    decoded_count,
+                    value_count,
+                    keys.subspan(decoded_count / 8, svb16_key_length(value_count)),
+                    window.subspan(window_consumed, data_bytes + padding));
+                if (consumed_count != data_bytes) {
+                    return pod5::Status::Invalid("Unexpected data length in signal buffer");
+                }
+                decoded_count += value_count;
+                window_consumed += data_bytes;
+            }
+        }
+
+        // Carry any partial group over to the start of the next window:
+        window_filled -= window_consumed;
+        std::memmove(window.data(), window.data() + window_consumed, window_filled);
+
+        if (zstd_result == 0) {
+            break;
+        }
+        if (!made_progress && input.pos == input.size) {
+            return pod5::Status::Invalid("Input data truncated in zstd frame");
+        }
+    }
+
+    if (keys_filled != keys_length || decoded_count != sample_count) {
+        return pod5::Status::Invalid("Too few samples in signal buffer");
+    }
+    if (window_filled != 0 || input.pos != input.size) {
         return pod5::Status::Invalid("Remaining data at end of signal buffer");
     }
 
     return pod5::Status::OK();
 }
 
+}  // namespace
+
+arrow::Status decompress_signal_buffered(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    gsl::span<std::int16_t> const & destination)
+{
+    SampleWriter writer{destination};
+    return decompress_signal_buffered(compressed_bytes, context, writer);
+}
+
+arrow::Status decompress_signal_streaming(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    gsl::span<std::int16_t> const & destination)
+{
+    SampleWriter writer{destination};
+    return decompress_signal_streaming(compressed_bytes, context, writer);
+}
+
+arrow::Status check_compressed_signal_frame(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    std::size_t sample_count)
+{
+    // Walks the frame's block headers, so a truncated frame or trailing bytes are found:
+    auto const frame_size =
+        ZSTD_findFrameCompressedSize(compressed_bytes.data(), compressed_bytes.size());
+    if (ZSTD_isError(frame_size)) {
+        return pod5::Status::IOError(
+            "Invalid zstd frame in compressed signal: ", ZSTD_getErrorName(frame_size));
+    }
+    if (frame_size != compressed_bytes.size()) {
+        return pod5::Status::IOError(
+            "Compressed signal of ",
+            compressed_bytes.size(),
+            " bytes holds a zstd frame of ",
+            frame_size,
+            " bytes");
+    }
+
+    auto const content_size =
+        ZSTD_getFrameContentSize(compressed_bytes.data(), compressed_bytes.size());
+    if (content_size == ZSTD_CONTENTSIZE_ERROR) {
+        return pod5::Status::IOError("Invalid zstd frame header in compressed signal");
+    }
+    // Frames written without their content size can't be checked further:
+    if (content_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+        return pod5::Status::OK();
+    }
+
+    // Each svb16 sample is encoded in one or two bytes, after a key bit per sample:
+    auto const key_length = svb16_key_length(sample_count);
+    if (content_size < key_length + sample_count
+        || content_size > svb16_max_encoded_length(sample_count))
+    {
+        return pod5::Status::IOError(
+            "Compressed signal holds ",
+            content_size,
+            " encoded bytes, which can't hold ",
+            sample_count,
+            " samples");
+    }
+    return pod5::Status::OK();
+}
+
+arrow::Status decompress_signal(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    gsl::span<std::int16_t> const & destination)
+{
+    POD5_TRACE_FUNCTION();
+    ARROW_ASSIGN_OR_RAISE(
+        auto const decompressed_zstd_size, find_decompressed_zstd_size(compressed_bytes));
+
+    if (decompressed_zstd_size > STREAMING_DECODE_THRESHOLD) {
+        return decompress_signal_streaming(compressed_bytes, context, destination);
+    }
+    return decompress_signal_buffered(compressed_bytes, context, destination);
+}
+
+void calibrate_signal(
+    gsl::span<SampleType const> const & samples,
+    SignalCalibration const & calibration,
+    gsl::span<float> const & destination)
+{
+    assert(samples.size() == destination.size());
+
+    // Kept as a plain loop so the compiler widens and converts whole vectors of samples at once:
+    auto const offset = calibration.offset;
+    auto const scale = calibration.scale;
+    auto const * const in = samples.data();
+    auto * const out = destination.data();
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        out[i] = (in[i] + offset) * scale;
+    }
+}
+
+Float16 Float16::from_float(float value)
+{
+    std::uint32_t value_bits;
+    std::memcpy(&value_bits, &value, sizeof(value_bits));
+    auto const sign = static_cast<std::uint16_t>((value_bits >> 16) & 0x8000);
+    auto const magnitude = value_bits & 0x7fffffff;
+
+    // Nan keeps a set mantissa bit, infinity and anything rounding to 65520 or more is infinite:
+    if (magnitude > 0x7f800000) {
+        return {static_cast<std::uint16_t>(sign | 0x7e00)};
+    }
+    if (magnitude >= 0x477ff000) {
+        return {static_cast<std::uint16_t>(sign | 0x7c00)};
+    }
+
+    std::uint32_t half_bits;
+    std::uint32_t dropped_bits;
+    std::uint32_t dropped_count;
+    if (magnitude >= 0x38800000) {
+        // Normal, rebias the exponent and drop the 13 mantissa bits half precision can't hold:
+        auto const rebiased = magnitude - 0x38000000;
+        dropped_count = 13;
+        half_bits = rebiased >> dropped_count;
+        dropped_bits = rebiased & ((1u << dropped_count) - 1);
+    } else if (magnitude > 0x33000000) {
+        // Subnormal in half precision, counted in units of 2^-24 with the implicit bit restored:
+        auto const mantissa = (magnitude & 0x7fffff) | 0x800000;
+        dropped_count = 126 - (magnitude >> 23);
+        half_bits = mantissa >> dropped_count;
+        dropped_bits = mantissa & ((1u << dropped_count) - 1);
+    } else {
+        // At most half the smallest subnormal, which rounds to (even) zero:
+        return {sign};
+    }
+
+    // Round to nearest, ties to even, a carry moving into the exponent as it should:
+    auto const halfway = 1u << (dropped_count - 1);
+    if (dropped_bits > halfway || (dropped_bits == halfway && (half_bits & 1))) {
+        ++half_bits;
+    }
+    return {static_cast<std::uint16_t>(sign | half_bits)};
+}
+
+float Float16::to_float() const
+{
+    std::uint32_t const sign = static_cast<std::uint32_t>(bits & 0x8000) << 16;
+    std::uint32_t const exponent = (bits >> 10) & 0x1f;
+    std::uint32_t const mantissa = bits & 0x3ff;
+
+    std::uint32_t value_bits;
+    if (exponent == 0x1f) {
+        value_bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        value_bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else {
+        // Zero or subnormal, both exact as a float:
+        float const value = mantissa * (1.0f / (1 << 24));
+        return sign ? -value : value;
+    }
+
+    float value;
+    std::memcpy(&value, &value_bits, sizeof(value));
+    return value;
+}
+
+void calibrate_signal(
+    gsl::span<SampleType const> const & samples,
+    SignalCalibration const & calibration,
+    gsl::span<Float16> const & destination)
+{
+    assert(samples.size() == destination.size());
+
+    auto const offset = calibration.offset;
+    auto const scale = calibration.scale;
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        destination[i] = Float16::from_float((samples[i] + offset) * scale);
+    }
+}
+
+void calibrate_signal(
+    gsl::span<SampleType const> const & samples,
+    SignalCalibration const & calibration,
+    gsl::span<std::int8_t> const & destination)
+{
+    assert(samples.size() == destination.size());
+
+    // Clamped before rounding, so the conversion never sees a value outside the int8 range:
+    auto const offset = calibration.offset;
+    auto const scale = calibration.scale;
+    auto const * const in = samples.data();
+    auto * const out = destination.data();
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        auto const level = std::clamp((in[i] + offset) * scale, -128.0f, 127.0f);
+        out[i] = static_cast<std::int8_t>(std::nearbyint(level));
+    }
+}
+
+namespace {
+template <typename OutputType>
+arrow::Status decompress_signal_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    CalibratedSampleWriter<OutputType> & writer)
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto const decompressed_zstd_size, find_decompressed_zstd_size(compressed_bytes));
+
+    if (decompressed_zstd_size > STREAMING_DECODE_THRESHOLD) {
+        return decompress_signal_streaming(compressed_bytes, context, writer);
+    }
+    return decompress_signal_buffered(compressed_bytes, context, writer);
+}
+}  // namespace
+
+arrow::Status decompress_signal_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<float> const & destination)
+{
+    CalibratedSampleWriter<float> writer{calibration, destination};
+    return decompress_signal_calibrated(compressed_bytes, context, writer);
+}
+
+arrow::Status decompress_signal_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<Float16> const & destination)
+{
+    CalibratedSampleWriter<Float16> writer{calibration, destination};
+    return decompress_signal_calibrated(compressed_bytes, context, writer);
+}
+
+arrow::Status decompress_signal_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<std::int8_t> const & destination)
+{
+    CalibratedSampleWriter<std::int8_t> writer{calibration, destination};
+    return decompress_signal_calibrated(compressed_bytes, context, writer);
+}
+
+arrow::Status decompress_signal(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    arrow::MemoryPool *,
+    gsl::span<std::int16_t> const & destination)
+{
+    auto & context = thread_local_signal_compression_context();
+    context.set_dictionary(nullptr);
+    return decompress_signal(compressed_bytes, context, destination);
+}
+
 arrow::Result<std::shared_ptr<arrow::Buffer>> decompress_signal(
     gsl::span<std::uint8_t const> const & compressed_bytes,
     std::uint32_t samples_count,
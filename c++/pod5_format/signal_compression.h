@@ -5,6 +5,10 @@
 
 #include <gsl/gsl-lite.hpp>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace arrow {
 class MemoryPool;
 class Buffer;
@@ -12,10 +16,207 @@ class Buffer;
 
 namespace pod5 {
 
+class ThreadPool;
+
 using SampleType = std::int16_t;
 
 POD5_FORMAT_EXPORT std::size_t compressed_signal_max_size(std::size_t sample_count);
 
+/// \brief zstd settings used when compressing signal.
+struct POD5_FORMAT_EXPORT SignalCompressionProfile {
+    static constexpr int DEFAULT_LEVEL = 1;
+
+    /// zstd compression level, higher levels trade write throughput for smaller files.
+    int level = DEFAULT_LEVEL;
+    /// zstd strategy (a ZSTD_strategy value), 0 selects the default strategy for [level].
+    int strategy = 0;
+    /// Number of zstd worker threads used by each compression call, 0 compresses on the
+    /// calling thread.
+    int worker_count = 0;
+
+    bool operator==(SignalCompressionProfile const & other) const
+    {
+        return level == other.level && strategy == other.strategy
+               && worker_count == other.worker_count;
+    }
+
+    bool operator!=(SignalCompressionProfile const & other) const { return !(*this == other); }
+};
+
+/// \brief Check [profile] is supported by the zstd library pod5 is built against.
+POD5_FORMAT_EXPORT arrow::Status check_signal_compression_profile(
+    SignalCompressionProfile const & profile);
+
+/// \brief Format [profile] for storing in file metadata.
+POD5_FORMAT_EXPORT std::string to_string(SignalCompressionProfile const & profile);
+
+/// \brief Parse a profile formatted by to_string().
+POD5_FORMAT_EXPORT arrow::Result<SignalCompressionProfile> parse_signal_compression_profile(
+    std::string const & profile);
+
+/// \brief A zstd dictionary trained on svb16 encoded signal.
+/// \note A dictionary is immutable once created, and can be shared between threads.
+class POD5_FORMAT_EXPORT SignalCompressionDictionary {
+public:
+    static constexpr std::size_t DEFAULT_MAX_SIZE = 64 * 1024;
+
+    /// \brief Load a dictionary from the bytes of a trained zstd dictionary.
+    static arrow::Result<std::shared_ptr<SignalCompressionDictionary const>> make(
+        std::shared_ptr<arrow::Buffer> const & data);
+
+    ~SignalCompressionDictionary();
+
+    /// \brief The raw dictionary bytes, as stored in a file.
+    std::shared_ptr<arrow::Buffer> const & data() const;
+    /// \brief The zstd dictionary id, recorded in each frame compressed with the dictionary.
+    std::uint32_t id() const;
+
+    struct Impl;
+    Impl const & impl() const { return *m_impl; }
+
+private:
+    SignalCompressionDictionary(std::unique_ptr<Impl> && impl);
+
+    std::unique_ptr<Impl> m_impl;
+};
+
+/// \brief Train a dictionary on the svb16 encoding of [samples].
+/// \note Training works best on many short reads representative of the data to be compressed,
+///       only the start of each read contributes to the dictionary.
+POD5_FORMAT_EXPORT arrow::Result<std::shared_ptr<SignalCompressionDictionary const>>
+train_signal_compression_dictionary(
+    gsl::span<gsl::span<SampleType const> const> const & samples,
+    std::size_t max_dictionary_size = SignalCompressionDictionary::DEFAULT_MAX_SIZE,
+    arrow::MemoryPool * pool = nullptr);
+
+/// \brief Holds zstd compression state and scratch space for (de)compressing signal.
+/// \note Reusing a context avoids setting up zstd state and allocating an intermediate
+///       buffer for every call. A context must only be used by one thread at a time.
+class POD5_FORMAT_EXPORT SignalCompressionContext {
+public:
+    SignalCompressionContext(
+        arrow::MemoryPool * pool = nullptr,
+        SignalCompressionProfile const & profile = {});
+    ~SignalCompressionContext();
+
+    SignalCompressionContext(SignalCompressionContext &&);
+    SignalCompressionContext & operator=(SignalCompressionContext &&);
+    SignalCompressionContext(SignalCompressionContext const &) = delete;
+    SignalCompressionContext & operator=(SignalCompressionContext const &) = delete;
+
+    /// \brief Set the zstd settings used by future compression calls.
+    void set_profile(SignalCompressionProfile const & profile);
+    SignalCompressionProfile const & profile() const;
+
+    /// \brief Set the dictionary used by future compression and decompression calls, or nullptr
+    ///        to (de)compress without a dictionary.
+    void set_dictionary(std::shared_ptr<SignalCompressionDictionary const> const & dictionary);
+    std::shared_ptr<SignalCompressionDictionary const> const & dictionary() const;
+
+    struct Impl;
+    Impl & impl() { return *m_impl; }
+
+private:
+    std::unique_ptr<Impl> m_impl;
+};
+
+/// \brief Find a compression context owned by the calling thread.
+POD5_FORMAT_EXPORT SignalCompressionContext & thread_local_signal_compression_context();
+
+POD5_FORMAT_EXPORT arrow::Result<std::size_t> compress_signal(
+    gsl::span<SampleType const> const & samples,
+    SignalCompressionContext & context,
+    gsl::span<std::uint8_t> const & destination);
+
+/// \brief Decompress signal into [destination], selecting the best decode path for its size.
+POD5_FORMAT_EXPORT arrow::Status decompress_signal(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    gsl::span<std::int16_t> const & destination);
+
+/// \brief Decompress signal by inflating the whole zstd frame before decoding it.
+POD5_FORMAT_EXPORT arrow::Status decompress_signal_buffered(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    gsl::span<std::int16_t> const & destination);
+
+/// \brief Decompress signal by streaming the zstd frame through a small window,
+///        decoding samples as the data becomes available.
+POD5_FORMAT_EXPORT arrow::Status decompress_signal_streaming(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    gsl::span<std::int16_t> const & destination);
+
+/// \brief Check [compressed_bytes] hold one whole zstd frame, whose content is sized for the
+///        svb16 encoding of [sample_count] samples, reading only the frame's headers.
+/// \note The samples aren't decompressed, so corruption within the compressed blocks is only
+///       found by decompressing or by the file's signal checksums.
+/// \returns IOError describing the first problem found.
+POD5_FORMAT_EXPORT arrow::Status check_compressed_signal_frame(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    std::size_t sample_count);
+
+/// \brief Calibration used to convert ADC samples to picoamps: pA = (adc + offset) * scale.
+struct POD5_FORMAT_EXPORT SignalCalibration {
+    float offset = 0.0f;
+    float scale = 1.0f;
+};
+
+/// \brief An IEEE 754 half precision float, held as its bits, for compact calibrated signal.
+struct POD5_FORMAT_EXPORT Float16 {
+    std::uint16_t bits = 0;
+
+    /// \brief Round [value] to the nearest half precision value, overflowing to infinity.
+    static Float16 from_float(float value);
+
+    float to_float() const;
+};
+
+/// \brief Convert ADC [samples] to picoamps, writing the result to [destination].
+/// \note [destination] must be the same size as [samples].
+POD5_FORMAT_EXPORT void calibrate_signal(
+    gsl::span<SampleType const> const & samples,
+    SignalCalibration const & calibration,
+    gsl::span<float> const & destination);
+
+/// \brief Convert ADC [samples] to picoamps held at half precision, writing the result to
+///        [destination].
+/// \note [destination] must be the same size as [samples].
+POD5_FORMAT_EXPORT void calibrate_signal(
+    gsl::span<SampleType const> const & samples,
+    SignalCalibration const & calibration,
+    gsl::span<Float16> const & destination);
+
+/// \brief Convert ADC [samples] to 8 bit levels with [calibration], rounding each
+///        (adc + offset) * scale to the nearest integer and clamping it to the int8 range.
+/// \note [destination] must be the same size as [samples].
+POD5_FORMAT_EXPORT void calibrate_signal(
+    gsl::span<SampleType const> const & samples,
+    SignalCalibration const & calibration,
+    gsl::span<std::int8_t> const & destination);
+
+/// \brief Decompress signal straight to picoamps, calibrating samples as they are decoded.
+/// \note This avoids writing an intermediate int16 copy of the read.
+POD5_FORMAT_EXPORT arrow::Status decompress_signal_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<float> const & destination);
+
+/// \brief Decompress signal straight to half precision picoamps, see calibrate_signal().
+POD5_FORMAT_EXPORT arrow::Status decompress_signal_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<Float16> const & destination);
+
+/// \brief Decompress signal straight to clamped 8 bit levels, see calibrate_signal().
+POD5_FORMAT_EXPORT arrow::Status decompress_signal_calibrated(
+    gsl::span<std::uint8_t const> const & compressed_bytes,
+    SignalCompressionContext & context,
+    SignalCalibration const & calibration,
+    gsl::span<std::int8_t> const & destination);
+
 POD5_FORMAT_EXPORT arrow::Result<std::size_t> compress_signal(
     gsl::span<SampleType const> const & samples,
     arrow::MemoryPool * pool,
@@ -25,6 +226,41 @@ POD5_FORMAT_EXPORT arrow::Result<std::shared_ptr<arrow::Buffer>> compress_signal
     gsl::span<SampleType const> const & samples,
     arrow::MemoryPool * pool);
 
+/// \brief Compressed signal for a batch of reads, packed into a single buffer.
+struct POD5_FORMAT_EXPORT CompressedSignalBatch {
+    std::shared_ptr<arrow::Buffer> data;
+    /// Offsets of each read's signal in [data], with a trailing entry for the end of the data.
+    std::vector<std::size_t> offsets;
+
+    std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    /// \brief Find the compressed bytes for the read at [index], suitable for passing to
+    ///        FileWriter::add_pre_compressed_signal.
+    gsl::span<std::uint8_t const> signal(std::size_t index) const;
+};
+
+/// \brief Compress the signal for many reads, spreading the work across [thread_pool].
+/// \note The calling thread also compresses reads, so this is safe to call from a worker of
+///       [thread_pool] and makes progress even if the pool is busy.
+POD5_FORMAT_EXPORT arrow::Result<CompressedSignalBatch> compress_signal_batch(
+    gsl::span<gsl::span<SampleType const> const> const & samples,
+    ThreadPool & thread_pool,
+    arrow::MemoryPool * pool,
+    SignalCompressionProfile const & profile = {},
+    std::shared_ptr<SignalCompressionDictionary const> const & dictionary = nullptr);
+
+/// \brief Compress the signal for many reads into caller provided storage.
+/// \param destination Must be at least the sum of compressed_signal_max_size() for each read.
+/// \param offsets     Filled with the offset of each read's signal in [destination], must have
+///                    room for one more entry than there are reads.
+POD5_FORMAT_EXPORT arrow::Status compress_signal_batch(
+    gsl::span<gsl::span<SampleType const> const> const & samples,
+    ThreadPool & thread_pool,
+    gsl::span<std::uint8_t> const & destination,
+    gsl::span<std::size_t> const & offsets,
+    SignalCompressionProfile const & profile = {},
+    std::shared_ptr<SignalCompressionDictionary const> const & dictionary = nullptr);
+
 POD5_FORMAT_EXPORT arrow::Result<std::shared_ptr<arrow::Buffer>> decompress_signal(
     gsl::span<std::uint8_t const> const & compressed_bytes,
     std::uint32_t samples_count,
@@ -0,0 +1,163 @@
+#include "pod5_format/signal_row_index.h"
+
+#include <arrow/array/array_primitive.h>
+#include <arrow/array/builder_primitive.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <arrow/util/key_value_metadata.h>
+
+namespace pod5 {
+
+namespace {
+
+char const * const INDEX_TYPE_KEY = "MINKNOW:index_type";
+char const * const SIGNAL_ROW_INDEX_TYPE = "signal_row_sample_counts";
+
+std::shared_ptr<arrow::Schema> make_signal_row_index_schema(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    return arrow::schema({arrow::field("samples", arrow::uint32(), false)}, metadata);
+}
+
+bool is_signal_row_index(arrow::Schema const & schema)
+{
+    auto const & metadata = schema.metadata();
+    if (!metadata) {
+        return false;
+    }
+    auto const index_type = metadata->Get(INDEX_TYPE_KEY);
+    return index_type.ok() && *index_type == SIGNAL_ROW_INDEX_TYPE;
+}
+
+// Append the values of every batch of [reader]'s only column to [sample_counts].
+Status append_sample_counts(
+    arrow::ipc::RecordBatchFileReader & reader,
+    std::vector<std::uint32_t> & sample_counts)
+{
+    for (int i = 0; i < reader.num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader.ReadRecordBatch(i));
+        if (batch->num_columns() != 1 || batch->column(0)->type_id() != arrow::Type::UINT32) {
+            return Status::IOError("Invalid signal row sample counts");
+        }
+        auto const samples = std::static_pointer_cast<arrow::UInt32Array>(batch->column(0));
+        sample_counts.insert(
+            sample_counts.end(),
+            samples->raw_values(),
+            samples->raw_values() + samples->length());
+    }
+    return Status::OK();
+}
+
+}  // namespace
+
+SignalRowIndex::SignalRowIndex(std::vector<std::uint32_t> const & sample_counts)
+{
+    m_row_sample_starts.reserve(sample_counts.size() + 1);
+    for (auto const count : sample_counts) {
+        m_row_sample_starts.push_back(m_row_sample_starts.back() + count);
+    }
+}
+
+Result<std::shared_ptr<SignalRowIndex const>> SignalRowIndex::build(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & signal_table_file,
+    arrow::MemoryPool * pool)
+{
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = pool;
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto schema_reader, arrow::ipc::RecordBatchFileReader::Open(signal_table_file, options));
+    auto const samples_field = schema_reader->schema()->GetFieldIndex("samples");
+    if (samples_field < 0) {
+        return Status::IOError("Signal table has no samples column");
+    }
+
+    // Only the samples column is read from each batch, not the signal:
+    options.included_fields = {samples_field};
+    ARROW_ASSIGN_OR_RAISE(
+        auto reader, arrow::ipc::RecordBatchFileReader::Open(signal_table_file, options));
+
+    std::vector<std::uint32_t> sample_counts;
+    ARROW_RETURN_NOT_OK(append_sample_counts(*reader, sample_counts));
+    return std::make_shared<SignalRowIndex const>(sample_counts);
+}
+
+Result<std::shared_ptr<SignalRowIndex const>> SignalRowIndex::open(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    arrow::MemoryPool * pool)
+{
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = pool;
+
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(file, options));
+    if (!is_signal_row_index(*reader->schema())) {
+        return std::shared_ptr<SignalRowIndex const>();
+    }
+    if (!reader->schema()->Equals(*make_signal_row_index_schema(nullptr), false)) {
+        return Status::IOError("Invalid signal row index schema");
+    }
+
+    std::vector<std::uint32_t> sample_counts;
+    ARROW_RETURN_NOT_OK(append_sample_counts(*reader, sample_counts));
+    return std::make_shared<SignalRowIndex const>(sample_counts);
+}
+
+Result<std::shared_ptr<arrow::Buffer>> SignalRowIndex::write(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    arrow::MemoryPool * pool) const
+{
+    auto const index_metadata =
+        metadata ? metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    index_metadata->Append(INDEX_TYPE_KEY, SIGNAL_ROW_INDEX_TYPE);
+
+    arrow::UInt32Builder samples(pool);
+    ARROW_RETURN_NOT_OK(samples.Reserve(row_count()));
+    for (std::size_t row = 0; row < row_count(); ++row) {
+        samples.UnsafeAppend(sample_count(row));
+    }
+    std::shared_ptr<arrow::Array> samples_array;
+    ARROW_RETURN_NOT_OK(samples.Finish(&samples_array));
+
+    auto const schema = make_signal_row_index_schema(index_metadata);
+    auto const batch =
+        arrow::RecordBatch::Make(schema, std::int64_t(row_count()), {samples_array});
+
+    ARROW_ASSIGN_OR_RAISE(auto sink, arrow::io::BufferOutputStream::Create(4096, pool));
+
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return sink->Finish();
+}
+
+std::uint64_t SignalRowIndex::sample_count(
+    gsl::span<std::uint64_t const> const & row_indices) const
+{
+    std::uint64_t result = 0;
+    for (auto const row : row_indices) {
+        result += sample_count(row);
+    }
+    return result;
+}
+
+std::vector<std::uint64_t> SignalRowIndex::sample_offsets(
+    gsl::span<std::uint64_t const> const & row_indices) const
+{
+    std::vector<std::uint64_t> result;
+    result.reserve(row_indices.size() + 1);
+    std::uint64_t offset = 0;
+    for (auto const row : row_indices) {
+        result.push_back(offset);
+        offset += sample_count(row);
+    }
+    result.push_back(offset);
+    return result;
+}
+
+}  // namespace pod5
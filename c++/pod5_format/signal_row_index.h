@@ -0,0 +1,71 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <arrow/io/type_fwd.h>
+#include <gsl/gsl-lite.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace arrow {
+class Buffer;
+class KeyValueMetadata;
+class MemoryPool;
+}  // namespace arrow
+
+namespace pod5 {
+
+/// \brief The sample count of every row in a signal table, letting readers count and locate a
+///        read's samples without loading the signal batches holding its rows.
+///
+/// Written into the file as an arrow table with one row per signal table row, tagged with
+/// "MINKNOW:index_type" schema metadata so it can be told apart from other OtherIndex embedded
+/// files.
+class POD5_FORMAT_EXPORT SignalRowIndex {
+public:
+    SignalRowIndex() = default;
+    explicit SignalRowIndex(std::vector<std::uint32_t> const & sample_counts);
+
+    /// \brief Build the index for the signal table in [signal_table_file], reading only its
+    ///        samples column.
+    static Result<std::shared_ptr<SignalRowIndex const>> build(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & signal_table_file,
+        arrow::MemoryPool * pool);
+
+    /// \brief Open an index written by [write] from an OtherIndex embedded file.
+    /// \returns The index, or null if [file] holds a different kind of index.
+    static Result<std::shared_ptr<SignalRowIndex const>> open(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+        arrow::MemoryPool * pool);
+
+    /// \brief Serialise the index as an arrow ipc file, tagged with [metadata].
+    Result<std::shared_ptr<arrow::Buffer>> write(
+        std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+        arrow::MemoryPool * pool) const;
+
+    /// \brief Find the number of signal table rows indexed.
+    std::size_t row_count() const { return m_row_sample_starts.size() - 1; }
+
+    /// \brief Find the number of samples in [row], which must be indexed.
+    std::uint32_t sample_count(std::uint64_t row) const
+    {
+        return std::uint32_t(m_row_sample_starts[row + 1] - m_row_sample_starts[row]);
+    }
+
+    /// \brief Find the number of samples in a list of rows, which must all be indexed.
+    std::uint64_t sample_count(gsl::span<std::uint64_t const> const & row_indices) const;
+
+    /// \brief Find the offset of each row's samples within the signal for a list of rows, which
+    ///        must all be indexed, followed by the total sample count.
+    std::vector<std::uint64_t> sample_offsets(
+        gsl::span<std::uint64_t const> const & row_indices) const;
+
+private:
+    // The samples in the table before each row, followed by the table's total:
+    std::vector<std::uint64_t> m_row_sample_starts{0};
+};
+
+}  // namespace pod5
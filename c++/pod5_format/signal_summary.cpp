@@ -0,0 +1,407 @@
+#include "pod5_format/signal_summary.h"
+
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_nested.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/array/builder_binary.h>
+#include <arrow/array/builder_primitive.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <arrow/util/key_value_metadata.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+namespace pod5 {
+
+namespace {
+
+char const * const INDEX_TYPE_KEY = "MINKNOW:index_type";
+char const * const SIGNAL_SUMMARY_TYPE = "signal_summary";
+char const * const DECIMATIONS_KEY = "MINKNOW:signal_summary_decimations";
+
+enum SignalSummaryField : int { ReadId, Decimation, Min, Max, Mean };
+
+std::shared_ptr<arrow::Schema> make_signal_summary_schema(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    return arrow::schema(
+        {arrow::field("read_id", arrow::fixed_size_binary(sizeof(Uuid)), false),
+         arrow::field("decimation", arrow::uint32(), false),
+         arrow::field("min", arrow::list(arrow::int16()), false),
+         arrow::field("max", arrow::list(arrow::int16()), false),
+         arrow::field("mean", arrow::list(arrow::int16()), false)},
+        metadata);
+}
+
+Result<std::vector<std::uint32_t>> read_decimations(arrow::KeyValueMetadata const & metadata)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const value, metadata.Get(DECIMATIONS_KEY));
+    std::vector<std::uint32_t> decimations;
+    std::istringstream stream(value);
+    std::string decimation;
+    while (std::getline(stream, decimation, ',')) {
+        try {
+            decimations.push_back(std::uint32_t(std::stoul(decimation)));
+        } catch (std::exception const &) {
+            return Status::IOError("Invalid signal summary decimation '", decimation, "'");
+        }
+    }
+    ARROW_RETURN_NOT_OK(check_signal_summary_decimations(decimations));
+    return decimations;
+}
+
+Result<std::shared_ptr<arrow::Array>> make_list_array(
+    std::vector<std::int32_t> const & offsets,
+    std::vector<std::int16_t> const & values,
+    arrow::MemoryPool * pool)
+{
+    arrow::Int32Builder offsets_builder(pool);
+    ARROW_RETURN_NOT_OK(offsets_builder.AppendValues(offsets));
+    ARROW_ASSIGN_OR_RAISE(auto const offsets_array, offsets_builder.Finish());
+    arrow::Int16Builder values_builder(pool);
+    ARROW_RETURN_NOT_OK(values_builder.AppendValues(values));
+    ARROW_ASSIGN_OR_RAISE(auto const values_array, values_builder.Finish());
+    ARROW_ASSIGN_OR_RAISE(
+        auto list, arrow::ListArray::FromArrays(*offsets_array, *values_array, pool));
+    return list;
+}
+
+std::vector<std::int16_t> list_values(arrow::ListArray const & list, std::int64_t row)
+{
+    auto const values = std::static_pointer_cast<arrow::Int16Array>(list.values());
+    auto const begin = values->raw_values() + list.value_offset(row);
+    return {begin, begin + list.value_length(row)};
+}
+
+}  // namespace
+
+SignalSummaryLevel summarise_signal(
+    gsl::span<gsl::span<std::int16_t const> const> const & signal,
+    std::uint32_t decimation)
+{
+    SignalSummaryLevel level;
+    level.decimation = decimation;
+
+    std::size_t sample_count = 0;
+    for (auto const & chunk : signal) {
+        sample_count += chunk.size();
+    }
+    auto const point_count = (sample_count + decimation - 1) / decimation;
+    level.min.reserve(point_count);
+    level.max.reserve(point_count);
+    level.mean.reserve(point_count);
+
+    // Runs can span chunks, so each is built from the part of it in each chunk:
+    std::int16_t run_min = 0;
+    std::int16_t run_max = 0;
+    std::int64_t run_sum = 0;
+    std::uint32_t run_count = 0;
+    auto const finish_run = [&] {
+        level.min.push_back(run_min);
+        level.max.push_back(run_max);
+        level.mean.push_back(std::int16_t(std::lround(double(run_sum) / run_count)));
+        run_count = 0;
+    };
+    for (auto const & chunk : signal) {
+        std::size_t offset = 0;
+        while (offset < chunk.size()) {
+            auto const part_size =
+                std::min<std::size_t>(decimation - run_count, chunk.size() - offset);
+            auto const part = chunk.subspan(offset, part_size);
+            auto const minmax = std::minmax_element(part.begin(), part.end());
+            auto const sum = std::accumulate(part.begin(), part.end(), std::int64_t(0));
+            if (run_count == 0) {
+                run_min = *minmax.first;
+                run_max = *minmax.second;
+                run_sum = 0;
+            } else {
+                run_min = std::min(run_min, *minmax.first);
+                run_max = std::max(run_max, *minmax.second);
+            }
+            run_sum += sum;
+            run_count += std::uint32_t(part_size);
+            offset += part_size;
+            if (run_count == decimation) {
+                finish_run();
+            }
+        }
+    }
+    if (run_count > 0) {
+        finish_run();
+    }
+    return level;
+}
+
+SignalStatistics compute_signal_statistics(
+    gsl::span<gsl::span<std::int16_t const> const> const & signal)
+{
+    // Sums are kept exactly, the loop over each chunk being simple enough to vectorise:
+    std::int16_t min = std::numeric_limits<std::int16_t>::max();
+    std::int16_t max = std::numeric_limits<std::int16_t>::min();
+    std::int64_t sum = 0;
+    std::uint64_t sum_of_squares = 0;
+    std::size_t sample_count = 0;
+    for (auto const & chunk : signal) {
+        for (auto const sample : chunk) {
+            min = std::min(min, sample);
+            max = std::max(max, sample);
+            sum += sample;
+            sum_of_squares += std::uint64_t(std::int32_t(sample) * sample);
+        }
+        sample_count += chunk.size();
+    }
+
+    SignalStatistics result;
+    if (sample_count == 0) {
+        return result;
+    }
+    auto const mean = double(sum) / sample_count;
+    auto const variance = double(sum_of_squares) / sample_count - mean * mean;
+    result.min = min;
+    result.max = max;
+    result.mean = float(mean);
+    result.standard_deviation = float(std::sqrt(std::max(variance, 0.0)));
+    return result;
+}
+
+Status check_signal_summary_decimations(std::vector<std::uint32_t> const & decimations)
+{
+    std::set<std::uint32_t> seen;
+    for (auto const decimation : decimations) {
+        if (decimation < 2) {
+            return Status::Invalid("Signal summary decimations must be above 1");
+        }
+        if (!seen.insert(decimation).second) {
+            return Status::Invalid("Signal summary decimation ", decimation, " is repeated");
+        }
+    }
+    return Status::OK();
+}
+
+struct SignalSummaryWriter::LevelRows {
+    std::uint32_t decimation;
+    std::vector<Uuid> read_ids;
+    std::vector<std::int32_t> offsets{0};
+    std::vector<std::int16_t> min;
+    std::vector<std::int16_t> max;
+    std::vector<std::int16_t> mean;
+};
+
+SignalSummaryWriter::SignalSummaryWriter(
+    std::shared_ptr<arrow::Schema> && schema,
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> && writer,
+    std::vector<std::uint32_t> && decimations,
+    arrow::MemoryPool * pool,
+    std::size_t batch_rows)
+: m_schema(std::move(schema))
+, m_writer(std::move(writer))
+, m_pool(pool)
+, m_batch_rows(batch_rows)
+{
+    for (auto const decimation : decimations) {
+        m_levels.push_back({decimation});
+    }
+}
+
+SignalSummaryWriter::~SignalSummaryWriter() = default;
+
+Result<std::unique_ptr<SignalSummaryWriter>> SignalSummaryWriter::open(
+    std::shared_ptr<arrow::io::OutputStream> const & sink,
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    std::vector<std::uint32_t> decimations,
+    arrow::MemoryPool * pool,
+    std::size_t batch_rows)
+{
+    ARROW_RETURN_NOT_OK(check_signal_summary_decimations(decimations));
+    std::sort(decimations.begin(), decimations.end());
+
+    std::string decimations_value;
+    for (auto const decimation : decimations) {
+        decimations_value += (decimations_value.empty() ? "" : ",") + std::to_string(decimation);
+    }
+    auto const summary_metadata =
+        metadata ? metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    summary_metadata->Append(INDEX_TYPE_KEY, SIGNAL_SUMMARY_TYPE);
+    summary_metadata->Append(DECIMATIONS_KEY, decimations_value);
+
+    arrow::ipc::IpcWriteOptions options;
+    options.memory_pool = pool;
+    auto schema = make_signal_summary_schema(summary_metadata);
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options));
+    return std::unique_ptr<SignalSummaryWriter>(new SignalSummaryWriter(
+        std::move(schema),
+        std::move(writer),
+        std::move(decimations),
+        pool,
+        std::max<std::size_t>(batch_rows, 1)));
+}
+
+Status SignalSummaryWriter::add_read(
+    Uuid const & read_id,
+    gsl::span<gsl::span<std::int16_t const> const> const & signal)
+{
+    for (auto & level : m_levels) {
+        auto const summary = summarise_signal(signal, level.decimation);
+        level.read_ids.push_back(read_id);
+        level.min.insert(level.min.end(), summary.min.begin(), summary.min.end());
+        level.max.insert(level.max.end(), summary.max.begin(), summary.max.end());
+        level.mean.insert(level.mean.end(), summary.mean.begin(), summary.mean.end());
+        level.offsets.push_back(std::int32_t(level.min.size()));
+        if (level.read_ids.size() >= m_batch_rows) {
+            ARROW_RETURN_NOT_OK(write_level(level));
+        }
+    }
+    return Status::OK();
+}
+
+Status SignalSummaryWriter::close()
+{
+    for (auto & level : m_levels) {
+        ARROW_RETURN_NOT_OK(write_level(level));
+    }
+    return m_writer->Close();
+}
+
+Status SignalSummaryWriter::write_level(LevelRows & level)
+{
+    if (level.read_ids.empty()) {
+        return Status::OK();
+    }
+
+    arrow::FixedSizeBinaryBuilder read_ids(arrow::fixed_size_binary(sizeof(Uuid)), m_pool);
+    ARROW_RETURN_NOT_OK(read_ids.AppendValues(
+        reinterpret_cast<std::uint8_t const *>(level.read_ids.data()), level.read_ids.size()));
+    ARROW_ASSIGN_OR_RAISE(auto const read_ids_array, read_ids.Finish());
+
+    arrow::UInt32Builder decimations(m_pool);
+    ARROW_RETURN_NOT_OK(decimations.AppendValues(level.read_ids.size(), level.decimation));
+    ARROW_ASSIGN_OR_RAISE(auto const decimations_array, decimations.Finish());
+
+    ARROW_ASSIGN_OR_RAISE(auto const min, make_list_array(level.offsets, level.min, m_pool));
+    ARROW_ASSIGN_OR_RAISE(auto const max, make_list_array(level.offsets, level.max, m_pool));
+    ARROW_ASSIGN_OR_RAISE(auto const mean, make_list_array(level.offsets, level.mean, m_pool));
+
+    auto const batch = arrow::RecordBatch::Make(
+        m_schema,
+        std::int64_t(level.read_ids.size()),
+        {read_ids_array, decimations_array, min, max, mean});
+    ARROW_RETURN_NOT_OK(m_writer->WriteRecordBatch(*batch));
+
+    level.read_ids.clear();
+    level.offsets.assign(1, 0);
+    level.min.clear();
+    level.max.clear();
+    level.mean.clear();
+    return Status::OK();
+}
+
+SignalSummary::SignalSummary(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
+    std::vector<std::uint32_t> && decimations,
+    arrow::MemoryPool * pool)
+: m_file(file)
+, m_reader(std::move(reader))
+, m_decimations(std::move(decimations))
+, m_pool(pool)
+{
+}
+
+Result<std::shared_ptr<SignalSummary const>> SignalSummary::open(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+    arrow::MemoryPool * pool)
+{
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = pool;
+
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(file, options));
+    auto const & metadata = reader->schema()->metadata();
+    if (!metadata) {
+        return std::shared_ptr<SignalSummary const>();
+    }
+    auto const index_type = metadata->Get(INDEX_TYPE_KEY);
+    if (!index_type.ok() || *index_type != SIGNAL_SUMMARY_TYPE) {
+        return std::shared_ptr<SignalSummary const>();
+    }
+    if (!reader->schema()->Equals(*make_signal_summary_schema(nullptr), false)) {
+        return Status::IOError("Invalid signal summary schema");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto decimations, read_decimations(*metadata));
+    std::sort(decimations.begin(), decimations.end());
+    return std::make_shared<SignalSummary const>(
+        file, std::move(reader), std::move(decimations), pool);
+}
+
+Result<std::optional<SignalSummaryLevel>> SignalSummary::find_level(
+    Uuid const & read_id,
+    std::uint32_t decimation) const
+{
+    std::call_once(m_rows_located, [&] { m_locate_status = locate_rows(); });
+    ARROW_RETURN_NOT_OK(m_locate_status);
+
+    auto const level_rows = m_rows.find(decimation);
+    if (level_rows == m_rows.end()) {
+        return std::nullopt;
+    }
+    auto const location = level_rows->second.find(read_id);
+    if (location == level_rows->second.end()) {
+        return std::nullopt;
+    }
+
+    std::shared_ptr<arrow::RecordBatch> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_reader_mutex);
+        ARROW_ASSIGN_OR_RAISE(batch, m_reader->ReadRecordBatch(location->second.batch));
+    }
+    auto const row = location->second.row;
+
+    SignalSummaryLevel level;
+    level.decimation = decimation;
+    level.min = list_values(*std::static_pointer_cast<arrow::ListArray>(batch->column(Min)), row);
+    level.max = list_values(*std::static_pointer_cast<arrow::ListArray>(batch->column(Max)), row);
+    level.mean =
+        list_values(*std::static_pointer_cast<arrow::ListArray>(batch->column(Mean)), row);
+    if (level.max.size() != level.min.size() || level.mean.size() != level.min.size()) {
+        return Status::IOError("Invalid signal summary row");
+    }
+    return level;
+}
+
+Status SignalSummary::locate_rows() const
+{
+    // Only the read id and decimation columns are read to locate rows, not the summaries:
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = m_pool;
+    options.included_fields = {ReadId, Decimation};
+    ARROW_ASSIGN_OR_RAISE(
+        auto const reader, arrow::ipc::RecordBatchFileReader::Open(m_file, options));
+
+    for (int i = 0; i < reader->num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto const batch, reader->ReadRecordBatch(i));
+        auto const read_ids = std::static_pointer_cast<arrow::FixedSizeBinaryArray>(
+            batch->GetColumnByName("read_id"));
+        auto const decimations =
+            std::static_pointer_cast<arrow::UInt32Array>(batch->GetColumnByName("decimation"));
+        if (!read_ids || !decimations) {
+            return Status::IOError("Invalid signal summary batch");
+        }
+        for (std::int64_t row = 0; row < batch->num_rows(); ++row) {
+            auto const read_id_bytes = read_ids->GetValue(row);
+            Uuid const read_id(read_id_bytes, read_id_bytes + sizeof(Uuid));
+            m_rows[decimations->Value(row)][read_id] = {i, row};
+        }
+    }
+    return Status::OK();
+}
+
+}  // namespace pod5
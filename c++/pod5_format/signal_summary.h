@@ -0,0 +1,165 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+#include "pod5_format/uuid.h"
+
+#include <arrow/io/type_fwd.h>
+#include <gsl/gsl-lite.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arrow {
+class KeyValueMetadata;
+class MemoryPool;
+class Schema;
+
+namespace ipc {
+class RecordBatchFileReader;
+class RecordBatchWriter;
+}  // namespace ipc
+}  // namespace arrow
+
+namespace pod5 {
+
+/// \brief A read's signal reduced by [decimation]: the min, max and mean of each run of
+///        [decimation] samples, the last run holding whatever samples remain.
+struct POD5_FORMAT_EXPORT SignalSummaryLevel {
+    std::uint32_t decimation = 0;
+    std::vector<std::int16_t> min;
+    std::vector<std::int16_t> max;
+    /// Means rounded to the nearest sample value.
+    std::vector<std::int16_t> mean;
+
+    std::size_t size() const { return min.size(); }
+};
+
+/// \brief Reduce [signal], given as consecutive chunks, by [decimation].
+POD5_FORMAT_EXPORT SignalSummaryLevel summarise_signal(
+    gsl::span<gsl::span<std::int16_t const> const> const & signal,
+    std::uint32_t decimation);
+
+/// \brief Statistics of a read's samples, stored in the read table of files written with
+///        FileWriterOptions::set_write_signal_statistics.
+struct SignalStatistics {
+    std::int16_t min = 0;
+    std::int16_t max = 0;
+    float mean = 0;
+    /// The population standard deviation of the samples.
+    float standard_deviation = 0;
+};
+
+/// \brief Find the statistics of [signal], given as consecutive chunks, in one pass over it.
+/// \note Signal without samples has statistics of 0.
+POD5_FORMAT_EXPORT SignalStatistics compute_signal_statistics(
+    gsl::span<gsl::span<std::int16_t const> const> const & signal);
+
+/// \brief Check a list of summary decimations, each above 1 and none repeated.
+POD5_FORMAT_EXPORT Status check_signal_summary_decimations(
+    std::vector<std::uint32_t> const & decimations);
+
+/// \brief Writes reads' signal summaries at several decimations, as an arrow ipc file later
+///        embedded in a pod5 file as an OtherIndex.
+///
+/// The file holds a row per read and decimation, with each batch holding rows of a single
+/// decimation, so fetching a coarse level doesn't load the finer levels of other reads. Its
+/// schema is tagged with "MINKNOW:index_type" metadata so it can be told apart from other
+/// OtherIndex embedded files.
+class POD5_FORMAT_EXPORT SignalSummaryWriter {
+public:
+    static constexpr std::size_t DEFAULT_BATCH_ROWS = 64;
+
+    ~SignalSummaryWriter();
+
+    /// \brief Start writing summaries at [decimations] to [sink], tagged with [metadata].
+    static Result<std::unique_ptr<SignalSummaryWriter>> open(
+        std::shared_ptr<arrow::io::OutputStream> const & sink,
+        std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+        std::vector<std::uint32_t> decimations,
+        arrow::MemoryPool * pool,
+        std::size_t batch_rows = DEFAULT_BATCH_ROWS);
+
+    /// \brief Summarise the signal of [read_id], given as consecutive chunks, at every
+    ///        decimation.
+    Status add_read(
+        Uuid const & read_id,
+        gsl::span<gsl::span<std::int16_t const> const> const & signal);
+
+    /// \brief Write the rows not yet written and finish the file.
+    Status close();
+
+private:
+    struct LevelRows;
+
+    SignalSummaryWriter(
+        std::shared_ptr<arrow::Schema> && schema,
+        std::shared_ptr<arrow::ipc::RecordBatchWriter> && writer,
+        std::vector<std::uint32_t> && decimations,
+        arrow::MemoryPool * pool,
+        std::size_t batch_rows);
+
+    Status write_level(LevelRows & level);
+
+    std::shared_ptr<arrow::Schema> m_schema;
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> m_writer;
+    std::vector<LevelRows> m_levels;
+    arrow::MemoryPool * m_pool;
+    std::size_t m_batch_rows;
+};
+
+/// \brief Reads the signal summaries written by SignalSummaryWriter from an OtherIndex
+///        embedded file.
+class POD5_FORMAT_EXPORT SignalSummary {
+public:
+    /// \brief Open summaries written by SignalSummaryWriter from an OtherIndex embedded file.
+    /// \returns The summaries, or null if [file] holds a different kind of index.
+    static Result<std::shared_ptr<SignalSummary const>> open(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+        arrow::MemoryPool * pool);
+
+    SignalSummary(
+        std::shared_ptr<arrow::io::RandomAccessFile> const & file,
+        std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
+        std::vector<std::uint32_t> && decimations,
+        arrow::MemoryPool * pool);
+
+    /// \brief Find the decimations reads are summarised at, in increasing order.
+    std::vector<std::uint32_t> const & decimations() const { return m_decimations; }
+
+    /// \brief Find the summary of [read_id] at [decimation].
+    /// \returns std::nullopt if the read has no summary at [decimation].
+    ///
+    /// The read id and decimation of each row are read on the first call, to locate rows. Only
+    /// the batch holding the row is read after that.
+    Result<std::optional<SignalSummaryLevel>> find_level(
+        Uuid const & read_id,
+        std::uint32_t decimation) const;
+
+private:
+    struct RowLocation {
+        int batch;
+        std::int64_t row;
+    };
+
+    Status locate_rows() const;
+
+    std::shared_ptr<arrow::io::RandomAccessFile> m_file;
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> m_reader;
+    std::vector<std::uint32_t> m_decimations;
+    arrow::MemoryPool * m_pool;
+    mutable std::mutex m_reader_mutex;
+
+    mutable std::once_flag m_rows_located;
+    mutable Status m_locate_status;
+    // Rows of each decimation, by read id:
+    mutable std::map<std::uint32_t, std::unordered_map<Uuid, RowLocation>> m_rows;
+};
+
+}  // namespace pod5
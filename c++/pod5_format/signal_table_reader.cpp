@@ -1,51 +1,70 @@
 #include "pod5_format/signal_table_reader.h"
 
+#include "pod5_format/crc32c.h"
+#include "pod5_format/internal/ipc_file_blocks.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/internal/read_range_coalescing.h"
+#include "pod5_format/internal/sharded_lru_cache.h"
+#include "pod5_format/internal/tracing/tracing.h"
 #include "pod5_format/schema_metadata.h"
+#include "pod5_format/signal_codec.h"
 #include "pod5_format/signal_compression.h"
+#include "pod5_format/signal_row_index.h"
 
 #include <arrow/array/array_nested.h>
 #include <arrow/array/array_primitive.h>
+#include <arrow/buffer.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/dictionary.h>
+#include <arrow/ipc/message.h>
 #include <arrow/ipc/reader.h>
+#include <arrow/util/byte_size.h>
+#include <arrow/util/future.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <numeric>
 
 namespace pod5 {
 
-struct SignalTableReaderCacheCleaner {
-    static void make_space_in_table_batches(
-        std::unordered_map<std::size_t, SignalTableReader::CachedItem> & cached_batches)
-    {
-        std::vector<std::pair<std::size_t, SignalTableReader::AccessIndex>> access_ordered_data;
-        access_ordered_data.reserve(cached_batches.size());
-
-        for (auto item : cached_batches) {
-            access_ordered_data.emplace_back(
-                std::make_pair(item.first, item.second.last_access_index));
-        }
-        std::sort(
-            access_ordered_data.begin(),
-            access_ordered_data.end(),
-            [](auto const & a, auto const & b) { return a.second < b.second; });
-
-        // Clear about 20% of the cache to make space for further growth:
-        auto const to_clear = std::max<std::size_t>(1, cached_batches.size() * 0.2f);
-        for (std::size_t i = 0; i < to_clear; ++i) {
-            auto const index_to_remove = access_ordered_data[i].first;
-            cached_batches.erase(index_to_remove);
-        }
-    }
-};
-
 SignalTableRecordBatch::SignalTableRecordBatch(
     std::shared_ptr<arrow::RecordBatch> const & batch,
     SignalTableSchemaDescription field_locations,
-    arrow::MemoryPool * pool)
+    arrow::MemoryPool * pool,
+    std::shared_ptr<SignalCompressionDictionary const> dictionary,
+    std::shared_ptr<SignalDecompressionCounters> decompression_counters)
 : TableRecordBatch(batch)
 , m_field_locations(field_locations)
 , m_pool(pool)
+, m_dictionary(std::move(dictionary))
+, m_decompression_counters(std::move(decompression_counters))
 {
 }
 
+namespace {
+
+// Run [decompress], adding [sample_count] samples and the time taken to [counters] if set.
+template <typename Decompress>
+Status count_decompression(
+    SignalDecompressionCounters * counters,
+    std::size_t sample_count,
+    Decompress && decompress)
+{
+    if (!counters) {
+        return decompress();
+    }
+    auto const start = std::chrono::steady_clock::now();
+    auto const result = decompress();
+    auto const time = std::chrono::steady_clock::now() - start;
+    counters->decompressed_bytes += sample_count * sizeof(std::int16_t);
+    counters->decompression_nanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+    return result;
+}
+
+}  // namespace
+
 std::shared_ptr<UuidArray> SignalTableRecordBatch::read_id_column() const
 {
     return std::static_pointer_cast<UuidArray>(batch()->column(m_field_locations.read_id));
@@ -67,6 +86,67 @@ std::shared_ptr<arrow::UInt32Array> SignalTableRecordBatch::samples_column() con
     return std::static_pointer_cast<arrow::UInt32Array>(batch()->column(m_field_locations.samples));
 }
 
+std::shared_ptr<arrow::UInt32Array> SignalTableRecordBatch::checksum_column() const
+{
+    if (m_field_locations.checksum < 0) {
+        return nullptr;
+    }
+    return std::static_pointer_cast<arrow::UInt32Array>(
+        batch()->column(m_field_locations.checksum));
+}
+
+gsl::span<std::uint8_t const> SignalTableRecordBatch::stored_signal_row(
+    std::size_t row_index) const
+{
+    if (m_field_locations.signal_type == SignalType::UncompressedSignal) {
+        auto const signal_column = uncompressed_signal_column();
+        auto const values = std::static_pointer_cast<arrow::Int16Array>(signal_column->values());
+        return gsl::make_span(
+                   values->raw_values() + signal_column->value_offset(row_index),
+                   signal_column->value_length(row_index))
+            .as_span<std::uint8_t const>();
+    }
+    return vbz_signal_column()->Value(row_index);
+}
+
+Status SignalTableRecordBatch::verify_signal_checksum(std::size_t row_index) const
+{
+    auto const checksums = checksum_column();
+    if (!checksums) {
+        return pod5::Status::Invalid("Signal table holds no checksums");
+    }
+    if (row_index >= num_rows()) {
+        return pod5::Status::Invalid(
+            "Queried signal row ",
+            row_index,
+            " is outside the available rows (",
+            num_rows(),
+            " in batch)");
+    }
+
+    auto const expected = checksums->Value(row_index);
+    auto const found = crc32c(stored_signal_row(row_index));
+    if (found != expected) {
+        return pod5::Status::IOError(
+            "Signal row ",
+            row_index,
+            " of batch is corrupt, its checksum ",
+            found,
+            " doesn't match the stored checksum ",
+            expected);
+    }
+    return Status::OK();
+}
+
+Status SignalTableRecordBatch::check_signal_row(std::size_t row_index) const
+{
+    auto const interval = m_field_locations.checksum_interval;
+    if (m_field_locations.checksum < 0 || interval == 0 || row_index % interval != 0) {
+        return Status::OK();
+    }
+    return verify_signal_checksum(row_index);
+}
+
 Result<std::size_t> SignalTableRecordBatch::samples_byte_count(std::size_t row_index) const
 {
     switch (m_field_locations.signal_type) {
@@ -75,7 +155,9 @@ Result<std::size_t> SignalTableRecordBatch::samples_byte_count(std::size_t row_i
         auto signal = signal_column->value_slice(row_index);
         return signal->length() * sizeof(std::int16_t);
     }
-    case SignalType::VbzSignal: {
+    case SignalType::VbzSignal:
+    case SignalType::VbzDictionarySignal:
+    case SignalType::CodecSignal: {
         auto signal_column = vbz_signal_column();
         auto signal_compressed = signal_column->Value(row_index);
         return signal_compressed.size();
@@ -88,6 +170,14 @@ Result<std::size_t> SignalTableRecordBatch::samples_byte_count(std::size_t row_i
 Status SignalTableRecordBatch::extract_signal_row(
     std::size_t row_index,
     gsl::span<std::int16_t> samples) const
+{
+    return extract_signal_row(row_index, samples, thread_local_signal_compression_context());
+}
+
+Status SignalTableRecordBatch::extract_signal_row(
+    std::size_t row_index,
+    gsl::span<std::int16_t> samples,
+    SignalCompressionContext & compression_context) const
 {
     if (row_index >= num_rows()) {
         return pod5::Status::Invalid(
@@ -104,6 +194,7 @@ Status SignalTableRecordBatch::extract_signal_row(
         return pod5::Status::Invalid(
             "Unexpected size for sample array ", samples.size(), " expected ", samples_in_row);
     }
+    ARROW_RETURN_NOT_OK(check_signal_row(row_index));
 
     switch (m_field_locations.signal_type) {
     case SignalType::UncompressedSignal: {
@@ -113,18 +204,116 @@ Status SignalTableRecordBatch::extract_signal_row(
         std::copy(signal->raw_values(), signal->raw_values() + signal->length(), samples.begin());
         return Status::OK();
     }
-    case SignalType::VbzSignal: {
+    case SignalType::VbzSignal:
+    case SignalType::VbzDictionarySignal:
+    case SignalType::CodecSignal: {
         auto signal_column = vbz_signal_column();
         auto signal_compressed = signal_column->Value(row_index);
-        return pod5::decompress_signal(signal_compressed, m_pool, samples);
+        compression_context.set_dictionary(m_dictionary);
+        return count_decompression(m_decompression_counters.get(), samples.size(), [&] {
+            return m_field_locations.codec->decompress(
+                signal_compressed, compression_context, samples);
+        });
     }
     }
 
     return pod5::Status::Invalid("Unknown signal type");
 }
 
-Result<std::shared_ptr<arrow::Buffer>> SignalTableRecordBatch::extract_signal_row_inplace(
-    std::size_t row_index) const
+Status SignalTableRecordBatch::extract_signal_rows(
+    gsl::span<std::size_t const> const & row_indices,
+    gsl::span<gsl::span<std::int16_t> const> const & samples,
+    SignalCompressionContext & compression_context) const
+{
+    if (row_indices.size() != samples.size()) {
+        return pod5::Status::Invalid(
+            "Row count (",
+            row_indices.size(),
+            ") must match the sample array count (",
+            samples.size(),
+            ")");
+    }
+    if (m_field_locations.signal_type == SignalType::UncompressedSignal) {
+        for (std::size_t i = 0; i < row_indices.size(); ++i) {
+            ARROW_RETURN_NOT_OK(
+                extract_signal_row(row_indices[i], samples[i], compression_context));
+        }
+        return Status::OK();
+    }
+
+    auto const sample_count = samples_column();
+    auto const signal_column = vbz_signal_column();
+    std::vector<gsl::span<std::uint8_t const>> compressed_rows(row_indices.size());
+    std::size_t total_samples = 0;
+    for (std::size_t i = 0; i < row_indices.size(); ++i) {
+        auto const row_index = row_indices[i];
+        if (row_index >= num_rows()) {
+            return pod5::Status::Invalid(
+                "Queried signal row ",
+                row_index,
+                " is outside the available rows (",
+                num_rows(),
+                " in batch)");
+        }
+        auto const samples_in_row = sample_count->Value(row_index);
+        if (samples_in_row != samples[i].size()) {
+            return pod5::Status::Invalid(
+                "Unexpected size for sample array ",
+                samples[i].size(),
+                " expected ",
+                samples_in_row);
+        }
+        ARROW_RETURN_NOT_OK(check_signal_row(row_index));
+        compressed_rows[i] = signal_column->Value(row_index);
+        total_samples += samples_in_row;
+    }
+
+    compression_context.set_dictionary(m_dictionary);
+    return count_decompression(m_decompression_counters.get(), total_samples, [&] {
+        return m_field_locations.codec->decompress_rows(
+            gsl::make_span(compressed_rows), compression_context, samples);
+    });
+}
+
+std::vector<std::uint64_t> SignalTableRecordBatch::signal_row_offsets() const
+{
+    auto const sample_count = samples_column();
+    std::vector<std::uint64_t> offsets;
+    offsets.reserve(num_rows() + 1);
+    offsets.push_back(0);
+    for (std::size_t row = 0; row < num_rows(); ++row) {
+        offsets.push_back(offsets.back() + sample_count->Value(row));
+    }
+    return offsets;
+}
+
+Status SignalTableRecordBatch::extract_all_signal_rows(
+    gsl::span<std::int16_t> const & samples,
+    SignalCompressionContext & compression_context) const
+{
+    auto const offsets = signal_row_offsets();
+    if (offsets.back() != samples.size()) {
+        return pod5::Status::Invalid(
+            "Unexpected size for sample array ", samples.size(), " expected ", offsets.back());
+    }
+
+    std::vector<std::size_t> row_indices(num_rows());
+    std::iota(row_indices.begin(), row_indices.end(), 0);
+    std::vector<gsl::span<std::int16_t>> row_samples;
+    row_samples.reserve(num_rows());
+    for (std::size_t row = 0; row < num_rows(); ++row) {
+        row_samples.push_back(samples.subspan(offsets[row], offsets[row + 1] - offsets[row]));
+    }
+    return extract_signal_rows(
+        gsl::make_span(row_indices), gsl::make_span(row_samples), compression_context);
+}
+
+template <typename OutputType>
+Status SignalTableRecordBatch::extract_calibrated_row(
+    std::size_t row_index,
+    SignalCalibration const & calibration,
+    gsl::span<OutputType> samples,
+    SignalCompressionContext & compression_context) const
 {
     if (row_index >= num_rows()) {
         return pod5::Status::Invalid(
@@ -135,21 +324,85 @@ Result<std::shared_ptr<arrow::Buffer>> SignalTableRecordBatch::extract_signal_ro
             " in batch)");
     }
 
+    auto sample_count = samples_column();
+    auto samples_in_row = sample_count->Value(row_index);
+    if (samples_in_row != samples.size()) {
+        return pod5::Status::Invalid(
+            "Unexpected size for sample array ", samples.size(), " expected ", samples_in_row);
+    }
+    ARROW_RETURN_NOT_OK(check_signal_row(row_index));
+
     switch (m_field_locations.signal_type) {
     case SignalType::UncompressedSignal: {
         auto signal_column = uncompressed_signal_column();
-        auto const value_slice =
+        auto signal =
             std::static_pointer_cast<arrow::Int16Array>(signal_column->value_slice(row_index));
+        pod5::calibrate_signal(
+            gsl::make_span(signal->raw_values(), signal->length()), calibration, samples);
+        return Status::OK();
+    }
+    case SignalType::VbzSignal:
+    case SignalType::VbzDictionarySignal:
+    case SignalType::CodecSignal: {
+        auto signal_column = vbz_signal_column();
+        auto signal_compressed = signal_column->Value(row_index);
+        compression_context.set_dictionary(m_dictionary);
+        return count_decompression(m_decompression_counters.get(), samples.size(), [&] {
+            return m_field_locations.codec->decompress_calibrated(
+                signal_compressed, compression_context, calibration, samples);
+        });
+    }
+    }
+
+    return pod5::Status::Invalid("Unknown signal type");
+}
 
-        auto const element_size =
-            sizeof(std::remove_reference<decltype(*signal_column)>::type::TypeClass);
+Status SignalTableRecordBatch::extract_signal_row_calibrated(
+    std::size_t row_index,
+    SignalCalibration const & calibration,
+    gsl::span<float> samples,
+    SignalCompressionContext & compression_context) const
+{
+    return extract_calibrated_row(row_index, calibration, samples, compression_context);
+}
 
-        auto const values = value_slice->values();
-        auto offset = signal_column->value_offset(row_index);
-        auto length = signal_column->value_length(row_index);
-        return arrow::SliceBuffer(values, offset * element_size, length * element_size);
+Status SignalTableRecordBatch::extract_signal_row_calibrated(
+    std::size_t row_index,
+    SignalCalibration const & calibration,
+    gsl::span<Float16> samples,
+    SignalCompressionContext & compression_context) const
+{
+    return extract_calibrated_row(row_index, calibration, samples, compression_context);
+}
+
+Status SignalTableRecordBatch::extract_signal_row_calibrated(
+    std::size_t row_index,
+    SignalCalibration const & calibration,
+    gsl::span<std::int8_t> samples,
+    SignalCompressionContext & compression_context) const
+{
+    return extract_calibrated_row(row_index, calibration, samples, compression_context);
+}
+
+Result<std::shared_ptr<arrow::Buffer>> SignalTableRecordBatch::extract_signal_row_inplace(
+    std::size_t row_index) const
+{
+    if (row_index >= num_rows()) {
+        return pod5::Status::Invalid(
+            "Queried signal row ",
+            row_index,
+            " is outside the available rows (",
+            num_rows(),
+            " in batch)");
     }
-    case SignalType::VbzSignal: {
+
+    switch (m_field_locations.signal_type) {
+    case SignalType::UncompressedSignal:
+        return uncompressed_signal_row(row_index);
+    case SignalType::VbzSignal:
+    case SignalType::VbzDictionarySignal:
+    case SignalType::CodecSignal: {
+        ARROW_RETURN_NOT_OK(check_signal_row(row_index));
         auto signal_column = vbz_signal_column();
         return signal_column->ValueAsBuffer(row_index);
     }
@@ -158,74 +411,361 @@ Result<std::shared_ptr<arrow::Buffer>> SignalTableRecordBatch::extract_signal_ro
     return pod5::Status::Invalid("Unknown signal type");
 }
 
+Result<std::shared_ptr<arrow::Buffer>> SignalTableRecordBatch::uncompressed_signal_row(
+    std::size_t row_index) const
+{
+    if (m_field_locations.signal_type != SignalType::UncompressedSignal) {
+        return pod5::Status::Invalid("Signal is compressed, and can't be read in place");
+    }
+    if (row_index >= num_rows()) {
+        return pod5::Status::Invalid(
+            "Queried signal row ",
+            row_index,
+            " is outside the available rows (",
+            num_rows(),
+            " in batch)");
+    }
+
+    ARROW_RETURN_NOT_OK(check_signal_row(row_index));
+
+    auto signal_column = uncompressed_signal_column();
+    auto const values = std::static_pointer_cast<arrow::Int16Array>(signal_column->values());
+
+    // Slice the values buffer directly, the slice holds a reference to the batch's buffer:
+    auto const element_size = sizeof(std::int16_t);
+    auto const offset = values->offset() + signal_column->value_offset(row_index);
+    auto const length = signal_column->value_length(row_index);
+    return arrow::SliceBuffer(values->values(), offset * element_size, length * element_size);
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 
 SignalTableReader::SignalTableReader(
     std::shared_ptr<void> && input_source,
     std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
+    std::shared_ptr<arrow::Schema> schema,
     SignalTableSchemaDescription field_locations,
     SchemaMetadataDescription && schema_metadata,
     std::size_t num_record_batches,
     std::size_t batch_size,
     std::size_t max_cached_table_batches,
-    arrow::MemoryPool * pool)
-: TableReader(std::move(input_source), std::move(reader), std::move(schema_metadata), pool)
+    std::size_t max_cached_table_batch_bytes,
+    arrow::MemoryPool * pool,
+    std::shared_ptr<SignalCompressionDictionary const> dictionary,
+    std::shared_ptr<arrow::io::RandomAccessFile> input_file,
+    std::vector<RecordBatchLocation> batch_locations)
+: TableReader(
+      std::move(input_source),
+      std::move(reader),
+      std::move(schema),
+      num_record_batches,
+      std::move(schema_metadata),
+      pool)
 , m_field_locations(field_locations)
 , m_pool(pool)
-, m_max_cached_table_batches(max_cached_table_batches)
-, m_table_batches(num_record_batches)
+, m_dictionary(std::move(dictionary))
+, m_decompression_counters(std::make_shared<SignalDecompressionCounters>())
+, m_table_batches(std::make_unique<ShardedLruCache<SignalTableRecordBatch>>(
+      max_cached_table_batches,
+      max_cached_table_batch_bytes,
+      "signal table batch cache"))
 , m_batch_size(batch_size)
+, m_input_file(std::move(input_file))
+, m_batch_locations(std::move(batch_locations))
 {
+    // Locations found in the table's own footer don't know their rows:
+    bool const rows_listed = !m_batch_locations.empty()
+                             && m_batch_locations.size() == num_record_batches
+                             && std::all_of(
+                                 m_batch_locations.begin(),
+                                 m_batch_locations.end(),
+                                 [](RecordBatchLocation const & l) { return l.row_count > 0; });
+    if (rows_listed) {
+        m_batch_first_rows.reserve(m_batch_locations.size() + 1);
+        m_batch_first_rows.push_back(0);
+        for (auto const & location : m_batch_locations) {
+            m_batch_first_rows.push_back(m_batch_first_rows.back() + location.row_count);
+        }
+    }
 }
 
-SignalTableReader::SignalTableReader(SignalTableReader && other)
-: TableReader(std::move(other))
-, m_field_locations(std::move(other.m_field_locations))
-, m_pool(other.m_pool)
-, m_max_cached_table_batches(other.m_max_cached_table_batches)
-, m_table_batches(std::move(other.m_table_batches))
-, m_batch_size(other.m_batch_size)
+SignalTableReader::SignalTableReader(SignalTableReader && other) = default;
+SignalTableReader & SignalTableReader::operator=(SignalTableReader && other) = default;
+SignalTableReader::~SignalTableReader() = default;
+
+namespace {
+
+using CachedSignalBatch = ShardedLruCache<SignalTableRecordBatch>::LoadedValue;
+
+CachedSignalBatch make_cached_batch(SignalTableRecordBatch && batch)
 {
+    auto const byte_size = arrow::util::TotalBufferSize(*batch.batch());
+    return CachedSignalBatch{std::move(batch), static_cast<std::size_t>(byte_size)};
 }
 
-SignalTableReader & SignalTableReader::operator=(SignalTableReader && other)
+}  // namespace
+
+Result<SignalTableRecordBatch> SignalTableReader::read_record_batch(std::size_t i) const
 {
-    m_field_locations = std::move(other.m_field_locations);
-    m_pool = other.m_pool;
-    m_max_cached_table_batches = other.m_max_cached_table_batches;
-    m_batch_size = other.m_batch_size;
-    m_table_batches = std::move(other.m_table_batches);
-    static_cast<TableReader &>(*this) = std::move(static_cast<TableReader &>(other));
-    return *this;
+    return read_cached_batch(i, true);
 }
 
-Result<SignalTableRecordBatch> SignalTableReader::read_record_batch(std::size_t i) const
+Result<SignalTableRecordBatch> SignalTableReader::read_cached_batch(
+    std::size_t i,
+    bool planned_read) const
+{
+    auto const load = [&]() -> Result<CachedSignalBatch> {
+        POD5_TRACE_SPAN("SignalTableReader::load_record_batch");
+        // Loads from many threads can run at once. Located batches are decoded from their own
+        // messages, without the ipc reader:
+        if (has_batch_locations()) {
+            ARROW_ASSIGN_OR_RAISE(auto const message, read_record_batch_message(i));
+            ARROW_ASSIGN_OR_RAISE(auto batch, decode_batch_message(i, *message));
+            return make_cached_batch(std::move(batch));
+        }
+        // Otherwise the ipc reader only mutates its state reading dictionaries, with its first
+        // batch read, which make_signal_table_reader() does for tables whose batches it can't
+        // locate:
+        if (!reader()) {
+            return Status::Invalid("Signal batch locations unknown, can't read batch ", i);
+        }
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader()->ReadRecordBatch(i));
+        count_batch_decoded();
+        return make_cached_batch(
+            {batch, m_field_locations, m_pool, m_dictionary, m_decompression_counters});
+    };
+    return planned_read ? m_table_batches->get(i, load) : m_table_batches->load_ahead(i, load);
+}
+
+void SignalTableReader::set_batch_access_plan(std::vector<std::size_t> const & batches)
+{
+    m_table_batches->set_access_plan(batches);
+}
+
+void SignalTableReader::clear_batch_access_plan() { m_table_batches->clear_access_plan(); }
+
+std::size_t SignalTableReader::cached_batch_count() const
+{
+    return m_table_batches->item_count();
+}
+
+std::size_t SignalTableReader::cached_batch_bytes() const { return m_table_batches->byte_size(); }
+
+std::size_t SignalTableReader::cached_decoded_read_bytes() const
+{
+    return m_decoded_reads ? m_decoded_reads->byte_size() : 0;
+}
+
+void SignalTableReader::clear_cache()
 {
-    std::lock_guard<std::mutex> l(m_batch_get_mutex);
-    if (m_last_read_record_batch_index == i) {
-        return pod5::SignalTableRecordBatch{m_last_read_record_batch, m_field_locations, m_pool};
+    m_table_batches->clear();
+    if (m_decoded_reads) {
+        m_decoded_reads->clear();
     }
+}
+
+SignalTableStatistics SignalTableReader::statistics() const
+{
+    auto const cache_statistics = m_table_batches->statistics();
+    SignalTableStatistics result;
+    result.batches_decoded = batches_decoded();
+    result.cache_hits = cache_statistics.hits;
+    result.cache_misses = cache_statistics.misses;
+    result.cache_evictions = cache_statistics.evictions;
+    if (m_decoded_reads) {
+        auto const decoded_read_statistics = m_decoded_reads->statistics();
+        result.decoded_read_cache_hits = decoded_read_statistics.hits;
+        result.decoded_read_cache_misses = decoded_read_statistics.misses;
+        result.decoded_read_cache_evictions = decoded_read_statistics.evictions;
+    }
+    result.decompressed_bytes = m_decompression_counters->decompressed_bytes;
+    result.decompression_time =
+        std::chrono::nanoseconds(m_decompression_counters->decompression_nanoseconds.load());
+    return result;
+}
+
+Status SignalTableReader::prefetch_record_batches(
+    gsl::span<std::size_t const> const & batches) const
+{
+    if (!has_batch_locations()) {
+        return Status::OK();
+    }
+
+    std::vector<internal::ByteRange> ranges;
+    for (auto const batch : batches) {
+        if (batch >= m_batch_locations.size()) {
+            return Status::Invalid("Batch index ", batch, " outside of signal table");
+        }
+        if (!m_table_batches->contains(batch)) {
+            auto const & location = m_batch_locations[batch];
+            ranges.push_back({location.offset, location.length()});
+        }
+    }
+    if (ranges.empty()) {
+        return Status::OK();
+    }
+
+    // Coalesced hints read ahead in fewer, larger requests, as the loads will:
+    if (m_read_coalescing) {
+        ranges = internal::coalesce_byte_ranges(
+                     ranges,
+                     m_read_coalescing->hole_size_limit,
+                     m_read_coalescing->range_size_limit)
+                     .reads;
+    }
+    std::vector<arrow::io::ReadRange> hint_ranges;
+    hint_ranges.reserve(ranges.size());
+    for (auto const & range : ranges) {
+        hint_ranges.push_back({range.offset, range.length});
+    }
+    return m_input_file->WillNeed(hint_ranges);
+}
+
+Status SignalTableReader::load_record_batches(gsl::span<std::size_t const> const & batches) const
+{
+    std::vector<std::size_t> batches_to_load;
+    for (auto const batch : batches) {
+        if (batch >= num_record_batches()) {
+            return Status::Invalid("Batch index ", batch, " outside of signal table");
+        }
+        if (!m_table_batches->contains(batch)
+            && std::find(batches_to_load.begin(), batches_to_load.end(), batch)
+                   == batches_to_load.end())
+        {
+            batches_to_load.push_back(batch);
+        }
+    }
+    // Loading more than the cache holds would evict the first batches before they are used:
+    auto const max_cached_batches = m_table_batches->max_item_count();
+    if (max_cached_batches != 0 && batches_to_load.size() > max_cached_batches) {
+        batches_to_load.resize(max_cached_batches);
+    }
+
+    if (!has_batch_locations()) {
+        for (auto const batch : batches_to_load) {
+            ARROW_RETURN_NOT_OK(read_cached_batch(batch, false));
+        }
+        return Status::OK();
+    }
+
+    // Likewise for the cache's byte limit, though always load at least one batch:
+    auto const max_cached_bytes = m_table_batches->max_byte_size();
+    std::vector<internal::ByteRange> ranges;
+    ranges.reserve(batches_to_load.size());
+    std::size_t load_bytes = 0;
+    for (auto const batch : batches_to_load) {
+        auto const & location = m_batch_locations[batch];
+        load_bytes += location.length();
+        if (max_cached_bytes != 0 && !ranges.empty() && load_bytes > max_cached_bytes) {
+            break;
+        }
+        ranges.push_back({location.offset, location.length()});
+    }
+    batches_to_load.resize(ranges.size());
+
+    // Coalescing merges nearby batches into one read, each batch is then a slice of its read:
+    internal::CoalescedReads coalesced;
+    if (m_read_coalescing) {
+        coalesced = internal::coalesce_byte_ranges(
+            ranges, m_read_coalescing->hole_size_limit, m_read_coalescing->range_size_limit);
+    } else {
+        coalesced.reads = ranges;
+        coalesced.read_for_range.resize(ranges.size());
+        std::iota(coalesced.read_for_range.begin(), coalesced.read_for_range.end(), 0);
+    }
+
+    // Issue every read before waiting on any, so they can all be in flight at once:
+    std::vector<arrow::Future<std::shared_ptr<arrow::Buffer>>> reads;
+    reads.reserve(coalesced.reads.size());
+    for (auto const & read : coalesced.reads) {
+        reads.push_back(
+            m_input_file->ReadAsync(arrow::io::default_io_context(), read.offset, read.length));
+    }
+
+    for (std::size_t i = 0; i < batches_to_load.size(); ++i) {
+        auto const batch_index = batches_to_load[i];
+        auto const & location = m_batch_locations[batch_index];
+        ARROW_RETURN_NOT_OK(
+            m_table_batches->load_ahead(batch_index, [&]() -> Result<CachedSignalBatch> {
+                auto const read_index = coalesced.read_for_range[i];
+                auto const & read = coalesced.reads[read_index];
+                ARROW_ASSIGN_OR_RAISE(auto const read_buffer, reads[read_index].result());
+                if (read_buffer->size() != read.length) {
+                    return Status::IOError("Truncated read of signal batch ", batch_index);
+                }
+                auto const buffer = arrow::SliceBuffer(
+                    read_buffer, ranges[i].offset - read.offset, ranges[i].length);
+
+                arrow::io::BufferReader stream(buffer);
+                ARROW_ASSIGN_OR_RAISE(
+                    auto const message,
+                    arrow::ipc::ReadMessage(0, location.metadata_length, &stream));
+                if (!message) {
+                    return Status::IOError("Missing message for signal batch ", batch_index);
+                }
+                ARROW_ASSIGN_OR_RAISE(auto batch, decode_batch_message(batch_index, *message));
+                return make_cached_batch(std::move(batch));
+            }));
+    }
+    return Status::OK();
+}
 
-    auto it = m_table_batches.find(i);
-    if (it != m_table_batches.end()) {
-        it->second.last_access_index = m_last_access_index++;
-        return it->second.item;
+Result<std::unique_ptr<arrow::ipc::Message>> SignalTableReader::read_record_batch_message(
+    std::size_t i) const
+{
+    if (i >= num_record_batches()) {
+        return Status::Invalid("Batch index ", i, " outside of signal table");
+    }
+    if (!has_batch_locations()) {
+        return Status::Invalid("Signal batch locations unknown, can't read batch messages");
     }
 
-    // If limited in cached batches, then ensure we apply limit:
-    if (m_max_cached_table_batches != 0 && m_table_batches.size() >= m_max_cached_table_batches) {
-        SignalTableReaderCacheCleaner::make_space_in_table_batches(m_table_batches);
-        assert(m_table_batches.size() < m_max_cached_table_batches);
+    auto const & location = m_batch_locations[i];
+    ARROW_ASSIGN_OR_RAISE(
+        auto const buffer, m_input_file->ReadAt(location.offset, location.length()));
+    if (buffer->size() != location.length()) {
+        return Status::IOError("Truncated read of signal batch ", i);
     }
 
-    ARROW_ASSIGN_OR_RAISE(m_last_read_record_batch, reader()->ReadRecordBatch(i));
-    m_last_read_record_batch_index = i;
-    auto inserted = m_table_batches.emplace(
-        i,
-        CachedItem{
-            pod5::SignalTableRecordBatch{m_last_read_record_batch, m_field_locations, m_pool},
-            m_last_access_index++});
-    return inserted.first->second.item;
+    arrow::io::BufferReader stream(buffer);
+    ARROW_ASSIGN_OR_RAISE(
+        auto message, arrow::ipc::ReadMessage(0, location.metadata_length, &stream));
+    if (!message || message->type() != arrow::ipc::MessageType::RECORD_BATCH) {
+        return Status::IOError("Missing message for signal batch ", i);
+    }
+    return message;
+}
+
+Result<SignalTableRecordBatch> SignalTableReader::decode_batch_message(
+    std::size_t i,
+    arrow::ipc::Message const & message) const
+{
+    arrow::ipc::IpcReadOptions options;
+    options.memory_pool = m_pool;
+    // Signal tables hold no dictionary encoded columns, so the memo stays empty:
+    arrow::ipc::DictionaryMemo dictionary_memo;
+    ARROW_ASSIGN_OR_RAISE(
+        auto batch, arrow::ipc::ReadRecordBatch(message, schema(), &dictionary_memo, options));
+    count_batch_decoded();
+
+    // Rows listed by the file's footer place reads in batches, so they must match the batch:
+    auto const listed_rows = m_batch_locations[i].row_count;
+    if (listed_rows > 0 && listed_rows != batch->num_rows()) {
+        return Status::IOError(
+            "Signal batch ",
+            i,
+            " holds ",
+            batch->num_rows(),
+            " rows, but the file's footer lists ",
+            listed_rows);
+    }
+    return SignalTableRecordBatch{
+        batch, m_field_locations, m_pool, m_dictionary, m_decompression_counters};
+}
+
+bool SignalTableReader::has_batch_locations() const
+{
+    return m_input_file && m_batch_locations.size() == num_record_batches();
 }
 
 Result<std::size_t> SignalTableReader::signal_batch_for_row_id(
@@ -236,6 +776,19 @@ Result<std::size_t> SignalTableReader::signal_batch_for_row_id(
         return Status::Invalid("Invalid row '", row, "' for file with zero signal rows.");
     }
 
+    if (!m_batch_first_rows.empty()) {
+        // Find the last batch starting at or before the row:
+        auto const next_batch =
+            std::upper_bound(m_batch_first_rows.begin(), m_batch_first_rows.end(), row);
+        if (next_batch == m_batch_first_rows.end()) {
+            return Status::Invalid("Row outside batch bounds");
+        }
+        if (batch_row) {
+            *batch_row = row - *(next_batch - 1);
+        }
+        return std::size_t(next_batch - m_batch_first_rows.begin()) - 1;
+    }
+
     auto batch = row / m_batch_size;
 
     if (batch_row) {
@@ -249,25 +802,394 @@ Result<std::size_t> SignalTableReader::signal_batch_for_row_id(
     return batch;
 }
 
+Result<std::uint64_t> SignalTableReader::batch_first_row(std::size_t batch) const
+{
+    if (batch > num_record_batches()) {
+        return Status::Invalid("Batch index ", batch, " outside of signal table");
+    }
+    if (!m_batch_first_rows.empty()) {
+        return m_batch_first_rows[batch];
+    }
+    if (batch == num_record_batches()) {
+        return Status::Invalid("Signal table row count unknown, as its batches aren't listed");
+    }
+    return std::uint64_t(batch) * m_batch_size;
+}
+
 Result<std::size_t> SignalTableReader::extract_sample_count(
     gsl::span<std::uint64_t const> const & row_indices) const
 {
     std::size_t sample_count = 0;
     for (auto const & signal_row : row_indices) {
+        ARROW_ASSIGN_OR_RAISE(auto const row_samples, row_sample_count(signal_row));
+        sample_count += row_samples;
+    }
+    return sample_count;
+}
+
+Result<std::vector<std::uint64_t>> SignalTableReader::extract_chunk_boundaries(
+    gsl::span<std::uint64_t const> const & row_indices) const
+{
+    std::vector<std::uint64_t> boundaries;
+    boundaries.reserve(row_indices.size() + 1);
+    std::uint64_t offset = 0;
+    for (auto const & signal_row : row_indices) {
+        boundaries.push_back(offset);
+        ARROW_ASSIGN_OR_RAISE(auto const row_samples, row_sample_count(signal_row));
+        offset += row_samples;
+    }
+    boundaries.push_back(offset);
+    return boundaries;
+}
+
+Result<std::uint64_t> SignalTableReader::row_sample_count(std::uint64_t row) const
+{
+    if (m_row_index && row < m_row_index->row_count()) {
+        return m_row_index->sample_count(row);
+    }
+
+    std::size_t batch_row = 0;
+    ARROW_ASSIGN_OR_RAISE(auto const signal_batch_index, signal_batch_for_row_id(row, &batch_row));
+    // Counts are often found ahead of reading the signal, so don't move an access plan on:
+    ARROW_ASSIGN_OR_RAISE(auto const & signal_batch, read_cached_batch(signal_batch_index, false));
+    return signal_batch.samples_column()->Value(batch_row);
+}
+
+Status SignalTableReader::extract_samples(
+    gsl::span<std::uint64_t const> const & row_indices,
+    gsl::span<std::int16_t> const & output_samples) const
+{
+    return extract_samples(
+        row_indices, output_samples, thread_local_signal_compression_context());
+}
+
+Status SignalTableReader::extract_samples(
+    gsl::span<std::uint64_t const> const & row_indices,
+    gsl::span<std::int16_t> const & output_samples,
+    SignalCompressionContext & compression_context) const
+{
+    if (!m_decoded_reads || row_indices.empty()) {
+        return decode_samples(row_indices, output_samples, compression_context);
+    }
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto const samples, extract_sample_buffer(row_indices, compression_context));
+    if (static_cast<std::size_t>(samples->size()) > output_samples.size_bytes()) {
+        return Status::Invalid("Too few samples in input samples array");
+    }
+    std::memcpy(output_samples.data(), samples->data(), samples->size());
+    return Status::OK();
+}
+
+Status SignalTableReader::decode_samples(
+    gsl::span<std::uint64_t const> const & row_indices,
+    gsl::span<std::int16_t> const & output_samples,
+    SignalCompressionContext & compression_context) const
+{
+    std::size_t sample_count = 0;
+
+    // Consecutive rows of one batch are decompressed together, so codecs can decode them at once:
+    std::vector<std::size_t> batch_rows;
+    std::vector<gsl::span<std::int16_t>> batch_samples;
+    for (std::size_t i = 0; i < row_indices.size();) {
         std::size_t batch_row = 0;
         ARROW_ASSIGN_OR_RAISE(
-            auto const signal_batch_index, signal_batch_for_row_id(signal_row, &batch_row));
+            auto const signal_batch_index, signal_batch_for_row_id(row_indices[i], &batch_row));
 
         ARROW_ASSIGN_OR_RAISE(auto const & signal_batch, read_record_batch(signal_batch_index));
         auto const & samples_column = signal_batch.samples_column();
-        sample_count += samples_column->Value(batch_row);
+        batch_rows.clear();
+        batch_samples.clear();
+        for (; i < row_indices.size(); ++i) {
+            ARROW_ASSIGN_OR_RAISE(
+                auto const row_batch_index, signal_batch_for_row_id(row_indices[i], &batch_row));
+            if (row_batch_index != signal_batch_index) {
+                break;
+            }
+
+            auto const row_samples_count = samples_column->Value(batch_row);
+            std::size_t const sample_start = sample_count;
+            sample_count += row_samples_count;
+            if (sample_count > output_samples.size()) {
+                return Status::Invalid("Too few samples in input samples array");
+            }
+            batch_rows.push_back(batch_row);
+            batch_samples.push_back(output_samples.subspan(sample_start, row_samples_count));
+        }
+
+        ARROW_RETURN_NOT_OK(signal_batch.extract_signal_rows(
+            gsl::make_span(batch_rows), gsl::make_span(batch_samples), compression_context));
     }
-    return sample_count;
+    return Status::OK();
 }
 
 Status SignalTableReader::extract_samples(
     gsl::span<std::uint64_t const> const & row_indices,
+    gsl::span<std::int16_t> const & output_samples,
+    ThreadPool & thread_pool) const
+{
+    ARROW_ASSIGN_OR_RAISE(auto const sample_offsets, extract_sample_offsets(row_indices));
+    if (sample_offsets.back() > output_samples.size()) {
+        return Status::Invalid("Too few samples in input samples array");
+    }
+
+    return internal::run_parallel_tasks(
+        &thread_pool, row_indices.size(), [&](std::size_t row) -> Status {
+            std::size_t batch_row = 0;
+            ARROW_ASSIGN_OR_RAISE(
+                auto const signal_batch_index,
+                signal_batch_for_row_id(row_indices[row], &batch_row));
+
+            ARROW_ASSIGN_OR_RAISE(auto const & signal_batch, read_record_batch(signal_batch_index));
+            return signal_batch.extract_signal_row(
+                batch_row,
+                output_samples.subspan(
+                    sample_offsets[row], sample_offsets[row + 1] - sample_offsets[row]),
+                thread_local_signal_compression_context());
+        });
+}
+
+Result<std::vector<SignalTableReader::ReadRowLocation>> SignalTableReader::locate_reads_rows(
+    gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+    gsl::span<std::uint64_t> const & sample_offsets,
+    std::size_t output_sample_count) const
+{
+    if (sample_offsets.size() != reads_row_indices.size() + 1) {
+        return Status::Invalid(
+            "Sample offsets size (",
+            sample_offsets.size(),
+            ") must be one more than the read count (",
+            reads_row_indices.size(),
+            ")");
+    }
+
+    // Each signal row of every read, found once here and decompressed by one task:
+    std::vector<ReadRowLocation> rows;
+
+    std::uint64_t sample_count = 0;
+    for (std::size_t read = 0; read < reads_row_indices.size(); ++read) {
+        sample_offsets[read] = sample_count;
+        for (auto const & signal_row : reads_row_indices[read]) {
+            ReadRowLocation row;
+            row.read = read;
+            ARROW_ASSIGN_OR_RAISE(
+                row.signal_batch_index, signal_batch_for_row_id(signal_row, &row.batch_row));
+
+            // With a row index, batches are only loaded by the tasks decompressing them:
+            row.sample_start = sample_count;
+            ARROW_ASSIGN_OR_RAISE(row.sample_count, row_sample_count(signal_row));
+            sample_count += row.sample_count;
+            rows.push_back(row);
+        }
+    }
+    sample_offsets[reads_row_indices.size()] = sample_count;
+
+    if (sample_count > output_sample_count) {
+        return Status::Invalid("Too few samples in input samples array");
+    }
+    return rows;
+}
+
+Status SignalTableReader::extract_samples_for_reads(
+    gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+    gsl::span<std::int16_t> const & output_samples,
+    gsl::span<std::uint64_t> const & sample_offsets,
+    ThreadPool & thread_pool) const
+{
+    ARROW_ASSIGN_OR_RAISE(
+        auto const rows,
+        locate_reads_rows(reads_row_indices, sample_offsets, output_samples.size()));
+
+    return internal::run_parallel_tasks(&thread_pool, rows.size(), [&](std::size_t i) -> Status {
+        auto const & row = rows[i];
+        ARROW_ASSIGN_OR_RAISE(auto const & signal_batch, read_record_batch(row.signal_batch_index));
+        return signal_batch.extract_signal_row(
+            row.batch_row,
+            output_samples.subspan(row.sample_start, row.sample_count),
+            thread_local_signal_compression_context());
+    });
+}
+
+template <typename OutputType>
+Status SignalTableReader::extract_calibrated_reads(
+    gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+    gsl::span<SignalCalibration const> const & calibrations,
+    gsl::span<OutputType> const & output_samples,
+    gsl::span<std::uint64_t> const & sample_offsets,
+    ThreadPool & thread_pool) const
+{
+    if (calibrations.size() != reads_row_indices.size()) {
+        return Status::Invalid(
+            "Calibration count (",
+            calibrations.size(),
+            ") must match the read count (",
+            reads_row_indices.size(),
+            ")");
+    }
+    ARROW_ASSIGN_OR_RAISE(
+        auto const rows,
+        locate_reads_rows(reads_row_indices, sample_offsets, output_samples.size()));
+
+    // Each row is decoded straight to its calibrated output, with no intermediate int16 copy:
+    return internal::run_parallel_tasks(&thread_pool, rows.size(), [&](std::size_t i) -> Status {
+        auto const & row = rows[i];
+        ARROW_ASSIGN_OR_RAISE(auto const & signal_batch, read_record_batch(row.signal_batch_index));
+        return signal_batch.extract_signal_row_calibrated(
+            row.batch_row,
+            calibrations[row.read],
+            output_samples.subspan(row.sample_start, row.sample_count),
+            thread_local_signal_compression_context());
+    });
+}
+
+Status SignalTableReader::extract_samples_calibrated_for_reads(
+    gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+    gsl::span<SignalCalibration const> const & calibrations,
+    gsl::span<float> const & output_samples,
+    gsl::span<std::uint64_t> const & sample_offsets,
+    ThreadPool & thread_pool) const
+{
+    return extract_calibrated_reads(
+        reads_row_indices, calibrations, output_samples, sample_offsets, thread_pool);
+}
+
+Status SignalTableReader::extract_samples_calibrated_for_reads(
+    gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+    gsl::span<SignalCalibration const> const & calibrations,
+    gsl::span<Float16> const & output_samples,
+    gsl::span<std::uint64_t> const & sample_offsets,
+    ThreadPool & thread_pool) const
+{
+    return extract_calibrated_reads(
+        reads_row_indices, calibrations, output_samples, sample_offsets, thread_pool);
+}
+
+Status SignalTableReader::extract_samples_calibrated_for_reads(
+    gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+    gsl::span<SignalCalibration const> const & calibrations,
+    gsl::span<std::int8_t> const & output_samples,
+    gsl::span<std::uint64_t> const & sample_offsets,
+    ThreadPool & thread_pool) const
+{
+    return extract_calibrated_reads(
+        reads_row_indices, calibrations, output_samples, sample_offsets, thread_pool);
+}
+
+Result<std::vector<std::uint64_t>> SignalTableReader::extract_sample_offsets(
+    gsl::span<std::uint64_t const> const & row_indices) const
+{
+    std::vector<std::uint64_t> sample_offsets;
+    sample_offsets.reserve(row_indices.size() + 1);
+
+    std::uint64_t sample_count = 0;
+    for (auto const & signal_row : row_indices) {
+        ARROW_ASSIGN_OR_RAISE(auto const row_samples, row_sample_count(signal_row));
+        sample_offsets.push_back(sample_count);
+        sample_count += row_samples;
+    }
+    sample_offsets.push_back(sample_count);
+    return sample_offsets;
+}
+
+Status SignalTableReader::extract_samples_range(
+    gsl::span<std::uint64_t const> const & row_indices,
+    std::uint64_t sample_start,
     gsl::span<std::int16_t> const & output_samples) const
+{
+    ARROW_ASSIGN_OR_RAISE(auto const sample_offsets, extract_sample_offsets(row_indices));
+    return extract_samples_range(
+        row_indices,
+        sample_offsets,
+        sample_start,
+        output_samples,
+        thread_local_signal_compression_context());
+}
+
+Status SignalTableReader::extract_samples_range(
+    gsl::span<std::uint64_t const> const & row_indices,
+    gsl::span<std::uint64_t const> const & sample_offsets,
+    std::uint64_t sample_start,
+    gsl::span<std::int16_t> const & output_samples,
+    SignalCompressionContext & compression_context) const
+{
+    if (sample_offsets.size() != row_indices.size() + 1) {
+        return Status::Invalid(
+            "Expected ",
+            row_indices.size() + 1,
+            " sample offsets for signal rows, got ",
+            sample_offsets.size());
+    }
+    // Checked without adding [sample_start] to the size, which could overflow:
+    std::uint64_t const total_samples = sample_offsets.back();
+    if (sample_start > total_samples || output_samples.size() > total_samples - sample_start) {
+        return Status::Invalid(
+            "Requested ",
+            output_samples.size(),
+            " samples from ",
+            sample_start,
+            " are outside the signal (",
+            total_samples,
+            " samples)");
+    }
+    std::uint64_t const sample_end = sample_start + output_samples.size();
+    if (output_samples.empty()) {
+        return Status::OK();
+    }
+
+    // Binary search for the first row holding [sample_start]:
+    auto const first_row = std::upper_bound(
+                               sample_offsets.begin(), sample_offsets.end() - 1, sample_start)
+                           - sample_offsets.begin() - 1;
+
+    std::vector<std::int16_t> partial_row;
+    for (std::size_t row = first_row; row < row_indices.size() && sample_offsets[row] < sample_end;
+         ++row)
+    {
+        std::size_t batch_row = 0;
+        ARROW_ASSIGN_OR_RAISE(
+            auto const signal_batch_index, signal_batch_for_row_id(row_indices[row], &batch_row));
+        ARROW_ASSIGN_OR_RAISE(auto const & signal_batch, read_record_batch(signal_batch_index));
+
+        auto const row_start = sample_offsets[row];
+        auto const row_end = sample_offsets[row + 1];
+        auto const copy_start = std::max(row_start, sample_start);
+        auto const copy_end = std::min(row_end, sample_end);
+        auto const destination =
+            output_samples.subspan(copy_start - sample_start, copy_end - copy_start);
+
+        if (copy_start == row_start && copy_end == row_end) {
+            // Whole row is wanted, decode straight into the output:
+            ARROW_RETURN_NOT_OK(
+                signal_batch.extract_signal_row(batch_row, destination, compression_context));
+            continue;
+        }
+
+        partial_row.resize(row_end - row_start);
+        ARROW_RETURN_NOT_OK(signal_batch.extract_signal_row(
+            batch_row, gsl::make_span(partial_row), compression_context));
+        std::copy(
+            partial_row.begin() + (copy_start - row_start),
+            partial_row.begin() + (copy_end - row_start),
+            destination.begin());
+    }
+    return Status::OK();
+}
+
+Status SignalTableReader::extract_samples_calibrated(
+    gsl::span<std::uint64_t const> const & row_indices,
+    SignalCalibration const & calibration,
+    gsl::span<float> const & output_samples) const
+{
+    return extract_samples_calibrated(
+        row_indices, calibration, output_samples, thread_local_signal_compression_context());
+}
+
+template <typename OutputType>
+Status SignalTableReader::extract_calibrated_samples(
+    gsl::span<std::uint64_t const> const & row_indices,
+    SignalCalibration const & calibration,
+    gsl::span<OutputType> const & output_samples,
+    SignalCompressionContext & compression_context) const
 {
     std::size_t sample_count = 0;
 
@@ -285,12 +1207,115 @@ Status SignalTableReader::extract_samples(
             return Status::Invalid("Too few samples in input samples array");
         }
 
-        ARROW_RETURN_NOT_OK(signal_batch.extract_signal_row(
-            batch_row, output_samples.subspan(sample_start, row_samples_count)));
+        ARROW_RETURN_NOT_OK(signal_batch.extract_signal_row_calibrated(
+            batch_row,
+            calibration,
+            output_samples.subspan(sample_start, row_samples_count),
+            compression_context));
     }
     return Status::OK();
 }
 
+Status SignalTableReader::extract_samples_calibrated(
+    gsl::span<std::uint64_t const> const & row_indices,
+    SignalCalibration const & calibration,
+    gsl::span<float> const & output_samples,
+    SignalCompressionContext & compression_context) const
+{
+    return extract_calibrated_samples(
+        row_indices, calibration, output_samples, compression_context);
+}
+
+Status SignalTableReader::extract_samples_calibrated(
+    gsl::span<std::uint64_t const> const & row_indices,
+    SignalCalibration const & calibration,
+    gsl::span<Float16> const & output_samples,
+    SignalCompressionContext & compression_context) const
+{
+    return extract_calibrated_samples(
+        row_indices, calibration, output_samples, compression_context);
+}
+
+Status SignalTableReader::extract_samples_calibrated(
+    gsl::span<std::uint64_t const> const & row_indices,
+    SignalCalibration const & calibration,
+    gsl::span<std::int8_t> const & output_samples,
+    SignalCompressionContext & compression_context) const
+{
+    return extract_calibrated_samples(
+        row_indices, calibration, output_samples, compression_context);
+}
+
+struct SignalTableReader::DecodedRead {
+    std::vector<std::uint64_t> row_indices;
+    std::shared_ptr<arrow::Buffer> samples;
+};
+
+void SignalTableReader::set_max_cached_decoded_read_bytes(
+    std::size_t max_cached_decoded_read_bytes)
+{
+    m_decoded_reads.reset();
+    if (max_cached_decoded_read_bytes != 0) {
+        m_decoded_reads = std::make_unique<ShardedLruCache<std::shared_ptr<DecodedRead const>>>(
+            0, max_cached_decoded_read_bytes, "signal table decoded read cache");
+    }
+}
+
+Result<std::shared_ptr<arrow::Buffer>> SignalTableReader::extract_sample_buffer(
+    gsl::span<std::uint64_t const> const & row_indices) const
+{
+    return extract_sample_buffer(row_indices, thread_local_signal_compression_context());
+}
+
+Result<std::shared_ptr<arrow::Buffer>> SignalTableReader::extract_sample_buffer(
+    gsl::span<std::uint64_t const> const & row_indices,
+    SignalCompressionContext & compression_context) const
+{
+    if (!m_decoded_reads || row_indices.empty()) {
+        return decode_sample_buffer(row_indices, compression_context);
+    }
+
+    using CachedDecodedRead = ShardedLruCache<std::shared_ptr<DecodedRead const>>::LoadedValue;
+    ARROW_ASSIGN_OR_RAISE(
+        auto const decoded_read,
+        m_decoded_reads->get(row_indices.front(), [&]() -> Result<CachedDecodedRead> {
+            ARROW_ASSIGN_OR_RAISE(
+                auto samples, decode_sample_buffer(row_indices, compression_context));
+            auto read = std::make_shared<DecodedRead>(
+                DecodedRead{{row_indices.begin(), row_indices.end()}, std::move(samples)});
+            auto const byte_size = read->samples->size()
+                                   + read->row_indices.size() * sizeof(std::uint64_t);
+            return CachedDecodedRead{std::move(read), static_cast<std::size_t>(byte_size)};
+        }));
+
+    // Rows belong to a single read, so only a different selection of the same read's rows
+    // shares a first row with the cached read. Those are decoded without caching them:
+    if (!std::equal(
+            row_indices.begin(),
+            row_indices.end(),
+            decoded_read->row_indices.begin(),
+            decoded_read->row_indices.end()))
+    {
+        return decode_sample_buffer(row_indices, compression_context);
+    }
+    return decoded_read->samples;
+}
+
+Result<std::shared_ptr<arrow::Buffer>> SignalTableReader::decode_sample_buffer(
+    gsl::span<std::uint64_t const> const & row_indices,
+    SignalCompressionContext & compression_context) const
+{
+    ARROW_ASSIGN_OR_RAISE(auto const sample_count, extract_sample_count(row_indices));
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::Buffer> samples,
+        arrow::AllocateBuffer(sample_count * sizeof(std::int16_t), m_pool));
+    ARROW_RETURN_NOT_OK(decode_samples(
+        row_indices,
+        gsl::make_span(samples->mutable_data(), samples->size()).as_span<std::int16_t>(),
+        compression_context));
+    return samples;
+}
+
 Result<std::vector<std::shared_ptr<arrow::Buffer>>> SignalTableReader::extract_samples_inplace(
     gsl::span<std::uint64_t const> const & row_indices,
     std::vector<std::uint32_t> & sample_count) const
@@ -313,30 +1338,118 @@ Result<std::vector<std::shared_ptr<arrow::Buffer>>> SignalTableReader::extract_s
     return sample_buffers;
 }
 
+Result<std::vector<std::shared_ptr<arrow::Buffer>>>
+SignalTableReader::extract_uncompressed_sample_buffers(
+    gsl::span<std::uint64_t const> const & row_indices) const
+{
+    if (m_field_locations.signal_type != SignalType::UncompressedSignal) {
+        return pod5::Status::Invalid("Signal is compressed, and can't be read in place");
+    }
+
+    std::vector<std::shared_ptr<arrow::Buffer>> sample_buffers;
+    sample_buffers.reserve(row_indices.size());
+    for (auto const & signal_row : row_indices) {
+        std::size_t batch_row = 0;
+        ARROW_ASSIGN_OR_RAISE(
+            auto const signal_batch_index, signal_batch_for_row_id(signal_row, &batch_row));
+
+        ARROW_ASSIGN_OR_RAISE(auto const & signal_batch, read_record_batch(signal_batch_index));
+        ARROW_ASSIGN_OR_RAISE(auto samples, signal_batch.uncompressed_signal_row(batch_row));
+        sample_buffers.emplace_back(std::move(samples));
+    }
+    return sample_buffers;
+}
+
 SignalType SignalTableReader::signal_type() const { return m_field_locations.signal_type; }
 
+void SignalTableReader::set_vbz_signal_decoder(
+    std::shared_ptr<SignalCodec const> vbz_signal_decoder)
+{
+    if (vbz_signal_decoder
+        && (m_field_locations.signal_type == SignalType::VbzSignal
+            || m_field_locations.signal_type == SignalType::VbzDictionarySignal))
+    {
+        m_field_locations.codec = std::move(vbz_signal_decoder);
+    }
+}
+
+Result<std::size_t> SignalTableReader::batch_alignment() const
+{
+    return read_signal_batch_alignment_metadata(schema()->metadata());
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 Result<SignalTableReader> make_signal_table_reader(
     std::shared_ptr<arrow::io::RandomAccessFile> const & input,
     std::size_t max_cached_table_batches,
-    arrow::MemoryPool * pool)
+    std::size_t max_cached_table_batch_bytes,
+    arrow::MemoryPool * pool,
+    std::vector<RecordBatchLocation> batch_locations)
 {
-    arrow::ipc::IpcReadOptions options;
-    options.memory_pool = pool;
+    // Locations listed by the file's footer are only trusted if they fit the input, the rows
+    // each batch holds are checked as it is decoded:
+    ARROW_ASSIGN_OR_RAISE(auto const input_size, input->GetSize());
+    auto const first_message_offset = ipc_file_blocks::IPC_FILE_LEADING_MAGIC_SIZE;
+    bool const listed_locations_valid =
+        !batch_locations.empty()
+        && std::all_of(
+            batch_locations.begin(), batch_locations.end(), [&](RecordBatchLocation const & l) {
+                return l.offset > first_message_offset && l.metadata_length > 0
+                       && l.body_length >= 0 && l.row_count > 0
+                       && l.offset + l.length() <= input_size;
+            });
 
-    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(input, options));
+    // Listed batches are read without the table's own footer, so only its schema is read, from
+    // the message following the file's leading magic:
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader;
+    std::shared_ptr<arrow::Schema> schema;
+    std::size_t num_record_batches = 0;
+    if (listed_locations_valid) {
+        ARROW_ASSIGN_OR_RAISE(
+            auto const schema_stream,
+            arrow::io::RandomAccessFile::GetStream(
+                input, first_message_offset, input_size - first_message_offset));
+        arrow::ipc::DictionaryMemo dictionary_memo;
+        ARROW_ASSIGN_OR_RAISE(
+            schema, arrow::ipc::ReadSchema(schema_stream.get(), &dictionary_memo));
+        num_record_batches = batch_locations.size();
+    } else {
+        arrow::ipc::IpcReadOptions options;
+        options.memory_pool = pool;
+        ARROW_ASSIGN_OR_RAISE(reader, arrow::ipc::RecordBatchFileReader::Open(input, options));
+        schema = reader->schema();
+        num_record_batches = reader->num_record_batches();
+    }
 
-    auto read_metadata_key_values = reader->schema()->metadata();
+    auto read_metadata_key_values = schema->metadata();
     if (!read_metadata_key_values) {
         return Status::IOError("Missing metadata on signal table schema");
     }
     ARROW_ASSIGN_OR_RAISE(
         auto read_metadata, read_schema_key_value_metadata(read_metadata_key_values));
-    ARROW_ASSIGN_OR_RAISE(auto field_locations, read_signal_table_schema(reader->schema()));
+    ARROW_ASSIGN_OR_RAISE(auto field_locations, read_signal_table_schema(schema));
 
-    std::size_t const num_record_batches = reader->num_record_batches();
+    std::shared_ptr<SignalCompressionDictionary const> dictionary;
+    if (field_locations.signal_type == SignalType::VbzDictionarySignal) {
+        ARROW_ASSIGN_OR_RAISE(
+            dictionary, read_signal_dictionary_metadata(read_metadata_key_values));
+    }
+
+    // Batch locations only speed up reads, so files whose batches can't be located are still
+    // readable:
+    if (!listed_locations_valid) {
+        batch_locations.clear();
+        auto batch_locations_result = ipc_file_blocks::read_record_batch_locations(input);
+        if (batch_locations_result.ok() && batch_locations_result->size() == num_record_batches) {
+            batch_locations = std::move(*batch_locations_result);
+        }
+    }
+
+    // The listed row counts save decoding the first batch to find the table's batch size:
     std::size_t batch_size = 0;
-    if (num_record_batches > 0) {
+    if (listed_locations_valid) {
+        batch_size = batch_locations.front().row_count;
+    } else if (num_record_batches > 0) {
         ARROW_ASSIGN_OR_RAISE(auto const batch_zero, reader->ReadRecordBatch(0));
         batch_size = batch_zero->num_rows();
     }
@@ -344,12 +1457,25 @@ Result<SignalTableReader> make_signal_table_reader(
     return SignalTableReader(
         {input},
         std::move(reader),
+        std::move(schema),
         field_locations,
         std::move(read_metadata),
         num_record_batches,
         batch_size,
         max_cached_table_batches,
-        pool);
+        max_cached_table_batch_bytes,
+        pool,
+        std::move(dictionary),
+        input,
+        std::move(batch_locations));
+}
+
+Result<SignalTableReader> make_signal_table_reader(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & input,
+    std::size_t max_cached_table_batches,
+    arrow::MemoryPool * pool)
+{
+    return make_signal_table_reader(input, max_cached_table_batches, 0, pool);
 }
 
 }  // namespace pod5
@@ -7,12 +7,15 @@
 #include "pod5_format/table_reader.h"
 #include "pod5_format/types.h"
 
-#include <arrow/io/type_fwd.h>
+#include <arrow/io/caching.h>
+#include <arrow/io/interfaces.h>
 #include <gsl/gsl-lite.hpp>
 
 #include <atomic>
-#include <mutex>
-#include <unordered_map>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
 
 namespace arrow {
 class Schema;
@@ -22,103 +25,558 @@ class RandomAccessFile;
 }
 
 namespace ipc {
+class Message;
 class RecordBatchFileReader;
 }
 }  // namespace arrow
 
 namespace pod5 {
 
-struct SignalTableReaderCacheCleaner;
+class SignalCompressionContext;
+class SignalCompressionDictionary;
+class SignalRowIndex;
+struct SignalCalibration;
+class ThreadPool;
+template <typename Value>
+class ShardedLruCache;
+
+/// \brief Signal decompressed by the batches of a signal table, counted from many threads.
+struct SignalDecompressionCounters {
+    /// Bytes of int16 samples decompressed.
+    std::atomic<std::uint64_t> decompressed_bytes{0};
+    /// Time spent decompressing, summed across threads.
+    std::atomic<std::uint64_t> decompression_nanoseconds{0};
+};
+
+/// \brief Counts of a signal table's batch loads and decompression since it was opened.
+struct SignalTableStatistics {
+    std::uint64_t batches_decoded = 0;
+    /// Batch cache lookups finding the batch cached (or being loaded by another thread), and
+    /// lookups which loaded it.
+    std::uint64_t cache_hits = 0;
+    std::uint64_t cache_misses = 0;
+    std::uint64_t cache_evictions = 0;
+    /// The same counts for the decoded read cache, see
+    /// SignalTableReader::set_max_cached_decoded_read_bytes().
+    std::uint64_t decoded_read_cache_hits = 0;
+    std::uint64_t decoded_read_cache_misses = 0;
+    std::uint64_t decoded_read_cache_evictions = 0;
+    std::uint64_t decompressed_bytes = 0;
+    std::chrono::nanoseconds decompression_time{0};
+};
 
 class POD5_FORMAT_EXPORT SignalTableRecordBatch : public TableRecordBatch {
 public:
+    /// \param decompression_counters Counters to add the batch's decompression to, if any.
     SignalTableRecordBatch(
         std::shared_ptr<arrow::RecordBatch> const & batch,
         SignalTableSchemaDescription field_locations,
-        arrow::MemoryPool * pool);
+        arrow::MemoryPool * pool,
+        std::shared_ptr<SignalCompressionDictionary const> dictionary = nullptr,
+        std::shared_ptr<SignalDecompressionCounters> decompression_counters = nullptr);
 
     std::shared_ptr<UuidArray> read_id_column() const;
     std::shared_ptr<arrow::LargeListArray> uncompressed_signal_column() const;
     std::shared_ptr<VbzSignalArray> vbz_signal_column() const;
     std::shared_ptr<arrow::UInt32Array> samples_column() const;
+    /// \brief Find the CRC32C checksum of each row's signal as stored, or null if the table has
+    ///        no checksums.
+    std::shared_ptr<arrow::UInt32Array> checksum_column() const;
 
     Result<std::size_t> samples_byte_count(std::size_t row_index) const;
 
+    /// \brief Check a row's signal as stored against its checksum, whatever the checksum interval
+    ///        rows are checked at as they are decoded.
+    /// \returns IOError if the row doesn't match its checksum, Invalid if the table has no
+    ///          checksums.
+    Status verify_signal_checksum(std::size_t row_index) const;
+
     /// \brief Extract a row of sample data into [samples], decompressing if required.
+    /// \note Decompression uses a context owned by the calling thread.
     Status extract_signal_row(std::size_t row_index, gsl::span<std::int16_t> samples) const;
+    /// \brief Extract a row of sample data into [samples], decompressing using
+    ///        [compression_context].
+    Status extract_signal_row(
+        std::size_t row_index,
+        gsl::span<std::int16_t> samples,
+        SignalCompressionContext & compression_context) const;
+    /// \brief Extract many rows of sample data, each into the matching entry of [samples],
+    ///        decompressing them together through the table's codec.
+    Status extract_signal_rows(
+        gsl::span<std::size_t const> const & row_indices,
+        gsl::span<gsl::span<std::int16_t> const> const & samples,
+        SignalCompressionContext & compression_context) const;
+    /// \brief Find the offset of each row's samples once every row of the batch is extracted one
+    ///        after another, with a final entry for the batch's sample count.
+    std::vector<std::uint64_t> signal_row_offsets() const;
+    /// \brief Extract every row of the batch into [samples], one after another at the offsets
+    ///        found by signal_row_offsets(), decompressing them in one call to the table's codec.
+    /// \note Lets callers stage a whole batch's samples to a device in one copy, from [samples]
+    ///       in memory they allocate (for example, pinned host memory).
+    Status extract_all_signal_rows(
+        gsl::span<std::int16_t> const & samples,
+        SignalCompressionContext & compression_context) const;
+    /// \brief Extract a row of sample data into [samples] calibrated to picoamps, decompressing
+    ///        and calibrating in a single pass.
+    Status extract_signal_row_calibrated(
+        std::size_t row_index,
+        SignalCalibration const & calibration,
+        gsl::span<float> samples,
+        SignalCompressionContext & compression_context) const;
+    /// \brief Extract a row of sample data into [samples] as half precision picoamps, see
+    ///        calibrate_signal().
+    Status extract_signal_row_calibrated(
+        std::size_t row_index,
+        SignalCalibration const & calibration,
+        gsl::span<Float16> samples,
+        SignalCompressionContext & compression_context) const;
+    /// \brief Extract a row of sample data into [samples] as clamped 8 bit levels, see
+    ///        calibrate_signal().
+    Status extract_signal_row_calibrated(
+        std::size_t row_index,
+        SignalCalibration const & calibration,
+        gsl::span<std::int8_t> samples,
+        SignalCompressionContext & compression_context) const;
     Result<std::shared_ptr<arrow::Buffer>> extract_signal_row_inplace(std::size_t row_index) const;
+    /// \brief Find the int16 samples of an uncompressed signal row, as a slice of the batch's
+    ///        own buffers.
+    /// \note No samples are copied, for mapped files the buffer points into the mapping. The
+    ///       buffer keeps the batch data alive, so it remains valid after the batch is released.
+    /// \returns Invalid if the batch signal is compressed.
+    Result<std::shared_ptr<arrow::Buffer>> uncompressed_signal_row(std::size_t row_index) const;
+
+    /// \brief Find the bytes of a row's signal as stored, compressed for compressed signal.
+    /// \note The span points into the batch, so is valid only while the batch is held.
+    gsl::span<std::uint8_t const> stored_signal_row(std::size_t row_index) const;
 
 private:
+    /// Find the sample count of [row], from the row index if it covers the row.
+    Result<std::uint64_t> row_sample_count(std::uint64_t row) const;
+
+    /// Check a row about to be decoded against its checksum, if the checksum interval covers it.
+    Status check_signal_row(std::size_t row_index) const;
+
+    template <typename OutputType>
+    Status extract_calibrated_row(
+        std::size_t row_index,
+        SignalCalibration const & calibration,
+        gsl::span<OutputType> samples,
+        SignalCompressionContext & compression_context) const;
+
     SignalTableSchemaDescription m_field_locations;
     arrow::MemoryPool * m_pool;
+    std::shared_ptr<SignalCompressionDictionary const> m_dictionary;
+    std::shared_ptr<SignalDecompressionCounters> m_decompression_counters;
 };
 
 class POD5_FORMAT_EXPORT SignalTableReader : public TableReader {
 public:
+    /// \param reader Null if every batch is read from [batch_locations], without the table's
+    ///               own footer.
+    /// \param schema The table's schema.
     SignalTableReader(
         std::shared_ptr<void> && input_source,
         std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
+        std::shared_ptr<arrow::Schema> schema,
         SignalTableSchemaDescription field_locations,
         SchemaMetadataDescription && schema_metadata,
         std::size_t num_record_batches,
         std::size_t batch_size,
         std::size_t max_cached_table_batches,
-        arrow::MemoryPool * pool);
+        std::size_t max_cached_table_batch_bytes,
+        arrow::MemoryPool * pool,
+        std::shared_ptr<SignalCompressionDictionary const> dictionary = nullptr,
+        std::shared_ptr<arrow::io::RandomAccessFile> input_file = nullptr,
+        std::vector<RecordBatchLocation> batch_locations = {});
 
     SignalTableReader(SignalTableReader &&);
     SignalTableReader & operator=(SignalTableReader &&);
+    ~SignalTableReader();
 
+    /// \brief Read a signal batch, using the cached batch if it has already been loaded.
+    /// \note Safe to call from many threads at once, lookups of cached batches do not wait on
+    ///       other threads loading batches.
     Result<SignalTableRecordBatch> read_record_batch(std::size_t i) const;
 
+    /// \brief Read signal batch [i] as the record batch message stored in the file, without
+    ///        decoding it, so it can be written to another signal table as it is (see
+    ///        SignalTableWriter::write_raw_batch()).
+    /// \note Invalid if batch locations are unknown. The batch isn't cached.
+    Result<std::unique_ptr<arrow::ipc::Message>> read_record_batch_message(std::size_t i) const;
+
+    /// \brief Find the batch holding [row], and the row's index within it in [batch_row].
+    /// \note Batches may hold different row counts when the file lists them in its footer,
+    ///       otherwise every batch but the last holds table_batch_size() rows.
     Result<std::size_t> signal_batch_for_row_id(std::uint64_t row, std::size_t * batch_row) const;
 
+    /// \brief Find the first row of [batch], or the table's row count for the batch following
+    ///        the last.
+    /// \returns Invalid for the batch following the last if the table's row count is unknown,
+    ///          as the file doesn't list its batches.
+    Result<std::uint64_t> batch_first_row(std::size_t batch) const;
+
+    /// \brief Find the number of rows in the table's first batch, which every batch but the last
+    ///        holds unless the file lists batches of different sizes.
+    std::size_t table_batch_size() const { return m_batch_size; }
+
+    /// \brief Find the alignment of the table's batches in the file, 0 if they aren't aligned.
+    /// \see FileWriterOptions::set_page_align_signal_batches()
+    Result<std::size_t> batch_alignment() const;
+
+    /// \brief Hint that signal batches will be read soon, so the file can read them ahead of
+    ///        use (madvise for mapped files, posix_fadvise otherwise).
+    /// \note Batches already cached are skipped. Does nothing if batch locations are unknown.
+    Status prefetch_record_batches(gsl::span<std::size_t const> const & batches) const;
+
+    /// \brief Load signal batches into the cache, issuing the reads for all of them at once.
+    ///
+    /// Files opened for asynchronous reads (see FileReaderOptions::set_use_io_uring) then have
+    /// many reads in flight, instead of one per read_record_batch() call.
+    /// \note Batches already cached are skipped, and only as many batches (and bytes) as the
+    ///       cache holds are loaded. Falls back to read_record_batch() if batch locations are
+    ///       unknown.
+    Status load_record_batches(gsl::span<std::size_t const> const & batches) const;
+
+    /// \brief Set the order signal batches will be read in, so the batch cache keeps the batches
+    ///        needed soonest and drops a batch once its last planned read has passed, rather than
+    ///        evicting the least recently used batches.
+    /// \param batches The batches in the order they will be read, for example from a traversal
+    ///                plan, see FileReader::set_signal_access_plan().
+    /// \note Batches loaded ahead by load_record_batches(), or read for the sample counts of
+    ///       rows (see extract_sample_count()), don't move the plan forward.
+    void set_batch_access_plan(std::vector<std::size_t> const & batches);
+
+    /// \brief Drop the plan set by set_batch_access_plan(), evicting the least recently used
+    ///        batches again.
+    void clear_batch_access_plan();
+
+    /// \brief Set if load_record_batches() and prefetch_record_batches() should merge the byte
+    ///        ranges of batches within [read_coalescing]'s hole size limit into fewer, larger
+    ///        reads, or issue one read per batch if [read_coalescing] is empty.
+    void set_read_coalescing(std::optional<arrow::io::CacheOptions> read_coalescing)
+    {
+        m_read_coalescing = read_coalescing;
+    }
+
+    /// \brief Set the sample counts of the table's rows, so rows' sample counts and offsets are
+    ///        found without loading the batches holding them. Rows [row_index] doesn't cover are
+    ///        still counted from their batches.
+    void set_row_index(std::shared_ptr<SignalRowIndex const> row_index)
+    {
+        m_row_index = std::move(row_index);
+    }
+
+    /// \brief Set the codec decoding the table's signal in place of the built in vbz codec, if the
+    ///        table is vbz compressed, see FileReaderOptions::set_vbz_signal_decoder.
+    /// \note Batches already read keep decoding with the built in codec.
+    void set_vbz_signal_decoder(std::shared_ptr<SignalCodec const> vbz_signal_decoder);
+
+    /// \brief Set how many bytes of decoded samples to keep cached per read, above the cache of
+    ///        signal batches, so repeated extract_samples() and extract_sample_buffer() calls for
+    ///        the same read skip decoding its rows again. 0 disables the cache.
+    /// \note Reads are identified by their first row, which only the read owns. Discards any
+    ///       reads already cached, so must not be called while other threads use the reader.
+    void set_max_cached_decoded_read_bytes(std::size_t max_cached_decoded_read_bytes);
+
+    /// \brief Set how often rows are checked against their checksums as they are decoded, if
+    ///        the table holds checksums, see FileReaderOptions::set_signal_checksum_interval.
+    /// \note Batches already read keep checking at the previous interval.
+    void set_signal_checksum_interval(std::size_t checksum_interval)
+    {
+        m_field_locations.checksum_interval = checksum_interval;
+    }
+
+    /// \brief Find if the table holds the CRC32C checksum of each row's signal.
+    bool has_signal_checksums() const { return m_field_locations.checksum >= 0; }
+
+    /// \brief Find the sample counts of the table's rows, or null if they aren't known.
+    std::shared_ptr<SignalRowIndex const> const & row_index() const { return m_row_index; }
+
     /// \brief Find the number of samples in a given list of rows.
     /// \param row_indices      The rows to query for sample ount.
     /// \returns The sum of all sample counts on input rows.
     Result<std::size_t> extract_sample_count(
         gsl::span<std::uint64_t const> const & row_indices) const;
 
+    /// \brief Find where each of a read's signal rows starts within its signal.
+    /// \param row_indices      The read's signal rows, in order.
+    /// \returns The sample offset of each row's chunk, followed by the read's sample count.
+    Result<std::vector<std::uint64_t>> extract_chunk_boundaries(
+        gsl::span<std::uint64_t const> const & row_indices) const;
+
     /// \brief Extract the samples for a list of rows.
     /// \param row_indices      The rows to query for samples.
     /// \param output_samples   The output samples from the rows. Data in the vector is cleared before appending.
+    /// \note Copied from the decoded read cache if it is enabled, see
+    ///       set_max_cached_decoded_read_bytes().
     Status extract_samples(
         gsl::span<std::uint64_t const> const & row_indices,
         gsl::span<std::int16_t> const & output_samples) const;
 
+    /// \brief Extract the samples for a list of rows, decompressing using [compression_context].
+    Status extract_samples(
+        gsl::span<std::uint64_t const> const & row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        SignalCompressionContext & compression_context) const;
+
+    /// \brief Extract the samples for a list of rows, decompressing rows concurrently on
+    ///        [thread_pool] and the calling thread.
+    /// \note Each row is decompressed straight to its offset in [output_samples], so this pays
+    ///       off for reads with many signal rows.
+    Status extract_samples(
+        gsl::span<std::uint64_t const> const & row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        ThreadPool & thread_pool) const;
+
+    /// \brief Extract the samples for several reads into one buffer, decompressing the rows of all
+    ///        reads concurrently on [thread_pool] and the calling thread.
+    /// \param reads_row_indices    The signal rows of each read.
+    /// \param output_samples       The output samples, each read's samples following the last's.
+    /// \param sample_offsets       Output for the offset of each read's samples in
+    ///                             [output_samples], followed by the total sample count.
+    ///                             Must be one longer than [reads_row_indices].
+    Status extract_samples_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const;
+
+    /// \brief Extract the samples for several reads into one buffer calibrated to picoamps,
+    ///        decompressing the rows of all reads concurrently on [thread_pool] and the calling
+    ///        thread.
+    /// \param calibrations         The calibration of each read in [reads_row_indices].
+    /// \see extract_samples_for_reads()
+    Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<float> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const;
+
+    /// \brief Extract the samples for several reads into one buffer as half precision picoamps.
+    /// \see extract_samples_calibrated_for_reads()
+    Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<Float16> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const;
+
+    /// \brief Extract the samples for several reads into one buffer as clamped 8 bit levels, see
+    ///        calibrate_signal().
+    /// \see extract_samples_calibrated_for_reads()
+    Status extract_samples_calibrated_for_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<std::int8_t> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const;
+
+    /// \brief Find the offset of each row's samples within the signal for a list of rows.
+    /// \param row_indices      The rows to query for sample offsets.
+    /// \returns The sample offset of each row, followed by the total sample count. This can be
+    ///          computed once per read and reused when extracting many sample ranges.
+    Result<std::vector<std::uint64_t>> extract_sample_offsets(
+        gsl::span<std::uint64_t const> const & row_indices) const;
+
+    /// \brief Extract a range of samples from the signal for a list of rows, decoding only the
+    ///        rows which overlap the range.
+    /// \param row_indices      The rows holding the signal.
+    /// \param sample_start     The first sample to extract.
+    /// \param output_samples   The output samples, sized to the number of samples to extract.
+    Status extract_samples_range(
+        gsl::span<std::uint64_t const> const & row_indices,
+        std::uint64_t sample_start,
+        gsl::span<std::int16_t> const & output_samples) const;
+
+    /// \brief Extract a range of samples from the signal for a list of rows.
+    /// \param sample_offsets   The sample offsets for [row_indices], from extract_sample_offsets().
+    Status extract_samples_range(
+        gsl::span<std::uint64_t const> const & row_indices,
+        gsl::span<std::uint64_t const> const & sample_offsets,
+        std::uint64_t sample_start,
+        gsl::span<std::int16_t> const & output_samples,
+        SignalCompressionContext & compression_context) const;
+
+    /// \brief Extract the samples for a list of rows, calibrated to picoamps using [calibration].
+    /// \param row_indices      The rows to query for samples.
+    /// \param output_samples   The output samples from the rows.
+    Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<float> const & output_samples) const;
+
+    /// \brief Extract the samples for a list of rows calibrated to picoamps, decompressing using
+    ///        [compression_context].
+    Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<float> const & output_samples,
+        SignalCompressionContext & compression_context) const;
+
+    /// \brief Extract the samples for a list of rows as half precision picoamps, see
+    ///        calibrate_signal().
+    Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<Float16> const & output_samples,
+        SignalCompressionContext & compression_context) const;
+
+    /// \brief Extract the samples for a list of rows as clamped 8 bit levels, see
+    ///        calibrate_signal().
+    Status extract_samples_calibrated(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<std::int8_t> const & output_samples,
+        SignalCompressionContext & compression_context) const;
+
+    /// \brief Find the samples for a list of rows as one buffer of int16 samples. The buffer is
+    ///        shared with the decoded read cache if it is enabled, a cached read is returned
+    ///        without copying it.
+    /// \param row_indices      The rows to query for samples.
+    Result<std::shared_ptr<arrow::Buffer>> extract_sample_buffer(
+        gsl::span<std::uint64_t const> const & row_indices) const;
+
+    /// \brief Find the samples for a list of rows as one buffer, decompressing using
+    ///        [compression_context] if the rows aren't cached.
+    Result<std::shared_ptr<arrow::Buffer>> extract_sample_buffer(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCompressionContext & compression_context) const;
+
     /// \brief Extract the samples as written in the arrow table for a list of rows.
     /// \param row_indices      The rows to query for samples.
     Result<std::vector<std::shared_ptr<arrow::Buffer>>> extract_samples_inplace(
         gsl::span<std::uint64_t const> const & row_indices,
         std::vector<std::uint32_t> & sample_count) const;
 
+    /// \brief Find the int16 samples for a list of uncompressed rows, without copying them.
+    /// \param row_indices      The rows to query for samples.
+    /// \returns One buffer per row, see SignalTableRecordBatch::uncompressed_signal_row().
+    ///          Invalid if the table's signal is compressed.
+    Result<std::vector<std::shared_ptr<arrow::Buffer>>> extract_uncompressed_sample_buffers(
+        gsl::span<std::uint64_t const> const & row_indices) const;
+
     /// \brief Find the signal type of this writer
     SignalType signal_type() const;
 
+    /// \brief Find the dictionary signal is compressed against, if the signal type uses one.
+    std::shared_ptr<SignalCompressionDictionary const> const & dictionary() const
+    {
+        return m_dictionary;
+    }
+
+    /// \brief Find the codec decoding the table's signal, null if the signal is uncompressed.
+    std::shared_ptr<SignalCodec const> const & codec() const { return m_field_locations.codec; }
+
+    /// \brief Find the number of signal batches currently held in the cache.
+    std::size_t cached_batch_count() const;
+    /// \brief Find the total size in bytes of the signal batches currently held in the cache.
+    std::size_t cached_batch_bytes() const;
+
+    /// \brief Find the total size in bytes of the decoded reads currently held in the cache.
+    std::size_t cached_decoded_read_bytes() const;
+
+    /// \brief Drop every signal batch and decoded read held in the caches.
+    void clear_cache();
+
+    /// \brief Find the table's batch load, cache and decompression counts.
+    SignalTableStatistics statistics() const;
+
 private:
-    SignalTableSchemaDescription m_field_locations;
-    arrow::MemoryPool * m_pool;
-    std::size_t m_max_cached_table_batches;
+    struct DecodedRead;
 
-    mutable std::size_t m_last_read_record_batch_index = -1;
-    mutable std::shared_ptr<arrow::RecordBatch> m_last_read_record_batch;
+    /// Read batch [i] through the batch cache, as the batch's next planned read if
+    /// [planned_read], see set_batch_access_plan().
+    Result<SignalTableRecordBatch> read_cached_batch(std::size_t i, bool planned_read) const;
 
-    mutable std::mutex m_batch_get_mutex;
-    using AccessIndex = std::uint64_t;
+    /// Decode the samples of [row_indices] into [output_samples], bypassing the decoded read
+    /// cache.
+    Status decode_samples(
+        gsl::span<std::uint64_t const> const & row_indices,
+        gsl::span<std::int16_t> const & output_samples,
+        SignalCompressionContext & compression_context) const;
+
+    /// Decode the samples of [row_indices] into a new buffer.
+    Result<std::shared_ptr<arrow::Buffer>> decode_sample_buffer(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCompressionContext & compression_context) const;
 
-    struct CachedItem {
-        pod5::SignalTableRecordBatch item;
-        AccessIndex last_access_index;
+    /// One signal row of a read extracted into a buffer shared by several reads.
+    struct ReadRowLocation {
+        std::size_t read;
+        std::size_t signal_batch_index;
+        std::size_t batch_row;
+        std::uint64_t sample_start;
+        std::uint64_t sample_count;
     };
 
-    mutable std::unordered_map<std::size_t, CachedItem> m_table_batches;
+    /// Locate every signal row of [reads_row_indices], filling [sample_offsets] with where each
+    /// read's samples start in an output buffer of [output_sample_count] samples.
+    Result<std::vector<ReadRowLocation>> locate_reads_rows(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        std::size_t output_sample_count) const;
+
+    template <typename OutputType>
+    Status extract_calibrated_reads(
+        gsl::span<gsl::span<std::uint64_t const> const> const & reads_row_indices,
+        gsl::span<SignalCalibration const> const & calibrations,
+        gsl::span<OutputType> const & output_samples,
+        gsl::span<std::uint64_t> const & sample_offsets,
+        ThreadPool & thread_pool) const;
+
+    template <typename OutputType>
+    Status extract_calibrated_samples(
+        gsl::span<std::uint64_t const> const & row_indices,
+        SignalCalibration const & calibration,
+        gsl::span<OutputType> const & output_samples,
+        SignalCompressionContext & compression_context) const;
 
-    mutable AccessIndex m_last_access_index = 0;
+    SignalTableSchemaDescription m_field_locations;
+    arrow::MemoryPool * m_pool;
+    std::shared_ptr<SignalCompressionDictionary const> m_dictionary;
+    std::shared_ptr<SignalDecompressionCounters> m_decompression_counters;
+
+    std::unique_ptr<ShardedLruCache<SignalTableRecordBatch>> m_table_batches;
+    // Decoded samples of recently extracted reads, keyed by their first row. Null if disabled.
+    std::unique_ptr<ShardedLruCache<std::shared_ptr<DecodedRead const>>> m_decoded_reads;
 
     std::size_t m_batch_size;
 
-    friend struct SignalTableReaderCacheCleaner;
+    bool has_batch_locations() const;
+
+    /// Decode signal batch [i] from its record batch [message], without the ipc reader, checking
+    /// it holds the rows its location lists.
+    Result<SignalTableRecordBatch> decode_batch_message(
+        std::size_t i,
+        arrow::ipc::Message const & message) const;
+
+    std::shared_ptr<arrow::io::RandomAccessFile> m_input_file;
+    // Location of each record batch in [m_input_file], empty if they couldn't be found.
+    std::vector<RecordBatchLocation> m_batch_locations;
+    // The first row of each batch followed by the table's row count, when the file lists the
+    // rows of each batch. Empty otherwise, with every batch but the last holding [m_batch_size].
+    std::vector<std::uint64_t> m_batch_first_rows;
+    std::optional<arrow::io::CacheOptions> m_read_coalescing;
+    std::shared_ptr<SignalRowIndex const> m_row_index;
 };
 
+/// \brief Open a signal table for reading.
+/// \param max_cached_table_batches        The most signal batches to keep cached, 0 for no limit.
+/// \param max_cached_table_batch_bytes    The most bytes of signal batches to keep cached, 0 for
+///                                        no limit.
+/// \param batch_locations                 The table's batches, as listed by the file's footer,
+///                                        saving reading them from the table's own footer.
+///                                        Ignored unless they fit the table.
+POD5_FORMAT_EXPORT Result<SignalTableReader> make_signal_table_reader(
+    std::shared_ptr<arrow::io::RandomAccessFile> const & sink,
+    std::size_t max_cached_table_batches,
+    std::size_t max_cached_table_batch_bytes,
+    arrow::MemoryPool * pool,
+    std::vector<RecordBatchLocation> batch_locations = {});
+
+/// \brief Open a signal table for reading, with no limit on the bytes of batches cached.
+/// \param max_cached_table_batches        The most signal batches to keep cached, 0 for no limit.
 POD5_FORMAT_EXPORT Result<SignalTableReader> make_signal_table_reader(
     std::shared_ptr<arrow::io::RandomAccessFile> const & sink,
     std::size_t max_cached_table_batches,
@@ -1,22 +1,41 @@
 #include "pod5_format/signal_table_schema.h"
 
 #include "pod5_format/schema_utils.h"
+#include "pod5_format/signal_codec.h"
+#include "pod5_format/signal_compression.h"
 #include "pod5_format/types.h"
 
+#include <arrow/buffer.h>
 #include <arrow/type.h>
+#include <arrow/util/base64.h>
+#include <arrow/util/key_value_metadata.h>
+
+#include <charconv>
+#include <string>
 
 namespace pod5 {
 
+namespace {
+char const SIGNAL_DICTIONARY_METADATA_KEY[] = "MINKNOW:signal_dictionary";
+char const SIGNAL_CODEC_METADATA_KEY[] = "MINKNOW:signal_codec";
+char const SIGNAL_BATCH_ALIGNMENT_METADATA_KEY[] = "MINKNOW:signal_batch_alignment";
+}
+
 std::shared_ptr<arrow::Schema> make_signal_table_schema(
     SignalType signal_type,
     std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
-    SignalTableSchemaDescription * field_locations)
+    SignalTableSchemaDescription * field_locations,
+    bool with_checksums)
 {
     auto const uuid_type = uuid();
 
     if (field_locations) {
         *field_locations = {};
         field_locations->signal_type = signal_type;
+        if (signal_type == SignalType::VbzSignal || signal_type == SignalType::VbzDictionarySignal)
+        {
+            field_locations->codec = vbz_signal_codec();
+        }
     }
 
     std::shared_ptr<arrow::DataType> signal_schema_type;
@@ -27,15 +46,26 @@ std::shared_ptr<arrow::Schema> make_signal_table_schema(
     case SignalType::VbzSignal:
         signal_schema_type = vbz_signal();
         break;
+    case SignalType::VbzDictionarySignal:
+        signal_schema_type = vbz_dictionary_signal();
+        break;
+    case SignalType::CodecSignal:
+        signal_schema_type = codec_signal();
+        break;
     }
 
-    return arrow::schema(
-        {
-            arrow::field("read_id", uuid_type),
-            arrow::field("signal", signal_schema_type),
-            arrow::field("samples", arrow::uint32()),
-        },
-        metadata);
+    arrow::FieldVector fields{
+        arrow::field("read_id", uuid_type),
+        arrow::field("signal", signal_schema_type),
+        arrow::field("samples", arrow::uint32()),
+    };
+    if (with_checksums) {
+        if (field_locations) {
+            field_locations->checksum = int(fields.size());
+        }
+        fields.push_back(arrow::field("checksum", arrow::uint32()));
+    }
+    return arrow::schema(std::move(fields), metadata);
 }
 
 Result<SignalTableSchemaDescription> read_signal_table_schema(
@@ -46,6 +76,7 @@ Result<SignalTableSchemaDescription> read_signal_table_schema(
 
     ARROW_ASSIGN_OR_RAISE(auto signal_field_idx, find_field_untyped(schema, "signal"));
     SignalType signal_type = SignalType::UncompressedSignal;
+    std::shared_ptr<SignalCodec const> codec;
     {
         auto const signal_field = schema->field(signal_field_idx);
 
@@ -58,14 +89,99 @@ Result<SignalTableSchemaDescription> read_signal_table_schema(
             }
         } else if (signal_arrow_type->Equals(vbz_signal())) {
             signal_type = SignalType::VbzSignal;
+            codec = vbz_signal_codec();
+        } else if (signal_arrow_type->Equals(vbz_dictionary_signal())) {
+            signal_type = SignalType::VbzDictionarySignal;
+            codec = vbz_signal_codec();
+        } else if (signal_arrow_type->Equals(codec_signal())) {
+            signal_type = SignalType::CodecSignal;
+            ARROW_ASSIGN_OR_RAISE(
+                auto const codec_id, read_signal_codec_metadata(schema->metadata()));
+            ARROW_ASSIGN_OR_RAISE(codec, find_signal_codec(codec_id));
         } else {
             return Status::TypeError(
                 "Schema field 'signal' is incorrect type: '", signal_arrow_type->name(), "'");
         }
     }
 
-    return SignalTableSchemaDescription{
-        signal_type, read_id_field_idx, signal_field_idx, samples_field_idx};
+    SignalTableSchemaDescription description{
+        signal_type, read_id_field_idx, signal_field_idx, samples_field_idx, std::move(codec)};
+    // Checksums are optional, tables written without them have no column:
+    if (schema->GetFieldIndex("checksum") != -1) {
+        ARROW_ASSIGN_OR_RAISE(
+            description.checksum, find_field(schema, "checksum", arrow::uint32()));
+    }
+    return description;
+}
+
+Result<std::shared_ptr<arrow::KeyValueMetadata const>> add_signal_dictionary_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    SignalCompressionDictionary const & dictionary)
+{
+    auto const & data = dictionary.data();
+
+    // Metadata values are strings, so store the binary dictionary as base64:
+    auto result = metadata ? metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    result->Append(
+        SIGNAL_DICTIONARY_METADATA_KEY,
+        arrow::util::base64_encode(std::string_view{
+            reinterpret_cast<char const *>(data->data()), std::size_t(data->size())}));
+    return result;
+}
+
+Result<std::shared_ptr<SignalCompressionDictionary const>> read_signal_dictionary_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    if (!metadata || metadata->FindKey(SIGNAL_DICTIONARY_METADATA_KEY) < 0) {
+        return Status::IOError("Missing signal dictionary in signal table schema metadata");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto encoded, metadata->Get(SIGNAL_DICTIONARY_METADATA_KEY));
+    return SignalCompressionDictionary::make(
+        arrow::Buffer::FromString(arrow::util::base64_decode(encoded)));
+}
+
+std::shared_ptr<arrow::KeyValueMetadata const> add_signal_codec_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    std::string const & codec_id)
+{
+    auto result = metadata ? metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    result->Append(SIGNAL_CODEC_METADATA_KEY, codec_id);
+    return result;
+}
+
+Result<std::string> read_signal_codec_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    if (!metadata || metadata->FindKey(SIGNAL_CODEC_METADATA_KEY) < 0) {
+        return Status::IOError("Missing signal codec in signal table schema metadata");
+    }
+    return metadata->Get(SIGNAL_CODEC_METADATA_KEY);
+}
+
+std::shared_ptr<arrow::KeyValueMetadata const> add_signal_batch_alignment_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    std::size_t alignment)
+{
+    auto result = metadata ? metadata->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    result->Append(SIGNAL_BATCH_ALIGNMENT_METADATA_KEY, std::to_string(alignment));
+    return result;
+}
+
+Result<std::size_t> read_signal_batch_alignment_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata)
+{
+    if (!metadata || metadata->FindKey(SIGNAL_BATCH_ALIGNMENT_METADATA_KEY) < 0) {
+        return 0;
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto value, metadata->Get(SIGNAL_BATCH_ALIGNMENT_METADATA_KEY));
+    std::size_t alignment = 0;
+    auto const parsed = std::from_chars(value.data(), value.data() + value.size(), alignment);
+    if (parsed.ec != std::errc{} || parsed.ptr != value.data() + value.size()) {
+        return Status::IOError("Invalid signal batch alignment '", value, "'");
+    }
+    return alignment;
 }
 
 }  // namespace pod5
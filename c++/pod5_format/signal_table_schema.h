@@ -4,7 +4,9 @@
 #include "pod5_format/result.h"
 #include "pod5_format/signal_table_utils.h"
 
+#include <cstddef>
 #include <memory>
+#include <string>
 
 namespace arrow {
 class KeyValueMetadata;
@@ -13,25 +15,77 @@ class Schema;
 
 namespace pod5 {
 
+class SignalCodec;
+class SignalCompressionDictionary;
+
 struct SignalTableSchemaDescription {
     SignalType signal_type;
 
     int read_id = 0;
     int signal = 1;
     int samples = 2;
+
+    /// The codec (de)compressing the table's signal, unset for uncompressed signal.
+    std::shared_ptr<SignalCodec const> codec;
+
+    /// The column holding the CRC32C checksum of each row's signal as stored, -1 if the table
+    /// has no checksums.
+    int checksum = -1;
+    /// Check one in every [checksum_interval] rows against its checksum as the row is decoded,
+    /// 0 leaving rows unchecked. Set by readers, see
+    /// FileReaderOptions::set_signal_checksum_interval.
+    std::size_t checksum_interval = 1;
 };
 
 /// \brief Make a new schema for a signal table.
 /// \param signal_type The type of signal to use.
 /// \param metadata Metadata to be applied to the schema.
 /// \param field_locations [optional] The signal table field locations, for use when writing to the table.
+///        The codec of SignalType::CodecSignal tables is left for the caller to set.
+/// \param with_checksums Add a column holding the CRC32C checksum of each row's signal as stored.
 /// \returns The schema for a signal table.
 POD5_FORMAT_EXPORT std::shared_ptr<arrow::Schema> make_signal_table_schema(
     SignalType signal_type,
     std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
-    SignalTableSchemaDescription * field_locations);
+    SignalTableSchemaDescription * field_locations,
+    bool with_checksums = false);
 
+/// \brief Find the fields of a signal table with [schema], and the codec its signal is
+///        compressed with.
+/// \returns NotImplemented if the table's codec isn't registered.
 POD5_FORMAT_EXPORT Result<SignalTableSchemaDescription> read_signal_table_schema(
-    std::shared_ptr<arrow::Schema> const &);
+    std::shared_ptr<arrow::Schema> const & schema);
+
+/// \brief Add [dictionary] to a signal table's schema [metadata].
+POD5_FORMAT_EXPORT Result<std::shared_ptr<arrow::KeyValueMetadata const>>
+add_signal_dictionary_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    SignalCompressionDictionary const & dictionary);
+
+/// \brief Load the dictionary stored in a signal table's schema [metadata].
+POD5_FORMAT_EXPORT Result<std::shared_ptr<SignalCompressionDictionary const>>
+read_signal_dictionary_metadata(std::shared_ptr<arrow::KeyValueMetadata const> const & metadata);
+
+/// \brief Record the id of the codec compressing a signal table's signal in its schema
+///        [metadata].
+POD5_FORMAT_EXPORT std::shared_ptr<arrow::KeyValueMetadata const> add_signal_codec_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    std::string const & codec_id);
+
+/// \brief Find the id of the codec recorded in a signal table's schema [metadata].
+POD5_FORMAT_EXPORT Result<std::string> read_signal_codec_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata);
+
+/// \brief Record in a signal table's schema [metadata] that each of its batches starts on a
+///        multiple of [alignment] bytes in the file.
+POD5_FORMAT_EXPORT std::shared_ptr<arrow::KeyValueMetadata const>
+add_signal_batch_alignment_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
+    std::size_t alignment);
+
+/// \brief Find the alignment of a signal table's batches recorded in its schema [metadata].
+/// \returns 0 if the table's batches aren't aligned.
+POD5_FORMAT_EXPORT Result<std::size_t> read_signal_batch_alignment_metadata(
+    std::shared_ptr<arrow::KeyValueMetadata const> const & metadata);
 
 }  // namespace pod5
@@ -7,6 +7,10 @@ using SignalTableRowIndex = std::uint64_t;
 enum class SignalType {
     UncompressedSignal,
     VbzSignal,
+    /// Vbz signal compressed against a zstd dictionary stored once in the signal table.
+    VbzDictionarySignal,
+    /// Signal compressed by a registered SignalCodec, whose id is stored in the signal table.
+    CodecSignal,
 };
 
 }  // namespace pod5
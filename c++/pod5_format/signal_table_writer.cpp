@@ -1,21 +1,166 @@
 #include "pod5_format/signal_table_writer.h"
 
+#include "pod5_format/crc32c.h"
 #include "pod5_format/errors.h"
 #include "pod5_format/internal/async_output_stream.h"
+#include "pod5_format/internal/ipc_file_blocks.h"
 #include "pod5_format/internal/tracing/tracing.h"
 #include "pod5_format/types.h"
 
+#include <arrow/array/array_nested.h>
+#include <arrow/array/array_primitive.h>
 #include <arrow/array/builder_binary.h>
 #include <arrow/array/builder_nested.h>
 #include <arrow/array/builder_primitive.h>
 #include <arrow/array/util.h>
+#include <arrow/buffer.h>
 #include <arrow/extension_type.h>
+#include <arrow/ipc/dictionary.h>
+#include <arrow/ipc/message.h>
+#include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 #include <arrow/record_batch.h>
 #include <arrow/type.h>
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 namespace pod5 {
 
+/// Writes the payloads of a signal table writer's batches to the table's file, alongside
+/// payloads passed through from another table's messages.
+///
+/// With a batch alignment, each message is padded to end on a multiple of the alignment in the
+/// file, so the next starts on one. The padding follows the message's flatbuffer metadata, as
+/// padding to 8 bytes already does, so the table stays readable as a stream and as a file.
+class RawBatchPayloadWriter : public arrow::ipc::internal::IpcPayloadWriter {
+public:
+    /// \param sink            The stream [writer] writes to.
+    /// \param file_offset     Where the table starts in its file.
+    /// \param batch_alignment The alignment of messages in the file, 0 leaves them unpadded.
+    RawBatchPayloadWriter(
+        std::unique_ptr<arrow::ipc::internal::IpcPayloadWriter> && writer,
+        arrow::io::OutputStream * sink,
+        std::int64_t file_offset,
+        std::size_t batch_alignment,
+        arrow::MemoryPool * pool)
+    : m_writer(std::move(writer))
+    , m_sink(sink)
+    , m_file_offset(file_offset)
+    , m_batch_alignment(batch_alignment)
+    , m_pool(pool)
+    {
+    }
+
+    arrow::Status Start() override
+    {
+        m_started = true;
+        return m_writer->Start();
+    }
+
+    arrow::Status WritePayload(arrow::ipc::IpcPayload const & payload) override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto const start, m_sink->Tell());
+        if (m_batch_alignment == 0) {
+            ARROW_RETURN_NOT_OK(m_writer->WritePayload(payload));
+        } else {
+            ARROW_ASSIGN_OR_RAISE(auto const aligned_payload, align_payload(payload));
+            ARROW_RETURN_NOT_OK(m_writer->WritePayload(aligned_payload));
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto const end, m_sink->Tell());
+        if (payload.type == arrow::ipc::MessageType::RECORD_BATCH) {
+            // Located as the table's footer will list it, the metadata being everything ahead of
+            // the body:
+            m_last_batch_location = {
+                start, std::int32_t(end - start - payload.body_length), payload.body_length};
+        }
+
+        // The padding relies on arrow's message framing, check it still holds:
+        if (m_batch_alignment != 0 && (m_file_offset + end) % m_batch_alignment != 0) {
+            return arrow::Status::IOError("Failed to align signal table message");
+        }
+        return arrow::Status::OK();
+    }
+
+    arrow::Status Close() override { return m_writer->Close(); }
+
+    /// \brief Find if the table has been started, writing its schema.
+    bool started() const { return m_started; }
+
+    /// \brief Find the location of the last record batch written, relative to the table's start.
+    RecordBatchLocation const & last_batch_location() const { return m_last_batch_location; }
+
+private:
+    // Copy [payload], padding its metadata so the message ends on a multiple of the alignment.
+    arrow::Result<arrow::ipc::IpcPayload> align_payload(arrow::ipc::IpcPayload const & payload)
+    {
+        // Messages are framed as a continuation marker and metadata length, the metadata padded
+        // to 8 bytes, then each body buffer padded to 8 bytes:
+        static constexpr std::int64_t PREFIX_SIZE = 8;
+        auto const padded = [](std::int64_t size) { return (size + 7) & ~std::int64_t(7); };
+
+        ARROW_ASSIGN_OR_RAISE(auto const start, m_sink->Tell());
+        auto const metadata_size = padded(PREFIX_SIZE + payload.metadata->size()) - PREFIX_SIZE;
+        std::int64_t body_size = 0;
+        for (auto const & buffer : payload.body_buffers) {
+            body_size += buffer ? padded(buffer->size()) : 0;
+        }
+
+        auto const alignment = std::int64_t(m_batch_alignment);
+        auto const end = m_file_offset + start + PREFIX_SIZE + metadata_size + body_size;
+        auto const padding = (alignment - end % alignment) % alignment;
+
+        ARROW_ASSIGN_OR_RAISE(
+            auto metadata, arrow::AllocateBuffer(metadata_size + padding, m_pool));
+        auto const data = metadata->mutable_data();
+        std::memcpy(data, payload.metadata->data(), payload.metadata->size());
+        std::memset(
+            data + payload.metadata->size(), 0, metadata->size() - payload.metadata->size());
+
+        arrow::ipc::IpcPayload result = payload;
+        result.metadata = std::move(metadata);
+        return result;
+    }
+
+    std::unique_ptr<arrow::ipc::internal::IpcPayloadWriter> m_writer;
+    arrow::io::OutputStream * m_sink;
+    std::int64_t m_file_offset;
+    std::size_t m_batch_alignment;
+    arrow::MemoryPool * m_pool;
+    bool m_started = false;
+    RecordBatchLocation m_last_batch_location{};
+};
+
+namespace {
+
+// Find the checksum of each row of signal [column] as stored, as SignalTableWriter stores them.
+Result<std::shared_ptr<arrow::Array>> make_checksum_column(
+    arrow::Array const & column,
+    arrow::MemoryPool * pool)
+{
+    arrow::UInt32Builder builder(pool);
+    ARROW_RETURN_NOT_OK(builder.Reserve(column.length()));
+    if (column.type()->id() == arrow::Type::LARGE_LIST) {
+        auto const & signal = static_cast<arrow::LargeListArray const &>(column);
+        auto const values = std::static_pointer_cast<arrow::Int16Array>(signal.values());
+        for (std::int64_t row = 0; row < signal.length(); ++row) {
+            auto const samples = gsl::make_span(
+                values->raw_values() + signal.value_offset(row), signal.value_length(row));
+            builder.UnsafeAppend(crc32c(samples.as_span<std::uint8_t const>()));
+        }
+    } else {
+        auto const & signal = static_cast<VbzSignalArray const &>(column);
+        for (std::int64_t row = 0; row < signal.length(); ++row) {
+            builder.UnsafeAppend(crc32c(signal.Value(row)));
+        }
+    }
+    return builder.Finish();
+}
+
+}  // namespace
+
 SignalTableWriter::SignalTableWriter(
     std::shared_ptr<arrow::ipc::RecordBatchWriter> && writer,
     std::shared_ptr<arrow::Schema> && schema,
@@ -23,17 +168,28 @@ SignalTableWriter::SignalTableWriter(
     SignalTableSchemaDescription const & field_locations,
     std::shared_ptr<FileOutputStream> const & output_stream,
     std::size_t table_batch_size,
-    arrow::MemoryPool * pool)
+    arrow::MemoryPool * pool,
+    SignalCompressionProfile const & compression_profile,
+    std::shared_ptr<SignalCompressionDictionary const> const & compression_dictionary,
+    std::size_t table_batch_bytes,
+    RawBatchPayloadWriter * raw_payload_writer)
 : m_pool(pool)
 , m_schema(schema)
 , m_field_locations(field_locations)
 , m_output_stream{output_stream}
 , m_table_batch_size(table_batch_size)
+, m_table_batch_bytes(table_batch_bytes)
 , m_writer(std::move(writer))
+, m_raw_payload_writer(raw_payload_writer)
 , m_signal_builder(std::move(signal_builder))
+, m_compression_context(pool, compression_profile)
 {
     m_read_id_builder = make_read_id_builder(m_pool);
     m_samples_builder = std::make_unique<arrow::UInt32Builder>(m_pool);
+    if (m_field_locations.checksum >= 0) {
+        m_checksum_builder = std::make_unique<arrow::UInt32Builder>(m_pool);
+    }
+    m_compression_context.set_dictionary(compression_dictionary);
 }
 
 SignalTableWriter::SignalTableWriter(SignalTableWriter && other) = default;
@@ -60,12 +216,17 @@ Result<SignalTableRowIndex> SignalTableWriter::add_signal(
     auto row_id = m_written_batched_row_count + m_current_batch_row_count;
     ARROW_RETURN_NOT_OK(m_read_id_builder->Append(read_id.data()));
 
-    ARROW_RETURN_NOT_OK(std::visit(visitors::append_signal{signal, m_pool}, m_signal_builder));
+    ARROW_RETURN_NOT_OK(
+        std::visit(visitors::append_signal{signal, m_compression_context}, m_signal_builder));
+    if (m_checksum_builder) {
+        ARROW_RETURN_NOT_OK(m_checksum_builder->Append(
+            std::visit(visitors::last_row_checksum{signal}, m_signal_builder)));
+    }
 
     ARROW_RETURN_NOT_OK(m_samples_builder->Append(signal.size()));
     ++m_current_batch_row_count;
 
-    if (m_current_batch_row_count >= m_table_batch_size) {
+    if (is_batch_full()) {
         ARROW_RETURN_NOT_OK(write_batch());
     }
 
@@ -89,11 +250,14 @@ Result<SignalTableRowIndex> SignalTableWriter::add_pre_compressed_signal(
 
     ARROW_RETURN_NOT_OK(
         std::visit(visitors::append_pre_compressed_signal{signal}, m_signal_builder));
+    if (m_checksum_builder) {
+        ARROW_RETURN_NOT_OK(m_checksum_builder->Append(crc32c(signal)));
+    }
 
     ARROW_RETURN_NOT_OK(m_samples_builder->Append(sample_count));
     ++m_current_batch_row_count;
 
-    if (m_current_batch_row_count >= m_table_batch_size) {
+    if (is_batch_full()) {
         ARROW_RETURN_NOT_OK(write_batch());
     }
 
@@ -115,12 +279,20 @@ SignalTableWriter::add_signal_batch(
         return Status::Invalid("Unable to write batches directly and using per read methods");
     }
 
+    // Readers find a row's batch by the row count of the first, so only the last batch may be
+    // short:
     if (!final_batch && row_count != m_table_batch_size) {
         return Status::Invalid("Unable to write invalid sized signal batch to signal table");
     }
 
+    if (m_checksum_builder && columns.size() == std::size_t(m_field_locations.checksum)) {
+        ARROW_ASSIGN_OR_RAISE(
+            auto checksums, make_checksum_column(*columns[m_field_locations.signal], m_pool));
+        columns.push_back(std::move(checksums));
+    }
+
     auto const record_batch = arrow::RecordBatch::Make(m_schema, row_count, std::move(columns));
-    ARROW_RETURN_NOT_OK(m_writer->WriteRecordBatch(*record_batch));
+    ARROW_RETURN_NOT_OK(write_batch(*record_batch));
     if (final_batch) {
         ARROW_RETURN_NOT_OK(close());
     }
@@ -149,9 +321,80 @@ SignalType SignalTableWriter::signal_type() const { return m_field_locations.sig
 Status SignalTableWriter::write_batch(arrow::RecordBatch const & record_batch)
 {
     ARROW_RETURN_NOT_OK(m_writer->WriteRecordBatch(record_batch));
+    ARROW_RETURN_NOT_OK(batch_written(record_batch.num_rows()));
+    return m_output_stream->batch_complete();
+}
+
+Status SignalTableWriter::write_raw_batch(
+    arrow::ipc::Message const & message,
+    std::size_t row_count)
+{
+    if (!m_writer) {
+        return Status::IOError("Writer terminated");
+    }
+    if (!m_raw_payload_writer) {
+        return Status::Invalid("Raw batches can't be written by this writer");
+    }
+    if (m_current_batch_row_count > 0) {
+        return Status::Invalid("Raw batches can't be written with a batch in progress");
+    }
+    if (message.type() != arrow::ipc::MessageType::RECORD_BATCH || !message.body()) {
+        return Status::Invalid("Raw batch message is not a record batch");
+    }
+    // Raw batches must hold the rows they are listed with:
+    ARROW_ASSIGN_OR_RAISE(
+        auto const message_row_count,
+        ipc_file_blocks::read_record_batch_row_count(*message.metadata()));
+    if (std::size_t(message_row_count) != row_count) {
+        return Status::Invalid("Raw batch holds ", message_row_count, " rows, not ", row_count);
+    }
+
+    // The table's schema is written with its first batch, so that batch is decoded and written
+    // by the writer:
+    if (!m_raw_payload_writer->started()) {
+        // Signal tables hold no dictionary encoded columns, so the memo stays empty:
+        arrow::ipc::DictionaryMemo dictionary_memo;
+        arrow::ipc::IpcReadOptions options;
+        options.memory_pool = m_pool;
+        ARROW_ASSIGN_OR_RAISE(
+            auto const record_batch,
+            arrow::ipc::ReadRecordBatch(message, m_schema, &dictionary_memo, options));
+        if (std::size_t(record_batch->num_rows()) != row_count) {
+            return Status::Invalid(
+                "Raw batch holds ", record_batch->num_rows(), " rows, not ", row_count);
+        }
+        m_written_batched_row_count += row_count;
+        return write_batch(*record_batch);
+    }
+
+    arrow::ipc::IpcPayload payload;
+    payload.type = arrow::ipc::MessageType::RECORD_BATCH;
+    payload.metadata = message.metadata();
+    payload.body_buffers = {message.body()};
+    payload.body_length = message.body_length();
+    ARROW_RETURN_NOT_OK(m_raw_payload_writer->WritePayload(payload));
+
+    m_written_batched_row_count += row_count;
+    ARROW_RETURN_NOT_OK(batch_written(row_count));
     return m_output_stream->batch_complete();
 }
 
+std::vector<SignalTableWriter::WrittenBatch> SignalTableWriter::take_written_batches()
+{
+    return std::exchange(m_written_batches, {});
+}
+
+Status SignalTableWriter::batch_written(std::size_t row_count)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const end_offset, m_output_stream->Tell());
+    m_written_batches.push_back({end_offset, row_count});
+
+    auto location = m_raw_payload_writer->last_batch_location();
+    location.row_count = row_count;
+    m_batch_locations.push_back(location);
+    return Status::OK();
+}
+
 Status SignalTableWriter::write_batch()
 {
     POD5_TRACE_FUNCTION();
@@ -163,13 +406,18 @@ Status SignalTableWriter::write_batch()
         return Status::IOError("Writer terminated");
     }
 
-    std::vector<std::shared_ptr<arrow::Array>> columns{nullptr, nullptr, nullptr};
+    std::vector<std::shared_ptr<arrow::Array>> columns(m_schema->num_fields());
     ARROW_RETURN_NOT_OK(m_read_id_builder->Finish(&columns[m_field_locations.read_id]));
 
+    m_written_signal_bytes += std::visit(visitors::signal_data_size{}, m_signal_builder);
+
     ARROW_RETURN_NOT_OK(
         std::visit(visitors::finish_column{&columns[m_field_locations.signal]}, m_signal_builder));
 
     ARROW_RETURN_NOT_OK(m_samples_builder->Finish(&columns[m_field_locations.samples]));
+    if (m_checksum_builder) {
+        ARROW_RETURN_NOT_OK(m_checksum_builder->Finish(&columns[m_field_locations.checksum]));
+    }
 
     auto const record_batch =
         arrow::RecordBatch::Make(m_schema, m_current_batch_row_count, std::move(columns));
@@ -177,9 +425,31 @@ Status SignalTableWriter::write_batch()
     m_current_batch_row_count = 0;
 
     ARROW_RETURN_NOT_OK(m_writer->WriteRecordBatch(*record_batch));
+    ARROW_RETURN_NOT_OK(batch_written(record_batch->num_rows()));
     return m_output_stream->batch_complete();
 }
 
+bool SignalTableWriter::is_batch_full()
+{
+    if (m_current_batch_row_count >= m_table_batch_size) {
+        return true;
+    }
+    if (m_table_batch_bytes == 0 || m_written_batched_row_count > 0) {
+        return false;
+    }
+
+    // Every batch must hold the same number of rows, so the first batch decides it:
+    static constexpr std::size_t ROW_BYTES =
+        sizeof(Uuid) + sizeof(std::uint32_t) + sizeof(std::int64_t);
+    auto const batch_bytes = std::visit(visitors::signal_data_size{}, m_signal_builder)
+                             + m_current_batch_row_count * ROW_BYTES;
+    if (batch_bytes < m_table_batch_bytes) {
+        return false;
+    }
+    m_table_batch_size = m_current_batch_row_count;
+    return true;
+}
+
 Status SignalTableWriter::reserve_rows()
 {
     // Only reserve if we have not already reserved (at the start of a batch)
@@ -187,13 +457,21 @@ Status SignalTableWriter::reserve_rows()
         return arrow::Status::OK();
     }
 
-    ARROW_RETURN_NOT_OK(m_read_id_builder->Reserve(m_table_batch_size));
-    ARROW_RETURN_NOT_OK(m_samples_builder->Reserve(m_table_batch_size));
+    auto const row_count = m_table_batch_size;
+    ARROW_RETURN_NOT_OK(m_read_id_builder->Reserve(row_count));
+    ARROW_RETURN_NOT_OK(m_samples_builder->Reserve(row_count));
+    if (m_checksum_builder) {
+        ARROW_RETURN_NOT_OK(m_checksum_builder->Reserve(row_count));
+    }
 
-    static constexpr std::uint32_t APPROX_READ_SIZE = 102'400;
+    static constexpr std::size_t APPROX_READ_SIZE = 102'400;
+    auto approx_read_size = APPROX_READ_SIZE;
+    if (m_table_batch_bytes > 0) {
+        // Don't reserve much more than the byte target when the row limit is high:
+        approx_read_size = std::min(approx_read_size, m_table_batch_bytes / row_count + 1);
+    }
 
-    return std::visit(
-        visitors::reserve_rows{m_table_batch_size, APPROX_READ_SIZE}, m_signal_builder);
+    return std::visit(visitors::reserve_rows{row_count, approx_read_size}, m_signal_builder);
 }
 
 Result<SignalTableWriter> make_signal_table_writer(
@@ -201,17 +479,64 @@ Result<SignalTableWriter> make_signal_table_writer(
     std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
     std::size_t table_batch_size,
     SignalType compression_type,
-    arrow::MemoryPool * pool)
+    arrow::MemoryPool * pool,
+    SignalCompressionProfile const & compression_profile,
+    std::shared_ptr<SignalCompressionDictionary const> const & compression_dictionary,
+    std::size_t table_batch_bytes,
+    std::size_t batch_alignment,
+    std::int64_t file_offset,
+    std::shared_ptr<SignalCodec const> const & codec,
+    bool write_checksums)
 {
+    ARROW_RETURN_NOT_OK(check_signal_compression_profile(compression_profile));
+    if (batch_alignment % 8 != 0) {
+        return Status::Invalid("Signal batch alignment must be a multiple of 8 bytes");
+    }
+
+    auto table_metadata = metadata;
+    std::shared_ptr<SignalCompressionDictionary const> table_dictionary;
+    if (compression_type == SignalType::VbzDictionarySignal) {
+        if (!compression_dictionary) {
+            return Status::Invalid("Dictionary signal type requires a compression dictionary");
+        }
+        ARROW_ASSIGN_OR_RAISE(
+            table_metadata, add_signal_dictionary_metadata(metadata, *compression_dictionary));
+        table_dictionary = compression_dictionary;
+    }
+    if (compression_type == SignalType::CodecSignal) {
+        if (!codec) {
+            return Status::Invalid("Codec signal type requires a signal codec");
+        }
+        table_metadata = add_signal_codec_metadata(table_metadata, codec->id());
+    }
+    if (batch_alignment > 0) {
+        table_metadata = add_signal_batch_alignment_metadata(table_metadata, batch_alignment);
+    }
+
     SignalTableSchemaDescription field_locations;
-    auto schema = make_signal_table_schema(compression_type, metadata, &field_locations);
+    auto schema = make_signal_table_schema(
+        compression_type, table_metadata, &field_locations, write_checksums);
+    if (compression_type == SignalType::CodecSignal) {
+        field_locations.codec = codec;
+    }
 
     arrow::ipc::IpcWriteOptions options;
     options.memory_pool = pool;
 
-    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(sink, schema, options, metadata));
-
-    ARROW_ASSIGN_OR_RAISE(auto signal_builder, make_signal_builder(compression_type, pool));
+    // Batches are written through a payload writer of our own, so raw batch messages can be
+    // written to the same file and listed in its footer:
+    ARROW_ASSIGN_OR_RAISE(
+        auto payload_writer,
+        arrow::ipc::internal::MakePayloadFileWriter(sink.get(), schema, options, table_metadata));
+    auto raw_payload_writer = std::make_unique<RawBatchPayloadWriter>(
+        std::move(payload_writer), sink.get(), file_offset, batch_alignment, pool);
+    auto const raw_payload_writer_ptr = raw_payload_writer.get();
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::ipc::RecordBatchWriter> writer,
+        arrow::ipc::internal::OpenRecordBatchWriter(
+            std::move(raw_payload_writer), schema, options));
+
+    ARROW_ASSIGN_OR_RAISE(auto signal_builder, make_signal_builder(compression_type, codec, pool));
 
     auto signal_table_writer = SignalTableWriter(
         std::move(writer),
@@ -220,7 +545,11 @@ Result<SignalTableWriter> make_signal_table_writer(
         field_locations,
         sink,
         table_batch_size,
-        pool);
+        pool,
+        compression_profile,
+        table_dictionary,
+        table_batch_bytes,
+        raw_payload_writer_ptr);
 
     return signal_table_writer;
 }
@@ -4,25 +4,36 @@
 #include "pod5_format/result.h"
 #include "pod5_format/signal_builder.h"
 #include "pod5_format/signal_table_schema.h"
+#include "pod5_format/table_reader.h"
 #include "pod5_format/uuid.h"
 
 #include <arrow/io/type_fwd.h>
 #include <gsl/gsl-lite.hpp>
 
+#include <vector>
+
 namespace arrow {
 class Schema;
 
 namespace ipc {
+class Message;
 class RecordBatchWriter;
-}
+}  // namespace ipc
 }  // namespace arrow
 
 namespace pod5 {
 
 class FileOutputStream;
+class RawBatchPayloadWriter;
 
 class POD5_FORMAT_EXPORT SignalTableWriter {
 public:
+    /// \brief A batch written to the table, found by where it ends in the table's stream.
+    struct WrittenBatch {
+        std::int64_t end_offset;
+        std::uint64_t row_count;
+    };
+
     SignalTableWriter(
         std::shared_ptr<arrow::ipc::RecordBatchWriter> && writer,
         std::shared_ptr<arrow::Schema> && schema,
@@ -30,7 +41,12 @@ public:
         SignalTableSchemaDescription const & field_locations,
         std::shared_ptr<FileOutputStream> const & output_stream,
         std::size_t table_batch_size,
-        arrow::MemoryPool * pool);
+        arrow::MemoryPool * pool,
+        SignalCompressionProfile const & compression_profile = {},
+        std::shared_ptr<SignalCompressionDictionary const> const & compression_dictionary =
+            nullptr,
+        std::size_t table_batch_bytes = 0,
+        RawBatchPayloadWriter * raw_payload_writer = nullptr);
     SignalTableWriter(SignalTableWriter &&);
     SignalTableWriter & operator=(SignalTableWriter &&);
     SignalTableWriter(SignalTableWriter const &) = delete;
@@ -38,6 +54,8 @@ public:
     ~SignalTableWriter();
 
     /// \brief Find the size of table batches for the signal table writer.
+    /// \note With a byte target this is the most rows a batch can hold until the first batch is
+    ///       written, then the row count of that batch.
     std::size_t table_batch_size() const { return m_table_batch_size; }
 
     /// \brief Add a read to the signal table, adding to the current batch.
@@ -62,6 +80,11 @@ public:
         gsl::span<std::uint8_t const> const & signal,
         std::uint32_t sample_count);
 
+    /// \brief Write a batch of [row_count] rows from [columns], which must be the table batch
+    ///        size unless [final_batch] is set.
+    /// \note If the writer stores checksums, [columns] may leave out the checksum column to
+    ///       have the writer find each row's checksum.
+    /// \returns The first row of the batch, and the row following its last.
     pod5::Result<std::pair<SignalTableRowIndex, SignalTableRowIndex>> add_signal_batch(
         std::size_t row_count,
         std::vector<std::shared_ptr<arrow::Array>> && columns,
@@ -73,6 +96,38 @@ public:
     /// \brief Find the signal type of this writer
     SignalType signal_type() const;
 
+    /// \brief Find the zstd settings used to compress signal added to this writer.
+    SignalCompressionProfile const & compression_profile() const
+    {
+        return m_compression_context.profile();
+    }
+
+    /// \brief Find the codec compressing signal added to this writer, unset if signal is stored
+    ///        uncompressed.
+    std::shared_ptr<SignalCodec const> const & codec() const { return m_field_locations.codec; }
+
+    /// \brief Find if the writer stores the CRC32C checksum of each row's signal as stored.
+    bool writes_checksums() const { return m_checksum_builder != nullptr; }
+
+    /// \brief Find the dictionary signal added to this writer is compressed against.
+    std::shared_ptr<SignalCompressionDictionary const> const & compression_dictionary() const
+    {
+        return m_compression_context.dictionary();
+    }
+
+    /// \brief Find the number of rows added to this writer, which is the index of the next row.
+    std::size_t row_count() const
+    {
+        return m_written_batched_row_count + m_current_batch_row_count;
+    }
+
+    /// \brief Find the bytes of signal data added to this writer row by row, as stored in the
+    ///        table.
+    std::size_t signal_bytes() const
+    {
+        return m_written_signal_bytes + std::visit(visitors::signal_data_size{}, m_signal_builder);
+    }
+
     /// \brief Reserve space for future row writes, called automatically when a flush occurs.
     Status reserve_rows();
 
@@ -82,24 +137,57 @@ public:
     /// \brief Flush passed data into the writer as a record batch.
     Status write_batch(arrow::RecordBatch const &);
 
+    /// \brief Write a record batch message read from another signal table with this schema,
+    ///        copying its bytes without decoding them.
+    /// \param message A record batch message, which isn't checked against the schema.
+    /// \param row_count The rows held by the batch.
+    /// \note The table's first batch is decoded and written as any other, as the table's schema
+    ///       is written with it.
+    Status write_raw_batch(arrow::ipc::Message const & message, std::size_t row_count);
+
+    /// \brief Find the number of batches written since take_written_batches was last called.
+    std::size_t written_batch_count() const { return m_written_batches.size(); }
+
+    /// \brief Take the batches written since this was last called, in the order written.
+    std::vector<WrittenBatch> take_written_batches();
+
+    /// \brief Find the locations of every batch written, relative to the table's start.
+    std::vector<RecordBatchLocation> const & batch_locations() const { return m_batch_locations; }
+
 private:
     /// \brief Flush buffered data into the writer as a record batch.
     Status write_batch();
 
+    /// \brief Find if the current batch should be written, fixing the batch size once the first
+    ///        batch reaches the byte target.
+    bool is_batch_full();
+
+    /// \brief Record a batch of [row_count] rows has been written up to the stream's position.
+    Status batch_written(std::size_t row_count);
+
     arrow::MemoryPool * m_pool = nullptr;
     std::shared_ptr<arrow::Schema> m_schema;
     SignalTableSchemaDescription m_field_locations;
     std::shared_ptr<FileOutputStream> m_output_stream;
     std::size_t m_table_batch_size;
+    std::size_t m_table_batch_bytes;
 
     std::shared_ptr<arrow::ipc::RecordBatchWriter> m_writer;
+    // Owned by [m_writer], writing the payloads of its batches:
+    RawBatchPayloadWriter * m_raw_payload_writer;
 
     std::unique_ptr<arrow::FixedSizeBinaryBuilder> m_read_id_builder;
     SignalBuilderVariant m_signal_builder;
     std::unique_ptr<arrow::UInt32Builder> m_samples_builder;
+    // Null unless the table holds checksums:
+    std::unique_ptr<arrow::UInt32Builder> m_checksum_builder;
+    SignalCompressionContext m_compression_context;
 
     std::size_t m_written_batched_row_count = 0;
     std::size_t m_current_batch_row_count = 0;
+    std::size_t m_written_signal_bytes = 0;
+    std::vector<WrittenBatch> m_written_batches;
+    std::vector<RecordBatchLocation> m_batch_locations;
 };
 
 /// \brief Make a new writer for a signal table.
@@ -107,12 +195,31 @@ private:
 /// \param metadata Metadata to be applied to the table schema.
 /// \param table_batch_size The size of each batch written for the table.
 /// \param pool Pool to be used for building table in memory.
+/// \param compression_profile zstd settings used to compress vbz signal.
+/// \param compression_dictionary Dictionary to compress against, required for
+///        SignalType::VbzDictionarySignal. It is stored in the table schema metadata.
+/// \param table_batch_bytes Target size of the first batch, which fixes the row count of every
+///        batch, with [table_batch_size] the most rows it can hold. 0 uses [table_batch_size].
+/// \param batch_alignment Pad each batch so the next starts on a multiple of this many bytes in
+///        the file, recorded in the table schema metadata. 0 leaves batches unpadded.
+/// \param file_offset Where [sink]'s position 0 lies in the file, which batches are aligned in.
+/// \param codec Codec compressing signal, required for SignalType::CodecSignal. Its id is stored
+///        in the table schema metadata.
+/// \param write_checksums Store the CRC32C checksum of each row's signal as stored (compressed,
+///        for compressed signal) in a column of its own, for readers to detect corruption.
 /// \returns The writer for the new table.
 POD5_FORMAT_EXPORT Result<SignalTableWriter> make_signal_table_writer(
     std::shared_ptr<FileOutputStream> const & sink,
     std::shared_ptr<arrow::KeyValueMetadata const> const & metadata,
     std::size_t table_batch_size,
     SignalType compression_type,
-    arrow::MemoryPool * pool);
+    arrow::MemoryPool * pool,
+    SignalCompressionProfile const & compression_profile = {},
+    std::shared_ptr<SignalCompressionDictionary const> const & compression_dictionary = nullptr,
+    std::size_t table_batch_bytes = 0,
+    std::size_t batch_alignment = 0,
+    std::int64_t file_offset = 0,
+    std::shared_ptr<SignalCodec const> const & codec = nullptr,
+    bool write_checksums = false);
 
 }  // namespace pod5
@@ -16,6 +16,10 @@
 #define SVB16_X64
 #elif defined(__arm__) || defined(__aarch64__)
 #define SVB16_ARM
+// NEON is always available on aarch64, the kernels use aarch64 only table lookups.
+#if defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define SVB16_NEON
+#endif
 #endif
 
 #ifndef __has_builtin
@@ -5,8 +5,12 @@
 #include "svb16.h"  // svb16_key_length
 #ifdef SVB16_X64
 #include "decode_x64.hpp"
+#include "decode_x64_avx.hpp"
 #include "simd_detect_x64.hpp"
 #endif
+#ifdef SVB16_NEON
+#include "decode_neon.hpp"
+#endif
 
 namespace svb16 {
 
@@ -17,23 +21,47 @@ inline std::size_t decode_input_buffer_padding_byte_count()
 {
 #ifdef SVB16_X64
     return sizeof(__m128i);
+#elif defined(SVB16_NEON)
+    return sizeof(uint8x16_t);
 #else
     return 0;
 #endif
 }
 
+// Decode values from separately stored keys and data, returning the number of data bytes consumed.
+//
+// [data] must be followed by decode_input_buffer_padding_byte_count() readable bytes.
 template <typename Int16T, bool UseDelta, bool UseZigzag>
-size_t decode(gsl::span<Int16T> out, gsl::span<uint8_t const> in, Int16T prev = 0)
+size_t decode(
+    gsl::span<Int16T> out,
+    gsl::span<uint8_t const> keys,
+    gsl::span<uint8_t const> data,
+    Int16T prev = 0)
 {
-    auto keys_length = ::svb16_key_length(out.size());
-    auto const keys = in.subspan(0, keys_length);
-    auto const data = in.subspan(keys_length);
 #ifdef SVB16_X64
+    if (has_avx512_vbmi2()) {
+        return decode_avx512<Int16T, UseDelta, UseZigzag>(out, keys, data, prev) - data.begin();
+    }
+    if (has_avx2()) {
+        return decode_avx2<Int16T, UseDelta, UseZigzag>(out, keys, data, prev) - data.begin();
+    }
     if (has_sse4_1()) {
-        return decode_sse<Int16T, UseDelta, UseZigzag>(out, keys, data, prev) - in.begin();
+        return decode_sse<Int16T, UseDelta, UseZigzag>(out, keys, data, prev) - data.begin();
     }
 #endif
-    return decode_scalar<Int16T, UseDelta, UseZigzag>(out, keys, data, prev) - in.begin();
+#ifdef SVB16_NEON
+    return decode_neon<Int16T, UseDelta, UseZigzag>(out, keys, data, prev) - data.begin();
+#endif
+    return decode_scalar<Int16T, UseDelta, UseZigzag>(out, keys, data, prev) - data.begin();
+}
+
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+size_t decode(gsl::span<Int16T> out, gsl::span<uint8_t const> in, Int16T prev = 0)
+{
+    auto keys_length = ::svb16_key_length(out.size());
+    auto const keys = in.subspan(0, keys_length);
+    auto const data = in.subspan(keys_length);
+    return keys_length + decode<Int16T, UseDelta, UseZigzag>(out, keys, data, prev);
 }
 
 }  // namespace svb16
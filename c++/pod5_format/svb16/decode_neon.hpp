@@ -0,0 +1,85 @@
+#pragma once
+
+#include "common.hpp"
+#include "decode_scalar.hpp"
+#include "shuffle_tables.hpp"
+
+#include <gsl/gsl-lite.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef SVB16_NEON
+
+#include <arm_neon.h>
+
+namespace svb16 {
+namespace detail {
+template <bool UseDelta, bool UseZigzag>
+inline uint16x8_t decode_transform_8(uint16x8_t value, uint16x8_t * prev)
+{
+    SVB16_IF_CONSTEXPR(UseZigzag)
+    {
+        // (N >> 1) ^ (0xFFFF if N & 1 else 0x0000)
+        auto const low_bit_mask =
+            vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(vshlq_n_u16(value, 15)), 15));
+        value = veorq_u16(vshrq_n_u16(value, 1), low_bit_mask);
+    }
+
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        auto const zero = vdupq_n_u16(0);
+        // value == [A B C D E F G H]
+        value = vaddq_u16(value, vextq_u16(zero, value, 7));
+        // value == [A AB BC CD DE EF FG GH]
+        value = vaddq_u16(value, vextq_u16(zero, value, 6));
+        // value == [A AB ABC ABCD BCDE CDEF DEFG EFGH]
+        value = vaddq_u16(value, vextq_u16(zero, value, 4));
+        // value == [A AB ABC ABCD ABCDE ABCDEF ABCDEFG ABCDEFGH]
+        value = vaddq_u16(value, *prev);
+        *prev = vdupq_laneq_u16(value, 7);
+    }
+    return value;
+}
+}  // namespace detail
+
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+uint8_t const * decode_neon(
+    gsl::span<Int16T> out_span,
+    gsl::span<uint8_t const> keys_span,
+    gsl::span<uint8_t const> data_span,
+    Int16T prev = 0)
+{
+    auto out = out_span.begin();
+    auto const count = out_span.size();
+    auto keys = keys_span.begin();
+    auto data = data_span.begin();
+
+    uint16x8_t prev_reg = vdupq_n_u16(static_cast<uint16_t>(prev));
+    for (auto const end = out + (count & ~std::size_t(7)); out != end; out += 8) {
+        auto const key = *keys++;
+
+        // Note we load 16 bytes here, which may read beyond the end of the data - see
+        // `decode_input_buffer_padding_byte_count`. Out of range (0xFF) indices produce zero bytes.
+        auto const shuffle = vld1q_u8(g_decode_shuffle_table[key]);
+        auto const bytes = vqtbl1q_u8(vld1q_u8(data), shuffle);
+        data += 8 + svb16_popcount(key);
+
+        auto const value =
+            detail::decode_transform_8<UseDelta, UseZigzag>(vreinterpretq_u16_u8(bytes), &prev_reg);
+        vst1q_u16(reinterpret_cast<uint16_t *>(out), value);
+    }
+
+    if (out != out_span.begin()) {
+        prev = out[-1];
+    }
+    return decode_scalar<Int16T, UseDelta, UseZigzag>(
+        gsl::make_span(out, out_span.end()),
+        gsl::make_span(keys, keys_span.end()),
+        gsl::make_span(data, data_span.end()),
+        prev);
+}
+
+}  // namespace svb16
+
+#endif  // SVB16_NEON
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "common.hpp"
+#include "decode_scalar.hpp"
+#include "intrinsics.hpp"
+#include "shuffle_tables.hpp"
+
+#include <gsl/gsl-lite.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef SVB16_X64
+
+namespace svb16 {
+namespace detail {
+template <bool UseDelta, bool UseZigzag>
+[[gnu::target("avx2")]] inline __m256i decode_transform_16(__m256i value, __m256i * prev)
+{
+    SVB16_IF_CONSTEXPR(UseZigzag)
+    {
+        value = _mm256_xor_si256(
+            _mm256_srli_epi16(value, 1), _mm256_srai_epi16(_mm256_slli_epi16(value, 15), 15));
+    }
+
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        // Prefix sum within each 128 bit lane:
+        value = _mm256_add_epi16(value, _mm256_slli_si256(value, 2));
+        value = _mm256_add_epi16(value, _mm256_slli_si256(value, 4));
+        value = _mm256_add_epi16(value, _mm256_slli_si256(value, 8));
+
+        // Then carry the last value of the low lane into the high lane:
+        auto const broadcast_last_16 = _mm256_set1_epi16(0x0F0E);
+        auto const lane_totals = _mm256_shuffle_epi8(value, broadcast_last_16);
+        value = _mm256_add_epi16(value, _mm256_permute2x128_si256(lane_totals, lane_totals, 0x08));
+        value = _mm256_add_epi16(value, *prev);
+
+        // [prev] holds the final value in every element:
+        *prev = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(value, broadcast_last_16), 0xFF);
+    }
+    return value;
+}
+
+template <bool UseDelta, bool UseZigzag>
+[[gnu::target("avx512f,avx512bw,avx512vbmi2,bmi2")]] inline __m512i decode_transform_32(
+    __m512i value,
+    __m512i * prev)
+{
+    SVB16_IF_CONSTEXPR(UseZigzag)
+    {
+        value = _mm512_xor_si512(
+            _mm512_srli_epi16(value, 1), _mm512_srai_epi16(_mm512_slli_epi16(value, 15), 15));
+    }
+
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        // Prefix sum within each 128 bit lane:
+        value = _mm512_add_epi16(value, _mm512_bslli_epi128(value, 2));
+        value = _mm512_add_epi16(value, _mm512_bslli_epi128(value, 4));
+        value = _mm512_add_epi16(value, _mm512_bslli_epi128(value, 8));
+
+        // Then carry lane totals up into the following lanes (the maskz forms avoid
+        // false uninitialised warnings from some gcc versions):
+        auto const zero = _mm512_setzero_si512();
+        auto const lane_totals = _mm512_shuffle_epi8(value, _mm512_set1_epi16(0x0F0E));
+        auto const carry_1 = _mm512_maskz_alignr_epi64(0xFF, lane_totals, zero, 6);
+        auto const carry_2 =
+            _mm512_maskz_alignr_epi64(0xFF, _mm512_add_epi16(lane_totals, carry_1), zero, 4);
+        value = _mm512_add_epi16(value, _mm512_add_epi16(carry_1, carry_2));
+        value = _mm512_add_epi16(value, *prev);
+
+        // [prev] holds the final value in every element:
+        *prev = _mm512_permutexvar_epi16(_mm512_set1_epi16(31), value);
+    }
+    return value;
+}
+}  // namespace detail
+
+/// Decode 16 values per step, using two decode shuffle table lookups per 256 bit register.
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+[[gnu::target("avx2")]] uint8_t const * decode_avx2(
+    gsl::span<Int16T> out_span,
+    gsl::span<uint8_t const> keys_span,
+    gsl::span<uint8_t const> data_span,
+    Int16T prev = 0)
+{
+    auto out = out_span.begin();
+    auto const count = out_span.size();
+    auto keys = keys_span.begin();
+    auto data = data_span.begin();
+
+    __m256i prev_reg = _mm256_set1_epi16(prev);
+    for (auto const end = out + (count & ~std::size_t(15)); out != end; out += 16) {
+        auto const key_0 = keys[0];
+        auto const key_1 = keys[1];
+        keys += 2;
+
+        // Note we load sizeof(__m128i) bytes from the start of each group here, which may read beyond
+        // the end of the data - see `decode_input_buffer_padding_byte_count`.
+        auto const len_0 = 8 + svb16_popcount(key_0);
+        auto const data_0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data));
+        auto const data_1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + len_0));
+        data += len_0 + 8 + svb16_popcount(key_1);
+
+        auto const shuffle = _mm256_set_m128i(
+            *reinterpret_cast<__m128i const *>(&g_decode_shuffle_table[key_1]),
+            *reinterpret_cast<__m128i const *>(&g_decode_shuffle_table[key_0]));
+        auto value = _mm256_shuffle_epi8(_mm256_set_m128i(data_1, data_0), shuffle);
+        value = detail::decode_transform_16<UseDelta, UseZigzag>(value, &prev_reg);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), value);
+    }
+
+    if (out != out_span.begin()) {
+        prev = out[-1];
+    }
+    return decode_scalar<Int16T, UseDelta, UseZigzag>(
+        gsl::make_span(out, out_span.end()),
+        gsl::make_span(keys, keys_span.end()),
+        gsl::make_span(data, data_span.end()),
+        prev);
+}
+
+/// Decode 32 values per step, using a masked byte expand in place of shuffle tables.
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+[[gnu::target("avx512f,avx512bw,avx512vbmi2,bmi2")]] uint8_t const * decode_avx512(
+    gsl::span<Int16T> out_span,
+    gsl::span<uint8_t const> keys_span,
+    gsl::span<uint8_t const> data_span,
+    Int16T prev = 0)
+{
+    auto out = out_span.begin();
+    auto const count = out_span.size();
+    auto keys = keys_span.begin();
+    auto data = data_span.begin();
+
+    // Every value has a low byte, high bytes are present only where the key bit is set:
+    std::uint64_t const low_bytes = 0x5555555555555555;
+    std::uint64_t const high_bytes = 0xAAAAAAAAAAAAAAAA;
+
+    __m512i prev_reg = _mm512_set1_epi16(prev);
+    for (auto const end = out + (count & ~std::size_t(31)); out != end; out += 32) {
+        std::uint32_t key;
+        std::memcpy(&key, keys, sizeof(key));
+        keys += sizeof(key);
+
+        // The expand only reads the bytes selected by the mask, so never reads beyond the data:
+        __mmask64 const byte_mask = low_bytes | _pdep_u64(key, high_bytes);
+        auto value = _mm512_maskz_expandloadu_epi8(byte_mask, data);
+        data += 32 + svb16_popcount(key);
+
+        value = detail::decode_transform_32<UseDelta, UseZigzag>(value, &prev_reg);
+        _mm512_storeu_si512(reinterpret_cast<void *>(out), value);
+    }
+
+    if (out != out_span.begin()) {
+        prev = out[-1];
+    }
+    return decode_scalar<Int16T, UseDelta, UseZigzag>(
+        gsl::make_span(out, out_span.end()),
+        gsl::make_span(keys, keys_span.end()),
+        gsl::make_span(data, data_span.end()),
+        prev);
+}
+
+}  // namespace svb16
+
+#endif  // SVB16_X64
@@ -5,8 +5,12 @@
 #include "svb16.h"  // svb16_key_length
 #ifdef SVB16_X64
 #include "encode_x64.hpp"
+#include "encode_x64_avx.hpp"
 #include "simd_detect_x64.hpp"
 #endif
+#ifdef SVB16_NEON
+#include "encode_neon.hpp"
+#endif
 
 namespace svb16 {
 
@@ -16,9 +20,18 @@ size_t encode(Int16T const * in, uint8_t * SVB_RESTRICT out, uint32_t count, Int
     auto const keys = out;
     auto const data = keys + ::svb16_key_length(count);
 #ifdef SVB16_X64
+    if (has_avx512_vbmi2()) {
+        return encode_avx512<Int16T, UseDelta, UseZigzag>(in, keys, data, count, prev) - out;
+    }
+    if (has_avx2()) {
+        return encode_avx2<Int16T, UseDelta, UseZigzag>(in, keys, data, count, prev) - out;
+    }
     if (has_ssse3()) {
         return encode_sse<Int16T, UseDelta, UseZigzag>(in, keys, data, count, prev) - out;
     }
+#endif
+#ifdef SVB16_NEON
+    return encode_neon<Int16T, UseDelta, UseZigzag>(in, keys, data, count, prev) - out;
 #endif
     return encode_scalar<Int16T, UseDelta, UseZigzag>(in, keys, data, count, prev) - out;
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "common.hpp"
+#include "encode_scalar.hpp"
+#include "shuffle_tables.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef SVB16_NEON
+
+#include <arm_neon.h>
+
+namespace svb16 {
+namespace detail {
+template <bool UseDelta, bool UseZigzag>
+inline uint16x8_t encode_transform_8(uint16x8_t loaded, uint16x8_t * prev)
+{
+    auto value = loaded;
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        // Subtract [P A B C D E F G] from [A B C D E F G H]:
+        value = vsubq_u16(loaded, vextq_u16(*prev, loaded, 7));
+        *prev = loaded;
+    }
+    SVB16_IF_CONSTEXPR(UseZigzag)
+    {
+        auto const sign_mask = vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(value), 15));
+        value = veorq_u16(vaddq_u16(value, value), sign_mask);
+    }
+    return value;
+}
+}  // namespace detail
+
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+uint8_t * encode_neon(
+    Int16T const * in,
+    uint8_t * SVB_RESTRICT keys_dest,
+    uint8_t * SVB_RESTRICT data_dest,
+    uint32_t count,
+    Int16T prev = 0)
+{
+    uint16_t const key_bit_values[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    auto const key_bits = vld1q_u16(key_bit_values);
+    auto const max_one_byte = vdupq_n_u16(0x00FF);
+
+    uint16x8_t prev_reg = vdupq_n_u16(static_cast<uint16_t>(prev));
+    for (Int16T const * end = &in[(count & ~7)]; in != end; in += 8) {
+        auto const loaded = vld1q_u16(reinterpret_cast<uint16_t const *>(in));
+        auto const value = detail::encode_transform_8<UseDelta, UseZigzag>(loaded, &prev_reg);
+
+        // 1 bit per value: 1 if the value needs two bytes
+        auto const key =
+            static_cast<uint8_t>(vaddvq_u16(vandq_u16(vcgtq_u16(value, max_one_byte), key_bits)));
+
+        // use the shuffle table to discard the MSB if the corresponding key bit is not set
+        auto const shuffle = vld1q_u8(&g_encode_shuffle_table[(key & 0x7F) << 4]);
+        auto const packed = vqtbl1q_u8(vreinterpretq_u8_u16(value), shuffle);
+
+        // store the data to data_dest (note that we often end up with overlapping writes)
+        vst1q_u8(data_dest, packed);
+        data_dest += 8 + svb16_popcount(key);
+        *keys_dest++ = key;
+    }
+
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        if (count >= 8) {
+            prev = in[-1];
+        }
+    }
+    count &= 7;
+    return encode_scalar<Int16T, UseDelta, UseZigzag>(in, keys_dest, data_dest, count, prev);
+}
+
+}  // namespace svb16
+
+#endif  // SVB16_NEON
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "common.hpp"
+#include "encode_scalar.hpp"
+#include "intrinsics.hpp"
+#include "shuffle_tables.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef SVB16_X64
+
+namespace svb16 {
+namespace detail {
+template <bool UseDelta, bool UseZigzag>
+[[gnu::target("avx2")]] inline __m256i encode_transform_16(__m256i loaded, __m256i * prev)
+{
+    auto value = loaded;
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        // Shift the previous values in by one element, crossing the 128 bit lanes:
+        auto const straddle = _mm256_permute2x128_si256(*prev, loaded, 0x21);
+        value = _mm256_sub_epi16(loaded, _mm256_alignr_epi8(loaded, straddle, 14));
+        *prev = loaded;
+    }
+    SVB16_IF_CONSTEXPR(UseZigzag)
+    {
+        value = _mm256_xor_si256(_mm256_add_epi16(value, value), _mm256_srai_epi16(value, 16));
+    }
+    return value;
+}
+
+template <bool UseDelta, bool UseZigzag>
+[[gnu::target("avx512f,avx512bw,avx512vbmi2,bmi2")]] inline __m512i encode_transform_32(
+    __m512i loaded,
+    __m512i * prev)
+{
+    auto value = loaded;
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        // Element 0 takes the last previous value, element i takes loaded element i - 1:
+        auto const shift_indices = _mm512_set_epi16(
+            62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47,
+            46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31);
+        value = _mm512_sub_epi16(loaded, _mm512_permutex2var_epi16(*prev, shift_indices, loaded));
+        *prev = loaded;
+    }
+    SVB16_IF_CONSTEXPR(UseZigzag)
+    {
+        value = _mm512_xor_si512(_mm512_add_epi16(value, value), _mm512_srai_epi16(value, 16));
+    }
+    return value;
+}
+}  // namespace detail
+
+/// Encode 16 values per step, using two encode shuffle table lookups per 256 bit register.
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+[[gnu::target("avx2")]] uint8_t * encode_avx2(
+    Int16T const * in,
+    uint8_t * SVB_RESTRICT keys_dest,
+    uint8_t * SVB_RESTRICT data_dest,
+    uint32_t count,
+    Int16T prev = 0)
+{
+    __m256i prev_reg = _mm256_set1_epi16(prev);
+    auto const max_one_byte = _mm256_set1_epi16(0x00FF);
+    for (Int16T const * end = &in[(count & ~15)]; in != end; in += 16) {
+        auto const loaded = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in));
+        auto const value = detail::encode_transform_16<UseDelta, UseZigzag>(loaded, &prev_reg);
+
+        // 0xFFFF per value which fits in one byte, packed to one byte per value within each lane:
+        auto const is_small =
+            _mm256_cmpeq_epi16(_mm256_max_epu16(value, max_one_byte), max_one_byte);
+        auto const small_mask =
+            static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_packs_epi16(is_small, is_small)));
+        auto const keys =
+            static_cast<uint16_t>(~((small_mask & 0x00FF) | ((small_mask >> 8) & 0xFF00)));
+
+        // use the shuffle table to discard the MSB if the corresponding key bit is not set
+        auto const shuffle = _mm256_set_m128i(
+            _mm_loadu_si128((__m128i const *)&g_encode_shuffle_table[(keys >> 4) & 0x07F0]),
+            _mm_loadu_si128((__m128i const *)&g_encode_shuffle_table[(keys << 4) & 0x07F0]));
+        auto const packed = _mm256_shuffle_epi8(value, shuffle);
+
+        // store the data to data_dest (note that we often end up with overlapping writes)
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data_dest), _mm256_castsi256_si128(packed));
+        data_dest += 8 + svb16_popcount(keys & 0xFF);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(data_dest), _mm256_extracti128_si256(packed, 1));
+        data_dest += 8 + svb16_popcount(keys >> 8);
+
+        std::memcpy(keys_dest, &keys, sizeof(keys));
+        keys_dest += sizeof(keys);
+    }
+
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        if (count >= 16) {
+            prev = in[-1];
+        }
+    }
+    count &= 15;
+    return encode_scalar<Int16T, UseDelta, UseZigzag>(in, keys_dest, data_dest, count, prev);
+}
+
+/// Encode 32 values per step, using a masked byte compress in place of shuffle tables.
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+[[gnu::target("avx512f,avx512bw,avx512vbmi2,bmi2")]] uint8_t * encode_avx512(
+    Int16T const * in,
+    uint8_t * SVB_RESTRICT keys_dest,
+    uint8_t * SVB_RESTRICT data_dest,
+    uint32_t count,
+    Int16T prev = 0)
+{
+    std::uint64_t const low_bytes = 0x5555555555555555;
+    std::uint64_t const high_bytes = 0xAAAAAAAAAAAAAAAA;
+
+    __m512i prev_reg = _mm512_set1_epi16(prev);
+    auto const max_one_byte = _mm512_set1_epi16(0x00FF);
+    for (Int16T const * end = &in[(count & ~31)]; in != end; in += 32) {
+        auto const loaded = _mm512_loadu_si512(reinterpret_cast<void const *>(in));
+        auto const value = detail::encode_transform_32<UseDelta, UseZigzag>(loaded, &prev_reg);
+
+        std::uint32_t const keys = _mm512_cmpgt_epu16_mask(value, max_one_byte);
+
+        // Keep every low byte, and the high bytes of values needing two bytes:
+        __mmask64 const byte_mask = low_bytes | _pdep_u64(keys, high_bytes);
+        _mm512_mask_compressstoreu_epi8(data_dest, byte_mask, value);
+        data_dest += 32 + svb16_popcount(keys);
+
+        std::memcpy(keys_dest, &keys, sizeof(keys));
+        keys_dest += sizeof(keys);
+    }
+
+    SVB16_IF_CONSTEXPR(UseDelta)
+    {
+        if (count >= 32) {
+            prev = in[-1];
+        }
+    }
+    count &= 31;
+    return encode_scalar<Int16T, UseDelta, UseZigzag>(in, keys_dest, data_dest, count, prev);
+}
+
+}  // namespace svb16
+
+#endif  // SVB16_X64
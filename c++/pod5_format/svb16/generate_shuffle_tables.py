@@ -49,7 +49,7 @@ if __name__ == "__main__":
     print('#include "common.hpp" // arch macros')
     print("#include <cstdint>")
     print()
-    print("#ifdef SVB16_X64")
+    print("#if defined(SVB16_X64) || defined(SVB16_NEON)")
     print_x64_encode_table()
     print_x64_decode_table()
     print("#endif")
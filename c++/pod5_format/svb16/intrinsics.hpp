@@ -6,7 +6,7 @@
 #include <intrin.h>
 #elif defined(__GNUC__) && defined(SVB16_X64)
 #include <x86intrin.h>
-#elif defined(__GNUC__) && defined(__ARM_NEON__)
+#elif defined(__GNUC__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
 #include <arm_neon.h>
 #endif
 
@@ -3,7 +3,7 @@
 
 #include <cstdint>
 
-#ifdef SVB16_X64
+#if defined(SVB16_X64) || defined(SVB16_NEON)
 static constexpr uint8_t g_encode_shuffle_table[128 * 16] = {
     0x00, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
     0x00, 0x01, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
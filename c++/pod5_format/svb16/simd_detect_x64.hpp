@@ -8,15 +8,6 @@
 #include <intrin.h>
 #endif
 
-// __AVX__ is documented for MSVC, but __SSE4_1__ isn't
-#if defined(__AVX__) || defined(__SSE4_1__)
-
-inline constexpr bool has_ssse3() { return true; }
-
-inline constexpr bool has_sse4_1() { return true; }
-
-#else
-
 struct CpuidResult {
     unsigned int eax;
     unsigned int ebx;
@@ -51,6 +42,27 @@ inline unsigned int cpuid_leaf1_ecx()
     return ecx;
 }
 
+// Find which register state the OS saves on context switch (XCR0).
+inline unsigned long long xgetbv0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    asm("xgetbv\n\t" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+// __AVX__ is documented for MSVC, but __SSE4_1__ isn't
+#if defined(__AVX__) || defined(__SSE4_1__)
+
+inline constexpr bool has_ssse3() { return true; }
+
+inline constexpr bool has_sse4_1() { return true; }
+
+#else
+
 #if defined(__SSSE3__)
 inline constexpr bool has_ssse3() { return true; }
 #else
@@ -60,4 +72,44 @@ inline bool has_ssse3() { return (cpuid_leaf1_ecx() & (1 << 9)) != 0; }
 inline bool has_sse4_1() { return (cpuid_leaf1_ecx() & (1 << 19)) != 0; }
 
 #endif  // defined(__SSE4_1__)
+
+#if defined(__AVX__) || defined(__SSE4_2__)
+inline constexpr bool has_sse4_2() { return true; }
+#else
+inline bool has_sse4_2() { return (cpuid_leaf1_ecx() & (1 << 20)) != 0; }
+#endif
+
+inline bool has_avx2()
+{
+    static bool const result = [] {
+        // AVX2 needs OSXSAVE, and the OS to save xmm/ymm state:
+        if ((cpuid_leaf1_ecx() & (1 << 27)) == 0 || (xgetbv0() & 0x6) != 0x6) {
+            return false;
+        }
+        if (cpuid(0, 0).eax < 7) {
+            return false;
+        }
+        return (cpuid(7, 0).ebx & (1 << 5)) != 0;
+    }();
+    return result;
+}
+
+// The AVX-512 kernels need F, BW, VBMI2 (byte expand/compress) and BMI2 (pdep).
+inline bool has_avx512_vbmi2()
+{
+    static bool const result = [] {
+        // Also needs the OS to save opmask and zmm state:
+        if (!has_avx2() || (xgetbv0() & 0xE6) != 0xE6) {
+            return false;
+        }
+        auto const leaf7 = cpuid(7, 0);
+        bool const avx512f = (leaf7.ebx & (1 << 16)) != 0;
+        bool const avx512bw = (leaf7.ebx & (1 << 30)) != 0;
+        bool const bmi2 = (leaf7.ebx & (1 << 8)) != 0;
+        bool const avx512vbmi2 = (leaf7.ecx & (1 << 6)) != 0;
+        return avx512f && avx512bw && bmi2 && avx512vbmi2;
+    }();
+    return result;
+}
+
 #endif  // defined(SVB16_X64)
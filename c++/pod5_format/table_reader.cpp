@@ -25,14 +25,51 @@ std::size_t TableRecordBatch::num_rows() const { return m_batch->num_rows(); }
 
 //---------------------------------------------------------------------------------------------------------------------
 
+TableBatchMigration::~TableBatchMigration() = default;
+
+Result<std::shared_ptr<arrow::RecordBatch>> migrate_batch(
+    TableBatchMigrations const & migrations,
+    std::shared_ptr<arrow::RecordBatch> batch)
+{
+    for (auto const & migration : migrations) {
+        ARROW_ASSIGN_OR_RAISE(batch, migration->migrate(batch));
+    }
+    return batch;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
 TableReader::TableReader(
     std::shared_ptr<void> && input_source,
     std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
     SchemaMetadataDescription && schema_metadata,
-    arrow::MemoryPool * pool)
+    arrow::MemoryPool * pool,
+    TableBatchMigrations && migrations)
 : m_input_source(std::move(input_source))
 , m_reader(std::move(reader))
+, m_schema(m_reader->schema())
+, m_num_record_batches(m_reader->num_record_batches())
 , m_schema_metadata(std::move(schema_metadata))
+, m_migrations(std::move(migrations))
+, m_batches_decoded(std::make_unique<std::atomic<std::uint64_t>>(0))
+{
+}
+
+TableReader::TableReader(
+    std::shared_ptr<void> && input_source,
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
+    std::shared_ptr<arrow::Schema> && schema,
+    std::size_t num_record_batches,
+    SchemaMetadataDescription && schema_metadata,
+    arrow::MemoryPool * pool,
+    TableBatchMigrations && migrations)
+: m_input_source(std::move(input_source))
+, m_reader(std::move(reader))
+, m_schema(std::move(schema))
+, m_num_record_batches(num_record_batches)
+, m_schema_metadata(std::move(schema_metadata))
+, m_migrations(std::move(migrations))
+, m_batches_decoded(std::make_unique<std::atomic<std::uint64_t>>(0))
 {
 }
 
@@ -40,6 +77,31 @@ TableReader::TableReader(TableReader &&) = default;
 TableReader & TableReader::operator=(TableReader &&) = default;
 TableReader::~TableReader() = default;
 
-std::size_t TableReader::num_record_batches() const { return m_reader->num_record_batches(); }
+std::size_t TableReader::num_record_batches() const { return m_num_record_batches; }
+
+std::shared_ptr<arrow::Schema> TableReader::schema() const
+{
+    if (!m_migrations.empty()) {
+        return m_migrations.back()->schema();
+    }
+    return m_schema;
+}
+
+Result<std::shared_ptr<arrow::RecordBatch>> TableReader::read_batch(
+    std::size_t i,
+    std::mutex & reader_mutex) const
+{
+    if (!m_reader) {
+        return Status::Invalid("Table opened without an ipc reader, can't read batch ", i);
+    }
+
+    std::shared_ptr<arrow::RecordBatch> batch;
+    {
+        std::lock_guard<std::mutex> l(reader_mutex);
+        ARROW_ASSIGN_OR_RAISE(batch, m_reader->ReadRecordBatch(i));
+    }
+    count_batch_decoded();
+    return migrate_batch(m_migrations, std::move(batch));
+}
 
 }  // namespace pod5
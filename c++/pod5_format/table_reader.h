@@ -3,11 +3,16 @@
 #include "pod5_format/pod5_format_export.h"
 #include "pod5_format/schema_metadata.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace arrow {
 class MemoryPool;
 class RecordBatch;
+class Schema;
 
 namespace ipc {
 class RecordBatchFileReader;
@@ -16,6 +21,18 @@ class RecordBatchFileReader;
 
 namespace pod5 {
 
+/// \brief Location of a record batch's message within an arrow ipc file.
+struct RecordBatchLocation {
+    std::int64_t offset;
+    std::int32_t metadata_length;
+    std::int64_t body_length;
+    /// The rows held by the batch, when known, 0 otherwise.
+    std::int64_t row_count = 0;
+
+    /// \brief Total size of the batch's message, metadata followed by body.
+    std::int64_t length() const { return metadata_length + body_length; }
+};
+
 class POD5_FORMAT_EXPORT TableRecordBatch {
 public:
     TableRecordBatch(std::shared_ptr<arrow::RecordBatch> const & batch);
@@ -35,13 +52,50 @@ private:
     std::shared_ptr<arrow::RecordBatch> m_batch;
 };
 
+/// \brief Adapts batches of a table written by an older version of the format to the next
+///        version's schema, as each batch is read.
+class POD5_FORMAT_EXPORT TableBatchMigration {
+public:
+    virtual ~TableBatchMigration();
+
+    /// \brief Find the schema of migrated batches.
+    virtual std::shared_ptr<arrow::Schema> const & schema() const = 0;
+
+    /// \brief Migrate [batch], in the previous version's schema.
+    virtual Result<std::shared_ptr<arrow::RecordBatch>> migrate(
+        std::shared_ptr<arrow::RecordBatch> const & batch) const = 0;
+};
+
+/// Migrations applied to a table's batches in order, each to the output of the last.
+using TableBatchMigrations = std::vector<std::shared_ptr<TableBatchMigration const>>;
+
+/// \brief Apply [migrations] to [batch] in order.
+POD5_FORMAT_EXPORT Result<std::shared_ptr<arrow::RecordBatch>> migrate_batch(
+    TableBatchMigrations const & migrations,
+    std::shared_ptr<arrow::RecordBatch> batch);
+
 class POD5_FORMAT_EXPORT TableReader {
 public:
+    /// \param migrations Applied to each batch read, when the table was written by an older
+    ///                   version of the format.
     TableReader(
         std::shared_ptr<void> && input_source,
         std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
         SchemaMetadataDescription && schema_metadata,
-        arrow::MemoryPool * pool);
+        arrow::MemoryPool * pool,
+        TableBatchMigrations && migrations = {});
+    /// \brief Open a table whose batches may be read without an ipc reader, as their locations
+    ///        are known.
+    /// \param reader Null if the table was opened without one, read_batch() is then Invalid.
+    /// \param schema The table's schema, before any migrations.
+    TableReader(
+        std::shared_ptr<void> && input_source,
+        std::shared_ptr<arrow::ipc::RecordBatchFileReader> && reader,
+        std::shared_ptr<arrow::Schema> && schema,
+        std::size_t num_record_batches,
+        SchemaMetadataDescription && schema_metadata,
+        arrow::MemoryPool * pool,
+        TableBatchMigrations && migrations = {});
     TableReader(TableReader &&);
     TableReader & operator=(TableReader &&);
     TableReader(TableReader const &) = delete;
@@ -52,12 +106,36 @@ public:
 
     std::size_t num_record_batches() const;
 
+    /// \brief Find the table's ipc reader, null if the table was opened without one.
     std::shared_ptr<arrow::ipc::RecordBatchFileReader> const & reader() const { return m_reader; }
 
+    /// \brief Find the table's schema, after any migrations.
+    std::shared_ptr<arrow::Schema> schema() const;
+
+    TableBatchMigrations const & migrations() const { return m_migrations; }
+
+    /// \brief Find the number of record batches decoded from the table since it was opened.
+    std::uint64_t batches_decoded() const { return m_batches_decoded->load(); }
+
+protected:
+    /// \brief Read batch [i], migrated to the current schema.
+    /// \note The ipc reader isn't thread safe, so the batch is read holding [reader_mutex]. It is
+    ///       migrated after the lock is released, so batches read concurrently migrate in parallel.
+    Result<std::shared_ptr<arrow::RecordBatch>> read_batch(
+        std::size_t i,
+        std::mutex & reader_mutex) const;
+
+    /// \brief Count a batch decoded other than by read_batch().
+    void count_batch_decoded() const { *m_batches_decoded += 1; }
+
 private:
     std::shared_ptr<void> m_input_source;
     std::shared_ptr<arrow::ipc::RecordBatchFileReader> m_reader;
+    std::shared_ptr<arrow::Schema> m_schema;
+    std::size_t m_num_record_batches;
     SchemaMetadataDescription m_schema_metadata;
+    TableBatchMigrations m_migrations;
+    std::unique_ptr<std::atomic<std::uint64_t>> m_batches_decoded;
 };
 
 }  // namespace pod5
@@ -1,32 +1,148 @@
 #include "pod5_format/thread_pool.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <cstdio>
 #include <deque>
+#include <fstream>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
-#include <stdexcept>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 namespace pod5 {
 
 namespace {
 
+// Pin the calling thread to [cpus], where supported, leaving it unpinned if [cpus] is empty or
+// none of them can be used.
+void set_current_thread_affinity(std::vector<unsigned> const & cpus)
+{
+#ifdef __linux__
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (auto const cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    // Only a hint: CPUs outside the process' own set are refused, and the thread runs anywhere.
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#else
+    (void)cpus;
+#endif
+}
+
+#ifdef __linux__
+// Parse a kernel CPU list, such as "0-3,8,10-11".
+std::vector<unsigned> parse_cpu_list(std::string const & cpu_list)
+{
+    std::vector<unsigned> cpus;
+    std::istringstream ranges(cpu_list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        unsigned first = 0;
+        unsigned last = 0;
+        auto const parsed = std::sscanf(range.c_str(), "%u-%u", &first, &last);
+        if (parsed < 1) {
+            continue;
+        }
+        if (parsed == 1) {
+            last = first;
+        }
+        for (auto cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+#endif
+
+// Identifies the pool and worker group of a pool's worker thread.
+struct CurrentWorker {
+    void const * pool = nullptr;
+    std::size_t worker_group = 0;
+};
+thread_local CurrentWorker t_current_worker;
+
+using Clock = std::chrono::steady_clock;
+
+// Find the bucket of a ThreadPoolStatistics time histogram counting [time].
+std::size_t time_histogram_bucket(Clock::duration time)
+{
+    std::size_t bucket = 0;
+    auto const micros = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+    while ((std::int64_t(1) << bucket) <= micros
+           && bucket < ThreadPoolStatistics::TIME_HISTOGRAM_BUCKETS - 1)
+    {
+        bucket += 1;
+    }
+    return bucket;
+}
+
 class ThreadPoolImpl : public ThreadPool, public std::enable_shared_from_this<ThreadPoolImpl> {
 public:
-    ThreadPoolImpl(std::size_t worker_count)
+    ThreadPoolImpl(ThreadPoolOptions const & options)
     {
-        assert(worker_count > 0);
-        for (std::size_t i = 0; i < std::max<std::size_t>(1, worker_count); ++i) {
-            m_threads.emplace_back([&] { run_thread(); });
+        assert(!options.worker_groups.empty());
+        for (std::size_t i = 0; i < std::max<std::size_t>(1, options.worker_groups.size()); ++i) {
+            m_groups.emplace_back(std::make_unique<WorkerGroup>());
+        }
+
+        auto const group_worker_threads = [&](std::size_t group) -> std::size_t {
+            if (group >= options.worker_groups.size()) {
+                return 1;
+            }
+            assert(options.worker_groups[group].worker_threads > 0);
+            return std::max<std::size_t>(1, options.worker_groups[group].worker_threads);
+        };
+        std::size_t worker_count = 0;
+        for (std::size_t group = 0; group < m_groups.size(); ++group) {
+            worker_count += group_worker_threads(group);
+        }
+        m_workers.resize(worker_count);
+
+        std::size_t worker = 0;
+        for (std::size_t group = 0; group < m_groups.size(); ++group) {
+            auto const cpus = group < options.worker_groups.size()
+                                  ? options.worker_groups[group].cpus
+                                  : std::vector<unsigned>{};
+            for (std::size_t i = 0; i < group_worker_threads(group); ++i, ++worker) {
+                m_threads.emplace_back([this, group, worker, cpus] {
+                    set_current_thread_affinity(cpus);
+                    t_current_worker = CurrentWorker{this, group};
+                    run_thread(group, worker);
+                });
+            }
         }
     }
 
     ~ThreadPoolImpl() { stop_and_drain(); }
 
-    void run_thread()
+    void run_thread(std::size_t const group, std::size_t const worker)
     {
         bool keep_alive = true;
         std::optional<WorkItem> work;
@@ -37,27 +153,32 @@ public:
 
                 if (work) {
                     if (work->strand_id != NO_STRAND) {
-                        m_busy_strands[work->strand_id] = false;
+                        finish_strand_work(work->strand_id);
                     }
                     work = std::nullopt;
+                    finish_running(worker);
                 }
 
-                // find the first piece of work whose strand isn't already busy
-                for (auto it = m_work.begin(); it != m_work.end(); ++it) {
-                    if (it->strand_id == NO_STRAND || !m_busy_strands.at(it->strand_id)) {
-                        if (it->strand_id != NO_STRAND) {
-                            m_busy_strands[it->strand_id] = true;
-                        }
-                        work = std::move(*it);
-                        m_work.erase(it);
-                        break;
-                    }
+                // Everything in the ready lists can run: strands are only listed while none of
+                // their work is running.
+                work = take_ready_work(group);
+                if (work) {
+                    start_running(worker, work->posted);
                 }
 
                 if (!work) {
                     if (m_keep_alive) {
-                        m_work_ready.wait(lock);
-                        keep_alive = m_keep_alive || !m_work.empty();
+                        auto & worker_group = *m_groups[group];
+                        worker_group.idle_workers += 1;
+                        worker_group.work_ready.wait(
+                            lock, [&] { return worker_group.pending_wakes > 0 || !m_keep_alive; });
+                        // A worker woken by wake_worker() was already taken off the idle count:
+                        if (worker_group.pending_wakes > 0) {
+                            worker_group.pending_wakes -= 1;
+                        } else {
+                            worker_group.idle_workers -= 1;
+                        }
+                        keep_alive = m_keep_alive || has_ready_work();
                     } else {
                         // If there wasn't any work for us to pick up, any remaining work must be
                         // for strands with running tasks (in which case the workers handling those
@@ -77,20 +198,45 @@ public:
         }
     }
 
-    void post(std::function<void()> callback) override
+    void post(ThreadPoolTask callback) override
     {
-        {
-            std::lock_guard<std::mutex> l{m_work_mutex};
-            if (!m_keep_alive) {
-                throw std::logic_error{"ThreadPool: post() called after stop_and_drain()"};
-            }
-            m_work.emplace_back(WorkItem{std::move(callback), NO_STRAND});
+        post_to_group(std::move(callback), default_group());
+    }
+
+    void post_to_group(ThreadPoolTask callback, std::size_t worker_group) override
+    {
+        worker_group %= m_groups.size();
+
+        std::lock_guard<std::mutex> l{m_work_mutex};
+        if (!m_keep_alive) {
+            throw std::logic_error{"ThreadPool: post() called after stop_and_drain()"};
         }
+        m_groups[worker_group]->ready.emplace_back(
+            WorkItem{std::move(callback), NO_STRAND, Clock::now()});
+        m_queued_tasks += 1;
+        // it's generally more efficient to wake a worker outside the lock, but the idle worker
+        // counts are only stable under it
+        wake_worker(worker_group);
+    }
+
+    void post_n(std::vector<ThreadPoolTask> callbacks) override
+    {
+        auto const worker_group = default_group();
 
-        m_work_ready.notify_one();
+        std::lock_guard<std::mutex> l{m_work_mutex};
+        if (!m_keep_alive) {
+            throw std::logic_error{"ThreadPool: post() called after stop_and_drain()"};
+        }
+        auto & ready = m_groups[worker_group]->ready;
+        auto const posted = Clock::now();
+        for (auto & callback : callbacks) {
+            ready.emplace_back(WorkItem{std::move(callback), NO_STRAND, posted});
+            wake_worker(worker_group);
+        }
+        m_queued_tasks += callbacks.size();
     }
 
-    void post(std::function<void()> callback, uint64_t const strand_id)
+    void post(ThreadPoolTask callback, uint64_t const strand_id, std::size_t worker_group)
     {
         assert(strand_id != NO_STRAND);
 
@@ -98,15 +244,18 @@ public:
         if (!m_keep_alive) {
             throw std::logic_error{"ThreadPool: post() called after stop_and_drain()"};
         }
-        if (m_busy_strands.size() <= strand_id) {
-            m_busy_strands.resize(strand_id + 1);
-        }
-        m_work.emplace_back(WorkItem{std::move(callback), strand_id});
 
-        // only send a wakeup if the strand isn't already busy - it's generally more efficient to do
-        // this outside the lock, but the conditional makes that hard to reason about
-        if (!m_busy_strands.at(strand_id)) {
-            m_work_ready.notify_one();
+        // A strand with queued or running work is already listed as ready or being run, and
+        // its worker lists it again once the running task finishes:
+        auto const strand_work = m_strand_work.try_emplace(strand_id);
+        strand_work.first->second.tasks.emplace_back(QueuedTask{std::move(callback), Clock::now()});
+        m_queued_tasks += 1;
+        if (strand_work.second) {
+            strand_work.first->second.worker_group = worker_group;
+            m_groups[worker_group]->ready.emplace_back(WorkItem{nullptr, strand_id, {}});
+            // it's generally more efficient to wake a worker outside the lock, but the
+            // conditional makes that hard to reason about
+            wake_worker(worker_group);
         }
     }
 
@@ -116,56 +265,240 @@ public:
             std::lock_guard<std::mutex> lock{m_work_mutex};
             m_keep_alive = false;
         }
-        m_work_ready.notify_all();
+        for (auto & group : m_groups) {
+            group->work_ready.notify_all();
+        }
         for (auto & thread : m_threads) {
             if (thread.joinable()) {
                 thread.join();
             }
         }
 
-        assert(m_work.empty());
+        assert(!has_ready_work());
+        assert(m_strand_work.empty());
     }
 
-    std::shared_ptr<ThreadPoolStrand> create_strand() override;
+    std::shared_ptr<ThreadPoolStrand> create_strand() override
+    {
+        return create_strand_in_group(default_group());
+    }
+
+    std::shared_ptr<ThreadPoolStrand> create_strand_in_group(std::size_t worker_group) override;
+
+    std::size_t worker_group_count() const override { return m_groups.size(); }
+
+    ThreadPoolStatistics statistics() const override
+    {
+        ThreadPoolStatistics result;
+        auto const now = Clock::now();
+
+        std::lock_guard<std::mutex> l{m_work_mutex};
+        result.queued_tasks = m_queued_tasks;
+        result.running_tasks = m_running_tasks;
+        result.tasks_run = m_tasks_run;
+        for (auto const & strand_work : m_strand_work) {
+            if (!strand_work.second.tasks.empty()) {
+                result.strand_queued_tasks.push_back(strand_work.second.tasks.size());
+            }
+        }
+        std::sort(
+            result.strand_queued_tasks.begin(),
+            result.strand_queued_tasks.end(),
+            std::greater<>{});
+        result.wait_time_histogram.assign(
+            m_wait_time_histogram.begin(), m_wait_time_histogram.end());
+        result.run_time_histogram.assign(m_run_time_histogram.begin(), m_run_time_histogram.end());
+
+        for (auto const & worker : m_workers) {
+            auto busy = worker.busy;
+            if (worker.running_since) {
+                busy += now - *worker.running_since;
+            }
+            auto const lifetime = now - worker.started;
+            result.worker_busy_ratios.push_back(
+                lifetime.count() > 0 ? std::chrono::duration<double>(busy).count()
+                                           / std::chrono::duration<double>(lifetime).count()
+                                     : 0.0);
+        }
+        return result;
+    }
 
 private:
     struct WorkItem {
-        std::function<void()> callback;
+        ThreadPoolTask callback;
         uint64_t strand_id;
+        // When [callback] was posted, for tasks not on a strand:
+        Clock::time_point posted;
 
         explicit operator bool() const { return !!callback; }
     };
 
+    struct QueuedTask {
+        ThreadPoolTask callback;
+        Clock::time_point posted;
+    };
+
+    // Work run by each worker, updated with the work mutex held as it starts and finishes tasks.
+    struct WorkerStatistics {
+        Clock::time_point started = Clock::now();
+        Clock::duration busy{0};
+        std::optional<Clock::time_point> running_since;
+    };
+
+    struct WorkerGroup {
+        // Work which can run now, in the order it became runnable: tasks posted to the group, and
+        // the group's strands with queued work and no task running.
+        std::deque<WorkItem> ready;
+        std::condition_variable work_ready;
+        // Workers waiting for work and not yet woken, and wakes not yet picked up by a worker.
+        std::size_t idle_workers = 0;
+        std::size_t pending_wakes = 0;
+    };
+
+    struct StrandWork {
+        // Queued tasks, in the order they were posted.
+        std::deque<QueuedTask> tasks;
+        std::size_t worker_group = 0;
+    };
+
     static constexpr uint64_t NO_STRAND = UINT64_MAX;
 
-    std::mutex m_work_mutex;
+    // Work posted without a group stays in the group of the worker posting it, and is spread
+    // over the groups when posted from other threads.
+    std::size_t default_group()
+    {
+        if (t_current_worker.pool == this) {
+            return t_current_worker.worker_group;
+        }
+        return m_next_default_group++ % m_groups.size();
+    }
+
+    // Called with the work mutex held, waking an idle worker of [group], or of any other group
+    // if all of [group]'s workers are busy or already woken. The woken worker stops counting as
+    // idle straight away, so each call for a batch of work wakes a different worker.
+    void wake_worker(std::size_t group)
+    {
+        for (std::size_t i = 0; i < m_groups.size(); ++i) {
+            auto & worker_group = *m_groups[(group + i) % m_groups.size()];
+            if (worker_group.idle_workers > 0) {
+                worker_group.idle_workers -= 1;
+                worker_group.pending_wakes += 1;
+                worker_group.work_ready.notify_one();
+                return;
+            }
+        }
+    }
+
+    // Called with the work mutex held, taking the next work ready in [group], or in the other
+    // groups if [group] has none, so idle workers never leave work waiting.
+    std::optional<WorkItem> take_ready_work(std::size_t group)
+    {
+        for (std::size_t i = 0; i < m_groups.size(); ++i) {
+            auto & ready = m_groups[(group + i) % m_groups.size()]->ready;
+            if (ready.empty()) {
+                continue;
+            }
+
+            auto work = std::move(ready.front());
+            ready.pop_front();
+            if (work.strand_id != NO_STRAND) {
+                auto & strand_work = m_strand_work.at(work.strand_id).tasks;
+                work.callback = std::move(strand_work.front().callback);
+                work.posted = strand_work.front().posted;
+                strand_work.pop_front();
+            }
+            m_queued_tasks -= 1;
+            return work;
+        }
+        return std::nullopt;
+    }
+
+    // Called with the work mutex held as [worker] starts a task posted at [posted].
+    void start_running(std::size_t worker, Clock::time_point posted)
+    {
+        auto const now = Clock::now();
+        m_wait_time_histogram[time_histogram_bucket(now - posted)] += 1;
+        m_workers[worker].running_since = now;
+        m_running_tasks += 1;
+    }
+
+    // Called with the work mutex held as [worker] finishes its task.
+    void finish_running(std::size_t worker)
+    {
+        auto & statistics = m_workers[worker];
+        auto const run_time = Clock::now() - *statistics.running_since;
+        statistics.running_since.reset();
+        statistics.busy += run_time;
+        m_run_time_histogram[time_histogram_bucket(run_time)] += 1;
+        m_running_tasks -= 1;
+        m_tasks_run += 1;
+    }
+
+    bool has_ready_work() const
+    {
+        return std::any_of(m_groups.begin(), m_groups.end(), [](auto const & group) {
+            return !group->ready.empty();
+        });
+    }
+
+    // Called with the work mutex held once a task of [strand_id] finishes, listing the strand as
+    // ready again if it has more work, or forgetting it until more is posted.
+    void finish_strand_work(uint64_t strand_id)
+    {
+        auto const strand_work = m_strand_work.find(strand_id);
+        assert(strand_work != m_strand_work.end());
+        if (strand_work->second.tasks.empty()) {
+            m_strand_work.erase(strand_work);
+            return;
+        }
+        // Queued behind other ready work, so busy strands don't starve others:
+        auto const group = strand_work->second.worker_group;
+        m_groups[group]->ready.emplace_back(WorkItem{nullptr, strand_id, {}});
+        wake_worker(group);
+    }
+
+    mutable std::mutex m_work_mutex;
     bool m_keep_alive{true};
-    std::condition_variable m_work_ready;
-    std::deque<WorkItem> m_work;
-    std::vector<bool> m_busy_strands;
+    std::vector<std::unique_ptr<WorkerGroup>> m_groups;
+
+    // Statistics, see ThreadPoolStatistics:
+    std::vector<WorkerStatistics> m_workers;
+    std::size_t m_queued_tasks{0};
+    std::size_t m_running_tasks{0};
+    std::uint64_t m_tasks_run{0};
+    std::array<std::uint64_t, ThreadPoolStatistics::TIME_HISTOGRAM_BUCKETS> m_wait_time_histogram{};
+    std::array<std::uint64_t, ThreadPoolStatistics::TIME_HISTOGRAM_BUCKETS> m_run_time_histogram{};
+    // Queued tasks of each strand listed as ready or with a task running.
+    std::unordered_map<uint64_t, StrandWork> m_strand_work;
 
     std::atomic<uint64_t> m_next_strand_id{0};
+    std::atomic<std::size_t> m_next_default_group{0};
     std::vector<std::thread> m_threads;
 };
 
 class StrandImpl : public ThreadPoolStrand {
 public:
-    StrandImpl(std::shared_ptr<ThreadPoolImpl> pool, uint64_t const strand_id)
+    StrandImpl(
+        std::shared_ptr<ThreadPoolImpl> pool,
+        uint64_t const strand_id,
+        std::size_t const worker_group)
     : m_pool(std::move(pool))
     , m_strand_id(strand_id)
+    , m_worker_group(worker_group)
     {
     }
 
-    void post(std::function<void()> callback) override
+    void post(ThreadPoolTask callback) override
     {
-        m_pool->post(std::move(callback), m_strand_id);
+        m_pool->post(std::move(callback), m_strand_id, m_worker_group);
     }
 
     std::shared_ptr<ThreadPoolImpl> m_pool;
     uint64_t m_strand_id;
+    std::size_t m_worker_group;
 };
 
-std::shared_ptr<ThreadPoolStrand> ThreadPoolImpl::create_strand()
+std::shared_ptr<ThreadPoolStrand> ThreadPoolImpl::create_strand_in_group(std::size_t worker_group)
 {
     uint64_t strand_id;
     {
@@ -175,13 +508,531 @@ std::shared_ptr<ThreadPoolStrand> ThreadPoolImpl::create_strand()
         }
         strand_id = m_next_strand_id++;
     }
-    return std::make_shared<StrandImpl>(shared_from_this(), strand_id);
+    return std::make_shared<StrandImpl>(
+        shared_from_this(), strand_id, worker_group % m_groups.size());
+}
+
+// Chase-Lev work stealing deque of tasks: the owning worker pushes and pops at the bottom without
+// locking, while other workers steal from the top.
+class WorkStealingDeque {
+public:
+    using Task = ThreadPoolTask;
+
+    WorkStealingDeque() : m_array(new TaskArray(INITIAL_CAPACITY))
+    {
+        m_arrays.emplace_back(m_array.load(std::memory_order_relaxed));
+    }
+
+    WorkStealingDeque(WorkStealingDeque const &) = delete;
+    WorkStealingDeque & operator=(WorkStealingDeque const &) = delete;
+
+    ~WorkStealingDeque()
+    {
+        while (auto task = pop()) {
+            delete task;
+        }
+    }
+
+    // Only called by the owning worker.
+    void push(Task * task)
+    {
+        auto const bottom = m_bottom.load(std::memory_order_relaxed);
+        auto const top = m_top.load(std::memory_order_acquire);
+        auto array = m_array.load(std::memory_order_relaxed);
+        if (bottom - top > std::int64_t(array->capacity) - 1) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Only called by the owning worker, taking the most recently pushed task.
+    Task * pop()
+    {
+        auto const bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        auto const array = m_array.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto task = array->get(bottom);
+        if (top == bottom) {
+            // The last task, which a thief may be taking too:
+            if (!m_top.compare_exchange_strong(
+                    top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                task = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Called by any thread, taking the least recently pushed task.
+    Task * steal()
+    {
+        auto top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto const bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        auto const array = m_array.load(std::memory_order_acquire);
+        auto task = array->get(top);
+        if (!m_top.compare_exchange_strong(
+                top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            // Lost the race with the owner or another thief:
+            return nullptr;
+        }
+        return task;
+    }
+
+    bool maybe_empty() const
+    {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t INITIAL_CAPACITY = 256;
+
+    struct TaskArray {
+        explicit TaskArray(std::size_t _capacity)
+        : capacity(_capacity)
+        , tasks(new std::atomic<Task *>[_capacity])
+        {
+        }
+
+        Task * get(std::int64_t index) const
+        {
+            return tasks[std::size_t(index) & (capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t index, Task * task)
+        {
+            tasks[std::size_t(index) & (capacity - 1)].store(task, std::memory_order_relaxed);
+        }
+
+        std::size_t const capacity;
+        std::unique_ptr<std::atomic<Task *>[]> tasks;
+    };
+
+    TaskArray * grow(TaskArray * array, std::int64_t top, std::int64_t bottom)
+    {
+        auto bigger = std::make_unique<TaskArray>(array->capacity * 2);
+        for (auto i = top; i < bottom; ++i) {
+            bigger->put(i, array->get(i));
+        }
+        // Thieves may still be reading the old array, so it's kept until the deque is destroyed:
+        m_arrays.push_back(std::move(bigger));
+        auto result = m_arrays.back().get();
+        m_array.store(result, std::memory_order_release);
+        return result;
+    }
+
+    std::atomic<std::int64_t> m_top{0};
+    std::atomic<std::int64_t> m_bottom{0};
+    std::atomic<TaskArray *> m_array;
+    std::vector<std::unique_ptr<TaskArray>> m_arrays;
+};
+
+class WorkStealingThreadPool : public ThreadPool,
+                               public std::enable_shared_from_this<WorkStealingThreadPool> {
+public:
+    WorkStealingThreadPool(std::size_t worker_count)
+    {
+        assert(worker_count > 0);
+        worker_count = std::max<std::size_t>(1, worker_count);
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            m_workers.emplace_back(std::make_unique<Worker>());
+        }
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            m_threads.emplace_back([this, i] { run_thread(i); });
+        }
+    }
+
+    ~WorkStealingThreadPool() { stop_and_drain(); }
+
+    void post(ThreadPoolTask callback) override
+    {
+        if (m_stopping.load()) {
+            throw std::logic_error{"ThreadPool: post() called after stop_and_drain()"};
+        }
+        submit(std::move(callback));
+    }
+
+    void post_n(std::vector<ThreadPoolTask> callbacks) override
+    {
+        if (m_stopping.load()) {
+            throw std::logic_error{"ThreadPool: post() called after stop_and_drain()"};
+        }
+        for (auto & callback : callbacks) {
+            enqueue(std::move(callback));
+        }
+        wake_workers(callbacks.size());
+    }
+
+    std::shared_ptr<ThreadPoolStrand> create_strand() override;
+
+    void stop_and_drain() override
+    {
+        {
+            std::lock_guard<std::mutex> l{m_sleep_mutex};
+            m_stopping = true;
+        }
+        m_work_ready.notify_all();
+        for (auto & thread : m_threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+
+        assert(m_pending == 0);
+    }
+
+    void check_running() const
+    {
+        if (m_stopping.load()) {
+            throw std::logic_error{"ThreadPool: post() called after stop_and_drain()"};
+        }
+    }
+
+    // Queue [callback] to run, even while the pool is draining.
+    void submit(ThreadPoolTask callback)
+    {
+        enqueue(std::move(callback));
+        wake_workers(1);
+    }
+
+private:
+    void enqueue(ThreadPoolTask callback)
+    {
+        m_pending += 1;
+        auto task = new WorkStealingDeque::Task(std::move(callback));
+
+        // Workers keep work they post themselves, where other workers can steal it:
+        if (t_current_pool == this) {
+            m_workers[t_current_worker]->deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> l{m_injected_mutex};
+            m_injected.push_back(task);
+            m_has_injected = true;
+        }
+    }
+
+    // Wake sleeping workers for [task_count] newly queued tasks.
+    void wake_workers(std::size_t task_count)
+    {
+        // Sleeping workers recheck the epoch before waiting, so either see this work or are woken:
+        m_work_epoch.fetch_add(1);
+        if (m_sleeping.load() > 0) {
+            std::lock_guard<std::mutex> l{m_sleep_mutex};
+            if (task_count == 1) {
+                m_work_ready.notify_one();
+            } else {
+                m_work_ready.notify_all();
+            }
+        }
+    }
+
+    struct Worker {
+        WorkStealingDeque deque;
+    };
+
+    // Times an idle worker looks for work before sleeping:
+    static constexpr int IDLE_SPINS = 64;
+
+    void run_thread(std::size_t index)
+    {
+        t_current_pool = this;
+        t_current_worker = index;
+
+        int idle_spins = 0;
+        while (true) {
+            auto const epoch = m_work_epoch.load();
+            if (auto task = find_task(index)) {
+                idle_spins = 0;
+                (*task)();
+                delete task;
+                if (m_pending.fetch_sub(1) == 1 && m_stopping.load()) {
+                    std::lock_guard<std::mutex> l{m_sleep_mutex};
+                    m_work_ready.notify_all();
+                }
+                continue;
+            }
+
+            if (m_stopping.load() && m_pending.load() == 0) {
+                break;
+            }
+
+            if (++idle_spins < IDLE_SPINS) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> l{m_sleep_mutex};
+            m_sleeping += 1;
+            m_work_ready.wait(l, [&] {
+                return m_work_epoch.load() != epoch || (m_stopping && m_pending.load() == 0);
+            });
+            m_sleeping -= 1;
+            idle_spins = 0;
+        }
+
+        t_current_pool = nullptr;
+    }
+
+    WorkStealingDeque::Task * find_task(std::size_t index)
+    {
+        if (auto task = m_workers[index]->deque.pop()) {
+            return task;
+        }
+
+        if (m_has_injected.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> l{m_injected_mutex};
+            if (!m_injected.empty()) {
+                auto task = m_injected.front();
+                m_injected.pop_front();
+                m_has_injected = !m_injected.empty();
+                return task;
+            }
+        }
+
+        // Steal from the other workers, starting with the next so thieves spread out:
+        for (std::size_t i = 1; i < m_workers.size(); ++i) {
+            auto & victim = m_workers[(index + i) % m_workers.size()]->deque;
+            if (victim.maybe_empty()) {
+                continue;
+            }
+            if (auto task = victim.steal()) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    static thread_local WorkStealingThreadPool * t_current_pool;
+    static thread_local std::size_t t_current_worker;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_injected_mutex;
+    std::deque<WorkStealingDeque::Task *> m_injected;
+    std::atomic<bool> m_has_injected{false};
+
+    // Tasks submitted and not yet finished.
+    std::atomic<std::size_t> m_pending{0};
+    std::atomic<bool> m_stopping{false};
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_work_ready;
+    std::atomic<std::size_t> m_sleeping{0};
+    std::atomic<std::uint64_t> m_work_epoch{0};
+
+    std::vector<std::thread> m_threads;
+};
+
+thread_local WorkStealingThreadPool * WorkStealingThreadPool::t_current_pool = nullptr;
+thread_local std::size_t WorkStealingThreadPool::t_current_worker = 0;
+
+// Runs one task at a time, in the order posted, by submitting the strand's next task to the
+// pool once the previous one finishes.
+class WorkStealingStrand : public ThreadPoolStrand {
+public:
+    WorkStealingStrand(std::shared_ptr<WorkStealingThreadPool> pool)
+    : m_pool(std::move(pool))
+    , m_queue(std::make_shared<Queue>())
+    {
+    }
+
+    void post(ThreadPoolTask callback) override
+    {
+        m_pool->check_running();
+        {
+            std::lock_guard<std::mutex> l{m_queue->mutex};
+            m_queue->tasks.emplace_back(std::move(callback));
+            if (m_queue->scheduled) {
+                return;
+            }
+            m_queue->scheduled = true;
+        }
+        submit_next(m_pool.get(), m_queue);
+    }
+
+private:
+    // Tasks of the strand, kept alive by its submitted task rather than the strand, so the last
+    // reference to the pool is never dropped on one of its own threads.
+    struct Queue {
+        std::mutex mutex;
+        std::deque<ThreadPoolTask> tasks;
+        // Set while a task of the strand is submitted to the pool or running.
+        bool scheduled = false;
+    };
+
+    // The pool outlives this, as it waits for submitted tasks before stopping.
+    static void submit_next(WorkStealingThreadPool * pool, std::shared_ptr<Queue> queue)
+    {
+        pool->submit([pool, queue = std::move(queue)] { run_next(pool, queue); });
+    }
+
+    static void run_next(WorkStealingThreadPool * pool, std::shared_ptr<Queue> const & queue)
+    {
+        ThreadPoolTask task;
+        {
+            std::lock_guard<std::mutex> l{queue->mutex};
+            task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> l{queue->mutex};
+            if (queue->tasks.empty()) {
+                queue->scheduled = false;
+                return;
+            }
+        }
+        submit_next(pool, queue);
+    }
+
+    std::shared_ptr<WorkStealingThreadPool> m_pool;
+    std::shared_ptr<Queue> m_queue;
+};
+
+std::shared_ptr<ThreadPoolStrand> WorkStealingThreadPool::create_strand()
+{
+    if (m_stopping.load()) {
+        throw std::logic_error{"ThreadPool: create_strand() called after stop_and_drain()"};
+    }
+    return std::make_shared<WorkStealingStrand>(shared_from_this());
 }
 }  // namespace
 
 std::shared_ptr<ThreadPool> make_thread_pool(std::size_t worker_threads)
 {
-    return std::make_shared<ThreadPoolImpl>(worker_threads);
+    ThreadPoolOptions options;
+    options.worker_groups.push_back({worker_threads, {}, -1});
+    return make_thread_pool(options);
+}
+
+std::shared_ptr<ThreadPool> make_thread_pool(ThreadPoolOptions const & options)
+{
+    return std::make_shared<ThreadPoolImpl>(options);
+}
+
+std::shared_ptr<ThreadPool> process_thread_pool()
+{
+    static std::mutex mutex;
+    static std::shared_ptr<ThreadPool> thread_pool;
+#ifndef _WIN32
+    static pid_t pool_process = 0;
+#endif
+
+    std::lock_guard<std::mutex> l(mutex);
+#ifndef _WIN32
+    if (thread_pool && pool_process != getpid()) {
+        // Made before a fork, so its workers only exist in the parent. Joining them here would
+        // never return, so the pool is leaked:
+        (void)new std::shared_ptr<ThreadPool>(std::move(thread_pool));
+        thread_pool = nullptr;
+    }
+    pool_process = getpid();
+#endif
+    if (!thread_pool) {
+        thread_pool = make_thread_pool(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    return thread_pool;
+}
+
+ThreadPoolOptions numa_thread_pool_options(std::size_t worker_threads)
+{
+    worker_threads = std::max<std::size_t>(1, worker_threads);
+
+    ThreadPoolOptions options;
+#ifdef __linux__
+    cpu_set_t allowed_cpus;
+    CPU_ZERO(&allowed_cpus);
+    auto const have_allowed_cpus = sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) == 0;
+
+    // The CPUs of each node this process may run on:
+    std::vector<ThreadPoolWorkerGroup> nodes;
+    std::size_t cpu_count = 0;
+    if (auto node_dir = opendir("/sys/devices/system/node")) {
+        while (auto entry = readdir(node_dir)) {
+            int node = -1;
+            char trailing = 0;
+            if (std::sscanf(entry->d_name, "node%d%c", &node, &trailing) != 1) {
+                continue;
+            }
+
+            std::ifstream cpu_list_file(
+                std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist");
+            std::string cpu_list;
+            std::getline(cpu_list_file, cpu_list);
+
+            ThreadPoolWorkerGroup group{0, {}, node};
+            for (auto const cpu : parse_cpu_list(cpu_list)) {
+                if (!have_allowed_cpus || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed_cpus))) {
+                    group.cpus.push_back(cpu);
+                }
+            }
+            if (!group.cpus.empty()) {
+                cpu_count += group.cpus.size();
+                nodes.push_back(std::move(group));
+            }
+        }
+        closedir(node_dir);
+    }
+    std::sort(nodes.begin(), nodes.end(), [](auto const & lhs, auto const & rhs) {
+        return lhs.numa_node < rhs.numa_node;
+    });
+
+    if (nodes.size() > 1) {
+        // Workers are shared out by each node's CPU count, the largest nodes taking any left over:
+        std::size_t assigned_workers = 0;
+        for (auto & node : nodes) {
+            node.worker_threads = worker_threads * node.cpus.size() / cpu_count;
+            assigned_workers += node.worker_threads;
+        }
+        std::vector<std::size_t> order(nodes.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return nodes[lhs].cpus.size() > nodes[rhs].cpus.size();
+        });
+        for (std::size_t i = 0; assigned_workers < worker_threads; ++i) {
+            nodes[order[i % order.size()]].worker_threads += 1;
+            assigned_workers += 1;
+        }
+
+        for (auto & node : nodes) {
+            if (node.worker_threads > 0) {
+                options.worker_groups.push_back(std::move(node));
+            }
+        }
+    }
+#endif
+
+    // Machines with one node, or whose nodes can't be found, have one unpinned group:
+    if (options.worker_groups.size() < 2) {
+        options.worker_groups.clear();
+        options.worker_groups.push_back({worker_threads, {}, -1});
+    }
+    return options;
+}
+
+std::shared_ptr<ThreadPool> make_work_stealing_thread_pool(std::size_t worker_threads)
+{
+    return std::make_shared<WorkStealingThreadPool>(worker_threads);
 }
 
 }  // namespace pod5
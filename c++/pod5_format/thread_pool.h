@@ -2,28 +2,248 @@
 
 #include "pod5_format/pod5_format_export.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace pod5 {
 
+/// \brief A move only callable posted to a thread pool, holding callables of up to
+///        INLINE_SIZE bytes without allocating.
+///
+/// Unlike std::function, move only callables can be posted, and the inline storage fits a
+/// lambda capturing a couple of shared pointers and [this].
+class ThreadPoolTask {
+public:
+    static constexpr std::size_t INLINE_SIZE = 6 * sizeof(void *);
+
+    ThreadPoolTask() noexcept = default;
+    ThreadPoolTask(std::nullptr_t) noexcept {}
+
+    template <
+        typename Callable,
+        typename Decayed = std::decay_t<Callable>,
+        typename = std::enable_if_t<
+            !std::is_same<Decayed, ThreadPoolTask>::value
+            && std::is_invocable<Decayed &>::value>>
+    ThreadPoolTask(Callable && callable)
+    {
+        if (is_null(callable)) {
+            return;
+        }
+        if constexpr (fits_inline<Decayed>()) {
+            new (&m_storage) Decayed(std::forward<Callable>(callable));
+            m_ops = &INLINE_OPS<Decayed>;
+        } else {
+            *reinterpret_cast<Decayed **>(&m_storage) =
+                new Decayed(std::forward<Callable>(callable));
+            m_ops = &HEAP_OPS<Decayed>;
+        }
+    }
+
+    ThreadPoolTask(ThreadPoolTask && other) noexcept { take(other); }
+
+    ThreadPoolTask & operator=(ThreadPoolTask && other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    ThreadPoolTask(ThreadPoolTask const &) = delete;
+    ThreadPoolTask & operator=(ThreadPoolTask const &) = delete;
+
+    ~ThreadPoolTask() { reset(); }
+
+    explicit operator bool() const { return m_ops != nullptr; }
+
+    void operator()() { m_ops->invoke(&m_storage); }
+
+private:
+    struct Ops {
+        void (*invoke)(void * storage);
+        // Move the callable in [from] to [to], leaving [from] empty:
+        void (*move)(void * to, void * from) noexcept;
+        void (*destroy)(void * storage) noexcept;
+    };
+
+    template <typename Callable>
+    static constexpr bool fits_inline()
+    {
+        return sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t)
+               && std::is_nothrow_move_constructible<Callable>::value;
+    }
+
+    // Null function pointers and empty std::functions make empty tasks:
+    template <typename Callable>
+    static bool is_null(Callable const & callable)
+    {
+        if constexpr (std::is_constructible<bool, Callable const &>::value) {
+            return !static_cast<bool>(callable);
+        } else {
+            return false;
+        }
+    }
+
+    template <typename Callable>
+    static constexpr Ops INLINE_OPS{
+        [](void * storage) { (*static_cast<Callable *>(storage))(); },
+        [](void * to, void * from) noexcept {
+            new (to) Callable(std::move(*static_cast<Callable *>(from)));
+            static_cast<Callable *>(from)->~Callable();
+        },
+        [](void * storage) noexcept { static_cast<Callable *>(storage)->~Callable(); },
+    };
+
+    template <typename Callable>
+    static constexpr Ops HEAP_OPS{
+        [](void * storage) { (**static_cast<Callable **>(storage))(); },
+        [](void * to, void * from) noexcept {
+            *static_cast<Callable **>(to) = *static_cast<Callable **>(from);
+        },
+        [](void * storage) noexcept { delete *static_cast<Callable **>(storage); },
+    };
+
+    void take(ThreadPoolTask & other) noexcept
+    {
+        if (other.m_ops) {
+            other.m_ops->move(&m_storage, &other.m_storage);
+            m_ops = std::exchange(other.m_ops, nullptr);
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (m_ops) {
+            std::exchange(m_ops, nullptr)->destroy(&m_storage);
+        }
+    }
+
+    std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)> m_storage;
+    Ops const * m_ops = nullptr;
+};
+
+/// \brief A snapshot of the work queued and run on a thread pool, see ThreadPool::statistics().
+struct ThreadPoolStatistics {
+    static constexpr std::size_t TIME_HISTOGRAM_BUCKETS = 24;
+
+    /// Tasks posted and not yet started, including those queued on strands.
+    std::size_t queued_tasks = 0;
+    /// Tasks running now.
+    std::size_t running_tasks = 0;
+    /// Tasks queued on each strand with queued tasks, largest first.
+    std::vector<std::size_t> strand_queued_tasks;
+    /// Tasks run to completion.
+    std::uint64_t tasks_run = 0;
+    /// Tasks by the time from being posted to starting, and by the time taken to run: [0] under
+    /// 1us, [1] under 2us, [2] under 4us... the last bucket holding every longer task.
+    std::vector<std::uint64_t> wait_time_histogram;
+    std::vector<std::uint64_t> run_time_histogram;
+    /// The fraction of the time since each worker started that it has spent running tasks.
+    std::vector<double> worker_busy_ratios;
+};
+
 class POD5_FORMAT_EXPORT ThreadPoolStrand {
 public:
     virtual ~ThreadPoolStrand() = default;
-    virtual void post(std::function<void()> callback) = 0;
+    virtual void post(ThreadPoolTask callback) = 0;
 };
 
 class POD5_FORMAT_EXPORT ThreadPool {
 public:
     virtual ~ThreadPool() = default;
     virtual std::shared_ptr<ThreadPoolStrand> create_strand() = 0;
-    virtual void post(std::function<void()> callback) = 0;
+    virtual void post(ThreadPoolTask callback) = 0;
+
+    /// \brief Post every task in [callbacks], as one call to post() for each, but taking the
+    ///        pool's lock and waking workers once for all of them.
+    virtual void post_n(std::vector<ThreadPoolTask> callbacks)
+    {
+        for (auto & callback : callbacks) {
+            post(std::move(callback));
+        }
+    }
+
     /// Stops the thread pool and drains all active work.
     ///
     /// Further calls to create_strand() or post() (including on an existing strand created from
     /// this pool) will throw.
     virtual void stop_and_drain() = 0;
+
+    /// \brief Find the work queued and run on the pool so far, to see if it is saturated.
+    ///
+    /// Pools which don't keep statistics return an empty snapshot.
+    virtual ThreadPoolStatistics statistics() const { return {}; }
+
+    /// Find the number of worker groups in the pool, see ThreadPoolOptions.
+    virtual std::size_t worker_group_count() const { return 1; }
+
+    /// \brief Post [callback] to run on a worker of [worker_group], so work touching memory
+    ///        local to the group's NUMA node runs on that node.
+    ///
+    /// Idle workers of other groups still take the work rather than leave it waiting.
+    virtual void post_to_group(ThreadPoolTask callback, std::size_t worker_group)
+    {
+        (void)worker_group;
+        post(std::move(callback));
+    }
+
+    /// Create a strand whose tasks prefer workers of [worker_group], as post_to_group().
+    virtual std::shared_ptr<ThreadPoolStrand> create_strand_in_group(std::size_t worker_group)
+    {
+        (void)worker_group;
+        return create_strand();
+    }
+};
+
+/// \brief Workers of a thread pool sharing a set of CPUs, such as those of one NUMA node.
+struct ThreadPoolWorkerGroup {
+    std::size_t worker_threads = 1;
+    /// The CPUs the group's workers are pinned to, or empty to leave them unpinned.
+    /// \note Pinning is a hint, ignored where unsupported or where the CPUs can't be used.
+    std::vector<unsigned> cpus;
+    /// The NUMA node local to [cpus], or -1 if unknown.
+    int numa_node = -1;
+};
+
+struct ThreadPoolOptions {
+    /// The pool's groups of workers, work posted without a group is spread over the groups.
+    std::vector<ThreadPoolWorkerGroup> worker_groups;
 };
 
 POD5_FORMAT_EXPORT std::shared_ptr<ThreadPool> make_thread_pool(std::size_t worker_threads);
+
+/// \brief Find the pool, with a thread per core, shared by callers spreading work across threads.
+///
+/// The pool is made on first use. A child process forked after that gets a new pool on its first
+/// use, as the parent's workers don't exist in the child; the parent's pool is never destroyed
+/// there, so references to it stay valid.
+POD5_FORMAT_EXPORT std::shared_ptr<ThreadPool> process_thread_pool();
+
+/// \brief Make a thread pool with a group of workers for each of [options.worker_groups].
+///
+/// Work posted from a worker without naming a group runs in the worker's own group.
+POD5_FORMAT_EXPORT std::shared_ptr<ThreadPool> make_thread_pool(ThreadPoolOptions const & options);
+
+/// \brief Find options giving a pool of [worker_threads] workers a group for each NUMA node the
+///        process may run on, pinned to the node's CPUs, sharing the workers by CPU count.
+///
+/// Machines with a single node, or whose nodes can't be found, get one unpinned group.
+POD5_FORMAT_EXPORT ThreadPoolOptions numa_thread_pool_options(std::size_t worker_threads);
+
+/// \brief Make a thread pool whose workers each keep a lock free deque of the tasks they post,
+///        taking work from each other when idle.
+///
+/// Suits many small tasks posted from within the pool's own tasks, as no global lock is taken to
+/// post or run them. Tasks posted from outside the pool go through a shared queue. Strands run
+/// their tasks one at a time in the order posted, as with make_thread_pool().
+POD5_FORMAT_EXPORT std::shared_ptr<ThreadPool> make_work_stealing_thread_pool(
+    std::size_t worker_threads);
 }  // namespace pod5
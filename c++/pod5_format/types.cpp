@@ -98,6 +98,34 @@ arrow::Result<std::shared_ptr<arrow::DataType>> VbzSignalType::Deserialize(
     return std::make_shared<VbzSignalType>();
 }
 
+arrow::Result<std::shared_ptr<arrow::DataType>> VbzDictionarySignalType::Deserialize(
+    std::shared_ptr<arrow::DataType> storage_type,
+    std::string const & serialized_data) const
+{
+    if (serialized_data != "") {
+        return arrow::Status::Invalid("Unexpected type metadata: '", serialized_data, "'");
+    }
+    if (!storage_type->Equals(*arrow::large_binary())) {
+        return arrow::Status::Invalid(
+            "Incorrect storage for VbzDictionarySignalType: '", storage_type->ToString(), "'");
+    }
+    return std::make_shared<VbzDictionarySignalType>();
+}
+
+arrow::Result<std::shared_ptr<arrow::DataType>> CodecSignalType::Deserialize(
+    std::shared_ptr<arrow::DataType> storage_type,
+    std::string const & serialized_data) const
+{
+    if (serialized_data != "") {
+        return arrow::Status::Invalid("Unexpected type metadata: '", serialized_data, "'");
+    }
+    if (!storage_type->Equals(*arrow::large_binary())) {
+        return arrow::Status::Invalid(
+            "Incorrect storage for CodecSignalType: '", storage_type->ToString(), "'");
+    }
+    return std::make_shared<CodecSignalType>();
+}
+
 std::unique_ptr<arrow::FixedSizeBinaryBuilder> make_read_id_builder(arrow::MemoryPool * pool)
 {
     auto uuid_type = uuid();
@@ -115,6 +143,18 @@ std::shared_ptr<VbzSignalType> vbz_signal()
     return vbz_signal;
 }
 
+std::shared_ptr<VbzDictionarySignalType> vbz_dictionary_signal()
+{
+    static auto vbz_dictionary_signal = std::make_shared<VbzDictionarySignalType>();
+    return vbz_dictionary_signal;
+}
+
+std::shared_ptr<CodecSignalType> codec_signal()
+{
+    static auto codec_signal = std::make_shared<CodecSignalType>();
+    return codec_signal;
+}
+
 std::shared_ptr<UuidType> uuid()
 {
     static auto uuid = std::make_shared<UuidType>();
@@ -128,6 +168,8 @@ pod5::Status register_extension_types()
     if (++g_pod5_register_count == 1) {
         ARROW_RETURN_NOT_OK(arrow::RegisterExtensionType(uuid()));
         ARROW_RETURN_NOT_OK(arrow::RegisterExtensionType(vbz_signal()));
+        ARROW_RETURN_NOT_OK(arrow::RegisterExtensionType(vbz_dictionary_signal()));
+        ARROW_RETURN_NOT_OK(arrow::RegisterExtensionType(codec_signal()));
     }
     return pod5::Status::OK();
 }
@@ -142,6 +184,12 @@ pod5::Status unregister_extension_types()
         if (arrow::GetExtensionType("minknow.vbz")) {
             ARROW_RETURN_NOT_OK(arrow::UnregisterExtensionType("minknow.vbz"));
         }
+        if (arrow::GetExtensionType("minknow.vbz_dictionary")) {
+            ARROW_RETURN_NOT_OK(arrow::UnregisterExtensionType("minknow.vbz_dictionary"));
+        }
+        if (arrow::GetExtensionType("minknow.codec_signal")) {
+            ARROW_RETURN_NOT_OK(arrow::UnregisterExtensionType("minknow.codec_signal"));
+        }
     }
     return pod5::Status::OK();
 }
@@ -71,9 +71,31 @@ public:
         std::string const & serialized_data) const override;
 };
 
+/// \brief Vbz signal compressed against a zstd dictionary stored in the signal table metadata.
+class POD5_FORMAT_EXPORT VbzDictionarySignalType : public VbzSignalType {
+public:
+    std::string extension_name() const override { return "minknow.vbz_dictionary"; }
+
+    arrow::Result<std::shared_ptr<arrow::DataType>> Deserialize(
+        std::shared_ptr<arrow::DataType> storage_type,
+        std::string const & serialized_data) const override;
+};
+
+/// \brief Signal compressed by the SignalCodec named in the signal table metadata.
+class POD5_FORMAT_EXPORT CodecSignalType : public VbzSignalType {
+public:
+    std::string extension_name() const override { return "minknow.codec_signal"; }
+
+    arrow::Result<std::shared_ptr<arrow::DataType>> Deserialize(
+        std::shared_ptr<arrow::DataType> storage_type,
+        std::string const & serialized_data) const override;
+};
+
 std::unique_ptr<arrow::FixedSizeBinaryBuilder> make_read_id_builder(arrow::MemoryPool * pool);
 
 std::shared_ptr<VbzSignalType> vbz_signal();
+std::shared_ptr<VbzDictionarySignalType> vbz_dictionary_signal();
+std::shared_ptr<CodecSignalType> codec_signal();
 std::shared_ptr<UuidType> uuid();
 
 /// \brief Register all required extension types.
@@ -0,0 +1,324 @@
+#include "pod5_format/uuid_format.h"
+
+#include "pod5_format/svb16/common.hpp"
+#ifdef SVB16_X64
+#include "pod5_format/svb16/intrinsics.hpp"
+#include "pod5_format/svb16/simd_detect_x64.hpp"
+#endif
+
+#include <cstring>
+#include <initializer_list>
+
+namespace pod5 {
+
+namespace {
+
+static_assert(sizeof(Uuid) == 16, "UUIDs are formatted and parsed as packed 16 byte arrays");
+
+// Formatted UUIDs hold dashes after the 4th, 6th, 8th and 10th bytes:
+bool is_dash_position(std::size_t byte)
+{
+    return byte == 4 || byte == 6 || byte == 8 || byte == 10;
+}
+
+void format_uuid_scalar(std::uint8_t const * id, char * out)
+{
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    for (std::size_t i = 0; i < 16; ++i) {
+        if (is_dash_position(i)) {
+            *out++ = '-';
+        }
+        *out++ = HEX_DIGITS[id[i] >> 4];
+        *out++ = HEX_DIGITS[id[i] & 0x0f];
+    }
+}
+
+bool parse_uuid_scalar(char const * str, std::uint8_t * id)
+{
+    for (std::size_t i = 0; i < 16; ++i) {
+        if (is_dash_position(i) && *str++ != '-') {
+            return false;
+        }
+        if (!uuid_detail::is_hex(str[0]) || !uuid_detail::is_hex(str[1])) {
+            return false;
+        }
+        id[i] = std::uint8_t(uuid_detail::hex2char(str[0]) << 4 | uuid_detail::hex2char(str[1]));
+        str += 2;
+    }
+    return true;
+}
+
+#ifdef SVB16_X64
+
+// Each 128 bit lane formats or parses one UUID, so the AVX2 kernels handle two at a time with the
+// same shuffles as the SSSE3 ones.
+//
+// Formatting splits each byte into its high and low nibbles, interleaves them and looks up their
+// hex digits, giving the 32 digits of an id in [first] and [second]. Those are then shuffled into
+// place around the dashes:
+//   out[0, 16):  first[0, 8) - first[8, 12) - first[12, 14)
+//   out[16, 32): first[14, 16) - second[0, 4) - second[4, 12)
+//   out[32, 36): second[12, 16)
+#define POD5_UUID_HEX_DIGITS \
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+#define POD5_UUID_FORMAT_SHUFFLE_0 0, 1, 2, 3, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12, 13
+#define POD5_UUID_FORMAT_DASHES_0 0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0
+#define POD5_UUID_FORMAT_SHUFFLE_1_FIRST \
+    14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+#define POD5_UUID_FORMAT_SHUFFLE_1_SECOND -1, -1, -1, 0, 1, 2, 3, -1, 4, 5, 6, 7, 8, 9, 10, 11
+#define POD5_UUID_FORMAT_DASHES_1 0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0
+
+// Parsing loads chars [0, 16), [16, 32) and [20, 36) of the string, and shuffles out the dashes
+// to give the digits of bytes [0, 8) and [8, 16):
+//   first:  chars[0, 8), chars[9, 13), chars[14, 18)
+//   second: chars[19, 23), chars[24, 36)
+#define POD5_UUID_PARSE_SHUFFLE_FIRST_0 0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 14, 15, -1, -1
+#define POD5_UUID_PARSE_SHUFFLE_FIRST_16 \
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1
+#define POD5_UUID_PARSE_SHUFFLE_SECOND_16 \
+    3, 4, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+#define POD5_UUID_PARSE_SHUFFLE_SECOND_20 -1, -1, -1, -1, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+
+// Pairs of hex digit values combine to bytes as high * 16 + low:
+static constexpr std::int16_t NIBBLE_PAIR_WEIGHTS = 0x0110;
+
+[[gnu::target("ssse3")]] void format_uuid_ssse3(std::uint8_t const * id, char * out)
+{
+    auto const hex_digits = _mm_setr_epi8(POD5_UUID_HEX_DIGITS);
+    auto const nibble_mask = _mm_set1_epi8(0x0f);
+
+    auto const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(id));
+    auto const high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+    auto const low = _mm_and_si128(bytes, nibble_mask);
+    auto const first = _mm_shuffle_epi8(hex_digits, _mm_unpacklo_epi8(high, low));
+    auto const second = _mm_shuffle_epi8(hex_digits, _mm_unpackhi_epi8(high, low));
+
+    auto const out_0 = _mm_or_si128(
+        _mm_shuffle_epi8(first, _mm_setr_epi8(POD5_UUID_FORMAT_SHUFFLE_0)),
+        _mm_setr_epi8(POD5_UUID_FORMAT_DASHES_0));
+    auto const out_16 = _mm_or_si128(
+        _mm_or_si128(
+            _mm_shuffle_epi8(first, _mm_setr_epi8(POD5_UUID_FORMAT_SHUFFLE_1_FIRST)),
+            _mm_shuffle_epi8(second, _mm_setr_epi8(POD5_UUID_FORMAT_SHUFFLE_1_SECOND))),
+        _mm_setr_epi8(POD5_UUID_FORMAT_DASHES_1));
+    auto const out_32 = _mm_cvtsi128_si32(_mm_srli_si128(second, 12));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), out_0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), out_16);
+    std::memcpy(out + 32, &out_32, sizeof(out_32));
+}
+
+[[gnu::target("avx2")]] void format_uuid_pair_avx2(std::uint8_t const * ids, char * out)
+{
+    auto const hex_digits = _mm256_setr_epi8(POD5_UUID_HEX_DIGITS, POD5_UUID_HEX_DIGITS);
+    auto const nibble_mask = _mm256_set1_epi8(0x0f);
+
+    auto const bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(ids));
+    auto const high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble_mask);
+    auto const low = _mm256_and_si256(bytes, nibble_mask);
+    auto const first = _mm256_shuffle_epi8(hex_digits, _mm256_unpacklo_epi8(high, low));
+    auto const second = _mm256_shuffle_epi8(hex_digits, _mm256_unpackhi_epi8(high, low));
+
+    auto const out_0 = _mm256_or_si256(
+        _mm256_shuffle_epi8(
+            first, _mm256_setr_epi8(POD5_UUID_FORMAT_SHUFFLE_0, POD5_UUID_FORMAT_SHUFFLE_0)),
+        _mm256_setr_epi8(POD5_UUID_FORMAT_DASHES_0, POD5_UUID_FORMAT_DASHES_0));
+    auto const out_16 = _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_shuffle_epi8(
+                first,
+                _mm256_setr_epi8(
+                    POD5_UUID_FORMAT_SHUFFLE_1_FIRST, POD5_UUID_FORMAT_SHUFFLE_1_FIRST)),
+            _mm256_shuffle_epi8(
+                second,
+                _mm256_setr_epi8(
+                    POD5_UUID_FORMAT_SHUFFLE_1_SECOND, POD5_UUID_FORMAT_SHUFFLE_1_SECOND))),
+        _mm256_setr_epi8(POD5_UUID_FORMAT_DASHES_1, POD5_UUID_FORMAT_DASHES_1));
+    auto const out_32 = _mm256_srli_si256(second, 12);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_castsi256_si128(out_0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), _mm256_castsi256_si128(out_16));
+    auto const out_32_first = _mm_cvtsi128_si32(_mm256_castsi256_si128(out_32));
+    std::memcpy(out + 32, &out_32_first, sizeof(out_32_first));
+
+    out += UUID_STRING_LENGTH;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_extracti128_si256(out_0, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), _mm256_extracti128_si256(out_16, 1));
+    auto const out_32_second = _mm_cvtsi128_si32(_mm256_extracti128_si256(out_32, 1));
+    std::memcpy(out + 32, &out_32_second, sizeof(out_32_second));
+}
+
+// Find the values of hex digits [chars], clearing bytes of [valid] where they aren't digits.
+[[gnu::target("ssse3")]] __m128i hex_digit_values_ssse3(__m128i chars, __m128i * valid)
+{
+    // Out of range digits wrap around to large unsigned values:
+    auto const digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    auto const is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    auto const letters = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    auto const is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letters, _mm_set1_epi8(5)), letters);
+    *valid = _mm_and_si128(*valid, _mm_or_si128(is_digit, is_letter));
+    return _mm_or_si128(
+        _mm_and_si128(is_digit, digits),
+        _mm_andnot_si128(is_digit, _mm_add_epi8(letters, _mm_set1_epi8(10))));
+}
+
+[[gnu::target("ssse3")]] bool parse_uuid_ssse3(char const * str, std::uint8_t * id)
+{
+    if (str[8] != '-' || str[13] != '-' || str[18] != '-' || str[23] != '-') {
+        return false;
+    }
+
+    auto const chars_0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(str));
+    auto const chars_16 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(str + 16));
+    auto const chars_20 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(str + 20));
+    auto const first = _mm_or_si128(
+        _mm_shuffle_epi8(chars_0, _mm_setr_epi8(POD5_UUID_PARSE_SHUFFLE_FIRST_0)),
+        _mm_shuffle_epi8(chars_16, _mm_setr_epi8(POD5_UUID_PARSE_SHUFFLE_FIRST_16)));
+    auto const second = _mm_or_si128(
+        _mm_shuffle_epi8(chars_16, _mm_setr_epi8(POD5_UUID_PARSE_SHUFFLE_SECOND_16)),
+        _mm_shuffle_epi8(chars_20, _mm_setr_epi8(POD5_UUID_PARSE_SHUFFLE_SECOND_20)));
+
+    auto valid = _mm_set1_epi8(-1);
+    auto const weights = _mm_set1_epi16(NIBBLE_PAIR_WEIGHTS);
+    auto const first_bytes = _mm_maddubs_epi16(hex_digit_values_ssse3(first, &valid), weights);
+    auto const second_bytes = _mm_maddubs_epi16(hex_digit_values_ssse3(second, &valid), weights);
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+        return false;
+    }
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(id), _mm_packus_epi16(first_bytes, second_bytes));
+    return true;
+}
+
+[[gnu::target("avx2")]] __m256i hex_digit_values_avx2(__m256i chars, __m256i * valid)
+{
+    auto const digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    auto const is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+    auto const letters =
+        _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    auto const is_letter =
+        _mm256_cmpeq_epi8(_mm256_min_epu8(letters, _mm256_set1_epi8(5)), letters);
+    *valid = _mm256_and_si256(*valid, _mm256_or_si256(is_digit, is_letter));
+    return _mm256_or_si256(
+        _mm256_and_si256(is_digit, digits),
+        _mm256_andnot_si256(is_digit, _mm256_add_epi8(letters, _mm256_set1_epi8(10))));
+}
+
+[[gnu::target("avx2")]] __m256i load_string_pair_avx2(char const * str)
+{
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(str))),
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(str + UUID_STRING_LENGTH)),
+        1);
+}
+
+// Parse two consecutive strings, returning false if either isn't a UUID.
+[[gnu::target("avx2")]] bool parse_uuid_pair_avx2(char const * str, std::uint8_t * ids)
+{
+    for (auto const dash : {8, 13, 18, 23}) {
+        if (str[dash] != '-' || str[UUID_STRING_LENGTH + dash] != '-') {
+            return false;
+        }
+    }
+
+    auto const chars_0 = load_string_pair_avx2(str);
+    auto const chars_16 = load_string_pair_avx2(str + 16);
+    auto const chars_20 = load_string_pair_avx2(str + 20);
+    auto const first = _mm256_or_si256(
+        _mm256_shuffle_epi8(
+            chars_0,
+            _mm256_setr_epi8(POD5_UUID_PARSE_SHUFFLE_FIRST_0, POD5_UUID_PARSE_SHUFFLE_FIRST_0)),
+        _mm256_shuffle_epi8(
+            chars_16,
+            _mm256_setr_epi8(POD5_UUID_PARSE_SHUFFLE_FIRST_16, POD5_UUID_PARSE_SHUFFLE_FIRST_16)));
+    auto const second = _mm256_or_si256(
+        _mm256_shuffle_epi8(
+            chars_16,
+            _mm256_setr_epi8(
+                POD5_UUID_PARSE_SHUFFLE_SECOND_16, POD5_UUID_PARSE_SHUFFLE_SECOND_16)),
+        _mm256_shuffle_epi8(
+            chars_20,
+            _mm256_setr_epi8(
+                POD5_UUID_PARSE_SHUFFLE_SECOND_20, POD5_UUID_PARSE_SHUFFLE_SECOND_20)));
+
+    auto valid = _mm256_set1_epi8(-1);
+    auto const weights = _mm256_set1_epi16(NIBBLE_PAIR_WEIGHTS);
+    auto const first_bytes = _mm256_maddubs_epi16(hex_digit_values_avx2(first, &valid), weights);
+    auto const second_bytes =
+        _mm256_maddubs_epi16(hex_digit_values_avx2(second, &valid), weights);
+    if (_mm256_movemask_epi8(valid) != -1) {
+        return false;
+    }
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(ids), _mm256_packus_epi16(first_bytes, second_bytes));
+    return true;
+}
+
+#endif  // SVB16_X64
+
+}  // namespace
+
+void format_uuids(gsl::span<Uuid const> const & ids, char * out)
+{
+    auto const bytes = reinterpret_cast<std::uint8_t const *>(ids.data());
+    std::size_t i = 0;
+#ifdef SVB16_X64
+    if (has_avx2()) {
+        for (; i + 2 <= ids.size(); i += 2) {
+            format_uuid_pair_avx2(bytes + i * sizeof(Uuid), out + i * UUID_STRING_LENGTH);
+        }
+    }
+    if (has_ssse3()) {
+        for (; i < ids.size(); ++i) {
+            format_uuid_ssse3(bytes + i * sizeof(Uuid), out + i * UUID_STRING_LENGTH);
+        }
+    }
+#endif
+    for (; i < ids.size(); ++i) {
+        format_uuid_scalar(bytes + i * sizeof(Uuid), out + i * UUID_STRING_LENGTH);
+    }
+}
+
+std::size_t parse_uuids(char const * strings, gsl::span<Uuid> const & ids)
+{
+    auto const bytes = reinterpret_cast<std::uint8_t *>(ids.data());
+    std::size_t i = 0;
+#ifdef SVB16_X64
+    if (has_avx2()) {
+        // A pair holding an invalid string is parsed again one by one below, to find which:
+        for (; i + 2 <= ids.size(); i += 2) {
+            if (!parse_uuid_pair_avx2(strings + i * UUID_STRING_LENGTH, bytes + i * sizeof(Uuid)))
+            {
+                break;
+            }
+        }
+    }
+    if (has_ssse3()) {
+        for (; i < ids.size(); ++i) {
+            if (!parse_uuid_ssse3(strings + i * UUID_STRING_LENGTH, bytes + i * sizeof(Uuid))) {
+                return i;
+            }
+        }
+    }
+#endif
+    for (; i < ids.size(); ++i) {
+        if (!parse_uuid_scalar(strings + i * UUID_STRING_LENGTH, bytes + i * sizeof(Uuid))) {
+            return i;
+        }
+    }
+    return ids.size();
+}
+
+std::optional<Uuid> parse_uuid(std::string_view str)
+{
+    if (str.size() == UUID_STRING_LENGTH) {
+        Uuid id;
+        if (parse_uuids(str.data(), gsl::make_span(&id, 1)) == 1) {
+            return id;
+        }
+    }
+    // Braced ids, and dashes in other places, are still accepted:
+    return Uuid::from_string(str);
+}
+
+}  // namespace pod5
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/uuid.h"
+
+#include <gsl/gsl-lite.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace pod5 {
+
+/// \brief Length of a formatted UUID, "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx", without a
+///        terminator.
+static constexpr std::size_t UUID_STRING_LENGTH = 36;
+
+/// \brief Format [ids] as lowercase UUID strings, one after another every UUID_STRING_LENGTH
+///        chars of [out], without terminators.
+/// \param out  Must hold at least ids.size() * UUID_STRING_LENGTH chars.
+///
+/// Formats several ids at once with SSSE3 or AVX2 where the CPU supports them.
+POD5_FORMAT_EXPORT void format_uuids(gsl::span<Uuid const> const & ids, char * out);
+
+/// \brief Parse [ids.size()] UUID strings stored one after another every UUID_STRING_LENGTH chars
+///        of [strings], in either case and without braces.
+/// \returns The index of the first string which isn't a UUID, or ids.size() if all parsed. Ids
+///          after an invalid string are left unset.
+///
+/// Parses with SSSE3 or AVX2 where the CPU supports them.
+POD5_FORMAT_EXPORT std::size_t parse_uuids(char const * strings, gsl::span<Uuid> const & ids);
+
+/// \brief Parse a UUID string, taking the vectorised path for UUID_STRING_LENGTH char strings
+///        and Uuid::from_string otherwise, so braced ids parse too.
+POD5_FORMAT_EXPORT std::optional<Uuid> parse_uuid(std::string_view str);
+
+}  // namespace pod5
@@ -0,0 +1,211 @@
+#include "pod5_format/writer_resources.h"
+
+#include "pod5_format/io_manager.h"
+#include "pod5_format/memory_pool.h"
+#include "pod5_format/thread_pool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+
+namespace pod5 {
+
+namespace internal {
+
+/// \brief Runs tasks posted by several writers on one pool, taking a task from each writer with
+///        queued tasks in turn.
+///
+/// At most one runner per pool thread is posted to the pool, each taking tasks until none are
+/// queued, so the pool's own queue never holds one writer's backlog ahead of another's.
+class FairShareScheduler {
+public:
+    struct WriterQueue {
+        std::deque<ThreadPoolTask> tasks;
+        // Tasks taken from [tasks] which haven't finished running:
+        std::size_t running = 0;
+        bool stopped = false;
+        std::condition_variable drained;
+    };
+
+    FairShareScheduler(std::shared_ptr<ThreadPool> const & pool, std::size_t max_runners)
+    : m_pool(pool)
+    , m_max_runners(std::max<std::size_t>(1, max_runners))
+    {
+    }
+
+    // Runners refer to the scheduler, so wait for them before it goes:
+    ~FairShareScheduler() { m_pool->stop_and_drain(); }
+
+    std::shared_ptr<ThreadPool> const & pool() const { return m_pool; }
+
+    void post(std::shared_ptr<WriterQueue> const & queue, ThreadPoolTask task)
+    {
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            if (queue->stopped) {
+                throw std::logic_error{"ThreadPool: post() called after stop_and_drain()"};
+            }
+            // Writers are listed as ready while they have queued tasks:
+            if (queue->tasks.empty()) {
+                m_ready.push_back(queue);
+            }
+            queue->tasks.push_back(std::move(task));
+            if (m_runners >= m_max_runners) {
+                return;
+            }
+            ++m_runners;
+        }
+        m_pool->post([this] { run(); });
+    }
+
+    void drain(std::shared_ptr<WriterQueue> const & queue)
+    {
+        std::unique_lock<std::mutex> l(m_mutex);
+        queue->stopped = true;
+        queue->drained.wait(l, [&] { return queue->tasks.empty() && queue->running == 0; });
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> l(m_mutex);
+        while (!m_ready.empty()) {
+            auto queue = std::move(m_ready.front());
+            m_ready.pop_front();
+            auto task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+            if (!queue->tasks.empty()) {
+                m_ready.push_back(queue);
+            }
+            ++queue->running;
+
+            l.unlock();
+            task();
+            // Release whatever the task holds before taking the lock again:
+            task = nullptr;
+            l.lock();
+
+            if (--queue->running == 0 && queue->tasks.empty()) {
+                queue->drained.notify_all();
+            }
+        }
+        --m_runners;
+    }
+
+    std::shared_ptr<ThreadPool> m_pool;
+    std::size_t const m_max_runners;
+
+    std::mutex m_mutex;
+    std::deque<std::shared_ptr<WriterQueue>> m_ready;
+    std::size_t m_runners = 0;
+};
+
+}  // namespace internal
+
+namespace {
+
+/// A writer's view of the shared compression pool, see WriterResources::make_writer_thread_pool.
+class WriterThreadPool : public ThreadPool {
+public:
+    WriterThreadPool(std::shared_ptr<internal::FairShareScheduler> const & scheduler)
+    : m_scheduler(scheduler)
+    , m_queue(std::make_shared<internal::FairShareScheduler::WriterQueue>())
+    {
+    }
+
+    std::shared_ptr<ThreadPoolStrand> create_strand() override
+    {
+        return m_scheduler->pool()->create_strand();
+    }
+
+    void post(ThreadPoolTask callback) override
+    {
+        m_scheduler->post(m_queue, std::move(callback));
+    }
+
+    void stop_and_drain() override { m_scheduler->drain(m_queue); }
+
+    ThreadPoolStatistics statistics() const override
+    {
+        return m_scheduler->pool()->statistics();
+    }
+
+private:
+    std::shared_ptr<internal::FairShareScheduler> m_scheduler;
+    std::shared_ptr<internal::FairShareScheduler::WriterQueue> m_queue;
+};
+
+}  // namespace
+
+WriterResources::WriterResources(
+    WriterResourcesOptions const & options,
+    std::shared_ptr<IOManager> const & io_manager)
+: m_options(options)
+, m_compression_scheduler(std::make_shared<internal::FairShareScheduler>(
+      make_thread_pool(options.compression_threads),
+      options.compression_threads))
+, m_io_thread_pool(make_thread_pool(options.io_threads))
+// Not the io pool, a stream closing on it would wait on its own reservation:
+, m_preallocation_thread_pool(make_thread_pool(1))
+, m_io_manager(io_manager)
+, m_pending_signal_bytes(std::make_shared<std::atomic<std::size_t>>(0))
+{
+}
+
+WriterResources::~WriterResources() = default;
+
+std::shared_ptr<ThreadPool> WriterResources::make_writer_thread_pool()
+{
+    return std::make_shared<WriterThreadPool>(m_compression_scheduler);
+}
+
+std::optional<PendingSignalReservation> WriterResources::try_reserve_pending_signal(
+    std::size_t bytes)
+{
+    auto const max_bytes = m_options.max_pending_signal_bytes;
+    auto pending = m_pending_signal_bytes->load(std::memory_order_acquire);
+    do {
+        if (max_bytes != 0 && pending + bytes > max_bytes) {
+            return std::nullopt;
+        }
+    } while (!m_pending_signal_bytes->compare_exchange_weak(
+        pending, pending + bytes, std::memory_order_acq_rel));
+    return PendingSignalReservation{m_pending_signal_bytes, bytes};
+}
+
+PendingSignalReservation WriterResources::reserve_pending_signal(std::size_t bytes)
+{
+    m_pending_signal_bytes->fetch_add(bytes, std::memory_order_acq_rel);
+    return PendingSignalReservation{m_pending_signal_bytes, bytes};
+}
+
+pod5::Result<std::shared_ptr<WriterResources>> make_writer_resources(
+    WriterResourcesOptions const & options,
+    arrow::MemoryPool * memory_pool)
+{
+    if (options.compression_threads == 0 || options.io_threads == 0) {
+        return arrow::Status::Invalid("Writer resources need at least one thread of each kind");
+    }
+    if (!memory_pool) {
+        memory_pool = pod5::default_memory_pool();
+    }
+
+    std::shared_ptr<IOManager> io_manager;
+#ifdef __linux__
+    if (options.use_io_uring) {
+        // Kernels without io_uring, or refusing it to this process, get a sync IO manager:
+        auto uring_io_manager = make_io_uring_io_manager(memory_pool, options.io_queue_depth);
+        if (uring_io_manager.ok()) {
+            io_manager = *uring_io_manager;
+        }
+    }
+    if (!io_manager) {
+        ARROW_ASSIGN_OR_RAISE(io_manager, make_sync_io_manager(memory_pool));
+    }
+#endif
+
+    return std::make_shared<WriterResources>(options, io_manager);
+}
+
+}  // namespace pod5
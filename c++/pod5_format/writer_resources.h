@@ -0,0 +1,151 @@
+#pragma once
+
+#include "pod5_format/pod5_format_export.h"
+#include "pod5_format/result.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace arrow {
+class MemoryPool;
+}
+
+namespace pod5 {
+
+class IOManager;
+class ThreadPool;
+
+namespace internal {
+class FairShareScheduler;
+}
+
+struct WriterResourcesOptions {
+    /// Threads compressing signal for every writer sharing the resources.
+    std::size_t compression_threads = std::max(1u, std::thread::hardware_concurrency());
+    /// Threads writing files which aren't written with direct or sync io.
+    std::size_t io_threads = 2;
+    /// Whether files written with direct or sync io share an io_uring IO manager, falling back
+    /// to a sync IO manager where io_uring is unavailable.
+    bool use_io_uring = true;
+    /// The most writes the io_uring IO manager keeps in flight, across every writer.
+    std::uint32_t io_queue_depth = 64;
+    /// The most bytes of signal held waiting to be compressed, across every writer.
+    /// \note 0 sets no limit, leaving each writer bounded by its own max compression jobs.
+    std::size_t max_pending_signal_bytes = 0;
+};
+
+/// \brief A share of a WriterResources' pending signal budget, given back when destroyed.
+class POD5_FORMAT_EXPORT PendingSignalReservation {
+public:
+    PendingSignalReservation() = default;
+    PendingSignalReservation(std::shared_ptr<std::atomic<std::size_t>> pending, std::size_t bytes)
+    : m_pending(std::move(pending))
+    , m_bytes(bytes)
+    {
+    }
+
+    PendingSignalReservation(PendingSignalReservation && other) noexcept
+    : m_pending(std::move(other.m_pending))
+    , m_bytes(other.m_bytes)
+    {
+    }
+
+    PendingSignalReservation & operator=(PendingSignalReservation && other) noexcept
+    {
+        if (this != &other) {
+            release();
+            m_pending = std::move(other.m_pending);
+            m_bytes = other.m_bytes;
+        }
+        return *this;
+    }
+
+    ~PendingSignalReservation() { release(); }
+
+    std::size_t bytes() const { return m_pending ? m_bytes : 0; }
+
+private:
+    void release()
+    {
+        if (m_pending) {
+            m_pending->fetch_sub(m_bytes, std::memory_order_acq_rel);
+            m_pending.reset();
+        }
+    }
+
+    std::shared_ptr<std::atomic<std::size_t>> m_pending;
+    std::size_t m_bytes = 0;
+};
+
+/// \brief Threads, IO and memory shared by every FileWriter created with them, so a process
+///        writing many files at once runs a fixed number of threads however many are open.
+///
+/// Each writer compresses signal through a view of one shared compression pool, which runs the
+/// writers' queued jobs in turn rather than in the order they were posted, so a writer queueing
+/// many chunks doesn't hold up the others. Writers wait on their own compression once the
+/// pending signal budget is spent, rather than holding more signal in memory.
+/// \see FileWriterOptions::set_writer_resources
+class POD5_FORMAT_EXPORT WriterResources {
+public:
+    WriterResources(
+        WriterResourcesOptions const & options,
+        std::shared_ptr<IOManager> const & io_manager);
+    ~WriterResources();
+
+    WriterResourcesOptions const & options() const { return m_options; }
+
+    /// \brief Make a thread pool for one writer, posting to the shared compression pool in turn
+    ///        with the other writers' pools.
+    ///
+    /// Strands made by the pool run on the shared compression pool directly.
+    std::shared_ptr<ThreadPool> make_writer_thread_pool();
+
+    /// \brief Find the pool writing files not written with direct or sync io, each through a
+    ///        strand of its own.
+    std::shared_ptr<ThreadPool> const & io_thread_pool() const { return m_io_thread_pool; }
+
+    /// \brief Find the pool reserving file space in the background for every writer.
+    std::shared_ptr<ThreadPool> const & preallocation_thread_pool() const
+    {
+        return m_preallocation_thread_pool;
+    }
+
+    /// \brief Find the IO manager shared by files written with direct or sync io, unset where
+    ///        neither is supported.
+    std::shared_ptr<IOManager> const & io_manager() const { return m_io_manager; }
+
+    /// \brief Reserve [bytes] of the pending signal budget.
+    /// \returns The reservation, or nothing if the budget can't hold [bytes] more.
+    std::optional<PendingSignalReservation> try_reserve_pending_signal(std::size_t bytes);
+
+    /// \brief Reserve [bytes] of the pending signal budget, whether or not it is spent.
+    PendingSignalReservation reserve_pending_signal(std::size_t bytes);
+
+    /// \brief Find the bytes of signal currently reserved by writers.
+    std::size_t pending_signal_bytes() const
+    {
+        return m_pending_signal_bytes->load(std::memory_order_acquire);
+    }
+
+private:
+    WriterResourcesOptions m_options;
+    std::shared_ptr<internal::FairShareScheduler> m_compression_scheduler;
+    std::shared_ptr<ThreadPool> m_io_thread_pool;
+    std::shared_ptr<ThreadPool> m_preallocation_thread_pool;
+    std::shared_ptr<IOManager> m_io_manager;
+    std::shared_ptr<std::atomic<std::size_t>> m_pending_signal_bytes;
+};
+
+/// \brief Make resources to be shared by writers, see FileWriterOptions::set_writer_resources.
+/// \param memory_pool The pool the IO manager allocates write buffers from.
+POD5_FORMAT_EXPORT pod5::Result<std::shared_ptr<WriterResources>> make_writer_resources(
+    WriterResourcesOptions const & options = {},
+    arrow::MemoryPool * memory_pool = nullptr);
+
+}  // namespace pod5
@@ -2,23 +2,73 @@
 
 #include "pod5_format/async_signal_loader.h"
 #include "pod5_format/c_api.h"
+#include "pod5_format/dataset_reader.h"
 #include "pod5_format/file_reader.h"
 #include "pod5_format/file_updater.h"
 #include "pod5_format/file_writer.h"
+#include "pod5_format/memory_pool.h"
+#include "pod5_format/read_batch_iterator.h"
+#include "pod5_format/read_scan.h"
+#include "pod5_format/read_table_export.h"
 #include "pod5_format/read_table_reader.h"
+#include "pod5_format/signal_codec.h"
 #include "pod5_format/signal_compression.h"
+#include "pod5_format/signal_summary.h"
 #include "pod5_format/signal_table_reader.h"
 #include "pod5_format/thread_pool.h"
 #include "pod5_format/uuid.h"
+#include "pod5_format/uuid_format.h"
 #include "utils.h"
 
+#include <arrow/buffer.h>
+#include <arrow/c/abi.h>
+#include <arrow/c/bridge.h>
+#include <arrow/io/file.h>
 #include <arrow/memory_pool.h>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <map>
+#include <optional>
+
 namespace py = pybind11;
 
+// Pool shared by binding calls which spread their work over several threads. Remade in processes
+// forked from the one which made it, such as dataloader workers:
+inline std::shared_ptr<pod5::ThreadPool> shared_thread_pool_ptr()
+{
+    return pod5::process_thread_pool();
+}
+
+inline pod5::ThreadPool & shared_thread_pool() { return *shared_thread_pool_ptr(); }
+
+// Make a numpy array taking ownership of [values], without copying them.
+template <typename T>
+py::array_t<T> make_owned_array(std::vector<T> && values)
+{
+    auto const owned_values = new std::vector<T>(std::move(values));
+    py::capsule const owner(
+        owned_values, [](void * ptr) { delete static_cast<std::vector<T> *>(ptr); });
+    return py::array_t<T>({owned_values->size()}, {sizeof(T)}, owned_values->data(), owner);
+}
+
+// Find the calibration of each read from numpy arrays of offsets and scales.
+inline std::vector<pod5::SignalCalibration> make_calibrations(
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & calibration_offsets,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & calibration_scales)
+{
+    if (calibration_offsets.size() != calibration_scales.size()) {
+        throw std::runtime_error("Calibration offsets and scales must be the same length");
+    }
+    std::vector<pod5::SignalCalibration> calibrations(calibration_offsets.size());
+    for (std::size_t i = 0; i < calibrations.size(); ++i) {
+        calibrations[i] = {calibration_offsets.data()[i], calibration_scales.data()[i]};
+    }
+    return calibrations;
+}
+
 inline std::shared_ptr<pod5::FileWriter> create_file(
     char const * path,
     std::string const & writer_name,
@@ -41,7 +91,11 @@ inline std::shared_ptr<pod5::FileWriter> recover_file(
     return writer;
 }
 
-class Pod5SignalCacheBatch {
+// Signal loaded for one batch, exposed to python as numpy views over the loaded buffers.
+//
+// Each view holds a capsule owning a reference to the batch, so the buffers outlive the batch
+// object for as long as any view of them is alive.
+class Pod5SignalCacheBatch : public std::enable_shared_from_this<Pod5SignalCacheBatch> {
 public:
     Pod5SignalCacheBatch(
         pod5::AsyncSignalLoader::SamplesMode samples_mode,
@@ -53,8 +107,7 @@ public:
 
     py::array_t<std::uint64_t> sample_count() const
     {
-        return py::array_t<std::uint64_t>(
-            m_cached_data.sample_count().size(), m_cached_data.sample_count().data());
+        return read_only_view(gsl::make_span(m_cached_data.sample_count()), make_owner());
     }
 
     py::list samples() const
@@ -63,17 +116,84 @@ public:
         if (m_samples_mode != pod5::AsyncSignalLoader::SamplesMode::Samples) {
             return py_samples;
         }
-        for (auto const & row_samples : m_cached_data.samples()) {
-            py_samples.append(py::array_t<std::int16_t>(
-                {row_samples.size()}, {sizeof(std::int16_t)}, row_samples.data()));
+        auto const owner = make_owner();
+        for (std::size_t row = 0; row < m_cached_data.sample_count().size(); ++row) {
+            py_samples.append(view(m_cached_data.samples(row), owner));
         }
 
         return py_samples;
     }
 
+    py::array_t<std::uint64_t> sample_offsets() const
+    {
+        return read_only_view(gsl::make_span(m_cached_data.sample_offsets()), make_owner());
+    }
+
+    // Find all rows' samples as one array, without a copy:
+    py::array_t<std::int16_t> all_samples() const
+    {
+        return view(m_cached_data.all_samples(), make_owner());
+    }
+
+    // Calibrate every row's samples to picoamps, given each row's calibration, returning all
+    // rows' picoamp samples as one array alongside sample_offsets():
+    py::tuple samples_pa(
+        py::array_t<float, py::array::c_style | py::array::forcecast> const & calibration_offsets,
+        py::array_t<float, py::array::c_style | py::array::forcecast> const & calibration_scales)
+        const
+    {
+        if (m_samples_mode != pod5::AsyncSignalLoader::SamplesMode::Samples) {
+            throw std::runtime_error("Signal batch was loaded without samples");
+        }
+        auto const calibrations = make_calibrations(calibration_offsets, calibration_scales);
+        auto const & row_offsets = m_cached_data.sample_offsets();
+        if (calibrations.size() + 1 != row_offsets.size()) {
+            throw std::runtime_error("Expected a calibration for each row of the signal batch");
+        }
+
+        std::vector<float> samples(row_offsets.back());
+        {
+            py::gil_scoped_release release;
+            auto const all_samples = m_cached_data.all_samples();
+            for (std::size_t row = 0; row < calibrations.size(); ++row) {
+                auto const row_start = row_offsets[row];
+                auto const row_size = row_offsets[row + 1] - row_start;
+                pod5::calibrate_signal(
+                    all_samples.subspan(row_start, row_size),
+                    calibrations[row],
+                    gsl::make_span(samples).subspan(row_start, row_size));
+            }
+        }
+        return py::make_tuple(make_owned_array(std::move(samples)), sample_offsets());
+    }
+
     std::uint32_t batch_index() const { return m_cached_data.batch_index(); }
 
 private:
+    // Make a capsule keeping this batch, and so its buffers, alive:
+    py::capsule make_owner() const
+    {
+        return py::capsule(
+            new std::shared_ptr<Pod5SignalCacheBatch const>(shared_from_this()), [](void * ptr) {
+                delete static_cast<std::shared_ptr<Pod5SignalCacheBatch const> *>(ptr);
+            });
+    }
+
+    template <typename T>
+    static py::array_t<T> view(gsl::span<T const> data, py::capsule const & owner)
+    {
+        return py::array_t<T>({data.size()}, {sizeof(T)}, data.data(), owner);
+    }
+
+    // Views of the row layout are read only, as samples() depends on it:
+    template <typename T>
+    static py::array_t<T> read_only_view(gsl::span<T const> data, py::capsule const & owner)
+    {
+        auto result = view(data, owner);
+        py::detail::array_proxy(result.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+        return result;
+    }
+
     pod5::AsyncSignalLoader::SamplesMode m_samples_mode;
     pod5::CachedBatchSignalData m_cached_data;
 };
@@ -133,9 +253,57 @@ public:
     {
     }
 
+    // Make an async loader for specific reads in specific batches, running as tasks on the
+    // shared thread pool so loaders of many files can be open at once. Loading runs at most
+    // [max_pending_batches] batches, or [max_pending_bytes] decoded bytes, ahead of the caller.
+    Pod5AsyncSignalLoader(
+        std::shared_ptr<pod5::FileReader> const & reader,
+        pod5::AsyncSignalLoader::SamplesMode samples_mode,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> && batch_counts,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> && batch_rows,
+        std::shared_ptr<pod5::ThreadPool> const & thread_pool,
+        std::size_t max_pending_batches,
+        std::uint64_t max_pending_bytes)
+    : m_samples_mode(samples_mode)
+    , m_batch_counts_ref(std::move(batch_counts))
+    , m_batch_rows_ref(std::move(batch_rows))
+    , m_async_loader(
+          reader,
+          samples_mode,
+          gsl::make_span(m_batch_counts_ref.data(), m_batch_counts_ref.size()),
+          gsl::make_span(m_batch_rows_ref.data(), m_batch_rows_ref.size()),
+          thread_pool,
+          std::max(1u, std::thread::hardware_concurrency()),
+          std::max<std::size_t>(1, max_pending_batches),
+          pod5::AsyncSignalLoader::DEFAULT_PREFETCH_DISTANCE,
+          max_pending_bytes)
+    {
+    }
+
     std::shared_ptr<Pod5SignalCacheBatch> release_next_batch()
     {
-        auto batch = m_async_loader.release_next_batch();
+        auto batch = [&] {
+            py::gil_scoped_release release;
+            return m_async_loader.release_next_batch();
+        }();
+        if (!batch.ok()) {
+            throw std::runtime_error(batch.status().ToString());
+        }
+
+        if (!*batch) {
+            assert(m_async_loader.is_finished());
+            throw pybind11::stop_iteration();
+        }
+
+        return std::make_shared<Pod5SignalCacheBatch>(m_samples_mode, std::move(**batch));
+    }
+
+    std::shared_ptr<Pod5SignalCacheBatch> release_next_completed_batch()
+    {
+        auto batch = [&] {
+            py::gil_scoped_release release;
+            return m_async_loader.release_next_completed_batch();
+        }();
         if (!batch.ok()) {
             throw std::runtime_error(batch.status().ToString());
         }
@@ -152,6 +320,7 @@ public:
         std::shared_ptr<pod5::FileReader> const & reader,
         py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> const & batches)
     {
+        py::gil_scoped_release release;
         std::vector<std::uint32_t> batch_counts(reader->num_read_record_batches(), 0);
         for (auto const & batch_idx : gsl::make_span(batches.data(), batches.shape(0))) {
             auto read_batch = reader->read_read_record_batch(batch_idx);
@@ -172,6 +341,89 @@ public:
     pod5::AsyncSignalLoader m_async_loader;
 };
 
+// A table batch, handed to pyarrow through the Arrow PyCapsule interface without copying.
+class Pod5RecordBatch {
+public:
+    explicit Pod5RecordBatch(std::shared_ptr<arrow::RecordBatch> batch) : m_batch(std::move(batch))
+    {
+    }
+
+    std::size_t num_rows() const { return m_batch->num_rows(); }
+
+    // Export the batch as a schema and array capsule, for pyarrow.record_batch():
+    py::tuple arrow_c_array(py::object const & requested_schema) const
+    {
+        if (!requested_schema.is_none()) {
+            throw std::runtime_error("Batches are only exported with their own schema");
+        }
+
+        auto schema = std::make_unique<ArrowSchema>();
+        auto array = std::make_unique<ArrowArray>();
+        auto const status = arrow::ExportRecordBatch(*m_batch, array.get(), schema.get());
+        POD5_PYTHON_RETURN_NOT_OK(status);
+
+        // Capsules release whatever the consumer didn't move out of them:
+        py::capsule const schema_capsule(schema.release(), "arrow_schema", [](PyObject * capsule) {
+            auto const schema =
+                static_cast<ArrowSchema *>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+            if (schema->release) {
+                schema->release(schema);
+            }
+            delete schema;
+        });
+        py::capsule const array_capsule(array.release(), "arrow_array", [](PyObject * capsule) {
+            auto const array =
+                static_cast<ArrowArray *>(PyCapsule_GetPointer(capsule, "arrow_array"));
+            if (array->release) {
+                array->release(array);
+            }
+            delete array;
+        });
+        return py::make_tuple(schema_capsule, array_capsule);
+    }
+
+private:
+    std::shared_ptr<arrow::RecordBatch> m_batch;
+};
+
+// Iterate over a file's read table batches, reading ahead on the shared thread pool.
+class Pod5ReadBatchIterator {
+public:
+    explicit Pod5ReadBatchIterator(std::unique_ptr<pod5::ReadBatchIterator> && iterator)
+    : m_iterator(std::move(iterator))
+    {
+    }
+
+    ~Pod5ReadBatchIterator()
+    {
+        // Reads still running are waited for without holding up other python threads:
+        py::gil_scoped_release release;
+        m_iterator.reset();
+    }
+
+    std::shared_ptr<Pod5RecordBatch> next_batch()
+    {
+        auto batch = [&] {
+            py::gil_scoped_release release;
+            return m_iterator->next();
+        }();
+        if (!batch.ok()) {
+            throw std::runtime_error(batch.status().ToString());
+        }
+
+        if (!*batch) {
+            throw pybind11::stop_iteration();
+        }
+
+        return std::make_shared<Pod5RecordBatch>((*batch)->batch());
+    }
+
+    std::size_t batch_count() const { return m_iterator->batch_count(); }
+
+private:
+    std::unique_ptr<pod5::ReadBatchIterator> m_iterator;
+};
+
 struct Pod5FileReaderPtr {
     std::shared_ptr<pod5::FileReader> reader = nullptr;
 
@@ -192,12 +444,211 @@ struct Pod5FileReaderPtr {
         return reader->signal_table_location();
     }
 
+    // Check if the read or run info table is migrated in place as it is read, in which case its
+    // location is only found by writing the migrated table to a temporary directory.
+    bool read_table_migrated() const { return reader->read_table_migrated(); }
+
+    bool run_info_table_migrated() const { return reader->run_info_table_migrated(); }
+
     std::string get_file_version_pre_migration() const
     {
         return reader->file_version_pre_migration().to_string();
     }
 
-    void close() { reader = nullptr; }
+    pod5::FileReaderStatistics statistics() const { return reader->statistics(); }
+
+    // Find the signal batch holding [row], and the row's index within the batch.
+    std::pair<std::size_t, std::size_t> signal_batch_for_row_id(std::uint64_t row) const
+    {
+        std::size_t batch_row = 0;
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto batch, reader->signal_batch_for_row_id(row, &batch_row));
+        return {batch, batch_row};
+    }
+
+    // Find the file identifier, writing software and writing pod5 version stored in the read
+    // table's schema.
+    py::tuple schema_metadata() const
+    {
+        auto const metadata = reader->schema_metadata();
+        return py::make_tuple(
+            pod5::to_string(metadata.file_identifier),
+            metadata.writing_software,
+            metadata.writing_pod5_version.to_string());
+    }
+
+    std::size_t num_read_record_batches() const { return reader->num_read_record_batches(); }
+
+    std::size_t num_signal_record_batches() const { return reader->num_signal_record_batches(); }
+
+    // Check if the file's signal is stored compressed, rather than as raw samples.
+    bool is_signal_compressed() const
+    {
+        return reader->signal_type() != pod5::SignalType::UncompressedSignal;
+    }
+
+    // Find the codec of a file written with SignalType::CodecSignal, null for vbz files, which
+    // decompress_signal() decodes against their dictionary instead.
+    std::shared_ptr<pod5::SignalCodec const> codec_signal_codec() const
+    {
+        if (reader->signal_type() != pod5::SignalType::CodecSignal) {
+            return nullptr;
+        }
+        return reader->signal_codec();
+    }
+
+    // Decompress a signal row stored in this file into [signal_out], through the file's codec or
+    // against its signal compression dictionary if it has one.
+    void decompress_signal(
+        py::array_t<uint8_t, py::array::c_style | py::array::forcecast> const & compressed_signal,
+        py::array_t<std::int16_t, py::array::c_style | py::array::forcecast> & signal_out) const
+    {
+        auto const compressed =
+            gsl::make_span(compressed_signal.data(0), compressed_signal.shape(0));
+        auto const output = gsl::make_span(signal_out.mutable_data(0), signal_out.shape(0));
+        auto const dictionary = reader->signal_compression_dictionary();
+        auto const codec = codec_signal_codec();
+
+        py::gil_scoped_release release;
+        auto & context = pod5::thread_local_signal_compression_context();
+        context.set_dictionary(dictionary);
+        if (codec) {
+            throw_on_error(codec->decompress(compressed, context, output));
+            return;
+        }
+        throw_on_error(pod5::decompress_signal(compressed, context, output));
+    }
+
+    // Decompress a signal row stored in this file straight to picoamps, see decompress_signal().
+    void decompress_signal_pa(
+        py::array_t<uint8_t, py::array::c_style | py::array::forcecast> const & compressed_signal,
+        float calibration_offset,
+        float calibration_scale,
+        py::array_t<float, py::array::c_style | py::array::forcecast> & signal_out) const
+    {
+        auto const compressed =
+            gsl::make_span(compressed_signal.data(0), compressed_signal.shape(0));
+        auto const output = gsl::make_span(signal_out.mutable_data(0), signal_out.shape(0));
+        auto const dictionary = reader->signal_compression_dictionary();
+        auto const codec = codec_signal_codec();
+        pod5::SignalCalibration const calibration{calibration_offset, calibration_scale};
+
+        py::gil_scoped_release release;
+        auto & context = pod5::thread_local_signal_compression_context();
+        context.set_dictionary(dictionary);
+        if (codec) {
+            throw_on_error(codec->decompress_calibrated(compressed, context, calibration, output));
+            return;
+        }
+        throw_on_error(
+            pod5::decompress_signal_calibrated(compressed, context, calibration, output));
+    }
+
+    // Find the decimations reads' signal summaries are stored at, empty if the file has none.
+    std::vector<std::uint32_t> signal_summary_decimations() const
+    {
+        auto const summary = reader->signal_summary();
+        return summary ? summary->decimations() : std::vector<std::uint32_t>{};
+    }
+
+    // Find the min, max and mean arrays summarising the signal of [read_id] at [decimation], or
+    // None if the read has no summary at [decimation].
+    std::optional<py::tuple> signal_summary(
+        py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & read_id,
+        std::uint32_t decimation) const
+    {
+        if (read_id.size() != sizeof(pod5::Uuid)) {
+            throw std::runtime_error("Read id must be 16 bytes");
+        }
+        auto const summary = reader->signal_summary();
+        if (!summary) {
+            return std::nullopt;
+        }
+        pod5::Uuid const uuid{*reinterpret_cast<pod5::Uuid const *>(read_id.data())};
+
+        std::optional<pod5::SignalSummaryLevel> level;
+        {
+            py::gil_scoped_release release;
+            POD5_PYTHON_ASSIGN_OR_RAISE(level, summary->find_level(uuid, decimation));
+        }
+        if (!level) {
+            return std::nullopt;
+        }
+        return py::make_tuple(
+            make_owned_array(std::move(level->min)),
+            make_owned_array(std::move(level->max)),
+            make_owned_array(std::move(level->mean)));
+    }
+
+    // Read read table batch [index], loading only [columns] if any are given. The batch is the
+    // reader's own, shared with pyarrow without copying, so python needn't parse the table again.
+    std::shared_ptr<Pod5RecordBatch> read_batch(
+        std::size_t index,
+        std::vector<std::string> const & columns)
+    {
+        if (index >= reader->num_read_record_batches()) {
+            throw py::index_error("Read batch index out of range");
+        }
+        auto const projection = columns.empty() ? nullptr : read_table_projection(columns);
+
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(
+            auto const batch,
+            projection ? file_reader->read_read_record_batch(index, *projection)
+                       : file_reader->read_read_record_batch(index));
+        return std::make_shared<Pod5RecordBatch>(batch.batch());
+    }
+
+    // Read signal table batch [index] through the reader's signal batch cache, shared with
+    // pyarrow without copying.
+    std::shared_ptr<Pod5RecordBatch> signal_batch(std::size_t index)
+    {
+        if (index >= reader->num_signal_record_batches()) {
+            throw py::index_error("Signal batch index out of range");
+        }
+
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto const batch, file_reader->read_signal_record_batch(index));
+        return std::make_shared<Pod5RecordBatch>(batch.batch());
+    }
+
+    std::size_t num_run_info_record_batches() const
+    {
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto const count, reader->num_run_info_record_batches());
+        return count;
+    }
+
+    // Read run info table batch [index], migrated in place for files predating run info tables,
+    // shared with pyarrow without copying.
+    std::shared_ptr<Pod5RecordBatch> run_info_batch(std::size_t index)
+    {
+        if (index >= num_run_info_record_batches()) {
+            throw py::index_error("Run info batch index out of range");
+        }
+
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(
+            auto const batch, file_reader->read_run_info_record_batch(index));
+        return std::make_shared<Pod5RecordBatch>(batch.batch());
+    }
+
+    void close()
+    {
+        projections.clear();
+        reader = nullptr;
+    }
+
+    // Ready the reader to be used by processes forked after this call, see
+    // FileReader::prepare_for_fork().
+    void prepare_for_fork()
+    {
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
+        auto const status = file_reader->prepare_for_fork();
+        POD5_PYTHON_RETURN_NOT_OK(status);
+    }
 
     std::size_t plan_traversal(
         py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & read_id_data,
@@ -205,19 +656,140 @@ struct Pod5FileReaderPtr {
         py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> & batch_rows)
     {
         auto const read_id_count = read_id_data.shape(0);
+        auto const batch_counts_out = batch_counts.mutable_data();
+        auto const batch_rows_out = batch_rows.mutable_data();
+
+        // Held while the GIL is released, in case another thread closes the reader:
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
         auto search_input = pod5::ReadIdSearchInput(gsl::make_span(
             reinterpret_cast<pod5::Uuid const *>(read_id_data.data()), read_id_count));
 
         POD5_PYTHON_ASSIGN_OR_RAISE(
             auto find_success_count,
-            reader->search_for_read_ids(
+            file_reader->search_for_read_ids(
                 search_input,
-                gsl::make_span(batch_counts.mutable_data(), reader->num_read_record_batches()),
-                gsl::make_span(batch_rows.mutable_data(), read_id_count)));
+                gsl::make_span(batch_counts_out, file_reader->num_read_record_batches()),
+                gsl::make_span(batch_rows_out, read_id_count)));
 
         return find_success_count;
     }
 
+    // FileReader::set_signal_access_plan(), from the output of plan_traversal() or scan_reads().
+    void set_signal_access_plan(
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> const & batch_counts,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> const & batch_rows)
+    {
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
+        // Planned as Pod5AsyncSignalLoader loads reads:
+        auto const status = file_reader->set_signal_access_plan(
+            gsl::make_span(batch_counts.data(), batch_counts.size()),
+            gsl::make_span(batch_rows.data(), batch_rows.size()),
+            true);
+        POD5_PYTHON_RETURN_NOT_OK(status);
+    }
+
+    void clear_signal_access_plan()
+    {
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
+        auto const status = file_reader->clear_signal_access_plan();
+        POD5_PYTHON_RETURN_NOT_OK(status);
+    }
+
+    std::size_t scan_reads(
+        std::string const & expression,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> & batch_counts,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> & batch_rows)
+    {
+        auto const batch_counts_out = batch_counts.mutable_data();
+        auto const batch_rows_out = gsl::make_span(batch_rows.mutable_data(), batch_rows.shape(0));
+
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto predicate, pod5::ReadScanPredicate::parse(expression));
+        POD5_PYTHON_ASSIGN_OR_RAISE(
+            auto selected_count,
+            file_reader->scan_reads(
+                predicate,
+                gsl::make_span(batch_counts_out, file_reader->num_read_record_batches()),
+                batch_rows_out));
+
+        return selected_count;
+    }
+
+    // Iterate over the read table batches, loading only [columns] if any are given, with up to
+    // [prefetch_batches] batches read ahead of the caller.
+    std::shared_ptr<Pod5ReadBatchIterator> iterate_read_batches(
+        std::vector<std::string> const & columns,
+        std::size_t prefetch_batches)
+    {
+        pod5::ReadBatchIteratorOptions options;
+        options.set_prefetch_batches(prefetch_batches);
+        options.set_columns(columns);
+        options.set_thread_pool(shared_thread_pool_ptr());
+
+        auto const file_reader = reader;
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(
+            auto iterator, pod5::make_read_batch_iterator(file_reader, options));
+        return std::make_shared<Pod5ReadBatchIterator>(std::move(iterator));
+    }
+
+    // Find the signal of several reads calibrated to picoamps, decoding all their signal rows
+    // in parallel straight to picoamps.
+    //
+    // Read i's signal rows are signal_rows[signal_row_offsets[i]:signal_row_offsets[i + 1]], as
+    // in the read table's signal list column. Returns all reads' samples as one array, and the
+    // offset of each read's samples followed by the total sample count.
+    py::tuple get_signal_pa(
+        py::array_t<std::int64_t, py::array::c_style | py::array::forcecast> const &
+            signal_row_offsets,
+        py::array_t<std::uint64_t, py::array::c_style | py::array::forcecast> const & signal_rows,
+        py::array_t<float, py::array::c_style | py::array::forcecast> const & calibration_offsets,
+        py::array_t<float, py::array::c_style | py::array::forcecast> const & calibration_scales)
+    {
+        auto const calibrations = make_calibrations(calibration_offsets, calibration_scales);
+        if (std::size_t(signal_row_offsets.size()) != calibrations.size() + 1) {
+            throw std::runtime_error("Expected a signal row offset for each read, and the end");
+        }
+
+        auto const row_offsets = signal_row_offsets.data();
+        std::vector<gsl::span<std::uint64_t const>> reads_rows(calibrations.size());
+        for (std::size_t read = 0; read < reads_rows.size(); ++read) {
+            if (row_offsets[read] < 0 || row_offsets[read] > row_offsets[read + 1]
+                || row_offsets[read + 1] > signal_rows.size())
+            {
+                throw py::index_error("Signal row offsets out of range");
+            }
+            reads_rows[read] = gsl::make_span(
+                signal_rows.data() + row_offsets[read], row_offsets[read + 1] - row_offsets[read]);
+        }
+
+        auto const file_reader = reader;
+        std::vector<std::uint64_t> sample_offsets(reads_rows.size() + 1);
+        std::vector<float> samples;
+        {
+            py::gil_scoped_release release;
+            // The reads' rows are contiguous in [signal_rows], so are counted in one call:
+            auto const all_rows = gsl::make_span(
+                signal_rows.data() + row_offsets[0],
+                row_offsets[reads_rows.size()] - row_offsets[0]);
+            POD5_PYTHON_ASSIGN_OR_RAISE(
+                auto const sample_count, file_reader->extract_sample_count(all_rows));
+            samples.resize(sample_count);
+            throw_on_error(file_reader->extract_samples_calibrated_for_reads(
+                gsl::make_span(reads_rows),
+                gsl::make_span(calibrations),
+                gsl::make_span(samples),
+                gsl::make_span(sample_offsets),
+                shared_thread_pool()));
+        }
+        return py::make_tuple(
+            make_owned_array(std::move(samples)), make_owned_array(std::move(sample_offsets)));
+    }
+
     std::shared_ptr<Pod5AsyncSignalLoader> batch_get_signal(bool get_samples, bool get_sample_count)
     {
         return std::make_shared<Pod5AsyncSignalLoader>(
@@ -251,18 +823,233 @@ struct Pod5FileReaderPtr {
             std::move(batch_counts),
             std::move(batch_rows));
     }
+
+    // Stream the samples of the selected reads, or of every read if [batch_counts] is empty,
+    // loading a bounded distance ahead of the caller on the shared thread pool.
+    std::shared_ptr<Pod5AsyncSignalLoader> stream_signal(
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> && batch_counts,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> && batch_rows,
+        std::size_t max_pending_batches,
+        std::uint64_t max_pending_bytes)
+    {
+        return std::make_shared<Pod5AsyncSignalLoader>(
+            reader,
+            pod5::AsyncSignalLoader::SamplesMode::Samples,
+            std::move(batch_counts),
+            std::move(batch_rows),
+            shared_thread_pool_ptr(),
+            max_pending_batches,
+            max_pending_bytes);
+    }
+
+    // Find the projection loading [columns], made on first use.
+    std::shared_ptr<pod5::ReadTableProjection const> read_table_projection(
+        std::vector<std::string> columns)
+    {
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+        auto const found = projections.find(columns);
+        if (found != projections.end()) {
+            return found->second;
+        }
+
+        auto projection = reader->make_read_table_projection(columns);
+        if (!projection.ok()) {
+            // Unknown columns are reported as pyarrow's projections reported them:
+            if (projection.status().IsInvalid()) {
+                throw py::key_error(projection.status().message());
+            }
+            raise_error(projection);
+        }
+        projections.emplace(std::move(columns), *projection);
+        return *projection;
+    }
+
+    // Projections made for read_batch(), by their sorted column names:
+    std::map<std::vector<std::string>, std::shared_ptr<pod5::ReadTableProjection const>>
+        projections;
 };
 
 inline Pod5FileReaderPtr open_file(char const * filename)
 {
+    py::gil_scoped_release release;
     POD5_PYTHON_ASSIGN_OR_RAISE(auto reader, pod5::open_file_reader(filename, {}));
     return Pod5FileReaderPtr(std::move(reader));
 }
 
+struct Pod5DatasetReaderPtr {
+    std::shared_ptr<pod5::DatasetReader> dataset = nullptr;
+
+    Pod5DatasetReaderPtr(std::shared_ptr<pod5::DatasetReader> && dataset_)
+    : dataset(std::move(dataset_))
+    {
+    }
+
+    std::size_t file_count() const { return dataset->file_count(); }
+
+    std::string file_path(std::size_t file) const
+    {
+        if (file >= dataset->file_count()) {
+            throw py::index_error("Dataset file index out of range");
+        }
+        return dataset->file_path(file);
+    }
+
+    std::size_t open_file_count() const { return dataset->open_file_count(); }
+
+    Pod5FileReaderPtr get_file_reader(std::size_t file) const
+    {
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto reader, dataset->file_reader(file));
+        return Pod5FileReaderPtr(std::move(reader));
+    }
+
+    std::size_t read_count()
+    {
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto read_count, dataset->read_count());
+        return read_count;
+    }
+
+    bool has_duplicate_read_ids()
+    {
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto index, dataset->index());
+        return index->has_duplicate_read_ids();
+    }
+
+    void build_index()
+    {
+        py::gil_scoped_release release;
+        throw_on_error(dataset->build_index());
+    }
+
+    void load_index(std::string const & path)
+    {
+        py::gil_scoped_release release;
+        throw_on_error(dataset->load_index(path));
+    }
+
+    void write_index(std::string const & path)
+    {
+        py::gil_scoped_release release;
+        throw_on_error(dataset->write_index(path));
+    }
+
+    void update_index(std::string const & path)
+    {
+        py::gil_scoped_release release;
+        throw_on_error(dataset->update_index(path));
+    }
+
+    // Find the reads in [read_id_data], writing the location of each found read into
+    // [files], [batches] and [batch_rows] in traversal order.
+    std::size_t plan_traversal(
+        py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & read_id_data,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> & files,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> & batches,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> & batch_rows)
+    {
+        std::size_t const read_id_count = read_id_data.shape(0);
+        if (std::size_t(files.shape(0)) < read_id_count
+            || std::size_t(batches.shape(0)) < read_id_count
+            || std::size_t(batch_rows.shape(0)) < read_id_count)
+        {
+            throw std::runtime_error("Dataset traversal outputs must be as long as the read ids");
+        }
+
+        auto read_ids = gsl::make_span(
+            reinterpret_cast<pod5::Uuid const *>(read_id_data.data()), read_id_count);
+        std::vector<pod5::DatasetReadLocation> locations(read_id_count);
+        std::size_t find_success_count = 0;
+        {
+            py::gil_scoped_release release;
+            POD5_PYTHON_ASSIGN_OR_RAISE(
+                find_success_count,
+                dataset->search_for_read_ids(read_ids, gsl::make_span(locations)));
+        }
+
+        auto files_out = files.mutable_data();
+        auto batches_out = batches.mutable_data();
+        auto batch_rows_out = batch_rows.mutable_data();
+        for (std::size_t i = 0; i < find_success_count; ++i) {
+            files_out[i] = locations[i].file;
+            batches_out[i] = locations[i].batch;
+            batch_rows_out[i] = locations[i].batch_row;
+        }
+        return find_success_count;
+    }
+};
+
+inline Pod5DatasetReaderPtr open_dataset(
+    std::vector<std::string> paths,
+    std::size_t max_open_files,
+    std::size_t index_threads)
+{
+    pod5::DatasetReaderOptions options;
+    options.set_max_open_files(max_open_files);
+    options.set_index_threads(index_threads);
+    py::gil_scoped_release release;
+    POD5_PYTHON_ASSIGN_OR_RAISE(auto dataset, pod5::open_dataset_reader(std::move(paths), options));
+    return Pod5DatasetReaderPtr(std::move(dataset));
+}
+
 inline void write_updated_file_to_dest(Pod5FileReaderPtr source, char const * dest_filename)
 {
-    POD5_PYTHON_RETURN_NOT_OK(
-        pod5::update_file(arrow::default_memory_pool(), source.reader, dest_filename));
+    py::gil_scoped_release release;
+    // Read table batches are migrated in parallel while the signal table is copied:
+    auto const thread_pool =
+        pod5::make_thread_pool(std::max(2u, std::thread::hardware_concurrency()));
+    POD5_PYTHON_RETURN_NOT_OK(pod5::update_file(
+        arrow::default_memory_pool(), source.reader, dest_filename, *thread_pool));
+}
+
+// Export the `pod5 view` table of the files at [paths], labelled [filenames], to the file
+// descriptor [output_fd], which is closed once written. Returns the number of reads written.
+inline std::uint64_t export_read_tables(
+    std::vector<std::string> const & paths,
+    std::vector<std::string> const & filenames,
+    int output_fd,
+    std::vector<std::string> const & fields,
+    std::string const & separator,
+    std::string const & format,
+    bool header,
+    std::size_t threads)
+{
+    // Owned from here, so closed on any error:
+    POD5_PYTHON_ASSIGN_OR_RAISE(auto const output, arrow::io::FileOutputStream::Open(output_fd));
+    if (paths.size() != filenames.size()) {
+        throw std::runtime_error("Expected a filename for each path");
+    }
+
+    pod5::ReadTableExportOptions options;
+    for (auto const & name : fields) {
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto const field, pod5::find_read_table_export_field(name));
+        options.fields.push_back(field);
+    }
+    if (format == "arrow") {
+        options.format = pod5::ReadTableExportFormat::Arrow;
+    } else if (format != "tsv") {
+        throw std::runtime_error("Unknown export format '" + format + "'");
+    }
+    options.separator = separator;
+    options.header = header;
+    threads = std::max<std::size_t>(threads, 1);
+    options.max_batches_in_flight = threads * 4;
+
+    py::gil_scoped_release release;
+    auto const thread_pool = pod5::make_thread_pool(threads);
+    POD5_PYTHON_ASSIGN_OR_RAISE(
+        auto const exporter,
+        pod5::ReadTableExporter::create(
+            output, options, thread_pool, arrow::default_memory_pool()));
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto const reader, pod5::open_file_reader(paths[i]));
+        throw_on_error(exporter->add_file(reader, filenames[i]));
+    }
+    throw_on_error(exporter->close());
+    throw_on_error(output->Close());
+    return exporter->reads_written();
 }
 
 inline pod5::RunInfoDictionaryIndex FileWriter_add_run_info(
@@ -419,6 +1206,7 @@ inline void FileWriter_add_reads(
             num_reads_since_mux_changes,
             time_since_mux_changes);
 
+        py::gil_scoped_release release;
         throw_on_error(w.add_complete_read(read_data, signal_span));
     }
 }
@@ -508,30 +1296,184 @@ inline void FileWriter_add_reads_pre_compressed(
             num_reads_since_mux_changes,
             time_since_mux_changes);
 
+        py::gil_scoped_release release;
         throw_on_error(w.add_complete_read(read_data, signal_rows, signal_duration_count));
     }
 }
 
+template <typename T>
+gsl::span<T const> column_span(
+    py::array_t<T, py::array::c_style | py::array::forcecast> const & column,
+    std::size_t count,
+    char const * name)
+{
+    if (static_cast<std::size_t>(column.size()) != count) {
+        throw std::runtime_error(
+            std::string("Column '") + name + "' does not hold a value for each read");
+    }
+    return gsl::make_span(column.data(), count);
+}
+
+inline void FileWriter_add_reads_columnar(
+    pod5::FileWriter & w,
+    std::size_t count,
+    py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & read_id_data,
+    py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> const & read_numbers,
+    py::array_t<std::uint64_t, py::array::c_style | py::array::forcecast> const & start_samples,
+    py::array_t<std::uint16_t, py::array::c_style | py::array::forcecast> const & channels,
+    py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & wells,
+    py::array_t<std::int16_t, py::array::c_style | py::array::forcecast> const & pore_types,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & calibration_offsets,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & calibration_scales,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & median_befores,
+    py::array_t<std::int16_t, py::array::c_style | py::array::forcecast> const & end_reasons,
+    py::array_t<bool, py::array::c_style | py::array::forcecast> const & end_reason_forceds,
+    py::array_t<std::int16_t, py::array::c_style | py::array::forcecast> const & run_infos,
+    py::array_t<std::uint64_t, py::array::c_style | py::array::forcecast> const &
+        num_minknow_events,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & tracked_scaling_scales,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & tracked_scaling_shifts,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & predicted_scaling_scales,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & predicted_scaling_shifts,
+    py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> const &
+        num_reads_since_mux_changes,
+    py::array_t<float, py::array::c_style | py::array::forcecast> const & time_since_mux_changes,
+    py::array_t<std::int16_t, py::array::c_style | py::array::forcecast> const & signal,
+    py::array_t<std::uint64_t, py::array::c_style | py::array::forcecast> const & signal_offsets)
+{
+    if (read_id_data.ndim() != 2 || read_id_data.shape(1) != 16
+        || static_cast<std::size_t>(read_id_data.shape(0)) != count)
+    {
+        throw std::runtime_error("Read id array is of unexpected size");
+    }
+
+    // The columns are viewed in place, numpy arrays already of the right type aren't copied:
+    pod5::ReadDataColumns columns;
+    columns.read_id =
+        gsl::make_span(reinterpret_cast<pod5::Uuid const *>(read_id_data.data()), count);
+    columns.read_number = column_span(read_numbers, count, "read_number");
+    columns.start_sample = column_span(start_samples, count, "start_sample");
+    columns.median_before = column_span(median_befores, count, "median_before");
+    columns.end_reason = column_span(end_reasons, count, "end_reason");
+    columns.end_reason_forced = column_span(end_reason_forceds, count, "end_reason_forced");
+    columns.run_info = column_span(run_infos, count, "run_info");
+    columns.num_minknow_events = column_span(num_minknow_events, count, "num_minknow_events");
+    columns.tracked_scaling_scale =
+        column_span(tracked_scaling_scales, count, "tracked_scaling_scale");
+    columns.tracked_scaling_shift =
+        column_span(tracked_scaling_shifts, count, "tracked_scaling_shift");
+    columns.predicted_scaling_scale =
+        column_span(predicted_scaling_scales, count, "predicted_scaling_scale");
+    columns.predicted_scaling_shift =
+        column_span(predicted_scaling_shifts, count, "predicted_scaling_shift");
+    columns.num_reads_since_mux_change =
+        column_span(num_reads_since_mux_changes, count, "num_reads_since_mux_change");
+    columns.time_since_mux_change =
+        column_span(time_since_mux_changes, count, "time_since_mux_change");
+    columns.channel = column_span(channels, count, "channel");
+    columns.well = column_span(wells, count, "well");
+    columns.pore_type = column_span(pore_types, count, "pore_type");
+    columns.calibration_offset = column_span(calibration_offsets, count, "calibration_offset");
+    columns.calibration_scale = column_span(calibration_scales, count, "calibration_scale");
+
+    auto const offsets = column_span(signal_offsets, count + 1, "signal_offsets");
+    auto const sample_count = static_cast<std::uint64_t>(signal.size());
+    std::vector<gsl::span<std::int16_t const>> signals;
+    signals.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > sample_count) {
+            throw std::runtime_error("Signal offsets are out of order or beyond the signal");
+        }
+        signals.emplace_back(signal.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    py::gil_scoped_release release;
+    throw_on_error(w.add_reads(columns, signals));
+}
+
 inline void decompress_signal_wrapper(
     py::array_t<uint8_t, py::array::c_style | py::array::forcecast> const & compressed_signal,
     py::array_t<std::int16_t, py::array::c_style | py::array::forcecast> & signal_out)
 {
-    throw_on_error(pod5::decompress_signal(
-        gsl::make_span(compressed_signal.data(0), compressed_signal.shape(0)),
-        arrow::system_memory_pool(),
-        gsl::make_span(signal_out.mutable_data(0), signal_out.shape(0))));
+    auto const compressed = gsl::make_span(compressed_signal.data(0), compressed_signal.shape(0));
+    auto const output = gsl::make_span(signal_out.mutable_data(0), signal_out.shape(0));
+
+    py::gil_scoped_release release;
+    throw_on_error(pod5::decompress_signal(compressed, arrow::system_memory_pool(), output));
+}
+
+inline void decompress_signal_pa_wrapper(
+    py::array_t<uint8_t, py::array::c_style | py::array::forcecast> const & compressed_signal,
+    float calibration_offset,
+    float calibration_scale,
+    py::array_t<float, py::array::c_style | py::array::forcecast> & signal_out)
+{
+    auto const compressed = gsl::make_span(compressed_signal.data(0), compressed_signal.shape(0));
+    auto const output = gsl::make_span(signal_out.mutable_data(0), signal_out.shape(0));
+
+    py::gil_scoped_release release;
+    auto & context = pod5::thread_local_signal_compression_context();
+    context.set_dictionary(nullptr);
+    throw_on_error(pod5::decompress_signal_calibrated(
+        compressed,
+        context,
+        pod5::SignalCalibration{calibration_offset, calibration_scale},
+        output));
+}
+
+inline py::array_t<float> calibrate_signal_wrapper(
+    py::array_t<std::int16_t, py::array::c_style | py::array::forcecast> const & signal,
+    float calibration_offset,
+    float calibration_scale)
+{
+    auto const input = gsl::make_span(signal.data(), signal.shape(0));
+    std::vector<float> output(input.size());
+    {
+        py::gil_scoped_release release;
+        pod5::calibrate_signal(
+            input,
+            pod5::SignalCalibration{calibration_offset, calibration_scale},
+            gsl::make_span(output));
+    }
+    return make_owned_array(std::move(output));
 }
 
 inline std::size_t compress_signal_wrapper(
     py::array_t<std::int16_t, py::array::c_style | py::array::forcecast> const & signal,
     py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> & compressed_signal_out)
 {
-    auto size = throw_on_error(pod5::compress_signal(
-        gsl::make_span(signal.data(), signal.shape(0)),
-        arrow::system_memory_pool(),
-        gsl::make_span(compressed_signal_out.mutable_data(), compressed_signal_out.shape(0))));
+    auto const input = gsl::make_span(signal.data(), signal.shape(0));
+    auto const output =
+        gsl::make_span(compressed_signal_out.mutable_data(), compressed_signal_out.shape(0));
 
-    return size;
+    py::gil_scoped_release release;
+    return throw_on_error(pod5::compress_signal(input, arrow::system_memory_pool(), output));
+}
+
+inline std::map<std::string, pod5::MemoryPoolStatistics> memory_statistics()
+{
+    std::map<std::string, pod5::MemoryPoolStatistics> result;
+    for (std::size_t i = 0; i < pod5::MEMORY_SUBSYSTEM_COUNT; ++i) {
+        auto const subsystem = pod5::MemorySubsystem(i);
+        result[pod5::memory_subsystem_name(subsystem)] =
+            pod5::subsystem_memory_pool(subsystem).statistics();
+    }
+    return result;
+}
+
+inline void set_memory_limit(std::string const & subsystem_name, std::int64_t max_bytes)
+{
+    if (max_bytes < 0) {
+        throw std::runtime_error("Memory limit must not be negative");
+    }
+    for (std::size_t i = 0; i < pod5::MEMORY_SUBSYSTEM_COUNT; ++i) {
+        auto const subsystem = pod5::MemorySubsystem(i);
+        if (subsystem_name == pod5::memory_subsystem_name(subsystem)) {
+            pod5::subsystem_memory_pool(subsystem).set_max_bytes(max_bytes);
+            return;
+        }
+    }
+    throw std::runtime_error("Unknown memory subsystem '" + subsystem_name + "'");
 }
 
 inline std::size_t vbz_compressed_signal_max_size(std::size_t sample_count)
@@ -539,6 +1481,84 @@ inline std::size_t vbz_compressed_signal_max_size(std::size_t sample_count)
     return pod5::compressed_signal_max_size(sample_count);
 }
 
+// Train a signal compression dictionary on [signals], returning the dictionary's bytes for
+// FileWriterOptions.signal_compression_dictionary.
+inline py::bytes train_signal_compression_dictionary_wrapper(
+    std::vector<py::array_t<std::int16_t, py::array::c_style | py::array::forcecast>> const &
+        signals,
+    std::size_t max_dictionary_size)
+{
+    std::vector<gsl::span<std::int16_t const>> samples;
+    samples.reserve(signals.size());
+    for (auto const & signal : signals) {
+        samples.emplace_back(signal.data(), signal.shape(0));
+    }
+
+    std::shared_ptr<pod5::SignalCompressionDictionary const> dictionary;
+    {
+        py::gil_scoped_release release;
+        POD5_PYTHON_ASSIGN_OR_RAISE(
+            dictionary,
+            pod5::train_signal_compression_dictionary(
+                gsl::make_span(samples), max_dictionary_size));
+    }
+    auto const & data = dictionary->data();
+    return py::bytes(reinterpret_cast<char const *>(data->data()), data->size());
+}
+
+// Find the bytes of the dictionary [options] compress signal against, or None if unset.
+inline std::optional<py::bytes> FileWriterOptions_signal_compression_dictionary(
+    pod5::FileWriterOptions const & options)
+{
+    auto const & dictionary = options.signal_compression_dictionary();
+    if (!dictionary) {
+        return std::nullopt;
+    }
+    auto const & data = dictionary->data();
+    return py::bytes(reinterpret_cast<char const *>(data->data()), data->size());
+}
+
+// Set the dictionary [options] compress signal against from its bytes, or clear it with None.
+inline void FileWriterOptions_set_signal_compression_dictionary(
+    pod5::FileWriterOptions & options,
+    std::optional<py::bytes> const & dictionary_data)
+{
+    if (!dictionary_data) {
+        options.set_signal_compression_dictionary(nullptr);
+        return;
+    }
+    POD5_PYTHON_ASSIGN_OR_RAISE(
+        auto const dictionary,
+        pod5::SignalCompressionDictionary::make(
+            arrow::Buffer::FromString(std::string(*dictionary_data))));
+    options.set_signal_compression_dictionary(dictionary);
+}
+
+// Find the id of the codec [options] compress SignalType::CodecSignal signal with, if set.
+inline std::optional<std::string> FileWriterOptions_signal_codec_id(
+    pod5::FileWriterOptions const & options)
+{
+    auto const & codec = options.signal_codec();
+    if (!codec) {
+        return std::nullopt;
+    }
+    return codec->id();
+}
+
+// Set the codec [options] compress SignalType::CodecSignal signal with to the registered codec
+// with [codec_id], or clear it with None.
+inline void FileWriterOptions_set_signal_codec_id(
+    pod5::FileWriterOptions & options,
+    std::optional<std::string> const & codec_id)
+{
+    if (!codec_id) {
+        options.set_signal_codec(nullptr);
+        return;
+    }
+    POD5_PYTHON_ASSIGN_OR_RAISE(auto const codec, pod5::find_signal_codec(*codec_id));
+    options.set_signal_codec(codec);
+}
+
 inline std::size_t load_read_id_iterable(
     py::iterable const & read_ids_str,
     py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> & read_id_data_out)
@@ -553,8 +1573,20 @@ inline std::size_t load_read_id_iterable(
             throw std::runtime_error("Too many input uuids for output container");
         }
 
-        temp_uuid = read_id.cast<py::str>();
-        if (auto const found_uuid = pod5::Uuid::from_string(temp_uuid)) {
+        // Parse str objects' own utf8 data, rather than copying each to a std::string:
+        std::string_view uuid_str;
+        Py_ssize_t uuid_str_size = 0;
+        char const * uuid_str_data = PyUnicode_Check(read_id.ptr())
+                                         ? PyUnicode_AsUTF8AndSize(read_id.ptr(), &uuid_str_size)
+                                         : nullptr;
+        if (uuid_str_data) {
+            uuid_str = std::string_view{uuid_str_data, std::size_t(uuid_str_size)};
+        } else {
+            PyErr_Clear();
+            temp_uuid = read_id.cast<py::str>();
+            uuid_str = temp_uuid;
+        }
+        if (auto const found_uuid = pod5::parse_uuid(uuid_str)) {
             read_ids[out_idx++] = *found_uuid;
         }
         // if it's invalid, ignore it - we will return one fewer read ids than expected and the caller can deal with it.
@@ -571,15 +1603,17 @@ inline py::list format_read_id_to_str(
             "Unexpected amount of data for read id - expected data to align to 16 bytes.");
     }
 
-    py::list result;
-
-    std::array<char, 37> str_data;
+    // Format every id at once, then make each string from its slice of the formatted ids:
     std::size_t const count = read_id_data_out.size() / 16;
-    for (std::size_t i = 0; i < count; ++i) {
-        auto read_id_data = read_id_data_out.data() + (i * 16);
+    std::vector<char> str_data(count * pod5::UUID_STRING_LENGTH);
+    pod5::format_uuids(
+        gsl::make_span(reinterpret_cast<pod5::Uuid const *>(read_id_data_out.data()), count),
+        str_data.data());
 
-        pod5_format_read_id(read_id_data, str_data.data());
-        result.append(py::str(str_data.data(), str_data.size() - 1));
+    py::list result(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        result[i] =
+            py::str(str_data.data() + i * pod5::UUID_STRING_LENGTH, pod5::UUID_STRING_LENGTH);
     }
 
     return result;
@@ -3,6 +3,8 @@
 #include "repack/repack_output.h"
 #include "repack/repacker.h"
 
+#include <chrono>
+
 PYBIND11_MODULE(pod5_format_pybind, m)
 {
     using namespace pod5;
@@ -13,8 +15,22 @@ PYBIND11_MODULE(pod5_format_pybind, m)
     py::enum_<SignalType>(m, "SignalType", py::arithmetic(), "SignalType enum")
         .value("UncompressedSignal", SignalType::UncompressedSignal, "Signal is not compressed")
         .value("VbzSignal", SignalType::VbzSignal, "Signal is compressed using vbz")
+        .value(
+            "VbzDictionarySignal",
+            SignalType::VbzDictionarySignal,
+            "Signal is compressed using vbz against a shared zstd dictionary")
+        .value(
+            "CodecSignal",
+            SignalType::CodecSignal,
+            "Signal is compressed by a registered codec, see FileWriterOptions.signal_codec_id")
         .export_values();
 
+    py::class_<SignalCompressionProfile>(m, "SignalCompressionProfile")
+        .def(py::init<>())
+        .def_readwrite("level", &SignalCompressionProfile::level)
+        .def_readwrite("strategy", &SignalCompressionProfile::strategy)
+        .def_readwrite("worker_count", &SignalCompressionProfile::worker_count);
+
     py::class_<FileWriterOptions>(m, "FileWriterOptions")
         .def(py::init([]() {
             FileWriterOptions options;
@@ -35,7 +51,23 @@ PYBIND11_MODULE(pod5_format_pybind, m)
         .def_property(
             "signal_compression_type",
             &FileWriterOptions::signal_type,
-            &FileWriterOptions::set_signal_type);
+            &FileWriterOptions::set_signal_type)
+        .def_property(
+            "signal_compression_profile",
+            &FileWriterOptions::signal_compression_profile,
+            &FileWriterOptions::set_signal_compression_profile)
+        .def_property(
+            "signal_compression_dictionary",
+            FileWriterOptions_signal_compression_dictionary,
+            FileWriterOptions_set_signal_compression_dictionary)
+        .def_property(
+            "signal_codec_id",
+            FileWriterOptions_signal_codec_id,
+            FileWriterOptions_set_signal_codec_id)
+        .def_property(
+            "signal_summary_decimations",
+            &FileWriterOptions::signal_summary_decimations,
+            &FileWriterOptions::set_signal_summary_decimations);
 
     py::class_<FileWriter, std::shared_ptr<FileWriter>>(m, "FileWriter")
         .def("close", [](pod5::FileWriter & w) { throw_on_error(w.close()); })
@@ -51,7 +83,8 @@ PYBIND11_MODULE(pod5_format_pybind, m)
             })
         .def("add_run_info", FileWriter_add_run_info)
         .def("add_reads", FileWriter_add_reads)
-        .def("add_reads_pre_compressed", FileWriter_add_reads_pre_compressed);
+        .def("add_reads_pre_compressed", FileWriter_add_reads_pre_compressed)
+        .def("add_reads_columnar", FileWriter_add_reads_columnar);
 
     py::class_<pod5::FileLocation>(m, "EmbeddedFileData")
         .def_readonly("file_path", &pod5::FileLocation::file_path)
@@ -60,13 +93,60 @@ PYBIND11_MODULE(pod5_format_pybind, m)
 
     py::class_<Pod5AsyncSignalLoader, std::shared_ptr<Pod5AsyncSignalLoader>>(
         m, "Pod5AsyncSignalLoader")
-        .def("release_next_batch", &Pod5AsyncSignalLoader::release_next_batch);
+        .def("release_next_batch", &Pod5AsyncSignalLoader::release_next_batch)
+        .def(
+            "release_next_completed_batch", &Pod5AsyncSignalLoader::release_next_completed_batch);
 
     py::class_<Pod5SignalCacheBatch, std::shared_ptr<Pod5SignalCacheBatch>>(
         m, "Pod5SignalCacheBatch")
         .def_property_readonly("batch_index", &Pod5SignalCacheBatch::batch_index)
         .def_property_readonly("sample_count", &Pod5SignalCacheBatch::sample_count)
-        .def_property_readonly("samples", &Pod5SignalCacheBatch::samples);
+        .def_property_readonly("samples", &Pod5SignalCacheBatch::samples)
+        .def_property_readonly("sample_offsets", &Pod5SignalCacheBatch::sample_offsets)
+        .def_property_readonly("all_samples", &Pod5SignalCacheBatch::all_samples)
+        .def(
+            "samples_pa",
+            &Pod5SignalCacheBatch::samples_pa,
+            py::arg("calibration_offsets"),
+            py::arg("calibration_scales"));
+
+    py::class_<Pod5RecordBatch, std::shared_ptr<Pod5RecordBatch>>(m, "Pod5RecordBatch")
+        .def_property_readonly("num_rows", &Pod5RecordBatch::num_rows)
+        .def(
+            "__arrow_c_array__",
+            &Pod5RecordBatch::arrow_c_array,
+            py::arg("requested_schema") = py::none());
+
+    py::class_<Pod5ReadBatchIterator, std::shared_ptr<Pod5ReadBatchIterator>>(
+        m, "Pod5ReadBatchIterator")
+        .def_property_readonly("batch_count", &Pod5ReadBatchIterator::batch_count)
+        .def("next_batch", &Pod5ReadBatchIterator::next_batch);
+
+    py::class_<pod5::FileReaderStatistics>(m, "FileReaderStatistics")
+        .def_readonly(
+            "run_info_table_bytes_read", &pod5::FileReaderStatistics::run_info_table_bytes_read)
+        .def_readonly("read_table_bytes_read", &pod5::FileReaderStatistics::read_table_bytes_read)
+        .def_readonly(
+            "signal_table_bytes_read", &pod5::FileReaderStatistics::signal_table_bytes_read)
+        .def_readonly(
+            "read_table_batches_decoded", &pod5::FileReaderStatistics::read_table_batches_decoded)
+        .def_readonly(
+            "signal_table_batches_decoded",
+            &pod5::FileReaderStatistics::signal_table_batches_decoded)
+        .def_readonly("signal_cache_hits", &pod5::FileReaderStatistics::signal_cache_hits)
+        .def_readonly("signal_cache_misses", &pod5::FileReaderStatistics::signal_cache_misses)
+        .def_readonly(
+            "signal_cache_evictions", &pod5::FileReaderStatistics::signal_cache_evictions)
+        .def_readonly("read_table_cache_hits", &pod5::FileReaderStatistics::read_table_cache_hits)
+        .def_readonly(
+            "read_table_cache_misses", &pod5::FileReaderStatistics::read_table_cache_misses)
+        .def_readonly(
+            "read_table_cache_evictions", &pod5::FileReaderStatistics::read_table_cache_evictions)
+        .def_readonly("decompressed_bytes", &pod5::FileReaderStatistics::decompressed_bytes)
+        .def_property_readonly(
+            "decompression_time_seconds", [](pod5::FileReaderStatistics const & statistics) {
+                return std::chrono::duration<double>(statistics.decompression_time).count();
+            });
 
     py::class_<Pod5FileReaderPtr>(m, "Pod5FileReader")
         .def(
@@ -75,12 +155,75 @@ PYBIND11_MODULE(pod5_format_pybind, m)
         .def("get_file_read_table_location", &Pod5FileReaderPtr::get_file_read_table_location)
         .def("get_file_signal_table_location", &Pod5FileReaderPtr::get_file_signal_table_location)
         .def("get_file_version_pre_migration", &Pod5FileReaderPtr::get_file_version_pre_migration)
+        .def("read_table_migrated", &Pod5FileReaderPtr::read_table_migrated)
+        .def("run_info_table_migrated", &Pod5FileReaderPtr::run_info_table_migrated)
+        .def("statistics", &Pod5FileReaderPtr::statistics)
+        .def(
+            "signal_batch_for_row_id",
+            &Pod5FileReaderPtr::signal_batch_for_row_id,
+            py::arg("row"))
         .def("plan_traversal", &Pod5FileReaderPtr::plan_traversal)
+        .def("prepare_for_fork", &Pod5FileReaderPtr::prepare_for_fork)
+        .def("scan_reads", &Pod5FileReaderPtr::scan_reads)
+        .def("set_signal_access_plan", &Pod5FileReaderPtr::set_signal_access_plan)
+        .def("clear_signal_access_plan", &Pod5FileReaderPtr::clear_signal_access_plan)
+        .def("schema_metadata", &Pod5FileReaderPtr::schema_metadata)
+        .def("num_read_record_batches", &Pod5FileReaderPtr::num_read_record_batches)
+        .def("num_signal_record_batches", &Pod5FileReaderPtr::num_signal_record_batches)
+        .def("is_signal_compressed", &Pod5FileReaderPtr::is_signal_compressed)
+        .def("decompress_signal", &Pod5FileReaderPtr::decompress_signal)
+        .def("decompress_signal_pa", &Pod5FileReaderPtr::decompress_signal_pa)
+        .def("signal_summary_decimations", &Pod5FileReaderPtr::signal_summary_decimations)
+        .def(
+            "signal_summary",
+            &Pod5FileReaderPtr::signal_summary,
+            py::arg("read_id"),
+            py::arg("decimation"))
+        .def(
+            "read_batch",
+            &Pod5FileReaderPtr::read_batch,
+            py::arg("index"),
+            py::arg("columns") = std::vector<std::string>{})
+        .def("signal_batch", &Pod5FileReaderPtr::signal_batch, py::arg("index"))
+        .def("num_run_info_record_batches", &Pod5FileReaderPtr::num_run_info_record_batches)
+        .def("run_info_batch", &Pod5FileReaderPtr::run_info_batch, py::arg("index"))
+        .def(
+            "iterate_read_batches",
+            &Pod5FileReaderPtr::iterate_read_batches,
+            py::arg("columns"),
+            py::arg("prefetch_batches"))
+        .def(
+            "get_signal_pa",
+            &Pod5FileReaderPtr::get_signal_pa,
+            py::arg("signal_row_offsets"),
+            py::arg("signal_rows"),
+            py::arg("calibration_offsets"),
+            py::arg("calibration_scales"))
         .def("batch_get_signal", &Pod5FileReaderPtr::batch_get_signal)
         .def("batch_get_signal_selection", &Pod5FileReaderPtr::batch_get_signal_selection)
         .def("batch_get_signal_batches", &Pod5FileReaderPtr::batch_get_signal_batches)
+        .def(
+            "stream_signal",
+            &Pod5FileReaderPtr::stream_signal,
+            py::arg("batch_counts"),
+            py::arg("batch_rows"),
+            py::arg("max_pending_batches"),
+            py::arg("max_pending_bytes") = pod5::AsyncSignalLoader::NO_PENDING_BYTES_LIMIT)
         .def("close", &Pod5FileReaderPtr::close);
 
+    py::class_<Pod5DatasetReaderPtr>(m, "Pod5DatasetReader")
+        .def("file_count", &Pod5DatasetReaderPtr::file_count)
+        .def("file_path", &Pod5DatasetReaderPtr::file_path)
+        .def("open_file_count", &Pod5DatasetReaderPtr::open_file_count)
+        .def("get_file_reader", &Pod5DatasetReaderPtr::get_file_reader)
+        .def("read_count", &Pod5DatasetReaderPtr::read_count)
+        .def("has_duplicate_read_ids", &Pod5DatasetReaderPtr::has_duplicate_read_ids)
+        .def("build_index", &Pod5DatasetReaderPtr::build_index)
+        .def("load_index", &Pod5DatasetReaderPtr::load_index)
+        .def("write_index", &Pod5DatasetReaderPtr::write_index)
+        .def("update_index", &Pod5DatasetReaderPtr::update_index)
+        .def("plan_traversal", &Pod5DatasetReaderPtr::plan_traversal);
+
     // Errors API
     m.def("get_error_string", &pod5_get_error_string, "Get the most recent error as a string");
 
@@ -96,6 +239,13 @@ PYBIND11_MODULE(pod5_format_pybind, m)
     // Opening files
     m.def("open_file", &open_file, "Open a POD5 file for reading");
     m.def("recover_file", &recover_file, "Recover a POD5 file which was not closed correctly");
+    m.def(
+        "open_dataset",
+        &open_dataset,
+        "Open a list of POD5 files for reading as one dataset",
+        py::arg("filenames"),
+        py::arg("max_open_files") = pod5::DatasetReaderOptions::DEFAULT_MAX_OPEN_FILES,
+        py::arg("index_threads") = pod5::DatasetReaderOptions::DEFAULT_INDEX_THREADS);
 
     m.def(
         "update_file",
@@ -104,25 +254,148 @@ PYBIND11_MODULE(pod5_format_pybind, m)
 
     // Signal API
     m.def("decompress_signal", &decompress_signal_wrapper, "Decompress a numpy array of signal");
+    m.def(
+        "decompress_signal_pa",
+        &decompress_signal_pa_wrapper,
+        "Decompress a numpy array of signal, calibrating it to picoamps");
+    m.def(
+        "calibrate_signal",
+        &calibrate_signal_wrapper,
+        "Calibrate a numpy array of signal to picoamps",
+        py::arg("signal"),
+        py::arg("calibration_offset"),
+        py::arg("calibration_scale"));
     m.def("compress_signal", &compress_signal_wrapper, "Compress a numpy array of signal");
     m.def("vbz_compressed_signal_max_size", &vbz_compressed_signal_max_size);
+    m.attr("VBZ_SIGNAL_CODEC_ID") = pod5::VBZ_SIGNAL_CODEC_ID;
+    m.def(
+        "train_signal_compression_dictionary",
+        &train_signal_compression_dictionary_wrapper,
+        "Train a zstd dictionary for VbzDictionarySignal files on some reads' signal",
+        py::arg("signals"),
+        py::arg("max_dictionary_size") = SignalCompressionDictionary::DEFAULT_MAX_SIZE);
+
+    // Memory API
+    py::class_<pod5::MemoryPoolStatistics>(m, "MemoryPoolStatistics")
+        .def_readonly("bytes_allocated", &pod5::MemoryPoolStatistics::bytes_allocated)
+        .def_readonly("peak_bytes_allocated", &pod5::MemoryPoolStatistics::peak_bytes_allocated)
+        .def_readonly("allocation_count", &pod5::MemoryPoolStatistics::allocation_count)
+        .def_readonly("failed_allocations", &pod5::MemoryPoolStatistics::failed_allocations)
+        .def_readonly("max_bytes", &pod5::MemoryPoolStatistics::max_bytes);
+    m.def(
+        "memory_statistics",
+        &memory_statistics,
+        "Find the memory allocated by each subsystem of every reader and writer, by name");
+    m.def(
+        "set_memory_limit",
+        &set_memory_limit,
+        "Limit the memory a subsystem of every reader and writer may allocate at once, 0 for no "
+        "limit",
+        py::arg("subsystem"),
+        py::arg("max_bytes"));
+    m.def(
+        "export_read_tables",
+        &export_read_tables,
+        "Export the pod5 view table of some files to a file descriptor",
+        py::arg("paths"),
+        py::arg("filenames"),
+        py::arg("output_fd"),
+        py::arg("fields"),
+        py::arg("separator"),
+        py::arg("format"),
+        py::arg("header"),
+        py::arg("threads"));
+    m.def("export_field_names", &pod5::read_table_export_field_names);
 
     // Repacker API
     py::class_<repack::Pod5RepackerOutput, std::shared_ptr<repack::Pod5RepackerOutput>>(
         m, "Pod5RepackerOutput");
 
+    py::enum_<repack::ReadOrder>(m, "RepackReadOrder", "Order reads are written to outputs in")
+        .value("AsAdded", repack::ReadOrder::AsAdded, "Reads are written as they are read")
+        .value("ReadId", repack::ReadOrder::ReadId, "Reads are sorted by read id")
+        .value(
+            "ChannelStartSample",
+            repack::ReadOrder::ChannelStartSample,
+            "Reads are sorted by channel, then start sample");
+
+    auto const seconds = [](std::chrono::nanoseconds time) {
+        return std::chrono::duration<double>(time).count();
+    };
+    py::class_<repack::RepackStateStatistics>(m, "RepackerStateStatistics")
+        .def_readonly("name", &repack::RepackStateStatistics::name)
+        .def_readonly("runs", &repack::RepackStateStatistics::runs)
+        .def_readonly("queued", &repack::RepackStateStatistics::queued)
+        .def_readonly("max_queued", &repack::RepackStateStatistics::max_queued)
+        .def_property_readonly(
+            "time_seconds",
+            [=](repack::RepackStateStatistics const & state) { return seconds(state.time); })
+        .def_property_readonly(
+            "max_time_seconds",
+            [=](repack::RepackStateStatistics const & state) { return seconds(state.max_time); })
+        .def_readonly("time_histogram", &repack::RepackStateStatistics::time_histogram);
+
+    py::class_<repack::RepackStatistics>(m, "RepackerStatistics")
+        .def_readonly("read_table_batches_read", &repack::RepackStatistics::read_table_batches_read)
+        .def_readonly("reads_read", &repack::RepackStatistics::reads_read)
+        .def_readonly("signal_batches_copied", &repack::RepackStatistics::signal_batches_copied)
+        .def_readonly("signal_bytes_copied", &repack::RepackStatistics::signal_bytes_copied)
+        .def_readonly("signal_batches_written", &repack::RepackStatistics::signal_batches_written)
+        .def_readonly("signal_rows_written", &repack::RepackStatistics::signal_rows_written)
+        .def_readonly("signal_bytes_written", &repack::RepackStatistics::signal_bytes_written)
+        .def_readonly("reads_written", &repack::RepackStatistics::reads_written)
+        .def_readonly("worker_concurrency", &repack::RepackStatistics::worker_concurrency)
+        .def_readonly("states", &repack::RepackStatistics::states);
+
+    py::class_<pod5::ThreadPoolStatistics>(m, "ThreadPoolStatistics")
+        .def_readonly("queued_tasks", &pod5::ThreadPoolStatistics::queued_tasks)
+        .def_readonly("running_tasks", &pod5::ThreadPoolStatistics::running_tasks)
+        .def_readonly("strand_queued_tasks", &pod5::ThreadPoolStatistics::strand_queued_tasks)
+        .def_readonly("tasks_run", &pod5::ThreadPoolStatistics::tasks_run)
+        .def_readonly("wait_time_histogram", &pod5::ThreadPoolStatistics::wait_time_histogram)
+        .def_readonly("run_time_histogram", &pod5::ThreadPoolStatistics::run_time_histogram)
+        .def_readonly("worker_busy_ratios", &pod5::ThreadPoolStatistics::worker_busy_ratios);
+
     py::class_<repack::Pod5Repacker, std::shared_ptr<repack::Pod5Repacker>>(m, "Repacker")
-        .def(py::init<>())
-        .def("add_output", &repack::Pod5Repacker::add_output)
+        .def(
+            py::init<std::size_t, bool>(),
+            py::arg("max_pending_bytes") = repack::Pod5Repacker::DEFAULT_MAX_PENDING_BYTES,
+            py::arg("adaptive_concurrency") = false)
+        .def(
+            "add_output",
+            &repack::Pod5Repacker::add_output,
+            py::arg("output"),
+            py::arg("check_duplicate_read_ids"),
+            py::arg("read_order") = repack::ReadOrder::AsAdded)
         .def("set_output_finished", &repack::Pod5Repacker::set_output_finished)
         .def("add_all_reads_to_output", &repack::Pod5Repacker::add_all_reads_to_output)
         .def("add_selected_reads_to_output", &repack::Pod5Repacker::add_selected_reads_to_output)
-        .def("finish", &repack::Pod5Repacker::finish)
+        .def(
+            "add_partitioned_reads_to_outputs",
+            &repack::Pod5Repacker::add_partitioned_reads_to_outputs,
+            py::arg("outputs"),
+            py::arg("input"),
+            py::arg("read_ids"),
+            py::arg("read_outputs"))
+        .def(
+            "add_read_ids_to_output",
+            &repack::Pod5Repacker::add_read_ids_to_output,
+            py::arg("output"),
+            py::arg("inputs"),
+            py::arg("read_ids"))
+        .def(
+            "finish",
+            &repack::Pod5Repacker::finish,
+            py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("is_complete", &repack::Pod5Repacker::is_complete)
         .def_property_readonly(
             "currently_open_file_reader_count",
             &repack::Pod5Repacker::currently_open_file_reader_count)
-        .def_property_readonly("reads_completed", &repack::Pod5Repacker::reads_completed);
+        .def_property_readonly("reads_completed", &repack::Pod5Repacker::reads_completed)
+        .def_property_readonly("pending_bytes", &repack::Pod5Repacker::pending_bytes)
+        .def_property_readonly("max_pending_bytes", &repack::Pod5Repacker::max_pending_bytes)
+        .def("statistics", &repack::Pod5Repacker::statistics)
+        .def("thread_pool_statistics", &repack::Pod5Repacker::thread_pool_statistics);
 
     // Util API
     m.def(
@@ -1,18 +1,21 @@
 #pragma once
 
+#include "pod5_format/file_writer.h"
 #include "pod5_format/internal/tracing/tracing.h"
 #include "pod5_format/read_table_reader.h"
+#include "pod5_format/schema_metadata.h"
 #include "pod5_format/signal_builder.h"
 #include "pod5_format/signal_table_schema.h"
 #include "pod5_format/uuid.h"
+#include "repack_sort.h"
 #include "repack_utils.h"
 
 #include <arrow/array/array_nested.h>
 #include <arrow/array/array_primitive.h>
 #include <arrow/array/builder_binary.h>
 
+#include <algorithm>
 #include <numeric>
-#include <unordered_set>
 
 namespace repack {
 
@@ -24,17 +27,30 @@ struct ReadReadData {
 
     std::vector<pod5::Uuid> signal_rows_read_ids;
     std::vector<std::uint64_t> signal_rows;
+
+    // Output rows of the signal rows in batches already copied to the output, by position in
+    // [signal_rows]:
+    std::vector<std::pair<std::size_t, pod5::SignalTableRowIndex>> copied_signal_rows;
+    // Positions in [signal_rows] of the rows whose signal is still to be copied:
+    std::vector<std::size_t> uncopied_signal_rows;
 };
 
 arrow::Result<ReadReadData> read_read_data(
     ReadsTableDictionaryThreadCache & reads_table_cache,
-    states::unread_read_table_rows && in_batch)
+    states::unread_read_table_rows && in_batch,
+    bool load_signal = true)
 {
     POD5_TRACE_FUNCTION();
 
     auto const & source_file = in_batch.input;
-    ARROW_ASSIGN_OR_RAISE(
-        auto source_read_table_batch, source_file->read_read_record_batch(in_batch.batch_index));
+    auto source_read_table_batch_ptr = std::move(in_batch.read_batch);
+    if (!source_read_table_batch_ptr) {
+        ARROW_ASSIGN_OR_RAISE(
+            auto read_batch, source_file->read_read_record_batch(in_batch.batch_index));
+        source_read_table_batch_ptr =
+            std::make_shared<pod5::ReadTableRecordBatch const>(std::move(read_batch));
+    }
+    auto const & source_read_table_batch = *source_read_table_batch_ptr;
 
     ARROW_ASSIGN_OR_RAISE(auto columns, source_read_table_batch.columns());
 
@@ -53,6 +69,19 @@ arrow::Result<ReadReadData> read_read_data(
         std::iota(batch_rows.begin(), batch_rows.end(), 0);
     }
 
+    // Remap the rows' pore type and run info indices to the output's, a column at a time:
+    std::vector<pod5::PoreDictionaryIndex> pore_indices(batch_rows.size());
+    std::vector<pod5::RunInfoDictionaryIndex> run_info_indices(batch_rows.size());
+    for (std::size_t batch_row_index = 0; batch_row_index < batch_rows.size(); ++batch_row_index) {
+        auto const batch_row = batch_rows[batch_row_index];
+        pore_indices[batch_row_index] = source_reads_pore_type_column->Value(batch_row);
+        run_info_indices[batch_row_index] = source_reads_run_info_column->Value(batch_row);
+    }
+    ARROW_RETURN_NOT_OK(reads_table_cache.remap_pore_indices(
+        source_file, source_read_table_batch, pore_indices, pore_indices));
+    ARROW_RETURN_NOT_OK(reads_table_cache.remap_run_info_indices(
+        source_file, source_read_table_batch, run_info_indices, run_info_indices));
+
     ReadReadData result;
     result.input = source_file;
     result.reads.reserve(batch_rows.size());
@@ -80,18 +109,9 @@ arrow::Result<ReadReadData> read_read_data(
         auto const & time_since_mux_change = columns.time_since_mux_change->Value(batch_row);
         auto const & num_samples = columns.num_samples->Value(batch_row);
 
-        auto const & pore_type_index = source_reads_pore_type_column->Value(batch_row);
         auto const & end_reason_index = source_reads_end_reason_column->Value(batch_row);
-        auto const & run_info_index = source_reads_run_info_column->Value(batch_row);
-
-        ARROW_ASSIGN_OR_RAISE(
-            auto dest_pore_index,
-            reads_table_cache.find_pore_index(
-                source_file, source_read_table_batch, pore_type_index));
-        ARROW_ASSIGN_OR_RAISE(
-            auto dest_run_info_index,
-            reads_table_cache.find_run_info_index(
-                source_file, source_read_table_batch, run_info_index));
+        auto const dest_pore_index = pore_indices[batch_row_index];
+        auto const dest_run_info_index = run_info_indices[batch_row_index];
 
         result.reads.emplace_back(
             read_id,
@@ -127,26 +147,52 @@ arrow::Result<ReadReadData> read_read_data(
         }
         result.signal_row_sizes.emplace_back(signal_rows_span.size());
     }
+
+    std::vector<std::uint64_t> rows_to_load;
+    rows_to_load.reserve(result.signal_rows.size());
+    auto const & copied_signal = in_batch.copied_signal;
+    for (std::size_t i = 0; i < result.signal_rows.size(); ++i) {
+        auto const signal_row = result.signal_rows[i];
+        if (copied_signal) {
+            // Find the last copied batch starting at or before the row:
+            auto const & source_first_rows = copied_signal->source_first_rows;
+            auto const next_batch =
+                std::upper_bound(source_first_rows.begin(), source_first_rows.end(), signal_row);
+            auto const batch = std::size_t(next_batch - source_first_rows.begin()) - 1;
+            if (next_batch != source_first_rows.end() && batch < copied_signal->first_rows.size())
+            {
+                auto const batch_row = signal_row - source_first_rows[batch];
+                result.copied_signal_rows.emplace_back(
+                    i, copied_signal->first_rows[batch] + batch_row);
+                continue;
+            }
+        }
+        result.uncopied_signal_rows.push_back(i);
+        rows_to_load.push_back(signal_row);
+    }
+
+    // Load the batch's signal with all reads in flight together, before it is copied row by row.
+    // Loading is only an optimisation - any real problem is reported when the signal is read:
+    if (load_signal) {
+        (void)source_file->load_signal_rows(rows_to_load);
+    }
     return result;
 }
 
 arrow::Status read_signal(
     std::shared_ptr<pod5::FileReader> const & source_file,
-    pod5::SignalType input_compression_type,
+    bool copy_compressed,
     std::uint64_t abs_signal_row,
     pod5::Uuid read_id,
-    pod5::SignalType output_compression_type,
     arrow::FixedSizeBinaryBuilder & read_id_builder,
     pod5::SignalBuilderVariant & signal_builder,
     arrow::UInt32Builder & samples_builder,
-    arrow::MemoryPool * pool)
+    pod5::SignalCompressionContext & compression_context,
+    std::shared_ptr<pod5::SignalCompressionDictionary const> const & output_dictionary)
 {
     auto signal_rows_span = gsl::make_span(&abs_signal_row, 1);
 
-    // If were using the same compression type in both files, just copy compressed:
-    if (input_compression_type == output_compression_type
-        && output_compression_type == pod5::SignalType::VbzSignal)
-    {
+    if (copy_compressed) {
         std::vector<uint32_t> sample_counts;
         ARROW_ASSIGN_OR_RAISE(
             auto extracted_signal,
@@ -170,9 +216,14 @@ arrow::Status read_signal(
         auto signal_buffer_span = gsl::make_span(signal);
         ARROW_RETURN_NOT_OK(source_file->extract_samples(signal_rows_span, signal_buffer_span));
 
+        // Extraction loads the source dictionary into the context, switch back for output:
+        compression_context.set_dictionary(output_dictionary);
+
         ARROW_RETURN_NOT_OK(read_id_builder.Append(read_id.data()));
         ARROW_RETURN_NOT_OK(
-            std::visit(pod5::visitors::append_signal{signal_buffer_span, pool}, signal_builder));
+            std::visit(
+                pod5::visitors::append_signal{signal_buffer_span, compression_context},
+                signal_builder));
         ARROW_RETURN_NOT_OK(samples_builder.Append(sample_count));
     }
     return arrow::Status::OK();
@@ -183,26 +234,82 @@ struct RequestedSignalReads {
     std::shared_ptr<states::read_split_signal_table_batch_rows> partial_request;
 };
 
+// Find if signal is stored the same way in [source_file] and the output, so it can be copied
+// compressed.
+bool is_signal_stored_alike(
+    pod5::FileReader const & source_file,
+    pod5::SignalType output_compression_type,
+    pod5::SignalCompressionProfile const & output_compression_profile,
+    std::shared_ptr<pod5::SignalCompressionDictionary const> const & output_dictionary)
+{
+    auto const source_dictionary = source_file.signal_compression_dictionary();
+    bool const same_dictionary =
+        output_compression_type == pod5::SignalType::VbzSignal
+        || (output_compression_type == pod5::SignalType::VbzDictionarySignal && source_dictionary
+            && output_dictionary && source_dictionary->id() == output_dictionary->id());
+    return source_file.signal_type() == output_compression_type && same_dictionary
+           && source_file.schema_metadata().signal_compression_profile
+                  == output_compression_profile;
+}
+
+// Find how many of [source_file]'s signal batches can be copied to [output] as they are stored.
+//
+// Signal rows are found by batch size, so batches are only copied between files with the same
+// batch size, and the last batch, which may be partial, is always copied row by row. Batches
+// only hold the output's columns if both files store signal checksums, or neither does.
+std::size_t copyable_signal_batch_count(
+    pod5::FileReader const & source_file,
+    pod5::FileWriter const & output)
+{
+    if (!is_signal_stored_alike(
+            source_file,
+            output.signal_type(),
+            output.signal_compression_profile(),
+            output.signal_compression_dictionary())
+        || source_file.has_signal_checksums() != output.writes_signal_checksums())
+    {
+        return 0;
+    }
+
+    auto const source_batch_size = source_file.signal_table_batch_size();
+    auto const batch_count = source_file.num_signal_record_batches();
+    if (!source_batch_size.ok() || *source_batch_size != output.signal_table_batch_size()
+        || batch_count < 2)
+    {
+        return 0;
+    }
+    return batch_count - 1;
+}
+
 arrow::Result<RequestedSignalReads> request_signal_reads(
     std::shared_ptr<pod5::FileReader> const & source_file,
     pod5::SignalType output_compression_type,
+    pod5::SignalCompressionProfile const & output_compression_profile,
+    std::shared_ptr<pod5::SignalCompressionDictionary const> const & output_dictionary,
     std::size_t signal_batch_size,
     std::vector<pod5::Uuid> read_ids,
     std::vector<std::uint64_t> signal_rows,
+    std::vector<std::size_t> const & dest_batch_row_indices,
     std::shared_ptr<states::read_split_signal_table_batch_rows> const & partial_request,
     std::shared_ptr<states::read_read_table_rows_no_signal> const & dest_read_table_rows,
     arrow::MemoryPool * pool)
 {
     POD5_TRACE_FUNCTION();
 
-    auto const input_signal_type = source_file->signal_type();
+    // If the signal is stored the same way in both files, just copy it compressed:
+    bool const copy_compressed = is_signal_stored_alike(
+        *source_file, output_compression_type, output_compression_profile, output_dictionary);
+
+    auto & compression_context = pod5::thread_local_signal_compression_context();
+    compression_context.set_profile(output_compression_profile);
 
     assert(read_ids.size() == signal_rows.size());
 
     RequestedSignalReads result;
     auto next_request = partial_request;
 
-    assert(signal_rows.size() == dest_read_table_rows->signal_row_indices.size());
+    assert(signal_rows.size() == dest_batch_row_indices.size());
+    assert(signal_rows.size() <= dest_read_table_rows->signal_row_indices.size());
 
     std::size_t signal_rows_position = 0;
     while (signal_rows_position < signal_rows.size()) {
@@ -218,20 +325,19 @@ arrow::Result<RequestedSignalReads> request_signal_reads(
             signal_batch_size - next_request->patch_rows.size());
 
         for (std::size_t i = 0; i < to_write; ++i) {
-            auto const dest_batch_row_index = signal_rows_position + i;
-            assert(dest_batch_row_index < signal_rows.size());
+            auto const dest_batch_row_index = dest_batch_row_indices[signal_rows_position + i];
             assert(dest_batch_row_index < dest_read_table_rows->signal_row_indices.size());
 
             ARROW_RETURN_NOT_OK(read_signal(
                 source_file,
-                input_signal_type,
+                copy_compressed,
                 signal_rows[signal_rows_position + i],
                 read_ids[signal_rows_position + i],
-                output_compression_type,
                 *next_request->read_id_builder,
                 next_request->signal_builder,
                 next_request->samples_builder,
-                pool));
+                compression_context,
+                output_dictionary));
 
             next_request->patch_rows.emplace_back(dest_read_table_rows, dest_batch_row_index);
         }
@@ -295,13 +401,74 @@ arrow::Status write_reads(
     return arrow::Status::OK();
 }
 
+// Write [reads] to [output] in order, with each read's signal rows following the rows of the
+// reads before it.
+arrow::Status write_sorted_reads(
+    std::shared_ptr<pod5::FileWriter> const & output,
+    std::vector<std::shared_ptr<pod5::FileReader>> const & inputs,
+    std::vector<bool> const & copy_compressed,
+    std::vector<SortedRead> const & reads)
+{
+    POD5_TRACE_FUNCTION();
+
+    // Load the signal of all the reads with the reads of each input in flight together.
+    // Loading is only an optimisation - any real problem is reported when the signal is read:
+    std::vector<std::vector<std::uint64_t>> input_signal_rows(inputs.size());
+    for (auto const & read : reads) {
+        auto & rows = input_signal_rows[read.input_index];
+        rows.insert(rows.end(), read.signal_rows.begin(), read.signal_rows.end());
+    }
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (!input_signal_rows[i].empty()) {
+            (void)inputs[i]->load_signal_rows(input_signal_rows[i]);
+        }
+    }
+
+    std::vector<pod5::SignalTableRowIndex> output_signal_rows;
+    for (auto const & read : reads) {
+        auto const & input = inputs[read.input_index];
+        output_signal_rows.clear();
+        for (auto const & signal_row : read.signal_rows) {
+            auto const signal_rows_span = gsl::make_span(&signal_row, 1);
+            if (copy_compressed[read.input_index]) {
+                std::vector<std::uint32_t> sample_counts;
+                ARROW_ASSIGN_OR_RAISE(
+                    auto extracted_signal,
+                    input->extract_samples_inplace(signal_rows_span, sample_counts));
+                assert(1 == extracted_signal.size());
+                auto const & signal_buffer = extracted_signal.front();
+                ARROW_ASSIGN_OR_RAISE(
+                    auto output_row,
+                    output->add_pre_compressed_signal(
+                        read.read.read_id,
+                        gsl::make_span(signal_buffer->data(), signal_buffer->size()),
+                        sample_counts.front()));
+                output_signal_rows.push_back(output_row);
+            } else {
+                ARROW_ASSIGN_OR_RAISE(
+                    auto sample_count, input->extract_sample_count(signal_rows_span));
+                std::vector<std::int16_t> signal(sample_count);
+                ARROW_RETURN_NOT_OK(
+                    input->extract_samples(signal_rows_span, gsl::make_span(signal)));
+                ARROW_ASSIGN_OR_RAISE(
+                    auto output_rows,
+                    output->add_signal(read.read.read_id, gsl::make_span(signal)));
+                output_signal_rows.insert(
+                    output_signal_rows.end(), output_rows.begin(), output_rows.end());
+            }
+        }
+        ARROW_RETURN_NOT_OK(output->add_complete_read(
+            read.read, gsl::make_span(output_signal_rows), read.num_samples));
+    }
+    return arrow::Status::OK();
+}
+
 arrow::Status check_duplicate_read_ids(
-    std::unordered_set<pod5::Uuid> & output_read_ids,
+    ReadIdSet & output_read_ids,
     std::vector<pod5::ReadData> const & new_reads)
 {
     for (auto const & read : new_reads) {
-        auto result = output_read_ids.insert(read.read_id);
-        if (!result.second) {
+        if (!output_read_ids.insert(read.read_id)) {
             return arrow::Status::Invalid(
                 "Duplicate read id ", to_string(read.read_id), " found in file");
         }
@@ -1,11 +1,13 @@
 #include "repack_output.h"
 
 #include "pod5_format/internal/tracing/tracing.h"
+#include "pod5_format/memory_pool.h"
 #include "repack_functions.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <thread>
-#include <unordered_set>
 
 namespace repack {
 
@@ -56,6 +58,7 @@ struct Pod5RepackerOutputState {
     Pod5RepackerOutputState(
         std::shared_ptr<pod5::FileWriter> const & _output_file,
         bool _check_duplicate_read_ids,
+        ReadOrder read_order,
         arrow::MemoryPool * _memory_pool)
     : output_file(_output_file)
     , check_duplicate_read_ids(_check_duplicate_read_ids)
@@ -63,6 +66,25 @@ struct Pod5RepackerOutputState {
     , dict_manager(
           std::make_shared<ReadsTableDictionaryManager>(_output_file, read_table_writer_mutex))
     {
+        if (read_order != ReadOrder::AsAdded) {
+            read_sorter = std::make_unique<ReadSorter>(
+                read_order,
+                _output_file->path() + ".sort-run-",
+                ReadSorter::DEFAULT_MAX_RUN_BYTES,
+                _memory_pool);
+        }
+    }
+
+    // Find the index of [input] in [sorted_inputs], adding it if it's new.
+    std::uint32_t sorted_input_index(std::shared_ptr<pod5::FileReader> const & input)
+    {
+        std::lock_guard<std::mutex> l{sorted_inputs_mutex};
+        auto const it = std::find(sorted_inputs.begin(), sorted_inputs.end(), input);
+        if (it != sorted_inputs.end()) {
+            return std::uint32_t(it - sorted_inputs.begin());
+        }
+        sorted_inputs.push_back(input);
+        return std::uint32_t(sorted_inputs.size() - 1);
     }
 
     Pod5RepackerOutputThreadState * get_thread_state()
@@ -89,7 +111,13 @@ struct Pod5RepackerOutputState {
     std::unordered_map<std::thread::id, Pod5RepackerOutputThreadState> thread_states;
 
     std::mutex output_read_ids_mutex;
-    std::unordered_set<pod5::Uuid> output_read_ids;
+    ReadIdSet output_read_ids;
+
+    // Set for outputs writing reads sorted, rather than in the order they are added:
+    std::unique_ptr<ReadSorter> read_sorter;
+    // Inputs of the reads held by [read_sorter], kept open until the reads are written:
+    std::mutex sorted_inputs_mutex;
+    std::vector<std::shared_ptr<pod5::FileReader>> sorted_inputs;
 };
 
 namespace {
@@ -106,18 +134,87 @@ struct StateProgressResult {
 };
 
 struct StateOperator {
-    StateOperator(Pod5RepackerOutputState * _progress_state) : progress_state(_progress_state) {}
+    StateOperator(
+        Pod5RepackerOutputState * _progress_state,
+        PendingBytesBudget * _pending_bytes_budget,
+        RepackStatisticsCounters * _statistics,
+        WorkerConcurrency * _worker_concurrency)
+    : progress_state(_progress_state)
+    , pending_bytes_budget(_pending_bytes_budget)
+    , statistics(_statistics)
+    , worker_concurrency(_worker_concurrency)
+    {
+    }
+
+    arrow::Result<StateProgressResult> operator()(
+        std::shared_ptr<states::uncopied_signal_table_batches> & batches) const
+    {
+        POD5_TRACE_SPAN("repack uncopied_signal_table_batches");
+
+        auto const & input = batches->input;
+        auto copied_signal = std::make_shared<states::copied_signal_batches>();
+        copied_signal->source_first_rows.reserve(batches->batch_count + 1);
+        for (std::size_t i = 0; i <= batches->batch_count; ++i) {
+            ARROW_ASSIGN_OR_RAISE(auto const first_row, input->signal_batch_first_row(i));
+            copied_signal->source_first_rows.push_back(first_row);
+        }
+        copied_signal->first_rows.reserve(batches->batch_count);
+        for (std::size_t i = 0; i < batches->batch_count; ++i) {
+            // Rows of batches which can't be read as stored are copied row by row instead, which
+            // reports any real problem with the batch:
+            auto message = input->read_signal_record_batch_message(i);
+            if (!message.ok()) {
+                break;
+            }
+
+            std::lock_guard<std::mutex> l(progress_state->signal_table_writer_mutex);
+            auto const row_count =
+                copied_signal->source_first_rows[i + 1] - copied_signal->source_first_rows[i];
+            ARROW_ASSIGN_OR_RAISE(
+                auto first_row,
+                progress_state->output_file->add_raw_signal_batch(**message, row_count));
+            copied_signal->first_rows.push_back(first_row);
+            statistics->signal_batches_copied += 1;
+            statistics->signal_bytes_copied += (*message)->body_length();
+            add_signal_work((*message)->body_length());
+        }
+
+        // The read table is then read, finding the copied rows:
+        std::vector<states::shared_variant> read_batches;
+        for (std::size_t i = 0; i < input->num_read_record_batches(); ++i) {
+            read_batches.emplace_back(std::make_shared<states::unread_read_table_rows>(
+                input, i, std::vector<std::uint32_t>{}, copied_signal));
+        }
+        return StateProgressResult{std::move(read_batches)};
+    }
 
     arrow::Result<StateProgressResult> operator()(
         std::shared_ptr<states::unread_read_table_rows> & batch) const
     {
-        POD5_TRACE_FUNCTION();
+        POD5_TRACE_SPAN("repack unread_read_table_rows");
 
-        // Read out the read table data from the source file
+        // Read out the read table data from the source file, sorted outputs read signal later:
+        bool const sorted_output = progress_state->read_sorter != nullptr;
         ARROW_ASSIGN_OR_RAISE(
             auto read_result,
-            read_read_data(progress_state->get_thread_state()->dict_cache, std::move(*batch)));
+            read_read_data(
+                progress_state->get_thread_state()->dict_cache,
+                std::move(*batch),
+                !sorted_output));
         batch.reset();
+        statistics->read_table_batches_read += 1;
+        statistics->reads_read += read_result.reads.size();
+
+        if (progress_state->check_duplicate_read_ids) {
+            std::lock_guard<std::mutex> l{progress_state->output_read_ids_mutex};
+            ARROW_RETURN_NOT_OK(
+                check_duplicate_read_ids(progress_state->output_read_ids, read_result.reads));
+        }
+
+        if (sorted_output) {
+            ARROW_RETURN_NOT_OK(sort_reads(std::move(read_result)));
+            return StateProgressResult{{}};
+        }
 
         auto read_table_rows = std::make_shared<states::read_read_table_rows_no_signal>();
         read_table_rows->reads = std::move(read_result.reads);
@@ -125,10 +222,22 @@ struct StateOperator {
         read_table_rows->signal_row_sizes = std::move(read_result.signal_row_sizes);
         read_table_rows->signal_row_indices.resize(read_result.signal_rows.size());
 
-        if (progress_state->check_duplicate_read_ids) {
-            std::lock_guard<std::mutex> l{progress_state->output_read_ids_mutex};
-            ARROW_RETURN_NOT_OK(
-                check_duplicate_read_ids(progress_state->output_read_ids, read_table_rows->reads));
+        // Rows already copied are patched before any signal batch below can complete the table:
+        for (auto const & copied_row : read_result.copied_signal_rows) {
+            read_table_rows->signal_row_indices[copied_row.first] = copied_row.second;
+        }
+        read_table_rows->written_row_indices += read_result.copied_signal_rows.size();
+        if (read_result.uncopied_signal_rows.empty()) {
+            return StateProgressResult{std::vector<states::shared_variant>{read_table_rows}};
+        }
+
+        std::vector<pod5::Uuid> uncopied_read_ids;
+        std::vector<std::uint64_t> uncopied_signal_rows;
+        uncopied_read_ids.reserve(read_result.uncopied_signal_rows.size());
+        uncopied_signal_rows.reserve(read_result.uncopied_signal_rows.size());
+        for (auto const position : read_result.uncopied_signal_rows) {
+            uncopied_read_ids.push_back(read_result.signal_rows_read_ids[position]);
+            uncopied_signal_rows.push_back(read_result.signal_rows[position]);
         }
 
         // Split the read table rows into new signal table batches:
@@ -139,14 +248,25 @@ struct StateOperator {
                 request_signal_reads(
                     read_result.input,
                     progress_state->output_file->signal_type(),
+                    progress_state->output_file->signal_compression_profile(),
+                    progress_state->output_file->signal_compression_dictionary(),
                     progress_state->output_file->signal_table_batch_size(),
-                    read_result.signal_rows_read_ids,
-                    read_result.signal_rows,
+                    std::move(uncopied_read_ids),
+                    std::move(uncopied_signal_rows),
+                    read_result.uncopied_signal_rows,
                     progress_state->partial_signal_batch,
                     read_table_rows,
                     progress_state->memory_pool));
 
             progress_state->partial_signal_batch = signal_request_result.partial_request;
+
+            // Complete batches are held until written, partial batches are at most one batch:
+            for (auto & request : signal_request_result.complete_requests) {
+                auto & signal_batch =
+                    *std::get<std::shared_ptr<states::read_split_signal_table_batch_rows>>(request);
+                signal_batch.pending_bytes = signal_batch.data_size();
+                pending_bytes_budget->add(signal_batch.pending_bytes);
+            }
             return StateProgressResult{std::move(signal_request_result.complete_requests)};
         }
     }
@@ -154,8 +274,9 @@ struct StateOperator {
     arrow::Result<StateProgressResult> operator()(
         std::shared_ptr<states::read_split_signal_table_batch_rows> & batch) const
     {
-        POD5_TRACE_FUNCTION();
+        POD5_TRACE_SPAN("repack read_split_signal_table_batch_rows");
 
+        auto const signal_bytes = batch->data_size();
         ARROW_ASSIGN_OR_RAISE(auto read_signal_result, read_signal_data(*batch));
 
         std::pair<pod5::SignalTableRowIndex, pod5::SignalTableRowIndex> inserted_signal_rows;
@@ -168,6 +289,11 @@ struct StateOperator {
                     std::move(read_signal_result.columns),
                     read_signal_result.final_batch));
         }
+        pending_bytes_budget->release(batch->pending_bytes);
+        statistics->signal_batches_written += 1;
+        statistics->signal_rows_written += read_signal_result.row_count;
+        statistics->signal_bytes_written += signal_bytes;
+        add_signal_work(signal_bytes);
 
         std::vector<states::shared_variant> result_new_states;
 
@@ -197,7 +323,7 @@ struct StateOperator {
     arrow::Result<StateProgressResult> operator()(
         std::shared_ptr<states::read_read_table_rows_no_signal> & batch) const
     {
-        POD5_TRACE_FUNCTION();
+        POD5_TRACE_SPAN("repack read_read_table_rows_no_signal");
         assert(batch->written_row_indices == batch->signal_row_indices.size());
 
         std::lock_guard<std::mutex> l(progress_state->read_table_writer_mutex);
@@ -208,13 +334,46 @@ struct StateOperator {
             batch->signal_row_sizes,
             batch->signal_row_indices));
         progress_state->reads_completed += batch->reads.size();
+        statistics->reads_written += batch->reads.size();
 
         return StateProgressResult{{}};
     }
 
+    arrow::Result<StateProgressResult> operator()(
+        std::shared_ptr<states::unwritten_sorted_reads> & batch) const
+    {
+        POD5_TRACE_SPAN("repack unwritten_sorted_reads");
+
+        auto const & output = progress_state->output_file;
+        auto const & inputs = progress_state->sorted_inputs;
+        std::vector<bool> copy_compressed;
+        for (auto const & input : inputs) {
+            copy_compressed.push_back(is_signal_stored_alike(
+                *input,
+                output->signal_type(),
+                output->signal_compression_profile(),
+                output->signal_compression_dictionary()));
+        }
+
+        // Reads are written one chunk after another, so their signal follows the same order:
+        ARROW_RETURN_NOT_OK(progress_state->read_sorter->write_sorted(
+            SORTED_READS_CHUNK_SIZE, [&](std::vector<SortedRead> && reads) -> arrow::Status {
+                ARROW_RETURN_NOT_OK(write_sorted_reads(output, inputs, copy_compressed, reads));
+                progress_state->reads_completed += reads.size();
+                statistics->reads_written += reads.size();
+                return arrow::Status::OK();
+            }));
+
+        // Removes the sorter's spilled runs:
+        progress_state->read_sorter.reset();
+        progress_state->sorted_inputs.clear();
+        return StateProgressResult{
+            std::vector<states::shared_variant>{std::make_shared<states::finished>()}};
+    }
+
     arrow::Result<StateProgressResult> operator()(std::shared_ptr<states::finished> & batch) const
     {
-        POD5_TRACE_FUNCTION();
+        POD5_TRACE_SPAN("repack finished");
 
         std::vector<states::shared_variant> final_states;
         // No further reads expected, flush all partial state:
@@ -229,7 +388,39 @@ struct StateOperator {
         return StateProgressResult{std::move(final_states)};
     }
 
+    // Number of sorted reads written together, loading their signal together:
+    static constexpr std::size_t SORTED_READS_CHUNK_SIZE = 1000;
+
+    arrow::Status sort_reads(ReadReadData && read_result) const
+    {
+        auto const input_index = progress_state->sorted_input_index(read_result.input);
+
+        std::vector<SortedRead> sorted_reads(read_result.reads.size());
+        auto signal_rows = read_result.signal_rows.begin();
+        for (std::size_t i = 0; i < sorted_reads.size(); ++i) {
+            auto & sorted_read = sorted_reads[i];
+            sorted_read.read = read_result.reads[i];
+            sorted_read.num_samples = read_result.signal_durations[i];
+            sorted_read.input_index = input_index;
+            sorted_read.signal_rows.assign(
+                signal_rows, signal_rows + read_result.signal_row_sizes[i]);
+            signal_rows += read_result.signal_row_sizes[i];
+        }
+        return progress_state->read_sorter->add(std::move(sorted_reads));
+    }
+
+    // Count [bytes] of signal moved towards the tuned worker concurrency's throughput:
+    void add_signal_work(std::size_t bytes) const
+    {
+        if (worker_concurrency) {
+            worker_concurrency->add_work(bytes);
+        }
+    }
+
     Pod5RepackerOutputState * progress_state;
+    PendingBytesBudget * pending_bytes_budget;
+    RepackStatisticsCounters * statistics;
+    WorkerConcurrency * worker_concurrency;
 };
 
 }  // namespace
@@ -237,15 +428,25 @@ struct StateOperator {
 Pod5RepackerOutput::Pod5RepackerOutput(
     std::shared_ptr<Pod5Repacker> const & repacker,
     std::shared_ptr<pod5::ThreadPool> thread_pool,
+    std::shared_ptr<PendingBytesBudget> pending_bytes_budget,
+    std::shared_ptr<RepackStatisticsCounters> statistics,
     std::shared_ptr<pod5::FileWriter> const & output,
-    bool check_duplicate_read_ids)
+    bool check_duplicate_read_ids,
+    ReadOrder read_order,
+    std::size_t worker_group,
+    std::shared_ptr<WorkerConcurrency> worker_concurrency)
 : m_repacker(repacker)
 , m_thread_pool(thread_pool)
+, m_worker_group(worker_group)
+, m_pending_bytes_budget(std::move(pending_bytes_budget))
+, m_statistics(std::move(statistics))
+, m_worker_concurrency(std::move(worker_concurrency))
 , m_output(output)
 , m_progress_state(std::make_unique<Pod5RepackerOutputState>(
       output,
       check_duplicate_read_ids,
-      arrow::default_memory_pool()))
+      read_order,
+      &pod5::subsystem_memory_pool(pod5::MemorySubsystem::Repacker)))
 {
 }
 
@@ -274,7 +475,12 @@ void Pod5RepackerOutput::set_finished()
 
         {
             std::lock_guard<std::mutex> l{m_active_read_table_states_mutex};
-            m_active_read_table_states.emplace_front(std::make_shared<states::finished>());
+            // Sorted outputs write their reads now all are known, then finish:
+            if (m_progress_state->read_sorter) {
+                queue_state(std::make_shared<states::unwritten_sorted_reads>());
+            } else {
+                queue_state(std::make_shared<states::finished>());
+            }
         }
         post_try_work();
 
@@ -287,8 +493,8 @@ bool Pod5RepackerOutput::is_complete() const
     if (!m_finished) {
         return false;
     }
-    std::lock_guard<std::mutex> l{m_active_read_table_states_mutex};
-    return m_active_read_table_states.empty();
+    // Sorted outputs write all their reads from one state, which is in flight until done:
+    return !has_tasks();
 }
 
 std::size_t Pod5RepackerOutput::reads_completed() const
@@ -299,37 +505,88 @@ std::size_t Pod5RepackerOutput::reads_completed() const
 void Pod5RepackerOutput::register_new_reads(
     std::shared_ptr<pod5::FileReader> const & input,
     std::size_t batch_index,
-    std::vector<std::uint32_t> && batch_rows)
+    std::vector<std::uint32_t> && batch_rows,
+    std::shared_ptr<pod5::ReadTableRecordBatch const> read_batch)
+{
+    if (m_finished) {
+        throw std::runtime_error("Failed to add reads to finished output");
+    }
+
+    {
+        std::lock_guard<std::mutex> l{m_active_read_table_states_mutex};
+        queue_state(std::make_shared<states::unread_read_table_rows>(
+            input, batch_index, std::move(batch_rows), nullptr, std::move(read_batch)));
+    }
+
+    post_try_work();
+}
+
+void Pod5RepackerOutput::register_all_reads(std::shared_ptr<pod5::FileReader> const & input)
 {
     if (m_finished) {
         throw std::runtime_error("Failed to add reads to finished output");
     }
 
+    // Sorted outputs copy reads in sorted order, so can't copy whole batches:
+    auto const copyable_batches =
+        m_progress_state->read_sorter ? 0 : copyable_signal_batch_count(*input, *m_output);
+    if (copyable_batches == 0) {
+        for (std::size_t i = 0; i < input->num_read_record_batches(); ++i) {
+            register_new_reads(input, i);
+        }
+        return;
+    }
+
     {
         std::lock_guard<std::mutex> l{m_active_read_table_states_mutex};
-        m_active_read_table_states.emplace_front(std::make_shared<states::unread_read_table_rows>(
-            input, batch_index, std::move(batch_rows)));
+        queue_state(
+            std::make_shared<states::uncopied_signal_table_batches>(input, copyable_batches));
     }
 
     post_try_work();
 }
 
+void Pod5RepackerOutput::queue_state(states::shared_variant && state)
+{
+    m_statistics->state_queued(state);
+    m_active_read_table_states.emplace_front(std::move(state));
+}
+
 void Pod5RepackerOutput::post_try_work()
 {
-    m_thread_pool->post([&]() {
+    auto try_work = [&]() {
         POD5_TRACE_FUNCTION();
 
-        auto get_next_work = [](auto & locked_states) -> states::shared_variant {
+        auto get_next_work = [&](auto & locked_states) -> states::shared_variant {
             if (locked_states.empty()) {
                 return {};
             }
 
-            auto work = locked_states.back();
-            locked_states.pop_back();
+            // Input batches aren't read while the budget is used up, other work writes out
+            // pending batches, releasing their bytes:
+            auto next = locked_states.rbegin();
+            if (m_pending_bytes_budget->is_used_up()) {
+                next = std::find_if(
+                    locked_states.rbegin(), locked_states.rend(), [](auto const & state) {
+                        using unread_rows = std::shared_ptr<states::unread_read_table_rows>;
+                        return !std::holds_alternative<unread_rows>(state);
+                    });
+                if (next == locked_states.rend()) {
+                    return {};
+                }
+            }
+
+            auto work = *next;
+            locked_states.erase(std::next(next).base());
+            m_statistics->state_dequeued(work);
             return work;
         };
 
-        StateOperator state_operator{m_progress_state.get()};
+        StateOperator state_operator{
+            m_progress_state.get(),
+            m_pending_bytes_budget.get(),
+            m_statistics.get(),
+            m_worker_concurrency.get()};
 
         states::shared_variant next_work;
         while (!m_has_error) {
@@ -342,11 +599,33 @@ void Pod5RepackerOutput::post_try_work()
                 std::lock_guard<std::mutex> l{m_active_read_table_states_mutex};
                 next_work = get_next_work(m_active_read_table_states);
                 if (!std::visit(is_not_nullptr{}, next_work)) {
-                    return;
+                    // Input batches held back by the budget are picked up again once it has room:
+                    if (m_active_read_table_states.empty()
+                        || m_pending_bytes_budget->pause(
+                            [this, paused = std::chrono::steady_clock::now()] {
+                                if (m_worker_concurrency) {
+                                    m_worker_concurrency->add_stall(
+                                        std::chrono::steady_clock::now() - paused);
+                                }
+                                post_try_work();
+                            }))
+                    {
+                        return;
+                    }
+                    continue;
                 }
             }
 
+            // Past the tuned concurrency, wait for a running state to finish first:
+            if (m_worker_concurrency) {
+                m_worker_concurrency->acquire();
+            }
+            auto const start = std::chrono::steady_clock::now();
             auto result = std::visit(state_operator, next_work);
+            m_statistics->state_ran(next_work, std::chrono::steady_clock::now() - start);
+            if (m_worker_concurrency) {
+                m_worker_concurrency->release();
+            }
             if (!result.ok()) {
                 set_error(result.status());
                 return;
@@ -357,11 +636,16 @@ void Pod5RepackerOutput::post_try_work()
                 std::lock_guard<std::mutex> l{m_active_read_table_states_mutex};
                 auto && states = m_active_read_table_states;
                 states.insert(states.end(), result->new_states.begin(), result->new_states.end());
+                for (auto const & state : result->new_states) {
+                    m_statistics->state_queued(state);
+                }
 
                 next_work = get_next_work(states);
             }
         }
-    });
+    };
+    // Keeping an output's work in one group keeps the batches it builds on one NUMA node:
+    m_thread_pool->post_to_group(std::move(try_work), m_worker_group);
 }
 
 }  // namespace repack
@@ -2,7 +2,10 @@
 
 #include "pod5_format/file_writer.h"
 #include "pod5_format/thread_pool.h"
+#include "repack_sort.h"
 #include "repack_states.h"
+#include "repack_statistics.h"
+#include "repack_utils.h"
 
 #include <atomic>
 #include <deque>
@@ -21,8 +24,15 @@ public:
     Pod5RepackerOutput(
         std::shared_ptr<Pod5Repacker> const & repacker,
         std::shared_ptr<pod5::ThreadPool> thread_pool,
+        std::shared_ptr<PendingBytesBudget> pending_bytes_budget,
+        std::shared_ptr<RepackStatisticsCounters> statistics,
         std::shared_ptr<pod5::FileWriter> const & output,
-        bool check_duplicate_read_ids);
+        bool check_duplicate_read_ids,
+        ReadOrder read_order = ReadOrder::AsAdded,
+        // The group of [thread_pool]'s workers to prefer for the output's work:
+        std::size_t worker_group = 0,
+        // Bounds the states run at once across the repacker's outputs, null for no bound:
+        std::shared_ptr<WorkerConcurrency> worker_concurrency = nullptr);
     ~Pod5RepackerOutput();
 
     std::string path() const { return m_output->path(); }
@@ -52,10 +62,20 @@ public:
     void register_new_reads(
         std::shared_ptr<pod5::FileReader> const & input,
         std::size_t batch_index,
-        std::vector<std::uint32_t> && batch_rows = {}  // All rows by default
-    );
+        std::vector<std::uint32_t> && batch_rows = {},  // All rows by default
+        // The batch, when the caller has read it already:
+        std::shared_ptr<pod5::ReadTableRecordBatch const> read_batch = nullptr);
+
+    // Register all reads of [input] to the output, should not be called after #set_reads_finished
+    //
+    // Whole signal batches are copied as they are stored in [input] where its signal is stored
+    // the same way as the output's, rebasing only the reads' signal rows.
+    void register_all_reads(std::shared_ptr<pod5::FileReader> const & input);
 
 private:
+    // Queue [state] to run next, expects m_active_read_table_states_mutex to be held.
+    void queue_state(states::shared_variant && state);
+
     void post_try_work();
 
     void set_error(arrow::Status error)
@@ -66,10 +86,16 @@ private:
             m_error = std::move(error);
         }
         m_has_error = true;
+        // This output's pending batches won't be written, so can't hold back other outputs:
+        m_pending_bytes_budget->stop();
     }
 
     std::shared_ptr<Pod5Repacker> m_repacker;
     std::shared_ptr<pod5::ThreadPool> m_thread_pool;
+    std::size_t m_worker_group;
+    std::shared_ptr<PendingBytesBudget> m_pending_bytes_budget;
+    std::shared_ptr<RepackStatisticsCounters> m_statistics;
+    std::shared_ptr<WorkerConcurrency> m_worker_concurrency;
     std::shared_ptr<pod5::FileWriter> m_output;
     std::atomic<bool> m_finished{false};
 
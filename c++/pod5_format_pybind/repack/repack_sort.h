@@ -0,0 +1,286 @@
+#pragma once
+
+#include "pod5_format/read_table_utils.h"
+
+#include <arrow/io/buffered.h>
+#include <arrow/io/file.h>
+#include <arrow/memory_pool.h>
+#include <arrow/util/io_util.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace repack {
+
+// Order reads are written to a repacker output in.
+enum class ReadOrder {
+    // The order reads are added to the output, as batches are read.
+    AsAdded,
+    // Sorted by read id.
+    ReadId,
+    // Sorted by channel, then the read's start sample.
+    ChannelStartSample,
+};
+
+// A read waiting to be written to a sorted output, with the input rows of its signal.
+struct SortedRead {
+    pod5::ReadData read;
+    std::uint64_t num_samples = 0;
+    // Index of the read's input, in the order inputs were first seen by the output:
+    std::uint32_t input_index = 0;
+    std::vector<std::uint64_t> signal_rows;
+
+    std::size_t data_size() const
+    {
+        return sizeof(SortedRead) + signal_rows.size() * sizeof(std::uint64_t);
+    }
+};
+
+struct SortedReadLess {
+    ReadOrder order;
+
+    bool operator()(SortedRead const & lhs, SortedRead const & rhs) const
+    {
+        if (order == ReadOrder::ChannelStartSample) {
+            return std::tie(lhs.read.channel, lhs.read.start_sample, lhs.read.read_id)
+                   < std::tie(rhs.read.channel, rhs.read.start_sample, rhs.read.read_id);
+        }
+        return lhs.read.read_id < rhs.read.read_id;
+    }
+};
+
+// Sorts the reads added to an output, spilling sorted runs of reads to files beside the output
+// once the reads held in memory reach a byte limit, and merging the runs once all reads are added.
+class ReadSorter {
+public:
+    static constexpr std::size_t DEFAULT_MAX_RUN_BYTES = 256 * 1024 * 1024;
+
+    ReadSorter(
+        ReadOrder order,
+        std::string run_path_prefix,
+        std::size_t max_run_bytes = DEFAULT_MAX_RUN_BYTES,
+        arrow::MemoryPool * pool = arrow::default_memory_pool())
+    : m_less{order}
+    , m_run_path_prefix(std::move(run_path_prefix))
+    , m_max_run_bytes(max_run_bytes)
+    , m_pool(pool)
+    {
+    }
+
+    ~ReadSorter()
+    {
+        for (auto const & path : m_run_paths) {
+            remove_run(path);
+        }
+    }
+
+    ReadOrder order() const { return m_less.order; }
+
+    // Add reads to be sorted, safe to call from many threads at once.
+    arrow::Status add(std::vector<SortedRead> && reads)
+    {
+        std::vector<SortedRead> full_run;
+        std::string full_run_path;
+        {
+            std::lock_guard<std::mutex> l{m_mutex};
+            for (auto & read : reads) {
+                m_run_bytes += read.data_size();
+                m_run.push_back(std::move(read));
+            }
+            if (m_run_bytes < m_max_run_bytes) {
+                return arrow::Status::OK();
+            }
+
+            // The full run is sorted and spilled without holding up other threads adding reads:
+            full_run.swap(m_run);
+            m_run_bytes = 0;
+            full_run_path = m_run_path_prefix + std::to_string(m_run_paths.size());
+            m_run_paths.push_back(full_run_path);
+        }
+        return write_run(std::move(full_run), full_run_path);
+    }
+
+    // Pass every read added to [write_reads] in sorted order, in chunks of [chunk_size] reads.
+    // Must be called once all reads are added.
+    template <typename WriteReads>
+    arrow::Status write_sorted(std::size_t chunk_size, WriteReads && write_reads)
+    {
+        std::lock_guard<std::mutex> l{m_mutex};
+        chunk_size = std::max<std::size_t>(chunk_size, 1);
+
+        // Reads which all fit in memory are never spilled:
+        if (m_run_paths.empty()) {
+            std::sort(m_run.begin(), m_run.end(), m_less);
+            for (std::size_t start = 0; start < m_run.size(); start += chunk_size) {
+                auto const end = std::min(start + chunk_size, m_run.size());
+                std::vector<SortedRead> chunk(
+                    std::make_move_iterator(m_run.begin() + start),
+                    std::make_move_iterator(m_run.begin() + end));
+                ARROW_RETURN_NOT_OK(write_reads(std::move(chunk)));
+            }
+            m_run.clear();
+            return arrow::Status::OK();
+        }
+
+        if (!m_run.empty()) {
+            auto const path = m_run_path_prefix + std::to_string(m_run_paths.size());
+            m_run_paths.push_back(path);
+            ARROW_RETURN_NOT_OK(write_run(std::exchange(m_run, {}), path));
+            m_run_bytes = 0;
+        }
+
+        // Merge the runs, holding the next read of each:
+        std::vector<std::unique_ptr<RunReader>> runs;
+        for (auto const & path : m_run_paths) {
+            ARROW_ASSIGN_OR_RAISE(auto run, RunReader::open(path, m_pool));
+            runs.push_back(std::move(run));
+        }
+        auto const run_greater = [&](std::size_t lhs, std::size_t rhs) {
+            return m_less(runs[rhs]->current(), runs[lhs]->current());
+        };
+        std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(run_greater)>
+            next_runs(run_greater);
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            ARROW_ASSIGN_OR_RAISE(auto const has_read, runs[i]->next());
+            if (has_read) {
+                next_runs.push(i);
+            }
+        }
+
+        std::vector<SortedRead> chunk;
+        chunk.reserve(chunk_size);
+        while (!next_runs.empty()) {
+            auto const run = next_runs.top();
+            next_runs.pop();
+            chunk.push_back(std::move(runs[run]->current()));
+            ARROW_ASSIGN_OR_RAISE(auto const has_read, runs[run]->next());
+            if (has_read) {
+                next_runs.push(run);
+            }
+
+            if (chunk.size() >= chunk_size) {
+                ARROW_RETURN_NOT_OK(write_reads(std::exchange(chunk, {})));
+                chunk.reserve(chunk_size);
+            }
+        }
+        if (!chunk.empty()) {
+            ARROW_RETURN_NOT_OK(write_reads(std::move(chunk)));
+        }
+        return arrow::Status::OK();
+    }
+
+private:
+    static_assert(
+        std::is_trivially_copyable<pod5::ReadData>::value,
+        "Reads are spilled to runs byte for byte");
+
+    // Reads one run spilled by write_run, read by read.
+    class RunReader {
+    public:
+        static arrow::Result<std::unique_ptr<RunReader>> open(
+            std::string const & path,
+            arrow::MemoryPool * pool)
+        {
+            ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::ReadableFile::Open(path, pool));
+            ARROW_ASSIGN_OR_RAISE(
+                auto stream, arrow::io::BufferedInputStream::Create(RUN_BUFFER_SIZE, pool, file));
+            return std::unique_ptr<RunReader>(new RunReader(std::move(stream)));
+        }
+
+        SortedRead & current() { return m_current; }
+
+        // Read the next read of the run into current(), returning false at the end of the run.
+        arrow::Result<bool> next()
+        {
+            ARROW_ASSIGN_OR_RAISE(
+                auto const read_bytes, m_stream->Read(sizeof(m_current.read), &m_current.read));
+            if (read_bytes == 0) {
+                return false;
+            }
+            if (read_bytes != std::int64_t(sizeof(m_current.read))) {
+                return arrow::Status::IOError("Truncated sort run");
+            }
+
+            std::uint32_t signal_row_count = 0;
+            ARROW_RETURN_NOT_OK(read_value(m_current.num_samples));
+            ARROW_RETURN_NOT_OK(read_value(m_current.input_index));
+            ARROW_RETURN_NOT_OK(read_value(signal_row_count));
+            m_current.signal_rows.resize(signal_row_count);
+            auto const rows_size = signal_row_count * sizeof(std::uint64_t);
+            ARROW_ASSIGN_OR_RAISE(
+                auto const rows_read, m_stream->Read(rows_size, m_current.signal_rows.data()));
+            if (rows_read != std::int64_t(rows_size)) {
+                return arrow::Status::IOError("Truncated sort run");
+            }
+            return true;
+        }
+
+    private:
+        RunReader(std::shared_ptr<arrow::io::BufferedInputStream> && stream)
+        : m_stream(std::move(stream))
+        {
+        }
+
+        template <typename T>
+        arrow::Status read_value(T & value)
+        {
+            ARROW_ASSIGN_OR_RAISE(auto const read_bytes, m_stream->Read(sizeof(value), &value));
+            if (read_bytes != std::int64_t(sizeof(value))) {
+                return arrow::Status::IOError("Truncated sort run");
+            }
+            return arrow::Status::OK();
+        }
+
+        std::shared_ptr<arrow::io::BufferedInputStream> m_stream;
+        SortedRead m_current;
+    };
+
+    static constexpr std::int64_t RUN_BUFFER_SIZE = 1024 * 1024;
+
+    arrow::Status write_run(std::vector<SortedRead> && run, std::string const & path) const
+    {
+        std::sort(run.begin(), run.end(), m_less);
+
+        ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::FileOutputStream::Open(path, false));
+        ARROW_ASSIGN_OR_RAISE(
+            auto stream, arrow::io::BufferedOutputStream::Create(RUN_BUFFER_SIZE, m_pool, file));
+        for (auto const & read : run) {
+            auto const signal_row_count = std::uint32_t(read.signal_rows.size());
+            ARROW_RETURN_NOT_OK(stream->Write(&read.read, sizeof(read.read)));
+            ARROW_RETURN_NOT_OK(stream->Write(&read.num_samples, sizeof(read.num_samples)));
+            ARROW_RETURN_NOT_OK(stream->Write(&read.input_index, sizeof(read.input_index)));
+            ARROW_RETURN_NOT_OK(stream->Write(&signal_row_count, sizeof(signal_row_count)));
+            ARROW_RETURN_NOT_OK(stream->Write(
+                read.signal_rows.data(), read.signal_rows.size() * sizeof(std::uint64_t)));
+        }
+        return stream->Close();
+    }
+
+    static void remove_run(std::string const & path)
+    {
+        auto const filename = arrow::internal::PlatformFilename::FromString(path);
+        if (filename.ok()) {
+            (void)arrow::internal::DeleteFile(*filename, false);
+        }
+    }
+
+    SortedReadLess const m_less;
+    std::string const m_run_path_prefix;
+    std::size_t const m_max_run_bytes;
+    arrow::MemoryPool * m_pool;
+
+    std::mutex m_mutex;
+    std::vector<SortedRead> m_run;
+    std::size_t m_run_bytes = 0;
+    std::vector<std::string> m_run_paths;
+};
+
+}  // namespace repack
@@ -13,21 +13,53 @@
 
 namespace repack { namespace states {
 
+// Signal batches of an input copied to the output as they are stored, so the output rows of
+// their signal rows are found without reading the signal.
+class copied_signal_batches {
+public:
+    // Input row of the first row of each input batch which may be copied, followed by the row
+    // after the last, as batches may hold different row counts:
+    std::vector<std::uint64_t> source_first_rows;
+    // Output row of the first row of each input batch copied, from the input's first batch:
+    std::vector<pod5::SignalTableRowIndex> first_rows;
+};
+
+class uncopied_signal_table_batches {
+public:
+    uncopied_signal_table_batches(
+        std::shared_ptr<pod5::FileReader> const & _input,
+        std::size_t _batch_count)
+    : input(_input)
+    , batch_count(_batch_count)
+    {
+    }
+
+    std::shared_ptr<pod5::FileReader> input;
+    std::size_t batch_count;
+};
+
 class unread_read_table_rows {
 public:
     unread_read_table_rows(
         std::shared_ptr<pod5::FileReader> const & _input,
         std::size_t _batch_index,
-        std::vector<std::uint32_t> && _batch_rows)
+        std::vector<std::uint32_t> && _batch_rows,
+        std::shared_ptr<copied_signal_batches const> _copied_signal = nullptr,
+        std::shared_ptr<pod5::ReadTableRecordBatch const> _read_batch = nullptr)
     : input(_input)
     , batch_index(_batch_index)
     , batch_rows(std::move(_batch_rows))
+    , copied_signal(std::move(_copied_signal))
+    , read_batch(std::move(_read_batch))
     {
     }
 
     std::shared_ptr<pod5::FileReader> input;
     std::size_t batch_index;
     std::vector<std::uint32_t> batch_rows;
+    std::shared_ptr<copied_signal_batches const> copied_signal;
+    // The batch, if already read from [input] by whoever registered the rows:
+    std::shared_ptr<pod5::ReadTableRecordBatch const> read_batch;
 };
 
 class read_read_table_rows_no_signal {
@@ -70,16 +102,30 @@ public:
 
     std::vector<PatchRecord> patch_rows;
     bool final_batch = false;
+    // Bytes counted against the repacker's pending bytes budget until the batch is written:
+    std::size_t pending_bytes = 0;
+
+    std::size_t data_size() const
+    {
+        return read_id_builder->length() * read_id_builder->byte_width()
+               + std::visit(pod5::visitors::signal_data_size{}, signal_builder)
+               + samples_builder.length() * sizeof(std::uint32_t);
+    }
 
     std::size_t row_count() const { return patch_rows.size(); }
 };
 
+// All reads added to a sorted output, waiting to be written in order.
+struct unwritten_sorted_reads {};
+
 struct finished {};
 
 using shared_variant = std::variant<
+    std::shared_ptr<uncopied_signal_table_batches>,
     std::shared_ptr<unread_read_table_rows>,
     std::shared_ptr<read_split_signal_table_batch_rows>,
     std::shared_ptr<read_read_table_rows_no_signal>,
+    std::shared_ptr<unwritten_sorted_reads>,
     std::shared_ptr<finished>>;
 
 }}  // namespace repack::states
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "pod5_format/internal/tracing/tracing.h"
+#include "repack_states.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace repack {
+
+// Work done by each kind of state, see repack_states.h.
+struct RepackStateStatistics {
+    std::string name;
+    // Number of times a state of this kind was run.
+    std::size_t runs = 0;
+    // States of this kind waiting to run, and the most there have been at once.
+    std::size_t queued = 0;
+    std::size_t max_queued = 0;
+    // Time spent running states of this kind, across all threads.
+    std::chrono::nanoseconds time{0};
+    std::chrono::nanoseconds max_time{0};
+    // Runs by duration: [0] under 1us, [1] under 2us, [2] under 4us... the last bucket holding
+    // every longer run.
+    std::vector<std::size_t> time_histogram;
+};
+
+struct RepackStatistics {
+    // Read table batches read from inputs, and the reads taken from them.
+    std::size_t read_table_batches_read = 0;
+    std::size_t reads_read = 0;
+    // Signal batches copied from inputs as they are stored.
+    std::size_t signal_batches_copied = 0;
+    std::size_t signal_bytes_copied = 0;
+    // Signal batches built from input rows and written to outputs.
+    std::size_t signal_batches_written = 0;
+    std::size_t signal_rows_written = 0;
+    std::size_t signal_bytes_written = 0;
+    std::size_t reads_written = 0;
+    // States run at once across all outputs: the count tuned so far for a repacker with adaptive
+    // concurrency, otherwise the thread pool's worker count.
+    std::size_t worker_concurrency = 0;
+
+    std::vector<RepackStateStatistics> states;
+};
+
+// Counters shared by all outputs of a repacker, updated from many threads at once.
+class RepackStatisticsCounters {
+public:
+    static constexpr std::size_t STATE_COUNT = std::variant_size<states::shared_variant>::value;
+    static constexpr std::size_t TIME_HISTOGRAM_BUCKETS = 24;
+
+    std::atomic<std::size_t> read_table_batches_read{0};
+    std::atomic<std::size_t> reads_read{0};
+    std::atomic<std::size_t> signal_batches_copied{0};
+    std::atomic<std::size_t> signal_bytes_copied{0};
+    std::atomic<std::size_t> signal_batches_written{0};
+    std::atomic<std::size_t> signal_rows_written{0};
+    std::atomic<std::size_t> signal_bytes_written{0};
+    std::atomic<std::size_t> reads_written{0};
+
+    void state_queued(states::shared_variant const & state)
+    {
+        auto & counters = m_states[state.index()];
+        auto const queued = counters.queued.fetch_add(1) + 1;
+        update_max(counters.max_queued, queued);
+        POD5_TRACE_COUNTER("repack queued states", STATE_NAMES[state.index()], queued);
+    }
+
+    void state_dequeued(states::shared_variant const & state)
+    {
+        auto & counters = m_states[state.index()];
+        counters.queued -= 1;
+        POD5_TRACE_COUNTER(
+            "repack queued states", STATE_NAMES[state.index()], counters.queued.load());
+    }
+
+    void state_ran(states::shared_variant const & state, std::chrono::nanoseconds time)
+    {
+        auto & counters = m_states[state.index()];
+        counters.runs += 1;
+        counters.time_ns += std::uint64_t(time.count());
+        update_max(counters.max_time_ns, std::uint64_t(time.count()));
+
+        std::size_t bucket = 0;
+        auto const micros = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+        while ((std::int64_t(1) << bucket) <= micros && bucket < TIME_HISTOGRAM_BUCKETS - 1) {
+            bucket += 1;
+        }
+        counters.time_histogram[bucket] += 1;
+    }
+
+    RepackStatistics snapshot() const
+    {
+        RepackStatistics result;
+        result.read_table_batches_read = read_table_batches_read;
+        result.reads_read = reads_read;
+        result.signal_batches_copied = signal_batches_copied;
+        result.signal_bytes_copied = signal_bytes_copied;
+        result.signal_batches_written = signal_batches_written;
+        result.signal_rows_written = signal_rows_written;
+        result.signal_bytes_written = signal_bytes_written;
+        result.reads_written = reads_written;
+
+        for (std::size_t i = 0; i < STATE_COUNT; ++i) {
+            auto const & counters = m_states[i];
+            RepackStateStatistics state;
+            state.name = STATE_NAMES[i];
+            state.runs = counters.runs;
+            state.queued = counters.queued;
+            state.max_queued = counters.max_queued;
+            state.time = std::chrono::nanoseconds(counters.time_ns.load());
+            state.max_time = std::chrono::nanoseconds(counters.max_time_ns.load());
+            for (auto const & bucket : counters.time_histogram) {
+                state.time_histogram.push_back(bucket);
+            }
+            result.states.push_back(std::move(state));
+        }
+        return result;
+    }
+
+private:
+    struct StateCounters {
+        std::atomic<std::size_t> runs{0};
+        std::atomic<std::size_t> queued{0};
+        std::atomic<std::size_t> max_queued{0};
+        std::atomic<std::uint64_t> time_ns{0};
+        std::atomic<std::uint64_t> max_time_ns{0};
+        std::array<std::atomic<std::size_t>, TIME_HISTOGRAM_BUCKETS> time_histogram{};
+    };
+
+    // Names of the states in states::shared_variant, in order:
+    static constexpr std::array<char const *, STATE_COUNT> STATE_NAMES{
+        "uncopied_signal_table_batches",
+        "unread_read_table_rows",
+        "read_split_signal_table_batch_rows",
+        "read_read_table_rows_no_signal",
+        "unwritten_sorted_reads",
+        "finished",
+    };
+
+    template <typename T>
+    static void update_max(std::atomic<T> & max, T value)
+    {
+        auto current = max.load();
+        while (current < value && !max.compare_exchange_weak(current, value)) {
+        }
+    }
+
+    std::array<StateCounters, STATE_COUNT> m_states;
+};
+
+}  // namespace repack
@@ -1,22 +1,23 @@
 #pragma once
 
+#include "pod5_format/internal/concurrency_tuner.h"
 #include "pod5_format/read_table_reader.h"
 
 #include <arrow/array/array_dict.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace repack {
 
-struct pair_hasher {
-    template <class T1, class T2>
-    std::size_t operator()(std::pair<T1, T2> const & pair) const
-    {
-        return std::hash<T1>{}(pair.first) ^ std::hash<T2>{}(pair.second);
-    }
-};
-
 struct run_info_hasher {
     std::size_t operator()(pod5::RunInfoData const & run_info) const
     {
@@ -91,6 +92,9 @@ private:
         m_run_info_data_indexes;
 };
 
+// Maps the dictionary indices of each input file to the output's, through dense tables indexed
+// by the input's dictionary index, so a batch's index columns are remapped with a gather rather
+// than a lookup per read.
 class ReadsTableDictionaryThreadCache {
 public:
     ReadsTableDictionaryThreadCache(std::shared_ptr<ReadsTableDictionaryManager> const & main_cache)
@@ -98,42 +102,38 @@ public:
     {
     }
 
-    // Find or create a pore index in the output file - expects to run on strand.
-    arrow::Result<pod5::PoreDictionaryIndex> find_pore_index(
+    // Map the pore type indices [source_indices] of [source_batch] to the output file's, into
+    // [dest_indices], which may be [source_indices] - expects to run on strand.
+    arrow::Status remap_pore_indices(
         std::shared_ptr<pod5::FileReader> const & source_file,
         pod5::ReadTableRecordBatch const & source_batch,
-        pod5::PoreDictionaryIndex source_index)
+        gsl::span<pod5::PoreDictionaryIndex const> const & source_indices,
+        gsl::span<pod5::PoreDictionaryIndex> const & dest_indices)
     {
-        auto const key = std::make_pair(make_file_key(source_file), source_index);
-        auto const it = m_pore_indexes.find(key);
-        if (it != m_pore_indexes.end()) {
-            return it->second;
-        }
-
-        ARROW_ASSIGN_OR_RAISE(
-            auto dest_index,
-            m_main_cache->find_pore_index(source_file, source_batch, source_index));
-        m_pore_indexes[key] = dest_index;
-        return dest_index;
+        return remap_indices(
+            m_pore_indexes[make_file_key(source_file)],
+            source_indices,
+            dest_indices,
+            [&](pod5::PoreDictionaryIndex source_index) {
+                return m_main_cache->find_pore_index(source_file, source_batch, source_index);
+            });
     }
 
-    // Find or create a run_info index in the output file - expects to run on strand.
-    arrow::Result<pod5::RunInfoDictionaryIndex> find_run_info_index(
+    // Map the run info indices [source_indices] of [source_batch] to the output file's, into
+    // [dest_indices], which may be [source_indices] - expects to run on strand.
+    arrow::Status remap_run_info_indices(
         std::shared_ptr<pod5::FileReader> const & source_file,
         pod5::ReadTableRecordBatch const & source_batch,
-        pod5::RunInfoDictionaryIndex source_index)
+        gsl::span<pod5::RunInfoDictionaryIndex const> const & source_indices,
+        gsl::span<pod5::RunInfoDictionaryIndex> const & dest_indices)
     {
-        auto const key = std::make_pair(make_file_key(source_file), source_index);
-        auto const it = m_run_info_indexes.find(key);
-        if (it != m_run_info_indexes.end()) {
-            return it->second;
-        }
-
-        ARROW_ASSIGN_OR_RAISE(
-            auto dest_index,
-            m_main_cache->find_run_info_index(source_file, source_batch, source_index));
-        m_run_info_indexes[key] = dest_index;
-        return dest_index;
+        return remap_indices(
+            m_run_info_indexes[make_file_key(source_file)],
+            source_indices,
+            dest_indices,
+            [&](pod5::RunInfoDictionaryIndex source_index) {
+                return m_main_cache->find_run_info_index(source_file, source_batch, source_index);
+            });
     }
 
 private:
@@ -144,14 +144,272 @@ private:
         return reinterpret_cast<FileKey>(file.get());
     }
 
+    // Output index of each input index, UNMAPPED for input indices not seen yet:
+    template <typename IndexType>
+    using RemapTable = std::vector<IndexType>;
+
     template <typename IndexType>
-    using DictionaryLookup =
-        std::unordered_map<std::pair<FileKey, IndexType>, IndexType, pair_hasher>;
+    static constexpr IndexType UNMAPPED = -1;
+
+    template <typename IndexType, typename Resolve>
+    static arrow::Status remap_indices(
+        RemapTable<IndexType> & table,
+        gsl::span<IndexType const> const & source_indices,
+        gsl::span<IndexType> const & dest_indices,
+        Resolve && resolve)
+    {
+        if (source_indices.empty()) {
+            return arrow::Status::OK();
+        }
+        auto const [min_index, max_index] =
+            std::minmax_element(source_indices.begin(), source_indices.end());
+        if (*min_index < 0) {
+            return arrow::Status::Invalid("Invalid dictionary index ", *min_index);
+        }
+        if (std::size_t(*max_index) >= table.size()) {
+            table.resize(std::size_t(*max_index) + 1, UNMAPPED<IndexType>);
+        }
+
+        // Only indices this input hasn't used before are resolved, through the main cache:
+        for (auto const source_index : source_indices) {
+            if (table[source_index] == UNMAPPED<IndexType>) {
+                ARROW_ASSIGN_OR_RAISE(table[source_index], resolve(source_index));
+            }
+        }
+
+        std::transform(
+            source_indices.begin(),
+            source_indices.end(),
+            dest_indices.begin(),
+            [&](IndexType source_index) { return table[source_index]; });
+        return arrow::Status::OK();
+    }
 
     std::shared_ptr<ReadsTableDictionaryManager> m_main_cache;
 
-    DictionaryLookup<pod5::PoreDictionaryIndex> m_pore_indexes;
-    DictionaryLookup<pod5::RunInfoDictionaryIndex> m_run_info_indexes;
+    std::unordered_map<FileKey, RemapTable<pod5::PoreDictionaryIndex>> m_pore_indexes;
+    std::unordered_map<FileKey, RemapTable<pod5::RunInfoDictionaryIndex>> m_run_info_indexes;
+};
+
+// Bounds the bytes of signal batches a repacker's outputs have built but not yet written.
+//
+// Outputs stop reading input batches while the budget is used up, and are resumed as written
+// batches release their bytes.
+class PendingBytesBudget {
+public:
+    // Value for max_bytes placing no limit on the pending bytes.
+    static constexpr std::size_t NO_PENDING_BYTES_LIMIT = 0;
+
+    PendingBytesBudget(std::size_t max_bytes) : m_max_bytes(max_bytes) {}
+
+    std::size_t max_bytes() const { return m_max_bytes; }
+
+    std::size_t pending_bytes() const { return m_pending_bytes.load(); }
+
+    bool is_used_up() const
+    {
+        return m_max_bytes != NO_PENDING_BYTES_LIMIT && !m_stopped
+               && m_pending_bytes.load() >= m_max_bytes;
+    }
+
+    void add(std::size_t bytes) { m_pending_bytes += bytes; }
+
+    // Release bytes added before, resuming paused work once the budget has room.
+    void release(std::size_t bytes)
+    {
+        std::vector<std::function<void()>> to_resume;
+        {
+            std::lock_guard<std::mutex> l{m_mutex};
+            m_pending_bytes -= bytes;
+            if (is_used_up()) {
+                return;
+            }
+            to_resume.swap(m_paused);
+        }
+        for (auto const & resume : to_resume) {
+            resume();
+        }
+    }
+
+    // Pause work until the budget has room, calling [resume] once it does.
+    // Returns false without keeping [resume] if the budget has room already.
+    bool pause(std::function<void()> resume)
+    {
+        std::lock_guard<std::mutex> l{m_mutex};
+        if (!is_used_up()) {
+            return false;
+        }
+        m_paused.push_back(std::move(resume));
+        return true;
+    }
+
+    // Stop limiting pending bytes, resuming all paused work - used once an output fails, as its
+    // pending batches will never be written to release their bytes.
+    void stop()
+    {
+        std::vector<std::function<void()>> to_resume;
+        {
+            std::lock_guard<std::mutex> l{m_mutex};
+            m_stopped = true;
+            to_resume.swap(m_paused);
+        }
+        for (auto const & resume : to_resume) {
+            resume();
+        }
+    }
+
+private:
+    std::size_t const m_max_bytes;
+    std::atomic<std::size_t> m_pending_bytes{0};
+    std::atomic<bool> m_stopped{false};
+
+    std::mutex m_mutex;
+    std::vector<std::function<void()>> m_paused;
+};
+
+// Bounds the states a repacker's outputs run at once to a count tuned by the signal bytes they
+// move, see pod5::internal::ConcurrencyTuner.
+//
+// The pool's workers past the count wait for a slot, rather than contend for storage or cores
+// the running states already saturate.
+class WorkerConcurrency {
+public:
+    WorkerConcurrency(std::size_t max_workers) : m_tuner(1, max_workers) {}
+
+    std::size_t concurrency() const { return m_tuner.concurrency(); }
+
+    // Record [bytes] of signal read or copied by a running state.
+    void add_work(std::size_t bytes) { m_tuner.add_work(bytes); }
+
+    // Record work held back for [time] by the pending bytes budget.
+    void add_stall(std::chrono::nanoseconds time) { m_tuner.add_stall(time); }
+
+    // Wait for a slot to run a state in.
+    void acquire()
+    {
+        std::unique_lock<std::mutex> l{m_mutex};
+        m_slot_free.wait(l, [&] { return m_running < m_tuner.concurrency(); });
+        m_running += 1;
+    }
+
+    // Release a slot taken by acquire(), stepping the concurrency if it is due.
+    void release()
+    {
+        auto const changed = m_tuner.update();
+        {
+            std::lock_guard<std::mutex> l{m_mutex};
+            m_running -= 1;
+        }
+        if (changed) {
+            m_slot_free.notify_all();
+        } else {
+            m_slot_free.notify_one();
+        }
+    }
+
+private:
+    pod5::internal::ConcurrencyTuner m_tuner;
+
+    std::mutex m_mutex;
+    std::condition_variable m_slot_free;
+    std::size_t m_running = 0;
+};
+
+// Set of read ids, held in a flat open addressing table of the ids' 128 bits.
+//
+// Read ids are random uuids, so their bits need only a cheap mix to pick a slot, and a table of
+// plain 16 byte slots avoids the node allocation and pointer chasing of std::unordered_set.
+class ReadIdSet {
+public:
+    ReadIdSet() : m_slots(std::size_t(1) << MIN_CAPACITY_BITS), m_slot_bits(MIN_CAPACITY_BITS)
+    {
+    }
+
+    std::size_t size() const { return m_size + (m_has_nil_id ? 1 : 0); }
+
+    // Insert [read_id], returning false if it was already in the set.
+    bool insert(pod5::Uuid const & read_id)
+    {
+        auto const key = to_key(read_id);
+        // The nil id marks empty slots, so is tracked on its own:
+        if (key.is_empty()) {
+            return !std::exchange(m_has_nil_id, true);
+        }
+
+        if ((m_size + 1) * MAX_LOAD_DENOMINATOR > m_slots.size() * MAX_LOAD_NUMERATOR) {
+            grow();
+        }
+        return insert_key(key);
+    }
+
+private:
+    struct Key {
+        std::uint64_t low = 0;
+        std::uint64_t high = 0;
+
+        bool is_empty() const { return low == 0 && high == 0; }
+
+        bool operator==(Key const & other) const
+        {
+            return low == other.low && high == other.high;
+        }
+    };
+
+    static_assert(sizeof(pod5::Uuid) == sizeof(Key), "Read ids are held as two 64 bit words");
+
+    // Keep the table at most 3/4 full, so probe sequences stay short:
+    static constexpr std::size_t MAX_LOAD_NUMERATOR = 3;
+    static constexpr std::size_t MAX_LOAD_DENOMINATOR = 4;
+    static constexpr unsigned MIN_CAPACITY_BITS = 10;
+
+    static Key to_key(pod5::Uuid const & read_id)
+    {
+        Key key;
+        std::memcpy(&key.low, read_id.data(), sizeof(key.low));
+        std::memcpy(&key.high, read_id.data() + sizeof(key.low), sizeof(key.high));
+        return key;
+    }
+
+    std::size_t slot_index(Key const & key) const
+    {
+        // Fibonacci hashing spreads ids which are not random (eg. sequential test ids) too. The
+        // multiply mixes low bits into the top bits only, so the slot is taken from those:
+        return std::size_t(((key.low ^ key.high) * 0x9E3779B97F4A7C15ull) >> (64 - m_slot_bits));
+    }
+
+    bool insert_key(Key const & key)
+    {
+        auto const mask = m_slots.size() - 1;
+        for (auto index = slot_index(key);; index = (index + 1) & mask) {
+            auto & slot = m_slots[index];
+            if (slot.is_empty()) {
+                slot = key;
+                m_size += 1;
+                return true;
+            }
+            if (slot == key) {
+                return false;
+            }
+        }
+    }
+
+    void grow()
+    {
+        auto old_slots = std::exchange(m_slots, std::vector<Key>(m_slots.size() * 2));
+        m_slot_bits += 1;
+        m_size = 0;
+        for (auto const & key : old_slots) {
+            if (!key.is_empty()) {
+                insert_key(key);
+            }
+        }
+    }
+
+    // Always a power of two in size, 1 << m_slot_bits:
+    std::vector<Key> m_slots;
+    unsigned m_slot_bits;
+    std::size_t m_size = 0;
+    bool m_has_nil_id = false;
 };
 
 }  // namespace repack
@@ -1,9 +1,13 @@
 #include "repacker.h"
 
+#include "pod5_format/internal/parallel_tasks.h"
 #include "pod5_format/internal/tracing/tracing.h"
+#include "pod5_format/read_id_index.h"
 #include "repack_output.h"
 #include "repack_states.h"
 
+#include <algorithm>
+
 namespace repack {
 
 namespace {
@@ -24,7 +28,14 @@ void repacker_add_reads_preconditions(
 
 }  // namespace
 
-Pod5Repacker::Pod5Repacker() : m_thread_pool{pod5::make_thread_pool(10)} {}
+Pod5Repacker::Pod5Repacker(std::size_t max_pending_bytes, bool adaptive_concurrency)
+: m_thread_pool{pod5::make_thread_pool(pod5::numa_thread_pool_options(WORKER_THREADS))}
+, m_pending_bytes_budget{std::make_shared<PendingBytesBudget>(max_pending_bytes)}
+, m_statistics{std::make_shared<RepackStatisticsCounters>()}
+, m_worker_concurrency{
+      adaptive_concurrency ? std::make_shared<WorkerConcurrency>(WORKER_THREADS) : nullptr}
+{
+}
 
 Pod5Repacker::~Pod5Repacker() { finish(); }
 
@@ -47,11 +58,21 @@ void Pod5Repacker::finish()
 
 std::shared_ptr<Pod5RepackerOutput> Pod5Repacker::add_output(
     std::shared_ptr<pod5::FileWriter> const & output,
-    bool check_duplicate_read_ids)
+    bool check_duplicate_read_ids,
+    ReadOrder read_order)
 {
     POD5_TRACE_FUNCTION();
     auto repacker_output = std::make_shared<Pod5RepackerOutput>(
-        shared_from_this(), m_thread_pool, output, check_duplicate_read_ids);
+        shared_from_this(),
+        m_thread_pool,
+        m_pending_bytes_budget,
+        m_statistics,
+        output,
+        check_duplicate_read_ids,
+        read_order,
+        // Outputs are spread over the pool's groups, each output's work staying in its group:
+        m_outputs.size() % m_thread_pool->worker_group_count(),
+        m_worker_concurrency);
     m_outputs.push_back(repacker_output);
     return repacker_output;
 }
@@ -72,9 +93,7 @@ void Pod5Repacker::add_all_reads_to_output(
     POD5_TRACE_FUNCTION();
     repacker_add_reads_preconditions(shared_from_this(), output, input);
 
-    for (std::size_t i = 0; i < input.reader->num_read_record_batches(); ++i) {
-        output->register_new_reads(input.reader, i);
-    }
+    output->register_all_reads(input.reader);
 
     register_submitted_reader(input);
 }
@@ -111,6 +130,175 @@ void Pod5Repacker::add_selected_reads_to_output(
     register_submitted_reader(input);
 }
 
+std::size_t Pod5Repacker::add_partitioned_reads_to_outputs(
+    std::vector<std::shared_ptr<Pod5RepackerOutput>> const & outputs,
+    Pod5FileReaderPtr const & input,
+    py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & read_ids,
+    py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> const & read_outputs)
+{
+    POD5_TRACE_FUNCTION();
+    for (auto const & output : outputs) {
+        repacker_add_reads_preconditions(shared_from_this(), output, input);
+    }
+
+    std::size_t const route_count = read_ids.shape(0);
+    if (read_ids.ndim() != 2 || read_ids.shape(1) != sizeof(pod5::Uuid)
+        || std::size_t(read_outputs.size()) != route_count)
+    {
+        throw std::runtime_error("Expected a 16 byte read id for every read output");
+    }
+
+    // Routes sorted by read id, so each read's outputs are found by binary search:
+    auto const read_id_span = gsl::make_span(
+        reinterpret_cast<pod5::Uuid const *>(read_ids.data()), route_count);
+    std::vector<std::pair<pod5::Uuid, std::uint32_t>> routes;
+    routes.reserve(route_count);
+    for (std::size_t i = 0; i < route_count; ++i) {
+        if (read_outputs.data()[i] >= outputs.size()) {
+            throw std::runtime_error("Read output index out of range");
+        }
+        routes.emplace_back(read_id_span[i], read_outputs.data()[i]);
+    }
+    std::sort(routes.begin(), routes.end());
+    routes.erase(std::unique(routes.begin(), routes.end()), routes.end());
+
+    auto const route_less = [](auto const & lhs, auto const & rhs) {
+        return lhs.first < rhs.first;
+    };
+
+    std::size_t found_count = 0;
+    std::vector<std::vector<std::uint32_t>> output_rows(outputs.size());
+    for (std::size_t i = 0; i < input.reader->num_read_record_batches(); ++i) {
+        POD5_PYTHON_ASSIGN_OR_RAISE(auto batch, input.reader->read_read_record_batch(i));
+        auto const batch_read_ids = batch.read_id_column();
+        for (std::int64_t row = 0; row < batch_read_ids->length(); ++row) {
+            auto const read_routes = std::equal_range(
+                routes.begin(),
+                routes.end(),
+                std::make_pair(batch_read_ids->Value(row), std::uint32_t(0)),
+                route_less);
+            for (auto it = read_routes.first; it != read_routes.second; ++it) {
+                output_rows[it->second].push_back(std::uint32_t(row));
+                found_count += 1;
+            }
+        }
+
+        // Each output is passed the batch already read, rather than reading it again:
+        auto const shared_batch =
+            std::make_shared<pod5::ReadTableRecordBatch const>(std::move(batch));
+        for (std::size_t output = 0; output < outputs.size(); ++output) {
+            if (output_rows[output].empty()) {
+                continue;
+            }
+            outputs[output]->register_new_reads(
+                input.reader, i, std::exchange(output_rows[output], {}), shared_batch);
+        }
+    }
+
+    register_submitted_reader(input);
+    return found_count;
+}
+
+py::array_t<std::uint8_t> Pod5Repacker::add_read_ids_to_output(
+    std::shared_ptr<Pod5RepackerOutput> const & output,
+    std::vector<Pod5FileReaderPtr> const & inputs,
+    py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & read_ids)
+{
+    POD5_TRACE_FUNCTION();
+    std::vector<pod5::FileReader const *> distinct_readers;
+    for (auto const & input : inputs) {
+        repacker_add_reads_preconditions(shared_from_this(), output, input);
+        distinct_readers.push_back(input.reader.get());
+    }
+    std::sort(distinct_readers.begin(), distinct_readers.end());
+    if (std::adjacent_find(distinct_readers.begin(), distinct_readers.end())
+        != distinct_readers.end())
+    {
+        throw std::runtime_error("Each input may only be passed once");
+    }
+
+    std::size_t const read_id_count = read_ids.shape(0);
+    if (read_ids.ndim() != 2 || read_ids.shape(1) != sizeof(pod5::Uuid)) {
+        throw std::runtime_error("Expected an array of 16 byte read ids");
+    }
+    auto const read_id_span = gsl::make_span(
+        reinterpret_cast<pod5::Uuid const *>(read_ids.data()), read_id_count);
+
+    struct InputSelection {
+        std::vector<std::vector<std::uint32_t>> batch_rows;
+        // Indices into the sorted targets of the reads found in this input.
+        std::vector<std::size_t> found_targets;
+    };
+
+    std::vector<pod5::Uuid> targets(read_id_span.begin(), read_id_span.end());
+    std::vector<InputSelection> selections(inputs.size());
+    {
+        py::gil_scoped_release release;
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+        // Each search walks the sorted targets forward through the input's sorted index, so
+        // inputs holding few of the targets are skipped through quickly:
+        throw_on_error(pod5::internal::run_parallel_tasks(
+            m_thread_pool.get(), inputs.size(), [&](std::size_t i) -> pod5::Status {
+                auto const & reader = inputs[i].reader;
+                ARROW_ASSIGN_OR_RAISE(auto const index, reader->read_id_index());
+                auto const index_ids = index->read_ids();
+
+                auto & selection = selections[i];
+                selection.batch_rows.resize(reader->num_read_record_batches());
+                std::size_t entry = 0;
+                for (std::size_t target = 0; target < targets.size(); ++target) {
+                    entry = index->lower_bound(targets[target], entry);
+                    if (entry == index_ids.size()) {
+                        break;
+                    }
+                    if (!(index_ids[entry] == targets[target])) {
+                        continue;
+                    }
+
+                    selection.found_targets.push_back(target);
+                    for (; entry < index_ids.size() && index_ids[entry] == targets[target];
+                         ++entry)
+                    {
+                        selection.batch_rows[index->batch(entry)].push_back(
+                            index->batch_row(entry));
+                    }
+                }
+
+                // Rows are copied in file order:
+                for (auto & rows : selection.batch_rows) {
+                    std::sort(rows.begin(), rows.end());
+                }
+                return pod5::Status::OK();
+            }));
+    }
+
+    std::vector<std::uint8_t> target_found(targets.size(), 0);
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        auto & selection = selections[i];
+        for (auto const target : selection.found_targets) {
+            target_found[target] = 1;
+        }
+
+        for (std::size_t batch = 0; batch < selection.batch_rows.size(); ++batch) {
+            if (selection.batch_rows[batch].empty()) {
+                continue;
+            }
+            output->register_new_reads(
+                inputs[i].reader, batch, std::move(selection.batch_rows[batch]));
+        }
+        register_submitted_reader(inputs[i]);
+    }
+
+    std::vector<std::uint8_t> read_id_found(read_id_count);
+    for (std::size_t i = 0; i < read_id_count; ++i) {
+        auto const target = std::lower_bound(targets.begin(), targets.end(), read_id_span[i]);
+        read_id_found[i] = target_found[target - targets.begin()];
+    }
+    return make_owned_array(std::move(read_id_found));
+}
+
 void Pod5Repacker::check_for_error() const
 {
     for (auto const & output : m_outputs) {
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "pod5_format_pybind/api.h"
+#include "repack_sort.h"
+#include "repack_statistics.h"
+#include "repack_utils.h"
 
 #include <pybind11/pybind11.h>
 
@@ -14,14 +17,29 @@ class Pod5RepackerOutput;
 
 class Pod5Repacker : public std::enable_shared_from_this<Pod5Repacker> {
 public:
-    Pod5Repacker();
+    // Default limit on the bytes of signal batches built by outputs but not yet written.
+    static constexpr std::size_t DEFAULT_MAX_PENDING_BYTES = std::size_t(2) << 30;
+    // Workers of the thread pool running the outputs' work.
+    static constexpr std::size_t WORKER_THREADS = 10;
+
+    // Outputs stop reading input batches while [max_pending_bytes] of signal batches are waiting
+    // to be written, PendingBytesBudget::NO_PENDING_BYTES_LIMIT for no limit.
+    //
+    // With [adaptive_concurrency] the outputs' states run on between one and WORKER_THREADS
+    // workers at once, tuned by the signal bytes they move, see WorkerConcurrency.
+    Pod5Repacker(
+        std::size_t max_pending_bytes = DEFAULT_MAX_PENDING_BYTES,
+        bool adaptive_concurrency = false);
     ~Pod5Repacker();
 
     void finish();
 
+    // Add an output, writing reads in [read_order]. Sorted outputs write their reads once
+    // set_output_finished is called, spilling sorted runs of reads beside the output meanwhile.
     std::shared_ptr<Pod5RepackerOutput> add_output(
         std::shared_ptr<pod5::FileWriter> const & output,
-        bool check_duplicate_read_ids);
+        bool check_duplicate_read_ids,
+        ReadOrder read_order = ReadOrder::AsAdded);
     void set_output_finished(std::shared_ptr<Pod5RepackerOutput> const & output);
 
     void add_all_reads_to_output(
@@ -34,9 +52,46 @@ public:
         py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> && batch_counts,
         py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> && all_batch_rows);
 
+    // Route reads of [input] to many outputs in one pass over its read table, sending the read
+    // [read_ids][i] to [outputs][read_outputs[i]]. A read id may be routed to several outputs.
+    // Returns the number of routes whose read was found in [input].
+    std::size_t add_partitioned_reads_to_outputs(
+        std::vector<std::shared_ptr<Pod5RepackerOutput>> const & outputs,
+        Pod5FileReaderPtr const & input,
+        py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & read_ids,
+        py::array_t<std::uint32_t, py::array::c_style | py::array::forcecast> const &
+            read_outputs);
+
+    // Select the reads with ids in [read_ids] from every one of [inputs] and send them to
+    // [output], searching each input's read id index in parallel. Each input must be passed once.
+    // Returns a flag for each of [read_ids], set if the read was found in any input.
+    py::array_t<std::uint8_t> add_read_ids_to_output(
+        std::shared_ptr<Pod5RepackerOutput> const & output,
+        std::vector<Pod5FileReaderPtr> const & inputs,
+        py::array_t<std::uint8_t, py::array::c_style | py::array::forcecast> const & read_ids);
+
     bool is_complete() const;
     std::size_t reads_completed() const;
 
+    // Bytes of signal batches built by outputs and waiting to be written
+    std::size_t pending_bytes() const { return m_pending_bytes_budget->pending_bytes(); }
+    std::size_t max_pending_bytes() const { return m_pending_bytes_budget->max_bytes(); }
+
+    // Counters for the work done by all outputs so far, and the time spent in each state.
+    RepackStatistics statistics() const
+    {
+        auto result = m_statistics->snapshot();
+        result.worker_concurrency =
+            m_worker_concurrency ? m_worker_concurrency->concurrency() : WORKER_THREADS;
+        return result;
+    }
+
+    // Queue depths and task times of the thread pool running the outputs' work.
+    pod5::ThreadPoolStatistics thread_pool_statistics() const
+    {
+        return m_thread_pool->statistics();
+    }
+
     std::size_t currently_open_file_reader_count()
     {
         check_for_error();
@@ -74,6 +129,10 @@ private:
     }
 
     std::shared_ptr<pod5::ThreadPool> m_thread_pool;
+    std::shared_ptr<PendingBytesBudget> m_pending_bytes_budget;
+    std::shared_ptr<RepackStatisticsCounters> m_statistics;
+    // Null unless the repacker was made with adaptive concurrency:
+    std::shared_ptr<WorkerConcurrency> m_worker_concurrency;
 
     mutable std::vector<std::weak_ptr<pod5::FileReader>> m_file_readers;
     std::vector<std::shared_ptr<Pod5RepackerOutput>> m_outputs;
@@ -1,16 +1,27 @@
 #include "pod5_format/c_api.h"
 
 #include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
 #include "pod5_format/schema_metadata.h"
+#include "pod5_format/signal_summary.h"
 #include "pod5_format/uuid.h"
 #include "pod5_format/version.h"
 #include "utils.h"
 
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/c/bridge.h>
+#include <arrow/extension_type.h>
+#include <arrow/record_batch.h>
 #include <catch2/catch.hpp>
 #include <gsl/gsl-lite.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <numeric>
+#include <thread>
 
 struct Pod5C_Result {
     static Pod5C_Result capture(pod5_error_t err_num)
@@ -253,6 +264,30 @@ SCENARIO("C API Reads")
         std::vector<Pod5ReadId> expected_read_ids{input_read_id, input_read_id_2};
         CHECK(read_ids == expected_read_ids);
 
+        Pod5FileSummary_t file_summary{};
+        std::uint8_t has_summary = 0;
+        CHECK_POD5_OK(pod5_read_file_summary(filename, &file_summary, &has_summary));
+        // Files written through the C API don't embed a summary:
+        CHECK(has_summary == 0);
+
+        // Nor signal summaries:
+        std::size_t decimation_count = 1;
+        CHECK_POD5_OK(pod5_get_signal_summary_decimations(file, 0, nullptr, &decimation_count));
+        CHECK(decimation_count == 0);
+        std::size_t level_size = 0;
+        has_summary = 1;
+        CHECK_POD5_OK(pod5_get_read_signal_summary(
+            file,
+            read_ids[0].read_id,
+            64,
+            0,
+            nullptr,
+            nullptr,
+            nullptr,
+            &level_size,
+            &has_summary));
+        CHECK(has_summary == 0);
+
         std::size_t batch_count = 0;
         CHECK_POD5_OK(pod5_get_read_batch_count(&batch_count, file));
         REQUIRE(batch_count == 1);
@@ -282,6 +317,180 @@ SCENARIO("C API Reads")
                 == POD5_ERROR_INDEXERROR);
         }
 
+        // Batches can be exported through the Arrow C data interface:
+        {
+            ArrowArray array;
+            ArrowSchema schema;
+            CHECK_POD5_OK(pod5_export_read_batch_arrow(batch_0, &array, &schema));
+            auto const read_batch = arrow::ImportRecordBatch(&array, &schema);
+            REQUIRE(read_batch.ok());
+            CHECK((*read_batch)->num_rows() == read_count);
+
+            auto const read_ids = std::dynamic_pointer_cast<arrow::ExtensionArray>(
+                (*read_batch)->GetColumnByName("read_id"));
+            REQUIRE(!!read_ids);
+            auto const read_id_storage =
+                std::static_pointer_cast<arrow::FixedSizeBinaryArray>(read_ids->storage());
+            CHECK(
+                std::memcmp(
+                    read_id_storage->GetValue(0), input_read_id.data(), input_read_id.size())
+                == 0);
+
+            std::size_t signal_batch_count = 0;
+            CHECK_POD5_OK(pod5_get_signal_batch_count(&signal_batch_count, file));
+            REQUIRE(signal_batch_count > 0);
+            CHECK_POD5_OK(pod5_export_signal_batch_arrow(file, 0, &array, &schema));
+            auto const signal_batch = arrow::ImportRecordBatch(&array, &schema);
+            REQUIRE(signal_batch.ok());
+            auto const samples = std::static_pointer_cast<arrow::UInt32Array>(
+                (*signal_batch)->GetColumnByName("samples"));
+            REQUIRE(!!samples);
+            CHECK(samples->Value(0) == signal_1.size());
+
+            CHECK(
+                pod5_export_signal_batch_arrow(file, signal_batch_count, &array, &schema)
+                != POD5_OK);
+        }
+
+        // Projected batches only load the requested columns:
+        {
+            char const * bad_columns[] = {"not_a_column"};
+            Pod5ReadTableProjection * projection = nullptr;
+            CHECK(pod5_create_read_table_projection(&projection, file, bad_columns, 1) != POD5_OK);
+
+            char const * columns[] = {"read_id", "num_samples", "signal"};
+            CHECK_POD5_OK(pod5_create_read_table_projection(&projection, file, columns, 3));
+            REQUIRE(!!projection);
+
+            Pod5ReadRecordBatch * projected_batch = nullptr;
+            CHECK_POD5_OK(pod5_get_read_batch_projected(&projected_batch, file, 0, projection));
+            REQUIRE(!!projected_batch);
+
+            ReadBatchRowInfoV3 v3_struct;
+            uint16_t input_version = 0;
+            CHECK_POD5_OK(pod5_get_read_batch_row_info_data(
+                projected_batch, 1, READ_BATCH_ROW_INFO_VERSION, &v3_struct, &input_version));
+            CHECK(*reinterpret_cast<pod5::Uuid const *>(v3_struct.read_id) == input_read_id_2);
+            CHECK(v3_struct.num_samples == signal_2.size());
+            CHECK(v3_struct.signal_row_count == 1);
+            CHECK(v3_struct.read_number == 0);
+            CHECK(v3_struct.calibration_scale == 0.0f);
+
+            std::vector<uint64_t> signal_row_indices(1);
+            CHECK_POD5_OK(pod5_get_signal_row_indices(
+                projected_batch, 1, signal_row_indices.size(), signal_row_indices.data()));
+
+            CalibrationExtraData calibration_extra_data{};
+            CHECK(
+                pod5_get_calibration_extra_info(projected_batch, 0, &calibration_extra_data)
+                == POD5_ERROR_INVALID);
+
+            CHECK_POD5_OK(pod5_free_read_batch(projected_batch));
+            CHECK_POD5_OK(pod5_free_read_table_projection(projection));
+        }
+
+        // Iterators return every batch in order, reading ahead of the caller:
+        {
+            char const * columns[] = {"read_id", "num_samples"};
+            Pod5ReadTableProjection * projection = nullptr;
+            CHECK_POD5_OK(pod5_create_read_table_projection(&projection, file, columns, 2));
+
+            Pod5ReadBatchIterator * iterator = nullptr;
+            CHECK_POD5_OK(pod5_create_read_batch_iterator(&iterator, file, 2, projection));
+            REQUIRE(!!iterator);
+            CHECK_POD5_OK(pod5_free_read_table_projection(projection));
+
+            std::size_t iterated_batches = 0;
+            std::size_t iterated_rows = 0;
+            while (true) {
+                Pod5ReadRecordBatch * iterated_batch = nullptr;
+                CHECK_POD5_OK(pod5_read_batch_iterator_next(iterator, &iterated_batch));
+                if (!iterated_batch) {
+                    break;
+                }
+                std::size_t row_count = 0;
+                CHECK_POD5_OK(pod5_get_read_batch_row_count(&row_count, iterated_batch));
+                iterated_rows += row_count;
+                iterated_batches += 1;
+                CHECK_POD5_OK(pod5_free_read_batch(iterated_batch));
+            }
+            CHECK(iterated_batches == batch_count);
+            CHECK(iterated_rows == read_count);
+            CHECK_POD5_OK(pod5_free_read_batch_iterator(iterator));
+        }
+
+        // Scans select the rows matching an expression:
+        {
+            std::vector<uint32_t> batch_counts(batch_count);
+            std::vector<uint32_t> batch_rows(read_count);
+            std::size_t selected_count = 0;
+            auto const expression = "num_samples == " + std::to_string(signal_2.size());
+            CHECK_POD5_OK(pod5_scan_reads(
+                file,
+                expression.c_str(),
+                batch_counts.data(),
+                batch_rows.data(),
+                batch_rows.size(),
+                &selected_count));
+            CHECK(selected_count == 1);
+            CHECK(batch_counts[0] == 1);
+            CHECK(batch_rows[0] == 1);
+
+            CHECK(
+                pod5_scan_reads(
+                    file,
+                    "num_samples ==",
+                    batch_counts.data(),
+                    batch_rows.data(),
+                    batch_rows.size(),
+                    &selected_count)
+                == POD5_ERROR_INVALID);
+        }
+
+        // Datasets find reads across files, here the same file twice:
+        {
+            char const * filenames[] = {filename, filename};
+            CHECK(!pod5_open_dataset(NULL, 2, NULL));
+            auto dataset = pod5_open_dataset(filenames, 2, NULL);
+            REQUIRE(!!dataset);
+
+            std::size_t file_count = 0;
+            CHECK_POD5_OK(pod5_get_dataset_file_count(dataset, &file_count));
+            CHECK(file_count == 2);
+            std::size_t dataset_read_count = 0;
+            CHECK_POD5_OK(pod5_get_dataset_read_count(dataset, &dataset_read_count));
+            CHECK(dataset_read_count == 2 * read_count);
+
+            Pod5FileReader_t * dataset_file = nullptr;
+            CHECK(pod5_get_dataset_file_reader(dataset, 2, &dataset_file) == POD5_ERROR_INDEXERROR);
+            CHECK_POD5_OK(pod5_get_dataset_file_reader(dataset, 1, &dataset_file));
+            REQUIRE(!!dataset_file);
+            CHECK_POD5_OK(pod5_close_and_free_reader(dataset_file));
+
+            static constexpr char const * index_filename = "./foo_c_api.index";
+            CHECK_POD5_OK(pod5_write_dataset_index(dataset, index_filename));
+            CHECK_POD5_OK(pod5_close_and_free_dataset(dataset));
+
+            dataset = pod5_open_dataset(filenames, 2, NULL);
+            REQUIRE(!!dataset);
+            CHECK_POD5_OK(pod5_load_dataset_index(dataset, index_filename));
+
+            std::vector<pod5::Uuid> search_ids{pod5::Uuid{}, input_read_id_2};
+            std::vector<DatasetReadLocation_t> locations(search_ids.size());
+            std::size_t find_success_count = 0;
+            CHECK_POD5_OK(pod5_plan_dataset_traversal(
+                dataset,
+                reinterpret_cast<uint8_t const *>(search_ids.data()),
+                search_ids.size(),
+                locations.data(),
+                &find_success_count));
+            REQUIRE(find_success_count == 1);
+            CHECK(locations[0].file_index == 0);
+            CHECK(locations[0].batch == 0);
+            CHECK(locations[0].batch_row == 1);
+            CHECK_POD5_OK(pod5_close_and_free_dataset(dataset));
+        }
+
         for (std::size_t row = 0; row < read_count; ++row) {
             auto signal = signal_1;
             if (row == 1) {
@@ -352,6 +561,27 @@ SCENARIO("C API Reads")
                 file, batch_0, row, sample_count, read_signal.data()));
             CHECK(read_signal == signal);
 
+            Pod5ReadSignalOptions_t signal_options{};
+            signal_options.parallel_decode = true;
+            std::fill(read_signal.begin(), read_signal.end(), 0);
+            CHECK_POD5_OK(pod5_get_read_complete_signal_options(
+                file, batch_0, row, sample_count, read_signal.data(), &signal_options));
+            CHECK(read_signal == signal);
+
+            std::vector<int16_t> read_signal_range(5);
+            CHECK_POD5_OK(pod5_get_read_signal_range(
+                file, batch_0, row, 3, read_signal_range.size(), read_signal_range.data()));
+            CHECK(
+                gsl::make_span(read_signal_range)
+                == gsl::make_span(signal).subspan(3, read_signal_range.size()));
+
+            std::vector<float> read_signal_pa(sample_count);
+            CHECK_POD5_OK(pod5_get_read_complete_signal_pa(
+                file, batch_0, row, sample_count, read_signal_pa.data()));
+            for (std::size_t i = 0; i < sample_count; ++i) {
+                CHECK(read_signal_pa[i] == (signal[i] + calibration_offset) * calibration_scale);
+            }
+
             CHECK_POD5_OK(
                 pod5_free_signal_row_info(signal_row_indices.size(), signal_row_info.data()));
 
@@ -423,6 +653,29 @@ SCENARIO("C API Reads")
                 CHECK(end_reason == POD5_END_REASON_UNKNOWN);
             }
 
+            // Cached values are shared by every lookup of the same index:
+            {
+                char const * pore_type = nullptr;
+                CHECK_POD5_OK(pod5_get_cached_pore_type(batch_0, v3_struct.pore_type, &pore_type));
+                CHECK(pore_type == expected_pore_type);
+                char const * pore_type_again = nullptr;
+                CHECK_POD5_OK(
+                    pod5_get_cached_pore_type(batch_0, v3_struct.pore_type, &pore_type_again));
+                CHECK(pore_type_again == pore_type);
+                CHECK(pod5_get_cached_pore_type(batch_0, -1, &pore_type) == POD5_ERROR_INDEXERROR);
+
+                pod5_end_reason end_reason = POD5_END_REASON_UNKNOWN;
+                char const * end_reason_string = nullptr;
+                CHECK_POD5_OK(pod5_get_cached_end_reason(
+                    batch_0, v3_struct.end_reason, &end_reason, &end_reason_string));
+                CHECK(end_reason == POD5_END_REASON_MUX_CHANGE);
+                CHECK(end_reason_string == expected_end_reason);
+                CHECK(
+                    pod5_get_cached_end_reason(
+                        batch_0, v3_struct.end_reason + 100, &end_reason, &end_reason_string)
+                    == POD5_ERROR_INDEXERROR);
+            }
+
             CalibrationExtraData calibration_extra_data{};
             CHECK_POD5_OK(pod5_get_calibration_extra_info(batch_0, row, &calibration_extra_data));
             CHECK(calibration_extra_data.digitisation == adc_max - adc_min + 1);
@@ -445,7 +698,7 @@ SCENARIO("C API Reads")
             pod5_get_file_run_info(file, run_info_count, &run_info_error) == POD5_ERROR_INDEXERROR);
         CHECK(!run_info_error);
 
-        auto check_run_info = [](RunInfoDictData * run_info) {
+        auto check_run_info = [](RunInfoDictData const * run_info) {
             REQUIRE(!!run_info);
             CHECK(run_info->tracking_id.size == 2);
             CHECK(run_info->tracking_id.keys[0] == std::string("baz"));
@@ -469,6 +722,17 @@ SCENARIO("C API Reads")
         check_run_info(run_info_data_out_2);
         pod5_free_run_info(run_info_data_out_2);
 
+        RunInfoDictData const * cached_run_info = nullptr;
+        CHECK_POD5_OK(pod5_get_cached_run_info(batch_0, 0, &cached_run_info));
+        check_run_info(cached_run_info);
+        RunInfoDictData const * cached_run_info_again = nullptr;
+        CHECK_POD5_OK(pod5_get_cached_run_info(batch_0, 0, &cached_run_info_again));
+        CHECK(cached_run_info_again == cached_run_info);
+        CHECK(pod5_get_cached_run_info(batch_0, -1, &cached_run_info) == POD5_ERROR_INDEXERROR);
+        CHECK(
+            pod5_get_cached_run_info(batch_0, run_info_count, &cached_run_info)
+            == POD5_ERROR_INDEXERROR);
+
         pod5_free_read_batch(batch_0);
 
         pod5_close_and_free_reader(file);
@@ -642,6 +906,279 @@ SCENARIO("C API Many Reads")
         CHECK_POD5_OK(pod5_get_read_count(file, &read_count_returned));
         REQUIRE(read_count_returned == read_count);
 
+        {
+            Pod5ReadRecordBatch * batch = nullptr;
+            CHECK_POD5_OK(pod5_get_read_batch(&batch, file, 0));
+            REQUIRE(!!batch);
+
+            std::vector<std::uint32_t> batch_rows{5, 0, 17, 3};
+            std::vector<std::uint64_t> signal_offsets(batch_rows.size() + 1);
+            CHECK_POD5_OK(pod5_get_reads_complete_signal_batch(
+                file,
+                batch,
+                batch_rows.size(),
+                batch_rows.data(),
+                0,
+                nullptr,
+                signal_offsets.data()));
+            CHECK(signal_offsets.back() == batch_rows.size() * signal_1.size());
+
+            std::vector<std::int16_t> signal(signal_offsets.back());
+            std::fill(signal_offsets.begin(), signal_offsets.end(), 0);
+            CHECK_POD5_OK(pod5_get_reads_complete_signal_batch(
+                file,
+                batch,
+                batch_rows.size(),
+                batch_rows.data(),
+                signal.size(),
+                signal.data(),
+                signal_offsets.data()));
+            for (std::size_t i = 0; i < batch_rows.size(); ++i) {
+                CHECK(signal_offsets[i] == i * signal_1.size());
+                CHECK(
+                    gsl::make_span(signal).subspan(signal_offsets[i], signal_1.size())
+                    == gsl::make_span(signal_1));
+            }
+
+            // Too short an output buffer:
+            CHECK(
+                pod5_get_reads_complete_signal_batch(
+                    file,
+                    batch,
+                    batch_rows.size(),
+                    batch_rows.data(),
+                    signal.size() - 1,
+                    signal.data(),
+                    signal_offsets.data())
+                == POD5_ERROR_INVALID);
+
+            // Whole columns can be copied out of the batch:
+            std::size_t row_count = 0;
+            CHECK_POD5_OK(pod5_get_read_batch_row_count(&row_count, batch));
+            std::vector<std::uint16_t> channels(row_count);
+            CHECK_POD5_OK(pod5_get_read_batch_column(
+                batch,
+                POD5_READ_COLUMN_CHANNEL,
+                0,
+                row_count,
+                sizeof(std::uint16_t),
+                channels.data()));
+            CHECK(channels == std::vector<std::uint16_t>(row_count, 43));
+
+            std::vector<pod5::Uuid> read_ids(2);
+            CHECK_POD5_OK(pod5_get_read_batch_column(
+                batch, POD5_READ_COLUMN_READ_ID, 3, 2, sizeof(read_id_t), read_ids.data()));
+            CHECK(read_ids == std::vector<pod5::Uuid>(2, input_read_id));
+
+            std::vector<float> calibration_scales(row_count);
+            CHECK_POD5_OK(pod5_get_read_batch_column(
+                batch,
+                POD5_READ_COLUMN_CALIBRATION_SCALE,
+                0,
+                row_count,
+                sizeof(float),
+                calibration_scales.data()));
+            CHECK(calibration_scales == std::vector<float>(row_count, 100.0f));
+
+            std::vector<std::uint8_t> end_reasons_forced(row_count, 1);
+            CHECK_POD5_OK(pod5_get_read_batch_column(
+                batch,
+                POD5_READ_COLUMN_END_REASON_FORCED,
+                0,
+                row_count,
+                sizeof(std::uint8_t),
+                end_reasons_forced.data()));
+            CHECK(end_reasons_forced == std::vector<std::uint8_t>(row_count, 0));
+
+            std::vector<std::uint32_t> signal_row_counts(row_count);
+            CHECK_POD5_OK(pod5_get_read_batch_column(
+                batch,
+                POD5_READ_COLUMN_SIGNAL_ROW_COUNT,
+                0,
+                row_count,
+                sizeof(std::uint32_t),
+                signal_row_counts.data()));
+            CHECK(signal_row_counts == std::vector<std::uint32_t>(row_count, 1));
+
+            // The value size must match the column, and the rows must be in the batch:
+            CHECK(
+                pod5_get_read_batch_column(
+                    batch,
+                    POD5_READ_COLUMN_CHANNEL,
+                    0,
+                    row_count,
+                    sizeof(std::uint32_t),
+                    channels.data())
+                == POD5_ERROR_INVALID);
+            CHECK(
+                pod5_get_read_batch_column(
+                    batch,
+                    POD5_READ_COLUMN_CHANNEL,
+                    1,
+                    row_count,
+                    sizeof(std::uint16_t),
+                    channels.data())
+                == POD5_ERROR_INDEXERROR);
+
+            CHECK_POD5_OK(pod5_free_read_batch(batch));
+        }
+
+        {
+            std::size_t batch_count = 0;
+            CHECK_POD5_OK(pod5_get_read_batch_count(&batch_count, file));
+            REQUIRE(batch_count > 1);
+
+            // Load every read:
+            Pod5SignalLoader_t * loader = nullptr;
+            Pod5SignalLoaderOptions_t loader_options{};
+            loader_options.worker_count = 2;
+            CHECK_POD5_OK(
+                pod5_create_signal_loader(file, nullptr, 0, nullptr, 0, &loader_options, &loader));
+            REQUIRE(!!loader);
+            std::size_t worker_count = 0;
+            CHECK_POD5_OK(pod5_get_signal_loader_worker_count(loader, &worker_count));
+            CHECK(worker_count == 2);
+
+            std::size_t batches_loaded = 0;
+            std::size_t reads_loaded = 0;
+            Pod5SignalLoaderBatch_t * loaded_batch = nullptr;
+            while (true) {
+                CHECK_POD5_OK(pod5_signal_loader_release_next_batch(loader, &loaded_batch));
+                if (!loaded_batch) {
+                    break;
+                }
+                CHECK(loaded_batch->batch_index == batches_loaded);
+                REQUIRE(!!loaded_batch->samples);
+                for (std::size_t row = 0; row < loaded_batch->row_count; ++row) {
+                    CHECK(loaded_batch->batch_rows[row] == row);
+                    CHECK(loaded_batch->sample_counts[row] == signal_1.size());
+                    CHECK(
+                        gsl::make_span(
+                            loaded_batch->samples + loaded_batch->sample_offsets[row],
+                            loaded_batch->sample_counts[row])
+                        == gsl::make_span(signal_1));
+                }
+                reads_loaded += loaded_batch->row_count;
+                batches_loaded += 1;
+                CHECK_POD5_OK(pod5_free_signal_loader_batch(loaded_batch));
+            }
+            CHECK(batches_loaded == batch_count);
+            CHECK(reads_loaded == read_count);
+            CHECK_POD5_OK(pod5_close_and_free_signal_loader(loader));
+
+            // Load a plan of two reads in the second batch, sample counts only:
+            std::vector<std::uint32_t> batch_counts(batch_count, 0);
+            batch_counts[1] = 2;
+            std::vector<std::uint32_t> batch_rows{7, 2};
+            loader_options.sample_counts_only = true;
+            CHECK(
+                pod5_create_signal_loader(
+                    file,
+                    batch_counts.data(),
+                    batch_counts.size() - 1,
+                    batch_rows.data(),
+                    batch_rows.size(),
+                    &loader_options,
+                    &loader)
+                == POD5_ERROR_INVALID);
+            CHECK_POD5_OK(pod5_create_signal_loader(
+                file,
+                batch_counts.data(),
+                batch_counts.size(),
+                batch_rows.data(),
+                batch_rows.size(),
+                &loader_options,
+                &loader));
+
+            std::size_t planned_reads_loaded = 0;
+            while (true) {
+                CHECK_POD5_OK(
+                    pod5_signal_loader_release_next_completed_batch(loader, &loaded_batch));
+                if (!loaded_batch) {
+                    break;
+                }
+                CHECK(loaded_batch->row_count == batch_counts[loaded_batch->batch_index]);
+                CHECK(!loaded_batch->samples);
+                for (std::size_t row = 0; row < loaded_batch->row_count; ++row) {
+                    CHECK(loaded_batch->batch_rows[row] == batch_rows[row]);
+                    CHECK(loaded_batch->sample_counts[row] == signal_1.size());
+                }
+                planned_reads_loaded += loaded_batch->row_count;
+                CHECK_POD5_OK(pod5_free_signal_loader_batch(loaded_batch));
+            }
+            CHECK(planned_reads_loaded == batch_rows.size());
+            CHECK_POD5_OK(pod5_close_and_free_signal_loader(loader));
+        }
+
+        // Many threads read from one reader at once, each seeing only its own errors:
+        {
+            std::size_t batch_count = 0;
+            CHECK_POD5_OK(pod5_get_read_batch_count(&batch_count, file));
+
+            std::size_t const thread_count = 8;
+            std::atomic<std::size_t> threads_ready{0};
+            std::atomic<std::size_t> reads_checked{0};
+            std::atomic<std::size_t> failures{0};
+
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t < thread_count; ++t) {
+                threads.emplace_back([&, t] {
+                    // Half the threads make a failing call before all threads start reading:
+                    bool const expect_error = t % 2 == 1;
+                    if (expect_error) {
+                        Pod5ReadRecordBatch * batch = nullptr;
+                        if (pod5_get_read_batch(&batch, file, batch_count) == POD5_OK) {
+                            failures += 1;
+                        }
+                    }
+                    threads_ready += 1;
+                    while (threads_ready < thread_count) {
+                        std::this_thread::yield();
+                    }
+
+                    // Other threads' calls have neither cleared nor set this thread's error:
+                    if ((pod5_get_error_no() != POD5_OK) != expect_error
+                        || (std::string{pod5_get_error_string()}.empty() == expect_error))
+                    {
+                        failures += 1;
+                    }
+
+                    std::vector<std::int16_t> read_signal(signal_1.size());
+                    for (std::size_t batch_index = 0; batch_index < batch_count; ++batch_index) {
+                        Pod5ReadRecordBatch * batch = nullptr;
+                        if (pod5_get_read_batch(&batch, file, batch_index) != POD5_OK) {
+                            failures += 1;
+                            continue;
+                        }
+
+                        std::size_t row_count = 0;
+                        pod5_get_read_batch_row_count(&row_count, batch);
+                        for (std::size_t row = t; row < row_count; row += thread_count) {
+                            std::size_t sample_count = 0;
+                            if (pod5_get_read_complete_sample_count(file, batch, row, &sample_count)
+                                    != POD5_OK
+                                || sample_count != signal_1.size()
+                                || pod5_get_read_complete_signal(
+                                       file, batch, row, sample_count, read_signal.data())
+                                       != POD5_OK
+                                || read_signal != signal_1)
+                            {
+                                failures += 1;
+                            }
+                            reads_checked += 1;
+                        }
+                        pod5_free_read_batch(batch);
+                    }
+                });
+            }
+            for (auto & thread : threads) {
+                thread.join();
+            }
+
+            CHECK(failures == 0);
+            CHECK(reads_checked == read_count);
+        }
+
         pod5_close_and_free_reader(file);
         CHECK_POD5_OK(pod5_get_error_no());
     }
@@ -733,3 +1270,210 @@ SCENARIO("C API Run Info")
         CHECK_POD5_OK(pod5_close_and_free_reader(file));
     }
 }
+
+SCENARIO("C API Batch Signal Compression")
+{
+    std::vector<std::vector<std::int16_t>> signals(20);
+    std::vector<int16_t const *> signal_data;
+    std::vector<size_t> signal_size;
+    std::size_t max_size = 0;
+    for (std::size_t i = 0; i < signals.size(); ++i) {
+        signals[i].resize(1000 * (i + 1));
+        std::iota(signals[i].begin(), signals[i].end(), static_cast<std::int16_t>(i));
+        signal_data.push_back(signals[i].data());
+        signal_size.push_back(signals[i].size());
+        max_size += pod5_vbz_compressed_signal_max_size(signals[i].size());
+    }
+
+    std::vector<char> compressed(max_size);
+    std::vector<size_t> offsets(signals.size() + 1);
+    CHECK_POD5_OK(pod5_vbz_compress_signal_batch(
+        signals.size(),
+        signal_data.data(),
+        signal_size.data(),
+        compressed.data(),
+        compressed.size(),
+        offsets.data()));
+
+    for (std::size_t i = 0; i < signals.size(); ++i) {
+        std::vector<std::int16_t> decompressed(signals[i].size());
+        CHECK_POD5_OK(pod5_vbz_decompress_signal(
+            compressed.data() + offsets[i],
+            offsets[i + 1] - offsets[i],
+            decompressed.size(),
+            decompressed.data()));
+        CHECK(decompressed == signals[i]);
+    }
+
+    CHECK(
+        pod5_vbz_compress_signal_batch(
+            signals.size(),
+            signal_data.data(),
+            signal_size.data(),
+            compressed.data(),
+            offsets.back(),
+            offsets.data())
+        == POD5_ERROR_INVALID);
+}
+
+SCENARIO("C API Signal Summaries")
+{
+    static constexpr char const * filename = "./foo_c_api_signal_summary.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(filename));
+
+    pod5_init();
+    auto fin = gsl::finally([] { pod5_terminate(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::vector<std::int16_t> signal(1000);
+    std::iota(signal.begin(), signal.end(), 0);
+    Pod5ReadId const read_id{uuid_gen()};
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_summary_decimations({16, 256});
+        auto writer = pod5::create_file_writer(filename, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        pod5::ReadData read_data;
+        read_data.read_id = read_id.as_uuid();
+        read_data.run_info = *(*writer)->add_run_info(get_test_run_info_data());
+        read_data.pore_type = *(*writer)->add_pore_type("Pore_type");
+        read_data.end_reason = *(*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto file = pod5_open_file(filename);
+    REQUIRE(file);
+    auto close_file = gsl::finally([&] { pod5_close_and_free_reader(file); });
+
+    std::size_t decimation_count = 0;
+    CHECK_POD5_OK(pod5_get_signal_summary_decimations(file, 0, nullptr, &decimation_count));
+    REQUIRE(decimation_count == 2);
+    std::vector<std::uint32_t> decimations(1);
+    CHECK(
+        pod5_get_signal_summary_decimations(
+            file, decimations.size(), decimations.data(), &decimation_count)
+        == POD5_ERROR_CAPACITYERROR);
+    decimations.resize(decimation_count);
+    CHECK_POD5_OK(pod5_get_signal_summary_decimations(
+        file, decimations.size(), decimations.data(), &decimation_count));
+    CHECK(decimations == std::vector<std::uint32_t>{16, 256});
+
+    std::size_t level_size = 0;
+    std::uint8_t has_summary = 0;
+    CHECK_POD5_OK(pod5_get_read_signal_summary(
+        file, read_id.read_id, 16, 0, nullptr, nullptr, nullptr, &level_size, &has_summary));
+    REQUIRE(has_summary == 1);
+    REQUIRE(level_size == (signal.size() + 15) / 16);
+
+    std::vector<std::int16_t> min(level_size);
+    std::vector<std::int16_t> max(level_size);
+    std::vector<std::int16_t> mean(level_size);
+    CHECK_POD5_OK(pod5_get_read_signal_summary(
+        file,
+        read_id.read_id,
+        16,
+        level_size,
+        min.data(),
+        max.data(),
+        mean.data(),
+        &level_size,
+        &has_summary));
+    gsl::span<std::int16_t const> const chunks[] = {signal};
+    auto const expected = pod5::summarise_signal(gsl::make_span(chunks), 16);
+    CHECK(min == expected.min);
+    CHECK(max == expected.max);
+    CHECK(mean == expected.mean);
+
+    CHECK(
+        pod5_get_read_signal_summary(
+            file,
+            read_id.read_id,
+            16,
+            level_size - 1,
+            min.data(),
+            max.data(),
+            mean.data(),
+            &level_size,
+            &has_summary)
+        == POD5_ERROR_CAPACITYERROR);
+
+    // No summary at other decimations, or for other reads:
+    CHECK_POD5_OK(pod5_get_read_signal_summary(
+        file, read_id.read_id, 64, 0, nullptr, nullptr, nullptr, &level_size, &has_summary));
+    CHECK(has_summary == 0);
+    Pod5ReadId const other_read_id{uuid_gen()};
+    CHECK_POD5_OK(pod5_get_read_signal_summary(
+        file, other_read_id.read_id, 16, 0, nullptr, nullptr, nullptr, &level_size, &has_summary));
+    CHECK(has_summary == 0);
+}
+
+SCENARIO("C API Thread Pool Statistics")
+{
+    // Run some work on the shared pool:
+    std::vector<std::int16_t> signal(100'000);
+    std::iota(signal.begin(), signal.end(), 0);
+    std::vector<int16_t const *> signal_data(4, signal.data());
+    std::vector<size_t> signal_size(4, signal.size());
+    std::vector<char> compressed(4 * pod5_vbz_compressed_signal_max_size(signal.size()));
+    std::vector<size_t> offsets(5);
+    CHECK_POD5_OK(pod5_vbz_compress_signal_batch(
+        signal_data.size(),
+        signal_data.data(),
+        signal_size.data(),
+        compressed.data(),
+        compressed.size(),
+        offsets.data()));
+
+    Pod5ThreadPoolStatistics_t statistics{};
+    std::vector<double> busy_ratios(256, -1.0);
+    CHECK_POD5_OK(
+        pod5_get_thread_pool_statistics(&statistics, busy_ratios.data(), busy_ratios.size()));
+    CHECK(statistics.worker_count > 0);
+    // Helper tasks may still be finishing once the calling thread has done the work:
+    CHECK(statistics.queued_tasks + statistics.running_tasks + statistics.tasks_run > 0);
+    CHECK(
+        std::accumulate(
+            std::begin(statistics.run_time_histogram),
+            std::end(statistics.run_time_histogram),
+            std::uint64_t(0))
+        == statistics.tasks_run);
+    for (std::size_t i = 0; i < std::min<std::size_t>(statistics.worker_count, 256); ++i) {
+        CHECK(busy_ratios[i] >= 0.0);
+        CHECK(busy_ratios[i] <= 1.0);
+    }
+
+    CHECK(pod5_get_thread_pool_statistics(nullptr, nullptr, 0) == POD5_ERROR_INVALID);
+}
+
+SCENARIO("C API Read Id Formatting")
+{
+    auto engine = pod5::UuidRandomGenerator::engine_type{Catch::rngSeed()};
+    pod5::UuidRandomGenerator gen{engine};
+    std::vector<pod5::Uuid> read_ids(5);
+    std::generate(read_ids.begin(), read_ids.end(), gen);
+    auto const read_id_data = reinterpret_cast<read_id_t const *>(read_ids.data());
+
+    std::string formatted(read_ids.size() * 36, '\0');
+    CHECK_POD5_OK(pod5_format_read_ids(read_id_data, read_ids.size(), &formatted[0]));
+    for (std::size_t i = 0; i < read_ids.size(); ++i) {
+        CHECK(formatted.substr(i * 36, 36) == to_string(read_ids[i]));
+    }
+
+    std::vector<pod5::Uuid> parsed(read_ids.size());
+    auto const parsed_data = reinterpret_cast<read_id_t *>(parsed.data());
+    CHECK_POD5_OK(pod5_parse_read_ids(formatted.data(), parsed.size(), parsed_data));
+    CHECK(parsed == read_ids);
+
+    // The first string which isn't a read id is reported:
+    formatted[3 * 36 + 10] = 'x';
+    CHECK(pod5_parse_read_ids(formatted.data(), parsed.size(), parsed_data) == POD5_ERROR_INVALID);
+    CHECK(std::string{pod5_get_error_string()}.find("index 3") != std::string::npos);
+
+    CHECK(pod5_format_read_ids(nullptr, 1, &formatted[0]) == POD5_ERROR_INVALID);
+    CHECK(pod5_parse_read_ids(formatted.data(), 1, nullptr) == POD5_ERROR_INVALID);
+    CHECK_POD5_OK(pod5_parse_read_ids(nullptr, 0, nullptr));
+}
@@ -0,0 +1,98 @@
+#include "pod5_format/internal/concurrency_tuner.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+using pod5::internal::ConcurrencyTuner;
+
+namespace {
+
+// Run [intervals] sample intervals of [tuner], each delivering the work [throughput] gives for
+// the concurrency at its start, returning the lowest and highest concurrency of the last
+// [settled_intervals].
+std::pair<std::size_t, std::size_t> run_intervals(
+    ConcurrencyTuner & tuner,
+    ConcurrencyTuner::Clock::time_point & now,
+    std::size_t intervals,
+    std::size_t settled_intervals,
+    std::function<std::uint64_t(std::size_t)> const & throughput,
+    double stall_ratio = 0)
+{
+    auto const interval = std::chrono::milliseconds(100);
+    std::size_t lowest = tuner.max_concurrency();
+    std::size_t highest = tuner.min_concurrency();
+    for (std::size_t i = 0; i < intervals; ++i) {
+        auto const concurrency = tuner.concurrency();
+        tuner.add_work(throughput(concurrency));
+        tuner.add_stall(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            interval * stall_ratio * double(concurrency)));
+        now += interval;
+        tuner.update(now);
+        if (i + settled_intervals >= intervals) {
+            lowest = std::min(lowest, tuner.concurrency());
+            highest = std::max(highest, tuner.concurrency());
+        }
+    }
+    return {lowest, highest};
+}
+
+}  // namespace
+
+TEST_CASE("Concurrency tuner settles around the knee of the throughput curve", "[concurrency]")
+{
+    auto now = ConcurrencyTuner::Clock::now();
+    ConcurrencyTuner tuner(1, 16, std::chrono::milliseconds(100), now);
+    CHECK(tuner.concurrency() == 9);
+
+    // Throughput stops growing past 6 workers, as when the storage is saturated:
+    auto const settled = run_intervals(tuner, now, 60, 20, [](std::size_t concurrency) {
+        return std::min<std::uint64_t>(concurrency, 6) * 1000;
+    });
+    CHECK(settled.first >= 5);
+    CHECK(settled.second <= 7);
+}
+
+TEST_CASE("Concurrency tuner climbs while workers add throughput", "[concurrency]")
+{
+    auto now = ConcurrencyTuner::Clock::now();
+    ConcurrencyTuner tuner(2, 12, std::chrono::milliseconds(100), now);
+
+    auto const settled = run_intervals(
+        tuner, now, 40, 10, [](std::size_t concurrency) { return concurrency * 1000; });
+    CHECK(settled.first >= 11);
+    CHECK(settled.second == 12);
+}
+
+TEST_CASE("Concurrency tuner removes workers held back by pending limits", "[concurrency]")
+{
+    auto now = ConcurrencyTuner::Clock::now();
+    ConcurrencyTuner tuner(2, 12, std::chrono::milliseconds(100), now);
+
+    // Workers spend half their time waiting for results to be taken, however many there are:
+    auto const settled = run_intervals(
+        tuner, now, 20, 5, [](std::size_t concurrency) { return concurrency * 1000; }, 0.5);
+    CHECK(settled.first == 2);
+    CHECK(settled.second == 2);
+}
+
+TEST_CASE("Concurrency tuner only steps once per sample interval", "[concurrency]")
+{
+    auto now = ConcurrencyTuner::Clock::now();
+    ConcurrencyTuner tuner(1, 8, std::chrono::milliseconds(100), now);
+    auto const start = tuner.concurrency();
+
+    tuner.add_work(1000);
+    CHECK(!tuner.update(now + std::chrono::milliseconds(50)));
+    CHECK(tuner.concurrency() == start);
+
+    // The first interval probes upwards:
+    CHECK(tuner.update(now + std::chrono::milliseconds(150)));
+    CHECK(tuner.concurrency() == start + 1);
+
+    // Idle intervals are skipped:
+    CHECK(!tuner.update(now + std::chrono::milliseconds(300)));
+    CHECK(tuner.concurrency() == start + 1);
+}
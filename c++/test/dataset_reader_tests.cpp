@@ -0,0 +1,349 @@
+#include "pod5_format/dataset_reader.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/schema_metadata.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Write a file holding [read_ids], five reads per read table batch.
+void write_dataset_file(std::string const & path, std::vector<pod5::Uuid> const & read_ids)
+{
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(path));
+
+    pod5::FileWriterOptions options;
+    options.set_read_table_batch_size(5);
+    auto writer = pod5::create_file_writer(path, "test_software", options);
+    REQUIRE_ARROW_STATUS_OK(writer);
+
+    auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+    auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    auto pore_type = (*writer)->add_pore_type("pore_type");
+
+    std::vector<std::int16_t> const signal(10, 1);
+    for (std::size_t i = 0; i < read_ids.size(); ++i) {
+        pod5::ReadData read_data;
+        read_data.read_id = read_ids[i];
+        read_data.read_number = i;
+        read_data.start_sample = 0;
+        read_data.channel = 1;
+        read_data.well = 1;
+        read_data.pore_type = *pore_type;
+        read_data.end_reason = *end_reason;
+        read_data.end_reason_forced = false;
+        read_data.run_info = *run_info;
+        CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+    }
+    CHECK_ARROW_STATUS_OK((*writer)->close());
+}
+
+// Write a file of reads with [read_lengths] samples, four reads per read table batch.
+void write_sized_dataset_file(
+    std::string const & path,
+    std::vector<std::size_t> const & read_lengths,
+    bool write_file_summary)
+{
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(path));
+
+    pod5::FileWriterOptions options;
+    options.set_read_table_batch_size(4);
+    options.set_write_file_summary(write_file_summary);
+    auto writer = pod5::create_file_writer(path, "test_software", options);
+    REQUIRE_ARROW_STATUS_OK(writer);
+
+    auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+    auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    auto pore_type = (*writer)->add_pore_type("pore_type");
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    for (std::size_t i = 0; i < read_lengths.size(); ++i) {
+        pod5::ReadData read_data;
+        read_data.read_id = uuid_gen();
+        read_data.read_number = i;
+        read_data.pore_type = *pore_type;
+        read_data.end_reason = *end_reason;
+        read_data.run_info = *run_info;
+        std::vector<std::int16_t> const signal(read_lengths[i], 1);
+        CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+    }
+    CHECK_ARROW_STATUS_OK((*writer)->close());
+}
+
+}  // namespace
+
+SCENARIO("Reading a dataset of files")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    // Three files of 12 reads, the last read of each file is repeated as the first of the next:
+    std::vector<std::string> const paths{
+        "./dataset_0.pod5", "./dataset_1.pod5", "./dataset_2.pod5"};
+    std::vector<std::vector<pod5::Uuid>> file_read_ids(paths.size());
+    for (std::size_t file = 0; file < paths.size(); ++file) {
+        if (file != 0) {
+            file_read_ids[file].push_back(file_read_ids[file - 1].back());
+        }
+        while (file_read_ids[file].size() < 12) {
+            file_read_ids[file].push_back(uuid_gen());
+        }
+        write_dataset_file(paths[file], file_read_ids[file]);
+    }
+
+    pod5::DatasetReaderOptions options;
+    options.set_max_open_files(2);
+    auto dataset = pod5::open_dataset_reader(paths, options);
+    REQUIRE_ARROW_STATUS_OK(dataset);
+    CHECK((*dataset)->file_count() == 3);
+    CHECK((*dataset)->file_path(2) == paths[2]);
+
+    WHEN("Opening files")
+    {
+        CHECK((*dataset)->open_file_count() == 0);
+        for (std::size_t file = 0; file < paths.size(); ++file) {
+            auto reader = (*dataset)->file_reader(file);
+            REQUIRE_ARROW_STATUS_OK(reader);
+            CHECK(*(*reader)->read_count() == 12);
+            CHECK((*dataset)->open_file_count() <= 2);
+        }
+        CHECK((*dataset)->file_reader(3).status().IsIndexError());
+    }
+
+    WHEN("Searching for reads")
+    {
+        auto read_count = (*dataset)->read_count();
+        REQUIRE_ARROW_STATUS_OK(read_count);
+        CHECK(*read_count == 36);
+
+        auto index = (*dataset)->index();
+        REQUIRE_ARROW_STATUS_OK(index);
+        CHECK((*index)->has_duplicate_read_ids());
+        CHECK((*index)->file_paths() == paths);
+
+        // Search for reads from the end of the dataset back to the start, and a missing read:
+        std::vector<pod5::Uuid> search{
+            file_read_ids[2][7], uuid_gen(), file_read_ids[1][0], file_read_ids[0][3]};
+        std::vector<pod5::DatasetReadLocation> locations(search.size());
+        auto found_count =
+            (*dataset)->search_for_read_ids(gsl::make_span(search), gsl::make_span(locations));
+        REQUIRE_ARROW_STATUS_OK(found_count);
+        REQUIRE(*found_count == 3);
+
+        // Results are in traversal order, a duplicated read is found in its first file:
+        CHECK(locations[0].file == 0);
+        CHECK(locations[0].batch == 0);
+        CHECK(locations[0].batch_row == 3);
+        CHECK(locations[1].file == 0);
+        CHECK(locations[1].batch == 2);
+        CHECK(locations[1].batch_row == 1);
+        CHECK(locations[2].file == 2);
+        CHECK(locations[2].batch == 1);
+        CHECK(locations[2].batch_row == 2);
+
+        std::vector<pod5::DatasetReadLocation> short_locations(1);
+        CHECK(!(*dataset)
+                   ->search_for_read_ids(gsl::make_span(search), gsl::make_span(short_locations))
+                   .ok());
+    }
+
+    WHEN("Writing and loading the index")
+    {
+        static constexpr char const * index_path = "./dataset.index";
+        REQUIRE_ARROW_STATUS_OK((*dataset)->write_index(index_path));
+
+        auto reopened = pod5::open_dataset_reader(paths, options);
+        REQUIRE_ARROW_STATUS_OK(reopened);
+        REQUIRE_ARROW_STATUS_OK((*reopened)->load_index(index_path));
+        auto index = (*reopened)->index();
+        REQUIRE_ARROW_STATUS_OK(index);
+        CHECK((*index)->size() == 36);
+        CHECK((*index)->file_identifiers()[1]
+              == (*(*dataset)->file_reader(1))->schema_metadata().file_identifier);
+
+        std::vector<pod5::Uuid> search{file_read_ids[1][5]};
+        std::vector<pod5::DatasetReadLocation> locations(search.size());
+        auto found_count =
+            (*reopened)->search_for_read_ids(gsl::make_span(search), gsl::make_span(locations));
+        REQUIRE_ARROW_STATUS_OK(found_count);
+        REQUIRE(*found_count == 1);
+        CHECK(locations[0].file == 1);
+        CHECK(locations[0].batch == 1);
+        CHECK(locations[0].batch_row == 0);
+
+        AND_WHEN("The index is loaded for different files")
+        {
+            auto other = pod5::open_dataset_reader({paths[0], paths[1]}, options);
+            REQUIRE_ARROW_STATUS_OK(other);
+            CHECK((*other)->load_index(index_path).IsInvalid());
+        }
+
+        AND_WHEN("A file is rewritten after indexing")
+        {
+            write_dataset_file(paths[1], file_read_ids[1]);
+
+            auto stale = pod5::open_dataset_reader(paths, options);
+            REQUIRE_ARROW_STATUS_OK(stale);
+            REQUIRE_ARROW_STATUS_OK((*stale)->load_index(index_path));
+            CHECK_ARROW_STATUS_OK((*stale)->file_reader(0));
+            CHECK((*stale)->file_reader(1).status().IsIOError());
+        }
+    }
+
+    WHEN("Updating a stored index as files are added and removed")
+    {
+        static constexpr char const * index_path = "./dataset_update.index";
+        REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(index_path));
+
+        // A missing index is built in full and written:
+        auto first_files = pod5::open_dataset_reader({paths[0], paths[1]}, options);
+        REQUIRE_ARROW_STATUS_OK(first_files);
+        REQUIRE_ARROW_STATUS_OK((*first_files)->update_index(index_path));
+        CHECK(*(*first_files)->read_count() == 24);
+
+        // Adding a file indexes only that file, keeping the stored entries:
+        REQUIRE_ARROW_STATUS_OK((*dataset)->update_index(index_path));
+        auto index = (*dataset)->index();
+        REQUIRE_ARROW_STATUS_OK(index);
+        CHECK((*index)->size() == 36);
+        CHECK((*index)->file_paths() == paths);
+        CHECK((*index)->has_duplicate_read_ids());
+
+        std::vector<pod5::Uuid> search{file_read_ids[2][7], file_read_ids[0][3]};
+        std::vector<pod5::DatasetReadLocation> locations(search.size());
+        auto found_count =
+            (*dataset)->search_for_read_ids(gsl::make_span(search), gsl::make_span(locations));
+        REQUIRE_ARROW_STATUS_OK(found_count);
+        REQUIRE(*found_count == 2);
+        CHECK(locations[0].file == 0);
+        CHECK(locations[0].batch_row == 3);
+        CHECK(locations[1].file == 2);
+        CHECK(locations[1].batch == 1);
+        CHECK(locations[1].batch_row == 2);
+
+        // The stored index now matches the whole dataset:
+        auto reopened = pod5::open_dataset_reader(paths, options);
+        REQUIRE_ARROW_STATUS_OK(reopened);
+        CHECK_ARROW_STATUS_OK((*reopened)->load_index(index_path));
+
+        AND_WHEN("Files are removed and reordered")
+        {
+            auto fewer_files = pod5::open_dataset_reader({paths[2], paths[0]}, options);
+            REQUIRE_ARROW_STATUS_OK(fewer_files);
+            REQUIRE_ARROW_STATUS_OK((*fewer_files)->update_index(index_path));
+            CHECK(*(*fewer_files)->read_count() == 24);
+
+            std::vector<pod5::Uuid> search{file_read_ids[1][5], file_read_ids[0][3]};
+            std::vector<pod5::DatasetReadLocation> locations(search.size());
+            auto found_count = (*fewer_files)
+                                   ->search_for_read_ids(
+                                       gsl::make_span(search), gsl::make_span(locations));
+            REQUIRE_ARROW_STATUS_OK(found_count);
+            REQUIRE(*found_count == 1);
+            CHECK(locations[0].file == 1);
+            CHECK(locations[0].batch == 0);
+            CHECK(locations[0].batch_row == 3);
+        }
+    }
+}
+
+SCENARIO("Splitting a dataset into shards")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_file_summary = GENERATE(true, false);
+    CAPTURE(write_file_summary);
+
+    // A small file, a large file of long reads a boundary falls within, and a mid sized file:
+    std::vector<std::string> const paths{
+        "./dataset_shard_0.pod5", "./dataset_shard_1.pod5", "./dataset_shard_2.pod5"};
+    std::vector<std::vector<std::size_t>> const file_read_lengths{
+        std::vector<std::size_t>(3, 10),
+        std::vector<std::size_t>(40, 200),
+        std::vector<std::size_t>(10, 50),
+    };
+    std::uint64_t total_samples = 0;
+    std::size_t total_batches = 0;
+    for (std::size_t file = 0; file < paths.size(); ++file) {
+        write_sized_dataset_file(paths[file], file_read_lengths[file], write_file_summary);
+        for (auto length : file_read_lengths[file]) {
+            total_samples += length;
+        }
+        total_batches += (file_read_lengths[file].size() + 3) / 4;
+    }
+
+    auto dataset = pod5::open_dataset_reader(paths);
+    REQUIRE_ARROW_STATUS_OK(dataset);
+    CHECK_ARROW_STATUS_NOT_OK((*dataset)->plan_shards(0));
+
+    std::size_t const shard_count = 4;
+    auto shards = (*dataset)->plan_shards(shard_count);
+    REQUIRE_ARROW_STATUS_OK(shards);
+    REQUIRE(shards->size() == shard_count);
+
+    // Shards cover every batch once, in dataset order, within a batch's samples of even:
+    std::uint64_t const max_batch_samples = 4 * 200;
+    std::uint64_t sample_count = 0;
+    std::size_t batch_count = 0;
+    std::pair<std::uint32_t, std::uint32_t> next_batch{0, 0};
+    for (auto const & shard : *shards) {
+        CHECK(shard.sample_count + max_batch_samples >= total_samples / shard_count);
+        CHECK(shard.sample_count <= total_samples / shard_count + max_batch_samples);
+        sample_count += shard.sample_count;
+        for (auto const & unit : shard.units) {
+            if (unit.file != next_batch.first) {
+                CHECK(next_batch.second == (file_read_lengths[next_batch.first].size() + 3) / 4);
+                next_batch = {unit.file, 0};
+            }
+            CHECK(unit.first_batch == next_batch.second);
+            CHECK(unit.file_path == paths[unit.file]);
+            next_batch.second += unit.batch_count;
+            batch_count += unit.batch_count;
+        }
+    }
+    CHECK(sample_count == total_samples);
+    CHECK(batch_count == total_batches);
+
+    // The large file is split between shards:
+    CHECK((*shards)[0].units.back().file == 1);
+    CHECK((*shards)[1].units.front().file == 1);
+
+    THEN("Each work unit opens on its own")
+    {
+        for (auto const & shard : *shards) {
+            for (auto const & unit : shard.units) {
+                auto unit_reader = pod5::open_dataset_work_unit(unit);
+                REQUIRE_ARROW_STATUS_OK(unit_reader);
+                REQUIRE((*unit_reader)->batch_count() == unit.batch_count);
+
+                std::uint64_t read_count = 0;
+                for (std::size_t i = 0; i < unit.batch_count; ++i) {
+                    auto const batch = (*unit_reader)->read_read_record_batch(i);
+                    REQUIRE_ARROW_STATUS_OK(batch);
+                    read_count += batch->num_rows();
+                }
+                CHECK(read_count == unit.read_count);
+                CHECK_ARROW_STATUS_NOT_OK((*unit_reader)->read_read_record_batch(unit.batch_count));
+            }
+        }
+    }
+
+    THEN("Units of rewritten files are refused")
+    {
+        auto const unit = (*shards)[0].units.front();
+        write_sized_dataset_file(paths[unit.file], file_read_lengths[unit.file], true);
+        CHECK(pod5::open_dataset_work_unit(unit).status().IsIOError());
+    }
+}
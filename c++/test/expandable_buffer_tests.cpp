@@ -0,0 +1,106 @@
+#include "pod5_format/expandable_buffer.h"
+
+#include "test_utils.h"
+
+#include <arrow/memory_pool.h>
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+SCENARIO("Expandable buffer growth")
+{
+    auto const pool = arrow::system_memory_pool();
+    pod5::ExpandableBuffer<std::uint8_t> buffer;
+    REQUIRE_ARROW_STATUS_OK(buffer.init_buffer(pool));
+
+    GIVEN("Values appended one at a time")
+    {
+        std::vector<std::int64_t> capacities;
+        for (std::uint8_t i = 0; i < 200; ++i) {
+            REQUIRE_ARROW_STATUS_OK(buffer.append(i));
+            auto const capacity = buffer.get_buffer()->capacity();
+            if (capacities.empty() || capacities.back() != capacity) {
+                capacities.push_back(capacity);
+            }
+        }
+
+        THEN("Capacity grows geometrically")
+        {
+            for (std::size_t i = 1; i < capacities.size(); ++i) {
+                CHECK(capacities[i] >= capacities[i - 1] * 2);
+            }
+            CHECK(buffer.size() == 200);
+            CHECK(buffer.get_data_span()[199] == 199);
+        }
+    }
+
+    GIVEN("A buffer shared with an array")
+    {
+        std::vector<std::uint8_t> const values{1, 2, 3};
+        REQUIRE_ARROW_STATUS_OK(buffer.append_array(gsl::make_span(values)));
+        auto const shared = buffer.get_buffer();
+
+        WHEN("More values are appended")
+        {
+            REQUIRE_ARROW_STATUS_OK(buffer.append(std::uint8_t(4)));
+
+            THEN("The shared data is left untouched")
+            {
+                CHECK(shared->size() == 3);
+                CHECK(buffer.get_buffer() != shared);
+                CHECK(buffer.get_data_span().size() == 4);
+                CHECK(buffer.get_data_span()[0] == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("Expandable buffer pool")
+{
+    auto const pool = arrow::system_memory_pool();
+    auto const buffer_pool = std::make_shared<pod5::ExpandableBufferPool>();
+    pod5::ExpandableBuffer<std::uint8_t> buffer;
+    REQUIRE_ARROW_STATUS_OK(buffer.init_buffer(pool, buffer_pool));
+    REQUIRE_ARROW_STATUS_OK(buffer.reserve(100'000));
+
+    // Hand the buffer out, as finishing a batch does:
+    auto handed_out = buffer.get_buffer();
+    auto const handed_out_data = handed_out->data();
+    REQUIRE_ARROW_STATUS_OK(buffer.clear());
+
+    GIVEN("The handed out buffer is still held")
+    {
+        WHEN("The builder is cleared again")
+        {
+            REQUIRE_ARROW_STATUS_OK(buffer.append(std::uint8_t(1)));
+            auto second = buffer.get_buffer();
+            REQUIRE_ARROW_STATUS_OK(buffer.clear());
+
+            THEN("It is not reused")
+            {
+                CHECK(buffer_pool->reused_buffers() == 0);
+                CHECK(buffer.get_buffer()->data() != handed_out_data);
+            }
+        }
+    }
+
+    GIVEN("The handed out buffer is released")
+    {
+        handed_out.reset();
+
+        WHEN("The builder is cleared again")
+        {
+            REQUIRE_ARROW_STATUS_OK(buffer.append(std::uint8_t(1)));
+            auto second = buffer.get_buffer();
+            REQUIRE_ARROW_STATUS_OK(buffer.clear());
+
+            THEN("It is reused, empty and with its capacity")
+            {
+                CHECK(buffer_pool->reused_buffers() == 1);
+                CHECK(buffer.get_buffer()->data() == handed_out_data);
+                CHECK(buffer.size() == 0);
+                CHECK(buffer.get_buffer()->capacity() >= 100'000);
+            }
+        }
+    }
+}
@@ -1,20 +1,53 @@
 #include "pod5_format/async_signal_loader.h"
+#include "pod5_format/direct_io_file.h"
 #include "pod5_format/file_reader.h"
+#include "pod5_format/file_updater.h"
+#include "pod5_format/file_verify.h"
 #include "pod5_format/file_writer.h"
+#include "pod5_format/internal/combined_file_utils.h"
+#include "pod5_format/internal/ipc_file_blocks.h"
+#include "pod5_format/io_manager.h"
+#include "pod5_format/read_id_index.h"
 #include "pod5_format/read_table_reader.h"
+#include "pod5_format/read_table_sort.h"
+#include "pod5_format/read_table_statistics.h"
+#include "pod5_format/schema_metadata.h"
 #include "pod5_format/signal_table_reader.h"
+#include "pod5_format/thread_pool.h"
 #include "pod5_format/uuid.h"
 #include "test_utils.h"
 #include "utils.h"
 
 #include <arrow/array/array_binary.h>
 #include <arrow/array/array_dict.h>
+#include <arrow/array/array_nested.h>
 #include <arrow/array/array_primitive.h>
+#include <arrow/buffer.h>
+#include <arrow/filesystem/localfs.h>
+#include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/message.h>
 #include <arrow/memory_pool.h>
+#include <arrow/util/future.h>
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
 #include <iostream>
 #include <numeric>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 void run_file_reader_writer_tests()
 {
@@ -90,7 +123,14 @@ void run_file_reader_writer_tests()
     // Open the file for reading:
     // Write a file:
     {
-        auto reader = pod5::open_file_reader(file, {});
+        // io_uring falls back to regular reads if unavailable, so every mode opens the file:
+        auto const read_mode = GENERATE(as<std::string>{}, "mmap", "readable_file", "io_uring");
+        CAPTURE(read_mode);
+        pod5::FileReaderOptions reader_options;
+        reader_options.set_force_disable_file_mapping(read_mode != "mmap");
+        reader_options.set_use_io_uring(read_mode == "io_uring");
+
+        auto reader = pod5::open_file_reader(file, reader_options);
         REQUIRE_ARROW_STATUS_OK(reader);
 
         REQUIRE((*reader)->num_read_record_batches() == 10);
@@ -134,20 +174,212 @@ void run_file_reader_writer_tests()
             CHECK(samples_array->Value(4) == 18'080);
         }
 
+        {
+            // Projected batches report columns outside the projection as missing:
+            auto projection = (*reader)->make_read_table_projection({"read_id", "num_samples"});
+            REQUIRE_ARROW_STATUS_OK(projection);
+            auto read_batch = (*reader)->read_read_record_batch(3, **projection);
+            REQUIRE_ARROW_STATUS_OK(read_batch);
+            CHECK(read_batch->batch()->num_columns() == 2);
+            CHECK(read_batch->read_id_column()->Value(0) == read_id_1);
+            CHECK(!read_batch->signal_column());
+            CHECK(!read_batch->get_signal_rows(0).ok());
+            auto columns = read_batch->columns();
+            REQUIRE_ARROW_STATUS_OK(columns);
+            CHECK(columns->num_samples->Value(0) == signal_1.size());
+            CHECK(!columns->calibration_scale);
+            CHECK(!columns->run_info);
+            CHECK(!read_batch->get_run_info(0).ok());
+            auto const view = read_batch->view();
+            CHECK(view.read_id[0] == read_id_1);
+            CHECK(view.num_samples[0] == signal_1.size());
+            CHECK(!view.signal);
+            CHECK(!view.calibration_scale);
+            CHECK(!view.run_info);
+
+            CHECK(!(*reader)->make_read_table_projection({"not_a_column"}).ok());
+        }
+
+        // Prefetching is a hint, and never changes what is read:
+        std::vector<std::uint64_t> const prefetch_rows{0, 1, 2, 7, 49};
+        CHECK_ARROW_STATUS_OK((*reader)->prefetch_signal_rows(gsl::make_span(prefetch_rows)));
+        std::vector<std::uint64_t> const invalid_prefetch_rows{50};
+        CHECK(!(*reader)->prefetch_signal_rows(gsl::make_span(invalid_prefetch_rows)).ok());
+        CHECK_ARROW_STATUS_OK((*reader)->load_signal_rows(gsl::make_span(prefetch_rows)));
+        CHECK(!(*reader)->load_signal_rows(gsl::make_span(invalid_prefetch_rows)).ok());
+
+        {
+            // Files opened through a filesystem coalesce their reads, with the same results:
+            auto const open_mode = GENERATE(as<std::string>{}, "filesystem", "uri", "coalesced");
+            CAPTURE(open_mode);
+            auto const absolute_path = std::filesystem::absolute(file).string();
+            auto coalesced_options = reader_options;
+            coalesced_options.set_read_coalescing(arrow::io::CacheOptions::Defaults());
+            auto fs_reader =
+                open_mode == "filesystem"
+                    ? pod5::open_file_reader(
+                        std::make_shared<arrow::fs::LocalFileSystem>(),
+                        absolute_path,
+                        reader_options)
+                    : open_mode == "uri"
+                          ? pod5::open_file_reader_from_uri(absolute_path, reader_options)
+                          : pod5::open_file_reader(file, coalesced_options);
+            REQUIRE_ARROW_STATUS_OK(fs_reader);
+            REQUIRE((*fs_reader)->num_signal_record_batches() == 10);
+            CHECK_ARROW_STATUS_OK(
+                (*fs_reader)->prefetch_signal_rows(gsl::make_span(prefetch_rows)));
+            CHECK_ARROW_STATUS_OK((*fs_reader)->load_signal_rows(gsl::make_span(prefetch_rows)));
+            for (std::size_t i = 0; i < 10; ++i) {
+                auto signal_batch = (*fs_reader)->read_signal_record_batch(i);
+                REQUIRE_ARROW_STATUS_OK(signal_batch);
+                CHECK(signal_batch->samples_column()->Value(4) == 18'080);
+            }
+            std::vector<std::int16_t> samples(signal_1.size());
+            std::vector<std::uint64_t> const read_rows{0, 1, 2, 3, 4};
+            CHECK_ARROW_STATUS_OK((*fs_reader)->extract_samples(
+                gsl::make_span(read_rows), gsl::make_span(samples)));
+            CHECK(samples == signal_1);
+
+            CHECK(!pod5::open_file_reader_from_uri(absolute_path + ".missing", reader_options)
+                       .ok());
+        }
+
+        {
+            // Lazily opened files read their tables on first use, with the same results:
+            auto lazy_options = reader_options;
+            lazy_options.set_lazy_open(true);
+            auto lazy_reader = pod5::open_file_reader(file, lazy_options);
+            REQUIRE_ARROW_STATUS_OK(lazy_reader);
+            CHECK(*(*lazy_reader)->read_count() == 10);
+            CHECK((*lazy_reader)->schema_metadata().file_identifier
+                  == (*reader)->schema_metadata().file_identifier);
+            CHECK((*lazy_reader)->num_signal_record_batches() == 10);
+            CHECK(**(*lazy_reader)->find_run_info(run_info_data.acquisition_id) == run_info_data);
+
+            std::vector<std::int16_t> samples(signal_1.size());
+            std::vector<std::uint64_t> const read_rows{5, 6, 7, 8, 9};
+            CHECK_ARROW_STATUS_OK((*lazy_reader)->extract_samples(
+                gsl::make_span(read_rows), gsl::make_span(samples)));
+            CHECK(samples == signal_1);
+        }
+
+        {
+            // Async reads complete on the pool, with the same results as synchronous reads:
+            auto thread_pool = pod5::make_thread_pool(2);
+            std::vector<arrow::Future<pod5::ReadTableRecordBatch>> read_batches;
+            std::vector<arrow::Future<pod5::SignalTableRecordBatch>> signal_batches;
+            for (std::size_t i = 0; i < 10; ++i) {
+                read_batches.push_back((*reader)->read_read_record_batch_async(i, *thread_pool));
+                signal_batches.push_back(
+                    (*reader)->read_signal_record_batch_async(i, *thread_pool));
+            }
+            for (std::size_t i = 0; i < 10; ++i) {
+                auto const & read_batch = read_batches[i].result();
+                REQUIRE_ARROW_STATUS_OK(read_batch);
+                CHECK(read_batch->read_id_column()->Value(0) == read_id_1);
+                auto const & signal_batch = signal_batches[i].result();
+                REQUIRE_ARROW_STATUS_OK(signal_batch);
+                CHECK(signal_batch->samples_column()->Value(4) == 18'080);
+            }
+            CHECK(!(*reader)->read_signal_record_batch_async(10, *thread_pool).result().ok());
+
+            thread_pool->stop_and_drain();
+            CHECK(!(*reader)->read_read_record_batch_async(0, *thread_pool).result().ok());
+        }
+
+        {
+            // A byte budget holds back loading until pending batches are released:
+            std::uint64_t const batch_bytes = signal_1.size() * sizeof(std::int16_t);
+            pod5::AsyncSignalLoader budget_loader(
+                *reader,
+                pod5::AsyncSignalLoader::SamplesMode::Samples,
+                {},
+                {},
+                2,
+                10,
+                pod5::AsyncSignalLoader::DEFAULT_PREFETCH_DISTANCE,
+                batch_bytes);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            // At most a pending batch, and a batch per worker in flight:
+            CHECK(budget_loader.pending_bytes() <= 3 * batch_bytes);
+
+            for (std::size_t i = 0; i < 10; ++i) {
+                CAPTURE(i);
+                auto batch = budget_loader.release_next_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                REQUIRE(*batch);
+                CHECK((*batch)->batch_index() == i);
+                auto const samples = (*batch)->samples(0);
+                CHECK(std::vector<std::int16_t>(samples.begin(), samples.end()) == signal_1);
+            }
+            CHECK(budget_loader.pending_bytes() == 0);
+        }
+
+        {
+            // Batches can be taken in the order they finish loading, each exactly once:
+            pod5::AsyncSignalLoader completion_loader(
+                *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 4);
+            std::vector<std::uint32_t> batch_indices;
+            for (std::size_t i = 0; i < 10; ++i) {
+                auto batch = completion_loader.release_next_completed_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                REQUIRE(*batch);
+                batch_indices.push_back((*batch)->batch_index());
+                auto const samples = (*batch)->samples(0);
+                CHECK(std::vector<std::int16_t>(samples.begin(), samples.end()) == signal_1);
+            }
+            std::sort(batch_indices.begin(), batch_indices.end());
+            std::vector<std::uint32_t> expected_indices(10);
+            std::iota(expected_indices.begin(), expected_indices.end(), 0);
+            CHECK(batch_indices == expected_indices);
+
+            auto const end = completion_loader.release_next_completed_batch();
+            REQUIRE_ARROW_STATUS_OK(end);
+            CHECK(!*end);
+            CHECK(completion_loader.is_finished());
+        }
+
         auto const samples_mode = GENERATE(
             pod5::AsyncSignalLoader::SamplesMode::NoSamples,
             pod5::AsyncSignalLoader::SamplesMode::Samples);
+        auto const prefetch_distance = GENERATE(std::size_t(0), std::size_t(2), std::size_t(20));
+        CAPTURE(prefetch_distance);
 
-        pod5::AsyncSignalLoader async_no_samples_loader(
-            *reader,
-            samples_mode,
-            {},  // Read all the batches
-            {}   // No specific rows within batches)
-        );
+        // Loaders either run on their own threads, or as tasks on a pool shared between loaders:
+        auto const use_thread_pool = GENERATE(false, true);
+        CAPTURE(use_thread_pool);
+        auto thread_pool = pod5::make_thread_pool(2);
+        std::unique_ptr<pod5::AsyncSignalLoader> async_no_samples_loader;
+        if (use_thread_pool) {
+            // A second loader shares the pool, so they take turns:
+            pod5::AsyncSignalLoader other_loader(
+                *reader, samples_mode, {}, {}, thread_pool, 2, 1, prefetch_distance);
+            async_no_samples_loader = std::make_unique<pod5::AsyncSignalLoader>(
+                *reader,
+                samples_mode,
+                gsl::span<std::uint32_t const>{},
+                gsl::span<std::uint32_t const>{},
+                thread_pool,
+                4,
+                10,
+                prefetch_distance);
+            auto const other_batch = other_loader.release_next_batch();
+            REQUIRE_ARROW_STATUS_OK(other_batch);
+            CHECK((*other_batch)->batch_index() == 0);
+        } else {
+            async_no_samples_loader = std::make_unique<pod5::AsyncSignalLoader>(
+                *reader,
+                samples_mode,
+                gsl::span<std::uint32_t const>{},  // Read all the batches
+                gsl::span<std::uint32_t const>{},  // No specific rows within batches
+                std::thread::hardware_concurrency(),
+                10,
+                prefetch_distance);
+        }
 
         for (std::size_t i = 0; i < 10; ++i) {
             CAPTURE(i);
-            auto first_batch_res = async_no_samples_loader.release_next_batch();
+            auto first_batch_res = async_no_samples_loader->release_next_batch();
             REQUIRE_ARROW_STATUS_OK(first_batch_res);
             auto first_batch = std::move(*first_batch_res);
             CHECK(first_batch->batch_index() == i);
@@ -155,11 +387,14 @@ void run_file_reader_writer_tests()
             CHECK(first_batch->sample_count().size() == 1);
             CHECK(first_batch->sample_count()[0] == signal_1.size());
 
-            CHECK(first_batch->samples().size() == 1);
+            CHECK(first_batch->sample_offsets() == std::vector<std::uint64_t>{0, signal_1.size()});
+            auto const samples = first_batch->samples(0);
             if (samples_mode == pod5::AsyncSignalLoader::SamplesMode::Samples) {
-                CHECK(first_batch->samples()[0] == signal_1);
+                CHECK(std::vector<std::int16_t>(samples.begin(), samples.end()) == signal_1);
+                CHECK(first_batch->all_samples().size() == signal_1.size());
             } else {
-                CHECK(first_batch->samples()[0].size() == 0);
+                CHECK(samples.empty());
+                CHECK(first_batch->all_samples().empty());
             }
         }
     }
@@ -167,178 +402,2531 @@ void run_file_reader_writer_tests()
 
 SCENARIO("File Reader Writer Tests") { run_file_reader_writer_tests(); }
 
-SCENARIO("Opening older files")
+TEST_CASE("Cached batch signal data reuses released sample buffers")
+{
+    auto const buffer_pool = std::make_shared<pod5::SampleBufferPool>(1);
+    std::int16_t const * first_buffer = nullptr;
+    {
+        pod5::CachedBatchSignalData data(0, {3, 0, 2}, buffer_pool);
+        CHECK(data.sample_offsets() == std::vector<std::uint64_t>{0, 3, 3, 5});
+        CHECK(data.all_samples().size() == 5);
+        CHECK(data.samples(1).empty());
+        auto const row_samples = data.mutable_samples(2);
+        REQUIRE(row_samples.size() == 2);
+        row_samples[0] = 7;
+        CHECK(data.all_samples()[3] == 7);
+        first_buffer = data.all_samples().data();
+    }
+    CHECK(buffer_pool->buffer_count() == 1);
+
+    {
+        // A smaller batch reuses the released buffer:
+        pod5::CachedBatchSignalData data(1, {4}, buffer_pool);
+        CHECK(data.all_samples().data() == first_buffer);
+        CHECK(buffer_pool->buffer_count() == 0);
+
+        // Data without a pool stores no samples:
+        pod5::CachedBatchSignalData no_samples(2, {4}, nullptr);
+        CHECK(no_samples.sample_count() == std::vector<std::uint64_t>{4});
+        CHECK(no_samples.all_samples().empty());
+        CHECK(no_samples.samples(0).empty());
+    }
+
+    // The reused buffer is returned again:
+    CHECK(buffer_pool->buffer_count() == 1);
+}
+
+TEST_CASE("Async signal loading of reads with scattered signal")
 {
+    static constexpr char const * file = "./scattered_signal.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
     (void)pod5::register_extension_types();
     auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
 
-    auto uuid_from_string = [](char const * val) -> pod5::Uuid {
-        auto result = pod5::Uuid::from_string(val);
-        REQUIRE(result);
-        return *result;
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 60;
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(10 + i, std::int16_t(i));
     };
 
-    struct ReadData {
-        pod5::Uuid read_id;
-        std::uint32_t read_number;
-        float calibration_offset;
-        float calibration_scale;
-        std::string end_reason;
-        std::string pore_type;
-        std::string run_info_id;
-    };
+    // Write all the signal, then the reads in reverse, as a merged file might be:
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(4);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
 
-    std::vector<ReadData> test_read_data{
-        {{uuid_from_string("0000173c-bf67-44e7-9a9c-1ad0bc728e74")},
-         1093,
-         21.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("002fde30-9e23-4125-9eae-d112c18a81a7")},
-         75,
-         4.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("006d1319-2877-4b34-85df-34de7250a47b")},
-         1053,
-         6.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("00728efb-2120-4224-87d8-580fbb0bd4b2")},
-         657,
-         2.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("007cc97e-6de2-4ff6-a0fd-1c1eca816425")},
-         1625,
-         23.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("008468c3-e477-46c4-a6e2-7d021a4ebf0b")},
-         411,
-         4.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("008ed3dc-86c2-452f-b107-6877a473d177")},
-         513,
-         5.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("00919556-e519-4960-8aa5-c2dfa020980c")},
-         56,
-         2.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("00925f34-6baf-47fc-b40c-22591e27fb5c")},
-         930,
-         37.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-        {{uuid_from_string("009dc9bd-c5f4-487b-ba4c-b9ce7e3a711e")},
-         195,
-         14.0f,
-         0.1755f,
-         "unknown",
-         "not_set",
-         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        std::vector<pod5::Uuid> read_ids;
+        std::vector<std::vector<std::uint64_t>> signal_rows;
+        for (std::size_t i = 0; i < read_count; ++i) {
+            read_ids.push_back(uuid_gen());
+            auto const signal = signal_for_read(i);
+            auto rows = (*writer)->add_signal(read_ids.back(), gsl::make_span(signal));
+            REQUIRE_ARROW_STATUS_OK(rows);
+            signal_rows.push_back(std::move(*rows));
+        }
+        for (std::size_t i = read_count; i-- > 0;) {
+            pod5::ReadData const read_data{
+                read_ids[i],
+                std::uint32_t(i),
+                0,
+                1,
+                1,
+                *pore_type,
+                0.0f,
+                1.0f,
+                0.0f,
+                *end_reason,
+                false,
+                *run_info,
+                0,
+                1.0f,
+                0.0f,
+                1.0f,
+                0.0f,
+                0,
+                0.0f};
+            REQUIRE_ARROW_STATUS_OK((*writer)->add_complete_read(
+                read_data, gsl::make_span(signal_rows[i]), signal_for_read(i).size()));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    // Reads are returned in read table order however they are loaded:
+    auto const row_order = GENERATE(
+        pod5::AsyncSignalLoader::RowOrder::ReadTable,
+        pod5::AsyncSignalLoader::RowOrder::SignalTable);
+    auto const adaptive_worker_count = GENERATE(false, true);
+    pod5::AsyncSignalLoader loader(
+        *reader,
+        pod5::AsyncSignalLoader::SamplesMode::Samples,
+        {},
+        {},
+        4,
+        10,
+        pod5::AsyncSignalLoader::DEFAULT_PREFETCH_DISTANCE,
+        pod5::AsyncSignalLoader::NO_PENDING_BYTES_LIMIT,
+        row_order,
+        adaptive_worker_count);
+    // An adaptive worker count starts halfway to the most workers:
+    CHECK(loader.worker_count() == (adaptive_worker_count ? 3 : 4));
+
+    std::size_t read_table_row = 0;
+    while (true) {
+        auto batch = loader.release_next_batch();
+        REQUIRE_ARROW_STATUS_OK(batch);
+        if (!*batch) {
+            break;
+        }
+        for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+            auto const expected_signal = signal_for_read(read_count - 1 - read_table_row);
+            auto const samples = (*batch)->samples(row);
+            CHECK((*batch)->sample_count()[row] == expected_signal.size());
+            CHECK(std::vector<std::int16_t>(samples.begin(), samples.end()) == expected_signal);
+            read_table_row += 1;
+        }
+    }
+    CHECK(read_table_row == read_count);
+}
+
+TEST_CASE("Estimating the signal IO of a traversal plan")
+{
+    static constexpr char const * file = "./traversal_cost.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 60;
+    std::uint64_t total_samples = 0;
+
+    // Write the reads in reverse to their signal, each read's signal in one row:
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(4);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::vector<pod5::Uuid> read_ids;
+        std::vector<std::vector<std::uint64_t>> signal_rows;
+        for (std::size_t i = 0; i < read_count; ++i) {
+            read_ids.push_back(uuid_gen());
+            std::vector<std::int16_t> const signal(10 + i, std::int16_t(i));
+            total_samples += signal.size();
+            auto rows = (*writer)->add_signal(read_ids.back(), gsl::make_span(signal));
+            REQUIRE_ARROW_STATUS_OK(rows);
+            signal_rows.push_back(std::move(*rows));
+        }
+        for (std::size_t i = read_count; i-- > 0;) {
+            pod5::ReadData const read_data{
+                read_ids[i],
+                std::uint32_t(i),
+                0,
+                1,
+                1,
+                *pore_type,
+                0.0f,
+                1.0f,
+                0.0f,
+                *end_reason,
+                false,
+                *run_info,
+                0,
+                1.0f,
+                0.0f,
+                1.0f,
+                0.0f,
+                0,
+                0.0f};
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal_rows[i]), 10 + i));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE((*reader)->num_read_record_batches() == 1);
+    REQUIRE((*reader)->num_signal_record_batches() == read_count / 4);
+
+    std::uint64_t all_batch_bytes = 0;
+    for (auto const & location : (*reader)->signal_table_batch_locations()) {
+        all_batch_bytes += location.length();
+    }
+    CHECK(all_batch_bytes > 0);
+
+    // Visiting in file order walks the signal table backwards, seeking for every batch:
+    auto const file_order = (*reader)->estimate_traversal_cost({}, {});
+    REQUIRE_ARROW_STATUS_OK(file_order);
+    CHECK(file_order->read_count == read_count);
+    CHECK(file_order->signal_row_count == read_count);
+    CHECK(file_order->signal_batch_count == read_count / 4);
+    CHECK(file_order->signal_batch_bytes == all_batch_bytes);
+    CHECK(file_order->sample_count == total_samples);
+    CHECK(file_order->estimated_seeks == read_count / 4);
+
+    // Visiting in signal order reads the batches in one pass:
+    std::vector<std::uint32_t> const batch_counts{std::uint32_t(read_count)};
+    std::vector<std::uint32_t> signal_order;
+    for (std::size_t i = read_count; i-- > 0;) {
+        signal_order.push_back(std::uint32_t(i));
+    }
+    auto const in_signal_order = (*reader)->estimate_traversal_cost(batch_counts, signal_order);
+    REQUIRE_ARROW_STATUS_OK(in_signal_order);
+    CHECK(in_signal_order->signal_batch_count == read_count / 4);
+    CHECK(in_signal_order->estimated_seeks == 1);
+
+    // A subset only counts the batches it touches:
+    std::vector<std::uint32_t> const subset_rows{59, 0};
+    auto const subset = (*reader)->estimate_traversal_cost(
+        std::vector<std::uint32_t>{2}, subset_rows);
+    REQUIRE_ARROW_STATUS_OK(subset);
+    CHECK(subset->read_count == 2);
+    CHECK(subset->signal_batch_count == 2);
+    CHECK(subset->signal_batch_bytes < all_batch_bytes);
+    CHECK(subset->sample_count == 10 + 69);
+    CHECK(subset->estimated_seeks == 2);
+
+    std::vector<std::uint32_t> const wrong_batch_counts{1, 1};
+    CHECK(!(*reader)->estimate_traversal_cost(wrong_batch_counts, subset_rows).ok());
+}
+
+TEST_CASE("Loading signal with a signal access plan")
+{
+    static constexpr char const * file = "./signal_access_plan.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 60;
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(10 + i, std::int16_t(i));
     };
 
-    auto repo_root =
-        ::arrow::internal::PlatformFilename::FromString(__FILE__)->Parent().Parent().Parent();
-    auto path = GENERATE_COPY(
-        *repo_root.Join("test_data/multi_fast5_zip_v0.pod5"),
-        *repo_root.Join("test_data/multi_fast5_zip_v1.pod5"),
-        *repo_root.Join("test_data/multi_fast5_zip_v2.pod5"),
-        *repo_root.Join("test_data/multi_fast5_zip_v3.pod5"));
-    auto reader = pod5::open_file_reader(path.ToString(), {});
-    CHECK_ARROW_STATUS_OK(reader);
+    // Write the reads in reverse to their signal, so the loader reorders them:
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(4);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
 
-    auto metadata = (*reader)->schema_metadata();
-    CHECK(metadata.writing_software == "Python API");
+        std::vector<pod5::Uuid> read_ids;
+        std::vector<std::vector<std::uint64_t>> signal_rows;
+        for (std::size_t i = 0; i < read_count; ++i) {
+            read_ids.push_back(uuid_gen());
+            auto const signal = signal_for_read(i);
+            auto rows = (*writer)->add_signal(read_ids.back(), gsl::make_span(signal));
+            REQUIRE_ARROW_STATUS_OK(rows);
+            signal_rows.push_back(std::move(*rows));
+        }
+        for (std::size_t i = read_count; i-- > 0;) {
+            pod5::ReadData const read_data{
+                read_ids[i],
+                std::uint32_t(i),
+                0,
+                1,
+                1,
+                *pore_type,
+                0.0f,
+                1.0f,
+                0.0f,
+                *end_reason,
+                false,
+                *run_info,
+                0,
+                1.0f,
+                0.0f,
+                1.0f,
+                0.0f,
+                0,
+                0.0f};
+            REQUIRE_ARROW_STATUS_OK((*writer)->add_complete_read(
+                read_data, gsl::make_span(signal_rows[i]), signal_for_read(i).size()));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
 
-    std::size_t abs_row = 0;
+    // A cache holding every batch, and no signal row index, so sample counts are read from
+    // the signal batches:
+    pod5::FileReaderOptions reader_options;
+    reader_options.set_max_cached_signal_table_batches(0);
+    auto reader = pod5::open_file_reader(file, reader_options);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE(!(*reader)->signal_row_index());
+    auto const signal_batch_count = (*reader)->num_signal_record_batches();
+    REQUIRE(signal_batch_count == read_count / 4);
 
-    for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
-        auto batch = (*reader)->read_read_record_batch(i);
+    // Counting the reads' samples doesn't move the plan on, so each batch is decoded once, to
+    // count the samples, and kept until the reads' signal is loaded:
+    REQUIRE_ARROW_STATUS_OK((*reader)->set_signal_access_plan({}, {}, true));
+    pod5::AsyncSignalLoader loader(
+        *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 1, 10);
 
-        auto columns = batch->columns();
-        REQUIRE_ARROW_STATUS_OK(columns);
+    std::size_t read_table_row = 0;
+    while (true) {
+        auto batch = loader.release_next_batch();
+        REQUIRE_ARROW_STATUS_OK(batch);
+        if (!*batch) {
+            break;
+        }
+        for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+            auto const expected_signal = signal_for_read(read_count - 1 - read_table_row);
+            auto const samples = (*batch)->samples(row);
+            CHECK(std::vector<std::int16_t>(samples.begin(), samples.end()) == expected_signal);
+            read_table_row += 1;
+        }
+    }
+    CHECK(read_table_row == read_count);
+    CHECK((*reader)->statistics().signal_table_batches_decoded == signal_batch_count);
+    REQUIRE_ARROW_STATUS_OK((*reader)->clear_signal_access_plan());
+}
 
-        for (std::size_t row = 0; row < batch->num_rows(); ++row) {
-            CAPTURE(abs_row);
-            auto read_data = test_read_data[row];
-            CHECK(columns->read_id->Value(row) == read_data.read_id);
-            CHECK(columns->read_number->Value(row) == read_data.read_number);
-            CHECK(columns->calibration_offset->Value(row) == read_data.calibration_offset);
-            CHECK(columns->calibration_scale->Value(row) == Approx(read_data.calibration_scale));
-            auto end_reason = *batch->get_end_reason(columns->end_reason->GetValueIndex(row));
-            CHECK(end_reason.first == pod5::end_reason_from_string(read_data.end_reason));
-            CHECK(end_reason.second == read_data.end_reason);
-            auto pore_type = batch->get_pore_type(columns->pore_type->GetValueIndex(row));
-            CHECK(*pore_type == read_data.pore_type);
-            auto run_info_id = batch->get_run_info(columns->run_info->GetValueIndex(row));
-            CHECK(*run_info_id == read_data.run_info_id);
+TEST_CASE("Async signal loading splits long reads between jobs")
+{
+    static constexpr char const * file = "./long_read_signal.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
 
-            ++abs_row;
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 30;
+    // Every tenth read is longer than a job, so is loaded in parts by several workers:
+    auto signal_for_read = [](std::size_t i) {
+        std::size_t const sample_count =
+            i % 10 == 0 ? pod5::AsyncSignalLoader::MINIMUM_JOB_SAMPLES * 3 + 7 : 1000 + i;
+        std::vector<std::int16_t> signal(sample_count);
+        for (std::size_t sample = 0; sample < signal.size(); ++sample) {
+            signal[sample] = std::int16_t((sample + i) % 1000);
+        }
+        return signal;
+    };
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_max_signal_chunk_size(100'000);
+        options.set_read_table_batch_size(15);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = std::uint32_t(i);
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
         }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
     }
-    CHECK(abs_row == test_read_data.size());
 
-    auto run_info = (*reader)->find_run_info(test_read_data[0].run_info_id);
-    REQUIRE_ARROW_STATUS_OK(run_info);
-    CHECK((*run_info)->acquisition_id == test_read_data[0].run_info_id);
-    CHECK((*run_info)->adc_min == -4096);
-    CHECK((*run_info)->adc_max == 4095);
-    CHECK((*run_info)->protocol_run_id == "df049455-3552-438c-8176-d4a5b1dd9fc5");
-    CHECK((*run_info)->software == "python-pod5-converter");
-    CHECK(
-        (*run_info)->tracking_id
-        == pod5::RunInfoData::MapType{
-            {"asic_id", "131070"},
-            {"asic_id_eeprom", "0"},
-            {"asic_temp", "35.043102"},
-            {"asic_version", "IA02C"},
-            {"auto_update", "0"},
-            {"auto_update_source", "https://mirror.oxfordnanoportal.com/software/MinKNOW/"},
-            {"bream_is_standard", "0"},
-            {"device_id", "MS00000"},
-            {"device_type", "minion"},
-            {"distribution_status", "modified"},
-            {"distribution_version", "unknown"},
-            {"exp_script_name", "c449127e3461a521e0865fe6a88716f6f6b0b30c"},
-            {"exp_script_purpose", "sequencing_run"},
-            {"exp_start_time", "2019-05-13T11:11:43Z"},
-            {"flow_cell_id", ""},
-            {"guppy_version", "3.0.3+7e7b7d0"},
-            {"heatsink_temp", "35.000000"},
-            {"hostname", "happy_fish"},
-            {"installation_type", "prod"},
-            {"local_firmware_file", "1"},
-            {"operating_system", "ubuntu 16.04"},
-            {"protocol_group_id", "TEST_EXPERIMENT"},
-            {"protocol_run_id", "df049455-3552-438c-8176-d4a5b1dd9fc5"},
-            {"protocols_version", "4.0.6"},
-            {"run_id", "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
-            {"sample_id", "TEST_SAMPLE"},
-            {"usb_config", "MinION_fx3_1.1.1_ONT#MinION_fpga_1.1.0#ctrl#Auto"},
-            {"version", "3.4.0-rc3"},
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    pod5::AsyncSignalLoader loader(
+        *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 4);
+
+    std::size_t read_index = 0;
+    while (true) {
+        auto batch = loader.release_next_batch();
+        REQUIRE_ARROW_STATUS_OK(batch);
+        if (!*batch) {
+            break;
+        }
+        for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+            auto const expected_signal = signal_for_read(read_index);
+            auto const samples = (*batch)->samples(row);
+            CHECK(std::vector<std::int16_t>(samples.begin(), samples.end()) == expected_signal);
+            read_index += 1;
+        }
+    }
+    CHECK(read_index == read_count);
+}
+
+TEST_CASE("Copying signal batches between files as they are stored")
+{
+    static constexpr char const * source_file = "./raw_batches_source.pod5";
+    static constexpr char const * dest_file = "./raw_batches_dest.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(source_file));
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(dest_file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 10;
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(10 + i, std::int16_t(i));
+    };
+
+    pod5::FileWriterOptions options;
+    options.set_signal_table_batch_size(4);
+
+    std::vector<pod5::Uuid> read_ids;
+    {
+        auto writer = pod5::create_file_writer(source_file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        for (std::size_t i = 0; i < read_count; ++i) {
+            read_ids.push_back(uuid_gen());
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK((*writer)->add_signal(read_ids.back(), gsl::make_span(signal)));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto source = pod5::open_file_reader(source_file);
+    REQUIRE_ARROW_STATUS_OK(source);
+    REQUIRE((*source)->num_signal_record_batches() == 3);
+    CHECK(*(*source)->signal_table_batch_size() == 4);
+
+    // The full batches are copied as stored, the partial last batch row by row:
+    {
+        auto writer = pod5::create_file_writer(dest_file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::vector<std::uint64_t> signal_rows;
+        for (std::size_t batch = 0; batch < 2; ++batch) {
+            auto message = (*source)->read_signal_record_batch_message(batch);
+            REQUIRE_ARROW_STATUS_OK(message);
+            CHECK_FALSE((*writer)->add_raw_signal_batch(**message, 3).ok());
+            auto first_row = (*writer)->add_raw_signal_batch(**message, 4);
+            REQUIRE_ARROW_STATUS_OK(first_row);
+            CHECK(*first_row == batch * 4);
+            for (std::uint64_t row = 0; row < 4; ++row) {
+                signal_rows.push_back(*first_row + row);
+            }
+        }
+        for (std::size_t i = signal_rows.size(); i < read_count; ++i) {
+            auto const signal = signal_for_read(i);
+            auto rows = (*writer)->add_signal(read_ids[i], gsl::make_span(signal));
+            REQUIRE_ARROW_STATUS_OK(rows);
+            REQUIRE(rows->size() == 1);
+            signal_rows.push_back(rows->front());
+        }
+
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData const read_data{
+                read_ids[i],
+                std::uint32_t(i),
+                0,
+                1,
+                1,
+                *pore_type,
+                0.0f,
+                1.0f,
+                0.0f,
+                *end_reason,
+                false,
+                *run_info,
+                0,
+                1.0f,
+                0.0f,
+                1.0f,
+                0.0f,
+                0,
+                0.0f};
+            REQUIRE_ARROW_STATUS_OK((*writer)->add_complete_read(
+                read_data, gsl::make_span(&signal_rows[i], 1), signal_for_read(i).size()));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto dest = pod5::open_file_reader(dest_file);
+    REQUIRE_ARROW_STATUS_OK(dest);
+    CHECK((*dest)->num_signal_record_batches() == 3);
+    auto read_batch = (*dest)->read_read_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(read_batch);
+    REQUIRE(read_batch->num_rows() == std::int64_t(read_count));
+    auto const signal_column = read_batch->signal_column();
+    for (std::size_t i = 0; i < read_count; ++i) {
+        auto const rows =
+            std::static_pointer_cast<arrow::UInt64Array>(signal_column->value_slice(i));
+        auto const rows_span = gsl::make_span(rows->raw_values(), rows->length());
+        auto const expected_signal = signal_for_read(i);
+        std::vector<std::int16_t> samples(expected_signal.size());
+        REQUIRE_ARROW_STATUS_OK((*dest)->extract_samples(rows_span, gsl::make_span(samples)));
+        CHECK(samples == expected_signal);
+    }
+}
+
+TEST_CASE("Compressing signal on a thread pool while writing")
+{
+    static constexpr char const * file = "./pooled_compression.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const max_compression_jobs = GENERATE(std::size_t(0), std::size_t(1), std::size_t(4));
+    // Whether reads hand ownership of their signal to the writer:
+    auto const owned_signal = GENERATE(false, true);
+    CAPTURE(max_compression_jobs, owned_signal);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 40;
+    // Reads span several chunks, so chunks of many reads are compressing at once:
+    auto signal_for_read = [](std::size_t i) {
+        std::vector<std::int16_t> signal(50 + i * 37);
+        std::iota(signal.begin(), signal.end(), std::int16_t(i));
+        return signal;
+    };
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_max_signal_chunk_size(100);
+        options.set_signal_table_batch_size(7);
+        options.set_max_compression_jobs(max_compression_jobs);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData const read_data{
+                uuid_gen(),
+                std::uint32_t(i),
+                0,
+                1,
+                1,
+                *pore_type,
+                0.0f,
+                1.0f,
+                0.0f,
+                *end_reason,
+                false,
+                *run_info,
+                0,
+                1.0f,
+                0.0f,
+                1.0f,
+                0.0f,
+                0,
+                0.0f};
+            auto signal = signal_for_read(i);
+            if (!owned_signal) {
+                REQUIRE_ARROW_STATUS_OK(
+                    (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+            } else if (i % 2 == 0) {
+                REQUIRE_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, std::move(signal)));
+            } else {
+                auto buffer = arrow::AllocateBuffer(signal.size() * sizeof(std::int16_t));
+                REQUIRE_ARROW_STATUS_OK(buffer);
+                std::memcpy((*buffer)->mutable_data(), signal.data(), (*buffer)->size());
+                REQUIRE_ARROW_STATUS_OK((*writer)->add_complete_read(
+                    read_data, std::shared_ptr<arrow::Buffer>(std::move(*buffer))));
+            }
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    pod5::AsyncSignalLoader loader(
+        *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 2);
+    std::size_t read_index = 0;
+    while (true) {
+        auto batch = loader.release_next_batch();
+        REQUIRE_ARROW_STATUS_OK(batch);
+        if (!*batch) {
+            break;
+        }
+        for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+            auto const samples = (*batch)->samples(row);
+            CHECK(
+                std::vector<std::int16_t>(samples.begin(), samples.end())
+                == signal_for_read(read_index));
+            read_index += 1;
+        }
+    }
+    CHECK(read_index == read_count);
+}
+
+TEST_CASE("Writing reads from several producer threads")
+{
+    static constexpr char const * file = "./producer_threads.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const signal_type =
+        GENERATE(pod5::SignalType::VbzSignal, pod5::SignalType::UncompressedSignal);
+    CAPTURE(signal_type);
+
+    std::size_t const thread_count = 4;
+    std::size_t const reads_per_thread = 30;
+    // Reads are numbered by the thread adding them, and their signal found from the number:
+    auto signal_for_read = [](std::uint32_t read_number) {
+        std::vector<std::int16_t> signal(20 + (read_number % 97) * 3);
+        std::iota(signal.begin(), signal.end(), std::int16_t(read_number));
+        return signal;
+    };
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_type(signal_type);
+        options.set_max_signal_chunk_size(64);
+        options.set_signal_table_batch_size(9);
+        options.set_read_table_batch_size(11);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::vector<pod5::Uuid> read_ids;
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        for (std::size_t i = 0; i < thread_count * reads_per_thread; ++i) {
+            read_ids.push_back(uuid_gen());
+        }
+
+        std::vector<pod5::Status> thread_status(thread_count);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&, t] {
+                auto producer = (*writer)->create_producer(7);
+                for (std::size_t i = 0; i < reads_per_thread && thread_status[t].ok(); ++i) {
+                    auto const read_number = std::uint32_t(t * reads_per_thread + i);
+                    pod5::ReadData const read_data{
+                        read_ids[read_number],
+                        read_number,
+                        0,
+                        1,
+                        1,
+                        *pore_type,
+                        0.0f,
+                        1.0f,
+                        0.0f,
+                        *end_reason,
+                        false,
+                        *run_info,
+                        0,
+                        1.0f,
+                        0.0f,
+                        1.0f,
+                        0.0f,
+                        0,
+                        0.0f};
+                    auto const signal = signal_for_read(read_number);
+                    thread_status[t] =
+                        producer->add_complete_read(read_data, gsl::make_span(signal));
+                }
+                // Flushed either way, as producers don't flush when destroyed:
+                auto const flushed = producer->flush();
+                if (thread_status[t].ok()) {
+                    thread_status[t] = flushed;
+                }
+            });
+        }
+        for (auto & thread : threads) {
+            thread.join();
+        }
+        for (auto const & status : thread_status) {
+            CHECK_ARROW_STATUS_OK(status);
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    pod5::AsyncSignalLoader loader(
+        *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 2);
+    std::vector<bool> found_reads(thread_count * reads_per_thread, false);
+    while (true) {
+        auto batch = loader.release_next_batch();
+        REQUIRE_ARROW_STATUS_OK(batch);
+        if (!*batch) {
+            break;
+        }
+        auto read_batch = (*reader)->read_read_record_batch((*batch)->batch_index());
+        REQUIRE_ARROW_STATUS_OK(read_batch);
+        auto columns = read_batch->columns();
+        REQUIRE_ARROW_STATUS_OK(columns);
+        for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+            auto const read_number = columns->read_number->Value(row);
+            REQUIRE(read_number < found_reads.size());
+            CHECK(!found_reads[read_number]);
+            found_reads[read_number] = true;
+
+            auto const samples = (*batch)->samples(row);
+            CHECK(
+                std::vector<std::int16_t>(samples.begin(), samples.end())
+                == signal_for_read(read_number));
+        }
+    }
+    CHECK(std::all_of(found_reads.begin(), found_reads.end(), [](bool found) { return found; }));
+}
+
+TEST_CASE("Sizing table batches by bytes")
+{
+    static constexpr char const * file = "./batch_bytes.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 200;
+    std::size_t const max_batch_rows = 10'000;
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(300, std::int16_t(i));
+    };
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_type(pod5::SignalType::UncompressedSignal);
+        options.set_signal_table_batch_size(max_batch_rows);
+        options.set_signal_table_batch_bytes(8 * 1024);
+        options.set_read_table_batch_size(max_batch_rows);
+        options.set_read_table_batch_bytes(4 * 1024);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData const read_data{
+                uuid_gen(),
+                std::uint32_t(i),
+                0,
+                1,
+                1,
+                *pore_type,
+                0.0f,
+                1.0f,
+                0.0f,
+                *end_reason,
+                false,
+                *run_info,
+                0,
+                1.0f,
+                0.0f,
+                1.0f,
+                0.0f,
+                0,
+                0.0f};
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        // The first signal batch reached the byte target well before the row limit:
+        CHECK((*writer)->signal_table_batch_size() < 20);
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    // Every batch but the last holds the row count of the first:
+    auto const signal_batch_count = (*reader)->num_signal_record_batches();
+    REQUIRE(signal_batch_count > 1);
+    auto const signal_batch_rows = (*reader)->read_signal_record_batch(0)->num_rows();
+    std::size_t signal_rows = 0;
+    for (std::size_t i = 0; i < signal_batch_count; ++i) {
+        auto const rows = (*reader)->read_signal_record_batch(i)->num_rows();
+        CHECK(
+            (i + 1 == signal_batch_count ? rows <= signal_batch_rows
+                                         : rows == signal_batch_rows));
+        CHECK(*(*reader)->signal_batch_first_row(i) == signal_rows);
+        signal_rows += rows;
+    }
+    CHECK(signal_rows == read_count);
+
+    auto const read_batch_count = (*reader)->num_read_record_batches();
+    REQUIRE(read_batch_count > 1);
+    auto const read_batch_rows = (*reader)->read_read_record_batch(0)->num_rows();
+    CHECK(read_batch_rows < max_batch_rows);
+    for (std::size_t i = 0; i < read_batch_count; ++i) {
+        auto const rows = (*reader)->read_read_record_batch(i)->num_rows();
+        CHECK((i + 1 == read_batch_count ? rows <= read_batch_rows : rows == read_batch_rows));
+    }
+
+    // Rows are found in the right batches when reading the signal back:
+    pod5::AsyncSignalLoader loader(
+        *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 2);
+    std::size_t read_index = 0;
+    while (true) {
+        auto batch = loader.release_next_batch();
+        REQUIRE_ARROW_STATUS_OK(batch);
+        if (!*batch) {
+            break;
+        }
+        for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+            auto const samples = (*batch)->samples(row);
+            CHECK(
+                std::vector<std::int16_t>(samples.begin(), samples.end())
+                == signal_for_read(read_index));
+            read_index += 1;
+        }
+    }
+    CHECK(read_index == read_count);
+}
+
+TEST_CASE("Flushing written batches by deadline and size")
+{
+    static constexpr char const * file = "./flush_policy.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const use_sync_io = GENERATE(false, true);
+    CAPTURE(use_sync_io);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 100;
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(1000, std::int16_t(i));
+    };
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_use_sync_io(use_sync_io);
+        options.set_flush_on_batch_complete(false);
+        options.set_max_flush_latency(std::chrono::milliseconds(5));
+        options.set_max_unflushed_bytes(16 * 1024);
+        options.set_signal_table_batch_size(5);
+        options.set_read_table_batch_size(5);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData const read_data{
+                uuid_gen(),
+                std::uint32_t(i),
+                0,
+                1,
+                1,
+                *pore_type,
+                0.0f,
+                1.0f,
+                0.0f,
+                *end_reason,
+                false,
+                *run_info,
+                0,
+                1.0f,
+                0.0f,
+                1.0f,
+                0.0f,
+                0,
+                0.0f};
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+
+            // Leave the writer idle now and then, so deadlines expire between calls:
+            if (i % 20 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    CHECK((*reader)->num_signal_record_batches() == read_count / 5);
+
+    pod5::AsyncSignalLoader loader(
+        *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 2);
+    std::size_t read_index = 0;
+    while (true) {
+        auto batch = loader.release_next_batch();
+        REQUIRE_ARROW_STATUS_OK(batch);
+        if (!*batch) {
+            break;
+        }
+        for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+            auto const samples = (*batch)->samples(row);
+            CHECK(
+                std::vector<std::int16_t>(samples.begin(), samples.end())
+                == signal_for_read(read_index));
+            read_index += 1;
+        }
+    }
+    CHECK(read_index == read_count);
+}
+
+TEST_CASE("Adding reads without waiting on full write queues")
+{
+    static constexpr char const * file = "./try_add_reads.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    // Noisy signal compresses to more than the pending write limit:
+    std::uniform_int_distribution<std::int16_t> sample_dist;
+    std::vector<std::int16_t> signal(1000);
+    for (auto & sample : signal) {
+        sample = sample_dist(gen);
+    }
+
+    std::vector<pod5::Uuid> added_read_ids;
+    {
+        // Writes are queued to one IO thread, which the test holds up to fill the queues:
+        auto const io_thread_pool = pod5::make_thread_pool(1);
+        pod5::FileWriterOptions options;
+        options.set_thread_pool(io_thread_pool);
+        options.set_max_pending_write_bytes(1024);
+        options.set_signal_table_batch_size(1);
+        options.set_read_table_batch_size(1);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::promise<void> capacity_freed;
+        std::atomic<bool> capacity_signalled{false};
+        (*writer)->set_write_capacity_callback([&] {
+            if (!capacity_signalled.exchange(true)) {
+                capacity_freed.set_value();
+            }
         });
+
+        auto try_add_read = [&] {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = std::uint32_t(added_read_ids.size());
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const added = (*writer)->try_add_complete_read(read_data, gsl::make_span(signal));
+            REQUIRE_ARROW_STATUS_OK(added);
+            if (*added) {
+                added_read_ids.push_back(read_data.read_id);
+            }
+            return *added;
+        };
+
+        // Let the writes made opening the file complete, then hold up the IO thread:
+        while (!(*writer)->has_write_capacity()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::promise<void> release_io;
+        io_thread_pool->post([io_released = release_io.get_future().share()] {
+            io_released.wait();
+        });
+
+        // A read is added while the queues have room, and refused once its writes fill them:
+        CHECK(try_add_read());
+        CHECK(!(*writer)->has_write_capacity());
+        CHECK(!try_add_read());
+        CHECK(!capacity_signalled);
+
+        release_io.set_value();
+        REQUIRE(
+            capacity_freed.get_future().wait_for(std::chrono::seconds(10))
+            == std::future_status::ready);
+        while (!try_add_read()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    std::vector<pod5::Uuid> read_ids;
+    for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
+        auto batch = (*reader)->read_read_record_batch(i);
+        REQUIRE_ARROW_STATUS_OK(batch);
+        auto const columns = batch->columns();
+        REQUIRE_ARROW_STATUS_OK(columns);
+        for (std::int64_t row = 0; row < columns->read_id->length(); ++row) {
+            read_ids.push_back(columns->read_id->Value(row));
+        }
+    }
+    CHECK(read_ids == added_read_ids);
+}
+
+TEST_CASE("Closing a writer on a thread pool")
+{
+    static constexpr char const * file = "./close_async.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 20;
+    std::vector<std::int16_t> const signal(1000, 5);
+
+    auto const close_thread_pool = pod5::make_thread_pool(1);
+    std::vector<pod5::Uuid> added_read_ids;
+    arrow::Future<> closed;
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(3);
+        options.set_read_table_batch_size(3);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = std::uint32_t(i);
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+            added_read_ids.push_back(read_data.read_id);
+        }
+
+        closed = (*writer)->close_async(*close_thread_pool);
+        // Closing again shares the first close:
+        CHECK((*writer)->close_async(*close_thread_pool).Equals(closed));
+        // The writer is destroyed here without waiting, the close keeps what it needs alive.
+    }
+    REQUIRE_ARROW_STATUS_OK(closed.status());
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    std::vector<pod5::Uuid> read_ids;
+    for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
+        auto batch = (*reader)->read_read_record_batch(i);
+        REQUIRE_ARROW_STATUS_OK(batch);
+        auto const columns = batch->columns();
+        REQUIRE_ARROW_STATUS_OK(columns);
+        for (std::int64_t row = 0; row < columns->read_id->length(); ++row) {
+            read_ids.push_back(columns->read_id->Value(row));
+        }
+    }
+    CHECK(read_ids == added_read_ids);
+
+    // A writer closed on a stopped pool reports the failure, and can still be closed in place:
+    static constexpr char const * stopped_file = "./close_async_stopped.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(stopped_file));
+    close_thread_pool->stop_and_drain();
+    auto writer = pod5::create_file_writer(stopped_file, "test_software", {});
+    REQUIRE_ARROW_STATUS_OK(writer);
+    CHECK(!(*writer)->close_async(*close_thread_pool).status().ok());
+    REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    REQUIRE_ARROW_STATUS_OK(pod5::open_file_reader(stopped_file));
+}
+
+TEST_CASE("Writing a file to an output stream")
+{
+    static constexpr char const * file = "./output_stream.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const sort_read_table = GENERATE(false, true);
+    CAPTURE(sort_read_table);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::size_t const read_count = 20;
+    auto const signal_for_read = [](std::size_t i) {
+        std::vector<std::int16_t> signal(100 + i * 10);
+        std::iota(signal.begin(), signal.end(), std::int16_t(i));
+        return signal;
+    };
+
+    CHECK_FALSE(pod5::create_file_writer(
+                    std::shared_ptr<arrow::io::OutputStream>{}, "test_software", {})
+                    .ok());
+
+    auto sink = arrow::io::BufferOutputStream::Create();
+    REQUIRE_ARROW_STATUS_OK(sink);
+    std::vector<pod5::Uuid> added_read_ids;
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(3);
+        options.set_read_table_batch_size(4);
+        options.set_sort_read_table_by_read_id(sort_read_table);
+        options.set_signal_summary_decimations({16});
+        auto writer = pod5::create_file_writer(*sink, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        CHECK((*writer)->path().empty());
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = std::uint32_t(i);
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+            added_read_ids.push_back(read_data.read_id);
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+    // The sink is left open for its owner:
+    CHECK_FALSE((*sink)->closed());
+    auto buffer = (*sink)->Finish();
+    REQUIRE_ARROW_STATUS_OK(buffer);
+
+    // The bytes streamed out are a whole file:
+    {
+        auto out = arrow::io::FileOutputStream::Open(file);
+        REQUIRE_ARROW_STATUS_OK(out);
+        REQUIRE_ARROW_STATUS_OK((*out)->Write(*buffer));
+        REQUIRE_ARROW_STATUS_OK((*out)->Close());
+    }
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE_ARROW_STATUS_OK(pod5::verify_file(**reader));
+    CHECK((*reader)->signal_summary());
+
+    std::vector<pod5::Uuid> read_ids;
+    for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
+        auto batch = (*reader)->read_read_record_batch(i);
+        REQUIRE_ARROW_STATUS_OK(batch);
+        auto const view = batch->view();
+        for (std::int64_t row = 0; row < view.num_rows; ++row) {
+            read_ids.push_back(view.read_id[row]);
+            auto const expected = signal_for_read(view.read_number[row]);
+            std::vector<std::int16_t> samples(expected.size());
+            REQUIRE_ARROW_STATUS_OK(
+                (*reader)->extract_samples(view.signal[row], gsl::make_span(samples)));
+            CHECK(samples == expected);
+        }
+    }
+    auto expected_read_ids = added_read_ids;
+    if (sort_read_table) {
+        std::sort(expected_read_ids.begin(), expected_read_ids.end());
+    }
+    CHECK(read_ids == expected_read_ids);
+}
+
+TEST_CASE("Adding reads in bulk as columns")
+{
+    static constexpr char const * file = "./bulk_reads.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const signal_type =
+        GENERATE(pod5::SignalType::VbzSignal, pod5::SignalType::UncompressedSignal);
+    CAPTURE(signal_type);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    static constexpr std::size_t read_count = 50;
+    // Includes reads without signal, and reads spanning several chunks:
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>((i % 4) * 300, std::int16_t(i));
+    };
+
+    std::vector<pod5::Uuid> read_ids;
+    std::vector<std::uint32_t> read_numbers;
+    std::vector<std::uint64_t> start_samples;
+    std::vector<float> floats;
+    std::vector<std::uint64_t> num_minknow_events;
+    std::vector<std::uint32_t> num_reads_since_mux_change;
+    std::vector<std::uint16_t> channels;
+    std::vector<std::uint8_t> wells;
+    std::array<bool, read_count> end_reasons_forced{};
+    std::vector<std::vector<std::int16_t>> signals;
+    for (std::size_t i = 0; i < read_count; ++i) {
+        read_ids.push_back(uuid_gen());
+        read_numbers.push_back(std::uint32_t(i));
+        start_samples.push_back(i * 1000);
+        floats.push_back(float(i) / 2);
+        num_minknow_events.push_back(i * 10);
+        num_reads_since_mux_change.push_back(std::uint32_t(i % 7));
+        channels.push_back(std::uint16_t(i + 1));
+        wells.push_back(std::uint8_t(i % 4 + 1));
+        end_reasons_forced[i] = i % 3 == 0;
+        signals.push_back(signal_for_read(i));
+    }
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_type(signal_type);
+        options.set_max_signal_chunk_size(500);
+        options.set_signal_table_batch_size(8);
+        options.set_read_table_batch_size(7);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_negative);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::vector<std::int16_t> const pore_types(read_count, *pore_type);
+        std::vector<std::int16_t> const end_reasons(read_count, *end_reason);
+        std::vector<std::int16_t> const run_infos(read_count, *run_info);
+        std::vector<gsl::span<std::int16_t const>> signal_spans(signals.begin(), signals.end());
+
+        auto columns_for = [&](std::size_t start, std::size_t count) {
+            auto const float_column = gsl::make_span(floats).subspan(start, count);
+            pod5::ReadDataColumns columns;
+            columns.read_id = gsl::make_span(read_ids).subspan(start, count);
+            columns.read_number = gsl::make_span(read_numbers).subspan(start, count);
+            columns.start_sample = gsl::make_span(start_samples).subspan(start, count);
+            columns.median_before = float_column;
+            columns.end_reason = gsl::make_span(end_reasons).subspan(start, count);
+            columns.end_reason_forced = gsl::make_span(end_reasons_forced).subspan(start, count);
+            columns.run_info = gsl::make_span(run_infos).subspan(start, count);
+            columns.num_minknow_events = gsl::make_span(num_minknow_events).subspan(start, count);
+            columns.tracked_scaling_scale = float_column;
+            columns.tracked_scaling_shift = float_column;
+            columns.predicted_scaling_scale = float_column;
+            columns.predicted_scaling_shift = float_column;
+            columns.num_reads_since_mux_change =
+                gsl::make_span(num_reads_since_mux_change).subspan(start, count);
+            columns.time_since_mux_change = float_column;
+            columns.channel = gsl::make_span(channels).subspan(start, count);
+            columns.well = gsl::make_span(wells).subspan(start, count);
+            columns.pore_type = gsl::make_span(pore_types).subspan(start, count);
+            columns.calibration_offset = float_column;
+            columns.calibration_scale = float_column;
+            return columns;
+        };
+
+        // Columns of different lengths are rejected, writing nothing:
+        auto short_columns = columns_for(0, 10);
+        short_columns.well = short_columns.well.subspan(0, 9);
+        CHECK_FALSE(
+            (*writer)->add_reads(short_columns, gsl::make_span(signal_spans).subspan(0, 10)).ok());
+
+        // Add the reads in two calls, so the second continues part way through a batch:
+        REQUIRE_ARROW_STATUS_OK(
+            (*writer)->add_reads(columns_for(0, 10), gsl::make_span(signal_spans).subspan(0, 10)));
+        REQUIRE_ARROW_STATUS_OK((*writer)->add_reads(
+            columns_for(10, read_count - 10),
+            gsl::make_span(signal_spans).subspan(10, read_count - 10)));
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    std::size_t read_index = 0;
+    for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
+        auto read_batch = (*reader)->read_read_record_batch(i);
+        REQUIRE_ARROW_STATUS_OK(read_batch);
+        auto columns = read_batch->columns();
+        REQUIRE_ARROW_STATUS_OK(columns);
+        CHECK(
+            (i + 1 == (*reader)->num_read_record_batches() ? columns->read_id->length() <= 7
+                                                           : columns->read_id->length() == 7));
+
+        for (std::int64_t row = 0; row < columns->read_id->length(); ++row, ++read_index) {
+            CAPTURE(read_index);
+            CHECK(columns->read_id->Value(row) == read_ids[read_index]);
+            CHECK(columns->read_number->Value(row) == read_numbers[read_index]);
+            CHECK(columns->start_sample->Value(row) == start_samples[read_index]);
+            CHECK(columns->median_before->Value(row) == floats[read_index]);
+            CHECK(columns->num_minknow_events->Value(row) == num_minknow_events[read_index]);
+            CHECK(
+                columns->num_reads_since_mux_change->Value(row)
+                == num_reads_since_mux_change[read_index]);
+            CHECK(columns->num_samples->Value(row) == signals[read_index].size());
+            CHECK(columns->channel->Value(row) == channels[read_index]);
+            CHECK(columns->well->Value(row) == wells[read_index]);
+            CHECK(columns->end_reason_forced->Value(row) == end_reasons_forced[read_index]);
+            CHECK(
+                std::size_t(columns->signal->value_length(row))
+                == (signals[read_index].size() + 499) / 500);
+
+            std::vector<std::int16_t> samples(signals[read_index].size());
+            auto const signal_rows = std::static_pointer_cast<arrow::UInt64Array>(
+                columns->signal->value_slice(row));
+            REQUIRE_ARROW_STATUS_OK((*reader)->extract_samples(
+                gsl::make_span(signal_rows->raw_values(), signal_rows->length()),
+                gsl::make_span(samples)));
+            CHECK(samples == signals[read_index]);
+        }
+    }
+    CHECK(read_index == read_count);
+}
+
+SCENARIO("Opening older files")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto uuid_from_string = [](char const * val) -> pod5::Uuid {
+        auto result = pod5::Uuid::from_string(val);
+        REQUIRE(result);
+        return *result;
+    };
+
+    struct ReadData {
+        pod5::Uuid read_id;
+        std::uint32_t read_number;
+        float calibration_offset;
+        float calibration_scale;
+        std::string end_reason;
+        std::string pore_type;
+        std::string run_info_id;
+    };
+
+    std::vector<ReadData> test_read_data{
+        {{uuid_from_string("0000173c-bf67-44e7-9a9c-1ad0bc728e74")},
+         1093,
+         21.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("002fde30-9e23-4125-9eae-d112c18a81a7")},
+         75,
+         4.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("006d1319-2877-4b34-85df-34de7250a47b")},
+         1053,
+         6.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("00728efb-2120-4224-87d8-580fbb0bd4b2")},
+         657,
+         2.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("007cc97e-6de2-4ff6-a0fd-1c1eca816425")},
+         1625,
+         23.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("008468c3-e477-46c4-a6e2-7d021a4ebf0b")},
+         411,
+         4.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("008ed3dc-86c2-452f-b107-6877a473d177")},
+         513,
+         5.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("00919556-e519-4960-8aa5-c2dfa020980c")},
+         56,
+         2.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("00925f34-6baf-47fc-b40c-22591e27fb5c")},
+         930,
+         37.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+        {{uuid_from_string("009dc9bd-c5f4-487b-ba4c-b9ce7e3a711e")},
+         195,
+         14.0f,
+         0.1755f,
+         "unknown",
+         "not_set",
+         "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+    };
+
+    auto repo_root =
+        ::arrow::internal::PlatformFilename::FromString(__FILE__)->Parent().Parent().Parent();
+    auto path = GENERATE_COPY(
+        *repo_root.Join("test_data/multi_fast5_zip_v0.pod5"),
+        *repo_root.Join("test_data/multi_fast5_zip_v1.pod5"),
+        *repo_root.Join("test_data/multi_fast5_zip_v2.pod5"),
+        *repo_root.Join("test_data/multi_fast5_zip_v3.pod5"));
+    auto reader = pod5::open_file_reader(path.ToString(), {});
+    CHECK_ARROW_STATUS_OK(reader);
+
+    auto metadata = (*reader)->schema_metadata();
+    CHECK(metadata.writing_software == "Python API");
+
+    std::size_t abs_row = 0;
+
+    for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
+        auto batch = (*reader)->read_read_record_batch(i);
+
+        auto columns = batch->columns();
+        REQUIRE_ARROW_STATUS_OK(columns);
+
+        for (std::size_t row = 0; row < batch->num_rows(); ++row) {
+            CAPTURE(abs_row);
+            auto read_data = test_read_data[row];
+            CHECK(columns->read_id->Value(row) == read_data.read_id);
+            CHECK(columns->read_number->Value(row) == read_data.read_number);
+            CHECK(columns->calibration_offset->Value(row) == read_data.calibration_offset);
+            CHECK(columns->calibration_scale->Value(row) == Approx(read_data.calibration_scale));
+            auto end_reason = *batch->get_end_reason(columns->end_reason->GetValueIndex(row));
+            CHECK(end_reason.first == pod5::end_reason_from_string(read_data.end_reason));
+            CHECK(end_reason.second == read_data.end_reason);
+            auto pore_type = batch->get_pore_type(columns->pore_type->GetValueIndex(row));
+            CHECK(*pore_type == read_data.pore_type);
+            auto run_info_id = batch->get_run_info(columns->run_info->GetValueIndex(row));
+            CHECK(*run_info_id == read_data.run_info_id);
+
+            ++abs_row;
+        }
+    }
+    CHECK(abs_row == test_read_data.size());
+
+    auto run_info = (*reader)->find_run_info(test_read_data[0].run_info_id);
+    REQUIRE_ARROW_STATUS_OK(run_info);
+    CHECK((*run_info)->acquisition_id == test_read_data[0].run_info_id);
+    CHECK((*run_info)->adc_min == -4096);
+    CHECK((*run_info)->adc_max == 4095);
+    CHECK((*run_info)->protocol_run_id == "df049455-3552-438c-8176-d4a5b1dd9fc5");
+    CHECK((*run_info)->software == "python-pod5-converter");
+    CHECK(
+        (*run_info)->tracking_id
+        == pod5::RunInfoData::MapType{
+            {"asic_id", "131070"},
+            {"asic_id_eeprom", "0"},
+            {"asic_temp", "35.043102"},
+            {"asic_version", "IA02C"},
+            {"auto_update", "0"},
+            {"auto_update_source", "https://mirror.oxfordnanoportal.com/software/MinKNOW/"},
+            {"bream_is_standard", "0"},
+            {"device_id", "MS00000"},
+            {"device_type", "minion"},
+            {"distribution_status", "modified"},
+            {"distribution_version", "unknown"},
+            {"exp_script_name", "c449127e3461a521e0865fe6a88716f6f6b0b30c"},
+            {"exp_script_purpose", "sequencing_run"},
+            {"exp_start_time", "2019-05-13T11:11:43Z"},
+            {"flow_cell_id", ""},
+            {"guppy_version", "3.0.3+7e7b7d0"},
+            {"heatsink_temp", "35.000000"},
+            {"hostname", "happy_fish"},
+            {"installation_type", "prod"},
+            {"local_firmware_file", "1"},
+            {"operating_system", "ubuntu 16.04"},
+            {"protocol_group_id", "TEST_EXPERIMENT"},
+            {"protocol_run_id", "df049455-3552-438c-8176-d4a5b1dd9fc5"},
+            {"protocols_version", "4.0.6"},
+            {"run_id", "a08e850aaa44c8b56765eee10b386fc3e516a62b"},
+            {"sample_id", "TEST_SAMPLE"},
+            {"usb_config", "MinION_fx3_1.1.1_ONT#MinION_fpga_1.1.0#ctrl#Auto"},
+            {"version", "3.4.0-rc3"},
+        });
+
+    // Reading migrates batches as they're read, without writing temporary copies:
+    for (auto const & entry : std::filesystem::directory_iterator(".")) {
+        CHECK(entry.path().filename().string().rfind(".tmp_pod5", 0) != 0);
+    }
+
+    // Migrated tables are only written out once their location is needed:
+    auto const & read_table_location = (*reader)->read_table_location();
+    auto read_table_file = arrow::io::ReadableFile::Open(read_table_location.file_path);
+    REQUIRE_ARROW_STATUS_OK(read_table_file);
+    auto read_table = pod5::make_read_table_reader(
+        std::make_shared<pod5::combined_file_utils::SubFile>(
+            *read_table_file, read_table_location.offset, read_table_location.size),
+        arrow::default_memory_pool());
+    REQUIRE_ARROW_STATUS_OK(read_table);
+    CHECK(read_table->num_record_batches() == (*reader)->num_read_record_batches());
+    auto read_table_batch = read_table->read_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(read_table_batch);
+    CHECK(read_table_batch->num_rows() == test_read_data.size());
+}
+
+TEST_CASE("Updating older files in parallel")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto repo_root =
+        ::arrow::internal::PlatformFilename::FromString(__FILE__)->Parent().Parent().Parent();
+    auto path = GENERATE_COPY(
+        *repo_root.Join("test_data/multi_fast5_zip_v0.pod5"),
+        *repo_root.Join("test_data/multi_fast5_zip_v2.pod5"),
+        *repo_root.Join("test_data/multi_fast5_zip_v3.pod5"));
+    std::string const updated_path = "./updated_in_parallel.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(updated_path));
+
+    auto source = pod5::open_file_reader(path.ToString(), {});
+    REQUIRE_ARROW_STATUS_OK(source);
+
+    // One pending batch at most, so batches are migrated while others are written:
+    auto thread_pool = pod5::make_thread_pool(2);
+    REQUIRE_ARROW_STATUS_OK(pod5::update_file(
+        arrow::default_memory_pool(), *source, updated_path, *thread_pool, 1));
+
+    auto updated = pod5::open_file_reader(updated_path, {});
+    REQUIRE_ARROW_STATUS_OK(updated);
+    CHECK((*updated)->file_version_pre_migration() == pod5::current_build_version_number());
+    CHECK(*(*updated)->read_count() == *(*source)->read_count());
+    REQUIRE((*updated)->num_read_record_batches() == (*source)->num_read_record_batches());
+
+    auto source_batch = (*source)->read_read_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(source_batch);
+    auto updated_batch = (*updated)->read_read_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(updated_batch);
+    auto source_columns = *source_batch->columns();
+    auto updated_columns = *updated_batch->columns();
+    for (std::size_t row = 0; row < updated_batch->num_rows(); ++row) {
+        CHECK(updated_columns.read_id->Value(row) == source_columns.read_id->Value(row));
+        CHECK(updated_columns.num_samples->Value(row) == source_columns.num_samples->Value(row));
+        CHECK(
+            *updated_batch->get_run_info(updated_columns.run_info->GetValueIndex(row))
+            == *source_batch->get_run_info(source_columns.run_info->GetValueIndex(row)));
+    }
+
+    // The signal table is copied as stored:
+    CHECK((*updated)->num_signal_record_batches() == (*source)->num_signal_record_batches());
+    auto const signal_rows = std::static_pointer_cast<arrow::UInt64Array>(
+        updated_columns.signal->value_slice(0));
+    std::vector<std::uint64_t> rows(signal_rows->length());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        rows[i] = signal_rows->Value(i);
+    }
+    auto const sample_count = (*updated)->extract_sample_count(gsl::make_span(rows));
+    REQUIRE_ARROW_STATUS_OK(sample_count);
+    CHECK(*sample_count == updated_columns.num_samples->Value(0));
+    auto run_info = (*updated)->find_run_info(
+        *updated_batch->get_run_info(updated_columns.run_info->GetValueIndex(0)));
+    REQUIRE_ARROW_STATUS_OK(run_info);
+
+    *updated = nullptr;
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(updated_path));
+}
+
+SCENARIO("Searching for read ids")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_read_id_index = GENERATE(true, false);
+    CAPTURE(write_read_id_index);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::size_t const read_count = 20;
+    std::size_t const read_table_batch_size = 3;
+    std::vector<pod5::Uuid> read_ids;
+    for (std::size_t i = 0; i < read_count; ++i) {
+        read_ids.push_back(uuid_gen());
+    }
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_read_table_batch_size(read_table_batch_size);
+        options.set_write_read_id_index(write_read_id_index);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = read_ids[i];
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    auto const batch_count = (*reader)->num_read_record_batches();
+    REQUIRE(batch_count == 7);
+
+    // Search for every other read, along with an id not in the file:
+    std::vector<pod5::Uuid> search_ids;
+    for (std::size_t i = 0; i < read_count; i += 2) {
+        search_ids.push_back(read_ids[i]);
+    }
+    search_ids.push_back(uuid_gen());
+
+    std::vector<std::uint32_t> batch_counts(batch_count);
+    std::vector<std::uint32_t> batch_rows(search_ids.size());
+    auto const found = (*reader)->search_for_read_ids(
+        pod5::ReadIdSearchInput{gsl::make_span(search_ids)},
+        gsl::make_span(batch_counts),
+        gsl::make_span(batch_rows));
+    REQUIRE_ARROW_STATUS_OK(found);
+    CHECK(*found == read_count / 2);
+
+    std::vector<std::uint32_t> expected_batch_counts(batch_count);
+    std::vector<std::uint32_t> expected_batch_rows;
+    for (std::size_t i = 0; i < read_count; i += 2) {
+        expected_batch_counts[i / read_table_batch_size] += 1;
+        expected_batch_rows.push_back(i % read_table_batch_size);
+    }
+    expected_batch_rows.resize(search_ids.size());
+    CHECK(batch_counts == expected_batch_counts);
+    CHECK(batch_rows == expected_batch_rows);
+
+    // A large unsorted query is split across threads, and finds every read:
+    std::vector<pod5::Uuid> large_search_ids(read_ids.rbegin(), read_ids.rend());
+    for (std::size_t i = 0; i < 200'000; ++i) {
+        large_search_ids.push_back(uuid_gen());
+    }
+    std::shuffle(large_search_ids.begin(), large_search_ids.end(), gen);
+
+    std::vector<std::uint32_t> large_batch_rows(large_search_ids.size());
+    auto const large_found = (*reader)->search_for_read_ids(
+        pod5::ReadIdSearchInput{gsl::make_span(large_search_ids)},
+        gsl::make_span(batch_counts),
+        gsl::make_span(large_batch_rows));
+    REQUIRE_ARROW_STATUS_OK(large_found);
+    CHECK(*large_found == read_count);
+    CHECK(batch_counts == std::vector<std::uint32_t>{3, 3, 3, 3, 3, 3, 2});
+    for (std::size_t i = 0; i < read_count; ++i) {
+        CHECK(large_batch_rows[i] == i % read_table_batch_size);
+    }
+
+    // Readers prepared for fork keep the same index, which forked children search:
+    CHECK_ARROW_STATUS_OK((*reader)->prepare_for_fork());
+    CHECK_ARROW_STATUS_OK((*reader)->prepare_for_fork());
+    auto const shared_index = (*reader)->read_id_index();
+    REQUIRE_ARROW_STATUS_OK(shared_index);
+    REQUIRE((*shared_index)->size() == read_count);
+    for (std::size_t i = 0; i < read_count; ++i) {
+        auto const entry = (*shared_index)->lower_bound(read_ids[i]);
+        REQUIRE(entry < read_count);
+        CHECK((*shared_index)->read_ids()[entry] == read_ids[i]);
+        CHECK((*shared_index)->batch(entry) == i / read_table_batch_size);
+    }
+
+#ifdef __linux__
+    // The process pool is made before forking, so the child has to make its own:
+    auto const thread_pool = pod5::process_thread_pool();
+    CHECK((*reader)->read_read_record_batch_async(0, *thread_pool).result().ok());
+
+    auto const child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        // Catch isn't fork safe, so the child only reports through its exit code:
+        std::vector<std::uint32_t> child_batch_counts(batch_count);
+        std::vector<std::uint32_t> child_batch_rows(search_ids.size());
+        auto const child_found = (*reader)->search_for_read_ids(
+            pod5::ReadIdSearchInput{gsl::make_span(search_ids)},
+            gsl::make_span(child_batch_counts),
+            gsl::make_span(child_batch_rows));
+        auto const child_batch =
+            (*reader)->read_read_record_batch_async(1, *pod5::process_thread_pool()).result();
+        auto const passed = child_found.ok() && *child_found == read_count / 2
+                            && child_batch_counts == expected_batch_counts && child_batch.ok()
+                            && child_batch->num_rows() == read_table_batch_size;
+        _exit(passed ? 0 : 1);
+    }
+    int child_status = 0;
+    REQUIRE(waitpid(child, &child_status, 0) == child);
+    CHECK(WIFEXITED(child_status));
+    CHECK(WEXITSTATUS(child_status) == 0);
+#endif
+}
+
+SCENARIO("Writing the read table sorted by read id")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_read_id_index = GENERATE(true, false);
+    CAPTURE(write_read_id_index);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::size_t const read_count = 20;
+    std::size_t const read_table_batch_size = 3;
+    std::vector<pod5::Uuid> read_ids;
+    for (std::size_t i = 0; i < read_count; ++i) {
+        read_ids.push_back(uuid_gen());
+    }
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_read_table_batch_size(read_table_batch_size);
+        options.set_write_read_id_index(write_read_id_index);
+        options.set_write_read_table_statistics(true);
+        options.set_sort_read_table_by_read_id(true);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+
+        // The second pore type is added part way through, so is in a later dictionary delta:
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < read_count; ++i) {
+            auto pore_type = (*writer)->add_pore_type(i < read_count / 2 ? "Pore_a" : "Pore_b");
+            pod5::ReadData read_data;
+            read_data.read_id = read_ids[i];
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    auto const batch_count = (*reader)->num_read_record_batches();
+    REQUIRE(batch_count == 7);
+    auto const statistics = (*reader)->read_table_statistics();
+    REQUIRE(statistics);
+    CHECK(statistics->batch_count() == batch_count);
+
+    // Every read is in the table once, in read id order, with its own fields:
+    std::vector<pod5::Uuid> sorted_read_ids;
+    for (std::size_t i = 0; i < batch_count; ++i) {
+        auto batch = (*reader)->read_read_record_batch(i);
+        REQUIRE_ARROW_STATUS_OK(batch);
+        CHECK(pod5::is_read_table_sorted_by_read_id(*batch->batch()->schema()));
+
+        auto const columns = batch->columns();
+        REQUIRE_ARROW_STATUS_OK(columns);
+        for (std::size_t row = 0; row < batch->num_rows(); ++row) {
+            auto const read_number = columns->read_number->Value(row);
+            REQUIRE(read_number < read_count);
+            CHECK(columns->read_id->Value(row) == read_ids[read_number]);
+
+            auto const pore_type =
+                batch->get_pore_type(std::int16_t(columns->pore_type->GetValueIndex(row)));
+            REQUIRE_ARROW_STATUS_OK(pore_type);
+            CHECK(*pore_type == (read_number < read_count / 2 ? "Pore_a" : "Pore_b"));
+            sorted_read_ids.push_back(columns->read_id->Value(row));
+        }
+    }
+    std::sort(read_ids.begin(), read_ids.end());
+    CHECK(sorted_read_ids == read_ids);
+
+    // Searching finds each read at its sorted position, with or without a stored index:
+    std::vector<std::uint32_t> batch_counts(batch_count);
+    std::vector<std::uint32_t> batch_rows(read_count);
+    auto const found = (*reader)->search_for_read_ids(
+        pod5::ReadIdSearchInput{gsl::make_span(read_ids)},
+        gsl::make_span(batch_counts),
+        gsl::make_span(batch_rows));
+    REQUIRE_ARROW_STATUS_OK(found);
+    CHECK(*found == read_count);
+    CHECK(batch_counts == std::vector<std::uint32_t>{3, 3, 3, 3, 3, 3, 2});
+    for (std::size_t i = 0; i < read_count; ++i) {
+        CHECK(batch_rows[i] == i % read_table_batch_size);
+    }
+
+    std::vector<pod5::Uuid> const missing_ids{uuid_gen()};
+    auto const missing_found = (*reader)->search_for_read_ids(
+        pod5::ReadIdSearchInput{gsl::make_span(missing_ids)},
+        gsl::make_span(batch_counts),
+        gsl::make_span(batch_rows));
+    REQUIRE_ARROW_STATUS_OK(missing_found);
+    CHECK(*missing_found == 0);
+
+    // An index built from the sorted table matches its layout:
+    auto const index = (*reader)->read_id_index();
+    REQUIRE_ARROW_STATUS_OK(index);
+    REQUIRE((*index)->size() == read_count);
+    for (std::size_t i = 0; i < read_count; ++i) {
+        CHECK((*index)->read_ids()[i] == read_ids[i]);
+        CHECK((*index)->batch(i) == i / read_table_batch_size);
+        CHECK((*index)->batch_row(i) == i % read_table_batch_size);
+    }
+}
+
+SCENARIO("Writing compressed read and run info tables")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const sort_read_table_by_read_id = GENERATE(true, false);
+    CAPTURE(sort_read_table_by_read_id);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::size_t const read_count = 50;
+    std::vector<pod5::Uuid> read_ids;
+    for (std::size_t i = 0; i < read_count; ++i) {
+        read_ids.push_back(uuid_gen());
+    }
+    auto const run_info_data = get_test_run_info_data();
+
+    auto write_file = [&](char const * file, arrow::Compression::type table_compression) {
+        REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+        pod5::FileWriterOptions options;
+        options.set_read_table_batch_size(20);
+        options.set_sort_read_table_by_read_id(sort_read_table_by_read_id);
+        options.set_table_compression(table_compression);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(run_info_data);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = read_ids[i];
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    };
+
+    static constexpr char const * compressed_file = "./foo_compressed.pod5";
+    static constexpr char const * uncompressed_file = "./foo_uncompressed.pod5";
+    write_file(compressed_file, arrow::Compression::ZSTD);
+    write_file(uncompressed_file, arrow::Compression::UNCOMPRESSED);
+
+    auto reader = pod5::open_file_reader(compressed_file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    auto uncompressed_reader = pod5::open_file_reader(uncompressed_file, {});
+    REQUIRE_ARROW_STATUS_OK(uncompressed_reader);
+    CHECK(
+        (*reader)->read_table_location().size
+        < (*uncompressed_reader)->read_table_location().size);
+
+    // The tables read back as they were written, with no change to the readers:
+    CHECK(**(*reader)->find_run_info(run_info_data.acquisition_id) == run_info_data);
+    std::vector<pod5::Uuid> found_read_ids;
+    for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
+        auto batch = (*reader)->read_read_record_batch(i);
+        REQUIRE_ARROW_STATUS_OK(batch);
+        auto const columns = batch->columns();
+        REQUIRE_ARROW_STATUS_OK(columns);
+        for (std::size_t row = 0; row < batch->num_rows(); ++row) {
+            auto const read_number = columns->read_number->Value(row);
+            REQUIRE(read_number < read_count);
+            CHECK(columns->read_id->Value(row) == read_ids[read_number]);
+            CHECK(columns->num_samples->Value(row) == 100);
+            found_read_ids.push_back(columns->read_id->Value(row));
+        }
+    }
+    if (!sort_read_table_by_read_id) {
+        CHECK(found_read_ids == read_ids);
+    } else {
+        std::sort(read_ids.begin(), read_ids.end());
+        CHECK(found_read_ids == read_ids);
+    }
+
+    auto const index = (*reader)->read_id_index();
+    REQUIRE_ARROW_STATUS_OK(index);
+    CHECK((*index)->size() == read_count);
+
+    // Only codecs arrow reads back in any build can be written:
+    pod5::FileWriterOptions options;
+    options.set_table_compression(arrow::Compression::GZIP);
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(compressed_file));
+    CHECK(!pod5::create_file_writer(compressed_file, "test_software", options).ok());
+}
+
+SCENARIO("Writing page aligned signal batches")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const page_align_signal_batches = GENERATE(true, false);
+    CAPTURE(page_align_signal_batches);
+
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(500 + 300 * i, std::int16_t(i));
+    };
+
+    std::size_t const read_count = 10;
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(3);
+        options.set_page_align_signal_batches(page_align_signal_batches);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    // Every signal message starts and ends on an aligned offset in the file:
+    std::size_t const alignment = page_align_signal_batches ? pod5::IOManager::Alignment : 0;
+    auto const & signal_location = (*reader)->signal_table_location();
+    pod5::combined_file_utils::ParsedFileInfo signal_file_info;
+    REQUIRE_ARROW_STATUS_OK(signal_file_info.from_full_file(file));
+    signal_file_info.file_start_offset = signal_location.offset;
+    signal_file_info.file_length = signal_location.size;
+    auto signal_sub_file = pod5::combined_file_utils::open_sub_file(signal_file_info);
+    REQUIRE_ARROW_STATUS_OK(signal_sub_file);
+
+    auto signal_table = pod5::make_signal_table_reader(
+        *signal_sub_file, 1, 0, arrow::default_memory_pool());
+    REQUIRE_ARROW_STATUS_OK(signal_table);
+    auto const batch_alignment = signal_table->batch_alignment();
+    REQUIRE_ARROW_STATUS_OK(batch_alignment);
+    CHECK(*batch_alignment == alignment);
+
+    auto const locations = pod5::ipc_file_blocks::read_record_batch_locations(*signal_sub_file);
+    REQUIRE_ARROW_STATUS_OK(locations);
+    REQUIRE(locations->size() == 4);
+    if (page_align_signal_batches) {
+        for (auto const & location : *locations) {
+            CHECK((signal_location.offset + location.offset) % alignment == 0);
+            CHECK((signal_location.offset + location.offset + location.length()) % alignment == 0);
+        }
+    }
+
+    // Readers find the same signal with or without direct I/O, which falls back to regular reads
+    // on filesystems without it:
+    auto direct_io_file = pod5::open_direct_io_file(file, arrow::default_memory_pool());
+    if (direct_io_file.ok()) {
+        auto const size = (*direct_io_file)->GetSize();
+        REQUIRE_ARROW_STATUS_OK(size);
+        auto const data = (*direct_io_file)->ReadAt(5, *size);
+        REQUIRE_ARROW_STATUS_OK(data);
+        CHECK((*data)->size() == *size - 5);
+    }
+
+    pod5::FileReaderOptions direct_io_options;
+    direct_io_options.set_use_direct_io(true);
+    auto direct_io_reader = pod5::open_file_reader(file, direct_io_options);
+    REQUIRE_ARROW_STATUS_OK(direct_io_reader);
+    REQUIRE((*direct_io_reader)->num_signal_record_batches() == 4);
+    for (std::uint64_t i = 0; i < read_count; ++i) {
+        auto const expected = signal_for_read(i);
+        std::vector<std::int16_t> samples(expected.size());
+        std::vector<std::uint64_t> const rows{i};
+        CHECK_ARROW_STATUS_OK(
+            (*direct_io_reader)->extract_samples(gsl::make_span(rows), gsl::make_span(samples)));
+        CHECK(samples == expected);
+    }
+}
+
+SCENARIO("Listing signal batches in the file footer")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const page_align_signal_batches = GENERATE(true, false);
+    CAPTURE(page_align_signal_batches);
+
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(200 + 100 * i, std::int16_t(i));
+    };
+
+    std::size_t const read_count = 10;
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(3);
+        options.set_page_align_signal_batches(page_align_signal_batches);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    pod5::combined_file_utils::ParsedFileInfo main_file;
+    REQUIRE_ARROW_STATUS_OK(main_file.from_full_file(file));
+    auto const footer = pod5::combined_file_utils::read_footer(file, main_file.file);
+    REQUIRE_ARROW_STATUS_OK(footer);
+    auto signal_sub_file = pod5::combined_file_utils::open_sub_file(footer->signal_table);
+    REQUIRE_ARROW_STATUS_OK(signal_sub_file);
+
+    // The footer lists the batches where the signal table's own footer does:
+    auto const & listed = footer->signal_table.batch_locations;
+    auto const locations = pod5::ipc_file_blocks::read_record_batch_locations(*signal_sub_file);
+    REQUIRE_ARROW_STATUS_OK(locations);
+    REQUIRE(listed.size() == 4);
+    REQUIRE(locations->size() == listed.size());
+    for (std::size_t i = 0; i < listed.size(); ++i) {
+        CAPTURE(i);
+        CHECK(listed[i].offset == (*locations)[i].offset);
+        CHECK(listed[i].metadata_length == (*locations)[i].metadata_length);
+        CHECK(listed[i].body_length == (*locations)[i].body_length);
+        CHECK(listed[i].row_count == (i < 3 ? 3 : 1));
+    }
+    CHECK(footer->run_info_table.batch_locations.empty());
+    CHECK(footer->reads_table.batch_locations.empty());
+
+    auto check_signal = [&](pod5::SignalTableReader & signal_table) {
+        CHECK(signal_table.table_batch_size() == 3);
+        for (std::uint64_t i = 0; i < read_count; ++i) {
+            auto const expected = signal_for_read(i);
+            std::vector<std::int16_t> samples(expected.size());
+            std::vector<std::uint64_t> const rows{i};
+            CHECK_ARROW_STATUS_OK(
+                signal_table.extract_samples(gsl::make_span(rows), gsl::make_span(samples)));
+            CHECK(samples == expected);
+        }
+    };
+
+    WHEN("The signal table is opened with the listed batches")
+    {
+        auto signal_table = pod5::make_signal_table_reader(
+            *signal_sub_file, 1, 0, arrow::default_memory_pool(), listed);
+        REQUIRE_ARROW_STATUS_OK(signal_table);
+        // The table's own footer isn't read:
+        CHECK(!signal_table->reader());
+        CHECK(signal_table->num_record_batches() == listed.size());
+        check_signal(*signal_table);
+    }
+
+    WHEN("The listed batches don't hold the rows they list")
+    {
+        auto bad_listing = listed;
+        bad_listing.front().row_count += 1;
+        auto signal_table = pod5::make_signal_table_reader(
+            *signal_sub_file, 1, 0, arrow::default_memory_pool(), bad_listing);
+        REQUIRE_ARROW_STATUS_OK(signal_table);
+        THEN("Loading the batch fails")
+        {
+            CHECK(!signal_table->read_record_batch(0).ok());
+            CHECK_ARROW_STATUS_OK(signal_table->read_record_batch(1));
+        }
+    }
+
+    WHEN("The listed batches don't fit the signal table")
+    {
+        // They are ignored, and the table's own footer used instead:
+        auto bad_listing = listed;
+        bad_listing.back().body_length += footer->signal_table.file_length;
+        auto signal_table = pod5::make_signal_table_reader(
+            *signal_sub_file, 1, 0, arrow::default_memory_pool(), bad_listing);
+        REQUIRE_ARROW_STATUS_OK(signal_table);
+        check_signal(*signal_table);
+    }
+
+    WHEN("The file is opened")
+    {
+        auto reader = pod5::open_file_reader(file, {});
+        REQUIRE_ARROW_STATUS_OK(reader);
+        REQUIRE((*reader)->num_signal_record_batches() == 4);
+        for (std::uint64_t i = 0; i < read_count; ++i) {
+            auto const expected = signal_for_read(i);
+            std::vector<std::int16_t> samples(expected.size());
+            std::vector<std::uint64_t> const rows{i};
+            CHECK_ARROW_STATUS_OK(
+                (*reader)->extract_samples(gsl::make_span(rows), gsl::make_span(samples)));
+            CHECK(samples == expected);
+        }
+    }
+}
+
+SCENARIO("Footer contents of files written with default options")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    // Released readers reject footers holding any content type beyond the three tables, so
+    // the optional indexes are only written when asked for:
+    auto const write_indexes = GENERATE(false, true);
+    CAPTURE(write_indexes);
+
+    {
+        pod5::FileWriterOptions options;
+        if (write_indexes) {
+            options.set_write_read_id_index(true);
+            options.set_write_read_id_filter(true);
+            options.set_write_read_table_statistics(true);
+            options.set_write_file_summary(true);
+            options.set_write_signal_row_index(true);
+        }
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < 5; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    pod5::combined_file_utils::ParsedFileInfo main_file;
+    REQUIRE_ARROW_STATUS_OK(main_file.from_full_file(file));
+    auto const footer = pod5::combined_file_utils::read_footer(file, main_file.file);
+    REQUIRE_ARROW_STATUS_OK(footer);
+
+    CHECK(footer->signal_table.file);
+    CHECK(footer->run_info_table.file);
+    CHECK(footer->reads_table.file);
+    if (!write_indexes) {
+        CHECK(!footer->read_id_index.file);
+        CHECK(footer->other_indexes.empty());
+    } else {
+        CHECK(footer->read_id_index.file);
+        CHECK(footer->other_indexes.size() == 4);
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    CHECK((*reader)->num_read_record_batches() == 1);
+}
+
+TEST_CASE("Copying signal batches of another size")
+{
+    static constexpr char const * small_batches_file = "./small_signal_batches.pod5";
+    static constexpr char const * large_batches_file = "./large_signal_batches.pod5";
+    static constexpr char const * copied_batches_file = "./copied_signal_batches.pod5";
+    for (auto const file : {small_batches_file, large_batches_file, copied_batches_file}) {
+        REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    }
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    auto signal_for_read = [](std::size_t file_index, std::size_t i) {
+        return std::vector<std::int16_t>(20 + i, std::int16_t(file_index * 100 + i));
+    };
+
+    // Two source files of two full batches, of 3 and 5 rows:
+    auto write_source = [&](char const * file, std::size_t file_index, std::size_t batch_size) {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(batch_size);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        for (std::size_t i = 0; i < batch_size * 2; ++i) {
+            auto const signal = signal_for_read(file_index, i);
+            REQUIRE_ARROW_STATUS_OK((*writer)->add_signal(uuid_gen(), gsl::make_span(signal)));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    };
+    write_source(small_batches_file, 0, 3);
+    write_source(large_batches_file, 1, 5);
+
+    auto small_source = pod5::open_file_reader(small_batches_file);
+    REQUIRE_ARROW_STATUS_OK(small_source);
+    auto large_source = pod5::open_file_reader(large_batches_file);
+    REQUIRE_ARROW_STATUS_OK(large_source);
+
+    auto const last_signal = signal_for_read(2, 0);
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_table_batch_size(3);
+        auto writer = pod5::create_file_writer(copied_batches_file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto small_message = (*small_source)->read_signal_record_batch_message(0);
+        REQUIRE_ARROW_STATUS_OK(small_message);
+        auto first_row = (*writer)->add_raw_signal_batch(**small_message, 3);
+        REQUIRE_ARROW_STATUS_OK(first_row);
+        CHECK(*first_row == 0);
+
+        // Readers find rows by the size of the first batch, so batches of another size are
+        // refused, whatever row count they are listed with:
+        auto large_message = (*large_source)->read_signal_record_batch_message(0);
+        REQUIRE_ARROW_STATUS_OK(large_message);
+        CHECK_FALSE((*writer)->add_raw_signal_batch(**large_message, 5).ok());
+        CHECK_FALSE((*writer)->add_raw_signal_batch(**large_message, 3).ok());
+
+        small_message = (*small_source)->read_signal_record_batch_message(1);
+        REQUIRE_ARROW_STATUS_OK(small_message);
+        first_row = (*writer)->add_raw_signal_batch(**small_message, 3);
+        REQUIRE_ARROW_STATUS_OK(first_row);
+        CHECK(*first_row == 3);
+
+        // Only the last batch may be short:
+        REQUIRE_ARROW_STATUS_OK((*writer)->add_signal(uuid_gen(), gsl::make_span(last_signal)));
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(copied_batches_file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE((*reader)->num_signal_record_batches() == 3);
+    CHECK(*(*reader)->signal_table_batch_size() == 3);
+
+    for (std::uint64_t row = 0; row < 7; ++row) {
+        CAPTURE(row);
+        auto const expected = row < 6 ? signal_for_read(0, row) : last_signal;
+        std::vector<std::int16_t> samples(expected.size());
+        std::vector<std::uint64_t> const rows{row};
+        REQUIRE_ARROW_STATUS_OK(
+            (*reader)->extract_samples(gsl::make_span(rows), gsl::make_span(samples)));
+        CHECK(samples == expected);
+    }
+}
+
+SCENARIO("Appending reads to a closed file")
+{
+    static constexpr char const * file = "./appended.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const page_align_signal_batches = GENERATE(false, true);
+    CAPTURE(page_align_signal_batches);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    auto signal_for_read = [](std::size_t i) {
+        std::vector<std::int16_t> signal(100 + i * 10);
+        std::iota(signal.begin(), signal.end(), std::int16_t(i));
+        return signal;
+    };
+
+    // Reads numbered from [first_read], with pore and run info names of [suffix]:
+    std::vector<pod5::Uuid> added_read_ids;
+    auto add_reads = [&](pod5::FileWriter & writer,
+                         std::size_t first_read,
+                         std::size_t count,
+                         std::string const & suffix) {
+        auto run_info = writer.add_run_info(get_test_run_info_data(suffix));
+        REQUIRE_ARROW_STATUS_OK(run_info);
+        auto end_reason = writer.lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = writer.add_pore_type("pore_type" + suffix);
+        REQUIRE_ARROW_STATUS_OK(pore_type);
+        for (std::size_t i = first_read; i < first_read + count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = std::uint32_t(i);
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(writer.add_complete_read(read_data, gsl::make_span(signal)));
+            added_read_ids.push_back(read_data.read_id);
+        }
+    };
+
+    pod5::FileWriterOptions options;
+    options.set_signal_table_batch_size(3);
+    options.set_read_table_batch_size(4);
+    options.set_page_align_signal_batches(page_align_signal_batches);
+
+    // 10 reads leave a short last signal batch, which the appended reads must fill first:
+    std::size_t const original_read_count = 10;
+    {
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        add_reads(**writer, 0, original_read_count, "_first");
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    pod5::Uuid file_identifier;
+    std::vector<std::uint8_t> original_signal_bytes;
+    std::size_t original_signal_batch_count = 0;
+    {
+        auto reader = pod5::open_file_reader(file);
+        REQUIRE_ARROW_STATUS_OK(reader);
+        file_identifier = (*reader)->schema_metadata().file_identifier;
+        auto const & batches = (*reader)->signal_table_batch_locations();
+        original_signal_batch_count = batches.size();
+        REQUIRE(original_signal_batch_count == 4);
+        // The full batches, before the short last batch:
+        auto const & last_full_batch = batches[original_signal_batch_count - 2];
+        auto const signal_batches_end = (*reader)->signal_table_location().offset
+                                        + last_full_batch.offset + last_full_batch.length();
+        original_signal_bytes.resize(signal_batches_end);
+        std::ifstream in(file, std::ios::binary);
+        in.read(
+            reinterpret_cast<char *>(original_signal_bytes.data()), original_signal_bytes.size());
+        REQUIRE(in);
+    }
+
+    WHEN("Appending to a file with signal summaries")
+    {
+        auto summaries_options = options;
+        summaries_options.set_signal_summary_decimations({16});
+        auto writer = pod5::open_file_writer_for_append(file, "test_software", summaries_options);
+        THEN("The writer isn't opened, and the file is left readable")
+        {
+            CHECK_FALSE(writer.ok());
+            CHECK(pod5::open_file_reader(file).ok());
+        }
+    }
+
+    WHEN("Reads are appended to the file")
+    {
+        std::size_t const appended_read_count = 7;
+        {
+            auto writer = pod5::open_file_writer_for_append(file, "test_software", options);
+            REQUIRE_ARROW_STATUS_OK(writer);
+            // Reads of the file's pore and run info share its dictionary entries:
+            add_reads(**writer, original_read_count, 2, "_first");
+            add_reads(**writer, original_read_count + 2, appended_read_count - 2, "_second");
+            REQUIRE_ARROW_STATUS_OK((*writer)->close());
+        }
+
+        THEN("The file holds the original reads followed by the appended ones")
+        {
+            auto reader = pod5::open_file_reader(file);
+            REQUIRE_ARROW_STATUS_OK(reader);
+            REQUIRE_ARROW_STATUS_OK(pod5::verify_file(**reader));
+            CHECK((*reader)->schema_metadata().file_identifier == file_identifier);
+            CHECK(*(*reader)->get_run_info_count() == 2);
+            CHECK((*reader)->signal_table_batch_locations().size() > original_signal_batch_count);
+
+            std::vector<pod5::Uuid> read_ids;
+            for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
+                auto batch = (*reader)->read_read_record_batch(i);
+                REQUIRE_ARROW_STATUS_OK(batch);
+                auto const view = batch->view();
+                for (std::int64_t row = 0; row < view.num_rows; ++row) {
+                    auto const read_number = view.read_number[row];
+                    CAPTURE(read_number);
+                    read_ids.push_back(view.read_id[row]);
+                    auto const suffix =
+                        read_number < original_read_count + 2 ? "_first" : "_second";
+                    auto const pore_type = batch->get_pore_type(view.pore_type[row]);
+                    REQUIRE_ARROW_STATUS_OK(pore_type);
+                    CHECK(*pore_type == std::string("pore_type") + suffix);
+                    auto const run_info = batch->get_run_info(view.run_info[row]);
+                    REQUIRE_ARROW_STATUS_OK(run_info);
+                    CHECK(*run_info == std::string("acquisition_id") + suffix);
+
+                    auto const expected = signal_for_read(read_number);
+                    std::vector<std::int16_t> samples(expected.size());
+                    REQUIRE_ARROW_STATUS_OK(
+                        (*reader)->extract_samples(view.signal[row], gsl::make_span(samples)));
+                    CHECK(samples == expected);
+                }
+            }
+            CHECK(read_ids == added_read_ids);
+        }
+
+        THEN("Signal batches hold the rows of the first, and are read back by row")
+        {
+            auto reader = pod5::open_file_reader(file);
+            REQUIRE_ARROW_STATUS_OK(reader);
+            auto const batch_count = (*reader)->num_signal_record_batches();
+            std::size_t const read_count = original_read_count + appended_read_count;
+            REQUIRE(batch_count == (read_count + 2) / 3);
+            for (std::size_t i = 0; i < batch_count; ++i) {
+                CAPTURE(i);
+                auto const batch = (*reader)->read_signal_record_batch(i);
+                REQUIRE_ARROW_STATUS_OK(batch);
+                CHECK(batch->num_rows() == (i + 1 < batch_count ? 3 : read_count - i * 3));
+            }
+
+            // Reads were added in order, one signal row each, so row n is read n's signal:
+            for (std::uint64_t row = 0; row < read_count; ++row) {
+                CAPTURE(row);
+                auto const expected = signal_for_read(row);
+                std::vector<std::int16_t> samples(expected.size());
+                std::vector<std::uint64_t> const rows{row};
+                REQUIRE_ARROW_STATUS_OK(
+                    (*reader)->extract_samples(gsl::make_span(rows), gsl::make_span(samples)));
+                CHECK(samples == expected);
+            }
+        }
+
+        THEN("The original full signal batches are left as they were")
+        {
+            std::vector<std::uint8_t> signal_bytes(original_signal_bytes.size());
+            std::ifstream in(file, std::ios::binary);
+            in.read(reinterpret_cast<char *>(signal_bytes.data()), signal_bytes.size());
+            REQUIRE(in);
+            CHECK(signal_bytes == original_signal_bytes);
+        }
+    }
+
+#ifdef __linux__
+    WHEN("An append writer is dropped without being closed")
+    {
+        std::size_t const appended_read_count = 7;
+        auto const child = fork();
+        REQUIRE(child >= 0);
+        if (child == 0) {
+            // Catch isn't fork safe, so the child only reports through its exit code. It exits
+            // as a crashing process would, without the writer's destructor closing it:
+            auto writer = pod5::open_file_writer_for_append(file, "test_software", options);
+            if (!writer.ok()) {
+                _exit(1);
+            }
+            auto run_info = (*writer)->add_run_info(get_test_run_info_data("_second"));
+            auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+            auto pore_type = (*writer)->add_pore_type("pore_type_second");
+            bool passed = run_info.ok() && end_reason.ok() && pore_type.ok();
+            for (std::size_t i = 0; passed && i < appended_read_count; ++i) {
+                pod5::ReadData read_data;
+                read_data.read_id = uuid_gen();
+                read_data.read_number = std::uint32_t(original_read_count + i);
+                read_data.pore_type = *pore_type;
+                read_data.end_reason = *end_reason;
+                read_data.run_info = *run_info;
+                auto const signal = signal_for_read(original_read_count + i);
+                passed = (*writer)->add_complete_read(read_data, gsl::make_span(signal)).ok();
+            }
+            // Full signal batches are written out before the writer is abandoned:
+            passed = passed && (*writer)->flush().ok();
+            _exit(passed ? 0 : 1);
+        }
+        int child_status = 0;
+        REQUIRE(waitpid(child, &child_status, 0) == child);
+        CHECK(WIFEXITED(child_status));
+        CHECK(WEXITSTATUS(child_status) == 0);
+
+        THEN("The file still opens, holding only its original reads")
+        {
+            auto reader = pod5::open_file_reader(file);
+            REQUIRE_ARROW_STATUS_OK(reader);
+            REQUIRE_ARROW_STATUS_OK(pod5::verify_file(**reader));
+            CHECK((*reader)->schema_metadata().file_identifier == file_identifier);
+            CHECK((*reader)->signal_table_batch_locations().size() == original_signal_batch_count);
+
+            std::vector<pod5::Uuid> read_ids;
+            for (std::size_t i = 0; i < (*reader)->num_read_record_batches(); ++i) {
+                auto batch = (*reader)->read_read_record_batch(i);
+                REQUIRE_ARROW_STATUS_OK(batch);
+                auto const view = batch->view();
+                for (std::int64_t row = 0; row < view.num_rows; ++row) {
+                    read_ids.push_back(view.read_id[row]);
+                }
+            }
+            CHECK(read_ids == added_read_ids);
+        }
+
+        // The abandoned writer's staged tables are left beside the file:
+        auto const tmp_prefix = "." + to_string(file_identifier) + ".tmp-";
+        for (auto const & entry : std::filesystem::directory_iterator(".")) {
+            if (entry.path().filename().string().rfind(tmp_prefix, 0) == 0) {
+                std::filesystem::remove(entry.path());
+            }
+        }
+    }
+#endif
 }
@@ -0,0 +1,204 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_stream_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/array/array_binary.h>
+#include <arrow/io/file.h>
+#include <catch2/catch.hpp>
+
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Reads another stream without seeking or reporting its position, like a pipe, optionally ending
+// after [limit] bytes.
+class NonSeekableStream : public arrow::io::InputStream {
+public:
+    NonSeekableStream(std::shared_ptr<arrow::io::InputStream> input, std::int64_t limit = -1)
+    : m_input(std::move(input))
+    , m_remaining(limit)
+    {
+    }
+
+    arrow::Status Close() override { return m_input->Close(); }
+
+    bool closed() const override { return m_input->closed(); }
+
+    arrow::Result<std::int64_t> Tell() const override
+    {
+        return arrow::Status::NotImplemented("Stream can't report its position");
+    }
+
+    arrow::Result<std::int64_t> Read(std::int64_t nbytes, void * out) override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto const read, m_input->Read(limit(nbytes), out));
+        m_remaining -= m_remaining >= 0 ? read : 0;
+        return read;
+    }
+
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Read(std::int64_t nbytes) override
+    {
+        ARROW_ASSIGN_OR_RAISE(auto buffer, m_input->Read(limit(nbytes)));
+        m_remaining -= m_remaining >= 0 ? buffer->size() : 0;
+        return buffer;
+    }
+
+private:
+    std::int64_t limit(std::int64_t nbytes) const
+    {
+        return m_remaining >= 0 ? std::min(nbytes, m_remaining) : nbytes;
+    }
+
+    std::shared_ptr<arrow::io::InputStream> m_input;
+    std::int64_t m_remaining;
+};
+
+pod5::Result<std::unique_ptr<pod5::FileStreamReader>> open_stream(
+    char const * file,
+    std::int64_t limit = -1)
+{
+    ARROW_ASSIGN_OR_RAISE(auto input, arrow::io::ReadableFile::Open(file));
+    return pod5::open_file_stream_reader(std::make_shared<NonSeekableStream>(input, limit));
+}
+
+}  // namespace
+
+SCENARIO("Streaming a file front to back")
+{
+    static constexpr char const * file = "./stream_reader.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const signal_type =
+        GENERATE(pod5::SignalType::UncompressedSignal, pod5::SignalType::VbzSignal);
+    CAPTURE(signal_type);
+
+    auto signal_for_read = [](std::size_t i) {
+        std::vector<std::int16_t> signal(100 + i * 10);
+        std::iota(signal.begin(), signal.end(), std::int16_t(i * 100));
+        return signal;
+    };
+
+    std::size_t const read_count = 10;
+    std::vector<pod5::Uuid> read_ids;
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_type(signal_type);
+        options.set_signal_table_batch_size(3);
+        options.set_read_table_batch_size(4);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            read_ids.push_back(read_data.read_id);
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    GIVEN("A stream reader over the file")
+    {
+        auto reader = open_stream(file);
+        REQUIRE_ARROW_STATUS_OK(reader);
+        CHECK((*reader)->schema_metadata().writing_software == "test_software");
+
+        THEN("Every table can be read in turn")
+        {
+            std::size_t signal_rows = 0;
+            while (true) {
+                auto batch = (*reader)->read_next_signal_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                if (!*batch) {
+                    break;
+                }
+                auto const read_id_column = (*batch)->read_id_column();
+                for (std::size_t row = 0; row < (*batch)->num_rows(); ++row, ++signal_rows) {
+                    CHECK(read_id_column->Value(row) == read_ids[signal_rows]);
+                    auto const expected = signal_for_read(signal_rows);
+                    std::vector<std::int16_t> samples(expected.size());
+                    REQUIRE_ARROW_STATUS_OK(
+                        (*batch)->extract_signal_row(row, gsl::make_span(samples)));
+                    CHECK(samples == expected);
+                }
+            }
+            CHECK(signal_rows == read_count);
+
+            auto run_info_batch = (*reader)->read_next_run_info_batch();
+            REQUIRE_ARROW_STATUS_OK(run_info_batch);
+            REQUIRE(*run_info_batch);
+            auto run_info_columns = (*run_info_batch)->columns();
+            REQUIRE_ARROW_STATUS_OK(run_info_columns);
+            REQUIRE(run_info_columns->acquisition_id->length() == 1);
+            CHECK(
+                run_info_columns->acquisition_id->GetString(0)
+                == get_test_run_info_data().acquisition_id);
+
+            std::vector<pod5::Uuid> streamed_read_ids;
+            while (true) {
+                auto batch = (*reader)->read_next_read_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                if (!*batch) {
+                    break;
+                }
+                auto const read_id_column = (*batch)->read_id_column();
+                for (std::size_t row = 0; row < (*batch)->num_rows(); ++row) {
+                    streamed_read_ids.push_back(read_id_column->Value(row));
+                }
+            }
+            CHECK(streamed_read_ids == read_ids);
+
+            // Earlier tables can't be returned to:
+            auto signal_batch = (*reader)->read_next_signal_batch();
+            REQUIRE_ARROW_STATUS_OK(signal_batch);
+            CHECK(!*signal_batch);
+        }
+
+        THEN("Reads can be streamed skipping the signal")
+        {
+            std::size_t read_rows = 0;
+            while (true) {
+                auto batch = (*reader)->read_next_read_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                if (!*batch) {
+                    break;
+                }
+                read_rows += (*batch)->num_rows();
+            }
+            CHECK(read_rows == read_count);
+        }
+    }
+
+    GIVEN("A stream ending part way through the read table")
+    {
+        auto file_reader = pod5::open_file_reader(file, {});
+        REQUIRE_ARROW_STATUS_OK(file_reader);
+        auto const & read_table = (*file_reader)->read_table_location();
+        auto reader = open_stream(file, read_table.offset + read_table.size / 2);
+        REQUIRE_ARROW_STATUS_OK(reader);
+
+        THEN("Reading the read table fails")
+        {
+            CHECK_ARROW_STATUS_NOT_OK((*reader)->read_next_read_batch());
+        }
+    }
+}
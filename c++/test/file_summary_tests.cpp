@@ -0,0 +1,104 @@
+#include "pod5_format/c_api.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_summary.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/memory_pool.h>
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+SCENARIO("File summary embedded in a file")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_file_summary = GENERATE(true, false);
+    CAPTURE(write_file_summary);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_write_file_summary(write_file_summary);
+        options.set_read_table_batch_size(6);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info_a = (*writer)->add_run_info(get_test_run_info_data("_a"));
+        auto run_info_b = (*writer)->add_run_info(get_test_run_info_data("_b"));
+        REQUIRE_ARROW_STATUS_OK((*writer)->add_run_info(get_test_run_info_data("_unused")));
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        // Even reads are in run info a, odd reads in run info b, starting a second apart:
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < 20; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.start_sample = i * 4000;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = i % 2 ? *run_info_b : *run_info_a;
+            auto const read_signal = gsl::make_span(signal).subspan(0, i % 2 ? 50 : 100);
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, read_signal));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto summary = pod5::open_file_summary(file, arrow::default_memory_pool());
+    REQUIRE_ARROW_STATUS_OK(summary);
+    if (!write_file_summary) {
+        CHECK(!*summary);
+        return;
+    }
+
+    REQUIRE(*summary);
+    CHECK((*summary)->read_count() == 20);
+    CHECK((*summary)->sample_count() == 1500);
+    CHECK((*summary)->signal_bytes() > 0);
+
+    auto const & run_infos = (*summary)->run_infos();
+    REQUIRE(run_infos.size() == 3);
+    CHECK(run_infos[0].acquisition_id == "acquisition_id_a");
+    CHECK(run_infos[0].read_count == 10);
+    CHECK(run_infos[0].sample_count == 1000);
+    CHECK(run_infos[0].min_start_sample == 0);
+    CHECK(run_infos[0].max_start_sample == 18 * 4000);
+    CHECK(run_infos[1].acquisition_id == "acquisition_id_b");
+    CHECK(run_infos[1].read_count == 10);
+    CHECK(run_infos[1].sample_count == 500);
+    CHECK(run_infos[1].min_start_sample == 4000);
+    CHECK(run_infos[1].max_start_sample == 19 * 4000);
+    CHECK(run_infos[1].acquisition_start_time == 1005);
+    CHECK(run_infos[1].sample_rate == 4000);
+    CHECK(run_infos[2].acquisition_id == "acquisition_id_unused");
+    CHECK(run_infos[2].read_count == 0);
+
+    CHECK((*summary)->min_start_time() == 1005);
+    CHECK((*summary)->max_start_time() == 1005 + 19 * 1000);
+
+    // The C API reads the same summary:
+    Pod5FileSummary_t c_summary{};
+    std::uint8_t has_summary = 0;
+    REQUIRE(pod5_read_file_summary(file, &c_summary, &has_summary) == POD5_OK);
+    CHECK(has_summary == 1);
+    CHECK(c_summary.read_count == 20);
+    CHECK(c_summary.sample_count == 1500);
+    CHECK(c_summary.run_info_count == 3);
+    CHECK(c_summary.has_start_times == 1);
+
+    // The file must still open with the summary present:
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    CHECK((*reader)->num_read_record_batches() == 4);
+}
@@ -0,0 +1,111 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_tail_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+SCENARIO("Tailing the signal table of a file being written")
+{
+    static constexpr char const * file = "./tail_reader.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const checkpoint_interval = GENERATE(std::size_t(0), std::size_t(1));
+    CAPTURE(checkpoint_interval);
+
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(50 + i, std::int16_t(i));
+    };
+
+    pod5::FileWriterOptions options;
+    options.set_signal_table_batch_size(2);
+    options.set_recovery_checkpoint_interval(checkpoint_interval);
+    // Flush every add, so written batches reach the file:
+    options.set_max_unflushed_bytes(1);
+
+    auto writer = pod5::create_file_writer(file, "test_software", options);
+    REQUIRE_ARROW_STATUS_OK(writer);
+    auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+    auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::vector<pod5::Uuid> read_ids;
+    auto add_reads = [&](std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = read_ids.size();
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(read_ids.size());
+            read_ids.push_back(read_data.read_id);
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+    };
+
+    // Checks [batches] hold the rows following the [row_count] already tailed:
+    auto check_batches = [&](std::vector<pod5::SignalTableRecordBatch> const & batches,
+                             std::size_t row_count) {
+        for (auto const & batch : batches) {
+            auto const read_id_column = batch.read_id_column();
+            for (std::size_t row = 0; row < batch.num_rows(); ++row, ++row_count) {
+                CHECK(read_id_column->Value(row) == read_ids[row_count]);
+                auto const expected = signal_for_read(row_count);
+                std::vector<std::int16_t> samples(expected.size());
+                REQUIRE_ARROW_STATUS_OK(batch.extract_signal_row(row, gsl::make_span(samples)));
+                CHECK(samples == expected);
+            }
+        }
+        return row_count;
+    };
+
+    // Two whole batches and part of a third are written:
+    add_reads(5);
+
+    auto reader = pod5::open_file_tail_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    CHECK((*reader)->schema_metadata().writing_software == "test_software");
+
+    auto batches = (*reader)->poll_signal_batches();
+    REQUIRE_ARROW_STATUS_OK(batches);
+    // The second batch is only known to be whole if it was checkpointed, or if it ends the file
+    // where the writer reserves no space ahead:
+    if (checkpoint_interval > 0) {
+        CHECK(batches->size() == 2);
+    } else {
+        CHECK(batches->size() >= 1);
+    }
+    CHECK(check_batches(*batches, 0) == (*reader)->signal_row_count());
+    CHECK(!(*reader)->signal_table_complete());
+
+    // Nothing new has been written:
+    auto const tailed_rows = (*reader)->signal_row_count();
+    batches = (*reader)->poll_signal_batches();
+    REQUIRE_ARROW_STATUS_OK(batches);
+    CHECK(batches->empty());
+
+    add_reads(4);
+    REQUIRE_ARROW_STATUS_OK((*writer)->close());
+
+    // Closing the file writes the last batches and ends the table:
+    batches = (*reader)->poll_signal_batches();
+    REQUIRE_ARROW_STATUS_OK(batches);
+    CHECK(check_batches(*batches, tailed_rows) == read_ids.size());
+    CHECK((*reader)->signal_row_count() == read_ids.size());
+    CHECK((*reader)->signal_table_complete());
+
+    batches = (*reader)->poll_signal_batches();
+    REQUIRE_ARROW_STATUS_OK(batches);
+    CHECK(batches->empty());
+}
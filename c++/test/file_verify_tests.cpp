@@ -0,0 +1,222 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_verify.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/signal_compression.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TestFileWriter {
+    TestFileWriter(char const * file, pod5::FileWriterOptions const & options)
+    : writer(pod5::create_file_writer(file, "test_software", options))
+    {
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        REQUIRE_ARROW_STATUS_OK(run_info);
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        REQUIRE_ARROW_STATUS_OK(end_reason);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+        REQUIRE_ARROW_STATUS_OK(pore_type);
+
+        read_data.run_info = *run_info;
+        read_data.end_reason = *end_reason;
+        read_data.pore_type = *pore_type;
+    }
+
+    pod5::ReadData next_read(pod5::UuidRandomGenerator & uuid_gen)
+    {
+        read_data.read_id = uuid_gen();
+        read_data.read_number += 1;
+        return read_data;
+    }
+
+    pod5::Result<std::unique_ptr<pod5::FileWriter>> writer;
+    pod5::ReadData read_data;
+};
+
+std::vector<std::int16_t> random_signal(std::mt19937 & gen, std::size_t sample_count)
+{
+    std::uniform_int_distribution<std::int16_t> dist{0, 1000};
+    std::vector<std::int16_t> signal(sample_count);
+    std::generate(signal.begin(), signal.end(), [&] { return dist(gen); });
+    return signal;
+}
+
+}  // namespace
+
+SCENARIO("Verifying an intact file")
+{
+    static constexpr char const * file = "./verify_intact.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const signal_type =
+        GENERATE(pod5::SignalType::UncompressedSignal, pod5::SignalType::VbzSignal);
+    auto const write_checksums = GENERATE(true, false);
+    CAPTURE(signal_type, write_checksums);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::uint64_t sample_count = 0;
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_type(signal_type);
+        options.set_write_signal_checksums(write_checksums);
+        options.set_max_signal_chunk_size(1000);
+        options.set_signal_table_batch_size(5);
+        options.set_read_table_batch_size(4);
+        TestFileWriter test_writer(file, options);
+        auto & writer = **test_writer.writer;
+
+        // Reads of several chunks span signal batches:
+        for (std::size_t i = 0; i < 20; ++i) {
+            auto const signal = random_signal(gen, 500 + i * 150);
+            sample_count += signal.size();
+            CHECK_ARROW_STATUS_OK(
+                writer.add_complete_read(test_writer.next_read(uuid_gen), gsl::make_span(signal)));
+        }
+        REQUIRE_ARROW_STATUS_OK(writer.close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    pod5::FileVerifyOptions options;
+    options.set_thread_pool(pod5::make_thread_pool(3));
+    auto report = pod5::verify_file(**reader, options);
+    REQUIRE_ARROW_STATUS_OK(report);
+    CHECK(report->read_count == 20);
+    CHECK(report->read_table_batch_count == (*reader)->num_read_record_batches());
+    CHECK(report->signal_table_batch_count == (*reader)->num_signal_record_batches());
+    CHECK(report->signal_table_batch_count > 1);
+    CHECK(report->sample_count == sample_count);
+    CHECK(report->signal_row_count > report->read_count);
+    CHECK(report->checksummed_signal_rows == (write_checksums ? report->signal_row_count : 0));
+    auto const vbz = signal_type == pod5::SignalType::VbzSignal;
+    CHECK(report->checked_signal_frames == (vbz ? report->signal_row_count : 0));
+
+    // Checks can be skipped, and the default pool used:
+    options = {};
+    options.set_check_signal_checksums(false);
+    options.set_check_compressed_frames(false);
+    report = pod5::verify_file(**reader, options);
+    REQUIRE_ARROW_STATUS_OK(report);
+    CHECK(report->sample_count == sample_count);
+    CHECK(report->checksummed_signal_rows == 0);
+    CHECK(report->checked_signal_frames == 0);
+}
+
+SCENARIO("Verifying files whose reads don't match their signal")
+{
+    static constexpr char const * file = "./verify_mismatch.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const bad_signal_row = GENERATE(true, false);
+    CAPTURE(bad_signal_row);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    {
+        TestFileWriter test_writer(file, pod5::FileWriterOptions{});
+        auto & writer = **test_writer.writer;
+        auto const signal = random_signal(gen, 1000);
+        CHECK_ARROW_STATUS_OK(
+            writer.add_complete_read(test_writer.next_read(uuid_gen), gsl::make_span(signal)));
+
+        auto read_data = test_writer.next_read(uuid_gen);
+        auto rows = writer.add_signal(read_data.read_id, gsl::make_span(signal));
+        REQUIRE_ARROW_STATUS_OK(rows);
+        if (bad_signal_row) {
+            rows->push_back(1000);
+            CHECK_ARROW_STATUS_OK(
+                writer.add_complete_read(read_data, gsl::make_span(*rows), signal.size()));
+        } else {
+            CHECK_ARROW_STATUS_OK(
+                writer.add_complete_read(read_data, gsl::make_span(*rows), signal.size() + 1));
+        }
+        REQUIRE_ARROW_STATUS_OK(writer.close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    auto const report = pod5::verify_file(**reader);
+    REQUIRE(!report.ok());
+    CHECK(report.status().IsIOError());
+    auto const & message = report.status().message();
+    CHECK(message.find("Read batch 0: row 1: ") == 0);
+    CHECK(message.find(bad_signal_row ? "outside the signal table" : "num_samples is 1001")
+          != std::string::npos);
+}
+
+SCENARIO("Verifying a file with corrupt signal")
+{
+    static constexpr char const * file = "./verify_corrupt.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    {
+        pod5::FileWriterOptions options;
+        options.set_write_signal_checksums(true);
+        TestFileWriter test_writer(file, options);
+        auto & writer = **test_writer.writer;
+        auto const signal = random_signal(gen, 1000);
+        CHECK_ARROW_STATUS_OK(
+            writer.add_complete_read(test_writer.next_read(uuid_gen), gsl::make_span(signal)));
+        REQUIRE_ARROW_STATUS_OK(writer.close());
+    }
+
+    // A byte in the middle of the read's zstd frame is flipped:
+    std::string contents;
+    {
+        std::ifstream in(file, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto const frame = contents.find("\x28\xb5\x2f\xfd");
+    REQUIRE(frame != std::string::npos);
+    contents[frame + 100] ^= 0x55;
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), contents.size());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    auto const report = pod5::verify_file(**reader);
+    REQUIRE(!report.ok());
+    CHECK(report.status().message().find("Signal batch 0: row 0: ") == 0);
+}
+
+SCENARIO("Checking compressed signal frames")
+{
+    std::mt19937 gen{Catch::rngSeed()};
+    auto const signal = random_signal(gen, 1000);
+    auto compressed = pod5::compress_signal(gsl::make_span(signal), arrow::default_memory_pool());
+    REQUIRE_ARROW_STATUS_OK(compressed);
+    auto const bytes = gsl::make_span((*compressed)->data(), (*compressed)->size());
+
+    CHECK_ARROW_STATUS_OK(pod5::check_compressed_signal_frame(bytes, signal.size()));
+    // The frame can't hold the encoded bytes of a different sample count:
+    CHECK(!pod5::check_compressed_signal_frame(bytes, signal.size() * 2).ok());
+    // Nor can a truncated frame be decompressed:
+    CHECK(!pod5::check_compressed_signal_frame(bytes.subspan(0, bytes.size() - 1), signal.size())
+               .ok());
+}
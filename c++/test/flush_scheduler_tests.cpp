@@ -0,0 +1,95 @@
+#include "pod5_format/internal/flush_scheduler.h"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using pod5::internal::FlushScheduler;
+
+TEST_CASE("Flush scheduler flushes once unflushed bytes cross the threshold", "[flush_scheduler]")
+{
+    FlushScheduler scheduler(
+        std::chrono::milliseconds(0), 100, pod5::make_thread_pool(1), [] { return false; });
+
+    CHECK(!scheduler.is_flush_due(0));
+    CHECK(!scheduler.is_flush_due(99));
+    CHECK(scheduler.is_flush_due(100));
+
+    scheduler.flushed(100);
+    CHECK(!scheduler.is_flush_due(100));
+    CHECK(!scheduler.is_flush_due(150));
+    CHECK(scheduler.is_flush_due(250));
+}
+
+TEST_CASE("Flush scheduler flushes once a deadline expires", "[flush_scheduler]")
+{
+    std::mutex writer;
+    std::size_t bytes_written = 0;
+    std::atomic<std::size_t> flush_count{0};
+
+    FlushScheduler * scheduler_ptr = nullptr;
+    FlushScheduler scheduler(
+        std::chrono::milliseconds(20), 0, pod5::make_thread_pool(1), [&] {
+            std::unique_lock<std::mutex> l(writer, std::try_to_lock);
+            if (!l.owns_lock()) {
+                return false;
+            }
+            scheduler_ptr->flushed(bytes_written);
+            flush_count += 1;
+            return true;
+        });
+    scheduler_ptr = &scheduler;
+
+    SECTION("With the writer idle, the deadline is flushed on the pool")
+    {
+        {
+            std::lock_guard<std::mutex> l(writer);
+            bytes_written = 10;
+            CHECK(!scheduler.is_flush_due(bytes_written));
+        }
+
+        auto const give_up = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (flush_count == 0 && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(flush_count == 1);
+
+        std::lock_guard<std::mutex> l(writer);
+        CHECK(!scheduler.is_flush_due(bytes_written));
+    }
+
+    SECTION("With the writer busy, its next call flushes")
+    {
+        std::lock_guard<std::mutex> l(writer);
+        bytes_written = 10;
+        CHECK(!scheduler.is_flush_due(bytes_written));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        CHECK(scheduler.is_flush_due(bytes_written));
+        scheduler.flushed(bytes_written);
+        CHECK(!scheduler.is_flush_due(bytes_written));
+        CHECK(flush_count == 0);
+
+        scheduler.stop();
+    }
+}
+
+TEST_CASE("Flush scheduler stops waiting for deadlines", "[flush_scheduler]")
+{
+    std::atomic<std::size_t> flush_count{0};
+    FlushScheduler scheduler(std::chrono::hours(1), 0, pod5::make_thread_pool(1), [&] {
+        flush_count += 1;
+        return false;
+    });
+
+    CHECK(!scheduler.is_flush_due(10));
+
+    // Stopping doesn't wait for the deadline:
+    auto const start = std::chrono::steady_clock::now();
+    scheduler.stop();
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::minutes(1));
+    CHECK(flush_count == 0);
+}
@@ -0,0 +1,180 @@
+#include "pod5_format/internal/io_uring_ring.h"
+
+#include <catch2/catch.hpp>
+
+#ifdef POD5_HAS_IO_URING
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct RingTestFile {
+    RingTestFile(std::size_t size) : data(size)
+    {
+        std::iota(data.begin(), data.end(), std::uint8_t(0));
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<char const *>(data.data()), data.size());
+        out.close();
+        fd = open(path, O_RDONLY);
+    }
+
+    ~RingTestFile()
+    {
+        close(fd);
+        std::remove(path);
+    }
+
+    char const * path = "./io_uring_ring_test.bin";
+    std::vector<std::uint8_t> data;
+    int fd = -1;
+};
+
+}  // namespace
+
+TEST_CASE("io_uring ring reads", "[io_uring]")
+{
+    auto ring = pod5::io_uring::IoUringRing::create(8);
+    if (!ring.ok()) {
+        WARN("Skipping io_uring tests: " << ring.status().ToString());
+        return;
+    }
+
+    RingTestFile file(1024 * 1024);
+    REQUIRE(file.fd >= 0);
+
+    SECTION("Many reads in flight at once, more than the queue depth")
+    {
+        std::size_t const read_count = 200;
+        std::size_t const read_size = 4096;
+        std::vector<std::vector<std::uint8_t>> outputs(read_count);
+        std::vector<std::promise<std::int64_t>> results(read_count);
+
+        std::vector<pod5::io_uring::ReadRequest> requests;
+        for (std::size_t i = 0; i < read_count; ++i) {
+            outputs[i].resize(read_size);
+            auto const offset = (i * 7919 * 64) % (file.data.size() - read_size);
+            requests.push_back(
+                {file.fd, offset, outputs[i].data(), read_size, [&results, i](std::int64_t res) {
+                     results[i].set_value(res);
+                 }});
+        }
+        REQUIRE((*ring)->submit_reads(std::move(requests)).ok());
+
+        for (std::size_t i = 0; i < read_count; ++i) {
+            CAPTURE(i);
+            CHECK(results[i].get_future().get() == std::int64_t(read_size));
+            auto const offset = (i * 7919 * 64) % (file.data.size() - read_size);
+            CHECK(std::equal(outputs[i].begin(), outputs[i].end(), file.data.begin() + offset));
+        }
+    }
+
+    SECTION("Reads from many threads")
+    {
+        std::atomic<std::size_t> good_reads{0};
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 8; ++t) {
+            threads.emplace_back([&, t] {
+                for (std::size_t i = 0; i < 50; ++i) {
+                    std::vector<std::uint8_t> output(100);
+                    std::promise<std::int64_t> result;
+                    auto const offset = t * 1000 + i;
+                    std::vector<pod5::io_uring::ReadRequest> requests{
+                        {file.fd, offset, output.data(), output.size(), [&](std::int64_t res) {
+                             result.set_value(res);
+                         }}};
+                    if ((*ring)->submit_reads(std::move(requests)).ok()
+                        && result.get_future().get() == 100
+                        && std::equal(output.begin(), output.end(), file.data.begin() + offset))
+                    {
+                        good_reads += 1;
+                    }
+                }
+            });
+        }
+        for (auto & thread : threads) {
+            thread.join();
+        }
+        CHECK(good_reads == 8 * 50);
+    }
+
+    SECTION("Reads past the end of the file are short")
+    {
+        std::vector<std::uint8_t> output(4096);
+        std::promise<std::int64_t> result;
+        std::vector<pod5::io_uring::ReadRequest> requests{
+            {file.fd, file.data.size() - 100, output.data(), output.size(), [&](std::int64_t res) {
+                 result.set_value(res);
+             }}};
+        REQUIRE((*ring)->submit_reads(std::move(requests)).ok());
+        CHECK(result.get_future().get() == 100);
+    }
+
+    SECTION("Reads of an invalid file fail")
+    {
+        std::vector<std::uint8_t> output(16);
+        std::promise<std::int64_t> result;
+        std::vector<pod5::io_uring::ReadRequest> requests{
+            {-1, 0, output.data(), output.size(), [&](std::int64_t res) {
+                 result.set_value(res);
+             }}};
+        REQUIRE((*ring)->submit_reads(std::move(requests)).ok());
+        CHECK(result.get_future().get() == -EBADF);
+    }
+}
+
+TEST_CASE("io_uring ring writes", "[io_uring]")
+{
+    auto ring = pod5::io_uring::IoUringRing::create(8);
+    if (!ring.ok()) {
+        WARN("Skipping io_uring tests: " << ring.status().ToString());
+        return;
+    }
+
+    char const * path = "./io_uring_ring_write_test.bin";
+    int const fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    REQUIRE(fd >= 0);
+
+    // Write more blocks than the queue depth, all in flight at once:
+    std::size_t const write_count = 100;
+    std::size_t const write_size = 4096;
+    std::vector<std::vector<std::uint8_t>> inputs(write_count);
+    std::vector<std::promise<std::int64_t>> results(write_count);
+    std::vector<pod5::io_uring::WriteRequest> requests;
+    for (std::size_t i = 0; i < write_count; ++i) {
+        inputs[i].assign(write_size, std::uint8_t(i));
+        requests.push_back(
+            {fd, i * write_size, inputs[i].data(), write_size, [&results, i](std::int64_t res) {
+                 results[i].set_value(res);
+             }});
+    }
+    REQUIRE((*ring)->submit_writes(std::move(requests)).ok());
+    for (auto & result : results) {
+        CHECK(result.get_future().get() == std::int64_t(write_size));
+    }
+    close(fd);
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<std::uint8_t> contents(
+        (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::remove(path);
+    REQUIRE(contents.size() == write_count * write_size);
+    for (std::size_t i = 0; i < write_count; ++i) {
+        CHECK(std::all_of(
+            contents.begin() + i * write_size,
+            contents.begin() + (i + 1) * write_size,
+            [i](std::uint8_t value) { return value == std::uint8_t(i); }));
+    }
+}
+
+#endif
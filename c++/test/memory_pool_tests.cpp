@@ -0,0 +1,216 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/memory_pool.h"
+#include "test_utils.h"
+
+#include <arrow/buffer.h>
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+SCENARIO("Recycling memory pool")
+{
+    auto const upstream = arrow::system_memory_pool();
+    auto const upstream_bytes = upstream->bytes_allocated();
+    std::size_t const max_cached_bytes = 100'000;
+    pod5::RecyclingMemoryPool pool(upstream, max_cached_bytes);
+
+    GIVEN("A freed allocation")
+    {
+        std::uint8_t const * first_data = nullptr;
+        {
+            auto buffer = arrow::AllocateResizableBuffer(10'000, &pool);
+            REQUIRE_ARROW_STATUS_OK(buffer);
+            first_data = (*buffer)->data();
+        }
+        CHECK(pool.cached_bytes() >= 10'000);
+
+        THEN("An allocation of a similar size reuses it")
+        {
+            auto buffer = arrow::AllocateResizableBuffer(9'000, &pool);
+            REQUIRE_ARROW_STATUS_OK(buffer);
+            CHECK((*buffer)->data() == first_data);
+            CHECK(pool.recycled_allocations() == 1);
+            CHECK(pool.cached_bytes() == 0);
+
+            // Growing within the recycled allocation keeps it in place:
+            REQUIRE_ARROW_STATUS_OK((*buffer)->Resize(10'000));
+            CHECK((*buffer)->data() == first_data);
+        }
+
+        THEN("Much smaller allocations don't hold on to it")
+        {
+            auto buffer = arrow::AllocateResizableBuffer(4'096, &pool);
+            REQUIRE_ARROW_STATUS_OK(buffer);
+            CHECK(pool.recycled_allocations() == 0);
+        }
+
+        THEN("Growing an empty buffer reuses it")
+        {
+            auto buffer = arrow::AllocateResizableBuffer(0, &pool);
+            REQUIRE_ARROW_STATUS_OK(buffer);
+            REQUIRE_ARROW_STATUS_OK((*buffer)->Reserve(10'000));
+            CHECK((*buffer)->data() == first_data);
+            CHECK(pool.recycled_allocations() == 1);
+        }
+
+        THEN("Releasing unused memory returns it upstream")
+        {
+            pool.ReleaseUnused();
+            CHECK(pool.cached_bytes() == 0);
+            CHECK(upstream->bytes_allocated() == upstream_bytes);
+        }
+    }
+
+    GIVEN("Allocations too small, or too many, to keep")
+    {
+        {
+            auto small_buffer = arrow::AllocateResizableBuffer(100, &pool);
+            REQUIRE_ARROW_STATUS_OK(small_buffer);
+            auto large_buffer = arrow::AllocateResizableBuffer(max_cached_bytes * 2, &pool);
+            REQUIRE_ARROW_STATUS_OK(large_buffer);
+        }
+
+        THEN("They are returned upstream when freed")
+        {
+            CHECK(pool.cached_bytes() == 0);
+            CHECK(upstream->bytes_allocated() == upstream_bytes);
+        }
+    }
+}
+
+SCENARIO("Tracking memory pool")
+{
+    auto const upstream = arrow::system_memory_pool();
+    auto const upstream_bytes = upstream->bytes_allocated();
+    pod5::TrackingMemoryPool pool(upstream, "test", 18'000);
+
+    GIVEN("Allocations within the limit")
+    {
+        auto first = arrow::AllocateResizableBuffer(10'000, &pool);
+        REQUIRE_ARROW_STATUS_OK(first);
+        auto second = arrow::AllocateResizableBuffer(5'000, &pool);
+        REQUIRE_ARROW_STATUS_OK(second);
+
+        THEN("They are counted")
+        {
+            auto const statistics = pool.statistics();
+            CHECK(statistics.bytes_allocated >= 15'000);
+            CHECK(statistics.peak_bytes_allocated == statistics.bytes_allocated);
+            CHECK(statistics.allocation_count == 2);
+            CHECK(statistics.failed_allocations == 0);
+            CHECK(statistics.max_bytes == 18'000);
+        }
+
+        THEN("Allocating beyond the limit fails, leaving the pool unchanged")
+        {
+            auto const bytes_allocated = pool.statistics().bytes_allocated;
+            auto third = arrow::AllocateResizableBuffer(10'000, &pool);
+            CHECK(third.status().IsOutOfMemory());
+            CHECK_FALSE((*second)->Resize(10'000).ok());
+            CHECK(pool.statistics().bytes_allocated == bytes_allocated);
+            CHECK(pool.statistics().failed_allocations == 2);
+        }
+
+        THEN("Freeing them keeps the peak, and allows more allocations")
+        {
+            auto const peak = pool.statistics().peak_bytes_allocated;
+            first->reset();
+            CHECK(pool.statistics().bytes_allocated < peak);
+            CHECK(pool.statistics().peak_bytes_allocated == peak);
+
+            auto third = arrow::AllocateResizableBuffer(10'000, &pool);
+            REQUIRE_ARROW_STATUS_OK(third);
+        }
+
+        THEN("Removing the limit allows larger allocations")
+        {
+            pool.set_max_bytes(0);
+            auto third = arrow::AllocateResizableBuffer(100'000, &pool);
+            REQUIRE_ARROW_STATUS_OK(third);
+        }
+    }
+
+    THEN("Everything allocated is returned upstream")
+    {
+        CHECK(pool.statistics().bytes_allocated == 0);
+        CHECK(upstream->bytes_allocated() == upstream_bytes);
+    }
+}
+
+TEST_CASE("Subsystem memory pools tag the default memory pool")
+{
+    auto const subsystem = pod5::MemorySubsystem::SignalCache;
+    auto & subsystem_pool = pod5::subsystem_memory_pool(subsystem);
+    CHECK(subsystem_pool.name() == "signal_cache");
+    CHECK(pod5::tagged_memory_pool(subsystem, pod5::default_memory_pool()) == &subsystem_pool);
+
+    auto const other_pool = arrow::system_memory_pool();
+    if (other_pool != pod5::default_memory_pool()) {
+        CHECK(pod5::tagged_memory_pool(subsystem, other_pool) == other_pool);
+    }
+}
+
+TEST_CASE("Memory pool backends")
+{
+    auto const default_pool = pod5::memory_pool_for_backend(pod5::MemoryPoolBackend::Default);
+    REQUIRE_ARROW_STATUS_OK(default_pool);
+    CHECK(*default_pool == pod5::default_memory_pool());
+
+    auto const system_pool = pod5::memory_pool_for_backend(pod5::MemoryPoolBackend::System);
+    REQUIRE_ARROW_STATUS_OK(system_pool);
+    CHECK(*system_pool == arrow::system_memory_pool());
+
+    pod5::FileReaderOptions reader_options;
+    REQUIRE_ARROW_STATUS_OK(
+        reader_options.set_memory_pool_backend(pod5::MemoryPoolBackend::System));
+    CHECK(reader_options.memory_pool() == arrow::system_memory_pool());
+}
+
+#ifdef __linux__
+SCENARIO("Huge page memory pool")
+{
+    auto const upstream = arrow::system_memory_pool();
+    pod5::HugePageMemoryPool pool(upstream);
+    auto const huge_page = pod5::HugePageMemoryPool::HUGE_PAGE_BYTES;
+
+    GIVEN("A large allocation")
+    {
+        auto buffer = arrow::AllocateResizableBuffer(huge_page + 1, &pool);
+        REQUIRE_ARROW_STATUS_OK(buffer);
+        auto const data = (*buffer)->mutable_data();
+        std::fill(data, data + huge_page + 1, std::uint8_t(7));
+
+        THEN("It is mapped in whole huge pages, aligned to a huge page")
+        {
+            CHECK(pool.huge_page_bytes() == 2 * huge_page);
+            CHECK(reinterpret_cast<std::uintptr_t>(data) % huge_page == 0);
+        }
+
+        THEN("Growing it keeps its contents")
+        {
+            REQUIRE_ARROW_STATUS_OK((*buffer)->Resize(3 * huge_page));
+            auto const grown = (*buffer)->data();
+            CHECK(std::all_of(grown, grown + huge_page + 1, [](auto b) { return b == 7; }));
+            CHECK(pool.huge_page_bytes() == 3 * huge_page);
+        }
+
+        THEN("Freeing it unmaps it")
+        {
+            buffer->reset();
+            CHECK(pool.huge_page_bytes() == 0);
+        }
+    }
+
+    GIVEN("A small allocation")
+    {
+        auto buffer = arrow::AllocateResizableBuffer(1'000, &pool);
+        REQUIRE_ARROW_STATUS_OK(buffer);
+
+        THEN("It comes from the wrapped pool")
+        {
+            CHECK(pool.huge_page_bytes() == 0);
+            CHECK(pool.bytes_allocated() >= 1'000);
+        }
+    }
+}
+#endif
@@ -0,0 +1,159 @@
+#include "pod5_format/multi_file_signal_loader.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The signal written for the read at [read_index] in the file at [file_index].
+std::vector<std::int16_t> test_signal(std::size_t file_index, std::size_t read_index)
+{
+    return std::vector<std::int16_t>(5 + read_index, std::int16_t(file_index * 100 + read_index));
+}
+
+// Write a file of [read_count] reads, two reads per read table batch.
+void write_loader_file(std::string const & path, std::size_t file_index, std::size_t read_count)
+{
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(path));
+
+    pod5::FileWriterOptions options;
+    options.set_read_table_batch_size(2);
+    auto writer = pod5::create_file_writer(path, "test_software", options);
+    REQUIRE_ARROW_STATUS_OK(writer);
+
+    auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+    auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+    auto pore_type = (*writer)->add_pore_type("pore_type");
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    for (std::size_t i = 0; i < read_count; ++i) {
+        pod5::ReadData read_data;
+        read_data.read_id = uuid_gen();
+        read_data.read_number = i;
+        read_data.start_sample = 0;
+        read_data.channel = 1;
+        read_data.well = 1;
+        read_data.pore_type = *pore_type;
+        read_data.end_reason = *end_reason;
+        read_data.end_reason_forced = false;
+        read_data.run_info = *run_info;
+        auto const signal = test_signal(file_index, i);
+        CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+    }
+    CHECK_ARROW_STATUS_OK((*writer)->close());
+}
+
+}  // namespace
+
+SCENARIO("Loading signal from many files")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::vector<std::string> const paths{
+        "./multi_file_loader_0.pod5", "./multi_file_loader_1.pod5", "./multi_file_loader_2.pod5"};
+    std::vector<std::size_t> const read_counts{6, 3, 4};
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        write_loader_file(paths[i], i, read_counts[i]);
+    }
+
+    auto const files_in_flight = GENERATE(std::size_t(1), std::size_t(2), std::size_t(5));
+    CAPTURE(files_in_flight);
+    pod5::MultiFileSignalLoaderOptions options;
+    options.set_files_in_flight(files_in_flight);
+    options.set_tasks_per_file(2);
+    options.set_thread_pool(pod5::make_thread_pool(2));
+
+    WHEN("Loading every read of each file")
+    {
+        // Files are either opened by the loader, or passed already open:
+        auto opened_reader = pod5::open_file_reader(paths[1]);
+        REQUIRE_ARROW_STATUS_OK(opened_reader);
+        std::vector<pod5::SignalLoadPlan> plans(paths.size());
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            plans[i].path = paths[i];
+        }
+        plans[1].reader = *opened_reader;
+
+        pod5::MultiFileSignalLoader loader(std::move(plans), options);
+
+        THEN("Batches are returned file by file, in batch order")
+        {
+            std::vector<std::size_t> next_read(paths.size(), 0);
+            std::size_t last_file = 0;
+            while (true) {
+                auto batch = loader.release_next_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                if (!*batch) {
+                    break;
+                }
+                auto const file_index = (*batch)->file_index;
+                CHECK(file_index >= last_file);
+                last_file = file_index;
+
+                auto const & signal = *(*batch)->signal;
+                CHECK(signal.batch_index() == next_read[file_index] / 2);
+                for (std::size_t row = 0; row < signal.sample_count().size(); ++row) {
+                    auto const samples = signal.samples(row);
+                    CHECK(
+                        std::vector<std::int16_t>(samples.begin(), samples.end())
+                        == test_signal(file_index, next_read[file_index]));
+                    next_read[file_index] += 1;
+                }
+            }
+
+            CHECK(next_read == read_counts);
+            CHECK(loader.is_finished());
+        }
+    }
+
+    WHEN("Loading specific reads, with a missing file")
+    {
+        std::vector<pod5::SignalLoadPlan> plans(3);
+        plans[0].path = paths[0];
+        // Only the second read of the second batch, and no others:
+        plans[0].batch_counts = {0, 1, 0};
+        plans[0].batch_rows = {1};
+        plans[1].path = "./not_a_file.pod5";
+        plans[2].path = paths[2];
+
+        pod5::MultiFileSignalLoader loader(std::move(plans), options);
+
+        THEN("The chosen reads are loaded, then the missing file fails")
+        {
+            std::size_t loaded_reads = 0;
+            while (true) {
+                auto batch = loader.release_next_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                REQUIRE(*batch);
+                CHECK((*batch)->file_index == 0);
+                auto const & signal = *(*batch)->signal;
+                if (signal.batch_index() == 1) {
+                    REQUIRE(signal.sample_count().size() == 1);
+                    auto const samples = signal.samples(0);
+                    CHECK(
+                        std::vector<std::int16_t>(samples.begin(), samples.end())
+                        == test_signal(0, 3));
+                    loaded_reads += 1;
+                }
+                if (signal.batch_index() == 2) {
+                    break;
+                }
+            }
+            CHECK(loaded_reads == 1);
+
+            CHECK(!loader.release_next_batch().ok());
+            CHECK(!loader.is_finished());
+        }
+    }
+}
@@ -129,6 +129,30 @@ TEST_CASE("AsyncOutputStream", "[OutputStream]")
     check_file_contents(filename);
 }
 
+TEST_CASE("AsyncOutputStream parallel writes", "[OutputStream]")
+{
+    using namespace pod5;
+
+    auto const filename = "./test_file.bin";
+    {
+        std::ofstream f(filename, std::ios_base::trunc);
+    }
+    {
+        auto res = arrow::io::FileOutputStream::Open(filename);
+        REQUIRE_ARROW_STATUS_OK(res);
+        auto thread_pool = make_thread_pool(4);
+        auto stream = *AsyncOutputStream::make(
+            *res,
+            thread_pool,
+            arrow::default_memory_pool(),
+            AsyncOutputStream::DEFAULT_MAX_PENDING_WRITE_BYTES,
+            4);
+
+        run_output_stream_test(stream);
+    }
+    check_file_contents(filename);
+}
+
 #ifdef __linux__
 TEST_CASE("LinuxOutputStream IOManagerSyncImpl", "[OutputStream]")
 {
@@ -149,4 +173,83 @@ TEST_CASE("LinuxOutputStream IOManagerSyncImpl", "[OutputStream]")
     check_file_contents(filename);
 }
 
+TEST_CASE("LinuxOutputStream IOManagerIoUringImpl", "[OutputStream]")
+{
+    using namespace pod5;
+
+    auto io_manager = pod5::make_io_uring_io_manager(arrow::default_memory_pool(), 4);
+    if (!io_manager.ok()) {
+        WARN("Skipping io_uring tests: " << io_manager.status().ToString());
+        return;
+    }
+
+    // One manager is shared by both streams, which are open together:
+    auto filenames = {"./test_file.bin", "./test_file_2.bin"};
+    for (auto filename : filenames) {
+        std::ofstream f(filename, std::ios_base::trunc);
+    }
+    {
+        std::vector<std::shared_ptr<LinuxOutputStream>> streams;
+        for (auto filename : filenames) {
+            streams.push_back(
+                *LinuxOutputStream::make(filename, *io_manager, 1024 * 1024, true, false, false));
+        }
+        for (auto const & stream : streams) {
+            run_output_stream_test(stream);
+        }
+    }
+    for (auto filename : filenames) {
+        check_file_contents(filename);
+    }
+}
+
+TEST_CASE("LinuxOutputStream Preallocation", "[OutputStream]")
+{
+    using namespace pod5;
+
+    auto filename = "./test_file.bin";
+    auto background = GENERATE(false, true);
+    auto expected_size = GENERATE(std::size_t(0), 2 * TestDataSize);
+    CAPTURE(background, expected_size);
+    {
+        std::ofstream f(filename, std::ios_base::trunc);
+    }
+    {
+        auto io_manager = pod5::make_sync_io_manager();
+        REQUIRE_ARROW_STATUS_OK(io_manager);
+
+        FilePreallocationOptions preallocation;
+        preallocation.expected_size = expected_size;
+        preallocation.min_reservation = 1024 * 1024;
+        preallocation.max_reservation = 16 * 1024 * 1024;
+        if (background) {
+            preallocation.thread_pool = make_thread_pool(1);
+        }
+        auto stream = *LinuxOutputStream::make(
+            filename, *io_manager, 1024 * 1024, false, true, true, preallocation);
+
+        // Many small writes, so reservations are made as the file grows:
+        auto const data = get_test_data();
+        std::size_t const write_size = 256 * 1024;
+        for (std::size_t offset = 0; offset < data->size(); offset += write_size) {
+            CHECK_ARROW_STATUS_OK(stream->Write(arrow::SliceBuffer(
+                data, offset, std::min(write_size, std::size_t(data->size()) - offset))));
+        }
+        REQUIRE_ARROW_STATUS_OK(stream->Close());
+
+        auto const statistics = stream->preallocation_statistics();
+        if (expected_size > 0) {
+            // The expected size covers every write:
+            CHECK(statistics.reservation_count == 1);
+        } else {
+            // Reservations grow with the file, up to the largest reservation, and writes
+            // don't wait on a background reservation which is still in flight:
+            CHECK(statistics.reservation_count > (background ? 0 : 1));
+            CHECK(statistics.reservation_count < TestDataSize / preallocation.min_reservation);
+        }
+        CHECK(statistics.reservation_time.count() > 0);
+    }
+    check_file_contents(filename);
+}
+
 #endif
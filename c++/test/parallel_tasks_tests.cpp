@@ -0,0 +1,86 @@
+#include "pod5_format/internal/parallel_tasks.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Parallel tasks run every task once", "[parallel_tasks]")
+{
+    auto const use_pool = GENERATE(true, false);
+    CAPTURE(use_pool);
+    auto const task_count = GENERATE(0, 1, 7, 1000);
+    CAPTURE(task_count);
+
+    auto thread_pool = use_pool ? pod5::make_thread_pool(4) : nullptr;
+
+    std::vector<std::atomic<int>> runs(task_count);
+    auto const status =
+        pod5::internal::run_parallel_tasks(thread_pool.get(), task_count, [&](std::size_t i) {
+            runs[i] += 1;
+            return pod5::Status::OK();
+        });
+    CHECK(status.ok());
+    for (auto const & run : runs) {
+        CHECK(run == 1);
+    }
+}
+
+TEST_CASE("Parallel tasks return the first error", "[parallel_tasks]")
+{
+    auto thread_pool = pod5::make_thread_pool(4);
+
+    std::atomic<std::size_t> runs{0};
+    auto const status =
+        pod5::internal::run_parallel_tasks(thread_pool.get(), 100, [&](std::size_t i) {
+            runs += 1;
+            if (i == 10) {
+                return pod5::Status::Invalid("Task failed");
+            }
+            return pod5::Status::OK();
+        });
+    CHECK(status.IsInvalid());
+    CHECK(status.message() == "Task failed");
+    CHECK(runs <= 100);
+}
+
+TEST_CASE("Parallel tasks run on the calling thread once the pool is stopped", "[parallel_tasks]")
+{
+    auto thread_pool = pod5::make_thread_pool(2);
+    thread_pool->stop_and_drain();
+
+    std::atomic<std::size_t> runs{0};
+    auto const status =
+        pod5::internal::run_parallel_tasks(thread_pool.get(), 10, [&](std::size_t) {
+            runs += 1;
+            return pod5::Status::OK();
+        });
+    CHECK(status.ok());
+    CHECK(runs == 10);
+}
+
+TEST_CASE("Sorted runs merge into one stable sorted run", "[parallel_tasks]")
+{
+    auto thread_pool = pod5::make_thread_pool(4);
+
+    // Seven runs of (key, run) pairs, sorted by key within each run:
+    std::vector<std::pair<int, std::size_t>> values;
+    std::vector<std::size_t> run_starts{0};
+    for (std::size_t run = 0; run < 7; ++run) {
+        for (int key = 0; key < int(run * 3); key += 2) {
+            values.emplace_back(key, run);
+        }
+        run_starts.push_back(values.size());
+    }
+
+    auto expected = values;
+    auto const compare_keys = [](auto const & a, auto const & b) { return a.first < b.first; };
+    std::stable_sort(expected.begin(), expected.end(), compare_keys);
+
+    auto const status = pod5::internal::merge_sorted_runs(
+        thread_pool.get(), values, std::move(run_starts), compare_keys);
+    CHECK(status.ok());
+    CHECK(values == expected);
+}
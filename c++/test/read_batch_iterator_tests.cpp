@@ -0,0 +1,118 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_batch_iterator.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+SCENARIO("Iterating over read batches")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::vector<pod5::Uuid> read_ids;
+    {
+        pod5::FileWriterOptions options;
+        options.set_read_table_batch_size(10);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("pore_type");
+
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < 25; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.channel = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            read_ids.push_back(read_data.read_id);
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE((*reader)->num_read_record_batches() == 3);
+
+    auto const check_batches = [&](pod5::ReadBatchIterator & iterator, bool projected) {
+        CHECK(iterator.batch_count() == 3);
+        std::size_t row_count = 0;
+        for (std::size_t i = 0; i < 3; ++i) {
+            CHECK(iterator.next_batch_index() == i);
+            auto batch = iterator.next();
+            REQUIRE_ARROW_STATUS_OK(batch);
+            REQUIRE(*batch);
+            auto const read_id_column = (*batch)->read_id_column();
+            for (std::int64_t row = 0; row < read_id_column->length(); ++row) {
+                CHECK(read_id_column->Value(row) == read_ids[row_count++]);
+            }
+            CHECK(bool((*batch)->signal_column()) != projected);
+        }
+        CHECK(row_count == read_ids.size());
+
+        // Finished iterators stay finished:
+        for (std::size_t i = 0; i < 2; ++i) {
+            auto batch = iterator.next();
+            REQUIRE_ARROW_STATUS_OK(batch);
+            CHECK(!*batch);
+        }
+    };
+
+    WHEN("Reading every column")
+    {
+        auto iterator = pod5::make_read_batch_iterator(*reader);
+        REQUIRE_ARROW_STATUS_OK(iterator);
+        check_batches(**iterator, false);
+    }
+
+    WHEN("Reading projected columns on a shared pool")
+    {
+        auto const thread_pool = pod5::make_thread_pool(2);
+        for (auto const prefetch_batches : std::vector<std::size_t>{1, 2, 10}) {
+            pod5::ReadBatchIteratorOptions options;
+            options.set_prefetch_batches(prefetch_batches);
+            options.set_columns({"read_id", "channel"});
+            options.set_thread_pool(thread_pool);
+
+            auto iterator = pod5::make_read_batch_iterator(*reader, options);
+            REQUIRE_ARROW_STATUS_OK(iterator);
+            check_batches(**iterator, true);
+        }
+    }
+
+    WHEN("Dropping an iterator part way through")
+    {
+        auto iterator = pod5::make_read_batch_iterator(*reader);
+        REQUIRE_ARROW_STATUS_OK(iterator);
+        auto batch = (*iterator)->next();
+        REQUIRE_ARROW_STATUS_OK(batch);
+        iterator->reset();
+        CHECK((*batch)->num_rows() == 10);
+    }
+
+    WHEN("Iterating over unknown columns")
+    {
+        pod5::ReadBatchIteratorOptions options;
+        options.set_columns({"not_a_column"});
+        CHECK(!pod5::make_read_batch_iterator(*reader, options).ok());
+        CHECK(!pod5::make_read_batch_iterator(nullptr).ok());
+    }
+}
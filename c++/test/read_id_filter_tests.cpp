@@ -0,0 +1,133 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_id_filter.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/io/memory.h>
+#include <arrow/memory_pool.h>
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+SCENARIO("Read id filter")
+{
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::vector<pod5::Uuid> read_ids;
+    for (std::size_t i = 0; i < 10'000; ++i) {
+        read_ids.push_back(uuid_gen());
+    }
+
+    auto filter = pod5::ReadIdFilter::build(gsl::make_span(read_ids));
+    REQUIRE_ARROW_STATUS_OK(filter);
+    CHECK((*filter)->bit_count() >= read_ids.size() * pod5::ReadIdFilter::DEFAULT_BITS_PER_READ);
+    CHECK((*filter)->hash_count() == 7);
+
+    auto const check_filter = [&](pod5::ReadIdFilter const & filter) {
+        for (auto const & read_id : read_ids) {
+            CHECK(filter.may_contain(read_id));
+        }
+
+        // Around 1% of absent ids should pass, allow plenty of room for randomness:
+        std::size_t false_positives = 0;
+        std::size_t const absent_count = 100'000;
+        for (std::size_t i = 0; i < absent_count; ++i) {
+            false_positives += filter.may_contain(uuid_gen());
+        }
+        CHECK(false_positives < absent_count / 50);
+    };
+
+    WHEN("Checking the built filter")
+    {
+        check_filter(**filter);
+    }
+
+    WHEN("Writing and reopening the filter")
+    {
+        auto buffer = (*filter)->write(nullptr, arrow::default_memory_pool());
+        REQUIRE_ARROW_STATUS_OK(buffer);
+
+        auto reopened = pod5::ReadIdFilter::open(
+            std::make_shared<arrow::io::BufferReader>(*buffer), arrow::default_memory_pool());
+        REQUIRE_ARROW_STATUS_OK(reopened);
+        CHECK((*reopened)->bit_count() == (*filter)->bit_count());
+        CHECK((*reopened)->hash_count() == (*filter)->hash_count());
+        check_filter(**reopened);
+    }
+
+    WHEN("Building an empty filter")
+    {
+        auto empty = pod5::ReadIdFilter::build({});
+        REQUIRE_ARROW_STATUS_OK(empty);
+        CHECK(!(*empty)->may_contain(read_ids.front()));
+    }
+
+    WHEN("Building a filter with no bits per read")
+    {
+        CHECK(!pod5::ReadIdFilter::build(gsl::make_span(read_ids), 0).ok());
+    }
+}
+
+SCENARIO("Read id filter embedded in a file")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_read_id_filter = GENERATE(true, false);
+    CAPTURE(write_read_id_filter);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::vector<pod5::Uuid> read_ids;
+    for (std::size_t i = 0; i < 20; ++i) {
+        read_ids.push_back(uuid_gen());
+    }
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_write_read_id_filter(write_read_id_filter);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < read_ids.size(); ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = read_ids[i];
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto filter = pod5::open_read_id_filter(file, arrow::default_memory_pool());
+    REQUIRE_ARROW_STATUS_OK(filter);
+    if (!write_read_id_filter) {
+        CHECK(!*filter);
+        return;
+    }
+
+    REQUIRE(*filter);
+    for (auto const & read_id : read_ids) {
+        CHECK((*filter)->may_contain(read_id));
+    }
+
+    // The file must still open with the filter present:
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    CHECK((*reader)->num_read_record_batches() == 1);
+}
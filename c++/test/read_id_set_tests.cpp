@@ -0,0 +1,61 @@
+#include "pod5_format_pybind/repack/repack_utils.h"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+pod5::Uuid make_read_id(std::uint64_t low, std::uint64_t high)
+{
+    std::array<std::uint8_t, 16> bytes;
+    std::memcpy(bytes.data(), &low, sizeof(low));
+    std::memcpy(bytes.data() + sizeof(low), &high, sizeof(high));
+    return pod5::Uuid{bytes};
+}
+
+void check_read_id_set(std::vector<pod5::Uuid> const & read_ids)
+{
+    repack::ReadIdSet set;
+    for (auto const & read_id : read_ids) {
+        CHECK(set.insert(read_id));
+    }
+    CHECK(set.size() == read_ids.size());
+
+    // Every id is found again, however many the table grew through:
+    for (auto const & read_id : read_ids) {
+        CHECK(!set.insert(read_id));
+    }
+    CHECK(set.size() == read_ids.size());
+}
+
+}  // namespace
+
+TEST_CASE("Read id sets hold near sequential ids", "[repack]")
+{
+    // Ids differing only in their low bits, across several table sizes:
+    std::vector<pod5::Uuid> read_ids;
+    for (std::uint64_t i = 0; i < 20000; ++i) {
+        read_ids.push_back(make_read_id(0x1234567800000000ull + i, 0xabcdef0000000000ull));
+    }
+    check_read_id_set(read_ids);
+}
+
+TEST_CASE("Read id sets hold ids colliding in their slot", "[repack]")
+{
+    // Each id's words xor to the same value, so every id hashes to the same slot:
+    std::vector<pod5::Uuid> read_ids;
+    for (std::uint64_t i = 1; i <= 2000; ++i) {
+        read_ids.push_back(make_read_id(i, i ^ 0x5555ull));
+    }
+    check_read_id_set(read_ids);
+}
+
+TEST_CASE("Read id sets hold the nil id", "[repack]")
+{
+    std::vector<pod5::Uuid> read_ids{pod5::Uuid{}, make_read_id(1, 0), make_read_id(0, 1)};
+    check_read_id_set(read_ids);
+}
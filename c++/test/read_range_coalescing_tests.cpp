@@ -0,0 +1,49 @@
+#include "pod5_format/internal/read_range_coalescing.h"
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using pod5::internal::ByteRange;
+
+TEST_CASE("Coalescing merges nearby ranges", "[read_range_coalescing]")
+{
+    // Out of file order, with a range repeated:
+    std::vector<ByteRange> const ranges{
+        {200, 50}, {0, 100}, {110, 40}, {1000, 10}, {0, 100}, {1015, 5}};
+
+    auto const coalesced = pod5::internal::coalesce_byte_ranges(gsl::make_span(ranges), 10, 1000);
+    REQUIRE(coalesced.reads.size() == 3);
+    CHECK(coalesced.reads[0].offset == 0);
+    CHECK(coalesced.reads[0].length == 150);
+    CHECK(coalesced.reads[1].offset == 200);
+    CHECK(coalesced.reads[1].length == 50);
+    CHECK(coalesced.reads[2].offset == 1000);
+    CHECK(coalesced.reads[2].length == 20);
+    CHECK(coalesced.read_for_range == std::vector<std::size_t>{1, 0, 0, 2, 0, 2});
+
+    // Every range lies within its read:
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        auto const & read = coalesced.reads[coalesced.read_for_range[i]];
+        CHECK(ranges[i].offset >= read.offset);
+        CHECK(ranges[i].end() <= read.end());
+    }
+}
+
+TEST_CASE("Coalescing respects the read size limit", "[read_range_coalescing]")
+{
+    std::vector<ByteRange> const ranges{{0, 100}, {100, 100}, {200, 100}, {300, 100}};
+
+    auto const coalesced = pod5::internal::coalesce_byte_ranges(gsl::make_span(ranges), 0, 250);
+    REQUIRE(coalesced.reads.size() == 2);
+    CHECK(coalesced.reads[0].length == 200);
+    CHECK(coalesced.reads[1].offset == 200);
+    CHECK(coalesced.reads[1].length == 200);
+    CHECK(coalesced.read_for_range == std::vector<std::size_t>{0, 0, 1, 1});
+
+    // No gap is allowed to be read through without a hole limit:
+    std::vector<ByteRange> const gapped{{0, 100}, {101, 100}};
+    CHECK(pod5::internal::coalesce_byte_ranges(gsl::make_span(gapped), 0, 1000).reads.size() == 2);
+
+    CHECK(pod5::internal::coalesce_byte_ranges({}, 10, 100).reads.empty());
+}
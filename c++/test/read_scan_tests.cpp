@@ -0,0 +1,159 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_scan.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+struct ScanResult {
+    std::vector<std::uint32_t> batch_counts;
+    std::vector<std::uint32_t> batch_rows;
+};
+
+ScanResult scan(pod5::FileReader const & reader, std::string const & expression)
+{
+    auto predicate = pod5::ReadScanPredicate::parse(expression);
+    REQUIRE_ARROW_STATUS_OK(predicate);
+
+    ScanResult result;
+    result.batch_counts.resize(reader.num_read_record_batches());
+    result.batch_rows.resize(100);
+    auto selected_count = reader.scan_reads(
+        *predicate, gsl::make_span(result.batch_counts), gsl::make_span(result.batch_rows));
+    REQUIRE_ARROW_STATUS_OK(selected_count);
+    result.batch_rows.resize(*selected_count);
+    return result;
+}
+
+}  // namespace
+
+SCENARIO("Read scan expressions")
+{
+    CHECK(pod5::ReadScanPredicate::parse("channel < 10").ok());
+    CHECK(pod5::ReadScanPredicate::parse("not (channel < 10 or well == 2) and start >= 1e3").ok());
+    CHECK(pod5::ReadScanPredicate::parse("end_reason not in ('mux_change', \"unknown\")").ok());
+    CHECK(pod5::ReadScanPredicate::parse("end_reason_forced = true").ok());
+
+    CHECK(!pod5::ReadScanPredicate::parse("").ok());
+    CHECK(!pod5::ReadScanPredicate::parse("channel").ok());
+    CHECK(!pod5::ReadScanPredicate::parse("channel <").ok());
+    CHECK(!pod5::ReadScanPredicate::parse("channel < 10 and").ok());
+    CHECK(!pod5::ReadScanPredicate::parse("(channel < 10").ok());
+    CHECK(!pod5::ReadScanPredicate::parse("channel in (1, 'a')").ok());
+    CHECK(!pod5::ReadScanPredicate::parse("pore_type < 'a'").ok());
+    CHECK(!pod5::ReadScanPredicate::parse("pore_type == 'a").ok());
+
+    auto predicate =
+        pod5::ReadScanPredicate::parse("well == 1 and (channel < 10 or pore_type == 'a')");
+    REQUIRE_ARROW_STATUS_OK(predicate);
+    CHECK(predicate->columns() == std::vector<std::string>{"channel", "pore_type", "well"});
+}
+
+SCENARIO("Scanning a file for reads")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_read_table_batch_size(10);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto signal_positive = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto mux_change = (*writer)->lookup_end_reason(pod5::ReadEndReason::mux_change);
+        auto pore_a = (*writer)->add_pore_type("pore_a");
+        auto pore_b = (*writer)->add_pore_type("pore_b");
+
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < 25; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.start_sample = i * 1000;
+            read_data.channel = i;
+            read_data.well = 1 + i % 4;
+            read_data.pore_type = i % 2 ? *pore_b : *pore_a;
+            read_data.end_reason = i % 5 == 0 ? *mux_change : *signal_positive;
+            read_data.end_reason_forced = i % 5 == 0;
+            read_data.run_info = *run_info;
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE((*reader)->num_read_record_batches() == 3);
+
+    WHEN("Comparing numeric columns")
+    {
+        auto const result = scan(**reader, "channel >= 8 and channel < 12");
+        CHECK(result.batch_counts == std::vector<std::uint32_t>{2, 2, 0});
+        CHECK(result.batch_rows == std::vector<std::uint32_t>{8, 9, 0, 1});
+    }
+
+    WHEN("Testing numeric sets")
+    {
+        auto const result = scan(**reader, "read_number in (3, 14, 24) or well == 100");
+        CHECK(result.batch_counts == std::vector<std::uint32_t>{1, 1, 1});
+        CHECK(result.batch_rows == std::vector<std::uint32_t>{3, 4, 4});
+    }
+
+    WHEN("Testing dictionary columns")
+    {
+        auto const result = scan(**reader, "end_reason == 'mux_change' and pore_type != 'pore_b'");
+        CHECK(result.batch_counts == std::vector<std::uint32_t>{1, 1, 1});
+        CHECK(result.batch_rows == std::vector<std::uint32_t>{0, 0, 0});
+    }
+
+    WHEN("Negating tests")
+    {
+        auto const result =
+            scan(**reader, "not end_reason_forced and channel not in (1, 2, 3) and channel < 5");
+        CHECK(result.batch_counts == std::vector<std::uint32_t>{1, 0, 0});
+        CHECK(result.batch_rows == std::vector<std::uint32_t>{4});
+    }
+
+    WHEN("Scanning for missing or mistyped columns")
+    {
+        std::vector<std::uint32_t> batch_counts(3);
+        std::vector<std::uint32_t> batch_rows(25);
+        for (auto const & expression :
+             {"not_a_column == 1", "pore_type == 1", "channel == 'a'", "read_id == 1"})
+        {
+            auto predicate = pod5::ReadScanPredicate::parse(expression);
+            REQUIRE_ARROW_STATUS_OK(predicate);
+            CHECK(!(*reader)
+                       ->scan_reads(
+                           *predicate, gsl::make_span(batch_counts), gsl::make_span(batch_rows))
+                       .ok());
+        }
+    }
+
+    WHEN("Scanning with too few output rows")
+    {
+        auto predicate = pod5::ReadScanPredicate::parse("channel >= 0");
+        REQUIRE_ARROW_STATUS_OK(predicate);
+        std::vector<std::uint32_t> batch_counts(3);
+        std::vector<std::uint32_t> batch_rows(10);
+        CHECK(!(*reader)
+                   ->scan_reads(
+                       *predicate, gsl::make_span(batch_counts), gsl::make_span(batch_rows))
+                   .ok());
+    }
+}
@@ -0,0 +1,202 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_export.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/array/array_binary.h>
+#include <arrow/array/array_primitive.h>
+#include <arrow/buffer.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> split(std::string const & text, char separator)
+{
+    std::vector<std::string> parts;
+    std::stringstream stream{text};
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+std::shared_ptr<arrow::Buffer> export_files(
+    std::vector<std::shared_ptr<pod5::FileReader>> const & readers,
+    pod5::ReadTableExportOptions const & options,
+    std::shared_ptr<pod5::ThreadPool> const & thread_pool)
+{
+    auto output = arrow::io::BufferOutputStream::Create();
+    REQUIRE_ARROW_STATUS_OK(output);
+    auto exporter = pod5::ReadTableExporter::create(
+        *output, options, thread_pool, arrow::default_memory_pool());
+    REQUIRE_ARROW_STATUS_OK(exporter);
+    for (std::size_t i = 0; i < readers.size(); ++i) {
+        REQUIRE_ARROW_STATUS_OK((*exporter)->add_file(readers[i], "file_" + std::to_string(i)));
+    }
+    REQUIRE_ARROW_STATUS_OK((*exporter)->close());
+    CHECK((*exporter)->reads_written() == readers.size() * 25);
+
+    auto buffer = (*output)->Finish();
+    REQUIRE_ARROW_STATUS_OK(buffer);
+    return *buffer;
+}
+
+}  // namespace
+
+SCENARIO("Read table export fields")
+{
+    auto const & names = pod5::read_table_export_field_names();
+    REQUIRE(names.size() == 24);
+    CHECK(names.front() == "read_id");
+    CHECK(names.back() == "pore_type");
+
+    auto field = pod5::find_read_table_export_field("mux");
+    REQUIRE_ARROW_STATUS_OK(field);
+    CHECK(*field == pod5::ReadTableExportField::mux);
+    CHECK(!pod5::find_read_table_export_field("well").ok());
+}
+
+SCENARIO("Exporting read tables")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    std::vector<pod5::Uuid> read_ids;
+
+    {
+        pod5::FileWriterOptions options;
+        options.set_read_table_batch_size(10);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto signal_positive = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_a = (*writer)->add_pore_type("pore_a");
+        auto pore_b = (*writer)->add_pore_type("pore_b");
+
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < 25; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.start_sample = i * 1000;
+            read_data.channel = i;
+            read_data.well = 1 + i % 4;
+            read_data.pore_type = i % 2 ? *pore_b : *pore_a;
+            read_data.end_reason = *signal_positive;
+            read_data.run_info = *run_info;
+            read_ids.push_back(read_data.read_id);
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE((*reader)->num_read_record_batches() == 3);
+    auto const thread_pool = pod5::make_thread_pool(4);
+
+    WHEN("Exporting every field as text")
+    {
+        pod5::ReadTableExportOptions options;
+        options.max_batches_in_flight = 2;
+        auto const text = export_files({*reader, *reader}, options, thread_pool)->ToString();
+
+        auto const lines = split(text, '\n');
+        REQUIRE(lines.size() == 51);
+        CHECK(split(lines[0], '\t') == pod5::read_table_export_field_names());
+
+        // Reads are written in file order, each file after the last:
+        for (std::size_t i = 0; i < 50; ++i) {
+            auto const values = split(lines[i + 1], '\t');
+            REQUIRE(values.size() == 24);
+            auto const read = i % 25;
+            CHECK(values[0] == pod5::to_string(read_ids[read]));
+            CHECK(values[1] == "file_" + std::to_string(i / 25));
+            CHECK(values[2] == std::to_string(read));
+            CHECK(values[4] == std::to_string(1 + read % 4));
+            CHECK(values[5] == "signal_positive");
+            CHECK(std::stod(values[6]) == Approx(read * 1000 / 4000.0));
+            CHECK(values[7] == std::to_string(read * 1000));
+            CHECK(values[11] == "4000");
+            CHECK(values[19] == "protocol_run_id");
+            CHECK(values[21] == "experiment_name");
+            CHECK(values[23] == (read % 2 ? "pore_b" : "pore_a"));
+        }
+    }
+
+    WHEN("Exporting selected fields as text")
+    {
+        pod5::ReadTableExportOptions options;
+        options.fields = {pod5::ReadTableExportField::pore_type, pod5::ReadTableExportField::mux};
+        options.separator = ",";
+        options.header = false;
+        auto const text = export_files({*reader}, options, nullptr)->ToString();
+
+        auto const lines = split(text, '\n');
+        REQUIRE(lines.size() == 25);
+        CHECK(lines[0] == "1,pore_a");
+        CHECK(lines[1] == "2,pore_b");
+    }
+
+    WHEN("Exporting as an arrow stream")
+    {
+        pod5::ReadTableExportOptions options;
+        options.format = pod5::ReadTableExportFormat::Arrow;
+        options.fields = {
+            pod5::ReadTableExportField::read_id,
+            pod5::ReadTableExportField::channel,
+            pod5::ReadTableExportField::duration};
+        auto const buffer = export_files({*reader}, options, thread_pool);
+
+        auto stream = arrow::ipc::RecordBatchStreamReader::Open(
+            std::make_shared<arrow::io::BufferReader>(buffer));
+        REQUIRE_ARROW_STATUS_OK(stream);
+        auto table = (*stream)->ToRecordBatches();
+        REQUIRE_ARROW_STATUS_OK(table);
+        REQUIRE(table->size() == 3);
+
+        std::size_t read = 0;
+        for (auto const & batch : *table) {
+            REQUIRE(batch->num_columns() == 3);
+            CHECK(batch->schema()->field(1)->name() == "channel");
+            auto const ids = std::static_pointer_cast<arrow::StringArray>(batch->column(0));
+            auto const channels = std::static_pointer_cast<arrow::UInt16Array>(batch->column(1));
+            auto const durations = std::static_pointer_cast<arrow::DoubleArray>(batch->column(2));
+            for (std::int64_t row = 0; row < batch->num_rows(); ++row, ++read) {
+                CHECK(ids->GetString(row) == pod5::to_string(read_ids[read]));
+                CHECK(channels->Value(row) == read);
+                CHECK(durations->Value(row) == Approx(100 / 4000.0));
+            }
+        }
+        CHECK(read == 25);
+    }
+
+    WHEN("Adding a file after closing")
+    {
+        auto output = arrow::io::BufferOutputStream::Create();
+        REQUIRE_ARROW_STATUS_OK(output);
+        auto exporter = pod5::ReadTableExporter::create(
+            *output, {}, thread_pool, arrow::default_memory_pool());
+        REQUIRE_ARROW_STATUS_OK(exporter);
+        REQUIRE_ARROW_STATUS_OK((*exporter)->close());
+        CHECK(!(*exporter)->add_file(*reader, "file").ok());
+    }
+}
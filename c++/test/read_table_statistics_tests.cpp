@@ -0,0 +1,177 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_statistics.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/io/memory.h>
+#include <arrow/memory_pool.h>
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+pod5::ReadTableBatchStatistics make_batch_statistics(
+    std::uint16_t min_channel,
+    std::uint16_t max_channel,
+    std::vector<std::int16_t> end_reasons)
+{
+    return pod5::ReadTableBatchStatistics{
+        min_channel, max_channel, 100, 200, 1000, 2000, std::move(end_reasons), {0}};
+}
+
+}  // namespace
+
+SCENARIO("Read table batch predicates")
+{
+    auto const statistics = make_batch_statistics(10, 20, {1, 3});
+
+    pod5::ReadBatchPredicate predicate;
+    CHECK(predicate.may_match(statistics));
+
+    WHEN("Filtering by channel")
+    {
+        predicate.channel = {{15, 30}};
+        CHECK(predicate.may_match(statistics));
+        predicate.channel = {{20, 20}};
+        CHECK(predicate.may_match(statistics));
+        predicate.channel = {{21, 30}};
+        CHECK(!predicate.may_match(statistics));
+        predicate.channel = {{0, 9}};
+        CHECK(!predicate.may_match(statistics));
+    }
+
+    WHEN("Filtering by sample ranges")
+    {
+        predicate.num_samples = {{150, 150}};
+        predicate.start_sample = {{0, 1000}};
+        CHECK(predicate.may_match(statistics));
+        predicate.start_sample = {{2001, 3000}};
+        CHECK(!predicate.may_match(statistics));
+    }
+
+    WHEN("Filtering by end reason")
+    {
+        predicate.end_reasons = std::vector<std::int16_t>{0, 3};
+        CHECK(predicate.may_match(statistics));
+        predicate.end_reasons = std::vector<std::int16_t>{2};
+        CHECK(!predicate.may_match(statistics));
+        predicate.end_reasons = std::vector<std::int16_t>{};
+        CHECK(!predicate.may_match(statistics));
+    }
+
+    WHEN("Writing and reopening statistics")
+    {
+        pod5::ReadTableStatistics all_statistics;
+        all_statistics.add_batch(make_batch_statistics(10, 20, {1, 3}));
+        all_statistics.add_batch(make_batch_statistics(30, 40, {}));
+
+        auto buffer = all_statistics.write(nullptr, arrow::default_memory_pool());
+        REQUIRE_ARROW_STATUS_OK(buffer);
+
+        auto reopened = pod5::ReadTableStatistics::open(
+            std::make_shared<arrow::io::BufferReader>(*buffer), arrow::default_memory_pool());
+        REQUIRE_ARROW_STATUS_OK(reopened);
+        REQUIRE(*reopened);
+        REQUIRE((*reopened)->batch_count() == 2);
+
+        auto const & first = (*reopened)->batches()[0];
+        CHECK(first.min_channel == 10);
+        CHECK(first.max_channel == 20);
+        CHECK(first.min_num_samples == 100);
+        CHECK(first.max_start_sample == 2000);
+        CHECK(first.end_reasons == std::vector<std::int16_t>{1, 3});
+        CHECK(first.run_infos == std::vector<std::int16_t>{0});
+        CHECK((*reopened)->batches()[1].end_reasons.empty());
+
+        predicate.channel = {{35, 50}};
+        CHECK((*reopened)->filter_batches(predicate) == std::vector<std::size_t>{1});
+    }
+}
+
+SCENARIO("Read table statistics embedded in a file")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_read_table_statistics = GENERATE(true, false);
+    CAPTURE(write_read_table_statistics);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::size_t const batch_size = 10;
+    std::size_t const read_count = 45;
+    std::int16_t signal_positive_index = 0;
+    {
+        pod5::FileWriterOptions options;
+        options.set_read_table_batch_size(batch_size);
+        options.set_write_read_table_statistics(write_read_table_statistics);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto signal_positive = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto unblock = (*writer)->lookup_end_reason(pod5::ReadEndReason::unblock_mux_change);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+        signal_positive_index = *signal_positive;
+
+        std::vector<std::int16_t> const signal(100, 5);
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            // Reads are written in channel order, one batch per ten channels:
+            read_data.channel = i + 1;
+            read_data.start_sample = i * 1000;
+            read_data.pore_type = *pore_type;
+            // Only the final batch holds unblocked reads:
+            read_data.end_reason = i >= 42 ? *unblock : *signal_positive;
+            read_data.run_info = *run_info;
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE((*reader)->num_read_record_batches() == 5);
+
+    pod5::ReadBatchPredicate predicate;
+    predicate.channel = {{12, 25}};
+
+    auto const batches = (*reader)->filter_read_record_batches(predicate);
+    if (!write_read_table_statistics) {
+        CHECK(!(*reader)->read_table_statistics());
+        CHECK(batches == std::vector<std::size_t>{0, 1, 2, 3, 4});
+        return;
+    }
+
+    auto const statistics = (*reader)->read_table_statistics();
+    REQUIRE(statistics);
+    REQUIRE(statistics->batch_count() == 5);
+    auto const & last = statistics->batches()[4];
+    CHECK(last.min_channel == 41);
+    CHECK(last.max_channel == 45);
+    CHECK(last.min_start_sample == 40'000);
+    CHECK(last.max_start_sample == 44'000);
+    CHECK(last.min_num_samples == 100);
+    CHECK(last.max_num_samples == 100);
+    CHECK(last.end_reasons.size() == 2);
+    CHECK(last.run_infos.size() == 1);
+
+    CHECK(batches == std::vector<std::size_t>{1, 2});
+
+    pod5::ReadBatchPredicate end_reason_predicate;
+    end_reason_predicate.end_reasons = std::vector<std::int16_t>{signal_positive_index};
+    end_reason_predicate.start_sample = {{35'000, 100'000}};
+    CHECK(
+        (*reader)->filter_read_record_batches(end_reason_predicate)
+        == std::vector<std::size_t>{3, 4});
+}
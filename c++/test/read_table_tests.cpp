@@ -151,6 +151,9 @@ SCENARIO("Read table Tests")
                 REQUIRE(record_batch->num_rows() == static_cast<std::size_t>(read_count));
 
                 auto columns = record_batch->columns();
+                auto const view = record_batch->view();
+                CHECK(view.num_rows == read_count);
+                CHECK(view.table_version == columns->table_version);
 
                 CHECK(columns->read_id->length() == read_count);
                 CHECK(columns->signal->length() == read_count);
@@ -200,6 +203,23 @@ SCENARIO("Read table Tests")
                     CHECK(end_reason_indices->Value(j) == read_data.end_reason);
                     CHECK(pore_indices->Value(j) == read_data.pore_type);
                     CHECK(run_info_indices->Value(j) == read_data.run_info);
+
+                    // The view reads the same values straight from the columns:
+                    CHECK(view.read_id[j] == read_data.read_id);
+                    CHECK(view.signal[j] == gsl::make_span(expected_signal));
+                    CHECK(view.signal.value_length(j) == std::int32_t(expected_signal.size()));
+                    CHECK(view.read_number[j] == read_data.read_number);
+                    CHECK(view.start_sample[j] == read_data.start_sample);
+                    CHECK(view.median_before[j] == read_data.median_before);
+                    CHECK(view.num_samples[j] == expected_signal.size());
+                    CHECK(view.calibration_offset[j] == read_data.calibration_offset);
+                    CHECK(view.calibration_scale[j] == read_data.calibration_scale);
+                    CHECK(view.channel[j] == read_data.channel);
+                    CHECK(view.well[j] == read_data.well);
+                    CHECK(view.end_reason[j] == read_data.end_reason);
+                    CHECK(view.end_reason_forced[j] == read_data.end_reason_forced);
+                    CHECK(view.pore_type[j] == read_data.pore_type);
+                    CHECK(view.run_info[j] == read_data.run_info);
                 }
 
                 auto pore_data = record_batch->get_pore_type(0);
@@ -220,5 +240,33 @@ SCENARIO("Read table Tests")
                 CHECK(*run_info_data == "acq_id_2");
             }
         }
+
+        // Batches read again with a cache are served without decoding them again:
+        {
+            auto reader = pod5::make_read_table_reader(*file_in, pool, {}, 1024 * 1024);
+            REQUIRE_ARROW_STATUS_OK(reader);
+            for (std::size_t pass = 0; pass < 2; ++pass) {
+                for (std::size_t i = 0; i < record_batch_count; ++i) {
+                    auto const record_batch = reader->read_record_batch(i);
+                    REQUIRE_ARROW_STATUS_OK(record_batch);
+                    CHECK(record_batch->num_rows() == static_cast<std::size_t>(read_count));
+
+                    auto const pore_data = record_batch->get_pore_type(0);
+                    REQUIRE_ARROW_STATUS_OK(pore_data);
+                    CHECK(*pore_data == "Well Type");
+                }
+            }
+
+            auto const statistics = reader->statistics();
+            CHECK(statistics.batches_decoded == record_batch_count);
+            CHECK(statistics.cache_misses == record_batch_count);
+            CHECK(statistics.cache_hits == record_batch_count);
+            CHECK(reader->cached_batch_bytes() > 0);
+
+            reader->clear_cache();
+            CHECK(reader->cached_batch_bytes() == 0);
+            REQUIRE_ARROW_STATUS_OK(reader->read_record_batch(0));
+            CHECK(reader->statistics().batches_decoded == record_batch_count + 1);
+        }
     }
 }
@@ -159,3 +159,46 @@ TEST_CASE("Run Info Writer Tests")
         CHECK(string_value_array->Value(1) == "acq_id_2");
     }
 }
+
+TEST_CASE("Pore Writer finds pore types added before")
+{
+    auto pool = arrow::system_memory_pool();
+    auto pore_writer = pod5::make_pore_writer(pool);
+    REQUIRE_ARROW_STATUS_OK(pore_writer);
+
+    auto const first = (*pore_writer)->add("pore_type_1");
+    auto const second = (*pore_writer)->add("pore_type_2");
+    auto const first_again = (*pore_writer)->add("pore_type_1");
+    REQUIRE_ARROW_STATUS_OK(first);
+    REQUIRE_ARROW_STATUS_OK(second);
+    REQUIRE_ARROW_STATUS_OK(first_again);
+    CHECK(*first == 0);
+    CHECK(*second == 1);
+    CHECK(*first_again == 0);
+    CHECK((*pore_writer)->item_count() == 2);
+}
+
+TEST_CASE("Run Info Writer finds run infos added before")
+{
+    auto pool = arrow::system_memory_pool();
+    auto run_info_writer = pod5::make_run_info_writer(pool);
+    REQUIRE_ARROW_STATUS_OK(run_info_writer);
+
+    auto const first_run_info = get_test_run_info_data("_1");
+    auto changed_run_info = first_run_info;
+    changed_run_info.tracking_id.emplace_back("extra_key", "extra_value");
+
+    CHECK(!(*run_info_writer)->find(first_run_info));
+    auto const first = (*run_info_writer)->add(first_run_info);
+    REQUIRE_ARROW_STATUS_OK(first);
+    CHECK((*run_info_writer)->find(first_run_info) == *first);
+
+    // A run info differing in any field is a new entry, even with the same acquisition id:
+    CHECK(!(*run_info_writer)->find(changed_run_info));
+    auto const changed = (*run_info_writer)->add(changed_run_info);
+    REQUIRE_ARROW_STATUS_OK(changed);
+    CHECK(*changed == 1);
+    CHECK((*run_info_writer)->find(changed_run_info) == *changed);
+    CHECK((*run_info_writer)->find(first_run_info) == *first);
+    CHECK((*run_info_writer)->item_count() == 2);
+}
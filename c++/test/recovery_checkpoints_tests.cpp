@@ -0,0 +1,183 @@
+#include "pod5_format/internal/recovery_checkpoints.h"
+#include "pod5_format/async_signal_loader.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using pod5::internal::CheckpointedBatch;
+
+TEST_CASE("Recovery checkpoints list every intact record", "[recovery_checkpoints]")
+{
+    std::string const path = "./recovery_checkpoint_records";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(path));
+
+    // No checkpoint file lists no batches:
+    auto batches = pod5::internal::read_recovery_checkpoints(path);
+    REQUIRE_ARROW_STATUS_OK(batches);
+    CHECK(batches->empty());
+
+    std::vector<CheckpointedBatch> const first{{100, 10}, {200, 10}};
+    std::vector<CheckpointedBatch> const second{{300, 5}};
+    {
+        auto writer = pod5::internal::RecoveryCheckpointWriter::open(path);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        REQUIRE_ARROW_STATUS_OK((*writer)->write_checkpoint(gsl::make_span(first)));
+        REQUIRE_ARROW_STATUS_OK((*writer)->write_checkpoint(gsl::make_span(second)));
+    }
+
+    batches = pod5::internal::read_recovery_checkpoints(path);
+    REQUIRE_ARROW_STATUS_OK(batches);
+    REQUIRE(batches->size() == 3);
+    CHECK((*batches)[0].end_offset == 100);
+    CHECK((*batches)[1].end_offset == 200);
+    CHECK((*batches)[2].end_offset == 300);
+    CHECK((*batches)[2].row_count == 5);
+
+    // A record torn by a crash is ignored, keeping the records before it:
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    batches = pod5::internal::read_recovery_checkpoints(path);
+    REQUIRE_ARROW_STATUS_OK(batches);
+    REQUIRE(batches->size() == 2);
+    CHECK((*batches)[1].end_offset == 200);
+
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(path));
+}
+
+SCENARIO("Recovering a file, passing its signal batches through")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::filesystem::path const copy_dir = "./recovery_checkpoints_copy";
+    std::filesystem::remove_all(copy_dir);
+    std::filesystem::create_directories(copy_dir);
+    std::string const path = "./recovery_checkpoints.pod5";
+    std::string const recovered_path = "./recovery_checkpoints_recovered.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(path));
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(recovered_path));
+
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(20 + i, std::int16_t(i));
+    };
+
+    // Some reads are left after the last checkpoint, and have to be decoded:
+    std::size_t const read_count = 7;
+    auto const checkpoint_interval = GENERATE(std::size_t(0), std::size_t(1), std::size_t(3));
+    CAPTURE(checkpoint_interval);
+    pod5::FileRecoveryOptions recovery_options;
+    recovery_options.pass_through_signal_batches = GENERATE(true, false);
+    recovery_options.recover_tables_concurrently = GENERATE(true, false);
+    CAPTURE(recovery_options.pass_through_signal_batches);
+    CAPTURE(recovery_options.recover_tables_concurrently);
+    auto const page_align_signal_batches = GENERATE(false, true);
+    CAPTURE(page_align_signal_batches);
+
+    pod5::FileWriterOptions options;
+    options.set_page_align_signal_batches(page_align_signal_batches);
+    options.set_signal_table_batch_size(1);
+    options.set_read_table_batch_size(1);
+    options.set_recovery_checkpoint_interval(checkpoint_interval);
+    // Flush every add, so the copy holds every read added:
+    options.set_max_unflushed_bytes(1);
+
+    std::vector<std::string> checkpoint_files;
+    {
+        auto writer = pod5::create_file_writer(path, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data("_run_info"));
+        REQUIRE_ARROW_STATUS_OK(run_info);
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        REQUIRE_ARROW_STATUS_OK(end_reason);
+        auto pore_type = (*writer)->add_pore_type("pore_type");
+        REQUIRE_ARROW_STATUS_OK(pore_type);
+
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.channel = 1;
+            read_data.well = 1;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+
+        // Copy the file and its temporary files as a crash would leave them:
+        for (auto const & entry : std::filesystem::directory_iterator(".")) {
+            auto const name = entry.path().filename().string();
+            if (name == "recovery_checkpoints.pod5" || name.find(".tmp-") != std::string::npos) {
+                std::filesystem::copy_file(entry.path(), copy_dir / name);
+                if (name.find(".tmp-checkpoints") != std::string::npos) {
+                    checkpoint_files.push_back(name);
+                }
+            }
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+    CHECK(checkpoint_files.empty() == (checkpoint_interval == 0));
+
+    WHEN("The copy is recovered")
+    {
+        auto recovered = pod5::recover_file_writer(
+            (copy_dir / "recovery_checkpoints.pod5").string(),
+            recovered_path,
+            {},
+            recovery_options);
+        REQUIRE_ARROW_STATUS_OK(recovered);
+        REQUIRE_ARROW_STATUS_OK((*recovered)->close());
+
+        THEN("Every read is recovered with its signal")
+        {
+            auto reader = pod5::open_file_reader(recovered_path);
+            REQUIRE_ARROW_STATUS_OK(reader);
+
+            pod5::AsyncSignalLoader loader(
+                *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 1);
+            std::size_t next_read = 0;
+            while (true) {
+                auto batch = loader.release_next_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                if (!*batch) {
+                    break;
+                }
+
+                auto read_batch = (*reader)->read_read_record_batch((*batch)->batch_index());
+                REQUIRE_ARROW_STATUS_OK(read_batch);
+                auto columns = read_batch->columns();
+                REQUIRE_ARROW_STATUS_OK(columns);
+                for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+                    auto const read_number = columns->read_number->Value(row);
+                    auto const samples = (*batch)->samples(row);
+                    CHECK(
+                        std::vector<std::int16_t>(samples.begin(), samples.end())
+                        == signal_for_read(read_number));
+                    next_read += 1;
+                }
+            }
+            CHECK(next_read == read_count);
+        }
+    }
+
+    THEN("Closing the writer removes its checkpoints")
+    {
+        for (auto const & name : checkpoint_files) {
+            CHECK(!std::filesystem::exists(name));
+        }
+    }
+}
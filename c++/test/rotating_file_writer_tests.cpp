@@ -0,0 +1,144 @@
+#include "pod5_format/rotating_file_writer.h"
+#include "pod5_format/async_signal_loader.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/array/array_dict.h>
+#include <arrow/array/array_primitive.h>
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+SCENARIO("Rotating output between files")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const path_for_file = [](std::size_t file_index) {
+        return "./rotating_writer_" + std::to_string(file_index) + ".pod5";
+    };
+    for (std::size_t i = 0; i < 10; ++i) {
+        REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(path_for_file(i)));
+    }
+
+    auto signal_for_read = [](std::size_t i) {
+        return std::vector<std::int16_t>(10 + i, std::int16_t(i));
+    };
+
+    std::size_t const read_count = 8;
+    // Either three reads each, or every read overflowing a tiny byte limit:
+    auto const rotate_by_bytes = GENERATE(false, true);
+    CAPTURE(rotate_by_bytes);
+    std::vector<std::size_t> const expected_reads_per_file =
+        rotate_by_bytes ? std::vector<std::size_t>(read_count, 1)
+                        : std::vector<std::size_t>{3, 3, 2};
+
+    auto const first_run_info = get_test_run_info_data("_first");
+    auto const second_run_info = get_test_run_info_data("_second");
+
+    pod5::RotatingFileWriterOptions options;
+    options.set_max_file_reads(rotate_by_bytes ? 0 : 3);
+    options.set_max_file_bytes(rotate_by_bytes ? 1 : 0);
+
+    {
+        pod5::RotatingFileWriter writer(path_for_file, "test_software", options);
+        auto first_run_info_index = writer.add_run_info(first_run_info);
+        REQUIRE_ARROW_STATUS_OK(first_run_info_index);
+        auto end_reason = writer.lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        REQUIRE_ARROW_STATUS_OK(end_reason);
+        auto pore_type = writer.add_pore_type("pore_type");
+        REQUIRE_ARROW_STATUS_OK(pore_type);
+
+        // Adding an entry again finds the existing one:
+        CHECK(writer.add_pore_type("pore_type") == *pore_type);
+        CHECK(writer.add_run_info(first_run_info) == *first_run_info_index);
+
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        pod5::RunInfoDictionaryIndex second_run_info_index = 0;
+        for (std::size_t i = 0; i < read_count; ++i) {
+            // Dictionary entries added after the first file started reach later files too:
+            if (i == 1) {
+                auto run_info_index = writer.add_run_info(second_run_info);
+                REQUIRE_ARROW_STATUS_OK(run_info_index);
+                second_run_info_index = *run_info_index;
+            }
+
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.start_sample = 0;
+            read_data.channel = 1;
+            read_data.well = 1;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.end_reason_forced = false;
+            read_data.run_info = i == 0 ? *first_run_info_index : second_run_info_index;
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(writer.add_complete_read(read_data, gsl::make_span(signal)));
+        }
+
+        REQUIRE_ARROW_STATUS_OK(writer.close());
+        CHECK(!writer.add_complete_read({}, {}).ok());
+
+        auto const paths = writer.paths();
+        REQUIRE(paths.size() == expected_reads_per_file.size());
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            CHECK(paths[i] == path_for_file(i));
+        }
+    }
+
+    THEN("Reads are split between the files in order")
+    {
+        std::size_t next_read = 0;
+        for (std::size_t file_index = 0; file_index < expected_reads_per_file.size(); ++file_index)
+        {
+            CAPTURE(file_index);
+            auto reader = pod5::open_file_reader(path_for_file(file_index));
+            REQUIRE_ARROW_STATUS_OK(reader);
+
+            pod5::AsyncSignalLoader loader(
+                *reader, pod5::AsyncSignalLoader::SamplesMode::Samples, {}, {}, 1);
+            std::size_t file_reads = 0;
+            while (true) {
+                auto batch = loader.release_next_batch();
+                REQUIRE_ARROW_STATUS_OK(batch);
+                if (!*batch) {
+                    break;
+                }
+
+                auto read_batch = (*reader)->read_read_record_batch((*batch)->batch_index());
+                REQUIRE_ARROW_STATUS_OK(read_batch);
+                auto columns = read_batch->columns();
+                REQUIRE_ARROW_STATUS_OK(columns);
+                for (std::size_t row = 0; row < (*batch)->sample_count().size(); ++row) {
+                    CHECK(columns->read_number->Value(row) == next_read);
+
+                    auto const samples = (*batch)->samples(row);
+                    CHECK(
+                        std::vector<std::int16_t>(samples.begin(), samples.end())
+                        == signal_for_read(next_read));
+
+                    auto const run_info_index =
+                        std::dynamic_pointer_cast<arrow::Int16Array>(columns->run_info->indices())
+                            ->Value(row);
+                    auto const acquisition_id = read_batch->get_run_info(run_info_index);
+                    REQUIRE_ARROW_STATUS_OK(acquisition_id);
+                    auto const run_info = (*reader)->find_run_info(*acquisition_id);
+                    REQUIRE_ARROW_STATUS_OK(run_info);
+                    CHECK(**run_info == (next_read == 0 ? first_run_info : second_run_info));
+
+                    next_read += 1;
+                    file_reads += 1;
+                }
+            }
+            CHECK(file_reads == expected_reads_per_file[file_index]);
+        }
+        CHECK(next_read == read_count);
+    }
+}
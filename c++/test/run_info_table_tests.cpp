@@ -114,6 +114,14 @@ SCENARIO("Run Info table Tests")
             auto found_run_info_1 = reader->find_run_info(run_info_data_1.acquisition_id);
             CHECK_ARROW_STATUS_OK(found_run_info_1);
             CHECK(**found_run_info_1 == run_info_data_1);
+
+            // Later lookups share the decoded run info, by acquisition id or index:
+            CHECK(*reader->find_run_info(run_info_data_0.acquisition_id) == *found_run_info_0);
+            CHECK(*reader->get_run_info(0) == *found_run_info_0);
+            CHECK(*reader->get_run_info(1) == *found_run_info_1);
+            CHECK(*reader->get_run_info_count() == 2);
+            CHECK(reader->get_run_info(2).status().IsIndexError());
+            CHECK(reader->find_run_info("not_an_acquisition_id").status().IsInvalid());
         }
     }
 }
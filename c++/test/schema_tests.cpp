@@ -33,3 +33,25 @@ SCENARIO("Version Tests")
 
     CHECK(Version(1, 200, 30).to_string() == "1.200.30");
 }
+
+SCENARIO("Schema metadata Tests")
+{
+    using namespace pod5;
+
+    SchemaMetadataDescription description;
+    description.file_identifier = *Uuid::from_string("d7c2a2a6-6c56-4b4c-9d6b-1e1c3e2f4a5b");
+    description.writing_software = "test_software";
+    description.writing_pod5_version = Version(1, 2, 3);
+    description.signal_compression_profile.level = 12;
+    description.signal_compression_profile.strategy = 7;
+
+    auto const metadata = make_schema_key_value_metadata(description);
+    REQUIRE_ARROW_STATUS_OK(metadata);
+
+    auto const parsed = read_schema_key_value_metadata(*metadata);
+    REQUIRE_ARROW_STATUS_OK(parsed);
+    CHECK(parsed->file_identifier == description.file_identifier);
+    CHECK(parsed->writing_software == description.writing_software);
+    CHECK(parsed->writing_pod5_version == description.writing_pod5_version);
+    CHECK(parsed->signal_compression_profile == description.signal_compression_profile);
+}
@@ -0,0 +1,194 @@
+#include "pod5_format/internal/sharded_lru_cache.h"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using Cache = pod5::ShardedLruCache<int>;
+
+namespace {
+
+auto load_value(int value, std::size_t byte_size, std::size_t * load_count = nullptr)
+{
+    return [=]() -> pod5::Result<Cache::LoadedValue> {
+        if (load_count) {
+            *load_count += 1;
+        }
+        return Cache::LoadedValue{value, byte_size};
+    };
+}
+
+}  // namespace
+
+TEST_CASE("Sharded LRU cache evicts by item count", "[sharded_lru_cache]")
+{
+    Cache cache(3, 0);
+
+    std::size_t load_count = 0;
+    for (std::size_t key = 0; key < 3; ++key) {
+        CHECK(*cache.get(key, load_value(int(key) * 10, 100, &load_count)) == int(key) * 10);
+    }
+    CHECK(load_count == 3);
+    CHECK(cache.item_count() == 3);
+    CHECK(cache.byte_size() == 300);
+
+    // Touch key 0, so key 1 is now the least recently used:
+    CHECK(*cache.get(0, load_value(-1, 100, &load_count)) == 0);
+    CHECK(load_count == 3);
+
+    CHECK(*cache.get(3, load_value(30, 100, &load_count)) == 30);
+    CHECK(load_count == 4);
+    CHECK(cache.item_count() == 3);
+    CHECK(!cache.contains(1));
+    CHECK(cache.contains(3));
+
+    // Keys 0, 2 and 3 are still cached:
+    CHECK(*cache.get(0, load_value(-1, 100, &load_count)) == 0);
+    CHECK(*cache.get(2, load_value(-1, 100, &load_count)) == 20);
+    CHECK(*cache.get(3, load_value(-1, 100, &load_count)) == 30);
+    CHECK(load_count == 4);
+
+    // Key 1 was evicted and loads again:
+    CHECK(*cache.get(1, load_value(11, 100, &load_count)) == 11);
+    CHECK(load_count == 5);
+    CHECK(cache.item_count() == 3);
+
+    auto const statistics = cache.statistics();
+    CHECK(statistics.hits == 4);
+    CHECK(statistics.misses == 5);
+    CHECK(statistics.evictions == 2);
+}
+
+TEST_CASE("Sharded LRU cache evicts by byte size", "[sharded_lru_cache]")
+{
+    Cache cache(0, 1000);
+
+    // Keys in the same shard and different shards alike are evicted oldest first:
+    for (std::size_t key = 0; key < 40; ++key) {
+        CHECK(*cache.get(key, load_value(int(key), 300)) == int(key));
+        CHECK(cache.byte_size() <= 1000);
+    }
+    CHECK(cache.item_count() == 3);
+
+    std::size_t load_count = 0;
+    for (std::size_t key = 37; key < 40; ++key) {
+        CHECK(*cache.get(key, load_value(-1, 300, &load_count)) == int(key));
+    }
+    CHECK(load_count == 0);
+
+    // An item larger than the limit is still kept, as the only cached item:
+    CHECK(*cache.get(100, load_value(100, 5000)) == 100);
+    CHECK(cache.item_count() == 1);
+    CHECK(cache.byte_size() == 5000);
+}
+
+TEST_CASE("Sharded LRU cache retries failed loads", "[sharded_lru_cache]")
+{
+    Cache cache(0, 0);
+
+    auto const failed = cache.get(5, []() -> pod5::Result<Cache::LoadedValue> {
+        return arrow::Status::IOError("Failed to load");
+    });
+    CHECK(!failed.ok());
+    CHECK(cache.item_count() == 0);
+
+    CHECK(*cache.get(5, load_value(5, 10)) == 5);
+    CHECK(cache.item_count() == 1);
+}
+
+TEST_CASE("Sharded LRU cache clears every item", "[sharded_lru_cache]")
+{
+    Cache cache(0, 0);
+    for (std::size_t key = 0; key < 40; ++key) {
+        CHECK(*cache.get(key, load_value(int(key), 10)) == int(key));
+    }
+    CHECK(cache.item_count() == 40);
+
+    cache.clear();
+    CHECK(cache.item_count() == 0);
+    CHECK(cache.byte_size() == 0);
+    CHECK(cache.statistics().evictions == 40);
+
+    std::size_t load_count = 0;
+    CHECK(*cache.get(3, load_value(30, 10, &load_count)) == 30);
+    CHECK(load_count == 1);
+}
+
+TEST_CASE("Sharded LRU cache evicts by an access plan", "[sharded_lru_cache]")
+{
+    std::vector<std::size_t> const plan{0, 1, 2, 0, 1, 3, 0};
+
+    // Least recently used eviction loads every lookup of the plan:
+    Cache lru_cache(2, 0);
+    std::size_t lru_load_count = 0;
+    for (auto const key : plan) {
+        CHECK(*lru_cache.get(key, load_value(int(key), 10, &lru_load_count)) == int(key));
+    }
+    CHECK(lru_load_count == plan.size());
+
+    Cache cache(2, 0);
+    cache.set_access_plan(plan);
+    CHECK(cache.has_access_plan());
+
+    std::size_t load_count = 0;
+    CHECK(*cache.get(0, load_value(0, 10, &load_count)) == 0);
+    CHECK(*cache.get(1, load_value(1, 10, &load_count)) == 1);
+    // Key 1 is next used after key 0, so it is the one evicted:
+    CHECK(*cache.get(2, load_value(2, 10, &load_count)) == 2);
+    CHECK(cache.contains(0));
+    CHECK(!cache.contains(1));
+    // Key 2 has no planned use left once key 0 is looked up again, so it is dropped:
+    CHECK(*cache.get(0, load_value(-1, 10, &load_count)) == 0);
+    CHECK(!cache.contains(2));
+    CHECK(cache.item_count() == 1);
+    CHECK(*cache.get(1, load_value(1, 10, &load_count)) == 1);
+    CHECK(*cache.get(3, load_value(3, 10, &load_count)) == 3);
+    CHECK(*cache.get(0, load_value(-1, 10, &load_count)) == 0);
+    CHECK(load_count == 5);
+
+    // Loading ahead doesn't move the plan on:
+    cache.set_access_plan({4, 5});
+    CHECK(*cache.load_ahead(5, load_value(5, 10, &load_count)) == 5);
+    CHECK(*cache.get(4, load_value(4, 10, &load_count)) == 4);
+    CHECK(cache.contains(5));
+
+    cache.clear_access_plan();
+    CHECK(!cache.has_access_plan());
+}
+
+TEST_CASE("Sharded LRU cache shares concurrent loads", "[sharded_lru_cache]")
+{
+    using namespace std::chrono_literals;
+
+    Cache cache(8, 0);
+
+    std::size_t const thread_count = 16;
+    std::size_t const key_count = 4;
+    std::atomic<std::size_t> load_count{0};
+    std::atomic<std::size_t> wrong_values{0};
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i] {
+            auto const key = i % key_count;
+            auto const result = cache.get(key, [&]() -> pod5::Result<Cache::LoadedValue> {
+                load_count += 1;
+                std::this_thread::sleep_for(50ms);
+                return Cache::LoadedValue{int(key), 1};
+            });
+            if (!result.ok() || *result != int(key)) {
+                wrong_values += 1;
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    CHECK(wrong_values == 0);
+    CHECK(load_count == key_count);
+    CHECK(cache.item_count() == key_count);
+}
@@ -0,0 +1,149 @@
+#include "pod5_format/crc32c.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/signal_table_reader.h"
+#include "pod5_format/signal_table_schema.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/array/array_primitive.h>
+#include <arrow/array/builder_primitive.h>
+#include <arrow/record_batch.h>
+#include <catch2/catch.hpp>
+
+#include <numeric>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+gsl::span<std::uint8_t const> as_bytes(std::string_view str)
+{
+    return gsl::make_span(reinterpret_cast<std::uint8_t const *>(str.data()), str.size());
+}
+
+}  // namespace
+
+SCENARIO("CRC32C checksums")
+{
+    CHECK(pod5::crc32c({}) == 0);
+    CHECK(pod5::crc32c(as_bytes("123456789")) == 0xE3069283);
+
+    std::vector<std::uint8_t> const zeros(32, 0);
+    CHECK(pod5::crc32c(gsl::make_span(zeros)) == 0x8A9136AA);
+
+    // Data given in pieces checksums as it does whole, whatever the alignment of the pieces:
+    std::vector<std::uint8_t> data(1000);
+    std::iota(data.begin(), data.end(), std::uint8_t(0));
+    auto const whole = pod5::crc32c(gsl::make_span(data));
+    for (std::size_t split : {1, 7, 8, 13, 999}) {
+        auto const span = gsl::make_span(data);
+        CHECK(pod5::crc32c(span.subspan(split), pod5::crc32c(span.subspan(0, split))) == whole);
+    }
+}
+
+SCENARIO("Signal rows checked against their checksums")
+{
+    static constexpr char const * file = "./signal_checksums.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const signal_type =
+        GENERATE(pod5::SignalType::UncompressedSignal, pod5::SignalType::VbzSignal);
+    auto const write_checksums = GENERATE(true, false);
+    CAPTURE(signal_type, write_checksums);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    auto const signal_for_read = [](std::size_t i) {
+        std::vector<std::int16_t> signal(1000 + i * 100);
+        std::iota(signal.begin(), signal.end(), std::int16_t(i));
+        return signal;
+    };
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_type(signal_type);
+        options.set_write_signal_checksums(write_checksums);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        CHECK((*writer)->writes_signal_checksums() == write_checksums);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+        for (std::size_t i = 0; i < 4; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            CHECK_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    CHECK((*reader)->has_signal_checksums() == write_checksums);
+
+    auto const batch = (*reader)->read_signal_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(batch);
+    REQUIRE(batch->num_rows() == 4);
+    for (std::size_t row = 0; row < batch->num_rows(); ++row) {
+        auto const expected = signal_for_read(row);
+        std::vector<std::int16_t> samples(expected.size());
+        REQUIRE_ARROW_STATUS_OK(batch->extract_signal_row(row, gsl::make_span(samples)));
+        CHECK(samples == expected);
+    }
+
+    if (!write_checksums) {
+        CHECK(!batch->checksum_column());
+        CHECK(batch->verify_signal_checksum(0).IsInvalid());
+        return;
+    }
+    REQUIRE(batch->checksum_column());
+    for (std::size_t row = 0; row < batch->num_rows(); ++row) {
+        CHECK_ARROW_STATUS_OK(batch->verify_signal_checksum(row));
+    }
+
+    // Rows whose stored signal no longer matches their checksum, as if the signal was corrupt:
+    arrow::UInt32Builder corrupt_checksums;
+    auto const checksums = batch->checksum_column();
+    for (std::int64_t row = 0; row < checksums->length(); ++row) {
+        REQUIRE_ARROW_STATUS_OK(corrupt_checksums.Append(checksums->Value(row) ^ 1));
+    }
+    auto const checksum_field = batch->batch()->schema()->GetFieldIndex("checksum");
+    auto corrupt_column = corrupt_checksums.Finish();
+    REQUIRE_ARROW_STATUS_OK(corrupt_column);
+    auto corrupt_batch = batch->batch()->SetColumn(
+        checksum_field, arrow::field("checksum", arrow::uint32()), *corrupt_column);
+    REQUIRE_ARROW_STATUS_OK(corrupt_batch);
+    auto field_locations = pod5::read_signal_table_schema((*corrupt_batch)->schema());
+    REQUIRE_ARROW_STATUS_OK(field_locations);
+
+    for (std::size_t checksum_interval : {0, 1, 2}) {
+        CAPTURE(checksum_interval);
+        field_locations->checksum_interval = checksum_interval;
+        pod5::SignalTableRecordBatch const corrupt(
+            *corrupt_batch, *field_locations, arrow::default_memory_pool());
+
+        for (std::size_t row = 0; row < corrupt.num_rows(); ++row) {
+            CAPTURE(row);
+            CHECK(corrupt.verify_signal_checksum(row).IsIOError());
+
+            // Rows are checked as they are decoded if the interval covers them:
+            std::vector<std::int16_t> samples(signal_for_read(row).size());
+            auto const status = corrupt.extract_signal_row(row, gsl::make_span(samples));
+            bool const checked = checksum_interval != 0 && row % checksum_interval == 0;
+            CHECK(status.IsIOError() == checked);
+            CHECK(status.ok() == !checked);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/signal_chunking.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/array/array_primitive.h>
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+SCENARIO("Signal chunk sizes")
+{
+    CHECK(pod5::SignalChunker::make({}).status().IsInvalid());
+    CHECK(pod5::SignalChunker::make({4000, 0}).status().IsInvalid());
+
+    auto chunker = pod5::SignalChunker::make({1000, 4000, 1000});
+    REQUIRE_ARROW_STATUS_OK(chunker);
+    CHECK(chunker->chunk_sizes() == std::vector<std::uint32_t>{4000, 1000});
+    CHECK(chunker->max_chunk_size() == 4000);
+
+    CHECK(chunker->plan(0).empty());
+    CHECK(chunker->plan(500) == std::vector<std::uint32_t>{500});
+    CHECK(chunker->plan(4000) == std::vector<std::uint32_t>{4000});
+    CHECK(chunker->plan(9500) == std::vector<std::uint32_t>{4000, 4000, 1000, 500});
+    CHECK(chunker->plan(10'000) == std::vector<std::uint32_t>{4000, 4000, 1000, 1000});
+}
+
+SCENARIO("Reads written with signal chunk sizes")
+{
+    static constexpr char const * file = "./signal_chunking.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const use_producer = GENERATE(true, false);
+    auto const max_compression_jobs = GENERATE(0, 2);
+    CAPTURE(use_producer, max_compression_jobs);
+
+    // Sizes which are multiples of a 500 sample window:
+    std::vector<std::uint32_t> const chunk_sizes{3000, 1000, 500};
+    auto chunker = pod5::SignalChunker::make(chunk_sizes);
+    REQUIRE_ARROW_STATUS_OK(chunker);
+
+    std::vector<std::size_t> const read_lengths{0, 250, 500, 2750, 3000, 7600, 10'000};
+    std::vector<std::int16_t> signal(10'000);
+    std::iota(signal.begin(), signal.end(), 0);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_chunk_sizes(chunk_sizes);
+        options.set_max_compression_jobs(max_compression_jobs);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        auto producer = (*writer)->create_producer(3);
+        for (std::size_t i = 0; i < read_lengths.size(); ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = std::uint32_t(i);
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const read_signal = gsl::make_span(signal).subspan(0, read_lengths[i]);
+            if (use_producer) {
+                CHECK_ARROW_STATUS_OK(producer->add_complete_read(read_data, read_signal));
+            } else {
+                CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(read_data, read_signal));
+            }
+        }
+        CHECK_ARROW_STATUS_OK(producer->flush());
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    auto const batch = (*reader)->read_read_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(batch);
+    REQUIRE(batch->num_rows() == std::int64_t(read_lengths.size()));
+
+    auto const signal_column = batch->signal_column();
+    for (std::size_t row = 0; row < read_lengths.size(); ++row) {
+        CAPTURE(row);
+        auto const rows =
+            std::static_pointer_cast<arrow::UInt64Array>(signal_column->value_slice(row));
+        auto const rows_span = gsl::make_span(rows->raw_values(), rows->length());
+
+        // Boundaries fall where the chunker splits the read, each on a window boundary:
+        std::vector<std::uint64_t> expected_boundaries{0};
+        for (auto const size : chunker->plan(read_lengths[row])) {
+            expected_boundaries.push_back(expected_boundaries.back() + size);
+        }
+        auto const boundaries = (*reader)->extract_chunk_boundaries(rows_span);
+        REQUIRE_ARROW_STATUS_OK(boundaries);
+        CHECK(*boundaries == expected_boundaries);
+        for (std::size_t i = 0; i + 1 < boundaries->size(); ++i) {
+            CHECK((*boundaries)[i] % 500 == 0);
+        }
+
+        std::vector<std::int16_t> samples(read_lengths[row]);
+        REQUIRE_ARROW_STATUS_OK((*reader)->extract_samples(rows_span, gsl::make_span(samples)));
+        CHECK(std::equal(samples.begin(), samples.end(), signal.begin()));
+    }
+}
+
+SCENARIO("Writers refuse invalid signal chunk sizes")
+{
+    static constexpr char const * file = "./signal_chunking_invalid.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+
+    pod5::FileWriterOptions options;
+    options.set_signal_chunk_sizes({4000, 0});
+    CHECK(pod5::create_file_writer(file, "test_software", options).status().IsInvalid());
+}
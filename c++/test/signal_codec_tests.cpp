@@ -0,0 +1,306 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/signal_codec.h"
+#include "pod5_format/signal_table_reader.h"
+#include "pod5_format/uuid.h"
+
+#include "test_utils.h"
+#include "utils.h"
+
+#include <catch2/catch.hpp>
+#include <gsl/gsl-lite.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Stores samples as they are, after a marker byte, counting the batched decodes it is asked for.
+class StoredSignalCodec : public pod5::SignalCodec {
+public:
+    static constexpr std::uint8_t MARKER = 0x5a;
+
+    std::string id() const override { return "test_stored"; }
+
+    std::size_t max_compressed_size(std::size_t sample_count) const override
+    {
+        return 1 + sample_count * sizeof(pod5::SampleType);
+    }
+
+    pod5::Result<std::size_t> compress(
+        gsl::span<pod5::SampleType const> const & samples,
+        pod5::SignalCompressionContext &,
+        gsl::span<std::uint8_t> const & destination) const override
+    {
+        auto const size = max_compressed_size(samples.size());
+        if (destination.size() < size) {
+            return pod5::Status::Invalid("Destination too small");
+        }
+        destination[0] = MARKER;
+        std::memcpy(destination.data() + 1, samples.data(), samples.size_bytes());
+        return size;
+    }
+
+    pod5::Status decompress(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        pod5::SignalCompressionContext &,
+        gsl::span<pod5::SampleType> const & destination) const override
+    {
+        if (compressed_bytes.size() != max_compressed_size(destination.size())
+            || compressed_bytes[0] != MARKER)
+        {
+            return pod5::Status::Invalid("Invalid stored signal");
+        }
+        std::memcpy(destination.data(), compressed_bytes.data() + 1, destination.size_bytes());
+        return pod5::Status::OK();
+    }
+
+    pod5::Status decompress_rows(
+        gsl::span<gsl::span<std::uint8_t const> const> const & compressed_rows,
+        pod5::SignalCompressionContext & context,
+        gsl::span<gsl::span<pod5::SampleType> const> const & destinations) const override
+    {
+        batch_decodes += 1;
+        return SignalCodec::decompress_rows(compressed_rows, context, destinations);
+    }
+
+    mutable std::atomic<std::size_t> batch_decodes{0};
+};
+
+// Decodes vbz signal through the built in codec, counting the batched decodes it is asked for.
+class CountingVbzDecoder : public pod5::SignalCodec {
+public:
+    std::string id() const override { return "test_counting_vbz"; }
+
+    std::size_t max_compressed_size(std::size_t sample_count) const override
+    {
+        return m_vbz->max_compressed_size(sample_count);
+    }
+
+    pod5::Result<std::size_t> compress(
+        gsl::span<pod5::SampleType const> const & samples,
+        pod5::SignalCompressionContext & context,
+        gsl::span<std::uint8_t> const & destination) const override
+    {
+        return m_vbz->compress(samples, context, destination);
+    }
+
+    pod5::Status decompress(
+        gsl::span<std::uint8_t const> const & compressed_bytes,
+        pod5::SignalCompressionContext & context,
+        gsl::span<pod5::SampleType> const & destination) const override
+    {
+        return m_vbz->decompress(compressed_bytes, context, destination);
+    }
+
+    pod5::Status decompress_rows(
+        gsl::span<gsl::span<std::uint8_t const> const> const & compressed_rows,
+        pod5::SignalCompressionContext & context,
+        gsl::span<gsl::span<pod5::SampleType> const> const & destinations) const override
+    {
+        batch_decodes += 1;
+        decoded_rows += compressed_rows.size();
+        return m_vbz->decompress_rows(compressed_rows, context, destinations);
+    }
+
+    mutable std::atomic<std::size_t> batch_decodes{0};
+    mutable std::atomic<std::size_t> decoded_rows{0};
+
+private:
+    std::shared_ptr<pod5::SignalCodec const> m_vbz = pod5::vbz_signal_codec();
+};
+
+}  // namespace
+
+TEST_CASE("Signal codec registry")
+{
+    auto const vbz = pod5::find_signal_codec(pod5::VBZ_SIGNAL_CODEC_ID);
+    REQUIRE_ARROW_STATUS_OK(vbz);
+    CHECK(*vbz == pod5::vbz_signal_codec());
+    CHECK(!pod5::unregister_signal_codec(pod5::VBZ_SIGNAL_CODEC_ID).ok());
+
+    auto const codec = std::make_shared<StoredSignalCodec>();
+    CHECK(pod5::find_signal_codec(codec->id()).status().IsNotImplemented());
+    REQUIRE_ARROW_STATUS_OK(pod5::register_signal_codec(codec));
+    CHECK(!pod5::register_signal_codec(codec).ok());
+
+    auto const found = pod5::find_signal_codec(codec->id());
+    REQUIRE_ARROW_STATUS_OK(found);
+    CHECK(*found == codec);
+
+    REQUIRE_ARROW_STATUS_OK(pod5::unregister_signal_codec(codec->id()));
+    CHECK(!pod5::find_signal_codec(codec->id()).ok());
+    CHECK(!pod5::unregister_signal_codec(codec->id()).ok());
+
+    // The default calibrated decode goes through decompress():
+    std::vector<std::int16_t> const samples{1, -2, 30};
+    std::vector<std::uint8_t> compressed(codec->max_compressed_size(samples.size()));
+    auto & context = pod5::thread_local_signal_compression_context();
+    REQUIRE_ARROW_STATUS_OK(
+        codec->compress(gsl::make_span(samples), context, gsl::make_span(compressed)));
+    std::vector<float> calibrated(samples.size());
+    REQUIRE_ARROW_STATUS_OK(codec->decompress_calibrated(
+        gsl::make_span(compressed), context, {1.0f, 0.5f}, gsl::make_span(calibrated)));
+    CHECK(calibrated == std::vector<float>{1.0f, -0.5f, 15.5f});
+}
+
+SCENARIO("Writing and reading files with a registered signal codec")
+{
+    static constexpr char const * file = "./signal_codec.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const codec = std::make_shared<StoredSignalCodec>();
+    REQUIRE_ARROW_STATUS_OK(pod5::register_signal_codec(codec));
+    auto unregister = gsl::finally([&] { (void)pod5::unregister_signal_codec(codec->id()); });
+
+    auto const use_thread_pool = GENERATE(true, false);
+    CAPTURE(use_thread_pool);
+
+    auto signal_for_read = [](std::size_t i) {
+        std::vector<std::int16_t> signal(100 + i * 10);
+        for (std::size_t j = 0; j < signal.size(); ++j) {
+            signal[j] = std::int16_t(i * 1000 + j);
+        }
+        return signal;
+    };
+
+    std::size_t const read_count = 10;
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_type(pod5::SignalType::CodecSignal);
+        options.set_signal_codec(codec);
+        options.set_signal_table_batch_size(4);
+        options.set_max_compression_jobs(use_thread_pool ? 2 : 0);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        CHECK((*writer)->signal_type() == pod5::SignalType::CodecSignal);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file, {});
+    REQUIRE_ARROW_STATUS_OK(reader);
+    CHECK((*reader)->signal_type() == pod5::SignalType::CodecSignal);
+
+    // Rows of the same batch decode together:
+    std::vector<std::uint64_t> rows(read_count);
+    std::iota(rows.begin(), rows.end(), 0);
+    std::vector<std::int16_t> expected;
+    for (std::size_t i = 0; i < read_count; ++i) {
+        auto const signal = signal_for_read(i);
+        expected.insert(expected.end(), signal.begin(), signal.end());
+    }
+    std::vector<std::int16_t> samples(expected.size());
+    REQUIRE_ARROW_STATUS_OK(
+        (*reader)->extract_samples(gsl::make_span(rows), gsl::make_span(samples)));
+    CHECK(samples == expected);
+    CHECK(codec->batch_decodes == 3);
+
+    WHEN("The codec isn't registered")
+    {
+        // The signal table can't be opened without its codec:
+        REQUIRE_ARROW_STATUS_OK(pod5::unregister_signal_codec(codec->id()));
+        auto const unregistered_reader = pod5::open_file_reader(file, {});
+        CHECK(unregistered_reader.status().IsNotImplemented());
+        REQUIRE_ARROW_STATUS_OK(pod5::register_signal_codec(codec));
+    }
+}
+
+SCENARIO("Decoding vbz files through a replacement decoder")
+{
+    static constexpr char const * file = "./vbz_signal_decoder.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const signal_type =
+        GENERATE(pod5::SignalType::VbzSignal, pod5::SignalType::UncompressedSignal);
+    CAPTURE(signal_type);
+
+    std::vector<std::vector<std::int16_t>> signals;
+    {
+        pod5::FileWriterOptions options;
+        options.set_signal_type(signal_type);
+        options.set_signal_table_batch_size(5);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+
+        std::mt19937 gen{Catch::rngSeed()};
+        auto uuid_gen = pod5::UuidRandomGenerator{gen};
+        for (std::size_t i = 0; i < 5; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            signals.emplace_back(200 + i * 30);
+            std::iota(signals.back().begin(), signals.back().end(), std::int16_t(i * 7));
+            REQUIRE_ARROW_STATUS_OK(
+                (*writer)->add_complete_read(read_data, gsl::make_span(signals.back())));
+        }
+        REQUIRE_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto const decoder = std::make_shared<CountingVbzDecoder>();
+    pod5::FileReaderOptions reader_options;
+    reader_options.set_vbz_signal_decoder(decoder);
+    auto reader = pod5::open_file_reader(file, reader_options);
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    auto const batch = (*reader)->read_signal_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(batch);
+    auto const offsets = batch->signal_row_offsets();
+    REQUIRE(offsets.size() == signals.size() + 1);
+
+    // The whole batch is decoded by one call, one row after another:
+    std::vector<std::int16_t> samples(offsets.back());
+    REQUIRE_ARROW_STATUS_OK(batch->extract_all_signal_rows(
+        gsl::make_span(samples), pod5::thread_local_signal_compression_context()));
+    for (std::size_t i = 0; i < signals.size(); ++i) {
+        CHECK(std::equal(
+            signals[i].begin(),
+            signals[i].end(),
+            samples.begin() + offsets[i],
+            samples.begin() + offsets[i + 1]));
+    }
+
+    // Only vbz files are decoded by the replacement:
+    if (signal_type == pod5::SignalType::VbzSignal) {
+        CHECK(decoder->batch_decodes == 1);
+        CHECK(decoder->decoded_rows == signals.size());
+    } else {
+        CHECK(decoder->batch_decodes == 0);
+    }
+
+    std::vector<std::int16_t> too_few(offsets.back() - 1);
+    CHECK_ARROW_STATUS_NOT_OK(batch->extract_all_signal_rows(
+        gsl::make_span(too_few), pod5::thread_local_signal_compression_context()));
+}
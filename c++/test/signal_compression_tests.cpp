@@ -1,4 +1,5 @@
 #include "pod5_format/signal_compression.h"
+#include "pod5_format/thread_pool.h"
 
 #include "test_utils.h"
 #include "utils.h"
@@ -8,6 +9,9 @@
 #include <catch2/catch.hpp>
 #include <gsl/gsl-lite.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <numeric>
 
 SCENARIO("Signal compression Tests")
@@ -28,3 +32,359 @@ SCENARIO("Signal compression Tests")
 
     CHECK(gsl::make_span(signal) == decompressed_span);
 }
+
+SCENARIO("Signal compression context reuse Tests")
+{
+    pod5::SignalCompressionContext context(arrow::system_memory_pool());
+
+    // Alternate between large and small signals to check the scratch space is resized correctly:
+    for (std::size_t sample_count : {10'000, 100, 50'000, 4'000}) {
+        std::vector<std::int16_t> signal(sample_count);
+        std::iota(signal.begin(), signal.end(), -100);
+
+        std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(signal.size()));
+        auto compressed_size =
+            pod5::compress_signal(gsl::make_span(signal), context, gsl::make_span(compressed));
+        REQUIRE_ARROW_STATUS_OK(compressed_size);
+        compressed.resize(*compressed_size);
+
+        std::vector<std::int16_t> decompressed(signal.size());
+        REQUIRE_ARROW_STATUS_OK(pod5::decompress_signal(
+            gsl::make_span(compressed), context, gsl::make_span(decompressed)));
+        CHECK(signal == decompressed);
+    }
+}
+
+SCENARIO("Signal streaming decompression Tests")
+{
+    pod5::SignalCompressionContext context(arrow::system_memory_pool());
+
+    auto sample_count = GENERATE(7, 64, 1000, 100'003, 1'000'000);
+    std::vector<std::int16_t> signal(sample_count);
+    std::uint32_t state = 12345;
+    for (auto & sample : signal) {
+        // Mix of small and large steps, so both 1 and 2 byte svb16 encodings are exercised:
+        state = state * 1103515245 + 12345;
+        sample = static_cast<std::int16_t>((state >> 16) % ((state & 0x100) ? 4000 : 60));
+    }
+
+    std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(signal.size()));
+    auto compressed_size =
+        pod5::compress_signal(gsl::make_span(signal), context, gsl::make_span(compressed));
+    REQUIRE_ARROW_STATUS_OK(compressed_size);
+    compressed.resize(*compressed_size);
+
+    std::vector<std::int16_t> decompressed(signal.size());
+    REQUIRE_ARROW_STATUS_OK(pod5::decompress_signal_streaming(
+        gsl::make_span(compressed), context, gsl::make_span(decompressed)));
+    CHECK(signal == decompressed);
+
+    std::vector<std::int16_t> buffered(signal.size());
+    REQUIRE_ARROW_STATUS_OK(pod5::decompress_signal_buffered(
+        gsl::make_span(compressed), context, gsl::make_span(buffered)));
+    CHECK(signal == buffered);
+
+    WHEN("The compressed data is truncated")
+    {
+        auto truncated = gsl::make_span(compressed).first(compressed.size() - 1);
+        CHECK_ARROW_STATUS_NOT_OK(pod5::decompress_signal_streaming(
+            truncated, context, gsl::make_span(decompressed)));
+    }
+
+    WHEN("Too many samples are requested")
+    {
+        std::vector<std::int16_t> too_large(signal.size() + 8);
+        CHECK_ARROW_STATUS_NOT_OK(pod5::decompress_signal_streaming(
+            gsl::make_span(compressed), context, gsl::make_span(too_large)));
+    }
+}
+
+SCENARIO("Signal calibrated decompression Tests")
+{
+    pod5::SignalCompressionContext context(arrow::system_memory_pool());
+
+    // Sizes either side of the calibration tile, and one large enough to take the streaming path:
+    auto sample_count = GENERATE(0, 5, 2048, 2049, 100'003, 5'000'000);
+    std::vector<std::int16_t> signal(sample_count);
+    std::uint32_t state = 54321;
+    for (auto & sample : signal) {
+        state = state * 1103515245 + 12345;
+        sample = static_cast<std::int16_t>((state >> 16) % ((state & 0x100) ? 4000 : 60)) - 30;
+    }
+
+    std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(signal.size()));
+    auto compressed_size =
+        pod5::compress_signal(gsl::make_span(signal), context, gsl::make_span(compressed));
+    REQUIRE_ARROW_STATUS_OK(compressed_size);
+    compressed.resize(*compressed_size);
+
+    pod5::SignalCalibration const calibration{21.5f, 0.1825f};
+    std::vector<float> expected(signal.size());
+    for (std::size_t i = 0; i < signal.size(); ++i) {
+        expected[i] = (signal[i] + calibration.offset) * calibration.scale;
+    }
+
+    std::vector<float> calibrated(signal.size());
+    pod5::calibrate_signal(gsl::make_span(signal), calibration, gsl::make_span(calibrated));
+    CHECK(calibrated == expected);
+
+    std::vector<float> decompressed(signal.size());
+    REQUIRE_ARROW_STATUS_OK(pod5::decompress_signal_calibrated(
+        gsl::make_span(compressed), context, calibration, gsl::make_span(decompressed)));
+    CHECK(decompressed == expected);
+
+    WHEN("Decompressing to half precision")
+    {
+        std::vector<pod5::Float16> decompressed_half(signal.size());
+        REQUIRE_ARROW_STATUS_OK(pod5::decompress_signal_calibrated(
+            gsl::make_span(compressed), context, calibration, gsl::make_span(decompressed_half)));
+        for (std::size_t i = 0; i < signal.size(); ++i) {
+            INFO("Sample " << i);
+            REQUIRE(decompressed_half[i].bits == pod5::Float16::from_float(expected[i]).bits);
+        }
+    }
+
+    WHEN("Decompressing to 8 bit levels")
+    {
+        pod5::SignalCalibration const levels{30.0f, 0.25f};
+        std::vector<std::int8_t> expected_levels(signal.size());
+        for (std::size_t i = 0; i < signal.size(); ++i) {
+            auto const level = std::nearbyint((signal[i] + levels.offset) * levels.scale);
+            expected_levels[i] = static_cast<std::int8_t>(std::clamp(level, -128.0f, 127.0f));
+        }
+
+        std::vector<std::int8_t> decompressed_levels(signal.size());
+        REQUIRE_ARROW_STATUS_OK(pod5::decompress_signal_calibrated(
+            gsl::make_span(compressed), context, levels, gsl::make_span(decompressed_levels)));
+        CHECK(decompressed_levels == expected_levels);
+    }
+
+    WHEN("Too many samples are requested")
+    {
+        std::vector<float> too_large(signal.size() + 8);
+        CHECK_ARROW_STATUS_NOT_OK(pod5::decompress_signal_calibrated(
+            gsl::make_span(compressed), context, calibration, gsl::make_span(too_large)));
+    }
+}
+
+TEST_CASE("Half precision conversion")
+{
+    auto const bits_of = [](float value) { return pod5::Float16::from_float(value).bits; };
+
+    CHECK(bits_of(0.0f) == 0x0000);
+    CHECK(bits_of(-0.0f) == 0x8000);
+    CHECK(bits_of(1.0f) == 0x3c00);
+    CHECK(bits_of(-2.5f) == 0xc100);
+    CHECK(bits_of(65504.0f) == 0x7bff);
+    // Past the largest half, and a tie rounding to even, which is infinity:
+    CHECK(bits_of(70000.0f) == 0x7c00);
+    CHECK(bits_of(65520.0f) == 0x7c00);
+    CHECK(bits_of(-std::numeric_limits<float>::infinity()) == 0xfc00);
+    CHECK((bits_of(std::numeric_limits<float>::quiet_NaN()) & 0x7fff) > 0x7c00);
+    // Ties round to the even neighbour:
+    CHECK(bits_of(1.0f + 1.0f / 2048) == 0x3c00);
+    CHECK(bits_of(1.0f + 3.0f / 2048) == 0x3c02);
+    // Subnormals, and values too small for them:
+    CHECK(bits_of(std::ldexp(1.0f, -24)) == 0x0001);
+    CHECK(bits_of(std::ldexp(3.0f, -25)) == 0x0002);
+    CHECK(bits_of(std::ldexp(1.0f, -25)) == 0x0000);
+    CHECK(bits_of(std::ldexp(1023.0f, -24)) == 0x03ff);
+
+    // Every finite half converts to a float and back unchanged:
+    for (std::uint32_t bits = 0; bits <= 0xffff; ++bits) {
+        pod5::Float16 const half{static_cast<std::uint16_t>(bits)};
+        if ((bits & 0x7c00) == 0x7c00) {
+            continue;
+        }
+        INFO("Half bits " << bits);
+        REQUIRE(bits_of(half.to_float()) == bits);
+    }
+    CHECK(pod5::Float16{0x7c00}.to_float() == std::numeric_limits<float>::infinity());
+    CHECK(pod5::Float16{0x0001}.to_float() == std::ldexp(1.0f, -24));
+}
+
+SCENARIO("Signal batch compression Tests")
+{
+    auto thread_pool = pod5::make_thread_pool(4);
+
+    auto const read_count = GENERATE(0, 1, 5, 300);
+    CAPTURE(read_count);
+
+    std::vector<std::vector<std::int16_t>> signals(read_count);
+    std::vector<gsl::span<std::int16_t const>> signal_spans;
+    for (std::size_t i = 0; i < signals.size(); ++i) {
+        // Vary read lengths so some tasks hold many reads and others only one:
+        signals[i].resize((i * 7919) % 400'000);
+        std::iota(signals[i].begin(), signals[i].end(), static_cast<std::int16_t>(i));
+        signal_spans.emplace_back(signals[i]);
+    }
+
+    auto batch = pod5::compress_signal_batch(
+        gsl::make_span(signal_spans), *thread_pool, arrow::system_memory_pool());
+    REQUIRE_ARROW_STATUS_OK(batch);
+    REQUIRE(batch->size() == signals.size());
+    CHECK(batch->offsets.back() == std::size_t(batch->data->size()));
+
+    auto & context = pod5::thread_local_signal_compression_context();
+    for (std::size_t i = 0; i < signals.size(); ++i) {
+        std::vector<std::int16_t> decompressed(signals[i].size());
+        REQUIRE_ARROW_STATUS_OK(
+            pod5::decompress_signal(batch->signal(i), context, gsl::make_span(decompressed)));
+        CHECK(decompressed == signals[i]);
+    }
+
+    WHEN("The destination is too small")
+    {
+        std::vector<std::uint8_t> destination(batch->offsets.back());
+        std::vector<std::size_t> offsets(signals.size() + 1);
+        auto const status = pod5::compress_signal_batch(
+            gsl::make_span(signal_spans),
+            *thread_pool,
+            gsl::make_span(destination),
+            gsl::make_span(offsets));
+        if (read_count > 0) {
+            CHECK_ARROW_STATUS_NOT_OK(status);
+        }
+    }
+}
+
+SCENARIO("Signal compression profile Tests")
+{
+    std::vector<std::int16_t> signal(100'000);
+    std::uint32_t state = 7;
+    for (std::size_t i = 0; i < signal.size(); ++i) {
+        // Repeating levels with a little noise, so higher levels find longer matches:
+        state = state * 1103515245 + 12345;
+        signal[i] = static_cast<std::int16_t>(500 + (i % 2000) / 20 + (state >> 16) % 4);
+    }
+
+    auto compress = [&](pod5::SignalCompressionContext & context) {
+        std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(signal.size()));
+        auto compressed_size =
+            pod5::compress_signal(gsl::make_span(signal), context, gsl::make_span(compressed));
+        REQUIRE_ARROW_STATUS_OK(compressed_size);
+        compressed.resize(*compressed_size);
+        return compressed;
+    };
+
+    pod5::SignalCompressionContext default_context;
+    auto const default_compressed = compress(default_context);
+
+    pod5::SignalCompressionProfile archive_profile;
+    archive_profile.level = 19;
+    archive_profile.strategy = 9;
+    CHECK_ARROW_STATUS_OK(pod5::check_signal_compression_profile(archive_profile));
+
+    pod5::SignalCompressionContext archive_context{nullptr, archive_profile};
+    CHECK(archive_context.profile() == archive_profile);
+    auto const archive_compressed = compress(archive_context);
+    CHECK(archive_compressed.size() <= default_compressed.size());
+
+    std::vector<std::int16_t> decompressed(signal.size());
+    REQUIRE_ARROW_STATUS_OK(pod5::decompress_signal(
+        gsl::make_span(archive_compressed), default_context, gsl::make_span(decompressed)));
+    CHECK(decompressed == signal);
+
+    WHEN("Switching a context back to the default profile")
+    {
+        archive_context.set_profile({});
+        CHECK(compress(archive_context) == default_compressed);
+    }
+
+    WHEN("The profile is invalid")
+    {
+        pod5::SignalCompressionProfile invalid_profile;
+        invalid_profile.strategy = 100;
+        CHECK_ARROW_STATUS_NOT_OK(pod5::check_signal_compression_profile(invalid_profile));
+
+        pod5::SignalCompressionContext invalid_context{nullptr, invalid_profile};
+        std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(signal.size()));
+        CHECK_ARROW_STATUS_NOT_OK(pod5::compress_signal(
+            gsl::make_span(signal), invalid_context, gsl::make_span(compressed)));
+    }
+
+    WHEN("Formatting a profile for metadata")
+    {
+        auto const parsed =
+            pod5::parse_signal_compression_profile(pod5::to_string(archive_profile));
+        REQUIRE_ARROW_STATUS_OK(parsed);
+        CHECK(*parsed == archive_profile);
+
+        auto const partial = pod5::parse_signal_compression_profile("zstd_level=5;future_key=2");
+        REQUIRE_ARROW_STATUS_OK(partial);
+        CHECK(partial->level == 5);
+        CHECK(partial->strategy == 0);
+
+        CHECK_ARROW_STATUS_NOT_OK(pod5::parse_signal_compression_profile("zstd_level"));
+        CHECK_ARROW_STATUS_NOT_OK(pod5::parse_signal_compression_profile("zstd_level=1x"));
+    }
+}
+
+SCENARIO("Signal compression dictionary Tests")
+{
+    // Short reads sharing structure, as seen when many reads are rejected early:
+    std::uint32_t state = 99;
+    auto make_read = [&](std::size_t sample_count) {
+        std::vector<std::int16_t> read(sample_count);
+        auto const level = static_cast<std::int16_t>(400 + (state >> 16) % 200);
+        for (std::size_t i = 0; i < read.size(); ++i) {
+            state = state * 1103515245 + 12345;
+            read[i] = static_cast<std::int16_t>(level + (i / 50 % 4) * 30 + (state >> 16) % 8);
+        }
+        return read;
+    };
+
+    std::vector<std::vector<std::int16_t>> training_reads;
+    std::vector<gsl::span<std::int16_t const>> training_spans;
+    for (std::size_t i = 0; i < 500; ++i) {
+        training_reads.push_back(make_read(1000 + i % 1000));
+    }
+    for (auto const & read : training_reads) {
+        training_spans.emplace_back(read);
+    }
+
+    auto dictionary = pod5::train_signal_compression_dictionary(
+        gsl::make_span(training_spans), 16 * 1024);
+    REQUIRE_ARROW_STATUS_OK(dictionary);
+    CHECK((*dictionary)->id() != 0);
+
+    auto reloaded = pod5::SignalCompressionDictionary::make((*dictionary)->data());
+    REQUIRE_ARROW_STATUS_OK(reloaded);
+    CHECK((*reloaded)->id() == (*dictionary)->id());
+
+    pod5::SignalCompressionContext plain_context;
+    pod5::SignalCompressionContext dictionary_context;
+    dictionary_context.set_dictionary(*dictionary);
+
+    std::size_t plain_size = 0;
+    std::size_t dictionary_size = 0;
+    for (std::size_t i = 0; i < 20; ++i) {
+        auto const read = make_read(1500);
+        std::vector<std::uint8_t> compressed(pod5::compressed_signal_max_size(read.size()));
+
+        auto size = pod5::compress_signal(
+            gsl::make_span(read), plain_context, gsl::make_span(compressed));
+        REQUIRE_ARROW_STATUS_OK(size);
+        plain_size += *size;
+
+        size = pod5::compress_signal(
+            gsl::make_span(read), dictionary_context, gsl::make_span(compressed));
+        REQUIRE_ARROW_STATUS_OK(size);
+        dictionary_size += *size;
+        auto const compressed_span = gsl::make_span(compressed).first(*size);
+
+        // Decompress using a different context, with the dictionary loaded from its bytes:
+        pod5::SignalCompressionContext reader_context;
+        reader_context.set_dictionary(*reloaded);
+        std::vector<std::int16_t> decompressed(read.size());
+        REQUIRE_ARROW_STATUS_OK(pod5::decompress_signal(
+            compressed_span, reader_context, gsl::make_span(decompressed)));
+        CHECK(decompressed == read);
+
+        CHECK_ARROW_STATUS_NOT_OK(pod5::decompress_signal(
+            compressed_span, plain_context, gsl::make_span(decompressed)));
+    }
+    CHECK(dictionary_size < plain_size);
+
+    CHECK_ARROW_STATUS_NOT_OK(pod5::SignalCompressionDictionary::make(nullptr));
+}
@@ -0,0 +1,152 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/signal_row_index.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/array/array_primitive.h>
+#include <arrow/io/memory.h>
+#include <arrow/memory_pool.h>
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+SCENARIO("Signal row index")
+{
+    std::vector<std::uint32_t> const sample_counts{10, 0, 25, 7};
+    pod5::SignalRowIndex const index(sample_counts);
+
+    CHECK(index.row_count() == 4);
+    CHECK(index.sample_count(2) == 25);
+
+    std::vector<std::uint64_t> const rows{3, 0, 2};
+    CHECK(index.sample_count(gsl::make_span(rows)) == 42);
+    CHECK(index.sample_offsets(gsl::make_span(rows)) == std::vector<std::uint64_t>{0, 7, 17, 42});
+
+    GIVEN("The index written out")
+    {
+        auto const buffer = index.write(nullptr, arrow::default_memory_pool());
+        REQUIRE_ARROW_STATUS_OK(buffer);
+
+        THEN("It reads back the same")
+        {
+            auto const read_back = pod5::SignalRowIndex::open(
+                std::make_shared<arrow::io::BufferReader>(*buffer), arrow::default_memory_pool());
+            REQUIRE_ARROW_STATUS_OK(read_back);
+            REQUIRE(*read_back);
+            REQUIRE((*read_back)->row_count() == 4);
+            for (std::size_t row = 0; row < sample_counts.size(); ++row) {
+                CHECK((*read_back)->sample_count(row) == sample_counts[row]);
+            }
+        }
+    }
+}
+
+SCENARIO("Signal row index embedded in a file")
+{
+    static constexpr char const * file = "./foo.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_signal_row_index = GENERATE(true, false);
+    CAPTURE(write_signal_row_index);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    // Reads of 1 to 4 chunks, so their rows span signal batches:
+    std::vector<std::int16_t> signal(400);
+    std::iota(signal.begin(), signal.end(), 0);
+    std::size_t const read_count = 20;
+    auto const read_length = [](std::size_t i) { return 30 + i * 17; };
+    {
+        pod5::FileWriterOptions options;
+        options.set_write_signal_row_index(write_signal_row_index);
+        options.set_max_signal_chunk_size(100);
+        options.set_signal_table_batch_size(7);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(
+                read_data, gsl::make_span(signal).subspan(0, read_length(i))));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    pod5::FileReaderOptions reader_options;
+    reader_options.set_force_disable_file_mapping(true);
+    auto reader = pod5::open_file_reader(file, reader_options);
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    auto const signal_row_index = (*reader)->signal_row_index();
+    if (!write_signal_row_index) {
+        CHECK(!signal_row_index);
+    } else {
+        REQUIRE(signal_row_index);
+    }
+
+    auto read_batch = (*reader)->read_read_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(read_batch);
+    REQUIRE(read_batch->num_rows() == read_count);
+
+    std::size_t total_rows = 0;
+    for (std::size_t i = 0; i < read_count; ++i) {
+        auto const signal_rows = read_batch->get_signal_rows(i);
+        REQUIRE_ARROW_STATUS_OK(signal_rows);
+        auto const rows =
+            gsl::make_span((*signal_rows)->raw_values(), (*signal_rows)->length());
+        total_rows += rows.size();
+
+        auto const sample_count = (*reader)->extract_sample_count(rows);
+        REQUIRE_ARROW_STATUS_OK(sample_count);
+        CHECK(*sample_count == read_length(i));
+
+        // A range straddling the read's first chunk boundary, where it has one:
+        auto const range_start = read_length(i) > 100 ? 90 : 0;
+        std::vector<std::int16_t> range(read_length(i) - range_start);
+        CHECK_ARROW_STATUS_OK(
+            (*reader)->extract_samples_range(rows, range_start, gsl::make_span(range)));
+        CHECK(range.front() == std::int16_t(range_start));
+        CHECK(range.back() == std::int16_t(read_length(i) - 1));
+
+        // Ranges past the end are refused, including those whose end overflows:
+        std::vector<std::int16_t> past_end(2);
+        CHECK(!(*reader)
+                   ->extract_samples_range(rows, read_length(i) - 1, gsl::make_span(past_end))
+                   .ok());
+        CHECK(!(*reader)
+                   ->extract_samples_range(
+                       rows, std::numeric_limits<std::uint64_t>::max(), gsl::make_span(past_end))
+                   .ok());
+    }
+
+    if (signal_row_index) {
+        CHECK(signal_row_index->row_count() == total_rows);
+
+        // Counting samples needs no signal batches:
+        auto const statistics = (*reader)->statistics();
+        auto const signal_rows = read_batch->get_signal_rows(read_count - 1);
+        REQUIRE_ARROW_STATUS_OK(signal_rows);
+        auto const loaded = statistics.signal_table_batches_decoded;
+        REQUIRE_ARROW_STATUS_OK((*reader)->extract_sample_count(
+            gsl::make_span((*signal_rows)->raw_values(), (*signal_rows)->length())));
+        CHECK((*reader)->statistics().signal_table_batches_decoded == loaded);
+    }
+}
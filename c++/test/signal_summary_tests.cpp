@@ -0,0 +1,278 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/signal_summary.h"
+#include "pod5_format/uuid.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/io/memory.h>
+#include <arrow/memory_pool.h>
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+SCENARIO("Signal summarised at a decimation")
+{
+    std::vector<std::int16_t> const first{1, 5, -3, 4};
+    std::vector<std::int16_t> const second{2, 8, 0};
+    gsl::span<std::int16_t const> const chunks[] = {first, second};
+
+    // Runs span the chunks, the last holding the one sample left:
+    auto const level = pod5::summarise_signal(gsl::make_span(chunks), 3);
+    CHECK(level.decimation == 3);
+    REQUIRE(level.size() == 3);
+    CHECK(level.min == std::vector<std::int16_t>{-3, 2, 0});
+    CHECK(level.max == std::vector<std::int16_t>{5, 8, 0});
+    CHECK(level.mean == std::vector<std::int16_t>{1, 5, 0});
+
+    CHECK(pod5::summarise_signal({}, 3).size() == 0);
+
+    CHECK_ARROW_STATUS_OK(pod5::check_signal_summary_decimations({64, 1024}));
+    CHECK_ARROW_STATUS_NOT_OK(pod5::check_signal_summary_decimations({1}));
+    CHECK_ARROW_STATUS_NOT_OK(pod5::check_signal_summary_decimations({64, 64}));
+}
+
+SCENARIO("Signal statistics of a read")
+{
+    std::vector<std::int16_t> const first{1, 5, -3, 4};
+    std::vector<std::int16_t> const second{2, 8, 0};
+    gsl::span<std::int16_t const> const chunks[] = {first, second};
+
+    auto const statistics = pod5::compute_signal_statistics(gsl::make_span(chunks));
+    CHECK(statistics.min == -3);
+    CHECK(statistics.max == 8);
+    CHECK(statistics.mean == Approx(17.0 / 7));
+    CHECK(statistics.standard_deviation == Approx(std::sqrt(119.0 / 7 - (17.0 / 7) * (17.0 / 7))));
+
+    auto const empty = pod5::compute_signal_statistics({});
+    CHECK(empty.min == 0);
+    CHECK(empty.max == 0);
+    CHECK(empty.mean == 0);
+    CHECK(empty.standard_deviation == 0);
+}
+
+SCENARIO("Signal summaries written and read back")
+{
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    auto sink = arrow::io::BufferOutputStream::Create();
+    REQUIRE_ARROW_STATUS_OK(sink);
+    auto writer = pod5::SignalSummaryWriter::open(
+        *sink, nullptr, {16, 4}, arrow::default_memory_pool(), 3);
+    REQUIRE_ARROW_STATUS_OK(writer);
+
+    std::vector<pod5::Uuid> read_ids;
+    std::vector<std::vector<std::int16_t>> signals;
+    for (std::size_t i = 0; i < 7; ++i) {
+        read_ids.push_back(uuid_gen());
+        signals.emplace_back(10 + i * 9);
+        std::iota(signals.back().begin(), signals.back().end(), std::int16_t(i));
+        gsl::span<std::int16_t const> const chunks[] = {signals.back()};
+        CHECK_ARROW_STATUS_OK((*writer)->add_read(read_ids.back(), gsl::make_span(chunks)));
+    }
+    REQUIRE_ARROW_STATUS_OK((*writer)->close());
+
+    auto buffer = (*sink)->Finish();
+    REQUIRE_ARROW_STATUS_OK(buffer);
+    auto summary = pod5::SignalSummary::open(
+        std::make_shared<arrow::io::BufferReader>(*buffer), arrow::default_memory_pool());
+    REQUIRE_ARROW_STATUS_OK(summary);
+    REQUIRE(*summary);
+    CHECK((*summary)->decimations() == std::vector<std::uint32_t>{4, 16});
+
+    for (std::size_t i = 0; i < read_ids.size(); ++i) {
+        gsl::span<std::int16_t const> const chunks[] = {signals[i]};
+        for (std::uint32_t decimation : {4, 16}) {
+            auto const level = (*summary)->find_level(read_ids[i], decimation);
+            REQUIRE_ARROW_STATUS_OK(level);
+            REQUIRE(*level);
+            auto const expected = pod5::summarise_signal(gsl::make_span(chunks), decimation);
+            CHECK((*level)->min == expected.min);
+            CHECK((*level)->max == expected.max);
+            CHECK((*level)->mean == expected.mean);
+        }
+    }
+
+    auto const missing_level = (*summary)->find_level(read_ids[0], 8);
+    REQUIRE_ARROW_STATUS_OK(missing_level);
+    CHECK(!*missing_level);
+    auto const missing_read = (*summary)->find_level(uuid_gen(), 4);
+    REQUIRE_ARROW_STATUS_OK(missing_read);
+    CHECK(!*missing_read);
+}
+
+SCENARIO("Signal summaries embedded in a file")
+{
+    static constexpr char const * file = "./signal_summary.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_summaries = GENERATE(true, false);
+    CAPTURE(write_summaries);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    std::vector<std::int16_t> signal(3000);
+    std::iota(signal.begin(), signal.end(), 0);
+    std::vector<pod5::Uuid> read_ids;
+    auto const read_length = [](std::size_t i) { return 500 + i * 250; };
+    {
+        pod5::FileWriterOptions options;
+        if (write_summaries) {
+            options.set_signal_summary_decimations({64, 1024});
+        }
+        options.set_max_signal_chunk_size(1000);
+
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+        for (std::size_t i = 0; i < 10; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            read_ids.push_back(read_data.read_id);
+            CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(
+                read_data, gsl::make_span(signal).subspan(0, read_length(i))));
+        }
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+
+    auto const summary = (*reader)->signal_summary();
+    if (!write_summaries) {
+        CHECK(!summary);
+        return;
+    }
+    REQUIRE(summary);
+    CHECK(summary->decimations() == std::vector<std::uint32_t>{64, 1024});
+
+    for (std::size_t i = 0; i < read_ids.size(); ++i) {
+        auto const level = summary->find_level(read_ids[i], 64);
+        REQUIRE_ARROW_STATUS_OK(level);
+        REQUIRE(*level);
+        REQUIRE((*level)->size() == (read_length(i) + 63) / 64);
+        CHECK((*level)->min.front() == 0);
+        CHECK((*level)->max.front() == 63);
+        CHECK((*level)->max.back() == std::int16_t(read_length(i) - 1));
+
+        auto const coarse = summary->find_level(read_ids[i], 1024);
+        REQUIRE_ARROW_STATUS_OK(coarse);
+        REQUIRE(*coarse);
+        CHECK((*coarse)->size() == (read_length(i) + 1023) / 1024);
+    }
+}
+
+SCENARIO("Signal statistics written in the read table")
+{
+    static constexpr char const * file = "./signal_statistics.pod5";
+    REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const write_statistics = GENERATE(true, false);
+    CAPTURE(write_statistics);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    auto const signal_for_read = [](std::size_t i) {
+        std::vector<std::int16_t> signal(500 + i * 250);
+        std::iota(signal.begin(), signal.end(), std::int16_t(i * 10) - 200);
+        return signal;
+    };
+    // Reads 0-3 are added whole, 4-7 through a producer, and 8 as already written signal rows:
+    std::size_t const read_count = 9;
+    {
+        pod5::FileWriterOptions options;
+        options.set_write_signal_statistics(write_statistics);
+        options.set_max_signal_chunk_size(1000);
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+
+        auto run_info = (*writer)->add_run_info(get_test_run_info_data());
+        auto end_reason = (*writer)->lookup_end_reason(pod5::ReadEndReason::signal_positive);
+        auto pore_type = (*writer)->add_pore_type("Pore_type");
+        auto producer = (*writer)->create_producer(3);
+        for (std::size_t i = 0; i < read_count; ++i) {
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = i;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            auto const signal = signal_for_read(i);
+            if (i < 4) {
+                CHECK_ARROW_STATUS_OK(
+                    (*writer)->add_complete_read(read_data, gsl::make_span(signal)));
+            } else if (i < 8) {
+                CHECK_ARROW_STATUS_OK(
+                    producer->add_complete_read(read_data, gsl::make_span(signal)));
+            } else {
+                CHECK_ARROW_STATUS_OK(producer->flush());
+                auto signal_rows =
+                    (*writer)->add_signal(read_data.read_id, gsl::make_span(signal));
+                REQUIRE_ARROW_STATUS_OK(signal_rows);
+                CHECK_ARROW_STATUS_OK((*writer)->add_complete_read(
+                    read_data, gsl::make_span(*signal_rows), signal.size()));
+            }
+        }
+        producer.reset();
+        CHECK_ARROW_STATUS_OK((*writer)->close());
+    }
+
+    auto reader = pod5::open_file_reader(file);
+    REQUIRE_ARROW_STATUS_OK(reader);
+    REQUIRE((*reader)->num_read_record_batches() == 1);
+    auto batch = (*reader)->read_read_record_batch(0);
+    REQUIRE_ARROW_STATUS_OK(batch);
+    auto const view = batch->view();
+    REQUIRE(view.num_rows == read_count);
+
+    if (!write_statistics) {
+        CHECK(!view.signal_min);
+        CHECK(!view.signal_max);
+        CHECK(!view.signal_mean);
+        CHECK(!view.signal_standard_deviation);
+        return;
+    }
+    REQUIRE(view.signal_min);
+    REQUIRE(view.signal_max);
+    REQUIRE(view.signal_mean);
+    REQUIRE(view.signal_standard_deviation);
+
+    auto const & record_batch = *batch->batch();
+    auto const & min_column =
+        *record_batch.column(record_batch.schema()->GetFieldIndex("signal_min"));
+    for (std::size_t i = 0; i < read_count; ++i) {
+        CAPTURE(i);
+        CHECK(view.read_number[i] == i);
+        if (i == 8) {
+            CHECK(min_column.IsNull(i));
+            continue;
+        }
+        CHECK(min_column.IsValid(i));
+
+        auto const signal = signal_for_read(i);
+        gsl::span<std::int16_t const> const chunks[] = {signal};
+        auto const expected = pod5::compute_signal_statistics(gsl::make_span(chunks));
+        CHECK(view.signal_min[i] == signal.front());
+        CHECK(view.signal_max[i] == signal.back());
+        CHECK(view.signal_mean[i] == Approx(expected.mean));
+        CHECK(view.signal_standard_deviation[i] == Approx(expected.standard_deviation));
+    }
+}
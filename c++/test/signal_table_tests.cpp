@@ -3,6 +3,7 @@
 #include "pod5_format/signal_compression.h"
 #include "pod5_format/signal_table_reader.h"
 #include "pod5_format/signal_table_writer.h"
+#include "pod5_format/thread_pool.h"
 #include "pod5_format/types.h"
 #include "pod5_format/uuid.h"
 #include "pod5_format/version.h"
@@ -16,6 +17,7 @@
 #include <arrow/record_batch.h>
 #include <catch2/catch.hpp>
 
+#include <cmath>
 #include <numeric>
 
 SCENARIO("Signal table Tests")
@@ -115,6 +117,8 @@ SCENARIO("Signal table Tests")
                 auto signal_typed = std::static_pointer_cast<VbzSignalArray>(signal);
                 compare_compressed_signal(signal_typed->Value(0), signal_1);
                 compare_compressed_signal(signal_typed->Value(1), signal_2);
+
+                CHECK(!record_batch_0->uncompressed_signal_row(0).ok());
             } else if (signal_type == SignalType::UncompressedSignal) {
                 auto signal = record_batch_0->uncompressed_signal_column();
                 CHECK(signal->length() == 2);
@@ -131,6 +135,25 @@ SCENARIO("Signal table Tests")
                     signal_2_read->raw_values(),
                     signal_2_read->raw_values() + signal_2_read->length());
                 CHECK(stored_values_2 == signal_2);
+
+                // Read the rows in place:
+                auto row_2_samples = record_batch_0->uncompressed_signal_row(1);
+                REQUIRE_ARROW_STATUS_OK(row_2_samples);
+                CHECK(
+                    gsl::make_span((*row_2_samples)->data(), (*row_2_samples)->size())
+                        .as_span<std::int16_t const>()
+                    == gsl::make_span(signal_2));
+
+                std::vector<std::uint64_t> const rows{0, 1};
+                auto sample_buffers =
+                    reader->extract_uncompressed_sample_buffers(gsl::make_span(rows));
+                REQUIRE_ARROW_STATUS_OK(sample_buffers);
+                REQUIRE(sample_buffers->size() == 2);
+                CHECK(
+                    gsl::make_span((*sample_buffers)[0]->data(), (*sample_buffers)[0]->size())
+                        .as_span<std::int16_t const>()
+                    == gsl::make_span(signal_1));
+                CHECK((*sample_buffers)[1]->data() == (*row_2_samples)->data());
             } else {
                 FAIL("Unknown signal type");
             }
@@ -139,6 +162,212 @@ SCENARIO("Signal table Tests")
             CHECK(samples->length() == 2);
             CHECK(samples->Value(0) == signal_1.size());
             CHECK(samples->Value(1) == signal_2.size());
+
+            // Treat both rows as chunks of one read, and query ranges across them:
+            std::vector<std::uint64_t> const rows{0, 1};
+            std::vector<std::int16_t> full_signal = signal_1;
+            full_signal.insert(full_signal.end(), signal_2.begin(), signal_2.end());
+
+            auto const sample_offsets = reader->extract_sample_offsets(gsl::make_span(rows));
+            REQUIRE_ARROW_STATUS_OK(sample_offsets);
+            CHECK(
+                *sample_offsets
+                == std::vector<std::uint64_t>{0, signal_1.size(), full_signal.size()});
+
+            for (auto const & range : std::vector<std::pair<std::size_t, std::size_t>>{
+                     {0, 0}, {5, 100}, {99'990, 100'010}, {100'000, 110'000}, {0, 110'000}})
+            {
+                CAPTURE(range);
+                std::vector<std::int16_t> range_samples(range.second - range.first);
+                REQUIRE_ARROW_STATUS_OK(reader->extract_samples_range(
+                    gsl::make_span(rows), range.first, gsl::make_span(range_samples)));
+                CHECK(
+                    gsl::make_span(range_samples)
+                    == gsl::make_span(full_signal).subspan(range.first, range_samples.size()));
+            }
+
+            std::vector<std::int16_t> too_many_samples(10);
+            CHECK_ARROW_STATUS_NOT_OK(reader->extract_samples_range(
+                gsl::make_span(rows), 109'995, gsl::make_span(too_many_samples)));
+
+            // Decompress the chunks concurrently:
+            auto thread_pool = pod5::make_thread_pool(2);
+            std::vector<std::int16_t> parallel_samples(full_signal.size());
+            REQUIRE_ARROW_STATUS_OK(reader->extract_samples(
+                gsl::make_span(rows), gsl::make_span(parallel_samples), *thread_pool));
+            CHECK(parallel_samples == full_signal);
+
+            std::vector<std::int16_t> too_few_samples(full_signal.size() - 1);
+            CHECK_ARROW_STATUS_NOT_OK(reader->extract_samples(
+                gsl::make_span(rows), gsl::make_span(too_few_samples), *thread_pool));
+
+            // Treat each row as a read of its own, calibrated to picoamps into one buffer:
+            std::vector<std::uint64_t> const read_0_rows{0};
+            std::vector<std::uint64_t> const read_1_rows{1};
+            std::vector<gsl::span<std::uint64_t const>> const reads_rows{
+                gsl::make_span(read_0_rows), gsl::make_span(read_1_rows)};
+            std::vector<pod5::SignalCalibration> const calibrations{{10.0f, 0.5f}, {-3.0f, 2.0f}};
+            std::vector<float> samples_pa(full_signal.size());
+            std::vector<std::uint64_t> read_offsets(reads_rows.size() + 1);
+            REQUIRE_ARROW_STATUS_OK(reader->extract_samples_calibrated_for_reads(
+                gsl::make_span(reads_rows),
+                gsl::make_span(calibrations),
+                gsl::make_span(samples_pa),
+                gsl::make_span(read_offsets),
+                *thread_pool));
+            CHECK(
+                read_offsets
+                == std::vector<std::uint64_t>{0, signal_1.size(), full_signal.size()});
+            std::size_t mismatched_samples = 0;
+            for (std::size_t i = 0; i < full_signal.size(); ++i) {
+                auto const & calibration = calibrations[i < signal_1.size() ? 0 : 1];
+                auto const expected = (full_signal[i] + calibration.offset) * calibration.scale;
+                mismatched_samples += std::abs(samples_pa[i] - expected) > 1e-3f;
+            }
+            CHECK(mismatched_samples == 0);
+
+            CHECK_ARROW_STATUS_NOT_OK(reader->extract_samples_calibrated_for_reads(
+                gsl::make_span(reads_rows),
+                gsl::make_span(calibrations).first(1),
+                gsl::make_span(samples_pa),
+                gsl::make_span(read_offsets),
+                *thread_pool));
+        }
+    }
+}
+
+SCENARIO("Signal table reader cache Tests")
+{
+    using namespace pod5;
+
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    auto filename = "./foo_cache.pod5";
+    auto pool = arrow::system_memory_pool();
+
+    // Write one read per batch, with differently sized signal so batch byte sizes vary:
+    std::size_t const batch_count = 10;
+    std::vector<std::vector<std::int16_t>> signals;
+    {
+        auto file_out = *pod5::AsyncOutputStream::make(
+            *arrow::io::FileOutputStream::Open(filename), pod5::make_thread_pool(1));
+        auto schema_metadata = make_schema_key_value_metadata(
+            {uuid_gen(), "test_software", *parse_version_number(Pod5Version)});
+        REQUIRE_ARROW_STATUS_OK(schema_metadata);
+
+        auto writer = pod5::make_signal_table_writer(
+            file_out, *schema_metadata, 1, SignalType::VbzSignal, pool);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        for (std::size_t i = 0; i < batch_count; ++i) {
+            signals.emplace_back(1'000 * (i + 1));
+            std::iota(signals.back().begin(), signals.back().end(), std::int16_t(i));
+            REQUIRE_ARROW_STATUS_OK(writer->add_signal(uuid_gen(), gsl::make_span(signals.back())));
+        }
+        REQUIRE_ARROW_STATUS_OK(writer->close());
+    }
+
+    auto file_in = arrow::io::ReadableFile::Open(filename, pool);
+    REQUIRE_ARROW_STATUS_OK(file_in);
+
+    auto check_batches = [&](SignalTableReader const & reader, auto && check_cache) {
+        REQUIRE(reader.num_record_batches() == batch_count);
+        // Revisit early batches as later ones are loaded, so eviction order matters:
+        for (std::size_t i : {0, 1, 2, 0, 3, 4, 0, 5, 9, 8, 7, 0, 6, 2, 1}) {
+            std::uint64_t const row = i;
+            std::vector<std::int16_t> samples(signals[i].size());
+            REQUIRE_ARROW_STATUS_OK(
+                reader.extract_samples(gsl::make_span(&row, 1), gsl::make_span(samples)));
+            CHECK(samples == signals[i]);
+            check_cache(reader);
         }
+    };
+
+    GIVEN("A reader limited by batch count")
+    {
+        auto reader = pod5::make_signal_table_reader(*file_in, 3, 0, pool);
+        REQUIRE_ARROW_STATUS_OK(reader);
+        check_batches(*reader, [](SignalTableReader const & reader) {
+            CHECK(reader.cached_batch_count() <= 3);
+        });
+        CHECK(reader->cached_batch_count() == 3);
+    }
+
+    GIVEN("A reader limited by batch bytes")
+    {
+        std::size_t const byte_limit = 8'000;
+        auto reader = pod5::make_signal_table_reader(*file_in, 0, byte_limit, pool);
+        REQUIRE_ARROW_STATUS_OK(reader);
+        check_batches(*reader, [&](SignalTableReader const & reader) {
+            // A batch larger than the limit is still kept while it is the most recent:
+            CHECK((reader.cached_batch_bytes() <= byte_limit || reader.cached_batch_count() == 1));
+        });
+    }
+
+    GIVEN("A reader coalescing loads, limited by batch bytes")
+    {
+        std::size_t const byte_limit = 8'000;
+        auto reader = pod5::make_signal_table_reader(*file_in, 0, byte_limit, pool);
+        REQUIRE_ARROW_STATUS_OK(reader);
+        auto coalescing = arrow::io::CacheOptions::Defaults();
+        coalescing.hole_size_limit = 1 << 20;
+        reader->set_read_coalescing(coalescing);
+
+        // Loads stop at the cache's limit rather than evicting the batches just read:
+        std::vector<std::size_t> batches(batch_count);
+        std::iota(batches.begin(), batches.end(), 0);
+        REQUIRE_ARROW_STATUS_OK(reader->load_record_batches(gsl::make_span(batches)));
+        CHECK(reader->cached_batch_count() >= 1);
+        CHECK((reader->cached_batch_bytes() <= byte_limit || reader->cached_batch_count() == 1));
+
+        check_batches(*reader, [&](SignalTableReader const & reader) {
+            CHECK((reader.cached_batch_bytes() <= byte_limit || reader.cached_batch_count() == 1));
+        });
+    }
+
+    GIVEN("A reader caching decoded reads above a single batch")
+    {
+        std::size_t const byte_limit = 24'000;
+        auto reader = pod5::make_signal_table_reader(*file_in, 1, 0, pool);
+        REQUIRE_ARROW_STATUS_OK(reader);
+        reader->set_max_cached_decoded_read_bytes(byte_limit);
+        check_batches(*reader, [&](SignalTableReader const & reader) {
+            CHECK(reader.cached_decoded_read_bytes() <= byte_limit);
+        });
+
+        auto const statistics = reader->statistics();
+        CHECK(statistics.decoded_read_cache_hits > 0);
+        CHECK(statistics.decoded_read_cache_evictions > 0);
+
+        // Cached reads are shared rather than decoded again:
+        std::uint64_t const row = 1;
+        auto const samples = reader->extract_sample_buffer(gsl::make_span(&row, 1));
+        REQUIRE_ARROW_STATUS_OK(samples);
+        auto const decompressed_bytes = reader->statistics().decompressed_bytes;
+        auto const shared_samples = reader->extract_sample_buffer(gsl::make_span(&row, 1));
+        REQUIRE_ARROW_STATUS_OK(shared_samples);
+        CHECK(*shared_samples == *samples);
+        CHECK(reader->statistics().decompressed_bytes == decompressed_bytes);
+        CHECK(
+            gsl::make_span((*samples)->data(), (*samples)->size()).as_span<std::int16_t const>()
+            == gsl::make_span(signals[1]));
+
+        std::vector<std::int16_t> too_few_samples(signals[1].size() - 1);
+        CHECK_ARROW_STATUS_NOT_OK(
+            reader->extract_samples(gsl::make_span(&row, 1), gsl::make_span(too_few_samples)));
+
+        reader->clear_cache();
+        CHECK(reader->cached_decoded_read_bytes() == 0);
+    }
+
+    GIVEN("An unlimited reader")
+    {
+        auto reader = pod5::make_signal_table_reader(*file_in, 0, 0, pool);
+        REQUIRE_ARROW_STATUS_OK(reader);
+        check_batches(*reader, [](SignalTableReader const &) {});
+        CHECK(reader->cached_batch_count() == batch_count);
     }
 }
@@ -0,0 +1,102 @@
+#include "pod5_format/svb16/decode.hpp"
+#include "pod5_format/svb16/encode.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#ifdef SVB16_X64
+
+using Catch::Matchers::Equals;
+
+enum class AvxKernel { Avx2, Avx512 };
+
+template <typename Int16T>
+std::vector<Int16T> make_avx_test_data(uint32_t count)
+{
+    std::minstd_rand rng;
+    std::uniform_int_distribution<Int16T> wide{
+        std::numeric_limits<Int16T>::min(), std::numeric_limits<Int16T>::max()};
+    std::uniform_int_distribution<Int16T> narrow{0, 100};
+    std::bernoulli_distribution use_wide{0.3};
+
+    // Mix small and large values so one and two byte encodings are both exercised:
+    std::vector<Int16T> data(count);
+    std::generate(data.begin(), data.end(), [&] { return use_wide(rng) ? wide(rng) : narrow(rng); });
+    return data;
+}
+
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+void test_avx_encode_decode(AvxKernel kernel)
+{
+    if ((kernel == AvxKernel::Avx2 && !has_avx2())
+        || (kernel == AvxKernel::Avx512 && !has_avx512_vbmi2()))
+    {
+        WARN("Skipping test, cpu does not support the kernel");
+        return;
+    }
+
+    // Deliberately not aligned to 16/32 so we test the scalar tidy up code at the end.
+    uint32_t const DATA_COUNT = GENERATE(7, 33, 1000, 20000);
+    auto const data = make_avx_test_data<Int16T>(DATA_COUNT);
+    auto const key_length = svb16_key_length(data.size());
+
+    std::vector<uint8_t> encoded(svb16_max_encoded_length(data.size()));
+    auto const encode = kernel == AvxKernel::Avx2 ? &svb16::encode_avx2<Int16T, UseDelta, UseZigzag>
+                                                  : &svb16::encode_avx512<Int16T, UseDelta, UseZigzag>;
+    auto const encoded_count =
+        encode(data.data(), encoded.data(), encoded.data() + key_length, DATA_COUNT, 0)
+        - encoded.data();
+
+    std::vector<uint8_t> encoded_scalar(svb16_max_encoded_length(data.size()));
+    auto const scalar_encoded_count =
+        svb16::encode_scalar<Int16T, UseDelta, UseZigzag>(
+            data.data(), encoded_scalar.data(), encoded_scalar.data() + key_length, DATA_COUNT)
+        - encoded_scalar.data();
+    CHECK(scalar_encoded_count == encoded_count);
+    encoded.resize(encoded_count);
+    encoded_scalar.resize(scalar_encoded_count);
+    CHECK(encoded == encoded_scalar);
+
+    // Pad the input as the decoders may read beyond the end of the data:
+    encoded.resize(encoded_count + svb16::decode_input_buffer_padding_byte_count());
+
+    std::vector<Int16T> decoded(DATA_COUNT);
+    auto const encoded_span = gsl::make_span(encoded);
+    auto const decode = kernel == AvxKernel::Avx2 ? &svb16::decode_avx2<Int16T, UseDelta, UseZigzag>
+                                                  : &svb16::decode_avx512<Int16T, UseDelta, UseZigzag>;
+    auto const consumed = decode(
+                              gsl::make_span(decoded),
+                              encoded_span.subspan(0, key_length),
+                              encoded_span.subspan(key_length),
+                              0)
+                          - encoded.data();
+
+    CHECK(consumed == encoded_count);
+    CHECK_THAT(decoded, Equals(data));
+}
+
+template <typename Int16T, bool UseDelta, bool UseZigzag>
+void test_avx_kernels()
+{
+    SECTION("AVX2") { test_avx_encode_decode<Int16T, UseDelta, UseZigzag>(AvxKernel::Avx2); }
+    SECTION("AVX-512") { test_avx_encode_decode<Int16T, UseDelta, UseZigzag>(AvxKernel::Avx512); }
+}
+
+TEST_CASE("AVX encode and decode match scalar", "[avx]")
+{
+    SECTION("Unsigned, no delta, no zig-zag") { test_avx_kernels<uint16_t, false, false>(); }
+    SECTION("Signed, no delta, no zig-zag") { test_avx_kernels<int16_t, false, false>(); }
+    SECTION("Unsigned, delta, no zig-zag") { test_avx_kernels<uint16_t, true, false>(); }
+    SECTION("Signed, delta, no zig-zag") { test_avx_kernels<int16_t, true, false>(); }
+    SECTION("Unsigned, delta, zig-zag") { test_avx_kernels<uint16_t, true, true>(); }
+    SECTION("Signed, delta, zig-zag") { test_avx_kernels<int16_t, true, true>(); }
+    SECTION("Unsigned, no delta, zig-zag") { test_avx_kernels<uint16_t, false, true>(); }
+    SECTION("Signed, no delta, zig-zag") { test_avx_kernels<int16_t, false, true>(); }
+}
+
+#endif
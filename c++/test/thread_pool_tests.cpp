@@ -2,11 +2,33 @@
 
 #include <catch2/catch.hpp>
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <numeric>
+#include <memory>
+#include <set>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+std::shared_ptr<pod5::ThreadPool> make_pool(bool work_stealing, std::size_t worker_threads)
+{
+    if (work_stealing) {
+        return pod5::make_work_stealing_thread_pool(worker_threads);
+    }
+    return pod5::make_thread_pool(worker_threads);
+}
+
+}  // namespace
+
 TEST_CASE("Thread pool runs tasks concurrently", "[thread_pool]")
 {
     using namespace std::chrono_literals;
@@ -17,6 +39,9 @@ TEST_CASE("Thread pool runs tasks concurrently", "[thread_pool]")
     auto const use_strands = GENERATE(true, false);
     CAPTURE(use_strands);
 
+    auto const work_stealing = GENERATE(true, false);
+    CAPTURE(work_stealing);
+
     // semaphores only in std lib in c++20, so fake them
     std::mutex sem_mutex;
     int sem1 = 2;
@@ -47,7 +72,7 @@ TEST_CASE("Thread pool runs tasks concurrently", "[thread_pool]")
         };
     };
 
-    auto thread_pool = pod5::make_thread_pool(2);
+    auto thread_pool = make_pool(work_stealing, 2);
     std::shared_ptr<pod5::ThreadPoolStrand> strands[2];
     if (use_strands) {
         for (unsigned i = 0; i < 2; ++i) {
@@ -79,6 +104,9 @@ TEST_CASE("Tasks on the same strand are serialised", "[thread_pool]")
     auto const explicit_stop = GENERATE(true, false);
     CAPTURE(explicit_stop);
 
+    auto const work_stealing = GENERATE(true, false);
+    CAPTURE(work_stealing);
+
     std::mutex seq_mutex;
     std::vector<int> seq;
     seq.reserve(4);
@@ -97,7 +125,7 @@ TEST_CASE("Tasks on the same strand are serialised", "[thread_pool]")
         };
     };
 
-    auto thread_pool = pod5::make_thread_pool(2);
+    auto thread_pool = make_pool(work_stealing, 2);
     auto strand = thread_pool->create_strand();
     strand->post(create_task(0));
     strand->post(create_task(1));
@@ -116,3 +144,292 @@ TEST_CASE("Tasks on the same strand are serialised", "[thread_pool]")
         REQUIRE(seq == (std::vector<int>{1, 1, 0, 0}));
     }
 }
+
+TEST_CASE("Tasks posted from tasks keep strand order", "[thread_pool]")
+{
+    auto const work_stealing = GENERATE(true, false);
+    CAPTURE(work_stealing);
+
+    std::size_t const strand_count = 64;
+    std::size_t const tasks_per_strand = 200;
+
+    auto thread_pool = make_pool(work_stealing, 4);
+    std::vector<std::shared_ptr<pod5::ThreadPoolStrand>> strands;
+    for (std::size_t i = 0; i < strand_count; ++i) {
+        strands.push_back(thread_pool->create_strand());
+    }
+
+    // Only touched by tasks on the strand, which never run concurrently:
+    std::vector<std::vector<std::size_t>> seqs(strand_count);
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    std::size_t unordered_tasks_run = 0;
+    std::set<std::thread::id> threads;
+
+    // Each task posts a task to the pool, and the next task of its strand, so most work is posted
+    // from the pool's own threads:
+    std::function<void(std::size_t, std::size_t)> run_task = [&](std::size_t strand,
+                                                                  std::size_t num) {
+        seqs[strand].push_back(num);
+        thread_pool->post([&] {
+            std::lock_guard<std::mutex> l{done_mutex};
+            threads.insert(std::this_thread::get_id());
+            unordered_tasks_run += 1;
+            done_cv.notify_one();
+        });
+        if (num + 1 < tasks_per_strand) {
+            strands[strand]->post([&, strand, num] { run_task(strand, num + 1); });
+        }
+    };
+    for (std::size_t i = 0; i < strand_count; ++i) {
+        strands[i]->post([&, i] { run_task(i, 0); });
+    }
+
+    // Tasks are still posted while running, so can't be drained until all have run:
+    {
+        std::unique_lock<std::mutex> l{done_mutex};
+        done_cv.wait(l, [&] { return unordered_tasks_run == strand_count * tasks_per_strand; });
+    }
+    thread_pool->stop_and_drain();
+
+    CHECK(unordered_tasks_run == strand_count * tasks_per_strand);
+    CHECK(threads.size() > 1);
+    for (auto const & seq : seqs) {
+        REQUIRE(seq.size() == tasks_per_strand);
+        for (std::size_t i = 0; i < seq.size(); ++i) {
+            REQUIRE(seq[i] == i);
+        }
+    }
+}
+
+TEST_CASE("Thread pool worker groups run their work", "[thread_pool]")
+{
+    pod5::ThreadPoolOptions options;
+    options.worker_groups.push_back({2, {}, -1});
+    options.worker_groups.push_back({1, {}, -1});
+    auto thread_pool = pod5::make_thread_pool(options);
+    REQUIRE(thread_pool->worker_group_count() == 2);
+
+    std::size_t const strand_count = 8;
+    std::size_t const tasks_per_strand = 100;
+
+    std::vector<std::shared_ptr<pod5::ThreadPoolStrand>> strands;
+    for (std::size_t i = 0; i < strand_count; ++i) {
+        strands.push_back(thread_pool->create_strand_in_group(i));
+    }
+
+    // Only touched by tasks on the strand, which never run concurrently:
+    std::vector<std::vector<std::size_t>> seqs(strand_count);
+    std::atomic<std::size_t> group_tasks_run{0};
+    for (std::size_t num = 0; num < tasks_per_strand; ++num) {
+        for (std::size_t i = 0; i < strand_count; ++i) {
+            strands[i]->post([&, i, num] { seqs[i].push_back(num); });
+            thread_pool->post_to_group([&] { group_tasks_run += 1; }, i);
+        }
+    }
+
+    thread_pool->stop_and_drain();
+
+    CHECK(group_tasks_run == strand_count * tasks_per_strand);
+    for (auto const & seq : seqs) {
+        REQUIRE(seq.size() == tasks_per_strand);
+        for (std::size_t i = 0; i < seq.size(); ++i) {
+            REQUIRE(seq[i] == i);
+        }
+    }
+}
+
+TEST_CASE("NUMA thread pool options share out every worker", "[thread_pool]")
+{
+    auto const worker_threads = GENERATE(1, 3, 16);
+    CAPTURE(worker_threads);
+
+    auto const options = pod5::numa_thread_pool_options(worker_threads);
+    REQUIRE(!options.worker_groups.empty());
+
+    std::size_t total_workers = 0;
+    for (auto const & group : options.worker_groups) {
+        CHECK(group.worker_threads > 0);
+        total_workers += group.worker_threads;
+    }
+    CHECK(total_workers == std::size_t(worker_threads));
+
+    // The pool must run with whatever the machine gives:
+    std::atomic<bool> ran{false};
+    auto thread_pool = pod5::make_thread_pool(options);
+    thread_pool->post([&] { ran = true; });
+    thread_pool->stop_and_drain();
+    CHECK(ran);
+}
+
+#ifdef __linux__
+TEST_CASE("Thread pool workers run on their group's CPUs", "[thread_pool]")
+{
+    cpu_set_t allowed_cpus;
+    CPU_ZERO(&allowed_cpus);
+    REQUIRE(sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) == 0);
+    unsigned cpu = 0;
+    while (!CPU_ISSET(cpu, &allowed_cpus)) {
+        cpu += 1;
+    }
+
+    pod5::ThreadPoolOptions options;
+    options.worker_groups.push_back({1, {cpu}, -1});
+    auto thread_pool = pod5::make_thread_pool(options);
+
+    std::atomic<int> task_cpu{-1};
+    thread_pool->post([&] { task_cpu = sched_getcpu(); });
+    thread_pool->stop_and_drain();
+    CHECK(task_cpu == int(cpu));
+}
+#endif
+
+TEST_CASE("Thread pool tasks hold move only callables", "[thread_pool]")
+{
+    std::vector<int> calls;
+
+    // Small callables are held inline, larger ones on the heap, either way moving with the task:
+    auto value = std::make_unique<int>(1);
+    pod5::ThreadPoolTask small_task{
+        [&calls, value = std::move(value)] { calls.push_back(*value); }};
+    std::array<char, pod5::ThreadPoolTask::INLINE_SIZE * 2> large_capture{};
+    large_capture[0] = 2;
+    pod5::ThreadPoolTask large_task{[&calls, large_capture] { calls.push_back(large_capture[0]); }};
+
+    auto moved_small_task = std::move(small_task);
+    auto moved_large_task = std::move(large_task);
+    CHECK(!small_task);
+    CHECK(!large_task);
+    REQUIRE(moved_small_task);
+    REQUIRE(moved_large_task);
+    moved_small_task();
+    moved_large_task();
+    CHECK(calls == std::vector<int>{1, 2});
+
+    CHECK(!pod5::ThreadPoolTask{std::function<void()>{}});
+    CHECK(!pod5::ThreadPoolTask{nullptr});
+
+    // Captures are destroyed with the task:
+    auto const shared = std::make_shared<int>(0);
+    {
+        pod5::ThreadPoolTask task{[shared] {}};
+        CHECK(shared.use_count() == 2);
+    }
+    CHECK(shared.use_count() == 1);
+}
+
+TEST_CASE("Thread pool runs tasks posted together", "[thread_pool]")
+{
+    auto const work_stealing = GENERATE(true, false);
+    CAPTURE(work_stealing);
+
+    auto thread_pool = make_pool(work_stealing, 4);
+
+    std::size_t const task_count = 1000;
+    std::atomic<std::size_t> tasks_run{0};
+    std::vector<pod5::ThreadPoolTask> tasks;
+    for (std::size_t i = 0; i < task_count; ++i) {
+        auto counted = std::make_unique<std::size_t>(1);
+        tasks.emplace_back([&, counted = std::move(counted)] { tasks_run += *counted; });
+    }
+    thread_pool->post_n(std::move(tasks));
+    thread_pool->stop_and_drain();
+
+    CHECK(tasks_run == task_count);
+    CHECK_THROWS_AS(thread_pool->post_n({}), std::logic_error);
+}
+
+TEST_CASE("Thread pool wakes every group's idle workers for tasks posted together", "[thread_pool]")
+{
+    using namespace std::chrono_literals;
+
+    pod5::ThreadPoolOptions options;
+    options.worker_groups.push_back({1, {}, -1});
+    options.worker_groups.push_back({1, {}, -1});
+    auto thread_pool = pod5::make_thread_pool(options);
+    // Let both workers go idle, so only waking them gets the tasks run:
+    std::this_thread::sleep_for(20ms);
+
+    // Both tasks land in one group, and each waits for the other, so they only finish if the
+    // other group's worker is woken too.
+    std::mutex mutex;
+    std::condition_variable cv;
+    int started = 0;
+    std::vector<pod5::ThreadPoolTask> tasks;
+    for (int i = 0; i < 2; ++i) {
+        tasks.emplace_back([&] {
+            std::unique_lock<std::mutex> l{mutex};
+            started += 1;
+            cv.notify_all();
+            cv.wait(l, [&] { return started == 2; });
+        });
+    }
+    thread_pool->post_n(std::move(tasks));
+    thread_pool->stop_and_drain();
+
+    CHECK(started == 2);
+}
+
+TEST_CASE("Thread pool statistics report queued and running work", "[thread_pool]")
+{
+    auto thread_pool = pod5::make_thread_pool(2);
+
+    // Hold both workers, so later tasks stay queued:
+    std::mutex gate_mutex;
+    std::condition_variable gate_cv;
+    bool gate_open = false;
+    std::size_t blocked_tasks = 0;
+    auto const blocking_task = [&] {
+        std::unique_lock<std::mutex> l{gate_mutex};
+        blocked_tasks += 1;
+        gate_cv.notify_all();
+        gate_cv.wait(l, [&] { return gate_open; });
+    };
+    thread_pool->post(blocking_task);
+    thread_pool->post(blocking_task);
+    {
+        std::unique_lock<std::mutex> l{gate_mutex};
+        gate_cv.wait(l, [&] { return blocked_tasks == 2; });
+    }
+
+    auto strand = thread_pool->create_strand();
+    for (int i = 0; i < 3; ++i) {
+        strand->post([] {});
+    }
+    thread_pool->post([] {});
+
+    auto statistics = thread_pool->statistics();
+    CHECK(statistics.queued_tasks == 4);
+    CHECK(statistics.running_tasks == 2);
+    CHECK(statistics.strand_queued_tasks == std::vector<std::size_t>{3});
+    CHECK(statistics.tasks_run == 0);
+    CHECK(statistics.worker_busy_ratios.size() == 2);
+
+    {
+        std::lock_guard<std::mutex> l{gate_mutex};
+        gate_open = true;
+    }
+    gate_cv.notify_all();
+    thread_pool->stop_and_drain();
+
+    statistics = thread_pool->statistics();
+    CHECK(statistics.queued_tasks == 0);
+    CHECK(statistics.running_tasks == 0);
+    CHECK(statistics.strand_queued_tasks.empty());
+    CHECK(statistics.tasks_run == 6);
+    auto const buckets = pod5::ThreadPoolStatistics::TIME_HISTOGRAM_BUCKETS;
+    REQUIRE(statistics.wait_time_histogram.size() == buckets);
+    REQUIRE(statistics.run_time_histogram.size() == buckets);
+    CHECK(
+        std::accumulate(
+            statistics.wait_time_histogram.begin(), statistics.wait_time_histogram.end(), 0ull)
+        == 6);
+    CHECK(
+        std::accumulate(
+            statistics.run_time_histogram.begin(), statistics.run_time_histogram.end(), 0ull)
+        == 6);
+    for (auto const ratio : statistics.worker_busy_ratios) {
+        CHECK(ratio > 0.0);
+        CHECK(ratio <= 1.0);
+    }
+}
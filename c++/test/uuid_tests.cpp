@@ -25,10 +25,15 @@
 
 #include "pod5_format/uuid.h"
 
+#include "pod5_format/uuid_format.h"
+
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <cctype>
 #include <set>
 #include <unordered_set>
+#include <utility>
 
 TEST_CASE("Default constructor returns nil UUID", "[pod5::Uuid]")
 {
@@ -309,3 +314,55 @@ TEST_CASE("Test constexpr", "[const]")
 }
 
 TEST_CASE("Test size", "[operators]") { REQUIRE(sizeof(pod5::Uuid) == 16); }
+
+TEST_CASE("Formatting and parsing UUIDs in bulk", "[pod5::Uuid]")
+{
+    auto engine = pod5::UuidRandomGenerator::engine_type{Catch::rngSeed()};
+    pod5::UuidRandomGenerator gen{engine};
+
+    // Odd counts leave a UUID over after those handled in pairs:
+    auto const count = GENERATE(0, 1, 2, 5, 64);
+    CAPTURE(count);
+    std::vector<pod5::Uuid> ids(count);
+    std::generate(ids.begin(), ids.end(), gen);
+
+    std::string formatted(ids.size() * pod5::UUID_STRING_LENGTH, '\0');
+    pod5::format_uuids(gsl::make_span(ids), &formatted[0]);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        CHECK(
+            formatted.substr(i * pod5::UUID_STRING_LENGTH, pod5::UUID_STRING_LENGTH)
+            == to_string(ids[i]));
+    }
+
+    std::vector<pod5::Uuid> parsed(ids.size());
+    CHECK(pod5::parse_uuids(formatted.data(), gsl::make_span(parsed)) == ids.size());
+    CHECK(parsed == ids);
+
+    // Upper case digits parse the same:
+    std::transform(formatted.begin(), formatted.end(), formatted.begin(), [](char c) {
+        return char(std::toupper(c));
+    });
+    std::fill(parsed.begin(), parsed.end(), pod5::Uuid{});
+    CHECK(pod5::parse_uuids(formatted.data(), gsl::make_span(parsed)) == ids.size());
+    CHECK(parsed == ids);
+
+    // The first invalid string is found, wherever it is:
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        for (auto const & [position, c] : {std::pair{0, 'g'}, {8, '0'}, {20, '-'}, {35, '/'}}) {
+            auto invalid = formatted;
+            invalid[i * pod5::UUID_STRING_LENGTH + position] = c;
+            CHECK(pod5::parse_uuids(invalid.data(), gsl::make_span(parsed)) == i);
+        }
+    }
+}
+
+TEST_CASE("Parsing single UUIDs", "[pod5::Uuid]")
+{
+    auto const expected = pod5::Uuid::from_string("1d5a3dd9-2d50-4f2b-a0fb-a3a749eb96c7");
+    REQUIRE(expected);
+    CHECK(pod5::parse_uuid("1d5a3dd9-2d50-4f2b-a0fb-a3a749eb96c7") == expected);
+    CHECK(pod5::parse_uuid("1D5A3DD9-2D50-4F2B-A0FB-A3A749EB96C7") == expected);
+    CHECK(pod5::parse_uuid("{1d5a3dd9-2d50-4f2b-a0fb-a3a749eb96c7}") == expected);
+    CHECK_FALSE(pod5::parse_uuid("1d5a3dd9-2d50-4f2b-a0fb-a3a749eb96cg"));
+    CHECK_FALSE(pod5::parse_uuid(""));
+}
@@ -0,0 +1,175 @@
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/uuid.h"
+#include "pod5_format/writer_resources.h"
+#include "test_utils.h"
+#include "utils.h"
+
+#include <arrow/array/array_primitive.h>
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+SCENARIO("Writers take turns on the shared compression pool")
+{
+    pod5::WriterResourcesOptions options;
+    options.compression_threads = 1;
+    auto resources = pod5::make_writer_resources(options);
+    REQUIRE_ARROW_STATUS_OK(resources);
+
+    auto first = (*resources)->make_writer_thread_pool();
+    auto second = (*resources)->make_writer_thread_pool();
+
+    // Hold the only thread while both writers queue work:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool started = false;
+    bool released = false;
+    first->post([&] {
+        std::unique_lock<std::mutex> l(mutex);
+        started = true;
+        cv.notify_all();
+        cv.wait(l, [&] { return released; });
+    });
+    {
+        std::unique_lock<std::mutex> l(mutex);
+        cv.wait(l, [&] { return started; });
+    }
+
+    std::vector<char> order;
+    for (int i = 0; i < 4; ++i) {
+        first->post([&] {
+            std::lock_guard<std::mutex> l(mutex);
+            order.push_back('a');
+        });
+    }
+    for (int i = 0; i < 2; ++i) {
+        second->post([&] {
+            std::lock_guard<std::mutex> l(mutex);
+            order.push_back('b');
+        });
+    }
+    {
+        std::lock_guard<std::mutex> l(mutex);
+        released = true;
+    }
+    cv.notify_all();
+
+    first->stop_and_drain();
+    second->stop_and_drain();
+    CHECK(order == std::vector<char>{'a', 'b', 'a', 'b', 'a', 'a'});
+    CHECK_THROWS(first->post([] {}));
+}
+
+SCENARIO("Pending signal budget")
+{
+    pod5::WriterResourcesOptions options;
+    options.max_pending_signal_bytes = 100;
+    auto resources = pod5::make_writer_resources(options);
+    REQUIRE_ARROW_STATUS_OK(resources);
+
+    auto first = (*resources)->try_reserve_pending_signal(60);
+    REQUIRE(first);
+    CHECK(first->bytes() == 60);
+    CHECK(!(*resources)->try_reserve_pending_signal(60));
+    {
+        auto over = (*resources)->reserve_pending_signal(60);
+        CHECK((*resources)->pending_signal_bytes() == 120);
+    }
+    CHECK((*resources)->pending_signal_bytes() == 60);
+
+    first.reset();
+    CHECK((*resources)->pending_signal_bytes() == 0);
+    CHECK((*resources)->try_reserve_pending_signal(100));
+}
+
+SCENARIO("Files written with shared writer resources")
+{
+    (void)pod5::register_extension_types();
+    auto fin = gsl::finally([] { (void)pod5::unregister_extension_types(); });
+
+    auto const use_directio = GENERATE(true, false);
+    CAPTURE(use_directio);
+
+    pod5::WriterResourcesOptions resource_options;
+    resource_options.compression_threads = 2;
+    // Less than a signal chunk, so writers wait on their own compression:
+    resource_options.max_pending_signal_bytes = 1000;
+    auto resources = pod5::make_writer_resources(resource_options);
+    REQUIRE_ARROW_STATUS_OK(resources);
+
+    std::mt19937 gen{Catch::rngSeed()};
+    auto uuid_gen = pod5::UuidRandomGenerator{gen};
+
+    pod5::FileWriterOptions options;
+    options.set_writer_resources(*resources);
+    options.set_max_compression_jobs(4);
+    options.set_max_signal_chunk_size(1000);
+    options.set_use_directio(use_directio);
+
+    std::vector<std::int16_t> signal(10'000);
+    std::iota(signal.begin(), signal.end(), 0);
+
+    std::size_t const file_count = 3;
+    std::vector<std::unique_ptr<pod5::FileWriter>> writers;
+    std::vector<std::vector<pod5::Uuid>> read_ids(file_count);
+    for (std::size_t i = 0; i < file_count; ++i) {
+        auto const file = "./writer_resources_" + std::to_string(i) + ".pod5";
+        REQUIRE_ARROW_STATUS_OK(remove_file_if_exists(file));
+        auto writer = pod5::create_file_writer(file, "test_software", options);
+        REQUIRE_ARROW_STATUS_OK(writer);
+        writers.push_back(std::move(*writer));
+    }
+
+    // Interleave the writers' reads, as a host writing to each file at once would:
+    for (std::size_t read = 0; read < 10; ++read) {
+        for (std::size_t i = 0; i < file_count; ++i) {
+            auto & writer = *writers[i];
+            auto run_info = writer.add_run_info(get_test_run_info_data());
+            auto end_reason = writer.lookup_end_reason(pod5::ReadEndReason::signal_positive);
+            auto pore_type = writer.add_pore_type("Pore_type");
+
+            pod5::ReadData read_data;
+            read_data.read_id = uuid_gen();
+            read_data.read_number = read;
+            read_data.pore_type = *pore_type;
+            read_data.end_reason = *end_reason;
+            read_data.run_info = *run_info;
+            read_ids[i].push_back(read_data.read_id);
+            CHECK_ARROW_STATUS_OK(writer.add_complete_read(
+                read_data, gsl::make_span(signal).subspan(0, 1000 + read * 500)));
+        }
+    }
+    for (auto & writer : writers) {
+        CHECK_ARROW_STATUS_OK(writer->close());
+    }
+    CHECK((*resources)->pending_signal_bytes() == 0);
+
+    for (std::size_t i = 0; i < file_count; ++i) {
+        auto reader = pod5::open_file_reader("./writer_resources_" + std::to_string(i) + ".pod5");
+        REQUIRE_ARROW_STATUS_OK(reader);
+        auto const batch = (*reader)->read_read_record_batch(0);
+        REQUIRE_ARROW_STATUS_OK(batch);
+        REQUIRE(batch->num_rows() == std::int64_t(read_ids[i].size()));
+
+        auto const ids = batch->read_id_column();
+        auto const signal_column = batch->signal_column();
+        for (std::size_t row = 0; row < read_ids[i].size(); ++row) {
+            CHECK(ids->Value(row) == read_ids[i][row]);
+
+            auto const rows =
+                std::static_pointer_cast<arrow::UInt64Array>(signal_column->value_slice(row));
+            auto const rows_span = gsl::make_span(rows->raw_values(), rows->length());
+            std::vector<std::int16_t> samples(1000 + row * 500);
+            REQUIRE_ARROW_STATUS_OK((*reader)->extract_samples(rows_span, gsl::make_span(samples)));
+            CHECK(std::equal(samples.begin(), samples.end(), signal.begin()));
+        }
+    }
+}
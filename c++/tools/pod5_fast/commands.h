@@ -0,0 +1,34 @@
+#pragma once
+
+#include "pod5_format/result.h"
+#include "tool_utils.h"
+
+namespace pod5_fast {
+
+/// \brief Print a summary line for each input file, see usage in main.cpp.
+pod5::Status run_inspect(Arguments & args);
+
+/// \brief Print the id of every read in the input files, in file order.
+pod5::Status run_read_ids(Arguments & args);
+
+/// \brief Copy the reads named in a list of read ids from the input files into one output.
+pod5::Status run_filter(Arguments & args);
+
+/// \brief Copy every read of the input files into one output.
+pod5::Status run_merge(Arguments & args);
+
+/// \brief Write the signal of every read in the input files to a raw sample file and an index.
+pod5::Status run_export_signal(Arguments & args);
+
+/// \brief Write synthetic pod5 files from a parametric signal model, see usage in main.cpp.
+pod5::Status run_generate(Arguments & args);
+
+#ifdef POD5_FAST_HAS_HDF5
+/// \brief Convert the reads of the input files to multi-read fast5 files.
+pod5::Status run_to_fast5(Arguments & args);
+#endif
+
+/// \brief Check each input file is intact, printing a line for each, see usage in main.cpp.
+pod5::Status run_verify(Arguments & args);
+
+}  // namespace pod5_fast
@@ -0,0 +1,163 @@
+#include "commands.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/multi_file_signal_loader.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/types.h"
+
+#include <arrow/array/array_primitive.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pod5_fast {
+
+namespace {
+
+/// Writes loaded signal to a raw sample file, and a line for each read to an index beside it.
+class SignalExport {
+public:
+    static pod5::Result<SignalExport> open(std::string const & prefix, bool force_overwrite)
+    {
+        auto const samples_path = prefix + ".samples";
+        auto const index_path = prefix + ".index.tsv";
+        ARROW_RETURN_NOT_OK(prepare_output(samples_path, force_overwrite));
+        ARROW_RETURN_NOT_OK(prepare_output(index_path, force_overwrite));
+
+        SignalExport result;
+        result.m_samples.open(samples_path, std::ios::binary);
+        result.m_index.open(index_path);
+        if (!result.m_samples || !result.m_index) {
+            return arrow::Status::IOError("Failed to open ", prefix, " outputs for writing");
+        }
+        result.m_index << "read_id\tfilename\tsample_offset\tsample_count\tcalibration_offset"
+                          "\tcalibration_scale\n";
+        return result;
+    }
+
+    /// Write the signal loaded for the rows of [read_batch].
+    pod5::Status write_batch(
+        std::string const & filename,
+        pod5::ReadTableRecordBatch const & read_batch,
+        pod5::CachedBatchSignalData const & signal)
+    {
+        ARROW_ASSIGN_OR_RAISE(auto const columns, read_batch.columns());
+        auto const row_count = signal.sample_count().size();
+        if (std::int64_t(row_count) != columns.read_id->length()) {
+            return arrow::Status::Invalid(
+                filename, ": loaded signal for ", row_count, " reads of batch ",
+                signal.batch_index(), ", expected ", columns.read_id->length());
+        }
+
+        for (std::size_t row = 0; row < row_count; ++row) {
+            auto const samples = signal.samples(row);
+            m_index << columns.read_id->Value(row) << '\t' << filename << '\t' << m_sample_offset
+                    << '\t' << samples.size() << '\t' << columns.calibration_offset->Value(row)
+                    << '\t' << columns.calibration_scale->Value(row) << '\n';
+            m_sample_offset += samples.size();
+        }
+        // Rows are loaded one after another, so the batch's samples are written at once:
+        auto const all_samples = signal.all_samples();
+        m_samples.write(
+            reinterpret_cast<char const *>(all_samples.data()), all_samples.size_bytes());
+        if (!m_samples || !m_index) {
+            return arrow::Status::IOError("Failed writing signal of ", filename);
+        }
+        m_read_count += row_count;
+        return pod5::Status::OK();
+    }
+
+    pod5::Status close()
+    {
+        m_samples.close();
+        m_index.close();
+        if (!m_samples || !m_index) {
+            return arrow::Status::IOError("Failed to close exported signal");
+        }
+        std::cerr << "Exported " << m_read_count << " reads, " << m_sample_offset
+                  << " samples\n";
+        return pod5::Status::OK();
+    }
+
+private:
+    std::ofstream m_samples;
+    std::ofstream m_index;
+    std::uint64_t m_sample_offset = 0;
+    std::uint64_t m_read_count = 0;
+};
+
+}  // namespace
+
+pod5::Status run_export_signal(Arguments & args)
+{
+    auto const recursive = args.take_flag("--recursive");
+    auto const force_overwrite = args.take_flag("--force-overwrite");
+    ARROW_ASSIGN_OR_RAISE(auto const thread_count, take_thread_count(args));
+    ARROW_ASSIGN_OR_RAISE(auto const output, args.take_option("--output"));
+    if (!output) {
+        return arrow::Status::Invalid("An --output prefix is required");
+    }
+    ARROW_ASSIGN_OR_RAISE(auto const paths, args.take_positionals());
+    ARROW_ASSIGN_OR_RAISE(auto const inputs, collect_inputs(paths, recursive));
+
+    ARROW_ASSIGN_OR_RAISE(auto signal_export, SignalExport::open(*output, force_overwrite));
+
+    pod5::MultiFileSignalLoaderOptions options;
+    options.set_thread_pool(pod5::make_thread_pool(pod5::numa_thread_pool_options(thread_count)));
+    options.set_tasks_per_file(std::max<std::size_t>(1, thread_count / options.files_in_flight()));
+
+    // Readers are opened a window of files at a time, so each file's read ids can be looked up
+    // as its signal is released without opening it twice:
+    std::size_t const window = options.files_in_flight() * 4;
+    for (std::size_t first = 0; first < inputs.size(); first += window) {
+        auto const count = std::min(window, inputs.size() - first);
+        std::vector<pod5::SignalLoadPlan> plans(count);
+        ARROW_RETURN_NOT_OK(pod5::internal::run_parallel_tasks(
+            options.thread_pool().get(), count, [&](std::size_t i) -> pod5::Status {
+                plans[i].path = inputs[first + i];
+                auto reader = pod5::open_file_reader(plans[i].path);
+                if (!reader.ok()) {
+                    return reader.status().WithMessage(
+                        plans[i].path, ": ", reader.status().message());
+                }
+                plans[i].reader = std::move(*reader);
+                return pod5::Status::OK();
+            }));
+
+        std::vector<std::shared_ptr<pod5::FileReader>> readers;
+        std::vector<std::shared_ptr<pod5::ReadTableProjection const>> projections;
+        for (auto const & plan : plans) {
+            readers.push_back(plan.reader);
+            ARROW_ASSIGN_OR_RAISE(
+                auto projection,
+                plan.reader->make_read_table_projection(
+                    {"read_id", "calibration_offset", "calibration_scale"}));
+            projections.push_back(std::move(projection));
+        }
+
+        pod5::MultiFileSignalLoader loader(std::move(plans), options);
+        while (true) {
+            ARROW_ASSIGN_OR_RAISE(auto batch, loader.release_next_batch());
+            if (!batch) {
+                break;
+            }
+            auto const & reader = *readers[batch->file_index];
+            ARROW_ASSIGN_OR_RAISE(
+                auto const read_batch,
+                reader.read_read_record_batch(
+                    batch->signal->batch_index(), *projections[batch->file_index]));
+            ARROW_RETURN_NOT_OK(signal_export.write_batch(
+                inputs[first + batch->file_index], read_batch, *batch->signal));
+        }
+    }
+    return signal_export.close();
+}
+
+}  // namespace pod5_fast
@@ -0,0 +1,471 @@
+#include "commands.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/uuid.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace pod5_fast {
+
+namespace {
+
+// Nanopore-like signal: levels held for a few samples each, as bases move through the pore, with
+// noise on top. The values are in pA, near those of R10.4.1 reads sampled at 5 kHz:
+constexpr std::uint16_t SAMPLE_RATE = 5000;
+constexpr double LEVEL_MEAN = 90;
+constexpr double LEVEL_SPREAD = 15;
+constexpr double MEAN_DWELL_SAMPLES = 10;
+constexpr double NOISE = 2;
+constexpr float CALIBRATION_OFFSET = -240;
+constexpr float CALIBRATION_SCALE = 0.1755f;
+constexpr std::uint16_t CHANNEL_COUNT = 512;
+
+/// Split [value] at each ':'.
+std::vector<std::string> split_fields(std::string const & value)
+{
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    while (true) {
+        auto const end = value.find(':', start);
+        fields.push_back(value.substr(start, end - start));
+        if (end == std::string::npos) {
+            return fields;
+        }
+        start = end + 1;
+    }
+}
+
+pod5::Result<double> parse_positive(std::string const & option, std::string const & value)
+{
+    std::size_t parsed_length = 0;
+    double number = 0;
+    try {
+        number = std::stod(value, &parsed_length);
+    } catch (std::exception const &) {
+    }
+    if (value.empty() || parsed_length != value.size() || !(number > 0)) {
+        return arrow::Status::Invalid("Option ", option, " expects a positive number, not ", value);
+    }
+    return number;
+}
+
+/// The distribution of read lengths, in samples.
+class ReadLengthModel {
+public:
+    /// Parse "lognormal:MEDIAN:SIGMA", "uniform:MIN:MAX" or "fixed:LENGTH".
+    static pod5::Result<ReadLengthModel> parse(std::string const & value)
+    {
+        auto const fields = split_fields(value);
+        ReadLengthModel model;
+        if (fields[0] == "lognormal" && fields.size() == 3) {
+            ARROW_ASSIGN_OR_RAISE(auto const median, parse_positive("--read-length", fields[1]));
+            ARROW_ASSIGN_OR_RAISE(auto const sigma, parse_positive("--read-length", fields[2]));
+            model.m_lognormal = std::lognormal_distribution<double>(std::log(median), sigma);
+            return model;
+        }
+        if (fields[0] == "uniform" && fields.size() == 3) {
+            ARROW_ASSIGN_OR_RAISE(auto const min, parse_positive("--read-length", fields[1]));
+            ARROW_ASSIGN_OR_RAISE(auto const max, parse_positive("--read-length", fields[2]));
+            if (max < min) {
+                return arrow::Status::Invalid("--read-length ", value, " has max below min");
+            }
+            model.m_uniform = std::uniform_int_distribution<std::uint64_t>(
+                std::uint64_t(min), std::uint64_t(max));
+            return model;
+        }
+        if (fields[0] == "fixed" && fields.size() == 2) {
+            ARROW_ASSIGN_OR_RAISE(auto const length, parse_positive("--read-length", fields[1]));
+            model.m_uniform = std::uniform_int_distribution<std::uint64_t>(
+                std::uint64_t(length), std::uint64_t(length));
+            return model;
+        }
+        return arrow::Status::Invalid(
+            "--read-length expects lognormal:MEDIAN:SIGMA, uniform:MIN:MAX or fixed:LENGTH, not ",
+            value);
+    }
+
+    template <typename Generator>
+    std::uint64_t sample(Generator & generator)
+    {
+        auto const length = m_lognormal ? std::llround((*m_lognormal)(generator))
+                                        : std::int64_t(m_uniform(generator));
+        return std::uint64_t(std::max<std::int64_t>(length, 1));
+    }
+
+private:
+    std::optional<std::lognormal_distribution<double>> m_lognormal;
+    std::uniform_int_distribution<std::uint64_t> m_uniform;
+};
+
+/// How each read's signal chunks are laid out in the signal table.
+struct SignalLayout {
+    enum class Kind {
+        // Each read's chunks are written together, just before the read:
+        Contiguous,
+        // The chunks of [group_size] reads are written in turn, a chunk of each at a time:
+        Interleaved,
+        // Every read's signal is written before any read, and the reads added in shuffled order:
+        Scattered,
+    };
+
+    /// Parse "contiguous", "interleaved:K" or "scattered".
+    static pod5::Result<SignalLayout> parse(std::string const & value)
+    {
+        auto const fields = split_fields(value);
+        if (fields.size() == 1 && fields[0] == "contiguous") {
+            return SignalLayout{Kind::Contiguous, 1};
+        }
+        if (fields.size() == 1 && fields[0] == "scattered") {
+            return SignalLayout{Kind::Scattered, 1};
+        }
+        if (fields.size() == 2 && fields[0] == "interleaved") {
+            ARROW_ASSIGN_OR_RAISE(auto const group_size, parse_positive("--layout", fields[1]));
+            return SignalLayout{Kind::Interleaved, std::size_t(group_size)};
+        }
+        return arrow::Status::Invalid(
+            "--layout expects contiguous, interleaved:K or scattered, not ", value);
+    }
+
+    Kind kind;
+    std::size_t group_size;
+};
+
+struct GenerateArgs {
+    std::size_t file_count;
+    std::size_t read_count;
+    std::uint64_t seed;
+    ReadLengthModel read_length;
+    SignalLayout layout;
+    std::size_t run_info_count;
+    pod5::FileWriterOptions options;
+};
+
+struct GeneratedCounts {
+    std::atomic<std::uint64_t> reads{0};
+    std::atomic<std::uint64_t> samples{0};
+    std::atomic<std::uint64_t> signal_rows{0};
+};
+
+/// Generates the reads of one file, drawing everything from one generator seeded from the
+/// file's index, so each file is the same whatever the thread count.
+class FileGenerator {
+public:
+    FileGenerator(GenerateArgs const & args, std::size_t file_index)
+    : m_args(args)
+    , m_read_length(args.read_length)
+    , m_uuid_generator(m_generator)
+    {
+        std::seed_seq seeds{std::uint64_t(args.seed), std::uint64_t(file_index)};
+        m_generator.seed(seeds);
+    }
+
+    pod5::Status run(pod5::FileWriter & writer, GeneratedCounts & counts)
+    {
+        ARROW_RETURN_NOT_OK(add_dictionaries(writer));
+
+        std::vector<pod5::ReadData> reads(m_args.read_count);
+        std::vector<std::uint64_t> sample_counts(m_args.read_count);
+        for (std::size_t i = 0; i < reads.size(); ++i) {
+            sample_counts[i] = m_read_length.sample(m_generator);
+            reads[i] = make_read_data(i, sample_counts[i]);
+        }
+
+        auto const chunk_size = m_args.options.max_signal_chunk_size();
+        std::vector<std::int16_t> signal;
+        switch (m_args.layout.kind) {
+        case SignalLayout::Kind::Contiguous:
+            for (std::size_t i = 0; i < reads.size(); ++i) {
+                make_signal(sample_counts[i], signal);
+                ARROW_RETURN_NOT_OK(writer.add_complete_read(reads[i], signal));
+                counts.signal_rows += (sample_counts[i] + chunk_size - 1) / chunk_size;
+            }
+            break;
+
+        case SignalLayout::Kind::Interleaved: {
+            auto const group_size = m_args.layout.group_size;
+            std::vector<std::vector<std::int16_t>> signals(group_size);
+            std::vector<std::vector<pod5::SignalTableRowIndex>> rows(group_size);
+            for (std::size_t first = 0; first < reads.size(); first += group_size) {
+                auto const count = std::min(group_size, reads.size() - first);
+                std::uint64_t longest = 0;
+                for (std::size_t i = 0; i < count; ++i) {
+                    make_signal(sample_counts[first + i], signals[i]);
+                    rows[i].clear();
+                    longest = std::max(longest, sample_counts[first + i]);
+                }
+                for (std::uint64_t offset = 0; offset < longest; offset += chunk_size) {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        if (offset >= signals[i].size()) {
+                            continue;
+                        }
+                        auto const chunk = gsl::make_span(signals[i]).subspan(
+                            offset,
+                            std::min<std::uint64_t>(chunk_size, signals[i].size() - offset));
+                        ARROW_ASSIGN_OR_RAISE(
+                            auto const chunk_rows,
+                            writer.add_signal(reads[first + i].read_id, chunk));
+                        rows[i].insert(rows[i].end(), chunk_rows.begin(), chunk_rows.end());
+                    }
+                }
+                for (std::size_t i = 0; i < count; ++i) {
+                    ARROW_RETURN_NOT_OK(writer.add_complete_read(
+                        reads[first + i], rows[i], sample_counts[first + i]));
+                    counts.signal_rows += rows[i].size();
+                }
+            }
+            break;
+        }
+
+        case SignalLayout::Kind::Scattered: {
+            std::vector<std::vector<pod5::SignalTableRowIndex>> rows(reads.size());
+            for (std::size_t i = 0; i < reads.size(); ++i) {
+                make_signal(sample_counts[i], signal);
+                ARROW_ASSIGN_OR_RAISE(rows[i], writer.add_signal(reads[i].read_id, signal));
+            }
+            std::vector<std::size_t> order(reads.size());
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+            std::shuffle(order.begin(), order.end(), m_generator);
+            for (auto const i : order) {
+                ARROW_RETURN_NOT_OK(writer.add_complete_read(reads[i], rows[i], sample_counts[i]));
+                counts.signal_rows += rows[i].size();
+            }
+            break;
+        }
+        }
+
+        counts.reads += reads.size();
+        for (auto const sample_count : sample_counts) {
+            counts.samples += sample_count;
+        }
+        return pod5::Status::OK();
+    }
+
+private:
+    pod5::Status add_dictionaries(pod5::FileWriter & writer)
+    {
+        ARROW_ASSIGN_OR_RAISE(m_pore_type, writer.add_pore_type("not_set"));
+        ARROW_ASSIGN_OR_RAISE(
+            m_signal_positive, writer.lookup_end_reason(pod5::ReadEndReason::signal_positive));
+        ARROW_ASSIGN_OR_RAISE(
+            m_unblock, writer.lookup_end_reason(pod5::ReadEndReason::unblock_mux_change));
+
+        // Each run info stands for an acquisition merged into the file:
+        for (std::size_t i = 0; i < m_args.run_info_count; ++i) {
+            auto const acquisition_id = pod5::to_string(m_uuid_generator());
+            auto const start_time = std::int64_t(1'700'000'000'000) + std::int64_t(i) * 3'600'000;
+            ARROW_ASSIGN_OR_RAISE(
+                auto const index,
+                writer.add_run_info(pod5::RunInfoData(
+                    acquisition_id,
+                    start_time,
+                    4095,
+                    -4096,
+                    {{"sample_frequency", std::to_string(SAMPLE_RATE)},
+                     {"sequencing_kit", "sqk-lsk114"}},
+                    "synthetic",
+                    "FAX00000",
+                    "FLO-MIN114",
+                    "sequencing/sequencing_MIN114_DNA_e8_2_400K",
+                    pod5::to_string(m_uuid_generator()),
+                    start_time,
+                    "synthetic",
+                    SAMPLE_RATE,
+                    "sqk-lsk114",
+                    "MN00000",
+                    "MinION Mk1B",
+                    "pod5-fast generate",
+                    "synthetic",
+                    "synthetic",
+                    {{"run_id", acquisition_id}})));
+            m_run_infos.push_back(index);
+        }
+        return pod5::Status::OK();
+    }
+
+    pod5::ReadData make_read_data(std::size_t index, std::uint64_t sample_count)
+    {
+        auto const channel = std::uint16_t(
+            std::uniform_int_distribution<std::uint32_t>(1, CHANNEL_COUNT)(m_generator));
+        auto const well =
+            std::uint8_t(std::uniform_int_distribution<std::uint32_t>(1, 4)(m_generator));
+        auto & channel_state = m_channels[channel - 1];
+        // Reads of each run info are written together, as a merge of whole acquisitions is:
+        auto const run_info = m_run_infos[index * m_run_infos.size() / m_args.read_count];
+        auto const unblocked = std::bernoulli_distribution(0.1)(m_generator);
+        auto const median_before = float(std::normal_distribution<double>(200, 10)(m_generator));
+        // Drawn apart from the arguments below, which are evaluated in an unspecified order:
+        auto const read_id = m_uuid_generator();
+        auto const read_number = channel_state.read_number++;
+
+        pod5::ReadData read(
+            read_id,
+            read_number,
+            channel_state.next_sample,
+            channel,
+            well,
+            m_pore_type,
+            CALIBRATION_OFFSET,
+            CALIBRATION_SCALE,
+            median_before,
+            unblocked ? m_unblock : m_signal_positive,
+            unblocked,
+            run_info,
+            sample_count / std::uint64_t(MEAN_DWELL_SAMPLES),
+            float(LEVEL_SPREAD),
+            float(LEVEL_MEAN),
+            float(LEVEL_SPREAD),
+            float(LEVEL_MEAN),
+            read_number,
+            float(channel_state.next_sample) / SAMPLE_RATE);
+        // Leave a gap between reads, as the pore is open or blocked between them:
+        channel_state.next_sample += sample_count + 1000;
+        return read;
+    }
+
+    void make_signal(std::uint64_t sample_count, std::vector<std::int16_t> & signal)
+    {
+        std::normal_distribution<float> level_distribution(LEVEL_MEAN, LEVEL_SPREAD);
+        std::geometric_distribution<std::uint32_t> dwell_distribution(1 / MEAN_DWELL_SAMPLES);
+        std::normal_distribution<float> noise_distribution(0, NOISE);
+
+        signal.resize(sample_count);
+        std::uint64_t position = 0;
+        while (position < sample_count) {
+            auto const level = level_distribution(m_generator);
+            auto const end = std::min<std::uint64_t>(
+                sample_count, position + 1 + dwell_distribution(m_generator));
+            for (; position < end; ++position) {
+                auto const pa = level + noise_distribution(m_generator);
+                auto const adc = std::lround(pa / CALIBRATION_SCALE - CALIBRATION_OFFSET);
+                signal[position] = std::int16_t(std::clamp<long>(
+                    adc,
+                    std::numeric_limits<std::int16_t>::min(),
+                    std::numeric_limits<std::int16_t>::max()));
+            }
+        }
+    }
+
+    struct ChannelState {
+        std::uint32_t read_number = 0;
+        std::uint64_t next_sample = 0;
+    };
+
+    GenerateArgs const & m_args;
+    ReadLengthModel m_read_length;
+    std::mt19937 m_generator;
+    pod5::UuidRandomGenerator m_uuid_generator;
+    pod5::PoreDictionaryIndex m_pore_type = 0;
+    pod5::EndReasonDictionaryIndex m_signal_positive = 0;
+    pod5::EndReasonDictionaryIndex m_unblock = 0;
+    std::vector<pod5::RunInfoDictionaryIndex> m_run_infos;
+    ChannelState m_channels[CHANNEL_COUNT];
+};
+
+}  // namespace
+
+pod5::Status run_generate(Arguments & args)
+{
+    auto const force_overwrite = args.take_flag("--force-overwrite");
+    ARROW_ASSIGN_OR_RAISE(auto const thread_count, take_thread_count(args));
+    ARROW_ASSIGN_OR_RAISE(auto const output, args.take_option("--output"));
+    if (!output) {
+        return arrow::Status::Invalid("An --output directory is required");
+    }
+
+    GenerateArgs generate_args;
+    ARROW_ASSIGN_OR_RAISE(generate_args.file_count, args.take_count("--files", 1));
+    ARROW_ASSIGN_OR_RAISE(generate_args.read_count, args.take_count("--reads", 4000));
+    ARROW_ASSIGN_OR_RAISE(generate_args.seed, args.take_count("--seed", 1));
+    ARROW_ASSIGN_OR_RAISE(generate_args.run_info_count, args.take_count("--run-infos", 1));
+    generate_args.run_info_count =
+        std::min(generate_args.run_info_count, generate_args.read_count);
+
+    ARROW_ASSIGN_OR_RAISE(auto const read_length, args.take_option("--read-length"));
+    ARROW_ASSIGN_OR_RAISE(
+        generate_args.read_length,
+        ReadLengthModel::parse(read_length.value_or("lognormal:40000:0.8")));
+    ARROW_ASSIGN_OR_RAISE(auto const layout, args.take_option("--layout"));
+    ARROW_ASSIGN_OR_RAISE(generate_args.layout, SignalLayout::parse(layout.value_or("contiguous")));
+
+    auto & options = generate_args.options;
+    ARROW_ASSIGN_OR_RAISE(
+        auto const chunk_size,
+        args.take_count("--chunk-size", pod5::FileWriterOptions::DEFAULT_SIGNAL_CHUNK_SIZE));
+    if (chunk_size > std::numeric_limits<std::uint32_t>::max()) {
+        return arrow::Status::Invalid("--chunk-size ", chunk_size, " is too large");
+    }
+    options.set_max_signal_chunk_size(std::uint32_t(chunk_size));
+    ARROW_ASSIGN_OR_RAISE(
+        auto const signal_batch_size,
+        args.take_count(
+            "--signal-batch-size", pod5::FileWriterOptions::DEFAULT_SIGNAL_TABLE_BATCH_SIZE));
+    options.set_signal_table_batch_size(signal_batch_size);
+    ARROW_ASSIGN_OR_RAISE(
+        auto const read_batch_size,
+        args.take_count(
+            "--read-batch-size", pod5::FileWriterOptions::DEFAULT_READ_TABLE_BATCH_SIZE));
+    options.set_read_table_batch_size(read_batch_size);
+    ARROW_ASSIGN_OR_RAISE(auto const positionals, args.take_positionals());
+    if (!positionals.empty()) {
+        return arrow::Status::Invalid("Unexpected argument ", positionals.front());
+    }
+
+    std::error_code error;
+    if (fs::exists(*output, error) && !fs::is_directory(*output, error)) {
+        return arrow::Status::Invalid("Output ", *output, " is a file, not a directory");
+    }
+
+    // Files are generated a thread each. Threads left over once every file has one compress
+    // signal for the files, so a few large files still use every core:
+    auto const thread_pool = pod5::make_thread_pool(pod5::numa_thread_pool_options(thread_count));
+    if (thread_count > generate_args.file_count) {
+        options.set_max_compression_jobs(thread_count / generate_args.file_count);
+        options.set_thread_pool(pod5::make_thread_pool(thread_count));
+    }
+
+    GeneratedCounts counts;
+    ARROW_RETURN_NOT_OK(pod5::internal::run_parallel_tasks(
+        thread_pool.get(), generate_args.file_count, [&](std::size_t file_index) -> pod5::Status {
+            auto const path =
+                (fs::path(*output) / ("synthetic_" + std::to_string(file_index) + ".pod5"))
+                    .string();
+            ARROW_RETURN_NOT_OK(prepare_output(path, force_overwrite));
+            auto status = [&]() -> pod5::Status {
+                ARROW_ASSIGN_OR_RAISE(
+                    auto writer, pod5::create_file_writer(path, "pod5-fast generate", options));
+                FileGenerator generator(generate_args, file_index);
+                ARROW_RETURN_NOT_OK(generator.run(*writer, counts));
+                return writer->close();
+            }();
+            if (!status.ok()) {
+                return status.WithMessage(path, ": ", status.message());
+            }
+            return pod5::Status::OK();
+        }));
+
+    std::cerr << "Generated " << counts.reads << " reads, " << counts.samples << " samples in "
+              << counts.signal_rows << " signal rows, into " << generate_args.file_count
+              << " files\n";
+    return pod5::Status::OK();
+}
+
+}  // namespace pod5_fast
@@ -0,0 +1,150 @@
+#include "commands.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_summary.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/memory_pool.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/schema_metadata.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid_format.h"
+
+#include <arrow/array/array_primitive.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pod5_fast {
+
+namespace {
+
+pod5::Result<std::uint64_t> count_samples(pod5::FileReader const & reader)
+{
+    // Only the sample count column is loaded, the reader migrates older tables to hold one:
+    ARROW_ASSIGN_OR_RAISE(
+        auto const projection, reader.make_read_table_projection({"num_samples"}));
+    std::uint64_t sample_count = 0;
+    for (std::size_t i = 0; i < reader.num_read_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto const batch, reader.read_read_record_batch(i, *projection));
+        ARROW_ASSIGN_OR_RAISE(auto const columns, batch.columns());
+        auto const num_samples = columns.num_samples;
+        for (std::int64_t row = 0; row < num_samples->length(); ++row) {
+            sample_count += num_samples->Value(row);
+        }
+    }
+    return sample_count;
+}
+
+pod5::Result<std::string> inspect_file(std::string const & path)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const reader, pod5::open_file_reader(path));
+    ARROW_ASSIGN_OR_RAISE(auto const read_count, reader->read_count());
+
+    // Files written with a summary answer without reading their read table:
+    ARROW_ASSIGN_OR_RAISE(
+        auto const summary, pod5::open_file_summary(path, pod5::default_memory_pool()));
+    std::uint64_t sample_count = 0;
+    if (summary) {
+        sample_count = summary->sample_count();
+    } else {
+        ARROW_ASSIGN_OR_RAISE(sample_count, count_samples(*reader));
+    }
+
+    auto const metadata = reader->schema_metadata();
+    std::ostringstream line;
+    line << path << '\t' << read_count << '\t' << sample_count << '\t'
+         << reader->signal_table_location().size << '\t' << reader->num_read_record_batches()
+         << '\t' << reader->num_signal_record_batches() << '\t'
+         << metadata.writing_pod5_version.to_string() << '\t' << metadata.writing_software
+         << '\t' << metadata.file_identifier << '\n';
+    return line.str();
+}
+
+pod5::Result<std::string> file_read_ids(std::string const & path)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const reader, pod5::open_file_reader(path));
+    ARROW_ASSIGN_OR_RAISE(auto const projection, reader->make_read_table_projection({"read_id"}));
+
+    std::string output;
+    for (std::size_t i = 0; i < reader->num_read_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto const batch, reader->read_read_record_batch(i, *projection));
+        auto const read_ids = batch.read_id_column();
+        auto const ids = gsl::make_span(read_ids->raw_values(), read_ids->length());
+
+        std::vector<char> formatted(ids.size() * pod5::UUID_STRING_LENGTH);
+        pod5::format_uuids(ids, formatted.data());
+        output.reserve(output.size() + ids.size() * (pod5::UUID_STRING_LENGTH + 1));
+        for (std::size_t id = 0; id < ids.size(); ++id) {
+            output.append(
+                formatted.data() + id * pod5::UUID_STRING_LENGTH, pod5::UUID_STRING_LENGTH);
+            output += '\n';
+        }
+    }
+    return output;
+}
+
+/// Run [per_file] over [inputs] on [thread_count] threads, printing each file's output in input
+/// order once it and the files before it are done.
+pod5::Status print_per_file(
+    std::vector<std::string> const & inputs,
+    std::size_t thread_count,
+    std::function<pod5::Result<std::string>(std::string const &)> const & per_file)
+{
+    auto const thread_pool = pod5::make_thread_pool(thread_count);
+    // Files are processed a window at a time, so output starts before every file is done:
+    std::size_t const window = thread_count * 4;
+    std::vector<std::string> outputs;
+    for (std::size_t first = 0; first < inputs.size(); first += window) {
+        auto const count = std::min(window, inputs.size() - first);
+        outputs.assign(count, {});
+        ARROW_RETURN_NOT_OK(pod5::internal::run_parallel_tasks(
+            thread_pool.get(), count, [&](std::size_t i) -> pod5::Status {
+                auto output = per_file(inputs[first + i]);
+                if (!output.ok()) {
+                    return output.status().WithMessage(
+                        inputs[first + i], ": ", output.status().message());
+                }
+                outputs[i] = std::move(*output);
+                return pod5::Status::OK();
+            }));
+        for (auto const & output : outputs) {
+            std::cout << output;
+        }
+    }
+    std::cout.flush();
+    return pod5::Status::OK();
+}
+
+}  // namespace
+
+pod5::Status run_inspect(Arguments & args)
+{
+    auto const recursive = args.take_flag("--recursive");
+    auto const no_header = args.take_flag("--no-header");
+    ARROW_ASSIGN_OR_RAISE(auto const thread_count, take_thread_count(args));
+    ARROW_ASSIGN_OR_RAISE(auto const paths, args.take_positionals());
+    ARROW_ASSIGN_OR_RAISE(auto const inputs, collect_inputs(paths, recursive));
+
+    if (!no_header) {
+        std::cout << "filename\treads\tsamples\tsignal_bytes\tread_batches\tsignal_batches"
+                     "\tpod5_version\twriting_software\tfile_identifier\n";
+    }
+    return print_per_file(inputs, thread_count, inspect_file);
+}
+
+pod5::Status run_read_ids(Arguments & args)
+{
+    auto const recursive = args.take_flag("--recursive");
+    ARROW_ASSIGN_OR_RAISE(auto const thread_count, take_thread_count(args));
+    ARROW_ASSIGN_OR_RAISE(auto const paths, args.take_positionals());
+    ARROW_ASSIGN_OR_RAISE(auto const inputs, collect_inputs(paths, recursive));
+
+    return print_per_file(inputs, thread_count, file_read_ids);
+}
+
+}  // namespace pod5_fast
@@ -0,0 +1,137 @@
+#include "commands.h"
+#include "pod5_format/types.h"
+#include "pod5_format/version.h"
+#include "tool_utils.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Command {
+    char const * name;
+    std::function<pod5::Status(pod5_fast::Arguments &)> run;
+    char const * usage;
+};
+
+std::vector<Command> const & commands()
+{
+    static std::vector<Command> const commands{
+        {"inspect",
+         pod5_fast::run_inspect,
+         "inspect [--recursive] [--no-header] [--threads N] <inputs...>\n"
+         "    Print a tab separated summary line for each file: reads, samples, signal bytes,\n"
+         "    batches, and the pod5 version, software and identifier it was written with.\n"},
+        {"read-ids",
+         pod5_fast::run_read_ids,
+         "read-ids [--recursive] [--threads N] <inputs...>\n"
+         "    Print the id of every read, one per line in file order.\n"},
+        {"filter",
+         pod5_fast::run_filter,
+         "filter --ids <read_ids.txt> --output <file.pod5> [--missing-ok] [--duplicate-ok]\n"
+         "       [--force-overwrite] [--recursive] [--readers N] [--threads N] <inputs...>\n"
+         "    Copy the reads listed one per line in the ids file into one output, failing if\n"
+         "    any aren't found unless --missing-ok is given.\n"},
+        {"merge",
+         pod5_fast::run_merge,
+         "merge --output <file.pod5> [--duplicate-ok] [--force-overwrite] [--recursive]\n"
+         "      [--readers N] [--threads N] <inputs...>\n"
+         "    Copy every read of the inputs into one output.\n"},
+        {"export-signal",
+         pod5_fast::run_export_signal,
+         "export-signal --output <prefix> [--force-overwrite] [--recursive] [--threads N]\n"
+         "              <inputs...>\n"
+         "    Write every read's raw samples, as little endian int16, one read after another to\n"
+         "    <prefix>.samples, and a line for each read locating its samples, with its\n"
+         "    calibration, to <prefix>.index.tsv.\n"},
+        {"generate",
+         pod5_fast::run_generate,
+         "generate --output <directory> [--files N] [--reads N] [--seed N]\n"
+         "         [--read-length lognormal:MEDIAN:SIGMA|uniform:MIN:MAX|fixed:LENGTH]\n"
+         "         [--chunk-size N] [--signal-batch-size N] [--read-batch-size N]\n"
+         "         [--run-infos N] [--layout contiguous|interleaved:K|scattered]\n"
+         "         [--force-overwrite] [--threads N]\n"
+         "    Write --files (default 1) synthetic files of --reads (default 4000) reads each,\n"
+         "    with nanopore-like signal drawn from --seed, so the same arguments give the same\n"
+         "    files. Read lengths default to lognormal:40000:0.8 samples, and the layout of each\n"
+         "    read's signal chunks in the signal table to contiguous.\n"},
+#ifdef POD5_FAST_HAS_HDF5
+        {"to-fast5",
+         pod5_fast::run_to_fast5,
+         "to-fast5 --output <directory> [--file-read-count N] [--force-overwrite] [--recursive]\n"
+         "         [--threads N] <inputs...>\n"
+         "    Convert every read to multi-read fast5, --file-read-count (default 4000) reads per\n"
+         "    file, copying vbz compressed signal into the fast5 vbz filter's chunks as it is.\n"},
+#endif
+        {"verify",
+         pod5_fast::run_verify,
+         "verify [--recursive] [--no-frames] [--threads N] <inputs...>\n"
+         "    Check each file's tables are intact, every read's signal rows exist and hold its\n"
+         "    samples, and signal rows match their checksums and zstd frame headers, without\n"
+         "    decoding signal. Prints OK or the problem found for each file.\n"},
+    };
+    return commands;
+}
+
+void print_usage(std::ostream & out)
+{
+    out << "pod5-fast " << pod5::Pod5Version << "\n\n"
+        << "Usage: pod5-fast <command> [arguments]\n\n"
+        << "Directories given as inputs are searched for .pod5 files. --threads defaults to a\n"
+        << "thread per core, --readers (the inputs held open at once) to 5.\n\n"
+        << "Commands:\n";
+    for (auto const & command : commands()) {
+        out << "  " << command.usage;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2) {
+        print_usage(std::cerr);
+        return EXIT_FAILURE;
+    }
+    if (std::strcmp(argv[1], "--help") == 0 || std::strcmp(argv[1], "-h") == 0) {
+        print_usage(std::cout);
+        return EXIT_SUCCESS;
+    }
+    if (std::strcmp(argv[1], "--version") == 0) {
+        std::cout << pod5::Pod5Version << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    std::string const name = argv[1];
+    for (auto const & command : commands()) {
+        if (name != command.name) {
+            continue;
+        }
+        if (argc > 2 && (std::strcmp(argv[2], "--help") == 0 || std::strcmp(argv[2], "-h") == 0)) {
+            std::cout << "Usage: pod5-fast " << command.usage;
+            return EXIT_SUCCESS;
+        }
+
+        std::ios::sync_with_stdio(false);
+        auto status = pod5::register_extension_types();
+        if (status.ok()) {
+            pod5_fast::Arguments args{std::vector<std::string>(argv + 2, argv + argc)};
+            status = command.run(args);
+        }
+        (void)pod5::unregister_extension_types();
+
+        if (!status.ok()) {
+            std::cerr << "pod5-fast " << name << ": " << status.ToString() << "\n";
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    std::cerr << "Unknown command \"" << name << "\"\n\n";
+    print_usage(std::cerr);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,268 @@
+#include "commands.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_writer.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/read_id_index.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format_pybind/repack/repack_output.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pod5_fast {
+
+namespace {
+
+// Outputs stop reading input batches while this many bytes of signal batches are waiting to be
+// written, as with the python repacker's default:
+constexpr std::size_t MAX_PENDING_BYTES = std::size_t(2) << 30;
+
+constexpr std::size_t DEFAULT_OPEN_READERS = 5;
+
+/// Copies reads into one output file with the repacker, keeping a bounded number of inputs open.
+class RepackRun {
+public:
+    RepackRun(
+        std::size_t thread_count,
+        std::shared_ptr<pod5::FileWriter> const & writer,
+        bool check_duplicate_read_ids,
+        std::size_t max_open_readers)
+    : m_thread_pool(pod5::make_thread_pool(pod5::numa_thread_pool_options(thread_count)))
+    , m_writer(writer)
+    , m_output(std::make_shared<repack::Pod5RepackerOutput>(
+          nullptr,
+          m_thread_pool,
+          std::make_shared<repack::PendingBytesBudget>(MAX_PENDING_BYTES),
+          std::make_shared<repack::RepackStatisticsCounters>(),
+          writer,
+          check_duplicate_read_ids))
+    , m_max_open_readers(max_open_readers)
+    {
+    }
+
+    ~RepackRun() { m_thread_pool->stop_and_drain(); }
+
+    repack::Pod5RepackerOutput & output() { return *m_output; }
+
+    /// Wait for the output to let go of inputs until another can be opened.
+    pod5::Status wait_to_open_reader()
+    {
+        while (true) {
+            if (m_output->has_error()) {
+                return m_output->error();
+            }
+            m_open_readers.erase(
+                std::remove_if(
+                    m_open_readers.begin(),
+                    m_open_readers.end(),
+                    [](auto const & reader) { return reader.expired(); }),
+                m_open_readers.end());
+            if (m_open_readers.size() < m_max_open_readers) {
+                return pod5::Status::OK();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    /// Record [reader] is held by the output until its reads are copied.
+    void track_reader(std::shared_ptr<pod5::FileReader> const & reader)
+    {
+        m_open_readers.push_back(reader);
+    }
+
+    /// Wait for every read to be written, then close the output.
+    pod5::Status finish()
+    {
+        m_output->set_finished();
+        while (!m_output->has_error() && !m_output->is_complete()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (m_output->has_error()) {
+            return m_output->error();
+        }
+        std::cerr << "Wrote " << m_output->reads_completed() << " reads to "
+                  << m_output->path() << "\n";
+        return m_writer->close();
+    }
+
+private:
+    std::shared_ptr<pod5::ThreadPool> m_thread_pool;
+    std::shared_ptr<pod5::FileWriter> m_writer;
+    std::shared_ptr<repack::Pod5RepackerOutput> m_output;
+    std::size_t m_max_open_readers;
+    std::vector<std::weak_ptr<pod5::FileReader>> m_open_readers;
+};
+
+struct RepackArguments {
+    std::vector<std::string> inputs;
+    std::string output;
+    std::size_t thread_count;
+    std::size_t max_open_readers;
+    bool check_duplicate_read_ids;
+    bool force_overwrite;
+};
+
+/// Take the arguments shared by commands writing one output, with the inputs last.
+pod5::Result<RepackArguments> take_repack_arguments(Arguments & args)
+{
+    RepackArguments result;
+    auto const recursive = args.take_flag("--recursive");
+    result.force_overwrite = args.take_flag("--force-overwrite");
+    result.check_duplicate_read_ids = !args.take_flag("--duplicate-ok");
+    ARROW_ASSIGN_OR_RAISE(result.thread_count, take_thread_count(args));
+    ARROW_ASSIGN_OR_RAISE(
+        result.max_open_readers, args.take_count("--readers", DEFAULT_OPEN_READERS));
+    ARROW_ASSIGN_OR_RAISE(auto const output, args.take_option("--output"));
+    if (!output) {
+        return arrow::Status::Invalid("An --output file is required");
+    }
+    result.output = *output;
+
+    ARROW_ASSIGN_OR_RAISE(auto const paths, args.take_positionals());
+    ARROW_ASSIGN_OR_RAISE(result.inputs, collect_inputs(paths, recursive));
+    return result;
+}
+
+pod5::Result<std::unique_ptr<RepackRun>> start_repack(RepackArguments const & repack_args)
+{
+    ARROW_RETURN_NOT_OK(prepare_output(repack_args.output, repack_args.force_overwrite));
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<pod5::FileWriter> writer,
+        pod5::create_file_writer(repack_args.output, "pod5-fast", pod5::FileWriterOptions{}));
+    return std::make_unique<RepackRun>(
+        repack_args.thread_count,
+        writer,
+        repack_args.check_duplicate_read_ids,
+        repack_args.max_open_readers);
+}
+
+/// The rows of one input holding any of a sorted list of read ids.
+struct InputSelection {
+    std::shared_ptr<pod5::FileReader> reader;
+    std::vector<std::vector<std::uint32_t>> batch_rows;
+    // Indices into the sorted read ids of the reads found in the input:
+    std::vector<std::size_t> found_targets;
+};
+
+pod5::Result<InputSelection> select_reads(
+    std::string const & path,
+    std::vector<pod5::Uuid> const & targets)
+{
+    InputSelection selection;
+    ARROW_ASSIGN_OR_RAISE(selection.reader, pod5::open_file_reader(path));
+    ARROW_ASSIGN_OR_RAISE(auto const index, selection.reader->read_id_index());
+    auto const index_ids = index->read_ids();
+
+    // The sorted targets are walked forward through the input's sorted index:
+    selection.batch_rows.resize(selection.reader->num_read_record_batches());
+    std::size_t entry = 0;
+    for (std::size_t target = 0; target < targets.size(); ++target) {
+        entry = index->lower_bound(targets[target], entry);
+        if (entry == index_ids.size()) {
+            break;
+        }
+        if (!(index_ids[entry] == targets[target])) {
+            continue;
+        }
+
+        selection.found_targets.push_back(target);
+        for (; entry < index_ids.size() && index_ids[entry] == targets[target]; ++entry) {
+            selection.batch_rows[index->batch(entry)].push_back(index->batch_row(entry));
+        }
+    }
+
+    // Rows are copied in file order:
+    for (auto & rows : selection.batch_rows) {
+        std::sort(rows.begin(), rows.end());
+    }
+    return selection;
+}
+
+}  // namespace
+
+pod5::Status run_filter(Arguments & args)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const ids_path, args.take_option("--ids"));
+    if (!ids_path) {
+        return arrow::Status::Invalid("An --ids list of read ids is required");
+    }
+    auto const missing_ok = args.take_flag("--missing-ok");
+    ARROW_ASSIGN_OR_RAISE(auto const repack_args, take_repack_arguments(args));
+
+    ARROW_ASSIGN_OR_RAISE(auto targets, read_id_list(*ids_path));
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+    ARROW_ASSIGN_OR_RAISE(auto run, start_repack(repack_args));
+    auto const search_pool = pod5::make_thread_pool(repack_args.thread_count);
+    std::vector<bool> target_found(targets.size(), false);
+
+    // Inputs are opened and searched a window at a time, as many as the output holds open:
+    auto const & inputs = repack_args.inputs;
+    auto const window = repack_args.max_open_readers;
+    std::vector<InputSelection> selections;
+    for (std::size_t first = 0; first < inputs.size(); first += window) {
+        auto const count = std::min(window, inputs.size() - first);
+        selections.assign(count, {});
+        ARROW_RETURN_NOT_OK(pod5::internal::run_parallel_tasks(
+            search_pool.get(), count, [&](std::size_t i) -> pod5::Status {
+                auto selection = select_reads(inputs[first + i], targets);
+                if (!selection.ok()) {
+                    return selection.status().WithMessage(
+                        inputs[first + i], ": ", selection.status().message());
+                }
+                selections[i] = std::move(*selection);
+                return pod5::Status::OK();
+            }));
+
+        for (auto & selection : selections) {
+            if (selection.found_targets.empty()) {
+                continue;
+            }
+            for (auto const target : selection.found_targets) {
+                target_found[target] = true;
+            }
+
+            ARROW_RETURN_NOT_OK(run->wait_to_open_reader());
+            for (std::size_t batch = 0; batch < selection.batch_rows.size(); ++batch) {
+                if (!selection.batch_rows[batch].empty()) {
+                    run->output().register_new_reads(
+                        selection.reader, batch, std::move(selection.batch_rows[batch]));
+                }
+            }
+            run->track_reader(selection.reader);
+        }
+        selections.clear();
+    }
+    ARROW_RETURN_NOT_OK(run->finish());
+
+    auto const missing_count =
+        std::size_t(std::count(target_found.begin(), target_found.end(), false));
+    if (missing_count > 0 && !missing_ok) {
+        return arrow::Status::Invalid(
+            missing_count, " of ", targets.size(), " read ids were not found in the inputs");
+    }
+    return pod5::Status::OK();
+}
+
+pod5::Status run_merge(Arguments & args)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const repack_args, take_repack_arguments(args));
+
+    ARROW_ASSIGN_OR_RAISE(auto run, start_repack(repack_args));
+    for (auto const & input : repack_args.inputs) {
+        ARROW_RETURN_NOT_OK(run->wait_to_open_reader());
+        ARROW_ASSIGN_OR_RAISE(auto const reader, pod5::open_file_reader(input));
+        run->output().register_all_reads(reader);
+        run->track_reader(reader);
+    }
+    return run->finish();
+}
+
+}  // namespace pod5_fast
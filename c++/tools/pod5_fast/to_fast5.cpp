@@ -0,0 +1,620 @@
+#include "commands.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/internal/parallel_tasks.h"
+#include "pod5_format/read_table_reader.h"
+#include "pod5_format/read_table_utils.h"
+#include "pod5_format/signal_compression.h"
+#include "pod5_format/thread_pool.h"
+#include "pod5_format/types.h"
+#include "pod5_format/uuid.h"
+
+#include <arrow/buffer.h>
+#include <hdf5.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace pod5_fast {
+
+namespace {
+
+// HDF5 filter id registered for vbz compression, and the options the python converter writes
+// (vbz version 0, 2 byte integers, delta zig-zag, zstd level 1):
+constexpr H5Z_filter_t VBZ_FILTER_ID = 32020;
+constexpr unsigned int VBZ_FILTER_OPTIONS[] = {0, 2, 1, 1};
+// The vbz filter prefixes each compressed chunk with its uncompressed size in bytes:
+constexpr std::size_t VBZ_CHUNK_HEADER_SIZE = sizeof(std::uint32_t);
+
+/// A read's metadata and its signal as vbz filter chunks, ready to be written to a fast5 file.
+struct Fast5Read {
+    pod5::Uuid read_id;
+    std::uint32_t read_number = 0;
+    std::uint64_t start_sample = 0;
+    float median_before = 0;
+    std::uint64_t num_minknow_events = 0;
+    float tracked_scaling_scale = 0;
+    float tracked_scaling_shift = 0;
+    float predicted_scaling_scale = 0;
+    float predicted_scaling_shift = 0;
+    std::uint32_t num_reads_since_mux_change = 0;
+    float time_since_mux_change = 0;
+    std::uint16_t channel = 0;
+    std::uint8_t well = 0;
+    float calibration_offset = 0;
+    float calibration_scale = 0;
+    pod5::ReadEndReason end_reason = pod5::ReadEndReason::unknown;
+    std::string pore_type;
+    std::shared_ptr<pod5::RunInfoData const> run_info;
+
+    std::uint64_t sample_count = 0;
+    std::uint64_t chunk_samples = 0;
+    std::vector<std::vector<std::uint8_t>> chunks;
+};
+
+/// Counts of how each read's signal was written.
+struct ChunkCounts {
+    std::uint64_t copied = 0;
+    std::uint64_t recompressed = 0;
+};
+
+/// Make a vbz filter chunk holding [sample_count] samples from [frame], a compressed pod5 row.
+std::vector<std::uint8_t> make_chunk(
+    gsl::span<std::uint8_t const> const & frame,
+    std::uint64_t sample_count)
+{
+    std::vector<std::uint8_t> chunk(VBZ_CHUNK_HEADER_SIZE + frame.size());
+    auto const uncompressed_size = static_cast<std::uint32_t>(sample_count * sizeof(std::int16_t));
+    for (std::size_t i = 0; i < VBZ_CHUNK_HEADER_SIZE; ++i) {
+        chunk[i] = static_cast<std::uint8_t>(uncompressed_size >> (8 * i));
+    }
+    std::copy(frame.begin(), frame.end(), chunk.begin() + VBZ_CHUNK_HEADER_SIZE);
+    return chunk;
+}
+
+/// Compress [samples] into a vbz filter chunk of [chunk_samples] samples, padding the end of
+/// the signal with zeros as HDF5 does for a dataset's last chunk.
+pod5::Result<std::vector<std::uint8_t>> compress_chunk(
+    gsl::span<std::int16_t const> const & samples,
+    std::uint64_t chunk_samples,
+    std::vector<std::int16_t> & padded,
+    std::vector<std::uint8_t> & compressed)
+{
+    auto chunk_signal = samples;
+    if (samples.size() < chunk_samples) {
+        padded.assign(chunk_samples, 0);
+        std::copy(samples.begin(), samples.end(), padded.begin());
+        chunk_signal = gsl::make_span(padded);
+    }
+    compressed.resize(pod5::compressed_signal_max_size(chunk_signal.size()));
+    ARROW_ASSIGN_OR_RAISE(
+        auto const compressed_size,
+        pod5::compress_signal(
+            chunk_signal,
+            pod5::thread_local_signal_compression_context(),
+            gsl::make_span(compressed)));
+    return make_chunk(gsl::make_span(compressed).first(compressed_size), chunk_signal.size());
+}
+
+/// Fill [read]'s signal chunks from its signal rows [rows].
+///
+/// Each row of a vbz compressed file holds the same zstd frame the vbz filter stores, so rows
+/// are copied as chunks when all but the last hold the same sample count. The last row is
+/// recompressed if it holds fewer samples, as HDF5 chunks are all the same size. Other signal
+/// is decoded, and recompressed in chunks the size of the read's first row.
+pod5::Status fill_signal_chunks(
+    pod5::FileReader const & reader,
+    gsl::span<std::uint64_t const> const & rows,
+    Fast5Read & read,
+    ChunkCounts & counts)
+{
+    std::vector<std::uint32_t> row_sample_counts;
+    ARROW_ASSIGN_OR_RAISE(
+        auto const row_data, reader.extract_samples_inplace(rows, row_sample_counts));
+    read.sample_count = 0;
+    for (auto const count : row_sample_counts) {
+        read.sample_count += count;
+    }
+    if (read.sample_count == 0) {
+        return pod5::Status::OK();
+    }
+    read.chunk_samples = row_sample_counts.front() ? row_sample_counts.front() : read.sample_count;
+
+    bool copy_rows = reader.signal_type() == pod5::SignalType::VbzSignal;
+    for (std::size_t i = 0; copy_rows && i + 1 < row_sample_counts.size(); ++i) {
+        copy_rows = row_sample_counts[i] == read.chunk_samples;
+    }
+    copy_rows = copy_rows && row_sample_counts.back() <= read.chunk_samples;
+
+    std::vector<std::int16_t> padded;
+    std::vector<std::uint8_t> compressed;
+    if (copy_rows) {
+        read.chunks.reserve(rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            if (row_sample_counts[i] == read.chunk_samples) {
+                auto const & data = row_data[i];
+                read.chunks.push_back(
+                    make_chunk(gsl::make_span(data->data(), data->size()), read.chunk_samples));
+                counts.copied += 1;
+                continue;
+            }
+            std::vector<std::int16_t> samples(row_sample_counts[i]);
+            ARROW_RETURN_NOT_OK(
+                reader.extract_samples(rows.subspan(i, 1), gsl::make_span(samples)));
+            ARROW_ASSIGN_OR_RAISE(
+                auto chunk,
+                compress_chunk(gsl::make_span(samples), read.chunk_samples, padded, compressed));
+            read.chunks.push_back(std::move(chunk));
+            counts.recompressed += 1;
+        }
+        return pod5::Status::OK();
+    }
+
+    std::vector<std::int16_t> samples(read.sample_count);
+    ARROW_RETURN_NOT_OK(reader.extract_samples(rows, gsl::make_span(samples)));
+    for (std::uint64_t start = 0; start < read.sample_count; start += read.chunk_samples) {
+        auto const chunk_signal = gsl::make_span(samples).subspan(
+            start, std::min(read.chunk_samples, read.sample_count - start));
+        ARROW_ASSIGN_OR_RAISE(
+            auto chunk, compress_chunk(chunk_signal, read.chunk_samples, padded, compressed));
+        read.chunks.push_back(std::move(chunk));
+        counts.recompressed += 1;
+    }
+    return pod5::Status::OK();
+}
+
+/// Read the reads of batch [batch_index] of [reader], with their signal as vbz filter chunks.
+pod5::Result<std::vector<Fast5Read>> prepare_batch(
+    pod5::FileReader const & reader,
+    std::size_t batch_index,
+    ChunkCounts & counts)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const batch, reader.read_read_record_batch(batch_index));
+    auto const view = batch.view();
+
+    // Dictionary values are shared by many reads of a batch, so are looked up once:
+    std::map<std::int16_t, std::string> pore_types;
+    std::map<std::int16_t, pod5::ReadEndReason> end_reasons;
+    std::map<std::int16_t, std::shared_ptr<pod5::RunInfoData const>> run_infos;
+
+    std::vector<Fast5Read> reads(view.num_rows);
+    for (std::int64_t row = 0; row < view.num_rows; ++row) {
+        auto & read = reads[row];
+        read.read_id = view.read_id[row];
+        read.read_number = view.read_number[row];
+        read.start_sample = view.start_sample[row];
+        read.median_before = view.median_before[row];
+        read.num_minknow_events = view.num_minknow_events[row];
+        read.tracked_scaling_scale = view.tracked_scaling_scale[row];
+        read.tracked_scaling_shift = view.tracked_scaling_shift[row];
+        read.predicted_scaling_scale = view.predicted_scaling_scale[row];
+        read.predicted_scaling_shift = view.predicted_scaling_shift[row];
+        read.num_reads_since_mux_change = view.num_reads_since_mux_change[row];
+        read.time_since_mux_change = view.time_since_mux_change[row];
+        read.channel = view.channel[row];
+        read.well = view.well[row];
+        read.calibration_offset = view.calibration_offset[row];
+        read.calibration_scale = view.calibration_scale[row];
+
+        auto const pore_type_index = view.pore_type[row];
+        if (pore_types.find(pore_type_index) == pore_types.end()) {
+            ARROW_ASSIGN_OR_RAISE(
+                pore_types[pore_type_index], batch.get_pore_type(pore_type_index));
+        }
+        read.pore_type = pore_types[pore_type_index];
+
+        auto const end_reason_index = view.end_reason[row];
+        if (end_reasons.find(end_reason_index) == end_reasons.end()) {
+            ARROW_ASSIGN_OR_RAISE(auto const end_reason, batch.get_end_reason(end_reason_index));
+            end_reasons[end_reason_index] = end_reason.first;
+        }
+        read.end_reason = end_reasons[end_reason_index];
+
+        auto const run_info_index = view.run_info[row];
+        if (run_infos.find(run_info_index) == run_infos.end()) {
+            ARROW_ASSIGN_OR_RAISE(auto const acquisition_id, batch.get_run_info(run_info_index));
+            ARROW_ASSIGN_OR_RAISE(run_infos[run_info_index], reader.find_run_info(acquisition_id));
+        }
+        read.run_info = run_infos[run_info_index];
+
+        ARROW_RETURN_NOT_OK(fill_signal_chunks(reader, view.signal[row], read, counts));
+    }
+    return reads;
+}
+
+/// An HDF5 object id, closed with [close] when the handle is destroyed.
+class Hdf5Handle {
+public:
+    static constexpr hid_t INVALID_ID = -1;
+
+    Hdf5Handle(hid_t id, herr_t (*close)(hid_t)) : m_id(id), m_close(close) {}
+    Hdf5Handle(Hdf5Handle && other) : m_id(other.m_id), m_close(other.m_close)
+    {
+        other.m_id = INVALID_ID;
+    }
+    Hdf5Handle & operator=(Hdf5Handle && other)
+    {
+        std::swap(m_id, other.m_id);
+        std::swap(m_close, other.m_close);
+        return *this;
+    }
+    Hdf5Handle(Hdf5Handle const &) = delete;
+    Hdf5Handle & operator=(Hdf5Handle const &) = delete;
+
+    ~Hdf5Handle()
+    {
+        if (m_id >= 0) {
+            m_close(m_id);
+        }
+    }
+
+    hid_t get() const { return m_id; }
+
+    /// Close the object now, reporting if closing it failed.
+    pod5::Status close(char const * description)
+    {
+        auto const id = m_id;
+        m_id = INVALID_ID;
+        if (id >= 0 && m_close(id) < 0) {
+            return arrow::Status::IOError("Failed to close ", description);
+        }
+        return pod5::Status::OK();
+    }
+
+private:
+    hid_t m_id;
+    herr_t (*m_close)(hid_t);
+};
+
+pod5::Result<Hdf5Handle> check_created(hid_t id, herr_t (*close)(hid_t), std::string const & name)
+{
+    if (id < 0) {
+        return arrow::Status::IOError("Failed to create ", name);
+    }
+    return Hdf5Handle(id, close);
+}
+
+pod5::Result<Hdf5Handle> create_group(hid_t parent, std::string const & name)
+{
+    return check_created(
+        H5Gcreate2(parent, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose, name);
+}
+
+pod5::Status write_attribute(hid_t object, char const * name, hid_t type, void const * value)
+{
+    ARROW_ASSIGN_OR_RAISE(auto space, check_created(H5Screate(H5S_SCALAR), H5Sclose, name));
+    ARROW_ASSIGN_OR_RAISE(
+        auto attribute,
+        check_created(
+            H5Acreate2(object, name, type, space.get(), H5P_DEFAULT, H5P_DEFAULT),
+            H5Aclose,
+            name));
+    if (H5Awrite(attribute.get(), type, value) < 0) {
+        return arrow::Status::IOError("Failed to write attribute ", name);
+    }
+    return attribute.close(name);
+}
+
+template <typename T>
+pod5::Status write_attribute(hid_t object, char const * name, hid_t type, T value)
+{
+    return write_attribute(object, name, type, static_cast<void const *>(&value));
+}
+
+/// Write a variable length string attribute, as h5py writes python strings.
+pod5::Status write_string_attribute(
+    hid_t object,
+    char const * name,
+    std::string const & value,
+    H5T_cset_t cset = H5T_CSET_UTF8)
+{
+    ARROW_ASSIGN_OR_RAISE(auto type, check_created(H5Tcopy(H5T_C_S1), H5Tclose, name));
+    if (H5Tset_size(type.get(), H5T_VARIABLE) < 0 || H5Tset_cset(type.get(), cset) < 0) {
+        return arrow::Status::IOError("Failed to make string type for ", name);
+    }
+    char const * data = value.c_str();
+    return write_attribute(object, name, type.get(), static_cast<void const *>(&data));
+}
+
+/// Writes reads to multi-read fast5 files, as the python pod5 to fast5 converter does.
+class Fast5Writer {
+public:
+    static pod5::Result<Fast5Writer> make()
+    {
+        // Reads' end reasons, with "partial" which fast5 has and pod5 doesn't:
+        ARROW_ASSIGN_OR_RAISE(
+            auto end_reason_type,
+            check_created(H5Tenum_create(H5T_NATIVE_UINT8), H5Tclose, "end reason type"));
+        auto const last_value = fast5_end_reason(pod5::ReadEndReason::last_end_reason);
+        for (std::uint8_t value = 0; value <= last_value; ++value) {
+            auto const reason = static_cast<pod5::ReadEndReason>(value == 0 ? 0 : value - 1);
+            auto const name = value == 1 ? "partial" : pod5::end_reason_as_string(reason);
+            if (H5Tenum_insert(end_reason_type.get(), name, &value) < 0) {
+                return arrow::Status::IOError("Failed to make end reason type");
+            }
+        }
+        return Fast5Writer(std::move(end_reason_type));
+    }
+
+    /// Open the fast5 file [path], closing the file open before it.
+    pod5::Status open(std::string const & path)
+    {
+        ARROW_RETURN_NOT_OK(close());
+        ARROW_ASSIGN_OR_RAISE(
+            m_file,
+            check_created(
+                H5Fcreate(path.c_str(), H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT), H5Fclose, path));
+        ARROW_RETURN_NOT_OK(
+            write_string_attribute(m_file->get(), "file_version", "3.0", H5T_CSET_ASCII));
+        ARROW_RETURN_NOT_OK(
+            write_string_attribute(m_file->get(), "file_type", "multi-read", H5T_CSET_ASCII));
+        m_path = path;
+        m_file_read_count = 0;
+        return pod5::Status::OK();
+    }
+
+    /// Find the number of reads written to the open file.
+    std::size_t file_read_count() const { return m_file_read_count; }
+
+    pod5::Status write_read(Fast5Read const & read)
+    {
+        auto const read_id = pod5::to_string(read.read_id);
+        auto const & run_info = *read.run_info;
+        auto run_id = run_info.acquisition_id;
+        for (auto const & tracking_entry : run_info.tracking_id) {
+            if (tracking_entry.first == "run_id") {
+                run_id = tracking_entry.second;
+            }
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto read_group, create_group(m_file->get(), "read_" + read_id));
+        ARROW_RETURN_NOT_OK(
+            write_string_attribute(read_group.get(), "run_id", run_id, H5T_CSET_ASCII));
+        ARROW_RETURN_NOT_OK(
+            write_string_attribute(read_group.get(), "pore_type", read.pore_type, H5T_CSET_ASCII));
+
+        ARROW_ASSIGN_OR_RAISE(auto tracking_id, create_group(read_group.get(), "tracking_id"));
+        for (auto const & entry : run_info.tracking_id) {
+            ARROW_RETURN_NOT_OK(
+                write_string_attribute(tracking_id.get(), entry.first.c_str(), entry.second));
+        }
+        ARROW_RETURN_NOT_OK(tracking_id.close("tracking_id"));
+
+        ARROW_ASSIGN_OR_RAISE(auto context_tags, create_group(read_group.get(), "context_tags"));
+        for (auto const & entry : run_info.context_tags) {
+            ARROW_RETURN_NOT_OK(
+                write_string_attribute(context_tags.get(), entry.first.c_str(), entry.second));
+        }
+        ARROW_RETURN_NOT_OK(context_tags.close("context_tags"));
+
+        ARROW_ASSIGN_OR_RAISE(auto channel_id, create_group(read_group.get(), "channel_id"));
+        double const digitisation = run_info.adc_max - run_info.adc_min + 1;
+        auto const channel = channel_id.get();
+        ARROW_RETURN_NOT_OK(
+            write_attribute(channel, "digitisation", H5T_NATIVE_DOUBLE, digitisation));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            channel, "offset", H5T_NATIVE_DOUBLE, double(read.calibration_offset)));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            channel, "range", H5T_NATIVE_DOUBLE, digitisation * read.calibration_scale));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            channel, "sampling_rate", H5T_NATIVE_DOUBLE, double(run_info.sample_rate)));
+        ARROW_RETURN_NOT_OK(
+            write_string_attribute(channel, "channel_number", std::to_string(read.channel)));
+        ARROW_RETURN_NOT_OK(channel_id.close("channel_id"));
+
+        ARROW_ASSIGN_OR_RAISE(auto raw_group, create_group(read_group.get(), "Raw"));
+        ARROW_RETURN_NOT_OK(write_signal(raw_group.get(), read));
+        auto const raw = raw_group.get();
+        ARROW_RETURN_NOT_OK(
+            write_attribute(raw, "start_time", H5T_NATIVE_UINT64, read.start_sample));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "duration", H5T_NATIVE_UINT32, static_cast<std::uint32_t>(read.sample_count)));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "read_number", H5T_NATIVE_INT32, static_cast<std::int32_t>(read.read_number)));
+        ARROW_RETURN_NOT_OK(write_attribute(raw, "start_mux", H5T_NATIVE_UINT8, read.well));
+        ARROW_RETURN_NOT_OK(write_string_attribute(raw, "read_id", read_id, H5T_CSET_ASCII));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "median_before", H5T_NATIVE_DOUBLE, double(read.median_before)));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "end_reason", m_end_reason_type.get(), fast5_end_reason(read.end_reason)));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "num_minknow_events", H5T_NATIVE_UINT64, read.num_minknow_events));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "tracked_scaling_scale", H5T_NATIVE_FLOAT, read.tracked_scaling_scale));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "tracked_scaling_shift", H5T_NATIVE_FLOAT, read.tracked_scaling_shift));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "predicted_scaling_scale", H5T_NATIVE_FLOAT, read.predicted_scaling_scale));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "predicted_scaling_shift", H5T_NATIVE_FLOAT, read.predicted_scaling_shift));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw,
+            "num_reads_since_mux_change",
+            H5T_NATIVE_UINT32,
+            read.num_reads_since_mux_change));
+        ARROW_RETURN_NOT_OK(write_attribute(
+            raw, "time_since_mux_change", H5T_NATIVE_FLOAT, read.time_since_mux_change));
+        ARROW_RETURN_NOT_OK(raw_group.close("Raw"));
+        ARROW_RETURN_NOT_OK(read_group.close(read_id.c_str()));
+
+        m_file_read_count += 1;
+        return pod5::Status::OK();
+    }
+
+    /// Close the open file, if any.
+    pod5::Status close()
+    {
+        if (!m_file) {
+            return pod5::Status::OK();
+        }
+        auto status = m_file->close(m_path.c_str());
+        m_file.reset();
+        return status;
+    }
+
+private:
+    explicit Fast5Writer(Hdf5Handle && end_reason_type)
+    : m_end_reason_type(std::move(end_reason_type))
+    {
+    }
+
+    static std::uint8_t fast5_end_reason(pod5::ReadEndReason reason)
+    {
+        // Fast5 numbers end reasons as pod5 does, with "partial" inserted after "unknown":
+        auto const value = static_cast<std::uint8_t>(reason);
+        return value == 0 ? 0 : value + 1;
+    }
+
+    /// Write [read]'s signal as the "Signal" dataset of [raw], storing its chunks as they are.
+    pod5::Status write_signal(hid_t raw, Fast5Read const & read)
+    {
+        hsize_t const dims[] = {read.sample_count};
+        ARROW_ASSIGN_OR_RAISE(
+            auto space, check_created(H5Screate_simple(1, dims, nullptr), H5Sclose, "Signal"));
+        ARROW_ASSIGN_OR_RAISE(
+            auto properties,
+            check_created(H5Pcreate(H5P_DATASET_CREATE), H5Pclose, "Signal properties"));
+        // Chunks can't be larger than the dataset, so reads without signal aren't chunked:
+        if (read.sample_count != 0) {
+            hsize_t const chunk_dims[] = {read.chunk_samples};
+            // The filter is optional, so files are written where the vbz plugin isn't
+            // installed. Chunks are compressed here rather than by the filter:
+            if (H5Pset_chunk(properties.get(), 1, chunk_dims) < 0
+                || H5Pset_filter(
+                       properties.get(),
+                       VBZ_FILTER_ID,
+                       H5Z_FLAG_OPTIONAL,
+                       std::size(VBZ_FILTER_OPTIONS),
+                       VBZ_FILTER_OPTIONS)
+                       < 0)
+            {
+                return arrow::Status::IOError("Failed to set up Signal chunking");
+            }
+        }
+        ARROW_ASSIGN_OR_RAISE(
+            auto dataset,
+            check_created(
+                H5Dcreate2(
+                    raw,
+                    "Signal",
+                    H5T_NATIVE_INT16,
+                    space.get(),
+                    H5P_DEFAULT,
+                    properties.get(),
+                    H5P_DEFAULT),
+                H5Dclose,
+                "Signal"));
+        for (std::size_t i = 0; i < read.chunks.size(); ++i) {
+            hsize_t const offset[] = {i * read.chunk_samples};
+            auto const & chunk = read.chunks[i];
+            if (H5Dwrite_chunk(dataset.get(), H5P_DEFAULT, 0, offset, chunk.size(), chunk.data())
+                < 0)
+            {
+                return arrow::Status::IOError("Failed to write Signal chunk ", i);
+            }
+        }
+        return dataset.close("Signal");
+    }
+
+    Hdf5Handle m_end_reason_type;
+    std::optional<Hdf5Handle> m_file;
+    std::string m_path;
+    std::size_t m_file_read_count = 0;
+};
+
+}  // namespace
+
+pod5::Status run_to_fast5(Arguments & args)
+{
+    auto const recursive = args.take_flag("--recursive");
+    auto const force_overwrite = args.take_flag("--force-overwrite");
+    ARROW_ASSIGN_OR_RAISE(auto const thread_count, take_thread_count(args));
+    ARROW_ASSIGN_OR_RAISE(auto const file_read_count, args.take_count("--file-read-count", 4000));
+    ARROW_ASSIGN_OR_RAISE(auto const output, args.take_option("--output"));
+    if (!output) {
+        return arrow::Status::Invalid("An --output directory is required");
+    }
+    ARROW_ASSIGN_OR_RAISE(auto const paths, args.take_positionals());
+    ARROW_ASSIGN_OR_RAISE(auto const inputs, collect_inputs(paths, recursive));
+
+    std::error_code error;
+    if (fs::exists(*output, error) && !fs::is_directory(*output, error)) {
+        return arrow::Status::Invalid("Output ", *output, " is a file, not a directory");
+    }
+
+    // HDF5 reports failures through our statuses instead of printing them:
+    H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
+    ARROW_ASSIGN_OR_RAISE(auto writer, Fast5Writer::make());
+
+    // Batches are read, and their signal chunked, in parallel. The HDF5 library is not thread
+    // safe, so the main thread then writes them in order:
+    auto const thread_pool = pod5::make_thread_pool(pod5::numa_thread_pool_options(thread_count));
+    std::uint64_t read_count = 0;
+    std::uint64_t sample_count = 0;
+    std::size_t output_count = 0;
+    ChunkCounts total_counts;
+    for (std::size_t input_index = 0; input_index < inputs.size(); ++input_index) {
+        auto const & input = inputs[input_index];
+        auto reader = pod5::open_file_reader(input);
+        if (!reader.ok()) {
+            return reader.status().WithMessage(input, ": ", reader.status().message());
+        }
+        auto const stem = fs::path(input).stem().string();
+
+        std::size_t chunk_index = 0;
+        auto const batch_count = (*reader)->num_read_record_batches();
+        for (std::size_t first = 0; first < batch_count; first += thread_count) {
+            auto const count = std::min(thread_count, batch_count - first);
+            std::vector<std::vector<Fast5Read>> batches(count);
+            std::vector<ChunkCounts> batch_counts(count);
+            ARROW_RETURN_NOT_OK(pod5::internal::run_parallel_tasks(
+                thread_pool.get(), count, [&](std::size_t i) -> pod5::Status {
+                    auto batch = prepare_batch(**reader, first + i, batch_counts[i]);
+                    if (!batch.ok()) {
+                        return batch.status().WithMessage(input, ": ", batch.status().message());
+                    }
+                    batches[i] = std::move(*batch);
+                    return pod5::Status::OK();
+                }));
+
+            for (std::size_t i = 0; i < count; ++i) {
+                total_counts.copied += batch_counts[i].copied;
+                total_counts.recompressed += batch_counts[i].recompressed;
+                for (auto const & read : batches[i]) {
+                    if (chunk_index == 0 || writer.file_read_count() == file_read_count) {
+                        auto const path = (fs::path(*output)
+                                           / (stem + "." + std::to_string(chunk_index) + "_"
+                                              + std::to_string(input_index) + ".fast5"))
+                                              .string();
+                        ARROW_RETURN_NOT_OK(prepare_output(path, force_overwrite));
+                        ARROW_RETURN_NOT_OK(writer.open(path));
+                        chunk_index += 1;
+                        output_count += 1;
+                    }
+                    ARROW_RETURN_NOT_OK(writer.write_read(read));
+                    read_count += 1;
+                    sample_count += read.sample_count;
+                }
+            }
+        }
+        ARROW_RETURN_NOT_OK(writer.close());
+    }
+
+    std::cerr << "Converted " << read_count << " reads, " << sample_count << " samples, into "
+              << output_count << " fast5 files, copying " << total_counts.copied
+              << " signal chunks and recompressing " << total_counts.recompressed << "\n";
+    return pod5::Status::OK();
+}
+
+}  // namespace pod5_fast
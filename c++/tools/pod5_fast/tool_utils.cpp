@@ -0,0 +1,178 @@
+#include "tool_utils.h"
+
+#include "pod5_format/uuid_format.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace pod5_fast {
+
+pod5::Result<std::optional<std::string>> Arguments::take_option(std::string const & name)
+{
+    for (std::size_t i = 0; i < m_args.size() && m_args[i] != "--"; ++i) {
+        if (m_args[i] != name) {
+            continue;
+        }
+        if (i + 1 == m_args.size()) {
+            return arrow::Status::Invalid("Option ", name, " expects a value");
+        }
+        auto value = std::move(m_args[i + 1]);
+        m_args.erase(m_args.begin() + i, m_args.begin() + i + 2);
+        return std::optional<std::string>{std::move(value)};
+    }
+    return std::nullopt;
+}
+
+pod5::Result<std::size_t> Arguments::take_count(
+    std::string const & name,
+    std::size_t default_value)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const value, take_option(name));
+    if (!value) {
+        return default_value;
+    }
+    std::size_t parsed_length = 0;
+    std::size_t count = 0;
+    try {
+        count = std::stoull(*value, &parsed_length);
+    } catch (std::exception const &) {
+    }
+    // stoull accepts, and wraps, negative counts:
+    if (value->empty() || value->front() == '-' || parsed_length != value->size() || count == 0) {
+        return arrow::Status::Invalid("Option ", name, " expects a positive count, not ", *value);
+    }
+    return count;
+}
+
+bool Arguments::take_flag(std::string const & name)
+{
+    auto const end = std::find(m_args.begin(), m_args.end(), "--");
+    auto const flag = std::find(m_args.begin(), end, name);
+    if (flag == end) {
+        return false;
+    }
+    m_args.erase(flag);
+    return true;
+}
+
+pod5::Result<std::vector<std::string>> Arguments::take_positionals()
+{
+    std::vector<std::string> positionals;
+    bool options_ended = false;
+    for (auto & arg : m_args) {
+        if (!options_ended && arg == "--") {
+            options_ended = true;
+            continue;
+        }
+        if (!options_ended && arg.size() > 1 && arg[0] == '-') {
+            return arrow::Status::Invalid("Unknown option ", arg);
+        }
+        positionals.push_back(std::move(arg));
+    }
+    m_args.clear();
+    return positionals;
+}
+
+pod5::Result<std::size_t> take_thread_count(Arguments & args)
+{
+    return args.take_count("--threads", std::max(1u, std::thread::hardware_concurrency()));
+}
+
+pod5::Result<std::vector<std::string>> collect_inputs(
+    std::vector<std::string> const & paths,
+    bool recursive)
+{
+    std::vector<std::string> inputs;
+    auto const add_if_pod5 = [&](fs::directory_entry const & entry) {
+        if (entry.is_regular_file() && entry.path().extension() == ".pod5") {
+            inputs.push_back(entry.path().string());
+        }
+    };
+
+    for (auto const & path : paths) {
+        std::error_code error;
+        if (!fs::is_directory(path, error)) {
+            if (!fs::exists(path, error)) {
+                return arrow::Status::IOError("Input ", path, " does not exist");
+            }
+            inputs.push_back(path);
+            continue;
+        }
+
+        if (recursive) {
+            for (auto const & entry : fs::recursive_directory_iterator(path, error)) {
+                add_if_pod5(entry);
+            }
+        } else {
+            for (auto const & entry : fs::directory_iterator(path, error)) {
+                add_if_pod5(entry);
+            }
+        }
+        if (error) {
+            return arrow::Status::IOError("Failed to list ", path, ": ", error.message());
+        }
+    }
+
+    std::sort(inputs.begin(), inputs.end());
+    inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+    return inputs;
+}
+
+pod5::Result<std::vector<pod5::Uuid>> read_id_list(std::string const & path)
+{
+    std::ifstream input(path);
+    if (!input) {
+        return arrow::Status::IOError("Failed to open read id list ", path);
+    }
+
+    std::vector<pod5::Uuid> read_ids;
+    std::string line;
+    for (std::size_t line_number = 1; std::getline(input, line); ++line_number) {
+        // Lists written on windows end their lines with "\r\n":
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || (line_number == 1 && line == "read_id")) {
+            continue;
+        }
+        auto const read_id = pod5::parse_uuid(line);
+        if (!read_id) {
+            return arrow::Status::Invalid(
+                path, ":", line_number, ": \"", line, "\" is not a valid read id");
+        }
+        read_ids.push_back(*read_id);
+    }
+    return read_ids;
+}
+
+pod5::Status prepare_output(std::string const & path, bool force_overwrite)
+{
+    std::error_code error;
+    if (fs::exists(path, error)) {
+        if (!force_overwrite) {
+            return arrow::Status::Invalid(
+                "Output ", path, " already exists, pass --force-overwrite to replace it");
+        }
+        if (!fs::remove(path, error)) {
+            return arrow::Status::IOError("Failed to remove ", path, ": ", error.message());
+        }
+    }
+
+    auto const directory = fs::path(path).parent_path();
+    if (!directory.empty()) {
+        fs::create_directories(directory, error);
+        if (error) {
+            return arrow::Status::IOError(
+                "Failed to create directory ", directory.string(), ": ", error.message());
+        }
+    }
+    return arrow::Status::OK();
+}
+
+}  // namespace pod5_fast
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "pod5_format/result.h"
+#include "pod5_format/uuid.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pod5_fast {
+
+/// \brief The arguments given to a command, taken as the command reads them.
+///
+/// Options ("--name value") and flags ("--name") may be given anywhere among the positional
+/// arguments, anything after "--" is positional.
+class Arguments {
+public:
+    explicit Arguments(std::vector<std::string> args) : m_args(std::move(args)) {}
+
+    /// \brief Take the value of the option [name], or nothing if it wasn't given.
+    pod5::Result<std::optional<std::string>> take_option(std::string const & name);
+
+    /// \brief Take the option [name] as a count, [default_value] if it wasn't given.
+    pod5::Result<std::size_t> take_count(std::string const & name, std::size_t default_value);
+
+    /// \brief Take the flag [name], finding if it was given.
+    bool take_flag(std::string const & name);
+
+    /// \brief Take the remaining arguments, which must all be positional.
+    pod5::Result<std::vector<std::string>> take_positionals();
+
+private:
+    std::vector<std::string> m_args;
+};
+
+/// \brief Take the "--threads" option, a thread per core if it wasn't given.
+pod5::Result<std::size_t> take_thread_count(Arguments & args);
+
+/// \brief Find the pod5 files named by [paths], directories giving the ".pod5" files in them,
+///        searched recursively if [recursive] is set, sorted by path.
+pod5::Result<std::vector<std::string>> collect_inputs(
+    std::vector<std::string> const & paths,
+    bool recursive);
+
+/// \brief Parse a list of read ids, one per line, ignoring blank lines and a "read_id" header.
+pod5::Result<std::vector<pod5::Uuid>> read_id_list(std::string const & path);
+
+/// \brief Check the output file [path] can be written, removing it if [force_overwrite] is
+///        set and making its directory if needed.
+pod5::Status prepare_output(std::string const & path, bool force_overwrite);
+
+}  // namespace pod5_fast
@@ -0,0 +1,57 @@
+#include "commands.h"
+#include "pod5_format/file_reader.h"
+#include "pod5_format/file_verify.h"
+#include "pod5_format/thread_pool.h"
+
+#include <iostream>
+#include <string>
+
+namespace pod5_fast {
+
+namespace {
+
+pod5::Result<pod5::FileVerifyReport> verify_path(
+    std::string const & path,
+    pod5::FileVerifyOptions const & options)
+{
+    ARROW_ASSIGN_OR_RAISE(auto const reader, pod5::open_file_reader(path));
+    return pod5::verify_file(*reader, options);
+}
+
+}  // namespace
+
+pod5::Status run_verify(Arguments & args)
+{
+    auto const recursive = args.take_flag("--recursive");
+    auto const no_frames = args.take_flag("--no-frames");
+    ARROW_ASSIGN_OR_RAISE(auto const thread_count, take_thread_count(args));
+    ARROW_ASSIGN_OR_RAISE(auto const paths, args.take_positionals());
+    ARROW_ASSIGN_OR_RAISE(auto const inputs, collect_inputs(paths, recursive));
+
+    // Files are checked one at a time, each spreading its batches over the pool:
+    pod5::FileVerifyOptions options;
+    options.set_check_compressed_frames(!no_frames);
+    options.set_thread_pool(pod5::make_thread_pool(thread_count));
+
+    std::size_t failed_count = 0;
+    for (auto const & path : inputs) {
+        auto const report = verify_path(path, options);
+        if (!report.ok()) {
+            ++failed_count;
+            std::cout << path << "\tFAILED\t" << report.status().ToString() << std::endl;
+            continue;
+        }
+        std::cout << path << "\tOK\t" << report->read_count << " reads\t"
+                  << report->sample_count << " samples\t" << report->signal_row_count
+                  << " signal rows\t" << report->checksummed_signal_rows << " checksummed\t"
+                  << report->checked_signal_frames << " frames checked" << std::endl;
+    }
+
+    if (failed_count > 0) {
+        return arrow::Status::IOError(
+            failed_count, " of ", inputs.size(), " files failed verification");
+    }
+    return pod5::Status::OK();
+}
+
+}  // namespace pod5_fast
@@ -2,10 +2,12 @@
 
 from ._version import __version__, __version_tuple__
 from .pod5_format_pybind import (
+    VBZ_SIGNAL_CODEC_ID,
     EmbeddedFileData,
     FileWriter,
     FileWriterOptions,
     Pod5AsyncSignalLoader,
+    Pod5DatasetReader,
     Pod5FileReader,
     Pod5RepackerOutput,
     Pod5SignalCacheBatch,
@@ -18,6 +20,7 @@ from .pod5_format_pybind import (
     format_read_id_to_str,
     get_error_string,
     load_read_id_iterable,
+    open_dataset,
     open_file,
     update_file,
     vbz_compressed_signal_max_size,
@@ -26,10 +29,12 @@ from .pod5_format_pybind import (
 __all__ = [
     "__version__",
     "__version_tuple__",
+    "VBZ_SIGNAL_CODEC_ID",
     "EmbeddedFileData",
     "FileWriter",
     "FileWriterOptions",
     "Pod5AsyncSignalLoader",
+    "Pod5DatasetReader",
     "Pod5FileReader",
     "Pod5RepackerOutput",
     "Pod5SignalCacheBatch",
@@ -42,6 +47,7 @@ __all__ = [
     "format_read_id_to_str",
     "get_error_string",
     "load_read_id_iterable",
+    "open_dataset",
     "open_file",
     "update_file",
     "vbz_compressed_signal_max_size",
@@ -8,7 +8,7 @@ c++ bindings for pod5_format
 # > pip install mypy
 # > stubgen -m lib_pod5.pod5_format_pybind
 
-from typing import Any, Iterable, List, Optional, Tuple, Union
+from typing import Any, Dict, Iterable, List, Optional, Tuple, Union
 
 import numpy as np
 import numpy.typing as npt
@@ -22,6 +22,34 @@ class EmbeddedFileData:
     @property
     def file_path(self) -> str: ...
 
+class FileReaderStatistics:
+    @property
+    def run_info_table_bytes_read(self) -> int: ...
+    @property
+    def read_table_bytes_read(self) -> int: ...
+    @property
+    def signal_table_bytes_read(self) -> int: ...
+    @property
+    def read_table_batches_decoded(self) -> int: ...
+    @property
+    def signal_table_batches_decoded(self) -> int: ...
+    @property
+    def signal_cache_hits(self) -> int: ...
+    @property
+    def signal_cache_misses(self) -> int: ...
+    @property
+    def signal_cache_evictions(self) -> int: ...
+    @property
+    def read_table_cache_hits(self) -> int: ...
+    @property
+    def read_table_cache_misses(self) -> int: ...
+    @property
+    def read_table_cache_evictions(self) -> int: ...
+    @property
+    def decompressed_bytes(self) -> int: ...
+    @property
+    def decompression_time_seconds(self) -> float: ...
+
 class FileWriter:
     def __init__(self, *args, **kwargs) -> None: ...
     def add_end_reason(self, end_reason_enum: int) -> int: ...
@@ -104,13 +132,49 @@ class FileWriter:
 class FileWriterOptions:
     max_signal_chunk_size: int
     read_table_batch_size: int
+    signal_codec_id: Optional[str]
+    signal_compression_dictionary: Optional[bytes]
     signal_compression_type: Any
+    signal_summary_decimations: List[int]
     signal_table_batch_size: int
     def __init__(self, *args, **kwargs) -> None: ...
 
+class MemoryPoolStatistics:
+    @property
+    def bytes_allocated(self) -> int: ...
+    @property
+    def peak_bytes_allocated(self) -> int: ...
+    @property
+    def allocation_count(self) -> int: ...
+    @property
+    def failed_allocations(self) -> int: ...
+    @property
+    def max_bytes(self) -> int: ...
+
 class Pod5AsyncSignalLoader:
     def __init__(self, *args, **kwargs) -> None: ...
     def release_next_batch(self) -> Pod5SignalCacheBatch: ...
+    def release_next_completed_batch(self) -> Pod5SignalCacheBatch: ...
+
+class Pod5DatasetReader:
+    def __init__(self, *args, **kwargs) -> None: ...
+    def build_index(self) -> None: ...
+    def file_count(self) -> int: ...
+    def file_path(self, file: int) -> str: ...
+    def get_file_reader(self, file: int) -> Pod5FileReader: ...
+    def has_duplicate_read_ids(self) -> bool: ...
+    def load_index(self, path: str) -> None: ...
+    def open_file_count(self) -> int: ...
+    def plan_traversal(
+        self,
+        read_id_data: npt.NDArray[np.uint8],
+        files: npt.NDArray[np.uint32],
+        batches: npt.NDArray[np.uint32],
+        batch_rows: npt.NDArray[np.uint32],
+    ) -> int: ...
+    def read_count(self) -> int: ...
+    def update_index(self, path: str) -> None: ...
+    def write_index(self, path: str) -> None: ...
 
 class Pod5FileReader:
     def __init__(self, *args, **kwargs) -> None: ...
@@ -130,17 +194,83 @@ class Pod5FileReader:
         batch_counts: npt.NDArray[np.uint32],
         batch_rows: npt.NDArray[np.uint32],
     ) -> Pod5AsyncSignalLoader: ...
+    def stream_signal(
+        self,
+        batch_counts: npt.NDArray[np.uint32],
+        batch_rows: npt.NDArray[np.uint32],
+        max_pending_batches: int,
+        max_pending_bytes: int = 0,
+    ) -> Pod5AsyncSignalLoader: ...
     def close(self) -> None: ...
     def get_file_read_table_location(self) -> EmbeddedFileData: ...
     def get_file_run_info_table_location(self) -> EmbeddedFileData: ...
     def get_file_signal_table_location(self) -> EmbeddedFileData: ...
     def get_file_version_pre_migration(self) -> str: ...
+    def read_table_migrated(self) -> bool: ...
+    def run_info_table_migrated(self) -> bool: ...
+    def prepare_for_fork(self) -> None: ...
+    def statistics(self) -> FileReaderStatistics: ...
+    def signal_batch_for_row_id(self, row: int) -> Tuple[int, int]: ...
+    def get_signal_pa(
+        self,
+        signal_row_offsets: npt.NDArray[np.int64],
+        signal_rows: npt.NDArray[np.uint64],
+        calibration_offsets: npt.NDArray[np.float32],
+        calibration_scales: npt.NDArray[np.float32],
+    ) -> Tuple[npt.NDArray[np.float32], npt.NDArray[np.uint64]]: ...
     def plan_traversal(
         self,
         read_id_data: npt.NDArray[np.uint8],
         batch_counts: npt.NDArray[np.uint32],
         batch_rows: npt.NDArray[np.uint32],
     ) -> int: ...
+    def scan_reads(
+        self,
+        expression: str,
+        batch_counts: npt.NDArray[np.uint32],
+        batch_rows: npt.NDArray[np.uint32],
+    ) -> int: ...
+    def iterate_read_batches(
+        self, columns: List[str], prefetch_batches: int
+    ) -> Pod5ReadBatchIterator: ...
+    def schema_metadata(self) -> Tuple[str, str, str]: ...
+    def num_read_record_batches(self) -> int: ...
+    def num_signal_record_batches(self) -> int: ...
+    def is_signal_compressed(self) -> bool: ...
+    def decompress_signal(
+        self,
+        compressed_signal: Union[npt.NDArray[np.uint8], memoryview],
+        signal_out: npt.NDArray[np.int16],
+    ) -> None: ...
+    def decompress_signal_pa(
+        self,
+        compressed_signal: Union[npt.NDArray[np.uint8], memoryview],
+        calibration_offset: float,
+        calibration_scale: float,
+        signal_out: npt.NDArray[np.float32],
+    ) -> None: ...
+    def signal_summary_decimations(self) -> List[int]: ...
+    def signal_summary(
+        self, read_id: npt.NDArray[np.uint8], decimation: int
+    ) -> Optional[
+        Tuple[npt.NDArray[np.int16], npt.NDArray[np.int16], npt.NDArray[np.int16]]
+    ]: ...
+    def read_batch(self, index: int, columns: List[str] = ...) -> Pod5RecordBatch: ...
+    def signal_batch(self, index: int) -> Pod5RecordBatch: ...
+    def num_run_info_record_batches(self) -> int: ...
+    def run_info_batch(self, index: int) -> Pod5RecordBatch: ...
+
+class Pod5RecordBatch:
+    def __init__(self, *args, **kwargs) -> None: ...
+    @property
+    def num_rows(self) -> int: ...
+    def __arrow_c_array__(self, requested_schema: Any = None) -> Tuple[Any, Any]: ...
+
+class Pod5ReadBatchIterator:
+    def __init__(self, *args, **kwargs) -> None: ...
+    @property
+    def batch_count(self) -> int: ...
+    def next_batch(self) -> Pod5RecordBatch: ...
 
 class Pod5RepackerOutput:
     def __init__(self, *args, **kwargs) -> None: ...
@@ -153,14 +283,83 @@ class Pod5SignalCacheBatch:
     def sample_count(self) -> npt.NDArray[np.uint64]: ...
     @property
     def samples(self) -> List[npt.NDArray[np.int16]]: ...
+    @property
+    def sample_offsets(self) -> npt.NDArray[np.uint64]: ...
+    @property
+    def all_samples(self) -> npt.NDArray[np.int16]: ...
+    def samples_pa(
+        self,
+        calibration_offsets: npt.NDArray[np.float32],
+        calibration_scales: npt.NDArray[np.float32],
+    ) -> Tuple[npt.NDArray[np.float32], npt.NDArray[np.uint64]]: ...
+
+class RepackReadOrder:
+    AsAdded: RepackReadOrder
+    ReadId: RepackReadOrder
+    ChannelStartSample: RepackReadOrder
+
+class RepackerStateStatistics:
+    @property
+    def name(self) -> str: ...
+    @property
+    def runs(self) -> int: ...
+    @property
+    def queued(self) -> int: ...
+    @property
+    def max_queued(self) -> int: ...
+    @property
+    def time_seconds(self) -> float: ...
+    @property
+    def max_time_seconds(self) -> float: ...
+    @property
+    def time_histogram(self) -> List[int]: ...
+
+class RepackerStatistics:
+    @property
+    def read_table_batches_read(self) -> int: ...
+    @property
+    def reads_read(self) -> int: ...
+    @property
+    def signal_batches_copied(self) -> int: ...
+    @property
+    def signal_bytes_copied(self) -> int: ...
+    @property
+    def signal_batches_written(self) -> int: ...
+    @property
+    def signal_rows_written(self) -> int: ...
+    @property
+    def signal_bytes_written(self) -> int: ...
+    @property
+    def reads_written(self) -> int: ...
+    @property
+    def states(self) -> List[RepackerStateStatistics]: ...
+
+class ThreadPoolStatistics:
+    @property
+    def queued_tasks(self) -> int: ...
+    @property
+    def running_tasks(self) -> int: ...
+    @property
+    def strand_queued_tasks(self) -> List[int]: ...
+    @property
+    def tasks_run(self) -> int: ...
+    @property
+    def wait_time_histogram(self) -> List[int]: ...
+    @property
+    def run_time_histogram(self) -> List[int]: ...
+    @property
+    def worker_busy_ratios(self) -> List[float]: ...
 
 class Repacker:
-    def __init__(self) -> None: ...
+    def __init__(self, max_pending_bytes: int = ...) -> None: ...
     def add_all_reads_to_output(
         self, output: Pod5RepackerOutput, input: Pod5FileReader
     ) -> None: ...
     def add_output(
-        self, output: FileWriter, check_duplicate_read_ids: bool
+        self,
+        output: FileWriter,
+        check_duplicate_read_ids: bool,
+        read_order: RepackReadOrder = ...,
     ) -> Pod5RepackerOutput: ...
     def add_selected_reads_to_output(
         self,
@@ -169,6 +368,19 @@ class Repacker:
         batch_counts: npt.NDArray[np.uint32],
         all_batch_rows: npt.NDArray[np.uint32],
     ) -> None: ...
+    def add_partitioned_reads_to_outputs(
+        self,
+        outputs: List[Pod5RepackerOutput],
+        input: Pod5FileReader,
+        read_ids: npt.NDArray[np.uint8],
+        read_outputs: npt.NDArray[np.uint32],
+    ) -> int: ...
+    def add_read_ids_to_output(
+        self,
+        output: Pod5RepackerOutput,
+        inputs: List[Pod5FileReader],
+        read_ids: npt.NDArray[np.uint8],
+    ) -> npt.NDArray[np.uint8]: ...
     def finish(self) -> None: ...
     @property
     def is_complete(self) -> bool: ...
@@ -176,7 +388,16 @@ class Repacker:
     def open_file_readers(self) -> int: ...
     @property
     def reads_completed(self) -> int: ...
+    @property
+    def pending_bytes(self) -> int: ...
+    @property
+    def max_pending_bytes(self) -> int: ...
+    def statistics(self) -> RepackerStatistics: ...
+    def thread_pool_statistics(self) -> ThreadPoolStatistics: ...
 
+def calibrate_signal(
+    signal: npt.NDArray[np.int16], calibration_offset: float, calibration_scale: float
+) -> npt.NDArray[np.float32]: ...
 def compress_signal(
     signal: npt.NDArray[np.int16], compressed_signal_out: npt.NDArray[np.uint8]
 ) -> int: ...
@@ -188,6 +409,23 @@ def decompress_signal(
     compressed_signal: Union[npt.NDArray[np.uint8], memoryview],
     signal_out: npt.NDArray[np.int16],
 ) -> None: ...
+def decompress_signal_pa(
+    compressed_signal: Union[npt.NDArray[np.uint8], memoryview],
+    calibration_offset: float,
+    calibration_scale: float,
+    signal_out: npt.NDArray[np.float32],
+) -> None: ...
+def export_field_names() -> List[str]: ...
+def export_read_tables(
+    paths: List[str],
+    filenames: List[str],
+    output_fd: int,
+    fields: List[str],
+    separator: str,
+    format: str,
+    header: bool,
+    threads: int,
+) -> int: ...
 def format_read_id_to_str(
     read_id_data_out: npt.NDArray[np.uint8],
 ) -> List[str]: ...
@@ -195,6 +433,16 @@ def get_error_string() -> str: ...
 def load_read_id_iterable(
     read_ids_str: Iterable, read_id_data_out: npt.NDArray[np.uint8]
 ) -> int: ...
+def memory_statistics() -> Dict[str, MemoryPoolStatistics]: ...
+def open_dataset(
+    filenames: List[str], max_open_files: int = ..., index_threads: int = ...
+) -> Pod5DatasetReader: ...
 def open_file(filename: str) -> Pod5FileReader: ...
+def set_memory_limit(subsystem: str, max_bytes: int) -> None: ...
 def update_file(reader: Pod5FileReader, output: str): ...
+def train_signal_compression_dictionary(
+    signals: List[npt.NDArray[np.int16]], max_dictionary_size: int = ...
+) -> bytes: ...
 def vbz_compressed_signal_max_size(sample_count: int) -> int: ...
+
+VBZ_SIGNAL_CODEC_ID: str
@@ -4,7 +4,15 @@ Basic lib pod5 tets
 
 from pathlib import Path
 
-from lib_pod5 import Pod5FileReader, create_file, open_file
+import numpy as np
+
+from lib_pod5 import (
+    Pod5DatasetReader,
+    Pod5FileReader,
+    create_file,
+    open_dataset,
+    open_file,
+)
 
 
 def test_create_file(tmp_path: Path) -> None:
@@ -28,3 +36,30 @@ def test_open_file(tmp_path: Path) -> None:
     assert isinstance(reader, Pod5FileReader)
 
     reader.close()
+
+
+def test_open_dataset(tmp_path: Path) -> None:
+    """Test that lib-pod5 can open, index and plan across files as a dataset"""
+    targets = [tmp_path / f"test_{i}.pod5" for i in range(3)]
+    for target in targets:
+        create_file(str(target), "test").close()
+
+    dataset = open_dataset([str(t) for t in targets], max_open_files=2)
+    assert isinstance(dataset, Pod5DatasetReader)
+    assert dataset.file_count() == 3
+    assert dataset.file_path(1) == str(targets[1])
+    assert dataset.open_file_count() == 0
+
+    assert dataset.read_count() == 0
+    assert not dataset.has_duplicate_read_ids()
+    assert isinstance(dataset.get_file_reader(2), Pod5FileReader)
+
+    index_path = tmp_path / "dataset.index"
+    dataset.write_index(str(index_path))
+    reopened = open_dataset([str(t) for t in targets])
+    reopened.load_index(str(index_path))
+    assert reopened.read_count() == 0
+
+    read_ids = np.zeros((2, 16), dtype=np.uint8)
+    outputs = [np.zeros(2, dtype=np.uint32) for _ in range(3)]
+    assert reopened.plan_traversal(read_ids, *outputs) == 0
@@ -32,10 +32,12 @@ from .pod5_types import (
 from .reader import Reader, ReadRecord, ReadRecordBatch
 from .dataset import DatasetReader
 from .signal_tools import (
+    train_signal_compression_dictionary,
     vbz_compress_signal,
     vbz_decompress_signal,
     vbz_decompress_signal_chunked,
     vbz_decompress_signal_into,
+    vbz_decompress_signal_pa_into,
 )
 from .writer import SignalType, Writer
 
@@ -57,9 +59,11 @@ __all__ = (
     "ReadRecord",
     "ReadRecordBatch",
     "SignalType",
+    "train_signal_compression_dictionary",
     "vbz_compress_signal",
     "vbz_decompress_signal",
     "vbz_decompress_signal_chunked",
     "vbz_decompress_signal_into",
+    "vbz_decompress_signal_pa_into",
     "Writer",
 )
@@ -6,19 +6,23 @@ from typing import (
     Any,
     Callable,
     Collection,
-    Dict,
     Generator,
     Iterable,
+    Iterator,
     List,
     Optional,
     Set,
     Union,
 )
 import warnings
+
+import lib_pod5 as p5b
+import numpy as np
+
 from pod5.api_utils import Pod5ApiException
 
 from pod5.pod5_types import PathOrStr
-from pod5.reader import ReadRecord, Reader
+from pod5.reader import DEFAULT_LOOKAHEAD_READS, ReadRecord, Reader
 from pod5.tools.utils import search_path
 
 DEFAULT_CPUS = min(os.cpu_count() or 1, 4)
@@ -34,6 +38,7 @@ class DatasetReader:
         threads: int = DEFAULT_CPUS,
         max_cached_readers: Optional[int] = 2**4,
         warn_duplicate_indexing: bool = True,
+        index_path: Optional[PathOrStr] = None,
     ) -> None:
         """
         Reads pod5 files and/or directories of pod5 files as a dataset.
@@ -56,12 +61,17 @@ class DatasetReader:
         warn_duplicate_indexing : bool
             Issue warnings when duplicate read_ids are detected and
             indexing by read_id is attempted
+        index_path : Optional[PathOrStr]
+            A file to keep the read_id index in between processes. An existing index
+            is memory mapped, after indexing any dataset files it doesn't hold, and
+            written back if it changed. A missing index is built and written.
 
         Note
         ----
         Random record access is implemented by creating an index of read_id to file
-        path. This can consume a large amount of memory. Methods that generate an index
-        have this noted in their docstring.
+        location, sorted by read_id. Methods that generate an index have this noted
+        in their docstring. Pass `index_path` to keep the index on disk, so later
+        processes map it rather than reading every file again.
 
         Warnings
         --------
@@ -77,16 +87,16 @@ class DatasetReader:
         )
         self._num_reads: Optional[int] = None
         self._max_cached_readers = max_cached_readers
+        self._index_path = Path(index_path) if index_path is not None else None
         self.threads = threads
         self.warn_duplicate_indexing = warn_duplicate_indexing
 
         # Cache on DatasetReader instances and control cache size on init
         self._get_reader = self._init_get_reader(self._max_cached_readers)
 
+        self._index: Optional[p5b.Pod5DatasetReader] = None
         if index:
             self._index_read_ids()
-        else:
-            self._index: Optional[Dict[str, Path]] = None
 
     def __iter__(self) -> Generator[ReadRecord, None, None]:
         yield from self.reads()
@@ -103,6 +113,10 @@ class DatasetReader:
         if self._num_reads is not None:
             return self._num_reads
 
+        if self._index is not None:
+            self._num_reads = self._index.read_count()
+            return self._num_reads
+
         def _get_num_reads(path: Path) -> int:
             try:
                 return self.get_reader(path).num_reads
@@ -167,6 +181,56 @@ class DatasetReader:
         for reads in self._run_max_workers(_get_reads_iter, self.paths, self.threads):
             yield from reads
 
+    def stream_reads(
+        self,
+        selection: Optional[Iterable[str]] = None,
+        lookahead_reads: int = DEFAULT_LOOKAHEAD_READS,
+        lookahead_bytes: Optional[int] = None,
+    ) -> Generator[ReadRecord, None, None]:
+        """
+        Iterate over ``ReadRecord``s in the dataset with their signal loaded ahead
+        of the caller, see :py:meth:`Reader.stream_reads`.
+
+        Parameters
+        ----------
+        selection : iterable[str]
+            The read ids to walk in the dataset.
+        lookahead_reads : int
+            Roughly the most reads of each file to load ahead of the caller.
+        lookahead_bytes : Optional[int]
+            The most bytes of decoded signal of each file to hold ahead of the caller.
+
+        Note
+        ----
+        Each file's signal starts loading as the previous file's reads start being
+        yielded, so loading continues across files, with up to two files' look-ahead
+        held at once. Files are walked in ``self.paths`` order.
+
+        Missing records are not detected and multiple records will be
+        yielded if there are duplicates in either of the dataset or selection.
+
+        Yields
+        ------
+        :py:class:`ReadRecord`
+        """
+        if selection is not None:
+            selection = list(selection)
+
+        previous: Optional[Iterator[ReadRecord]] = None
+        for path in self.paths:
+            stream = self.get_reader(path).stream_reads(
+                selection=selection,
+                missing_ok=True,
+                lookahead_reads=lookahead_reads,
+                lookahead_bytes=lookahead_bytes,
+            )
+            if previous is not None:
+                yield from previous
+            previous = stream
+
+        if previous is not None:
+            yield from previous
+
     def get_read(self, read_id: str) -> Optional[ReadRecord]:
         """
         Get a `ReadRecord` by `read_id` or return `None` if it is missing
@@ -259,14 +323,23 @@ class DatasetReader:
         if self.has_duplicate():
             self._issue_duplicate_read_warning()
 
-        return self._index.get(read_id, None)
+        read_id_data = np.empty((1, 16), dtype=np.uint8)
+        if p5b.load_read_id_iterable([read_id], read_id_data) == 0:
+            return None
+
+        files = np.empty(1, dtype=np.uint32)
+        batches = np.empty(1, dtype=np.uint32)
+        batch_rows = np.empty(1, dtype=np.uint32)
+        if self._index.plan_traversal(read_id_data, files, batches, batch_rows) == 0:
+            return None
+        return self.paths[files[0]]
 
     def clear_readers(self) -> None:
         """Clears the readers LRU cache"""
         self._get_reader.cache_clear()  # type: ignore
 
     def clear_index(self) -> None:
-        """Clears the read_id to file path index"""
+        """Clears the read_id to file location index"""
         self._index = None
 
     def has_duplicate(self) -> bool:
@@ -279,7 +352,7 @@ class DatasetReader:
         """
         self.index_read_ids()
         assert self._index is not None
-        return len(self) != len(self._index)
+        return self._index.has_duplicate_read_ids()
 
     @staticmethod
     def _collect_dataset(
@@ -313,16 +386,22 @@ class DatasetReader:
         return
 
     def _index_read_ids(self) -> None:
-        def _get_index(path: Path) -> Dict[str, Path]:
-            try:
-                return {read_id: path for read_id in self.get_reader(path).read_ids}
-            except Exception as exc:
-                msg = f"DatasetReader error reading: {[path]}"
-                raise Pod5ApiException(msg) from exc
-
-        self._index = {}
-        for index_item in self._run_max_workers(_get_index, self.paths, self.threads):
-            self._index.update(index_item)
+        # The native dataset merges each file's sorted read_id index, and is only
+        # used to find reads, files are still read through `get_reader`. Paths are
+        # absolute so an index on disk matches from any working directory.
+        index = p5b.open_dataset(
+            [str(path.absolute()) for path in self.paths],
+            max_open_files=self._max_cached_readers or 0,
+            index_threads=self.threads,
+        )
+        try:
+            if self._index_path is None:
+                index.build_index()
+            else:
+                index.update_index(str(self._index_path))
+        except RuntimeError as exc:
+            raise Pod5ApiException(f"DatasetReader error indexing: {exc}") from exc
+        self._index = index
 
     def _issue_duplicate_read_warning(self) -> None:
         if self.warn_duplicate_indexing:
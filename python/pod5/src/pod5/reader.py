@@ -9,10 +9,12 @@ from io import BufferedReader, IOBase
 import os
 from pathlib import Path
 from typing import (
+    Callable,
     Collection,
     Dict,
     Generator,
     Iterable,
+    Iterator,
     List,
     Optional,
     Set,
@@ -39,7 +41,10 @@ from pod5.pod5_types import (
 )
 
 from .api_utils import Pod5ApiException, format_read_ids, pack_read_ids, safe_close
-from .signal_tools import vbz_decompress_signal, vbz_decompress_signal_into
+
+# Reads loaded ahead of the caller by default when streaming reads
+DEFAULT_LOOKAHEAD_READS = 4000
+DEFAULT_PREFETCH_BATCHES = 4
 
 
 ReadRecordV3Columns = namedtuple(
@@ -75,6 +80,7 @@ SignalRowInfo = namedtuple(
     "SignalRowInfo",
     ["batch_index", "batch_row_index", "sample_count", "byte_count"],
 )
+SignalSummary = namedtuple("SignalSummary", ["min", "max", "mean"])
 
 
 class ReadRecord:
@@ -282,11 +288,7 @@ class ReadRecord:
                 return self._batch_signal_cache[self._selected_batch_index]
             return self._batch_signal_cache[self._row]
 
-        rows = self._batch.columns.signal[self._row]
-        batch_data = [self._find_signal_row_index(r.as_py()) for r in rows]
-        sample_counts = []
-        for batch, _, batch_row_index in batch_data:
-            sample_counts.append(batch.samples[batch_row_index].as_py())
+        batch_data, sample_counts = self._find_signal_rows()
 
         output = np.empty(dtype=np.int16, shape=(sum(sample_counts),))
         current_sample_index = 0
@@ -298,7 +300,7 @@ class ReadRecord:
                 current_sample_index : current_sample_index + current_row_count
             ]
             if self._reader.is_vbz_compressed:
-                vbz_decompress_signal_into(
+                self._reader._decompress_signal_into(
                     memoryview(signal[batch_row_index].as_buffer()), output_slice
                 )
             else:
@@ -316,7 +318,27 @@ class ReadRecord:
         numpy.ndarray[float32]
             A numpy array of signal data in pico amps with float32 type.
         """
-        return self.calibrate_signal_array(self.signal)
+        if self._batch_signal_cache is not None or not self._reader.is_vbz_compressed:
+            return self.calibrate_signal_array(self.signal)
+
+        # Decompress straight to pA, avoiding an intermediate int16 copy of the signal:
+        offset = self.calibration.offset
+        scale = self.calibration.scale
+        batch_data, sample_counts = self._find_signal_rows()
+
+        output = np.empty(dtype=np.float32, shape=(sum(sample_counts),))
+        current_sample_index = 0
+
+        for i, (batch, _, batch_row_index) in enumerate(batch_data):
+            current_row_count = sample_counts[i]
+            self._reader._decompress_signal_pa_into(
+                memoryview(batch.signal[batch_row_index].as_buffer()),
+                offset,
+                scale,
+                output[current_sample_index : current_sample_index + current_row_count],
+            )
+            current_sample_index += current_row_count
+        return output
 
     def signal_for_chunk(self, index: int) -> npt.NDArray[np.int16]:
         """
@@ -370,9 +392,21 @@ class ReadRecord:
         -------
         A numpy array of signal data with float32 type.
         """
-        offset = np.float32(self.calibration.offset)
-        scale = np.float32(self.calibration.scale)
-        return (signal_array_adc + offset) * scale
+        calibration = self.calibration
+        return p5b.calibrate_signal(
+            signal_array_adc, calibration.offset, calibration.scale
+        )
+
+    def _find_signal_rows(self) -> Tuple[List[Tuple[Signal, int, int]], List[int]]:
+        """
+        Find the signal batch rows for this read, and the sample count of each.
+        """
+        rows = self._batch.columns.signal[self._row]
+        batch_data = [self._find_signal_row_index(r.as_py()) for r in rows]
+        sample_counts = []
+        for batch, _, batch_row_index in batch_data:
+            sample_counts.append(batch.samples[batch_row_index].as_py())
+        return batch_data, sample_counts
 
     def _find_signal_row_index(self, signal_row: int) -> Tuple[Signal, int, int]:
         """
@@ -382,10 +416,11 @@ class ReadRecord:
         -------
         A Tuple containing the `Signal` and its `batch_index` and `row_index`
         """
-        sig_row_count: int = self._reader.signal_batch_row_count
-        sig_batch_idx: int = signal_row // sig_row_count
+        # Signal batches may hold different row counts, so the file reader finds the batch:
+        sig_batch_idx, batch_row_idx = (
+            self._reader.inner_file_reader.signal_batch_for_row_id(signal_row)
+        )
         sig_batch = self._reader._get_signal_batch(sig_batch_idx)
-        batch_row_idx: int = signal_row - (sig_batch_idx * sig_row_count)
 
         return sig_batch, sig_batch_idx, batch_row_idx
 
@@ -402,8 +437,9 @@ class ReadRecord:
         signal = batch.signal
         if self._reader.is_vbz_compressed:
             sample_count = batch.samples[batch_row_index].as_py()
-            return vbz_decompress_signal(
-                memoryview(signal[batch_row_index].as_buffer()), sample_count
+            output = np.empty(sample_count, dtype=np.int16)
+            return self._reader._decompress_signal_into(
+                memoryview(signal[batch_row_index].as_buffer()), output
             )
 
             return signal.to_numpy()
@@ -456,9 +492,11 @@ class ReadRecordBatch:
     def columns(self) -> ReadRecordV3Columns:
         """Return the data from this batch as a ReadRecordColumns instance"""
         if self._columns is None:
+            # Batches read with a column projection hold only some columns
+            names = set(self._batch.schema.names)
             self._columns = ReadRecordV3Columns(
                 *[
-                    self._batch.column(name)
+                    self._batch.column(name) if name in names else None
                     for name in self._reader._columns_type._fields
                 ]
             )
@@ -483,8 +521,9 @@ class ReadRecordBatch:
         """
 
         signal_cache = None
-        if self._signal_cache and self._signal_cache.samples:
-            signal_cache = self._signal_cache.samples
+        if self._signal_cache:
+            # Views over the batch's loaded samples, so only look them up once:
+            signal_cache = self._signal_cache.samples or None
 
         if self._selected_batch_rows is not None:
             for idx, row in enumerate(self._selected_batch_rows):
@@ -526,6 +565,42 @@ class ReadRecordBatch:
             return self.columns.read_number.take(self._selected_batch_rows)
         return self.columns.read_number
 
+    def signal_pa(self) -> Tuple[npt.NDArray[np.float32], npt.NDArray[np.uint64]]:
+        """
+        Get the signal of every read in this batch calibrated in pico amps, decoded
+        and calibrated natively across threads in one call.
+
+        Cached signal is calibrated rather than decoded again.
+
+        Returns
+        -------
+        (samples, offsets) : (numpy.ndarray[float32], numpy.ndarray[uint64])
+            The samples of all reads one after another, and the offset of each read's
+            samples followed by the total sample count, so read ``i`` is
+            ``samples[offsets[i] : offsets[i + 1]]``. Use
+            ``numpy.split(samples, offsets[1:-1])`` for a list of views of each read.
+        """
+        columns = self.columns
+        signal = columns.signal
+        calibration_offsets = columns.calibration_offset
+        calibration_scales = columns.calibration_scale
+        if self._selected_batch_rows is not None:
+            signal = signal.take(self._selected_batch_rows)
+            calibration_offsets = calibration_offsets.take(self._selected_batch_rows)
+            calibration_scales = calibration_scales.take(self._selected_batch_rows)
+
+        if self._signal_cache and self._signal_cache.samples:
+            return self._signal_cache.samples_pa(
+                calibration_offsets.to_numpy(), calibration_scales.to_numpy()
+            )
+
+        return self._reader.inner_file_reader.get_signal_pa(
+            signal.offsets.to_numpy(),
+            signal.values.to_numpy(),
+            calibration_offsets.to_numpy(),
+            calibration_scales.to_numpy(),
+        )
+
     @property
     def cached_sample_count_column(self) -> npt.NDArray[np.uint64]:
         """
@@ -546,7 +621,12 @@ class ReadRecordBatch:
 
 
 class ArrowTableHandle:
-    """Class for managing arrow file handles and memory view mapping of tables"""
+    """
+    Class for managing arrow file handles and memory view mapping of tables
+
+    The table is only mapped and its footer parsed when its reader or stream is
+    first used.
+    """
 
     def __init__(
         self,
@@ -580,27 +660,38 @@ class ArrowTableHandle:
         self._fh: Union[BufferedReader, None] = None
         self._reader: Union[pa.RecordBatchFileReader, None] = None
         self._stream: Union[pa.PythonFile, pa.NativeFile, None] = None
+        self._projected_readers: Dict[Tuple[str, ...], pa.RecordBatchFileReader] = {}
+        self._closed = False
 
-        self._fh = None
+    def _open_stream(self) -> Union[pa.PythonFile, pa.NativeFile]:
         if "POD5_DISABLE_MMAP_OPEN" in os.environ:
-            self._stream = self._open_without_mmap()
-        else:
-            # Create a memory view of the file and select the region for the table
-            try:
-                self._stream = self._open_with_mmap()
-            except OSError:
-                # If we fail fall back to a traditional open.
-                self._stream = self._open_without_mmap()
+            return self._open_without_mmap()
 
-        self._reader = pa.ipc.open_file(self._stream, options=self._options)
+        # Create a memory view of the file and select the region for the table
+        try:
+            return self._open_with_mmap()
+        except OSError:
+            # If we fail fall back to a traditional open.
+            return self._open_without_mmap()
 
     def _open_without_mmap(self) -> pa.PythonFile:
         class File(IOBase):
-            def __init__(self, handle, location):
+            def __init__(self, handle, path, location):
                 self._handle = handle
+                self._path = path
                 self._location = location
+                self._pid = os.getpid()
                 self.seek(0, whence=0)
 
+            def _process_handle(self):
+                # A forked child shares the parent's offset, so opens its own handle:
+                if self._pid != os.getpid():
+                    position = self._handle.tell()
+                    self._handle = self._path.open("rb")
+                    self._handle.seek(position)
+                    self._pid = os.getpid()
+                return self._handle
+
             def seek(self, position, whence=0):
                 if whence == 0:
                     position = position + self._location.offset
@@ -610,17 +701,17 @@ class ArrowTableHandle:
                     ) - position
                     whence = 0
                 # The new abs location:
-                abs_location = self._handle.seek(position, whence)
+                abs_location = self._process_handle().seek(position, whence)
 
                 return abs_location - self._location.offset
 
             def read(self, size=-1):
-                return self._handle.read(size)
+                return self._process_handle().read(size)
 
         if self._fh is None:
             self._fh = self._path.open("rb")
 
-        return pa.PythonFile(File(self._fh, self._location))
+        return pa.PythonFile(File(self._fh, self._path, self._location))
 
     def _open_with_mmap(self) -> pa.BufferReader:
         # Temporarily open file to reduce open file handles
@@ -640,23 +731,49 @@ class ArrowTableHandle:
     @property
     def reader(self) -> pa.ipc.RecordBatchFileReader:
         """Return the pyarrow file reader object"""
-        if self._reader is not None:
-            return self._reader
+        if self._reader is None:
+            self._reader = pa.ipc.open_file(self.stream, options=self._options)
+        return self._reader
+
+    def projected_reader(self, columns: Iterable[str]) -> pa.ipc.RecordBatchFileReader:
+        """
+        Return a pyarrow file reader which only reads and decodes the named columns
 
-        raise RuntimeError(f"Could not open pyarrow reader: {p5b.get_error_string()}")
+        Raises
+        ------
+        KeyError
+            If a column is not in the table
+        """
+        key = tuple(sorted(set(columns)))
+        if key not in self._projected_readers:
+            schema = self.reader.schema
+            missing = [name for name in key if schema.get_field_index(name) < 0]
+            if missing:
+                raise KeyError(f"Columns not in table: {missing}")
+
+            options = pa.ipc.IpcReadOptions(
+                included_fields=sorted(schema.get_field_index(name) for name in key)
+            )
+            self._projected_readers[key] = pa.ipc.open_file(
+                self.stream, options=options
+            )
+        return self._projected_readers[key]
 
     @property
     def stream(self) -> Union[pa.PythonFile, pa.NativeFile]:
         """Return the pyarrow file stream / backend"""
-        if self._stream is not None:
-            return self._stream
-
-        raise RuntimeError(f"Could not open pyarrow stream: {p5b.get_error_string()}")
+        if self._closed:
+            raise RuntimeError("ArrowTableHandle has been closed!")
+        if self._stream is None:
+            self._stream = self._open_stream()
+        return self._stream
 
     def close(self) -> None:
         """
         Cleanly close the open file handles and memory views.
         """
+        self._closed = True
+        self._projected_readers.clear()
         safe_close(self, "_reader")
         self._reader = None
 
@@ -676,9 +793,77 @@ class ArrowTableHandle:
         self.close()
 
 
+class MigratedTableReader:
+    """
+    Reads a table of a file written by an older version of the format, migrated
+    batch by batch by the inner file reader as it is read, rather than rewritten
+    as a current version table.
+
+    Offers the parts of :py:class:`pyarrow.ipc.RecordBatchFileReader` used to read
+    a table's batches.
+    """
+
+    def __init__(
+        self,
+        num_record_batches: Callable[[], int],
+        read_batch: Callable[[int], p5b.Pod5RecordBatch],
+    ) -> None:
+        self._num_record_batches = num_record_batches
+        self._read_batch = read_batch
+
+    @property
+    def num_record_batches(self) -> int:
+        """The number of batches in the table"""
+        return self._num_record_batches()
+
+    def get_batch(self, index: int) -> pa.RecordBatch:
+        """Read the migrated batch at `index`"""
+        return pa.record_batch(self._read_batch(index))
+
+    get_record_batch = get_batch
+
+    def read_all(self) -> pa.Table:
+        """Read every migrated batch of the table"""
+        return pa.Table.from_batches(
+            [self.get_batch(index) for index in range(self.num_record_batches)]
+        )
+
+
+class MigratedTableHandle:
+    """
+    Handle to a table migrated in place by the inner file reader, standing in for
+    an :py:class:`ArrowTableHandle` so no migrated copy of the table is written.
+    """
+
+    def __init__(self, reader: MigratedTableReader) -> None:
+        self._reader: Optional[MigratedTableReader] = reader
+
+    @property
+    def reader(self) -> MigratedTableReader:
+        """Return the migrated table reader"""
+        if self._reader is None:
+            raise RuntimeError("MigratedTableHandle has been closed!")
+        return self._reader
+
+    def close(self) -> None:
+        """Release the inner file reader"""
+        self._reader = None
+
+
+TableHandle = Union[ArrowTableHandle, MigratedTableHandle]
+TableReader = Union[pa.ipc.RecordBatchFileReader, MigratedTableReader]
+
+
 class Reader:
     """
     The base reader for POD5 data
+
+    A reader may be shared with processes forked after it is opened, such as
+    PyTorch DataLoader workers, rather than each worker reopening the file. Call
+    :py:meth:`prepare_for_fork` before forking, so the file is parsed and its
+    read id index built once, in memory every worker shares. Each worker then
+    caches only the signal it decodes itself. Fork while no other thread is
+    using the reader, and don't close it in the parent while workers use it.
     """
 
     def __init__(self, path: PathOrStr):
@@ -688,8 +873,8 @@ class Reader:
         self._path = Path(path).absolute()
 
         self._file_reader: Optional[p5b.Pod5FileReader] = None
-        self._read_handle: Optional[ArrowTableHandle] = None
-        self._run_info_handle: Optional[ArrowTableHandle] = None
+        self._read_handle: Optional[TableHandle] = None
+        self._run_info_handle: Optional[TableHandle] = None
         self._signal_handle: Optional[ArrowTableHandle] = None
 
         (
@@ -699,12 +884,14 @@ class Reader:
             self._signal_handle,
         ) = self._open_arrow_table_handles(self._path)
 
-        schema_metadata = self.read_table.schema.metadata
-        self._file_identifier = UUID(
-            schema_metadata[b"MINKNOW:file_identifier"].decode("utf-8")
-        )
-        self._writing_software = schema_metadata[b"MINKNOW:software"].decode("utf-8")
-        writing_version_str = schema_metadata[b"MINKNOW:pod5_version"].decode("utf-8")
+        # Batches are read through the file reader, and shared with pyarrow without
+        # copying, so the tables are only opened by pyarrow if used directly:
+        (
+            file_identifier,
+            self._writing_software,
+            writing_version_str,
+        ) = self._file_reader.schema_metadata()
+        self._file_identifier = UUID(file_identifier)
         writing_version = packaging.version.parse(writing_version_str)
 
         self._columns_type = ReadRecordV3Columns
@@ -726,10 +913,14 @@ class Reader:
     @staticmethod
     def _open_arrow_table_handles(
         path: Path,
-    ) -> Tuple[
-        p5b.Pod5FileReader, ArrowTableHandle, ArrowTableHandle, ArrowTableHandle
-    ]:
-        """Open handles to the underlying arrow tables within this pod5 file"""
+    ) -> Tuple[p5b.Pod5FileReader, TableHandle, TableHandle, ArrowTableHandle]:
+        """
+        Open handles to the underlying arrow tables within this pod5 file
+
+        Tables of files written by older versions of the format are migrated in
+        place by the file reader as they are read, rather than written out as
+        current version tables.
+        """
         if not path.is_file():
             raise FileNotFoundError(f"Failed to open pod5 file at: {path}")
 
@@ -739,10 +930,28 @@ class Reader:
                 f"Failed to open reader for {path} Reason: {p5b.get_error_string()}"
             )
 
-        read_handle = ArrowTableHandle(file_reader.get_file_read_table_location())
-        run_info_handle = ArrowTableHandle(
-            file_reader.get_file_run_info_table_location()
-        )
+        read_handle: TableHandle
+        if file_reader.read_table_migrated():
+            read_handle = MigratedTableHandle(
+                MigratedTableReader(
+                    file_reader.num_read_record_batches,
+                    lambda index: file_reader.read_batch(index, []),
+                )
+            )
+        else:
+            read_handle = ArrowTableHandle(file_reader.get_file_read_table_location())
+
+        run_info_handle: TableHandle
+        if file_reader.run_info_table_migrated():
+            run_info_handle = MigratedTableHandle(
+                MigratedTableReader(
+                    file_reader.num_run_info_record_batches, file_reader.run_info_batch
+                )
+            )
+        else:
+            run_info_handle = ArrowTableHandle(
+                file_reader.get_file_run_info_table_location()
+            )
         signal_handle = ArrowTableHandle(file_reader.get_file_signal_table_location())
         return file_reader, read_handle, run_info_handle, signal_handle
 
@@ -774,6 +983,18 @@ class Reader:
         # Explicitly clear this dictionary to close file handles used in cache
         self._cached_signal_batches = {}
 
+    def prepare_for_fork(self) -> None:
+        """
+        Ready the reader to be shared with processes forked after this call.
+
+        Every table is opened and the read id index is built in memory shared
+        with forked processes, so workers neither parse the file again nor copy
+        the index. Cached signal is dropped, so workers don't inherit the
+        parent's cache.
+        """
+        self.inner_file_reader.prepare_for_fork()
+        self._cached_signal_batches = {}
+
     @property
     def path(self) -> Path:
         """Return the path to this pod5 file"""
@@ -787,15 +1008,25 @@ class Reader:
         return self._file_reader
 
     @property
-    def read_table(self) -> pa.ipc.RecordBatchFileReader:
-        """Access the pod5 read table"""
+    def read_table(self) -> TableReader:
+        """
+        Access the pod5 read table, opened by pyarrow on first use. Prefer
+        :py:meth:`get_batch`, which shares the batches already decoded by the
+        inner file reader.
+
+        Files written by older versions of the format are read through a
+        :py:class:`MigratedTableReader`, migrating each batch as it is read.
+        """
         if self._read_handle is None:
             raise RuntimeError("ArrowTableHandle has been closed!")
         return self._read_handle.reader
 
     @property
-    def run_info_table(self) -> pa.ipc.RecordBatchFileReader:
-        """Access the pod5 run_info table"""
+    def run_info_table(self) -> TableReader:
+        """
+        Access the pod5 run_info table, a :py:class:`MigratedTableReader` for files
+        predating run info tables
+        """
         if self._run_info_handle is None:
             raise RuntimeError("ArrowTableHandle has been closed!")
         return self._run_info_handle.reader
@@ -807,6 +1038,53 @@ class Reader:
             raise RuntimeError("ArrowTableHandle has been closed!")
         return self._signal_handle.reader
 
+    def statistics(self) -> p5b.FileReaderStatistics:
+        """
+        Find the IO and decoding counts of the underlying c_api file reader since
+        the file was opened: bytes read and batches decoded per table, signal batch
+        cache hits, misses and evictions, and the samples decompressed and time
+        spent decompressing them.
+
+        Tables read directly through pyarrow, with :py:attr:`read_table`,
+        :py:attr:`run_info_table` or :py:attr:`signal_table`, are not counted.
+        """
+        return self.inner_file_reader.statistics()
+
+    @property
+    def signal_summary_decimations(self) -> List[int]:
+        """
+        Find the decimations reads' signal summaries are stored at, in increasing
+        order, or an empty list if the file was written without summaries.
+        """
+        return self.inner_file_reader.signal_summary_decimations()
+
+    def get_signal_summary(
+        self, read_id: Union[str, UUID], decimation: int
+    ) -> Optional[SignalSummary]:
+        """
+        Find the summary of a read's signal at one of
+        :py:attr:`signal_summary_decimations`: the min, max and mean of each run of
+        "decimation" samples, the last run holding whatever samples remain. Only
+        the summary batch holding the read is read.
+
+        Parameters
+        ----------
+        read_id : str, UUID
+            The read to find the summary of
+        decimation : int
+            The decimation to find the summary at
+
+        Returns
+        -------
+        :py:class:`SignalSummary` of int16 numpy arrays, or None if the read has no
+        summary at "decimation".
+        """
+        read_id_data = np.frombuffer(UUID(str(read_id)).bytes, dtype=np.uint8)
+        level = self.inner_file_reader.signal_summary(read_id_data, decimation)
+        if level is None:
+            return None
+        return SignalSummary(*level)
+
     @property
     def file_version(self) -> packaging.version.Version:
         return self._file_version
@@ -831,17 +1109,46 @@ class Reader:
     def is_vbz_compressed(self) -> bool:
         """Return if this file's signal is compressed"""
         if self._is_vbz_compressed is None:
-            self._is_vbz_compressed = self.signal_table.schema.field(
-                "signal"
-            ).type.equals(pa.large_binary())
+            self._is_vbz_compressed = self.inner_file_reader.is_signal_compressed()
         return self._is_vbz_compressed
 
+    def _decompress_signal_into(
+        self,
+        compressed_signal: memoryview,
+        output_array: npt.NDArray[np.int16],
+    ) -> npt.NDArray[np.int16]:
+        """
+        Decompress a signal row of this file into "output_array", using the file's
+        signal compression dictionary if it has one.
+        """
+        if len(compressed_signal) != 0:
+            self.inner_file_reader.decompress_signal(compressed_signal, output_array)
+        return output_array
+
+    def _decompress_signal_pa_into(
+        self,
+        compressed_signal: memoryview,
+        calibration_offset: float,
+        calibration_scale: float,
+        output_array: npt.NDArray[np.float32],
+    ) -> npt.NDArray[np.float32]:
+        """
+        Decompress a signal row of this file into "output_array", calibrating it to
+        pA in the same pass, see _decompress_signal_into.
+        """
+        if len(compressed_signal) != 0:
+            self.inner_file_reader.decompress_signal_pa(
+                compressed_signal, calibration_offset, calibration_scale, output_array
+            )
+        return output_array
+
     @property
     def signal_batch_row_count(self) -> int:
         """Return signal batch row count"""
         if self._signal_batch_row_count is None:
-            if self.signal_table.num_record_batches > 0:
-                self._signal_batch_row_count = self.signal_table.get_batch(0).num_rows
+            if self.inner_file_reader.num_signal_record_batches() > 0:
+                first_batch = self.inner_file_reader.signal_batch(0)
+                self._signal_batch_row_count = first_batch.num_rows
             else:
                 self._signal_batch_row_count = 0
         return self._signal_batch_row_count
@@ -851,7 +1158,7 @@ class Reader:
         """
         Find the number of read batches available in the file.
         """
-        return self.read_table.num_record_batches
+        return self.inner_file_reader.num_read_record_batches()
 
     @property
     def num_reads(self) -> int:
@@ -891,16 +1198,29 @@ class Reader:
         )
         return format_read_ids(read_ids)
 
-    def get_batch(self, index: int) -> ReadRecordBatch:
+    def get_batch(
+        self, index: int, columns: Optional[Iterable[str]] = None
+    ) -> ReadRecordBatch:
         """
         Get a read batch in the file.
 
+        Parameters
+        ----------
+        index : int
+            The index of the batch to read.
+        columns : Optional[Iterable[str]]
+            If set, only these read table columns are read and decoded. Other
+            columns are reported as None by :py:attr:`ReadRecordBatch.columns`.
+
         Returns
         -------
         :py:class:`ReadRecordBatch`
             The requested batch as a ReadRecordBatch.
         """
-        return ReadRecordBatch(self, self.read_table.get_batch(index))
+        batch = self.inner_file_reader.read_batch(
+            index, list(columns) if columns is not None else []
+        )
+        return ReadRecordBatch(self, pa.record_batch(batch))
 
     def read_batches(
         self,
@@ -939,6 +1259,39 @@ class Reader:
         else:
             yield from self._reads_batches(preload=preload)
 
+    def prefetch_batches(
+        self,
+        columns: Optional[Iterable[str]] = None,
+        prefetch_batches: int = DEFAULT_PREFETCH_BATCHES,
+    ) -> Generator[ReadRecordBatch, None, None]:
+        """
+        Iterate every batch in the file, reading the batches after the one last
+        yielded on native threads, so IO and decoding overlap whatever work the
+        caller does with each batch.
+
+        Parameters
+        ----------
+        columns : Optional[Iterable[str]]
+            If set, only these read table columns are read and decoded. Other
+            columns are reported as None by :py:attr:`ReadRecordBatch.columns`.
+        prefetch_batches : int
+            The most batches read ahead of the one being yielded, bounding the
+            memory held by batches not yet yielded.
+
+        Returns
+        -------
+        An iterable of :py:class:`ReadRecordBatch` in the file, in file order.
+        """
+        iterator = self.inner_file_reader.iterate_read_batches(
+            list(columns) if columns is not None else [], max(1, prefetch_batches)
+        )
+        while True:
+            try:
+                batch = iterator.next_batch()
+            except StopIteration:
+                return
+            yield ReadRecordBatch(self, pa.record_batch(batch))
+
     def reads(
         self,
         selection: Optional[Iterable[str]] = None,
@@ -968,6 +1321,120 @@ class Reader:
                 list(selection), missing_ok=missing_ok, preload=preload
             )
 
+    def scan(
+        self,
+        expression: str,
+        preload: Optional[Set[str]] = None,
+    ) -> Generator[ReadRecord, None, None]:
+        """
+        Iterate the reads matching a filter expression. The filter is evaluated in
+        C++ over only the read table columns it tests, without loading the table
+        into memory.
+
+        Parameters
+        ----------
+        expression : str
+            Comparisons (==, !=, <, <=, >, >=) and set tests (in, not in) on read
+            table columns, joined with and, or, not and parentheses. Dictionary
+            columns (pore_type, end_reason and run_info) compare against their
+            string values, for example
+            ``"channel < 100 and end_reason in ('signal_positive', 'unblock_mux_change')"``.
+        preload : set[str]
+            Columns to preload - "samples" and "sample_count" are valid values
+
+        Returns
+        -------
+        An iterable of :py:class:`ReadRecord` matching the expression, in file order.
+        """
+        batch_rows = np.empty(dtype="u4", shape=self.num_reads)
+        per_batch_counts = np.empty(dtype="u4", shape=self.batch_count)
+        selected_count = self.inner_file_reader.scan_reads(
+            expression, per_batch_counts, batch_rows
+        )
+
+        for batch in self._traverse_selected_batches(
+            per_batch_counts, batch_rows[:selected_count], preload=preload
+        ):
+            for read in batch.reads():
+                yield read
+
+    def stream_reads(
+        self,
+        selection: Optional[Iterable[str]] = None,
+        missing_ok: bool = False,
+        lookahead_reads: int = DEFAULT_LOOKAHEAD_READS,
+        lookahead_bytes: Optional[int] = None,
+    ) -> Iterator[ReadRecord]:
+        """
+        Iterate reads in the file with their signal loaded ahead of the caller.
+
+        Signal is read and decompressed on native threads, a bounded distance
+        ahead of the read being yielded, so IO and decoding overlap whatever work
+        the caller does with each read. Loading starts when this is called, not
+        when iteration starts.
+
+        Parameters
+        ----------
+        selection : iterable[str]
+            The read ids to walk in the file, every read is walked if None.
+        missing_ok : bool
+            If selection contains entries not found in the file, an error will be raised.
+        lookahead_reads : int
+            Roughly the most reads to load ahead of the caller, rounded to whole
+            read table batches.
+        lookahead_bytes : Optional[int]
+            The most bytes of decoded signal to hold ahead of the caller, if set.
+
+        Returns
+        -------
+        An iterator of :py:class:`ReadRecord` in file order, with cached signal.
+        """
+        per_batch_counts = np.empty(0, dtype=np.uint32)
+        batch_rows = np.empty(0, dtype=np.uint32)
+        if selection is not None:
+            selection = list(selection)
+            found, per_batch_counts, batch_rows = self._plan_traversal(
+                selection, missing_ok=missing_ok
+            )
+            if not missing_ok and found != len(selection):
+                raise RuntimeError(
+                    f"Failed to find {len(selection) - found} "
+                    "requested reads in the file"
+                )
+            batch_rows = batch_rows[:found]
+
+        reads_per_batch = max(1, self.num_reads // max(1, self.batch_count))
+        loader = self.inner_file_reader.stream_signal(
+            per_batch_counts,
+            batch_rows,
+            max(1, -(-lookahead_reads // reads_per_batch)),
+            lookahead_bytes or 0,
+        )
+        return self._stream_reads(loader, per_batch_counts, batch_rows)
+
+    def _stream_reads(
+        self,
+        loader: p5b.Pod5AsyncSignalLoader,
+        per_batch_counts: npt.NDArray[np.uint32],
+        batch_rows: npt.NDArray[np.uint32],
+    ) -> Generator[ReadRecord, None, None]:
+        """Generate the reads of every batch streamed by `loader`"""
+        current_offset = 0
+        for batch_idx in range(self.batch_count):
+            batch_count = per_batch_counts[batch_idx] if len(per_batch_counts) else None
+            if batch_count == 0:
+                loader.release_next_batch()
+                continue
+
+            batch = self.get_batch(batch_idx)
+            if batch_count is not None:
+                batch.set_selected_batch_rows(
+                    batch_rows[current_offset : current_offset + batch_count]
+                )
+                current_offset += batch_count
+            batch.set_cached_signal(loader.release_next_batch())
+            yield from batch.reads()
+
     def _reads(
         self, preload: Optional[Set[str]] = None
     ) -> Generator[ReadRecord, None, None]:
@@ -998,7 +1465,7 @@ class Reader:
                 "sample_count" in preload,
             )
 
-        for idx in range(self.read_table.num_record_batches):
+        for idx in range(self.batch_count):
             batch = self.get_batch(idx)
             if signal_cache:
                 batch.set_cached_signal(signal_cache.release_next_batch())
@@ -1040,6 +1507,17 @@ class Reader:
                 f"Failed to find {len(selection) - successful_finds} requested reads in the file"
             )
 
+        yield from self._traverse_selected_batches(
+            per_batch_counts, batch_rows, preload=preload
+        )
+
+    def _traverse_selected_batches(
+        self,
+        per_batch_counts: npt.NDArray[np.uint32],
+        batch_rows: npt.NDArray[np.uint32],
+        preload: Optional[Set[str]] = None,
+    ) -> Generator[ReadRecordBatch, None, None]:
+        """Generate every batch, restricted to the selected rows of each"""
         signal_cache: Optional[p5b.Pod5AsyncSignalLoader] = None
         if preload:
             signal_cache = self.inner_file_reader.batch_get_signal_selection(
@@ -1108,7 +1586,7 @@ class Reader:
         if batch_id in self._cached_signal_batches:
             return self._cached_signal_batches[batch_id]
 
-        batch = self.signal_table.get_batch(batch_id)
+        batch = pa.record_batch(self.inner_file_reader.signal_batch(batch_id))
 
         signal_batch = Signal(*[batch.column(name) for name in Signal._fields])
 
@@ -1,17 +1,48 @@
 """
 Tools to assist repacking pod5 data into other pod5 files
 """
-from typing import Collection
+import json
+from typing import Any, Collection, Dict, Optional, Sequence, Tuple
 import lib_pod5 as p5b
+import numpy as np
+import numpy.typing as npt
 
 import pod5 as p5
 
+# Read orders of repacker outputs, by sort_by argument:
+SORT_KEYS = {
+    None: p5b.RepackReadOrder.AsAdded,
+    "read_id": p5b.RepackReadOrder.ReadId,
+    "channel": p5b.RepackReadOrder.ChannelStartSample,
+}
+
 
 class Repacker:
     """Wrapper class around native pod5 tools to repack data"""
 
-    def __init__(self):
-        self._repacker = p5b.Repacker()
+    def __init__(
+        self,
+        max_pending_bytes: Optional[int] = None,
+        adaptive_concurrency: bool = False,
+    ):
+        """
+        Parameters
+        ----------
+        max_pending_bytes: Optional[int]
+            Limit on the bytes of signal read from inputs and waiting to be written
+            to outputs. Inputs aren't read while the limit is reached. 0 sets no limit,
+            None uses the default limit.
+        adaptive_concurrency: bool
+            Tune the number of workers repacking at once by the signal throughput
+            they deliver, rather than running every worker. The chosen count is
+            reported as `worker_concurrency` by :py:meth:`statistics`.
+        """
+        if max_pending_bytes is None:
+            self._repacker = p5b.Repacker(adaptive_concurrency=adaptive_concurrency)
+        else:
+            self._repacker = p5b.Repacker(
+                max_pending_bytes, adaptive_concurrency=adaptive_concurrency
+            )
         self._reads_requested = 0
 
     @property
@@ -29,13 +60,74 @@ class Repacker:
         """Find the number of reads written to files"""
         return self._repacker.reads_completed
 
+    @property
+    def pending_bytes(self) -> int:
+        """Find the bytes of signal read from inputs and waiting to be written"""
+        return self._repacker.pending_bytes
+
     @property
     def reads_requested(self) -> int:
         """Find the number of requested reads to be written"""
         return self._reads_requested
 
+    def statistics(self) -> Dict[str, Any]:
+        """
+        Counters for the work done by the repacker's outputs so far, and the time
+        spent in each state their work passes through, as a json serialisable dict.
+
+        `worker_concurrency` is the number of workers running that work at once.
+
+        Each state's `time_histogram` counts runs taking under 1us, 2us, 4us and so
+        on, the last bucket counting all longer runs.
+
+        `thread_pool` holds the queue depths of the thread pool running this work,
+        its tasks' wait and run time histograms (bucketed as above) and the fraction
+        of time each worker has been busy.
+        """
+        stats = self._repacker.statistics()
+        result: Dict[str, Any] = {
+            key: getattr(stats, key)
+            for key in (
+                "read_table_batches_read",
+                "reads_read",
+                "signal_batches_copied",
+                "signal_bytes_copied",
+                "signal_batches_written",
+                "signal_rows_written",
+                "signal_bytes_written",
+                "reads_written",
+                "worker_concurrency",
+            )
+        }
+        result["states"] = {
+            state.name: {
+                "runs": state.runs,
+                "queued": state.queued,
+                "max_queued": state.max_queued,
+                "time_seconds": state.time_seconds,
+                "max_time_seconds": state.max_time_seconds,
+                "time_histogram": list(state.time_histogram),
+            }
+            for state in stats.states
+        }
+
+        pool = self._repacker.thread_pool_statistics()
+        result["thread_pool"] = {
+            "queued_tasks": pool.queued_tasks,
+            "running_tasks": pool.running_tasks,
+            "strand_queued_tasks": list(pool.strand_queued_tasks),
+            "tasks_run": pool.tasks_run,
+            "wait_time_histogram": list(pool.wait_time_histogram),
+            "run_time_histogram": list(pool.run_time_histogram),
+            "worker_busy_ratios": list(pool.worker_busy_ratios),
+        }
+        return result
+
     def add_output(
-        self, output_file: p5.Writer, check_duplicate_read_ids: bool = True
+        self,
+        output_file: p5.Writer,
+        check_duplicate_read_ids: bool = True,
+        sort_by: Optional[str] = None,
     ) -> p5b.Pod5RepackerOutput:
         """
         Add an output file writer to the repacker, so it can have read data repacked
@@ -50,6 +142,10 @@ class Repacker:
             The output file writer to use
         check_duplicate_read_ids: bool
             Check the output for duplicate read ids, and raise an error if found.
+        sort_by: Optional[str]
+            Write reads sorted by "read_id", or by "channel" then start sample,
+            rather than in the order they are added. Sorted outputs write their
+            reads once :py:meth:`set_output_finished` is called.
 
         Returns
         -------
@@ -58,7 +154,13 @@ class Repacker:
             or :py:meth:`add_reads_to_output`
         """
         assert output_file._writer is not None
-        return self._repacker.add_output(output_file._writer, check_duplicate_read_ids)
+        if sort_by not in SORT_KEYS:
+            raise ValueError(
+                f"Unknown sort_by {sort_by}, expected one of {list(SORT_KEYS)}"
+            )
+        return self._repacker.add_output(
+            output_file._writer, check_duplicate_read_ids, SORT_KEYS[sort_by]
+        )
 
     def add_selected_reads_to_output(
         self,
@@ -100,6 +202,82 @@ class Repacker:
             output_ref, reader.inner_file_reader, per_batch_counts, all_batch_rows
         )
 
+    def add_partitioned_reads_to_outputs(
+        self,
+        output_refs: Sequence[p5b.Pod5RepackerOutput],
+        reader: p5.Reader,
+        routes: Collection[Tuple[str, int]],
+    ):
+        """
+        Copy reads from the given :py:class:`Reader` into many Repacker outputs,
+        reading the source's read table once however many outputs there are.
+
+        Parameters
+        ----------
+        output_refs : Sequence[lib_pod5.pod5_format_pybind.Pod5RepackerOutput]
+            The repacker handle references returned from :py:meth:`add_output`
+        reader : :py:class:`Reader`
+            The Pod5 file reader to copy reads from
+        routes: Collection[Tuple[str, int]]
+            Pairs of a read_id string and the index into `output_refs` of an output
+            to copy it to. A read_id may be copied to several outputs.
+
+        Raises
+        ------
+        RuntimeError
+            If any of the routed read_ids were not found in the source file
+        """
+        routes = set(routes)
+        read_ids = p5.pack_read_ids([read_id for read_id, _ in routes])
+        read_outputs = np.array([output for _, output in routes], dtype=np.uint32)
+
+        successful_finds = self._repacker.add_partitioned_reads_to_outputs(
+            list(output_refs), reader.inner_file_reader, read_ids, read_outputs
+        )
+
+        if successful_finds != len(routes):
+            raise RuntimeError(
+                f"Failed to find {len(routes) - successful_finds} "
+                "requested reads in the source file"
+            )
+        self._reads_requested += successful_finds
+
+    def add_read_ids_to_output(
+        self,
+        output_ref: p5b.Pod5RepackerOutput,
+        readers: Sequence[p5.Reader],
+        read_ids: npt.NDArray[np.uint8],
+    ) -> npt.NDArray[np.bool_]:
+        """
+        Copy the reads with the given packed read_ids from any of the given
+        :py:class:`Reader` instances into the Repacker output reference which was
+        returned by :py:meth:`add_output`.
+
+        Every reader's read id index is searched in parallel, without formatting
+        read ids as strings, so this suits selecting reads from many files at once.
+
+        Parameters
+        ----------
+        output_ref : lib_pod5.pod5_format_pybind.Pod5RepackerOutput
+            The repacker handle reference returned from :py:meth:`add_output`
+        readers : Sequence[:py:class:`Reader`]
+            The distinct Pod5 file readers to copy reads from
+        read_ids: numpy.ndarray[uint8]
+            The read ids to copy, packed 16 bytes per id as by :py:func:`pack_read_ids`
+
+        Returns
+        -------
+        found: numpy.ndarray[bool]
+            For each of `read_ids`, whether it was found in any of the readers
+        """
+        found = self._repacker.add_read_ids_to_output(
+            output_ref,
+            [reader.inner_file_reader for reader in readers],
+            read_ids.reshape(-1, 16),
+        ).astype(bool)
+        self._reads_requested += int(np.count_nonzero(found))
+        return found
+
     def add_all_reads_to_output(
         self, output_ref: p5b.Pod5RepackerOutput, reader: p5.Reader
     ) -> None:
@@ -129,3 +307,36 @@ class Repacker:
         Tell the repacker a specific output is complete and can be finalised.
         """
         return self._repacker.set_output_finished(output)
+
+
+def format_statistics(statistics: Dict[str, Any], output_format: str = "text") -> str:
+    """
+    Format the :py:meth:`Repacker.statistics` of a repacker as "json", or as a
+    "text" breakdown of the time spent in each state
+    """
+    if output_format == "json":
+        return json.dumps(statistics)
+
+    lines = [
+        f"{key}: {value}"
+        for key, value in statistics.items()
+        if key not in ("states", "thread_pool")
+    ]
+    pool = statistics.get("thread_pool")
+    if pool:
+        busy = pool["worker_busy_ratios"]
+        mean_busy = sum(busy) / len(busy) if busy else 0.0
+        lines.append(
+            f"thread_pool: {pool['tasks_run']} tasks run, "
+            f"{pool['queued_tasks']} queued, {pool['running_tasks']} running, "
+            f"{len(busy)} workers {mean_busy:.0%} busy"
+        )
+    lines.append(
+        f"{'state':<36}{'runs':>10}{'max queued':>12}{'time (s)':>12}{'max (s)':>10}"
+    )
+    for name, state in statistics["states"].items():
+        lines.append(
+            f"{name:<36}{state['runs']:>10}{state['max_queued']:>12}"
+            f"{state['time_seconds']:>12.3f}{state['max_time_seconds']:>10.3f}"
+        )
+    return "\n".join(lines)
@@ -2,13 +2,14 @@
 Tools for handling pod5 signals
 """
 
-from typing import List, Tuple, Union
+from typing import List, Sequence, Tuple, Union
 
 import lib_pod5 as p5b
 import numpy as np
 import numpy.typing as npt
 
 DEFAULT_SIGNAL_CHUNK_SIZE = 102400
+DEFAULT_MAX_DICTIONARY_SIZE = 64 * 1024
 
 
 def vbz_decompress_signal(
@@ -106,6 +107,40 @@ def vbz_decompress_signal_into(
     return output_array
 
 
+def vbz_decompress_signal_pa_into(
+    compressed_signal: Union[npt.NDArray[np.uint8], memoryview],
+    calibration_offset: float,
+    calibration_scale: float,
+    output_array: npt.NDArray[np.float32],
+) -> npt.NDArray[np.float32]:
+    """
+    Decompress a numpy array of compressed signal data into the destination
+    "output_array", calibrating it to pA in the same pass
+
+    Parameters
+    ----------
+    compressed_signal : numpy.ndarray[uint8]
+        The array of compressed signal data to decompress.
+    calibration_offset : float
+        The calibration offset of the read the signal belongs to.
+    calibration_scale : float
+        The calibration scale of the read the signal belongs to.
+    output_array : numpy.ndarray[float32]
+        The destination location for signal
+
+    Returns
+    -------
+    A decompressed and calibrated signal array numpy.ndarray[float32]
+    """
+    if len(compressed_signal) == 0:
+        return np.array([], dtype=np.float32)
+
+    p5b.decompress_signal_pa(
+        compressed_signal, calibration_offset, calibration_scale, output_array
+    )
+    return output_array
+
+
 def vbz_compress_signal(signal: npt.NDArray[np.int16]) -> npt.NDArray[np.uint8]:
     """
     Compress a numpy array of signal data
@@ -131,6 +166,28 @@ def vbz_compress_signal(signal: npt.NDArray[np.int16]) -> npt.NDArray[np.uint8]:
     return np.resize(compressed_signal, size)
 
 
+def train_signal_compression_dictionary(
+    signals: Sequence[npt.NDArray[np.int16]],
+    max_dictionary_size: int = DEFAULT_MAX_DICTIONARY_SIZE,
+) -> bytes:
+    """
+    Train a zstd dictionary for writing SignalType.VbzDictionarySignal files
+
+    Parameters
+    ----------
+    signals : Sequence[numpy.ndarray[int16]]
+        The signal of many reads representative of those to be written. Only the
+        start of each read contributes to the dictionary.
+    max_dictionary_size : int
+        The largest dictionary to train, in bytes
+
+    Returns
+    -------
+    The dictionary, to pass as a Writer's signal_compression_dictionary
+    """
+    return p5b.train_signal_compression_dictionary(list(signals), max_dictionary_size)
+
+
 def vbz_compress_signal_chunked(
     signal: npt.NDArray[np.int16], signal_chunk_size: int = DEFAULT_SIGNAL_CHUNK_SIZE
 ) -> Tuple[List[npt.NDArray[np.uint8]], List[int]]:
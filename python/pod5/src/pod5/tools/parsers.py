@@ -63,6 +63,16 @@ def add_force_overwrite_argument(parser: argparse._ActionsContainer):
     )
 
 
+def add_repack_stats_argument(parser: argparse.ArgumentParser):
+    parser.add_argument(
+        "--stats",
+        choices=["text", "json"],
+        default=None,
+        help="Print counters and the time spent in each stage of repacking to stderr "
+        "once done, as a table or as json",
+    )
+
+
 #
 # CONVERT - fast5
 #
@@ -391,6 +401,7 @@ def prepare_pod5_merge_argparser(
     )
     add_recursive_argument(parser)
     add_force_overwrite_argument(parser)
+    add_repack_stats_argument(parser)
     parser.add_argument(
         "-t",
         "--threads",
@@ -447,6 +458,7 @@ def prepare_pod5_repack_argparser(
     )
     add_recursive_argument(parser)
     add_force_overwrite_argument(parser)
+    add_repack_stats_argument(parser)
     parser.add_argument(
         "-t",
         "--threads",
@@ -454,6 +466,13 @@ def prepare_pod5_repack_argparser(
         default=DEFAULT_THREADS,
         help="Number of repacking workers",
     )
+    parser.add_argument(
+        "--sort-by",
+        choices=["read_id", "channel"],
+        default=None,
+        help="Write reads sorted by read id, or by channel then start sample, "
+        "rather than in input order",
+    )
 
     def run(**kwargs):
         from pod5.tools.pod5_repack import repack_pod5
@@ -500,6 +519,7 @@ def prepare_pod5_subset_argparser(
     )
     add_recursive_argument(parser)
     add_force_overwrite_argument(parser)
+    add_repack_stats_argument(parser)
     parser.add_argument(
         "-t",
         "--threads",
@@ -696,7 +716,7 @@ def prepare_pod5_view_argparser(
         "--threads",
         default=DEFAULT_THREADS,
         type=int,
-        help="Set the number of reader workers",
+        help="Set the number of export workers",
     )
     format_group = parser.add_argument_group("Formatting")
     format_group.add_argument(
@@ -708,6 +728,12 @@ def prepare_pod5_view_argparser(
         help="Table separator character (e.g. ',')",
         type=str,
     )
+    format_group.add_argument(
+        "--output-format",
+        default="tsv",
+        choices=["tsv", "arrow"],
+        help="Write a delimited table, or an arrow ipc stream of typed columns",
+    )
 
     selection = parser.add_argument_group("Selection")
     selection.add_argument(
@@ -5,6 +5,7 @@ Tool for converting fast5 files to the pod5 format
 import datetime
 import multiprocessing as mp
 from multiprocessing.context import SpawnContext
+import struct
 import sys
 import warnings
 from pod5.pod5_types import CompressedRead
@@ -27,10 +28,16 @@ from typing import (
 import h5py
 import iso8601
 import more_itertools
+import numpy as np
+import numpy.typing as npt
 import vbz_h5py_plugin  # noqa: F401
 
 import pod5 as p5
-from pod5.signal_tools import DEFAULT_SIGNAL_CHUNK_SIZE, vbz_compress_signal_chunked
+from pod5.signal_tools import (
+    DEFAULT_SIGNAL_CHUNK_SIZE,
+    vbz_compress_signal_chunked,
+    vbz_decompress_signal,
+)
 from pod5.tools.parsers import pod5_convert_from_fast5_argparser, run_tool
 from pod5.tools.utils import (
     DEFAULT_THREADS,
@@ -46,6 +53,12 @@ from pod5.tools.utils import (
 READ_CHUNK_SIZE = 400
 TIMEOUT_SECONDS = 600
 
+# HDF5 filter id registered for vbz compression
+VBZ_FILTER_ID = 32020
+# The vbz filter prefixes each compressed chunk with its uncompressed size in bytes
+VBZ_CHUNK_HEADER = struct.Struct("<I")
+ZSTD_FRAME_MAGIC = b"\x28\xb5\x2f\xfd"
+
 
 logger = init_logging()
 
@@ -481,13 +494,92 @@ def convert_run_info(
     )
 
 
+class VbzPassthrough:
+    """
+    Copies the vbz compressed signal chunks of a fast5 file's reads straight into
+    pod5 signal chunks, skipping their decompression and recompression.
+
+    The vbz hdf5 filter stores the same zstd compressed delta zig-zag svb16 stream
+    pod5 compresses signal to, behind a header of the uncompressed size. The first
+    chunk copied from each file is decoded and compared with the signal h5py reads,
+    and files whose chunks don't match fall back to recompressing signal. Only
+    datasets chunked at the requested signal chunk size are copied, so every read
+    is stored in chunks of that size.
+    """
+
+    def __init__(self) -> None:
+        self.verified: Optional[bool] = None
+
+    def read_signal_chunks(
+        self, dataset: h5py.Dataset, signal_chunk_size: int
+    ) -> Optional[Tuple[List[npt.NDArray[np.uint8]], List[int]]]:
+        """
+        Read the signal of a fast5 read as compressed pod5 signal chunks and their
+        sample counts, or None if the signal must be recompressed instead
+        """
+        if self.verified is False:
+            return None
+        if dataset.ndim != 1 or dataset.dtype != np.int16 or dataset.chunks is None:
+            return None
+
+        plist = dataset.id.get_create_plist()
+        if plist.get_nfilters() != 1 or plist.get_filter(0)[0] != VBZ_FILTER_ID:
+            return None
+
+        # Chunks of another size are recompressed to the chunk size asked for
+        chunk_samples = dataset.chunks[0]
+        if chunk_samples != signal_chunk_size:
+            return None
+        whole_chunks = dataset.shape[0] // chunk_samples
+        chunks: List[npt.NDArray[np.uint8]] = []
+        lengths: List[int] = []
+        for idx in range(whole_chunks):
+            filter_mask, raw = dataset.id.read_direct_chunk((idx * chunk_samples,))
+            if (
+                filter_mask != 0
+                or len(raw) <= VBZ_CHUNK_HEADER.size
+                or VBZ_CHUNK_HEADER.unpack_from(raw)[0] != chunk_samples * 2
+                or raw[VBZ_CHUNK_HEADER.size : VBZ_CHUNK_HEADER.size + 4]
+                != ZSTD_FRAME_MAGIC
+            ):
+                return None
+            chunks.append(
+                np.frombuffer(raw, dtype=np.uint8, offset=VBZ_CHUNK_HEADER.size)
+            )
+            lengths.append(chunk_samples)
+
+        if chunks and self.verified is None:
+            try:
+                copied = vbz_decompress_signal(chunks[0], chunk_samples)
+                self.verified = bool(np.array_equal(dataset[:chunk_samples], copied))
+            except RuntimeError:
+                self.verified = False
+            if not self.verified:
+                logger.info(f"vbz passthrough disabled for {dataset.file.filename}")
+                return None
+
+        # The last chunk is padded beyond the end of the signal, so is recompressed
+        tail_start = whole_chunks * chunk_samples
+        if tail_start < dataset.shape[0]:
+            tail_chunks, tail_lengths = vbz_compress_signal_chunked(
+                dataset[tail_start:], signal_chunk_size
+            )
+            chunks.extend(tail_chunks)
+            lengths.extend(tail_lengths)
+
+        return chunks, lengths
+
+
 def convert_fast5_read(
     fast5_read: h5py.Group,
     run_info_cache: Dict[str, p5.RunInfo],
     signal_chunk_size: int = DEFAULT_SIGNAL_CHUNK_SIZE,
+    passthrough: Optional[VbzPassthrough] = None,
 ) -> p5.CompressedRead:
     """
     Given a fast5 read parsed from a fast5 file, return a pod5.Read object.
+
+    Signal is copied without recompression through `passthrough` where possible.
     """
     channel_id = fast5_read["channel_id"]
     raw = fast5_read["Raw"]
@@ -537,10 +629,15 @@ def convert_fast5_read(
     end_reason = convert_fast5_end_reason(raw.attrs.get("end_reason", 0))
 
     # Signal conversion process
-    signal = raw["Signal"][()]
-    signal_chunks, signal_chunk_lengths = vbz_compress_signal_chunked(
-        signal, signal_chunk_size
-    )
+    copied = None
+    if passthrough is not None:
+        copied = passthrough.read_signal_chunks(raw["Signal"], signal_chunk_size)
+    if copied is not None:
+        signal_chunks, signal_chunk_lengths = copied
+    else:
+        signal_chunks, signal_chunk_lengths = vbz_compress_signal_chunked(
+            raw["Signal"][()], signal_chunk_size
+        )
 
     return p5.CompressedRead(
         read_id=read_id,
@@ -589,6 +686,7 @@ def convert_fast5_file_chunk(
     chunk: Iterable[str],
     cache: Dict[str, p5.RunInfo],
     signal_chunk_size: int,
+    passthrough: Optional[VbzPassthrough] = None,
 ) -> List[CompressedRead]:
     reads: List[p5.CompressedRead] = []
 
@@ -599,7 +697,7 @@ def convert_fast5_file_chunk(
             f5_read = get_read_from_fast5(group_name, handle)
             if f5_read is None:
                 continue
-            read = convert_fast5_read(f5_read, cache, signal_chunk_size)
+            read = convert_fast5_read(f5_read, cache, signal_chunk_size, passthrough)
             reads.append(read)
 
     except Exception as exc:
@@ -618,12 +716,13 @@ def convert_fast5_file(
     """Convert the reads in a fast5 file"""
 
     run_info_cache: Dict[str, p5.RunInfo] = {}
+    passthrough = VbzPassthrough()
     total_reads: int = 0
 
     with h5py.File(str(path), "r") as _f5:
         for chunk in more_itertools.chunked(_f5.keys(), READ_CHUNK_SIZE):
             reads = convert_fast5_file_chunk(
-                queues, _f5, chunk, run_info_cache, signal_chunk_size
+                queues, _f5, chunk, run_info_cache, signal_chunk_size, passthrough
             )
             queues.enqueue_data(path, reads)
             total_reads += len(reads)
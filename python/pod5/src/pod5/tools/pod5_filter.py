@@ -5,7 +5,7 @@ Tool for subsetting pod5 files into one or more outputs using a list of read ids
 
 from pathlib import Path
 from time import sleep
-from typing import List
+from typing import List, Sequence
 from pod5.tools.polars_utils import PL_DEST_FNAME, PL_READ_ID, PL_UUID_REGEX
 from pod5.tools.utils import (
     DEFAULT_THREADS,
@@ -16,6 +16,8 @@ from pod5.tools.utils import (
     logged_all,
 )
 
+import numpy as np
+import numpy.typing as npt
 import polars as pl
 
 from tqdm.auto import tqdm
@@ -24,11 +26,6 @@ import pod5 as p5
 from pod5.repack import Repacker
 
 from pod5.tools.parsers import prepare_pod5_filter_argparser, run_tool
-from pod5.tools.pod5_subset import (
-    calculate_transfers,
-    parse_sources,
-)
-from pod5.tools.polars_utils import PL_SRC_FNAME
 from pod5.tools.utils import logged
 
 
@@ -36,6 +33,9 @@ logger = init_logging()
 
 pl.enable_string_cache()
 
+# Number of sources searched together, and the most files held open at once
+SOURCE_CHUNK_SIZE = 32
+
 
 @logged_all
 def parse_read_id_targets(ids: Path, output: Path) -> pl.LazyFrame:
@@ -67,44 +67,48 @@ def parse_read_id_targets(ids: Path, output: Path) -> pl.LazyFrame:
 
 
 @logged(log_time=True)
-def filter_reads(dest: Path, sources: pl.DataFrame, duplicate_ok: bool) -> None:
-    """Copy the reads in `sources` into a new pod5 file at `dest`"""
+def filter_reads(
+    dest: Path,
+    sources: Sequence[Path],
+    read_ids: npt.NDArray[np.uint8],
+    missing_ok: bool,
+    duplicate_ok: bool,
+) -> None:
+    """
+    Copy the reads with the packed `read_ids` found in any of `sources` into a new
+    pod5 file at `dest`
+    """
     repacker = Repacker()
+    found = np.zeros(len(read_ids), dtype=bool)
     with p5.Writer(dest) as writer:
         output = repacker.add_output(writer, not duplicate_ok)
 
-        # Count the total number of reads expected
-        total_reads = 0
-        for source, reads in sources.group_by(PL_SRC_FNAME):
-            total_reads += len(reads.get_column(PL_READ_ID))
-
         pbar = tqdm(
-            total=total_reads,
+            total=0,
             unit="Read",
             desc="Filtering",
             leave=True,
             **PBAR_DEFAULTS,
         )
 
-        active_limit = 5
-
-        # Copy selected reads from one file at a time
-        for source, reads in sources.group_by(PL_SRC_FNAME):
-            src = Path(source)
-            read_ids = reads.get_column(PL_READ_ID).unique().to_list()
-            logger.debug(f"Filtering: {src} - n_reads: {len(read_ids)}")
-
-            if len(read_ids) == 0:
-                logger.debug(f"Skipping: {src}")
-                continue
-
-            while repacker.currently_open_file_reader_count >= active_limit:
+        # Sources are searched in parallel a chunk at a time, bounding the number
+        # of files held open by the repacker
+        for start in range(0, len(sources), SOURCE_CHUNK_SIZE):
+            while repacker.currently_open_file_reader_count >= SOURCE_CHUNK_SIZE:
                 pbar.update(repacker.reads_completed - pbar.n)
                 sleep(0.2)
 
-            with p5.Reader(src) as reader:
-                repacker.add_selected_reads_to_output(output, reader, read_ids)
-                continue
+            chunk = sources[start : start + SOURCE_CHUNK_SIZE]
+            logger.debug(f"Filtering: {len(chunk)} sources from {chunk[0]}")
+            readers = [p5.Reader(src) for src in chunk]
+            try:
+                found |= repacker.add_read_ids_to_output(output, readers, read_ids)
+            finally:
+                for reader in readers:
+                    reader.close()
+
+            pbar.total = repacker.reads_requested
+            pbar.refresh()
 
         repacker.set_output_finished(output)
         while repacker.currently_open_file_reader_count > 0:
@@ -114,6 +118,14 @@ def filter_reads(dest: Path, sources: pl.DataFrame, duplicate_ok: bool) -> None:
         repacker.finish()
         pbar.close()
 
+    missing = len(read_ids) - int(np.count_nonzero(found))
+    print(f"Found {len(read_ids) - missing} read_ids from {len(sources)} inputs")
+    if missing and not missing_ok:
+        dest.unlink()
+        raise AssertionError(
+            f"Missing {missing} read_ids from inputs but --missing-ok not set"
+        )
+
     return
 
 
@@ -128,7 +140,7 @@ def filter_pod5(
     recursive: bool = False,
     threads: int = DEFAULT_THREADS,
 ) -> None:
-    """Prepare the pod5 filter mapping and run the repacker"""
+    """Parse the requested read_ids and copy them from the inputs with the repacker"""
     # Remove output file
     if output.exists():
         if not force_overwrite:
@@ -142,27 +154,22 @@ def filter_pod5(
     if not output.parent.exists():
         output.parent.mkdir(parents=True, exist_ok=True)
 
-    targets = parse_read_id_targets(ids, output=output)
-    print(f"Parsed {len(targets.collect())} reads_ids from: {ids.name}")
+    targets = parse_read_id_targets(ids, output=output).collect()
+    print(f"Parsed {len(targets)} reads_ids from: {ids.name}")
 
-    threads = limit_threads(threads)
+    # Read ids are packed once, the inputs' read ids are never formatted as strings
+    read_ids = p5.pack_read_ids(targets.get_column(PL_READ_ID).to_list())
 
+    threads = limit_threads(threads)
     _inputs = collect_inputs(inputs, recursive, "*.pod5", threads=threads)
-    sources = parse_sources(_inputs, threads=threads)
-    print(f"Found {len(sources.collect())} read_ids from {len(_inputs)} inputs")
 
-    # Map the target outputs to which source read ids they're comprised of
-    transfers = calculate_transfers(
-        sources=sources,
-        targets=targets,
+    filter_reads(
+        dest=output,
+        sources=sorted(_inputs),
+        read_ids=read_ids,
         missing_ok=missing_ok,
+        duplicate_ok=duplicate_ok,
     )
-    print(f"Calculated {len(transfers.collect())} transfers")
-
-    # There will only one output from this
-    groupby_dest = transfers.collect().group_by(PL_DEST_FNAME)
-    for dest, sources in groupby_dest:
-        filter_reads(dest=dest, sources=sources, duplicate_ok=duplicate_ok)
 
     return
 
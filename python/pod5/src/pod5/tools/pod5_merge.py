@@ -2,8 +2,9 @@
 Tool for merging pod5 files
 """
 
+import sys
 from time import sleep
-from typing import Iterable
+from typing import Iterable, Optional
 from pathlib import Path
 from tqdm.auto import tqdm
 
@@ -30,6 +31,7 @@ def merge_pod5(
     recursive: bool = False,
     threads: int = DEFAULT_THREADS,
     readers: int = 5,
+    stats: Optional[str] = None,
 ) -> None:
     """
     Merge the an iterable of input pod5 paths into the specified output path
@@ -95,6 +97,11 @@ def merge_pod5(
             logger.debug(f"{len(_inputs)=}, {active=}, {active>0=}")
 
         repacker.finish()
+        if stats:
+            print(
+                p5_repack.format_statistics(repacker.statistics(), stats),
+                file=sys.stderr,
+            )
         del repacker
         pbar.update(opened_readers - active - pbar.n)
         pbar.close()
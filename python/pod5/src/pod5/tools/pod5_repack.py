@@ -2,6 +2,7 @@
 Tool for repacking pod5 files to potentially improve performance
 """
 from concurrent.futures import ProcessPoolExecutor, as_completed
+import sys
 import typing
 from pathlib import Path
 from tqdm.auto import tqdm
@@ -30,16 +31,26 @@ def resolve_overwrite(src: Path, dest: Path, force: bool) -> None:
             )
 
 
-def repack_pod5_file(src: Path, dest: Path):
+def repack_pod5_file(
+    src: Path,
+    dest: Path,
+    sort_by: typing.Optional[str] = None,
+    stats: typing.Optional[str] = None,
+):
     """Repack the source pod5 file into dest"""
     repacker = pod5.repack.Repacker()
     with p5.Writer(dest) as writer:
-        repacker_output = repacker.add_output(writer, False)
+        repacker_output = repacker.add_output(writer, False, sort_by=sort_by)
         with p5.Reader(src) as reader:
             # Add all reads to the repacker
             repacker.add_all_reads_to_output(repacker_output, reader)
         repacker.set_output_finished(repacker_output)
         repacker.finish()
+        if stats:
+            print(
+                pod5.repack.format_statistics(repacker.statistics(), stats),
+                file=sys.stderr,
+            )
 
 
 def repack_pod5(
@@ -48,6 +59,8 @@ def repack_pod5(
     threads: int = DEFAULT_THREADS,
     force_overwrite: bool = False,
     recursive: bool = False,
+    sort_by: typing.Optional[str] = None,
+    stats: typing.Optional[str] = None,
 ):
     """Given a list of pod5 files, repack their contents and write files 1-1"""
 
@@ -76,7 +89,11 @@ def repack_pod5(
 
         for src in _inputs:
             dest = output / src.name
-            futures[executor.submit(repack_pod5_file, src=src, dest=dest)] = dest
+            futures[
+                executor.submit(
+                    repack_pod5_file, src=src, dest=dest, sort_by=sort_by, stats=stats
+                )
+            ] = dest
 
         for future in as_completed(futures):
             tqdm.write(f"Finished {futures[future]}")
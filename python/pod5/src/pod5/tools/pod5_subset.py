@@ -2,6 +2,7 @@
 Tool for subsetting pod5 files into one or more outputs
 """
 
+from contextlib import ExitStack
 from copy import deepcopy
 import multiprocessing as mp
 from multiprocessing.context import SpawnContext
@@ -377,16 +378,26 @@ class WorkQueue:
         self,
         context: SpawnContext,
         transfers: pl.LazyFrame,
+        groups: int = 1,
     ) -> None:
         self.work: mp.JoinableQueue = context.JoinableQueue()
         self.size = 0
-        groupby_dest = transfers.collect().group_by(PL_DEST_FNAME)
-        for dest, sources in groupby_dest:
-            self.work.put((Path(dest), sources))
-            self.size += 1
 
-        self.progress: mp.Queue = context.Queue(maxsize=self.size + 1)
-        logger.info(f"WorkQueue size: {self.size}")
+        # Destinations are split into groups, each written by one worker which reads
+        # each source once for all of its destinations
+        collected = transfers.collect()
+        self.n_dests = collected.get_column(PL_DEST_FNAME).n_unique()
+        n_groups = max(1, min(groups, self.n_dests))
+        grouped: List[List[pl.DataFrame]] = [[] for _ in range(n_groups)]
+        for idx, (_, dest_transfers) in enumerate(collected.group_by(PL_DEST_FNAME)):
+            grouped[idx % n_groups].append(dest_transfers)
+        for group in grouped:
+            if group:
+                self.work.put(pl.concat(group))
+                self.size += 1
+
+        self.progress: mp.Queue = context.Queue(maxsize=self.n_dests + 1)
+        logger.info(f"WorkQueue size: {self.size}, destinations: {self.n_dests}")
 
     @logged_all
     def join(self) -> None:
@@ -424,7 +435,7 @@ class WorkQueue:
 @logged_all
 def overall_progress(queue: WorkQueue):
     pbar = tqdm(
-        total=queue.size,
+        total=queue.n_dests,
         desc="Subsetting",
         unit="Files",
         leave=True,
@@ -433,7 +444,7 @@ def overall_progress(queue: WorkQueue):
     )
 
     count = 0
-    while count < queue.size:
+    while count < queue.n_dests:
         try:
             queue.progress.get(timeout=1)
             count += 1
@@ -444,7 +455,10 @@ def overall_progress(queue: WorkQueue):
 
 @logged_all
 def launch_subsetting(
-    transfers: pl.LazyFrame, duplicate_ok: bool, threads: int = DEFAULT_THREADS
+    transfers: pl.LazyFrame,
+    duplicate_ok: bool,
+    threads: int = DEFAULT_THREADS,
+    stats: Optional[str] = None,
 ) -> None:
     """
     Iterate over the transfers dataframe subsetting reads from sources to destinations
@@ -453,7 +467,7 @@ def launch_subsetting(
     assert {PL_READ_ID, PL_SRC_FNAME, PL_DEST_FNAME}.issubset(set(transfers.columns))
 
     ctx = mp.get_context("spawn")
-    work = WorkQueue(ctx, transfers)
+    work = WorkQueue(ctx, transfers, groups=threads)
 
     active_processes = []
     try:
@@ -461,7 +475,7 @@ def launch_subsetting(
         for idx in range(min(threads, work.size)):
             process = ctx.Process(
                 target=process_subset_tasks,
-                args=(work, idx + 1, duplicate_ok),
+                args=(work, idx + 1, duplicate_ok, stats),
                 daemon=True,
             )
             # Enqueue a sentinel for each process to stop
@@ -493,7 +507,9 @@ def launch_subsetting(
 
 
 @logged(log_time=True)
-def process_subset_tasks(queue: WorkQueue, process: int, duplicate_ok: bool):
+def process_subset_tasks(
+    queue: WorkQueue, process: int, duplicate_ok: bool, stats: Optional[str] = None
+):
     """Consumes work from the queue and launches subsetting tasks"""
     while True:
         task = queue.work.get(timeout=60)
@@ -501,27 +517,35 @@ def process_subset_tasks(queue: WorkQueue, process: int, duplicate_ok: bool):
             queue.work.task_done()
             break
 
-        target, sources = task
+        transfers: pl.DataFrame = task
         try:
-            subset_reads(target, sources, process, duplicate_ok)
+            subset_reads(transfers, process, duplicate_ok, stats)
         finally:
             queue.work.task_done()
-            queue.progress.put(True)
+            for _ in range(transfers.get_column(PL_DEST_FNAME).n_unique()):
+                queue.progress.put(True)
 
 
 @logged(log_time=True)
 def subset_reads(
-    dest: Path, sources: pl.DataFrame, process: int, duplicate_ok: bool
+    transfers: pl.DataFrame,
+    process: int,
+    duplicate_ok: bool,
+    stats: Optional[str] = None,
 ) -> None:
-    """Copy the reads in `sources` into a new pod5 file at `dest`"""
+    """
+    Copy the reads in `transfers` into new pod5 files at each of their destinations,
+    reading each source once for all destinations
+    """
+    dests = sorted(set(transfers.get_column(PL_DEST_FNAME).to_list()))
+    dest_indices = {dest: idx for idx, dest in enumerate(dests)}
+
     # Count the total number of reads expected
-    total_reads = 0
-    for source, reads in sources.group_by(PL_SRC_FNAME):
-        total_reads += len(reads.get_column(PL_READ_ID))
+    total_reads = len(transfers.unique())
 
     pbar = tqdm(
         total=total_reads,
-        desc=dest.name,
+        desc=Path(dests[0]).name if len(dests) == 1 else f"{len(dests)} files",
         unit="Reads",
         leave=False,
         position=process,
@@ -529,23 +553,34 @@ def subset_reads(
     )
 
     repacker = p5_repack.Repacker()
-    with p5.Writer(dest) as writer:
-        output = repacker.add_output(writer, not duplicate_ok)
+    with ExitStack() as writers:
+        outputs = [
+            repacker.add_output(
+                writers.enter_context(p5.Writer(Path(dest))), not duplicate_ok
+            )
+            for dest in dests
+        ]
 
         active_limit = 5
-        # Copy selected reads from one file at a time
-        for source, reads in sources.group_by(PL_SRC_FNAME):
+        # Copy selected reads from one file at a time, to all destinations at once
+        for source, reads in transfers.group_by(PL_SRC_FNAME):
             while repacker.currently_open_file_reader_count >= active_limit:
                 pbar.update(repacker.reads_completed - pbar.n)
                 sleep(0.2)
 
-            read_ids = reads.get_column(PL_READ_ID).unique().to_list()
-            logger.debug(f"Subsetting: {source} - n_reads: {len(read_ids)}")
+            read_ids = reads.get_column(PL_READ_ID).to_list()
+            read_dests = reads.get_column(PL_DEST_FNAME).to_list()
+            routes = set(
+                (read_id, dest_indices[dest])
+                for read_id, dest in zip(read_ids, read_dests)
+            )
+            logger.debug(f"Subsetting: {source} - n_reads: {len(routes)}")
 
             with p5.Reader(Path(source)) as reader:
-                repacker.add_selected_reads_to_output(output, reader, read_ids)
+                repacker.add_partitioned_reads_to_outputs(outputs, reader, routes)
 
-        repacker.set_output_finished(output)
+        for output in outputs:
+            repacker.set_output_finished(output)
         while repacker.currently_open_file_reader_count > 0:
             pbar.update(repacker.reads_completed - pbar.n)
             sleep(0.1)
@@ -554,6 +589,11 @@ def subset_reads(
 
         # Finish the pod5 file and close source handles
         repacker.finish()
+        if stats:
+            print(
+                p5_repack.format_statistics(repacker.statistics(), stats),
+                file=sys.stderr,
+            )
 
     pbar.close()
 
@@ -569,6 +609,7 @@ def subset_pod5s_with_mapping(
     missing_ok: bool = False,
     duplicate_ok: bool = False,
     force_overwrite: bool = False,
+    stats: Optional[str] = None,
 ) -> None:
     """
     Given an iterable of input pod5 paths and an output directory, create output pod5
@@ -592,7 +633,9 @@ def subset_pod5s_with_mapping(
     )
 
     print(f"Calculated {len(transfers.collect())} transfers")
-    launch_subsetting(transfers=transfers, duplicate_ok=duplicate_ok, threads=threads)
+    launch_subsetting(
+        transfers=transfers, duplicate_ok=duplicate_ok, threads=threads, stats=stats
+    )
 
     print("Done")
     return None
@@ -613,6 +656,7 @@ def subset_pod5(
     ignore_incomplete_template: bool = False,
     force_overwrite: bool = False,
     recursive: bool = False,
+    stats: Optional[str] = None,
 ) -> Any:
     """Prepare the subsampling mapping and run the repacker"""
 
@@ -646,6 +690,7 @@ def subset_pod5(
         missing_ok=missing_ok,
         duplicate_ok=duplicate_ok,
         force_overwrite=force_overwrite,
+        stats=stats,
     )
 
 
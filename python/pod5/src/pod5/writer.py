@@ -80,6 +80,9 @@ class Writer:
         path: PathOrStr,
         software_name: str = DEFAULT_SOFTWARE_NAME,
         signal_compression_type: SignalType = SignalType.VbzSignal,
+        signal_compression_dictionary: Optional[bytes] = None,
+        signal_codec_id: Optional[str] = None,
+        signal_summary_decimations: Optional[Sequence[int]] = None,
     ):
         """
         Open a pod5 file for Writing.
@@ -92,6 +95,17 @@ class Writer:
             The name of the application used to create this pod5 file
         signal_compression_type : SignalType
             The type of compression to use in the file. Defaults to Vbz.
+        signal_compression_dictionary : bytes, optional
+            The dictionary signal is compressed against, required by and only used
+            with SignalType.VbzDictionarySignal, see
+            :py:func:`pod5.signal_tools.train_signal_compression_dictionary`.
+        signal_codec_id : str, optional
+            The id of the registered codec compressing signal, required by and only
+            used with SignalType.CodecSignal. Readers must register a codec with the
+            same id.
+        signal_summary_decimations : Sequence[int], optional
+            Decimations to keep each read's min, max and mean signal at, each above
+            1, read back with :py:meth:`pod5.Reader.get_signal_summary`.
         """
         self._path = Path(path).absolute()
         self._software_name = software_name
@@ -104,6 +118,12 @@ class Writer:
 
         options = p5b.FileWriterOptions()
         options.signal_compression_type = signal_compression_type
+        if signal_compression_dictionary is not None:
+            options.signal_compression_dictionary = signal_compression_dictionary
+        if signal_codec_id is not None:
+            options.signal_codec_id = signal_codec_id
+        if signal_summary_decimations is not None:
+            options.signal_summary_decimations = list(signal_summary_decimations)
 
         self._writer: Optional[p5b.FileWriter] = p5b.create_file(
             str(self._path), software_name, options
@@ -327,6 +347,106 @@ class Writer:
             )
         raise TypeError(f"Writer.add_reads(reads) - unexpected type: {type(reads[0])=}")
 
+    def add_reads_columnar(
+        self,
+        *,
+        read_id: Any,
+        read_number: Any,
+        start_sample: Any,
+        channel: Any,
+        well: Any,
+        pore_type: Any,
+        calibration_offset: Any,
+        calibration_scale: Any,
+        median_before: Any,
+        end_reason: Any,
+        run_info: Any,
+        signal: Any,
+        signal_offsets: Any,
+        end_reason_forced: Any = None,
+        num_minknow_events: Any = None,
+        tracked_scaling_scale: Any = None,
+        tracked_scaling_shift: Any = None,
+        predicted_scaling_scale: Any = None,
+        predicted_scaling_shift: Any = None,
+        num_reads_since_mux_change: Any = None,
+        time_since_mux_change: Any = None,
+    ) -> None:
+        """
+        Add many reads given as columns, one array per read field, holding a value
+        for every read in the same order.
+
+        The columns are handed to the writer without building a Python object per
+        read. Arrays already of the written dtype (or Arrow arrays viewable as one)
+        are not copied, and signal is compressed in parallel without holding the GIL.
+
+        Parameters
+        ----------
+        read_id : numpy.ndarray
+            The read ids, either a uint8 array of shape (count, 16) or an array of
+            16 byte values, such as ``UUID.bytes`` in a ``"S16"`` array.
+        read_number, start_sample, channel, well : array-like
+            Integer columns, see :py:class:`Read` and :py:class:`Pore`.
+        pore_type, end_reason, run_info : array-like
+            The index of each read's pore type, end reason and run info, as
+            returned by :py:meth:`Writer.add`.
+        calibration_offset, calibration_scale, median_before : array-like
+            Float columns, see :py:class:`Read` and :py:class:`Calibration`.
+        signal : array-like
+            The int16 signal of every read, concatenated in read order.
+        signal_offsets : array-like
+            Offsets into ``signal``, one more than the read count: read ``i`` holds
+            ``signal[signal_offsets[i]:signal_offsets[i + 1]]``.
+        end_reason_forced : array-like, optional
+            Whether each end reason was forced, False if not given.
+        num_minknow_events, num_reads_since_mux_change : array-like, optional
+            Integer columns, 0 if not given.
+        tracked_scaling_scale, tracked_scaling_shift : array-like, optional
+            Float columns, NaN if not given.
+        predicted_scaling_scale, predicted_scaling_shift : array-like, optional
+            Float columns, NaN if not given.
+        time_since_mux_change : array-like, optional
+            Float column, 0 if not given.
+        """
+        if self._writer is None:
+            raise Pod5ApiException("Writer handle has been closed")
+
+        read_id = np.ascontiguousarray(read_id)
+        if read_id.ndim == 1 and read_id.dtype.itemsize == 16:
+            read_id = read_id.view(np.uint8).reshape(-1, 16)
+        count = read_id.shape[0]
+
+        def column(value: Any, dtype: Any, default: Any = None) -> np.ndarray:
+            if value is None:
+                return np.full(count, default, dtype=dtype)
+            return np.asarray(value, dtype=dtype)
+
+        nan = float("nan")
+        self._writer.add_reads_columnar(  # type: ignore [call-arg]
+            count,
+            read_id.astype(np.uint8, copy=False),
+            column(read_number, np.uint32),
+            column(start_sample, np.uint64),
+            column(channel, np.uint16),
+            column(well, np.uint8),
+            column(pore_type, np.int16),
+            column(calibration_offset, np.float32),
+            column(calibration_scale, np.float32),
+            column(median_before, np.float32),
+            column(end_reason, np.int16),
+            column(end_reason_forced, np.bool_, False),
+            column(run_info, np.int16),
+            column(num_minknow_events, np.uint64, 0),
+            column(tracked_scaling_scale, np.float32, nan),
+            column(tracked_scaling_shift, np.float32, nan),
+            column(predicted_scaling_scale, np.float32, nan),
+            column(predicted_scaling_shift, np.float32, nan),
+            column(num_reads_since_mux_change, np.uint32, 0),
+            column(time_since_mux_change, np.float32, 0),
+            column(signal, np.int16),
+            column(signal_offsets, np.uint64),
+        )
+
     def _prepare_add_reads_args(self, reads: Sequence[BaseRead]) -> List[Any]:
         """
         Converts the List of reads into the list of ctypes arrays of data to be supplied
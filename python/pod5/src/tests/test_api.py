@@ -4,6 +4,7 @@ from pathlib import Path
 from typing import Union
 from uuid import UUID, uuid4, uuid5
 
+import lib_pod5 as p5b
 import numpy as np
 import pytest
 
@@ -262,6 +263,73 @@ def test_pyarrow_from_pathlib_uncompressed():
             run_reader_test(_fh)
 
 
+def test_dictionary_compressed_round_trip(tmp_path: Path):
+    # Short reads sharing structure, which a trained dictionary compresses well:
+    rng = np.random.default_rng(99)
+    signals = []
+    for i in range(500):
+        sample_count = 1000 + i % 1000
+        level = 400 + int(rng.integers(0, 200))
+        steps = (np.arange(sample_count) // 50 % 4) * 30
+        noise = rng.integers(0, 8, sample_count)
+        signals.append((level + steps + noise).astype(np.int16))
+
+    dictionary = p5.train_signal_compression_dictionary(signals)
+    assert len(dictionary) > 0
+
+    reads = []
+    for i in range(20):
+        read = gen_test_read(i)
+        read.signal = signals[i]
+        reads.append(read)
+
+    path = tmp_path / "dictionary.pod5"
+    with p5.Writer(
+        path,
+        signal_compression_type=p5.SignalType.VbzDictionarySignal,
+        signal_compression_dictionary=dictionary,
+    ) as writer:
+        writer.add_reads(reads)
+
+    with p5.Reader(path) as reader:
+        assert reader.is_vbz_compressed
+        records = {record.read_id: record for record in reader.reads()}
+        assert len(records) == len(reads)
+        for read in reads:
+            record = records[read.read_id]
+            assert np.array_equal(record.signal, read.signal)
+            assert np.array_equal(record.signal_for_chunk(0), read.signal)
+            assert np.allclose(
+                record.signal_pa, record.calibrate_signal_array(read.signal)
+            )
+
+
+def test_codec_signal_round_trip(tmp_path: Path):
+    """Signal written through a registered codec is read back through it"""
+    reads = [gen_test_read(i) for i in range(20)]
+
+    with pytest.raises(RuntimeError):
+        p5b.FileWriterOptions().signal_codec_id = "not_a_codec"
+
+    path = tmp_path / "codec.pod5"
+    with p5.Writer(
+        path,
+        signal_compression_type=p5.SignalType.CodecSignal,
+        signal_codec_id=p5b.VBZ_SIGNAL_CODEC_ID,
+    ) as writer:
+        writer.add_reads(reads)
+
+    with p5.Reader(path) as reader:
+        records = {record.read_id: record for record in reader.reads()}
+        assert len(records) == len(reads)
+        for read in reads:
+            record = records[read.read_id]
+            assert np.array_equal(record.signal, read.signal)
+            assert np.allclose(
+                record.signal_pa, record.calibrate_signal_array(read.signal)
+            )
+
+
 def test_read_id_packing():
     """
     Assert pack_read_ids repacks and format_read_ids correctly unpacks collections
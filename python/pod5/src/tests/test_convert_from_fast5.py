@@ -29,6 +29,7 @@ from pod5.tools.pod5_convert_from_fast5 import (
     handle_exception,
     is_multi_read_fast5,
     logger,
+    VbzPassthrough,
 )
 
 
@@ -235,6 +236,61 @@ class TestFast5Conversion:
                 assert expected_read.signal.shape[0] == signal.shape[0]
                 assert signal.dtype == np.int16
 
+    def test_convert_fast5_read_passthrough(self) -> None:
+        """
+        Test signal copied through vbz passthrough matches the fast5 signal
+        """
+        run_info_cache: Dict[str, pod5.RunInfo] = {}
+        passthrough = VbzPassthrough()
+
+        with h5py.File(str(FAST5_PATH), "r") as _f5:
+            for read_id in EXPECTED_POD5_RESULTS:
+                group = _f5[f"read_{read_id}"]
+                read = convert_fast5_read(
+                    group, run_info_cache, passthrough=passthrough
+                )
+                expected = group["Raw/Signal"][()]
+                assert np.array_equal(read.decompressed_signal, expected)
+                assert read.sample_count == len(expected)
+
+        assert passthrough.verified is not False
+
+    @pytest.mark.parametrize("matching_chunk_size", [True, False])
+    def test_convert_fast5_read_passthrough_chunk_size(
+        self, matching_chunk_size: bool
+    ) -> None:
+        """
+        Test signal is only copied through vbz passthrough when the fast5 chunk size
+        matches the requested one, and every chunk but the last has that size
+        """
+        run_info_cache: Dict[str, pod5.RunInfo] = {}
+        passthrough = VbzPassthrough()
+
+        with h5py.File(str(FAST5_PATH), "r") as _f5:
+            for read_id in EXPECTED_POD5_RESULTS:
+                group = _f5[f"read_{read_id}"]
+                dataset = group["Raw/Signal"]
+                assert dataset.chunks is not None
+                chunk_size = dataset.chunks[0]
+                if not matching_chunk_size:
+                    chunk_size = chunk_size // 2 + 1
+
+                read = convert_fast5_read(
+                    group,
+                    run_info_cache,
+                    signal_chunk_size=chunk_size,
+                    passthrough=passthrough,
+                )
+                assert all(
+                    length == chunk_size for length in read.signal_chunk_lengths[:-1]
+                )
+                assert 0 < read.signal_chunk_lengths[-1] <= chunk_size
+                assert np.array_equal(read.decompressed_signal, dataset[()])
+
+        # Chunks of another size are never copied, so never verified:
+        if not matching_chunk_size:
+            assert passthrough.verified is None
+
     @pytest.mark.parametrize(
         "fast5,expected",
         [
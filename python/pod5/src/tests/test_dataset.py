@@ -88,7 +88,7 @@ class TestDatasetReader:
         # Extremely unlikely that there will be a  collision in 40 UUIDs
         assert not dataset.has_duplicate()
         assert dataset._index is not None
-        assert dataset.num_reads == len(dataset._index)
+        assert dataset.num_reads == dataset._index.read_count()
 
         observed_count = 0
         for path in dataset.paths:
@@ -229,8 +229,41 @@ class TestDatasetReader:
         """Test prompt indexing"""
         with p5.DatasetReader(nested_dataset, recursive=True, index=True) as ds:
             assert ds._index is not None
-            assert len(ds._index) == EXPECT_READ_COUNT_RECURSIVE
-            assert set(ds._index.keys()) == set(ds.read_ids)
+            assert ds._index.read_count() == EXPECT_READ_COUNT_RECURSIVE
+            for read_id in ds.read_ids:
+                assert ds.get_path(read_id) is not None
+
+    def test_persistent_read_indexing(self, tmp_path: Path) -> None:
+        """Test an index kept on disk is reused and updated as files are added"""
+        first = tmp_path / "first.pod5"
+        second = tmp_path / "second.pod5"
+        shutil.copyfile(POD5_PATH, first)
+        index_path = tmp_path / "dataset.index"
+
+        with p5.DatasetReader(first, index=True, index_path=index_path) as ds:
+            assert index_path.exists()
+            read_ids = list(ds.read_ids)
+            assert ds.get_path(read_ids[0]) == first
+
+        # The stored index is mapped rather than rebuilt, and unchanged by loading it:
+        index_mtime = index_path.stat().st_mtime_ns
+        with p5.DatasetReader(first, index_path=index_path) as ds:
+            assert ds.get_path(read_ids[-1]) == first
+            assert len(ds) == POD5_PATH_EXPECTED_NUM_READS
+        assert index_path.stat().st_mtime_ns == index_mtime
+
+        # Adding a file indexes it, keeping the entries for the first:
+        shutil.copyfile(POD5_PATH, second)
+        with p5.DatasetReader(
+            [first, second], index_path=index_path, warn_duplicate_indexing=False
+        ) as ds:
+            assert len(ds) == 2 * POD5_PATH_EXPECTED_NUM_READS
+            assert ds.has_duplicate()
+            assert ds.get_path(read_ids[0]) == first
+
+        with p5.DatasetReader(second, index_path=index_path) as ds:
+            assert not ds.has_duplicate()
+            assert ds.get_path(read_ids[0]) == second
 
     def test_iter_multi(self, nested_dataset: Path) -> None:
         """Test __iter__ yields all records"""
@@ -300,6 +333,22 @@ class TestDatasetReader:
         assert observed_count == expected_count == len(observed_read_ids)
         assert observed_read_ids == set(sample)
 
+    def test_stream_reads(self, nested_dataset: Path) -> None:
+        """Test streamed reads match iterated reads across files"""
+        dataset = p5.DatasetReader(nested_dataset, recursive=True)
+
+        streamed = list(dataset.stream_reads(lookahead_reads=3))
+        assert len(streamed) == EXPECT_READ_COUNT_RECURSIVE
+        assert sorted(str(read.read_id) for read in streamed) == sorted(
+            dataset.read_ids
+        )
+
+        sample = random.sample(list(dataset.read_ids), 15)
+        selected = dataset.stream_reads(selection=sample + [str(uuid4())])
+        for read_record in selected:
+            assert str(read_record.read_id) in sample
+            assert len(read_record.signal) == read_record.sample_count
+
     def test_mixed_load(self, nested_dataset: Path) -> None:
         """Test passing file and directory paths"""
         dataset = p5.DatasetReader(
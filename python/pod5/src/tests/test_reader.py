@@ -2,6 +2,7 @@
 Testing Pod5Reader
 """
 
+import os
 import random
 from typing import Type
 from unittest import mock
@@ -19,8 +20,13 @@ import lib_pod5 as p5b
 import pod5 as p5
 from pod5.api_utils import format_read_ids
 from pod5.pod5_types import Calibration, EndReason, RunInfo
-from pod5.reader import ArrowTableHandle, ReadRecordBatch, SignalRowInfo
-from tests.conftest import POD5_PATH
+from pod5.reader import (
+    ArrowTableHandle,
+    MigratedTableReader,
+    ReadRecordBatch,
+    SignalRowInfo,
+)
+from tests.conftest import POD5_PATH, TEST_DATA_PATH
 
 
 class TestPod5Reader:
@@ -167,6 +173,20 @@ class TestPod5Reader:
         # Clean reader resources
         del pod5_file_reader
 
+    @pytest.mark.parametrize("version", [0, 1, 2])
+    def test_legacy_tables_migrated_in_place(self, version: int) -> None:
+        """Older files' tables are migrated as they are read, not rewritten"""
+        legacy_path = TEST_DATA_PATH / f"multi_fast5_zip_v{version}.pod5"
+        with p5.Reader(POD5_PATH) as expected, p5.Reader(legacy_path) as reader:
+            assert isinstance(reader.read_table, MigratedTableReader)
+            assert isinstance(reader.run_info_table, MigratedTableReader)
+
+            assert reader.read_table.read_all().num_rows == expected.num_reads
+            assert reader.read_ids == expected.read_ids
+            for read, expected_read in zip(reader.reads(), expected.reads()):
+                run_info = read.run_info
+                assert run_info.acquisition_id == expected_read.run_info.acquisition_id
+
     def test_iter_selection_in_file_order(self, reader: p5.Reader) -> None:
         """Tests iteration order is on-disk order"""
         shuffled = reader.read_ids
@@ -193,6 +213,92 @@ class TestRecordBatch:
                 assert read.read_id == batch.get_read(idx).read_id
             assert n_reads == idx + 1
 
+    def test_column_projection(self, pod5_factory) -> None:
+        n_reads = 10
+        path = pod5_factory(n_reads)
+        with p5.Reader(path) as reader:
+            full_batch = reader.get_batch(0)
+            batch = reader.get_batch(0, columns=["read_id", "num_samples"])
+
+            assert batch.num_reads == n_reads
+            assert batch.columns.read_id == full_batch.columns.read_id
+            assert batch.columns.num_samples == full_batch.columns.num_samples
+            assert batch.columns.signal is None
+            assert batch.columns.read_number is None
+
+            with pytest.raises(KeyError):
+                reader.get_batch(0, columns=["not_a_column"])
+
+    def test_prefetch_batches(self, pod5_factory) -> None:
+        n_reads = 10
+        path = pod5_factory(n_reads)
+        with p5.Reader(path) as reader:
+            full_batches = list(reader.read_batches())
+            batches = list(reader.prefetch_batches(prefetch_batches=2))
+            assert len(batches) == len(full_batches)
+            for batch, full_batch in zip(batches, full_batches):
+                assert batch.num_reads == full_batch.num_reads
+                assert batch.columns.read_id == full_batch.columns.read_id
+                assert batch.columns.channel == full_batch.columns.channel
+
+            columns = ["read_id", "num_samples"]
+            projected = list(reader.prefetch_batches(columns=columns))
+            assert sum(batch.num_reads for batch in projected) == n_reads
+            first_samples = full_batches[0].columns.num_samples
+            assert projected[0].columns.num_samples == first_samples
+            assert projected[0].columns.signal is None
+
+            with pytest.raises(RuntimeError):
+                list(reader.prefetch_batches(columns=["not_a_column"]))
+
+    @pytest.mark.skipif(not hasattr(os, "fork"), reason="Requires fork")
+    def test_prepare_for_fork(self, pod5_factory) -> None:
+        n_reads = 10
+        path = pod5_factory(n_reads)
+        with p5.Reader(path) as reader:
+            reader.prepare_for_fork()
+            read_ids = [str(read.read_id) for read in reader.reads()]
+            signal = [read.signal.sum() for read in reader.reads()]
+
+            pid = os.fork()
+            if pid == 0:
+                # The child only reports through its exit code:
+                passed = False
+                try:
+                    selected = reader.reads(selection=read_ids[::-1])
+                    selected_ids = sorted(str(read.read_id) for read in selected)
+                    child_signal = [read.signal.sum() for read in reader.reads()]
+                    passed = selected_ids == sorted(read_ids) and child_signal == signal
+                finally:
+                    os._exit(0 if passed else 1)
+
+            _, status = os.waitpid(pid, 0)
+            assert os.WIFEXITED(status)
+            assert os.WEXITSTATUS(status) == 0
+
+    def test_scan(self, pod5_factory) -> None:
+        n_reads = 20
+        path = pod5_factory(n_reads)
+        with p5.Reader(path) as reader:
+            all_reads = list(reader.reads())
+            threshold = sorted(r.num_samples for r in all_reads)[n_reads // 2]
+            end_reason = all_reads[0].end_reason.name
+
+            expression = (
+                f"num_samples >= {threshold} and end_reason == '{end_reason}'"
+            )
+            expected = [
+                str(r.read_id)
+                for r in all_reads
+                if r.num_samples >= threshold and r.end_reason.name == end_reason
+            ]
+            assert [str(r.read_id) for r in reader.scan(expression)] == expected
+
+            assert list(reader.scan("not (channel >= 0)")) == []
+
+            with pytest.raises(RuntimeError):
+                list(reader.scan("num_samples >="))
+
     def test_column_selection(self, pod5_factory) -> None:
         n_reads = 10
         path = pod5_factory(n_reads)
@@ -250,3 +356,107 @@ class TestRecordBatch:
                 batch.cached_sample_count_column
             with pytest.raises(RuntimeError, match="No cached signal data available"):
                 batch.cached_samples_column
+
+    def test_cached_signal_views(self, pod5_factory) -> None:
+        n_reads = 10
+        path = pod5_factory(n_reads)
+        with p5.Reader(path) as reader:
+            loader = reader.inner_file_reader.batch_get_signal(True, True)
+            cache = loader.release_next_batch()
+            all_samples = cache.all_samples
+            samples = cache.samples
+            sample_counts = cache.sample_count
+            sample_offsets = cache.sample_offsets
+            expected = [row_samples.copy() for row_samples in samples]
+
+            # Rows are views over the batch's one buffer, which outlives the batch:
+            del cache, loader
+            assert len(samples) == n_reads
+            for row, row_samples in enumerate(samples):
+                assert numpy.shares_memory(row_samples, all_samples)
+                assert len(row_samples) == sample_counts[row]
+                assert (row_samples == expected[row]).all()
+                assert (
+                    all_samples[sample_offsets[row] : sample_offsets[row + 1]]
+                    == expected[row]
+                ).all()
+
+            assert not sample_counts.flags.writeable
+            assert not sample_offsets.flags.writeable
+
+    def test_stream_reads(self, pod5_factory) -> None:
+        path = pod5_factory(50)
+        with p5.Reader(path) as reader:
+            expected = {read.read_id: read.signal for read in reader.reads()}
+
+            streamed = list(reader.stream_reads(lookahead_reads=1))
+            assert [read.read_id for read in streamed] == list(expected)
+            for read in streamed:
+                assert numpy.array_equal(read.signal, expected[read.read_id])
+
+            selection = [str(read_id) for read_id in list(expected)[::4]]
+            selected = list(
+                reader.stream_reads(selection=selection, lookahead_bytes=1024)
+            )
+            assert sorted(str(read.read_id) for read in selected) == sorted(selection)
+            for read in selected:
+                assert numpy.array_equal(read.signal, expected[read.read_id])
+
+            with pytest.raises(RuntimeError, match="Failed to find"):
+                reader.stream_reads(selection=[str(uuid4())])
+
+    def test_statistics(self, pod5_factory) -> None:
+        path = pod5_factory(10)
+        with p5.Reader(path) as reader:
+            for _ in reader.read_batches(preload={"samples"}):
+                pass
+
+            statistics = reader.statistics()
+            sample_count = sum(read.num_samples for read in reader.reads())
+            assert statistics.signal_table_bytes_read > 0
+            assert statistics.signal_table_batches_decoded > 0
+            assert statistics.signal_cache_misses > 0
+            assert statistics.decompressed_bytes == sample_count * 2
+            assert statistics.decompression_time_seconds > 0
+
+    def test_batches_shared_with_file_reader(self, pod5_factory) -> None:
+        n_reads = 10
+        path = pod5_factory(n_reads)
+        with p5.Reader(path) as reader:
+            batch = reader.get_batch(0)
+            assert batch.num_reads == n_reads
+            assert reader.get_batch(0).columns.read_id == batch.columns.read_id
+            list(reader.reads())
+
+            # Batches come from the file reader, pyarrow only opens tables used directly:
+            assert reader._read_handle is not None
+            assert reader._read_handle._reader is None
+            statistics = reader.statistics()
+            assert statistics.read_table_batches_decoded == 1
+            assert statistics.read_table_cache_hits > 0
+
+            assert reader.read_table.get_batch(0).equals(batch._batch)
+
+    def test_batch_signal_pa(self, pod5_factory) -> None:
+        n_reads = 10
+        path = pod5_factory(n_reads)
+        with p5.Reader(path) as reader:
+            for preload in [None, {"samples"}]:
+                for batch in reader.read_batches(preload=preload):
+                    samples, offsets = batch.signal_pa()
+                    reads = list(batch.reads())
+                    assert samples.dtype == numpy.float32
+                    assert len(offsets) == len(reads) + 1
+                    for read, read_samples in zip(
+                        reads, numpy.split(samples, offsets[1:-1])
+                    ):
+                        assert numpy.allclose(read_samples, read.signal_pa)
+
+            batch = reader.get_batch(0)
+            select_idxs = [3, 4, 8]
+            batch.set_selected_batch_rows(select_idxs)
+            samples, offsets = batch.signal_pa()
+            reads = list(reader.reads())
+            selected_samples = numpy.split(samples, offsets[1:-1])
+            for read_samples, idx in zip(selected_samples, select_idxs):
+                assert numpy.allclose(read_samples, reads[idx].signal_pa)
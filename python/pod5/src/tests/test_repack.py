@@ -1,10 +1,11 @@
+import json
 from pathlib import Path
 import random
 from uuid import uuid4
 import numpy as np
 
 import pod5 as p5
-from pod5.repack import Repacker
+from pod5.repack import Repacker, format_statistics
 from pod5.tools.pod5_repack import repack_pod5
 from tests.conftest import skip_if_windows
 import pytest
@@ -127,6 +128,102 @@ class TestRepacker:
             assert repacker.reads_completed == 10
             assert repacker.is_complete
 
+    def test_statistics(self, tmp_path: Path, pod5_factory) -> None:
+        path = pod5_factory(10)
+
+        dest = tmp_path / "dest.pod5"
+        repacker = Repacker()
+        with p5.Writer(dest) as writer:
+            output = repacker.add_output(writer)
+            with p5.Reader(path) as reader:
+                repacker.add_selected_reads_to_output(output, reader, reader.read_ids)
+            repacker.set_output_finished(output)
+            repacker.finish()
+
+        stats = repacker.statistics()
+        assert stats["reads_read"] == 10
+        assert stats["reads_written"] == 10
+        assert stats["signal_rows_written"] > 0
+        assert stats["states"]["unread_read_table_rows"]["runs"] > 0
+        for state in stats["states"].values():
+            assert state["queued"] == 0
+            assert sum(state["time_histogram"]) == state["runs"]
+
+        pool = stats["thread_pool"]
+        assert pool["tasks_run"] > 0
+        assert sum(pool["run_time_histogram"]) == pool["tasks_run"]
+        assert all(0 <= ratio <= 1 for ratio in pool["worker_busy_ratios"])
+
+        assert json.loads(format_statistics(stats, "json")) == stats
+        assert "unread_read_table_rows" in format_statistics(stats)
+
+    def test_adaptive_concurrency(self, tmp_path: Path, pod5_factory) -> None:
+        path = pod5_factory(100)
+
+        dest = tmp_path / "dest.pod5"
+        repacker = Repacker(adaptive_concurrency=True)
+        with p5.Writer(dest) as writer:
+            output = repacker.add_output(writer)
+            with p5.Reader(path) as reader:
+                repacker.add_all_reads_to_output(output, reader)
+            repacker.set_output_finished(output)
+            repacker.finish()
+
+        assert repacker.reads_completed == 100
+        assert 1 <= repacker.statistics()["worker_concurrency"] <= 10
+        assert Repacker().statistics()["worker_concurrency"] == 10
+
+    def test_pending_bytes_limit(self, tmp_path: Path, pod5_factory) -> None:
+        path = pod5_factory(1100)
+
+        dest = tmp_path / "dest.pod5"
+        # Any signal batch uses up the budget, so inputs are read one batch at a time:
+        repacker = Repacker(max_pending_bytes=1)
+        with p5.Writer(dest) as writer:
+            output = repacker.add_output(writer)
+            with p5.Reader(path) as reader:
+                selection = set(random.sample(reader.read_ids, 500))
+                repacker.add_selected_reads_to_output(output, reader, selection)
+            repacker.set_output_finished(output)
+            repacker.finish()
+
+            assert repacker.reads_completed == len(selection)
+            assert repacker.pending_bytes == 0
+
+        with p5.Reader(dest) as confirm:
+            assert set(confirm.read_ids) == set(selection)
+
+    @pytest.mark.parametrize("sort_by", ["read_id", "channel"])
+    def test_sorted_output(self, tmp_path: Path, pod5_factory, sort_by: str) -> None:
+        path = pod5_factory(1100)
+
+        dest = tmp_path / "dest.pod5"
+        repacker = Repacker()
+        with p5.Writer(dest) as writer:
+            output = repacker.add_output(writer, sort_by=sort_by)
+            with p5.Reader(path) as reader:
+                repacker.add_all_reads_to_output(output, reader)
+            repacker.set_output_finished(output)
+            repacker.finish()
+
+            assert repacker.reads_completed == 1100
+            assert repacker.is_complete
+
+        with p5.Reader(path) as source, p5.Reader(dest) as confirm:
+            source_signals = {
+                record.read_id: record.signal for record in source.reads()
+            }
+            records = list(confirm.reads())
+            assert len(records) == len(source_signals)
+            for record in records:
+                assert np.array_equal(record.signal, source_signals[record.read_id])
+
+            if sort_by == "read_id":
+                keys = [record.read_id for record in records]
+            else:
+                keys = [(record.pore.channel, record.start_sample) for record in records]
+            assert keys == sorted(keys)
+
     def test_add_selection(self, tmp_path: Path, pod5_factory) -> None:
         path = pod5_factory(1100)
 
@@ -151,6 +248,64 @@ class TestRepacker:
 
         repacker.finish()
 
+    def test_add_partitioned(self, tmp_path: Path, pod5_factory) -> None:
+        path = pod5_factory(1100)
+
+        dests = [tmp_path / f"dest_{idx}.pod5" for idx in range(3)]
+        repacker = Repacker()
+        with p5.Writer(dests[0]) as writer_0, p5.Writer(
+            dests[1]
+        ) as writer_1, p5.Writer(dests[2]) as writer_2:
+            outputs = [
+                repacker.add_output(writer)
+                for writer in (writer_0, writer_1, writer_2)
+            ]
+
+            with p5.Reader(path) as reader:
+                read_ids = reader.read_ids
+                # Every read goes to one output, and the first 10 to the last output too:
+                routes = [(read_id, idx % 2) for idx, read_id in enumerate(read_ids)]
+                routes += [(read_id, 2) for read_id in read_ids[:10]]
+                repacker.add_partitioned_reads_to_outputs(outputs, reader, routes)
+
+            for output in outputs:
+                repacker.set_output_finished(output)
+            repacker.finish()
+
+            assert repacker.reads_requested == len(routes)
+            assert repacker.reads_completed == len(routes)
+
+        for idx, dest in enumerate(dests):
+            with p5.Reader(dest) as confirm:
+                expected = set(read_id for read_id, out in routes if out == idx)
+                assert set(confirm.read_ids) == expected
+
+    def test_add_read_ids(self, tmp_path: Path, pod5_factory) -> None:
+        paths = [pod5_factory(100), pod5_factory(300)]
+
+        dest = tmp_path / "dest.pod5"
+        repacker = Repacker()
+        with p5.Writer(dest) as writer:
+            output = repacker.add_output(writer)
+
+            readers = [p5.Reader(path) for path in paths]
+            selected = readers[0].read_ids[::3] + readers[1].read_ids[1::7]
+            missing = str(uuid4())
+            found = repacker.add_read_ids_to_output(
+                output, readers, p5.pack_read_ids(selected + [missing])
+            )
+            for reader in readers:
+                reader.close()
+
+            repacker.set_output_finished(output)
+            repacker.finish()
+
+            assert list(found) == [True] * len(selected) + [False]
+            assert repacker.reads_requested == len(selected)
+
+        with p5.Reader(dest) as confirm:
+            assert sorted(confirm.read_ids) == sorted(selected)
+
     def test_missing_selection(self, tmp_path: Path, pod5_factory) -> None:
         path = pod5_factory(10)
 
@@ -1,27 +1,24 @@
+import dataclasses
 from pathlib import Path
 import random
 from typing import Any, Dict
 import polars as pl
+import pyarrow as pa
 
 import pytest
 
+import lib_pod5 as p5b
 import pod5 as p5
 from pod5.tools.pod5_view import (
     Field,
-    assert_unique_acquisition_id,
-    get_reads_tables,
-    join_reads_to_run_info,
-    parse_read_table_chunks,
-    parse_reads_table_all,
-    parse_run_info_table,
     view_pod5,
     select_fields,
     get_field_or_raise,
     resolve_output,
     write,
-    write_header,
     FIELDS,
 )
+from tests.conftest import _random_read
 
 
 TEST_DATA_PATH = Path(__file__).parent.parent.parent.parent.parent / "test_data"
@@ -55,6 +52,21 @@ ALL_FIELDS = [
 ]
 
 
+def write_duplicated_run_info(path: Path, **changes: Any) -> None:
+    """
+    Write reads split between two run infos sharing an acquisition_id, the second
+    with `changes` applied
+    """
+    reads = [_random_read(seed) for seed in range(6)]
+    run_info = reads[0].run_info
+    duplicate = dataclasses.replace(run_info, **changes)
+    with p5.Writer(path) as writer:
+        for idx, read in enumerate(reads):
+            writer.add_read(
+                dataclasses.replace(read, run_info=duplicate if idx % 2 else run_info)
+            )
+
+
 class TestView:
     """Test view application"""
 
@@ -129,16 +141,13 @@ class TestView:
         with pytest.raises(AssertionError, match="Found no pod5 files"):
             view_pod5([tmp_path], tmp_path)
 
-    def test_write_stdout(self, capsys: pytest.CaptureFixture) -> None:
-        """Test that polars writes to stdout when path is None"""
+    def test_write_stdout(self, capfd: pytest.CaptureFixture) -> None:
+        """Test that the table is written to stdout when path is None"""
 
-        ldf = next(get_reads_tables(POD5_PATH, select_fields()))
-        write_header(None, select_fields())
-        write(ldf, None)
-        content: str = capsys.readouterr().out
-        err: str = capsys.readouterr().err
-        assert not err
-        lines = content.splitlines()
+        write([POD5_PATH], None, select_fields())
+        captured = capfd.readouterr()
+        assert not captured.err
+        lines = captured.out.splitlines()
         header = lines[0]
         assert list(map(str.strip, header.split("\t"))) == ALL_FIELDS
         # Empty trailing line
@@ -157,60 +166,55 @@ class TestView:
 
                 self._compare(record, row)
 
-    def test_parse_run_info(self, pod5_factory) -> None:
-        """Test the run_info table parser"""
-        a_pod5 = pod5_factory(10)
-        with p5.Reader(a_pod5) as reader:
-            run_info = parse_run_info_table(reader)
-
-        assert isinstance(run_info, pl.LazyFrame)
-        run_info = run_info.collect()
-        assert run_info.is_unique().all()
-        assert "context_tags" not in run_info.columns
-        assert "tracking_id" not in run_info.columns
-
-    def test_parse_reads_all(self, pod5_factory) -> None:
-        """Test the reads table parser where the file is small enough to do in one go"""
-        a_pod5 = pod5_factory(10)
-        with p5.Reader(a_pod5) as reader:
-            reads = parse_reads_table_all(reader)
-
-        assert isinstance(reads, pl.LazyFrame)
-        assert "read_id" in reads.columns
-        assert "run_info" in reads.columns
-        assert len(reads.collect()) == 10
-
-    def test_parse_reads_multi_chunk(self, pod5_factory) -> None:
-        """Test the reads table parser"""
-        a_pod5 = pod5_factory(1100)
-        with p5.Reader(a_pod5) as reader:
-            tables = [t for t in parse_read_table_chunks(reader, approx_size=999)]
-
-        assert len(tables) == 2
-        for table in tables:
-            assert isinstance(table, pl.LazyFrame)
-            assert "read_id" in table.columns
-            assert "run_info" in table.columns
-
-        all_reads = pl.concat(tables)
-        assert len(all_reads.collect()) == 1100
-
-    def test_unique_on_duplicated_run_info(self) -> None:
-        """Legacy bug where run_info data was duplicated"""
-        reads_data = {"read_id": ["a", "b", "c"], "run_info": ["r1", "r1", "r1"]}
-        reads = pl.DataFrame(reads_data).lazy()
+    def test_view_multiple_files(self, tmp_path: Path, pod5_factory) -> None:
+        """Test reads of several files are written in order, each file in turn"""
+        paths = [pod5_factory(1100), pod5_factory(10)]
+        output = tmp_path / "test.tsv"
+        view_pod5(paths, output, include="read_id,filename", threads=4)
 
-        run_info_data_dupl = {"acquisition_id": ["r1", "r1"], "data": ["d1", "d1"]}
-        run_info = pl.DataFrame(run_info_data_dupl).lazy()
+        df = pl.read_csv(output, separator="\t")
+        expected_ids = []
+        expected_names = []
+        for path in sorted(paths):
+            with p5.Reader(path) as reader:
+                expected_ids.extend(reader.read_ids)
+                expected_names.extend([path.name] * reader.num_reads)
 
-        assert_unique_acquisition_id(run_info, Path.cwd())
-        joined = join_reads_to_run_info(reads, run_info)
+        assert df["read_id"].to_list() == expected_ids
+        assert df["filename"].to_list() == expected_names
+
+    def test_unique_on_duplicated_run_info(self, tmp_path: Path) -> None:
+        """Legacy bug where run_info data was duplicated"""
+        path = tmp_path / "duplicated.pod5"
+        write_duplicated_run_info(path, software="duplicated")
+        with p5.Reader(path) as reader:
+            assert reader.run_info_table.read_all().num_rows == 2
+            read_ids = reader.read_ids
+
+        output = tmp_path / "test.tsv"
+        view_pod5([path], output, include="read_id,run_id")
 
-        assert len(reads.collect()) == 3
-        assert len(run_info.collect()) == 2
-        # If len(joined) is 6, the uniqueness of run_info has failed and the
+        df = pl.read_csv(output, separator="\t")
+        # If there are 12 rows, the uniqueness of run_info has failed and the
         # join operation has doubled-up every row
-        assert len(joined.collect()) == 3
+        assert len(df) == 6
+        assert df["read_id"].to_list() == read_ids
+
+    def test_view_arrow(self, tmp_path: Path) -> None:
+        """Test the arrow output holds typed columns"""
+        output = tmp_path / "test.arrow"
+        view_pod5([POD5_PATH], output, output_format="arrow")
+
+        with pa.ipc.open_stream(output.read_bytes()) as stream:
+            table = stream.read_all()
+
+        assert table.column_names == ALL_FIELDS
+        assert table.schema.field("channel").type == pa.uint16()
+        assert table.schema.field("start_time").type == pa.float64()
+        with p5.Reader(POD5_PATH) as reader:
+            for idx, record in enumerate(reader):
+                row = {name: table[name][idx].as_py() for name in ALL_FIELDS}
+                self._compare(record, row)
 
 
 class TestSelection:
@@ -296,15 +300,16 @@ class TestMisc:
     def test_fields(self) -> None:
         assert all(key == field for key, field in zip(ALL_FIELDS, FIELDS.keys()))
         assert len(FIELDS) > 0
-
-    def test_unique_acquisition_id(self) -> None:
-        pass_example = pl.DataFrame(
-            {"acquisition_id": [1, 1, 3], "b": [1, 1, 3], "c": [2, 2, 3]}
-        ).lazy()
-        assert_unique_acquisition_id(pass_example, Path("none"))
-
-        fail_example = pl.DataFrame(
-            {"acquisition_id": [1, 1, 3], "b": [1, 2, 3], "c": [2, 1, 3]}
-        ).lazy()
-        with pytest.raises(AssertionError, match="acquisition_id"):
-            assert_unique_acquisition_id(fail_example, Path("none"))
+        assert list(FIELDS) == p5b.export_field_names()
+        assert "context_tags" not in FIELDS
+        assert "tracking_id" not in FIELDS
+
+    def test_unique_acquisition_id(self, tmp_path: Path) -> None:
+        pass_example = tmp_path / "pass.pod5"
+        write_duplicated_run_info(pass_example, software="duplicated")
+        view_pod5([pass_example], tmp_path / "pass.tsv")
+
+        fail_example = tmp_path / "fail.pod5"
+        write_duplicated_run_info(fail_example, sample_id="another_sample")
+        with pytest.raises(RuntimeError, match="acquisition_id"):
+            view_pod5([fail_example], tmp_path / "fail.tsv")
@@ -31,6 +31,33 @@ class TestPod5Writer:
         """Write some random single reads to a writer which are pre-compressed"""
         writer.add_read(random_read_pre_compressed)
 
+    @pytest.mark.parametrize("random_read", [1], indirect=True)
+    def test_writer_memory_statistics(
+        self, writer: p5.Writer, random_read: p5.Read
+    ) -> None:
+        """Writer allocations are counted as the writer builders subsystem's"""
+        before = p5b.memory_statistics()["writer_builders"]
+        writer.add_read(random_read)
+        after = p5b.memory_statistics()["writer_builders"]
+        assert after.allocation_count > before.allocation_count
+        assert after.peak_bytes_allocated >= after.bytes_allocated
+
+    @pytest.mark.parametrize("random_read", [1], indirect=True)
+    def test_writer_memory_limit(self, tmp_path, random_read: p5.Read) -> None:
+        """Allocations over a subsystem's limit fail rather than growing the process"""
+        with pytest.raises(RuntimeError, match="Unknown memory subsystem"):
+            p5b.set_memory_limit("not_a_subsystem", 1)
+
+        failed = p5b.memory_statistics()["writer_builders"].failed_allocations
+        p5b.set_memory_limit("writer_builders", 1)
+        try:
+            with pytest.raises(RuntimeError, match="over its limit"):
+                with p5.Writer(tmp_path / "limited.pod5") as writer:
+                    writer.add_read(random_read)
+        finally:
+            p5b.set_memory_limit("writer_builders", 0)
+        assert p5b.memory_statistics()["writer_builders"].failed_allocations > failed
+
     def test_read_edit_write(self, reader: p5.Reader, writer: p5.Writer) -> None:
         """Read some records, edit the reads and write an edited read"""
 
@@ -115,6 +142,68 @@ class TestPod5Writer:
             assert np.array_equal(before.signal, after.signal)
             assert np.array_equal(before.signal_pa, after.signal_pa)
 
+    def test_add_reads_columnar(self, reader: p5.Reader, writer: p5.Writer) -> None:
+        """Write reads given as columns and check they match the reads they came from"""
+        reads = [record.to_read() for record in reader]
+        signal_lengths = [len(read.signal) for read in reads]
+
+        writer.add_reads_columnar(
+            read_id=np.array([read.read_id.bytes for read in reads], dtype="S16"),
+            read_number=[read.read_number for read in reads],
+            start_sample=[read.start_sample for read in reads],
+            channel=[read.pore.channel for read in reads],
+            well=[read.pore.well for read in reads],
+            pore_type=[writer.add(read.pore.pore_type) for read in reads],
+            calibration_offset=[read.calibration.offset for read in reads],
+            calibration_scale=[read.calibration.scale for read in reads],
+            median_before=[read.median_before for read in reads],
+            end_reason=[writer.add(read.end_reason) for read in reads],
+            end_reason_forced=[read.end_reason.forced for read in reads],
+            run_info=[writer.add(read.run_info) for read in reads],
+            num_minknow_events=[read.num_minknow_events for read in reads],
+            signal=np.concatenate([read.signal for read in reads]),
+            signal_offsets=np.concatenate([[0], np.cumsum(signal_lengths)]),
+        )
+        writer.close()
+
+        with p5.Reader(writer.path) as written:
+            after = {record.read_id: record for record in written}
+            assert len(after) == len(reads)
+            for read in reads:
+                record = after[read.read_id]
+                assert record.read_number == read.read_number
+                assert record.start_sample == read.start_sample
+                assert record.pore == read.pore
+                assert record.calibration == read.calibration
+                assert record.end_reason == read.end_reason
+                assert record.run_info == read.run_info
+                assert record.num_minknow_events == read.num_minknow_events
+                assert np.array_equal(record.signal, read.signal)
+
+    def test_add_reads_columnar_bad_offsets(self, writer: p5.Writer) -> None:
+        """Columns of the wrong length and offsets beyond the signal are rejected"""
+        end_reason = p5.EndReason.from_reason_with_default_forced(
+            p5.EndReasonEnum.SIGNAL_POSITIVE
+        )
+        columns = dict(
+            read_id=np.zeros((1, 16), dtype=np.uint8),
+            read_number=[1],
+            start_sample=[0],
+            channel=[1],
+            well=[1],
+            pore_type=[writer.add("pore")],
+            calibration_offset=[0.0],
+            calibration_scale=[1.0],
+            median_before=[0.0],
+            end_reason=[writer.add(end_reason)],
+            run_info=[0],
+            signal=np.arange(10, dtype=np.int16),
+        )
+        with pytest.raises(RuntimeError, match="Signal offsets"):
+            writer.add_reads_columnar(signal_offsets=[0, 11], **columns)
+        with pytest.raises(RuntimeError, match="signal_offsets"):
+            writer.add_reads_columnar(signal_offsets=[0], **columns)
+
     def test_read_record_type_check(self, reader: p5.Reader, writer: p5.Writer) -> None:
         """Check type errors raised when passing ReadRecords to writer"""
         with pytest.raises(TypeError, match="ReadRecord.to_read"):
@@ -128,3 +217,31 @@ class TestPod5Writer:
             writer.add_read([1])  # type: ignore
 
         writer.close()
+
+    @pytest.mark.parametrize("random_read", [1], indirect=True)
+    def test_signal_summaries(self, tmp_path, random_read: p5.Read) -> None:
+        """Signal summaries written with the reads are found by the reader"""
+        path = tmp_path / "summaries.pod5"
+        with p5.Writer(path, signal_summary_decimations=[16, 256]) as writer:
+            writer.add_read(random_read)
+
+        with p5.Reader(path) as reader:
+            assert reader.signal_summary_decimations == [16, 256]
+            summary = reader.get_signal_summary(random_read.read_id, 16)
+            assert summary is not None
+            signal = random_read.signal
+            runs = [signal[i : i + 16] for i in range(0, len(signal), 16)]
+            assert np.array_equal(summary.min, [run.min() for run in runs])
+            assert np.array_equal(summary.max, [run.max() for run in runs])
+            assert summary.mean.dtype == np.int16
+            assert len(summary.mean) == len(runs)
+
+            assert reader.get_signal_summary(random_read.read_id, 64) is None
+
+        path = tmp_path / "no_summaries.pod5"
+        with p5.Writer(path) as writer:
+            writer.add_read(random_read)
+
+        with p5.Reader(path) as reader:
+            assert reader.signal_summary_decimations == []
+            assert reader.get_signal_summary(random_read.read_id, 16) is None